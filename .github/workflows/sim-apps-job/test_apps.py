@@ -33,6 +33,9 @@ blacklist = [
     "example_spi_read",
     "example_spi_host_dma_power_gate",
     "example_spi_write",
+    "example_spi_flash_bench",
+    "example_bus_qos",
+    "example_plic_latency",
 ]
 
 app_list = [app for app in os.listdir("sw/applications")]
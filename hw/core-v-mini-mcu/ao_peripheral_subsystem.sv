@@ -21,6 +21,19 @@ module ao_peripheral_subsystem
     input  logic        execute_from_flash_i,
     output logic        exit_valid_o,
     output logic [31:0] exit_value_o,
+    output logic        bus_qos_override_o,
+    output logic [15:0] bus_qos_window_o,
+    output logic [31:0] bus_qos_priority_o,
+    output logic [31:0] bus_qos_budget_o,
+    output logic        perf_freeze_o,
+    output logic        perf_clear_o,
+    output logic [ 7:0] perf_sel_o,
+    input  logic [31:0] perf_value_i,
+    output logic        instr_buf_enable_o,
+    output logic        instr_buf_prefetch_o,
+    output logic        instr_buf_clear_o,
+    input  logic [31:0] instr_buf_hits_i,
+    input  logic [31:0] instr_buf_misses_i,
 
     // Memory Map SPI Region
     input  obi_req_t  spimemio_req_i,
@@ -79,8 +92,14 @@ module ao_peripheral_subsystem
     input  obi_resp_t dma_write_ch0_resp_i,
     output obi_req_t  dma_addr_ch0_req_o,
     input  obi_resp_t dma_addr_ch0_resp_i,
+
+    output core_v_mini_mcu_pkg::obi_wide_req_t  dma_wide_read_req_o,
+    input  core_v_mini_mcu_pkg::obi_wide_resp_t dma_wide_read_resp_i,
+    output core_v_mini_mcu_pkg::obi_wide_req_t  dma_wide_write_req_o,
+    input  core_v_mini_mcu_pkg::obi_wide_resp_t dma_wide_write_resp_i,
     output logic      dma_done_intr_o,
     output logic      dma_window_intr_o,
+    output logic      dma_busy_o,
 
     // External PADs
     output reg_req_t pad_req_o,
@@ -111,12 +130,17 @@ module ao_peripheral_subsystem
     // I2s
     input logic i2s_rx_valid_i,
 
+    // PDM2PCM
+    input logic pdm2pcm_rx_valid_i,
+
     // EXTERNAL PERIPH
     output reg_req_t ext_peripheral_slave_req_o,
     input  reg_rsp_t ext_peripheral_slave_resp_i,
 
     input logic ext_dma_slot_tx_i,
-    input logic ext_dma_slot_rx_i
+    input logic ext_dma_slot_rx_i,
+    input logic ext_dma_slot_acc_tx_i,
+    input logic ext_dma_slot_acc_rx_i
 );
 
   import core_v_mini_mcu_pkg::*;
@@ -138,6 +162,8 @@ module ao_peripheral_subsystem
   logic [AO_PERIPHERALS_PORT_SEL_WIDTH-1:0] peripheral_select;
 
   logic use_spimemio;
+  logic [31:0] flash_cache_hits;
+  logic [31:0] flash_cache_misses;
 
   logic spi_flash_rx_valid;
   logic spi_flash_tx_ready;
@@ -166,7 +192,9 @@ module ao_peripheral_subsystem
   obi_pkg::obi_req_t  slave_fifoout_req;
   obi_pkg::obi_resp_t slave_fifoout_resp;
 
-  obi_fifo obi_fifo_i (
+  obi_fifo #(
+      .OUTSTANDING(core_v_mini_mcu_pkg::AO_PERIPHERAL_OUTSTANDING)
+  ) obi_fifo_i (
       .clk_i,
       .rst_ni,
       .producer_req_i (slave_fifoin_req),
@@ -244,6 +272,21 @@ module ao_peripheral_subsystem
       .boot_select_i,
       .execute_from_flash_i,
       .use_spimemio_o(use_spimemio),
+      .flash_cache_hits_i(flash_cache_hits),
+      .flash_cache_misses_i(flash_cache_misses),
+      .bus_qos_override_o,
+      .bus_qos_window_o,
+      .bus_qos_priority_o,
+      .bus_qos_budget_o,
+      .perf_freeze_o,
+      .perf_clear_o,
+      .perf_sel_o,
+      .perf_value_i,
+      .instr_buf_enable_o,
+      .instr_buf_prefetch_o,
+      .instr_buf_clear_o,
+      .instr_buf_hits_i,
+      .instr_buf_misses_i,
       .exit_valid_o,
       .exit_value_o
   );
@@ -257,6 +300,8 @@ module ao_peripheral_subsystem
       .clk_i,
       .rst_ni,
       .use_spimemio_i(use_spimemio),
+      .flash_cache_hits_o(flash_cache_hits),
+      .flash_cache_misses_o(flash_cache_misses),
       .spimemio_req_i,
       .spimemio_resp_o,
       .yo_reg_req_i(ao_peripheral_slv_req[core_v_mini_mcu_pkg::SPI_MEMIO_IDX]),
@@ -335,23 +380,39 @@ module ao_peripheral_subsystem
       .intr_timer_expired_1_0_o(rv_timer_1_intr_o)
   );
 
-  parameter DMA_TRIGGER_SLOT_NUM = 7;
-  logic [DMA_TRIGGER_SLOT_NUM-1:0] dma_trigger_slots;
-  assign dma_trigger_slots[0] = spi_rx_valid_i;
-  assign dma_trigger_slots[1] = spi_tx_ready_i;
-  assign dma_trigger_slots[2] = spi_flash_rx_valid;
-  assign dma_trigger_slots[3] = spi_flash_tx_ready;
-  assign dma_trigger_slots[4] = i2s_rx_valid_i;
-  assign dma_trigger_slots[5] = ext_dma_slot_tx_i;
-  assign dma_trigger_slots[6] = ext_dma_slot_rx_i;
-
-  dma #(
-      .reg_req_t (reg_pkg::reg_req_t),
-      .reg_rsp_t (reg_pkg::reg_rsp_t),
-      .obi_req_t (obi_pkg::obi_req_t),
-      .obi_resp_t(obi_pkg::obi_resp_t),
-      .SLOT_NUM  (DMA_TRIGGER_SLOT_NUM)
-  ) dma_i (
+  logic uart_rx_valid, uart_tx_ready;
+  logic [core_v_mini_mcu_pkg::DMA_TRIG_SRC_NUM-1:0] dma_trigger_sources;
+  logic [core_v_mini_mcu_pkg::DMA_TRIGGER_SLOT_NUM-1:0] dma_trigger_slots;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_SPI_RX] = spi_rx_valid_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_SPI_TX] = spi_tx_ready_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_SPI_FLASH_RX] = spi_flash_rx_valid;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_SPI_FLASH_TX] = spi_flash_tx_ready;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_I2S] = i2s_rx_valid_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_EXT_TX] = ext_dma_slot_tx_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_EXT_RX] = ext_dma_slot_rx_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_PDM2PCM] = pdm2pcm_rx_valid_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_UART_RX] = uart_rx_valid;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_UART_TX] = uart_tx_ready;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_EXT_ACC_TX] = ext_dma_slot_acc_tx_i;
+  assign dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIG_SRC_EXT_ACC_RX] = ext_dma_slot_acc_rx_i;
+
+  // Trigger slots of mcu_cfg.hjson
+  for (genvar i = 0; i < core_v_mini_mcu_pkg::DMA_TRIGGER_SLOT_NUM; i++) begin : gen_dma_trigger_slot
+    assign dma_trigger_slots[i] = dma_trigger_sources[core_v_mini_mcu_pkg::DMA_TRIGGER_SLOT_SRC[i]];
+  end
+
+  dma_subsystem #(
+      .reg_req_t  (reg_pkg::reg_req_t),
+      .reg_rsp_t  (reg_pkg::reg_rsp_t),
+      .obi_req_t  (obi_pkg::obi_req_t),
+      .obi_resp_t (obi_pkg::obi_resp_t),
+      .obi_wide_req_t(core_v_mini_mcu_pkg::obi_wide_req_t),
+      .obi_wide_resp_t(core_v_mini_mcu_pkg::obi_wide_resp_t),
+      .SLOT_NUM   (core_v_mini_mcu_pkg::DMA_TRIGGER_SLOT_NUM),
+      .WIDE_LANES (core_v_mini_mcu_pkg::DMA_WIDE_LANES),
+      .DMA_CH_NUM (core_v_mini_mcu_pkg::DMA_CH_NUM),
+      .DMA_CH_SIZE(core_v_mini_mcu_pkg::DMA_CH_SIZE)
+  ) dma_subsystem_i (
       .clk_i,
       .rst_ni,
       .reg_req_i(ao_peripheral_slv_req[core_v_mini_mcu_pkg::DMA_IDX]),
@@ -362,9 +423,14 @@ module ao_peripheral_subsystem
       .dma_write_ch0_resp_i,
       .dma_addr_ch0_req_o,
       .dma_addr_ch0_resp_i,
+      .dma_wide_read_req_o,
+      .dma_wide_read_resp_i,
+      .dma_wide_write_req_o,
+      .dma_wide_write_resp_i,
       .trigger_slot_i(dma_trigger_slots),
       .dma_done_intr_o(dma_done_intr_o),
-      .dma_window_intr_o(dma_window_intr_o)
+      .dma_window_intr_o(dma_window_intr_o),
+      .dma_busy_o
   );
 
   assign pad_req_o = ao_peripheral_slv_req[core_v_mini_mcu_pkg::PAD_CONTROL_IDX];
@@ -430,7 +496,9 @@ module ao_peripheral_subsystem
       .intr_rx_frame_err_o(uart_intr_rx_frame_err_o),
       .intr_rx_break_err_o(uart_intr_rx_break_err_o),
       .intr_rx_timeout_o(uart_intr_rx_timeout_o),
-      .intr_rx_parity_err_o(uart_intr_rx_parity_err_o)
+      .intr_rx_parity_err_o(uart_intr_rx_parity_err_o),
+      .dma_rx_valid_o(uart_rx_valid),
+      .dma_tx_ready_o(uart_tx_ready)
   );
 
 endmodule : ao_peripheral_subsystem
@@ -0,0 +1,147 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: bus_perf_counters.sv
+// Description: Performance counters of the system crossbar, read through
+//              the PERF_CTRL and PERF_VALUE registers of soc_ctrl
+
+module bus_perf_counters #(
+    parameter int unsigned XBAR_NMASTER = 2,
+    parameter int unsigned XBAR_NSLAVE = 1,
+    parameter int unsigned NUM_BANKS = 1,
+    // Slave index of the first RAM bank, the others follow it
+    parameter int unsigned FIRST_BANK_IDX = 1,
+    localparam int unsigned LogNSlave = XBAR_NSLAVE > 1 ? $clog2(XBAR_NSLAVE) : 32'd1
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Requests of the masters, their slaves and their responses
+    input logic [XBAR_NMASTER-1:0]                req_i,
+    input logic [XBAR_NMASTER-1:0][LogNSlave-1:0] slave_sel_i,
+    input logic [XBAR_NMASTER-1:0]                gnt_i,
+    input logic [XBAR_NMASTER-1:0]                rvalid_i,
+
+    // Accesses granted by the RAM banks
+    input logic [NUM_BANKS-1:0] bank_access_i,
+
+    // Cycles counted by the global counters
+    input logic dma_busy_i,
+    input logic core_stall_i,
+
+    // Settings and readout, see PERF_CTRL
+    input  logic        freeze_i,
+    input  logic        clear_i,
+    input  logic [ 7:0] sel_i,
+    output logic [31:0] value_o
+);
+  // The counters wrap at 2^32. sel_i[7:5] selects the group, sel_i[4:0] the
+  // master or the bank, so only the first 32 of them can be read:
+  //   0: cycles with a request of the master
+  //   1: requests of the master granted
+  //   2: read responses of the master
+  //   3: accesses of the bank
+  //   4: cycles with a request to the bank waiting for its grant, i.e. lost
+  //      to another master or to the arbitration settings
+  //   5: 0 cycles, 1 cycles with the DMA busy, 2 cycles with a request of the
+  //      core waiting for its grant
+  //   7: 0 number of masters, 1 number of banks
+  // The other selections read 0.
+
+  localparam logic [2:0] GroupReqCycles = 3'd0;
+  localparam logic [2:0] GroupGnt = 3'd1;
+  localparam logic [2:0] GroupRvalid = 3'd2;
+  localparam logic [2:0] GroupBankAccesses = 3'd3;
+  localparam logic [2:0] GroupBankConflicts = 3'd4;
+  localparam logic [2:0] GroupGlobal = 3'd5;
+  localparam logic [2:0] GroupInfo = 3'd7;
+
+  localparam int unsigned NumGlobal = 3;
+
+  logic [XBAR_NMASTER-1:0][31:0] req_cycles_q, gnt_q, rvalid_q;
+  logic [NUM_BANKS-1:0][31:0] bank_accesses_q, bank_conflicts_q;
+  logic [NumGlobal-1:0][31:0] global_q;
+
+  logic [NUM_BANKS-1:0] bank_conflict;
+  logic [NumGlobal-1:0] global_event;
+
+  always_comb begin
+    bank_conflict = '0;
+    for (int unsigned b = 0; b < NUM_BANKS; b++) begin
+      for (int unsigned m = 0; m < XBAR_NMASTER; m++) begin
+        if (req_i[m] && !gnt_i[m] && 32'(slave_sel_i[m]) == FIRST_BANK_IDX + b) begin
+          bank_conflict[b] = 1'b1;
+        end
+      end
+    end
+  end
+
+  assign global_event = {core_stall_i, dma_busy_i, 1'b1};
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      req_cycles_q <= '0;
+      gnt_q <= '0;
+      rvalid_q <= '0;
+      bank_accesses_q <= '0;
+      bank_conflicts_q <= '0;
+      global_q <= '0;
+    end else if (clear_i) begin
+      req_cycles_q <= '0;
+      gnt_q <= '0;
+      rvalid_q <= '0;
+      bank_accesses_q <= '0;
+      bank_conflicts_q <= '0;
+      global_q <= '0;
+    end else if (!freeze_i) begin
+      for (int unsigned m = 0; m < XBAR_NMASTER; m++) begin
+        if (req_i[m]) req_cycles_q[m] <= req_cycles_q[m] + 32'd1;
+        if (req_i[m] && gnt_i[m]) gnt_q[m] <= gnt_q[m] + 32'd1;
+        if (rvalid_i[m]) rvalid_q[m] <= rvalid_q[m] + 32'd1;
+      end
+      for (int unsigned b = 0; b < NUM_BANKS; b++) begin
+        if (bank_access_i[b]) bank_accesses_q[b] <= bank_accesses_q[b] + 32'd1;
+        if (bank_conflict[b]) bank_conflicts_q[b] <= bank_conflicts_q[b] + 32'd1;
+      end
+      for (int unsigned g = 0; g < NumGlobal; g++) begin
+        if (global_event[g]) global_q[g] <= global_q[g] + 32'd1;
+      end
+    end
+  end
+
+  // The selected counter is registered, it is read at least a cycle after
+  // sel_i is written
+  logic [2:0] group;
+  logic [4:0] index;
+  logic [31:0] value_d;
+
+  assign group = sel_i[7:5];
+  assign index = sel_i[4:0];
+
+  always_comb begin
+    value_d = '0;
+    unique case (group)
+      GroupReqCycles: if (32'(index) < XBAR_NMASTER) value_d = req_cycles_q[index];
+      GroupGnt: if (32'(index) < XBAR_NMASTER) value_d = gnt_q[index];
+      GroupRvalid: if (32'(index) < XBAR_NMASTER) value_d = rvalid_q[index];
+      GroupBankAccesses: if (32'(index) < NUM_BANKS) value_d = bank_accesses_q[index];
+      GroupBankConflicts: if (32'(index) < NUM_BANKS) value_d = bank_conflicts_q[index];
+      GroupGlobal: if (32'(index) < NumGlobal) value_d = global_q[index];
+      GroupInfo: begin
+        if (index == 5'd0) value_d = XBAR_NMASTER;
+        else if (index == 5'd1) value_d = NUM_BANKS;
+      end
+      default: value_d = '0;
+    endcase
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      value_o <= '0;
+    end else begin
+      value_o <= value_d;
+    end
+  end
+
+endmodule : bus_perf_counters
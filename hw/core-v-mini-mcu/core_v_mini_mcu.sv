@@ -318,7 +318,9 @@ module core_v_mini_mcu
     output logic [31:0] exit_value_o,
 
     input logic ext_dma_slot_tx_i,
-    input logic ext_dma_slot_rx_i
+    input logic ext_dma_slot_rx_i,
+    input logic ext_dma_slot_acc_tx_i,
+    input logic ext_dma_slot_acc_rx_i
 );
 
   import core_v_mini_mcu_pkg::*;
@@ -352,6 +354,12 @@ module core_v_mini_mcu
   obi_req_t dma_addr_ch0_req;
   obi_resp_t dma_addr_ch0_resp;
 
+  // wide DMA ports into the interleaved banks
+  obi_wide_req_t dma_wide_read_req;
+  obi_wide_resp_t dma_wide_read_resp;
+  obi_wide_req_t dma_wide_write_req;
+  obi_wide_resp_t dma_wide_write_resp;
+
   // ram signals
   obi_req_t [core_v_mini_mcu_pkg::NUM_BANKS-1:0] ram_slave_req;
   obi_resp_t [core_v_mini_mcu_pkg::NUM_BANKS-1:0] ram_slave_resp;
@@ -370,6 +378,27 @@ module core_v_mini_mcu
   logic debug_core_req;
   logic debug_reset_n;
 
+  // Arbitration settings of the system bus
+  logic bus_qos_override;
+  logic [15:0] bus_qos_window;
+  logic [31:0] bus_qos_priority, bus_qos_budget;
+
+  // Performance counters of the system bus
+  logic dma_busy;
+  logic perf_freeze, perf_clear;
+  logic [7:0] perf_sel;
+  logic [31:0] perf_value;
+
+  // Instruction buffer of the main core
+  obi_req_t core_instr_cpu_req;
+  obi_resp_t core_instr_cpu_resp;
+  logic instr_buf_enable, instr_buf_prefetch, instr_buf_clear;
+  logic [31:0] instr_buf_hits, instr_buf_misses;
+
+  // Posted write buffer of the main core
+  obi_req_t core_data_cpu_req;
+  obi_resp_t core_data_cpu_resp;
+
   // core
   logic core_sleep;
 
@@ -434,6 +463,14 @@ module core_v_mini_mcu
   // I2s
   logic i2s_rx_valid;
 
+  // PDM2PCM
+  logic pdm2pcm_rx_valid;
+
+  // Cluster control of the extra harts
+  logic [31:0] cluster_boot_addr;
+  logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_fetch_enable;
+  logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_sw_irq;
+
   assign intr = {
     1'b0, irq_fast, 4'b0, irq_external, 3'b0, rv_timer_intr[0], 3'b0, irq_software, 3'b0
   };
@@ -450,7 +487,6 @@ module core_v_mini_mcu
   };
 
   cpu_subsystem #(
-      .BOOT_ADDR(BOOT_ADDR),
       .COREV_PULP(COREV_PULP),
       .FPU(FPU),
       .ZFINX(ZFINX),
@@ -461,10 +497,12 @@ module core_v_mini_mcu
       // Clock and Reset
       .clk_i,
       .rst_ni(cpu_subsystem_rst_n && debug_reset_n),
-      .core_instr_req_o(core_instr_req),
-      .core_instr_resp_i(core_instr_resp),
-      .core_data_req_o(core_data_req),
-      .core_data_resp_i(core_data_resp),
+      .boot_addr_i(BOOT_ADDR),
+      .fetch_enable_i(1'b1),
+      .core_instr_req_o(core_instr_cpu_req),
+      .core_instr_resp_i(core_instr_cpu_resp),
+      .core_data_req_o(core_data_cpu_req),
+      .core_data_resp_i(core_data_cpu_resp),
       .xif_compressed_if,
       .xif_issue_if,
       .xif_commit_if,
@@ -478,6 +516,34 @@ module core_v_mini_mcu
       .core_sleep_o(core_sleep)
   );
 
+  instr_buffer #(
+      .LINES(core_v_mini_mcu_pkg::INSTR_BUFFER_LINES),
+      .LINE_SIZE(core_v_mini_mcu_pkg::INSTR_BUFFER_LINE_SIZE)
+  ) instr_buffer_i (
+      .clk_i,
+      .rst_ni(rst_ni && debug_reset_n),
+      .core_req_i(core_instr_cpu_req),
+      .core_resp_o(core_instr_cpu_resp),
+      .bus_req_o(core_instr_req),
+      .bus_resp_i(core_instr_resp),
+      .enable_i(instr_buf_enable),
+      .prefetch_i(instr_buf_prefetch),
+      .clear_i(instr_buf_clear),
+      .hits_o(instr_buf_hits),
+      .misses_o(instr_buf_misses)
+  );
+
+  posted_write_buffer #(
+      .DEPTH(core_v_mini_mcu_pkg::POSTED_WRITE_BUFFER_DEPTH)
+  ) posted_write_buffer_i (
+      .clk_i,
+      .rst_ni(rst_ni && debug_reset_n),
+      .core_req_i(core_data_cpu_req),
+      .core_resp_o(core_data_cpu_resp),
+      .bus_req_o(core_data_req),
+      .bus_resp_i(core_data_resp)
+  );
+
   debug_subsystem #(
       .JTAG_IDCODE(JTAG_IDCODE)
   ) debug_subsystem_i (
@@ -537,7 +603,16 @@ module core_v_mini_mcu
       .ext_dma_write_ch0_req_o(ext_dma_write_ch0_req_o),
       .ext_dma_write_ch0_resp_i(ext_dma_write_ch0_resp_i),
       .ext_dma_addr_ch0_req_o(ext_dma_addr_ch0_req_o),
-      .ext_dma_addr_ch0_resp_i(ext_dma_addr_ch0_resp_i)
+      .ext_dma_addr_ch0_resp_i(ext_dma_addr_ch0_resp_i),
+      .bus_qos_override_i(bus_qos_override),
+      .bus_qos_window_i(bus_qos_window),
+      .bus_qos_priority_i(bus_qos_priority),
+      .bus_qos_budget_i(bus_qos_budget),
+      .dma_busy_i(dma_busy),
+      .perf_freeze_i(perf_freeze),
+      .perf_clear_i(perf_clear),
+      .perf_sel_i(perf_sel),
+      .perf_value_o(perf_value)
   );
 
   memory_subsystem #(
@@ -548,6 +623,10 @@ module core_v_mini_mcu
       .clk_gate_en_ni(memory_subsystem_clkgate_en_n),
       .ram_req_i(ram_slave_req),
       .ram_resp_o(ram_slave_resp),
+      .dma_wide_read_req_i(dma_wide_read_req),
+      .dma_wide_read_resp_o(dma_wide_read_resp),
+      .dma_wide_write_req_i(dma_wide_write_req),
+      .dma_wide_write_resp_o(dma_wide_write_resp),
       .set_retentive_ni(memory_subsystem_banks_set_retentive_n)
   );
 
@@ -560,6 +639,20 @@ module core_v_mini_mcu
       .execute_from_flash_i,
       .exit_valid_o,
       .exit_value_o,
+      .bus_qos_override_o(bus_qos_override),
+      .bus_qos_window_o(bus_qos_window),
+      .bus_qos_priority_o(bus_qos_priority),
+      .bus_qos_budget_o(bus_qos_budget),
+      .perf_freeze_o(perf_freeze),
+      .perf_clear_o(perf_clear),
+      .perf_sel_o(perf_sel),
+      .perf_value_i(perf_value),
+      .instr_buf_enable_o(instr_buf_enable),
+      .instr_buf_prefetch_o(instr_buf_prefetch),
+      .instr_buf_clear_o(instr_buf_clear),
+      .instr_buf_hits_i(instr_buf_hits),
+      .instr_buf_misses_i(instr_buf_misses),
+      .dma_busy_o(dma_busy),
       .spimemio_req_i(flash_mem_slave_req),
       .spimemio_resp_o(flash_mem_slave_resp),
       .spi_flash_sck_o,
@@ -602,6 +695,10 @@ module core_v_mini_mcu
       .dma_write_ch0_resp_i(dma_write_ch0_resp),
       .dma_addr_ch0_req_o(dma_addr_ch0_req),
       .dma_addr_ch0_resp_i(dma_addr_ch0_resp),
+      .dma_wide_read_req_o(dma_wide_read_req),
+      .dma_wide_read_resp_i(dma_wide_read_resp),
+      .dma_wide_write_req_o(dma_wide_write_req),
+      .dma_wide_write_resp_i(dma_wide_write_resp),
       .dma_done_intr_o(dma_done_intr),
       .dma_window_intr_o(dma_window_intr),
       .spi_flash_intr_event_o(spi_flash_intr),
@@ -626,10 +723,13 @@ module core_v_mini_mcu
       .spi_rx_valid_i(spi_rx_valid),
       .spi_tx_ready_i(spi_tx_ready),
       .i2s_rx_valid_i(i2s_rx_valid),
+      .pdm2pcm_rx_valid_i(pdm2pcm_rx_valid),
       .ext_peripheral_slave_req_o,
       .ext_peripheral_slave_resp_i,
       .ext_dma_slot_tx_i,
-      .ext_dma_slot_rx_i
+      .ext_dma_slot_rx_i,
+      .ext_dma_slot_acc_tx_i,
+      .ext_dma_slot_acc_rx_i
   );
 
   peripheral_subsystem peripheral_subsystem_i (
@@ -681,6 +781,7 @@ module core_v_mini_mcu
       .pdm2pcm_clk_o(pdm2pcm_clk_o),
       .pdm2pcm_clk_en_o(pdm2pcm_clk_oe_o),
       .pdm2pcm_pdm_i(pdm2pcm_pdm_i),
+      .pdm2pcm_rx_valid_o(pdm2pcm_rx_valid),
       .i2s_sck_o(i2s_sck_o),
       .i2s_sck_oe_o(i2s_sck_oe_o),
       .i2s_sck_i(i2s_sck_i),
@@ -690,7 +791,10 @@ module core_v_mini_mcu
       .i2s_sd_o(i2s_sd_o),
       .i2s_sd_oe_o(i2s_sd_oe_o),
       .i2s_sd_i(i2s_sd_i),
-      .i2s_rx_valid_o(i2s_rx_valid)
+      .i2s_rx_valid_o(i2s_rx_valid),
+      .cluster_boot_addr_o(cluster_boot_addr),
+      .cluster_fetch_enable_o(cluster_fetch_enable),
+      .cluster_sw_irq_o(cluster_sw_irq)
   );
 
   assign pdm2pcm_pdm_o    = 0;
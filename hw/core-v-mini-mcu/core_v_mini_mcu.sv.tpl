@@ -72,7 +72,9 @@ ${pad.core_v_mini_mcu_interface}
     output logic [31:0] exit_value_o,
 
     input logic ext_dma_slot_tx_i,
-    input logic ext_dma_slot_rx_i
+    input logic ext_dma_slot_rx_i,
+    input logic ext_dma_slot_acc_tx_i,
+    input logic ext_dma_slot_acc_rx_i
 );
 
   import core_v_mini_mcu_pkg::*;
@@ -106,6 +108,12 @@ ${pad.core_v_mini_mcu_interface}
   obi_req_t dma_addr_ch0_req;
   obi_resp_t dma_addr_ch0_resp;
 
+  // wide DMA ports into the interleaved banks
+  obi_wide_req_t dma_wide_read_req;
+  obi_wide_resp_t dma_wide_read_resp;
+  obi_wide_req_t dma_wide_write_req;
+  obi_wide_resp_t dma_wide_write_resp;
+
   // ram signals
   obi_req_t [core_v_mini_mcu_pkg::NUM_BANKS-1:0] ram_slave_req;
   obi_resp_t [core_v_mini_mcu_pkg::NUM_BANKS-1:0] ram_slave_resp;
@@ -124,6 +132,27 @@ ${pad.core_v_mini_mcu_interface}
   logic debug_core_req;
   logic debug_reset_n;
 
+  // Arbitration settings of the system bus
+  logic bus_qos_override;
+  logic [15:0] bus_qos_window;
+  logic [31:0] bus_qos_priority, bus_qos_budget;
+
+  // Performance counters of the system bus
+  logic dma_busy;
+  logic perf_freeze, perf_clear;
+  logic [7:0] perf_sel;
+  logic [31:0] perf_value;
+
+  // Instruction buffer of the main core
+  obi_req_t core_instr_cpu_req;
+  obi_resp_t core_instr_cpu_resp;
+  logic instr_buf_enable, instr_buf_prefetch, instr_buf_clear;
+  logic [31:0] instr_buf_hits, instr_buf_misses;
+
+  // Posted write buffer of the main core
+  obi_req_t core_data_cpu_req;
+  obi_resp_t core_data_cpu_resp;
+
   // core
   logic core_sleep;
 
@@ -188,6 +217,14 @@ ${pad.core_v_mini_mcu_interface}
   // I2s
   logic i2s_rx_valid;
 
+  // PDM2PCM
+  logic pdm2pcm_rx_valid;
+
+  // Cluster control of the extra harts
+  logic [31:0] cluster_boot_addr;
+  logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_fetch_enable;
+  logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_sw_irq;
+
   assign intr = {
     1'b0, irq_fast, 4'b0, irq_external, 3'b0, rv_timer_intr[0], 3'b0, irq_software, 3'b0
   };
@@ -204,7 +241,6 @@ ${pad.core_v_mini_mcu_interface}
   };
 
   cpu_subsystem #(
-      .BOOT_ADDR(BOOT_ADDR),
       .COREV_PULP(COREV_PULP),
       .FPU(FPU),
       .ZFINX(ZFINX),
@@ -215,10 +251,12 @@ ${pad.core_v_mini_mcu_interface}
       // Clock and Reset
       .clk_i,
       .rst_ni(cpu_subsystem_rst_n && debug_reset_n),
-      .core_instr_req_o(core_instr_req),
-      .core_instr_resp_i(core_instr_resp),
-      .core_data_req_o(core_data_req),
-      .core_data_resp_i(core_data_resp),
+      .boot_addr_i(BOOT_ADDR),
+      .fetch_enable_i(1'b1),
+      .core_instr_req_o(core_instr_cpu_req),
+      .core_instr_resp_i(core_instr_cpu_resp),
+      .core_data_req_o(core_data_cpu_req),
+      .core_data_resp_i(core_data_cpu_resp),
       .xif_compressed_if,
       .xif_issue_if,
       .xif_commit_if,
@@ -232,6 +270,79 @@ ${pad.core_v_mini_mcu_interface}
       .core_sleep_o(core_sleep)
   );
 
+  instr_buffer #(
+      .LINES(core_v_mini_mcu_pkg::INSTR_BUFFER_LINES),
+      .LINE_SIZE(core_v_mini_mcu_pkg::INSTR_BUFFER_LINE_SIZE)
+  ) instr_buffer_i (
+      .clk_i,
+      .rst_ni(rst_ni && debug_reset_n),
+      .core_req_i(core_instr_cpu_req),
+      .core_resp_o(core_instr_cpu_resp),
+      .bus_req_o(core_instr_req),
+      .bus_resp_i(core_instr_resp),
+      .enable_i(instr_buf_enable),
+      .prefetch_i(instr_buf_prefetch),
+      .clear_i(instr_buf_clear),
+      .hits_o(instr_buf_hits),
+      .misses_o(instr_buf_misses)
+  );
+
+  posted_write_buffer #(
+      .DEPTH(core_v_mini_mcu_pkg::POSTED_WRITE_BUFFER_DEPTH)
+  ) posted_write_buffer_i (
+      .clk_i,
+      .rst_ni(rst_ni && debug_reset_n),
+      .core_req_i(core_data_cpu_req),
+      .core_resp_o(core_data_cpu_resp),
+      .bus_req_o(core_data_req),
+      .bus_resp_i(core_data_resp)
+  );
+
+% if num_harts > 1:
+  // Extra harts of the cluster: no coprocessor and no debug, only the software
+  // interrupt of cluster_ctrl. They start at the boot address of cluster_ctrl
+  // once their fetch enable is set.
+  obi_req_t [${num_harts - 2}:0] hart_instr_req;
+  obi_resp_t [${num_harts - 2}:0] hart_instr_resp;
+  obi_req_t [${num_harts - 2}:0] hart_data_req;
+  obi_resp_t [${num_harts - 2}:0] hart_data_resp;
+
+  for (genvar h = 1; h < core_v_mini_mcu_pkg::NUM_HARTS; h++) begin : gen_hart
+    if_xif hart_xif ();
+
+    cpu_subsystem #(
+        .HART_ID(h),
+        .COREV_PULP(COREV_PULP),
+        .FPU(FPU),
+        .ZFINX(ZFINX),
+        .NUM_MHPMCOUNTERS(NUM_MHPMCOUNTERS),
+        .DM_HALTADDRESS(DM_HALTADDRESS),
+        .X_EXT(0)
+    ) cpu_subsystem_i (
+        .clk_i,
+        .rst_ni(cpu_subsystem_rst_n && debug_reset_n),
+        .boot_addr_i(cluster_boot_addr),
+        .fetch_enable_i(cluster_fetch_enable[h]),
+        .core_instr_req_o(hart_instr_req[h-1]),
+        .core_instr_resp_i(hart_instr_resp[h-1]),
+        .core_data_req_o(hart_data_req[h-1]),
+        .core_data_resp_i(hart_data_resp[h-1]),
+        .xif_compressed_if(hart_xif.cpu_compressed),
+        .xif_issue_if(hart_xif.cpu_issue),
+        .xif_commit_if(hart_xif.cpu_commit),
+        .xif_mem_if(hart_xif.cpu_mem),
+        .xif_mem_result_if(hart_xif.cpu_mem_result),
+        .xif_result_if(hart_xif.cpu_result),
+        .irq_i({28'b0, cluster_sw_irq[h], 3'b0}),
+        .irq_ack_o(),
+        .irq_id_o(),
+        .debug_req_i(1'b0),
+        .core_sleep_o()
+    );
+  end
+
+% endif
+
   debug_subsystem #(
       .JTAG_IDCODE(JTAG_IDCODE)
   ) debug_subsystem_i (
@@ -268,6 +379,12 @@ ${pad.core_v_mini_mcu_interface}
       .dma_write_ch0_resp_o(dma_write_ch0_resp),
       .dma_addr_ch0_req_i(dma_addr_ch0_req),
       .dma_addr_ch0_resp_o(dma_addr_ch0_resp),
+% if num_harts > 1:
+      .hart_instr_req_i(hart_instr_req),
+      .hart_instr_resp_o(hart_instr_resp),
+      .hart_data_req_i(hart_data_req),
+      .hart_data_resp_o(hart_data_resp),
+% endif
       .ext_xbar_master_req_i(ext_xbar_master_req_i),
       .ext_xbar_master_resp_o(ext_xbar_master_resp_o),
       .ram_req_o(ram_slave_req),
@@ -291,7 +408,16 @@ ${pad.core_v_mini_mcu_interface}
       .ext_dma_write_ch0_req_o(ext_dma_write_ch0_req_o),
       .ext_dma_write_ch0_resp_i(ext_dma_write_ch0_resp_i),
       .ext_dma_addr_ch0_req_o(ext_dma_addr_ch0_req_o),
-      .ext_dma_addr_ch0_resp_i(ext_dma_addr_ch0_resp_i)
+      .ext_dma_addr_ch0_resp_i(ext_dma_addr_ch0_resp_i),
+      .bus_qos_override_i(bus_qos_override),
+      .bus_qos_window_i(bus_qos_window),
+      .bus_qos_priority_i(bus_qos_priority),
+      .bus_qos_budget_i(bus_qos_budget),
+      .dma_busy_i(dma_busy),
+      .perf_freeze_i(perf_freeze),
+      .perf_clear_i(perf_clear),
+      .perf_sel_i(perf_sel),
+      .perf_value_o(perf_value)
   );
 
   memory_subsystem #(
@@ -302,6 +428,10 @@ ${pad.core_v_mini_mcu_interface}
       .clk_gate_en_ni(memory_subsystem_clkgate_en_n),
       .ram_req_i(ram_slave_req),
       .ram_resp_o(ram_slave_resp),
+      .dma_wide_read_req_i(dma_wide_read_req),
+      .dma_wide_read_resp_o(dma_wide_read_resp),
+      .dma_wide_write_req_i(dma_wide_write_req),
+      .dma_wide_write_resp_o(dma_wide_write_resp),
       .set_retentive_ni(memory_subsystem_banks_set_retentive_n)
   );
 
@@ -314,6 +444,20 @@ ${pad.core_v_mini_mcu_interface}
       .execute_from_flash_i,
       .exit_valid_o,
       .exit_value_o,
+      .bus_qos_override_o(bus_qos_override),
+      .bus_qos_window_o(bus_qos_window),
+      .bus_qos_priority_o(bus_qos_priority),
+      .bus_qos_budget_o(bus_qos_budget),
+      .perf_freeze_o(perf_freeze),
+      .perf_clear_o(perf_clear),
+      .perf_sel_o(perf_sel),
+      .perf_value_i(perf_value),
+      .instr_buf_enable_o(instr_buf_enable),
+      .instr_buf_prefetch_o(instr_buf_prefetch),
+      .instr_buf_clear_o(instr_buf_clear),
+      .instr_buf_hits_i(instr_buf_hits),
+      .instr_buf_misses_i(instr_buf_misses),
+      .dma_busy_o(dma_busy),
       .spimemio_req_i(flash_mem_slave_req),
       .spimemio_resp_o(flash_mem_slave_resp),
       .spi_flash_sck_o,
@@ -354,6 +498,10 @@ ${pad.core_v_mini_mcu_interface}
       .dma_write_ch0_resp_i(dma_write_ch0_resp),
       .dma_addr_ch0_req_o(dma_addr_ch0_req),
       .dma_addr_ch0_resp_i(dma_addr_ch0_resp),
+      .dma_wide_read_req_o(dma_wide_read_req),
+      .dma_wide_read_resp_i(dma_wide_read_resp),
+      .dma_wide_write_req_o(dma_wide_write_req),
+      .dma_wide_write_resp_i(dma_wide_write_resp),
       .dma_done_intr_o(dma_done_intr),
       .dma_window_intr_o(dma_window_intr),
       .spi_flash_intr_event_o(spi_flash_intr),
@@ -378,10 +526,13 @@ ${pad.core_v_mini_mcu_interface}
       .spi_rx_valid_i(spi_rx_valid),
       .spi_tx_ready_i(spi_tx_ready),
       .i2s_rx_valid_i(i2s_rx_valid),
+      .pdm2pcm_rx_valid_i(pdm2pcm_rx_valid),
       .ext_peripheral_slave_req_o,
       .ext_peripheral_slave_resp_i,
       .ext_dma_slot_tx_i,
-      .ext_dma_slot_rx_i
+      .ext_dma_slot_rx_i,
+      .ext_dma_slot_acc_tx_i,
+      .ext_dma_slot_acc_rx_i
   );
 
   peripheral_subsystem peripheral_subsystem_i (
@@ -433,6 +584,7 @@ ${pad.core_v_mini_mcu_interface}
       .pdm2pcm_clk_o(pdm2pcm_clk_o),
       .pdm2pcm_clk_en_o(pdm2pcm_clk_oe_o),
       .pdm2pcm_pdm_i(pdm2pcm_pdm_i),
+      .pdm2pcm_rx_valid_o(pdm2pcm_rx_valid),
       .i2s_sck_o(i2s_sck_o),
       .i2s_sck_oe_o(i2s_sck_oe_o),
       .i2s_sck_i(i2s_sck_i),
@@ -442,7 +594,10 @@ ${pad.core_v_mini_mcu_interface}
       .i2s_sd_o(i2s_sd_o),
       .i2s_sd_oe_o(i2s_sd_oe_o),
       .i2s_sd_i(i2s_sd_i),
-      .i2s_rx_valid_o(i2s_rx_valid)
+      .i2s_rx_valid_o(i2s_rx_valid),
+      .cluster_boot_addr_o(cluster_boot_addr),
+      .cluster_fetch_enable_o(cluster_fetch_enable),
+      .cluster_sw_irq_o(cluster_sw_irq)
   );
 
   assign pdm2pcm_pdm_o = 0;
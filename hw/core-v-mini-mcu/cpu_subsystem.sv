@@ -6,7 +6,7 @@ module cpu_subsystem
   import obi_pkg::*;
   import core_v_mini_mcu_pkg::*;
 #(
-    parameter BOOT_ADDR = 'h180,
+    parameter HART_ID = 0,  // mhartid, 0 for the main core
     parameter COREV_PULP =  0, // PULP ISA Extension (incl. custom CSRs and hardware loop, excl. p.elw)
     parameter FPU = 0,  // Floating Point Unit (interfaced via APU interface)
     parameter ZFINX = 0,  // Float-in-General Purpose registers
@@ -19,6 +19,10 @@ module cpu_subsystem
     input logic clk_i,
     input logic rst_ni,
 
+    // Boot address and fetch enable, from cluster_ctrl for the extra harts
+    input logic [31:0] boot_addr_i,
+    input logic        fetch_enable_i,
+
     // Instruction memory interface
     output obi_req_t  core_instr_req_o,
     input  obi_resp_t core_instr_resp_i,
@@ -47,12 +51,6 @@ module cpu_subsystem
     output logic core_sleep_o
 );
 
-
-  // CPU Control Signals
-  logic fetch_enable;
-
-  assign fetch_enable = 1'b1;
-
   assign core_instr_req_o.wdata = '0;
   assign core_instr_req_o.we    = '0;
   assign core_instr_req_o.be    = 4'b1111;
@@ -69,8 +67,8 @@ module cpu_subsystem
         .test_en_i(1'b0),
         .ram_cfg_i('0),
 
-        .hart_id_i  (32'h0),
-        .boot_addr_i(BOOT_ADDR),
+        .hart_id_i  (32'(HART_ID)),
+        .boot_addr_i(boot_addr_i),
 
         .instr_addr_o  (core_instr_req_o.addr),
         .instr_req_o   (core_instr_req_o.req),
@@ -98,7 +96,7 @@ module cpu_subsystem
         .debug_req_i (debug_req_i),
         .crash_dump_o(),
 
-        .fetch_enable_i(fetch_enable),
+        .fetch_enable_i(fetch_enable_i),
 
         .core_sleep_o
     );
@@ -120,10 +118,10 @@ module cpu_subsystem
         .scan_cg_en_i(1'b0),
 
         // Static configuration
-        .boot_addr_i(BOOT_ADDR),
+        .boot_addr_i(boot_addr_i),
         .dm_exception_addr_i(32'h0),
         .dm_halt_addr_i(DM_HALTADDRESS),
-        .mhartid_i(32'h0),
+        .mhartid_i(32'(HART_ID)),
         .mimpid_patch_i(4'h0),
         .mtvec_addr_i(32'h0),
 
@@ -194,7 +192,7 @@ module cpu_subsystem
         .debug_pc_o       (),
 
         // CPU control signals
-        .fetch_enable_i(fetch_enable),
+        .fetch_enable_i(fetch_enable_i),
         .core_sleep_o
     );
 
@@ -220,10 +218,10 @@ module cpu_subsystem
         .pulp_clock_en_i(1'b1),
         .scan_cg_en_i   (1'b0),
 
-        .boot_addr_i        (BOOT_ADDR),
+        .boot_addr_i        (boot_addr_i),
         .mtvec_addr_i       (32'h0),
         .dm_halt_addr_i     (DM_HALTADDRESS),
-        .hart_id_i          (32'h0),
+        .hart_id_i          (32'(HART_ID)),
         .dm_exception_addr_i(32'h0),
 
         .instr_addr_o  (core_instr_req_o.addr),
@@ -282,7 +280,7 @@ module cpu_subsystem
         .debug_running_o  (),
         .debug_halted_o   (),
 
-        .fetch_enable_i(fetch_enable),
+        .fetch_enable_i(fetch_enable_i),
         .core_sleep_o
 
     );
@@ -303,10 +301,10 @@ module cpu_subsystem
         .pulp_clock_en_i(1'b1),
         .scan_cg_en_i   (1'b0),
 
-        .boot_addr_i        (BOOT_ADDR),
+        .boot_addr_i        (boot_addr_i),
         .mtvec_addr_i       (32'h0),
         .dm_halt_addr_i     (DM_HALTADDRESS),
-        .hart_id_i          (32'h0),
+        .hart_id_i          (32'(HART_ID)),
         .dm_exception_addr_i(32'h0),
 
         .instr_addr_o  (core_instr_req_o.addr),
@@ -333,7 +331,7 @@ module cpu_subsystem
         .debug_running_o  (),
         .debug_halted_o   (),
 
-        .fetch_enable_i(fetch_enable),
+        .fetch_enable_i(fetch_enable_i),
         .core_sleep_o
     );
 
@@ -0,0 +1,229 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+/* DMA_CH_NUM independent DMA channels.
+ * Each channel has its own register block of DMA_CH_SIZE bytes in the DMA address range,
+ * and the channels share the read, write and address master ports of the system bus
+ * through round-robin crossbars, so their transactions overlap.
+ * The wide ports into the interleaved banks go to the lowest channel requesting them.
+ * The transaction done and window interrupts are the OR of the ones of the channels.
+ */
+
+module dma_subsystem #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter type obi_req_t = logic,
+    parameter type obi_resp_t = logic,
+    parameter type obi_wide_req_t = obi_req_t,
+    parameter type obi_wide_resp_t = obi_resp_t,
+    parameter int unsigned SLOT_NUM = 0,
+    parameter int unsigned WIDE_LANES = 1,
+    parameter int unsigned DMA_CH_NUM = 1,
+    parameter int unsigned DMA_CH_SIZE = 32'h100
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    output obi_req_t  dma_read_ch0_req_o,
+    input  obi_resp_t dma_read_ch0_resp_i,
+
+    output obi_req_t  dma_write_ch0_req_o,
+    input  obi_resp_t dma_write_ch0_resp_i,
+
+    output obi_req_t  dma_addr_ch0_req_o,
+    input  obi_resp_t dma_addr_ch0_resp_i,
+
+    output obi_wide_req_t  dma_wide_read_req_o,
+    input  obi_wide_resp_t dma_wide_read_resp_i,
+
+    output obi_wide_req_t  dma_wide_write_req_o,
+    input  obi_wide_resp_t dma_wide_write_resp_i,
+
+    input logic [SLOT_NUM-1:0] trigger_slot_i,
+
+    output logic dma_done_intr_o,
+    output logic dma_window_intr_o,
+
+    // A channel is busy, for the performance counters
+    output logic dma_busy_o
+);
+
+  localparam int unsigned ChSelWidth = DMA_CH_NUM > 1 ? $clog2(DMA_CH_NUM) : 32'd1;
+  localparam int unsigned ChAddrWidth = $clog2(DMA_CH_SIZE);
+
+  logic      [ChSelWidth-1:0] ch_sel;
+
+  reg_req_t  [DMA_CH_NUM-1:0] ch_reg_req;
+  reg_rsp_t  [DMA_CH_NUM-1:0] ch_reg_rsp;
+
+  obi_req_t  [DMA_CH_NUM-1:0] ch_read_req;
+  obi_resp_t [DMA_CH_NUM-1:0] ch_read_resp;
+  obi_req_t  [DMA_CH_NUM-1:0] ch_write_req;
+  obi_resp_t [DMA_CH_NUM-1:0] ch_write_resp;
+  obi_req_t  [DMA_CH_NUM-1:0] ch_addr_req;
+  obi_resp_t [DMA_CH_NUM-1:0] ch_addr_resp;
+
+  obi_wide_req_t  [DMA_CH_NUM-1:0] ch_wide_read_req;
+  obi_wide_resp_t [DMA_CH_NUM-1:0] ch_wide_read_resp;
+  obi_wide_req_t  [DMA_CH_NUM-1:0] ch_wide_write_req;
+  obi_wide_resp_t [DMA_CH_NUM-1:0] ch_wide_write_resp;
+
+  logic      [DMA_CH_NUM-1:0] ch_done_intr;
+  logic      [DMA_CH_NUM-1:0] ch_window_intr;
+  logic      [DMA_CH_NUM-1:0] ch_busy;
+
+  // The channel is selected by the address bits above its register block
+  generate
+    if (DMA_CH_NUM > 1) begin : gen_ch_sel
+      assign ch_sel = reg_req_i.addr[ChAddrWidth+:ChSelWidth];
+    end else begin : gen_ch_sel_single
+      assign ch_sel = '0;
+    end
+  endgenerate
+
+  reg_demux #(
+      .NoPorts(DMA_CH_NUM),
+      .req_t  (reg_req_t),
+      .rsp_t  (reg_rsp_t)
+  ) dma_reg_demux_i (
+      .clk_i,
+      .rst_ni,
+      .in_select_i(ch_sel),
+      .in_req_i(reg_req_i),
+      .in_rsp_o(reg_rsp_o),
+      .out_req_o(ch_reg_req),
+      .out_rsp_i(ch_reg_rsp)
+  );
+
+  generate
+    for (genvar i = 0; i < DMA_CH_NUM; i++) begin : gen_dma_ch
+      dma #(
+          .reg_req_t (reg_req_t),
+          .reg_rsp_t (reg_rsp_t),
+          .obi_req_t (obi_req_t),
+          .obi_resp_t(obi_resp_t),
+          .obi_wide_req_t(obi_wide_req_t),
+          .obi_wide_resp_t(obi_wide_resp_t),
+          .SLOT_NUM  (SLOT_NUM),
+          .WIDE_LANES(WIDE_LANES)
+      ) dma_i (
+          .clk_i,
+          .rst_ni,
+          .reg_req_i(ch_reg_req[i]),
+          .reg_rsp_o(ch_reg_rsp[i]),
+          .dma_read_ch0_req_o(ch_read_req[i]),
+          .dma_read_ch0_resp_i(ch_read_resp[i]),
+          .dma_write_ch0_req_o(ch_write_req[i]),
+          .dma_write_ch0_resp_i(ch_write_resp[i]),
+          .dma_addr_ch0_req_o(ch_addr_req[i]),
+          .dma_addr_ch0_resp_i(ch_addr_resp[i]),
+          .dma_wide_read_req_o(ch_wide_read_req[i]),
+          .dma_wide_read_resp_i(ch_wide_read_resp[i]),
+          .dma_wide_write_req_o(ch_wide_write_req[i]),
+          .dma_wide_write_resp_i(ch_wide_write_resp[i]),
+          .trigger_slot_i,
+          .dma_done_intr_o(ch_done_intr[i]),
+          .dma_window_intr_o(ch_window_intr[i]),
+          .dma_busy_o(ch_busy[i])
+      );
+    end
+  endgenerate
+
+  generate
+    if (DMA_CH_NUM > 1) begin : gen_ch_xbar
+      xbar_varlat_n_to_one #(
+          .XBAR_NMASTER(DMA_CH_NUM)
+      ) dma_read_xbar_i (
+          .clk_i,
+          .rst_ni,
+          .master_req_i (ch_read_req),
+          .master_resp_o(ch_read_resp),
+          .slave_req_o  (dma_read_ch0_req_o),
+          .slave_resp_i (dma_read_ch0_resp_i)
+      );
+
+      xbar_varlat_n_to_one #(
+          .XBAR_NMASTER(DMA_CH_NUM)
+      ) dma_write_xbar_i (
+          .clk_i,
+          .rst_ni,
+          .master_req_i (ch_write_req),
+          .master_resp_o(ch_write_resp),
+          .slave_req_o  (dma_write_ch0_req_o),
+          .slave_resp_i (dma_write_ch0_resp_i)
+      );
+
+      xbar_varlat_n_to_one #(
+          .XBAR_NMASTER(DMA_CH_NUM)
+      ) dma_addr_xbar_i (
+          .clk_i,
+          .rst_ni,
+          .master_req_i (ch_addr_req),
+          .master_resp_o(ch_addr_resp),
+          .slave_req_o  (dma_addr_ch0_req_o),
+          .slave_resp_i (dma_addr_ch0_resp_i)
+      );
+    end else begin : gen_ch_single
+      assign dma_read_ch0_req_o = ch_read_req[0];
+      assign ch_read_resp[0] = dma_read_ch0_resp_i;
+      assign dma_write_ch0_req_o = ch_write_req[0];
+      assign ch_write_resp[0] = dma_write_ch0_resp_i;
+      assign dma_addr_ch0_req_o = ch_addr_req[0];
+      assign ch_addr_resp[0] = dma_addr_ch0_resp_i;
+    end
+  endgenerate
+
+  // The memory answers the wide ports in the cycle after the grant, to the
+  // channel granted then
+  generate
+    if (DMA_CH_NUM > 1) begin : gen_wide_arb
+      logic [ChSelWidth-1:0] wide_read_sel, wide_read_sel_q;
+      logic [ChSelWidth-1:0] wide_write_sel, wide_write_sel_q;
+
+      always_comb begin
+        wide_read_sel  = '0;
+        wide_write_sel = '0;
+        for (int i = DMA_CH_NUM - 1; i >= 0; i--) begin
+          if (ch_wide_read_req[i].req) wide_read_sel = i[ChSelWidth-1:0];
+          if (ch_wide_write_req[i].req) wide_write_sel = i[ChSelWidth-1:0];
+        end
+      end
+
+      always_ff @(posedge clk_i or negedge rst_ni) begin
+        if (~rst_ni) begin
+          wide_read_sel_q  <= '0;
+          wide_write_sel_q <= '0;
+        end else begin
+          if (dma_wide_read_resp_i.gnt) wide_read_sel_q <= wide_read_sel;
+          if (dma_wide_write_resp_i.gnt) wide_write_sel_q <= wide_write_sel;
+        end
+      end
+
+      assign dma_wide_read_req_o  = ch_wide_read_req[wide_read_sel];
+      assign dma_wide_write_req_o = ch_wide_write_req[wide_write_sel];
+
+      for (genvar i = 0; i < DMA_CH_NUM; i++) begin : gen_wide_resp
+        assign ch_wide_read_resp[i].gnt = dma_wide_read_resp_i.gnt && wide_read_sel == i;
+        assign ch_wide_read_resp[i].rvalid = dma_wide_read_resp_i.rvalid && wide_read_sel_q == i;
+        assign ch_wide_read_resp[i].rdata = dma_wide_read_resp_i.rdata;
+        assign ch_wide_write_resp[i].gnt = dma_wide_write_resp_i.gnt && wide_write_sel == i;
+        assign ch_wide_write_resp[i].rvalid = dma_wide_write_resp_i.rvalid && wide_write_sel_q == i;
+        assign ch_wide_write_resp[i].rdata = dma_wide_write_resp_i.rdata;
+      end
+    end else begin : gen_wide_single
+      assign dma_wide_read_req_o = ch_wide_read_req[0];
+      assign ch_wide_read_resp[0] = dma_wide_read_resp_i;
+      assign dma_wide_write_req_o = ch_wide_write_req[0];
+      assign ch_wide_write_resp[0] = dma_wide_write_resp_i;
+    end
+  endgenerate
+
+  assign dma_done_intr_o   = |ch_done_intr;
+  assign dma_window_intr_o = |ch_window_intr;
+  assign dma_busy_o        = |ch_busy;
+
+endmodule
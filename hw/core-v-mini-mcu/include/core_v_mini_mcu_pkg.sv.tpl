@@ -26,6 +26,20 @@ package core_v_mini_mcu_pkg;
 
   localparam cpu_type_e CpuType = ${cpu_type};
 
+  typedef enum logic [1:0] {
+    XifNone,
+    XifFpuSs,
+    XifMac
+  } xif_coprocessor_e;
+
+% if xif_coprocessor == "xif_mac":
+  localparam xif_coprocessor_e XifCoprocessor = XifMac;
+% elif xif_coprocessor == "fpu_ss":
+  localparam xif_coprocessor_e XifCoprocessor = XifFpuSs;
+% else:
+  localparam xif_coprocessor_e XifCoprocessor = XifNone;
+% endif
+
   typedef enum logic {
     NtoM,
     onetoM
@@ -40,8 +54,15 @@ package core_v_mini_mcu_pkg;
   localparam logic [31:0] DMA_READ_CH0_IDX = 3;
   localparam logic [31:0] DMA_WRITE_CH0_IDX = 4;
   localparam logic [31:0] DMA_ADDR_CH0_IDX = 5;
+% for h in range(1, num_harts):
+  localparam logic [31:0] HART${h}_INSTR_IDX = ${4 + 2*h};
+  localparam logic [31:0] HART${h}_DATA_IDX = ${5 + 2*h};
+% endfor
 
-  localparam SYSTEM_XBAR_NMASTER = 6;
+  // Harts of the cluster, hart 0 being the main core
+  localparam int unsigned NUM_HARTS = ${num_harts};
+
+  localparam SYSTEM_XBAR_NMASTER = ${6 + 2*(num_harts - 1)};
 
   // Internal slave memory map and index
   // -----------------------------------
@@ -85,11 +106,13 @@ package core_v_mini_mcu_pkg;
   localparam logic[31:0] AO_PERIPHERAL_SIZE = 32'h${ao_peripheral_size_address};
   localparam logic[31:0] AO_PERIPHERAL_END_ADDRESS = AO_PERIPHERAL_START_ADDRESS + AO_PERIPHERAL_SIZE;
   localparam logic[31:0] AO_PERIPHERAL_IDX = 32'd${xheep.ram_numbanks() + 2};
+  localparam int unsigned AO_PERIPHERAL_OUTSTANDING = ${ao_peripheral_outstanding};
 
   localparam logic[31:0] PERIPHERAL_START_ADDRESS = 32'h${peripheral_start_address};
   localparam logic[31:0] PERIPHERAL_SIZE = 32'h${peripheral_size_address};
   localparam logic[31:0] PERIPHERAL_END_ADDRESS = PERIPHERAL_START_ADDRESS + PERIPHERAL_SIZE;
   localparam logic[31:0] PERIPHERAL_IDX = 32'd${xheep.ram_numbanks() + 3};
+  localparam int unsigned PERIPHERAL_OUTSTANDING = ${peripheral_outstanding};
 
   localparam logic[31:0] FLASH_MEM_START_ADDRESS = 32'h${flash_mem_start_address};
   localparam logic[31:0] FLASH_MEM_SIZE = 32'h${flash_mem_size_address};
@@ -151,6 +174,67 @@ package core_v_mini_mcu_pkg;
 % endfor
   };
 
+  // DMA channels, each one with a register block of DMA_CH_SIZE bytes
+  localparam int unsigned DMA_CH_NUM = ${dma_ch_count};
+  localparam int unsigned DMA_CH_SIZE = 32'h${dma_ch_size};
+
+  // Request lines of the DMA: the signals of ao_peripheral_subsystem, and the
+  // one of each trigger slot
+  localparam int unsigned DMA_TRIG_SRC_NUM = ${len(dma_trigger_sources)};
+% for src in dma_trigger_sources:
+  localparam int unsigned DMA_TRIG_SRC_${src.upper()} = ${loop.index};
+% endfor
+  localparam int unsigned DMA_TRIGGER_SLOT_NUM = ${len(dma_trigger_slots)};
+  localparam int unsigned DMA_TRIGGER_SLOT_SRC[DMA_TRIGGER_SLOT_NUM] = '{
+% for slot in dma_trigger_slots:
+      DMA_TRIG_SRC_${slot.upper()}${"," if not loop.last else ""}
+% endfor
+  };
+
+  // Wide port of the DMA into the first interleaved group, DMA_WIDE_LANES
+  // words per transfer on as many banks, see memory_subsystem. It is unused
+  // with one lane.
+  localparam int unsigned DMA_WIDE_LANES = ${dma_wide_lanes};
+% if dma_wide_lanes > 1:
+  localparam logic [31:0] DMA_WIDE_START_ADDRESS = 32'h${f'{dma_wide_group.start:08X}'};
+  localparam logic [31:0] DMA_WIDE_END_ADDRESS = 32'h${f'{dma_wide_group.start + dma_wide_group.size:08X}'};
+% else:
+  localparam logic [31:0] DMA_WIDE_START_ADDRESS = 32'h00000000;
+  localparam logic [31:0] DMA_WIDE_END_ADDRESS = 32'h00000000;
+% endif
+
+  typedef struct packed {
+    logic                        req;
+    logic                        we;
+    logic [4*DMA_WIDE_LANES-1:0]  be;
+    logic [31:0]                 addr;
+    logic [32*DMA_WIDE_LANES-1:0] wdata;
+  } obi_wide_req_t;
+
+  typedef struct packed {
+    logic                        gnt;
+    logic                        rvalid;
+    logic [32*DMA_WIDE_LANES-1:0] rdata;
+  } obi_wide_resp_t;
+
+  // Read cache of the memory-mapped flash, disabled when FLASH_CACHE_SIZE is 0
+  localparam int unsigned FLASH_CACHE_SIZE = 32'h${flash_cache_size};
+  localparam int unsigned FLASH_CACHE_LINE_SIZE = 32'h${flash_cache_line_size};
+
+  // Instruction buffer of the main core, removed when INSTR_BUFFER_LINES is 0
+  localparam int unsigned INSTR_BUFFER_LINES = ${instr_buffer_lines};
+  localparam int unsigned INSTR_BUFFER_LINE_SIZE = 32'h${instr_buffer_line_size};
+
+  // Posted write buffer of the main core towards the peripherals, removed when
+  // POSTED_WRITE_BUFFER_DEPTH is 0
+  localparam int unsigned POSTED_WRITE_BUFFER_DEPTH = ${posted_write_buffer_depth};
+
+  // Arbitration of the system crossbar: 2 priority bits and 4 budget bits per
+  // master, in the order of the master indices, see xbar_qos
+  localparam logic [31:0] BUS_QOS_PRIORITY = 32'h${bus_qos_priority};
+  localparam logic [31:0] BUS_QOS_BUDGET = 32'h${bus_qos_budget};
+  localparam logic [15:0] BUS_QOS_WINDOW = 16'd${bus_qos_window};
+
   localparam int unsigned AO_PERIPHERALS_PORT_SEL_WIDTH = AO_PERIPHERALS > 1 ? $clog2(AO_PERIPHERALS) : 32'd1;
 
 ######################################################################
@@ -0,0 +1,292 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Instruction buffer between the instruction port of the main core and the
+// system bus. It holds LINES lines of LINE_SIZE bytes, fully associative and
+// replaced in turn. A fetch that misses fills its whole line with consecutive
+// word reads, and is served as soon as its word arrives. With prefetch_i, the
+// line after the last one fetched is filled ahead of the core. A loop that fits
+// in the lines (one less with the prefetch) runs without any access to the bus,
+// at one fetch per cycle whatever the DMA does in the RAM banks.
+//
+// With enable_i low the fetches go straight to the bus. The buffer does not see
+// the writes to the code: a rising edge of clear_i, or enabling it again, drops
+// all the lines. clear_i also holds the counters at 0. With LINES = 0 the buffer
+// is removed.
+
+module instr_buffer
+  import obi_pkg::*;
+#(
+    parameter int unsigned LINES     = 4,
+    parameter int unsigned LINE_SIZE = 16  // Bytes
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  obi_req_t  core_req_i,
+    output obi_resp_t core_resp_o,
+
+    output obi_req_t  bus_req_o,
+    input  obi_resp_t bus_resp_i,
+
+    input logic enable_i,
+    input logic prefetch_i,
+    input logic clear_i,
+
+    // Fetches served from the lines, and line fills for a fetch
+    output logic [31:0] hits_o,
+    output logic [31:0] misses_o
+);
+
+  if (LINES == 0) begin : gen_no_buffer
+
+    assign bus_req_o   = core_req_i;
+    assign core_resp_o = bus_resp_i;
+    assign hits_o      = '0;
+    assign misses_o    = '0;
+
+    logic unused_ctrl;
+    assign unused_ctrl = enable_i ^ prefetch_i ^ clear_i;
+
+  end else begin : gen_buffer
+
+    localparam int unsigned WORDS = LINE_SIZE / 4;
+    localparam int unsigned OFFSET_W = $clog2(LINE_SIZE);
+    localparam int unsigned WORD_W = WORDS > 1 ? $clog2(WORDS) : 1;
+    localparam int unsigned IDX_W = LINES > 1 ? $clog2(LINES) : 1;
+    localparam int unsigned TAG_W = 32 - OFFSET_W;
+
+    logic [31:0] data_q[LINES][WORDS];
+    logic [TAG_W-1:0] tag_q[LINES];
+    logic [LINES-1:0] valid_q;
+
+    enum logic {
+      IDLE,
+      FILL
+    }
+        state_q, state_d;
+
+    // Fetches go through the buffer, changed once no access is in flight
+    logic buffered_q, buffered_d;
+    logic [1:0] outstanding_q;
+    logic clear_q;
+    logic invalidate;
+
+    // Line being filled and its words received so far
+    logic [IDX_W-1:0] fill_idx_q, fill_idx_d;
+    logic [WORDS-1:0] fill_words_q;
+    logic [WORD_W-1:0] issue_cnt_q, recv_cnt_q;
+    logic issue_done_q;
+    // Set when the lines are dropped during a fill: the line is not validated
+    logic fill_stale_q;
+    logic [IDX_W-1:0] next_victim_q;
+
+    // Line of the last fetch, the target of the prefetch
+    logic [TAG_W-1:0] last_tag_q;
+    logic last_valid_q;
+
+    logic rvalid_q;
+    logic [31:0] rdata_q;
+    logic [31:0] hits_q, misses_q;
+    // Set from the start of a fill for a fetch until the fetch is served
+    logic demand_q;
+
+    logic [TAG_W-1:0] tag, next_tag;
+    logic [WORD_W-1:0] word;
+    logic [LINES-1:0] line_hit;
+    logic [IDX_W-1:0] hit_idx, victim;
+    logic fill_hit, hit, next_present, start_demand, start_prefetch;
+    logic core_gnt, switching;
+
+    assign tag = core_req_i.addr[31:OFFSET_W];
+    assign next_tag = last_tag_q + TAG_W'(1);
+    if (WORDS > 1) begin : gen_word
+      assign word = core_req_i.addr[2+:WORD_W];
+    end else begin : gen_single_word
+      assign word = '0;
+    end
+
+    assign invalidate = (clear_i && !clear_q) || (buffered_d && !buffered_q);
+    assign switching = enable_i != buffered_q;
+
+    always_comb begin
+      hit_idx = '0;
+      next_present = state_q == FILL && tag_q[fill_idx_q] == next_tag;
+      victim = next_victim_q;
+      for (int unsigned i = 0; i < LINES; i++) begin
+        line_hit[i] = valid_q[i] && tag_q[i] == tag;
+        if (line_hit[i]) begin
+          hit_idx = IDX_W'(i);
+        end
+        if (valid_q[i] && tag_q[i] == next_tag) begin
+          next_present = 1'b1;
+        end
+      end
+      // Free lines first
+      for (int i = LINES - 1; i >= 0; i--) begin
+        if (!valid_q[i]) begin
+          victim = IDX_W'(i);
+        end
+      end
+    end
+
+    assign fill_hit = state_q == FILL && !fill_stale_q && tag_q[fill_idx_q] == tag &&
+                      fill_words_q[word];
+    assign hit = (|line_hit || fill_hit) && !invalidate;
+    assign core_gnt = buffered_q && !switching && core_req_i.req && hit;
+
+    assign start_demand = buffered_q && !switching && state_q == IDLE && core_req_i.req &&
+                          !hit && !invalidate;
+    assign start_prefetch = buffered_q && !switching && state_q == IDLE && !start_demand &&
+                            prefetch_i && last_valid_q && !next_present && !invalidate;
+
+    always_comb begin
+      state_d    = state_q;
+      fill_idx_d = fill_idx_q;
+      buffered_d = buffered_q;
+
+      if (!buffered_q) begin
+        bus_req_o   = core_req_i;
+        core_resp_o = bus_resp_i;
+        if (switching) begin
+          bus_req_o.req   = 1'b0;
+          core_resp_o.gnt = 1'b0;
+          if (outstanding_q == '0) begin
+            buffered_d = 1'b1;
+          end
+        end
+      end else begin
+        bus_req_o          = '0;
+        bus_req_o.be       = 4'b1111;
+        bus_req_o.req      = state_q == FILL && !issue_done_q;
+        bus_req_o.addr     = {tag_q[fill_idx_q], OFFSET_W'(0)};
+        if (WORDS > 1) begin
+          bus_req_o.addr[2+:WORD_W] = issue_cnt_q;
+        end
+
+        core_resp_o.gnt    = core_gnt;
+        core_resp_o.rvalid = rvalid_q;
+        core_resp_o.rdata  = rdata_q;
+
+        if (switching && state_q == IDLE && !rvalid_q) begin
+          buffered_d = 1'b0;
+        end
+      end
+
+      case (state_q)
+        IDLE: begin
+          if (start_demand || start_prefetch) begin
+            state_d    = FILL;
+            fill_idx_d = victim;
+          end
+        end
+
+        FILL: begin
+          if (bus_resp_i.rvalid && recv_cnt_q == WORD_W'(WORDS - 1)) begin
+            state_d = IDLE;
+          end
+        end
+
+        default: state_d = IDLE;
+      endcase
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        state_q       <= IDLE;
+        buffered_q    <= 1'b0;
+        outstanding_q <= '0;
+        clear_q       <= 1'b0;
+        valid_q       <= '0;
+        fill_idx_q    <= '0;
+        fill_words_q  <= '0;
+        issue_cnt_q   <= '0;
+        recv_cnt_q    <= '0;
+        issue_done_q  <= 1'b0;
+        fill_stale_q  <= 1'b0;
+        next_victim_q <= '0;
+        last_tag_q    <= '0;
+        last_valid_q  <= 1'b0;
+        rvalid_q      <= 1'b0;
+        rdata_q       <= '0;
+        demand_q      <= 1'b0;
+        hits_q        <= '0;
+        misses_q      <= '0;
+      end else begin
+        state_q    <= state_d;
+        buffered_q <= buffered_d;
+        fill_idx_q <= fill_idx_d;
+        clear_q    <= clear_i;
+
+        outstanding_q <= outstanding_q + 2'(bus_req_o.req && bus_resp_i.gnt) - 2'(bus_resp_i.rvalid);
+
+        if (state_q == IDLE && state_d == FILL) begin
+          valid_q[victim] <= 1'b0;
+          tag_q[victim]   <= start_demand ? tag : next_tag;
+          fill_words_q    <= '0;
+          issue_cnt_q     <= '0;
+          recv_cnt_q      <= '0;
+          issue_done_q    <= 1'b0;
+          fill_stale_q    <= 1'b0;
+          next_victim_q   <= victim == IDX_W'(LINES - 1) ? '0 : victim + IDX_W'(1);
+        end else if (state_q == FILL) begin
+          if (bus_req_o.req && bus_resp_i.gnt) begin
+            issue_cnt_q <= issue_cnt_q + WORD_W'(1);
+            if (issue_cnt_q == WORD_W'(WORDS - 1)) begin
+              issue_done_q <= 1'b1;
+            end
+          end
+          if (bus_resp_i.rvalid) begin
+            recv_cnt_q               <= recv_cnt_q + WORD_W'(1);
+            fill_words_q[recv_cnt_q] <= 1'b1;
+            if (state_d == IDLE) begin
+              valid_q[fill_idx_q] <= !(fill_stale_q || invalidate);
+            end
+          end
+          if (invalidate) begin
+            fill_stale_q <= 1'b1;
+          end
+        end
+        if (invalidate) begin
+          valid_q <= '0;
+        end
+
+        rvalid_q <= core_gnt;
+        if (core_gnt) begin
+          rdata_q      <= fill_hit ? data_q[fill_idx_q][word] : data_q[hit_idx][word];
+          last_tag_q   <= tag;
+          last_valid_q <= 1'b1;
+        end else if (!buffered_q) begin
+          last_valid_q <= 1'b0;
+        end
+
+        if (start_demand) begin
+          demand_q <= 1'b1;
+        end else if (core_gnt) begin
+          demand_q <= 1'b0;
+        end
+
+        if (clear_i) begin
+          hits_q   <= '0;
+          misses_q <= '0;
+        end else if (start_demand) begin
+          misses_q <= misses_q + 1;
+        end else if (core_gnt && !demand_q) begin
+          hits_q <= hits_q + 1;
+        end
+      end
+    end
+
+    always_ff @(posedge clk_i) begin
+      if (state_q == FILL && bus_resp_i.rvalid) begin
+        data_q[fill_idx_q][recv_cnt_q] <= bus_resp_i.rdata;
+      end
+    end
+
+    assign hits_o   = hits_q;
+    assign misses_o = misses_q;
+
+  end
+
+endmodule : instr_buffer
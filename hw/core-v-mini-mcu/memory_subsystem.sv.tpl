@@ -19,6 +19,12 @@ module memory_subsystem
     input  obi_req_t  [NUM_BANKS-1:0] ram_req_i,
     output obi_resp_t [NUM_BANKS-1:0] ram_resp_o,
 
+    // Wide DMA ports into the first interleaved group
+    input  core_v_mini_mcu_pkg::obi_wide_req_t  dma_wide_read_req_i,
+    output core_v_mini_mcu_pkg::obi_wide_resp_t dma_wide_read_resp_o,
+    input  core_v_mini_mcu_pkg::obi_wide_req_t  dma_wide_write_req_i,
+    output core_v_mini_mcu_pkg::obi_wide_resp_t dma_wide_write_resp_o,
+
     input logic [core_v_mini_mcu_pkg::NUM_BANKS-1:0] set_retentive_ni
 );
 
@@ -26,16 +32,135 @@ module memory_subsystem
   // Clock-gating
   logic [NUM_BANKS-1:0] clk_cg;
 
+  // Inputs of the banks, from the system bus or from a lane of a wide port
+  logic [NUM_BANKS-1:0] bank_req;
+  logic [NUM_BANKS-1:0] bank_we;
+  logic [NUM_BANKS-1:0][3:0] bank_be;
+  logic [NUM_BANKS-1:0][31:0] bank_wdata;
+
+  // Banks requested by the system bus, in the transfer of a wide port, and
+  // taken by it
+  logic [NUM_BANKS-1:0] xbar_req;
+  logic [NUM_BANKS-1:0] wide_read_hit, wide_write_hit;
+  logic [NUM_BANKS-1:0] wide_read_sel, wide_write_sel;
+  logic wide_read_gnt, wide_write_gnt;
+
 % for i, bank in enumerate(xheep.iter_ram_banks()):
   logic [${bank.size().bit_length()-1 -2}-1:0] ram_req_addr_${i};
 % endfor
 
 % for i, bank in enumerate(xheep.iter_ram_banks()):
 <%
+  # Word in the bank: the address bits above the ones choosing the bank in an
+  # interleaved group, then the words of the granularity
   p1 = bank.size().bit_length()-1 + bank.il_level()
-  p2 = 2 + bank.il_level()
+  p2 = bank.il_shift() + bank.il_level()
+  def word(addr):
+    if bank.il_level() == 0 or bank.il_shift() == 2:
+      return f"{addr}[{p1}-1:{p2}]"
+    if p1 == p2:
+      return f"{addr}[{bank.il_shift()}-1:2]"
+    return f"{{{addr}[{p1}-1:{p2}], {addr}[{bank.il_shift()}-1:2]}}"
+%>
+  assign ram_req_addr_${i} = wide_write_sel[${i}] ? ${word("dma_wide_write_req_i.addr")} :
+      wide_read_sel[${i}] ? ${word("dma_wide_read_req_i.addr")} : ${word(f"ram_req_i[{i}].addr")};
+% endfor
+
+  // Wide DMA ports
+  // --------------
+  // A transfer of DMA_WIDE_LANES words aligned on as many words takes the same
+  // row of DMA_WIDE_LANES consecutive banks of the group, one lane each. It is
+  // granted when the system bus requests none of these banks, which keeps its
+  // latency, and answered in the next cycle like the system bus. The write
+  // port goes before the read port, so a copy between different banks of the
+  // group moves DMA_WIDE_LANES words per cycle.
+<%
+  lanes = dma_wide_lanes
+  lane_bits = lanes.bit_length() - 1
+  group = dma_wide_group
+  if lanes > 1:
+    group_first = int(group.first_name)
+    group_bits = group.n.bit_length() - 1
+  else:
+    group_first = 0
+    group_bits = 0
+  slot_bits = max(1, group_bits - lane_bits)
+  slots = 2 ** (group_bits - lane_bits)
+%>
+% if lanes > 1:
+  logic [${slot_bits}-1:0] wide_read_slot, wide_read_slot_q, wide_write_slot;
+  logic wide_read_rvalid_q, wide_write_rvalid_q;
+
+% if group_bits > lane_bits:
+  assign wide_read_slot = dma_wide_read_req_i.addr[${2 + group_bits}-1:${2 + lane_bits}];
+  assign wide_write_slot = dma_wide_write_req_i.addr[${2 + group_bits}-1:${2 + lane_bits}];
+% else:
+  assign wide_read_slot = '0;
+  assign wide_write_slot = '0;
+% endif
+
+% for i, bank in enumerate(xheep.iter_ram_banks()):
+% if group_first <= int(bank.name()) < group_first + group.n:
+  assign wide_read_hit[${i}] = dma_wide_read_req_i.req && wide_read_slot == ${slot_bits}'d${(int(bank.name()) - group_first) >> lane_bits};
+  assign wide_write_hit[${i}] = dma_wide_write_req_i.req && wide_write_slot == ${slot_bits}'d${(int(bank.name()) - group_first) >> lane_bits};
+% else:
+  assign wide_read_hit[${i}] = 1'b0;
+  assign wide_write_hit[${i}] = 1'b0;
+% endif
+% endfor
+
+  assign wide_write_gnt = dma_wide_write_req_i.req && !(|(wide_write_hit & xbar_req));
+  assign wide_write_sel = wide_write_gnt ? wide_write_hit : '0;
+  assign wide_read_gnt = dma_wide_read_req_i.req && !(|(wide_read_hit & (xbar_req | wide_write_sel)));
+  assign wide_read_sel = wide_read_gnt ? wide_read_hit : '0;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      wide_read_rvalid_q  <= 1'b0;
+      wide_write_rvalid_q <= 1'b0;
+      wide_read_slot_q    <= '0;
+    end else begin
+      wide_read_rvalid_q  <= wide_read_gnt;
+      wide_write_rvalid_q <= wide_write_gnt;
+      if (wide_read_gnt) wide_read_slot_q <= wide_read_slot;
+    end
+  end
+
+  assign dma_wide_read_resp_o.gnt = wide_read_gnt;
+  assign dma_wide_read_resp_o.rvalid = wide_read_rvalid_q;
+  assign dma_wide_write_resp_o.gnt = wide_write_gnt;
+  assign dma_wide_write_resp_o.rvalid = wide_write_rvalid_q;
+  assign dma_wide_write_resp_o.rdata = '0;
+
+  always_comb begin
+    dma_wide_read_resp_o.rdata = '0;
+    case (wide_read_slot_q)
+% for slot in range(slots):
+      ${slot_bits}'d${slot}: dma_wide_read_resp_o.rdata = {${", ".join(f"ram_resp_o[{group_first + slot * lanes + lane}].rdata" for lane in reversed(range(lanes)))}};
+% endfor
+      default: ;
+    endcase
+  end
+% else:
+  assign wide_read_hit = '0;
+  assign wide_write_hit = '0;
+  assign wide_read_gnt = 1'b0;
+  assign wide_write_gnt = 1'b0;
+  assign wide_read_sel = '0;
+  assign wide_write_sel = '0;
+  assign dma_wide_read_resp_o = '0;
+  assign dma_wide_write_resp_o = '0;
+% endif
+
+% for i, bank in enumerate(xheep.iter_ram_banks()):
+<%
+  lane = (int(bank.name()) - group_first) % lanes if lanes > 1 and group_first <= int(bank.name()) < group_first + group.n else 0
 %>
-  assign ram_req_addr_${i} = ram_req_i[${i}].addr[${p1}-1:${p2}];
+  assign bank_req[${i}] = ram_req_i[${i}].req | wide_read_sel[${i}] | wide_write_sel[${i}];
+  assign bank_we[${i}] = wide_write_sel[${i}] | (ram_req_i[${i}].we & ~wide_read_sel[${i}]);
+  assign bank_be[${i}] = wide_write_sel[${i}] ? dma_wide_write_req_i.be[${4 * lane}+:4] :
+      wide_read_sel[${i}] ? 4'b1111 : ram_req_i[${i}].be;
+  assign bank_wdata[${i}] = wide_write_sel[${i}] ? dma_wide_write_req_i.wdata[${32 * lane}+:32] : ram_req_i[${i}].wdata;
 % endfor
 
   for (genvar i = 0; i < NUM_BANKS; i++) begin : gen_sram
@@ -55,6 +180,7 @@ module memory_subsystem
       end
     end
 
+    assign xbar_req[i] = ram_req_i[i].req;
     assign ram_resp_o[i].gnt = ram_req_i[i].req;
     assign ram_resp_o[i].rvalid = ram_valid_q[i];
   end
@@ -66,11 +192,11 @@ module memory_subsystem
   ) ram${bank.name()}_i (
       .clk_i(clk_cg[${i}]),
       .rst_ni(rst_ni),
-      .req_i(ram_req_i[${i}].req),
-      .we_i(ram_req_i[${i}].we),
+      .req_i(bank_req[${i}]),
+      .we_i(bank_we[${i}]),
       .addr_i(ram_req_addr_${i}),
-      .wdata_i(ram_req_i[${i}].wdata),
-      .be_i(ram_req_i[${i}].be),
+      .wdata_i(bank_wdata[${i}]),
+      .be_i(bank_be[${i}]),
       .set_retentive_ni(set_retentive_ni[${i}]),
       .rdata_o(ram_resp_o[${i}].rdata)
   );
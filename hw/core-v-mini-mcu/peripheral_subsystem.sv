@@ -89,7 +89,13 @@ module peripheral_subsystem
     // PDM2PCM Interface
     output logic pdm2pcm_clk_o,
     output logic pdm2pcm_clk_en_o,
-    input  logic pdm2pcm_pdm_i
+    input  logic pdm2pcm_pdm_i,
+    output logic pdm2pcm_rx_valid_o,
+
+    // Cluster control, to the extra harts
+    output logic [                           31:0] cluster_boot_addr_o,
+    output logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_fetch_enable_o,
+    output logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_sw_irq_o
 );
 
   import core_v_mini_mcu_pkg::*;
@@ -208,7 +214,9 @@ module peripheral_subsystem
   obi_pkg::obi_req_t  slave_fifoout_req;
   obi_pkg::obi_resp_t slave_fifoout_resp;
 
-  obi_fifo obi_fifo_i (
+  obi_fifo #(
+      .OUTSTANDING(core_v_mini_mcu_pkg::PERIPHERAL_OUTSTANDING)
+  ) obi_fifo_i (
       .clk_i(clk_cg),
       .rst_ni,
       .producer_req_i(slave_fifoin_req),
@@ -445,6 +453,7 @@ module peripheral_subsystem
 
   assign peripheral_slv_rsp[core_v_mini_mcu_pkg::PDM2PCM_IDX] = '0;
   assign pdm2pcm_clk_o = '0;
+  assign pdm2pcm_rx_valid_o = 1'b0;
 
   assign pdm2pcm_clk_en_o = 1;
 
@@ -470,4 +479,11 @@ module peripheral_subsystem
       .i2s_rx_valid_o(i2s_rx_valid_o)
   );
 
+  assign peripheral_slv_rsp[core_v_mini_mcu_pkg::CRC_IDX] = '0;
+
+  assign peripheral_slv_rsp[core_v_mini_mcu_pkg::CLUSTER_CTRL_IDX] = '0;
+  assign cluster_boot_addr_o = '0;
+  assign cluster_fetch_enable_o = '0;
+  assign cluster_sw_irq_o = '0;
+
 endmodule : peripheral_subsystem
@@ -89,7 +89,13 @@ module peripheral_subsystem
     // PDM2PCM Interface
     output logic pdm2pcm_clk_o,
     output logic pdm2pcm_clk_en_o,
-    input  logic pdm2pcm_pdm_i
+    input  logic pdm2pcm_pdm_i,
+    output logic pdm2pcm_rx_valid_o,
+
+    // Cluster control, to the extra harts
+    output logic [                           31:0] cluster_boot_addr_o,
+    output logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_fetch_enable_o,
+    output logic [core_v_mini_mcu_pkg::NUM_HARTS-1:0] cluster_sw_irq_o
 );
 
   import core_v_mini_mcu_pkg::*;
@@ -208,7 +214,9 @@ module peripheral_subsystem
   obi_pkg::obi_req_t slave_fifoout_req;
   obi_pkg::obi_resp_t slave_fifoout_resp;
 
-  obi_fifo obi_fifo_i (
+  obi_fifo #(
+      .OUTSTANDING(core_v_mini_mcu_pkg::PERIPHERAL_OUTSTANDING)
+  ) obi_fifo_i (
       .clk_i(clk_cg),
       .rst_ni,
       .producer_req_i (slave_fifoin_req),
@@ -551,11 +559,13 @@ module peripheral_subsystem
       .reg_req_i(peripheral_slv_req[core_v_mini_mcu_pkg::PDM2PCM_IDX]),
       .reg_rsp_o(peripheral_slv_rsp[core_v_mini_mcu_pkg::PDM2PCM_IDX]),
       .pdm_i(pdm2pcm_pdm_i),
-      .pdm_clk_o(pdm2pcm_clk_o)
+      .pdm_clk_o(pdm2pcm_clk_o),
+      .rx_valid_o(pdm2pcm_rx_valid_o)
   );
 % else:
   assign peripheral_slv_rsp[core_v_mini_mcu_pkg::PDM2PCM_IDX] = '0;
   assign pdm2pcm_clk_o = '0;
+  assign pdm2pcm_rx_valid_o = 1'b0;
 % endif
 % endif
 % endfor
@@ -601,4 +611,47 @@ module peripheral_subsystem
 % endif
 % endfor
 
+% for peripheral in peripherals.items():
+% if peripheral[0] in ("crc"):
+% if peripheral[1]['is_included'] in ("yes"):
+  crc #(
+      .reg_req_t(reg_pkg::reg_req_t),
+      .reg_rsp_t(reg_pkg::reg_rsp_t)
+  ) crc_i (
+      .clk_i(clk_cg),
+      .rst_ni,
+      .reg_req_i(peripheral_slv_req[core_v_mini_mcu_pkg::CRC_IDX]),
+      .reg_rsp_o(peripheral_slv_rsp[core_v_mini_mcu_pkg::CRC_IDX])
+  );
+% else:
+  assign peripheral_slv_rsp[core_v_mini_mcu_pkg::CRC_IDX] = '0;
+% endif
+% endif
+% endfor
+
+% for peripheral in peripherals.items():
+% if peripheral[0] in ("cluster_ctrl"):
+% if peripheral[1]['is_included'] in ("yes"):
+  cluster_ctrl #(
+      .reg_req_t(reg_pkg::reg_req_t),
+      .reg_rsp_t(reg_pkg::reg_rsp_t),
+      .NUM_HARTS(core_v_mini_mcu_pkg::NUM_HARTS)
+  ) cluster_ctrl_i (
+      .clk_i,
+      .rst_ni,
+      .reg_req_i(peripheral_slv_req[core_v_mini_mcu_pkg::CLUSTER_CTRL_IDX]),
+      .reg_rsp_o(peripheral_slv_rsp[core_v_mini_mcu_pkg::CLUSTER_CTRL_IDX]),
+      .boot_addr_o(cluster_boot_addr_o),
+      .fetch_enable_o(cluster_fetch_enable_o),
+      .sw_irq_o(cluster_sw_irq_o)
+  );
+% else:
+  assign peripheral_slv_rsp[core_v_mini_mcu_pkg::CLUSTER_CTRL_IDX] = '0;
+  assign cluster_boot_addr_o = '0;
+  assign cluster_fetch_enable_o = '0;
+  assign cluster_sw_irq_o = '0;
+% endif
+% endif
+% endfor
+
 endmodule : peripheral_subsystem
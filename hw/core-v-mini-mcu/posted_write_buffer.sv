@@ -0,0 +1,113 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Posted write buffer between the data port of the main core and the system
+// bus. The writes to the peripherals (the always-on and the switchable
+// peripheral ranges) are granted and answered at once and queued in up to
+// DEPTH entries, so that the core goes on while the slow register writes drain
+// to the bus in order. Every other access, reads included, waits until the
+// queue is empty and the queued writes are answered by the bus: a read of any
+// address is the fence that makes the previous writes visible. The answers of
+// the bus to the queued writes are dropped. With DEPTH = 0 the buffer is
+// removed.
+
+module posted_write_buffer
+  import obi_pkg::*;
+  import core_v_mini_mcu_pkg::*;
+#(
+    parameter int unsigned DEPTH = 4
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  obi_req_t  core_req_i,
+    output obi_resp_t core_resp_o,
+
+    output obi_req_t  bus_req_o,
+    input  obi_resp_t bus_resp_i
+);
+
+  if (DEPTH == 0) begin : gen_no_buffer
+
+    assign bus_req_o   = core_req_i;
+    assign core_resp_o = bus_resp_i;
+
+  end else begin : gen_buffer
+
+    // Above the outstanding requests of the peripheral buses (up to 8) and of
+    // the core
+    localparam int unsigned CntWidth = 4;
+
+    obi_req_t fifo_head;
+    logic fifo_full, fifo_empty, fifo_push, fifo_pop;
+
+    // Queued writes sent to the bus, and other accesses of the core, not
+    // answered yet. They are never in flight together.
+    logic [CntWidth-1:0] posted_out_q, direct_out_q;
+    logic posted_rvalid_q;
+
+    logic to_periph, posted, direct;
+
+    assign to_periph = (core_req_i.addr >= AO_PERIPHERAL_START_ADDRESS &&
+                        core_req_i.addr < AO_PERIPHERAL_END_ADDRESS) ||
+                       (core_req_i.addr >= PERIPHERAL_START_ADDRESS &&
+                        core_req_i.addr < PERIPHERAL_END_ADDRESS);
+
+    // A write is queued once the accesses before it are answered, so that the
+    // answers to the core stay in order
+    assign posted = core_req_i.req && core_req_i.we && to_periph;
+    assign fifo_push = posted && !fifo_full && direct_out_q == '0;
+
+    // The other accesses go to the bus once the queue is drained
+    assign direct = core_req_i.req && !posted && fifo_empty && posted_out_q == '0;
+
+    always_comb begin
+      bus_req_o = core_req_i;
+      bus_req_o.req = direct;
+      if (!fifo_empty) begin
+        bus_req_o = fifo_head;
+        bus_req_o.req = 1'b1;
+      end
+
+      core_resp_o.gnt = fifo_push || (direct && bus_resp_i.gnt);
+      core_resp_o.rvalid = posted_rvalid_q || (bus_resp_i.rvalid && posted_out_q == '0);
+      core_resp_o.rdata = bus_resp_i.rdata;
+    end
+
+    assign fifo_pop = !fifo_empty && bus_resp_i.gnt;
+
+    fifo_v3 #(
+        .DEPTH(DEPTH),
+        .dtype(obi_req_t)
+    ) posted_fifo_i (
+        .clk_i,
+        .rst_ni,
+        .flush_i(1'b0),
+        .testmode_i(1'b0),
+        .full_o(fifo_full),
+        .empty_o(fifo_empty),
+        .usage_o(),
+        .data_i(core_req_i),
+        .push_i(fifo_push),
+        .data_o(fifo_head),
+        .pop_i(fifo_pop)
+    );
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        posted_out_q    <= '0;
+        direct_out_q    <= '0;
+        posted_rvalid_q <= 1'b0;
+      end else begin
+        posted_rvalid_q <= fifo_push;
+        posted_out_q <= posted_out_q + CntWidth'(fifo_pop) -
+                        CntWidth'(bus_resp_i.rvalid && posted_out_q != '0);
+        direct_out_q <= direct_out_q + CntWidth'(direct && bus_resp_i.gnt) -
+                        CntWidth'(bus_resp_i.rvalid && posted_out_q == '0);
+      end
+    end
+
+  end
+
+endmodule : posted_write_buffer
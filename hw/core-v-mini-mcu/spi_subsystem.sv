@@ -11,6 +11,10 @@ module spi_subsystem
 
     input logic use_spimemio_i,
 
+    // Counters of the read cache of the memory-mapped flash
+    output logic [31:0] flash_cache_hits_o,
+    output logic [31:0] flash_cache_misses_o,
+
     // Memory mapped SPI
     input  obi_req_t  spimemio_req_i,
     output obi_resp_t spimemio_resp_o,
@@ -98,7 +102,10 @@ module spi_subsystem
   assign yo_spi_csb_en = 2'b01;
   assign yo_spi_csb[1] = 1'b1;
 
-  obi_spimemio obi_spimemio_i (
+  obi_spimemio #(
+      .CACHE_SIZE(core_v_mini_mcu_pkg::FLASH_CACHE_SIZE),
+      .CACHE_LINE_SIZE(core_v_mini_mcu_pkg::FLASH_CACHE_LINE_SIZE)
+  ) obi_spimemio_i (
       .clk_i,
       .rst_ni,
       .flash_csb_o(yo_spi_csb[0]),
@@ -118,7 +125,9 @@ module spi_subsystem
       .reg_req_i(yo_reg_req_i),
       .reg_rsp_o(yo_reg_rsp_o),
       .spimemio_req_i(spimemio_req_i),
-      .spimemio_resp_o(spimemio_resp_o)
+      .spimemio_resp_o(spimemio_resp_o),
+      .cache_hits_o(flash_cache_hits_o),
+      .cache_misses_o(flash_cache_misses_o)
   );
 
   // OpenTitan SPI Snitch Version used for booting
@@ -45,6 +45,15 @@ module system_bus
 
     input  obi_req_t  dma_addr_ch0_req_i,
     output obi_resp_t dma_addr_ch0_resp_o,
+% if num_harts > 1:
+
+    // Extra harts of the cluster, hart h on index h-1
+    input  obi_req_t  [${num_harts - 2}:0] hart_instr_req_i,
+    output obi_resp_t [${num_harts - 2}:0] hart_instr_resp_o,
+
+    input  obi_req_t  [${num_harts - 2}:0] hart_data_req_i,
+    output obi_resp_t [${num_harts - 2}:0] hart_data_resp_o,
+% endif
 
     // External master ports
     input  obi_req_t  [EXT_XBAR_NMASTER_RND-1:0] ext_xbar_master_req_i,
@@ -83,7 +92,21 @@ module system_bus
     input  obi_resp_t ext_dma_write_ch0_resp_i,
 
     output obi_req_t  ext_dma_addr_ch0_req_o,
-    input  obi_resp_t ext_dma_addr_ch0_resp_i
+    input  obi_resp_t ext_dma_addr_ch0_resp_i,
+
+    // Arbitration settings from soc_ctrl, replacing the ones of
+    // core_v_mini_mcu_pkg when bus_qos_override_i is set
+    input logic        bus_qos_override_i,
+    input logic [15:0] bus_qos_window_i,
+    input logic [31:0] bus_qos_priority_i,
+    input logic [31:0] bus_qos_budget_i,
+
+    // Performance counters, read through soc_ctrl
+    input  logic        dma_busy_i,
+    input  logic        perf_freeze_i,
+    input  logic        perf_clear_i,
+    input  logic [ 7:0] perf_sel_i,
+    output logic [31:0] perf_value_o
 );
 
   import core_v_mini_mcu_pkg::*;
@@ -100,13 +123,20 @@ module system_bus
   obi_req_t [core_v_mini_mcu_pkg::SYSTEM_XBAR_NSLAVE-1:0] int_slave_req;
   obi_resp_t [core_v_mini_mcu_pkg::SYSTEM_XBAR_NSLAVE-1:0] int_slave_resp;
 
+  // Slave addressed by each master
+  logic [core_v_mini_mcu_pkg::SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER-1:0][LOG_SYSTEM_XBAR_NSLAVE-1:0] master_slave_sel;
+
   // Error slave ports  
   obi_req_t error_slave_req;
   obi_resp_t error_slave_resp;
 
+  // Masters behind a 1-to-2 demux to the external slaves, the extra harts of
+  // the cluster only reach the internal slaves
+  localparam int unsigned DEMUX_NMASTER = DMA_ADDR_CH0_IDX + 1;
+
   // Forward crossbars ports
-  obi_req_t [core_v_mini_mcu_pkg::SYSTEM_XBAR_NMASTER-1:0][1:0] demux_xbar_req;
-  obi_resp_t [core_v_mini_mcu_pkg::SYSTEM_XBAR_NMASTER-1:0][1:0] demux_xbar_resp;
+  obi_req_t [DEMUX_NMASTER-1:0][1:0] demux_xbar_req;
+  obi_resp_t [DEMUX_NMASTER-1:0][1:0] demux_xbar_resp;
 
   // Dummy external master port (to prevent unused warning)
   obi_req_t [EXT_XBAR_NMASTER_RND-1:0] ext_xbar_req_unused;
@@ -115,6 +145,30 @@ module system_bus
 
   assign error_slave_resp = '0;
 
+  // Arbitration settings of the masters: 2 priority bits for the first 16, 4
+  // budget bits for the first 8, the others have priority 0 and no budget
+  logic [SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER-1:0][1:0] qos_priority;
+  logic [SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER-1:0][3:0] qos_budget;
+  logic [31:0] qos_priority_sel, qos_budget_sel;
+  logic [15:0] qos_window;
+
+  assign qos_priority_sel = bus_qos_override_i ? bus_qos_priority_i : BUS_QOS_PRIORITY;
+  assign qos_budget_sel = bus_qos_override_i ? bus_qos_budget_i : BUS_QOS_BUDGET;
+  assign qos_window = bus_qos_override_i ? bus_qos_window_i : BUS_QOS_WINDOW;
+
+  for (genvar i = 0; i < SYSTEM_XBAR_NMASTER + EXT_XBAR_NMASTER; i++) begin : gen_qos_settings
+    if (i < 16) begin : gen_priority
+      assign qos_priority[i] = qos_priority_sel[2*i+:2];
+    end else begin : gen_no_priority
+      assign qos_priority[i] = '0;
+    end
+    if (i < 8) begin : gen_budget
+      assign qos_budget[i] = qos_budget_sel[4*i+:4];
+    end else begin : gen_no_budget
+      assign qos_budget[i] = '0;
+    end
+  end
+
   // Internal master requests
   assign int_master_req[core_v_mini_mcu_pkg::CORE_INSTR_IDX] = core_instr_req_i;
   assign int_master_req[core_v_mini_mcu_pkg::CORE_DATA_IDX] = core_data_req_i;
@@ -122,12 +176,19 @@ module system_bus
   assign int_master_req[core_v_mini_mcu_pkg::DMA_READ_CH0_IDX] = dma_read_ch0_req_i;
   assign int_master_req[core_v_mini_mcu_pkg::DMA_WRITE_CH0_IDX] = dma_write_ch0_req_i;
   assign int_master_req[core_v_mini_mcu_pkg::DMA_ADDR_CH0_IDX] = dma_addr_ch0_req_i;
+% for h in range(1, num_harts):
+  assign int_master_req[core_v_mini_mcu_pkg::HART${h}_INSTR_IDX] = hart_instr_req_i[${h - 1}];
+  assign int_master_req[core_v_mini_mcu_pkg::HART${h}_DATA_IDX] = hart_data_req_i[${h - 1}];
+% endfor
 
   // Internal + external master requests
   generate
-    for (genvar i = 0; i < SYSTEM_XBAR_NMASTER; i++) begin: gen_sys_master_req_map
+    for (genvar i = 0; i < DEMUX_NMASTER; i++) begin: gen_sys_master_req_map
       assign master_req[i] = demux_xbar_req[i][DEMUX_XBAR_INT_SLAVE_IDX];
     end
+    for (genvar i = DEMUX_NMASTER; i < SYSTEM_XBAR_NMASTER; i++) begin: gen_hart_master_req_map
+      assign master_req[i] = int_master_req[i];
+    end
     for (genvar i = 0; i < EXT_XBAR_NMASTER; i++) begin : gen_ext_master_req_map
       assign master_req[SYSTEM_XBAR_NMASTER+i] = ext_xbar_master_req_i[i];
     end
@@ -135,9 +196,12 @@ module system_bus
 
   // Internal master responses
   generate
-    for (genvar i = 0; i < SYSTEM_XBAR_NMASTER; i++) begin: gen_demux_master_resp_map
+    for (genvar i = 0; i < DEMUX_NMASTER; i++) begin: gen_demux_master_resp_map
       assign demux_xbar_resp[i][DEMUX_XBAR_INT_SLAVE_IDX] = master_resp[i];
     end
+    for (genvar i = DEMUX_NMASTER; i < SYSTEM_XBAR_NMASTER; i++) begin: gen_hart_master_resp_map
+      assign int_master_resp[i] = master_resp[i];
+    end
   endgenerate
   assign core_instr_resp_o = int_master_resp[core_v_mini_mcu_pkg::CORE_INSTR_IDX];
   assign core_data_resp_o = int_master_resp[core_v_mini_mcu_pkg::CORE_DATA_IDX];
@@ -145,6 +209,10 @@ module system_bus
   assign dma_read_ch0_resp_o = int_master_resp[core_v_mini_mcu_pkg::DMA_READ_CH0_IDX];
   assign dma_write_ch0_resp_o = int_master_resp[core_v_mini_mcu_pkg::DMA_WRITE_CH0_IDX];
   assign dma_addr_ch0_resp_o = int_master_resp[core_v_mini_mcu_pkg::DMA_ADDR_CH0_IDX];
+% for h in range(1, num_harts):
+  assign hart_instr_resp_o[${h - 1}] = int_master_resp[core_v_mini_mcu_pkg::HART${h}_INSTR_IDX];
+  assign hart_data_resp_o[${h - 1}] = int_master_resp[core_v_mini_mcu_pkg::HART${h}_DATA_IDX];
+% endfor
 
   // External master responses
   if (EXT_XBAR_NMASTER == 0) begin
@@ -206,14 +274,50 @@ module system_bus
     if ($test$plusargs("verbose") != 0 && core_data_req_i.req && core_data_req_i.we)
       $display("write addr=0x%08x: data=0x%08x", core_data_req_i.addr, core_data_req_i.wdata);
   end
+
+  // system crossbar performance counters, read by the testbench at the end of the simulation
+  longint unsigned perf_master_req_cycles[SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER];
+  longint unsigned perf_master_gnt[SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER];
+  longint unsigned perf_master_rvalid[SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER];
+  longint unsigned perf_slave_gnt[SYSTEM_XBAR_NSLAVE];
+  // consecutive cycles without any master request, used by the testbench fast-forward
+  longint unsigned perf_idle_cycles;
+
+  always_ff @(posedge clk_i, negedge rst_ni) begin : perf_counters
+    if (!rst_ni) begin
+      for (int i = 0; i < SYSTEM_XBAR_NMASTER + EXT_XBAR_NMASTER; i++) begin
+        perf_master_req_cycles[i] <= '0;
+        perf_master_gnt[i] <= '0;
+        perf_master_rvalid[i] <= '0;
+      end
+      for (int i = 0; i < SYSTEM_XBAR_NSLAVE; i++) begin
+        perf_slave_gnt[i] <= '0;
+      end
+      perf_idle_cycles <= '0;
+    end else begin
+      perf_idle_cycles <= perf_idle_cycles + 1;
+      for (int i = 0; i < SYSTEM_XBAR_NMASTER + EXT_XBAR_NMASTER; i++) begin
+        if (master_req[i].req) begin
+          perf_master_req_cycles[i] <= perf_master_req_cycles[i] + 1;
+          perf_idle_cycles <= '0;
+        end
+        if (master_req[i].req && master_resp[i].gnt) perf_master_gnt[i] <= perf_master_gnt[i] + 1;
+        if (master_resp[i].rvalid) perf_master_rvalid[i] <= perf_master_rvalid[i] + 1;
+      end
+      for (int i = 0; i < SYSTEM_XBAR_NSLAVE; i++) begin
+        if (int_slave_req[i].req && int_slave_resp[i].gnt) perf_slave_gnt[i] <= perf_slave_gnt[i] + 1;
+      end
+    end
+  end
 `endif
 
   // 1-to-2 demux crossbars
   // ------------------------
   // These crossbars forward each master to a port on the internal crossbar or
-  // to the corresponding external master port.
+  // to the corresponding external master port. The extra harts go straight to
+  // the internal crossbar, their external accesses hit the error slave.
   generate
-    for (genvar i = 0; unsigned'(i) < SYSTEM_XBAR_NMASTER; i++) begin : gen_demux_xbar
+    for (genvar i = 0; unsigned'(i) < DEMUX_NMASTER; i++) begin : gen_demux_xbar
       xbar_varlat_one_to_n #(
           .XBAR_NSLAVE (32'd2), // internal crossbar + external crossbar
           .NUM_RULES   (32'd1) // only the external address space is defined
@@ -243,7 +347,53 @@ module system_bus
       .master_req_i(master_req),
       .master_resp_o(master_resp),
       .slave_req_o(int_slave_req),
-      .slave_resp_i(int_slave_resp)
+      .slave_resp_i(int_slave_resp),
+      .qos_priority_i(qos_priority),
+      .qos_budget_i(qos_budget),
+      .qos_window_i(qos_window),
+      .slave_sel_o(master_slave_sel)
+  );
+
+  // Performance counters
+  // ------------------------
+  logic [SYSTEM_XBAR_NMASTER+EXT_XBAR_NMASTER-1:0] perf_req, perf_gnt, perf_rvalid;
+  logic [NUM_BANKS-1:0] perf_bank_access;
+  logic perf_core_stall;
+
+  for (genvar i = 0; i < SYSTEM_XBAR_NMASTER + EXT_XBAR_NMASTER; i++) begin : gen_perf_master
+    assign perf_req[i] = master_req[i].req;
+    assign perf_gnt[i] = master_resp[i].gnt;
+    assign perf_rvalid[i] = master_resp[i].rvalid;
+  end
+
+  // The RAM banks follow the error slave
+  for (genvar i = 0; i < NUM_BANKS; i++) begin : gen_perf_bank
+    assign perf_bank_access[i] = int_slave_req[ERROR_IDX+1+i].req && int_slave_resp[ERROR_IDX+1+i].gnt;
+  end
+
+  // Internal and external accesses of the core alike
+  assign perf_core_stall = (core_instr_req_i.req && !core_instr_resp_o.gnt) ||
+                           (core_data_req_i.req && !core_data_resp_o.gnt);
+
+  bus_perf_counters #(
+      .XBAR_NMASTER  (SYSTEM_XBAR_NMASTER + EXT_XBAR_NMASTER),
+      .XBAR_NSLAVE   (SYSTEM_XBAR_NSLAVE),
+      .NUM_BANKS     (NUM_BANKS),
+      .FIRST_BANK_IDX(ERROR_IDX + 1)
+  ) bus_perf_counters_i (
+      .clk_i,
+      .rst_ni,
+      .req_i        (perf_req),
+      .slave_sel_i  (master_slave_sel),
+      .gnt_i        (perf_gnt),
+      .rvalid_i     (perf_rvalid),
+      .bank_access_i(perf_bank_access),
+      .dma_busy_i,
+      .core_stall_i (perf_core_stall),
+      .freeze_i     (perf_freeze_i),
+      .clear_i      (perf_clear_i),
+      .sel_i        (perf_sel_i),
+      .value_o      (perf_value_o)
   );
 
 endmodule
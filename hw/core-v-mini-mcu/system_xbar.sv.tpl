@@ -25,7 +25,16 @@ module system_xbar
     output obi_resp_t [XBAR_NMASTER-1:0] master_resp_o,
 
     output obi_req_t  [XBAR_NSLAVE-1:0] slave_req_o,
-    input  obi_resp_t [XBAR_NSLAVE-1:0] slave_resp_i
+    input  obi_resp_t [XBAR_NSLAVE-1:0] slave_resp_i,
+
+    // Arbitration settings, see xbar_qos
+    input logic [XBAR_NMASTER-1:0][1:0] qos_priority_i,
+    input logic [XBAR_NMASTER-1:0][3:0] qos_budget_i,
+    input logic [            15:0]      qos_window_i,
+
+    // Slave addressed by each master, for the performance counters (0 with
+    // the 1toM bus)
+    output logic [XBAR_NMASTER-1:0][IdxWidth-1:0] slave_sel_o
 
 );
 
@@ -64,6 +73,10 @@ module system_xbar
   logic [XBAR_NSLAVE-1:0][REQ_AGG_DATA_WIDTH-1:0] slave_req_out_data;
   obi_req_t [XBAR_NMASTER-1:0] master_req;
 
+  // QoS filter
+  logic [XBAR_NMASTER-1:0] qos_req_in, qos_req_out, qos_gnt;
+  logic [XBAR_NMASTER-1:0][LOG_XBAR_NSLAVE-1:0] qos_slave_sel;
+
   if (BUS_TYPE == NtoM) begin : gen_addr_decoders_NtoM
     for (genvar i = 0; i < XBAR_NMASTER; i++) begin : gen_addr_decoders
       addr_decode #(
@@ -95,10 +108,19 @@ module system_xbar
         port_sel[j] = pre_port_sel[j];
         post_master_req_addr[j] = master_req_i[j].addr;
 % for i, group in enumerate(xheep.iter_il_groups()):
-
+<%
+  # The bank is chosen by the address bits above the granularity, which the
+  # bank sees cleared
+  shift = group.granularity.bit_length() - 1
+  bits = group.n.bit_length() - 1
+%>
         if (pre_port_sel[j] == RAM_IL${i}_IDX[LOG_XBAR_NSLAVE-1:0]) begin
-          port_sel[j] = RAM_IL${i}_IDX[LOG_XBAR_NSLAVE-1:0] + {ZERO[LOG_XBAR_NSLAVE-${1+group.n.bit_length()}:0],master_req_i[j].addr[${group.n.bit_length()-1 +1}:2]};
-          post_master_req_addr[j] = {master_req_i[j].addr[31:${2+group.n.bit_length()-1}], ${2+group.n.bit_length()-1}'h0};
+          port_sel[j] = RAM_IL${i}_IDX[LOG_XBAR_NSLAVE-1:0] + {ZERO[LOG_XBAR_NSLAVE-${1+group.n.bit_length()}:0],master_req_i[j].addr[${shift + bits - 1}:${shift}]};
+% if shift == 2:
+          post_master_req_addr[j] = {master_req_i[j].addr[31:${shift + bits}], ${shift + bits}'h0};
+% else:
+          post_master_req_addr[j] = {master_req_i[j].addr[31:${shift + bits}], ${bits}'h0, master_req_i[j].addr[${shift - 1}:0]};
+% endif
         end
 % endfor
       end
@@ -106,11 +128,41 @@ module system_xbar
 % endif    
   end
 
+  // Priorities and bandwidth budgets of the masters. The whole 1toM bus is a
+  // single slave for the masters.
+  for (genvar i = 0; i < XBAR_NMASTER; i++) begin : gen_qos_unroll
+    assign qos_req_in[i] = master_req_i[i].req;
+    assign qos_gnt[i] = master_resp_o[i].gnt;
+  end
+
+  if (BUS_TYPE == NtoM) begin : gen_qos_sel_NtoM
+    assign qos_slave_sel = port_sel;
+  end else begin : gen_qos_sel_1toM
+    assign qos_slave_sel = '0;
+  end
+
+  assign slave_sel_o = qos_slave_sel;
+
+  xbar_qos #(
+      .XBAR_NMASTER(XBAR_NMASTER),
+      .XBAR_NSLAVE (XBAR_NSLAVE)
+  ) xbar_qos_i (
+      .clk_i,
+      .rst_ni,
+      .priority_i (qos_priority_i),
+      .budget_i   (qos_budget_i),
+      .window_i   (qos_window_i),
+      .req_i      (qos_req_in),
+      .slave_sel_i(qos_slave_sel),
+      .req_o      (qos_req_out),
+      .gnt_i      (qos_gnt)
+  );
+
   // Propagate interleaved address
   generate
     for (genvar i = 0; i < XBAR_NMASTER; i++) begin : gen_unroll_master
       assign master_req[i] = '{
-        req: master_req_i[i].req,
+        req: qos_req_out[i],
         we: master_req_i[i].we,
         be: master_req_i[i].be,
   % if not xheep.has_il_ram():
@@ -0,0 +1,86 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: xbar_qos.sv
+// Description: Priority and bandwidth filter of the requests of the system
+//              crossbar masters
+
+module xbar_qos #(
+    parameter int unsigned XBAR_NMASTER = 2,
+    parameter int unsigned XBAR_NSLAVE = 1,
+    localparam int unsigned LogNSlave = XBAR_NSLAVE > 1 ? $clog2(XBAR_NSLAVE) : 32'd1
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Settings
+    input logic [XBAR_NMASTER-1:0][1:0] priority_i,
+    input logic [XBAR_NMASTER-1:0][3:0] budget_i,
+    input logic [            15:0]      window_i,
+
+    // Requests of the masters and their slaves
+    input  logic [XBAR_NMASTER-1:0]                req_i,
+    input  logic [XBAR_NMASTER-1:0][LogNSlave-1:0] slave_sel_i,
+    // Requests forwarded to the crossbar, and its grants
+    output logic [XBAR_NMASTER-1:0]                req_o,
+    input  logic [XBAR_NMASTER-1:0]                gnt_i
+);
+  // A request is held back while a master of higher priority requests the
+  // same slave, so that the round-robin arbitration of the crossbar only
+  // applies among the masters of the same priority. A master with a budget b
+  // gets at most b/16 of the cycles of each window as grants, after which its
+  // requests are held back until the next window and do not hold back the
+  // masters of lower priority. A master keeps its request asserted while it is
+  // held back, as OBI requires.
+
+  logic [15:0] window_cnt_q;
+  logic window_end;
+  logic [XBAR_NMASTER-1:0][15:0] gnt_cnt_q;
+  logic [XBAR_NMASTER-1:0] throttled, eligible;
+
+  assign window_end = window_cnt_q >= window_i - 16'd1;
+
+  for (genvar i = 0; i < XBAR_NMASTER; i++) begin : gen_filter
+    logic [19:0] limit;
+
+    // At least one grant per window, so that no master starves
+    assign limit = (20'(window_i) * 20'(budget_i[i])) >> 4;
+    assign throttled[i] = window_i != '0 && budget_i[i] != '0 &&
+                          20'(gnt_cnt_q[i]) >= (limit != '0 ? limit : 20'd1);
+    assign eligible[i] = req_i[i] & ~throttled[i];
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (~rst_ni) begin
+        gnt_cnt_q[i] <= '0;
+      end else if (window_end) begin
+        gnt_cnt_q[i] <= '0;
+      end else if (req_o[i] && gnt_i[i] && gnt_cnt_q[i] != '1) begin
+        gnt_cnt_q[i] <= gnt_cnt_q[i] + 16'd1;
+      end
+    end
+  end
+
+  always_comb begin
+    req_o = eligible;
+    for (int i = 0; i < XBAR_NMASTER; i++) begin
+      for (int j = 0; j < XBAR_NMASTER; j++) begin
+        if (j != i && eligible[j] && slave_sel_i[j] == slave_sel_i[i] &&
+            priority_i[j] > priority_i[i]) begin
+          req_o[i] = 1'b0;
+        end
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      window_cnt_q <= '0;
+    end else if (window_end) begin
+      window_cnt_q <= '0;
+    end else begin
+      window_cnt_q <= window_cnt_q + 16'd1;
+    end
+  end
+
+endmodule : xbar_qos
@@ -0,0 +1,78 @@
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Writes the MMI file of the RAM banks of a routed design, for updatemem
+# (make vivado-fpga-update-sw):
+#   vivado -mode batch -source write_mmi.tcl -tclargs <routed.dcp> <out.mmi>
+# Each bank is one address space at its place in the memory map, made of the
+# block RAMs of its xilinx_mem_gen_<num_words> (tc_ram_i of sram_wrapper).
+# The interleaved banks are left out: the words of their address range are
+# spread over several banks, which one address space cannot describe.
+
+set dcp [lindex $argv 0]
+set mmi [lindex $argv 1]
+
+open_checkpoint $dcp
+
+# Name, first byte address, size in bytes
+set banks {
+% for bank in xheep.iter_cont_ram_banks():
+  {${bank.name()} ${bank.start_address()} ${bank.size()}}
+% endfor
+}
+
+set f [open $mmi w]
+puts $f "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+puts $f "<MemInfo Version=\"1\" Minor=\"0\">"
+puts $f "  <Processor Endianness=\"Little\" InstPath=\"x_heep\">"
+
+foreach bank $banks {
+  lassign $bank name start size
+  set brams [get_cells -hierarchical -filter "PRIMITIVE_TYPE =~ BMEM.* && NAME =~ */ram[set name]_i/tc_ram_i/*"]
+  if {[llength $brams] == 0} {
+    error "no block RAM found for the RAM bank $name"
+  }
+
+  # The block RAMs of a same address range make one bus block, the lowest
+  # range first
+  set ranges {}
+  foreach bram $brams {
+    # [MSB:LSB][first word:last word] of the bank built by the IP
+    if {![regexp {\[(\d+):(\d+)\]\[(\d+):(\d+)\]} [get_property bmm_info_memory_device $bram] -> msb lsb first last]} {
+      error "no bmm_info_memory_device for $bram"
+    }
+    set type [get_property REF_NAME $bram]
+    set mem_type [expr {[string match "RAMB36*" $type] ? "RAMB32" : "RAMB18"}]
+    regsub {^RAMB\d+_} [get_property LOC $bram] {} placement
+    dict lappend ranges [format "%08d %08d" $first $last] [list $mem_type $placement $msb $lsb]
+  }
+
+  puts $f "    <AddressSpace Name=\"ram$name\" Begin=\"$start\" End=\"[expr {$start + $size - 1}]\">"
+  foreach range [lsort [dict keys $ranges]] {
+    lassign $range first last
+    puts $f "      <BusBlock>"
+    foreach lane [lsort -integer -decreasing -index 2 [dict get $ranges $range]] {
+      lassign $lane mem_type placement msb lsb
+      puts $f "        <BitLane MemType=\"$mem_type\" Placement=\"$placement\">"
+      puts $f "          <DataWidth MSB=\"$msb\" LSB=\"$lsb\"/>"
+      puts $f "          <AddressRange Begin=\"[scan $first %d]\" End=\"[scan $last %d]\"/>"
+      puts $f "          <Parity ON=\"false\" NumBits=\"0\"/>"
+      puts $f "        </BitLane>"
+    }
+    puts $f "      </BusBlock>"
+  }
+  puts $f "    </AddressSpace>"
+}
+
+puts $f "  </Processor>"
+puts $f "  <Config>"
+puts $f "    <Option Name=\"Part\" Val=\"[get_property PART [current_design]]\"/>"
+puts $f "  </Config>"
+puts $f "  <DRC>"
+puts $f "    <Rule Name=\"RdAddrChange\" Val=\"false\"/>"
+puts $f "  </DRC>"
+puts $f "</MemInfo>"
+close $f
+
+puts "Wrote $mmi"
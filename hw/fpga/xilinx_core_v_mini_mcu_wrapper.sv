@@ -207,7 +207,9 @@ module xilinx_core_v_mini_mcu_wrapper
       .i2s_ws_io(i2s_ws_io),
       .i2s_sd_io(i2s_sd_io),
       .ext_dma_slot_tx_i('0),
-      .ext_dma_slot_rx_i('0)
+      .ext_dma_slot_rx_i('0),
+      .ext_dma_slot_acc_tx_i('0),
+      .ext_dma_slot_acc_rx_i('0)
   );
 
   assign exit_value_o = exit_value[0];
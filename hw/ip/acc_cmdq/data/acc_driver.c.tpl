@@ -0,0 +1,109 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : ${name}.c                                                **
+** date     : ${date}                                                      **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   ${name}.c
+* @date   ${date}
+* @brief  Driver of ${name}, generated by util/accgen.py from
+* ${description_file}, do not edit.
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "${name}.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static acc_cmdq_t ${name}_queue;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+static void handler_irq_${name}(uint32_t id);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+acc_cmdq_result_t ${name}_init(void)
+{
+  return acc_cmdq_init(&${name}_queue, ${NAME}_START_ADDRESS, ${NAME}_ID, ${num_args},
+                       ${NAME}_IRQ, &handler_irq_${name});
+}
+
+uint32_t ${name}_free_slots(void)
+{
+  return acc_cmdq_free_slots(&${name}_queue);
+}
+
+bool ${name}_busy(void)
+{
+  return acc_cmdq_busy(&${name}_queue);
+}
+
+acc_cmdq_result_t ${name}_submit(${name}_opcode_t opcode, uint8_t tag, const ${name}_args_t *args)
+{
+  const uint32_t words[${num_args}] = {
+${arg_words}
+  };
+
+  return acc_cmdq_submit(&${name}_queue, opcode, tag, words);
+}
+
+acc_cmdq_result_t ${name}_poll(acc_cmdq_cpl_t *cpl)
+{
+  return acc_cmdq_poll(&${name}_queue, cpl);
+}
+
+acc_cmdq_result_t ${name}_wait(acc_cmdq_cpl_t *cpl)
+{
+  return acc_cmdq_wait(&${name}_queue, cpl);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static void handler_irq_${name}(uint32_t id)
+{
+  acc_cmdq_irq_handler(&${name}_queue);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,133 @@
+/*
+                              *******************
+******************************* H SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : ${name}.h                                                **
+** date     : ${date}                                                      **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   ${name}.h
+* @date   ${date}
+* @brief  Driver of ${name}, generated by util/accgen.py from
+* ${description_file}, do not edit.
+*
+* ${name} is behind the standard command queue of hw/ip/acc_cmdq, see
+* acc_cmdq.h: jobs are queued with ${name}_submit() and their completions are
+* taken with ${name}_poll() or ${name}_wait().
+*/
+
+#ifndef _DRIVERS_${NAME}_H_
+#define _DRIVERS_${NAME}_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core_v_mini_mcu.h"
+#include "acc_cmdq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       DEFINITIONS AND MACROS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+#define ${NAME}_START_ADDRESS (${start_address})
+#define ${NAME}_ID 0x${id}
+#define ${NAME}_IRQ ${irq}
+#define ${NAME}_CMD_DEPTH ${cmd_depth}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        TYPEDEFS AND STRUCTURES                           */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Operations of ${name}.
+ */
+typedef enum ${name}_opcode {
+${opcode_entries}
+} ${name}_opcode_t;
+
+/**
+ * Arguments of a job of ${name}.
+ */
+typedef struct ${name}_args {
+${arg_entries}
+} ${name}_args_t;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Checks the ID of ${name} and enables its interrupt. plic_Init() must have
+ * been called.
+ * @return kAccCmdqOk, or kAccCmdqError if ${name} is not there.
+ */
+acc_cmdq_result_t ${name}_init(void);
+
+/**
+ * Number of jobs that can be queued without waiting.
+ */
+uint32_t ${name}_free_slots(void);
+
+/**
+ * Whether ${name} has jobs in progress or queued.
+ */
+bool ${name}_busy(void);
+
+/**
+ * Queues a job, without waiting for the previous ones.
+ * @return kAccCmdqOk, or kAccCmdqFull if the queue has no free slot.
+ */
+acc_cmdq_result_t ${name}_submit(${name}_opcode_t opcode, uint8_t tag, const ${name}_args_t *args);
+
+/**
+ * Takes the oldest completion, without waiting.
+ * @return kAccCmdqOk, or kAccCmdqEmpty if no completion is waiting.
+ */
+acc_cmdq_result_t ${name}_poll(acc_cmdq_cpl_t *cpl);
+
+/**
+ * Takes the oldest completion, sleeping until there is one.
+ */
+acc_cmdq_result_t ${name}_wait(acc_cmdq_cpl_t *cpl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_${NAME}_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
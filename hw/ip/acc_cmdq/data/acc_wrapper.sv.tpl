@@ -0,0 +1,73 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// Generated by util/accgen.py from ${description_file}, do not edit.
+//
+// Standard command queue of hw/ip/acc_cmdq in front of ${name}_core, which
+// takes the jobs on its cmd_* ports and returns their completions on its
+// cpl_* ports.
+
+module ${name}_cmdq #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic${type_params}
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+${port_declarations}
+    output logic intr_o
+);
+
+  logic cmd_valid, cmd_ready;
+  logic [7:0] cmd_opcode, cmd_tag;
+  logic [${num_args_minus_one}:0][31:0] cmd_args;
+
+  logic cpl_valid, cpl_ready;
+  logic [7:0] cpl_tag;
+  logic [15:0] cpl_status;
+
+  acc_cmdq #(
+      .ACC_ID(32'h${id}),
+      .NUM_ARGS(${num_args}),
+      .CMD_DEPTH(${cmd_depth}),
+      .CPL_DEPTH(${cpl_depth}),
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t)
+  ) acc_cmdq_i (
+      .clk_i,
+      .rst_ni,
+      .reg_req_i,
+      .reg_rsp_o,
+      .cmd_valid_o(cmd_valid),
+      .cmd_ready_i(cmd_ready),
+      .cmd_opcode_o(cmd_opcode),
+      .cmd_tag_o(cmd_tag),
+      .cmd_args_o(cmd_args),
+      .cpl_valid_i(cpl_valid),
+      .cpl_ready_o(cpl_ready),
+      .cpl_tag_i(cpl_tag),
+      .cpl_status_i(cpl_status),
+      .intr_o
+  );
+
+  ${name}_core #(
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t)${type_param_connections}
+  ) ${name}_core_i (
+      .clk_i,
+      .rst_ni,
+      .cmd_valid_i(cmd_valid),
+      .cmd_ready_o(cmd_ready),
+      .cmd_opcode_i(cmd_opcode),
+      .cmd_tag_i(cmd_tag),
+${arg_connections}
+      .cpl_valid_o(cpl_valid),
+      .cpl_ready_i(cpl_ready),
+      .cpl_tag_o(cpl_tag),
+      .cpl_status_o(cpl_status)${port_connections}
+  );
+
+endmodule
@@ -0,0 +1,187 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// Standard command queue of the accelerators on the external peripheral bus.
+// Software stages the arguments of a job, rings the doorbell with an opcode
+// and a tag, and reads the completions back with their tag and status. Up to
+// CMD_DEPTH jobs wait in front of the accelerator and CPL_DEPTH completions
+// behind it; the interrupt stays high while completions are waiting.
+//
+// Registers (byte offsets):
+//   0x00 ID          RO  ACC_ID
+//   0x04 STATUS      RO  [7:0] free command slots, [15:8] waiting completions,
+//                        [16] accelerator busy, [17] overflow
+//   0x08 CTRL        RW  [0] interrupt enable, writing 1 to [1] clears the overflow
+//   0x0C DOORBELL    WO  [7:0] opcode, [15:8] tag: queues the job with the
+//                        staged arguments, or sets the overflow if the queue is full
+//   0x10 COMPLETION  RO  [31] valid, [23:16] tag, [15:0] status, popped by the read
+//   0x20 + 4 i ARG i RW  Staged arguments, kept after the doorbell
+
+module acc_cmdq #(
+    parameter logic [31:0] ACC_ID = 32'h0,
+    parameter int unsigned NUM_ARGS = 4,
+    parameter int unsigned CMD_DEPTH = 4,
+    parameter int unsigned CPL_DEPTH = 4,
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    // Jobs to the accelerator, held until cmd_ready_i
+    output logic                     cmd_valid_o,
+    input  logic                     cmd_ready_i,
+    output logic [              7:0] cmd_opcode_o,
+    output logic [              7:0] cmd_tag_o,
+    output logic [NUM_ARGS-1:0][31:0] cmd_args_o,
+
+    // Completions from the accelerator, taken when cpl_ready_o
+    input  logic        cpl_valid_i,
+    output logic        cpl_ready_o,
+    input  logic [ 7:0] cpl_tag_i,
+    input  logic [15:0] cpl_status_i,
+
+    output logic intr_o
+);
+
+  localparam int unsigned CmdWidth = 16 + 32 * NUM_ARGS;
+  localparam int unsigned CplWidth = 24;
+  localparam int unsigned CmdUsageWidth = (CMD_DEPTH > 1) ? $clog2(CMD_DEPTH) : 1;
+  localparam int unsigned CplUsageWidth = (CPL_DEPTH > 1) ? $clog2(CPL_DEPTH) : 1;
+  localparam int unsigned ArgIdxWidth = (NUM_ARGS > 1) ? $clog2(NUM_ARGS) : 1;
+
+  localparam logic [7:0] IdOffset = 8'h00;
+  localparam logic [7:0] StatusOffset = 8'h04;
+  localparam logic [7:0] CtrlOffset = 8'h08;
+  localparam logic [7:0] DoorbellOffset = 8'h0C;
+  localparam logic [7:0] CompletionOffset = 8'h10;
+  localparam logic [7:0] ArgOffset = 8'h20;
+
+  logic [NUM_ARGS-1:0][31:0] args_q;
+  logic irq_en_q, overflow_q;
+  logic [7:0] outstanding_q;
+
+  logic reg_write, reg_read;
+  logic [7:0] reg_addr;
+  logic arg_sel;
+  logic [ArgIdxWidth-1:0] arg_idx;
+
+  logic cmd_push, cmd_pop, cmd_full, cmd_empty;
+  logic [CmdUsageWidth-1:0] cmd_usage;
+  logic [CmdWidth-1:0] cmd_in, cmd_out;
+
+  logic cpl_push, cpl_pop, cpl_full, cpl_empty;
+  logic [CplUsageWidth-1:0] cpl_usage;
+  logic [CplWidth-1:0] cpl_out;
+
+  logic [7:0] free_slots, waiting;
+
+  assign reg_addr = reg_req_i.addr[7:0];
+  assign reg_write = reg_req_i.valid && reg_req_i.write;
+  assign reg_read = reg_req_i.valid && !reg_req_i.write;
+  assign arg_sel = reg_addr >= ArgOffset && reg_addr < ArgOffset + 8'(4 * NUM_ARGS);
+  assign arg_idx = ArgIdxWidth'((reg_addr - ArgOffset) >> 2);
+
+  assign cmd_in = {reg_req_i.wdata[15:8], reg_req_i.wdata[7:0], args_q};
+  assign cmd_push = reg_write && reg_addr == DoorbellOffset && !cmd_full;
+  assign cmd_pop = cmd_valid_o && cmd_ready_i;
+
+  assign cmd_valid_o = !cmd_empty;
+  assign {cmd_tag_o, cmd_opcode_o, cmd_args_o} = cmd_out;
+
+  assign cpl_ready_o = !cpl_full;
+  assign cpl_push = cpl_valid_i && cpl_ready_o;
+  assign cpl_pop = reg_read && reg_addr == CompletionOffset && !cpl_empty;
+
+  assign free_slots = cmd_full ? 8'd0 : 8'(CMD_DEPTH) - 8'(cmd_usage);
+  assign waiting = cpl_full ? 8'(CPL_DEPTH) : 8'(cpl_usage);
+
+  assign intr_o = irq_en_q && !cpl_empty;
+
+  always_comb begin
+    reg_rsp_o.rdata = '0;
+    reg_rsp_o.error = 1'b0;
+    reg_rsp_o.ready = 1'b1;
+
+    if (reg_read) begin
+      if (reg_addr == IdOffset) begin
+        reg_rsp_o.rdata = ACC_ID;
+      end else if (reg_addr == StatusOffset) begin
+        reg_rsp_o.rdata = {14'h0, overflow_q, outstanding_q != '0, waiting, free_slots};
+      end else if (reg_addr == CtrlOffset) begin
+        reg_rsp_o.rdata = {31'h0, irq_en_q};
+      end else if (reg_addr == CompletionOffset) begin
+        reg_rsp_o.rdata = {!cpl_empty, 7'h0, cpl_empty ? 24'h0 : cpl_out};
+      end else if (arg_sel) begin
+        reg_rsp_o.rdata = args_q[arg_idx];
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      args_q <= '0;
+      irq_en_q <= 1'b0;
+      overflow_q <= 1'b0;
+    end else begin
+      if (reg_write && arg_sel) begin
+        args_q[arg_idx] <= reg_req_i.wdata;
+      end
+      if (reg_write && reg_addr == CtrlOffset) begin
+        irq_en_q <= reg_req_i.wdata[0];
+        if (reg_req_i.wdata[1]) overflow_q <= 1'b0;
+      end
+      if (reg_write && reg_addr == DoorbellOffset && cmd_full) begin
+        overflow_q <= 1'b1;
+      end
+    end
+  end
+
+  // Jobs taken by the accelerator and not completed yet
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      outstanding_q <= '0;
+    end else begin
+      outstanding_q <= outstanding_q + 8'(cmd_pop) - 8'(cpl_push);
+    end
+  end
+
+  fifo_v3 #(
+      .DATA_WIDTH(CmdWidth),
+      .DEPTH(CMD_DEPTH)
+  ) cmd_fifo_i (
+      .clk_i,
+      .rst_ni,
+      .flush_i(1'b0),
+      .testmode_i(1'b0),
+      .full_o(cmd_full),
+      .empty_o(cmd_empty),
+      .usage_o(cmd_usage),
+      .data_i(cmd_in),
+      .push_i(cmd_push),
+      .data_o(cmd_out),
+      .pop_i(cmd_pop)
+  );
+
+  fifo_v3 #(
+      .DATA_WIDTH(CplWidth),
+      .DEPTH(CPL_DEPTH)
+  ) cpl_fifo_i (
+      .clk_i,
+      .rst_ni,
+      .flush_i(1'b0),
+      .testmode_i(1'b0),
+      .full_o(cpl_full),
+      .empty_o(cpl_empty),
+      .usage_o(cpl_usage),
+      .data_i({cpl_tag_i, cpl_status_i}),
+      .push_i(cpl_push),
+      .data_o(cpl_out),
+      .pop_i(cpl_pop)
+  );
+
+endmodule
@@ -1,6 +1,6 @@
 // Auto-generated code
 
-const int reset_vec_size = 59;
+const int reset_vec_size = 172;
 
 uint32_t reset_vec[reset_vec_size] = {
     0x200405b7,
@@ -8,58 +8,171 @@ uint32_t reset_vec[reset_vec_size] = {
     0x41c8c119,
     0x05b79502,
     0xc5032000,
-    0xe5110085,
-    0x00c5c503,
-    0x498cd175,
-    0xc5039582,
-    0xc9110145,
-    0x200285b7,
-    0xc1884505,
-    0x400005b7,
-    0x18058593,
-    0x05b79582,
-    0x05372002,
-    0x4998a000,
-    0xc9988f49,
-    0x0fff0737,
-    0xcd980705,
-    0xd1884501,
-    0x77134998,
-    0x6713f007,
-    0xc9980087,
-    0x0ab00713,
-    0x0737d5d8,
-    0x070d1000,
-    0x49d8d1d8,
-    0xfe075fe3,
-    0xd5d8470d,
-    0x49d80001,
-    0xfe075fe3,
-    0x11000737,
+    0x17630085,
+    0x25031c05,
+    0x53371780,
+    0x03135242,
+    0x15638583,
+    0x25030065,
+    0x950217c0,
+    0x200a02b7,
+    0xfbaa0337,
+    0xa623030d,
+    0x5e370062,
+    0x0e134c55,
+    0xc503858e,
+    0xe51d00c5,
+    0x0102a303,
+    0x02037313,
+    0x00031c63,
+    0x0142a303,
+    0x0ffe7393,
+    0xfc731fe3,
+    0x008e5e13,
+    0x000e0c63,
+    0x20040637,
+    0x00064503,
+    0xb769d969,
+    0x0002a623,
+    0x9582498c,
+    0x842a2a35,
+    0x84aa2a25,
+    0x892a2a15,
+    0x89aa2a05,
+    0x8a2a2235,
+    0x8aaa2225,
+    0x20030637,
+    0x01428313,
+    0x00662023,
+    0x00062c23,
+    0x20234305,
+    0x43090266,
+    0x02662623,
+    0x02662823,
+    0x10000313,
+    0x02662423,
+    0x874e86ca,
+    0x63a1c31d,
+    0x00777363,
+    0xc25483ba,
+    0x00762623,
+    0x23030001,
+    0x73130146,
+    0x0ce30013,
+    0x969efe03,
+    0x40770733,
+    0x8837bff1,
+    0x0813edb8,
+    0x557d3208,
+    0x073386ca,
+    0x85630139,
+    0xc30302e6,
+    0x06850006,
+    0x00654533,
+    0x731343a1,
+    0x81050015,
+    0x40600333,
+    0x01037333,
+    0x00654533,
+    0x96e313fd,
+    0xbfe1fe03,
+    0xfff54513,
+    0x04b00313,
+    0x01450763,
+    0x04e00313,
+    0x0062ac23,
+    0xac23b719,
+    0x86ca0062,
+    0x07b38722,
+    0x7c630094,
+    0xc80304f7,
+    0x06850006,
+    0x00485313,
+    0x0a632881,
+    0xc3830003,
+    0x00230006,
+    0x06850077,
+    0x137d0705,
+    0xc883b7fd,
+    0xc3830006,
+    0x06890016,
+    0xe8b303a2,
+    0x86e30078,
+    0x7313fc08,
+    0x200d00f8,
+    0x08b30311,
+    0xc3834117,
+    0x00230008,
+    0x08850077,
+    0x137d0705,
+    0xfe0319e3,
+    0x100fb76d,
+    0x9a820000,
+    0x1a6343bd,
+    0xc3830073,
+    0x06850006,
+    0x8393931e,
+    0x8ae3f013,
+    0x8082fe03,
+    0x43814501,
+    0x02000e93,
+    0x0102a303,
+    0x02037313,
+    0xfe031ce3,
+    0x0142a303,
+    0x00731333,
+    0x00656533,
+    0x93e303a1,
+    0x8082ffd3,
+    0x0145c503,
+    0x85b7c911,
+    0x45052002,
+    0x05b7c188,
+    0x85934000,
+    0x95821805,
+    0x200205b7,
+    0xa0000537,
+    0x8f494998,
+    0x0737c998,
+    0x07050fff,
+    0x4501cd98,
+    0x4998d188,
+    0xf0077713,
+    0x00876713,
+    0x0713c998,
+    0xd5d80ab0,
+    0x10000737,
     0xd1d8070d,
-    0x49dc0001,
-    0xfe07dfe3,
-    0x86936685,
-    0x44818006,
-    0x10000b13,
-    0x09000437,
-    0x0ff40a93,
-    0x00db4663,
-    0x08000437,
-    0x0ff40a93,
-    0x0355a223,
-    0x49dc0001,
-    0xfe07dfe3,
-    0x10048b93,
-    0x83d149dc,
-    0xdfed8b85,
-    0x02048613,
-    0x0285a883,
-    0x0114a023,
-    0x9be30491,
-    0x93e3fec4,
-    0x8693ff74,
-    0xf2e9f006,
-    0x200005b7,
-    0x96024990
+    0x5fe349d8,
+    0x470dfe07,
+    0x0001d5d8,
+    0x5fe349d8,
+    0x0737fe07,
+    0x070d1100,
+    0x0001d1d8,
+    0xdfe349dc,
+    0x6685fe07,
+    0x80068693,
+    0x0b134481,
+    0x04371000,
+    0x0a930900,
+    0x46630ff4,
+    0x043700db,
+    0x0a930800,
+    0xa2230ff4,
+    0x00010355,
+    0xdfe349dc,
+    0x8b93fe07,
+    0x49dc1004,
+    0x8b8583d1,
+    0x8613dfed,
+    0xa8830204,
+    0xa0230285,
+    0x04910114,
+    0xfec49be3,
+    0xff7493e3,
+    0xf0068693,
+    0x05b7f2e9,
+    0x49902000,
+    0x00009602
 };
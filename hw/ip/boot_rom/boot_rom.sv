@@ -22,64 +22,177 @@ module boot_rom
 );
   import core_v_mini_mcu_pkg::*;
 
-  localparam int unsigned RomSize = 59;
+  localparam int unsigned RomSize = 172;
 
   logic [RomSize-1:0][31:0] mem;
   assign mem = {
-    32'h96024990,
-    32'h200005b7,
-    32'hf2e9f006,
-    32'h8693ff74,
-    32'h93e3fec4,
-    32'h9be30491,
-    32'h0114a023,
-    32'h0285a883,
-    32'h02048613,
-    32'hdfed8b85,
-    32'h83d149dc,
-    32'h10048b93,
-    32'hfe07dfe3,
-    32'h49dc0001,
-    32'h0355a223,
-    32'h0ff40a93,
-    32'h08000437,
-    32'h00db4663,
-    32'h0ff40a93,
-    32'h09000437,
-    32'h10000b13,
-    32'h44818006,
-    32'h86936685,
-    32'hfe07dfe3,
-    32'h49dc0001,
+    32'h00009602,
+    32'h49902000,
+    32'h05b7f2e9,
+    32'hf0068693,
+    32'hff7493e3,
+    32'hfec49be3,
+    32'h04910114,
+    32'ha0230285,
+    32'ha8830204,
+    32'h8613dfed,
+    32'h8b8583d1,
+    32'h49dc1004,
+    32'h8b93fe07,
+    32'hdfe349dc,
+    32'h00010355,
+    32'ha2230ff4,
+    32'h0a930800,
+    32'h043700db,
+    32'h46630ff4,
+    32'h0a930900,
+    32'h04371000,
+    32'h0b134481,
+    32'h80068693,
+    32'h6685fe07,
+    32'hdfe349dc,
+    32'h0001d1d8,
+    32'h070d1100,
+    32'h0737fe07,
+    32'h5fe349d8,
+    32'h0001d5d8,
+    32'h470dfe07,
+    32'h5fe349d8,
     32'hd1d8070d,
-    32'h11000737,
-    32'hfe075fe3,
-    32'h49d80001,
-    32'hd5d8470d,
-    32'hfe075fe3,
-    32'h49d8d1d8,
-    32'h070d1000,
-    32'h0737d5d8,
-    32'h0ab00713,
-    32'hc9980087,
-    32'h6713f007,
-    32'h77134998,
-    32'hd1884501,
-    32'hcd980705,
-    32'h0fff0737,
-    32'hc9988f49,
-    32'h4998a000,
-    32'h05372002,
-    32'h05b79582,
-    32'h18058593,
-    32'h400005b7,
-    32'hc1884505,
-    32'h200285b7,
-    32'hc9110145,
-    32'hc5039582,
-    32'h498cd175,
-    32'h00c5c503,
-    32'he5110085,
+    32'h10000737,
+    32'hd5d80ab0,
+    32'h0713c998,
+    32'h00876713,
+    32'hf0077713,
+    32'h4998d188,
+    32'h4501cd98,
+    32'h07050fff,
+    32'h0737c998,
+    32'h8f494998,
+    32'ha0000537,
+    32'h200205b7,
+    32'h95821805,
+    32'h85934000,
+    32'h05b7c188,
+    32'h45052002,
+    32'h85b7c911,
+    32'h0145c503,
+    32'h8082ffd3,
+    32'h93e303a1,
+    32'h00656533,
+    32'h00731333,
+    32'h0142a303,
+    32'hfe031ce3,
+    32'h02037313,
+    32'h0102a303,
+    32'h02000e93,
+    32'h43814501,
+    32'h8082fe03,
+    32'h8ae3f013,
+    32'h8393931e,
+    32'h06850006,
+    32'hc3830073,
+    32'h1a6343bd,
+    32'h9a820000,
+    32'h100fb76d,
+    32'hfe0319e3,
+    32'h137d0705,
+    32'h08850077,
+    32'h00230008,
+    32'hc3834117,
+    32'h08b30311,
+    32'h200d00f8,
+    32'h7313fc08,
+    32'h86e30078,
+    32'he8b303a2,
+    32'h06890016,
+    32'hc3830006,
+    32'hc883b7fd,
+    32'h137d0705,
+    32'h06850077,
+    32'h00230006,
+    32'hc3830003,
+    32'h0a632881,
+    32'h00485313,
+    32'h06850006,
+    32'hc80304f7,
+    32'h7c630094,
+    32'h07b38722,
+    32'h86ca0062,
+    32'hac23b719,
+    32'h0062ac23,
+    32'h04e00313,
+    32'h01450763,
+    32'h04b00313,
+    32'hfff54513,
+    32'hbfe1fe03,
+    32'h96e313fd,
+    32'h00654533,
+    32'h01037333,
+    32'h40600333,
+    32'h81050015,
+    32'h731343a1,
+    32'h00654533,
+    32'h06850006,
+    32'hc30302e6,
+    32'h85630139,
+    32'h073386ca,
+    32'h557d3208,
+    32'h0813edb8,
+    32'h8837bff1,
+    32'h40770733,
+    32'h969efe03,
+    32'h0ce30013,
+    32'h73130146,
+    32'h23030001,
+    32'h00762623,
+    32'hc25483ba,
+    32'h00777363,
+    32'h63a1c31d,
+    32'h874e86ca,
+    32'h02662423,
+    32'h10000313,
+    32'h02662823,
+    32'h02662623,
+    32'h43090266,
+    32'h20234305,
+    32'h00062c23,
+    32'h00662023,
+    32'h01428313,
+    32'h20030637,
+    32'h8aaa2225,
+    32'h8a2a2235,
+    32'h89aa2a05,
+    32'h892a2a15,
+    32'h84aa2a25,
+    32'h842a2a35,
+    32'h9582498c,
+    32'h0002a623,
+    32'hb769d969,
+    32'h00064503,
+    32'h20040637,
+    32'h000e0c63,
+    32'h008e5e13,
+    32'hfc731fe3,
+    32'h0ffe7393,
+    32'h0142a303,
+    32'h00031c63,
+    32'h02037313,
+    32'h0102a303,
+    32'he51d00c5,
+    32'hc503858e,
+    32'h0e134c55,
+    32'h5e370062,
+    32'ha623030d,
+    32'hfbaa0337,
+    32'h200a02b7,
+    32'h950217c0,
+    32'h25030065,
+    32'h15638583,
+    32'h03135242,
+    32'h53371780,
+    32'h25031c05,
+    32'h17630085,
     32'hc5032000,
     32'h05b79502,
     32'h41c8c119,
@@ -0,0 +1,128 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Description: Control of the harts of the cluster. It holds the boot address
+//              and the fetch enables of the extra harts, their software
+//              interrupts, a hardware barrier and test-and-set mutexes.
+//              Hart 0 is the main core, it always fetches and its software
+//              interrupt stays with the PLIC.
+
+module cluster_ctrl #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter int unsigned NUM_HARTS = 1,
+    parameter int unsigned NUM_MUTEX = 8
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Register interface
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    // To the harts
+    output logic [         31:0] boot_addr_o,
+    output logic [NUM_HARTS-1:0] fetch_enable_o,
+    output logic [NUM_HARTS-1:0] sw_irq_o
+);
+
+  import cluster_ctrl_reg_pkg::*;
+
+  // Harts present, hart 0 excluded for the software interrupts
+  localparam logic [7:0] HartsMask = 8'((1 << NUM_HARTS) - 1);
+  localparam logic [7:0] ExtraHartsMask = HartsMask & ~8'h1;
+
+  cluster_ctrl_reg2hw_t                          reg2hw;
+  cluster_ctrl_hw2reg_t                          hw2reg;
+
+  reg_req_t             [                   0:0] mutex_win_h2d;
+  reg_rsp_t             [                   0:0] mutex_win_d2h;
+
+  logic                 [                   7:0] sw_irq_q;
+  logic                 [                   7:0] sw_irq_d;
+  logic                 [                   7:0] arrived_q;
+  logic                 [                   7:0] arrived_next;
+  logic                 [                   7:0] barrier_mask;
+  logic                                          barrier_done;
+  logic                                          gen_q;
+  logic                 [         NUM_MUTEX-1:0] mutex_q;
+  logic                 [$clog2(NUM_MUTEX)-1:0] mutex_idx;
+
+  assign boot_addr_o = {reg2hw.boot_addr.q[31:8], 8'h00};
+  assign fetch_enable_o = {reg2hw.fetch_en.q[NUM_HARTS-1:0] | NUM_HARTS'(1)};
+
+  // A write to BARRIER adds the harts of its bits, the barrier completes when
+  // all the harts of the mask have arrived
+  assign barrier_mask = reg2hw.barrier_mask.q & HartsMask;
+  assign arrived_next = arrived_q | (reg2hw.barrier.qe ? reg2hw.barrier.q & HartsMask : 8'h0);
+  assign barrier_done = reg2hw.barrier.qe && (barrier_mask != 8'h0)
+                        && ((arrived_next & barrier_mask) == barrier_mask);
+
+  always_ff @(posedge clk_i, negedge rst_ni) begin
+    if (~rst_ni) begin
+      arrived_q <= '0;
+      gen_q     <= 1'b0;
+    end else if (barrier_done) begin
+      arrived_q <= '0;
+      gen_q     <= ~gen_q;
+    end else if (reg2hw.barrier.qe) begin
+      arrived_q <= arrived_next;
+    end
+  end
+
+  // The completion of the barrier wakes up the extra harts waiting for it
+  always_comb begin
+    sw_irq_d = sw_irq_q;
+    if (reg2hw.sw_irq_set.qe) sw_irq_d = sw_irq_d | reg2hw.sw_irq_set.q;
+    if (reg2hw.sw_irq_clear.qe) sw_irq_d = sw_irq_d & ~reg2hw.sw_irq_clear.q;
+    if (barrier_done) sw_irq_d = sw_irq_d | barrier_mask;
+  end
+
+  always_ff @(posedge clk_i, negedge rst_ni) begin
+    if (~rst_ni) begin
+      sw_irq_q <= '0;
+    end else begin
+      sw_irq_q <= sw_irq_d & ExtraHartsMask;
+    end
+  end
+
+  assign sw_irq_o = sw_irq_q[NUM_HARTS-1:0];
+
+  assign hw2reg.sw_irq_set.d = sw_irq_q;
+  assign hw2reg.sw_irq_clear.d = sw_irq_q;
+  assign hw2reg.barrier.d = arrived_q;
+  assign hw2reg.barrier_gen.d = gen_q;
+
+  // Mutexes: a read returns the state and takes the mutex, a write frees it.
+  // The peripheral bus serializes the accesses, so the read is atomic.
+  assign mutex_idx = mutex_win_h2d[0].addr[2+:$clog2(NUM_MUTEX)];
+
+  always_ff @(posedge clk_i, negedge rst_ni) begin
+    if (~rst_ni) begin
+      mutex_q <= '0;
+    end else if (mutex_win_h2d[0].valid) begin
+      mutex_q[mutex_idx] <= ~mutex_win_h2d[0].write;
+    end
+  end
+
+  assign mutex_win_d2h[0].rdata = {31'h0, mutex_q[mutex_idx]};
+  assign mutex_win_d2h[0].error = 1'b0;
+  assign mutex_win_d2h[0].ready = 1'b1;
+
+  cluster_ctrl_reg_top #(
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t)
+  ) cluster_ctrl_reg_top_i (
+      .clk_i,
+      .rst_ni,
+      .reg_req_win_o(mutex_win_h2d),
+      .reg_rsp_win_i(mutex_win_d2h),
+      .reg_req_i,
+      .reg_rsp_o,
+      .reg2hw,
+      .hw2reg,
+      .devmode_i(1'b1)
+  );
+
+endmodule : cluster_ctrl
@@ -0,0 +1,104 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Register Package auto-generated by `reggen` containing data structure
+
+package cluster_ctrl_reg_pkg;
+
+  // Address widths within the block
+  parameter int BlockAw = 6;
+
+  ////////////////////////////
+  // Typedefs for registers //
+  ////////////////////////////
+
+  typedef struct packed {logic [31:0] q;} cluster_ctrl_reg2hw_boot_addr_reg_t;
+
+  typedef struct packed {logic [7:0] q;} cluster_ctrl_reg2hw_fetch_en_reg_t;
+
+  typedef struct packed {
+    logic [7:0] q;
+    logic       qe;
+  } cluster_ctrl_reg2hw_sw_irq_set_reg_t;
+
+  typedef struct packed {
+    logic [7:0] q;
+    logic       qe;
+  } cluster_ctrl_reg2hw_sw_irq_clear_reg_t;
+
+  typedef struct packed {logic [7:0] q;} cluster_ctrl_reg2hw_barrier_mask_reg_t;
+
+  typedef struct packed {
+    logic [7:0] q;
+    logic       qe;
+  } cluster_ctrl_reg2hw_barrier_reg_t;
+
+  typedef struct packed {logic [7:0] d;} cluster_ctrl_hw2reg_sw_irq_set_reg_t;
+
+  typedef struct packed {logic [7:0] d;} cluster_ctrl_hw2reg_sw_irq_clear_reg_t;
+
+  typedef struct packed {logic [7:0] d;} cluster_ctrl_hw2reg_barrier_reg_t;
+
+  typedef struct packed {logic d;} cluster_ctrl_hw2reg_barrier_gen_reg_t;
+
+  // Register -> HW type
+  typedef struct packed {
+    cluster_ctrl_reg2hw_boot_addr_reg_t    boot_addr;     // [74:43]
+    cluster_ctrl_reg2hw_fetch_en_reg_t     fetch_en;      // [42:35]
+    cluster_ctrl_reg2hw_sw_irq_set_reg_t   sw_irq_set;    // [34:26]
+    cluster_ctrl_reg2hw_sw_irq_clear_reg_t sw_irq_clear;  // [25:17]
+    cluster_ctrl_reg2hw_barrier_mask_reg_t barrier_mask;  // [16:9]
+    cluster_ctrl_reg2hw_barrier_reg_t      barrier;       // [8:0]
+  } cluster_ctrl_reg2hw_t;
+
+  // HW -> register type
+  typedef struct packed {
+    cluster_ctrl_hw2reg_sw_irq_set_reg_t   sw_irq_set;    // [24:17]
+    cluster_ctrl_hw2reg_sw_irq_clear_reg_t sw_irq_clear;  // [16:9]
+    cluster_ctrl_hw2reg_barrier_reg_t      barrier;       // [8:1]
+    cluster_ctrl_hw2reg_barrier_gen_reg_t  barrier_gen;   // [0:0]
+  } cluster_ctrl_hw2reg_t;
+
+  // Register offsets
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_BOOT_ADDR_OFFSET = 6'h0;
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_FETCH_EN_OFFSET = 6'h4;
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_SW_IRQ_SET_OFFSET = 6'h8;
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_SW_IRQ_CLEAR_OFFSET = 6'hc;
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_BARRIER_MASK_OFFSET = 6'h10;
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_BARRIER_OFFSET = 6'h14;
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_BARRIER_GEN_OFFSET = 6'h18;
+
+  // Reset values for hwext registers and their fields
+  parameter logic [7:0] CLUSTER_CTRL_SW_IRQ_SET_RESVAL = 8'h0;
+  parameter logic [7:0] CLUSTER_CTRL_SW_IRQ_CLEAR_RESVAL = 8'h0;
+  parameter logic [7:0] CLUSTER_CTRL_BARRIER_RESVAL = 8'h0;
+  parameter logic [0:0] CLUSTER_CTRL_BARRIER_GEN_RESVAL = 1'h0;
+
+  // Window parameters
+  parameter logic [BlockAw-1:0] CLUSTER_CTRL_MUTEX_OFFSET = 6'h20;
+  parameter int unsigned CLUSTER_CTRL_MUTEX_SIZE = 'h20;
+
+  // Register index
+  typedef enum int {
+    CLUSTER_CTRL_BOOT_ADDR,
+    CLUSTER_CTRL_FETCH_EN,
+    CLUSTER_CTRL_SW_IRQ_SET,
+    CLUSTER_CTRL_SW_IRQ_CLEAR,
+    CLUSTER_CTRL_BARRIER_MASK,
+    CLUSTER_CTRL_BARRIER,
+    CLUSTER_CTRL_BARRIER_GEN
+  } cluster_ctrl_id_e;
+
+  // Register width information to check illegal writes
+  parameter logic [3:0] CLUSTER_CTRL_PERMIT[7] = '{
+      4'b1111,  // index[0] CLUSTER_CTRL_BOOT_ADDR
+      4'b0001,  // index[1] CLUSTER_CTRL_FETCH_EN
+      4'b0001,  // index[2] CLUSTER_CTRL_SW_IRQ_SET
+      4'b0001,  // index[3] CLUSTER_CTRL_SW_IRQ_CLEAR
+      4'b0001,  // index[4] CLUSTER_CTRL_BARRIER_MASK
+      4'b0001,  // index[5] CLUSTER_CTRL_BARRIER
+      4'b0001  // index[6] CLUSTER_CTRL_BARRIER_GEN
+  };
+
+endpackage
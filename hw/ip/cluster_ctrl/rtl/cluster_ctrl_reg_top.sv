@@ -0,0 +1,443 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Register Top module auto-generated by `reggen`
+
+
+`include "common_cells/assertions.svh"
+
+module cluster_ctrl_reg_top #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter int AW = 6
+) (
+    input logic clk_i,
+    input logic rst_ni,
+    input reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    // Output port for window
+    output reg_req_t [1-1:0] reg_req_win_o,
+    input  reg_rsp_t [1-1:0] reg_rsp_win_i,
+
+    // To HW
+    output cluster_ctrl_reg_pkg::cluster_ctrl_reg2hw_t reg2hw,  // Write
+    input  cluster_ctrl_reg_pkg::cluster_ctrl_hw2reg_t hw2reg,  // Read
+
+
+    // Config
+    input devmode_i  // If 1, explicit error return for unmapped register access
+);
+
+  import cluster_ctrl_reg_pkg::*;
+
+  localparam int DW = 32;
+  localparam int DBW = DW / 8;  // Byte Width
+
+  // register signals
+  logic           reg_we;
+  logic           reg_re;
+  logic [ AW-1:0] reg_addr;
+  logic [ DW-1:0] reg_wdata;
+  logic [DBW-1:0] reg_be;
+  logic [ DW-1:0] reg_rdata;
+  logic           reg_error;
+
+  logic addrmiss, wr_err;
+
+  logic [DW-1:0] reg_rdata_next;
+
+  // Below register interface can be changed
+  reg_req_t reg_intf_req;
+  reg_rsp_t reg_intf_rsp;
+
+
+  logic [0:0] reg_steer;
+
+  reg_req_t [2-1:0] reg_intf_demux_req;
+  reg_rsp_t [2-1:0] reg_intf_demux_rsp;
+
+  // demux connection
+  assign reg_intf_req = reg_intf_demux_req[1];
+  assign reg_intf_demux_rsp[1] = reg_intf_rsp;
+
+  assign reg_req_win_o[0] = reg_intf_demux_req[0];
+  assign reg_intf_demux_rsp[0] = reg_rsp_win_i[0];
+
+  // Create Socket_1n
+  reg_demux #(
+      .NoPorts(2),
+      .req_t  (reg_req_t),
+      .rsp_t  (reg_rsp_t)
+  ) i_reg_demux (
+      .clk_i,
+      .rst_ni,
+      .in_req_i(reg_req_i),
+      .in_rsp_o(reg_rsp_o),
+      .out_req_o(reg_intf_demux_req),
+      .out_rsp_i(reg_intf_demux_rsp),
+      .in_select_i(reg_steer)
+  );
+
+
+  // Create steering logic
+  always_comb begin
+    reg_steer = 1;  // Default set to register
+
+    // TODO: Can below codes be unique case () inside ?
+    if (reg_req_i.addr[AW-1:0] >= 32 && reg_req_i.addr[AW-1:0] < 64) begin
+      reg_steer = 0;
+    end
+  end
+
+
+  assign reg_we = reg_intf_req.valid & reg_intf_req.write;
+  assign reg_re = reg_intf_req.valid & ~reg_intf_req.write;
+  assign reg_addr = reg_intf_req.addr;
+  assign reg_wdata = reg_intf_req.wdata;
+  assign reg_be = reg_intf_req.wstrb;
+  assign reg_intf_rsp.rdata = reg_rdata;
+  assign reg_intf_rsp.error = reg_error;
+  assign reg_intf_rsp.ready = 1'b1;
+
+  assign reg_rdata = reg_rdata_next;
+  assign reg_error = (devmode_i & addrmiss) | wr_err;
+
+
+  // Define SW related signals
+  // Format: <reg>_<field>_{wd|we|qs}
+  //        or <reg>_{wd|we|qs} if field == 1 or 0
+  logic [31:0] boot_addr_qs;
+  logic [31:0] boot_addr_wd;
+  logic boot_addr_we;
+  logic [7:0] fetch_en_qs;
+  logic [7:0] fetch_en_wd;
+  logic fetch_en_we;
+  logic [7:0] sw_irq_set_qs;
+  logic [7:0] sw_irq_set_wd;
+  logic sw_irq_set_we;
+  logic sw_irq_set_re;
+  logic [7:0] sw_irq_clear_qs;
+  logic [7:0] sw_irq_clear_wd;
+  logic sw_irq_clear_we;
+  logic sw_irq_clear_re;
+  logic [7:0] barrier_mask_qs;
+  logic [7:0] barrier_mask_wd;
+  logic barrier_mask_we;
+  logic [7:0] barrier_qs;
+  logic [7:0] barrier_wd;
+  logic barrier_we;
+  logic barrier_re;
+  logic barrier_gen_qs;
+  logic barrier_gen_re;
+
+  // Register instances
+  // R[boot_addr]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_boot_addr (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(boot_addr_we),
+      .wd(boot_addr_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.boot_addr.q),
+
+      // to register interface (read)
+      .qs(boot_addr_qs)
+  );
+
+
+  // R[fetch_en]: V(False)
+
+  prim_subreg #(
+      .DW      (8),
+      .SWACCESS("RW"),
+      .RESVAL  (8'h0)
+  ) u_fetch_en (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(fetch_en_we),
+      .wd(fetch_en_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.fetch_en.q),
+
+      // to register interface (read)
+      .qs(fetch_en_qs)
+  );
+
+
+  // R[sw_irq_set]: V(True)
+
+  prim_subreg_ext #(
+      .DW(8)
+  ) u_sw_irq_set (
+      .re (sw_irq_set_re),
+      .we (sw_irq_set_we),
+      .wd (sw_irq_set_wd),
+      .d  (hw2reg.sw_irq_set.d),
+      .qre(),
+      .qe (reg2hw.sw_irq_set.qe),
+      .q  (reg2hw.sw_irq_set.q),
+      .qs (sw_irq_set_qs)
+  );
+
+
+  // R[sw_irq_clear]: V(True)
+
+  prim_subreg_ext #(
+      .DW(8)
+  ) u_sw_irq_clear (
+      .re (sw_irq_clear_re),
+      .we (sw_irq_clear_we),
+      .wd (sw_irq_clear_wd),
+      .d  (hw2reg.sw_irq_clear.d),
+      .qre(),
+      .qe (reg2hw.sw_irq_clear.qe),
+      .q  (reg2hw.sw_irq_clear.q),
+      .qs (sw_irq_clear_qs)
+  );
+
+
+  // R[barrier_mask]: V(False)
+
+  prim_subreg #(
+      .DW      (8),
+      .SWACCESS("RW"),
+      .RESVAL  (8'hff)
+  ) u_barrier_mask (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(barrier_mask_we),
+      .wd(barrier_mask_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.barrier_mask.q),
+
+      // to register interface (read)
+      .qs(barrier_mask_qs)
+  );
+
+
+  // R[barrier]: V(True)
+
+  prim_subreg_ext #(
+      .DW(8)
+  ) u_barrier (
+      .re (barrier_re),
+      .we (barrier_we),
+      .wd (barrier_wd),
+      .d  (hw2reg.barrier.d),
+      .qre(),
+      .qe (reg2hw.barrier.qe),
+      .q  (reg2hw.barrier.q),
+      .qs (barrier_qs)
+  );
+
+
+  // R[barrier_gen]: V(True)
+
+  prim_subreg_ext #(
+      .DW(1)
+  ) u_barrier_gen (
+      .re (barrier_gen_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.barrier_gen.d),
+      .qre(),
+      .qe (),
+      .q  (),
+      .qs (barrier_gen_qs)
+  );
+
+
+
+
+  logic [6:0] addr_hit;
+  always_comb begin
+    addr_hit = '0;
+    addr_hit[0] = (reg_addr == CLUSTER_CTRL_BOOT_ADDR_OFFSET);
+    addr_hit[1] = (reg_addr == CLUSTER_CTRL_FETCH_EN_OFFSET);
+    addr_hit[2] = (reg_addr == CLUSTER_CTRL_SW_IRQ_SET_OFFSET);
+    addr_hit[3] = (reg_addr == CLUSTER_CTRL_SW_IRQ_CLEAR_OFFSET);
+    addr_hit[4] = (reg_addr == CLUSTER_CTRL_BARRIER_MASK_OFFSET);
+    addr_hit[5] = (reg_addr == CLUSTER_CTRL_BARRIER_OFFSET);
+    addr_hit[6] = (reg_addr == CLUSTER_CTRL_BARRIER_GEN_OFFSET);
+  end
+
+  assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0;
+
+  // Check sub-word write is permitted
+  always_comb begin
+    wr_err = (reg_we &
+              ((addr_hit[0] & (|(CLUSTER_CTRL_PERMIT[0] & ~reg_be))) |
+               (addr_hit[1] & (|(CLUSTER_CTRL_PERMIT[1] & ~reg_be))) |
+               (addr_hit[2] & (|(CLUSTER_CTRL_PERMIT[2] & ~reg_be))) |
+               (addr_hit[3] & (|(CLUSTER_CTRL_PERMIT[3] & ~reg_be))) |
+               (addr_hit[4] & (|(CLUSTER_CTRL_PERMIT[4] & ~reg_be))) |
+               (addr_hit[5] & (|(CLUSTER_CTRL_PERMIT[5] & ~reg_be))) |
+               (addr_hit[6] & (|(CLUSTER_CTRL_PERMIT[6] & ~reg_be)))));
+  end
+
+  assign boot_addr_we = addr_hit[0] & reg_we & !reg_error;
+  assign boot_addr_wd = reg_wdata[31:0];
+
+  assign fetch_en_we = addr_hit[1] & reg_we & !reg_error;
+  assign fetch_en_wd = reg_wdata[7:0];
+
+  assign sw_irq_set_we = addr_hit[2] & reg_we & !reg_error;
+  assign sw_irq_set_wd = reg_wdata[7:0];
+  assign sw_irq_set_re = addr_hit[2] & reg_re & !reg_error;
+
+  assign sw_irq_clear_we = addr_hit[3] & reg_we & !reg_error;
+  assign sw_irq_clear_wd = reg_wdata[7:0];
+  assign sw_irq_clear_re = addr_hit[3] & reg_re & !reg_error;
+
+  assign barrier_mask_we = addr_hit[4] & reg_we & !reg_error;
+  assign barrier_mask_wd = reg_wdata[7:0];
+
+  assign barrier_we = addr_hit[5] & reg_we & !reg_error;
+  assign barrier_wd = reg_wdata[7:0];
+  assign barrier_re = addr_hit[5] & reg_re & !reg_error;
+
+  assign barrier_gen_re = addr_hit[6] & reg_re & !reg_error;
+
+  // Read data return
+  always_comb begin
+    reg_rdata_next = '0;
+    unique case (1'b1)
+      addr_hit[0]: begin
+        reg_rdata_next[31:0] = boot_addr_qs;
+      end
+
+      addr_hit[1]: begin
+        reg_rdata_next[7:0] = fetch_en_qs;
+      end
+
+      addr_hit[2]: begin
+        reg_rdata_next[7:0] = sw_irq_set_qs;
+      end
+
+      addr_hit[3]: begin
+        reg_rdata_next[7:0] = sw_irq_clear_qs;
+      end
+
+      addr_hit[4]: begin
+        reg_rdata_next[7:0] = barrier_mask_qs;
+      end
+
+      addr_hit[5]: begin
+        reg_rdata_next[7:0] = barrier_qs;
+      end
+
+      addr_hit[6]: begin
+        reg_rdata_next[0] = barrier_gen_qs;
+      end
+
+      default: begin
+        reg_rdata_next = '1;
+      end
+    endcase
+  end
+
+  // Unused signal tieoff
+
+  // wdata / byte enable are not always fully used
+  // add a blanket unused statement to handle lint waivers
+  logic unused_wdata;
+  logic unused_be;
+  assign unused_wdata = ^reg_wdata;
+  assign unused_be = ^reg_be;
+
+  // Assertions for Register Interface
+  `ASSERT(en2addrHit, (reg_we || reg_re) |-> $onehot0(addr_hit))
+
+endmodule
+
+module cluster_ctrl_reg_top_intf #(
+    parameter  int AW = 6,
+    localparam int DW = 32
+) (
+    input logic clk_i,
+    input logic rst_ni,
+    REG_BUS.in regbus_slave,
+    REG_BUS.out regbus_win_mst[1-1:0],
+    // To HW
+    output cluster_ctrl_reg_pkg::cluster_ctrl_reg2hw_t reg2hw,  // Write
+    input cluster_ctrl_reg_pkg::cluster_ctrl_hw2reg_t hw2reg,  // Read
+    // Config
+    input devmode_i  // If 1, explicit error return for unmapped register access
+);
+  localparam int unsigned STRB_WIDTH = DW / 8;
+
+  `include "register_interface/typedef.svh"
+  `include "register_interface/assign.svh"
+
+  // Define structs for reg_bus
+  typedef logic [AW-1:0] addr_t;
+  typedef logic [DW-1:0] data_t;
+  typedef logic [STRB_WIDTH-1:0] strb_t;
+  `REG_BUS_TYPEDEF_ALL(reg_bus, addr_t, data_t, strb_t)
+
+  reg_bus_req_t s_reg_req;
+  reg_bus_rsp_t s_reg_rsp;
+
+  // Assign SV interface to structs
+  `REG_BUS_ASSIGN_TO_REQ(s_reg_req, regbus_slave)
+  `REG_BUS_ASSIGN_FROM_RSP(regbus_slave, s_reg_rsp)
+
+  reg_bus_req_t s_reg_win_req[1-1:0];
+  reg_bus_rsp_t s_reg_win_rsp[1-1:0];
+  for (genvar i = 0; i < 1; i++) begin : gen_assign_window_structs
+    `REG_BUS_ASSIGN_TO_REQ(s_reg_win_req[i], regbus_win_mst[i])
+    `REG_BUS_ASSIGN_FROM_RSP(regbus_win_mst[i], s_reg_win_rsp[i])
+  end
+
+
+
+  cluster_ctrl_reg_top #(
+      .reg_req_t(reg_bus_req_t),
+      .reg_rsp_t(reg_bus_rsp_t),
+      .AW(AW)
+  ) i_regs (
+      .clk_i,
+      .rst_ni,
+      .reg_req_i(s_reg_req),
+      .reg_rsp_o(s_reg_rsp),
+      .reg_req_win_o(s_reg_win_req),
+      .reg_rsp_win_i(s_reg_win_rsp),
+      .reg2hw,  // Write
+      .hw2reg,  // Read
+      .devmode_i
+  );
+
+endmodule
+
+
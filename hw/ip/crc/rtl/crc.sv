@@ -0,0 +1,105 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Description: CRC of the data written to the DATA window, 32 or 16 bits
+//              with a programmable polynomial. A write adds its enabled bytes
+//              in one cycle, so the DMA can stream data into the window at
+//              the rate of the bus.
+
+module crc #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Register interface
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o
+);
+
+  import crc_reg_pkg::*;
+
+  crc_reg2hw_t            reg2hw;
+  crc_hw2reg_t            hw2reg;
+
+  reg_req_t    [     0:0] data_win_h2d;
+  reg_rsp_t    [     0:0] data_win_d2h;
+
+  logic        [    31:0] crc_q;
+  logic        [    31:0] crc_next;
+  logic        [    31:0] width_mask;
+  logic        [    31:0] poly_reflected;
+
+  assign width_mask = reg2hw.ctrl.width.q ? 32'h0000ffff : 32'hffffffff;
+
+  // Polynomial reflected within the width of the CRC, for the LSB first shifts
+  always_comb begin
+    poly_reflected = '0;
+    for (int i = 0; i < 32; i++) begin
+      if (reg2hw.ctrl.width.q) begin
+        if (i < 16) poly_reflected[i] = reg2hw.poly.q[15-i];
+      end else begin
+        poly_reflected[i] = reg2hw.poly.q[31-i];
+      end
+    end
+  end
+
+  // One bit per step, the bytes in the order of their addresses and their bits
+  // LSB first when reflected, MSB first otherwise
+  always_comb begin
+    logic [31:0] c;
+    logic        feedback;
+    c = crc_q;
+    for (int b = 0; b < 4; b++) begin
+      if (data_win_h2d[0].wstrb[b]) begin
+        for (int i = 0; i < 8; i++) begin
+          if (reg2hw.ctrl.reflect.q) begin
+            feedback = c[0] ^ data_win_h2d[0].wdata[8*b+i];
+            c = c >> 1;
+            if (feedback) c = c ^ poly_reflected;
+          end else begin
+            feedback = (reg2hw.ctrl.width.q ? c[15] : c[31]) ^ data_win_h2d[0].wdata[8*b+7-i];
+            c = (c << 1) & width_mask;
+            if (feedback) c = c ^ (reg2hw.poly.q & width_mask);
+          end
+        end
+      end
+    end
+    crc_next = c;
+  end
+
+  always_ff @(posedge clk_i, negedge rst_ni) begin
+    if (~rst_ni) begin
+      crc_q <= '0;
+    end else if (reg2hw.crc.qe) begin
+      crc_q <= reg2hw.crc.q & width_mask;
+    end else if (data_win_h2d[0].valid && data_win_h2d[0].write) begin
+      crc_q <= crc_next;
+    end
+  end
+
+  assign hw2reg.crc.d = crc_q;
+
+  // The window is write only, it reads as 0
+  assign data_win_d2h[0].rdata = '0;
+  assign data_win_d2h[0].error = 1'b0;
+  assign data_win_d2h[0].ready = 1'b1;
+
+  crc_reg_top #(
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t)
+  ) crc_reg_top_i (
+      .clk_i,
+      .rst_ni,
+      .reg_req_win_o(data_win_h2d),
+      .reg_rsp_win_i(data_win_d2h),
+      .reg_req_i,
+      .reg_rsp_o,
+      .reg2hw,
+      .hw2reg,
+      .devmode_i(1'b1)
+  );
+
+endmodule : crc
@@ -0,0 +1,68 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Register Package auto-generated by `reggen` containing data structure
+
+package crc_reg_pkg;
+
+  // Address widths within the block
+  parameter int BlockAw = 4;
+
+  ////////////////////////////
+  // Typedefs for registers //
+  ////////////////////////////
+
+  typedef struct packed {
+    struct packed {logic q;} width;
+    struct packed {logic q;} reflect;
+  } crc_reg2hw_ctrl_reg_t;
+
+  typedef struct packed {logic [31:0] q;} crc_reg2hw_poly_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+    logic        qe;
+  } crc_reg2hw_crc_reg_t;
+
+  typedef struct packed {logic [31:0] d;} crc_hw2reg_crc_reg_t;
+
+  // Register -> HW type
+  typedef struct packed {
+    crc_reg2hw_ctrl_reg_t ctrl;  // [66:65]
+    crc_reg2hw_poly_reg_t poly;  // [64:33]
+    crc_reg2hw_crc_reg_t  crc;   // [32:0]
+  } crc_reg2hw_t;
+
+  // HW -> register type
+  typedef struct packed {
+    crc_hw2reg_crc_reg_t crc;  // [31:0]
+  } crc_hw2reg_t;
+
+  // Register offsets
+  parameter logic [BlockAw-1:0] CRC_CTRL_OFFSET = 4'h0;
+  parameter logic [BlockAw-1:0] CRC_POLY_OFFSET = 4'h4;
+  parameter logic [BlockAw-1:0] CRC_CRC_OFFSET = 4'h8;
+
+  // Reset values for hwext registers and their fields
+  parameter logic [31:0] CRC_CRC_RESVAL = 32'h0;
+
+  // Window parameters
+  parameter logic [BlockAw-1:0] CRC_DATA_OFFSET = 4'hc;
+  parameter int unsigned CRC_DATA_SIZE = 'h4;
+
+  // Register index
+  typedef enum int {
+    CRC_CTRL,
+    CRC_POLY,
+    CRC_CRC
+  } crc_id_e;
+
+  // Register width information to check illegal writes
+  parameter logic [3:0] CRC_PERMIT[3] = '{
+      4'b0001,  // index[0] CRC_CTRL
+      4'b1111,  // index[1] CRC_POLY
+      4'b1111  // index[2] CRC_CRC
+  };
+
+endpackage
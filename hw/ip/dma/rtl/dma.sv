@@ -12,7 +12,10 @@ module dma #(
     parameter type reg_rsp_t = logic,
     parameter type obi_req_t = logic,
     parameter type obi_resp_t = logic,
-    parameter int unsigned SLOT_NUM = 0
+    parameter type obi_wide_req_t = obi_req_t,
+    parameter type obi_wide_resp_t = obi_resp_t,
+    parameter int unsigned SLOT_NUM = 0,
+    parameter int unsigned WIDE_LANES = 1
 ) (
     input logic clk_i,
     input logic rst_ni,
@@ -29,10 +32,20 @@ module dma #(
     output obi_req_t  dma_addr_ch0_req_o,
     input  obi_resp_t dma_addr_ch0_resp_i,
 
+    // Wide ports into the interleaved banks, WIDE_LANES words per transfer
+    output obi_wide_req_t  dma_wide_read_req_o,
+    input  obi_wide_resp_t dma_wide_read_resp_i,
+
+    output obi_wide_req_t  dma_wide_write_req_o,
+    input  obi_wide_resp_t dma_wide_write_resp_i,
+
     input logic [SLOT_NUM-1:0] trigger_slot_i,
 
     output dma_done_intr_o,
-    output dma_window_intr_o
+    output dma_window_intr_o,
+
+    // A transaction is in progress
+    output logic dma_busy_o
 );
 
   import dma_reg_pkg::*;
@@ -53,6 +66,7 @@ module dma #(
   logic        [                2:0] dma_cnt_du;
   logic                              dma_start;
   logic                              dma_done;
+  logic                              narrow_done;
   logic                              dma_window_event;
 
   logic                              window_done_q;
@@ -177,8 +191,46 @@ module dma #(
 
   logic                  dma_start_pending;
 
+  /* Linked-list mode */
+  logic                  ll_start_pending;
+  logic                  ll_on_q;
+  logic                  ll_fetch;
+  logic                  ll_req;
+  logic                  ll_wait_q;
+  logic           [ 3:0] ll_word_q;
+  logic           [31:0] ll_desc_q;
+  logic           [31:0] ll_rdata;
+  logic                  ll_rvalid;
+  logic                  ll_last;
+  logic                  ll_irq_q;
+  logic                  ll_irq_done_q;
+
+  /* Wide transfers */
+  logic                              wide_mode;
+  logic                              wide_on;
+  logic                              wide_done;
+  logic        [               31:0] wide_read_ptr;
+  logic        [               31:0] wide_write_ptr;
+  logic        [               16:0] wide_read_cnt;
+  logic        [               16:0] wide_write_cnt;
+  logic                              wide_read_req;
+  logic                              wide_write_req;
+  logic                              wide_fifo_full;
+  logic                              wide_fifo_empty;
+  logic                              wide_fifo_alm_full;
+  logic        [Addr_Fifo_Depth-1:0] wide_fifo_usage;
+  logic        [  32*WIDE_LANES-1:0] wide_fifo_output;
+
+  /* In-transfer operations */
+  logic                              ops_on;
+  logic                              op_signed;
+  logic        [               31:0] op_value;
+  logic signed [               48:0] op_product;
+  logic        [               31:0] op_output;
+
   enum {
     DMA_READY,
+    DMA_FETCHING,
     DMA_STARTING,
     DMA_RUNNING
   }
@@ -214,14 +266,15 @@ module dma #(
   logic [Addr_Fifo_Depth-1:0] outstanding_req, outstanding_addr_req;
   logic [31:0] window_counter;
 
-  assign dma_read_ch0_req_o.req = data_in_req && ~pad_fifo_on;
-  assign dma_read_ch0_req_o.we = data_in_we;
-  assign dma_read_ch0_req_o.be = data_in_be;
-  assign dma_read_ch0_req_o.addr = data_in_addr;
+  /* The descriptors are fetched on the read port, which is idle between two transactions */
+  assign dma_read_ch0_req_o.req = ll_fetch ? ll_req : data_in_req && ~pad_fifo_on;
+  assign dma_read_ch0_req_o.we = ll_fetch ? 1'b0 : data_in_we;
+  assign dma_read_ch0_req_o.be = ll_fetch ? 4'b1111 : data_in_be;
+  assign dma_read_ch0_req_o.addr = ll_fetch ? ll_desc_q + {26'h0, ll_word_q, 2'b00} : data_in_addr;
   assign dma_read_ch0_req_o.wdata = 32'h0;
 
-  assign data_in_gnt = dma_read_ch0_resp_i.gnt || (data_in_gnt_virt & pad_fifo_on);
-  assign data_in_rvalid = dma_read_ch0_resp_i.rvalid || (data_in_rvalid_virt & pad_fifo_on);
+  assign data_in_gnt = (dma_read_ch0_resp_i.gnt && ~ll_fetch) || (data_in_gnt_virt & pad_fifo_on);
+  assign data_in_rvalid = (dma_read_ch0_resp_i.rvalid && ~ll_fetch) || (data_in_rvalid_virt & pad_fifo_on);
   assign data_in_rdata = dma_read_ch0_resp_i.rdata;
 
   assign dma_addr_ch0_req_o.req = data_addr_in_req;
@@ -244,15 +297,19 @@ module dma #(
   assign data_out_rvalid = dma_write_ch0_resp_i.rvalid;
   assign data_out_rdata = dma_write_ch0_resp_i.rdata;
 
-  assign dma_done_intr_o = dma_done & reg2hw.interrupt_en.transaction_done.q;
+  /* In linked-list mode, only the descriptors with the IRQ flag and the last one interrupt */
+  assign dma_done_intr_o = dma_done & reg2hw.interrupt_en.transaction_done.q &
+                           (~ll_on_q | ll_irq_q | ~|reg2hw.ll_ptr.q);
   assign dma_window_intr_o = dma_window_event & reg2hw.interrupt_en.window_done.q;
 
   assign dst_data_type = dma_data_type_t'(reg2hw.dst_data_type.q);
   assign src_data_type = dma_data_type_t'(reg2hw.src_data_type.q);
 
   assign hw2reg.status.ready.d = (dma_state_q == DMA_READY);
+  assign dma_busy_o = (dma_state_q != DMA_READY);
 
   assign hw2reg.status.window_done.d = window_done_q;
+  assign hw2reg.status.ll_irq.d = ll_irq_done_q;
 
   assign circular_mode = reg2hw.mode.q == 1;
   assign address_mode = reg2hw.mode.q == 2;
@@ -350,10 +407,13 @@ module dma #(
   //
   // Main DMA state machine
   //
-  // READY   : idle, waiting for a write pulse to size registered in `dma_start_pending`
+  // READY   : idle, waiting for a write pulse to size registered in `dma_start_pending`,
+  //           or to the linked-list pointer registered in `ll_start_pending`
+  // FETCHING: load the registers of the transaction from the descriptor at `ll_desc_q`
   // STARTING: load transaction data
   // RUNNING : waiting for transaction finish
-  //           when `dma_done` rises either enter ready or restart in circular mode
+  //           when `dma_done` rises either enter ready, restart in circular mode,
+  //           or fetch the next descriptor of a linked list
   //
 
   always_comb begin
@@ -362,14 +422,20 @@ module dma #(
       DMA_READY: begin
         if (dma_start_pending) begin
           dma_state_d = DMA_STARTING;
+        end else if (ll_start_pending) begin
+          dma_state_d = DMA_FETCHING;
         end
       end
+      DMA_FETCHING: begin
+        if (ll_rvalid && ll_last) dma_state_d = DMA_STARTING;
+      end
       DMA_STARTING: begin
         dma_state_d = DMA_RUNNING;
       end
       DMA_RUNNING: begin
         if (dma_done) begin
           if (circular_mode) dma_state_d = DMA_STARTING;
+          else if (ll_on_q && |reg2hw.ll_ptr.q) dma_state_d = DMA_FETCHING;
           else dma_state_d = DMA_READY;
         end
       end
@@ -398,6 +464,130 @@ module dma #(
     end
   end
 
+  //
+  // Linked-list mode
+  //
+  // A non-zero write to LL_PTR starts a chain of transactions described in memory.
+  // Each descriptor is DMA_LL_DESC_WORDS words, fetched one at a time on the read port:
+  //   0 NEXT     : address of the next descriptor, 0 ends the chain (loaded into LL_PTR)
+  //   1 SRC_PTR, 2 DST_PTR, 3 ADDR_PTR
+  //   4 SIZE     : [15:0] SIZE_D1, [31:16] SIZE_D2
+  //   5 SRC_INC  : [5:0] SRC_PTR_INC_D1, [28:6] SRC_PTR_INC_D2
+  //   6 DST_INC  : [5:0] DST_PTR_INC_D1, [28:6] DST_PTR_INC_D2
+  //   7 SLOT     : as the SLOT register
+  //   8 PAD      : [5:0] PAD_TOP, [13:8] PAD_BOTTOM, [21:16] PAD_RIGHT, [29:24] PAD_LEFT
+  //   9 CONFIG   : [1:0] SRC_DATA_TYPE, [3:2] DST_DATA_TYPE, [4] SIGN_EXT, [6:5] MODE,
+  //                [7] DIM_CONFIG, [8] DIM_INV, [9] IRQ
+  // Every word is written to its registers as it arrives, so that software reads the
+  // transaction in progress. The window, the operations and the wide mode are set once
+  // in the registers for the whole chain. The done interrupt only fires for the
+  // descriptors with the IRQ flag, which also set STATUS.LL_IRQ, and for the last one.
+  //
+
+  localparam int unsigned DMA_LL_DESC_WORDS = 10;
+
+  assign ll_fetch = (dma_state_q == DMA_FETCHING);
+  assign ll_req = ll_fetch && ~ll_wait_q;
+  assign ll_rvalid = ll_fetch && dma_read_ch0_resp_i.rvalid;
+  assign ll_rdata = dma_read_ch0_resp_i.rdata;
+  assign ll_last = (ll_word_q == 4'(DMA_LL_DESC_WORDS - 1));
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : proc_ll_fetch
+    if (~rst_ni) begin
+      ll_start_pending <= 1'b0;
+      ll_on_q <= 1'b0;
+      ll_wait_q <= 1'b0;
+      ll_word_q <= '0;
+      ll_desc_q <= '0;
+      ll_irq_q <= 1'b0;
+    end else begin
+      if (ll_fetch) begin
+        ll_start_pending <= 1'b0;
+      end else if (reg2hw.ll_ptr.qe & |reg2hw.ll_ptr.q) begin
+        ll_start_pending <= 1'b1;
+      end
+
+      if (dma_state_d == DMA_FETCHING && dma_state_q != DMA_FETCHING) begin
+        ll_on_q <= 1'b1;
+        ll_wait_q <= 1'b0;
+        ll_word_q <= '0;
+        ll_desc_q <= reg2hw.ll_ptr.q;
+      end else if (dma_state_q == DMA_READY) begin
+        ll_on_q <= 1'b0;
+      end else if (ll_fetch) begin
+        if (ll_rvalid) begin
+          ll_wait_q <= 1'b0;
+          ll_word_q <= ll_word_q + 4'h1;
+        end else if (dma_read_ch0_resp_i.gnt) begin
+          ll_wait_q <= 1'b1;
+        end
+      end
+
+      if (ll_rvalid && ll_last) ll_irq_q <= ll_rdata[9];
+    end
+  end
+
+  /* Write the words of the descriptor to the registers as they arrive */
+  always_comb begin : proc_ll_load
+    hw2reg.ll_ptr.d = ll_rdata;
+    hw2reg.src_ptr.d = ll_rdata;
+    hw2reg.dst_ptr.d = ll_rdata;
+    hw2reg.addr_ptr.d = ll_rdata;
+    hw2reg.size_d1.d = ll_rdata[15:0];
+    hw2reg.size_d2.d = ll_rdata[31:16];
+    hw2reg.src_ptr_inc_d1.d = ll_rdata[5:0];
+    hw2reg.src_ptr_inc_d2.d = ll_rdata[28:6];
+    hw2reg.dst_ptr_inc_d1.d = ll_rdata[5:0];
+    hw2reg.dst_ptr_inc_d2.d = ll_rdata[28:6];
+    hw2reg.slot.rx_trigger_slot.d = ll_rdata[15:0];
+    hw2reg.slot.tx_trigger_slot.d = ll_rdata[31:16];
+    hw2reg.pad_top.d = ll_rdata[5:0];
+    hw2reg.pad_bottom.d = ll_rdata[13:8];
+    hw2reg.pad_right.d = ll_rdata[21:16];
+    hw2reg.pad_left.d = ll_rdata[29:24];
+    hw2reg.src_data_type.d = ll_rdata[1:0];
+    hw2reg.dst_data_type.d = ll_rdata[3:2];
+    hw2reg.sign_ext.d = ll_rdata[4];
+    hw2reg.mode.d = ll_rdata[6:5];
+    hw2reg.dim_config.d = ll_rdata[7];
+    hw2reg.dim_inv.d = ll_rdata[8];
+
+    hw2reg.ll_ptr.de = ll_rvalid && ll_word_q == 4'd0;
+    hw2reg.src_ptr.de = ll_rvalid && ll_word_q == 4'd1;
+    hw2reg.dst_ptr.de = ll_rvalid && ll_word_q == 4'd2;
+    hw2reg.addr_ptr.de = ll_rvalid && ll_word_q == 4'd3;
+    hw2reg.size_d1.de = ll_rvalid && ll_word_q == 4'd4;
+    hw2reg.size_d2.de = ll_rvalid && ll_word_q == 4'd4;
+    hw2reg.src_ptr_inc_d1.de = ll_rvalid && ll_word_q == 4'd5;
+    hw2reg.src_ptr_inc_d2.de = ll_rvalid && ll_word_q == 4'd5;
+    hw2reg.dst_ptr_inc_d1.de = ll_rvalid && ll_word_q == 4'd6;
+    hw2reg.dst_ptr_inc_d2.de = ll_rvalid && ll_word_q == 4'd6;
+    hw2reg.slot.rx_trigger_slot.de = ll_rvalid && ll_word_q == 4'd7;
+    hw2reg.slot.tx_trigger_slot.de = ll_rvalid && ll_word_q == 4'd7;
+    hw2reg.pad_top.de = ll_rvalid && ll_word_q == 4'd8;
+    hw2reg.pad_bottom.de = ll_rvalid && ll_word_q == 4'd8;
+    hw2reg.pad_right.de = ll_rvalid && ll_word_q == 4'd8;
+    hw2reg.pad_left.de = ll_rvalid && ll_word_q == 4'd8;
+    hw2reg.src_data_type.de = ll_rvalid && ll_last;
+    hw2reg.dst_data_type.de = ll_rvalid && ll_last;
+    hw2reg.sign_ext.de = ll_rvalid && ll_last;
+    hw2reg.mode.de = ll_rvalid && ll_last;
+    hw2reg.dim_config.de = ll_rvalid && ll_last;
+    hw2reg.dim_inv.de = ll_rvalid && ll_last;
+  end
+
+  // update ll_irq flag
+  // set when a descriptor with the IRQ flag is done
+  // reset on read
+  always_ff @(posedge clk_i, negedge rst_ni) begin : proc_ll_irq_done
+    if (~rst_ni) begin
+      ll_irq_done_q <= 1'b0;
+    end else begin
+      if (dma_done && ll_on_q && ll_irq_q) ll_irq_done_q <= 1'b1;
+      else if (reg2hw.status.ll_irq.re) ll_irq_done_q <= 1'b0;
+    end
+  end
+
   /*/ Store input data pointer and increment everytime read request is granted */
   always_ff @(posedge clk_i or negedge rst_ni) begin : proc_ptr_in_reg
     if (~rst_ni) begin
@@ -602,17 +792,87 @@ module dma #(
     ;  // case (dst_data_type)
   end
 
+  // In-transfer operations
+  //
+  // OP_CTRL applies operations to each element between the FIFO and the write:
+  // the element is extended to 32 bits (signed with SIGNED_DATA), scaled by
+  // OP_SCALE >>> SHIFT, offset by OP_ADD, clamped to OP_MIN (or set to 0 below
+  // it with THRESHOLD) and to OP_MAX, then truncated to the destination type and
+  // byte-swapped with BSWAP. The truncation does not saturate: MIN and MAX give
+  // the saturation to a narrower type. With ACC, the 32-bit results are added
+  // to OP_ACC as they are written. The padding elements go through the
+  // operations as zeros. The wide engine does not apply them.
+  //
+
+  assign ops_on = reg2hw.op_ctrl.scale.q | reg2hw.op_ctrl.add.q | reg2hw.op_ctrl.min.q |
+                  reg2hw.op_ctrl.max.q | reg2hw.op_ctrl.bswap.q;
+  assign op_signed = reg2hw.op_ctrl.signed_data.q;
+
+  always_comb begin : proc_op_data
+    case (src_data_type)
+      DMA_DATA_TYPE_WORD: op_value = fifo_output;
+      DMA_DATA_TYPE_HALF_WORD: op_value = {{16{op_signed & fifo_output[15]}}, fifo_output[15:0]};
+      default: op_value = {{24{op_signed & fifo_output[7]}}, fifo_output[7:0]};
+    endcase
+
+    op_product = $signed({op_signed & op_value[31], op_value}) * $signed(reg2hw.op_scale.q);
+    if (reg2hw.op_ctrl.scale.q) begin
+      op_value = 32'(op_product >>> reg2hw.op_ctrl.shift.q);
+    end
+
+    if (reg2hw.op_ctrl.add.q) begin
+      op_value = op_value + reg2hw.op_add.q;
+    end
+
+    if (reg2hw.op_ctrl.min.q &&
+        $signed({op_signed & op_value[31], op_value}) <
+        $signed({op_signed & reg2hw.op_min.q[31], reg2hw.op_min.q})) begin
+      op_value = reg2hw.op_ctrl.threshold.q ? 32'h0 : reg2hw.op_min.q;
+    end
+
+    if (reg2hw.op_ctrl.max.q &&
+        $signed({op_signed & op_value[31], op_value}) >
+        $signed({op_signed & reg2hw.op_max.q[31], reg2hw.op_max.q})) begin
+      op_value = reg2hw.op_max.q;
+    end
+
+    op_output = fifo_output;
+    if (ops_on) begin
+      case (dst_data_type)
+        DMA_DATA_TYPE_WORD:
+        op_output = reg2hw.op_ctrl.bswap.q ? {op_value[7:0], op_value[15:8], op_value[23:16], op_value[31:24]} : op_value;
+        DMA_DATA_TYPE_HALF_WORD:
+        op_output = reg2hw.op_ctrl.bswap.q ? {16'h0, op_value[7:0], op_value[15:8]} : {16'h0, op_value[15:0]};
+        default: op_output = {24'h0, op_value[7:0]};
+      endcase
+    end
+  end
+
+  // Sum of the elements written, reset at start
+  always_comb begin : proc_op_acc_reg
+    hw2reg.op_acc.d  = reg2hw.op_acc.q + op_value;
+    hw2reg.op_acc.de = 1'b0;
+    if (dma_start) begin
+      hw2reg.op_acc.d  = 'h0;
+      hw2reg.op_acc.de = 1'b1;
+    end else if (reg2hw.op_ctrl.acc.q && data_out_req && data_out_gnt) begin
+      hw2reg.op_acc.de = 1'b1;
+    end
+  end
+
   // Output data shift
   always_comb begin : proc_output_data
 
-    data_out_wdata[7:0]   = fifo_output[7:0];
-    data_out_wdata[15:8]  = fifo_output[15:8];
-    data_out_wdata[23:16] = fifo_output[23:16];
-    data_out_wdata[31:24] = fifo_output[31:24];
+    data_out_wdata[7:0]   = op_output[7:0];
+    data_out_wdata[15:8]  = op_output[15:8];
+    data_out_wdata[23:16] = op_output[23:16];
+    data_out_wdata[31:24] = op_output[31:24];
 
     case (write_address[1:0])
       2'b00: begin
-        if (sign_extend) begin
+        if (ops_on) begin
+          // extended by the operations
+        end else if (sign_extend) begin
           case ({
             src_data_type, dst_data_type
           })
@@ -620,20 +880,20 @@ module dma #(
             {
               DMA_DATA_TYPE_HALF_WORD, DMA_DATA_TYPE_WORD
             } :
-            data_out_wdata[31:16] = {16{fifo_output[15]}};
+            data_out_wdata[31:16] = {16{op_output[15]}};
             {
               DMA_DATA_TYPE_BYTE, DMA_DATA_TYPE_WORD
             }, {
               DMA_DATA_TYPE_BYTE_, DMA_DATA_TYPE_WORD
             } :
-            data_out_wdata[31:8] = {24{fifo_output[7]}};
+            data_out_wdata[31:8] = {24{op_output[7]}};
             {DMA_DATA_TYPE_HALF_WORD, DMA_DATA_TYPE_HALF_WORD} : ;
             {
               DMA_DATA_TYPE_BYTE, DMA_DATA_TYPE_HALF_WORD
             }, {
               DMA_DATA_TYPE_BYTE_, DMA_DATA_TYPE_HALF_WORD
             } :
-            data_out_wdata[15:8] = {8{fifo_output[7]}};
+            data_out_wdata[15:8] = {8{op_output[7]}};
             default: ;
           endcase
         end else begin
@@ -659,12 +919,14 @@ module dma #(
           endcase
         end
       end
-      2'b01: data_out_wdata[15:8] = fifo_output[7:0];  // Writing a byte, no need for sign extension
+      2'b01: data_out_wdata[15:8] = op_output[7:0];  // Writing a byte, no need for sign extension
       2'b10: begin  // Writing a half-word or a byte
-        data_out_wdata[23:16] = fifo_output[7:0];
-        data_out_wdata[31:24] = fifo_output[15:8];
+        data_out_wdata[23:16] = op_output[7:0];
+        data_out_wdata[31:24] = op_output[15:8];
 
-        if (sign_extend) begin
+        if (ops_on) begin
+          // extended by the operations
+        end else if (sign_extend) begin
           case ({
             src_data_type, dst_data_type
           })
@@ -674,7 +936,7 @@ module dma #(
             }, {
               DMA_DATA_TYPE_BYTE_, DMA_DATA_TYPE_HALF_WORD
             } :
-            data_out_wdata[31:24] = {8{fifo_output[7]}};
+            data_out_wdata[31:24] = {8{op_output[7]}};
             default: ;
           endcase
         end else begin
@@ -693,7 +955,7 @@ module dma #(
         end
       end
       2'b11:
-      data_out_wdata[31:24] = fifo_output[7:0];  // Writing a byte, no need for sign extension
+      data_out_wdata[31:24] = op_output[7:0];  // Writing a byte, no need for sign extension
     endcase
   end
 
@@ -947,8 +1209,8 @@ module dma #(
     unique case (dma_read_fsm_state)
 
       DMA_READ_FSM_IDLE: begin
-        // Wait for start signal
-        if (dma_start == 1'b1) begin
+        // Wait for start signal, the wide transfers go through the wide ports
+        if (dma_start == 1'b1 && !wide_mode) begin
           dma_read_fsm_n_state = DMA_READ_FSM_ON;
           fifo_flush = 1'b1;
         end else begin
@@ -1038,7 +1300,7 @@ module dma #(
   always_comb begin : proc_dma_write_fsm_logic
 
     dma_write_fsm_n_state = DMA_WRITE_FSM_IDLE;
-    dma_done = 1'b0;
+    narrow_done = 1'b0;
 
     data_out_req = '0;
     data_out_we = '0;
@@ -1049,7 +1311,7 @@ module dma #(
 
       DMA_WRITE_FSM_IDLE: begin
         // Wait for start signal
-        if (dma_start == 1'b1) begin
+        if (dma_start == 1'b1 && !wide_mode) begin
           dma_write_fsm_n_state = DMA_WRITE_FSM_ON;
         end else begin
           dma_write_fsm_n_state = DMA_WRITE_FSM_IDLE;
@@ -1059,10 +1321,10 @@ module dma #(
       DMA_WRITE_FSM_ON: begin
         // If all input data read exit
         if (fifo_empty == 1'b1 && dma_read_fsm_state == DMA_READ_FSM_IDLE) begin
-          dma_done = outstanding_req == '0 && outstanding_addr_req == '0;
+          narrow_done = outstanding_req == '0 && outstanding_addr_req == '0;
           // If all input data has been read (dma_read_fsm_state == DMA_READ_FSM_IDLE, set when all data has been read) 
           // and all requests have been granted, (outstanding_req == 0) then we are done
-          dma_write_fsm_n_state = dma_done ? DMA_WRITE_FSM_IDLE : DMA_WRITE_FSM_ON;
+          dma_write_fsm_n_state = narrow_done ? DMA_WRITE_FSM_IDLE : DMA_WRITE_FSM_ON;
         end else begin
           dma_write_fsm_n_state = DMA_WRITE_FSM_ON;
           // Wait if fifo is empty or if the SPI TX is not ready for new data (only in SPI mode 2).
@@ -1115,6 +1377,88 @@ module dma #(
       .pop_i(data_out_gnt && address_mode)
   );
 
+  //
+  // Wide transfers
+  //
+  // With WIDE.EN, a transaction moves WIDE_LANES words per transfer through the
+  // wide ports instead of the read and write ports: the reads are packed in a
+  // FIFO of WIDE_LANES words and written back as they are. The driver sets it
+  // only for 1D word copies with an increment of one word between aligned
+  // buffers of the interleaved group, see dma.h.
+  //
+
+  localparam logic [16:0] WideBytes = 17'(4 * WIDE_LANES);
+
+  assign wide_mode = (WIDE_LANES > 1) && reg2hw.wide.q;
+
+  assign wide_fifo_alm_full = (wide_fifo_usage == LastFifoUsage[Addr_Fifo_Depth-1:0]);
+
+  assign wide_read_req = wide_on && |wide_read_cnt && !wide_fifo_full && !wide_fifo_alm_full;
+  assign wide_write_req = wide_on && !wide_fifo_empty;
+  assign wide_done = wide_on && ~|wide_write_cnt;
+
+  assign dma_done = narrow_done | wide_done;
+
+  assign dma_wide_read_req_o.req = wide_read_req;
+  assign dma_wide_read_req_o.we = 1'b0;
+  assign dma_wide_read_req_o.be = '1;
+  assign dma_wide_read_req_o.addr = wide_read_ptr;
+  assign dma_wide_read_req_o.wdata = '0;
+
+  assign dma_wide_write_req_o.req = wide_write_req;
+  assign dma_wide_write_req_o.we = 1'b1;
+  assign dma_wide_write_req_o.be = '1;
+  assign dma_wide_write_req_o.addr = wide_write_ptr;
+  assign dma_wide_write_req_o.wdata = wide_fifo_output;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : proc_wide
+    if (~rst_ni) begin
+      wide_on        <= 1'b0;
+      wide_read_ptr  <= '0;
+      wide_write_ptr <= '0;
+      wide_read_cnt  <= '0;
+      wide_write_cnt <= '0;
+    end else begin
+      if (dma_start == 1'b1 && wide_mode) begin
+        wide_on        <= 1'b1;
+        wide_read_ptr  <= reg2hw.src_ptr.q;
+        wide_write_ptr <= reg2hw.dst_ptr.q;
+        wide_read_cnt  <= {1'h0, reg2hw.size_d1.q};
+        wide_write_cnt <= {1'h0, reg2hw.size_d1.q};
+      end else begin
+        if (wide_read_req && dma_wide_read_resp_i.gnt) begin
+          wide_read_ptr <= wide_read_ptr + {15'h0, WideBytes};
+          wide_read_cnt <= wide_read_cnt - WideBytes;
+        end
+        if (wide_write_req && dma_wide_write_resp_i.gnt) begin
+          wide_write_ptr <= wide_write_ptr + {15'h0, WideBytes};
+          wide_write_cnt <= wide_write_cnt - WideBytes;
+        end
+        if (wide_done) wide_on <= 1'b0;
+      end
+    end
+  end
+
+  fifo_v3 #(
+      .DEPTH     (FIFO_DEPTH),
+      .DATA_WIDTH(32 * WIDE_LANES)
+  ) dma_wide_fifo_i (
+      .clk_i,
+      .rst_ni,
+      .flush_i(dma_start),
+      .testmode_i(1'b0),
+      // status flags
+      .full_o(wide_fifo_full),
+      .empty_o(wide_fifo_empty),
+      .usage_o(wide_fifo_usage),
+      // the reads are pushed as they come back
+      .data_i(dma_wide_read_resp_i.rdata),
+      .push_i(dma_wide_read_resp_i.rvalid),
+      // and popped as they are written
+      .data_o(wide_fifo_output),
+      .pop_i(wide_write_req && dma_wide_write_resp_i.gnt)
+  );
+
   dma_reg_top #(
       .reg_req_t(reg_req_t),
       .reg_rsp_t(reg_rsp_t)
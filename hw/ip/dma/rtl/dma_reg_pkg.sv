@@ -38,6 +38,10 @@ package dma_reg_pkg;
       logic q;
       logic re;
     } window_done;
+    struct packed {
+      logic q;
+      logic re;
+    } ll_irq;
   } dma_reg2hw_status_reg_t;
 
   typedef struct packed {logic [5:0] q;} dma_reg2hw_src_ptr_inc_d1_reg_t;
@@ -94,48 +98,224 @@ package dma_reg_pkg;
     struct packed {logic q;} window_done;
   } dma_reg2hw_interrupt_en_reg_t;
 
+  typedef struct packed {logic q;} dma_reg2hw_wide_reg_t;
+
+  typedef struct packed {
+    struct packed {logic q;} scale;
+    struct packed {logic q;} add;
+    struct packed {logic q;} min;
+    struct packed {logic q;} max;
+    struct packed {logic q;} threshold;
+    struct packed {logic q;} acc;
+    struct packed {logic q;} bswap;
+    struct packed {logic q;} signed_data;
+    struct packed {logic [4:0] q;} shift;
+  } dma_reg2hw_op_ctrl_reg_t;
+
+  typedef struct packed {logic [15:0] q;} dma_reg2hw_op_scale_reg_t;
+
+  typedef struct packed {logic [31:0] q;} dma_reg2hw_op_add_reg_t;
+
+  typedef struct packed {logic [31:0] q;} dma_reg2hw_op_min_reg_t;
+
+  typedef struct packed {logic [31:0] q;} dma_reg2hw_op_max_reg_t;
+
+  typedef struct packed {logic [31:0] q;} dma_reg2hw_op_acc_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+    logic        qe;
+  } dma_reg2hw_ll_ptr_reg_t;
+
+  typedef struct packed {
+    logic [31:0] d;
+    logic        de;
+  } dma_hw2reg_src_ptr_reg_t;
+
+  typedef struct packed {
+    logic [31:0] d;
+    logic        de;
+  } dma_hw2reg_dst_ptr_reg_t;
+
+  typedef struct packed {
+    logic [31:0] d;
+    logic        de;
+  } dma_hw2reg_addr_ptr_reg_t;
+
+  typedef struct packed {
+    logic [15:0] d;
+    logic        de;
+  } dma_hw2reg_size_d1_reg_t;
+
+  typedef struct packed {
+    logic [15:0] d;
+    logic        de;
+  } dma_hw2reg_size_d2_reg_t;
+
   typedef struct packed {
     struct packed {logic d;} ready;
     struct packed {logic d;} window_done;
+    struct packed {logic d;} ll_irq;
   } dma_hw2reg_status_reg_t;
 
+  typedef struct packed {
+    logic [5:0] d;
+    logic       de;
+  } dma_hw2reg_src_ptr_inc_d1_reg_t;
+
+  typedef struct packed {
+    logic [22:0] d;
+    logic        de;
+  } dma_hw2reg_src_ptr_inc_d2_reg_t;
+
+  typedef struct packed {
+    logic [5:0] d;
+    logic       de;
+  } dma_hw2reg_dst_ptr_inc_d1_reg_t;
+
+  typedef struct packed {
+    logic [22:0] d;
+    logic        de;
+  } dma_hw2reg_dst_ptr_inc_d2_reg_t;
+
+  typedef struct packed {
+    struct packed {
+      logic [15:0] d;
+      logic        de;
+    } rx_trigger_slot;
+    struct packed {
+      logic [15:0] d;
+      logic        de;
+    } tx_trigger_slot;
+  } dma_hw2reg_slot_reg_t;
+
+  typedef struct packed {
+    logic [1:0] d;
+    logic       de;
+  } dma_hw2reg_src_data_type_reg_t;
+
+  typedef struct packed {
+    logic [1:0] d;
+    logic       de;
+  } dma_hw2reg_dst_data_type_reg_t;
+
+  typedef struct packed {
+    logic d;
+    logic de;
+  } dma_hw2reg_sign_ext_reg_t;
+
+  typedef struct packed {
+    logic [1:0] d;
+    logic       de;
+  } dma_hw2reg_mode_reg_t;
+
+  typedef struct packed {
+    logic d;
+    logic de;
+  } dma_hw2reg_dim_config_reg_t;
+
+  typedef struct packed {
+    logic d;
+    logic de;
+  } dma_hw2reg_dim_inv_reg_t;
+
+  typedef struct packed {
+    logic [5:0] d;
+    logic       de;
+  } dma_hw2reg_pad_top_reg_t;
+
+  typedef struct packed {
+    logic [5:0] d;
+    logic       de;
+  } dma_hw2reg_pad_bottom_reg_t;
+
+  typedef struct packed {
+    logic [5:0] d;
+    logic       de;
+  } dma_hw2reg_pad_right_reg_t;
+
+  typedef struct packed {
+    logic [5:0] d;
+    logic       de;
+  } dma_hw2reg_pad_left_reg_t;
+
   typedef struct packed {
     logic [7:0] d;
     logic       de;
   } dma_hw2reg_window_count_reg_t;
 
+  typedef struct packed {
+    logic [31:0] d;
+    logic        de;
+  } dma_hw2reg_op_acc_reg_t;
+
+  typedef struct packed {
+    logic [31:0] d;
+    logic        de;
+  } dma_hw2reg_ll_ptr_reg_t;
+
   // Register -> HW type
   typedef struct packed {
-    dma_reg2hw_src_ptr_reg_t src_ptr;  // [283:252]
-    dma_reg2hw_dst_ptr_reg_t dst_ptr;  // [251:220]
-    dma_reg2hw_addr_ptr_reg_t addr_ptr;  // [219:188]
-    dma_reg2hw_size_d1_reg_t size_d1;  // [187:171]
-    dma_reg2hw_size_d2_reg_t size_d2;  // [170:154]
-    dma_reg2hw_status_reg_t status;  // [153:150]
-    dma_reg2hw_src_ptr_inc_d1_reg_t src_ptr_inc_d1;  // [149:144]
-    dma_reg2hw_src_ptr_inc_d2_reg_t src_ptr_inc_d2;  // [143:121]
-    dma_reg2hw_dst_ptr_inc_d1_reg_t dst_ptr_inc_d1;  // [120:115]
-    dma_reg2hw_dst_ptr_inc_d2_reg_t dst_ptr_inc_d2;  // [114:92]
-    dma_reg2hw_slot_reg_t slot;  // [91:60]
-    dma_reg2hw_src_data_type_reg_t src_data_type;  // [59:58]
-    dma_reg2hw_dst_data_type_reg_t dst_data_type;  // [57:56]
-    dma_reg2hw_sign_ext_reg_t sign_ext;  // [55:55]
-    dma_reg2hw_mode_reg_t mode;  // [54:53]
-    dma_reg2hw_dim_config_reg_t dim_config;  // [52:52]
-    dma_reg2hw_dim_inv_reg_t dim_inv;  // [51:51]
-    dma_reg2hw_pad_top_reg_t pad_top;  // [50:44]
-    dma_reg2hw_pad_bottom_reg_t pad_bottom;  // [43:37]
-    dma_reg2hw_pad_right_reg_t pad_right;  // [36:30]
-    dma_reg2hw_pad_left_reg_t pad_left;  // [29:23]
-    dma_reg2hw_window_size_reg_t window_size;  // [22:10]
-    dma_reg2hw_window_count_reg_t window_count;  // [9:2]
-    dma_reg2hw_interrupt_en_reg_t interrupt_en;  // [1:0]
+    dma_reg2hw_src_ptr_reg_t src_ptr;  // [476:445]
+    dma_reg2hw_dst_ptr_reg_t dst_ptr;  // [444:413]
+    dma_reg2hw_addr_ptr_reg_t addr_ptr;  // [412:381]
+    dma_reg2hw_size_d1_reg_t size_d1;  // [380:364]
+    dma_reg2hw_size_d2_reg_t size_d2;  // [363:347]
+    dma_reg2hw_status_reg_t status;  // [346:341]
+    dma_reg2hw_src_ptr_inc_d1_reg_t src_ptr_inc_d1;  // [340:335]
+    dma_reg2hw_src_ptr_inc_d2_reg_t src_ptr_inc_d2;  // [334:312]
+    dma_reg2hw_dst_ptr_inc_d1_reg_t dst_ptr_inc_d1;  // [311:306]
+    dma_reg2hw_dst_ptr_inc_d2_reg_t dst_ptr_inc_d2;  // [305:283]
+    dma_reg2hw_slot_reg_t slot;  // [282:251]
+    dma_reg2hw_src_data_type_reg_t src_data_type;  // [250:249]
+    dma_reg2hw_dst_data_type_reg_t dst_data_type;  // [248:247]
+    dma_reg2hw_sign_ext_reg_t sign_ext;  // [246:246]
+    dma_reg2hw_mode_reg_t mode;  // [245:244]
+    dma_reg2hw_dim_config_reg_t dim_config;  // [243:243]
+    dma_reg2hw_dim_inv_reg_t dim_inv;  // [242:242]
+    dma_reg2hw_pad_top_reg_t pad_top;  // [241:235]
+    dma_reg2hw_pad_bottom_reg_t pad_bottom;  // [234:228]
+    dma_reg2hw_pad_right_reg_t pad_right;  // [227:221]
+    dma_reg2hw_pad_left_reg_t pad_left;  // [220:214]
+    dma_reg2hw_window_size_reg_t window_size;  // [213:201]
+    dma_reg2hw_window_count_reg_t window_count;  // [200:193]
+    dma_reg2hw_interrupt_en_reg_t interrupt_en;  // [192:191]
+    dma_reg2hw_wide_reg_t wide;  // [190:190]
+    dma_reg2hw_op_ctrl_reg_t op_ctrl;  // [189:177]
+    dma_reg2hw_op_scale_reg_t op_scale;  // [176:161]
+    dma_reg2hw_op_add_reg_t op_add;  // [160:129]
+    dma_reg2hw_op_min_reg_t op_min;  // [128:97]
+    dma_reg2hw_op_max_reg_t op_max;  // [96:65]
+    dma_reg2hw_op_acc_reg_t op_acc;  // [64:33]
+    dma_reg2hw_ll_ptr_reg_t ll_ptr;  // [32:0]
   } dma_reg2hw_t;
 
   // HW -> register type
   typedef struct packed {
-    dma_hw2reg_status_reg_t status;  // [10:9]
-    dma_hw2reg_window_count_reg_t window_count;  // [8:0]
+    dma_hw2reg_src_ptr_reg_t src_ptr;  // [349:317]
+    dma_hw2reg_dst_ptr_reg_t dst_ptr;  // [316:284]
+    dma_hw2reg_addr_ptr_reg_t addr_ptr;  // [283:251]
+    dma_hw2reg_size_d1_reg_t size_d1;  // [250:234]
+    dma_hw2reg_size_d2_reg_t size_d2;  // [233:217]
+    dma_hw2reg_status_reg_t status;  // [216:214]
+    dma_hw2reg_src_ptr_inc_d1_reg_t src_ptr_inc_d1;  // [213:207]
+    dma_hw2reg_src_ptr_inc_d2_reg_t src_ptr_inc_d2;  // [206:183]
+    dma_hw2reg_dst_ptr_inc_d1_reg_t dst_ptr_inc_d1;  // [182:176]
+    dma_hw2reg_dst_ptr_inc_d2_reg_t dst_ptr_inc_d2;  // [175:152]
+    dma_hw2reg_slot_reg_t slot;  // [151:118]
+    dma_hw2reg_src_data_type_reg_t src_data_type;  // [117:115]
+    dma_hw2reg_dst_data_type_reg_t dst_data_type;  // [114:112]
+    dma_hw2reg_sign_ext_reg_t sign_ext;  // [111:110]
+    dma_hw2reg_mode_reg_t mode;  // [109:107]
+    dma_hw2reg_dim_config_reg_t dim_config;  // [106:105]
+    dma_hw2reg_dim_inv_reg_t dim_inv;  // [104:103]
+    dma_hw2reg_pad_top_reg_t pad_top;  // [102:96]
+    dma_hw2reg_pad_bottom_reg_t pad_bottom;  // [95:89]
+    dma_hw2reg_pad_right_reg_t pad_right;  // [88:82]
+    dma_hw2reg_pad_left_reg_t pad_left;  // [81:75]
+    dma_hw2reg_window_count_reg_t window_count;  // [74:66]
+    dma_hw2reg_op_acc_reg_t op_acc;  // [65:33]
+    dma_hw2reg_ll_ptr_reg_t ll_ptr;  // [32:0]
   } dma_hw2reg_t;
 
   // Register offsets
@@ -163,11 +343,20 @@ package dma_reg_pkg;
   parameter logic [BlockAw-1:0] DMA_WINDOW_SIZE_OFFSET = 7'h54;
   parameter logic [BlockAw-1:0] DMA_WINDOW_COUNT_OFFSET = 7'h58;
   parameter logic [BlockAw-1:0] DMA_INTERRUPT_EN_OFFSET = 7'h5c;
+  parameter logic [BlockAw-1:0] DMA_WIDE_OFFSET = 7'h60;
+  parameter logic [BlockAw-1:0] DMA_OP_CTRL_OFFSET = 7'h64;
+  parameter logic [BlockAw-1:0] DMA_OP_SCALE_OFFSET = 7'h68;
+  parameter logic [BlockAw-1:0] DMA_OP_ADD_OFFSET = 7'h6c;
+  parameter logic [BlockAw-1:0] DMA_OP_MIN_OFFSET = 7'h70;
+  parameter logic [BlockAw-1:0] DMA_OP_MAX_OFFSET = 7'h74;
+  parameter logic [BlockAw-1:0] DMA_OP_ACC_OFFSET = 7'h78;
+  parameter logic [BlockAw-1:0] DMA_LL_PTR_OFFSET = 7'h7c;
 
   // Reset values for hwext registers and their fields
-  parameter logic [1:0] DMA_STATUS_RESVAL = 2'h1;
+  parameter logic [2:0] DMA_STATUS_RESVAL = 3'h1;
   parameter logic [0:0] DMA_STATUS_READY_RESVAL = 1'h1;
   parameter logic [0:0] DMA_STATUS_WINDOW_DONE_RESVAL = 1'h0;
+  parameter logic [0:0] DMA_STATUS_LL_IRQ_RESVAL = 1'h0;
 
   // Register index
   typedef enum int {
@@ -194,11 +383,19 @@ package dma_reg_pkg;
     DMA_PAD_LEFT,
     DMA_WINDOW_SIZE,
     DMA_WINDOW_COUNT,
-    DMA_INTERRUPT_EN
+    DMA_INTERRUPT_EN,
+    DMA_WIDE,
+    DMA_OP_CTRL,
+    DMA_OP_SCALE,
+    DMA_OP_ADD,
+    DMA_OP_MIN,
+    DMA_OP_MAX,
+    DMA_OP_ACC,
+    DMA_LL_PTR
   } dma_id_e;
 
   // Register width information to check illegal writes
-  parameter logic [3:0] DMA_PERMIT[24] = '{
+  parameter logic [3:0] DMA_PERMIT[32] = '{
       4'b1111,  // index[ 0] DMA_SRC_PTR
       4'b1111,  // index[ 1] DMA_DST_PTR
       4'b1111,  // index[ 2] DMA_ADDR_PTR
@@ -222,7 +419,15 @@ package dma_reg_pkg;
       4'b0001,  // index[20] DMA_PAD_LEFT
       4'b0011,  // index[21] DMA_WINDOW_SIZE
       4'b0001,  // index[22] DMA_WINDOW_COUNT
-      4'b0001  // index[23] DMA_INTERRUPT_EN
+      4'b0001,  // index[23] DMA_INTERRUPT_EN
+      4'b0001,  // index[24] DMA_WIDE
+      4'b0011,  // index[25] DMA_OP_CTRL
+      4'b0011,  // index[26] DMA_OP_SCALE
+      4'b1111,  // index[27] DMA_OP_ADD
+      4'b1111,  // index[28] DMA_OP_MIN
+      4'b1111,  // index[29] DMA_OP_MAX
+      4'b1111,  // index[30] DMA_OP_ACC
+      4'b1111  // index[31] DMA_LL_PTR
   };
 
 endpackage
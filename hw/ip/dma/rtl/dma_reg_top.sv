@@ -87,6 +87,8 @@ module dma_reg_top #(
   logic status_ready_re;
   logic status_window_done_qs;
   logic status_window_done_re;
+  logic status_ll_irq_qs;
+  logic status_ll_irq_re;
   logic [5:0] src_ptr_inc_d1_qs;
   logic [5:0] src_ptr_inc_d1_wd;
   logic src_ptr_inc_d1_we;
@@ -145,6 +147,52 @@ module dma_reg_top #(
   logic interrupt_en_window_done_qs;
   logic interrupt_en_window_done_wd;
   logic interrupt_en_window_done_we;
+  logic wide_qs;
+  logic wide_wd;
+  logic wide_we;
+  logic op_ctrl_scale_qs;
+  logic op_ctrl_scale_wd;
+  logic op_ctrl_scale_we;
+  logic op_ctrl_add_qs;
+  logic op_ctrl_add_wd;
+  logic op_ctrl_add_we;
+  logic op_ctrl_min_qs;
+  logic op_ctrl_min_wd;
+  logic op_ctrl_min_we;
+  logic op_ctrl_max_qs;
+  logic op_ctrl_max_wd;
+  logic op_ctrl_max_we;
+  logic op_ctrl_threshold_qs;
+  logic op_ctrl_threshold_wd;
+  logic op_ctrl_threshold_we;
+  logic op_ctrl_acc_qs;
+  logic op_ctrl_acc_wd;
+  logic op_ctrl_acc_we;
+  logic op_ctrl_bswap_qs;
+  logic op_ctrl_bswap_wd;
+  logic op_ctrl_bswap_we;
+  logic op_ctrl_signed_data_qs;
+  logic op_ctrl_signed_data_wd;
+  logic op_ctrl_signed_data_we;
+  logic [4:0] op_ctrl_shift_qs;
+  logic [4:0] op_ctrl_shift_wd;
+  logic op_ctrl_shift_we;
+  logic [15:0] op_scale_qs;
+  logic [15:0] op_scale_wd;
+  logic op_scale_we;
+  logic [31:0] op_add_qs;
+  logic [31:0] op_add_wd;
+  logic op_add_we;
+  logic [31:0] op_min_qs;
+  logic [31:0] op_min_wd;
+  logic op_min_we;
+  logic [31:0] op_max_qs;
+  logic [31:0] op_max_wd;
+  logic op_max_we;
+  logic [31:0] op_acc_qs;
+  logic [31:0] ll_ptr_qs;
+  logic [31:0] ll_ptr_wd;
+  logic ll_ptr_we;
 
   // Register instances
   // R[src_ptr]: V(False)
@@ -162,8 +210,8 @@ module dma_reg_top #(
       .wd(src_ptr_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.src_ptr.de),
+      .d (hw2reg.src_ptr.d),
 
       // to internal hardware
       .qe(),
@@ -189,8 +237,8 @@ module dma_reg_top #(
       .wd(dst_ptr_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.dst_ptr.de),
+      .d (hw2reg.dst_ptr.d),
 
       // to internal hardware
       .qe(),
@@ -216,8 +264,8 @@ module dma_reg_top #(
       .wd(addr_ptr_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.addr_ptr.de),
+      .d (hw2reg.addr_ptr.d),
 
       // to internal hardware
       .qe(),
@@ -243,8 +291,8 @@ module dma_reg_top #(
       .wd(size_d1_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.size_d1.de),
+      .d (hw2reg.size_d1.d),
 
       // to internal hardware
       .qe(reg2hw.size_d1.qe),
@@ -270,8 +318,8 @@ module dma_reg_top #(
       .wd(size_d2_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.size_d2.de),
+      .d (hw2reg.size_d2.d),
 
       // to internal hardware
       .qe(reg2hw.size_d2.qe),
@@ -314,6 +362,21 @@ module dma_reg_top #(
   );
 
 
+  //   F[ll_irq]: 2:2
+  prim_subreg_ext #(
+      .DW(1)
+  ) u_status_ll_irq (
+      .re (status_ll_irq_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.status.ll_irq.d),
+      .qre(reg2hw.status.ll_irq.re),
+      .qe (),
+      .q  (reg2hw.status.ll_irq.q),
+      .qs (status_ll_irq_qs)
+  );
+
+
   // R[src_ptr_inc_d1]: V(False)
 
   prim_subreg #(
@@ -329,8 +392,8 @@ module dma_reg_top #(
       .wd(src_ptr_inc_d1_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.src_ptr_inc_d1.de),
+      .d (hw2reg.src_ptr_inc_d1.d),
 
       // to internal hardware
       .qe(),
@@ -356,8 +419,8 @@ module dma_reg_top #(
       .wd(src_ptr_inc_d2_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.src_ptr_inc_d2.de),
+      .d (hw2reg.src_ptr_inc_d2.d),
 
       // to internal hardware
       .qe(),
@@ -383,8 +446,8 @@ module dma_reg_top #(
       .wd(dst_ptr_inc_d1_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.dst_ptr_inc_d1.de),
+      .d (hw2reg.dst_ptr_inc_d1.d),
 
       // to internal hardware
       .qe(),
@@ -410,8 +473,8 @@ module dma_reg_top #(
       .wd(dst_ptr_inc_d2_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.dst_ptr_inc_d2.de),
+      .d (hw2reg.dst_ptr_inc_d2.d),
 
       // to internal hardware
       .qe(),
@@ -438,8 +501,8 @@ module dma_reg_top #(
       .wd(slot_rx_trigger_slot_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.slot.rx_trigger_slot.de),
+      .d (hw2reg.slot.rx_trigger_slot.d),
 
       // to internal hardware
       .qe(),
@@ -464,8 +527,8 @@ module dma_reg_top #(
       .wd(slot_tx_trigger_slot_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.slot.tx_trigger_slot.de),
+      .d (hw2reg.slot.tx_trigger_slot.d),
 
       // to internal hardware
       .qe(),
@@ -491,8 +554,8 @@ module dma_reg_top #(
       .wd(src_data_type_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.src_data_type.de),
+      .d (hw2reg.src_data_type.d),
 
       // to internal hardware
       .qe(),
@@ -518,8 +581,8 @@ module dma_reg_top #(
       .wd(dst_data_type_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.dst_data_type.de),
+      .d (hw2reg.dst_data_type.d),
 
       // to internal hardware
       .qe(),
@@ -545,8 +608,8 @@ module dma_reg_top #(
       .wd(sign_ext_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.sign_ext.de),
+      .d (hw2reg.sign_ext.d),
 
       // to internal hardware
       .qe(),
@@ -572,8 +635,8 @@ module dma_reg_top #(
       .wd(mode_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.mode.de),
+      .d (hw2reg.mode.d),
 
       // to internal hardware
       .qe(),
@@ -599,8 +662,8 @@ module dma_reg_top #(
       .wd(dim_config_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.dim_config.de),
+      .d (hw2reg.dim_config.d),
 
       // to internal hardware
       .qe(),
@@ -626,8 +689,8 @@ module dma_reg_top #(
       .wd(dim_inv_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.dim_inv.de),
+      .d (hw2reg.dim_inv.d),
 
       // to internal hardware
       .qe(),
@@ -653,8 +716,8 @@ module dma_reg_top #(
       .wd(pad_top_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.pad_top.de),
+      .d (hw2reg.pad_top.d),
 
       // to internal hardware
       .qe(reg2hw.pad_top.qe),
@@ -680,8 +743,8 @@ module dma_reg_top #(
       .wd(pad_bottom_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.pad_bottom.de),
+      .d (hw2reg.pad_bottom.d),
 
       // to internal hardware
       .qe(reg2hw.pad_bottom.qe),
@@ -707,8 +770,8 @@ module dma_reg_top #(
       .wd(pad_right_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.pad_right.de),
+      .d (hw2reg.pad_right.d),
 
       // to internal hardware
       .qe(reg2hw.pad_right.qe),
@@ -734,8 +797,8 @@ module dma_reg_top #(
       .wd(pad_left_wd),
 
       // from internal hardware
-      .de(1'b0),
-      .d ('0),
+      .de(hw2reg.pad_left.de),
+      .d (hw2reg.pad_left.d),
 
       // to internal hardware
       .qe(reg2hw.pad_left.qe),
@@ -854,8 +917,435 @@ module dma_reg_top #(
 
 
 
+  // R[wide]: V(False)
+
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_wide (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(wide_we),
+      .wd(wide_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.wide.q),
+
+      // to register interface (read)
+      .qs(wide_qs)
+  );
+
+
+
+  // R[op_ctrl]: V(False)
+
+  //   F[scale]: 0:0
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_scale (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_scale_we),
+      .wd(op_ctrl_scale_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.scale.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_scale_qs)
+  );
+
+
+  //   F[add]: 1:1
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_add (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_add_we),
+      .wd(op_ctrl_add_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.add.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_add_qs)
+  );
+
+
+  //   F[min]: 2:2
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_min (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_min_we),
+      .wd(op_ctrl_min_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.min.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_min_qs)
+  );
+
+
+  //   F[max]: 3:3
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_max (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_max_we),
+      .wd(op_ctrl_max_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.max.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_max_qs)
+  );
+
+
+  //   F[threshold]: 4:4
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_threshold (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_threshold_we),
+      .wd(op_ctrl_threshold_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.threshold.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_threshold_qs)
+  );
+
+
+  //   F[acc]: 5:5
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_acc (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
 
-  logic [23:0] addr_hit;
+      // from register interface
+      .we(op_ctrl_acc_we),
+      .wd(op_ctrl_acc_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.acc.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_acc_qs)
+  );
+
+
+  //   F[bswap]: 6:6
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_bswap (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_bswap_we),
+      .wd(op_ctrl_bswap_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.bswap.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_bswap_qs)
+  );
+
+
+  //   F[signed_data]: 7:7
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_op_ctrl_signed_data (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_signed_data_we),
+      .wd(op_ctrl_signed_data_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.signed_data.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_signed_data_qs)
+  );
+
+
+  //   F[shift]: 12:8
+  prim_subreg #(
+      .DW      (5),
+      .SWACCESS("RW"),
+      .RESVAL  (5'h0)
+  ) u_op_ctrl_shift (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_ctrl_shift_we),
+      .wd(op_ctrl_shift_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_ctrl.shift.q),
+
+      // to register interface (read)
+      .qs(op_ctrl_shift_qs)
+  );
+
+
+
+  // R[op_scale]: V(False)
+
+  prim_subreg #(
+      .DW      (16),
+      .SWACCESS("RW"),
+      .RESVAL  (16'h0)
+  ) u_op_scale (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_scale_we),
+      .wd(op_scale_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_scale.q),
+
+      // to register interface (read)
+      .qs(op_scale_qs)
+  );
+
+
+  // R[op_add]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_op_add (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_add_we),
+      .wd(op_add_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_add.q),
+
+      // to register interface (read)
+      .qs(op_add_qs)
+  );
+
+
+  // R[op_min]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_op_min (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_min_we),
+      .wd(op_min_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_min.q),
+
+      // to register interface (read)
+      .qs(op_min_qs)
+  );
+
+
+  // R[op_max]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_op_max (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(op_max_we),
+      .wd(op_max_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_max.q),
+
+      // to register interface (read)
+      .qs(op_max_qs)
+  );
+
+
+  // R[op_acc]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RO"),
+      .RESVAL  (32'h0)
+  ) u_op_acc (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      .we(1'b0),
+      .wd('0),
+
+      // from internal hardware
+      .de(hw2reg.op_acc.de),
+      .d (hw2reg.op_acc.d),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.op_acc.q),
+
+      // to register interface (read)
+      .qs(op_acc_qs)
+  );
+
+
+  // R[ll_ptr]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_ll_ptr (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ll_ptr_we),
+      .wd(ll_ptr_wd),
+
+      // from internal hardware
+      .de(hw2reg.ll_ptr.de),
+      .d (hw2reg.ll_ptr.d),
+
+      // to internal hardware
+      .qe(reg2hw.ll_ptr.qe),
+      .q (reg2hw.ll_ptr.q),
+
+      // to register interface (read)
+      .qs(ll_ptr_qs)
+  );
+
+
+
+
+  logic [31:0] addr_hit;
   always_comb begin
     addr_hit = '0;
     addr_hit[0] = (reg_addr == DMA_SRC_PTR_OFFSET);
@@ -882,6 +1372,14 @@ module dma_reg_top #(
     addr_hit[21] = (reg_addr == DMA_WINDOW_SIZE_OFFSET);
     addr_hit[22] = (reg_addr == DMA_WINDOW_COUNT_OFFSET);
     addr_hit[23] = (reg_addr == DMA_INTERRUPT_EN_OFFSET);
+    addr_hit[24] = (reg_addr == DMA_WIDE_OFFSET);
+    addr_hit[25] = (reg_addr == DMA_OP_CTRL_OFFSET);
+    addr_hit[26] = (reg_addr == DMA_OP_SCALE_OFFSET);
+    addr_hit[27] = (reg_addr == DMA_OP_ADD_OFFSET);
+    addr_hit[28] = (reg_addr == DMA_OP_MIN_OFFSET);
+    addr_hit[29] = (reg_addr == DMA_OP_MAX_OFFSET);
+    addr_hit[30] = (reg_addr == DMA_OP_ACC_OFFSET);
+    addr_hit[31] = (reg_addr == DMA_LL_PTR_OFFSET);
   end
 
   assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0;
@@ -912,7 +1410,15 @@ module dma_reg_top #(
                (addr_hit[20] & (|(DMA_PERMIT[20] & ~reg_be))) |
                (addr_hit[21] & (|(DMA_PERMIT[21] & ~reg_be))) |
                (addr_hit[22] & (|(DMA_PERMIT[22] & ~reg_be))) |
-               (addr_hit[23] & (|(DMA_PERMIT[23] & ~reg_be)))));
+               (addr_hit[23] & (|(DMA_PERMIT[23] & ~reg_be))) |
+               (addr_hit[24] & (|(DMA_PERMIT[24] & ~reg_be))) |
+               (addr_hit[25] & (|(DMA_PERMIT[25] & ~reg_be))) |
+               (addr_hit[26] & (|(DMA_PERMIT[26] & ~reg_be))) |
+               (addr_hit[27] & (|(DMA_PERMIT[27] & ~reg_be))) |
+               (addr_hit[28] & (|(DMA_PERMIT[28] & ~reg_be))) |
+               (addr_hit[29] & (|(DMA_PERMIT[29] & ~reg_be))) |
+               (addr_hit[30] & (|(DMA_PERMIT[30] & ~reg_be))) |
+               (addr_hit[31] & (|(DMA_PERMIT[31] & ~reg_be)))));
   end
 
   assign src_ptr_we = addr_hit[0] & reg_we & !reg_error;
@@ -934,6 +1440,8 @@ module dma_reg_top #(
 
   assign status_window_done_re = addr_hit[5] & reg_re & !reg_error;
 
+  assign status_ll_irq_re = addr_hit[5] & reg_re & !reg_error;
+
   assign src_ptr_inc_d1_we = addr_hit[6] & reg_we & !reg_error;
   assign src_ptr_inc_d1_wd = reg_wdata[5:0];
 
@@ -991,6 +1499,51 @@ module dma_reg_top #(
   assign interrupt_en_window_done_we = addr_hit[23] & reg_we & !reg_error;
   assign interrupt_en_window_done_wd = reg_wdata[1];
 
+  assign wide_we = addr_hit[24] & reg_we & !reg_error;
+  assign wide_wd = reg_wdata[0];
+
+  assign op_ctrl_scale_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_scale_wd = reg_wdata[0];
+
+  assign op_ctrl_add_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_add_wd = reg_wdata[1];
+
+  assign op_ctrl_min_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_min_wd = reg_wdata[2];
+
+  assign op_ctrl_max_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_max_wd = reg_wdata[3];
+
+  assign op_ctrl_threshold_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_threshold_wd = reg_wdata[4];
+
+  assign op_ctrl_acc_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_acc_wd = reg_wdata[5];
+
+  assign op_ctrl_bswap_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_bswap_wd = reg_wdata[6];
+
+  assign op_ctrl_signed_data_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_signed_data_wd = reg_wdata[7];
+
+  assign op_ctrl_shift_we = addr_hit[25] & reg_we & !reg_error;
+  assign op_ctrl_shift_wd = reg_wdata[12:8];
+
+  assign op_scale_we = addr_hit[26] & reg_we & !reg_error;
+  assign op_scale_wd = reg_wdata[15:0];
+
+  assign op_add_we = addr_hit[27] & reg_we & !reg_error;
+  assign op_add_wd = reg_wdata[31:0];
+
+  assign op_min_we = addr_hit[28] & reg_we & !reg_error;
+  assign op_min_wd = reg_wdata[31:0];
+
+  assign op_max_we = addr_hit[29] & reg_we & !reg_error;
+  assign op_max_wd = reg_wdata[31:0];
+
+  assign ll_ptr_we = addr_hit[31] & reg_we & !reg_error;
+  assign ll_ptr_wd = reg_wdata[31:0];
+
   // Read data return
   always_comb begin
     reg_rdata_next = '0;
@@ -1018,6 +1571,7 @@ module dma_reg_top #(
       addr_hit[5]: begin
         reg_rdata_next[0] = status_ready_qs;
         reg_rdata_next[1] = status_window_done_qs;
+        reg_rdata_next[2] = status_ll_irq_qs;
       end
 
       addr_hit[6]: begin
@@ -1094,6 +1648,46 @@ module dma_reg_top #(
         reg_rdata_next[1] = interrupt_en_window_done_qs;
       end
 
+      addr_hit[24]: begin
+        reg_rdata_next[0] = wide_qs;
+      end
+
+      addr_hit[25]: begin
+        reg_rdata_next[0] = op_ctrl_scale_qs;
+        reg_rdata_next[1] = op_ctrl_add_qs;
+        reg_rdata_next[2] = op_ctrl_min_qs;
+        reg_rdata_next[3] = op_ctrl_max_qs;
+        reg_rdata_next[4] = op_ctrl_threshold_qs;
+        reg_rdata_next[5] = op_ctrl_acc_qs;
+        reg_rdata_next[6] = op_ctrl_bswap_qs;
+        reg_rdata_next[7] = op_ctrl_signed_data_qs;
+        reg_rdata_next[12:8] = op_ctrl_shift_qs;
+      end
+
+      addr_hit[26]: begin
+        reg_rdata_next[15:0] = op_scale_qs;
+      end
+
+      addr_hit[27]: begin
+        reg_rdata_next[31:0] = op_add_qs;
+      end
+
+      addr_hit[28]: begin
+        reg_rdata_next[31:0] = op_min_qs;
+      end
+
+      addr_hit[29]: begin
+        reg_rdata_next[31:0] = op_max_qs;
+      end
+
+      addr_hit[30]: begin
+        reg_rdata_next[31:0] = op_acc_qs;
+      end
+
+      addr_hit[31]: begin
+        reg_rdata_next[31:0] = ll_ptr_qs;
+      end
+
       default: begin
         reg_rdata_next = '1;
       end
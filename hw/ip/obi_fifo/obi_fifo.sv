@@ -3,11 +3,17 @@
 // SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
 
 //This module relies on the fact that the variable latency XBAR does not rise a new REQ if the previous one has not been granted
+//
+//With OUTSTANDING = 1 a request is granted only once the previous one has been answered, so each access is
+//serialised. With OUTSTANDING > 1 up to OUTSTANDING requests are in flight: they are issued to the consumer
+//back to back and its responses, which come back in order, are returned in the same order.
 
 
 module obi_fifo
   import obi_pkg::*;
-(
+#(
+    parameter int unsigned OUTSTANDING = 1
+) (
     input logic clk_i,
     input logic rst_ni,
 
@@ -18,20 +24,6 @@ module obi_fifo
     input  obi_resp_t consumer_resp_i
 );
 
-  typedef enum logic {
-    CONSUMER_REQUEST,
-    CONSUMER_WAIT_FOR_GNT
-  } consumer_obi_req_fsm_e;
-
-  consumer_obi_req_fsm_e consumer_state_n, consumer_state_q;
-
-  typedef enum logic {
-    PRODUCER_REQUEST,
-    PRODUCER_WAIT_FOR_VALID
-  } producer_obi_req_fsm_e;
-
-  producer_obi_req_fsm_e producer_state_n, producer_state_q;
-
   typedef struct packed {
     logic        we;
     logic [3:0]  be;
@@ -39,7 +31,7 @@ module obi_fifo
     logic [31:0] wdata;
   } obi_data_req_t;
 
-  obi_data_req_t producer_data_req, consumer_data_req, consumer_data_req_q;
+  obi_data_req_t producer_data_req, consumer_data_req;
 
   // remove .req from here if not it stays at 1
   assign {producer_data_req.we, producer_data_req.be, producer_data_req.addr, producer_data_req.wdata} =
@@ -49,127 +41,216 @@ module obi_fifo
 
   logic fifo_req_full, fifo_req_empty, fifo_req_push, fifo_req_pop;
   logic fifo_resp_full, fifo_resp_empty, fifo_resp_push, fifo_resp_pop;
-  logic save_request;
 
-  assign fifo_req_pop = !fifo_req_empty;
+  if (OUTSTANDING == 1) begin : gen_blocking
 
-  //block consumer outstanding transactions
-  always_comb begin
-    consumer_state_n = consumer_state_q;
-    consumer_req_o.req = ~fifo_req_empty;
-    save_request = 1'b0;
-    {consumer_req_o.we, consumer_req_o.be, consumer_req_o.addr, consumer_req_o.wdata} = {
-      consumer_data_req.we, consumer_data_req.be, consumer_data_req.addr, consumer_data_req.wdata
-    };
+    typedef enum logic {
+      CONSUMER_REQUEST,
+      CONSUMER_WAIT_FOR_GNT
+    } consumer_obi_req_fsm_e;
+
+    consumer_obi_req_fsm_e consumer_state_n, consumer_state_q;
+
+    typedef enum logic {
+      PRODUCER_REQUEST,
+      PRODUCER_WAIT_FOR_VALID
+    } producer_obi_req_fsm_e;
+
+    producer_obi_req_fsm_e producer_state_n, producer_state_q;
+
+    obi_data_req_t consumer_data_req_q;
+    logic save_request;
+
+    assign fifo_req_pop = !fifo_req_empty;
 
-    case (consumer_state_q)
+    //block consumer outstanding transactions
+    always_comb begin
+      consumer_state_n = consumer_state_q;
+      consumer_req_o.req = ~fifo_req_empty;
+      save_request = 1'b0;
+      {consumer_req_o.we, consumer_req_o.be, consumer_req_o.addr, consumer_req_o.wdata} = {
+        consumer_data_req.we, consumer_data_req.be, consumer_data_req.addr, consumer_data_req.wdata
+      };
 
-      CONSUMER_REQUEST: begin
-        if (!consumer_resp_i.gnt && consumer_req_o.req) begin
-          consumer_state_n = CONSUMER_WAIT_FOR_GNT;
-          save_request = 1'b1;
+      case (consumer_state_q)
+
+        CONSUMER_REQUEST: begin
+          if (!consumer_resp_i.gnt && consumer_req_o.req) begin
+            consumer_state_n = CONSUMER_WAIT_FOR_GNT;
+            save_request = 1'b1;
+          end
         end
-      end
 
-      CONSUMER_WAIT_FOR_GNT: begin
-        consumer_req_o.req = 1'b1;
-        {consumer_req_o.we, consumer_req_o.be, consumer_req_o.addr, consumer_req_o.wdata} = {
-          consumer_data_req_q.we,
-          consumer_data_req_q.be,
-          consumer_data_req_q.addr,
-          consumer_data_req_q.wdata
-        };
-        if (consumer_resp_i.gnt) begin
-          save_request = 1'b0;
-          consumer_state_n = CONSUMER_REQUEST;
+        CONSUMER_WAIT_FOR_GNT: begin
+          consumer_req_o.req = 1'b1;
+          {consumer_req_o.we, consumer_req_o.be, consumer_req_o.addr, consumer_req_o.wdata} = {
+            consumer_data_req_q.we,
+            consumer_data_req_q.be,
+            consumer_data_req_q.addr,
+            consumer_data_req_q.wdata
+          };
+          if (consumer_resp_i.gnt) begin
+            save_request = 1'b0;
+            consumer_state_n = CONSUMER_REQUEST;
+          end
         end
-      end
-    endcase
-  end
+      endcase
+    end
 
-  //block producer outstanding transactions, the FIFO in theory can support more request at a time
-  //but the bus won't dispatch the results depending on ID issues, so OBI slaves that have longer gnt/rvalid latency cannot support
-  //back to back requests
-  always_comb begin
-    producer_state_n    = producer_state_q;
-    producer_resp_o.gnt = !fifo_req_full;
-    fifo_req_push       = producer_req_i.req && !fifo_req_full;
+    //block producer outstanding transactions, the FIFO in theory can support more request at a time
+    //but the bus won't dispatch the results depending on ID issues, so OBI slaves that have longer gnt/rvalid latency cannot support
+    //back to back requests
+    always_comb begin
+      producer_state_n    = producer_state_q;
+      producer_resp_o.gnt = !fifo_req_full;
+      fifo_req_push       = producer_req_i.req && !fifo_req_full;
 
-    case (producer_state_q)
+      case (producer_state_q)
 
-      PRODUCER_REQUEST: begin
-        if (producer_req_i.req && !fifo_req_full) begin
-          producer_state_n = PRODUCER_WAIT_FOR_VALID;
+        PRODUCER_REQUEST: begin
+          if (producer_req_i.req && !fifo_req_full) begin
+            producer_state_n = PRODUCER_WAIT_FOR_VALID;
+          end
         end
-      end
 
-      PRODUCER_WAIT_FOR_VALID: begin
-        fifo_req_push       = 1'b0;
-        producer_resp_o.gnt = 1'b0;
-        if (producer_resp_o.rvalid) begin
-          fifo_req_push = producer_req_i.req && !fifo_req_full;
-          producer_resp_o.gnt = !fifo_req_full;
-          if (producer_req_i.req && producer_resp_o.gnt) begin
-            producer_state_n = PRODUCER_WAIT_FOR_VALID;
-          end else begin
-            producer_state_n = PRODUCER_REQUEST;
+        PRODUCER_WAIT_FOR_VALID: begin
+          fifo_req_push       = 1'b0;
+          producer_resp_o.gnt = 1'b0;
+          if (producer_resp_o.rvalid) begin
+            fifo_req_push = producer_req_i.req && !fifo_req_full;
+            producer_resp_o.gnt = !fifo_req_full;
+            if (producer_req_i.req && producer_resp_o.gnt) begin
+              producer_state_n = PRODUCER_WAIT_FOR_VALID;
+            end else begin
+              producer_state_n = PRODUCER_REQUEST;
+            end
           end
         end
+      endcase
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (~rst_ni) begin
+        consumer_state_q <= CONSUMER_REQUEST;
+        producer_state_q <= PRODUCER_REQUEST;
+        consumer_data_req_q <= '0;
+      end else begin
+        consumer_state_q <= consumer_state_n;
+        producer_state_q <= producer_state_n;
+        if (save_request) consumer_data_req_q <= consumer_data_req;
       end
-    endcase
-  end
+    end
+
+
+    fifo_v3 #(
+        .DEPTH(1),
+        .dtype(obi_data_req_t)
+    ) obi_req_fifo_i (
+        .clk_i,
+        .rst_ni,
+        .flush_i(1'b0),
+        .testmode_i(1'b0),
+        .full_o(fifo_req_full),
+        .empty_o(fifo_req_empty),
+        .usage_o(),
+        .data_i(producer_data_req),
+        .push_i(fifo_req_push),
+        .data_o(consumer_data_req),
+        .pop_i(fifo_req_pop)
+    );
+
+    //todo add asserts - it cannot be full as we are popping all the time
+    assign fifo_resp_push = consumer_resp_i.rvalid & !fifo_resp_full;
+    assign fifo_resp_pop = !fifo_resp_empty;
+    assign producer_resp_o.rvalid = fifo_resp_pop;
+
+    fifo_v3 #(
+        .DEPTH(1),
+        .dtype(logic [31:0])
+    ) obi_resp_fifo_i (
+        .clk_i,
+        .rst_ni,
+        .flush_i(1'b0),
+        .testmode_i(1'b0),
+        .full_o(fifo_resp_full),
+        .empty_o(fifo_resp_empty),
+        .usage_o(),
+        .data_i(consumer_resp_i.rdata),
+        .push_i(fifo_resp_push),
+        // grant is given above
+        .data_o(producer_resp_o.rdata),
+        .pop_i(fifo_resp_pop)
+    );
+
+  end else begin : gen_outstanding
+
+    localparam int unsigned CntWidth = $clog2(OUTSTANDING + 1);
 
-  always_ff @(posedge clk_i or negedge rst_ni) begin
-    if (~rst_ni) begin
-      consumer_state_q <= CONSUMER_REQUEST;
-      producer_state_q <= PRODUCER_REQUEST;
-      consumer_data_req_q <= '0;
-    end else begin
-      consumer_state_q <= consumer_state_n;
-      producer_state_q <= producer_state_n;
-      if (save_request) consumer_data_req_q <= consumer_data_req;
+    // Requests granted to the producer and not answered yet
+    logic [CntWidth-1:0] outstanding_q;
+    logic producer_gnt;
+
+    assign producer_gnt = !fifo_req_full && outstanding_q != CntWidth'(OUTSTANDING);
+    assign producer_resp_o.gnt = producer_gnt;
+    assign fifo_req_push = producer_req_i.req && producer_gnt;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (~rst_ni) begin
+        outstanding_q <= '0;
+      end else if (fifo_req_push && !producer_resp_o.rvalid) begin
+        outstanding_q <= outstanding_q + 1'b1;
+      end else if (!fifo_req_push && producer_resp_o.rvalid) begin
+        outstanding_q <= outstanding_q - 1'b1;
+      end
     end
-  end
 
+    // The head of the FIFO is held on the consumer port until it is granted
+    assign consumer_req_o.req = !fifo_req_empty;
+    assign {consumer_req_o.we, consumer_req_o.be, consumer_req_o.addr, consumer_req_o.wdata} = {
+      consumer_data_req.we, consumer_data_req.be, consumer_data_req.addr, consumer_data_req.wdata
+    };
+    assign fifo_req_pop = !fifo_req_empty && consumer_resp_i.gnt;
+
+    fifo_v3 #(
+        .DEPTH(OUTSTANDING),
+        .dtype(obi_data_req_t)
+    ) obi_req_fifo_i (
+        .clk_i,
+        .rst_ni,
+        .flush_i(1'b0),
+        .testmode_i(1'b0),
+        .full_o(fifo_req_full),
+        .empty_o(fifo_req_empty),
+        .usage_o(),
+        .data_i(producer_data_req),
+        .push_i(fifo_req_push),
+        .data_o(consumer_data_req),
+        .pop_i(fifo_req_pop)
+    );
+
+    // At most OUTSTANDING responses are expected, so it is never full. The
+    // responses are returned one cycle after the consumer gives them.
+    assign fifo_resp_push = consumer_resp_i.rvalid;
+    assign fifo_resp_pop = !fifo_resp_empty;
+    assign producer_resp_o.rvalid = fifo_resp_pop;
 
-  fifo_v3 #(
-      .DEPTH(1),
-      .dtype(obi_data_req_t)
-  ) obi_req_fifo_i (
-      .clk_i,
-      .rst_ni,
-      .flush_i(1'b0),
-      .testmode_i(1'b0),
-      .full_o(fifo_req_full),
-      .empty_o(fifo_req_empty),
-      .usage_o(),
-      .data_i(producer_data_req),
-      .push_i(fifo_req_push),
-      .data_o(consumer_data_req),
-      .pop_i(fifo_req_pop)
-  );
-
-  //todo add asserts - it cannot be full as we are popping all the time
-  assign fifo_resp_push = consumer_resp_i.rvalid & !fifo_resp_full;
-  assign fifo_resp_pop = !fifo_resp_empty;
-  assign producer_resp_o.rvalid = fifo_resp_pop;
-
-  fifo_v3 #(
-      .DEPTH(1),
-      .dtype(logic [31:0])
-  ) obi_resp_fifo_i (
-      .clk_i,
-      .rst_ni,
-      .flush_i(1'b0),
-      .testmode_i(1'b0),
-      .full_o(fifo_resp_full),
-      .empty_o(fifo_resp_empty),
-      .usage_o(),
-      .data_i(consumer_resp_i.rdata),
-      .push_i(fifo_resp_push),
-      // grant is given above
-      .data_o(producer_resp_o.rdata),
-      .pop_i(fifo_resp_pop)
-  );
+    fifo_v3 #(
+        .DEPTH(OUTSTANDING),
+        .dtype(logic [31:0])
+    ) obi_resp_fifo_i (
+        .clk_i,
+        .rst_ni,
+        .flush_i(1'b0),
+        .testmode_i(1'b0),
+        .full_o(fifo_resp_full),
+        .empty_o(fifo_resp_empty),
+        .usage_o(),
+        .data_i(consumer_resp_i.rdata),
+        .push_i(fifo_resp_push),
+        .data_o(producer_resp_o.rdata),
+        .pop_i(fifo_resp_pop)
+    );
+
+  end
 
 endmodule
@@ -7,7 +7,11 @@
 module obi_spimemio
   import obi_pkg::*;
   import reg_pkg::*;
-(
+#(
+    // Read cache in front of spimemio, removed when CACHE_SIZE is 0
+    parameter int unsigned CACHE_SIZE      = 0,
+    parameter int unsigned CACHE_LINE_SIZE = 16
+) (
     input  logic clk_i,
     input  logic rst_ni,
     output logic flash_csb_o,
@@ -32,14 +36,17 @@ module obi_spimemio
     output reg_rsp_t reg_rsp_o,
 
     input  obi_req_t  spimemio_req_i,
-    output obi_resp_t spimemio_resp_o
+    output obi_resp_t spimemio_resp_o,
+
+    output logic [31:0] cache_hits_o,
+    output logic [31:0] cache_misses_o
 );
 
   import picorv32_pkg::*;
   import obi_spimemio_reg_pkg::*;
 
-  picorv32_req_t  picorv32_req;
-  picorv32_resp_t picorv32_resp;
+  picorv32_req_t picorv32_req, spimemio_req;
+  picorv32_resp_t picorv32_resp, spimemio_resp;
 
   reg_rsp_t reg_rsp_reg, reg_rsp_spimem;
 
@@ -57,6 +64,21 @@ module obi_spimemio
       .obi_resp_o(spimemio_resp_o)
   );
 
+  spimemio_cache #(
+      .SIZE(CACHE_SIZE),
+      .LINE_SIZE(CACHE_LINE_SIZE)
+  ) spimemio_cache_i (
+      .clk_i,
+      .rst_ni,
+      .req_i(picorv32_req),
+      .resp_o(picorv32_resp),
+      .req_o(spimemio_req),
+      .resp_i(spimemio_resp),
+      .invalidate_i(reg2hw.cache_invalidate.qe & reg2hw.cache_invalidate.q),
+      .hits_o(cache_hits_o),
+      .misses_o(cache_misses_o)
+  );
+
   obi_spimemio_reg_top #(
       .reg_req_t(reg_req_t),
       .reg_rsp_t(reg_rsp_t)
@@ -88,10 +110,10 @@ module obi_spimemio
       .clk(clk_i),
       .resetn(rst_ni),
       .start_spi_i(reg2hw.start_spimem.q),
-      .valid(picorv32_req.valid),
-      .ready(picorv32_resp.ready),
-      .addr({picorv32_req.addr[23:2], 2'b00}),
-      .rdata(picorv32_resp.rdata),
+      .valid(spimemio_req.valid),
+      .ready(spimemio_resp.ready),
+      .addr({spimemio_req.addr[23:2], 2'b00}),
+      .rdata(spimemio_resp.rdata),
 
       .flash_csb(flash_csb_o),
       .flash_clk(flash_clk_o),
@@ -7,7 +7,7 @@
 package obi_spimemio_reg_pkg;
 
   // Address widths within the block
-  parameter int BlockAw = 3;
+  parameter int BlockAw = 4;
 
   ////////////////////////////
   // Typedefs for registers //
@@ -15,25 +15,34 @@ package obi_spimemio_reg_pkg;
 
   typedef struct packed {logic q;} obi_spimemio_reg2hw_start_spimem_reg_t;
 
+  typedef struct packed {
+    logic q;
+    logic qe;
+  } obi_spimemio_reg2hw_cache_invalidate_reg_t;
+
   // Register -> HW type
   typedef struct packed {
-    obi_spimemio_reg2hw_start_spimem_reg_t start_spimem;  // [0:0]
+    obi_spimemio_reg2hw_start_spimem_reg_t start_spimem;  // [2:2]
+    obi_spimemio_reg2hw_cache_invalidate_reg_t cache_invalidate;  // [1:0]
   } obi_spimemio_reg2hw_t;
 
   // Register offsets
-  parameter logic [BlockAw-1:0] OBI_SPIMEMIO_START_SPIMEM_OFFSET = 3'h0;
-  parameter logic [BlockAw-1:0] OBI_SPIMEMIO_CFG_SPIMEM_OFFSET = 3'h4;
+  parameter logic [BlockAw-1:0] OBI_SPIMEMIO_START_SPIMEM_OFFSET = 4'h0;
+  parameter logic [BlockAw-1:0] OBI_SPIMEMIO_CFG_SPIMEM_OFFSET = 4'h4;
+  parameter logic [BlockAw-1:0] OBI_SPIMEMIO_CACHE_INVALIDATE_OFFSET = 4'h8;
 
   // Register index
   typedef enum int {
     OBI_SPIMEMIO_START_SPIMEM,
-    OBI_SPIMEMIO_CFG_SPIMEM
+    OBI_SPIMEMIO_CFG_SPIMEM,
+    OBI_SPIMEMIO_CACHE_INVALIDATE
   } obi_spimemio_id_e;
 
   // Register width information to check illegal writes
-  parameter logic [3:0] OBI_SPIMEMIO_PERMIT[2] = '{
+  parameter logic [3:0] OBI_SPIMEMIO_PERMIT[3] = '{
       4'b0001,  // index[0] OBI_SPIMEMIO_START_SPIMEM
-      4'b1111  // index[1] OBI_SPIMEMIO_CFG_SPIMEM
+      4'b1111,  // index[1] OBI_SPIMEMIO_CFG_SPIMEM
+      4'b0001  // index[2] OBI_SPIMEMIO_CACHE_INVALIDATE
   };
 
 endpackage
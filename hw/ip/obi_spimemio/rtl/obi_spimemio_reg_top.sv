@@ -10,7 +10,7 @@
 module obi_spimemio_reg_top #(
     parameter type reg_req_t = logic,
     parameter type reg_rsp_t = logic,
-    parameter int AW = 3
+    parameter int AW = 4
 ) (
     input clk_i,
     input rst_ni,
@@ -70,6 +70,8 @@ module obi_spimemio_reg_top #(
   logic start_spimem_qs;
   logic start_spimem_wd;
   logic start_spimem_we;
+  logic cache_invalidate_wd;
+  logic cache_invalidate_we;
 
   // Register instances
   // R[start_spimem]: V(False)
@@ -124,13 +126,40 @@ module obi_spimemio_reg_top #(
   );
 
 
+  // R[cache_invalidate]: V(False)
 
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("WO"),
+      .RESVAL  (1'h0)
+  ) u_cache_invalidate (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(cache_invalidate_we),
+      .wd(cache_invalidate_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
 
-  logic [1:0] addr_hit;
+      // to internal hardware
+      .qe(reg2hw.cache_invalidate.qe),
+      .q (reg2hw.cache_invalidate.q),
+
+      .qs()
+  );
+
+
+
+
+  logic [2:0] addr_hit;
   always_comb begin
     addr_hit = '0;
     addr_hit[0] = (reg_addr == OBI_SPIMEMIO_START_SPIMEM_OFFSET);
     addr_hit[1] = (reg_addr == OBI_SPIMEMIO_CFG_SPIMEM_OFFSET);
+    addr_hit[2] = (reg_addr == OBI_SPIMEMIO_CACHE_INVALIDATE_OFFSET);
   end
 
   assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0;
@@ -139,12 +168,16 @@ module obi_spimemio_reg_top #(
   always_comb begin
     wr_err = (reg_we &
               ((addr_hit[0] & (|(OBI_SPIMEMIO_PERMIT[0] & ~reg_be))) |
-               (addr_hit[1] & (|(OBI_SPIMEMIO_PERMIT[1] & ~reg_be)))));
+               (addr_hit[1] & (|(OBI_SPIMEMIO_PERMIT[1] & ~reg_be))) |
+               (addr_hit[2] & (|(OBI_SPIMEMIO_PERMIT[2] & ~reg_be)))));
   end
 
   assign start_spimem_we = addr_hit[0] & reg_we & !reg_error;
   assign start_spimem_wd = reg_wdata[0];
 
+  assign cache_invalidate_we = addr_hit[2] & reg_we & !reg_error;
+  assign cache_invalidate_wd = reg_wdata[0];
+
   // Read data return
   always_comb begin
     reg_rdata_next = '0;
@@ -157,6 +190,10 @@ module obi_spimemio_reg_top #(
         reg_rdata_next[31:0] = '0;
       end
 
+      addr_hit[2]: begin
+        reg_rdata_next[0] = '0;
+      end
+
       default: begin
         reg_rdata_next = '1;
       end
@@ -0,0 +1,186 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Direct-mapped read cache between the OBI adapter and spimemio.
+// A miss fetches the whole line with consecutive word reads, which spimemio
+// serves as a single continuous flash read. Writes are not cached and are
+// forwarded as is. With SIZE = 0 the cache is removed.
+
+module spimemio_cache
+  import picorv32_pkg::*;
+#(
+    parameter int unsigned SIZE      = 4096,  // Bytes
+    parameter int unsigned LINE_SIZE = 16,    // Bytes
+    parameter int unsigned AW        = 24     // Address bits used by spimemio
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  picorv32_req_t  req_i,
+    output picorv32_resp_t resp_o,
+
+    output picorv32_req_t  req_o,
+    input  picorv32_resp_t resp_i,
+
+    // Pulse: drop all the lines and clear the counters
+    input logic invalidate_i,
+
+    output logic [31:0] hits_o,
+    output logic [31:0] misses_o
+);
+
+  if (SIZE == 0) begin : gen_no_cache
+
+    assign req_o    = req_i;
+    assign resp_o   = resp_i;
+    assign hits_o   = '0;
+    assign misses_o = '0;
+
+    logic unused_invalidate;
+    assign unused_invalidate = invalidate_i;
+
+  end else begin : gen_cache
+
+    localparam int unsigned LINES = SIZE / LINE_SIZE;
+    localparam int unsigned WORDS = LINE_SIZE / 4;
+    localparam int unsigned OFFSET_W = $clog2(LINE_SIZE);
+    localparam int unsigned INDEX_W = LINES > 1 ? $clog2(LINES) : 1;
+    localparam int unsigned WORD_W = WORDS > 1 ? $clog2(WORDS) : 1;
+    localparam int unsigned TAG_W = AW - OFFSET_W - (LINES > 1 ? INDEX_W : 0);
+
+    logic [31:0] data_q[LINES][WORDS];
+    logic [TAG_W-1:0] tag_q[LINES];
+    logic [LINES-1:0] valid_q;
+
+    enum logic {
+      IDLE,
+      FILL
+    }
+        state_q, state_d;
+
+    logic [WORD_W-1:0] fill_cnt_q, fill_cnt_d;
+    // Set when the cache is invalidated during a fill: the line must not be validated
+    logic fill_stale_q, fill_stale_d;
+    logic [31:0] hits_q, misses_q;
+    // Set from the end of a line fill until the request that missed is served
+    logic filled_q;
+
+    logic [INDEX_W-1:0] index;
+    logic [WORD_W-1:0] word;
+    logic [TAG_W-1:0] tag;
+    logic read, hit, last_word;
+
+    if (LINES > 1) begin : gen_index
+      assign index = req_i.addr[OFFSET_W+:INDEX_W];
+    end else begin : gen_single_line
+      assign index = '0;
+    end
+
+    if (WORDS > 1) begin : gen_word
+      assign word = req_i.addr[2+:WORD_W];
+    end else begin : gen_single_word
+      assign word = '0;
+    end
+
+    assign tag = req_i.addr[AW-1-:TAG_W];
+    assign read = req_i.valid && req_i.wstrb == 4'b0000;
+    assign hit = valid_q[index] && tag_q[index] == tag;
+    assign last_word = fill_cnt_q == WORD_W'(WORDS - 1);
+
+    always_comb begin
+      state_d      = state_q;
+      fill_cnt_d   = fill_cnt_q;
+      fill_stale_d = fill_stale_q | invalidate_i;
+
+      req_o        = '0;
+      resp_o.ready = 1'b0;
+      resp_o.rdata = data_q[index][word];
+
+      case (state_q)
+        IDLE: begin
+          if (req_i.valid && !read) begin
+            // Writes bypass the cache
+            req_o  = req_i;
+            resp_o = resp_i;
+          end else if (read && hit && !invalidate_i) begin
+            resp_o.ready = 1'b1;
+          end else if (read && !invalidate_i) begin
+            state_d      = FILL;
+            fill_cnt_d   = '0;
+            fill_stale_d = 1'b0;
+          end
+        end
+
+        FILL: begin
+          req_o.valid = 1'b1;
+          req_o.addr  = {req_i.addr[31:OFFSET_W], OFFSET_W'(0)};
+          if (WORDS > 1) begin
+            req_o.addr[2+:WORD_W] = fill_cnt_q;
+          end
+          if (resp_i.ready) begin
+            fill_cnt_d = fill_cnt_q + 1;
+            if (last_word) begin
+              state_d = IDLE;
+            end
+          end
+        end
+
+        default: state_d = IDLE;
+      endcase
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        state_q      <= IDLE;
+        fill_cnt_q   <= '0;
+        fill_stale_q <= 1'b0;
+        valid_q      <= '0;
+        filled_q     <= 1'b0;
+        hits_q       <= '0;
+        misses_q     <= '0;
+      end else begin
+        state_q      <= state_d;
+        fill_cnt_q   <= fill_cnt_d;
+        fill_stale_q <= fill_stale_d;
+
+        if (state_q == FILL && resp_i.ready && last_word) begin
+          valid_q[index] <= !fill_stale_d;
+        end
+        if (invalidate_i) begin
+          valid_q <= '0;
+        end
+
+        if (state_q == FILL && state_d == IDLE) begin
+          filled_q <= 1'b1;
+        end else if (resp_o.ready) begin
+          filled_q <= 1'b0;
+        end
+
+        if (invalidate_i) begin
+          hits_q   <= '0;
+          misses_q <= '0;
+        end else if (state_q == IDLE && state_d == FILL) begin
+          misses_q <= misses_q + 1;
+        end else if (resp_o.ready && read && !filled_q) begin
+          // The hit that serves a request after its line fill is not counted
+          hits_q <= hits_q + 1;
+        end
+      end
+    end
+
+    always_ff @(posedge clk_i) begin
+      if (state_q == FILL && resp_i.ready) begin
+        data_q[index][fill_cnt_q] <= resp_i.rdata;
+        if (last_word) begin
+          tag_q[index] <= tag;
+        end
+      end
+    end
+
+    assign hits_o   = hits_q;
+    assign misses_o = misses_q;
+
+  end
+
+endmodule : spimemio_cache
@@ -22,7 +22,10 @@ module pdm2pcm #(
 
     // PDM interface
     input  logic pdm_i,
-    output logic pdm_clk_o
+    output logic pdm_clk_o,
+
+    // DMA trigger, high while a sample can be read
+    output logic rx_valid_o
 );
 
   import pdm2pcm_reg_pkg::*;
@@ -121,6 +124,7 @@ module pdm2pcm #(
 
   assign push                  = pcm_data_valid & ~full;
   assign pop                   = rx_ready & ~empty;
+  assign rx_valid_o            = ~empty;
 
   assign hw2reg.status.fulll.d = full;
   assign hw2reg.status.empty.d = empty;
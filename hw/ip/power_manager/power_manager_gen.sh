@@ -1,5 +1,8 @@
 
 echo "Generating RTL"
-${PYTHON} ../../vendor/pulp_platform_register_interface/vendor/lowrisc_opentitan/util/regtool.py -r -t rtl ./data/power_manager.hjson
+RTL_TMP=$(mktemp -d)
+${PYTHON} ../../vendor/pulp_platform_register_interface/vendor/lowrisc_opentitan/util/regtool.py -r -t $RTL_TMP ./data/power_manager.hjson
+${PYTHON} ../../../util/gen_cache.py sync $RTL_TMP rtl
+rm -rf $RTL_TMP
 echo "Generating SW"
 ${PYTHON} ../../vendor/pulp_platform_register_interface/vendor/lowrisc_opentitan/util/regtool.py --cdefines -o ../../../sw/device/lib/drivers/power_manager/power_manager_regs.h ./data/power_manager.hjson
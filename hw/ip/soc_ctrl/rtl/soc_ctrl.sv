@@ -19,6 +19,28 @@ module soc_ctrl #(
     input  logic execute_from_flash_i,
     output logic use_spimemio_o,
 
+    input logic [31:0] flash_cache_hits_i,
+    input logic [31:0] flash_cache_misses_i,
+
+    // Arbitration settings of the system crossbar
+    output logic        bus_qos_override_o,
+    output logic [15:0] bus_qos_window_o,
+    output logic [31:0] bus_qos_priority_o,
+    output logic [31:0] bus_qos_budget_o,
+
+    // Performance counters of the system crossbar
+    output logic        perf_freeze_o,
+    output logic        perf_clear_o,
+    output logic [ 7:0] perf_sel_o,
+    input  logic [31:0] perf_value_i,
+
+    // Instruction buffer of the main core
+    output logic        instr_buf_enable_o,
+    output logic        instr_buf_prefetch_o,
+    output logic        instr_buf_clear_o,
+    input  logic [31:0] instr_buf_hits_i,
+    input  logic [31:0] instr_buf_misses_i,
+
     output logic        exit_valid_o,
     output logic [31:0] exit_value_o
 );
@@ -53,6 +75,14 @@ module soc_ctrl #(
   assign hw2reg.use_spimemio.de = ~enable_spi_sel;
   assign hw2reg.use_spimemio.d  = execute_from_flash_i;
 
+  assign hw2reg.flash_cache_hits.d = flash_cache_hits_i;
+  assign hw2reg.flash_cache_misses.d = flash_cache_misses_i;
+
+  assign hw2reg.perf_value.d = perf_value_i;
+
+  assign hw2reg.instr_buf_hits.d = instr_buf_hits_i;
+  assign hw2reg.instr_buf_misses.d = instr_buf_misses_i;
+
   soc_ctrl_reg_top #(
       .reg_req_t(reg_req_t),
       .reg_rsp_t(reg_rsp_t)
@@ -71,4 +101,17 @@ module soc_ctrl #(
   assign use_spimemio_o = reg2hw.use_spimemio.q;
   assign enable_spi_sel = reg2hw.enable_spi_sel.q;
 
+  assign bus_qos_override_o = reg2hw.bus_qos_ctrl.override.q;
+  assign bus_qos_window_o   = reg2hw.bus_qos_ctrl.window.q;
+  assign bus_qos_priority_o = reg2hw.bus_qos_priority.q;
+  assign bus_qos_budget_o   = reg2hw.bus_qos_budget.q;
+
+  assign perf_freeze_o = reg2hw.perf_ctrl.freeze.q;
+  assign perf_clear_o  = reg2hw.perf_ctrl.clear.q;
+  assign perf_sel_o    = reg2hw.perf_ctrl.sel.q;
+
+  assign instr_buf_enable_o   = reg2hw.instr_buf_ctrl.enable.q;
+  assign instr_buf_prefetch_o = reg2hw.instr_buf_ctrl.prefetch.q;
+  assign instr_buf_clear_o    = reg2hw.instr_buf_ctrl.clear.q;
+
 endmodule : soc_ctrl
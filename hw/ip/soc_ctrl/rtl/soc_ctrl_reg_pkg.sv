@@ -7,7 +7,7 @@
 package soc_ctrl_reg_pkg;
 
   // Address widths within the block
-  parameter int BlockAw = 5;
+  parameter int BlockAw = 7;
 
   ////////////////////////////
   // Typedefs for registers //
@@ -27,6 +27,27 @@ package soc_ctrl_reg_pkg;
 
   typedef struct packed {logic q;} soc_ctrl_reg2hw_enable_spi_sel_reg_t;
 
+  typedef struct packed {
+    struct packed {logic q;} override;
+    struct packed {logic [15:0] q;} window;
+  } soc_ctrl_reg2hw_bus_qos_ctrl_reg_t;
+
+  typedef struct packed {logic [31:0] q;} soc_ctrl_reg2hw_bus_qos_priority_reg_t;
+
+  typedef struct packed {logic [31:0] q;} soc_ctrl_reg2hw_bus_qos_budget_reg_t;
+
+  typedef struct packed {
+    struct packed {logic q;} freeze;
+    struct packed {logic q;} clear;
+    struct packed {logic [7:0] q;} sel;
+  } soc_ctrl_reg2hw_perf_ctrl_reg_t;
+
+  typedef struct packed {
+    struct packed {logic q;} enable;
+    struct packed {logic q;} prefetch;
+    struct packed {logic q;} clear;
+  } soc_ctrl_reg2hw_instr_buf_ctrl_reg_t;
+
   typedef struct packed {
     logic d;
     logic de;
@@ -42,33 +63,71 @@ package soc_ctrl_reg_pkg;
     logic de;
   } soc_ctrl_hw2reg_use_spimemio_reg_t;
 
+  typedef struct packed {logic [31:0] d;} soc_ctrl_hw2reg_flash_cache_hits_reg_t;
+
+  typedef struct packed {logic [31:0] d;} soc_ctrl_hw2reg_flash_cache_misses_reg_t;
+
+  typedef struct packed {logic [31:0] d;} soc_ctrl_hw2reg_perf_value_reg_t;
+
+  typedef struct packed {logic [31:0] d;} soc_ctrl_hw2reg_instr_buf_hits_reg_t;
+
+  typedef struct packed {logic [31:0] d;} soc_ctrl_hw2reg_instr_buf_misses_reg_t;
+
   // Register -> HW type
   typedef struct packed {
-    soc_ctrl_reg2hw_exit_valid_reg_t exit_valid;  // [68:68]
-    soc_ctrl_reg2hw_exit_value_reg_t exit_value;  // [67:36]
-    soc_ctrl_reg2hw_boot_select_reg_t boot_select;  // [35:35]
-    soc_ctrl_reg2hw_boot_exit_loop_reg_t boot_exit_loop;  // [34:34]
-    soc_ctrl_reg2hw_boot_address_reg_t boot_address;  // [33:2]
-    soc_ctrl_reg2hw_use_spimemio_reg_t use_spimemio;  // [1:1]
-    soc_ctrl_reg2hw_enable_spi_sel_reg_t enable_spi_sel;  // [0:0]
+    soc_ctrl_reg2hw_exit_valid_reg_t exit_valid;  // [162:162]
+    soc_ctrl_reg2hw_exit_value_reg_t exit_value;  // [161:130]
+    soc_ctrl_reg2hw_boot_select_reg_t boot_select;  // [129:129]
+    soc_ctrl_reg2hw_boot_exit_loop_reg_t boot_exit_loop;  // [128:128]
+    soc_ctrl_reg2hw_boot_address_reg_t boot_address;  // [127:96]
+    soc_ctrl_reg2hw_use_spimemio_reg_t use_spimemio;  // [95:95]
+    soc_ctrl_reg2hw_enable_spi_sel_reg_t enable_spi_sel;  // [94:94]
+    soc_ctrl_reg2hw_bus_qos_ctrl_reg_t bus_qos_ctrl;  // [93:77]
+    soc_ctrl_reg2hw_bus_qos_priority_reg_t bus_qos_priority;  // [76:45]
+    soc_ctrl_reg2hw_bus_qos_budget_reg_t bus_qos_budget;  // [44:13]
+    soc_ctrl_reg2hw_perf_ctrl_reg_t perf_ctrl;  // [12:3]
+    soc_ctrl_reg2hw_instr_buf_ctrl_reg_t instr_buf_ctrl;  // [2:0]
   } soc_ctrl_reg2hw_t;
 
   // HW -> register type
   typedef struct packed {
-    soc_ctrl_hw2reg_boot_select_reg_t boot_select;  // [5:4]
-    soc_ctrl_hw2reg_boot_exit_loop_reg_t boot_exit_loop;  // [3:2]
-    soc_ctrl_hw2reg_use_spimemio_reg_t use_spimemio;  // [1:0]
+    soc_ctrl_hw2reg_boot_select_reg_t boot_select;  // [165:164]
+    soc_ctrl_hw2reg_boot_exit_loop_reg_t boot_exit_loop;  // [163:162]
+    soc_ctrl_hw2reg_use_spimemio_reg_t use_spimemio;  // [161:160]
+    soc_ctrl_hw2reg_flash_cache_hits_reg_t flash_cache_hits;  // [159:128]
+    soc_ctrl_hw2reg_flash_cache_misses_reg_t flash_cache_misses;  // [127:96]
+    soc_ctrl_hw2reg_perf_value_reg_t perf_value;  // [95:64]
+    soc_ctrl_hw2reg_instr_buf_hits_reg_t instr_buf_hits;  // [63:32]
+    soc_ctrl_hw2reg_instr_buf_misses_reg_t instr_buf_misses;  // [31:0]
   } soc_ctrl_hw2reg_t;
 
   // Register offsets
-  parameter logic [BlockAw-1:0] SOC_CTRL_EXIT_VALID_OFFSET = 5'h0;
-  parameter logic [BlockAw-1:0] SOC_CTRL_EXIT_VALUE_OFFSET = 5'h4;
-  parameter logic [BlockAw-1:0] SOC_CTRL_BOOT_SELECT_OFFSET = 5'h8;
-  parameter logic [BlockAw-1:0] SOC_CTRL_BOOT_EXIT_LOOP_OFFSET = 5'hc;
-  parameter logic [BlockAw-1:0] SOC_CTRL_BOOT_ADDRESS_OFFSET = 5'h10;
-  parameter logic [BlockAw-1:0] SOC_CTRL_USE_SPIMEMIO_OFFSET = 5'h14;
-  parameter logic [BlockAw-1:0] SOC_CTRL_ENABLE_SPI_SEL_OFFSET = 5'h18;
-  parameter logic [BlockAw-1:0] SOC_CTRL_SYSTEM_FREQUENCY_HZ_OFFSET = 5'h1c;
+  parameter logic [BlockAw-1:0] SOC_CTRL_EXIT_VALID_OFFSET = 7'h0;
+  parameter logic [BlockAw-1:0] SOC_CTRL_EXIT_VALUE_OFFSET = 7'h4;
+  parameter logic [BlockAw-1:0] SOC_CTRL_BOOT_SELECT_OFFSET = 7'h8;
+  parameter logic [BlockAw-1:0] SOC_CTRL_BOOT_EXIT_LOOP_OFFSET = 7'hc;
+  parameter logic [BlockAw-1:0] SOC_CTRL_BOOT_ADDRESS_OFFSET = 7'h10;
+  parameter logic [BlockAw-1:0] SOC_CTRL_USE_SPIMEMIO_OFFSET = 7'h14;
+  parameter logic [BlockAw-1:0] SOC_CTRL_ENABLE_SPI_SEL_OFFSET = 7'h18;
+  parameter logic [BlockAw-1:0] SOC_CTRL_SYSTEM_FREQUENCY_HZ_OFFSET = 7'h1c;
+  parameter logic [BlockAw-1:0] SOC_CTRL_FLASH_CACHE_HITS_OFFSET = 7'h20;
+  parameter logic [BlockAw-1:0] SOC_CTRL_FLASH_CACHE_MISSES_OFFSET = 7'h24;
+  parameter logic [BlockAw-1:0] SOC_CTRL_BUS_QOS_CTRL_OFFSET = 7'h28;
+  parameter logic [BlockAw-1:0] SOC_CTRL_BUS_QOS_PRIORITY_OFFSET = 7'h2c;
+  parameter logic [BlockAw-1:0] SOC_CTRL_BUS_QOS_BUDGET_OFFSET = 7'h30;
+  parameter logic [BlockAw-1:0] SOC_CTRL_SCRATCH_OFFSET = 7'h34;
+  parameter logic [BlockAw-1:0] SOC_CTRL_PERF_CTRL_OFFSET = 7'h38;
+  parameter logic [BlockAw-1:0] SOC_CTRL_PERF_VALUE_OFFSET = 7'h3c;
+  parameter logic [BlockAw-1:0] SOC_CTRL_INSTR_BUF_CTRL_OFFSET = 7'h40;
+  parameter logic [BlockAw-1:0] SOC_CTRL_INSTR_BUF_HITS_OFFSET = 7'h44;
+  parameter logic [BlockAw-1:0] SOC_CTRL_INSTR_BUF_MISSES_OFFSET = 7'h48;
+
+  // Reset values for hwext registers and their fields
+  parameter logic [31:0] SOC_CTRL_FLASH_CACHE_HITS_RESVAL = 32'h0;
+  parameter logic [31:0] SOC_CTRL_FLASH_CACHE_MISSES_RESVAL = 32'h0;
+  parameter logic [31:0] SOC_CTRL_PERF_VALUE_RESVAL = 32'h0;
+  parameter logic [31:0] SOC_CTRL_INSTR_BUF_HITS_RESVAL = 32'h0;
+  parameter logic [31:0] SOC_CTRL_INSTR_BUF_MISSES_RESVAL = 32'h0;
 
   // Register index
   typedef enum int {
@@ -79,11 +138,22 @@ package soc_ctrl_reg_pkg;
     SOC_CTRL_BOOT_ADDRESS,
     SOC_CTRL_USE_SPIMEMIO,
     SOC_CTRL_ENABLE_SPI_SEL,
-    SOC_CTRL_SYSTEM_FREQUENCY_HZ
+    SOC_CTRL_SYSTEM_FREQUENCY_HZ,
+    SOC_CTRL_FLASH_CACHE_HITS,
+    SOC_CTRL_FLASH_CACHE_MISSES,
+    SOC_CTRL_BUS_QOS_CTRL,
+    SOC_CTRL_BUS_QOS_PRIORITY,
+    SOC_CTRL_BUS_QOS_BUDGET,
+    SOC_CTRL_SCRATCH,
+    SOC_CTRL_PERF_CTRL,
+    SOC_CTRL_PERF_VALUE,
+    SOC_CTRL_INSTR_BUF_CTRL,
+    SOC_CTRL_INSTR_BUF_HITS,
+    SOC_CTRL_INSTR_BUF_MISSES
   } soc_ctrl_id_e;
 
   // Register width information to check illegal writes
-  parameter logic [3:0] SOC_CTRL_PERMIT[8] = '{
+  parameter logic [3:0] SOC_CTRL_PERMIT[19] = '{
       4'b0001,  // index[0] SOC_CTRL_EXIT_VALID
       4'b1111,  // index[1] SOC_CTRL_EXIT_VALUE
       4'b0001,  // index[2] SOC_CTRL_BOOT_SELECT
@@ -91,7 +161,18 @@ package soc_ctrl_reg_pkg;
       4'b1111,  // index[4] SOC_CTRL_BOOT_ADDRESS
       4'b0001,  // index[5] SOC_CTRL_USE_SPIMEMIO
       4'b0001,  // index[6] SOC_CTRL_ENABLE_SPI_SEL
-      4'b1111  // index[7] SOC_CTRL_SYSTEM_FREQUENCY_HZ
+      4'b1111,  // index[7] SOC_CTRL_SYSTEM_FREQUENCY_HZ
+      4'b1111,  // index[8] SOC_CTRL_FLASH_CACHE_HITS
+      4'b1111,  // index[9] SOC_CTRL_FLASH_CACHE_MISSES
+      4'b1101,  // index[10] SOC_CTRL_BUS_QOS_CTRL
+      4'b1111,  // index[11] SOC_CTRL_BUS_QOS_PRIORITY
+      4'b1111,  // index[12] SOC_CTRL_BUS_QOS_BUDGET
+      4'b1111,  // index[13] SOC_CTRL_SCRATCH
+      4'b0011,  // index[14] SOC_CTRL_PERF_CTRL
+      4'b1111,  // index[15] SOC_CTRL_PERF_VALUE
+      4'b0001,  // index[16] SOC_CTRL_INSTR_BUF_CTRL
+      4'b1111,  // index[17] SOC_CTRL_INSTR_BUF_HITS
+      4'b1111  // index[18] SOC_CTRL_INSTR_BUF_MISSES
   };
 
 endpackage
@@ -10,7 +10,7 @@
 module soc_ctrl_reg_top #(
     parameter type reg_req_t = logic,
     parameter type reg_rsp_t = logic,
-    parameter int AW = 5
+    parameter int AW = 7
 ) (
     input logic clk_i,
     input logic rst_ni,
@@ -90,6 +90,49 @@ module soc_ctrl_reg_top #(
   logic [31:0] system_frequency_hz_qs;
   logic [31:0] system_frequency_hz_wd;
   logic system_frequency_hz_we;
+  logic [31:0] flash_cache_hits_qs;
+  logic flash_cache_hits_re;
+  logic [31:0] flash_cache_misses_qs;
+  logic flash_cache_misses_re;
+  logic bus_qos_ctrl_override_qs;
+  logic bus_qos_ctrl_override_wd;
+  logic bus_qos_ctrl_override_we;
+  logic [15:0] bus_qos_ctrl_window_qs;
+  logic [15:0] bus_qos_ctrl_window_wd;
+  logic bus_qos_ctrl_window_we;
+  logic [31:0] bus_qos_priority_qs;
+  logic [31:0] bus_qos_priority_wd;
+  logic bus_qos_priority_we;
+  logic [31:0] bus_qos_budget_qs;
+  logic [31:0] bus_qos_budget_wd;
+  logic bus_qos_budget_we;
+  logic [31:0] scratch_qs;
+  logic [31:0] scratch_wd;
+  logic scratch_we;
+  logic perf_ctrl_freeze_qs;
+  logic perf_ctrl_freeze_wd;
+  logic perf_ctrl_freeze_we;
+  logic perf_ctrl_clear_qs;
+  logic perf_ctrl_clear_wd;
+  logic perf_ctrl_clear_we;
+  logic [7:0] perf_ctrl_sel_qs;
+  logic [7:0] perf_ctrl_sel_wd;
+  logic perf_ctrl_sel_we;
+  logic [31:0] perf_value_qs;
+  logic perf_value_re;
+  logic instr_buf_ctrl_enable_qs;
+  logic instr_buf_ctrl_enable_wd;
+  logic instr_buf_ctrl_enable_we;
+  logic instr_buf_ctrl_prefetch_qs;
+  logic instr_buf_ctrl_prefetch_wd;
+  logic instr_buf_ctrl_prefetch_we;
+  logic instr_buf_ctrl_clear_qs;
+  logic instr_buf_ctrl_clear_wd;
+  logic instr_buf_ctrl_clear_we;
+  logic [31:0] instr_buf_hits_qs;
+  logic instr_buf_hits_re;
+  logic [31:0] instr_buf_misses_qs;
+  logic instr_buf_misses_re;
 
   // Register instances
   // R[exit_valid]: V(False)
@@ -307,9 +350,383 @@ module soc_ctrl_reg_top #(
   );
 
 
+  // R[flash_cache_hits]: V(True)
 
+  prim_subreg_ext #(
+      .DW(32)
+  ) u_flash_cache_hits (
+      .re (flash_cache_hits_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.flash_cache_hits.d),
+      .qre(),
+      .qe (),
+      .q  (),
+      .qs (flash_cache_hits_qs)
+  );
+
+
+  // R[flash_cache_misses]: V(True)
+
+  prim_subreg_ext #(
+      .DW(32)
+  ) u_flash_cache_misses (
+      .re (flash_cache_misses_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.flash_cache_misses.d),
+      .qre(),
+      .qe (),
+      .q  (),
+      .qs (flash_cache_misses_qs)
+  );
+
+
+  // R[bus_qos_ctrl]: V(False)
+
+  //   F[override]: 0
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_bus_qos_ctrl_override (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(bus_qos_ctrl_override_we),
+      .wd(bus_qos_ctrl_override_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.bus_qos_ctrl.override.q),
+
+      // to register interface (read)
+      .qs(bus_qos_ctrl_override_qs)
+  );
+
+
+  //   F[window]: 31:16
+  prim_subreg #(
+      .DW      (16),
+      .SWACCESS("RW"),
+      .RESVAL  (16'h0)
+  ) u_bus_qos_ctrl_window (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(bus_qos_ctrl_window_we),
+      .wd(bus_qos_ctrl_window_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.bus_qos_ctrl.window.q),
+
+      // to register interface (read)
+      .qs(bus_qos_ctrl_window_qs)
+  );
+
+
+  // R[bus_qos_priority]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_bus_qos_priority (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(bus_qos_priority_we),
+      .wd(bus_qos_priority_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.bus_qos_priority.q),
+
+      // to register interface (read)
+      .qs(bus_qos_priority_qs)
+  );
+
+
+  // R[bus_qos_budget]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_bus_qos_budget (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(bus_qos_budget_we),
+      .wd(bus_qos_budget_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.bus_qos_budget.q),
+
+      // to register interface (read)
+      .qs(bus_qos_budget_qs)
+  );
+
+
+  // R[scratch]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_scratch (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(scratch_we),
+      .wd(scratch_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (),
+
+      // to register interface (read)
+      .qs(scratch_qs)
+  );
+
+
+  // R[perf_ctrl]: V(False)
+
+  //   F[freeze]: 0
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_perf_ctrl_freeze (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(perf_ctrl_freeze_we),
+      .wd(perf_ctrl_freeze_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.perf_ctrl.freeze.q),
+
+      // to register interface (read)
+      .qs(perf_ctrl_freeze_qs)
+  );
+
+
+  //   F[clear]: 1
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_perf_ctrl_clear (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(perf_ctrl_clear_we),
+      .wd(perf_ctrl_clear_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.perf_ctrl.clear.q),
+
+      // to register interface (read)
+      .qs(perf_ctrl_clear_qs)
+  );
+
+
+  //   F[sel]: 15:8
+  prim_subreg #(
+      .DW      (8),
+      .SWACCESS("RW"),
+      .RESVAL  (8'h0)
+  ) u_perf_ctrl_sel (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(perf_ctrl_sel_we),
+      .wd(perf_ctrl_sel_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.perf_ctrl.sel.q),
+
+      // to register interface (read)
+      .qs(perf_ctrl_sel_qs)
+  );
+
+
+  // R[perf_value]: V(True)
+
+  prim_subreg_ext #(
+      .DW(32)
+  ) u_perf_value (
+      .re (perf_value_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.perf_value.d),
+      .qre(),
+      .qe (),
+      .q  (),
+      .qs (perf_value_qs)
+  );
+
+
+  // R[instr_buf_ctrl]: V(False)
+
+  //   F[enable]: 0
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_instr_buf_ctrl_enable (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(instr_buf_ctrl_enable_we),
+      .wd(instr_buf_ctrl_enable_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.instr_buf_ctrl.enable.q),
+
+      // to register interface (read)
+      .qs(instr_buf_ctrl_enable_qs)
+  );
+
+
+  //   F[prefetch]: 1
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_instr_buf_ctrl_prefetch (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(instr_buf_ctrl_prefetch_we),
+      .wd(instr_buf_ctrl_prefetch_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.instr_buf_ctrl.prefetch.q),
+
+      // to register interface (read)
+      .qs(instr_buf_ctrl_prefetch_qs)
+  );
+
+
+  //   F[clear]: 2
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_instr_buf_ctrl_clear (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(instr_buf_ctrl_clear_we),
+      .wd(instr_buf_ctrl_clear_wd),
 
-  logic [7:0] addr_hit;
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(),
+      .q (reg2hw.instr_buf_ctrl.clear.q),
+
+      // to register interface (read)
+      .qs(instr_buf_ctrl_clear_qs)
+  );
+
+
+  // R[instr_buf_hits]: V(True)
+
+  prim_subreg_ext #(
+      .DW(32)
+  ) u_instr_buf_hits (
+      .re (instr_buf_hits_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.instr_buf_hits.d),
+      .qre(),
+      .qe (),
+      .q  (),
+      .qs (instr_buf_hits_qs)
+  );
+
+
+  // R[instr_buf_misses]: V(True)
+
+  prim_subreg_ext #(
+      .DW(32)
+  ) u_instr_buf_misses (
+      .re (instr_buf_misses_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.instr_buf_misses.d),
+      .qre(),
+      .qe (),
+      .q  (),
+      .qs (instr_buf_misses_qs)
+  );
+
+
+
+  logic [18:0] addr_hit;
   always_comb begin
     addr_hit = '0;
     addr_hit[0] = (reg_addr == SOC_CTRL_EXIT_VALID_OFFSET);
@@ -320,6 +737,17 @@ module soc_ctrl_reg_top #(
     addr_hit[5] = (reg_addr == SOC_CTRL_USE_SPIMEMIO_OFFSET);
     addr_hit[6] = (reg_addr == SOC_CTRL_ENABLE_SPI_SEL_OFFSET);
     addr_hit[7] = (reg_addr == SOC_CTRL_SYSTEM_FREQUENCY_HZ_OFFSET);
+    addr_hit[8] = (reg_addr == SOC_CTRL_FLASH_CACHE_HITS_OFFSET);
+    addr_hit[9] = (reg_addr == SOC_CTRL_FLASH_CACHE_MISSES_OFFSET);
+    addr_hit[10] = (reg_addr == SOC_CTRL_BUS_QOS_CTRL_OFFSET);
+    addr_hit[11] = (reg_addr == SOC_CTRL_BUS_QOS_PRIORITY_OFFSET);
+    addr_hit[12] = (reg_addr == SOC_CTRL_BUS_QOS_BUDGET_OFFSET);
+    addr_hit[13] = (reg_addr == SOC_CTRL_SCRATCH_OFFSET);
+    addr_hit[14] = (reg_addr == SOC_CTRL_PERF_CTRL_OFFSET);
+    addr_hit[15] = (reg_addr == SOC_CTRL_PERF_VALUE_OFFSET);
+    addr_hit[16] = (reg_addr == SOC_CTRL_INSTR_BUF_CTRL_OFFSET);
+    addr_hit[17] = (reg_addr == SOC_CTRL_INSTR_BUF_HITS_OFFSET);
+    addr_hit[18] = (reg_addr == SOC_CTRL_INSTR_BUF_MISSES_OFFSET);
   end
 
   assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0;
@@ -334,7 +762,18 @@ module soc_ctrl_reg_top #(
                (addr_hit[4] & (|(SOC_CTRL_PERMIT[4] & ~reg_be))) |
                (addr_hit[5] & (|(SOC_CTRL_PERMIT[5] & ~reg_be))) |
                (addr_hit[6] & (|(SOC_CTRL_PERMIT[6] & ~reg_be))) |
-               (addr_hit[7] & (|(SOC_CTRL_PERMIT[7] & ~reg_be)))));
+               (addr_hit[7] & (|(SOC_CTRL_PERMIT[7] & ~reg_be))) |
+               (addr_hit[8] & (|(SOC_CTRL_PERMIT[8] & ~reg_be))) |
+               (addr_hit[9] & (|(SOC_CTRL_PERMIT[9] & ~reg_be))) |
+               (addr_hit[10] & (|(SOC_CTRL_PERMIT[10] & ~reg_be))) |
+               (addr_hit[11] & (|(SOC_CTRL_PERMIT[11] & ~reg_be))) |
+               (addr_hit[12] & (|(SOC_CTRL_PERMIT[12] & ~reg_be))) |
+               (addr_hit[13] & (|(SOC_CTRL_PERMIT[13] & ~reg_be))) |
+               (addr_hit[14] & (|(SOC_CTRL_PERMIT[14] & ~reg_be))) |
+               (addr_hit[15] & (|(SOC_CTRL_PERMIT[15] & ~reg_be))) |
+               (addr_hit[16] & (|(SOC_CTRL_PERMIT[16] & ~reg_be))) |
+               (addr_hit[17] & (|(SOC_CTRL_PERMIT[17] & ~reg_be))) |
+               (addr_hit[18] & (|(SOC_CTRL_PERMIT[18] & ~reg_be)))));
   end
 
   assign exit_valid_we = addr_hit[0] & reg_we & !reg_error;
@@ -358,6 +797,49 @@ module soc_ctrl_reg_top #(
   assign system_frequency_hz_we = addr_hit[7] & reg_we & !reg_error;
   assign system_frequency_hz_wd = reg_wdata[31:0];
 
+  assign flash_cache_hits_re = addr_hit[8] & reg_re & !reg_error;
+
+  assign flash_cache_misses_re = addr_hit[9] & reg_re & !reg_error;
+
+  assign bus_qos_ctrl_override_we = addr_hit[10] & reg_we & !reg_error;
+  assign bus_qos_ctrl_override_wd = reg_wdata[0];
+
+  assign bus_qos_ctrl_window_we = addr_hit[10] & reg_we & !reg_error;
+  assign bus_qos_ctrl_window_wd = reg_wdata[31:16];
+
+  assign bus_qos_priority_we = addr_hit[11] & reg_we & !reg_error;
+  assign bus_qos_priority_wd = reg_wdata[31:0];
+
+  assign bus_qos_budget_we = addr_hit[12] & reg_we & !reg_error;
+  assign bus_qos_budget_wd = reg_wdata[31:0];
+
+  assign scratch_we = addr_hit[13] & reg_we & !reg_error;
+  assign scratch_wd = reg_wdata[31:0];
+
+  assign perf_ctrl_freeze_we = addr_hit[14] & reg_we & !reg_error;
+  assign perf_ctrl_freeze_wd = reg_wdata[0];
+
+  assign perf_ctrl_clear_we = addr_hit[14] & reg_we & !reg_error;
+  assign perf_ctrl_clear_wd = reg_wdata[1];
+
+  assign perf_ctrl_sel_we = addr_hit[14] & reg_we & !reg_error;
+  assign perf_ctrl_sel_wd = reg_wdata[15:8];
+
+  assign perf_value_re = addr_hit[15] & reg_re & !reg_error;
+
+  assign instr_buf_ctrl_enable_we = addr_hit[16] & reg_we & !reg_error;
+  assign instr_buf_ctrl_enable_wd = reg_wdata[0];
+
+  assign instr_buf_ctrl_prefetch_we = addr_hit[16] & reg_we & !reg_error;
+  assign instr_buf_ctrl_prefetch_wd = reg_wdata[1];
+
+  assign instr_buf_ctrl_clear_we = addr_hit[16] & reg_we & !reg_error;
+  assign instr_buf_ctrl_clear_wd = reg_wdata[2];
+
+  assign instr_buf_hits_re = addr_hit[17] & reg_re & !reg_error;
+
+  assign instr_buf_misses_re = addr_hit[18] & reg_re & !reg_error;
+
   // Read data return
   always_comb begin
     reg_rdata_next = '0;
@@ -394,6 +876,55 @@ module soc_ctrl_reg_top #(
         reg_rdata_next[31:0] = system_frequency_hz_qs;
       end
 
+      addr_hit[8]: begin
+        reg_rdata_next[31:0] = flash_cache_hits_qs;
+      end
+
+      addr_hit[9]: begin
+        reg_rdata_next[31:0] = flash_cache_misses_qs;
+      end
+
+      addr_hit[10]: begin
+        reg_rdata_next[0] = bus_qos_ctrl_override_qs;
+        reg_rdata_next[31:16] = bus_qos_ctrl_window_qs;
+      end
+
+      addr_hit[11]: begin
+        reg_rdata_next[31:0] = bus_qos_priority_qs;
+      end
+
+      addr_hit[12]: begin
+        reg_rdata_next[31:0] = bus_qos_budget_qs;
+      end
+
+      addr_hit[13]: begin
+        reg_rdata_next[31:0] = scratch_qs;
+      end
+
+      addr_hit[14]: begin
+        reg_rdata_next[0] = perf_ctrl_freeze_qs;
+        reg_rdata_next[1] = perf_ctrl_clear_qs;
+        reg_rdata_next[15:8] = perf_ctrl_sel_qs;
+      end
+
+      addr_hit[15]: begin
+        reg_rdata_next[31:0] = perf_value_qs;
+      end
+
+      addr_hit[16]: begin
+        reg_rdata_next[0] = instr_buf_ctrl_enable_qs;
+        reg_rdata_next[1] = instr_buf_ctrl_prefetch_qs;
+        reg_rdata_next[2] = instr_buf_ctrl_clear_qs;
+      end
+
+      addr_hit[17]: begin
+        reg_rdata_next[31:0] = instr_buf_hits_qs;
+      end
+
+      addr_hit[18]: begin
+        reg_rdata_next[31:0] = instr_buf_misses_qs;
+      end
+
       default: begin
         reg_rdata_next = '1;
       end
@@ -415,7 +946,7 @@ module soc_ctrl_reg_top #(
 endmodule
 
 module soc_ctrl_reg_top_intf #(
-    parameter  int AW = 5,
+    parameter  int AW = 7,
     localparam int DW = 32
 ) (
     input logic clk_i,
@@ -0,0 +1,309 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Streaming FIR and FFT accelerator for the audio path, fed and drained by
+// the DMA through two trigger slots. The input words (e.g. the PCM samples of
+// the PDM2PCM) are shifted left by IN_SHIFT and their upper 16 bits taken as a
+// Q15 sample, optionally filtered by a FIR of up to TAPS_MAX coefficients, one
+// multiply-accumulate per cycle, then either output one by one or gathered in
+// frames of 2^LOG2N samples for an in-place radix-2 FFT, one butterfly per
+// cycle. The results match dsp_fir_q15() and dsp_fft_radix2_q15() of the DSP
+// SDK: the FIR rounds and saturates its sum, the FFT halves every stage.
+// The twiddle factors are loaded by software from dsp_fft_q15_twiddles(), the
+// first 2^(LOG2N-1) of them.
+// A frame is not accepted while the previous one is transformed and drained,
+// the input FIFO and the one of the source hold the samples meanwhile.
+
+module fft_fir #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter int unsigned LOG2N_MAX = 8,
+    parameter int unsigned TAPS_MAX = 32,
+    localparam int unsigned N_MAX = 2 ** LOG2N_MAX,
+    localparam int unsigned IN_DEPTH = 4,
+    localparam int unsigned IN_DEPTHw = $clog2(IN_DEPTH + 1)
+) (
+    input logic clk_i,
+    input logic rst_ni,
+    input reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    // DMA slots
+    output logic fft_fir_in_ready_o,
+    output logic fft_fir_out_valid_o
+);
+
+  import fft_fir_reg_pkg::*;
+
+  fft_fir_reg2hw_t reg2hw;
+  fft_fir_hw2reg_t hw2reg;
+
+  logic clear;
+
+  logic [31:0] in_word;
+  logic [IN_DEPTHw-1:0] in_usage;
+  logic in_valid, in_pop;
+  logic signed [15:0] in_sample;
+  logic [31:0] in_shifted;
+
+  // FIR stage
+  logic signed [15:0] coef_q[TAPS_MAX];
+  logic signed [15:0] hist_q[TAPS_MAX];
+  logic [$clog2(TAPS_MAX+1)-1:0] coef_idx_q, tap_q;
+  logic signed [39:0] acc_q;
+  logic signed [39:0] acc_round;
+  logic fir_busy_q;
+  logic signed [15:0] fir_out;
+  logic fir_valid;
+
+  // Sample at the output of the FIR stage
+  logic signed [15:0] sample;
+  logic sample_valid, sample_ready;
+
+  // FFT stage
+  enum logic [1:0] {
+    FFT_COLLECT,
+    FFT_COMPUTE,
+    FFT_DRAIN
+  }
+      fft_state_q;
+
+  logic [31:0] mem_q[N_MAX];
+  logic [31:0] tw_q[N_MAX/2];
+  logic [LOG2N_MAX-1:0] tw_idx_q;
+  logic [LOG2N_MAX:0] cnt_q;  // Samples collected, butterflies of the stage or bins drained
+  logic [$clog2(LOG2N_MAX)-1:0] stage_q;
+  logic [LOG2N_MAX:0] n, out_n;
+  logic [LOG2N_MAX-1:0] rev_idx;
+
+  logic [LOG2N_MAX-1:0] bf_j, bf_i, bf_i2, bf_tw;
+  logic signed [15:0] u_re, u_im, v_re, v_im, w_re, w_im;
+  logic signed [31:0] t_re, t_im;
+  logic signed [15:0] y0_re, y0_im, y1_re, y1_im;
+
+  // Output of the samples without FFT
+  logic signed [15:0] out_q;
+  logic out_full_q;
+
+  assign clear = reg2hw.ctrl.fir_en.qe;
+
+  /////////////////
+  // Input stage //
+  /////////////////
+
+  prim_fifo_sync #(
+      .Width(32),
+      .Depth(IN_DEPTH),
+      .Pass(1'b0),
+      .OutputZeroIfEmpty(1'b0)
+  ) in_fifo_i (
+      .clk_i,
+      .rst_ni,
+      .clr_i(clear),
+
+      // From the DMA
+      .wvalid_i(reg2hw.data_in.qe),
+      .wready_o(),
+      .wdata_i (reg2hw.data_in.q),
+
+      .rvalid_o(in_valid),
+      .rready_i(in_pop),
+      .rdata_o (in_word),
+
+      .full_o (),
+      .depth_o(in_usage)
+  );
+
+  // The DMA can issue one more write before it sees the slot fall, so the
+  // slot requires room for two samples
+  assign fft_fir_in_ready_o = in_usage < IN_DEPTHw'(IN_DEPTH - 1);
+
+  assign in_shifted = in_word << reg2hw.ctrl.in_shift.q;
+  assign in_sample = in_shifted[31:16];
+
+  ///////////////
+  // FIR stage //
+  ///////////////
+
+  // A sample enters the history, then the taps are accumulated one per cycle
+  assign in_pop = in_valid && (reg2hw.ctrl.fir_en.q ? !fir_busy_q && !fir_valid : sample_ready);
+
+  assign acc_round = (acc_q + 40'sd16384) >>> 15;
+  assign fir_out = acc_round > 40'sd32767 ? 16'sh7fff : acc_round < -40'sd32768 ? 16'sh8000 : acc_round[15:0];
+  assign fir_valid = fir_busy_q && tap_q == reg2hw.ctrl.taps.q;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : proc_fir
+    if (~rst_ni) begin
+      coef_idx_q <= '0;
+      tap_q <= '0;
+      acc_q <= '0;
+      fir_busy_q <= 1'b0;
+      for (int k = 0; k < TAPS_MAX; k++) begin
+        coef_q[k] <= '0;
+        hist_q[k] <= '0;
+      end
+    end else if (clear) begin
+      coef_idx_q <= '0;
+      fir_busy_q <= 1'b0;
+      for (int k = 0; k < TAPS_MAX; k++) hist_q[k] <= '0;
+    end else begin
+      if (reg2hw.coef.qe && coef_idx_q < TAPS_MAX) begin
+        coef_q[coef_idx_q] <= reg2hw.coef.q;
+        coef_idx_q <= coef_idx_q + 1;
+      end
+
+      if (reg2hw.ctrl.fir_en.q && in_pop) begin
+        hist_q[0] <= in_sample;
+        for (int k = 1; k < TAPS_MAX; k++) hist_q[k] <= hist_q[k-1];
+        tap_q <= '0;
+        acc_q <= '0;
+        fir_busy_q <= 1'b1;
+      end else if (fir_busy_q && !fir_valid) begin
+        acc_q <= acc_q + 40'(coef_q[tap_q] * hist_q[tap_q]);
+        tap_q <= tap_q + 1;
+      end else if (fir_valid && sample_ready) begin
+        fir_busy_q <= 1'b0;
+      end
+    end
+  end
+
+  assign sample = reg2hw.ctrl.fir_en.q ? fir_out : in_sample;
+  assign sample_valid = reg2hw.ctrl.fir_en.q ? fir_valid : in_valid;
+  assign sample_ready = reg2hw.ctrl.fft_en.q ? fft_state_q == FFT_COLLECT : !out_full_q;
+
+  ///////////////
+  // FFT stage //
+  ///////////////
+
+  assign n = (LOG2N_MAX + 1)'(1) << reg2hw.ctrl.log2n.q;
+  assign out_n = reg2hw.ctrl.half.q ? (n >> 1) + 1 : n;
+
+  // The samples are stored in bit-reversed order, for the output in natural order
+  always_comb begin
+    for (int b = 0; b < LOG2N_MAX; b++) rev_idx[b] = cnt_q[LOG2N_MAX-1-b];
+    rev_idx = rev_idx >> (LOG2N_MAX - reg2hw.ctrl.log2n.q);
+  end
+
+  // Butterfly cnt_q of the stage: groups of 2^(stage+1) points, twiddle j * n / 2^(stage+1)
+  always_comb begin
+    bf_j = cnt_q[LOG2N_MAX-1:0] & ((LOG2N_MAX'(1) << stage_q) - 1);
+    bf_i = ((cnt_q[LOG2N_MAX-1:0] >> stage_q) << (stage_q + 1)) | bf_j;
+    bf_i2 = bf_i | (LOG2N_MAX'(1) << stage_q);
+    bf_tw = bf_j << (reg2hw.ctrl.log2n.q - 1 - stage_q);
+  end
+
+  assign u_re = mem_q[bf_i][15:0];
+  assign u_im = mem_q[bf_i][31:16];
+  assign v_re = $signed(mem_q[bf_i2][15:0]) >>> 1;
+  assign v_im = $signed(mem_q[bf_i2][31:16]) >>> 1;
+  assign w_re = tw_q[bf_tw][15:0];
+  assign w_im = tw_q[bf_tw][31:16];
+
+  assign t_re = (v_re * w_re - v_im * w_im) >>> 15;
+  assign t_im = (v_re * w_im + v_im * w_re) >>> 15;
+  assign y0_re = (u_re >>> 1) + t_re[15:0];
+  assign y0_im = (u_im >>> 1) + t_im[15:0];
+  assign y1_re = (u_re >>> 1) - t_re[15:0];
+  assign y1_im = (u_im >>> 1) - t_im[15:0];
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : proc_fft
+    if (~rst_ni) begin
+      fft_state_q <= FFT_COLLECT;
+      cnt_q <= '0;
+      stage_q <= '0;
+      tw_idx_q <= '0;
+    end else if (clear) begin
+      fft_state_q <= FFT_COLLECT;
+      cnt_q <= '0;
+      stage_q <= '0;
+      tw_idx_q <= '0;
+    end else begin
+      if (reg2hw.twiddle.qe) begin
+        tw_q[tw_idx_q] <= reg2hw.twiddle.q;
+        tw_idx_q <= tw_idx_q + 1;
+      end
+
+      unique case (fft_state_q)
+        FFT_COLLECT: begin
+          if (reg2hw.ctrl.fft_en.q && sample_valid) begin
+            mem_q[rev_idx] <= {16'h0, sample};
+            if (cnt_q == n - 1) begin
+              cnt_q <= '0;
+              stage_q <= '0;
+              fft_state_q <= FFT_COMPUTE;
+            end else begin
+              cnt_q <= cnt_q + 1;
+            end
+          end
+        end
+        FFT_COMPUTE: begin
+          mem_q[bf_i]  <= {y0_im, y0_re};
+          mem_q[bf_i2] <= {y1_im, y1_re};
+          if (cnt_q == (n >> 1) - 1) begin
+            cnt_q <= '0;
+            if (stage_q == reg2hw.ctrl.log2n.q - 1) fft_state_q <= FFT_DRAIN;
+            else stage_q <= stage_q + 1;
+          end else begin
+            cnt_q <= cnt_q + 1;
+          end
+        end
+        FFT_DRAIN: begin
+          if (reg2hw.data_out.re) begin
+            if (cnt_q == out_n - 1) begin
+              cnt_q <= '0;
+              fft_state_q <= FFT_COLLECT;
+            end else begin
+              cnt_q <= cnt_q + 1;
+            end
+          end
+        end
+        default: fft_state_q <= FFT_COLLECT;
+      endcase
+    end
+  end
+
+  //////////////////
+  // Output stage //
+  //////////////////
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : proc_out
+    if (~rst_ni) begin
+      out_q <= '0;
+      out_full_q <= 1'b0;
+    end else if (clear) begin
+      out_full_q <= 1'b0;
+    end else if (!reg2hw.ctrl.fft_en.q) begin
+      if (sample_valid && sample_ready) begin
+        out_q <= sample;
+        out_full_q <= 1'b1;
+      end else if (reg2hw.data_out.re) begin
+        out_full_q <= 1'b0;
+      end
+    end
+  end
+
+  assign fft_fir_out_valid_o = reg2hw.ctrl.fft_en.q ? fft_state_q == FFT_DRAIN : out_full_q;
+  assign hw2reg.data_out.d = reg2hw.ctrl.fft_en.q ? mem_q[cnt_q[LOG2N_MAX-1:0]] : {{16{out_q[15]}}, out_q};
+
+  assign hw2reg.status.in_ready.de = 1'b1;
+  assign hw2reg.status.in_ready.d = fft_fir_in_ready_o;
+  assign hw2reg.status.out_valid.de = 1'b1;
+  assign hw2reg.status.out_valid.d = fft_fir_out_valid_o;
+  assign hw2reg.status.busy.de = 1'b1;
+  assign hw2reg.status.busy.d = fft_state_q == FFT_COMPUTE;
+
+  fft_fir_reg_top #(
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t)
+  ) fft_fir_reg_top_i (
+      .clk_i,
+      .rst_ni,
+      .reg2hw,
+      .hw2reg,
+      .reg_req_i,
+      .reg_rsp_o,
+      .devmode_i(1'b0)
+  );
+
+endmodule : fft_fir
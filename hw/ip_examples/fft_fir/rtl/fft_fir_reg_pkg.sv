@@ -0,0 +1,126 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Register Package auto-generated by `reggen` containing data structure
+
+package fft_fir_reg_pkg;
+
+  // Address widths within the block
+  parameter int BlockAw = 5;
+
+  ////////////////////////////
+  // Typedefs for registers //
+  ////////////////////////////
+
+  typedef struct packed {
+    logic [31:0] q;
+    logic        qe;
+  } fft_fir_reg2hw_data_in_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+    logic        re;
+  } fft_fir_reg2hw_data_out_reg_t;
+
+  typedef struct packed {
+    struct packed {
+      logic q;
+      logic qe;
+    } fir_en;
+    struct packed {
+      logic q;
+      logic qe;
+    } fft_en;
+    struct packed {
+      logic q;
+      logic qe;
+    } half;
+    struct packed {
+      logic [3:0] q;
+      logic       qe;
+    } log2n;
+    struct packed {
+      logic [4:0] q;
+      logic       qe;
+    } in_shift;
+    struct packed {
+      logic [5:0] q;
+      logic       qe;
+    } taps;
+  } fft_fir_reg2hw_ctrl_reg_t;
+
+  typedef struct packed {
+    logic [15:0] q;
+    logic        qe;
+  } fft_fir_reg2hw_coef_reg_t;
+
+  typedef struct packed {
+    logic [31:0] q;
+    logic        qe;
+  } fft_fir_reg2hw_twiddle_reg_t;
+
+  typedef struct packed {logic [31:0] d;} fft_fir_hw2reg_data_out_reg_t;
+
+  typedef struct packed {
+    struct packed {
+      logic d;
+      logic de;
+    } in_ready;
+    struct packed {
+      logic d;
+      logic de;
+    } out_valid;
+    struct packed {
+      logic d;
+      logic de;
+    } busy;
+  } fft_fir_hw2reg_status_reg_t;
+
+  // Register -> HW type
+  typedef struct packed {
+    fft_fir_reg2hw_data_in_reg_t data_in;  // [139:107]
+    fft_fir_reg2hw_data_out_reg_t data_out;  // [106:74]
+    fft_fir_reg2hw_ctrl_reg_t ctrl;  // [73:50]
+    fft_fir_reg2hw_coef_reg_t coef;  // [49:33]
+    fft_fir_reg2hw_twiddle_reg_t twiddle;  // [32:0]
+  } fft_fir_reg2hw_t;
+
+  // HW -> register type
+  typedef struct packed {
+    fft_fir_hw2reg_data_out_reg_t data_out;  // [37:6]
+    fft_fir_hw2reg_status_reg_t status;  // [5:0]
+  } fft_fir_hw2reg_t;
+
+  // Register offsets
+  parameter logic [BlockAw-1:0] FFT_FIR_DATA_IN_OFFSET = 5'h0;
+  parameter logic [BlockAw-1:0] FFT_FIR_DATA_OUT_OFFSET = 5'h4;
+  parameter logic [BlockAw-1:0] FFT_FIR_CTRL_OFFSET = 5'h8;
+  parameter logic [BlockAw-1:0] FFT_FIR_COEF_OFFSET = 5'hc;
+  parameter logic [BlockAw-1:0] FFT_FIR_TWIDDLE_OFFSET = 5'h10;
+  parameter logic [BlockAw-1:0] FFT_FIR_STATUS_OFFSET = 5'h14;
+
+  // Reset values for hwext registers and their fields
+  parameter logic [31:0] FFT_FIR_DATA_OUT_RESVAL = 32'h0;
+
+  // Register index
+  typedef enum int {
+    FFT_FIR_DATA_IN,
+    FFT_FIR_DATA_OUT,
+    FFT_FIR_CTRL,
+    FFT_FIR_COEF,
+    FFT_FIR_TWIDDLE,
+    FFT_FIR_STATUS
+  } fft_fir_id_e;
+
+  // Register width information to check illegal writes
+  parameter logic [3:0] FFT_FIR_PERMIT[6] = '{
+      4'b1111,  // index[0] FFT_FIR_DATA_IN
+      4'b1111,  // index[1] FFT_FIR_DATA_OUT
+      4'b0111,  // index[2] FFT_FIR_CTRL
+      4'b0011,  // index[3] FFT_FIR_COEF
+      4'b1111,  // index[4] FFT_FIR_TWIDDLE
+      4'b0001  // index[5] FFT_FIR_STATUS
+  };
+
+endpackage
@@ -0,0 +1,596 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Register Top module auto-generated by `reggen`
+
+
+`include "common_cells/assertions.svh"
+
+module fft_fir_reg_top #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter int AW = 5
+) (
+    input logic clk_i,
+    input logic rst_ni,
+    input reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+    // To HW
+    output fft_fir_reg_pkg::fft_fir_reg2hw_t reg2hw,  // Write
+    input fft_fir_reg_pkg::fft_fir_hw2reg_t hw2reg,  // Read
+
+
+    // Config
+    input devmode_i  // If 1, explicit error return for unmapped register access
+);
+
+  import fft_fir_reg_pkg::*;
+
+  localparam int DW = 32;
+  localparam int DBW = DW / 8;  // Byte Width
+
+  // register signals
+  logic           reg_we;
+  logic           reg_re;
+  logic [ AW-1:0] reg_addr;
+  logic [ DW-1:0] reg_wdata;
+  logic [DBW-1:0] reg_be;
+  logic [ DW-1:0] reg_rdata;
+  logic           reg_error;
+
+  logic addrmiss, wr_err;
+
+  logic [DW-1:0] reg_rdata_next;
+
+  // Below register interface can be changed
+  reg_req_t reg_intf_req;
+  reg_rsp_t reg_intf_rsp;
+
+
+  assign reg_intf_req = reg_req_i;
+  assign reg_rsp_o = reg_intf_rsp;
+
+
+  assign reg_we = reg_intf_req.valid & reg_intf_req.write;
+  assign reg_re = reg_intf_req.valid & ~reg_intf_req.write;
+  assign reg_addr = reg_intf_req.addr;
+  assign reg_wdata = reg_intf_req.wdata;
+  assign reg_be = reg_intf_req.wstrb;
+  assign reg_intf_rsp.rdata = reg_rdata;
+  assign reg_intf_rsp.error = reg_error;
+  assign reg_intf_rsp.ready = 1'b1;
+
+  assign reg_rdata = reg_rdata_next;
+  assign reg_error = (devmode_i & addrmiss) | wr_err;
+
+
+  // Define SW related signals
+  // Format: <reg>_<field>_{wd|we|qs}
+  //        or <reg>_{wd|we|qs} if field == 1 or 0
+  logic [31:0] data_in_qs;
+  logic [31:0] data_in_wd;
+  logic data_in_we;
+  logic [31:0] data_out_qs;
+  logic data_out_re;
+  logic ctrl_fir_en_qs;
+  logic ctrl_fir_en_wd;
+  logic ctrl_fir_en_we;
+  logic ctrl_fft_en_qs;
+  logic ctrl_fft_en_wd;
+  logic ctrl_fft_en_we;
+  logic ctrl_half_qs;
+  logic ctrl_half_wd;
+  logic ctrl_half_we;
+  logic [3:0] ctrl_log2n_qs;
+  logic [3:0] ctrl_log2n_wd;
+  logic ctrl_log2n_we;
+  logic [4:0] ctrl_in_shift_qs;
+  logic [4:0] ctrl_in_shift_wd;
+  logic ctrl_in_shift_we;
+  logic [5:0] ctrl_taps_qs;
+  logic [5:0] ctrl_taps_wd;
+  logic ctrl_taps_we;
+  logic [15:0] coef_qs;
+  logic [15:0] coef_wd;
+  logic coef_we;
+  logic [31:0] twiddle_qs;
+  logic [31:0] twiddle_wd;
+  logic twiddle_we;
+  logic status_in_ready_qs;
+  logic status_out_valid_qs;
+  logic status_busy_qs;
+
+  // Register instances
+  // R[data_in]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_data_in (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(data_in_we),
+      .wd(data_in_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.data_in.qe),
+      .q (reg2hw.data_in.q),
+
+      // to register interface (read)
+      .qs(data_in_qs)
+  );
+
+
+  // R[data_out]: V(True)
+
+  prim_subreg_ext #(
+      .DW(32)
+  ) u_data_out (
+      .re (data_out_re),
+      .we (1'b0),
+      .wd ('0),
+      .d  (hw2reg.data_out.d),
+      .qre(reg2hw.data_out.re),
+      .qe (),
+      .q  (reg2hw.data_out.q),
+      .qs (data_out_qs)
+  );
+
+
+  // R[ctrl]: V(False)
+
+  //   F[fir_en]: 0:0
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_ctrl_fir_en (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ctrl_fir_en_we),
+      .wd(ctrl_fir_en_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.ctrl.fir_en.qe),
+      .q (reg2hw.ctrl.fir_en.q),
+
+      // to register interface (read)
+      .qs(ctrl_fir_en_qs)
+  );
+
+
+  //   F[fft_en]: 1:1
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_ctrl_fft_en (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ctrl_fft_en_we),
+      .wd(ctrl_fft_en_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.ctrl.fft_en.qe),
+      .q (reg2hw.ctrl.fft_en.q),
+
+      // to register interface (read)
+      .qs(ctrl_fft_en_qs)
+  );
+
+
+  //   F[half]: 2:2
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RW"),
+      .RESVAL  (1'h0)
+  ) u_ctrl_half (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ctrl_half_we),
+      .wd(ctrl_half_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.ctrl.half.qe),
+      .q (reg2hw.ctrl.half.q),
+
+      // to register interface (read)
+      .qs(ctrl_half_qs)
+  );
+
+
+  //   F[log2n]: 7:4
+  prim_subreg #(
+      .DW      (4),
+      .SWACCESS("RW"),
+      .RESVAL  (4'h0)
+  ) u_ctrl_log2n (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ctrl_log2n_we),
+      .wd(ctrl_log2n_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.ctrl.log2n.qe),
+      .q (reg2hw.ctrl.log2n.q),
+
+      // to register interface (read)
+      .qs(ctrl_log2n_qs)
+  );
+
+
+  //   F[in_shift]: 12:8
+  prim_subreg #(
+      .DW      (5),
+      .SWACCESS("RW"),
+      .RESVAL  (5'h0)
+  ) u_ctrl_in_shift (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ctrl_in_shift_we),
+      .wd(ctrl_in_shift_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.ctrl.in_shift.qe),
+      .q (reg2hw.ctrl.in_shift.q),
+
+      // to register interface (read)
+      .qs(ctrl_in_shift_qs)
+  );
+
+
+  //   F[taps]: 21:16
+  prim_subreg #(
+      .DW      (6),
+      .SWACCESS("RW"),
+      .RESVAL  (6'h0)
+  ) u_ctrl_taps (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(ctrl_taps_we),
+      .wd(ctrl_taps_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.ctrl.taps.qe),
+      .q (reg2hw.ctrl.taps.q),
+
+      // to register interface (read)
+      .qs(ctrl_taps_qs)
+  );
+
+
+  // R[coef]: V(False)
+
+  prim_subreg #(
+      .DW      (16),
+      .SWACCESS("RW"),
+      .RESVAL  (16'h0)
+  ) u_coef (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(coef_we),
+      .wd(coef_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.coef.qe),
+      .q (reg2hw.coef.q),
+
+      // to register interface (read)
+      .qs(coef_qs)
+  );
+
+
+  // R[twiddle]: V(False)
+
+  prim_subreg #(
+      .DW      (32),
+      .SWACCESS("RW"),
+      .RESVAL  (32'h0)
+  ) u_twiddle (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      // from register interface
+      .we(twiddle_we),
+      .wd(twiddle_wd),
+
+      // from internal hardware
+      .de(1'b0),
+      .d ('0),
+
+      // to internal hardware
+      .qe(reg2hw.twiddle.qe),
+      .q (reg2hw.twiddle.q),
+
+      // to register interface (read)
+      .qs(twiddle_qs)
+  );
+
+
+  // R[status]: V(False)
+
+  //   F[in_ready]: 0:0
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RO"),
+      .RESVAL  (1'h0)
+  ) u_status_in_ready (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      .we(1'b0),
+      .wd('0),
+
+      // from internal hardware
+      .de(hw2reg.status.in_ready.de),
+      .d (hw2reg.status.in_ready.d),
+
+      // to internal hardware
+      .qe(),
+      .q (),
+
+      // to register interface (read)
+      .qs(status_in_ready_qs)
+  );
+
+
+  //   F[out_valid]: 1:1
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RO"),
+      .RESVAL  (1'h0)
+  ) u_status_out_valid (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      .we(1'b0),
+      .wd('0),
+
+      // from internal hardware
+      .de(hw2reg.status.out_valid.de),
+      .d (hw2reg.status.out_valid.d),
+
+      // to internal hardware
+      .qe(),
+      .q (),
+
+      // to register interface (read)
+      .qs(status_out_valid_qs)
+  );
+
+
+  //   F[busy]: 2:2
+  prim_subreg #(
+      .DW      (1),
+      .SWACCESS("RO"),
+      .RESVAL  (1'h0)
+  ) u_status_busy (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      .we(1'b0),
+      .wd('0),
+
+      // from internal hardware
+      .de(hw2reg.status.busy.de),
+      .d (hw2reg.status.busy.d),
+
+      // to internal hardware
+      .qe(),
+      .q (),
+
+      // to register interface (read)
+      .qs(status_busy_qs)
+  );
+
+
+
+
+  logic [5:0] addr_hit;
+  always_comb begin
+    addr_hit = '0;
+    addr_hit[0] = (reg_addr == FFT_FIR_DATA_IN_OFFSET);
+    addr_hit[1] = (reg_addr == FFT_FIR_DATA_OUT_OFFSET);
+    addr_hit[2] = (reg_addr == FFT_FIR_CTRL_OFFSET);
+    addr_hit[3] = (reg_addr == FFT_FIR_COEF_OFFSET);
+    addr_hit[4] = (reg_addr == FFT_FIR_TWIDDLE_OFFSET);
+    addr_hit[5] = (reg_addr == FFT_FIR_STATUS_OFFSET);
+  end
+
+  assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0;
+
+  // Check sub-word write is permitted
+  always_comb begin
+    wr_err = (reg_we &
+              ((addr_hit[0] & (|(FFT_FIR_PERMIT[0] & ~reg_be))) |
+               (addr_hit[1] & (|(FFT_FIR_PERMIT[1] & ~reg_be))) |
+               (addr_hit[2] & (|(FFT_FIR_PERMIT[2] & ~reg_be))) |
+               (addr_hit[3] & (|(FFT_FIR_PERMIT[3] & ~reg_be))) |
+               (addr_hit[4] & (|(FFT_FIR_PERMIT[4] & ~reg_be))) |
+               (addr_hit[5] & (|(FFT_FIR_PERMIT[5] & ~reg_be)))));
+  end
+
+  assign data_in_we = addr_hit[0] & reg_we & !reg_error;
+  assign data_in_wd = reg_wdata[31:0];
+
+  assign data_out_re = addr_hit[1] & reg_re & !reg_error;
+
+  assign ctrl_fir_en_we = addr_hit[2] & reg_we & !reg_error;
+  assign ctrl_fir_en_wd = reg_wdata[0];
+
+  assign ctrl_fft_en_we = addr_hit[2] & reg_we & !reg_error;
+  assign ctrl_fft_en_wd = reg_wdata[1];
+
+  assign ctrl_half_we = addr_hit[2] & reg_we & !reg_error;
+  assign ctrl_half_wd = reg_wdata[2];
+
+  assign ctrl_log2n_we = addr_hit[2] & reg_we & !reg_error;
+  assign ctrl_log2n_wd = reg_wdata[7:4];
+
+  assign ctrl_in_shift_we = addr_hit[2] & reg_we & !reg_error;
+  assign ctrl_in_shift_wd = reg_wdata[12:8];
+
+  assign ctrl_taps_we = addr_hit[2] & reg_we & !reg_error;
+  assign ctrl_taps_wd = reg_wdata[21:16];
+
+  assign coef_we = addr_hit[3] & reg_we & !reg_error;
+  assign coef_wd = reg_wdata[15:0];
+
+  assign twiddle_we = addr_hit[4] & reg_we & !reg_error;
+  assign twiddle_wd = reg_wdata[31:0];
+
+  // Read data return
+  always_comb begin
+    reg_rdata_next = '0;
+    unique case (1'b1)
+      addr_hit[0]: begin
+        reg_rdata_next[31:0] = data_in_qs;
+      end
+
+      addr_hit[1]: begin
+        reg_rdata_next[31:0] = data_out_qs;
+      end
+
+      addr_hit[2]: begin
+        reg_rdata_next[0] = ctrl_fir_en_qs;
+        reg_rdata_next[1] = ctrl_fft_en_qs;
+        reg_rdata_next[2] = ctrl_half_qs;
+        reg_rdata_next[7:4] = ctrl_log2n_qs;
+        reg_rdata_next[12:8] = ctrl_in_shift_qs;
+        reg_rdata_next[21:16] = ctrl_taps_qs;
+      end
+
+      addr_hit[3]: begin
+        reg_rdata_next[15:0] = coef_qs;
+      end
+
+      addr_hit[4]: begin
+        reg_rdata_next[31:0] = twiddle_qs;
+      end
+
+      addr_hit[5]: begin
+        reg_rdata_next[0] = status_in_ready_qs;
+        reg_rdata_next[1] = status_out_valid_qs;
+        reg_rdata_next[2] = status_busy_qs;
+      end
+
+      default: begin
+        reg_rdata_next = '1;
+      end
+    endcase
+  end
+
+  // Unused signal tieoff
+
+  // wdata / byte enable are not always fully used
+  // add a blanket unused statement to handle lint waivers
+  logic unused_wdata;
+  logic unused_be;
+  assign unused_wdata = ^reg_wdata;
+  assign unused_be = ^reg_be;
+
+  // Assertions for Register Interface
+  `ASSERT(en2addrHit, (reg_we || reg_re) |-> $onehot0(addr_hit))
+
+endmodule
+
+module fft_fir_reg_top_intf #(
+    parameter  int AW = 5,
+    localparam int DW = 32
+) (
+    input logic clk_i,
+    input logic rst_ni,
+    REG_BUS.in regbus_slave,
+    // To HW
+    output fft_fir_reg_pkg::fft_fir_reg2hw_t reg2hw,  // Write
+    input fft_fir_reg_pkg::fft_fir_hw2reg_t hw2reg,  // Read
+    // Config
+    input devmode_i  // If 1, explicit error return for unmapped register access
+);
+  localparam int unsigned STRB_WIDTH = DW / 8;
+
+  `include "register_interface/typedef.svh"
+  `include "register_interface/assign.svh"
+
+  // Define structs for reg_bus
+  typedef logic [AW-1:0] addr_t;
+  typedef logic [DW-1:0] data_t;
+  typedef logic [STRB_WIDTH-1:0] strb_t;
+  `REG_BUS_TYPEDEF_ALL(reg_bus, addr_t, data_t, strb_t)
+
+  reg_bus_req_t s_reg_req;
+  reg_bus_rsp_t s_reg_rsp;
+
+  // Assign SV interface to structs
+  `REG_BUS_ASSIGN_TO_REQ(s_reg_req, regbus_slave)
+  `REG_BUS_ASSIGN_FROM_RSP(regbus_slave, s_reg_rsp)
+
+
+
+  fft_fir_reg_top #(
+      .reg_req_t(reg_bus_req_t),
+      .reg_rsp_t(reg_bus_rsp_t),
+      .AW(AW)
+  ) i_regs (
+      .clk_i,
+      .rst_ni,
+      .reg_req_i(s_reg_req),
+      .reg_rsp_o(s_reg_rsp),
+      .reg2hw,  // Write
+      .hw2reg,  // Read
+      .devmode_i
+  );
+
+endmodule
+
+
@@ -0,0 +1,89 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Testbench interrupt trigger: raises interrupt lines a programmed number of cycles after a write,
+// so that the software can measure the interrupt latency against a known cycle.
+// - DELAY (0x0):  cycles between the write to CTRL and the raise of the lines
+// - CTRL (0x4):   writing arms the lines selected by wdata[1:0] (bit 0: PLIC line, bit 1: GPIO line)
+//                 and lowers the raised ones; writing 0 only lowers them. They are raised DELAY + 1
+//                 cycles after the write is accepted and stay high until the next write.
+//                 Reads return the armed and raised lines.
+// - STATUS (0x8): bit 0 armed, bit 1 raised
+// The GPIO line is only driven (gpio_oe_o) once it has been armed, so that the pad can be used by
+// other applications until then.
+
+module irq_trigger #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    output logic intr_o,
+    output logic gpio_o,
+    output logic gpio_oe_o
+);
+
+  localparam logic [3:0] IRQ_TRIGGER_DELAY_OFFSET = 4'h0;
+  localparam logic [3:0] IRQ_TRIGGER_CTRL_OFFSET = 4'h4;
+  localparam logic [3:0] IRQ_TRIGGER_STATUS_OFFSET = 4'h8;
+
+  logic [31:0] delay_q, count_q;
+  logic [1:0] armed_q, raised_q;
+  logic gpio_oe_q;
+
+  logic write_ctrl;
+
+  assign write_ctrl = reg_req_i.valid && reg_req_i.write &&
+                      reg_req_i.addr[3:0] == IRQ_TRIGGER_CTRL_OFFSET;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : trigger
+    if (!rst_ni) begin
+      delay_q   <= '0;
+      count_q   <= '0;
+      armed_q   <= '0;
+      raised_q  <= '0;
+      gpio_oe_q <= 1'b0;
+    end else begin
+      if (reg_req_i.valid && reg_req_i.write && reg_req_i.addr[3:0] == IRQ_TRIGGER_DELAY_OFFSET) begin
+        delay_q <= reg_req_i.wdata;
+      end
+
+      if (write_ctrl) begin
+        armed_q  <= reg_req_i.wdata[1:0];
+        raised_q <= '0;
+        count_q  <= delay_q;
+        if (reg_req_i.wdata[1]) gpio_oe_q <= 1'b1;
+      end else if (armed_q != '0) begin
+        if (count_q == '0) begin
+          raised_q <= armed_q;
+          armed_q  <= '0;
+        end else begin
+          count_q <= count_q - 32'd1;
+        end
+      end
+    end
+  end
+
+  assign reg_rsp_o.ready = 1'b1;
+  assign reg_rsp_o.error = 1'b0;
+
+  always_comb begin
+    reg_rsp_o.rdata = '0;
+    unique case (reg_req_i.addr[3:0])
+      IRQ_TRIGGER_DELAY_OFFSET:  reg_rsp_o.rdata = delay_q;
+      IRQ_TRIGGER_CTRL_OFFSET:   reg_rsp_o.rdata = {30'b0, armed_q | raised_q};
+      IRQ_TRIGGER_STATUS_OFFSET: reg_rsp_o.rdata = {30'b0, raised_q != '0, armed_q != '0};
+      default:                   reg_rsp_o.rdata = '0;
+    endcase
+  end
+
+  assign intr_o    = raised_q[0];
+  assign gpio_o    = raised_q[1];
+  assign gpio_oe_o = gpio_oe_q;
+
+endmodule  // irq_trigger
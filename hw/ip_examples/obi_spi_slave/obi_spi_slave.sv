@@ -0,0 +1,178 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// SPI slave giving an external host access to the memory map as an OBI master, so that it can
+// write and read the RAM banks, load a firmware and start it (BOOT_ADDRESS and BOOT_EXIT_LOOP of
+// soc_ctrl), and poll a mailbox. It wraps the vendored pulp_platform_axi_spi_slave, whose AXI
+// master only issues single-beat 32-bit transactions, one at a time: each one is bridged to one
+// OBI transaction.
+// Commands (8 bits, then MSB first):
+// - 0x02 addr[31:0] data...:        write words from addr, incrementing
+// - 0x0B addr[31:0] dummy data...:  read words from addr, after REG1 + 1 dummy cycles
+// - 0x01 / 0x05:                    write / read REG0, bit 0 enables the quad mode
+// - 0x11 / 0x07:                    write / read REG1, the dummy cycles of a read minus 1 (32 at reset)
+// - 0x20 / 0x21, 0x30 / 0x31:       write / read the wrap length of the addresses, low / high
+// A word is sent MSB first and lands in memory as it was sent, so a little-endian host sends the
+// bytes of each word in reverse order. The SPI mode is 0 (CPOL = 0, CPHA = 0).
+
+module obi_spi_slave #(
+    parameter type obi_req_t  = logic,
+    parameter type obi_resp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  logic       spi_sck_i,
+    input  logic       spi_csb_i,
+    input  logic [3:0] spi_sd_i,
+    output logic [3:0] spi_sd_o,
+    output logic [3:0] spi_sd_oe_o,
+
+    output obi_req_t  master_req_o,
+    input  obi_resp_t master_resp_i
+);
+
+  logic [3:0] spi_oen;
+
+  // AXI master of the SPI slave
+  logic aw_valid, aw_ready, w_valid, w_ready, b_valid, b_ready;
+  logic ar_valid, ar_ready, r_valid, r_ready;
+  logic [31:0] aw_addr, ar_addr, w_data, r_data_q;
+  logic [3:0] w_strb;
+
+  axi_spi_slave #(
+      .AXI_ADDR_WIDTH(32),
+      .AXI_DATA_WIDTH(32),
+      .AXI_USER_WIDTH(1),
+      .AXI_ID_WIDTH  (1)
+  ) axi_spi_slave_i (
+      .test_mode(1'b0),
+      .spi_sclk (spi_sck_i),
+      .spi_cs   (spi_csb_i),
+      .spi_oen0_o(spi_oen[0]),
+      .spi_oen1_o(spi_oen[1]),
+      .spi_oen2_o(spi_oen[2]),
+      .spi_oen3_o(spi_oen[3]),
+      .spi_sdi0 (spi_sd_i[0]),
+      .spi_sdi1 (spi_sd_i[1]),
+      .spi_sdi2 (spi_sd_i[2]),
+      .spi_sdi3 (spi_sd_i[3]),
+      .spi_sdo0 (spi_sd_o[0]),
+      .spi_sdo1 (spi_sd_o[1]),
+      .spi_sdo2 (spi_sd_o[2]),
+      .spi_sdo3 (spi_sd_o[3]),
+
+      .axi_aclk   (clk_i),
+      .axi_aresetn(rst_ni),
+
+      .axi_master_aw_valid (aw_valid),
+      .axi_master_aw_addr  (aw_addr),
+      .axi_master_aw_prot  (),
+      .axi_master_aw_region(),
+      .axi_master_aw_len   (),
+      .axi_master_aw_size  (),
+      .axi_master_aw_burst (),
+      .axi_master_aw_lock  (),
+      .axi_master_aw_cache (),
+      .axi_master_aw_qos   (),
+      .axi_master_aw_id    (),
+      .axi_master_aw_user  (),
+      .axi_master_aw_ready (aw_ready),
+
+      .axi_master_ar_valid (ar_valid),
+      .axi_master_ar_addr  (ar_addr),
+      .axi_master_ar_prot  (),
+      .axi_master_ar_region(),
+      .axi_master_ar_len   (),
+      .axi_master_ar_size  (),
+      .axi_master_ar_burst (),
+      .axi_master_ar_lock  (),
+      .axi_master_ar_cache (),
+      .axi_master_ar_qos   (),
+      .axi_master_ar_id    (),
+      .axi_master_ar_user  (),
+      .axi_master_ar_ready (ar_ready),
+
+      .axi_master_w_valid(w_valid),
+      .axi_master_w_data (w_data),
+      .axi_master_w_strb (w_strb),
+      .axi_master_w_user (),
+      .axi_master_w_last (),
+      .axi_master_w_ready(w_ready),
+
+      .axi_master_r_valid(r_valid),
+      .axi_master_r_data (r_data_q),
+      .axi_master_r_resp (2'b00),
+      .axi_master_r_last (1'b1),
+      .axi_master_r_id   (1'b1),
+      .axi_master_r_user (1'b0),
+      .axi_master_r_ready(r_ready),
+
+      .axi_master_b_valid(b_valid),
+      .axi_master_b_resp (2'b00),
+      .axi_master_b_id   (1'b1),
+      .axi_master_b_user (1'b0),
+      .axi_master_b_ready(b_ready)
+  );
+
+  // Released while the slave is not selected, the lines are shared with the other devices
+  assign spi_sd_oe_o = spi_csb_i ? 4'b0000 : ~spi_oen;
+
+  // AXI to OBI: the write address and data come together, and a transaction is answered before
+  // the next one is accepted
+  typedef enum logic [2:0] {
+    IDLE,
+    WRITE_WAIT,
+    WRITE_RESP,
+    READ_WAIT,
+    READ_RESP
+  } bridge_state_e;
+
+  bridge_state_e state_q, state_d;
+  logic write_req, read_req;
+
+  assign write_req = state_q == IDLE && aw_valid && w_valid;
+  assign read_req  = state_q == IDLE && !write_req && ar_valid;
+
+  always_comb begin
+    master_req_o       = '0;
+    master_req_o.req   = write_req || read_req;
+    master_req_o.we    = write_req;
+    master_req_o.be    = write_req ? w_strb : 4'hF;
+    master_req_o.addr  = write_req ? aw_addr : ar_addr;
+    master_req_o.wdata = w_data;
+  end
+
+  assign aw_ready = write_req && master_resp_i.gnt;
+  assign w_ready  = aw_ready;
+  assign ar_ready = read_req && master_resp_i.gnt;
+  assign b_valid  = state_q == WRITE_RESP;
+  assign r_valid  = state_q == READ_RESP;
+
+  always_comb begin
+    state_d = state_q;
+    unique case (state_q)
+      IDLE: begin
+        if (aw_ready) state_d = WRITE_WAIT;
+        else if (ar_ready) state_d = READ_WAIT;
+      end
+      WRITE_WAIT: if (master_resp_i.rvalid) state_d = WRITE_RESP;
+      WRITE_RESP: if (b_ready) state_d = IDLE;
+      READ_WAIT:  if (master_resp_i.rvalid) state_d = READ_RESP;
+      READ_RESP:  if (r_ready) state_d = IDLE;
+      default:    state_d = IDLE;
+    endcase
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      state_q  <= IDLE;
+      r_data_q <= '0;
+    end else begin
+      state_q <= state_d;
+      if (state_q == READ_WAIT && master_resp_i.rvalid) r_data_q <= master_resp_i.rdata;
+    end
+  end
+
+endmodule  // obi_spi_slave
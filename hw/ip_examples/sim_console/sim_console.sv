@@ -0,0 +1,44 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Simulation-only console: every write prints the written bytes to the host stdout in one cycle,
+// without modelling the UART serial line.
+// - DATA (0x0): prints wdata[7:0]
+// - WORD (0x4): prints the bytes enabled by wstrb, starting from the least significant one
+// Reads return 0. Nothing is printed in synthesis.
+
+module sim_console #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o
+);
+
+  localparam logic [3:0] SIM_CONSOLE_DATA_OFFSET = 4'h0;
+  localparam logic [3:0] SIM_CONSOLE_WORD_OFFSET = 4'h4;
+
+  assign reg_rsp_o.ready = 1'b1;
+  assign reg_rsp_o.error = 1'b0;
+  assign reg_rsp_o.rdata = '0;
+
+`ifndef SYNTHESIS
+  always_ff @(posedge clk_i) begin : print_console
+    if (rst_ni && reg_req_i.valid && reg_req_i.write) begin
+      if (reg_req_i.addr[3:0] == SIM_CONSOLE_DATA_OFFSET) begin
+        $write("%c", reg_req_i.wdata[7:0]);
+      end else if (reg_req_i.addr[3:0] == SIM_CONSOLE_WORD_OFFSET) begin
+        for (int i = 0; i < 4; i++) begin
+          if (reg_req_i.wstrb[i]) $write("%c", reg_req_i.wdata[8*i+:8]);
+        end
+      end
+      $fflush();
+    end
+  end
+`endif
+
+endmodule  // sim_console
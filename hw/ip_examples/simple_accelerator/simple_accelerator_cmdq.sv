@@ -0,0 +1,89 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// Generated by util/accgen.py from hw/ip_examples/simple_accelerator/simple_accelerator.hjson, do not edit.
+//
+// Standard command queue of hw/ip/acc_cmdq in front of simple_accelerator_core, which
+// takes the jobs on its cmd_* ports and returns their completions on its
+// cpl_* ports.
+
+module simple_accelerator_cmdq #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter type obi_req_t = logic,
+    parameter type obi_resp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    output obi_req_t acc_read_ch0_req_o,
+    input  obi_resp_t acc_read_ch0_resp_i,
+    output obi_req_t acc_write_ch0_req_o,
+    input  obi_resp_t acc_write_ch0_resp_i,
+
+    output logic intr_o
+);
+
+  logic cmd_valid, cmd_ready;
+  logic [7:0] cmd_opcode, cmd_tag;
+  logic [3:0][31:0] cmd_args;
+
+  logic cpl_valid, cpl_ready;
+  logic [7:0] cpl_tag;
+  logic [15:0] cpl_status;
+
+  acc_cmdq #(
+      .ACC_ID(32'h5AC00001),
+      .NUM_ARGS(4),
+      .CMD_DEPTH(4),
+      .CPL_DEPTH(4),
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t)
+  ) acc_cmdq_i (
+      .clk_i,
+      .rst_ni,
+      .reg_req_i,
+      .reg_rsp_o,
+      .cmd_valid_o(cmd_valid),
+      .cmd_ready_i(cmd_ready),
+      .cmd_opcode_o(cmd_opcode),
+      .cmd_tag_o(cmd_tag),
+      .cmd_args_o(cmd_args),
+      .cpl_valid_i(cpl_valid),
+      .cpl_ready_o(cpl_ready),
+      .cpl_tag_i(cpl_tag),
+      .cpl_status_i(cpl_status),
+      .intr_o
+  );
+
+  simple_accelerator_core #(
+      .reg_req_t(reg_req_t),
+      .reg_rsp_t(reg_rsp_t),
+      .obi_req_t(obi_req_t),
+      .obi_resp_t(obi_resp_t)
+  ) simple_accelerator_core_i (
+      .clk_i,
+      .rst_ni,
+      .cmd_valid_i(cmd_valid),
+      .cmd_ready_o(cmd_ready),
+      .cmd_opcode_i(cmd_opcode),
+      .cmd_tag_i(cmd_tag),
+      .cmd_src_i(cmd_args[0]),
+      .cmd_dst_i(cmd_args[1]),
+      .cmd_threshold_i(cmd_args[2]),
+      .cmd_size_i(cmd_args[3]),
+      .cpl_valid_o(cpl_valid),
+      .cpl_ready_i(cpl_ready),
+      .cpl_tag_o(cpl_tag),
+      .cpl_status_o(cpl_status),
+      .acc_read_ch0_req_o(acc_read_ch0_req_o),
+      .acc_read_ch0_resp_i(acc_read_ch0_resp_i),
+      .acc_write_ch0_req_o(acc_write_ch0_req_o),
+      .acc_write_ch0_resp_i(acc_write_ch0_resp_i)
+  );
+
+endmodule
@@ -0,0 +1,194 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// Core of simple_accelerator_cmdq: takes one job at a time from the command
+// queue, programs simple_accelerator through its registers, polls its READY
+// register and returns the completion.
+//
+// Completion status: 0 done, 1 unknown opcode, 2 size above 1023 words.
+
+module simple_accelerator_core #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter type obi_req_t = logic,
+    parameter type obi_resp_t = logic
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  logic        cmd_valid_i,
+    output logic        cmd_ready_o,
+    input  logic [ 7:0] cmd_opcode_i,
+    input  logic [ 7:0] cmd_tag_i,
+    input  logic [31:0] cmd_src_i,
+    input  logic [31:0] cmd_dst_i,
+    input  logic [31:0] cmd_threshold_i,
+    input  logic [31:0] cmd_size_i,
+
+    output logic        cpl_valid_o,
+    input  logic        cpl_ready_i,
+    output logic [ 7:0] cpl_tag_o,
+    output logic [15:0] cpl_status_o,
+
+    output obi_req_t  acc_read_ch0_req_o,
+    input  obi_resp_t acc_read_ch0_resp_i,
+
+    output obi_req_t  acc_write_ch0_req_o,
+    input  obi_resp_t acc_write_ch0_resp_i
+);
+
+  localparam logic [7:0] OpCopy = 8'd1;
+
+  localparam logic [15:0] StatusDone = 16'd0;
+  localparam logic [15:0] StatusBadOpcode = 16'd1;
+  localparam logic [15:0] StatusBadSize = 16'd2;
+
+  enum logic [1:0] {
+    CORE_IDLE,
+    CORE_PROGRAM,
+    CORE_POLL,
+    CORE_COMPLETE
+  }
+      core_state_q, core_state_d;
+
+  logic [2:0] step_q, step_d;
+  logic [31:0] src_q, dst_q, threshold_q, size_q;
+  logic [7:0] tag_q;
+  logic [15:0] status_q, status_d;
+
+  reg_req_t acc_reg_req;
+  reg_rsp_t acc_reg_rsp;
+
+  assign cmd_ready_o = core_state_q == CORE_IDLE;
+  assign cpl_valid_o = core_state_q == CORE_COMPLETE;
+  assign cpl_tag_o = tag_q;
+  assign cpl_status_o = status_q;
+
+  // Register writes of a job, in this order: READ, WRITE, THRESHOLD, SIZE,
+  // READY cleared, START
+  always_comb begin
+    acc_reg_req = '0;
+    acc_reg_req.wstrb = 4'hF;
+
+    if (core_state_q == CORE_PROGRAM) begin
+      acc_reg_req.valid = 1'b1;
+      acc_reg_req.write = 1'b1;
+      case (step_q)
+        3'd0: begin
+          acc_reg_req.addr  = 32'h0;
+          acc_reg_req.wdata = src_q;
+        end
+        3'd1: begin
+          acc_reg_req.addr  = 32'h4;
+          acc_reg_req.wdata = dst_q;
+        end
+        3'd2: begin
+          acc_reg_req.addr  = 32'h8;
+          acc_reg_req.wdata = threshold_q;
+        end
+        3'd3: begin
+          acc_reg_req.addr  = 32'h10;
+          acc_reg_req.wdata = size_q;
+        end
+        3'd4: begin
+          acc_reg_req.addr  = 32'hC;
+          acc_reg_req.wdata = 32'h0;
+        end
+        default: begin
+          acc_reg_req.addr  = 32'h14;
+          acc_reg_req.wdata = 32'h1;
+        end
+      endcase
+    end else if (core_state_q == CORE_POLL) begin
+      acc_reg_req.valid = 1'b1;
+      acc_reg_req.addr  = 32'hC;
+    end
+  end
+
+  always_comb begin
+    core_state_d = core_state_q;
+    step_d = step_q;
+    status_d = status_q;
+
+    case (core_state_q)
+      CORE_IDLE: begin
+        if (cmd_valid_i) begin
+          step_d = '0;
+          if (cmd_opcode_i != OpCopy) begin
+            status_d = StatusBadOpcode;
+            core_state_d = CORE_COMPLETE;
+          end else if (cmd_size_i > 32'd1023) begin
+            status_d = StatusBadSize;
+            core_state_d = CORE_COMPLETE;
+          end else if (cmd_size_i == '0) begin
+            // simple_accelerator does not start on an empty copy
+            status_d = StatusDone;
+            core_state_d = CORE_COMPLETE;
+          end else begin
+            status_d = StatusDone;
+            core_state_d = CORE_PROGRAM;
+          end
+        end
+      end
+      CORE_PROGRAM: begin
+        step_d = step_q + 3'd1;
+        if (step_q == 3'd5) begin
+          core_state_d = CORE_POLL;
+        end
+      end
+      CORE_POLL: begin
+        if (acc_reg_rsp.rdata[0]) begin
+          core_state_d = CORE_COMPLETE;
+        end
+      end
+      CORE_COMPLETE: begin
+        if (cpl_ready_i) begin
+          core_state_d = CORE_IDLE;
+        end
+      end
+      default: core_state_d = CORE_IDLE;
+    endcase
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      core_state_q <= CORE_IDLE;
+      step_q <= '0;
+      status_q <= '0;
+      tag_q <= '0;
+      src_q <= '0;
+      dst_q <= '0;
+      threshold_q <= '0;
+      size_q <= '0;
+    end else begin
+      core_state_q <= core_state_d;
+      step_q <= step_d;
+      status_q <= status_d;
+      if (cmd_valid_i && cmd_ready_o) begin
+        tag_q <= cmd_tag_i;
+        src_q <= cmd_src_i;
+        dst_q <= cmd_dst_i;
+        threshold_q <= cmd_threshold_i;
+        size_q <= cmd_size_i;
+      end
+    end
+  end
+
+  simple_accelerator #(
+      .reg_req_t (reg_req_t),
+      .reg_rsp_t (reg_rsp_t),
+      .obi_req_t (obi_req_t),
+      .obi_resp_t(obi_resp_t)
+  ) simple_accelerator_i (
+      .clk_i,
+      .rst_ni,
+      .reg_req_i(acc_reg_req),
+      .reg_rsp_o(acc_reg_rsp),
+      .acc_read_ch0_req_o,
+      .acc_read_ch0_resp_i,
+      .acc_write_ch0_req_o,
+      .acc_write_ch0_resp_i
+  );
+
+endmodule
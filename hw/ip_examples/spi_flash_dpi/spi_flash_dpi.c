@@ -0,0 +1,111 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "spi_flash_dpi.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static struct spi_flash_dpi_ctx *spi_flash_dpi_list = NULL;
+
+void *spi_flash_dpi_create(const char *name, const char *file, unsigned int size) {
+  struct spi_flash_dpi_ctx *ctx =
+      (struct spi_flash_dpi_ctx *)malloc(sizeof(struct spi_flash_dpi_ctx));
+  assert(ctx);
+
+  snprintf(ctx->name, sizeof(ctx->name), "%s", name);
+  ctx->size = size;
+  ctx->fd = -1;
+
+  if (strlen(file) == 0) {
+    ctx->mem = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(ctx->mem != MAP_FAILED);
+    memset(ctx->mem, 0xFF, size);
+    printf("SPI flash: %s starts erased, %u bytes\n", name, size);
+  } else {
+    // The bytes beyond the end of the file are erased, so that a new file
+    // starts erased
+    struct stat st;
+    ctx->fd = open(file, O_RDWR | O_CREAT, 0644);
+    if (ctx->fd < 0 || fstat(ctx->fd, &st) != 0) {
+      fprintf(stderr, "SPI flash: cannot open %s\n", file);
+      exit(EXIT_FAILURE);
+    }
+    off_t old_size = st.st_size < (off_t)size ? st.st_size : (off_t)size;
+    if (st.st_size < (off_t)size && ftruncate(ctx->fd, size) != 0) {
+      fprintf(stderr, "SPI flash: cannot extend %s to %u bytes\n", file, size);
+      exit(EXIT_FAILURE);
+    }
+    ctx->mem = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                               ctx->fd, 0);
+    assert(ctx->mem != MAP_FAILED);
+    memset(ctx->mem + old_size, 0xFF, size - old_size);
+    printf("SPI flash: %s backed by %s, %u bytes\n", name, file, size);
+  }
+
+  ctx->next = spi_flash_dpi_list;
+  spi_flash_dpi_list = ctx;
+  return (void *)ctx;
+}
+
+void spi_flash_dpi_close(void *ctx_void) {
+  struct spi_flash_dpi_ctx *ctx = (struct spi_flash_dpi_ctx *)ctx_void;
+  struct spi_flash_dpi_ctx **p;
+  if (!ctx) {
+    return;
+  }
+
+  for (p = &spi_flash_dpi_list; *p; p = &(*p)->next) {
+    if (*p == ctx) {
+      *p = ctx->next;
+      break;
+    }
+  }
+  if (ctx->fd >= 0) {
+    msync(ctx->mem, ctx->size, MS_SYNC);
+    close(ctx->fd);
+  }
+  munmap(ctx->mem, ctx->size);
+  free(ctx);
+}
+
+unsigned char spi_flash_dpi_read(void *ctx_void, unsigned int addr) {
+  struct spi_flash_dpi_ctx *ctx = (struct spi_flash_dpi_ctx *)ctx_void;
+  return ctx->mem[addr % ctx->size];
+}
+
+void spi_flash_dpi_program(void *ctx_void, unsigned int addr, unsigned char data) {
+  struct spi_flash_dpi_ctx *ctx = (struct spi_flash_dpi_ctx *)ctx_void;
+  ctx->mem[addr % ctx->size] &= data;
+}
+
+void spi_flash_dpi_erase(void *ctx_void, unsigned int addr, unsigned int size) {
+  struct spi_flash_dpi_ctx *ctx = (struct spi_flash_dpi_ctx *)ctx_void;
+  if (size > ctx->size) {
+    size = ctx->size;
+  }
+  memset(ctx->mem + (addr % ctx->size & ~(size - 1)), 0xFF, size);
+}
+
+void *spi_flash_dpi_find(const char *name) {
+  struct spi_flash_dpi_ctx *ctx;
+  for (ctx = spi_flash_dpi_list; ctx; ctx = ctx->next) {
+    if (strcmp(ctx->name, name) == 0) {
+      return (void *)ctx;
+    }
+  }
+  return NULL;
+}
+
+void spi_flash_dpi_write(void *ctx_void, unsigned int addr, unsigned char data) {
+  struct spi_flash_dpi_ctx *ctx = (struct spi_flash_dpi_ctx *)ctx_void;
+  ctx->mem[addr % ctx->size] = data;
+}
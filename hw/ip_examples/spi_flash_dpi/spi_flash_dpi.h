@@ -0,0 +1,42 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef SPI_FLASH_DPI_H_
+#define SPI_FLASH_DPI_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Content of a flash of spi_flash_dpi.sv: the file, mapped in memory, or
+// anonymous memory when there is none. The contexts are found by the name of
+// their instance, e.g. by tb_top.cpp to preload the image of a flash boot.
+struct spi_flash_dpi_ctx {
+  char name[64];
+  uint8_t *mem;
+  uint32_t size;
+  int fd;
+  struct spi_flash_dpi_ctx *next;
+};
+
+// Called by the model
+void *spi_flash_dpi_create(const char *name, const char *file, unsigned int size);
+void spi_flash_dpi_close(void *ctx_void);
+unsigned char spi_flash_dpi_read(void *ctx_void, unsigned int addr);
+// Clears the bits of data that are 0, like the programming of a NOR flash
+void spi_flash_dpi_program(void *ctx_void, unsigned int addr, unsigned char data);
+// Sets size bytes from addr, aligned on size, to 0xFF
+void spi_flash_dpi_erase(void *ctx_void, unsigned int addr, unsigned int size);
+
+// Called by the testbench: the context of the instance name, NULL if there is
+// none, and writes a byte whatever the content, the address modulo the size
+void *spi_flash_dpi_find(const char *name);
+void spi_flash_dpi_write(void *ctx_void, unsigned int addr, unsigned char data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // SPI_FLASH_DPI_H_
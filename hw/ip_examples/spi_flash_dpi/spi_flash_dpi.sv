@@ -0,0 +1,344 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Behavioural model of the W25Q128JW SPI flash, for Verilator where the spiflash model of picosoc
+// does not run. The content is kept by spi_flash_dpi.c, programs and erases take effect at once
+// and only the BUSY bit of the status register reports their latency. Plusargs:
+// - +flash_file=<path>:  file holding the content, mapped in memory and created erased if missing,
+//                        so that what the software programs is found again by the next runs.
+//                        Without it the flash starts erased.
+// - +flash_busy=<n>:     SPI clocks BUSY stays set after a program, an erase or a status register
+//                        write, 0 (none) by default
+// - +flash_dummy=<n>:    dummy clocks of the fast read quad I/O after the mode bits, 8 by default
+//                        like the picosoc model and the TARGET_SIM software, 4 on the W25Q128JW
+// tb_top.cpp writes the images in the content through spi_flash_dpi_find(NAME).
+// Commands (standard SPI, mode 0 or 3): 0x03, 0x0B, 0x6B and 0xEB reads, with the continuous read
+// mode of 0xEB (mode bits 0b10 in bits 5:4), 0x02 and 0x32 page programs, 0x20, 0x52, 0xD8, 0xC7
+// and 0x60 erases, 0x06 / 0x04 / 0x50 write enables, 0x05 / 0x35 / 0x15 and 0x01 / 0x31 / 0x11
+// status registers, 0x9F, 0x90, 0xAB and 0x4B identifications, 0xB9 power-down, 0x66 / 0x99
+// reset. The other commands, QPI mode and the block protection included, are ignored.
+
+module spi_flash_dpi #(
+    parameter string       NAME = "flash",
+    parameter int unsigned SIZE = 32'h0100_0000  // Bytes, a power of 2 up to 16 MiB
+) (
+    input  logic       sck_i,
+    input  logic       csb_i,
+    input  logic [3:0] sd_i,
+    output logic [3:0] sd_o,
+    output logic [3:0] sd_oe_o
+);
+
+  import "DPI-C" function chandle spi_flash_dpi_create(
+    input string name,
+    input string file,
+    input int unsigned size
+  );
+  import "DPI-C" function void spi_flash_dpi_close(input chandle ctx);
+  import "DPI-C" function byte unsigned spi_flash_dpi_read(
+    input chandle ctx,
+    input int unsigned addr
+  );
+  import "DPI-C" function void spi_flash_dpi_program(
+    input chandle ctx,
+    input int unsigned addr,
+    input byte unsigned data
+  );
+  import "DPI-C" function void spi_flash_dpi_erase(
+    input chandle ctx,
+    input int unsigned addr,
+    input int unsigned size
+  );
+
+  typedef enum logic [2:0] {
+    CMD,
+    ADDR,
+    MODE,
+    DUMMY,
+    DATA_IN,
+    DATA_OUT,
+    IGNORE
+  } phase_e;
+
+  chandle ctx;
+  int unsigned busy_clocks, quad_dummy;
+
+  // Transaction, restarted by each rising edge of csb_i
+  phase_e phase_q;
+  logic [7:0] cmd_q;
+  logic [31:0] shift_q;
+  int unsigned bits_q, dummy_q, index_q;
+  logic [23:0] addr_q;
+  logic quad_in_q, quad_out_q;
+  // Byte sent, its bits put on the lines so far, and the next ones
+  logic [7:0] out_q;
+  int unsigned sent_q;
+  logic [3:0] tx_q;
+  logic tx_en_q;
+  // Set when the transaction programs, erases or writes a status register at its end
+  logic written_q;
+  int unsigned erase_size_q;
+
+  // State of the flash
+  logic wel_q, srwe_q, crm_q, power_down_q, reset_en_q;
+  logic [7:0] sr1_q, sr2_q, sr3_q;
+  int unsigned busy_q;
+
+  logic [31:0] shift_d;
+  int unsigned bits_d;
+
+  assign shift_d = quad_in_q ? {shift_q[27:0], sd_i} : {shift_q[30:0], sd_i[0]};
+  assign bits_d  = bits_q + (quad_in_q ? 4 : 1);
+
+  initial begin
+    string file;
+    if (!$value$plusargs("flash_file=%s", file)) file = "";
+    if (!$value$plusargs("flash_busy=%d", busy_clocks)) busy_clocks = 0;
+    if (!$value$plusargs("flash_dummy=%d", quad_dummy)) quad_dummy = 8;
+    ctx = spi_flash_dpi_create(NAME, file, SIZE);
+
+    phase_q      = CMD;
+    cmd_q        = '0;
+    quad_in_q    = 1'b0;
+    tx_en_q      = 1'b0;
+    written_q    = 1'b0;
+    wel_q        = 1'b0;
+    srwe_q       = 1'b0;
+    crm_q        = 1'b0;
+    power_down_q = 1'b0;
+    reset_en_q   = 1'b0;
+    sr1_q        = '0;
+    // QE set in the factory
+    sr2_q        = 8'h02;
+    sr3_q        = '0;
+    busy_q       = 0;
+  end
+
+  final begin
+    spi_flash_dpi_close(ctx);
+  end
+
+  // Byte number index sent by a read of the flash, of the status or of the identification
+  function automatic logic [7:0] out_byte(input logic [7:0] cmd, input logic [23:0] addr,
+                                          input int unsigned index);
+    case (cmd)
+      8'h05:   return {sr1_q[7:2], wel_q, busy_q != 0};
+      8'h35:   return sr2_q;
+      8'h15:   return sr3_q;
+      8'h9F:   return index % 3 == 0 ? 8'hEF : index % 3 == 1 ? 8'h60 : 8'h18;
+      8'hAB:   return 8'h17;
+      8'h90:   return (addr[0] ^ index[0]) ? 8'h17 : 8'hEF;
+      8'h4B:   return 8'hD0 + 8'(index % 8);
+      default: return spi_flash_dpi_read(ctx, 32'(addr) % SIZE);
+    endcase
+  endfunction
+
+  // Schedules the first bits of the byte read at addr, sent from the next falling edge
+  task automatic start_out(input logic [23:0] addr, input logic quad);
+    logic [7:0] data;
+    data       = out_byte(cmd_q, addr, 0);
+    out_q      <= data;
+    sent_q     <= quad ? 4 : 1;
+    tx_q       <= quad ? data[7:4] : {2'b00, data[7], 1'b0};
+    tx_en_q    <= 1'b1;
+    quad_out_q <= quad;
+    addr_q     <= addr + 24'd1;
+    index_q    <= 0;
+    phase_q    <= DATA_OUT;
+  endtask
+
+  task automatic start_dummy(input int unsigned clocks, input logic quad);
+    if (clocks == 0) begin
+      start_out(addr_q, quad);
+    end else begin
+      dummy_q    <= clocks;
+      quad_out_q <= quad;
+      phase_q    <= DUMMY;
+    end
+  endtask
+
+  task automatic start_command(input logic [7:0] cmd);
+    cmd_q      <= cmd;
+    bits_q     <= 0;
+    phase_q    <= IGNORE;
+    reset_en_q <= 1'b0;
+    if (power_down_q && cmd != 8'hAB) begin
+      // Only the release from power-down
+    end else if (busy_q != 0 && cmd != 8'h05 && cmd != 8'h35 && cmd != 8'h15) begin
+      // Only the status while a program or an erase runs
+    end else begin
+      case (cmd)
+        8'h06: wel_q <= 1'b1;
+        8'h04: wel_q <= 1'b0;
+        8'h50: srwe_q <= 1'b1;
+        8'hB9: power_down_q <= 1'b1;
+        8'h66: reset_en_q <= 1'b1;
+        8'h99: begin
+          if (reset_en_q) begin
+            wel_q  <= 1'b0;
+            srwe_q <= 1'b0;
+            crm_q  <= 1'b0;
+          end
+        end
+        8'h05, 8'h35, 8'h15, 8'h9F: start_out('0, 1'b0);
+        8'hAB: begin
+          power_down_q <= 1'b0;
+          phase_q      <= ADDR;
+        end
+        8'h03, 8'h0B, 8'h6B, 8'h90, 8'h20, 8'h52, 8'hD8: phase_q <= ADDR;
+        8'h02, 8'h32: if (wel_q) phase_q <= ADDR;
+        8'hEB: begin
+          phase_q   <= ADDR;
+          quad_in_q <= 1'b1;
+        end
+        8'h01, 8'h31, 8'h11: begin
+          if (wel_q || srwe_q) begin
+            index_q <= 0;
+            phase_q <= DATA_IN;
+          end
+        end
+        8'hC7, 8'h60: begin
+          if (wel_q) begin
+            written_q    <= 1'b1;
+            erase_size_q <= SIZE;
+          end
+        end
+        8'h4B: start_dummy(32, 1'b0);
+        default: ;
+      endcase
+    end
+  endtask
+
+  always @(posedge sck_i or posedge csb_i) begin
+    if (csb_i) begin
+      // End of the transaction: an erase is done if its address is complete, and the write enable
+      // is cleared by a program, an erase or a status register write
+      if (written_q) begin
+        if (erase_size_q != 0) spi_flash_dpi_erase(ctx, 32'(addr_q), erase_size_q);
+        wel_q   <= 1'b0;
+        srwe_q  <= 1'b0;
+        busy_q  <= busy_clocks;
+      end
+      written_q    <= 1'b0;
+      erase_size_q <= 0;
+      bits_q       <= 0;
+      shift_q      <= '0;
+      tx_en_q      <= 1'b0;
+      // In the continuous read mode the next transaction starts with the address of a 0xEB read
+      phase_q      <= crm_q ? ADDR : CMD;
+      cmd_q        <= crm_q ? 8'hEB : 8'h00;
+      quad_in_q    <= crm_q;
+    end else begin
+      if (busy_q != 0) busy_q <= busy_q - 1;
+      shift_q <= shift_d;
+      bits_q  <= bits_d;
+
+      case (phase_q)
+        CMD: if (bits_d == 8) start_command(shift_d[7:0]);
+
+        ADDR: begin
+          if (bits_d == 24) begin
+            addr_q <= shift_d[23:0];
+            bits_q <= 0;
+            case (cmd_q)
+              8'h03, 8'h90: start_out(shift_d[23:0], 1'b0);
+              8'hAB: start_out('0, 1'b0);
+              8'h0B, 8'h6B: start_dummy(8, cmd_q == 8'h6B);
+              8'hEB: phase_q <= MODE;
+              8'h02, 8'h32: begin
+                index_q   <= 0;
+                quad_in_q <= cmd_q == 8'h32;
+                phase_q   <= DATA_IN;
+              end
+              8'h20, 8'h52, 8'hD8: begin
+                phase_q <= IGNORE;
+                if (wel_q) begin
+                  written_q    <= 1'b1;
+                  erase_size_q <= cmd_q == 8'h20 ? 32'h1000 : cmd_q == 8'h52 ? 32'h8000 : 32'h10000;
+                end
+              end
+              default: phase_q <= IGNORE;
+            endcase
+          end
+        end
+
+        MODE: begin
+          if (bits_d == 8) begin
+            crm_q <= shift_d[5:4] == 2'b10;
+            if (quad_dummy == 0) begin
+              start_out(addr_q, 1'b1);
+            end else begin
+              dummy_q    <= quad_dummy;
+              quad_out_q <= 1'b1;
+              phase_q    <= DUMMY;
+            end
+          end
+        end
+
+        DUMMY: begin
+          dummy_q <= dummy_q - 1;
+          if (dummy_q == 1) start_out(addr_q, quad_out_q);
+        end
+
+        DATA_IN: begin
+          if (bits_d == 8) begin
+            bits_q  <= 0;
+            index_q <= index_q + 1;
+            case (cmd_q)
+              8'h02, 8'h32: begin
+                // Wraps in the page
+                spi_flash_dpi_program(ctx, 32'(addr_q) % SIZE, shift_d[7:0]);
+                addr_q[7:0] <= addr_q[7:0] + 8'd1;
+                written_q   <= 1'b1;
+              end
+              8'h01: begin
+                if (index_q == 0) sr1_q <= shift_d[7:0] & 8'hFC;
+                else if (index_q == 1) sr2_q <= shift_d[7:0] & 8'h43;
+                written_q <= 1'b1;
+              end
+              8'h31: begin
+                if (index_q == 0) sr2_q <= shift_d[7:0] & 8'h43;
+                written_q <= 1'b1;
+              end
+              8'h11: begin
+                if (index_q == 0) sr3_q <= shift_d[7:0] & 8'h64;
+                written_q <= 1'b1;
+              end
+              default: ;
+            endcase
+          end
+        end
+
+        DATA_OUT: begin
+          if (sent_q == 8) begin
+            logic [7:0] data;
+            data = out_byte(cmd_q, addr_q, index_q + 1);
+            out_q   <= data;
+            sent_q  <= quad_out_q ? 4 : 1;
+            tx_q    <= quad_out_q ? data[7:4] : {2'b00, data[7], 1'b0};
+            addr_q  <= addr_q + 24'd1;
+            index_q <= index_q + 1;
+          end else begin
+            sent_q <= sent_q + (quad_out_q ? 4 : 1);
+            tx_q   <= quad_out_q ? out_q[3:0] : {2'b00, out_q[7-sent_q], 1'b0};
+          end
+        end
+
+        default: ;
+      endcase
+    end
+  end
+
+  // The flash drives the lines from the falling edges, MISO (sd[1]) or all of them in quad mode
+  always @(negedge sck_i or posedge csb_i) begin
+    if (csb_i) begin
+      sd_o    <= '0;
+      sd_oe_o <= '0;
+    end else begin
+      sd_o    <= tx_q;
+      sd_oe_o <= tx_en_q ? (quad_out_q ? 4'hF : 4'b0010) : 4'b0000;
+    end
+  end
+
+endmodule : spi_flash_dpi
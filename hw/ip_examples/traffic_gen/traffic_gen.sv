@@ -0,0 +1,226 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Testbench traffic generator: an OBI master issuing reads or writes at a programmed rate, to
+// measure how external masters contend with the core and the DMA for the RAM banks.
+// - CTRL (0x00):       writing bit 0 starts a run of COUNT transactions and clears the statistics,
+//                      bit 1 selects writes instead of reads, bit 2 random instead of sequential
+//                      addresses. Reads return bit 0 busy.
+// - ADDR (0x04):       base address, word aligned
+// - MASK (0x08):       the word address wraps in ADDR + (offset & MASK), MASK + 1 a power of 2
+// - COUNT (0x0C):      transactions of a run
+// - PERIOD (0x10):     a new transaction is due every PERIOD cycles (0 or 1: every cycle); the
+//                      due transactions wait their turn, at most OUTSTANDING of them on the bus
+// - HIST_SHIFT (0x14): latencies L are counted in the bin min(L >> HIST_SHIFT, NUM_BINS - 1)
+// - DONE (0x18):       completed transactions
+// - CYCLES (0x1C):     cycles from the start to the last response
+// - LAT_SUM (0x20):    sum of the latencies
+// - LAT_MAX (0x24):    highest latency
+// - HIST (0x40 + 4i):  latency histogram, NUM_BINS bins
+// The latency of a transaction is counted from the cycle it is due to the cycle of its rvalid, so
+// that it includes the wait for the grant when the bus is saturated. Writes write the address.
+
+module traffic_gen #(
+    parameter type reg_req_t = logic,
+    parameter type reg_rsp_t = logic,
+    parameter type obi_req_t = logic,
+    parameter type obi_resp_t = logic,
+    parameter int unsigned OUTSTANDING = 4,
+    parameter int unsigned NUM_BINS = 16
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input  reg_req_t reg_req_i,
+    output reg_rsp_t reg_rsp_o,
+
+    output obi_req_t  master_req_o,
+    input  obi_resp_t master_resp_i
+);
+
+  localparam logic [6:0] TRAFFIC_GEN_CTRL_OFFSET = 7'h00;
+  localparam logic [6:0] TRAFFIC_GEN_ADDR_OFFSET = 7'h04;
+  localparam logic [6:0] TRAFFIC_GEN_MASK_OFFSET = 7'h08;
+  localparam logic [6:0] TRAFFIC_GEN_COUNT_OFFSET = 7'h0C;
+  localparam logic [6:0] TRAFFIC_GEN_PERIOD_OFFSET = 7'h10;
+  localparam logic [6:0] TRAFFIC_GEN_HIST_SHIFT_OFFSET = 7'h14;
+  localparam logic [6:0] TRAFFIC_GEN_DONE_OFFSET = 7'h18;
+  localparam logic [6:0] TRAFFIC_GEN_CYCLES_OFFSET = 7'h1C;
+  localparam logic [6:0] TRAFFIC_GEN_LAT_SUM_OFFSET = 7'h20;
+  localparam logic [6:0] TRAFFIC_GEN_LAT_MAX_OFFSET = 7'h24;
+  localparam logic [6:0] TRAFFIC_GEN_HIST_OFFSET = 7'h40;
+
+  localparam int unsigned OutW = $clog2(OUTSTANDING + 1);
+  localparam int unsigned PtrW = OUTSTANDING > 1 ? $clog2(OUTSTANDING) : 1;
+  localparam int unsigned BinW = $clog2(NUM_BINS);
+
+  // Configuration
+  logic write_q, random_q;
+  logic [31:0] base_q, mask_q, count_q, period_q;
+  logic [4:0] hist_shift_q;
+
+  // Run
+  logic busy_q;
+  logic [31:0] cycle_q;  // cycles since the start
+  logic [31:0] tick_q;  // cycles until the next due transaction
+  logic [31:0] due_q;  // due transactions, issued or not
+  logic [31:0] issued_q;
+  logic [31:0] offset_q, lfsr_q;
+  logic [OutW-1:0] outstanding_q;
+
+  // Due cycle of each transaction, in the order of the issue
+  logic [31:0] due_cycle_q[OUTSTANDING];
+  logic [PtrW-1:0] wr_ptr_q, rd_ptr_q;
+
+  // Statistics
+  logic [31:0] done_q, cycles_q, lat_sum_q, lat_max_q;
+  logic [31:0] hist_q[NUM_BINS];
+
+  logic start, issue, retire, last_due;
+  logic [31:0] period, latency, word_offset, due_cycle_next;
+  logic [31:0] lat_bin;
+
+  assign start = reg_req_i.valid && reg_req_i.write && reg_req_i.addr[6:0] == TRAFFIC_GEN_CTRL_OFFSET &&
+      reg_req_i.wdata[0];
+
+  assign period = period_q == '0 ? 32'd1 : period_q;
+  assign last_due = due_q == count_q;
+
+  // A transaction is requested when it is due and there is room for its response
+  assign master_req_o.req = busy_q && issued_q != due_q && outstanding_q != OutW'(OUTSTANDING);
+  assign master_req_o.we = write_q;
+  assign master_req_o.be = 4'hF;
+  assign word_offset = (random_q ? lfsr_q : offset_q) & mask_q;
+  assign master_req_o.addr = base_q + {word_offset[29:0], 2'b00};
+  assign master_req_o.wdata = master_req_o.addr;
+
+  assign issue = master_req_o.req && master_resp_i.gnt;
+  assign retire = master_resp_i.rvalid && outstanding_q != '0;
+
+  // Due cycle of the transaction issued now: the (issued_q + 1)-th was due at (issued_q) * period
+  assign due_cycle_next = issued_q * period;
+
+  assign latency = cycle_q - due_cycle_q[rd_ptr_q];
+  assign lat_bin = latency >> hist_shift_q;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : config_regs
+    if (!rst_ni) begin
+      write_q      <= 1'b0;
+      random_q     <= 1'b0;
+      base_q       <= '0;
+      mask_q       <= '0;
+      count_q      <= '0;
+      period_q     <= '0;
+      hist_shift_q <= '0;
+    end else if (reg_req_i.valid && reg_req_i.write && !busy_q) begin
+      unique case (reg_req_i.addr[6:0])
+        TRAFFIC_GEN_CTRL_OFFSET: begin
+          write_q  <= reg_req_i.wdata[1];
+          random_q <= reg_req_i.wdata[2];
+        end
+        TRAFFIC_GEN_ADDR_OFFSET:       base_q <= {reg_req_i.wdata[31:2], 2'b00};
+        TRAFFIC_GEN_MASK_OFFSET:       mask_q <= reg_req_i.wdata;
+        TRAFFIC_GEN_COUNT_OFFSET:      count_q <= reg_req_i.wdata;
+        TRAFFIC_GEN_PERIOD_OFFSET:     period_q <= reg_req_i.wdata;
+        TRAFFIC_GEN_HIST_SHIFT_OFFSET: hist_shift_q <= reg_req_i.wdata[4:0];
+        default: ;
+      endcase
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin : run
+    if (!rst_ni) begin
+      busy_q        <= 1'b0;
+      cycle_q       <= '0;
+      tick_q        <= '0;
+      due_q         <= '0;
+      issued_q      <= '0;
+      offset_q      <= '0;
+      lfsr_q        <= 32'h1;
+      outstanding_q <= '0;
+      wr_ptr_q      <= '0;
+      rd_ptr_q      <= '0;
+      done_q        <= '0;
+      cycles_q      <= '0;
+      lat_sum_q     <= '0;
+      lat_max_q     <= '0;
+      for (int i = 0; i < OUTSTANDING; i++) due_cycle_q[i] <= '0;
+      for (int i = 0; i < NUM_BINS; i++) hist_q[i] <= '0;
+    end else if (start && !busy_q) begin
+      busy_q    <= count_q != '0;
+      cycle_q   <= '0;
+      // The first transaction is due at once
+      tick_q    <= period - 32'd1;
+      due_q     <= count_q != '0 ? 32'd1 : 32'd0;
+      issued_q  <= '0;
+      offset_q  <= '0;
+      done_q    <= '0;
+      cycles_q  <= '0;
+      lat_sum_q <= '0;
+      lat_max_q <= '0;
+      for (int i = 0; i < NUM_BINS; i++) hist_q[i] <= '0;
+    end else if (busy_q) begin
+      cycle_q <= cycle_q + 32'd1;
+
+      if (!last_due) begin
+        if (tick_q == '0) begin
+          due_q  <= due_q + 32'd1;
+          tick_q <= period - 32'd1;
+        end else begin
+          tick_q <= tick_q - 32'd1;
+        end
+      end
+
+      if (issue) begin
+        due_cycle_q[wr_ptr_q] <= due_cycle_next;
+        wr_ptr_q <= wr_ptr_q == PtrW'(OUTSTANDING - 1) ? '0 : wr_ptr_q + 1'b1;
+        issued_q <= issued_q + 32'd1;
+        offset_q <= offset_q + 32'd1;
+        // Galois LFSR x^32 + x^22 + x^2 + x + 1
+        lfsr_q <= {1'b0, lfsr_q[31:1]} ^ (lfsr_q[0] ? 32'h80200003 : 32'h0);
+      end
+
+      if (retire) begin
+        rd_ptr_q  <= rd_ptr_q == PtrW'(OUTSTANDING - 1) ? '0 : rd_ptr_q + 1'b1;
+        done_q    <= done_q + 32'd1;
+        lat_sum_q <= lat_sum_q + latency;
+        if (latency > lat_max_q) lat_max_q <= latency;
+        if (lat_bin >= NUM_BINS) hist_q[NUM_BINS-1] <= hist_q[NUM_BINS-1] + 32'd1;
+        else hist_q[lat_bin[BinW-1:0]] <= hist_q[lat_bin[BinW-1:0]] + 32'd1;
+        if (done_q + 32'd1 == count_q) begin
+          busy_q   <= 1'b0;
+          cycles_q <= cycle_q + 32'd1;
+        end
+      end
+
+      outstanding_q <= outstanding_q + OutW'(issue) - OutW'(retire);
+    end
+  end
+
+  assign reg_rsp_o.ready = 1'b1;
+  assign reg_rsp_o.error = 1'b0;
+
+  always_comb begin
+    reg_rsp_o.rdata = '0;
+    if (reg_req_i.addr[6:0] >= TRAFFIC_GEN_HIST_OFFSET &&
+        reg_req_i.addr[5:2] < NUM_BINS) begin
+      reg_rsp_o.rdata = hist_q[reg_req_i.addr[5:2]];
+    end else begin
+      unique case (reg_req_i.addr[6:0])
+        TRAFFIC_GEN_CTRL_OFFSET:       reg_rsp_o.rdata = {29'b0, random_q, write_q, busy_q};
+        TRAFFIC_GEN_ADDR_OFFSET:       reg_rsp_o.rdata = base_q;
+        TRAFFIC_GEN_MASK_OFFSET:       reg_rsp_o.rdata = mask_q;
+        TRAFFIC_GEN_COUNT_OFFSET:      reg_rsp_o.rdata = count_q;
+        TRAFFIC_GEN_PERIOD_OFFSET:     reg_rsp_o.rdata = period_q;
+        TRAFFIC_GEN_HIST_SHIFT_OFFSET: reg_rsp_o.rdata = {27'b0, hist_shift_q};
+        TRAFFIC_GEN_DONE_OFFSET:       reg_rsp_o.rdata = done_q;
+        TRAFFIC_GEN_CYCLES_OFFSET:     reg_rsp_o.rdata = cycles_q;
+        TRAFFIC_GEN_LAT_SUM_OFFSET:    reg_rsp_o.rdata = lat_sum_q;
+        TRAFFIC_GEN_LAT_MAX_OFFSET:    reg_rsp_o.rdata = lat_max_q;
+        default:                       reg_rsp_o.rdata = '0;
+      endcase
+    end
+  end
+
+endmodule  // traffic_gen
@@ -0,0 +1,218 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// Reference SIMD/MAC coprocessor on the CORE-V eXtension Interface. It takes
+// the custom-0 instructions below from the cv32e40x/cv32e40px, computes them
+// from their register operands and writes rd back once they are committed, so
+// an offloaded instruction costs no load or store. One instruction is in
+// flight at a time. See sw/device/lib/sdk/xif_mac/xif_mac.h for the
+// intrinsics.
+//
+// Instructions (opcode custom-0 = 7'b0001011):
+//   R-type, funct3 = 0, SIMD on bytes (b) or half words (h), wrapping:
+//     funct7 0 xmac.add4b, 1 xmac.sub4b, 2 xmac.add2h, 3 xmac.sub2h,
+//            4 xmac.max4b, 5 xmac.min4b (signed)
+//   R-type, funct3 = 1, dot products:
+//     funct7 0 xmac.dot4b (signed), 1 xmac.dotu4b (unsigned), 2 xmac.dot2h (signed)
+//   R4-type, funct3 = 2, rd = rs3 + ..., funct2 (bits 26:25):
+//     0 xmac.mac4b: rs3 + signed dot4b, 1 xmac.macu4b: rs3 + unsigned dot4b,
+//     2 xmac.mac2h: rs3 + signed dot2h, 3 xmac.mac: rs3 + rs1 * rs2
+
+module xif_mac (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // eXtension interface
+    if_xif.coproc_compressed xif_compressed_if,
+    if_xif.coproc_issue      xif_issue_if,
+    if_xif.coproc_commit     xif_commit_if,
+    if_xif.coproc_mem        xif_mem_if,
+    if_xif.coproc_mem_result xif_mem_result_if,
+    if_xif.coproc_result     xif_result_if
+);
+
+  localparam logic [6:0] OpcodeCustom0 = 7'b0001011;
+
+  typedef enum logic [1:0] {
+    MAC_EMPTY,
+    MAC_ISSUED,
+    MAC_COMMITTED
+  } mac_state_e;
+
+  mac_state_e state_q, state_d;
+
+  logic [31:0] instr;
+  logic [6:0] opcode, funct7;
+  logic [2:0] funct3;
+  logic [1:0] funct2;
+  logic [31:0] rs1, rs2, rs3;
+
+  logic supported, needs_rs3, operands_valid;
+  logic issue_accept;
+  logic [31:0] result;
+
+  logic [$bits(xif_issue_if.issue_req.id)-1:0] id_q;
+  logic [4:0] rd_q;
+  logic [31:0] result_q;
+
+  logic commit_now, kill_now;
+
+  assign instr  = xif_issue_if.issue_req.instr;
+  assign opcode = instr[6:0];
+  assign funct3 = instr[14:12];
+  assign funct7 = instr[31:25];
+  assign funct2 = instr[26:25];
+  assign rs1    = xif_issue_if.issue_req.rs[0];
+  assign rs2    = xif_issue_if.issue_req.rs[1];
+  assign rs3    = xif_issue_if.issue_req.rs[2];
+
+  // Decoder
+  always_comb begin
+    supported = 1'b0;
+    needs_rs3 = 1'b0;
+    if (opcode == OpcodeCustom0) begin
+      case (funct3)
+        3'd0: supported = funct7 <= 7'd5;
+        3'd1: supported = funct7 <= 7'd2;
+        3'd2: begin
+          supported = 1'b1;
+          needs_rs3 = 1'b1;
+        end
+        default: supported = 1'b0;
+      endcase
+    end
+  end
+
+  assign operands_valid = xif_issue_if.issue_req.rs_valid[0] && xif_issue_if.issue_req.rs_valid[1] &&
+      (!needs_rs3 || xif_issue_if.issue_req.rs_valid[2]);
+
+  // Datapath
+  function automatic logic [31:0] dot4b(logic [31:0] a, logic [31:0] b, logic is_signed);
+    logic [31:0] sum;
+    sum = '0;
+    for (int i = 0; i < 4; i++) begin
+      if (is_signed) begin
+        sum += 32'($signed(a[8*i+:8]) * $signed(b[8*i+:8]));
+      end else begin
+        sum += 32'(a[8*i+:8] * b[8*i+:8]);
+      end
+    end
+    return sum;
+  endfunction
+
+  function automatic logic [31:0] dot2h(logic [31:0] a, logic [31:0] b);
+    return 32'($signed(a[15:0]) * $signed(b[15:0])) + 32'($signed(a[31:16]) * $signed(b[31:16]));
+  endfunction
+
+  always_comb begin
+    result = '0;
+    case (funct3)
+      3'd0: begin
+        for (int i = 0; i < 4; i++) begin
+          case (funct7)
+            7'd0: result[8*i+:8] = rs1[8*i+:8] + rs2[8*i+:8];
+            7'd1: result[8*i+:8] = rs1[8*i+:8] - rs2[8*i+:8];
+            7'd4:
+            result[8*i+:8] = $signed(rs1[8*i+:8]) > $signed(rs2[8*i+:8]) ? rs1[8*i+:8] : rs2[8*i+:8];
+            7'd5:
+            result[8*i+:8] = $signed(rs1[8*i+:8]) < $signed(rs2[8*i+:8]) ? rs1[8*i+:8] : rs2[8*i+:8];
+            default: ;
+          endcase
+        end
+        if (funct7 == 7'd2) result = {rs1[31:16] + rs2[31:16], rs1[15:0] + rs2[15:0]};
+        if (funct7 == 7'd3) result = {rs1[31:16] - rs2[31:16], rs1[15:0] - rs2[15:0]};
+      end
+      3'd1: begin
+        case (funct7)
+          7'd0: result = dot4b(rs1, rs2, 1'b1);
+          7'd1: result = dot4b(rs1, rs2, 1'b0);
+          default: result = dot2h(rs1, rs2);
+        endcase
+      end
+      default: begin
+        case (funct2)
+          2'd0: result = rs3 + dot4b(rs1, rs2, 1'b1);
+          2'd1: result = rs3 + dot4b(rs1, rs2, 1'b0);
+          2'd2: result = rs3 + dot2h(rs1, rs2);
+          default: result = rs3 + rs1 * rs2;
+        endcase
+      end
+    endcase
+  end
+
+  // Issue: a supported instruction waits for its operands and a free slot,
+  // the others are refused at once
+  assign issue_accept = xif_issue_if.issue_valid && xif_issue_if.issue_ready && supported;
+
+  assign xif_issue_if.issue_ready = !supported || (state_q == MAC_EMPTY && operands_valid);
+  assign xif_issue_if.issue_resp.accept = supported;
+  assign xif_issue_if.issue_resp.writeback = supported;
+  assign xif_issue_if.issue_resp.dualwrite = 1'b0;
+  assign xif_issue_if.issue_resp.dualread = '0;
+  assign xif_issue_if.issue_resp.loadstore = 1'b0;
+  assign xif_issue_if.issue_resp.ecswrite = 1'b0;
+  assign xif_issue_if.issue_resp.exc = 1'b0;
+
+  // Commit, possibly in the cycle of the issue
+  assign commit_now = xif_commit_if.commit_valid && xif_commit_if.commit.id ==
+      (issue_accept ? xif_issue_if.issue_req.id : id_q);
+  assign kill_now = commit_now && xif_commit_if.commit.commit_kill;
+
+  always_comb begin
+    state_d = state_q;
+    case (state_q)
+      MAC_EMPTY: begin
+        if (issue_accept) begin
+          if (kill_now) state_d = MAC_EMPTY;
+          else if (commit_now) state_d = MAC_COMMITTED;
+          else state_d = MAC_ISSUED;
+        end
+      end
+      MAC_ISSUED: begin
+        if (kill_now) state_d = MAC_EMPTY;
+        else if (commit_now) state_d = MAC_COMMITTED;
+      end
+      MAC_COMMITTED: begin
+        if (xif_result_if.result_ready) state_d = MAC_EMPTY;
+      end
+      default: state_d = MAC_EMPTY;
+    endcase
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (~rst_ni) begin
+      state_q  <= MAC_EMPTY;
+      id_q     <= '0;
+      rd_q     <= '0;
+      result_q <= '0;
+    end else begin
+      state_q <= state_d;
+      if (issue_accept) begin
+        id_q     <= xif_issue_if.issue_req.id;
+        rd_q     <= instr[11:7];
+        result_q <= result;
+      end
+    end
+  end
+
+  // Result
+  assign xif_result_if.result_valid = state_q == MAC_COMMITTED;
+  assign xif_result_if.result.id = id_q;
+  assign xif_result_if.result.data = result_q;
+  assign xif_result_if.result.rd = rd_q;
+  assign xif_result_if.result.we = '1;
+  assign xif_result_if.result.ecsdata = '0;
+  assign xif_result_if.result.ecswe = '0;
+  assign xif_result_if.result.exc = 1'b0;
+  assign xif_result_if.result.exccode = '0;
+  assign xif_result_if.result.err = 1'b0;
+  assign xif_result_if.result.dbg = 1'b0;
+
+  // No compressed instructions nor memory accesses
+  assign xif_compressed_if.compressed_ready = 1'b1;
+  assign xif_compressed_if.compressed_resp = '0;
+  assign xif_mem_if.mem_valid = 1'b0;
+  assign xif_mem_if.mem_req = '0;
+
+endmodule
@@ -50,6 +50,8 @@ module x_heep_system
 
     input logic ext_dma_slot_tx_i,
     input logic ext_dma_slot_rx_i,
+    input logic ext_dma_slot_acc_tx_i,
+    input logic ext_dma_slot_acc_rx_i,
 
     // eXtension interface
     if_xif.cpu_compressed xif_compressed_if,
@@ -142,7 +144,9 @@ ${pad.core_v_mini_mcu_bonding}
     .external_subsystem_clkgate_en_no,
     .exit_value_o,
     .ext_dma_slot_tx_i,
-    .ext_dma_slot_rx_i
+    .ext_dma_slot_rx_i,
+    .ext_dma_slot_acc_tx_i,
+    .ext_dma_slot_acc_rx_i
   );
 
   pad_ring pad_ring_i (
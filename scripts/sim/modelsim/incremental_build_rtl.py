@@ -0,0 +1,171 @@
+# Copyright EPFL contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# FuseSoC wipes the work root at each build, so that Questasim recompiled the
+# whole design every time. This keeps the libraries in XHEEP_SIM_LIB_DIR
+# (build/sim_lib by default) instead:
+#  - the vendored IP (hw/vendor), i.e. the leading vlog commands of
+#    edalize_build_rtl.tcl that compile files of hw/vendor, goes in the library
+#    xheep_vendor, compiled once per content of the *.lock.hjson files, of the
+#    compiled files and of the options, and shared by all the builds,
+#  - the rest, the X-HEEP units, goes in a persistent work library, one per set
+#    of vlog commands (i.e. per configuration), compiled with -incr so that only
+#    the changed units are compiled again, and vopt runs only when it changed.
+# Runs after patch_modelsim_Makefile.py, whose Makefile it extends.
+
+import glob
+import hashlib
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+ROOT = os.path.abspath(os.path.join("..", "..", ".."))
+VENDOR_DIR = os.path.join(ROOT, "hw", "vendor") + os.sep
+LIB_DIR = os.path.abspath(
+    os.environ.get("XHEEP_SIM_LIB_DIR", os.path.join(ROOT, "build", "sim_lib"))
+)
+VENDOR_LIB = "xheep_vendor"
+BUILD_TCL = "edalize_build_rtl.tcl"
+
+
+def vlog_tokens(line):
+    try:
+        tokens = shlex.split(line)
+    except ValueError:
+        return None
+    if not tokens or tokens[0] != "vlog":
+        return None
+    return tokens
+
+
+def is_vendor(line):
+    tokens = vlog_tokens(line)
+    return tokens is not None and os.path.abspath(tokens[-1]).startswith(VENDOR_DIR)
+
+
+def hash_file(h, path):
+    h.update(path.encode())
+    try:
+        with open(path, "rb") as f:
+            h.update(f.read())
+    except OSError:
+        pass
+
+
+def tool_version():
+    vlog = os.path.join(os.environ.get("MODEL_TECH", ""), "vlog")
+    try:
+        return subprocess.run(
+            [vlog, "-version"], capture_output=True, text=True
+        ).stdout.strip()
+    except OSError:
+        return ""
+
+
+def vendor_key(lines):
+    h = hashlib.sha256()
+    h.update(tool_version().encode())
+    for lock in sorted(glob.glob(os.path.join(ROOT, "hw", "vendor", "*.lock.hjson"))):
+        hash_file(h, lock)
+    incdirs = set()
+    for line in lines:
+        h.update(line.encode())
+        tokens = vlog_tokens(line)
+        if tokens is None:
+            continue
+        # The vendored files are hashed as well, as some of them are patched
+        # locally and the lock files do not see it
+        hash_file(h, os.path.abspath(tokens[-1]))
+        incdirs.update(t[len("+incdir+") :] for t in tokens if t.startswith("+incdir+"))
+    for incdir in sorted(incdirs):
+        for header in sorted(glob.glob(os.path.join(incdir, "*.*h"))):
+            hash_file(h, os.path.abspath(header))
+    return h.hexdigest()[:16]
+
+
+def work_key(vendor, lines):
+    h = hashlib.sha256()
+    h.update(vendor.encode())
+    for line in lines:
+        h.update(line.encode())
+    return h.hexdigest()[:16]
+
+
+with open(BUILD_TCL, "r") as f:
+    lines = f.readlines()
+
+# Only the default work library is handled, otherwise the build is left as is
+libs = {l.split()[1] for l in lines if l.startswith("vlib ")}
+if libs != {"work"}:
+    print("incremental_build_rtl: libraries %s, full build" % sorted(libs))
+    sys.exit(0)
+
+compile_lines = [l for l in lines if not l.startswith("vlib ")]
+prefix = 0
+while prefix < len(compile_lines) and (
+    is_vendor(compile_lines[prefix]) or vlog_tokens(compile_lines[prefix]) is None
+):
+    prefix += 1
+vendor_lines = compile_lines[:prefix]
+xheep_lines = compile_lines[prefix:]
+
+vendor = vendor_key(vendor_lines)
+vendor_dir = os.path.join(LIB_DIR, "vendor_" + vendor)
+work_dir = os.path.join(LIB_DIR, "work_" + work_key(vendor, xheep_lines))
+work_re = re.compile(r"-work\s+work\b")
+
+os.rename(BUILD_TCL, BUILD_TCL + ".orig")
+with open(BUILD_TCL, "w") as out:
+    out.write("file mkdir {%s}\n" % LIB_DIR)
+    if vendor_lines:
+        # Compiled aside and renamed, so that an interrupted compilation is
+        # not taken for a complete library
+        tmp = "%s.%d" % (vendor_dir, os.getpid())
+        out.write("if {![file isdirectory {%s}]} {\n" % vendor_dir)
+        out.write("  file delete -force {%s}\n" % tmp)
+        out.write("  vlib {%s}\n" % tmp)
+        for line in vendor_lines:
+            out.write("  " + work_re.sub("-work {%s}" % tmp, line.rstrip("\n")) + "\n")
+        out.write("  file rename {%s} {%s}\n" % (tmp, vendor_dir))
+        out.write("}\n")
+        out.write("vmap %s {%s}\n" % (VENDOR_LIB, vendor_dir))
+    out.write("if {![file isdirectory {%s}]} {\n" % work_dir)
+    out.write("  vlib {%s}\n" % work_dir)
+    out.write("}\n")
+    out.write("vmap work {%s}\n" % work_dir)
+    for line in xheep_lines:
+        if vlog_tokens(line) is not None:
+            options = "-incr"
+            if vendor_lines:
+                options += " -L " + VENDOR_LIB
+            line = "vlog " + options + line[len("vlog") :]
+        out.write(line)
+
+# The simulation and vopt search the vendor library, vopt runs again only when
+# the work library changed
+lib_options = " -L " + VENDOR_LIB if vendor_lines else ""
+vopt_stamp = os.path.join(work_dir, "vopt.stamp")
+
+os.rename("Makefile", "Makefile.noincr")
+fileIn = open("Makefile.noincr", "r")
+fileOut = open("Makefile", "w")
+
+for line in fileIn:
+    if line.startswith("EXTRA_OPTIONS ?="):
+        line = line.rstrip("\n") + lib_options + "\n"
+    elif line == "opt:\n":
+        line = "opt: " + vopt_stamp + "\n\n" + vopt_stamp + ": " + os.path.join(work_dir, "_info") + "\n"
+    elif line.startswith("\t$(VOPT) -work work"):
+        line = line.replace("$(VOPT) -work work", "$(VOPT) -work work" + lib_options)
+        if "-pa_upf" in line:
+            # opt-upf writes the same optimized design as opt
+            line = "\trm -f " + vopt_stamp + "\n" + line
+        else:
+            line = line + "\ttouch $@\n"
+    fileOut.write(line)
+
+fileIn.close()
+fileOut.close()
@@ -0,0 +1,42 @@
+# Copyright EPFL contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# FuseSoC wipes the work root at each build, with the csrc folder where VCS
+# keeps the compiled modules, so that VCS recompiled the whole design every
+# time. This moves csrc to XHEEP_SIM_LIB_DIR (build/sim_lib by default), one
+# per set of options and files (i.e. per configuration), where the incremental
+# compilation of VCS (-Mupdate) compiles again only the changed modules. The
+# vendored IP, unchanged between the builds, is not compiled again.
+
+import hashlib
+import os
+
+ROOT = os.path.abspath(os.path.join("..", "..", ".."))
+LIB_DIR = os.path.abspath(
+    os.environ.get("XHEEP_SIM_LIB_DIR", os.path.join(ROOT, "build", "sim_lib"))
+)
+
+# The edalize command line and file list, the .scr files
+h = hashlib.sha256()
+for name in sorted(os.listdir(".")):
+    if name.endswith(".scr"):
+        with open(name, "rb") as f:
+            h.update(f.read())
+
+os.rename("Makefile", "Makefile.noincr")
+
+fileIn = open("Makefile.noincr", "r")
+fileOut = open("Makefile", "w")
+
+for line in fileIn:
+    if "$(EDALIZE_LAUNCHER) vcs" in line:
+        h.update(line.encode())
+        mdir = os.path.join(LIB_DIR, "vcs_" + h.hexdigest()[:16])
+        os.makedirs(mdir, exist_ok=True)
+        line = line[:-1] + " -Mupdate -Mdir=" + mdir + "\n"
+    fileOut.write(line)
+
+# closing text file
+fileIn.close()
+fileOut.close()
@@ -35,6 +35,7 @@ Original Author: Shay Gal-on
 
 #include "csr.h"
 #include "x-heep.h"
+#include "ram_bank.h"
 
 #include "coremark.h"
 
@@ -63,10 +64,22 @@ volatile ee_s32 seed5_volatile = 0;
 void
 portable_init(core_portable *p, int *argc, char *argv[])
 {
-    // Don't need to do anything here atm.
+    volatile int stack_var;
+
     (void)p;
     (void)argc;
     (void)argv;
+
+    // The fetches only run in parallel with the data accesses from another
+    // bank (see configs/coremark.hjson and the NtoM bus)
+    ee_printf("Code bank        : %d\n", ram_bank_of((const void *)portable_init));
+    ee_printf("Data bank        : %d\n", ram_bank_of((const void *)&seed1_volatile));
+    ee_printf("Stack bank       : %d\n", ram_bank_of((const void *)&stack_var));
+#ifdef COREMARK_TUNED
+    ee_printf("Build            : tuned\n");
+#else
+    ee_printf("Build            : base\n");
+#endif
 }
 
 void
@@ -0,0 +1,76 @@
+/*
+**
+** Copyright 2020 OpenHW Group
+** 
+** Licensed under the Solderpad Hardware Licence, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+** 
+**     https://solderpad.org/licenses/
+** 
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+** 
+*******************************************************************************
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "support.h"
+#include "csr.h"
+#include "x-heep.h"
+
+#define FS_INITIAL 0x01
+
+uint64_t embench_cycles;
+
+static uint64_t
+read_mcycle64 (void)
+{
+  uint32_t lo, hi, hi2;
+
+  /* mcycleh is read again in case mcycle overflowed in between */
+  do
+    {
+      CSR_READ (CSR_REG_MCYCLEH, &hi);
+      CSR_READ (CSR_REG_MCYCLE, &lo);
+      CSR_READ (CSR_REG_MCYCLEH, &hi2);
+    }
+  while (hi != hi2);
+
+  return ((uint64_t) hi << 32) | lo;
+}
+
+void
+initialise_board ()
+{
+  /* enable FP operations */
+  CSR_SET_BITS (CSR_REG_MSTATUS, (FS_INITIAL << 13));
+}
+
+void __attribute__ ((noinline)) __attribute__ ((externally_visible))
+start_trigger ()
+{
+  /* Enable the mcycle counter, the benchmark is timed from here */
+  CSR_CLEAR_BITS (CSR_REG_MCOUNTINHIBIT, 0x1);
+  embench_cycles = read_mcycle64 ();
+}
+
+void __attribute__ ((noinline)) __attribute__ ((externally_visible))
+stop_trigger ()
+{
+  embench_cycles = read_mcycle64 () - embench_cycles;
+
+  /* Read by util/embench.py, after the timed part. The printf of newlib
+     nano has no %llu. */
+  if (embench_cycles < 1000000000)
+    printf ("Embench cycles: %lu\n", (unsigned long) embench_cycles);
+  else
+    printf ("Embench cycles: %lu%09lu\n",
+            (unsigned long) (embench_cycles / 1000000000),
+            (unsigned long) (embench_cycles % 1000000000));
+}
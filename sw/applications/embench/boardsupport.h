@@ -0,0 +1,35 @@
+/*
+**
+** Copyright 2020 OpenHW Group
+** 
+** Licensed under the Solderpad Hardware Licence, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+** 
+**     https://solderpad.org/licenses/
+** 
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+** 
+*******************************************************************************
+*/
+
+#ifndef BOARDSUPPORT_H
+#define BOARDSUPPORT_H
+
+#include <stdint.h>
+
+/* The benchmarks scale their work with CPU_MHZ to run for about the same
+   time on any clock. With 1, the cycles reported by stop_trigger () are the
+   time at 1 MHz. */
+
+#define CPU_MHZ 1
+
+/* Cycles between start_trigger () and stop_trigger (), counted by mcycle */
+
+extern uint64_t embench_cycles;
+
+#endif /* BOARDSUPPORT_H */
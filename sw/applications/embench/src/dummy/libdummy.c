@@ -0,0 +1,33 @@
+/* Dummy benchmark
+
+   Copyright 2024 EPFL
+   Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+   SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1 */
+
+/* An empty benchmark with the same main, board support and libraries as the
+   others: util/embench.py subtracts its size from the size of each benchmark,
+   which leaves the code of the benchmark.  */
+
+#include "support.h"
+
+void
+initialise_benchmark (void)
+{
+}
+
+void
+warm_caches (int heat __attribute__ ((unused)))
+{
+}
+
+int __attribute__ ((noinline))
+benchmark (void)
+{
+  return 0;
+}
+
+int
+verify_benchmark (int res __attribute__ ((unused)))
+{
+  return 1;
+}
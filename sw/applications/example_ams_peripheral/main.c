@@ -7,8 +7,7 @@
 
 #include "core_v_mini_mcu.h"
 #include "x-heep.h"
-#include "ams_regs.h"
-#include "mmio.h"
+#include "ams.h"
 
 #ifdef TARGET_PYNQ_Z2
   #error ( "This app does NOT work on the FPGA as it relies on the simulator testbench" )
@@ -16,28 +15,25 @@
 
 int main(int argc, char *argv[])
 {
-        unsigned int AMS_START_ADDRESS = EXT_PERIPHERAL_START_ADDRESS + 0x1000;
-        mmio_region_t ams_base_addr = mmio_region_from_addr((uintptr_t)AMS_START_ADDRESS);
-
         printf("0");
-        mmio_region_write32(ams_base_addr, AMS_SEL_REG_OFFSET, 0);
+        ams_set_threshold(AMS_THRESHOLD_20);
 
         printf("1");
-        mmio_region_write32(ams_base_addr, AMS_SEL_REG_OFFSET, 1);
+        ams_set_threshold(AMS_THRESHOLD_40);
 
         for (int i = 0 ; i < 10000 ; i++) {
                 asm volatile ("nop");
         }
 
         printf("2");
-        mmio_region_write32(ams_base_addr, AMS_SEL_REG_OFFSET, 2);
+        ams_set_threshold(AMS_THRESHOLD_60);
 
         for (int i = 0 ; i < 10000 ; i++) {
                 asm volatile ("nop");
         }
 
         printf("3");
-        mmio_region_write32(ams_base_addr, AMS_SEL_REG_OFFSET, 3);
+        ams_set_threshold(AMS_THRESHOLD_80);
 
 
         printf("END\n");
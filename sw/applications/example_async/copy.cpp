@@ -0,0 +1,31 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+extern "C" {
+    #include "dma_sdk.h"
+}
+#include "async.hpp"
+#include "copy.h"
+
+static xheep::task copy(uint32_t *dst, uint32_t *src, uint32_t words, uint32_t chunks,
+                        async_future_t *filled)
+{
+    co_await xheep::wait(filled);
+
+    // The local variables live in the frame of the coroutine
+    uint32_t size = words / chunks;
+    async_future_t done;
+    for (uint32_t i = 0; i < chunks; i++)
+    {
+        async_future_init(&done);
+        dma_copy_32b_async(dst + i * size, src + i * size, size, async_future_callback, &done);
+        co_await xheep::wait(&done);
+    }
+}
+
+int spawn_copy(uint32_t *dst, uint32_t *src, uint32_t words, uint32_t chunks,
+               async_future_t *filled)
+{
+    return xheep::spawn(copy(dst, src, words, chunks, filled)) ? 0 : -1;
+}
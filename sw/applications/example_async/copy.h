@@ -0,0 +1,28 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef COPY_H_
+#define COPY_H_
+
+#include <stdint.h>
+#include "async.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Spawns a coroutine copying the words of src to dst in chunks, once the
+ * future filled is completed.
+ *
+ * @return 0, or -1 if the coroutine could not be allocated.
+ */
+int spawn_copy(uint32_t *dst, uint32_t *src, uint32_t words, uint32_t chunks,
+               async_future_t *filled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // COPY_H_
@@ -0,0 +1,91 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: main.c
+// Description: Example application of the cooperative executor of
+//              device/lib/runtime/async.h. A C task fills a buffer with DMA
+//              fills, one chunk after the other, and a C++ coroutine
+//              (copy.cpp) waits for the end of the fill before copying the
+//              buffer with DMA copies. The CPU sleeps while the DMA works.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "async.h"
+#include "dma_sdk.h"
+#include "core_v_mini_mcu.h"
+#include "x-heep.h"
+#include "copy.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define BUFFER_SIZE_32b  256
+#define CHUNKS           4
+#define CONST_VALUE      123
+
+static uint32_t source[BUFFER_SIZE_32b];
+static uint32_t destin[BUFFER_SIZE_32b];
+
+// The data of the task, kept between its runs
+typedef struct {
+    async_task_t task;
+    async_future_t chunk_done;
+    async_future_t *filled;
+    uint32_t chunk;
+} fill_t;
+
+static void fill_task(async_task_t *task)
+{
+    fill_t *fill = (fill_t *)task->arg;
+    static uint32_t value = CONST_VALUE;
+
+    ASYNC_BEGIN(task);
+    for (fill->chunk = 0; fill->chunk < CHUNKS; fill->chunk++)
+    {
+        async_future_init(&fill->chunk_done);
+        dma_fill_async(&source[fill->chunk * BUFFER_SIZE_32b / CHUNKS], &value,
+                       BUFFER_SIZE_32b / CHUNKS, async_future_callback, &fill->chunk_done);
+        ASYNC_AWAIT(task, &fill->chunk_done);
+    }
+    async_future_complete(fill->filled, 0);
+    ASYNC_END(task);
+}
+
+int main()
+{
+    static fill_t fill;
+    static async_future_t filled;
+
+    async_future_init(&filled);
+    fill.filled = &filled;
+    async_task_init(&fill.task, fill_task, &fill);
+    async_spawn(&fill.task);
+
+    if (spawn_copy(destin, source, BUFFER_SIZE_32b, CHUNKS, &filled) != 0)
+    {
+        PRINTF("The coroutine could not be allocated\n\r");
+        return EXIT_FAILURE;
+    }
+
+    async_run();
+
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < BUFFER_SIZE_32b; i++)
+    {
+        errors += destin[i] != CONST_VALUE;
+    }
+
+    PRINTF("Errors:%d\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Contention of the external masters with the core and the DMA for
+ *        the RAM banks, with the two traffic generators of the testharness
+ *        (traffic_gen.h). The generators read and write at a rate swept from
+ *        back to back to one word every 8 cycles, alone and while the DMA
+ *        copies a buffer and the core loads from RAM. For each rate, the
+ *        bandwidth achieved by each generator and its latency percentiles are
+ *        printed with the cycles of the DMA and of the core, and the rate is
+ *        flagged when a generator gets less than 95% of what it asks: the bus
+ *        is saturated there. Needs the external peripheral example of the
+ *        testharness (simulation only).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "dma_sdk.h"
+#include "ram_bank.h"
+#include "traffic_gen.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define GEN_WORDS   1024
+#define GEN_COUNT   1024
+#define DMA_WORDS   1024
+#define PROBE_WORDS 256
+
+static uint32_t gen_src[GEN_WORDS];
+static uint32_t gen_dst[GEN_WORDS];
+static uint32_t dma_src[DMA_WORDS];
+static uint32_t dma_dst[DMA_WORDS];
+static uint32_t probe[PROBE_WORDS];
+
+static const uint32_t periods[] = {1, 2, 3, 4, 6, 8};
+
+#define NUM_PERIODS (sizeof(periods) / sizeof(periods[0]))
+
+// Cycles of PROBE_WORDS dependent loads, so that each one waits for the bus
+static uint32_t __attribute__((noinline)) probe_loads(void)
+{
+    volatile uint32_t *p = probe;
+    uint32_t idx = 0, cycles;
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    for (uint32_t i = 0; i < PROBE_WORDS; i++)
+    {
+        idx = p[idx];
+    }
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return idx == 0 ? cycles : 0;
+}
+
+// Returns 1 when the generator did not get 95% of the words it asked for
+static int report(const char *name, const traffic_gen_stats_t *stats, uint32_t period)
+{
+    uint32_t bandwidth = traffic_gen_bandwidth(stats);
+    uint32_t offered = 100 / period;
+
+    PRINTF("  %-6s %3u/%3u words/100 cycles, latency avg %u p50 %u p90 %u p99 %u max %u\n\r",
+           name, bandwidth, offered, stats->done ? stats->lat_sum / stats->done : 0,
+           traffic_gen_percentile(stats, 50), traffic_gen_percentile(stats, 90),
+           traffic_gen_percentile(stats, 99), stats->lat_max);
+    return bandwidth * 100 < offered * 95;
+}
+
+static int run(uint32_t period, int with_cpu_dma)
+{
+    traffic_gen_cfg_t cfg[TRAFFIC_GEN_NUM] = {
+        {
+            .addr = (uint32_t)gen_src,
+            .words = GEN_WORDS,
+            .count = GEN_COUNT,
+            .period = period,
+            .write = false,
+            .random = false,
+            .hist_shift = 0,
+        },
+        {
+            .addr = (uint32_t)gen_dst,
+            .words = GEN_WORDS,
+            .count = GEN_COUNT,
+            .period = period,
+            .write = true,
+            .random = true,
+            .hist_shift = 0,
+        },
+    };
+    traffic_gen_stats_t stats[TRAFFIC_GEN_NUM];
+    dma_sdk_ticket_t ticket = -1;
+    uint32_t dma_cycles = 0, probe_cycles = 0;
+    int saturated = 0;
+
+    for (uint32_t i = 0; i < TRAFFIC_GEN_NUM; i++)
+    {
+        traffic_gen_config(i, &cfg[i]);
+    }
+    for (uint32_t i = 0; i < TRAFFIC_GEN_NUM; i++)
+    {
+        traffic_gen_start(i, &cfg[i]);
+    }
+
+    if (with_cpu_dma)
+    {
+        CSR_WRITE(CSR_REG_MCYCLE, 0);
+        ticket = dma_copy_32b_async(dma_dst, dma_src, DMA_WORDS, NULL, NULL);
+        dma_sdk_wait(ticket);
+        CSR_READ(CSR_REG_MCYCLE, &dma_cycles);
+        probe_cycles = probe_loads();
+    }
+
+    for (uint32_t i = 0; i < TRAFFIC_GEN_NUM; i++)
+    {
+        traffic_gen_wait(i);
+        traffic_gen_read_stats(i, &stats[i]);
+    }
+
+    PRINTF("period %u%s\n\r", period, with_cpu_dma ? ", with the DMA and the core" : "");
+    saturated |= report("read", &stats[0], period);
+    saturated |= report("write", &stats[1], period);
+    if (with_cpu_dma)
+    {
+        PRINTF("  DMA copy of %u words %u cycles, %u core loads %u cycles\n\r",
+               DMA_WORDS, dma_cycles, PROBE_WORDS, probe_cycles);
+    }
+    if (saturated)
+    {
+        PRINTF("  saturated\n\r");
+    }
+    return saturated;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+    int last_saturated = -1;
+    int last_saturated_loaded = -1;
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    for (uint32_t i = 0; i < GEN_WORDS; i++)
+    {
+        gen_src[i] = i;
+    }
+    for (uint32_t i = 0; i < DMA_WORDS; i++)
+    {
+        dma_src[i] = i;
+    }
+    // Every load reads the index 0 of the next one
+    for (uint32_t i = 0; i < PROBE_WORDS; i++)
+    {
+        probe[i] = 0;
+    }
+
+    PRINTF("Generators in banks 0x%x, DMA in banks 0x%x, core loads in banks 0x%x\n\r",
+           ram_banks_of(gen_src, sizeof(gen_src)) | ram_banks_of(gen_dst, sizeof(gen_dst)),
+           ram_banks_of(dma_src, sizeof(dma_src)) | ram_banks_of(dma_dst, sizeof(dma_dst)),
+           ram_banks_of(probe, sizeof(probe)));
+    PRINTF("Core loads alone: %u cycles\n\r", probe_loads());
+
+    // From the highest rate to the lowest, the last saturated rate is kept
+    for (uint32_t i = 0; i < NUM_PERIODS; i++)
+    {
+        if (run(periods[i], 0))
+        {
+            last_saturated = i;
+        }
+        if (run(periods[i], 1))
+        {
+            last_saturated_loaded = i;
+        }
+    }
+
+    // The generators write their address into the window
+    for (uint32_t i = 0; i < GEN_WORDS; i++)
+    {
+        if (gen_dst[i] != 0 && gen_dst[i] != (uint32_t)&gen_dst[i])
+        {
+            errors++;
+        }
+    }
+    for (uint32_t i = 0; i < DMA_WORDS; i++)
+    {
+        if (dma_dst[i] != i)
+        {
+            errors++;
+        }
+    }
+
+    if (last_saturated >= 0)
+    {
+        PRINTF("The two generators saturate the bus up to a period of %u cycles\n\r", periods[last_saturated]);
+    }
+    if (last_saturated_loaded >= 0)
+    {
+        PRINTF("With the DMA and the core, up to a period of %u cycles\n\r", periods[last_saturated_loaded]);
+    }
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Latency of the core loads while the DMA copies a buffer, with the
+ *        arbitration settings of the system crossbar changed through
+ *        soc_ctrl: round-robin, core data master first, and DMA masters
+ *        limited to a quarter of the bandwidth.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "soc_ctrl.h"
+#include "dma_sdk.h"
+#include "ram_bank.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define DMA_WORDS   2048
+#define PROBE_WORDS 256
+#define QOS_WINDOW  256
+
+static uint32_t dma_src[DMA_WORDS];
+static uint32_t dma_dst[DMA_WORDS];
+static uint32_t probe[PROBE_WORDS];
+
+static const uint32_t dma_masters[] = {
+    SOC_CTRL_BUS_MASTER_DMA_READ,
+    SOC_CTRL_BUS_MASTER_DMA_WRITE,
+    SOC_CTRL_BUS_MASTER_DMA_ADDR,
+};
+
+// Cycles of PROBE_WORDS dependent loads, so that each one waits for the bus
+static uint32_t __attribute__((noinline)) probe_loads(void)
+{
+    volatile uint32_t *p = probe;
+    uint32_t idx = 0, cycles;
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    for (uint32_t i = 0; i < PROBE_WORDS; i++)
+    {
+        idx = p[idx];
+    }
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return idx == 0 ? cycles : 0;
+}
+
+static uint32_t run(const char *name, int with_dma)
+{
+    dma_sdk_ticket_t ticket = -1;
+    uint32_t cycles;
+
+    if (with_dma)
+    {
+        ticket = dma_copy_32b_async(dma_dst, dma_src, DMA_WORDS, NULL, NULL);
+    }
+    cycles = probe_loads();
+    if (with_dma && dma_sdk_is_done(ticket))
+    {
+        PRINTF("%s: the copy ended before the loads, use a larger DMA_WORDS\n\r", name);
+    }
+    dma_sdk_wait(ticket);
+
+    PRINTF("%-12s %6d cycles, %3d.%02d cycles per load\n\r", name, cycles,
+           cycles / PROBE_WORDS, (cycles % PROBE_WORDS) * 100 / PROBE_WORDS);
+    return cycles;
+}
+
+int main(void)
+{
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+    uint32_t errors = 0;
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    for (uint32_t i = 0; i < DMA_WORDS; i++)
+    {
+        dma_src[i] = i;
+    }
+    // Every load reads the index 0 of the next one
+    for (uint32_t i = 0; i < PROBE_WORDS; i++)
+    {
+        probe[i] = 0;
+    }
+
+    PRINTF("Loads in banks 0x%x, DMA in banks 0x%x\n\r",
+           ram_banks_of(probe, sizeof(probe)),
+           ram_banks_of(dma_src, sizeof(dma_src)) | ram_banks_of(dma_dst, sizeof(dma_dst)));
+
+    uint32_t idle = run("idle", 0);
+
+    // Round-robin among all the masters
+    soc_ctrl_set_bus_qos(&soc_ctrl, 0, 0, 0);
+    uint32_t rr = run("round-robin", 1);
+
+    // Core data master first
+    soc_ctrl_set_bus_qos(&soc_ctrl,
+                         SOC_CTRL_BUS_QOS_PRIORITY(SOC_CTRL_BUS_MASTER_CORE_DATA, 1), 0, 0);
+    uint32_t prio = run("core first", 1);
+
+    // DMA masters limited to 4/16 of the cycles
+    uint32_t budget = 0;
+    for (uint32_t i = 0; i < sizeof(dma_masters) / sizeof(dma_masters[0]); i++)
+    {
+        budget |= SOC_CTRL_BUS_QOS_BUDGET(dma_masters[i], 4);
+    }
+    soc_ctrl_set_bus_qos(&soc_ctrl, 0, budget, QOS_WINDOW);
+    uint32_t limited = run("dma budget", 1);
+
+    soc_ctrl_clear_bus_qos(&soc_ctrl);
+
+    for (uint32_t i = 0; i < DMA_WORDS; i++)
+    {
+        if (dma_dst[i] != i)
+        {
+            errors++;
+        }
+    }
+
+    PRINTF("Extra cycles under DMA load: round-robin %d, core first %d, dma budget %d\n\r",
+           rr - idle, prio - idle, limited - idle);
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,29 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "bench.h"
+#include "hal.hpp"
+
+using Pin = xheep::Gpio<BENCH_PIN>;
+using Copy = xheep::Dma<0>;
+constexpr xheep::SpiSlave slave = {.csid = BENCH_SPI_CSID, .freq = BENCH_SPI_FREQ};
+using Host = xheep::Spi<xheep::SpiIdx::Host, slave>;
+
+__attribute__((noinline)) void bench_cpp_gpio(void)
+{
+    for (int i = 0; i < BENCH_TOGGLES; i++)
+    {
+        Pin::toggle();
+    }
+}
+
+__attribute__((noinline)) void bench_cpp_dma(void)
+{
+    Copy::copy(bench_dst, bench_src);
+}
+
+__attribute__((noinline)) void bench_cpp_spi(void)
+{
+    Host::init();
+}
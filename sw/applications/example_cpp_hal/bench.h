@@ -0,0 +1,35 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_PIN       2
+#define BENCH_TOGGLES   100
+#define BENCH_WORDS     64
+#define BENCH_SPI_CSID  0
+#define BENCH_SPI_FREQ  10000000
+
+extern uint32_t bench_src[BENCH_WORDS];
+extern uint32_t bench_dst[BENCH_WORDS];
+
+// The same operations with the C drivers (main.c) and the C++ layer (bench.cpp)
+void bench_c_gpio(void);
+void bench_c_dma(void);
+void bench_c_spi(void);
+void bench_cpp_gpio(void);
+void bench_cpp_dma(void);
+void bench_cpp_spi(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BENCH_H_
@@ -0,0 +1,111 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: main.c
+// Description: Cycles of the same operations with the C drivers and with the
+//              header-only C++ layer of device/lib/cpp (bench.cpp): toggling
+//              a GPIO, a DMA copy and the configuration of an SPI slave.
+//              The code size of each benchmark is the size of its function:
+//              riscv32-unknown-elf-nm -S -C sw/build/main.elf | grep bench_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "core_v_mini_mcu.h"
+#include "csr.h"
+#include "gpio.h"
+#include "dma_sdk.h"
+#include "spi_sdk.h"
+#include "x-heep.h"
+#include "bench.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+uint32_t bench_src[BENCH_WORDS];
+uint32_t bench_dst[BENCH_WORDS];
+
+__attribute__((noinline)) void bench_c_gpio(void)
+{
+    for (int i = 0; i < BENCH_TOGGLES; i++)
+    {
+        gpio_toggle(BENCH_PIN);
+    }
+}
+
+__attribute__((noinline)) void bench_c_dma(void)
+{
+    dma_copy_32b(bench_dst, bench_src, BENCH_WORDS);
+}
+
+__attribute__((noinline)) void bench_c_spi(void)
+{
+    spi_slave_t slave = SPI_SLAVE(BENCH_SPI_CSID, BENCH_SPI_FREQ);
+    spi_init(SPI_IDX_HOST, slave);
+}
+
+static uint32_t cycles(void (*bench)(void))
+{
+    uint32_t cycles;
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    bench();
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+static uint32_t check_copy(void)
+{
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < BENCH_WORDS; i++)
+    {
+        errors += bench_dst[i] != bench_src[i];
+        bench_dst[i] = 0;
+    }
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t errors = 0;
+
+    gpio_cfg_t pin_cfg = {
+        .pin = BENCH_PIN,
+        .mode = GpioModeOutPushPull
+    };
+    if (gpio_config(pin_cfg) != GpioOk)
+    {
+        PRINTF("Gpio initialization failed!\n\r");
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0; i < BENCH_WORDS; i++)
+    {
+        bench_src[i] = i * 0x01010101;
+    }
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("benchmark       C   C++ cycles\n\r");
+    uint32_t c = cycles(bench_c_gpio);
+    PRINTF("gpio toggle %5u %5u\n\r", c, cycles(bench_cpp_gpio));
+
+    c = cycles(bench_c_dma);
+    errors += check_copy();
+    PRINTF("dma copy    %5u", c);
+    PRINTF(" %5u\n\r", cycles(bench_cpp_dma));
+    errors += check_copy();
+
+    c = cycles(bench_c_spi);
+    PRINTF("spi init    %5u %5u\n\r", c, cycles(bench_cpp_spi));
+
+    PRINTF("Errors:%d\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file main.c
+ * @brief Check and cycles of the CRC peripheral
+ *
+ * The CRC of the check string "123456789" is computed for each preset of
+ * crc.h with the peripheral, fed by the CPU and by the DMA, and on the CPU
+ * alone, and compared with the check value of the preset. The cycles
+ * (mcycle) of the three ways are then reported for a 4kB buffer, the size of
+ * a flash sector.
+ *
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core_v_mini_mcu.h"
+#include "x-heep.h"
+#include "csr.h"
+#include "crc.h"
+
+#ifndef CRC_IS_INCLUDED
+  #error ( "This app does NOT work as the CRC peripheral is not included" )
+#endif
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define DMA_CHANNEL  0
+#define BUFFER_BYTES 4096
+
+typedef struct {
+    const char *name;
+    const crc_config_t *config;
+    uint32_t check;
+} preset_t;
+
+static const preset_t presets[] = {
+    { "CRC-32",        &crc_crc32,       0xCBF43926 },
+    { "CRC-32C",       &crc_crc32c,      0xE3069283 },
+    { "CRC-16/CCITT",  &crc_crc16_ccitt, 0x29B1 },
+    { "CRC-16/ARC",    &crc_crc16_arc,   0xBB3D },
+};
+
+static const uint8_t check_string[] = "123456789";
+
+static uint8_t buffer[BUFFER_BYTES] __attribute__((aligned(4)));
+
+int main(int argc, char *argv[])
+{
+    int errors = 0;
+    uint32_t crc_cpu, crc_dma, crc_sw;
+
+    for (int i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+        const crc_config_t *config = presets[i].config;
+
+        // Odd length, so the CPU writes bytes around the words of the DMA
+        crc_start(config);
+        crc_update(check_string, 9);
+        crc_cpu = crc_result(config);
+
+        if (crc_compute(config, check_string, 9, DMA_CHANNEL, &crc_dma) != kCrcOk) {
+            PRINTF("%s: DMA error\n\r", presets[i].name);
+            return EXIT_FAILURE;
+        }
+
+        crc_sw = crc_compute_sw(config, check_string, 9, config->init ^ config->xor_out);
+
+        if (crc_cpu != presets[i].check || crc_dma != presets[i].check || crc_sw != presets[i].check) {
+            PRINTF("%s: 0x%08x 0x%08x 0x%08x instead of 0x%08x\n\r", presets[i].name,
+                   crc_cpu, crc_dma, crc_sw, presets[i].check);
+            errors++;
+        }
+    }
+
+    for (int i = 0; i < BUFFER_BYTES; i++) {
+        buffer[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    uint32_t cycles_cpu, cycles_dma, cycles_sw;
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    crc_start(&crc_crc32);
+    crc_update(buffer, BUFFER_BYTES);
+    crc_cpu = crc_result(&crc_crc32);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_cpu);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    crc_compute(&crc_crc32, buffer, BUFFER_BYTES, DMA_CHANNEL, &crc_dma);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_dma);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    crc_sw = crc_compute_sw(&crc_crc32, buffer, BUFFER_BYTES, 0);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_sw);
+
+    if (crc_cpu != crc_sw || crc_dma != crc_sw) {
+        PRINTF("CRC-32 of %d bytes: 0x%08x 0x%08x instead of 0x%08x\n\r", BUFFER_BYTES, crc_cpu, crc_dma, crc_sw);
+        errors++;
+    }
+
+    PRINTF("CRC-32 of %d bytes, cycles: CPU writes %d, DMA %d, software %d\n\r",
+           BUFFER_BYTES, cycles_cpu, cycles_dma, cycles_sw);
+
+    if (errors) {
+        PRINTF("FAILURE\n\r");
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("SUCCESS\n\r");
+    return EXIT_SUCCESS;
+}
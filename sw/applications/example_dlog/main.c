@@ -0,0 +1,62 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Example application of the deferred logging of dlog.h. A loop is
+ *        instrumented with DLOG, then the records are dumped to the UART.
+ *        Decode the dump with util/dlog_decode.py and the ELF of the app.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "uart.h"
+#include "soc_ctrl.h"
+#include "dlog.h"
+
+#define LOG_WORDS 1024
+#define ITERATIONS 64
+
+static uint32_t log_buffer[LOG_WORDS];
+
+int main(int argc, char *argv[])
+{
+    unsigned int cycles;
+
+    if (dlog_init(log_buffer, LOG_WORDS) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    DLOG("example_dlog: %d iterations\n", ITERATIONS);
+
+    uint32_t acc = 0;
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        acc = acc * 31 + i;
+        DLOG("iteration %u: acc = 0x%08x\n", i, acc);
+    }
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+
+    DLOG("%u cycles for %u records\n", cycles, ITERATIONS);
+
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+    uart_t uart;
+    uart.base_addr   = mmio_region_from_addr((uintptr_t)UART_START_ADDRESS);
+    uart.baudrate    = UART_BAUDRATE;
+    uart.clk_freq_hz = soc_ctrl_get_frequency(&soc_ctrl);
+
+    if (uart_init(&uart) != kErrorOk)
+    {
+        return EXIT_FAILURE;
+    }
+
+    dlog_dump(uart_sink, &uart);
+    return dlog_dropped() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
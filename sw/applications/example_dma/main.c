@@ -63,10 +63,10 @@ dma_data_type_t C_type_2_dma_type(int C_type)
 }
 
 #define WAIT_DMA                              \
-    while (!dma_is_ready())                   \
+    while (!dma_is_ready(0))                   \
     {                                         \
         CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8); \
-        if (dma_is_ready() == 0)              \
+        if (dma_is_ready(0) == 0)              \
         {                                     \
             wait_for_interrupt();             \
         }                                     \
@@ -210,7 +210,7 @@ void dma_intr_handler_trans_done(void)
 
 int32_t window_intr_flag;
 
-void dma_intr_handler_window_done(void)
+void dma_intr_handler_window_done(uint8_t channel)
 {
     window_intr_flag++;
 }
@@ -244,7 +244,7 @@ int main(int argc, char *argv[])
         .size_du = TEST_DATA_SIZE,
         .trig = DMA_TRIG_MEMORY,
     };
-    dma_trans_t trans;
+    dma_trans_t trans = {0};
 
 #ifdef TEST_SINGLE_MODE
 
@@ -417,7 +417,7 @@ int main(int argc, char *argv[])
     {
         while (cycles < consecutive_trans)
         {
-            while (!dma_is_ready())
+            while (!dma_is_ready(0))
                 ;
             cycles++;
         }
@@ -483,13 +483,13 @@ int main(int argc, char *argv[])
 
     if (trans.end == DMA_TRANS_END_POLLING)
     { // There will be no interrupts whatsoever!
-        while (!dma_is_ready())
+        while (!dma_is_ready(0))
             ;
         PRINTF("?\n\r");
     }
     else
     {
-        while (!dma_is_ready())
+        while (!dma_is_ready(0))
         {
             wait_for_interrupt();
             PRINTF("i\n\r");
@@ -0,0 +1,315 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Throughput of the DMA and setup cost of its HAL. Memory-to-memory
+ *        transactions are swept over their size, the source and destination
+ *        data types, sign extension, 1D and 2D, padding, transposition
+ *        (dim_inv), misaligned pointers realigned by the HAL
+ *        (DMA_ENABLE_REALIGN) and the banks of the buffers. For each case,
+ *        the cycles of dma_validate_transaction() and dma_load_transaction()
+ *        (setup) and from the launch to the end of the transaction (copy)
+ *        are printed, with the bytes written per copy cycle, padding
+ *        included. The destination is checked against a copy made by the
+ *        CPU. The buffers are placed in the data bank, and in the
+ *        data_stream and data_interleaved sections when the configuration
+ *        has them (see configs/stream.hjson).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "dma.h"
+#include "ram_bank.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+// Largest transaction, in data units
+#define MAX_DU 1024
+
+// Source of MAX_DU words, plus room for the misaligned pointers
+#define SRC_BYTES (MAX_DU * 4 + 8)
+// Destination of MAX_DU words with the padding of a 32x32 matrix
+#define DST_BYTES ((32 + 2) * (32 + 2) * 4 + 8)
+
+// Written to the destination before each transaction, to check the padding
+#define DST_FILL 0xA5
+
+static uint8_t __attribute__((aligned(4))) data_src[SRC_BYTES];
+static uint8_t __attribute__((aligned(4))) data_dst[DST_BYTES];
+static uint8_t __attribute__((aligned(4))) ref[DST_BYTES];
+
+#ifdef LINKER_SECTION_DATA_STREAM_START_ADDRESS
+static uint8_t __attribute__((aligned(4))) RAM_SECTION(data_stream) bank_src[SRC_BYTES];
+#endif
+
+#if defined(HAS_MEMORY_BANKS_IL) && defined(LINKER_SECTION_DATA_INTERLEAVED_START_ADDRESS)
+static uint8_t __attribute__((aligned(4))) RAM_INTERLEAVED il_src[SRC_BYTES];
+static uint8_t __attribute__((aligned(4))) RAM_INTERLEAVED il_dst[DST_BYTES];
+#endif
+
+typedef struct
+{
+    const char *name;
+    uint8_t *src;
+    uint8_t *dst;
+} placement_t;
+
+static const placement_t placements[] = {
+    {"data bank", data_src, data_dst},
+#ifdef LINKER_SECTION_DATA_STREAM_START_ADDRESS
+    {"data_stream to data bank", bank_src, data_dst},
+#endif
+#if defined(HAS_MEMORY_BANKS_IL) && defined(LINKER_SECTION_DATA_INTERLEAVED_START_ADDRESS)
+    {"interleaved", il_src, il_dst},
+#endif
+};
+
+#define NUM_PLACEMENTS (sizeof(placements) / sizeof(placements[0]))
+
+typedef struct
+{
+    const char *name;
+    dma_data_type_t src_type;
+    dma_data_type_t dst_type;
+    uint8_t sign_ext;
+    dma_dim_t dim;
+    uint8_t pad;        // Padding on each side, in data units
+    uint8_t dim_inv;
+    uint8_t src_offset; // Misalignment of the source, in bytes
+    uint8_t dst_offset; // Misalignment of the destination, in bytes
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    {"1D word",              DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_1D, 0, 0, 0, 0},
+    {"1D half",              DMA_DATA_TYPE_HALF_WORD, DMA_DATA_TYPE_HALF_WORD, 0, DMA_DIM_CONF_1D, 0, 0, 0, 0},
+    {"1D byte",              DMA_DATA_TYPE_BYTE,      DMA_DATA_TYPE_BYTE,      0, DMA_DIM_CONF_1D, 0, 0, 0, 0},
+    {"1D byte to word",      DMA_DATA_TYPE_BYTE,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_1D, 0, 0, 0, 0},
+    {"1D byte to word sext", DMA_DATA_TYPE_BYTE,      DMA_DATA_TYPE_WORD,      1, DMA_DIM_CONF_1D, 0, 0, 0, 0},
+    {"1D half to word sext", DMA_DATA_TYPE_HALF_WORD, DMA_DATA_TYPE_WORD,      1, DMA_DIM_CONF_1D, 0, 0, 0, 0},
+    {"1D word pad 4",        DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_1D, 4, 0, 0, 0},
+    {"1D word src +1",       DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_1D, 0, 0, 1, 0},
+    {"1D word src +2",       DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_1D, 0, 0, 2, 0},
+    {"1D word dst +2",       DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_1D, 0, 0, 0, 2},
+    {"2D word",              DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_2D, 0, 0, 0, 0},
+    {"2D word pad 1",        DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_2D, 1, 0, 0, 0},
+    {"2D word transposed",   DMA_DATA_TYPE_WORD,      DMA_DATA_TYPE_WORD,      0, DMA_DIM_CONF_2D, 0, 1, 0, 0},
+    {"2D byte transposed",   DMA_DATA_TYPE_BYTE,      DMA_DATA_TYPE_BYTE,      0, DMA_DIM_CONF_2D, 0, 1, 0, 0},
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+// Data units of the sweep, of squares for 2D (4x4 to 32x32)
+static const uint32_t sizes_du[] = {16, 64, 256, 1024};
+
+#define NUM_SIZES (sizeof(sizes_du) / sizeof(sizes_du[0]))
+
+// Placements are swept with these cases only
+static const uint32_t placement_cases[] = {0, 10};
+
+#define NUM_PLACEMENT_CASES (sizeof(placement_cases) / sizeof(placement_cases[0]))
+
+static dma_target_t tgt_src;
+static dma_target_t tgt_dst;
+static dma_trans_t trans;
+
+static uint32_t side_of(uint32_t du)
+{
+    uint32_t side = 1;
+
+    while (side * side < du)
+    {
+        side++;
+    }
+    return side;
+}
+
+static inline uint32_t mcycle(void)
+{
+    uint32_t cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+// Element i of a buffer of a type, sign extended from it if asked, as the DMA
+static uint32_t read_du(const uint8_t *buf, uint32_t i, dma_data_type_t type, uint8_t sign_ext)
+{
+    uint32_t size = DMA_DATA_TYPE_2_SIZE(type);
+    uint32_t value = 0;
+
+    memcpy(&value, buf + i * size, size);
+    if (sign_ext && size < 4 && (value >> (8 * size - 1)) & 1)
+    {
+        value |= ~0u << (8 * size);
+    }
+    return value;
+}
+
+static void write_du(uint8_t *buf, uint32_t i, dma_data_type_t type, uint32_t value)
+{
+    memcpy(buf + i * DMA_DATA_TYPE_2_SIZE(type), &value, DMA_DATA_TYPE_2_SIZE(type));
+}
+
+// The destination computed by the CPU, returns its size in bytes
+static uint32_t reference(const bench_case_t *c, const uint8_t *src, uint32_t du)
+{
+    uint32_t dst_size = DMA_DATA_TYPE_2_SIZE(c->dst_type);
+    uint32_t d1 = c->dim == DMA_DIM_CONF_2D ? side_of(du) : du;
+    uint32_t d2 = c->dim == DMA_DIM_CONF_2D ? d1 : 1;
+    uint32_t top = c->dim == DMA_DIM_CONF_2D ? c->pad : 0;
+    uint32_t out_d1 = d1 + 2 * c->pad;
+    uint32_t out_d2 = d2 + 2 * top;
+
+    for (uint32_t r = 0; r < out_d2; r++)
+    {
+        for (uint32_t col = 0; col < out_d1; col++)
+        {
+            uint32_t value = 0;
+
+            if (r >= top && r < top + d2 && col >= c->pad && col < c->pad + d1)
+            {
+                uint32_t sr = r - top, sc = col - c->pad;
+                uint32_t i = c->dim_inv ? sc * d1 + sr : sr * d1 + sc;
+                value = read_du(src, i, c->src_type, c->sign_ext);
+            }
+            write_du(ref, r * out_d1 + col, c->dst_type, value);
+        }
+    }
+    return out_d1 * out_d2 * dst_size;
+}
+
+// Returns the errors, or 1 if the transaction was rejected
+static uint32_t run(const bench_case_t *c, const placement_t *p, uint32_t du)
+{
+    uint8_t *src = p->src + c->src_offset;
+    uint8_t *dst = p->dst + c->dst_offset;
+    uint32_t d1 = c->dim == DMA_DIM_CONF_2D ? side_of(du) : du;
+    uint32_t d2 = c->dim == DMA_DIM_CONF_2D ? d1 : 1;
+    uint32_t bytes, t0, t1, t2, errors = 0;
+    dma_config_flags_t flags;
+
+    if (c->dim == DMA_DIM_CONF_2D && d1 * d2 != du)
+    {
+        return 0;
+    }
+
+    bytes = reference(c, src, du);
+    memset(p->dst, DST_FILL, DST_BYTES);
+
+    tgt_src.ptr = src;
+    tgt_src.inc_du = 1;
+    tgt_src.size_du = d1;
+    tgt_src.inc_d2_du = c->dim == DMA_DIM_CONF_2D ? (c->dim_inv ? d1 : 1) : 0;
+    tgt_src.size_d2_du = c->dim == DMA_DIM_CONF_2D ? d2 : 0;
+    tgt_src.trig = DMA_TRIG_MEMORY;
+    tgt_src.type = c->src_type;
+
+    tgt_dst.ptr = dst;
+    tgt_dst.inc_du = 1;
+    tgt_dst.size_du = d1 + 2 * c->pad;
+    tgt_dst.inc_d2_du = c->dim == DMA_DIM_CONF_2D ? 1 : 0;
+    tgt_dst.size_d2_du = c->dim == DMA_DIM_CONF_2D ? d2 + 2 * c->pad : 0;
+    tgt_dst.trig = DMA_TRIG_MEMORY;
+    tgt_dst.type = c->dst_type;
+
+    trans.src = &tgt_src;
+    trans.dst = &tgt_dst;
+    trans.src_addr = NULL;
+    trans.mode = DMA_TRANS_MODE_SINGLE;
+    trans.dim = c->dim;
+    trans.pad_top_du = c->dim == DMA_DIM_CONF_2D ? c->pad : 0;
+    trans.pad_bottom_du = c->dim == DMA_DIM_CONF_2D ? c->pad : 0;
+    trans.pad_left_du = c->pad;
+    trans.pad_right_du = c->pad;
+    trans.sign_ext = c->sign_ext;
+    trans.dim_inv = c->dim_inv;
+    trans.win_du = 0;
+    trans.end = DMA_TRANS_END_POLLING;
+    trans.channel = 0;
+
+    t0 = mcycle();
+    flags = dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    if (!(flags & DMA_CONFIG_CRITICAL_ERROR))
+    {
+        flags |= dma_load_transaction(&trans);
+    }
+    t1 = mcycle();
+    if (flags & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        PRINTF("  %-20s %5u du rejected, flags 0x%04x\n\r", c->name, du, flags);
+        return 1;
+    }
+    dma_launch(&trans);
+    while (!dma_is_ready(0))
+    {
+    }
+    t2 = mcycle();
+
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        errors += dst[i] != ref[i];
+    }
+
+    uint32_t centi = (uint32_t)(((uint64_t)bytes * 100 + (t2 - t1) / 2) / (t2 - t1));
+    PRINTF("  %-20s %5u du %5u B setup %4u copy %6u cycles %u.%02u B/cycle%s\n\r", c->name, du, bytes,
+           t1 - t0, t2 - t1, centi / 100, centi % 100, errors ? " ERROR" : "");
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    dma_init(NULL);
+
+    for (uint32_t p = 0; p < NUM_PLACEMENTS; p++)
+    {
+        for (uint32_t i = 0; i < SRC_BYTES; i++)
+        {
+            // Bytes with the top bit set half of the time, for sign extension
+            placements[p].src[i] = (uint8_t)(i * 37 + 0x81);
+        }
+    }
+
+    PRINTF("%s, source in banks 0x%x, destination in banks 0x%x\n\r", placements[0].name,
+           ram_banks_of(placements[0].src, SRC_BYTES), ram_banks_of(placements[0].dst, DST_BYTES));
+    for (uint32_t c = 0; c < NUM_CASES; c++)
+    {
+        for (uint32_t s = 0; s < NUM_SIZES; s++)
+        {
+            errors += run(&cases[c], &placements[0], sizes_du[s]);
+        }
+    }
+
+    for (uint32_t p = 1; p < NUM_PLACEMENTS; p++)
+    {
+        PRINTF("%s, source in banks 0x%x, destination in banks 0x%x\n\r", placements[p].name,
+               ram_banks_of(placements[p].src, SRC_BYTES), ram_banks_of(placements[p].dst, DST_BYTES));
+        for (uint32_t c = 0; c < NUM_PLACEMENT_CASES; c++)
+        {
+            for (uint32_t s = 0; s < NUM_SIZES; s++)
+            {
+                errors += run(&cases[placement_cases[c]], &placements[p], sizes_du[s]);
+            }
+        }
+    }
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
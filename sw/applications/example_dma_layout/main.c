@@ -0,0 +1,219 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Benchmark of the layout transforms of dma_layout.h. Each transform
+ *        (matrix transposition, NCHW to NHWC and back, stereo interleaving
+ *        and deinterleaving) is done by the CPU and by the DMA, the cycles
+ *        are compared and the results checked against each other. Then the
+ *        product of two matrices is computed with B, read by columns, and
+ *        with B transposed by the DMA, read by rows, transposition included.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "dma_layout.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+// Matrices of the transposition and of the product
+#define ROWS    32
+#define COLS    48
+// Tensor of the NCHW and NHWC conversions
+#define TN      1
+#define TC      16
+#define TH      12
+#define TW      12
+// Stereo frames
+#define FRAMES  512
+#define STEREO  2
+
+#define MAX_BYTES   (ROWS * COLS * 4)
+#define PLAN_LEN    4
+
+static uint8_t __attribute__((aligned(4))) src[MAX_BYTES];
+static uint8_t __attribute__((aligned(4))) dst_cpu[MAX_BYTES];
+static uint8_t __attribute__((aligned(4))) dst_dma[MAX_BYTES];
+static int16_t left[FRAMES], right[FRAMES];
+static int16_t left_dma[FRAMES], right_dma[FRAMES];
+static int32_t mat_c[ROWS * ROWS];
+static int32_t mat_c_t[ROWS * ROWS];
+static dma_layout_desc_t plan[PLAN_LEN];
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+typedef enum { T_TRANSPOSE, T_NCHW_NHWC, T_NHWC_NCHW, T_INTERLEAVE, T_DEINTERLEAVE } transform_t;
+
+typedef struct
+{
+    const char *name;
+    transform_t transform;
+    dma_data_type_t type;
+} bench_case_t;
+
+static const bench_case_t cases[] = {
+    {"transpose word",   T_TRANSPOSE,    DMA_DATA_TYPE_WORD},
+    {"transpose half",   T_TRANSPOSE,    DMA_DATA_TYPE_HALF_WORD},
+    {"transpose byte",   T_TRANSPOSE,    DMA_DATA_TYPE_BYTE},
+    {"nchw to nhwc",     T_NCHW_NHWC,    DMA_DATA_TYPE_BYTE},
+    {"nhwc to nchw",     T_NHWC_NCHW,    DMA_DATA_TYPE_BYTE},
+    {"interleave",       T_INTERLEAVE,   DMA_DATA_TYPE_HALF_WORD},
+    {"deinterleave",     T_DEINTERLEAVE, DMA_DATA_TYPE_HALF_WORD},
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+// Runs a transform into dst, or into the left and right buffers, returns the bytes written
+static uint32_t run(const bench_case_t *c, uint8_t *dst, int16_t *l, int16_t *r, dma_layout_done_t *done)
+{
+    void *planes[STEREO] = {l, r};
+
+    switch (c->transform)
+    {
+    case T_TRANSPOSE:
+        *done = dma_layout_transpose(dst, src, ROWS, COLS, c->type, plan, PLAN_LEN);
+        return ROWS * COLS * DMA_DATA_TYPE_2_SIZE(c->type);
+    case T_NCHW_NHWC:
+        *done = dma_layout_nchw_to_nhwc(dst, src, TN, TC, TH, TW, c->type, plan, PLAN_LEN);
+        return TN * TC * TH * TW * DMA_DATA_TYPE_2_SIZE(c->type);
+    case T_NHWC_NCHW:
+        *done = dma_layout_nhwc_to_nchw(dst, src, TN, TC, TH, TW, c->type, plan, PLAN_LEN);
+        return TN * TC * TH * TW * DMA_DATA_TYPE_2_SIZE(c->type);
+    case T_INTERLEAVE:
+        *done = dma_layout_interleave(dst, planes, STEREO, FRAMES, c->type, plan, PLAN_LEN);
+        return FRAMES * STEREO * sizeof(int16_t);
+    default:
+        *done = dma_layout_deinterleave(planes, src, STEREO, FRAMES, c->type, plan, PLAN_LEN);
+        return 0;
+    }
+}
+
+// C = A x B with B read by columns, or with B^T read by rows
+static void __attribute__((noinline)) matmul(const int32_t *a, const int32_t *b, int32_t *c)
+{
+    for (uint32_t i = 0; i < ROWS; i++)
+    {
+        for (uint32_t j = 0; j < ROWS; j++)
+        {
+            int32_t acc = 0;
+            for (uint32_t k = 0; k < COLS; k++)
+            {
+                acc += a[i * COLS + k] * b[k * ROWS + j];
+            }
+            c[i * ROWS + j] = acc;
+        }
+    }
+}
+
+static void __attribute__((noinline)) matmul_bt(const int32_t *a, const int32_t *bt, int32_t *c)
+{
+    for (uint32_t i = 0; i < ROWS; i++)
+    {
+        for (uint32_t j = 0; j < ROWS; j++)
+        {
+            int32_t acc = 0;
+            for (uint32_t k = 0; k < COLS; k++)
+            {
+                acc += a[i * COLS + k] * bt[j * COLS + k];
+            }
+            c[i * ROWS + j] = acc;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int c_cpu, c_dma;
+    dma_layout_done_t done;
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < MAX_BYTES; i++)
+    {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    // The channels to interleave, replaced by the deinterleaving
+    memcpy(left, src, sizeof(left));
+    memcpy(right, src + sizeof(left), sizeof(right));
+    memcpy(left_dma, left, sizeof(left));
+    memcpy(right_dma, right, sizeof(right));
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("transform             cpu        dma\n\r");
+
+    for (uint32_t i = 0; i < NUM_CASES; i++)
+    {
+        const bench_case_t *c = &cases[i];
+
+        dma_layout_set_threshold(UINT32_MAX);
+        cycles_start();
+        uint32_t bytes = run(c, dst_cpu, left, right, &done);
+        c_cpu = cycles_stop();
+
+        dma_layout_set_threshold(0);
+        cycles_start();
+        run(c, dst_dma, left_dma, right_dma, &done);
+        c_dma = cycles_stop();
+
+        if (done != DMA_LAYOUT_DONE_DMA || memcmp(dst_dma, dst_cpu, bytes) != 0 ||
+            memcmp(left_dma, left, sizeof(left)) != 0 || memcmp(right_dma, right, sizeof(right)) != 0)
+        {
+            PRINTF("%-16s failed\n\r", c->name);
+            errors++;
+            continue;
+        }
+        PRINTF("%-16s %10u %10u\n\r", c->name, c_cpu, c_dma);
+    }
+
+    // B is COLS x ROWS, its transposition ROWS x COLS
+    const int32_t *mat_a = (const int32_t *)src;
+    const int32_t *mat_b = (const int32_t *)src;
+    int32_t *mat_bt = (int32_t *)dst_dma;
+
+    cycles_start();
+    matmul(mat_a, mat_b, mat_c);
+    c_cpu = cycles_stop();
+
+    dma_layout_set_threshold(DMA_LAYOUT_CPU_THRESHOLD);
+    cycles_start();
+    dma_layout_transpose(mat_bt, mat_b, COLS, ROWS, DMA_DATA_TYPE_WORD, plan, PLAN_LEN);
+    matmul_bt(mat_a, mat_bt, mat_c_t);
+    c_dma = cycles_stop();
+
+    errors += memcmp(mat_c, mat_c_t, sizeof(mat_c)) != 0;
+    PRINTF("matmul B %10u, B^T with transposition %10u\n\r", c_cpu, c_dma);
+
+    if (errors != 0)
+    {
+        PRINTF("%u errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
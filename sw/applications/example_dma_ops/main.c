@@ -0,0 +1,200 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: In-transfer operations of the DMA, checked against the CPU:
+ *        - a requantization of int16_t samples to int8_t, scaled by 3/4,
+ *          offset and saturated, with the sum of the results;
+ *        - a threshold of int16_t samples, the ones below a level set to 0;
+ *        - a conversion of the endianness of words.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "x-heep.h"
+#include "dma.h"
+
+#define SAMPLES 64
+#define OFFSET  (-10)
+#define LEVEL   100
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+static int16_t  samples[SAMPLES];
+static int8_t   quant[SAMPLES];
+static int16_t  gated[SAMPLES];
+static uint32_t words[SAMPLES];
+static uint32_t swapped[SAMPLES];
+
+static dma_config_flags_t run( dma_trans_t *trans )
+{
+    dma_config_flags_t res;
+
+    res = dma_validate_transaction(trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    res |= dma_load_transaction(trans);
+    res |= dma_launch(trans);
+    while (!(res & DMA_CONFIG_CRITICAL_ERROR) && !dma_is_ready(0))
+    {
+    }
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    int errors = 0;
+    int32_t sum = 0;
+
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        samples[i] = (int16_t)((i * 37) % 512) - 256;
+        words[i] = i * 2654435761u;
+    }
+
+    dma_init(NULL);
+
+    /* Requantization: (x * 3) >> 2, - 10, saturated to int8_t */
+    dma_target_t tgt_samples = {
+        .ptr = (uint8_t *)samples,
+        .inc_du = 1,
+        .size_du = SAMPLES,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_HALF_WORD,
+    };
+    dma_target_t tgt_quant = {
+        .ptr = (uint8_t *)quant,
+        .inc_du = 1,
+        .size_du = SAMPLES,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_BYTE,
+    };
+    dma_trans_t trans = {
+        .src = &tgt_samples,
+        .dst = &tgt_quant,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .end = DMA_TRANS_END_POLLING,
+        .ops = {
+            .en = DMA_OP_SCALE | DMA_OP_ADD | DMA_OP_MIN | DMA_OP_MAX | DMA_OP_ACC | DMA_OP_SIGNED,
+            .scale = 3,
+            .shift = 2,
+            .add = (uint32_t)OFFSET,
+            .min = (uint32_t)INT8_MIN,
+            .max = INT8_MAX,
+        },
+    };
+
+    if (run(&trans) & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        PRINTF("Requantization not launched\n\r");
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        int32_t q = ((samples[i] * 3) >> 2) + OFFSET;
+        q = q < INT8_MIN ? INT8_MIN : q > INT8_MAX ? INT8_MAX : q;
+        sum += q;
+        if (quant[i] != q)
+        {
+            PRINTF("quant[%u] = %d instead of %d\n\r", i, quant[i], q);
+            errors++;
+        }
+    }
+    if ((int32_t)dma_get_op_acc(0) != sum)
+    {
+        PRINTF("Sum %d instead of %d\n\r", (int32_t)dma_get_op_acc(0), sum);
+        errors++;
+    }
+
+    /* Threshold: the samples below LEVEL become 0 */
+    dma_target_t tgt_gated = {
+        .ptr = (uint8_t *)gated,
+        .inc_du = 1,
+        .size_du = SAMPLES,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_HALF_WORD,
+    };
+    trans = (dma_trans_t) {
+        .src = &tgt_samples,
+        .dst = &tgt_gated,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .end = DMA_TRANS_END_POLLING,
+        .ops = {
+            .en = DMA_OP_MIN | DMA_OP_THRESHOLD | DMA_OP_SIGNED,
+            .min = LEVEL,
+        },
+    };
+
+    if (run(&trans) & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        PRINTF("Threshold not launched\n\r");
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        int16_t g = samples[i] < LEVEL ? 0 : samples[i];
+        if (gated[i] != g)
+        {
+            PRINTF("gated[%u] = %d instead of %d\n\r", i, gated[i], g);
+            errors++;
+        }
+    }
+
+    /* Endianness conversion of words */
+    dma_target_t tgt_words = {
+        .ptr = (uint8_t *)words,
+        .inc_du = 1,
+        .size_du = SAMPLES,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    dma_target_t tgt_swapped = {
+        .ptr = (uint8_t *)swapped,
+        .inc_du = 1,
+        .size_du = SAMPLES,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    trans = (dma_trans_t) {
+        .src = &tgt_words,
+        .dst = &tgt_swapped,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .end = DMA_TRANS_END_POLLING,
+        .ops = {
+            .en = DMA_OP_BSWAP,
+        },
+    };
+
+    if (run(&trans) & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        PRINTF("Byte swap not launched\n\r");
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        if (swapped[i] != __builtin_bswap32(words[i]))
+        {
+            PRINTF("swapped[%u] = 0x%08x instead of 0x%08x\n\r", i, swapped[i], __builtin_bswap32(words[i]));
+            errors++;
+        }
+    }
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
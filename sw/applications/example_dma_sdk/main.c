@@ -8,11 +8,14 @@
 // Description: Example application to test the DMA SDK. Will copy
 //              a constant value in a buffer and then copy the content
 //              of the buffer into another. Will check that both transactions
-//              are performed correctly.
+//              are performed correctly. Then scatters the buffer into
+//              fragments (with an address table and with chained transactions)
+//              and gathers the fragments back.
 
 #include <stdint.h>
 #include <stdlib.h>
 #include "dma_sdk.h"
+#include "dma_sg.h"
 #include "core_v_mini_mcu.h"
 #include "x-heep.h"
 
@@ -30,6 +33,7 @@
 
 #define SOURCE_BUFFER_SIZE_32b  5
 #define CONST_VALUE             123
+#define FRAGMENTS               3
 
 int main(){
     static uint32_t source[SOURCE_BUFFER_SIZE_32b];
@@ -45,6 +49,34 @@ int main(){
     for( i = 0; i < SOURCE_BUFFER_SIZE_32b; i++){
         errors += destin[i] != CONST_VALUE;
     }
+
+    // Scatter the buffer into fragments of 2, 1 and 2 words spaced in memory, and gather them back
+    static uint32_t scattered[3 * SOURCE_BUFFER_SIZE_32b];
+    static uint32_t addr_table[SOURCE_BUFFER_SIZE_32b];
+    static dma_sg_desc_t plan[FRAGMENTS];
+    dma_sg_frag_t frags[FRAGMENTS] = {
+        { (uint8_t *) &scattered[0], 2 * sizeof(uint32_t) },
+        { (uint8_t *) &scattered[4], 1 * sizeof(uint32_t) },
+        { (uint8_t *) &scattered[9], 2 * sizeof(uint32_t) },
+    };
+
+    for( i = 0; i < SOURCE_BUFFER_SIZE_32b; i++){
+        source[i] = i;
+    }
+
+    // With the address table, then with chained transactions
+    for( uint32_t t = 0; t < 2; t++){
+        for( i = 0; i < SOURCE_BUFFER_SIZE_32b; i++){
+            destin[i] = 0;
+        }
+        errors += dma_sg_scatter( (uint8_t *) source, frags, FRAGMENTS,
+                                  t == 0 ? addr_table : NULL, SOURCE_BUFFER_SIZE_32b, plan ) != 0;
+        errors += dma_sg_gather( (uint8_t *) destin, frags, FRAGMENTS, plan ) != 0;
+        for( i = 0; i < SOURCE_BUFFER_SIZE_32b; i++){
+            errors += destin[i] != i;
+        }
+    }
+
     PRINTF("Errors:%d\n\r",errors );
 
     return errors ? EXIT_FAILURE : EXIT_SUCCESS;
@@ -0,0 +1,175 @@
+// Copyright EPFL contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Measures the cycles taken by dma_validate_transaction() at each check level
+// (integrity, only sanity and only critical) for a 1D and a 2D transaction,
+// and checks that the copies are still correct once validated.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dma.h"
+#include "core_v_mini_mcu.h"
+#include "x-heep.h"
+#include "csr.h"
+
+#define TEST_DATA_SIZE  64
+#define ROWS            8
+#define COLS            8
+#define ITERATIONS      16
+
+/* The cycles are the output of this benchmark, so printfs are also activated for simulation. */
+#define PRINTF_IN_FPGA 1
+#define PRINTF_IN_SIM 1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+#define PRINTF(fmt, ...) printf(fmt, ##__VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+#define PRINTF(fmt, ...) printf(fmt, ##__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+
+static uint32_t src[TEST_DATA_SIZE] __attribute__((aligned(4)));
+static uint32_t dst[TEST_DATA_SIZE] __attribute__((aligned(4)));
+
+static const char *level_names[] = {"sanity", "integrity", "critical"};
+
+// Average cycles of the validation of a transaction at a check level
+static uint32_t validation_cycles(dma_trans_t *trans, dma_perf_checks_t level)
+{
+    uint32_t start, end, total = 0;
+
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        trans->flags = DMA_CONFIG_OK;
+        CSR_READ(CSR_REG_MCYCLE, &start);
+        dma_validate_transaction(trans, DMA_ENABLE_REALIGN, level);
+        CSR_READ(CSR_REG_MCYCLE, &end);
+        total += end - start;
+    }
+    return total / ITERATIONS;
+}
+
+// Copy the source with the transaction and count the wrong destination words
+static uint32_t copy_errors(dma_trans_t *trans, dma_perf_checks_t level, uint32_t words)
+{
+    uint32_t errors = 0;
+
+    for (int i = 0; i < TEST_DATA_SIZE; i++)
+    {
+        dst[i] = 0;
+    }
+
+    trans->flags = DMA_CONFIG_OK;
+    if (dma_validate_transaction(trans, DMA_ENABLE_REALIGN, level) != DMA_CONFIG_OK
+        || dma_load_transaction(trans) != DMA_CONFIG_OK
+        || dma_launch(trans) != DMA_CONFIG_OK)
+    {
+        return words;
+    }
+    while (!dma_is_ready(0))
+    {
+    }
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        errors += dst[i] != src[i];
+    }
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t errors = 0;
+
+    for (int i = 0; i < TEST_DATA_SIZE; i++)
+    {
+        src[i] = i * 0x01010101;
+    }
+
+    // Enable the cycle counter
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    dma_init(NULL);
+
+    static dma_env_t env_dst = {
+        .start = (uint8_t *)dst,
+        .end = (uint8_t *)&dst[TEST_DATA_SIZE - 1],
+    };
+
+    static dma_target_t tgt_src = {
+        .ptr = (uint8_t *)src,
+        .inc_du = 1,
+        .size_du = TEST_DATA_SIZE,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    static dma_target_t tgt_dst = {
+        .ptr = (uint8_t *)dst,
+        .env = &env_dst,
+        .inc_du = 1,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    static dma_trans_t trans_1d = {
+        .src = &tgt_src,
+        .dst = &tgt_dst,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .dim = DMA_DIM_CONF_1D,
+        .end = DMA_TRANS_END_POLLING,
+    };
+
+    // A full matrix copied row by row
+    static dma_target_t tgt_src_2d = {
+        .ptr = (uint8_t *)src,
+        .inc_du = 1,
+        .inc_d2_du = 1,
+        .size_du = COLS,
+        .size_d2_du = ROWS,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    static dma_target_t tgt_dst_2d = {
+        .ptr = (uint8_t *)dst,
+        .inc_du = 1,
+        .inc_d2_du = 1,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    static dma_trans_t trans_2d = {
+        .src = &tgt_src_2d,
+        .dst = &tgt_dst_2d,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .dim = DMA_DIM_CONF_2D,
+        .end = DMA_TRANS_END_POLLING,
+    };
+
+    PRINTF("Validation cycles (average of %d)\n\r", ITERATIONS);
+
+    const dma_perf_checks_t levels[] = {
+        DMA_PERFORM_CHECKS_INTEGRITY,
+        DMA_PERFORM_CHECKS_ONLY_SANITY,
+        DMA_PERFORM_CHECKS_ONLY_CRITICAL,
+    };
+
+    for (int l = 0; l < sizeof(levels) / sizeof(levels[0]); l++)
+    {
+        uint32_t cycles_1d = validation_cycles(&trans_1d, levels[l]);
+        uint32_t cycles_2d = validation_cycles(&trans_2d, levels[l]);
+        PRINTF("%s: 1D %d, 2D %d\n\r", level_names[levels[l]], cycles_1d, cycles_2d);
+
+        errors += copy_errors(&trans_1d, levels[l], TEST_DATA_SIZE);
+        errors += copy_errors(&trans_2d, levels[l], ROWS * COLS);
+    }
+
+    if (errors)
+    {
+        PRINTF("FAILED with %d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("SUCCESS\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Copy of a buffer between two buffers of the interleaved banks:
+ *        - by the CPU;
+ *        - by the DMA SDK, through the 32-bit bus port of the DMA;
+ *        - by the DMA HAL, which uses the wide ports into the interleaved
+ *          banks when the MCU was generated with a `wide_width` of 64 or 128
+ *          in the `dma` entry of mcu_cfg.hjson.
+ *        The results are checked and the bytes per 100 cycles printed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "ram_bank.h"
+#include "dma.h"
+#include "dma_sdk.h"
+
+#define COPY_WORDS 1024
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+/* Aligned on a row of the wide ports, one word per lane. */
+static uint32_t RAM_INTERLEAVED __attribute__((aligned(16))) src[COPY_WORDS];
+static uint32_t RAM_INTERLEAVED __attribute__((aligned(16))) dst[COPY_WORDS];
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+static void clear_dst(void)
+{
+    for (uint32_t i = 0; i < COPY_WORDS; i++)
+    {
+        dst[i] = 0;
+    }
+}
+
+static int report(const char *name, unsigned int cycles)
+{
+    int errors = 0;
+    for (uint32_t i = 0; i < COPY_WORDS; i++)
+    {
+        if (dst[i] != src[i])
+        {
+            errors++;
+        }
+    }
+
+    PRINTF("%-10s %7u cycles %4u bytes/100 cycles %s\n\r", name, cycles,
+           cycles ? COPY_WORDS * 4 * 100 / cycles : 0, errors ? "WRONG" : "ok");
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+#ifndef HAS_MEMORY_BANKS_IL
+    PRINTF("This application is only meant to be tested when there are interleaved memory banks\n\r");
+    return EXIT_SUCCESS;
+#else
+    dma_config_flags_t res;
+    unsigned int cycles;
+    int errors = 0;
+
+    for (uint32_t i = 0; i < COPY_WORDS; i++)
+    {
+        src[i] = i * 2654435761u;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    dma_init(NULL);
+
+    PRINTF("%u words, wide ports of %u lanes:\n\r", COPY_WORDS, DMA_WIDE_LANES);
+
+    clear_dst();
+    cycles_start();
+    for (uint32_t i = 0; i < COPY_WORDS; i++)
+    {
+        dst[i] = src[i];
+    }
+    cycles = cycles_stop();
+    errors += report("CPU", cycles);
+
+    // The SDK programs the registers directly, without the wide ports
+    clear_dst();
+    cycles_start();
+    dma_copy_32b(dst, src, COPY_WORDS);
+    cycles = cycles_stop();
+    errors += report("DMA SDK", cycles);
+
+    dma_target_t tgt_src = {
+        .ptr = (uint8_t *)src,
+        .inc_du = 1,
+        .size_du = COPY_WORDS,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    dma_target_t tgt_dst = {
+        .ptr = (uint8_t *)dst,
+        .inc_du = 1,
+        .size_du = COPY_WORDS,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    dma_trans_t trans = {
+        .src = &tgt_src,
+        .dst = &tgt_dst,
+        .src_type = DMA_DATA_TYPE_WORD,
+        .dst_type = DMA_DATA_TYPE_WORD,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .win_du = 0,
+        .end = DMA_TRANS_END_POLLING,
+    };
+
+    clear_dst();
+    cycles_start();
+    res = dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    res |= dma_load_transaction(&trans);
+    res |= dma_launch(&trans);
+    while (!(res & DMA_CONFIG_CRITICAL_ERROR) && !dma_is_ready(0))
+    {
+    }
+    cycles = cycles_stop();
+    errors += report("DMA HAL", cycles);
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+#endif
+}
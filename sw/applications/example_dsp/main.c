@@ -0,0 +1,183 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Audio pipeline with the fixed-point library of dsp.h: a signal of two tones
+// and an offset goes, one block at a time as in the callback of a stream,
+// through a low-pass FIR decimating by 4, a DC-blocking biquad and the RMS and
+// peak meters, and its spectrum is computed with the radix-2 and radix-4 FFTs.
+// The blocks must give the same output as the whole signal at once, and the
+// FFTs the tone that the low-pass keeps. The cycles per input sample are
+// printed. With ARCH=rv32imc_zicsr_zifencei_xcvhwlp_xcvmem_xcvmac_xcvbi_xcvalu_xcvsimd_xcvbitmanip
+// on cv32e40px, the FIR uses the SIMD dot products of Xpulp.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "dsp.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define LEN 1024
+#define BLOCK 64
+#define FACTOR 4
+#define OUT_LEN (LEN / FACTOR)
+#define TAPS 16
+#define FFT_N OUT_LEN
+
+// Tones in periods per FFT_N output samples: the first one below the cut-off
+// of the low-pass, at an eighth of the input rate, the second one above
+#define TONE_KEPT 32
+#define TONE_CUT (3 * FFT_N / 2)
+
+// Largest accepted difference between the two FFTs
+#define FFT_TOLERANCE 16
+
+// Low-pass at an eighth of the rate, Hamming window, gain 0.99
+static const q15_t lowpass[TAPS] = {
+    -42, -175, -402, -349, 662, 2932, 5788, 7806, 7806, 5788, 2932, 662, -349, -402, -175, -42,
+};
+
+// y[n] = x[n] - x[n-1] + 0.98 y[n-1], the coefficients halved (post_shift 1)
+static const q15_t dc_block[5] = {16384, -16384, 0, -16056, 0};
+
+static q15_t signal[LEN];
+static q15_t out[OUT_LEN];
+static q15_t ref[OUT_LEN];
+
+static q15_t fir_history[DSP_FIR_HISTORY(TAPS, BLOCK)];
+static q15_t ref_history[DSP_FIR_HISTORY(TAPS, LEN)];
+static q15_t iir_state[DSP_BIQUAD_STATE(1)];
+static q15_t ref_state[DSP_BIQUAD_STATE(1)];
+
+static dsp_cq15_t tw[DSP_FFT_TWIDDLES(FFT_N)];
+static dsp_cq15_t fft2[FFT_N];
+static dsp_cq15_t fft4[FFT_N];
+
+static dsp_fir_q15_t fir;
+static dsp_biquad_q15_t iir;
+static uint32_t out_count = 0;
+static q15_t rms_max = 0;
+static q15_t peak_max = 0;
+
+// What the callback of an i2s_stream would do with each block, after
+// dsp_s32_to_q15() on its words
+static void process_block(const q15_t *block, uint32_t n)
+{
+    q15_t *dst = &out[out_count];
+    uint32_t count = dsp_fir_q15(&fir, block, dst, n);
+    dsp_biquad_q15(&iir, dst, dst, count);
+    q15_t rms = dsp_rms_q15(dst, count);
+    q15_t peak = dsp_peak_q15(dst, count);
+    rms_max = rms > rms_max ? rms : rms_max;
+    peak_max = peak > peak_max ? peak : peak_max;
+    out_count += count;
+}
+
+// Bin of the largest magnitude in the first half of a spectrum
+static uint32_t peak_bin(const dsp_cq15_t *x)
+{
+    uint32_t best = 0;
+    int32_t best_mag = -1;
+    for (uint32_t k = 0; k < FFT_N / 2; k++)
+    {
+        int32_t mag = (int32_t)x[k].re * x[k].re + (int32_t)x[k].im * x[k].im;
+        if (mag > best_mag)
+        {
+            best_mag = mag;
+            best = k;
+        }
+    }
+    return best;
+}
+
+#define TIME(cycles, call)                 \
+    do {                                   \
+        CSR_WRITE(CSR_REG_MCYCLE, 0);      \
+        call;                              \
+        CSR_READ(CSR_REG_MCYCLE, &cycles); \
+    } while (0)
+
+int main()
+{
+    uint32_t cycles;
+    uint32_t errors = 0;
+
+    for (int i = 0; i < LEN; i++)
+    {
+        float t = 6.28318530717958647692f * (float)i / (float)(FFT_N * FACTOR);
+        float v = 0.1f + 0.4f * sinf(TONE_KEPT * t) + 0.3f * sinf(TONE_CUT * t);
+        signal[i] = (q15_t)(v * 32767.0f);
+    }
+
+    //enable mcycle csr
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("CPU %s, FIR dot products: %s\n\r", CPU_TYPE, KERNELS_VERSION == KERNELS_XPULP ? "xpulp" : "plain");
+
+    // Block by block
+    if (dsp_fir_q15_init(&fir, lowpass, TAPS, fir_history, BLOCK, FACTOR) != 0 ||
+        dsp_biquad_q15_init(&iir, dc_block, 1, iir_state, 1) != 0)
+    {
+        PRINTF("init failed\n\r");
+        return EXIT_FAILURE;
+    }
+    TIME(cycles, for (uint32_t i = 0; i < LEN; i += BLOCK) process_block(&signal[i], BLOCK));
+    PRINTF("pipeline %u cycles, %u.%02u cycles/sample, rms %d peak %d\n\r", cycles, cycles / LEN,
+           (cycles * 100 / LEN) % 100, rms_max, peak_max);
+
+    // The whole signal at once
+    dsp_fir_q15_t ref_fir;
+    dsp_biquad_q15_t ref_iir;
+    dsp_fir_q15_init(&ref_fir, lowpass, TAPS, ref_history, LEN, FACTOR);
+    dsp_biquad_q15_init(&ref_iir, dc_block, 1, ref_state, 1);
+    uint32_t ref_count = dsp_fir_q15(&ref_fir, signal, ref, LEN);
+    dsp_biquad_q15(&ref_iir, ref, ref, ref_count);
+    if (ref_count != OUT_LEN || out_count != OUT_LEN)
+    {
+        errors++;
+    }
+    for (int i = 0; i < OUT_LEN; i++)
+    {
+        if (out[i] != ref[i]) errors++;
+    }
+    PRINTF("blocks vs whole signal: %s\n\r", errors ? "WRONG" : "ok");
+
+    // Spectrum of the filtered signal
+    dsp_fft_q15_twiddles(tw, FFT_N);
+    for (int i = 0; i < FFT_N; i++)
+    {
+        fft2[i].re = fft4[i].re = out[i];
+        fft2[i].im = fft4[i].im = 0;
+    }
+    TIME(cycles, dsp_fft_radix2_q15(fft2, tw, FFT_N));
+    PRINTF("fft radix-2 %u cycles, peak at bin %u\n\r", cycles, peak_bin(fft2));
+    TIME(cycles, dsp_fft_radix4_q15(fft4, tw, FFT_N));
+    PRINTF("fft radix-4 %u cycles, peak at bin %u\n\r", cycles, peak_bin(fft4));
+    if (peak_bin(fft2) != TONE_KEPT || peak_bin(fft4) != TONE_KEPT)
+    {
+        errors++;
+    }
+    for (int i = 0; i < FFT_N; i++)
+    {
+        if (abs(fft2[i].re - fft4[i].re) > FFT_TOLERANCE || abs(fft2[i].im - fft4[i].im) > FFT_TOLERANCE)
+        {
+            errors++;
+        }
+    }
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
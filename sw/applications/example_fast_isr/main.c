@@ -0,0 +1,155 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Entry latency and round trip of the fast GPIO 1 interrupt, with the
+ *        handler of fast_intr_ctrl.c calling fic_irq_gpio_1(), or with a leaf
+ *        handler of isr.h replacing it (LEAF_ISR below). The entry is
+ *        measured from the raise of the line to the first instruction of the
+ *        body of the handler, the round trip until the main program runs
+ *        again. The testharness interrupt trigger raises the line a known
+ *        number of cycles after it is armed. Build it with both values of
+ *        LEAF_ISR and compare, with riscv32-unknown-elf-objdump -d, the
+ *        registers saved by the two handlers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "gpio.h"
+#include "gpio_regs.h"
+#include "fast_intr_ctrl.h"
+#include "irq_trigger.h"
+#include "isr.h"
+#include "x-heep.h"
+
+/* The trigger only exists in simulation, so do print there. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#if !TARGET_SIM
+  #error ( "This app needs the interrupt trigger of the testharness" )
+#endif
+
+/* 1: leaf handler of isr.h, 0: handler of fast_intr_ctrl.c */
+#define LEAF_ISR 1
+
+#define RUNS 32
+// Cycles between the arm of the trigger and the interrupt
+#define TRIGGER_DELAY 64
+
+#define MIE_FAST_GPIO_1  (1 << ISR_IRQ_FAST(kGpio_1_fic_e))
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+} latency_t;
+
+static volatile uint32_t t_entry;
+static volatile bool served;
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+#if LEAF_ISR
+
+// Nothing is called, so only the registers of the body are saved
+ISR_LEAF_HANDLER(handler_irq_fast_gpio_1)
+{
+    t_entry = cycles();
+    // The status is write-1-to-clear, the pin is one of the AO domain
+    *(volatile uint32_t *)(GPIO_AO_START_ADDRESS + GPIO_INTRPT_STATUS_REG_OFFSET) =
+        1 << IRQ_TRIGGER_GPIO;
+    clear_fast_interrupt_inline(kGpio_1_fic_e);
+    served = true;
+}
+
+#else
+
+void fic_irq_gpio_1(void)
+{
+    t_entry = cycles();
+    gpio_intr_clear_stat(IRQ_TRIGGER_GPIO);
+    // The controller latches the level, which was high until the line above
+    clear_fast_interrupt(kGpio_1_fic_e);
+    served = true;
+}
+
+#endif
+
+static void latency_add(latency_t *l, uint32_t value)
+{
+    if (l->count == 0 || value < l->min) l->min = value;
+    if (l->count == 0 || value > l->max) l->max = value;
+    l->sum += value;
+    l->count++;
+}
+
+static void latency_print(const char *source, const latency_t *l)
+{
+    PRINTF("%-10s %-12s %6d %6d %6d %6d\n\r", CPU_TYPE, source,
+           l->min, l->sum / l->count, l->max, l->max - l->min);
+}
+
+int main(int argc, char *argv[])
+{
+    latency_t entry = {0}, round_trip = {0};
+
+    gpio_cfg_t cfg_in = {
+        .pin = IRQ_TRIGGER_GPIO,
+        .mode = GpioModeIn,
+        .en_input_sampling = true,
+        .en_intr = true,
+        .intr_type = GpioIntrEdgeRising
+    };
+    if (gpio_config(cfg_in) != GpioOk) {
+        PRINTF("GPIO config failed\n\r");
+        return EXIT_FAILURE;
+    }
+    enable_fast_interrupt(kGpio_1_fic_e, true);
+    irq_trigger_set_delay(TRIGGER_DELAY - IRQ_TRIGGER_ARM_CYCLES);
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_FAST_GPIO_1);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    for (int i = 0; i < RUNS; i++) {
+        served = false;
+        uint32_t t_start = cycles();
+        irq_trigger_arm(IRQ_TRIGGER_LINE_GPIO);
+        while (!served) {
+        }
+        uint32_t t_back = cycles();
+        irq_trigger_clear();
+
+        latency_add(&entry, t_entry - t_start - TRIGGER_DELAY);
+        latency_add(&round_trip, t_back - t_start - TRIGGER_DELAY);
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+
+    PRINTF("handler: %s\n\r", LEAF_ISR ? "leaf" : "fast_intr_ctrl");
+    PRINTF("%-10s %-12s %6s %6s %6s %6s\n\r", "cpu", "gpio 1", "min", "mean", "max", "jitter");
+    latency_print("entry", &entry);
+    latency_print("round trip", &round_trip);
+
+    return EXIT_SUCCESS;
+}
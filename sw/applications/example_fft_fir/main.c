@@ -0,0 +1,200 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// FFT and FIR accelerator of the testharness against the DSP SDK: a square
+// wave with noise goes through the FIR alone, then through the FIR and the
+// FFT, fed and drained by two DMA channels paced by the trigger slots of the
+// accelerator (by the CPU with a single channel). The results must be the
+// ones of dsp_fir_q15() and dsp_fft_radix2_q15(), and the cycles of both are
+// printed. fft_fir_stream.h chains the PDM2PCM to the accelerator the same way.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "rv_plic.h"
+#include "dma.h"
+#include "dsp.h"
+#include "fft_fir.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define LOG2N 8
+#define FFT_N (1 << LOG2N)
+#define TAPS 16
+
+static q15_t signal[FFT_N];
+static uint32_t __attribute__((aligned(4))) words[FFT_N];
+static uint32_t __attribute__((aligned(4))) result[FFT_N];
+
+static q15_t lowpass[TAPS];
+static q15_t history[DSP_FIR_HISTORY(TAPS, FFT_N)];
+static q15_t filtered[FFT_N];
+static dsp_cq15_t spectrum[FFT_N];
+static dsp_cq15_t tw[DSP_FFT_TWIDDLES(FFT_N)];
+
+static dma_target_t mem_in, mem_out, acc_in, acc_out;
+static dma_trans_t trans_in, trans_out;
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+// Streams the words into the accelerator and its results out of it
+static dma_config_flags_t run_accelerator(uint32_t out_words)
+{
+#if DMA_CH_NUM > 1
+    mem_in = (dma_target_t){.ptr = (uint8_t *)words, .inc_du = 1, .size_du = FFT_N,
+                            .type = DMA_DATA_TYPE_WORD, .trig = DMA_TRIG_MEMORY};
+    acc_in = (dma_target_t){.ptr = (uint8_t *)(FFT_FIR_START_ADDRESS + FFT_FIR_DATA_IN_REG_OFFSET),
+                            .inc_du = 0, .type = DMA_DATA_TYPE_WORD, .trig = DMA_TRIG_SLOT_EXT_ACC_TX};
+    acc_out = (dma_target_t){.ptr = (uint8_t *)(FFT_FIR_START_ADDRESS + FFT_FIR_DATA_OUT_REG_OFFSET),
+                             .inc_du = 0, .size_du = out_words, .type = DMA_DATA_TYPE_WORD,
+                             .trig = DMA_TRIG_SLOT_EXT_ACC_RX};
+    mem_out = (dma_target_t){.ptr = (uint8_t *)result, .inc_du = 1, .type = DMA_DATA_TYPE_WORD,
+                             .trig = DMA_TRIG_MEMORY};
+    trans_in = (dma_trans_t){.src = &mem_in, .dst = &acc_in, .mode = DMA_TRANS_MODE_SINGLE,
+                             .end = DMA_TRANS_END_INTR, .channel = 0};
+    trans_out = (dma_trans_t){.src = &acc_out, .dst = &mem_out, .mode = DMA_TRANS_MODE_SINGLE,
+                              .end = DMA_TRANS_END_INTR, .channel = 1};
+
+    // The output is drained while the input is fed, each paced by its slot
+    dma_config_flags_t res = dma_enqueue_transaction(&trans_out, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    res |= dma_enqueue_transaction(&trans_in, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    if (res & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        return res;
+    }
+    dma_queue_wait(0);
+    dma_queue_wait(1);
+    return res;
+#else
+    uint32_t in = 0, out = 0;
+    while (out < out_words)
+    {
+        uint32_t status = fft_fir_status();
+        if (in < FFT_N && (status & (1 << FFT_FIR_STATUS_IN_READY_BIT)))
+        {
+            fft_fir_push(words[in++]);
+        }
+        if (status & (1 << FFT_FIR_STATUS_OUT_VALID_BIT))
+        {
+            result[out++] = fft_fir_pop();
+        }
+    }
+    return DMA_CONFIG_OK;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    dsp_fir_q15_t fir;
+    unsigned int hw_cycles, sw_cycles;
+    int errors = 0;
+
+    // Square wave of 32 samples per period, with noise
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < FFT_N; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        signal[i] = (((i / 16) & 1) ? 6000 : -6000) + (int32_t)((seed >> 20) & 0x7ff) - 1024;
+        words[i] = (uint32_t)(uint16_t)signal[i] << 16;
+    }
+    // Triangular low-pass, reversed in time as it is symmetric
+    for (uint32_t k = 0; k < TAPS; k++)
+    {
+        lowpass[k] = (k < TAPS / 2 ? k + 1 : TAPS - k) * 455;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
+
+    if (plic_Init())
+    {
+        return EXIT_FAILURE;
+    }
+    dma_init(NULL);
+
+    // FIR alone: each output sign-extended to a word
+    fft_fir_config_t config = {.fir = true, .fft = false, .half = false,
+                               .log2n = LOG2N, .in_shift = 0, .taps = TAPS};
+    fft_fir_configure(&config);
+    fft_fir_load_coeffs(lowpass, TAPS);
+    cycles_start();
+    dma_config_flags_t res = run_accelerator(FFT_N);
+    hw_cycles = cycles_stop();
+
+    dsp_fir_q15_init(&fir, lowpass, TAPS, history, FFT_N, 1);
+    cycles_start();
+    dsp_fir_q15(&fir, signal, filtered, FFT_N);
+    sw_cycles = cycles_stop();
+
+    int fir_errors = (res & DMA_CONFIG_CRITICAL_ERROR) ? FFT_N : 0;
+    for (uint32_t i = 0; i < FFT_N && !fir_errors; i++)
+    {
+        fir_errors += result[i] != (uint32_t)(int32_t)filtered[i];
+    }
+    PRINTF("FIR %u taps, %u samples: accelerator %u cycles, dsp_fir_q15 %u cycles %s\n\r",
+           TAPS, FFT_N, hw_cycles, sw_cycles, fir_errors ? "WRONG" : "ok");
+    errors += fir_errors;
+
+    // FIR and FFT: the bins with the imaginary part in the upper halfword
+    config.fft = true;
+    fft_fir_configure(&config);
+    fft_fir_load_coeffs(lowpass, TAPS);
+    dsp_fft_q15_twiddles(tw, FFT_N);
+    fft_fir_load_twiddles((const uint32_t *)tw, FFT_N / 2);
+    cycles_start();
+    res = run_accelerator(FFT_N);
+    hw_cycles = cycles_stop();
+
+    dsp_fir_q15_init(&fir, lowpass, TAPS, history, FFT_N, 1);
+    cycles_start();
+    dsp_fir_q15(&fir, signal, filtered, FFT_N);
+    for (uint32_t i = 0; i < FFT_N; i++)
+    {
+        spectrum[i] = (dsp_cq15_t){.re = filtered[i], .im = 0};
+    }
+    dsp_fft_radix2_q15(spectrum, tw, FFT_N);
+    sw_cycles = cycles_stop();
+
+    int fft_errors = (res & DMA_CONFIG_CRITICAL_ERROR) ? FFT_N : 0;
+    for (uint32_t i = 0; i < FFT_N && !fft_errors; i++)
+    {
+        uint32_t bin = (uint16_t)spectrum[i].re | ((uint32_t)(uint16_t)spectrum[i].im << 16);
+        fft_errors += result[i] != bin;
+    }
+    PRINTF("FIR and FFT %u points: accelerator %u cycles, dsp %u cycles %s\n\r",
+           FFT_N, hw_cycles, sw_cycles, fft_errors ? "WRONG" : "ok");
+    errors += fft_errors;
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
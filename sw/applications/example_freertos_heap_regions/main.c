@@ -0,0 +1,153 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Placement of FreeRTOS allocations in the RAM regions of the linker
+ *        sections (sw/freertos/heap_regions.h). The task stacks come from the
+ *        default region in the data section, the buffers of the workers from
+ *        the interleaved banks when the configuration has them. At the end,
+ *        the use and the high-water mark of every region are printed with the
+ *        banks they span.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* FreeRTOS kernel includes */
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_timer.h"
+#include "heap_regions.h"
+#include "ram_bank.h"
+#include "x-heep.h"
+
+#define N_WORKERS  2
+#define BUFFER_LEN 256
+
+// Bits of MIE
+#define MIE_MTIE (1 << 7)
+
+/* Allocate heap to special section, kept with "used" since nothing refers to it */
+__attribute__((section(".heap"), used)) uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+
+/* Timer 0 AO Domain as Tick Counter */
+static rv_timer_t timer_0_1;
+
+static BaseType_t buffer_region;
+static volatile uint32_t sums[N_WORKERS];
+static volatile uint32_t done;
+
+static void prvWorkerTask(void *pvParameters)
+{
+    uint32_t id = (uint32_t)pvParameters;
+    uint32_t *buffer, sum = 0;
+
+    buffer = pvPortMallocRegion(BUFFER_LEN * sizeof(uint32_t), buffer_region);
+    if (buffer != NULL) {
+        for (int i = 0; i < BUFFER_LEN; i++) {
+            buffer[i] = i * (id + 1);
+        }
+        for (int i = 0; i < BUFFER_LEN; i++) {
+            sum += buffer[i];
+        }
+        vPortFree(buffer);
+    }
+
+    sums[id] = sum;
+    taskENTER_CRITICAL();
+    done++;
+    taskEXIT_CRITICAL();
+    vTaskDelete(NULL);
+}
+
+static void prvReportTask(void *pvParameters)
+{
+    HeapRegionStats_t stats;
+    int errors = 0;
+
+    (void)pvParameters;
+
+    while (done < N_WORKERS) {
+        vTaskDelay(1);
+    }
+
+    for (uint32_t id = 0; id < N_WORKERS; id++) {
+        if (sums[id] != (id + 1) * BUFFER_LEN * (BUFFER_LEN - 1) / 2) {
+            printf("worker %d: wrong sum %d\n\r", id, sums[id]);
+            errors++;
+        }
+    }
+
+    printf("%-18s %10s %6s %6s %6s %6s %6s\n\r", "region", "banks", "size", "free", "peak", "allocs", "frees");
+    for (BaseType_t r = 0; r < heapREGION_COUNT; r++) {
+        vPortGetHeapRegionStats(r, &stats);
+        printf("%-18s 0x%08x %6d %6d %6d %6d %6d\n\r", stats.pcName,
+               ram_banks_of(stats.pvStart, stats.xTotalSize), stats.xTotalSize, stats.xFreeSize,
+               stats.xTotalSize - stats.xMinimumEverFreeSize, stats.xAllocations, stats.xFrees);
+    }
+
+    taskDISABLE_INTERRUPTS();
+    exit(errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    // The tick of the scheduler is the comparator 0 of timer 0
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MTIE);
+
+    // The interleaved section only has room for the heap with link.ld
+    HeapRegionStats_t stats;
+    vPortGetHeapRegionStats(heapREGION_INTERLEAVED, &stats);
+    buffer_region = stats.xTotalSize >= N_WORKERS * 2 * BUFFER_LEN * sizeof(uint32_t) ?
+                    heapREGION_INTERLEAVED : heapREGION_DEFAULT;
+
+    // The stacks stay in the data section, whose banks are always in use
+    vPortSetHeapStackRegion(heapREGION_DEFAULT);
+
+    for (uint32_t id = 0; id < N_WORKERS; id++) {
+        xTaskCreate(prvWorkerTask, "Worker", configMINIMAL_STACK_SIZE * 2U, (void *)id,
+                    tskIDLE_PRIORITY + 1, NULL);
+    }
+    xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 4U, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+
+    // The scheduler enables the interrupts
+    vTaskStartScheduler();
+
+    // Only reached if there is not enough heap for the idle task
+    return EXIT_FAILURE;
+}
+
+/* Hooks enabled in FreeRTOSConfig.h */
+
+void vApplicationMallocFailedHook(void)
+{
+    taskDISABLE_INTERRUPTS();
+    printf("malloc failed\n\r");
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationIdleHook(void)
+{
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName)
+{
+    (void)pxTask;
+    taskDISABLE_INTERRUPTS();
+    printf("stack overflow in %s\n\r", pcTaskName);
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationTickHook(void)
+{
+}
@@ -0,0 +1,283 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: CPU left to the other tasks during DMA and flash transfers, with the
+ *        busy-waiting drivers and with the blocking ones of rtos_io.h. A task
+ *        of low priority counts in a loop, and a task of higher priority runs
+ *        each transfer: the availability is the count reached during the
+ *        transfer over the one reached in as many cycles without transfer.
+ *        The busy drivers keep the core in the transfer task (0%), while the
+ *        blocking ones give it to the counter until the interrupt, minus the
+ *        context switches. The flash model of the simulation may erase at
+ *        once, the erase figures are meant for the FPGA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes */
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "rv_timer.h"
+#include "fast_intr_ctrl.h"
+#include "dma.h"
+#include "dma_sdk.h"
+#include "w25q128jw.h"
+#include "rtos_io.h"
+#include "x-heep.h"
+
+/* The report is the point of the application, it is printed everywhere */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#if defined(TARGET_PYNQ_Z2) || defined(TARGET_ZCU104) || defined(TARGET_NEXYS_A7_100T)
+    #define USE_SPI_FLASH
+#endif
+
+// Words of a DMA copy, copied COPY_REPS times per run
+#define COPY_WORDS 1024
+#define COPY_REPS  8
+
+// Bytes of a flash read, at the start of the flash (the program when booted from it)
+#define READ_BYTES 4096
+
+// Sector erased by the erase runs, at the end of the 16MB flash
+#define SCRATCH_ADDR 0x00FFF000
+#define SECTOR_BYTES 4096
+
+// Bits of MIE
+#define MIE_MTIE     (1 << 7)
+#define MIE_MEIE     (1 << 11)
+#define MIE_FAST_DMA (1 << (16 + kDma_fic_e))
+
+/* Allocate heap to special section, kept with "used" since nothing refers to it */
+__attribute__((section(".heap"), used)) uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+
+/* Timer 0 AO Domain as Tick Counter */
+static rv_timer_t timer_0_1;
+
+static uint32_t copy_src[COPY_WORDS];
+static uint32_t copy_dst[COPY_WORDS];
+
+static uint8_t __attribute__((aligned(4))) read_busy[READ_BYTES];
+static uint8_t __attribute__((aligned(4))) read_rtos[READ_BYTES];
+
+// Counted by the low priority task
+static volatile uint32_t spins;
+
+static uint32_t errors;
+
+typedef void (*io_fn_t)(void);
+
+typedef struct {
+    const char *name;
+    io_fn_t busy;
+    io_fn_t rtos;
+} io_case_t;
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+static void copy_busy(void)
+{
+    for (int i = 0; i < COPY_REPS; i++) {
+        dma_copy_32b(copy_dst, copy_src, COPY_WORDS);
+    }
+}
+
+static void copy_rtos(void)
+{
+    for (int i = 0; i < COPY_REPS; i++) {
+        if (xRtosIoDmaCopy(copy_dst, copy_src, COPY_WORDS, portMAX_DELAY) != pdPASS) errors++;
+    }
+}
+
+static void read_flash_busy(void)
+{
+    if (w25q128jw_read_quad_dma(0, read_busy, READ_BYTES) != FLASH_OK) errors++;
+}
+
+static void read_flash_rtos(void)
+{
+    if (xRtosIoFlashReadQuadDma(0, read_rtos, READ_BYTES) != FLASH_OK) errors++;
+}
+
+static void erase_busy(void)
+{
+    /* Without the scheduler, the BSP spins on the status register */
+    vTaskSuspendAll();
+    if (w25q128jw_4k_erase(SCRATCH_ADDR) != FLASH_OK) errors++;
+    (void)xTaskResumeAll();
+}
+
+static void erase_rtos(void)
+{
+    if (xRtosIoFlashErase(SCRATCH_ADDR, SECTOR_BYTES) != FLASH_OK) errors++;
+}
+
+static const io_case_t io_cases[] = {
+    {"dma copy",   copy_busy,       copy_rtos},
+    {"flash read", read_flash_busy, read_flash_rtos},
+    {"flash erase", erase_busy,     erase_rtos},
+};
+
+#define N_IO_CASES (sizeof(io_cases) / sizeof(io_cases[0]))
+
+// Counts reached by the counter task in ref_cycles cycles without transfer
+static uint32_t ref_spins;
+static uint32_t ref_cycles;
+
+static void measure(const char *name, const char *driver, io_fn_t fn)
+{
+    uint32_t s0 = spins;
+    uint32_t c0 = cycles();
+    fn();
+    uint32_t c = cycles() - c0;
+    uint32_t s = spins - s0;
+
+    // Percent of the count of ref_spins / ref_cycles
+    uint64_t full = (uint64_t)ref_spins * c;
+    uint32_t avail = full ? (uint32_t)(((uint64_t)s * ref_cycles * 100) / full) : 0;
+
+    PRINTF("%-12s %-6s %10u %5u%%\n\r", name, driver, c, avail);
+}
+
+static void prvCounterTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        spins++;
+    }
+}
+
+static void prvIoTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    // The counter runs while this task sleeps
+    uint32_t s0 = spins;
+    uint32_t c0 = cycles();
+    vTaskDelay(10);
+    ref_cycles = cycles() - c0;
+    ref_spins = spins - s0;
+
+    PRINTF("CPU availability, %u counts in %u cycles without transfer\n\r", ref_spins, ref_cycles);
+    PRINTF("%-12s %-6s %10s %6s\n\r", "transfer", "driver", "cycles", "cpu");
+
+    for (uint32_t i = 0; i < N_IO_CASES; i++) {
+        measure(io_cases[i].name, "busy", io_cases[i].busy);
+        measure(io_cases[i].name, "rtos", io_cases[i].rtos);
+    }
+
+    if (memcmp(read_busy, read_rtos, READ_BYTES) != 0) errors++;
+    for (uint32_t i = 0; i < COPY_WORDS; i++) {
+        errors += copy_dst[i] != copy_src[i];
+    }
+
+    taskDISABLE_INTERRUPTS();
+    PRINTF("program finished with %d errors\n\r", errors);
+    exit(errors ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+    if (get_spi_flash_mode(&soc_ctrl) == SOC_CTRL_SPI_FLASH_MODE_SPIMEMIO) {
+        PRINTF("This application cannot work with the memory mapped SPI FLASH"
+            "module - do not use the FLASH_EXEC linker script for this application\n");
+        return EXIT_SUCCESS;
+    }
+
+    // Pick the correct spi device based on simulation type
+    spi_host_t* spi;
+    #ifndef USE_SPI_FLASH
+    spi = spi_host1;
+    #else
+    spi = spi_flash;
+    #endif
+
+    if (w25q128jw_init(spi) != FLASH_OK) return EXIT_FAILURE;
+
+    if (plic_Init() != kPlicOk) {
+        PRINTF("Init PLIC failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < COPY_WORDS; i++) {
+        copy_src[i] = i * 3 + 1;
+    }
+
+    vRtosIoInit();
+
+    // The blocking drivers wait for the transaction done interrupt of the DMA
+    dma_init(NULL);
+    enable_fast_interrupt(kDma_fic_e, true);
+
+    // The tick of the scheduler is the comparator 0 of timer 0
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MTIE | MIE_MEIE | MIE_FAST_DMA);
+
+    xTaskCreate(prvCounterTask, "Counter", configMINIMAL_STACK_SIZE, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+    xTaskCreate(prvIoTask, "Io", configMINIMAL_STACK_SIZE * 4U, NULL,
+                tskIDLE_PRIORITY + 2, NULL);
+
+    // The scheduler enables the interrupts
+    vTaskStartScheduler();
+
+    // Only reached if there is not enough heap for the idle task
+    return EXIT_FAILURE;
+}
+
+/* Hooks enabled in FreeRTOSConfig.h */
+
+void vApplicationMallocFailedHook(void)
+{
+    taskDISABLE_INTERRUPTS();
+    printf("malloc failed\n\r");
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationIdleHook(void)
+{
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName)
+{
+    (void)pxTask;
+    taskDISABLE_INTERRUPTS();
+    printf("stack overflow in %s\n\r", pcTaskName);
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationTickHook(void)
+{
+}
@@ -0,0 +1,235 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Interrupt latency and jitter through the FreeRTOS trap handler
+ *        (vectors_freertos.S), measured from a task while the scheduler and
+ *        its tick run, with the same testharness interrupt trigger and
+ *        sources as example_irq_latency:
+ *        - GPIO 1 through the fast interrupt controller
+ *        - an external line through the PLIC
+ *        The latency is the one of the first instruction of the C handler,
+ *        after the port has saved the context of the interrupted task.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* FreeRTOS kernel includes */
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "rv_timer.h"
+#include "gpio.h"
+#include "fast_intr_ctrl.h"
+#include "irq_trigger.h"
+#include "x-heep.h"
+
+#if !TARGET_SIM
+  #error ( "This app needs the interrupt trigger of the testharness" )
+#endif
+
+#ifndef RV_PLIC_IS_INCLUDED
+  #error ( "This app does NOT work as the RV_PLIC peripheral is not included" )
+#endif
+
+#define RUNS 32
+// Cycles between the arm of the trigger and the interrupt
+#define TRIGGER_DELAY 64
+
+// Bits of MIE
+#define MIE_MTIE        (1 << 7)
+#define MIE_MEIE        (1 << 11)
+#define MIE_FAST_GPIO_1 (1 << (16 + kGpio_1_fic_e))
+
+// mcause of the interrupts, without the interrupt bit
+#define MCAUSE_CODE_MASK     0x7FFFFFFF
+#define MCAUSE_EXTERNAL      11
+#define MCAUSE_FAST_GPIO_1   (16 + kGpio_1_fic_e)
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+} latency_t;
+
+/* Allocate heap to special section, kept with "used" since nothing refers to it */
+__attribute__((section(".heap"), used)) uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+
+/* Timer 0 AO Domain as Tick Counter */
+static rv_timer_t timer_0_1;
+
+static volatile uint32_t t_start;
+static volatile uint32_t t_entry;
+static volatile bool served;
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+static void latency_add(latency_t *l, uint32_t value)
+{
+    if (l->count == 0 || value < l->min) l->min = value;
+    if (l->count == 0 || value > l->max) l->max = value;
+    l->sum += value;
+    l->count++;
+}
+
+static void latency_print(const char *source, const latency_t *l)
+{
+    printf("%-10s %-14s %6d %6d %6d %6d\n\r", CPU_TYPE, source,
+           l->min, l->sum / l->count, l->max, l->max - l->min);
+}
+
+/**
+ * Called by the FreeRTOS port for the interrupts other than the machine timer.
+ * The handlers of vectors.S return with mret, so the sources are served here.
+ */
+void freertos_risc_v_application_interrupt_handler(uint32_t mcause)
+{
+    uint32_t t = cycles();
+
+    switch (mcause & MCAUSE_CODE_MASK) {
+    case MCAUSE_FAST_GPIO_1:
+        gpio_intr_clear_stat(IRQ_TRIGGER_GPIO);
+        clear_fast_interrupt(kGpio_1_fic_e);
+        break;
+    case MCAUSE_EXTERNAL: {
+        uint32_t id;
+        plic_irq_claim(&id);
+        if (id == IRQ_TRIGGER_PLIC_INTR) {
+            irq_trigger_clear();
+        }
+        plic_irq_complete(&id);
+        break;
+    }
+    default:
+        return;
+    }
+
+    t_entry = t;
+    served = true;
+}
+
+/**
+ * Same handler under the name given to portasmHANDLE_INTERRUPT in
+ * sw/CMakeLists.txt, for the ports that still call it.
+ */
+void vSystemIrqHandler(uint32_t mcause)
+{
+    freertos_risc_v_application_interrupt_handler(mcause);
+}
+
+// Cycles from the raise of the trigger lines to the handler
+static uint32_t measure_trigger(uint32_t lines)
+{
+    served = false;
+    t_start = cycles();
+    irq_trigger_arm(lines);
+    while (!served) {
+    }
+    return t_entry - t_start - TRIGGER_DELAY;
+}
+
+static void prvLatencyTask(void *pvParameters)
+{
+    latency_t fast_gpio = {0}, plic = {0};
+
+    (void)pvParameters;
+
+    for (int i = 0; i < RUNS; i++) {
+        latency_add(&fast_gpio, measure_trigger(IRQ_TRIGGER_LINE_GPIO));
+        irq_trigger_clear();
+        latency_add(&plic, measure_trigger(IRQ_TRIGGER_LINE_PLIC));
+        // Let the tick interrupt the next runs at different points
+        vTaskDelay(1);
+    }
+
+    taskDISABLE_INTERRUPTS();
+    irq_trigger_clear();
+
+    printf("FreeRTOS trap handler\n\r");
+    printf("%-10s %-14s %6s %6s %6s %6s\n\r", "cpu", "source", "min", "mean", "max", "jitter");
+    latency_print("fast gpio", &fast_gpio);
+    latency_print("plic", &plic);
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    if (plic_Init() != kPlicOk) {
+        printf("Init PLIC failed\n\r");
+        return EXIT_FAILURE;
+    }
+    plic_irq_set_priority(IRQ_TRIGGER_PLIC_INTR, 1);
+    plic_irq_set_enabled(IRQ_TRIGGER_PLIC_INTR, kPlicToggleEnabled);
+
+    gpio_cfg_t cfg_in = {
+        .pin = IRQ_TRIGGER_GPIO,
+        .mode = GpioModeIn,
+        .en_input_sampling = true,
+        .en_intr = true,
+        .intr_type = GpioIntrEdgeRising
+    };
+    if (gpio_config(cfg_in) != GpioOk) {
+        printf("GPIO config failed\n\r");
+        return EXIT_FAILURE;
+    }
+    enable_fast_interrupt(kGpio_1_fic_e, true);
+
+    irq_trigger_set_delay(TRIGGER_DELAY - IRQ_TRIGGER_ARM_CYCLES);
+
+    // The tick of the scheduler is the comparator 0 of timer 0
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MTIE | MIE_MEIE | MIE_FAST_GPIO_1);
+
+    xTaskCreate(prvLatencyTask, "Latency", configMINIMAL_STACK_SIZE * 4U, NULL,
+                tskIDLE_PRIORITY + 1, NULL);
+
+    // The scheduler enables the interrupts
+    vTaskStartScheduler();
+
+    // Only reached if there is not enough heap for the idle task
+    return EXIT_FAILURE;
+}
+
+/* Hooks enabled in FreeRTOSConfig.h */
+
+void vApplicationMallocFailedHook(void)
+{
+    taskDISABLE_INTERRUPTS();
+    printf("malloc failed\n\r");
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationIdleHook(void)
+{
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName)
+{
+    (void)pxTask;
+    taskDISABLE_INTERRUPTS();
+    printf("stack overflow in %s\n\r", pcTaskName);
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationTickHook(void)
+{
+}
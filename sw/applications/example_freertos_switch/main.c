@@ -0,0 +1,294 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Cost of the FreeRTOS scheduler on the CPU of the configuration, in
+ *        cycles of mcycle:
+ *        - yield: taskYIELD() to a task of the same priority, to the first
+ *          instruction of that task after its own yield;
+ *        - notify: xTaskNotifyGive() to a task of higher priority blocked on
+ *          it, to the first instruction of that task;
+ *        - queue wake: xQueueSend() to a task of higher priority blocked on
+ *          the queue, to the first instruction after its xQueueReceive();
+ *        - queue send, queue receive: xQueueSend() and xQueueReceive() on a
+ *          queue nobody waits for, without a context switch.
+ *        Then the run-time statistics of each task are printed, in cycles
+ *        (configGENERATE_RUN_TIME_STATS on mcycle, see port_trace.h). With
+ *        FREERTOS_TRACE=1 the scheduler is also traced with DLOG, and the
+ *        log is dumped to the UART at the end: decode it with
+ *        util/dlog_decode.py.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/* FreeRTOS kernel includes */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_timer.h"
+#include "uart.h"
+#include "soc_ctrl.h"
+#include "dlog.h"
+#include "x-heep.h"
+
+#define RUNS 32
+
+// Bits of MIE
+#define MIE_MTIE (1 << 7)
+
+// Tasks of uxTaskGetSystemState(), the ones of the app, the idle and timer tasks
+#define MAX_TASKS 8
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+} latency_t;
+
+/* Allocate heap to special section, kept with "used" since nothing refers to it */
+__attribute__((section(".heap"), used)) uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+
+/* Timer 0 AO Domain as Tick Counter */
+static rv_timer_t timer_0_1;
+
+#if configUSE_DLOG_TRACE
+#define LOG_WORDS 4096
+static uint32_t log_buffer[LOG_WORDS];
+#endif
+
+static TaskHandle_t xMainTask, xPeerTask, xHighTask;
+static QueueHandle_t xQueue;
+
+// Cycle at which the measured operation started
+static volatile uint32_t t_start;
+// Set by the main task while the peer takes turns with it
+static volatile BaseType_t xYielding;
+
+static latency_t yield, notify, queue_wake, queue_send, queue_receive;
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+static void latency_add(latency_t *l, uint32_t value)
+{
+    if (l->count == 0 || value < l->min) l->min = value;
+    if (l->count == 0 || value > l->max) l->max = value;
+    l->sum += value;
+    l->count++;
+}
+
+static void latency_print(const char *name, const latency_t *l)
+{
+    printf("%-10s %-14s %6u %6u %6u\n\r", CPU_TYPE, name,
+           l->min, l->count ? l->sum / l->count : 0, l->max);
+}
+
+// Same priority as the main task: the two of them take turns at each yield
+static void prvPeerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    // Either of the two can run first, the measures start with the main task
+    while (!xYielding) {
+        taskYIELD();
+    }
+
+    while (xYielding) {
+        uint32_t t = cycles();
+        latency_add(&yield, t - t_start);
+        t_start = cycles();
+        taskYIELD();
+    }
+
+    vTaskSuspend(NULL);
+}
+
+// Higher priority than the main task: woken by a notification, then by the queue
+static void prvHighTask(void *pvParameters)
+{
+    uint32_t t, sent;
+
+    (void)pvParameters;
+
+    for (int i = 0; i < RUNS; i++) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        t = cycles();
+        latency_add(&notify, t - t_start);
+    }
+
+    for (int i = 0; i < RUNS; i++) {
+        xQueueReceive(xQueue, &sent, portMAX_DELAY);
+        t = cycles();
+        latency_add(&queue_wake, t - sent);
+    }
+
+    vTaskSuspend(NULL);
+}
+
+static void print_run_time_stats(void)
+{
+    TaskStatus_t tasks[MAX_TASKS];
+    configRUN_TIME_COUNTER_TYPE total;
+    UBaseType_t n = uxTaskGetSystemState(tasks, MAX_TASKS, &total);
+
+    printf("%-12s %6s %12s %5s\n\r", "task", "number", "cycles", "share");
+    for (UBaseType_t i = 0; i < n; i++) {
+        uint32_t share = total ? (uint32_t)(tasks[i].ulRunTimeCounter * 100 / total) : 0;
+        printf("%-12s %6u %12u %4u%%\n\r", tasks[i].pcTaskName, (uint32_t)tasks[i].xTaskNumber,
+               (uint32_t)tasks[i].ulRunTimeCounter, share);
+    }
+}
+
+#if configUSE_DLOG_TRACE
+static void dump_trace(void)
+{
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+    uart_t uart;
+    uart.base_addr   = mmio_region_from_addr((uintptr_t)UART_START_ADDRESS);
+    uart.baudrate    = UART_BAUDRATE;
+    uart.clk_freq_hz = soc_ctrl_get_frequency(&soc_ctrl);
+
+    if (uart_init(&uart) == kErrorOk) {
+        dlog_dump(uart_sink, &uart);
+    }
+}
+#endif
+
+static void prvMainTask(void *pvParameters)
+{
+    uint32_t t;
+
+    (void)pvParameters;
+
+    // yield: the peer measures the switches to it, this task the ones back
+    xYielding = pdTRUE;
+    t_start = cycles();
+    for (int i = 0; i < RUNS; i++) {
+        taskYIELD();
+        t = cycles();
+        latency_add(&yield, t - t_start);
+        t_start = cycles();
+    }
+    xYielding = pdFALSE;
+    taskYIELD();
+
+    // notify: the high task preempts this one in xTaskNotifyGive()
+    for (int i = 0; i < RUNS; i++) {
+        t_start = cycles();
+        xTaskNotifyGive(xHighTask);
+    }
+
+    // queue wake: the high task preempts this one in xQueueSend()
+    for (int i = 0; i < RUNS; i++) {
+        t = cycles();
+        xQueueSend(xQueue, &t, 0);
+    }
+
+    // queue send and receive: nobody waits for the queue now
+    for (int i = 0; i < RUNS; i++) {
+        uint32_t value = i;
+        t = cycles();
+        xQueueSend(xQueue, &value, 0);
+        latency_add(&queue_send, cycles() - t);
+        t = cycles();
+        xQueueReceive(xQueue, &value, 0);
+        latency_add(&queue_receive, cycles() - t);
+    }
+
+    taskDISABLE_INTERRUPTS();
+
+    printf("FreeRTOS scheduler, cycles\n\r");
+    printf("%-10s %-14s %6s %6s %6s\n\r", "cpu", "operation", "min", "mean", "max");
+    latency_print("yield", &yield);
+    latency_print("notify", &notify);
+    latency_print("queue wake", &queue_wake);
+    latency_print("queue send", &queue_send);
+    latency_print("queue receive", &queue_receive);
+
+    print_run_time_stats();
+
+#if configUSE_DLOG_TRACE
+    dump_trace();
+#endif
+
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+#if configUSE_DLOG_TRACE
+    if (dlog_init(log_buffer, LOG_WORDS) != 0) {
+        return EXIT_FAILURE;
+    }
+#endif
+
+    // The tick of the scheduler is the comparator 0 of timer 0
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MTIE);
+
+    xQueue = xQueueCreate(1, sizeof(uint32_t));
+
+    xTaskCreate(prvMainTask, "Main", configMINIMAL_STACK_SIZE * 4U, NULL,
+                tskIDLE_PRIORITY + 1, &xMainTask);
+    xTaskCreate(prvPeerTask, "Peer", configMINIMAL_STACK_SIZE * 2U, NULL,
+                tskIDLE_PRIORITY + 1, &xPeerTask);
+    xTaskCreate(prvHighTask, "High", configMINIMAL_STACK_SIZE * 2U, NULL,
+                tskIDLE_PRIORITY + 2, &xHighTask);
+    if (xQueue == NULL || xMainTask == NULL || xPeerTask == NULL || xHighTask == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    // Numbers of the tasks in the trace
+    vTaskSetTaskNumber(xMainTask, 1);
+    vTaskSetTaskNumber(xPeerTask, 2);
+    vTaskSetTaskNumber(xHighTask, 3);
+
+    // The scheduler enables the interrupts
+    vTaskStartScheduler();
+
+    // Only reached if there is not enough heap for the idle task
+    return EXIT_FAILURE;
+}
+
+/* Hooks enabled in FreeRTOSConfig.h */
+
+void vApplicationMallocFailedHook(void)
+{
+    taskDISABLE_INTERRUPTS();
+    printf("malloc failed\n\r");
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationIdleHook(void)
+{
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName)
+{
+    (void)pxTask;
+    taskDISABLE_INTERRUPTS();
+    printf("stack overflow in %s\n\r", pcTaskName);
+    exit(EXIT_FAILURE);
+}
+
+void vApplicationTickHook(void)
+{
+}
@@ -0,0 +1,165 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Edge capture of a pulse train. A GPIO looped back onto another one
+ *        (connected in the testbench, use a cable on the FPGA) outputs pulses
+ *        of growing width, and the capture mode of the GPIO driver records
+ *        both edges of the input with their mcycle in a ring buffer, from the
+ *        interrupt handler. The events are read in batches by main, which
+ *        checks that none was lost and prints the width of the pulses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "gpio.h"
+#include "pad_control.h"
+#include "pad_control_regs.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#ifndef RV_PLIC_IS_INCLUDED
+  #error ( "This app does NOT work as the RV_PLIC peripheral is not included" )
+#endif
+
+#ifdef TARGET_PYNQ_Z2
+    #define GPIO_TB_OUT 8
+    #define GPIO_TB_IN  9
+    #define GPIO_INTR  GPIO_INTR_9
+    #pragma message ( "Connect a cable between GPIOs IN and OUT" )
+#else
+    #define GPIO_TB_OUT 30
+    #define GPIO_TB_IN  31
+    #define GPIO_INTR  GPIO_INTR_31
+#endif
+
+#define PULSES      32
+// Cycles of the first pulse and of the step between two, enough for the
+// handler to serve each edge
+#define WIDTH_MIN   400
+#define WIDTH_STEP  16
+// Smaller than the 2 * PULSES events, so that it is read while it fills
+#define RING_LEN    16
+#define BATCH       4
+
+static gpio_capture_event_t ring[RING_LEN];
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+static void wait_until(uint32_t t)
+{
+    while ((int32_t)(cycles() - t) < 0) {
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    pad_control_t pad_control;
+    pad_control.base_addr = mmio_region_from_addr((uintptr_t)PAD_CONTROL_START_ADDRESS);
+
+    if (plic_Init() != kPlicOk) {
+        PRINTF("Init PLIC failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+#if GPIO_TB_OUT == 31 || GPIO_TB_IN == 31
+    pad_control_set_mux(&pad_control, (ptrdiff_t)(PAD_CONTROL_PAD_MUX_I2C_SCL_REG_OFFSET), 1);
+#endif
+#if GPIO_TB_OUT == 30 || GPIO_TB_IN == 30
+    pad_control_set_mux(&pad_control, (ptrdiff_t)(PAD_CONTROL_PAD_MUX_I2C_SDA_REG_OFFSET), 1);
+#endif
+
+    plic_irq_set_priority(GPIO_INTR, 1);
+    plic_irq_set_enabled(GPIO_INTR, kPlicToggleEnabled);
+
+    gpio_cfg_t cfg_out = {
+        .pin = GPIO_TB_OUT,
+        .mode = GpioModeOutPushPull
+    };
+    if (gpio_config(cfg_out) != GpioOk) {
+        PRINTF("GPIO config failed\n\r");
+        return EXIT_FAILURE;
+    }
+    gpio_write(GPIO_TB_OUT, false);
+
+    if (gpio_capture_init(ring, RING_LEN) != GpioOk ||
+        gpio_capture_enable(GPIO_TB_IN, GpioIntrEdgeRisingFalling) != GpioOk) {
+        PRINTF("GPIO capture failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+    CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    gpio_capture_event_t events[BATCH];
+    uint32_t received = 0, errors = 0, rise = 0;
+    uint32_t t = cycles();
+
+    for (int i = 0; i < PULSES; i++) {
+        gpio_write(GPIO_TB_OUT, true);
+        t += WIDTH_MIN + i * WIDTH_STEP;
+        wait_until(t);
+        gpio_write(GPIO_TB_OUT, false);
+
+        // Drain a batch during the low time, while the edges keep coming
+        uint32_t n = gpio_capture_read(events, BATCH);
+        for (uint32_t j = 0; j < n; j++, received++) {
+            // Rising and falling edges alternate, starting with a rising one
+            uint8_t expected = received % 2 == 0 ? GpioCaptureRising : GpioCaptureFalling;
+            if (events[j].pin != GPIO_TB_IN || events[j].edge != expected) {
+                errors++;
+            }
+            if (events[j].edge == GpioCaptureRising) {
+                rise = events[j].cycle;
+            } else {
+                PRINTF("pulse %d: %d cycles\n\r", received / 2, events[j].cycle - rise);
+            }
+        }
+
+        t += WIDTH_MIN;
+        wait_until(t);
+    }
+
+    // The last edges
+    uint32_t n;
+    while ((n = gpio_capture_read(events, BATCH)) > 0) {
+        for (uint32_t j = 0; j < n; j++, received++) {
+            uint8_t expected = received % 2 == 0 ? GpioCaptureRising : GpioCaptureFalling;
+            if (events[j].pin != GPIO_TB_IN || events[j].edge != expected) {
+                errors++;
+            }
+        }
+    }
+
+    gpio_capture_disable(GPIO_TB_IN);
+    plic_irq_set_enabled(GPIO_INTR, kPlicToggleDisabled);
+
+    PRINTF("%d events, %d dropped, %d errors\n\r", received, gpio_capture_dropped(), errors);
+    if (received != 2 * PULSES || gpio_capture_dropped() != 0 || errors != 0) {
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("Success\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Bit-banged UART frames with the waveform output of the GPIO driver.
+ *        One word per bit is written to a GPIO looped back onto another one
+ *        (connected in the testbench, use a cable on the FPGA), paced by the
+ *        counter 1 of the AO rv_timer. The edges of the input are recorded by
+ *        the capture mode, and their spacing is checked against the bits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "rv_timer.h"
+#include "fast_intr_ctrl.h"
+#include "gpio.h"
+#include "gpio_wave.h"
+#include "pad_control.h"
+#include "pad_control_regs.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#ifndef RV_PLIC_IS_INCLUDED
+  #error ( "This app does NOT work as the RV_PLIC peripheral is not included" )
+#endif
+
+#ifdef TARGET_PYNQ_Z2
+    #define GPIO_TB_OUT 8
+    #define GPIO_TB_IN  9
+    #define GPIO_INTR  GPIO_INTR_9
+    #pragma message ( "Connect a cable between GPIOs IN and OUT" )
+#else
+    #define GPIO_TB_OUT 30
+    #define GPIO_TB_IN  31
+    #define GPIO_INTR  GPIO_INTR_31
+#endif
+
+// Cycles of a bit, the counter ticks every cycle
+#define BIT_PERIOD  1000
+// Error allowed on the spacing of two edges, for the interrupt latencies
+#define TOLERANCE   (BIT_PERIOD / 4)
+// Start bit, 8 data bits LSB first, stop bit
+#define FRAME_BITS  10
+#define N_FRAMES    3
+#define N_BITS      (N_FRAMES * FRAME_BITS)
+// A power of 2 above the number of edges, at most one per bit
+#define RING_LEN    32
+
+// Bits of MIE
+#define MIE_MEIE         (1 << 11)
+#define MIE_FAST_TIMER_1 (1 << (16 + kTimer_1_fic_e))
+
+static const uint8_t message[N_FRAMES] = {0x55, 0xA3, 0x0F};
+
+static uint32_t pattern[N_BITS];
+static gpio_capture_event_t ring[RING_LEN];
+static rv_timer_t timer_0_1;
+
+void fic_irq_timer_1(void)
+{
+    gpio_wave_tick();
+    // The controller latches the level, which was high until the line above
+    clear_fast_interrupt(kTimer_1_fic_e);
+}
+
+int main(int argc, char *argv[])
+{
+    pad_control_t pad_control;
+    pad_control.base_addr = mmio_region_from_addr((uintptr_t)PAD_CONTROL_START_ADDRESS);
+
+    if (plic_Init() != kPlicOk) {
+        PRINTF("Init PLIC failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+#if GPIO_TB_OUT == 31 || GPIO_TB_IN == 31
+    pad_control_set_mux(&pad_control, (ptrdiff_t)(PAD_CONTROL_PAD_MUX_I2C_SCL_REG_OFFSET), 1);
+#endif
+#if GPIO_TB_OUT == 30 || GPIO_TB_IN == 30
+    pad_control_set_mux(&pad_control, (ptrdiff_t)(PAD_CONTROL_PAD_MUX_I2C_SDA_REG_OFFSET), 1);
+#endif
+
+    plic_irq_set_priority(GPIO_INTR, 1);
+    plic_irq_set_enabled(GPIO_INTR, kPlicToggleEnabled);
+
+    gpio_cfg_t cfg_out = {
+        .pin = GPIO_TB_OUT,
+        .mode = GpioModeOutPushPull
+    };
+    if (gpio_config(cfg_out) != GpioOk) {
+        PRINTF("GPIO config failed\n\r");
+        return EXIT_FAILURE;
+    }
+    // The line is idle high
+    gpio_set_mask(1 << GPIO_TB_OUT);
+
+    if (gpio_capture_init(ring, RING_LEN) != GpioOk ||
+        gpio_capture_enable(GPIO_TB_IN, GpioIntrEdgeRisingFalling) != GpioOk) {
+        PRINTF("GPIO capture failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // One word per bit
+    for (int f = 0; f < N_FRAMES; f++) {
+        uint32_t frame = 1 << (FRAME_BITS - 1) | (uint32_t)message[f] << 1;
+        for (int b = 0; b < FRAME_BITS; b++) {
+            pattern[f * FRAME_BITS + b] = (frame >> b & 1) << GPIO_TB_OUT;
+        }
+    }
+
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_set_tick_params(&timer_0_1, 1, (rv_timer_tick_params_t){.prescale = 0, .tick_step = 1});
+    rv_timer_counter_set_enabled(&timer_0_1, 1, kRvTimerEnabled);
+
+    enable_fast_interrupt(kTimer_1_fic_e, true);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MEIE | MIE_FAST_TIMER_1);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    if (gpio_wave_start(&timer_0_1, 1, pattern, N_BITS, 1 << GPIO_TB_OUT, BIT_PERIOD, false) != GpioOk) {
+        PRINTF("GPIO wave failed\n\r");
+        return EXIT_FAILURE;
+    }
+    while (gpio_wave_busy()) {
+        asm volatile("wfi");
+    }
+    // Let the last edge be captured
+    for (int i = 0; i < 100; i++) {
+        asm volatile("nop");
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    rv_timer_counter_set_enabled(&timer_0_1, 1, kRvTimerDisabled);
+    gpio_capture_disable(GPIO_TB_IN);
+
+    // Expected edges: the bit indexes where the level changes from the former
+    gpio_capture_event_t events[N_BITS];
+    uint32_t n = gpio_capture_read(events, N_BITS);
+    uint32_t received = 0, errors = 0, level = 1, last_bit = 0;
+    for (uint32_t b = 0; b < N_BITS; b++) {
+        uint32_t bit = pattern[b] >> GPIO_TB_OUT;
+        if (bit == level) {
+            continue;
+        }
+        level = bit;
+        if (received == n) {
+            errors++;
+            break;
+        }
+        const gpio_capture_event_t *e = &events[received];
+        if (e->edge != (bit ? GpioCaptureRising : GpioCaptureFalling)) {
+            errors++;
+        }
+        if (received > 0) {
+            int32_t spacing = e->cycle - events[received - 1].cycle;
+            int32_t expected = (b - last_bit) * BIT_PERIOD;
+            if (spacing < expected - TOLERANCE || spacing > expected + TOLERANCE) {
+                PRINTF("edge %d: %d cycles instead of %d\n\r", received, spacing, expected);
+                errors++;
+            }
+        }
+        last_bit = b;
+        received++;
+    }
+
+    PRINTF("%d edges of %d, %d late ticks, %d errors\n\r", received, n, gpio_wave_late(), errors);
+    if (received != n || gpio_capture_dropped() != 0 || errors != 0) {
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("Success\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Continuous capture of both I2S channels with i2s_stream.h. The DMA
+ *        fills a ring of blocks and the core only wakes up once per block, in
+ *        the callback. With the microphone of the testbench, the left and
+ *        right samples of each block are checked.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "core_v_mini_mcu.h"
+#include "x-heep.h"
+#include "csr.h"
+#include "hart.h"
+#include "rv_plic.h"
+#include "i2s.h"
+#include "i2s_stream.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#ifdef TARGET_PYNQ_Z2
+// About 48 kHz stereo with 32-bit words: 15 MHz / 5 = 3 MHz = 64 * 46.9 kHz,
+// blocks of 1 ms
+#define I2S_CLK_DIV   5
+#define BLOCK_WORDS   96
+#define BLOCKS        1000
+#else
+#define I2S_CLK_DIV   32
+#define BLOCK_WORDS   32
+#define BLOCKS        8
+#endif
+#define RING_BLOCKS   4
+
+// The two samples sent by the microphone of the testbench
+#define TB_SAMPLE_A   0x8765431
+#define TB_SAMPLE_B   0xfedcba9
+
+static uint32_t ring[RING_BLOCKS * BLOCK_WORDS] __attribute__((aligned(4)));
+static i2s_stream_t stream;
+
+static volatile uint32_t blocks_done;
+static volatile uint32_t errors;
+static volatile bool mic_connected;
+static volatile int64_t energy;
+
+static void block_done(i2s_stream_t *s, const uint32_t *block, uint32_t index, void *arg)
+{
+    if (index >= BLOCKS)
+    {
+        return;
+    }
+
+#ifdef TARGET_PYNQ_Z2
+    // Energy of the left channel, 18 significant bits in the MSBs
+    for (uint32_t i = 0; i < BLOCK_WORDS; i += 2)
+    {
+        int32_t sample = (int32_t)block[i] >> 14;
+        energy += (int64_t)sample * sample;
+    }
+#else
+    // The testbench alternates two samples, starting with either of them
+    if (block[0] != 0)
+    {
+        mic_connected = true;
+        uint32_t other = block[0] == TB_SAMPLE_A ? TB_SAMPLE_B : TB_SAMPLE_A;
+        for (uint32_t i = 0; i < BLOCK_WORDS; i++)
+        {
+            if ((block[0] != TB_SAMPLE_A && block[0] != TB_SAMPLE_B) ||
+                block[i] != ((i & 1) ? other : block[0]))
+            {
+                errors++;
+                break;
+            }
+        }
+    }
+#endif
+
+    blocks_done = index + 1;
+}
+
+int main(int argc, char *argv[])
+{
+    i2s_result_t res;
+
+    PRINTF("I2S stream\r\n");
+
+    plic_Init();
+
+    res = i2s_init(I2S_CLK_DIV, I2S_32_BITS);
+    if (res != kI2sOk)
+    {
+        PRINTF("I2S init failed with %d\n\r", res);
+        return EXIT_FAILURE;
+    }
+
+    if (i2s_stream_init(&stream, ring, BLOCK_WORDS, RING_BLOCKS, block_done, NULL) != 0)
+    {
+        PRINTF("Stream init failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+    uint32_t mcycle_start, mcycle_end;
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_READ(CSR_REG_MCYCLE, &mcycle_start);
+
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    res = i2s_stream_start(&stream, I2S_BOTH_CH);
+    if (res != kI2sOk)
+    {
+        PRINTF("Stream start failed with %d\n\r", res);
+        return EXIT_FAILURE;
+    }
+
+    while (blocks_done < BLOCKS)
+    {
+        // The core sleeps between the blocks
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        if (blocks_done < BLOCKS)
+        {
+            wait_for_interrupt();
+        }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+
+    res = i2s_stream_stop(&stream);
+    CSR_READ(CSR_REG_MCYCLE, &mcycle_end);
+    i2s_terminate();
+
+    if (res == kI2sOverflow)
+    {
+        PRINTF("I2S rx FIFO overflowed\n\r");
+        errors++;
+    }
+    if (i2s_stream_overruns(&stream) != 0)
+    {
+        PRINTF("%d blocks dropped\n\r", i2s_stream_overruns(&stream));
+        errors++;
+    }
+
+    PRINTF("%d blocks of %d samples in %d cycles\n\r", BLOCKS, BLOCK_WORDS, mcycle_end - mcycle_start);
+#ifdef TARGET_PYNQ_Z2
+    PRINTF("Mean energy of the left channel: %d\n\r", (int32_t)(energy / (BLOCKS * BLOCK_WORDS / 2)));
+#else
+    if (!mic_connected)
+    {
+        PRINTF("WARNING: Microphone not connected!\r\n");
+    }
+#endif
+
+    if (errors == 0)
+    {
+        PRINTF("Success. \n\r");
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        PRINTF("Failure. \n\r");
+        return EXIT_FAILURE;
+    }
+}
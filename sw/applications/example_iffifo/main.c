@@ -12,7 +12,7 @@
 #include "core_v_mini_mcu.h"
 
 #include "x-heep.h"
-#include "iffifo_regs.h"
+#include "iffifo.h"
 
 #include "mmio.h"
 #include "handler.h"
@@ -38,8 +38,6 @@
     #define PRINTF(...)
 #endif
 
-unsigned int IFFIFO_START_ADDRESS = EXT_PERIPHERAL_START_ADDRESS + 0x2000;
-
 int32_t to_fifo  [6]   __attribute__ ((aligned (4)))  = { 1, 2, 3, 4, 5, 6 };
 int32_t from_fifo[4]   __attribute__ ((aligned (4)))  = { 0, 0, 0, 0 };
 
@@ -51,20 +49,18 @@ void dma_intr_handler_trans_done()
 
 void protected_wait_for_dma_interrupt(void)
 {
-  while(!dma_is_ready()) {
+  while(!dma_is_ready(0)) {
     CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-    if (!dma_is_ready()) {
+    if (!dma_is_ready(0)) {
         wait_for_interrupt();
     }
     CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
   }
 }
 
-iffifo_intr_flag = 0;
-static void handler_irq_iffifo( uint32_t int_id )
+int8_t iffifo_intr_flag = 0;
+void iffifo_intr_handler_reached(void)
 {
-  mmio_region_t iffifo_base_addr = mmio_region_from_addr((uintptr_t)IFFIFO_START_ADDRESS);
-  mmio_region_write32(iffifo_base_addr, IFFIFO_INTERRUPTS_REG_OFFSET, 0b0);
   iffifo_intr_flag = 1;
   PRINTF(" ** REACH intr. fired.\n");
 }
@@ -87,8 +83,7 @@ int compare_print_fifo_array(void) {
 
 void print_status_register(void)
 {
-  mmio_region_t iffifo_base_addr = mmio_region_from_addr((uintptr_t)IFFIFO_START_ADDRESS);
-  int32_t status = mmio_region_read32(iffifo_base_addr, IFFIFO_STATUS_REG_OFFSET);
+  int32_t status = iffifo_status();
   PRINTF("STATUS = ");
   PRINTF(status & (1 << IFFIFO_STATUS_EMPTY_BIT)     ? "E" : "-"); // FIFO empty
   PRINTF(status & (1 << IFFIFO_STATUS_AVAILABLE_BIT) ? "A" : "-"); // Data available in FIFO
@@ -99,9 +94,7 @@ void print_status_register(void)
 
 int is_iffifo_full(void)
 {
-  mmio_region_t iffifo_base_addr = mmio_region_from_addr((uintptr_t)IFFIFO_START_ADDRESS);
-  int32_t status = mmio_region_read32(iffifo_base_addr, IFFIFO_STATUS_REG_OFFSET);
-  return status & (1 << IFFIFO_STATUS_FULL_BIT);
+  return iffifo_status() & (1 << IFFIFO_STATUS_FULL_BIT);
 }
 
 int main(int argc, char *argv[]) {
@@ -116,10 +109,7 @@ int main(int argc, char *argv[]) {
     CSR_SET_BITS(CSR_REG_MIE, mask);
     
     if(plic_Init()) {return EXIT_FAILURE;};
-    if(plic_irq_set_priority(EXT_INTR_1, 1)) {return EXIT_FAILURE;};
-    if(plic_irq_set_enabled(EXT_INTR_1, kPlicToggleEnabled)) {return EXIT_FAILURE;};
-    
-    plic_assign_external_irq_handler(EXT_INTR_1, &handler_irq_iffifo);
+    iffifo_init();
     
     mmio_region_write32(iffifo_base_addr, IFFIFO_WATERMARK_REG_OFFSET, 2);
     mmio_region_write32(iffifo_base_addr, IFFIFO_INTERRUPTS_REG_OFFSET, 0b1);
@@ -135,7 +125,7 @@ int main(int argc, char *argv[]) {
     tgt_src.type       = DMA_DATA_TYPE_WORD;
     tgt_src.size_du    = 6;
 
-    tgt_dst.ptr        = IFFIFO_START_ADDRESS + IFFIFO_FIFO_IN_REG_OFFSET;
+    tgt_dst.ptr        = (uint8_t *)(IFFIFO_START_ADDRESS + IFFIFO_FIFO_IN_REG_OFFSET);
     tgt_dst.inc_du     = 0;
     tgt_dst.trig       = DMA_TRIG_SLOT_EXT_TX;
     tgt_dst.type       = DMA_DATA_TYPE_WORD;
@@ -159,9 +149,9 @@ int main(int argc, char *argv[]) {
     
     // To terminate the DMA transaction, 2 words must be manually popped from the FIFO.
     while(!is_iffifo_full());
-    int32_t read0 = mmio_region_read32(iffifo_base_addr, IFFIFO_FIFO_OUT_REG_OFFSET);
+    int32_t read0 = iffifo_pop();
     while(!is_iffifo_full());
-    int32_t read1 = mmio_region_read32(iffifo_base_addr, IFFIFO_FIFO_OUT_REG_OFFSET);
+    int32_t read1 = iffifo_pop();
     
     print_status_register();
     
@@ -170,7 +160,7 @@ int main(int argc, char *argv[]) {
     protected_wait_for_dma_interrupt();
     
     dma_init(NULL);
-    tgt_src.ptr        = IFFIFO_START_ADDRESS + IFFIFO_FIFO_OUT_REG_OFFSET;
+    tgt_src.ptr        = (uint8_t *)(IFFIFO_START_ADDRESS + IFFIFO_FIFO_OUT_REG_OFFSET);
     tgt_src.inc_du     = 0;
     tgt_src.trig       = DMA_TRIG_SLOT_EXT_RX;
     tgt_src.type       = DMA_DATA_TYPE_WORD;
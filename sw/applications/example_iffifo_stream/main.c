@@ -0,0 +1,172 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Throughput benchmark of the IFFIFO streams of iffifo.h. A buffer is
+ *        streamed through the loopback FIFO of the testharness, which returns
+ *        each word incremented by 1:
+ *        - by the CPU, pushing and popping the words;
+ *        - by one DMA channel, in bursts of the depth of the FIFO;
+ *        - by two DMA channels at once, in and out (DMA_CH_NUM > 1);
+ *        - by two DMA channels, the output read by blocks of the watermark
+ *          with the CPU sleeping between them (DMA_CH_NUM > 1).
+ *        The results are checked and the words per 100 cycles printed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "rv_plic.h"
+#include "dma.h"
+#include "iffifo.h"
+
+#define STREAM_WORDS 256
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+static uint32_t __attribute__((aligned(4))) tx[STREAM_WORDS];
+static uint32_t __attribute__((aligned(4))) rx[STREAM_WORDS];
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+static void clear_rx(void)
+{
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        rx[i] = 0;
+    }
+}
+
+// Number of words that did not come back incremented by 1
+static int check_rx(void)
+{
+    int errors = 0;
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        if (rx[i] != tx[i] + 1)
+        {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static int report(const char *name, unsigned int cycles, dma_config_flags_t res)
+{
+    int errors = (res & DMA_CONFIG_CRITICAL_ERROR) ? STREAM_WORDS : check_rx();
+
+    PRINTF("%-24s %7u cycles %4u words/100 cycles %s\n\r", name, cycles,
+           cycles ? STREAM_WORDS * 100 / cycles : 0, errors ? "WRONG" : "ok");
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    dma_config_flags_t res = DMA_CONFIG_OK;
+    unsigned int cycles;
+    int errors = 0;
+
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        tx[i] = i * 2654435761u;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
+
+    if (plic_Init())
+    {
+        return EXIT_FAILURE;
+    }
+    dma_init(NULL);
+    iffifo_init();
+
+    PRINTF("%u words through the IFFIFO:\n\r", STREAM_WORDS);
+
+    // The CPU fills the FIFO and empties it
+    clear_rx();
+    cycles_start();
+    for (uint32_t i = 0; i < STREAM_WORDS; i += IFFIFO_DEPTH)
+    {
+        for (uint32_t j = 0; j < IFFIFO_DEPTH; j++)
+        {
+            iffifo_push(tx[i + j]);
+        }
+        for (uint32_t j = 0; j < IFFIFO_DEPTH; j++)
+        {
+            rx[i + j] = iffifo_pop();
+        }
+    }
+    cycles = cycles_stop();
+    errors += report("CPU", cycles, DMA_CONFIG_OK);
+
+    // One channel fills the FIFO and empties it, as it cannot do both at once
+    clear_rx();
+    cycles_start();
+    for (uint32_t i = 0; i < STREAM_WORDS && !(res & DMA_CONFIG_CRITICAL_ERROR); i += IFFIFO_DEPTH)
+    {
+        res = iffifo_stream_in(&tx[i], IFFIFO_DEPTH, 0);
+        iffifo_stream_wait(0);
+        res |= iffifo_stream_out(&rx[i], IFFIFO_DEPTH, 0);
+        iffifo_stream_wait(0);
+    }
+    cycles = cycles_stop();
+    errors += report("DMA bursts", cycles, res);
+
+#if DMA_CH_NUM > 1
+    // The output is streamed while the input is, each paced by its slot
+    clear_rx();
+    cycles_start();
+    res = iffifo_stream_out(rx, STREAM_WORDS, 1);
+    res |= iffifo_stream_in(tx, STREAM_WORDS, 0);
+    iffifo_stream_wait(0);
+    iffifo_stream_wait(1);
+    cycles = cycles_stop();
+    errors += report("DMA in and out", cycles, res);
+
+    // The output is read by blocks of the FIFO depth, the CPU sleeping until
+    // the watermark is reached
+    clear_rx();
+    cycles_start();
+    res = iffifo_stream_in(tx, STREAM_WORDS, 0);
+    res |= iffifo_read_blocks(rx, STREAM_WORDS, IFFIFO_DEPTH, 1);
+    iffifo_stream_wait(0);
+    cycles = cycles_stop();
+    errors += report("DMA in, blocks out", cycles, res);
+#else
+    PRINTF("One DMA channel: the concurrent streams are skipped\n\r");
+#endif
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
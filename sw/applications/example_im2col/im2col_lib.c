@@ -5,207 +5,93 @@
 
     Author: Tommaso Terzano <tommaso.terzano@epfl.ch>
 
-    Info: im2col_lib.c describes functions used to calculate im2col and verify it using 
-    the golden result in im2colGolden.c.
+    Info: im2col_lib.c describes the reference im2col and the functions used to verify the im2col of the SDK,
+    against it or against the golden result in im2colGolden.c.
 
-    Notes: im2col_nchw_int32() and im2col_nhwc_int32() algorithms are inspired from the library SHL, developed by T-HEAD Semi.
+    Notes: im2col_reference() is inspired from the library SHL, developed by T-HEAD Semi.
     For reference, check out the following link:
     https://github.com/T-head-Semi/csi-nn2/blob/main/source/reference/im2col.c
 */
 
 #include "im2col_lib.h"
 
-int output_data[OH_NCHW*OW_NCHW];
-
-int im2col_nchw_int32()
+static uint32_t load(const void *data, uint32_t size, uint32_t index)
 {
-    PRINTF("OH: %d, OW: %d\n", OH_NCHW, OW_NCHW);
-
-    int size_transfer = 0;
-    int im_row = 0;
-    int im_col = 0;
-    int w_offset = 0;  // the offset ALONG the IW
-    int h_offset = 0; // the offset ALONG the IH
-    int im_c = 0; // Gets the CH on which the im2col is being performed depending on the row of the output image (c)
-    int col_index = 0;
-    
-    // Iterate over each row of the output matrix.
-    for (int c = 0; c < CH_COL; ++c) {
-        // Calculate offsets within the kernel window.
-        // These are used to move the filter around the input image
-
-        w_offset = c % FW;  
-        h_offset = (c / FW) % FH;
-        im_c = c / (FH * FW); // Gets the CH on which the im2col is being performed depending on the row of the output image (c)
-
-        // Iterate over each BATCH.
-        for (int b = 0; b < BATCH; ++b) {
-            // Iterate over each patch on the IW of the input matrix.
-            for (int h = 0; h < N_PATCHES_H; ++h) {
-                // Iterate over each patch on the heigth in the output matrix.
-                for (int w = 0; w < N_PATCHES_W; ++w) {
-                    // Calculate the row and column indices in the original input image, applying the stride and offset.
-                    im_row = h_offset + h * STRIDES - PAD;
-                    im_col = w_offset + w * STRIDES - PAD;
-
-                    // Calculate the index in the flattened output array where this value should be stored.
-                    col_index = ((c * BATCH + b) * N_PATCHES_H + h) * N_PATCHES_W + w;
-                    
-                    // If the calculated indices are outside the bounds of the input image, set the output to 0 (padding effect).
-                    // Otherwise, fetch the value from the input image and store it in the output array.
-                    if (im_row < 0 || im_col < 0 || im_row >= IH || im_col >= IW) {
-                        output_data[col_index] = 0;
-                    } else {
-                        output_data[col_index] = input_image_nchw[get_index(CH, IH, IW, b, im_c, im_row, im_col)];                        
-                    }
-                }
-            }
-        }
+    switch (size)
+    {
+    case 1: return ((const uint8_t *)data)[index];
+    case 2: return ((const uint16_t *)data)[index];
+    default: return ((const uint32_t *)data)[index];
     }
+}
 
-    // Finished!
-
-    PRINTF("Final output matrix:\n\n");
-
-    #if DEBUG
-    for (int i=0; i<OH; i++)
+static void store(void *data, uint32_t size, uint32_t index, uint32_t value)
+{
+    switch (size)
     {
-        for (int j=0; j<OW; j++)
-        {
-            PRINTF("%d ", output_data[i*OW + j]);
-        }
-        PRINTF("\n");
+    case 1: ((uint8_t *)data)[index] = value; break;
+    case 2: ((uint16_t *)data)[index] = value; break;
+    default: ((uint32_t *)data)[index] = value; break;
     }
-    #endif
-
-    // Return a 0 to indicate a success
-    return 0;
 }
 
-int im2col_nhwc_int32()
+void im2col_reference(const dma_tiling_im2col_t *shape, const void *input, void *output)
 {
-    PRINTF("OH: %d, OW: %d\n", OH_NHWC, OW_NHWC);
+    int size = DMA_DATA_TYPE_2_SIZE(shape->type);
+    int n_patches_h = DMA_TILING_PATCHES(shape->ih, shape->fh, shape->stride, shape->pad);
+    int n_patches_w = DMA_TILING_PATCHES(shape->iw, shape->fw, shape->stride, shape->pad);
+    int ch_col = shape->ch * shape->fh * shape->fw;
 
-    int size_transfer = 0;
-    int im_row = 0;
-    int im_col = 0;
-    int w_offset = 0;  // the offset ALONG the IW
-    int h_offset = 0; // the offset ALONG the IH
-    int im_c = 0; // Gets the CH on which the im2col is being performed depending on the row of the output image (c)
-    int col_index = 0;
-
-    // Calculate the heigth of the output matrix
-
-    // Iterate over each row of the output matrix.
-    for (int b = 0; b < BATCH; ++b) {
-        // Iterate over each BATCH.
-        for (int h = 0; h < N_PATCHES_H; ++h) {
-            // Iterate over each patch on the IW of the input matrix.
-            for (int w = 0; w < N_PATCHES_W; ++w) {
-                // Iterate over each patch on the heigth in the output matrix.
-                for (int c = 0; c < CH_COL; ++c) {
-                    // Calculate offsets within the kernel window.
-                    // These are used to move the filter around the input image
-
-                    w_offset = c % FW;  
-                    h_offset = (c / FW) % FH;
-                    im_c = c / (FH * FW); // Gets the CH on which the im2col is being performed depending on the row of the output image (c)
-                    
+    // Iterate over each row of the NCHW output matrix, i.e. each column of the NHWC one.
+    for (int c = 0; c < ch_col; ++c) {
+        // Calculate offsets within the kernel window.
+        // These are used to move the filter around the input image
+        int w_offset = c % shape->fw;
+        int h_offset = (c / shape->fw) % shape->fh;
+        int im_c = c / (shape->fh * shape->fw);
+
+        // Iterate over each batch and each patch.
+        for (int b = 0; b < shape->batch; ++b) {
+            for (int h = 0; h < n_patches_h; ++h) {
+                for (int w = 0; w < n_patches_w; ++w) {
                     // Calculate the row and column indices in the original input image, applying the stride and offset.
-                    im_row = h_offset + h * STRIDES - PAD;
-                    im_col = w_offset + w * STRIDES - PAD;
+                    int im_row = h_offset + h * shape->stride - shape->pad;
+                    int im_col = w_offset + w * shape->stride - shape->pad;
+
+                    int col_index, im_index;
+                    if (shape->format == DMA_TILING_NCHW) {
+                        col_index = ((c * shape->batch + b) * n_patches_h + h) * n_patches_w + w;
+                        im_index = ((b * shape->ch + im_c) * shape->ih + im_row) * shape->iw + im_col;
+                    } else {
+                        col_index = ((b * n_patches_h + h) * n_patches_w + w) * ch_col + c;
+                        im_index = ((b * shape->ih + im_row) * shape->iw + im_col) * shape->ch + im_c;
+                    }
 
-                    // Calculate the index in the flattened output array where this value should be stored.
-                    col_index = ((b * N_PATCHES_H + h) * N_PATCHES_W + w) * CH_COL + c; //  ((c * BATCH + b) * N_PATCHES_H + h) * N_PATCHES_W + w;
-                    
                     // If the calculated indices are outside the bounds of the input image, set the output to 0 (padding effect).
-                    // Otherwise, fetch the value from the input image and store it in the output array.
-                    if (im_row < 0 || im_col < 0 || im_row >= IH || im_col >= IW) {
-                        output_data[col_index] = 0;
+                    if (im_row < 0 || im_col < 0 || im_row >= shape->ih || im_col >= shape->iw) {
+                        store(output, size, col_index, 0);
                     } else {
-                        output_data[col_index] = input_image_nhwc[get_index(IH, IW, CH, b, im_row, im_col, im_c)];
-                    }                    
+                        store(output, size, col_index, load(input, size, im_index));
+                    }
                 }
             }
         }
     }
-
-    PRINTF("Final output matrix:\n\n");
-
-    #if DEBUG
-    for (int i=0; i<OH; i++)
-    {
-        for (int j=0; j<OW; j++)
-        {
-            PRINTF("%d ", output_data[i*OW + j]);
-        }
-        PRINTF("\n");
-    }
-    #endif
-
-    // Return a 0 to indicate a success
-    return 0;
 }
 
-
-int get_index(int dim1, int dim2, int dim3, int index0, int index1, int index2,
-                          int index3)
-{
-    return ((index0 * dim1 + index1) * dim2 + index2) * dim3 + index3;
-}
-
-// Verifies the im2col using golden values generated by "verification_script.py"
-int verify(int format)
+int verify(const dma_tiling_im2col_t *shape, const void *output, const void *expected)
 {
     int errors = 0;
+    uint32_t size = DMA_DATA_TYPE_2_SIZE(shape->type);
+    uint32_t length = im2col_output_length(shape);
 
-    if (format == 0)
-    {
-        for (int i=0; i<OH_NCHW; i++)
-        {
-            for (int j=0; j<OW_NCHW; j++)
-            {    
-                if (golden_im2col_nchw[i*OW_NCHW + j] != output_data[i*OW_NCHW + j])
-                {
-                    PRINTF("ERROR: Golden: %d, Output: %d, at %d %d\n", golden_im2col_nchw[i*OW_NCHW + j], output_data[i*OW_NCHW + j], i, j);
-                    errors ++;
-                }
-            }
-        }
-    }
-    else
+    for (uint32_t i = 0; i < length; i++)
     {
-        for (int i=0; i<OH_NHWC; i++)
+        if (load(output, size, i) != load(expected, size, i))
         {
-            for (int j=0; j<OW_NHWC; j++)
-            {    
-                if (golden_im2col_nhwc[i*OW_NHWC + j] != output_data[i*OW_NHWC + j])
-                {
-                    PRINTF("ERROR: Golden: %d, Output: %d, at %d %d\n", golden_im2col_nhwc[i*OW_NHWC + j], output_data[i*OW_NHWC + j], i, j);
-                    errors ++;
-                }
-            }
+            PRINTF_DEB("ERROR: Golden: %d, Output: %d, at %d\n", load(expected, size, i), load(output, size, i), i);
+            errors++;
         }
     }
     return errors;
 }
-
-void dma_run(dma_trans_t * trans)
-{
-    int res = dma_validate_transaction(trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY );
-    res = dma_load_transaction(trans);
-    res = dma_launch(trans);
-
-    while( ! dma_is_ready()) {
-        // disable_interrupts
-        // this does not prevent waking up the core as this is controlled by the MIP register
-        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-        if ( dma_is_ready() == 0 ) {
-            wait_for_interrupt();
-            //from here we wake up even if we did not jump to the ISR
-        }
-        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
-    }
-
-    return;
-}
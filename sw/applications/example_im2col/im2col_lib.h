@@ -4,8 +4,9 @@
     SPDX-License-Identifier: Apache-2.0
 
     Author: Tommaso Terzano <tommaso.terzano@epfl.ch>
-    
-    Info: Header file of im2col_lib.c, containing the function prototypes, parameters macros and the configuration of prints and performance analysis.
+
+    Info: Header file of im2col_lib.c, containing the reference im2col, the verification functions and the configuration of prints and performance analysis.
+    The im2col itself is computed by the SDK, see im2col.h.
 */
 
 #ifndef _IM2COL_
@@ -15,10 +16,9 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "im2colGolden.h"
-#include "dma.h"
+#include "im2col.h"
 #include "core_v_mini_mcu.h"
 #include "x-heep.h"
-#include "rv_plic.h"
 #include "csr.h"
 
 // By default, printfs are activated for FPGA and for simulation.
@@ -27,12 +27,10 @@
 #define DEBUG 0 // Set to 1 to enable debug prints
 #define TIMING 0 // Set to 1 to enable timing measurements
 
-// Format is defined in im2colGolden.h
-
 #if TARGET_SIM && PRINTF_IN_SIM
     #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
-    #define PRINTF_DEB(...) 
-    #define PRINTF_TIM(...)   
+    #define PRINTF_DEB(...)
+    #define PRINTF_TIM(...)
 #elif PRINTF_IN_FPGA && !TARGET_SIM
     #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
     #if DEBUG
@@ -51,24 +49,26 @@
     #define PRINTF_TIM(...)
 #endif
 
-// Define the dimensions of the input tensor and the kernel
+// Shape of the golden results of im2colGolden.c
+#define GOLDEN_SHAPE(fmt) {                \
+    .format = (fmt),                       \
+    .type = DMA_DATA_TYPE_WORD,            \
+    .batch = BATCH,                        \
+    .ch = CH,                              \
+    .ih = IH,                              \
+    .iw = IW,                              \
+    .fh = FH,                              \
+    .fw = FW,                              \
+    .stride = STRIDES,                     \
+    .pad = PAD,                            \
+}
 
-#define N_PATCHES_H ((IH + (PAD + PAD) - FH)/ STRIDES + 1)
-#define N_PATCHES_W ((IW + (PAD + PAD) - FW)/ STRIDES + 1)
+#define GOLDEN_LENGTH (CH * FH * FW * BATCH * DMA_TILING_PATCHES(IH, FH, STRIDES, PAD) * DMA_TILING_PATCHES(IW, FW, STRIDES, PAD))
 
-#define CH_COL (CH * FH * FW)
+// Reference im2col of any shape, one index computation per element
+void im2col_reference(const dma_tiling_im2col_t *shape, const void *input, void *output);
 
-#define OH_NCHW (CH * FH * FW * BATCH)
-#define OW_NCHW (N_PATCHES_H) * (N_PATCHES_W)
+// Number of elements of output that differ from expected
+int verify(const dma_tiling_im2col_t *shape, const void *output, const void *expected);
 
-#define OW_NHWC (FW * FH * CH * BATCH)
-#define OH_NHWC (N_PATCHES_W) * (N_PATCHES_H)
-
-int im2col_nchw_int32();
-int im2col_nhwc_int32();
-
-int get_index(int dim1, int dim2, int dim3, int index0, int index1, int index2, int index3);
-                
-int verify(int format);
-
-#endif
\ No newline at end of file
+#endif
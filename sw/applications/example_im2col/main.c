@@ -4,8 +4,10 @@
     SPDX-License-Identifier: Apache-2.0
 
     Author: Tommaso Terzano <tommaso.terzano@epfl.ch>
-    
-    Info: Example application of im2col algorithm with configurable format, verification and performance analysis.
+
+    Info: Example application of the im2col of the SDK (im2col.h), with verification and performance analysis.
+    Each format is computed by the CPU and by a plan of 2D DMA transactions, first against the golden result
+    of im2colGolden.c, then on int8 layer shapes of common CNNs against the reference im2col, with their cycles.
 */
 
 #include <stdio.h>
@@ -14,68 +16,156 @@
 #include "x-heep.h"
 #include "im2col_lib.h"
 
-#define NCHW_FORMAT 0
-#define NHWC_FORMAT 1
+// Largest input and output of the layers, in bytes
+#define LAYER_INPUT_MAX 3072
+#define LAYER_OUTPUT_MAX 7168
 
-int main()
+// Descriptors of the DMA plans: the shapes with more filter elements times
+// channels are only computed by the CPU
+#define PLAN_MAX 80
+
+typedef struct
 {
-    PRINTF("\nStarting test...\n\n");
-    
+    const char *name;
+    dma_tiling_im2col_t shape;
+} layer_t;
+
+#define LAYER(n, c, h, w, f_h, f_w, s, p) \
+    { n, { .type = DMA_DATA_TYPE_BYTE, .batch = 1, .ch = c, .ih = h, .iw = w, .fh = f_h, .fw = f_w, .stride = s, .pad = p } }
+
+// First layers and blocks of common CNNs, on small inputs to fit the RAM
+static const layer_t layers[] = {
+    LAYER("mobilenet conv1", 3, 32, 32, 3, 3, 2, 1),
+    LAYER("vgg conv1",       3, 16, 16, 3, 3, 1, 1),
+    LAYER("resnet 3x3",      8, 8, 8, 3, 3, 1, 1),
+    LAYER("squeezenet 1x1",  32, 8, 8, 1, 1, 1, 0),
+    LAYER("lenet5 conv2",    6, 10, 10, 5, 5, 1, 0),
+    LAYER("alexnet conv1",   3, 23, 23, 11, 11, 4, 0),
+};
+
+static const char *format_names[] = {"NCHW", "NHWC"};
+
+static uint32_t golden_output[GOLDEN_LENGTH];
+static uint8_t layer_input[LAYER_INPUT_MAX];
+static uint8_t layer_output[LAYER_OUTPUT_MAX];
+static uint8_t layer_ref[LAYER_OUTPUT_MAX];
+static dma_tiling_desc_t plan[PLAN_MAX];
+
+static unsigned int cycles;
+
+#define TIME(call)                         \
+    do {                                   \
+        CSR_WRITE(CSR_REG_MCYCLE, 0);      \
+        call;                              \
+        CSR_READ(CSR_REG_MCYCLE, &cycles); \
+    } while (0)
+
+// Runs an im2col of the golden shape, verifies it against the golden result and prints its cycles
+static int run_golden(const char *name, im2col_backend_t backend, dma_tiling_format_t format)
+{
+    const dma_tiling_im2col_t shape = GOLDEN_SHAPE(format);
+    const uint32_t *input = format == DMA_TILING_NCHW ? input_image_nchw : input_image_nhwc;
+    const uint32_t *golden = format == DMA_TILING_NCHW ? golden_im2col_nchw : golden_im2col_nhwc;
     int errors;
-    unsigned int cycles;
-    
-    #if TIMING
-        CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
-        CSR_WRITE(CSR_REG_MCYCLE, 0);
-    #endif 
-    
-    im2col_nchw_int32(); // Execute the im2col algorithm with NCHW format
-
-    #if TIMING
-        CSR_READ(CSR_REG_MCYCLE, &cycles);
-    #endif
-    
-    errors = verify(NCHW_FORMAT);
-
-    PRINTF("im2col NCHW test executed\n");
-    
+
+    // Clear the result of the previous test
+    for (int i = 0; i < GOLDEN_LENGTH; i++)
+    {
+        golden_output[i] = -1;
+    }
+
+    TIME(errors = im2col_run(backend, &shape, input, golden_output, plan, PLAN_MAX) != (int)backend);
+    errors += verify(&shape, golden_output, golden);
+
+    PRINTF("im2col %s test executed\n", name);
     PRINTF_TIM("Total number of cycles: [%d]\n\n", cycles);
 
     if (errors != 0)
     {
         PRINTF("TEST FAILED: %d errors\n", errors);
-        return 1;
-    } 
+    }
     else
     {
         PRINTF("TEST PASSED!\n");
     }
 
-    #if TIMING
-        CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
-        CSR_WRITE(CSR_REG_MCYCLE, 0);
-    #endif
+    return errors;
+}
 
-    im2col_nhwc_int32(); // Execute the im2col algorithm with NHWC format
+// Runs a layer by the reference and both backends, and prints their cycles
+static int run_layer(const layer_t *layer, dma_tiling_format_t format)
+{
+    dma_tiling_im2col_t shape = layer->shape;
+    shape.format = format;
+    int errors = 0;
+    unsigned int ref_cycles, cpu_cycles;
 
-    #if TIMING
-        CSR_READ(CSR_REG_MCYCLE, &cycles);
-    #endif
+    if (im2col_output_length(&shape) > LAYER_OUTPUT_MAX)
+    {
+        PRINTF("%-16s %s does not fit\n", layer->name, format_names[format]);
+        return 1;
+    }
 
-    errors = verify(NHWC_FORMAT);
+    TIME(im2col_reference(&shape, layer_input, layer_ref));
+    ref_cycles = cycles;
 
-    PRINTF("im2col NHWC test executed\n");
-    PRINTF_TIM("Total number of cycles: [%d]\n\n", cycles);
+    TIME(errors += im2col_cpu(&shape, layer_input, layer_output) != 0);
+    cpu_cycles = cycles;
+    errors += verify(&shape, layer_output, layer_ref);
 
-    if (errors != 0)
+    for (uint32_t i = 0; i < im2col_output_length(&shape); i++)
     {
-        PRINTF("TEST FAILED: %d errors\n", errors);
-        return 1;
-    } 
+        layer_output[i] = 0xff;
+    }
+    int dma_res;
+    TIME(dma_res = im2col_dma(&shape, layer_input, layer_output, plan, PLAN_MAX));
+    if (dma_res == 0)
+    {
+        errors += verify(&shape, layer_output, layer_ref);
+        PRINTF("%-16s %s %4u x %3u: reference %7u, CPU %7u, DMA %7u cycles %s\n", layer->name,
+               format_names[format], im2col_patches(&shape), im2col_patch_length(&shape),
+               ref_cycles, cpu_cycles, cycles, errors ? "WRONG" : "ok");
+    }
     else
     {
-        PRINTF("TEST PASSED!\n");
+        PRINTF("%-16s %s %4u x %3u: reference %7u, CPU %7u, DMA     n/a cycles %s\n", layer->name,
+               format_names[format], im2col_patches(&shape), im2col_patch_length(&shape),
+               ref_cycles, cpu_cycles, errors ? "WRONG" : "ok");
+    }
+
+    return errors;
+}
+
+int main()
+{
+    int errors = 0;
+    uint32_t seed = 1;
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("\nStarting test...\n\n");
+
+    if (run_golden("NCHW", IM2COL_CPU, DMA_TILING_NCHW) != 0 ||
+        run_golden("NCHW DMA", IM2COL_DMA, DMA_TILING_NCHW) != 0 ||
+        run_golden("NHWC", IM2COL_CPU, DMA_TILING_NHWC) != 0 ||
+        run_golden("NHWC DMA", IM2COL_DMA, DMA_TILING_NHWC) != 0)
+    {
+        return 1;
+    }
+
+    for (int i = 0; i < LAYER_INPUT_MAX; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        layer_input[i] = seed >> 16;
+    }
+
+    PRINTF("\nCNN layers, patches x patch length:\n");
+    for (uint32_t l = 0; l < sizeof(layers) / sizeof(layers[0]); l++)
+    {
+        errors += run_layer(&layers[l], DMA_TILING_NCHW);
+        errors += run_layer(&layers[l], DMA_TILING_NHWC);
     }
 
-    return 0;
+    PRINTF("program finished with %d errors\n", errors);
+    return errors ? 1 : 0;
 }
@@ -0,0 +1,135 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: A tight FIR loop, alone and while the DMA copies a buffer in the
+ *        RAM, with the instruction buffer of the main core disabled, enabled,
+ *        and enabled with the prefetch. Without the buffer the fetches of the
+ *        loop compete with the DMA for the bus, with it the loop runs from the
+ *        lines of the buffer and keeps its speed. The cycles of each run and
+ *        the hits and misses of the buffer are printed, and the results are
+ *        checked against the run without the DMA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "dma_sdk.h"
+#include "soc_ctrl.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define SAMPLES     512
+#define TAPS        8
+#define DMA_WORDS   4096
+
+static int32_t x[SAMPLES + TAPS];
+static int32_t y_ref[SAMPLES], y[SAMPLES];
+static const int32_t h[TAPS] = {3, -5, 12, 31, 31, 12, -5, 3};
+static uint32_t dma_src[DMA_WORDS], dma_dst[DMA_WORDS];
+
+static soc_ctrl_t soc_ctrl;
+
+static void __attribute__((noinline)) fir(int32_t *out)
+{
+    for (uint32_t n = 0; n < SAMPLES; n++)
+    {
+        int32_t acc = 0;
+        for (uint32_t k = 0; k < TAPS; k++)
+        {
+            acc += h[k] * x[n + k];
+        }
+        out[n] = acc >> 6;
+    }
+}
+
+// Cycles of the FIR, with the DMA copying during it if dma is set
+static unsigned int run(int dma, int32_t *out)
+{
+    dma_sdk_ticket_t ticket = 0;
+    unsigned int cycles;
+
+    if (dma)
+    {
+        ticket = dma_copy_32b_async(dma_dst, dma_src, DMA_WORDS, NULL, NULL);
+    }
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    fir(out);
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    if (dma)
+    {
+        dma_sdk_wait(ticket);
+    }
+    return cycles;
+}
+
+static uint32_t bench(const char *name, int enable, int prefetch)
+{
+    unsigned int alone, with_dma;
+    uint32_t errors = 0;
+
+    soc_ctrl_instr_buffer_enable(&soc_ctrl, enable, prefetch);
+    soc_ctrl_instr_buffer_clear(&soc_ctrl);
+
+    alone = run(0, y);
+    with_dma = run(1, y);
+    for (uint32_t n = 0; n < SAMPLES; n++)
+    {
+        errors += y[n] != y_ref[n];
+    }
+
+    PRINTF("%-9s alone %u cycles, with the DMA %u cycles, hits %u misses %u\n\r", name, alone, with_dma,
+           soc_ctrl_get_instr_buffer_hits(&soc_ctrl), soc_ctrl_get_instr_buffer_misses(&soc_ctrl));
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t errors = 0;
+
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    for (uint32_t i = 0; i < SAMPLES + TAPS; i++)
+    {
+        x[i] = (int32_t)(i * 37 % 255) - 128;
+    }
+    for (uint32_t i = 0; i < DMA_WORDS; i++)
+    {
+        dma_src[i] = i;
+    }
+    fir(y_ref);
+
+#if INSTR_BUFFER_LINES > 0
+    PRINTF("instruction buffer: %u lines of %u bytes\n\r", INSTR_BUFFER_LINES, INSTR_BUFFER_LINE_SIZE);
+    errors += bench("off", 0, 0);
+    errors += bench("on", 1, 0);
+    errors += bench("prefetch", 1, 1);
+    soc_ctrl_instr_buffer_enable(&soc_ctrl, 0, 0);
+#else
+    PRINTF("no instruction buffer (instr_buffer lines: 0 in mcu_cfg.hjson)\n\r");
+    errors += bench("off", 0, 0);
+#endif
+
+    if (errors != 0)
+    {
+        PRINTF("%u errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
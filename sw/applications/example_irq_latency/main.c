@@ -0,0 +1,236 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Interrupt latency and jitter, from the cycle an interrupt line is
+ *        raised to the first instruction of its handler, for each source:
+ *        - GPIO 1 through the fast interrupt controller
+ *        - timer 1 through the fast interrupt controller
+ *        - an external line through the PLIC
+ *        - the PLIC line preempting the GPIO handler (nested)
+ *        The testharness interrupt trigger raises the GPIO and PLIC lines a
+ *        known number of cycles after it is armed; the timer fires after the
+ *        same number of cycles. Run it for each CPU (make mcu-gen CPU=...) and
+ *        with PLIC_VECTORED=1 to compare the dispatch paths, and see
+ *        example_freertos_irq_latency for the FreeRTOS trap handler.
+ *        The latencies include the few cycles of the store that arms the
+ *        trigger, which are the same for all the sources.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "csr.h"
+#include "hart.h"
+#include "handler.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "rv_timer.h"
+#include "gpio.h"
+#include "fast_intr_ctrl.h"
+#include "irq_trigger.h"
+#include "x-heep.h"
+
+/* The trigger only exists in simulation, so do print there. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#if !TARGET_SIM
+  #error ( "This app needs the interrupt trigger of the testharness" )
+#endif
+
+#ifndef RV_PLIC_IS_INCLUDED
+  #error ( "This app does NOT work as the RV_PLIC peripheral is not included" )
+#endif
+
+#define RUNS 32
+// Cycles between the arm of the trigger (or the start of the timer) and the interrupt
+#define TRIGGER_DELAY 64
+
+// Bits of MIE
+#define MIE_MEIE         (1 << 11)
+#define MIE_FAST_TIMER_1 (1 << (16 + kTimer_1_fic_e))
+#define MIE_FAST_GPIO_1  (1 << (16 + kGpio_1_fic_e))
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+} latency_t;
+
+static rv_timer_t timer_0_1;
+
+static volatile uint32_t t_start;
+static volatile uint32_t t_entry;
+static volatile bool served;
+static volatile bool nest;
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+static void latency_add(latency_t *l, uint32_t value)
+{
+    if (l->count == 0 || value < l->min) l->min = value;
+    if (l->count == 0 || value > l->max) l->max = value;
+    l->sum += value;
+    l->count++;
+}
+
+static void latency_print(const char *source, const latency_t *l)
+{
+    PRINTF("%-10s %-14s %6d %6d %6d %6d\n\r", CPU_TYPE, source,
+           l->min, l->sum / l->count, l->max, l->max - l->min);
+}
+
+static void plic_handler(void)
+{
+    t_entry = cycles();
+    irq_trigger_clear();
+    served = true;
+}
+
+void fic_irq_gpio_1(void)
+{
+    uint32_t t = cycles();
+    gpio_intr_clear_stat(IRQ_TRIGGER_GPIO);
+    // The controller latches the level, which was high until the line above
+    clear_fast_interrupt(kGpio_1_fic_e);
+
+    if (nest) {
+        // A nested trap overwrites mepc and mstatus, save them around it
+        uint32_t mepc, mstatus;
+        CSR_READ(CSR_REG_MEPC, &mepc);
+        CSR_READ(CSR_REG_MSTATUS, &mstatus);
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+        t_start = cycles();
+        irq_trigger_arm(IRQ_TRIGGER_LINE_PLIC);
+        while (!served) {
+        }
+
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        CSR_WRITE(CSR_REG_MEPC, mepc);
+        CSR_WRITE(CSR_REG_MSTATUS, mstatus);
+        return;
+    }
+
+    t_entry = t;
+    served = true;
+}
+
+void fic_irq_timer_1(void)
+{
+    t_entry = cycles();
+    rv_timer_counter_set_enabled(&timer_0_1, 1, kRvTimerDisabled);
+    rv_timer_irq_clear(&timer_0_1, 1, 0);
+    clear_fast_interrupt(kTimer_1_fic_e);
+    served = true;
+}
+
+// Cycles from the raise of the trigger lines to the handler
+static uint32_t measure_trigger(uint32_t lines)
+{
+    served = false;
+    t_start = cycles();
+    irq_trigger_arm(lines);
+    while (!served) {
+    }
+    return t_entry - t_start - TRIGGER_DELAY;
+}
+
+// Cycles from the timer reaching its threshold to the handler
+static uint32_t measure_timer(void)
+{
+    rv_timer_reset(&timer_0_1);
+    rv_timer_set_tick_params(&timer_0_1, 1, (rv_timer_tick_params_t){.prescale = 0, .tick_step = 1});
+    rv_timer_irq_enable(&timer_0_1, 1, 0, kRvTimerEnabled);
+    rv_timer_arm(&timer_0_1, 1, 0, TRIGGER_DELAY);
+
+    served = false;
+    t_start = cycles();
+    rv_timer_counter_set_enabled(&timer_0_1, 1, kRvTimerEnabled);
+    while (!served) {
+    }
+    return t_entry - t_start - TRIGGER_DELAY;
+}
+
+int main(int argc, char *argv[])
+{
+    latency_t fast_gpio = {0}, fast_timer = {0}, plic = {0}, nested = {0};
+
+    if (plic_Init() != kPlicOk) {
+        PRINTF("Init PLIC failed\n\r");
+        return EXIT_FAILURE;
+    }
+    plic_irq_set_priority(IRQ_TRIGGER_PLIC_INTR, 1);
+    plic_irq_set_enabled(IRQ_TRIGGER_PLIC_INTR, kPlicToggleEnabled);
+    plic_assign_external_irq_handler(IRQ_TRIGGER_PLIC_INTR, &plic_handler);
+
+    gpio_cfg_t cfg_in = {
+        .pin = IRQ_TRIGGER_GPIO,
+        .mode = GpioModeIn,
+        .en_input_sampling = true,
+        .en_intr = true,
+        .intr_type = GpioIntrEdgeRising
+    };
+    if (gpio_config(cfg_in) != GpioOk) {
+        PRINTF("GPIO config failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+
+    enable_fast_interrupt(kGpio_1_fic_e, true);
+    enable_fast_interrupt(kTimer_1_fic_e, true);
+
+    irq_trigger_set_delay(TRIGGER_DELAY - IRQ_TRIGGER_ARM_CYCLES);
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MEIE | MIE_FAST_TIMER_1 | MIE_FAST_GPIO_1);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    for (int i = 0; i < RUNS; i++) {
+        latency_add(&fast_gpio, measure_trigger(IRQ_TRIGGER_LINE_GPIO));
+        irq_trigger_clear();
+
+        latency_add(&plic, measure_trigger(IRQ_TRIGGER_LINE_PLIC));
+
+        nest = true;
+        latency_add(&nested, measure_trigger(IRQ_TRIGGER_LINE_GPIO));
+        nest = false;
+
+        latency_add(&fast_timer, measure_timer());
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    irq_trigger_clear();
+
+#ifdef PLIC_VECTORED
+    PRINTF("PLIC dispatch: vectored\n\r");
+#else
+    PRINTF("PLIC dispatch: default\n\r");
+#endif
+    PRINTF("%-10s %-14s %6s %6s %6s %6s\n\r", "cpu", "source", "min", "mean", "max", "jitter");
+    latency_print("fast gpio", &fast_gpio);
+    latency_print("fast timer", &fast_timer);
+    latency_print("plic", &plic);
+    latency_print("plic nested", &nested);
+
+    return EXIT_SUCCESS;
+}
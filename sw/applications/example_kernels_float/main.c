@@ -0,0 +1,180 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Benchmark of the float kernels of kernels_float.h: every kernel is checked
+// against a plain loop and its floating-point operations per cycle are
+// printed. Build it twice to know when the FPU pays off:
+//   make app PROJECT=example_kernels_float ARCH=rv32imc     (soft-float)
+//   make app PROJECT=example_kernels_float ARCH=rv32imfc    (FPU, with FUSESOC_PARAM="--FPU=1")
+// The operands are in the interleaved banks when the configuration has them,
+// e.g. configs/example_interleaved.hjson.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "ram_bank.h"
+#include "kernels_float.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define M 16
+#define N 16
+#define K 16
+#define LEN 256
+#define TAPS 16
+#define FIR_LEN KERNELS_FIR_OUT(LEN, TAPS)
+#define FFT_N 64
+#define FFT_LOG2 6
+
+// Floating-point operations, a multiply-add counting as two
+#define FLOPS_GEMM (2 * M * N * K)
+#define FLOPS_DOT (2 * LEN)
+#define FLOPS_AXPY (2 * LEN)
+#define FLOPS_FIR (2 * FIR_LEN * TAPS)
+#define FLOPS_FFT (5 * FFT_N * FFT_LOG2)
+
+// Largest accepted difference with the plain loops, relative to the magnitude
+#define TOLERANCE 1e-3f
+
+static float a[M * K] RAM_INTERLEAVED;
+static float bt[N * K] RAM_INTERLEAVED;
+static float c[M * N] RAM_INTERLEAVED;
+static float x[LEN] RAM_INTERLEAVED;
+static float y[LEN] RAM_INTERLEAVED;
+static float h[TAPS] RAM_INTERLEAVED;
+static float out[LEN] RAM_INTERLEAVED;
+static kernel_complex_t fft[FFT_N] RAM_INTERLEAVED;
+static kernel_complex_t tw[FFT_N / 2] RAM_INTERLEAVED;
+
+static float ref[LEN];
+static kernel_complex_t fft_in[FFT_N];
+
+static uint32_t seed = 1;
+static uint32_t errors = 0;
+
+// Uniform in [-1, 1)
+static float rand_float(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (float)(int32_t)(seed >> 8 & 0xffff) / 32768.0f - 1.0f;
+}
+
+static float absf(float v)
+{
+    return v < 0 ? -v : v;
+}
+
+static uint32_t check(const float *res, const float *expected, uint32_t len)
+{
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (absf(res[i] - expected[i]) > TOLERANCE * (1.0f + absf(expected[i]))) wrong++;
+    }
+    errors += wrong;
+    return wrong;
+}
+
+static void report(const char *kernel, uint32_t cycles, uint32_t flops, uint32_t wrong)
+{
+    PRINTF("%-6s %7u cycles %3u.%02u FLOPs/cycle %s\n\r", kernel, cycles, flops / cycles,
+           (flops * 100 / cycles) % 100, wrong ? "WRONG" : "ok");
+}
+
+#define TIME(cycles, call)                 \
+    do {                                   \
+        CSR_WRITE(CSR_REG_MCYCLE, 0);      \
+        call;                              \
+        CSR_READ(CSR_REG_MCYCLE, &cycles); \
+    } while (0)
+
+int main()
+{
+    uint32_t cycles;
+
+    kernels_float_init();
+
+    //enable mcycle csr
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    for (int i = 0; i < M * K; i++) a[i] = rand_float();
+    for (int i = 0; i < N * K; i++) bt[i] = rand_float();
+    for (int i = 0; i < LEN; i++) { x[i] = rand_float(); y[i] = rand_float(); }
+    for (int i = 0; i < TAPS; i++) h[i] = rand_float();
+    for (int i = 0; i < FFT_N; i++) { fft_in[i].re = rand_float(); fft_in[i].im = rand_float(); }
+
+    PRINTF("CPU %s, %s\n\r", CPU_TYPE, KERNELS_HARD_FLOAT ? "FPU" : "soft-float");
+
+    // GEMM
+    TIME(cycles, kernel_gemm_f32(a, bt, c, M, N, K));
+    uint32_t wrong = 0;
+    for (int i = 0; i < M; i++)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            float acc = 0.0f;
+            for (int l = 0; l < K; l++) acc += a[i * K + l] * bt[j * K + l];
+            ref[j] = acc;
+        }
+        wrong += check(&c[i * N], ref, N);
+    }
+    report("gemm", cycles, FLOPS_GEMM, wrong);
+
+    // Dot product
+    float dot;
+    TIME(cycles, dot = kernel_dot_f32(x, y, LEN));
+    ref[0] = 0.0f;
+    for (int i = 0; i < LEN; i++) ref[0] += x[i] * y[i];
+    report("dot", cycles, FLOPS_DOT, check(&dot, ref, 1));
+
+    // axpy
+    for (int i = 0; i < LEN; i++) ref[i] = 0.5f * x[i] + y[i];
+    TIME(cycles, kernel_axpy_f32(0.5f, x, y, LEN));
+    report("axpy", cycles, FLOPS_AXPY, check(y, ref, LEN));
+
+    // FIR
+    TIME(cycles, kernel_fir_f32(x, h, out, LEN, TAPS));
+    for (int i = 0; i < FIR_LEN; i++)
+    {
+        ref[i] = 0.0f;
+        for (int j = 0; j < TAPS; j++) ref[i] += h[j] * x[i + j];
+    }
+    report("fir", cycles, FLOPS_FIR, check(out, ref, FIR_LEN));
+
+    // FFT, checked with the plain DFT of its two first bins
+    kernel_fft_f32_twiddles(tw, FFT_N);
+    for (int i = 0; i < FFT_N; i++) fft[i] = fft_in[i];
+    TIME(cycles, kernel_fft_f32(fft, tw, FFT_N));
+    wrong = 0;
+    for (int bin = 0; bin < 2; bin++)
+    {
+        float re = 0.0f, im = 0.0f;
+        for (int i = 0; i < FFT_N; i++)
+        {
+            const kernel_complex_t w = tw[(bin * i) % FFT_N < FFT_N / 2 ? (bin * i) % FFT_N : (bin * i) % FFT_N - FFT_N / 2];
+            // exp(-2 pi i t / n) for t >= n / 2 is minus the twiddle of t - n / 2
+            float sign = (bin * i) % FFT_N < FFT_N / 2 ? 1.0f : -1.0f;
+            re += sign * (fft_in[i].re * w.re - fft_in[i].im * w.im);
+            im += sign * (fft_in[i].re * w.im + fft_in[i].im * w.re);
+        }
+        ref[0] = re;
+        ref[1] = im;
+        wrong += check(&fft[bin].re, &ref[0], 1) + check(&fft[bin].im, &ref[1], 1);
+    }
+    report("fft", cycles, FLOPS_FFT, wrong);
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
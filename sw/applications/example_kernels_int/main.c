@@ -0,0 +1,146 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Benchmark of the int8 and int16 kernels of kernels_int.h: every version of
+// every kernel is run on the same random operands, its output is compared
+// with the one of the portable version, and its MACs per cycle are printed.
+// The Xpulp version is only built when ARCH has the CORE-V extensions, e.g.
+// ARCH=rv32imc_zicsr_zifencei_xcvhwlp_xcvmem_xcvmac_xcvbi_xcvalu_xcvsimd_xcvbitmanip
+// on cv32e40px.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "kernels_int.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define M 16
+#define N 16
+#define K 32
+#define H 16
+#define W 16
+#define FH 3
+#define FW 4
+#define OH KERNELS_CONV_OUT(H, FH)
+#define OW KERNELS_CONV_OUT(W, FW)
+
+#define MACS_GEMM (M * N * K)
+#define MACS_GEMV (M * K)
+#define MACS_CONV (OH * OW * FH * FW)
+
+static int8_t a8[M * K] __attribute__((aligned(4)));
+static int8_t b8[N * K] __attribute__((aligned(4)));
+static int8_t in8[H * W] __attribute__((aligned(4)));
+static int8_t f8[FH * FW] __attribute__((aligned(4)));
+static int16_t a16[M * K] __attribute__((aligned(4)));
+static int16_t b16[N * K] __attribute__((aligned(4)));
+static int16_t in16[H * W] __attribute__((aligned(4)));
+static int16_t f16[FH * FW] __attribute__((aligned(4)));
+
+static int32_t ref[M * N];
+static int32_t out[M * N];
+
+static const char *version_names[] = {"portable", "rv32im", "xpulp"};
+
+static uint32_t seed = 1;
+
+static int32_t rand_value(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (int32_t)(seed >> 16);
+}
+
+static uint32_t errors = 0;
+
+// Compares out with ref and prints the MACs per 100 cycles
+static void report(const char *kernel, int version, uint32_t cycles, uint32_t macs, uint32_t len)
+{
+    uint32_t wrong = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (out[i] != ref[i]) wrong++;
+    }
+    errors += wrong;
+    PRINTF("%-10s %-9s %6u cycles %4u.%02u MACs/cycle %s\n\r", kernel, version_names[version], cycles,
+           macs / cycles, (macs * 100 / cycles) % 100, wrong ? "WRONG" : "ok");
+}
+
+#define BENCH(kernel, version, macs, len, call)    \
+    do {                                           \
+        uint32_t cycles;                           \
+        CSR_WRITE(CSR_REG_MCYCLE, 0);              \
+        call;                                      \
+        CSR_READ(CSR_REG_MCYCLE, &cycles);         \
+        report(kernel, version, cycles, macs, len);\
+    } while (0)
+
+int main()
+{
+    for (int i = 0; i < M * K; i++) { a8[i] = rand_value(); a16[i] = rand_value(); }
+    for (int i = 0; i < N * K; i++) { b8[i] = rand_value(); b16[i] = rand_value(); }
+    for (int i = 0; i < H * W; i++) { in8[i] = rand_value(); in16[i] = rand_value(); }
+    for (int i = 0; i < FH * FW; i++) { f8[i] = rand_value(); f16[i] = rand_value(); }
+
+    //enable mcycle csr
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("CPU %s, kernels of kernel_gemm_s8() and co: %s\n\r", CPU_TYPE, version_names[KERNELS_VERSION]);
+
+    kernel_gemm_s8_portable(a8, b8, ref, M, N, K);
+    BENCH("gemm_s8", KERNELS_PORTABLE, MACS_GEMM, M * N, kernel_gemm_s8_portable(a8, b8, out, M, N, K));
+    BENCH("gemm_s8", KERNELS_RV32IM, MACS_GEMM, M * N, kernel_gemm_s8_rv32im(a8, b8, out, M, N, K));
+#if KERNELS_VERSION == KERNELS_XPULP
+    BENCH("gemm_s8", KERNELS_XPULP, MACS_GEMM, M * N, kernel_gemm_s8_xpulp(a8, b8, out, M, N, K));
+#endif
+
+    kernel_gemm_s16_portable(a16, b16, ref, M, N, K);
+    BENCH("gemm_s16", KERNELS_PORTABLE, MACS_GEMM, M * N, kernel_gemm_s16_portable(a16, b16, out, M, N, K));
+    BENCH("gemm_s16", KERNELS_RV32IM, MACS_GEMM, M * N, kernel_gemm_s16_rv32im(a16, b16, out, M, N, K));
+#if KERNELS_VERSION == KERNELS_XPULP
+    BENCH("gemm_s16", KERNELS_XPULP, MACS_GEMM, M * N, kernel_gemm_s16_xpulp(a16, b16, out, M, N, K));
+#endif
+
+    kernel_gemv_s8_portable(a8, b8, ref, M, K);
+    BENCH("gemv_s8", KERNELS_PORTABLE, MACS_GEMV, M, kernel_gemv_s8_portable(a8, b8, out, M, K));
+    BENCH("gemv_s8", KERNELS_RV32IM, MACS_GEMV, M, kernel_gemv_s8_rv32im(a8, b8, out, M, K));
+#if KERNELS_VERSION == KERNELS_XPULP
+    BENCH("gemv_s8", KERNELS_XPULP, MACS_GEMV, M, kernel_gemv_s8_xpulp(a8, b8, out, M, K));
+#endif
+
+    kernel_gemv_s16_portable(a16, b16, ref, M, K);
+    BENCH("gemv_s16", KERNELS_PORTABLE, MACS_GEMV, M, kernel_gemv_s16_portable(a16, b16, out, M, K));
+    BENCH("gemv_s16", KERNELS_RV32IM, MACS_GEMV, M, kernel_gemv_s16_rv32im(a16, b16, out, M, K));
+#if KERNELS_VERSION == KERNELS_XPULP
+    BENCH("gemv_s16", KERNELS_XPULP, MACS_GEMV, M, kernel_gemv_s16_xpulp(a16, b16, out, M, K));
+#endif
+
+    kernel_conv2d_s8_portable(in8, f8, ref, H, W, FH, FW);
+    BENCH("conv2d_s8", KERNELS_PORTABLE, MACS_CONV, OH * OW, kernel_conv2d_s8_portable(in8, f8, out, H, W, FH, FW));
+    BENCH("conv2d_s8", KERNELS_RV32IM, MACS_CONV, OH * OW, kernel_conv2d_s8_rv32im(in8, f8, out, H, W, FH, FW));
+#if KERNELS_VERSION == KERNELS_XPULP
+    BENCH("conv2d_s8", KERNELS_XPULP, MACS_CONV, OH * OW, kernel_conv2d_s8_xpulp(in8, f8, out, H, W, FH, FW));
+#endif
+
+    kernel_conv2d_s16_portable(in16, f16, ref, H, W, FH, FW);
+    BENCH("conv2d_s16", KERNELS_PORTABLE, MACS_CONV, OH * OW, kernel_conv2d_s16_portable(in16, f16, out, H, W, FH, FW));
+    BENCH("conv2d_s16", KERNELS_RV32IM, MACS_CONV, OH * OW, kernel_conv2d_s16_rv32im(in16, f16, out, H, W, FH, FW));
+#if KERNELS_VERSION == KERNELS_XPULP
+    BENCH("conv2d_s16", KERNELS_XPULP, MACS_CONV, OH * OW, kernel_conv2d_s16_xpulp(in16, f16, out, H, W, FH, FW));
+#endif
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
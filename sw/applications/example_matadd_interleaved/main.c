@@ -8,6 +8,7 @@
 #include "matrixAdd32.h"
 #include "x-heep.h"
 #include "core_v_mini_mcu.h"
+#include "ram_bank.h"
 
 /* By default, printfs are activated for FPGA and disabled for simulation. */
 #define PRINTF_IN_FPGA  1
@@ -24,7 +25,7 @@
 void __attribute__ ((noinline)) matrixAdd(int32_t * A, int32_t * B, int32_t * C, int N, int M);
 uint32_t check_results(int32_t *  C, int N, int M);
 
-int32_t __attribute__((section(".xheep_data_interleaved"))) m_c[16*16];
+int32_t RAM_INTERLEAVED m_c[16*16];
 
 
 int main()
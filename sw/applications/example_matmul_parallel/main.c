@@ -0,0 +1,117 @@
+/**
+ * @file main.c
+ * @brief Matrix multiplication on the harts of the cluster
+ *
+ * C = A * B on int8 matrices placed in the interleaved banks, the rows of C
+ * being shared between the harts (row i on hart i % harts). The product is
+ * computed on 1 to NUM_HARTS harts with cluster_fork(), each result is
+ * compared with the one of the main core alone, and the cycles (mcycle of
+ * the main core, fork and join included) are reported.
+ *
+ * With num_harts: 1 the program runs on the main core only.
+ *
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core_v_mini_mcu.h"
+#include "x-heep.h"
+#include "csr.h"
+#include "ram_bank.h"
+#include "cluster_ctrl.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define SIZE 32
+
+typedef struct {
+    const int8_t *a;
+    const int8_t *b;
+    int32_t *c;
+} matmul_args_t;
+
+static int8_t RAM_INTERLEAVED m_a[SIZE * SIZE];
+static int8_t RAM_INTERLEAVED m_b[SIZE * SIZE];
+static int32_t RAM_INTERLEAVED m_c[SIZE * SIZE];
+static int32_t m_ref[SIZE * SIZE];
+
+static void matmul_rows(void *arg, uint32_t hart, uint32_t harts)
+{
+    matmul_args_t *args = (matmul_args_t *)arg;
+
+    for (int i = hart; i < SIZE; i += harts) {
+        for (int j = 0; j < SIZE; j++) {
+            int32_t acc = 0;
+            for (int k = 0; k < SIZE; k++) {
+                acc += args->a[i * SIZE + k] * args->b[k * SIZE + j];
+            }
+            args->c[i * SIZE + j] = acc;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int errors = 0;
+    uint32_t cycles;
+
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        m_a[i] = (int8_t)((i * 7 + 3) % 9 - 4);
+        m_b[i] = (int8_t)((i * 5 + 1) % 7 - 3);
+    }
+
+    if (cluster_start() != kClusterCtrlOk && NUM_HARTS > 1) {
+        PRINTF("cluster_ctrl is not included\n\r");
+        return EXIT_FAILURE;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    matmul_args_t ref = { m_a, m_b, m_ref };
+    matmul_args_t par = { m_a, m_b, m_c };
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    cluster_fork(matmul_rows, &ref, 1);
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    PRINTF("%dx%d matmul on 1 hart: %d cycles\n\r", SIZE, SIZE, cycles);
+
+    for (uint32_t harts = 2; harts <= NUM_HARTS; harts++) {
+        for (int i = 0; i < SIZE * SIZE; i++) {
+            m_c[i] = 0;
+        }
+
+        CSR_WRITE(CSR_REG_MCYCLE, 0);
+        if (cluster_fork(matmul_rows, &par, harts) != kClusterCtrlOk) {
+            PRINTF("fork on %d harts failed\n\r", harts);
+            return EXIT_FAILURE;
+        }
+        CSR_READ(CSR_REG_MCYCLE, &cycles);
+
+        for (int i = 0; i < SIZE * SIZE; i++) {
+            if (m_c[i] != m_ref[i]) {
+                errors++;
+            }
+        }
+        PRINTF("%dx%d matmul on %d harts: %d cycles\n\r", SIZE, SIZE, harts, cycles);
+    }
+
+    if (errors) {
+        PRINTF("FAILURE: %d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("SUCCESS\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Micro-benchmark of the word-wise memory_copy, memory_set and
+ *        memory_compare of base/memory.c, called by name as the applications
+ *        take memcpy, memset and memcmp from newlib (HOST_BUILD). They are
+ *        compared with byte-at-a-time loops and with newlib, on aligned and
+ *        misaligned buffers of several sizes, and their results are checked.
+ *        Built with MEMORY_WORD=1, the newlib column times them as well.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "memory.h"
+
+#define MAX_LEN 4096
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+// Keep the reference loops byte-at-a-time, and out of line
+#if defined(__GNUC__) && !defined(__clang__)
+#define BYTEWISE __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+#else
+#define BYTEWISE __attribute__((noinline))
+#endif
+
+static uint8_t __attribute__((aligned(4))) src[MAX_LEN + 4];
+static uint8_t __attribute__((aligned(4))) dst[MAX_LEN + 4];
+static uint8_t __attribute__((aligned(4))) ref[MAX_LEN + 4];
+
+static const uint32_t lengths[] = {16, 256, 4096};
+static const uint32_t misalign[] = {0, 1};
+
+static BYTEWISE void memcpy_bytewise(uint8_t *d, const uint8_t *s, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        d[i] = s[i];
+    }
+}
+
+static BYTEWISE void memset_bytewise(uint8_t *d, uint8_t v, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        d[i] = v;
+    }
+}
+
+static BYTEWISE int memcmp_bytewise(const uint8_t *a, const uint8_t *b, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (a[i] != b[i])
+        {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int c_byte, c_word, c_libc;
+    int errors = 0;
+
+    for (uint32_t i = 0; i < sizeof(src); i++)
+    {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("func   len  off   bytewise   memory.c     newlib\n\r");
+
+    for (uint32_t l = 0; l < ARRAYSIZE(lengths); l++)
+    {
+        for (uint32_t m = 0; m < ARRAYSIZE(misalign); m++)
+        {
+            uint32_t len = lengths[l];
+            uint32_t off = misalign[m];
+
+            // memcpy, the destination is misaligned by off
+            cycles_start();
+            memcpy_bytewise(ref + off, src, len);
+            c_byte = cycles_stop();
+            cycles_start();
+            memory_copy(dst + off, src, len);
+            c_word = cycles_stop();
+            if (memcmp_bytewise(dst + off, ref + off, len) != 0)
+            {
+                errors++;
+            }
+            cycles_start();
+            memcpy(dst + off, src, len);
+            c_libc = cycles_stop();
+            PRINTF("memcpy %4u %u %10u %10u %10u\n\r", len, off, c_byte, c_word, c_libc);
+
+            // memset
+            cycles_start();
+            memset_bytewise(ref + off, 0x5A, len);
+            c_byte = cycles_stop();
+            cycles_start();
+            memory_set(dst + off, 0x5A, len);
+            c_word = cycles_stop();
+            if (memcmp_bytewise(dst + off, ref + off, len) != 0)
+            {
+                errors++;
+            }
+            cycles_start();
+            memset(dst + off, 0x5A, len);
+            c_libc = cycles_stop();
+            PRINTF("memset %4u %u %10u %10u %10u\n\r", len, off, c_byte, c_word, c_libc);
+
+            // memcmp of equal regions, the worst case
+            memcpy_bytewise(dst + off, src + off, len);
+            cycles_start();
+            int r_byte = memcmp_bytewise(dst + off, src + off, len);
+            c_byte = cycles_stop();
+            cycles_start();
+            int r_word = memory_compare(dst + off, src + off, len);
+            c_word = cycles_stop();
+            cycles_start();
+            int r_libc = memcmp(dst + off, src + off, len);
+            c_libc = cycles_stop();
+            if (r_byte != 0 || r_word != 0 || r_libc != 0)
+            {
+                errors++;
+            }
+            PRINTF("memcmp %4u %u %10u %10u %10u\n\r", len, off, c_byte, c_word, c_libc);
+
+            // memcmp with a difference in the last byte
+            dst[off + len - 1] ^= 0x80;
+            r_byte = memcmp_bytewise(dst + off, src + off, len);
+            r_word = memory_compare(dst + off, src + off, len);
+            if ((r_byte < 0) != (r_word < 0) || r_word == 0)
+            {
+                errors++;
+            }
+        }
+    }
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// Inference of a small int8 CNN with the runtime of nn.h: conv 3x3, max
+// pooling, conv 1x1, max pooling and a dense layer of 10 classes, on a 16x16
+// input of 4 channels. The model runs once with its weights in RAM, then with
+// the weights of its convolution and dense layers written to the flash and
+// streamed into two buffers of the interleaved banks, which must give the same
+// classes. The cycles of each layer are printed for both runs. The weights and
+// the input are pseudo-random, the point is the data path, not the accuracy.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "nn.h"
+#include "ram_bank.h"
+#include "w25q128jw.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#if defined(TARGET_PYNQ_Z2) || defined(TARGET_ZCU104) || defined(TARGET_NEXYS_A7_100T)
+    #define USE_SPI_FLASH
+#endif
+
+// Flash area of the weights, the last 64kB block of the 16MB flash
+#define WEIGHTS_ADDR 0x00FF0000
+
+#define LAYERS 5
+#define CLASSES 10
+
+// Weights of the layers with some: k elements per output channel
+#define K_CONV1 (3 * 3 * 4)
+#define K_CONV2 8
+#define K_FC    (4 * 4 * 16)
+
+// Buffers, from the requirements of nn_model_check(): the largest tensor is
+// the output of conv1, and its im2col the largest one
+#define ACT_LENGTH (16 * 16 * 8)
+#define COL_LENGTH (16 * 16 * K_CONV1)
+#define ACC_LENGTH (16 * 16 * 4)
+#define STREAM_LENGTH 512
+#define PLAN_LENGTH 40
+
+static int8_t w_conv1[8 * K_CONV1];
+static int8_t w_conv2[16 * K_CONV2];
+static int8_t w_fc[CLASSES * K_FC];
+static int32_t b_conv1[8];
+static int32_t b_conv2[16];
+static int32_t b_fc[CLASSES];
+
+// Flash addresses of the weights, one after the other
+#define FLASH_CONV1 WEIGHTS_ADDR
+#define FLASH_CONV2 (FLASH_CONV1 + sizeof(w_conv1))
+#define FLASH_FC    (FLASH_CONV2 + sizeof(w_conv2))
+
+static nn_layer_t layers[LAYERS] = {
+    {.op = NN_CONV2D, .in = {16, 16, 4}, .oc = 8, .fh = 3, .fw = 3, .stride = 1, .pad = 1,
+     .weights = w_conv1, .weights_flash = FLASH_CONV1, .bias = b_conv1,
+     .mult = 1, .shift = 9, .act_min = 0, .act_max = 127},
+    {.op = NN_MAXPOOL, .in = {16, 16, 8}, .fh = 2, .fw = 2, .stride = 2},
+    {.op = NN_CONV2D, .in = {8, 8, 8}, .oc = 16, .fh = 1, .fw = 1, .stride = 1, .pad = 0,
+     .weights = w_conv2, .weights_flash = FLASH_CONV2, .bias = b_conv2,
+     .mult = 1, .shift = 7, .act_min = 0, .act_max = 127},
+    {.op = NN_MAXPOOL, .in = {8, 8, 16}, .fh = 2, .fw = 2, .stride = 2},
+    {.op = NN_DENSE, .in = {4, 4, 16}, .oc = CLASSES,
+     .weights = w_fc, .weights_flash = FLASH_FC, .bias = b_fc,
+     .mult = 1, .shift = 10, .act_min = -128, .act_max = 127},
+};
+
+static const char *op_names[] = {"conv2d", "dense", "maxpool"};
+
+static int8_t __attribute__((aligned(4))) act[2][ACT_LENGTH];
+static int8_t __attribute__((aligned(4))) col[COL_LENGTH];
+static int32_t acc[ACC_LENGTH];
+static int8_t RAM_INTERLEAVED __attribute__((aligned(4))) stream[2][STREAM_LENGTH];
+static dma_tiling_desc_t plan[PLAN_LENGTH];
+
+static int8_t input[16 * 16 * 4];
+static int8_t golden[CLASSES];
+
+static nn_model_t model = {
+    .layers = layers,
+    .count = LAYERS,
+    .act = {act[0], act[1]},
+    .act_length = ACT_LENGTH,
+    .col = col,
+    .col_length = COL_LENGTH,
+    .acc = acc,
+    .acc_length = ACC_LENGTH,
+    .stream = {stream[0], stream[1]},
+    .stream_length = STREAM_LENGTH,
+    .plan = plan,
+    .plan_length = PLAN_LENGTH,
+};
+
+static uint32_t seed = 1;
+
+static int8_t random_s8(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (int8_t)(seed >> 16);
+}
+
+static void fill(int8_t *p, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        p[i] = random_s8();
+    }
+}
+
+// Runs the layers one by one on the input, prints their cycles and copies the
+// output into out
+static int run(const char *name, int8_t *out)
+{
+    unsigned int cycles, total = 0;
+    uint32_t idx = 0;
+
+    memcpy(act[0], input, sizeof(input));
+    for (uint32_t l = 0; l < LAYERS; l++)
+    {
+        CSR_WRITE(CSR_REG_MCYCLE, 0);
+        nn_status_t status = nn_layer_run(&model, &layers[l], act[idx], act[idx ^ 1]);
+        CSR_READ(CSR_REG_MCYCLE, &cycles);
+        if (status != NN_OK)
+        {
+            PRINTF("%s: layer %u failed (%d)\n", name, l, status);
+            return 1;
+        }
+        PRINTF("%-8s %u %-8s %8u cycles\n", name, l, op_names[layers[l].op], cycles);
+        total += cycles;
+        idx ^= 1;
+    }
+    PRINTF("%-8s total      %8u cycles\n", name, total);
+
+    memcpy(out, act[idx], CLASSES);
+    return 0;
+}
+
+int main()
+{
+    int8_t output[CLASSES];
+    nn_requirements_t req;
+    int errors = 0;
+
+    fill(w_conv1, sizeof(w_conv1));
+    fill(w_conv2, sizeof(w_conv2));
+    fill(w_fc, sizeof(w_fc));
+    for (uint32_t i = 0; i < 8; i++) b_conv1[i] = random_s8() * 16;
+    for (uint32_t i = 0; i < 16; i++) b_conv2[i] = random_s8() * 16;
+    for (uint32_t i = 0; i < CLASSES; i++) b_fc[i] = random_s8() * 16;
+    fill(input, sizeof(input));
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    if (nn_model_check(&model, &req) != NN_OK)
+    {
+        PRINTF("The buffers are too small: act %u, col %u, acc %u\n",
+               req.act_length, req.col_length, req.acc_length);
+        return EXIT_FAILURE;
+    }
+
+    // Weights in RAM
+    if (run("ram", golden) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+    if (get_spi_flash_mode(&soc_ctrl) == SOC_CTRL_SPI_FLASH_MODE_SPIMEMIO)
+    {
+        PRINTF("The weights cannot be streamed with the memory mapped SPI FLASH module - "
+               "do not use the FLASH_EXEC linker script for this application\n");
+        return EXIT_SUCCESS;
+    }
+
+    spi_host_t *spi;
+    #ifndef USE_SPI_FLASH
+    spi = spi_host1;
+    #else
+    spi = spi_flash;
+    #endif
+    if (w25q128jw_init(spi) != FLASH_OK) return EXIT_FAILURE;
+
+    // Weights in the flash, streamed through the two buffers
+    if (w25q128jw_write(FLASH_CONV1, w_conv1, sizeof(w_conv1), 1) != FLASH_OK ||
+        w25q128jw_write(FLASH_CONV2, w_conv2, sizeof(w_conv2), 1) != FLASH_OK ||
+        w25q128jw_write(FLASH_FC, w_fc, sizeof(w_fc), 1) != FLASH_OK)
+    {
+        PRINTF("Flash write failed\n");
+        return EXIT_FAILURE;
+    }
+    layers[0].weights = NULL;
+    layers[2].weights = NULL;
+    layers[4].weights = NULL;
+
+    if (nn_model_check(&model, &req) != NN_OK)
+    {
+        PRINTF("The buffers are too small: acc %u, stream %u\n", req.acc_length, req.stream_length);
+        return EXIT_FAILURE;
+    }
+    if (run("flash", output) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("class  ram flash\n");
+    for (uint32_t i = 0; i < CLASSES; i++)
+    {
+        PRINTF("%5u %4d %5d\n", i, golden[i], output[i]);
+        errors += golden[i] != output[i];
+    }
+
+    PRINTF("program finished with %d errors\n", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
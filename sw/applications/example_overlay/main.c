@@ -0,0 +1,132 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Example application of the overlays of overlay.h. Two phases of a
+ *        processing, each in an overlay of the first region, alternate over
+ *        blocks of data, with a checksum in an overlay of the second region,
+ *        resident all along. The same processing from the FLASH is the
+ *        reference of the results and of the cycles, and the counters of the
+ *        overlays give the cost of the swaps. It is meant to be linked with
+ *        LINKER=flash_exec, with the other linker scripts everything is in
+ *        the RAM and nothing is swapped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "overlay.h"
+
+#define DATA_LEN    256
+#define BLOCKS      8
+#define PASSES      16
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+static uint32_t data[DATA_LEN];
+
+// The phases, in FLASH and in overlays 0 and 1 (same region), the checksum in
+// FLASH and in overlay 4 (second region)
+#define SCRAMBLE(buf, len)                              \
+    for (uint32_t i = 0; i < (len); i++)                \
+    {                                                   \
+        (buf)[i] = ((buf)[i] << 5 | (buf)[i] >> 27) ^ 0x9E3779B9u; \
+    }
+#define MIX(buf, len)                                   \
+    for (uint32_t i = 1; i < (len); i++)                \
+    {                                                   \
+        (buf)[i] += (buf)[i - 1] * 7u;                  \
+    }
+#define CHECKSUM(sum, buf, len)                         \
+    for (uint32_t i = 0; i < (len); i++)                \
+    {                                                   \
+        (sum) = ((sum) << 1 | (sum) >> 31) ^ (buf)[i];  \
+    }
+
+static __attribute__((noinline)) void scramble_flash(uint32_t *buf, uint32_t len) { SCRAMBLE(buf, len) }
+static __attribute__((noinline)) void mix_flash(uint32_t *buf, uint32_t len) { MIX(buf, len) }
+static __attribute__((noinline)) uint32_t checksum_flash(const uint32_t *buf, uint32_t len)
+{
+    uint32_t sum = 0;
+    CHECKSUM(sum, buf, len)
+    return sum;
+}
+
+static OVERLAY(0) void scramble_ovl(uint32_t *buf, uint32_t len) { SCRAMBLE(buf, len) }
+static OVERLAY(1) void mix_ovl(uint32_t *buf, uint32_t len) { MIX(buf, len) }
+static OVERLAY(4) uint32_t checksum_ovl(const uint32_t *buf, uint32_t len)
+{
+    uint32_t sum = 0;
+    CHECKSUM(sum, buf, len)
+    return sum;
+}
+
+static void fill(void)
+{
+    for (uint32_t i = 0; i < DATA_LEN; i++)
+    {
+        data[i] = i * 0x9E3779B9u;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int cycles_flash, cycles_ovl;
+    uint32_t sum_flash = 0, sum_ovl = 0;
+    uint32_t block = DATA_LEN / BLOCKS;
+    overlay_stats_t stats;
+
+    overlay_reset_stats();
+
+    fill();
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    for (uint32_t p = 0; p < PASSES; p++)
+    {
+        for (uint32_t b = 0; b < BLOCKS; b++)
+        {
+            scramble_flash(data + b * block, block);
+            mix_flash(data + b * block, block);
+            sum_flash += checksum_flash(data + b * block, block);
+        }
+    }
+    CSR_READ(CSR_REG_MCYCLE, &cycles_flash);
+
+    fill();
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    for (uint32_t p = 0; p < PASSES; p++)
+    {
+        for (uint32_t b = 0; b < BLOCKS; b++)
+        {
+            OVERLAY_CALL(0, scramble_ovl, data + b * block, block);
+            OVERLAY_CALL(1, mix_ovl, data + b * block, block);
+            sum_ovl += OVERLAY_CALL(4, checksum_ovl, data + b * block, block);
+        }
+    }
+    CSR_READ(CSR_REG_MCYCLE, &cycles_ovl);
+
+    if (sum_flash != sum_ovl)
+    {
+        PRINTF("Checksums differ: %08x %08x\n\r", sum_flash, sum_ovl);
+        return EXIT_FAILURE;
+    }
+
+    overlay_get_stats(&stats);
+    PRINTF("flash: %u cycles, overlays: %u cycles\n\r", cycles_flash, cycles_ovl);
+    PRINTF("overlays: %u loads, %u hits, %u bytes, %u load cycles\n\r", stats.loads, stats.hits,
+           stats.bytes, stats.load_cycles);
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
@@ -18,11 +18,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 
 #include "core_v_mini_mcu.h"
 #include "x-heep.h"
-#include "pdm2pcm_regs.h"
-#include "mmio.h"
+#include "csr.h"
+#include "hart.h"
+#include "rv_plic.h"
+#include "pdm2pcm.h"
+#include "pdm2pcm_stream.h"
 #include "groundtruth.h"
 
 #ifndef PDM2PCM_IS_INCLUDED
@@ -41,77 +45,80 @@
     #define PRINTF(...)
 #endif
 
-int main(int argc, char *argv[])
-{
+#define CLK_DIV       15
+#define DECIMATION    16
+#define COUNT         5
+#define BUFFER_WORDS  8
+#define BUFFERS       2
+
+static uint32_t ring[BUFFERS * BUFFER_WORDS];
+static dma_stream_t stream;
 
+static volatile int count = 0;
+static volatile int finish = 0;
+static volatile int errors = 0;
+static int fed = 0;
+
+// Compare the samples with the ground truth, from the first non-zero one
+static void buffer_done(dma_stream_t *s, uint8_t *buffer, uint32_t index, void *arg)
+{
+    uint32_t *samples = (uint32_t *)buffer;
+
+    for (int i = 0; i < BUFFER_WORDS && !finish; i++) {
+        int32_t read = (int32_t)samples[i];
+        if (fed == 1 || read != 0) {
+            fed = 1;
+            if (pdm2pcm_groundtruth[count] != (int)read) {
+                PRINTF("ERROR: at index %d. read != groundtruth (resp. %d != %d).\n\r",count,(int)read,pdm2pcm_groundtruth[count]);
+                errors++;
+                finish = 1;
+            }
+            ++count;
+            if (count >= COUNT) {
+                finish = 1;
+            }
+        }
+    }
+    dma_stream_release(s);
+}
 
+int main(int argc, char *argv[])
+{
     PRINTF("PDM2PCM DEMO\n\r");
     PRINTF(" > Start\n\r");
 
-    mmio_region_t pdm2pcm_base_addr = mmio_region_from_addr((uintptr_t)PDM2PCM_START_ADDRESS);
-
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_CLKDIVIDX_REG_OFFSET ,15);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_REACHCOUNT_REG_OFFSET, 1);
-
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_DECIMCIC_REG_OFFSET, 15);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_DECIMHB1_REG_OFFSET, 31);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_DECIMHB2_REG_OFFSET, 63);
-
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB1COEF00_REG_OFFSET, 1);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB1COEF01_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB1COEF02_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB1COEF03_REG_OFFSET, 0);
-
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF00_REG_OFFSET, 1);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF01_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF02_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF03_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF04_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF05_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_HB2COEF06_REG_OFFSET, 0);
-
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF00_REG_OFFSET, 1);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF01_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF02_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF03_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF04_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF05_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF06_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF07_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF08_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF09_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF10_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF11_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF12_REG_OFFSET, 0);
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_FIRCOEF13_REG_OFFSET, 0);
-
-    mmio_region_write32(pdm2pcm_base_addr, PDM2PCM_CONTROL_REG_OFFSET  , 1);
-
-    int const COUNT = 5;
-
-    int count = 0;
-    int finish = 0;
-    int fed = 0;
-
-    while(finish == 0) {
-        uint32_t status = mmio_region_read32(pdm2pcm_base_addr, PDM2PCM_STATUS_REG_OFFSET);
-        if (!(status & 1)) {
-            int32_t read = mmio_region_read32(pdm2pcm_base_addr, PDM2PCM_RXDATA_REG_OFFSET);
-            if (fed == 1 || read != 0) {
-                fed = 1;
-                if(pdm2pcm_groundtruth[count] != (int)read) {
-                    PRINTF("ERROR: at index %d. read != groundtruth (resp. %d != %d).\n\r",count,(int)read,pdm2pcm_groundtruth[count]);
-                    return EXIT_FAILURE;
-                }
-                ++count;
-                if (count >= COUNT) {
-                    finish = 1;
-                    PRINTF("SUCCESS: Readings correspond to ground truth.\n\r");
-                }
-            }
+    plic_Init();
+
+    if (pdm2pcm_init(CLK_DIV, DECIMATION, PDM2PCM_PASSBAND_80) != kPdm2PcmOk) {
+        PRINTF("ERROR: PDM2PCM init failed.\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // The PCM samples are copied by the DMA, the core only wakes up once per buffer
+    pdm2pcm_stream_init(&stream, ring, BUFFER_WORDS, BUFFERS, buffer_done, NULL);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    if (pdm2pcm_stream_start(&stream) != 0) {
+        PRINTF("ERROR: PDM2PCM stream start failed.\n\r");
+        return EXIT_FAILURE;
+    }
+
+    while (!finish) {
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        if (!finish) {
+            wait_for_interrupt();
         }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
     }
-    return EXIT_SUCCESS;
 
-}
+    pdm2pcm_stream_stop(&stream);
 
+    if (dma_stream_overruns(&stream) != 0) {
+        PRINTF("ERROR: %d buffers dropped.\n\r", dma_stream_overruns(&stream));
+        return EXIT_FAILURE;
+    }
+    if (errors != 0) {
+        return EXIT_FAILURE;
+    }
+    PRINTF("SUCCESS: Readings correspond to ground truth.\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Entry and exit latency of a PLIC interrupt, raised by a GPIO looped
+ *        back onto another one (connected in the testbench, use a cable on
+ *        the FPGA). Build with PLIC_VECTORED=1 to compare with the constant
+ *        handler table and the claim loop.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "gpio.h"
+#include "pad_control.h"
+#include "pad_control_regs.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#ifndef RV_PLIC_IS_INCLUDED
+  #error ( "This app does NOT work as the RV_PLIC peripheral is not included" )
+#endif
+
+#ifdef TARGET_PYNQ_Z2
+    #define GPIO_TB_OUT 8
+    #define GPIO_TB_IN  9
+    #define GPIO_INTR  GPIO_INTR_9
+    #pragma message ( "Connect a cable between GPIOs IN and OUT" )
+#else
+    #define GPIO_TB_OUT 30
+    #define GPIO_TB_IN  31
+    #define GPIO_INTR  GPIO_INTR_31
+#endif
+
+#define RUNS 16
+
+static volatile uint32_t t_entry;
+static volatile uint32_t t_leave;
+static volatile uint32_t served;
+
+static inline uint32_t cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+static void gpio_handler(void)
+{
+    t_entry = cycles();
+    gpio_intr_clear_stat(GPIO_TB_IN);
+    served++;
+    t_leave = cycles();
+}
+
+int main(int argc, char *argv[])
+{
+    pad_control_t pad_control;
+    pad_control.base_addr = mmio_region_from_addr((uintptr_t)PAD_CONTROL_START_ADDRESS);
+
+    if (plic_Init() != kPlicOk) {
+        PRINTF("Init PLIC failed\n\r");
+        return EXIT_FAILURE;
+    }
+
+#if GPIO_TB_OUT == 31 || GPIO_TB_IN == 31
+    pad_control_set_mux(&pad_control, (ptrdiff_t)(PAD_CONTROL_PAD_MUX_I2C_SCL_REG_OFFSET), 1);
+#endif
+#if GPIO_TB_OUT == 30 || GPIO_TB_IN == 30
+    pad_control_set_mux(&pad_control, (ptrdiff_t)(PAD_CONTROL_PAD_MUX_I2C_SDA_REG_OFFSET), 1);
+#endif
+
+    plic_irq_set_priority(GPIO_INTR, 1);
+    plic_irq_set_enabled(GPIO_INTR, kPlicToggleEnabled);
+
+    gpio_cfg_t cfg_out = {
+        .pin = GPIO_TB_OUT,
+        .mode = GpioModeOutPushPull
+    };
+    gpio_cfg_t cfg_in = {
+        .pin = GPIO_TB_IN,
+        .mode = GpioModeIn,
+        .en_input_sampling = true,
+        .en_intr = true,
+        .intr_type = GpioIntrEdgeRising
+    };
+    if (gpio_config(cfg_out) != GpioOk || gpio_config(cfg_in) != GpioOk) {
+        PRINTF("GPIO config failed\n\r");
+        return EXIT_FAILURE;
+    }
+    gpio_write(GPIO_TB_OUT, false);
+    gpio_assign_irq_handler(GPIO_INTR, &gpio_handler);
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    uint32_t entry_min = UINT32_MAX, entry_max = 0, entry_sum = 0;
+    uint32_t exit_min = UINT32_MAX, exit_max = 0, exit_sum = 0;
+
+    for (int i = 0; i < RUNS; i++) {
+        uint32_t before = served;
+
+        // The handler runs between the write and the loads of served
+        uint32_t t_raise = cycles();
+        gpio_write(GPIO_TB_OUT, true);
+        while (served == before) {
+        }
+        uint32_t t_back = cycles();
+
+        // Cycles from the write to the handler, and from its end to main
+        uint32_t entry = t_entry - t_raise;
+        uint32_t exit = t_back - t_leave;
+        entry_min = entry < entry_min ? entry : entry_min;
+        entry_max = entry > entry_max ? entry : entry_max;
+        exit_min = exit < exit_min ? exit : exit_min;
+        exit_max = exit > exit_max ? exit : exit_max;
+        entry_sum += entry;
+        exit_sum += exit;
+
+        gpio_write(GPIO_TB_OUT, false);
+    }
+
+#ifdef PLIC_VECTORED
+    PRINTF("PLIC dispatch: vectored\n\r");
+#else
+    PRINTF("PLIC dispatch: default\n\r");
+#endif
+    PRINTF("entry: min %d, mean %d, max %d cycles\n\r", entry_min, entry_sum / RUNS, entry_max);
+    PRINTF("exit:  min %d, mean %d, max %d cycles\n\r", exit_min, exit_sum / RUNS, exit_max);
+
+    gpio_intr_dis_all(GPIO_TB_IN);
+    plic_irq_set_enabled(GPIO_INTR, kPlicToggleDisabled);
+
+    PRINTF("Success\n\r");
+    return served == RUNS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+// Copyright EPFL contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Info: Entry and exit costs of power_gate_core() and of
+//       power_gate_core_fast(), in cycles of the AO rv_timer. The software
+//       cost is measured with the wakeup interrupt already pending, so that
+//       wfi does not sleep; the power-gate cost is what a real power-gate
+//       adds to the programmed sleep, with the sequences of the power
+//       manager and the boot ROM.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_timer.h"
+#include "power_manager.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define N_ROUNDS      8
+// Cycles between the start of a power-gate and its wakeup interrupt
+#define SLEEP_CYCLES  2000
+
+// Bits of MIE
+#define MIE_MTIE (1 << 7)
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+} cost_t;
+
+typedef power_manager_result_t (*gate_t)(void);
+
+static rv_timer_t timer_0_1;
+static power_manager_t power_manager;
+static power_manager_counters_t cpu_counters;
+
+static uint64_t now(void)
+{
+    uint64_t t;
+    rv_timer_counter_read(&timer_0_1, 0, &t);
+    return t;
+}
+
+static void disarm(void)
+{
+    rv_timer_arm(&timer_0_1, 0, 0, UINT64_MAX);
+    rv_timer_irq_clear(&timer_0_1, 0, 0);
+}
+
+static power_manager_result_t gate_standard(void)
+{
+    return power_gate_core(&power_manager, kTimer_0_pm_e, &cpu_counters);
+}
+
+static power_manager_result_t gate_fast(void)
+{
+    return power_gate_core_fast(kTimer_0_pm_e);
+}
+
+static void add(cost_t *c, uint32_t cycles)
+{
+    if (cycles < c->min) c->min = cycles;
+    if (cycles > c->max) c->max = cycles;
+    c->sum += cycles;
+}
+
+// The wakeup interrupt is pending and enabled: wfi returns right away
+static uint32_t measure_software(gate_t gate)
+{
+    rv_timer_arm(&timer_0_1, 0, 0, 0);
+    CSR_SET_BITS(CSR_REG_MIE, MIE_MTIE);
+
+    uint64_t t0 = now();
+    gate();
+    uint64_t t1 = now();
+
+    CSR_CLEAR_BITS(CSR_REG_MIE, MIE_MTIE);
+    disarm();
+    return t1 - t0;
+}
+
+// The interrupt is only seen by the power manager, the core is switched off
+static uint32_t measure_power_gate(gate_t gate)
+{
+    uint64_t t0 = now();
+    rv_timer_arm(&timer_0_1, 0, 0, t0 + SLEEP_CYCLES);
+    gate();
+    uint64_t t1 = now();
+
+    disarm();
+    return t1 - t0 - SLEEP_CYCLES;
+}
+
+static void print_cost(const char *name, const cost_t *c)
+{
+    PRINTF("%-22s %6d %6d %6d\n\r", name, c->min, c->sum / N_ROUNDS, c->max);
+}
+
+int main(int argc, char *argv[])
+{
+    cost_t standard_sw = {UINT32_MAX, 0, 0}, fast_sw = {UINT32_MAX, 0, 0};
+    cost_t standard_pg = {UINT32_MAX, 0, 0}, fast_pg = {UINT32_MAX, 0, 0};
+
+    power_manager.base_addr = mmio_region_from_addr(POWER_MANAGER_START_ADDRESS);
+
+    // Same sequences as example_power_gating_core
+    if (power_gate_counters_init(&cpu_counters, 15, 30, 20, 10, 10, 35, 0, 0) != kPowerManagerOk_e)
+    {
+        PRINTF("Error: power manager fail. Check the reset and powergate counters value\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // The counter ticks every cycle
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_set_tick_params(&timer_0_1, 0, (rv_timer_tick_params_t){.prescale = 0, .tick_step = 1});
+    disarm();
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+
+    for (int i = 0; i < N_ROUNDS; i++)
+    {
+        add(&standard_sw, measure_software(gate_standard));
+        add(&standard_pg, measure_power_gate(gate_standard));
+    }
+
+    if (power_gate_core_fast_init(&power_manager, &cpu_counters) != kPowerManagerOk_e)
+    {
+        PRINTF("Error: power manager fail.\n\r");
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < N_ROUNDS; i++)
+    {
+        add(&fast_sw, measure_software(gate_fast));
+        add(&fast_pg, measure_power_gate(gate_fast));
+    }
+
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    PRINTF("%-22s %6s %6s %6s\n\r", "cycles", "min", "mean", "max");
+    print_cost("software, standard", &standard_sw);
+    print_cost("software, fast", &fast_sw);
+    print_cost("power-gate, standard", &standard_pg);
+    print_cost("power-gate, fast", &fast_pg);
+
+    if (fast_sw.max >= standard_sw.min)
+    {
+        PRINTF("Error: the fast entry is not faster\n\r");
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("Success.\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+// Copyright EPFL contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Info: Entry and exit latencies of the power domains, in cycles, for
+//       counters of growing steps, and the break-even idle times that follow.
+//       The peripheral domain, the RAM banks not used by the program (off and
+//       in retention) and the external domains are timed by
+//       power_policy_measure(). The core is timed with the AO rv_timer: its
+//       entry runs while it sleeps, what a power-gate adds to the programmed
+//       sleep is its exit. The break-even times assume SWITCH_ENERGY, to be
+//       replaced by the figure of the technology. Last, power_policy_calibrate()
+//       sets the break-even times of the policy with the default counters.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_timer.h"
+#include "power_manager.h"
+#include "power_policy.h"
+#include "ram_bank.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+// Energy of a switch off and on, in cycles of the leakage of a domain when on
+#define SWITCH_ENERGY 2000
+// Cycles between the start of a power-gate of the core and its wakeup
+#define SLEEP_CYCLES  2000
+
+// Steps of the counters, see counters_of()
+static const uint32_t steps[] = {1, 10, 50};
+#define N_STEPS (sizeof(steps) / sizeof(steps[0]))
+
+static rv_timer_t timer_0_1;
+static power_manager_t power_manager;
+
+// The order of example_power_gating_core: off, the isolation, the reset,
+// then the switch, on, the switch, the reset, then the isolation
+static void counters_of(uint32_t step, power_manager_counters_t *counters)
+{
+    power_gate_counters_init(counters, 2 * step, 3 * step, 3 * step, step, step, 4 * step, step, step);
+}
+
+static void print_row(const char *name, uint32_t step, const power_policy_latency_t *latency)
+{
+    PRINTF("%-14s %4u %8u %8u %10u\n\r", name, step, latency->entry, latency->exit,
+           power_policy_break_even_of(latency, SWITCH_ENERGY));
+}
+
+// Cycles of the AO rv_timer that a power-gate of the core adds to the sleep
+static uint32_t measure_core(power_manager_counters_t *counters)
+{
+    uint64_t t0, t1;
+
+    rv_timer_counter_read(&timer_0_1, 0, &t0);
+    rv_timer_arm(&timer_0_1, 0, 0, t0 + SLEEP_CYCLES);
+    power_gate_core(&power_manager, kTimer_0_pm_e, counters);
+    rv_timer_counter_read(&timer_0_1, 0, &t1);
+
+    rv_timer_arm(&timer_0_1, 0, 0, UINT64_MAX);
+    rv_timer_irq_clear(&timer_0_1, 0, 0);
+    return t1 - t0 - SLEEP_CYCLES;
+}
+
+static uint32_t measure_domain(const char *name, uint32_t domain, power_policy_state_t state)
+{
+    power_manager_counters_t counters;
+    power_policy_latency_t latency;
+    uint32_t errors = 0;
+
+    for (uint32_t s = 0; s < N_STEPS; s++)
+    {
+        counters_of(steps[s], &counters);
+        if (power_policy_measure(domain, state, &counters, &latency) != 0)
+        {
+            PRINTF("%-14s %4u failed\n\r", name, steps[s]);
+            errors++;
+            continue;
+        }
+        print_row(name, steps[s], &latency);
+    }
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    power_manager_counters_t counters;
+    power_policy_latency_t latency;
+    uint32_t used = ram_banks_in_use();
+    uint32_t errors = 0;
+    char name[16];
+
+    power_manager.base_addr = mmio_region_from_addr(POWER_MANAGER_START_ADDRESS);
+    power_policy_init(&power_manager);
+
+    // The counter ticks every cycle
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_set_tick_params(&timer_0_1, 0, (rv_timer_tick_params_t){.prescale = 0, .tick_step = 1});
+    rv_timer_arm(&timer_0_1, 0, 0, UINT64_MAX);
+    rv_timer_irq_clear(&timer_0_1, 0, 0);
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    PRINTF("%-14s %4s %8s %8s %10s\n\r", "domain", "step", "entry", "exit", "break-even");
+
+    // The interrupt only wakes the core through the power manager
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    for (uint32_t s = 0; s < N_STEPS; s++)
+    {
+        counters_of(steps[s], &counters);
+        latency.entry = 0;
+        latency.exit = measure_core(&counters);
+        print_row("core", steps[s], &latency);
+    }
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    errors += measure_domain("periph", POWER_POLICY_PERIPH_DOMAIN, kPowerPolicyOff);
+    for (uint32_t b = 0; b < MEMORY_BANKS; b++)
+    {
+        if (used >> b & 1)
+        {
+            continue;
+        }
+        snprintf(name, sizeof(name), "bank %u", b);
+        errors += measure_domain(name, b, kPowerPolicyOff);
+        snprintf(name, sizeof(name), "bank %u ret", b);
+        errors += measure_domain(name, b, kPowerPolicyRetention);
+    }
+    for (uint32_t e = 0; e < EXTERNAL_DOMAINS; e++)
+    {
+        snprintf(name, sizeof(name), "external %u", e);
+        errors += measure_domain(name, POWER_POLICY_EXTERNAL_DOMAIN(e), kPowerPolicyOff);
+    }
+
+    // The banks of the program are in use and cannot be measured
+    for (uint32_t d = 0; d < POWER_POLICY_DOMAINS; d++)
+    {
+        int pinned = d < MEMORY_BANKS && (used >> d & 1);
+        if ((power_policy_calibrate(d, SWITCH_ENERGY) != 0) != pinned)
+        {
+            PRINTF("Error: calibration of domain %u\n\r", d);
+            errors++;
+        }
+    }
+
+    if (errors != 0)
+    {
+        PRINTF("%u errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("Success.\n\r");
+    return EXIT_SUCCESS;
+}
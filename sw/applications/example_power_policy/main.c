@@ -0,0 +1,97 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Power policy of the RAM banks and of the peripheral domain. An idle
+ *        time shorter than the break-even time must leave the domains on, a
+ *        longer one must switch off the banks not used by the program and
+ *        the peripheral domain, which an acquire switches on again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "core_v_mini_mcu.h"
+#include "power_manager.h"
+#include "power_policy.h"
+#include "ram_bank.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define BREAK_EVEN  5000
+
+static power_manager_t power_manager;
+
+int main(int argc, char *argv[])
+{
+    power_manager.base_addr = mmio_region_from_addr(POWER_MANAGER_START_ADDRESS);
+
+    power_policy_init(&power_manager);
+    for (uint32_t d = 0; d < POWER_POLICY_DOMAINS; d++) {
+        power_policy_set_break_even(d, BREAK_EVEN);
+    }
+
+    // Nothing is switched for a short idle time, just after the init
+    if (power_policy_idle(10) != 0) {
+        PRINTF("Error: switched below the break-even time\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // All the unused domains are switched for a long one
+    power_policy_idle(2 * BREAK_EVEN);
+
+    uint32_t used = ram_banks_in_use();
+    for (uint32_t b = 0; b < MEMORY_BANKS; b++) {
+        uint32_t off = ram_block_power_domain_is_off(&power_manager, b);
+        PRINTF("bank %d: %s\n\r", b, (used >> b & 1) ? "program" : off ? "off" : "on");
+        if (off == ((used >> b & 1) != 0)) {
+            PRINTF("Error: bank %d\n\r", b);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!periph_power_domain_is_off(&power_manager) ||
+        power_policy_state(POWER_POLICY_PERIPH_DOMAIN) != kPowerPolicyOff) {
+        PRINTF("Error: peripheral domain still on\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // The acquire switches the peripheral domain on and asks to configure it
+    if (power_policy_periph_acquire(RV_PLIC_IDX) != 1 ||
+        periph_power_domain_is_off(&power_manager)) {
+        PRINTF("Error: peripheral domain not switched on\n\r");
+        return EXIT_FAILURE;
+    }
+    // A second user of the domain finds it on
+    if (power_policy_periph_acquire(GPIO_IDX) != 0) {
+        PRINTF("Error: peripheral domain switched twice\n\r");
+        return EXIT_FAILURE;
+    }
+    power_policy_periph_release(GPIO_IDX);
+
+    // Still used by the PLIC
+    power_policy_idle(2 * BREAK_EVEN);
+    if (periph_power_domain_is_off(&power_manager)) {
+        PRINTF("Error: peripheral domain switched off while used\n\r");
+        return EXIT_FAILURE;
+    }
+    power_policy_periph_release(RV_PLIC_IDX);
+
+    PRINTF("peripheral domain gated %d times\n\r",
+           power_policy_gatings(POWER_POLICY_PERIPH_DOMAIN));
+
+    /* write something to stdout */
+    PRINTF("Success.\n\r");
+    return EXIT_SUCCESS;
+}
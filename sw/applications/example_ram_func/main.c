@@ -0,0 +1,122 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Example application of the RAM_FUNC and RAM_RODATA attributes. The
+ *        same loop is run from the FLASH and from the RAM and the cycles of
+ *        both are compared, then the same lookups at scattered indices are
+ *        made in a table of the FLASH and in its copy in RAM. It is meant to
+ *        be linked with LINKER=flash_exec, with the other linker scripts
+ *        everything is in the RAM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "ram_func.h"
+
+#define DATA_LEN 256
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+static uint32_t data[DATA_LEN];
+
+// Same table twice, one read from the FLASH and one copied to RAM by the crt0
+#define T1(i)   (uint16_t)((i) * 40503u)
+#define T4(i)   T1(i), T1(i + 1), T1(i + 2), T1(i + 3)
+#define T16(i)  T4(i), T4(i + 4), T4(i + 8), T4(i + 12)
+#define T64(i)  T16(i), T16(i + 16), T16(i + 32), T16(i + 48)
+#define T256(i) T64(i), T64(i + 64), T64(i + 128), T64(i + 192)
+
+static const uint16_t table_flash[256] = {T256(0)};
+static const uint16_t RAM_RODATA table_ram[256] = {T256(0)};
+
+static __attribute__((noinline)) uint32_t checksum_flash(const uint32_t *buf, uint32_t len)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        sum = (sum << 1 | sum >> 31) ^ buf[i];
+    }
+    return sum;
+}
+
+static RAM_FUNC uint32_t checksum_ram(const uint32_t *buf, uint32_t len)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        sum = (sum << 1 | sum >> 31) ^ buf[i];
+    }
+    return sum;
+}
+
+// Runs from RAM for both tables, so that only the reads of the table differ
+static RAM_FUNC uint32_t lookup(const uint16_t *table, const uint32_t *buf, uint32_t len)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        sum += table[buf[i] >> 24];
+    }
+    return sum;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int cycles_flash, cycles_ram;
+    unsigned int cycles_table_flash, cycles_table_ram;
+
+    for (uint32_t i = 0; i < DATA_LEN; i++)
+    {
+        data[i] = i * 0x9E3779B9;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    uint32_t sum_flash = checksum_flash(data, DATA_LEN);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_flash);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    uint32_t sum_ram = checksum_ram(data, DATA_LEN);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_ram);
+
+    if (sum_flash != sum_ram)
+    {
+        PRINTF("Checksums differ: %08x %08x\n\r", sum_flash, sum_ram);
+        return EXIT_FAILURE;
+    }
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    uint32_t lookup_flash = lookup(table_flash, data, DATA_LEN);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_table_flash);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    uint32_t lookup_ram = lookup(table_ram, data, DATA_LEN);
+    CSR_READ(CSR_REG_MCYCLE, &cycles_table_ram);
+
+    if (lookup_flash != lookup_ram)
+    {
+        PRINTF("Lookups differ: %08x %08x\n\r", lookup_flash, lookup_ram);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("flash: %u cycles, ram: %u cycles\n\r", cycles_flash, cycles_ram);
+    PRINTF("table in flash: %u cycles, table in ram: %u cycles\n\r", cycles_table_flash, cycles_table_ram);
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
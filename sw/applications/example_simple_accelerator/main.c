@@ -2,13 +2,22 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+// Queues several copies to the simple accelerator through its command queue,
+// each with its own tag, threshold and size, sleeps until their completions
+// and checks the copied data.
+
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "core_v_mini_mcu.h"
 #include "x-heep.h"
+#include "csr.h"
+#include "rv_plic.h"
+
+#include "simple_accelerator.h"
 
 #define TEST_DATA_SIZE      16
+#define TEST_JOBS           6
 
 #define PRINTF_IN_SIM   0
 
@@ -21,65 +30,76 @@
 
 int32_t errors = 0;
 
-//defined in the testharness_pkg.sv
-#define SIMPLE_ACC_START_ADDRESS EXT_PERIPHERAL_START_ADDRESS + 0x3000;
+static uint32_t source_data[TEST_DATA_SIZE] __attribute__ ((aligned (4)));
+static uint32_t copied_data[TEST_JOBS][TEST_DATA_SIZE] __attribute__ ((aligned (4)));
 
-// Simple accelerator Decoder (address for bytes)
-//0 READ ADDRESS
-#define SIMPLE_ACC_READ_OFFSET 0
-//4 WRITE ADDRESS
-#define SIMPLE_ACC_WRITE_OFFSET 1
-//8 THRESHOLD
-#define SIMPLE_ACC_THRESHOLD_OFFSET 2
-//C READY
-#define SIMPLE_ACC_READY_OFFSET 3
-//10 SIZE
-#define SIMPLE_ACC_SIZE_OFFSET 4
-//14 START
-#define SIMPLE_ACC_START_OFFSET 5
+static const uint32_t thresholds[TEST_JOBS] = { 20, 0, 10, 45, 7, 30 };
+static const uint32_t sizes[TEST_JOBS] = { 16, 16, 8, 1, 12, 16 };
 
+int check_job(int job)
+{
+    int job_errors = 0;
 
+    for(int i=0;i<TEST_DATA_SIZE;i++) {
+        uint32_t expected_data = source_data[i] > thresholds[job] ? source_data[i] : thresholds[job];
+        if (i >= sizes[job]) expected_data = 0;
+        if(copied_data[job][i] != expected_data){
+            job_errors++;
+            PRINTF("job %d: copied_data[%d] is %d, expected %d\n\r", job, i, copied_data[job][i], expected_data);
+        }
+    }
+    return job_errors;
+}
 
 int main(int argc, char *argv[])
 {
-
-    static uint32_t source_data[TEST_DATA_SIZE] __attribute__ ((aligned (4)));
-    static uint32_t copied_data[TEST_DATA_SIZE] __attribute__ ((aligned (4)));
-    uint32_t threshold_value = 20;
-    volatile static uint32_t *simple_acc =  SIMPLE_ACC_START_ADDRESS;
-
+    acc_cmdq_cpl_t cpl;
+    uint32_t done = 0;
+    int submitted = 0;
 
     for(int i=0;i<TEST_DATA_SIZE;i++)
         source_data[i] = i & 0x1 ? i*3 : i*2;
 
+    plic_Init();
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
 
-    simple_acc[SIMPLE_ACC_READ_OFFSET] = &source_data[0];
-    simple_acc[SIMPLE_ACC_WRITE_OFFSET] = &copied_data[0];
-    simple_acc[SIMPLE_ACC_THRESHOLD_OFFSET] = threshold_value;
-    simple_acc[SIMPLE_ACC_SIZE_OFFSET] = TEST_DATA_SIZE;
-
-    //START
-    simple_acc[SIMPLE_ACC_START_OFFSET] = 1;
+    if (simple_accelerator_init() != kAccCmdqOk) {
+        PRINTF("Simple Accelerator not found\n\r");
+        return EXIT_FAILURE;
+    }
 
-    //UNTIL IT IS NOT READY.. WAIT SIMPLE ACCELERATOR
-    while(simple_acc[SIMPLE_ACC_READY_OFFSET] != 1);
+    // Queue the jobs as long as there are free slots, and take a completion
+    // when the queue is full
+    while (done != (1 << TEST_JOBS) - 1) {
+        if (submitted < TEST_JOBS) {
+            simple_accelerator_args_t args = {
+                .src = (uint32_t)&source_data[0],
+                .dst = (uint32_t)&copied_data[submitted][0],
+                .threshold = thresholds[submitted],
+                .size = sizes[submitted],
+            };
+            if (simple_accelerator_submit(kSimpleAcceleratorOpCopy, submitted, &args) == kAccCmdqOk) {
+                submitted++;
+                continue;
+            }
+        }
 
-    errors = 0;
-    for(int i=0;i<TEST_DATA_SIZE;i++) {
-        uint32_t expected_data = source_data[i] > threshold_value ? source_data[i] : threshold_value;
-        if(copied_data[i] != expected_data){
+        simple_accelerator_wait(&cpl);
+        if (cpl.tag >= TEST_JOBS || cpl.status != 0 || (done >> cpl.tag) & 0x1) {
+            PRINTF("Unexpected completion: tag %d, status %d\n\r", cpl.tag, cpl.status);
             errors++;
-            PRINTF("copied_data[%d] is %d, expected %d\n\r",i,copied_data[i], expected_data);
+            break;
         }
+        done |= 1 << cpl.tag;
+        errors += check_job(cpl.tag);
     }
 
     if (errors == 0) {
         PRINTF("Simple Accelerator Successful\n\r");
         return EXIT_SUCCESS;
     } else {
-        PRINTF("Simple Accelerator failure: %d errors out of %d data checked\n\r", errors, TEST_DATA_SIZE );
+        PRINTF("Simple Accelerator failure: %d errors\n\r", errors);
         return EXIT_FAILURE;
     }
-
-    return EXIT_SUCCESS;
 }
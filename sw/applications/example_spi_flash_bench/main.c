@@ -0,0 +1,204 @@
+/**
+ * @file main.c
+ * @brief Throughput and latency benchmark of the W25Q BSP read and write modes
+ *
+ * Every read and write mode of the BSP is run on a sweep of transfer sizes
+ * and flash address alignments. For each run the cycles (mcycle) and the
+ * bytes per 1000 cycles are reported, and the data is checked. The results
+ * are meant to pick the default of w25q128jw_read for the data sizes of an
+ * application.
+ *
+ * The writes use a scratch area at the end of the flash, which is erased
+ * before each run (not timed). The time of a write includes the program of
+ * its last page, which the BSP otherwise lets finish in the background.
+ *
+ * @note In simulation the flash is not polled after programs and erases, so
+ * the write figures only cover the SPI transfers.
+ *
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "x-heep.h"
+#include "csr.h"
+#include "w25q128jw.h"
+
+/* The report is the point of the application, it is printed everywhere */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#if defined(TARGET_PYNQ_Z2) || defined(TARGET_ZCU104) || defined(TARGET_NEXYS_A7_100T)
+    #define USE_SPI_FLASH
+#endif
+
+// Scratch area for the writes, the last 64kB block of the 16MB flash
+#define SCRATCH_ADDR 0x00FF0000
+
+// Largest transfer, plus room for the alignment offsets
+#define MAX_LENGTH 4096
+#define BUFFER_LENGTH (MAX_LENGTH + 4)
+
+// Transfer sizes and flash address offsets of the sweep
+static const uint32_t lengths[] = {4, 16, 64, 256, 1024, 4096};
+static const uint32_t offsets[] = {0, 1, 2, 3};
+
+#define N_LENGTHS (sizeof(lengths)/sizeof(lengths[0]))
+#define N_OFFSETS (sizeof(offsets)/sizeof(offsets[0]))
+
+typedef w25q_error_codes_t (*flash_op_t)(uint32_t addr, void* data, uint32_t length);
+
+typedef struct {
+    const char *name;
+    flash_op_t op;
+} bench_mode_t;
+
+static const bench_mode_t read_modes[] = {
+    {"read_standard",     w25q128jw_read_standard},
+    {"read_standard_dma", w25q128jw_read_standard_dma},
+    {"read_quad",         w25q128jw_read_quad},
+    {"read_quad_dma",     w25q128jw_read_quad_dma},
+};
+
+static const bench_mode_t write_modes[] = {
+    {"write_standard",     w25q128jw_write_standard},
+    {"write_standard_dma", w25q128jw_write_standard_dma},
+    {"write_quad",         w25q128jw_write_quad},
+    {"write_quad_dma",     w25q128jw_write_quad_dma},
+};
+
+#define N_READ_MODES (sizeof(read_modes)/sizeof(read_modes[0]))
+#define N_WRITE_MODES (sizeof(write_modes)/sizeof(write_modes[0]))
+
+// Reference data and buffer the flash is read into
+static uint8_t __attribute__((aligned(4))) reference[BUFFER_LENGTH];
+static uint8_t __attribute__((aligned(4))) buffer[BUFFER_LENGTH];
+
+// Run one mode on the sweep, return the number of failed runs
+static uint32_t bench_mode(const bench_mode_t *mode, uint8_t write);
+
+// Time a read or write of length bytes at addr, return 0 on failure
+static uint32_t bench_run(const bench_mode_t *mode, uint8_t write, uint32_t addr, uint32_t length);
+
+int main(int argc, char *argv[]) {
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+    if ( get_spi_flash_mode(&soc_ctrl) == SOC_CTRL_SPI_FLASH_MODE_SPIMEMIO ) {
+        PRINTF("This application cannot work with the memory mapped SPI FLASH"
+            "module - do not use the FLASH_EXEC linker script for this application\n");
+        return EXIT_SUCCESS;
+    }
+
+    // Pick the correct spi device based on simulation type
+    spi_host_t* spi;
+    #ifndef USE_SPI_FLASH
+    spi = spi_host1;
+    #else
+    spi = spi_flash;
+    #endif
+
+    // Init SPI host and SPI<->Flash bridge parameters
+    if (w25q128jw_init(spi) != FLASH_OK) return EXIT_FAILURE;
+
+    for (uint32_t i = 0; i < BUFFER_LENGTH; i++) {
+        reference[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("W25Q benchmark, cycles and bytes per 1000 cycles\n");
+    PRINTF("%-20s %6s %6s %10s %8s\n", "mode", "length", "offset", "cycles", "B/kcyc");
+
+    uint32_t errors = 0;
+
+    // The reads use the data programmed by the first write sweep
+    for (uint32_t i = 0; i < N_WRITE_MODES; i++) {
+        errors += bench_mode(&write_modes[i], 1);
+    }
+    for (uint32_t i = 0; i < N_READ_MODES; i++) {
+        errors += bench_mode(&read_modes[i], 0);
+    }
+
+    PRINTF("\n--------BENCHMARK FINISHED--------\n");
+    if (errors == 0) {
+        PRINTF("All runs passed!\n");
+        return EXIT_SUCCESS;
+    } else {
+        PRINTF("%u runs failed!\n", errors);
+        return EXIT_FAILURE;
+    }
+}
+
+static uint32_t bench_mode(const bench_mode_t *mode, uint8_t write) {
+    uint32_t errors = 0;
+
+    for (uint32_t l = 0; l < N_LENGTHS; l++) {
+        for (uint32_t o = 0; o < N_OFFSETS; o++) {
+            uint32_t length = lengths[l];
+            uint32_t offset = offsets[o];
+
+            uint32_t cycles = bench_run(mode, write, SCRATCH_ADDR + offset, length);
+            if (cycles == 0) {
+                PRINTF("%-20s %6u %6u %10s %8s\n", mode->name, length, offset, "error", "-");
+                errors++;
+            } else {
+                PRINTF("%-20s %6u %6u %10u %8u\n", mode->name, length, offset, cycles,
+                       (uint32_t)(((uint64_t)length * 1000) / cycles));
+            }
+        }
+    }
+
+    return errors;
+}
+
+static uint32_t bench_run(const bench_mode_t *mode, uint8_t write, uint32_t addr, uint32_t length) {
+    uint32_t offset = addr - SCRATCH_ADDR;
+    unsigned int cycles;
+
+    if (write) {
+        // The whole scratch area is rewritten, so that the reads find the reference
+        if (w25q128jw_4k_erase(SCRATCH_ADDR) != FLASH_OK) return 0;
+        if (w25q128jw_4k_erase(SCRATCH_ADDR + FLASH_SECTOR_SIZE) != FLASH_OK) return 0;
+
+        memcpy(buffer, &reference[offset], length);
+
+        CSR_WRITE(CSR_REG_MCYCLE, 0);
+        w25q_error_codes_t status = mode->op(addr, buffer, length);
+        // Any flash operation waits for the last page, read a word to include it
+        uint32_t word;
+        if (status == FLASH_OK) status = w25q128jw_read_standard(addr, &word, 4);
+        CSR_READ(CSR_REG_MCYCLE, &cycles);
+
+        if (status != FLASH_OK) return 0;
+
+        // Program the rest of the scratch area for the reads
+        if (offset != 0 && w25q128jw_write_standard(SCRATCH_ADDR, reference, offset) != FLASH_OK) return 0;
+        if (w25q128jw_write_standard(addr + length, &reference[offset + length], BUFFER_LENGTH - offset - length) != FLASH_OK) return 0;
+
+        if (w25q128jw_read_standard(addr, buffer, length) != FLASH_OK) return 0;
+    } else {
+        memset(buffer, 0, length);
+
+        CSR_WRITE(CSR_REG_MCYCLE, 0);
+        w25q_error_codes_t status = mode->op(addr, buffer, length);
+        CSR_READ(CSR_REG_MCYCLE, &cycles);
+
+        if (status != FLASH_OK) return 0;
+    }
+
+    if (memcmp(buffer, &reference[offset], length) != 0) return 0;
+
+    // A run is never 0 cycles, 0 is kept for the failures
+    return cycles ? cycles : 1;
+}
@@ -0,0 +1,226 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Throughput of the SPI slave of the testharness (obi_spi_slave), the
+ *        path by which an external host writes and reads the RAM banks. Here
+ *        X-HEEP is its own host: the SPI host drives the slave on its chip
+ *        select 1 (spi_slave_host.h), at the highest SCK of the slave, with
+ *        the DMA moving the words of the SPI FIFOs. For each size, a buffer is
+ *        written to RAM through the slave and read back, both checked, and
+ *        the cycles and bytes per 1000 cycles of each direction are printed.
+ *        Then a request is sent to the mailbox (spi_slave_mailbox.h) as the
+ *        host would, served, and its answer polled through the slave, with
+ *        the cycles of the round trip. Needs the external peripheral example
+ *        of the testharness (simulation only), or an SPI slave wired to the
+ *        SPI host pads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "soc_ctrl.h"
+#include "spi_sdk.h"
+#include "spi_slave_host.h"
+#include "spi_slave_mailbox.h"
+
+/* The report is the point of the application, it is printed everywhere */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define MAX_WORDS 1024
+
+// Command of the mailbox served here: ret[0] is the sum of arg[1] words at arg[0]
+#define MAILBOX_CMD_SUM 1
+
+static const uint32_t sizes[] = {16, 64, 256, 1024};
+
+#define NUM_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+static uint32_t src[SPI_SLAVE_HOST_HEADER_WORDS + MAX_WORDS];
+static uint32_t dst[MAX_WORDS];
+static uint32_t back[MAX_WORDS];
+
+static uint32_t cycles_now(void)
+{
+    uint32_t cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+// Bytes per 1000 cycles
+static uint32_t rate(uint32_t words, uint32_t cycles)
+{
+    return cycles ? (uint32_t)((uint64_t)words * 4 * 1000 / cycles) : 0;
+}
+
+// Returns the number of errors of one size
+static uint32_t bench_size(spi_t *spi, uint32_t words)
+{
+    uint32_t *data = src + SPI_SLAVE_HOST_HEADER_WORDS;
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        data[i] = 0x9e3779b9 * (i + words);
+        dst[i] = 0;
+        back[i] = 0;
+    }
+
+    uint32_t start = cycles_now();
+    spi_codes_e error = spi_slave_host_write(spi, (uint32_t)dst, src, words);
+    uint32_t write_cycles = cycles_now() - start;
+
+    start = cycles_now();
+    if (error == SPI_CODE_OK)
+    {
+        error = spi_slave_host_read(spi, (uint32_t)dst, back, words);
+    }
+    uint32_t read_cycles = cycles_now() - start;
+
+    if (error != SPI_CODE_OK)
+    {
+        PRINTF("%5u words: SPI error %x\n\r", words, error);
+        return 1;
+    }
+    for (uint32_t i = 0; i < words; i++)
+    {
+        errors += dst[i] != data[i];
+        errors += back[i] != data[i];
+    }
+
+    PRINTF("%5u words: write %8u cycles %5u B/kcyc, read %8u cycles %5u B/kcyc%s\n\r",
+           words, write_cycles, rate(words, write_cycles), read_cycles,
+           rate(words, read_cycles), errors ? ", MISMATCH" : "");
+    return errors;
+}
+
+// The host rings the mailbox, the device serves it, the host polls the answer
+static uint32_t bench_mailbox(spi_t *spi)
+{
+    uint32_t words = sizes[NUM_SIZES - 1];
+    uint32_t request[SPI_SLAVE_HOST_HEADER_WORDS + 2 + SPI_SLAVE_MAILBOX_ARGS];
+    uint32_t answer[2 + SPI_SLAVE_MAILBOX_RETS];
+    uint32_t expected = 0;
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        expected += dst[i];
+    }
+
+    spi_slave_mailbox_init();
+
+    uint32_t start = cycles_now();
+
+    // Host: is the mailbox served, then cmd, arg and the doorbell in one write
+    if (spi_slave_host_read(spi, (uint32_t)&spi_slave_mailbox.magic, answer, 2) != SPI_CODE_OK ||
+        answer[0] != SPI_SLAVE_MAILBOX_MAGIC)
+    {
+        PRINTF("mailbox: no magic\n\r");
+        return 1;
+    }
+    uint32_t doorbell = answer[1] + 1;
+    uint32_t *r = request + SPI_SLAVE_HOST_HEADER_WORDS;
+    r[0] = MAILBOX_CMD_SUM;
+    r[1] = (uint32_t)dst;
+    r[2] = words;
+    r[3] = 0;
+    r[4] = 0;
+    r[5] = doorbell;
+    spi_slave_host_write(spi, (uint32_t)&spi_slave_mailbox.cmd, request, 2 + SPI_SLAVE_MAILBOX_ARGS);
+
+    // Device
+    uint32_t cmd, arg[SPI_SLAVE_MAILBOX_ARGS];
+    uint32_t polls = 0;
+    while (!spi_slave_mailbox_pending(&cmd, arg))
+    {
+        if (++polls == 1000)
+        {
+            PRINTF("mailbox: no request\n\r");
+            return 1;
+        }
+    }
+    uint32_t ret[SPI_SLAVE_MAILBOX_RETS] = {0};
+    uint32_t status = 1;
+    if (cmd == MAILBOX_CMD_SUM)
+    {
+        const uint32_t *p = (const uint32_t *)arg[0];
+        for (uint32_t i = 0; i < arg[1]; i++)
+        {
+            ret[0] += p[i];
+        }
+        status = 0;
+    }
+    spi_slave_mailbox_reply(status, ret);
+
+    // Host: ack first, then status and ret
+    polls = 0;
+    do
+    {
+        if (spi_slave_host_read(spi, (uint32_t)&spi_slave_mailbox.ack, answer,
+                                2 + SPI_SLAVE_MAILBOX_RETS) != SPI_CODE_OK || ++polls == 1000)
+        {
+            PRINTF("mailbox: no answer\n\r");
+            return 1;
+        }
+    } while (answer[0] != doorbell);
+
+    uint32_t cycles = cycles_now() - start;
+    uint32_t errors = answer[1] != 0 || answer[2] != expected;
+    PRINTF("mailbox: answer in %u cycles, %u polls%s\n\r", cycles, polls,
+           errors ? ", WRONG" : "");
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+    uint32_t freq = soc_ctrl_get_frequency(&soc_ctrl);
+
+    // The slave is on the chip select 1 of the SPI host
+    spi_t spi = spi_init(SPI_IDX_HOST, SPI_SLAVE(1, SPI_SLAVE_MAX_FREQ(freq)));
+    if (!spi.init)
+    {
+        PRINTF("Failed to initialize the SPI host\n\r");
+        return EXIT_FAILURE;
+    }
+    spi_set_dma(&spi, true);
+    if (spi_slave_host_init(&spi) != SPI_CODE_OK)
+    {
+        PRINTF("Failed to set up the SPI slave\n\r");
+        return EXIT_FAILURE;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("SPI slave at %u Hz, system clock %u Hz, %u B/kcyc at most\n\r",
+           SPI_SLAVE_MAX_FREQ(freq), freq, 1000 / 2 / 8);
+
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < NUM_SIZES; i++)
+    {
+        errors += bench_size(&spi, sizes[i]);
+    }
+    errors += bench_mailbox(&spi);
+
+    if (errors)
+    {
+        PRINTF("FAILED with %u errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("All checks passed\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,299 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: STREAM-like bandwidth of the RAM. The copy, scale, add and triad
+ *        kernels of STREAM, on 32-bit integers, run on arrays placed in the
+ *        data bank (with the stack), in the continuous bank of the
+ *        data_stream section and in the interleaved banks of the
+ *        data_interleaved section, when the configuration has them (see
+ *        configs/stream.hjson). For each placement, the DMA also copies an
+ *        array, alone and while the core runs triad on the other arrays.
+ *        The best of STREAM_REPS runs of each kernel is printed in bytes per
+ *        cycle, counting the bytes each kernel reads and writes as STREAM
+ *        does. Regenerate the MCU with BUS=onetoM or BUS=NtoM to compare the
+ *        bus types.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "dma_sdk.h"
+#include "ram_bank.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+// 4 KiB per array, 12 KiB per placement
+#ifndef STREAM_WORDS
+#define STREAM_WORDS 1024
+#endif
+
+#ifndef STREAM_REPS
+#define STREAM_REPS 3
+#endif
+
+#define SCALAR 3
+
+// Keep the kernels as loads and stores, not calls to memcpy
+#if defined(__GNUC__) && !defined(__clang__)
+#define KERNEL __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+#else
+#define KERNEL __attribute__((noinline))
+#endif
+
+#define ARRAY_BYTES (STREAM_WORDS * sizeof(uint32_t))
+
+typedef struct
+{
+    const char *name;
+    uint32_t *a;
+    uint32_t *b;
+    uint32_t *c;
+} placement_t;
+
+static uint32_t data_a[STREAM_WORDS];
+static uint32_t data_b[STREAM_WORDS];
+static uint32_t data_c[STREAM_WORDS];
+
+#ifdef LINKER_SECTION_DATA_STREAM_START_ADDRESS
+static uint32_t RAM_SECTION(data_stream) bank_a[STREAM_WORDS];
+static uint32_t RAM_SECTION(data_stream) bank_b[STREAM_WORDS];
+static uint32_t RAM_SECTION(data_stream) bank_c[STREAM_WORDS];
+#endif
+
+#if defined(HAS_MEMORY_BANKS_IL) && defined(LINKER_SECTION_DATA_INTERLEAVED_START_ADDRESS)
+static uint32_t RAM_INTERLEAVED il_a[STREAM_WORDS];
+static uint32_t RAM_INTERLEAVED il_b[STREAM_WORDS];
+static uint32_t RAM_INTERLEAVED il_c[STREAM_WORDS];
+#endif
+
+// Copied by the DMA while the core runs triad, in the data bank
+static uint32_t dma_src[STREAM_WORDS];
+static uint32_t dma_dst[STREAM_WORDS];
+
+static const placement_t placements[] = {
+    {"data", data_a, data_b, data_c},
+#ifdef LINKER_SECTION_DATA_STREAM_START_ADDRESS
+    {"bank", bank_a, bank_b, bank_c},
+#endif
+#if defined(HAS_MEMORY_BANKS_IL) && defined(LINKER_SECTION_DATA_INTERLEAVED_START_ADDRESS)
+    {"interleaved", il_a, il_b, il_c},
+#endif
+};
+
+#define NUM_PLACEMENTS (sizeof(placements) / sizeof(placements[0]))
+
+enum
+{
+    COPY,
+    SCALE,
+    ADD,
+    TRIAD,
+    DMA_COPY,
+    DMA_TRIAD,
+    NUM_KERNELS,
+};
+
+static const char *const kernel_names[NUM_KERNELS] = {
+    "copy", "scale", "add", "triad", "dma copy", "dma + triad",
+};
+
+// Bytes read and written by each kernel
+static const uint32_t kernel_bytes[NUM_KERNELS] = {
+    2 * ARRAY_BYTES, 2 * ARRAY_BYTES, 3 * ARRAY_BYTES, 3 * ARRAY_BYTES,
+    2 * ARRAY_BYTES, 5 * ARRAY_BYTES,
+};
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline uint32_t cycles_stop(void)
+{
+    uint32_t cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+static KERNEL void stream_copy(uint32_t *c, const uint32_t *a)
+{
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        c[i] = a[i];
+    }
+}
+
+static KERNEL void stream_scale(uint32_t *b, const uint32_t *c)
+{
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        b[i] = SCALAR * c[i];
+    }
+}
+
+static KERNEL void stream_add(uint32_t *c, const uint32_t *a, const uint32_t *b)
+{
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        c[i] = a[i] + b[i];
+    }
+}
+
+static KERNEL void stream_triad(uint32_t *a, const uint32_t *b, const uint32_t *c)
+{
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        a[i] = b[i] + SCALAR * c[i];
+    }
+}
+
+static void init(const placement_t *p)
+{
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        p->a[i] = i;
+        p->b[i] = 2;
+        p->c[i] = 0;
+    }
+}
+
+// After copy, scale, add and triad from init(): c = a + 3a, a = 3a + 3c
+static uint32_t check(const placement_t *p)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        uint32_t b = SCALAR * i;
+        uint32_t c = i + b;
+        errors += p->a[i] != b + SCALAR * c;
+        errors += p->b[i] != b;
+        errors += p->c[i] != c;
+    }
+    return errors;
+}
+
+// Bytes per cycle with two decimals
+static void print_bandwidth(const char *kernel, uint32_t bytes, uint32_t cycles)
+{
+    uint32_t centi = cycles ? (uint32_t)(((uint64_t)bytes * 100 + cycles / 2) / cycles) : 0;
+
+    PRINTF("  %-12s %6u cycles %3u.%02u B/cycle\n\r", kernel, cycles, centi / 100, centi % 100);
+}
+
+static uint32_t run(const placement_t *p)
+{
+    uint32_t best[NUM_KERNELS];
+    uint32_t errors = 0;
+
+    for (uint32_t k = 0; k < NUM_KERNELS; k++)
+    {
+        best[k] = UINT32_MAX;
+    }
+
+    for (uint32_t rep = 0; rep < STREAM_REPS; rep++)
+    {
+        uint32_t cycles[NUM_KERNELS];
+        dma_sdk_ticket_t ticket;
+
+        init(p);
+
+        cycles_start();
+        stream_copy(p->c, p->a);
+        cycles[COPY] = cycles_stop();
+
+        cycles_start();
+        stream_scale(p->b, p->c);
+        cycles[SCALE] = cycles_stop();
+
+        cycles_start();
+        stream_add(p->c, p->a, p->b);
+        cycles[ADD] = cycles_stop();
+
+        cycles_start();
+        stream_triad(p->a, p->b, p->c);
+        cycles[TRIAD] = cycles_stop();
+
+        errors += check(p);
+
+        // The DMA copies a to c, then another array while the core runs triad
+        cycles_start();
+        dma_copy_32b(p->c, p->a, STREAM_WORDS);
+        cycles[DMA_COPY] = cycles_stop();
+        for (uint32_t i = 0; i < STREAM_WORDS; i++)
+        {
+            errors += p->c[i] != p->a[i];
+        }
+
+        init(p);
+        stream_copy(p->c, p->a);
+        stream_scale(p->b, p->c);
+        stream_add(p->c, p->a, p->b);
+        cycles_start();
+        ticket = dma_copy_32b_async(dma_dst, dma_src, STREAM_WORDS, NULL, NULL);
+        stream_triad(p->a, p->b, p->c);
+        dma_sdk_wait(ticket);
+        cycles[DMA_TRIAD] = cycles_stop();
+
+        errors += check(p);
+        for (uint32_t i = 0; i < STREAM_WORDS; i++)
+        {
+            errors += dma_dst[i] != dma_src[i];
+            dma_dst[i] = 0;
+        }
+
+        for (uint32_t k = 0; k < NUM_KERNELS; k++)
+        {
+            if (cycles[k] < best[k])
+            {
+                best[k] = cycles[k];
+            }
+        }
+    }
+
+    PRINTF("%s, banks 0x%x\n\r", p->name,
+           ram_banks_of(p->a, ARRAY_BYTES) | ram_banks_of(p->b, ARRAY_BYTES) | ram_banks_of(p->c, ARRAY_BYTES));
+    for (uint32_t k = 0; k < NUM_KERNELS; k++)
+    {
+        print_bandwidth(kernel_names[k], kernel_bytes[k], best[k]);
+    }
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    for (uint32_t i = 0; i < STREAM_WORDS; i++)
+    {
+        dma_src[i] = ~i;
+    }
+
+    PRINTF("STREAM, %u words per array, best of %u runs, concurrent DMA copy in banks 0x%x\n\r",
+           STREAM_WORDS, STREAM_REPS, ram_banks_of(dma_src, sizeof(dma_src)) | ram_banks_of(dma_dst, sizeof(dma_dst)));
+
+    for (uint32_t i = 0; i < NUM_PLACEMENTS; i++)
+    {
+        errors += run(&placements[i]);
+    }
+
+    PRINTF("program finished with %d errors\n\r", errors);
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
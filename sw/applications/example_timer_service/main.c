@@ -0,0 +1,156 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Hundreds of software timers over the comparator of the machine
+ *        timer interrupt, with timer_service.h. One-shot timeouts spread over
+ *        a wide range, a few of them cancelled, and periodic timers run while
+ *        the core sleeps. Each callback checks that it is not called before
+ *        its deadline nor later than a slot and the interrupt latency after
+ *        it, and the wake-ups are counted against the callbacks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "handler.h"
+#include "rv_timer.h"
+#include "timer_service.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define N_TIMEOUTS  200
+#define N_PERIODIC  4
+#define RUNS        5
+// Ticks of a slot: 2^COALESCE cycles, the counter ticks every cycle
+#define COALESCE    6
+// Delay allowed after a deadline, for the slot and the interrupt latency
+#define LATENESS    ((1 << COALESCE) + 2000)
+
+typedef struct {
+    timer_service_timer_t timer;
+    uint64_t deadline;
+    uint64_t period;
+    uint32_t runs;
+    uint32_t late;
+} timeout_t;
+
+static rv_timer_t timer_0_1;
+static timeout_t timeouts[N_TIMEOUTS + N_PERIODIC];
+static volatile uint32_t remaining;
+
+#ifndef TIMER_SERVICE
+// Without TIMER_SERVICE=1 the application forwards the interrupt
+void handler_irq_timer(void)
+{
+    timer_service_irq();
+}
+#endif
+
+static void expired(timer_service_timer_t *timer, void *arg)
+{
+    timeout_t *t = (timeout_t *)arg;
+    uint64_t now = timer_service_now();
+
+    if (now < t->deadline || now > t->deadline + LATENESS)
+    {
+        t->late++;
+    }
+    t->runs++;
+    if (t->period != 0)
+    {
+        t->deadline += t->period;
+        if (t->runs == RUNS)
+        {
+            timer_service_cancel(timer);
+        }
+        else
+        {
+            return;
+        }
+    }
+    remaining--;
+}
+
+int main(int argc, char *argv[])
+{
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_set_tick_params(&timer_0_1, 0, (rv_timer_tick_params_t){.prescale = 0, .tick_step = 1});
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    timer_service_init(&timer_0_1, COALESCE);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    // Timeouts from twenty thousand cycles to a few hundred thousand, some
+    // of them in the same slot; one in ten is cancelled right away
+    uint32_t cancelled = N_TIMEOUTS / 10;
+    uint64_t now = timer_service_now();
+    remaining = N_TIMEOUTS - cancelled + N_PERIODIC;
+    for (uint32_t i = 0; i < N_TIMEOUTS; i++)
+    {
+        uint64_t delay = 20000 + (i * 7919u) % 200000;
+        timeouts[i].deadline = now + delay;
+        timer_service_timer_init(&timeouts[i].timer, expired, &timeouts[i]);
+        timer_service_start_at(&timeouts[i].timer, timeouts[i].deadline, 0);
+        if (i % 10 == 0)
+        {
+            timer_service_cancel(&timeouts[i].timer);
+        }
+    }
+    for (uint32_t i = N_TIMEOUTS; i < N_TIMEOUTS + N_PERIODIC; i++)
+    {
+        timeouts[i].period = 30000 + (i - N_TIMEOUTS) * 1000;
+        timeouts[i].deadline = now + timeouts[i].period;
+        timer_service_timer_init(&timeouts[i].timer, expired, &timeouts[i]);
+        timer_service_start_at(&timeouts[i].timer, timeouts[i].deadline, timeouts[i].period);
+    }
+
+    while (remaining != 0)
+    {
+        asm volatile("wfi");
+    }
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+
+    uint32_t errors = 0;
+    for (uint32_t i = 0; i < N_TIMEOUTS + N_PERIODIC; i++)
+    {
+        uint32_t runs = i >= N_TIMEOUTS ? RUNS : i % 10 == 0 ? 0 : 1;
+        if (timeouts[i].runs != runs || timeouts[i].late != 0)
+        {
+            PRINTF("timer %u: %u runs, %u late\n\r", i, timeouts[i].runs, timeouts[i].late);
+            errors++;
+        }
+    }
+    if (timer_service_next() != UINT64_MAX)
+    {
+        PRINTF("comparator still armed\n\r");
+        errors++;
+    }
+
+    timer_service_stats_t stats = timer_service_stats();
+    PRINTF("%u callbacks in %u wake-ups (%u coalesced), %u cascaded, %u cancelled\n\r",
+           stats.expired, stats.wakeups, stats.coalesced, stats.cascaded, cancelled);
+
+    if (errors != 0)
+    {
+        PRINTF("%u errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Example application of the buffered UART TX mode. The same message,
+ *        longer than the TX FIFO, is written once blocking and once through
+ *        the ring buffer, drained by the TX watermark interrupt with the
+ *        interrupts enabled. The buffered write must return well before the
+ *        blocking one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "uart.h"
+#include "soc_ctrl.h"
+#include "rv_plic.h"
+
+#define RING_SIZE 512
+#define MESSAGES  4
+
+static uint8_t ring[RING_SIZE];
+
+static const char message[] =
+    "example_uart_buffered: this line is longer than the 32-byte TX FIFO\n";
+
+int main(int argc, char *argv[])
+{
+    unsigned int cycles_blocking, cycles_buffered;
+
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+    uart_t uart;
+    uart.base_addr   = mmio_region_from_addr((uintptr_t)UART_START_ADDRESS);
+    uart.baudrate    = UART_BAUDRATE;
+    uart.clk_freq_hz = soc_ctrl_get_frequency(&soc_ctrl);
+
+    if (uart_init(&uart) != kErrorOk || plic_Init() != kPlicOk)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // The blocking write sleeps on the TX empty interrupt once the FIFO is full
+    CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    uart_write(&uart, (const uint8_t *)message, strlen(message));
+    CSR_READ(CSR_REG_MCYCLE, &cycles_blocking);
+
+    if (uart_tx_buffered_enable(&uart, ring, RING_SIZE) != kErrorOk)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // The ring holds all the messages, the writes only copy them
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+    for (int i = 0; i < MESSAGES; i++)
+    {
+        uart_write(&uart, (const uint8_t *)message, strlen(message));
+    }
+    CSR_READ(CSR_REG_MCYCLE, &cycles_buffered);
+
+    // printf initializes the UART again, which leaves the buffered mode
+    uart_tx_flush(&uart);
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+
+    printf("%u cycles blocking, %u cycles buffered for %d messages\n",
+           cycles_blocking, cycles_buffered, MESSAGES);
+    return cycles_buffered < cycles_blocking ? EXIT_SUCCESS : EXIT_FAILURE;
+}
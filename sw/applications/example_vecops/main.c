@@ -0,0 +1,211 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Benchmark of vecops.h with two placements of the operands: packed in
+ *        the same bank as plain static arrays, and allocated by vec_alloc()
+ *        from the interleaved banks (or across the contiguous banks without
+ *        them). Each operation is timed with both, then y = M^T x is computed
+ *        column by column, the DMA gathering the next column of M while the
+ *        core takes the dot product of the current one, where the core and
+ *        the DMA compete for the banks. A core-only version with strided
+ *        loads is the reference of the results.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "core_v_mini_mcu.h"
+#include "ram_bank.h"
+#include "vecops.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+// Length of the vectors of the operations
+#define N       512
+// M is ROWS x COLS, row-major
+#define ROWS    128
+#define COLS    32
+
+// a, b, c, the two column buffers and x
+#define ARENA_BYTES ((3 * N + 2 * ROWS + ROWS + 64) * sizeof(int32_t))
+
+typedef struct
+{
+    int32_t *a, *b, *c;
+    int32_t *col[2];
+    int32_t *x;
+} operands_t;
+
+static int32_t packed_a[N], packed_b[N], packed_c[N];
+static int32_t packed_col[2][ROWS];
+static int32_t packed_x[ROWS];
+static uint8_t __attribute__((aligned(4))) RAM_INTERLEAVED arena_mem[ARENA_BYTES];
+
+static int32_t mat[ROWS * COLS];
+static int32_t y_ref[COLS], y[COLS];
+static uint8_t mask[N];
+static vec_gather_t gather;
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+// y = M^T x, the next column gathered by the DMA during the dot product of
+// the current one
+static void mtx_pipelined(const operands_t *op, int32_t *out)
+{
+    vec_gather_start(&gather, op->col[0], mat, COLS, ROWS);
+    for (uint32_t j = 0; j < COLS; j++)
+    {
+        vec_gather_wait(&gather);
+        if (j + 1 < COLS)
+        {
+            vec_gather_start(&gather, op->col[(j + 1) & 1], mat + j + 1, COLS, ROWS);
+        }
+        out[j] = vec_dot(op->col[j & 1], op->x, ROWS);
+    }
+}
+
+static void __attribute__((noinline)) mtx_strided(const int32_t *x, int32_t *out)
+{
+    for (uint32_t j = 0; j < COLS; j++)
+    {
+        int32_t acc = 0;
+        for (uint32_t i = 0; i < ROWS; i++)
+        {
+            acc += mat[i * COLS + j] * x[i];
+        }
+        out[j] = acc;
+    }
+}
+
+// Times the operations and the pipelined M^T x on a placement, returns the errors
+static uint32_t bench(const char *name, const operands_t *op)
+{
+    unsigned int c_add, c_mul, c_mac, c_dot, c_scale, c_cmp, c_mtx;
+    volatile int32_t dot;
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < N; i++)
+    {
+        op->a[i] = (int32_t)(i * 7) - 1000;
+        op->b[i] = (int32_t)(i * 13) % 511 - 255;
+    }
+    if (op->x != packed_x)
+    {
+        memcpy(op->x, packed_x, sizeof(packed_x));
+    }
+
+    cycles_start();
+    vec_add(op->c, op->a, op->b, N);
+    c_add = cycles_stop();
+    errors += op->c[N - 1] != op->a[N - 1] + op->b[N - 1];
+
+    cycles_start();
+    vec_mul(op->c, op->a, op->b, N);
+    c_mul = cycles_stop();
+    errors += op->c[N - 1] != op->a[N - 1] * op->b[N - 1];
+
+    cycles_start();
+    vec_mac(op->c, op->a, op->b, N);
+    c_mac = cycles_stop();
+    errors += op->c[N - 1] != 2 * op->a[N - 1] * op->b[N - 1];
+
+    cycles_start();
+    dot = vec_dot(op->a, op->b, N);
+    c_dot = cycles_stop();
+    (void)dot;
+
+    cycles_start();
+    vec_scale(op->c, op->a, 3 << 8, 8, N);
+    c_scale = cycles_stop();
+    errors += op->c[N - 1] != op->a[N - 1] * 3;
+
+    cycles_start();
+    vec_cmp(mask, op->a, op->b, N, VEC_CMP_GT);
+    c_cmp = cycles_stop();
+
+    cycles_start();
+    mtx_pipelined(op, y);
+    c_mtx = cycles_stop();
+    errors += memcmp(y, y_ref, sizeof(y)) != 0;
+
+    PRINTF("%-8s banks a %d b %d c %d col %d %d x %d\n\r", name, ram_bank_of(op->a), ram_bank_of(op->b),
+           ram_bank_of(op->c), ram_bank_of(op->col[0]), ram_bank_of(op->col[1]), ram_bank_of(op->x));
+    PRINTF("%-8s add %u mul %u mac %u dot %u scale %u cmp %u M^T x %u\n\r", name, c_add, c_mul, c_mac, c_dot,
+           c_scale, c_cmp, c_mtx);
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int c_strided;
+    uint32_t errors = 0;
+    vec_arena_t arena;
+
+    for (uint32_t i = 0; i < ROWS * COLS; i++)
+    {
+        mat[i] = (int32_t)(i * 37 % 201) - 100;
+    }
+    for (uint32_t i = 0; i < ROWS; i++)
+    {
+        packed_x[i] = (int32_t)(i % 17) - 8;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    cycles_start();
+    mtx_strided(packed_x, y_ref);
+    c_strided = cycles_stop();
+    PRINTF("M^T x with strided loads %u\n\r", c_strided);
+
+    operands_t packed = {packed_a, packed_b, packed_c, {packed_col[0], packed_col[1]}, packed_x};
+    errors += bench("packed", &packed);
+
+    // The operands of one operation in different banks
+    operands_t striped;
+    vec_arena_init(&arena, arena_mem, sizeof(arena_mem));
+    striped.col[0] = vec_alloc(&arena, ROWS);
+    striped.x = vec_alloc(&arena, ROWS);
+    striped.col[1] = vec_alloc(&arena, ROWS);
+    striped.a = vec_alloc(&arena, N);
+    striped.b = vec_alloc(&arena, N);
+    striped.c = vec_alloc(&arena, N);
+    if (striped.c == NULL)
+    {
+        PRINTF("arena full\n\r");
+        return EXIT_FAILURE;
+    }
+    errors += bench("striped", &striped);
+
+    if (errors != 0)
+    {
+        PRINTF("%u errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
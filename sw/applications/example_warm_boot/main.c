@@ -0,0 +1,127 @@
+// Copyright EPFL contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Info: Warm boot after a power-gate of the core. The core is switched off
+//       with power_gate_core_warm(), without saving its context, until the
+//       AO rv_timer wakes it up; crt0 then finds the record of
+//       warm_boot_register() and calls the resume handler without
+//       initializing the RAM again, so the .data and .bss values written
+//       before the sleep are still there.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_timer.h"
+#include "power_manager.h"
+#include "warm_boot.h"
+#include "x-heep.h"
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define N_ROUNDS      4
+// Cycles between the start of a power-gate and its wakeup interrupt
+#define SLEEP_CYCLES  2000
+#define MARKER        0xcafe0000
+
+static rv_timer_t timer_0_1;
+static power_manager_t power_manager;
+static power_manager_counters_t cpu_counters;
+
+// Initialized by a cold boot only
+static uint32_t rounds = 1;
+static uint32_t marker;
+static uint64_t sleep_start;
+
+static uint64_t now(void)
+{
+    uint64_t t;
+    rv_timer_counter_read(&timer_0_1, 0, &t);
+    return t;
+}
+
+static void disarm(void)
+{
+    rv_timer_arm(&timer_0_1, 0, 0, UINT64_MAX);
+    rv_timer_irq_clear(&timer_0_1, 0, 0);
+}
+
+static int resume(void *arg);
+
+// Does not return, the core goes through the warm boot
+static int sleep(void)
+{
+    warm_boot_register(resume, &marker);
+    sleep_start = now();
+    rv_timer_arm(&timer_0_1, 0, 0, sleep_start + SLEEP_CYCLES);
+    power_gate_core_warm(kTimer_0_pm_e);
+
+    warm_boot_cancel();
+    PRINTF("Error: the core was not switched off\n\r");
+    return EXIT_FAILURE;
+}
+
+static int resume(void *arg)
+{
+    uint32_t *m = arg;
+
+    PRINTF("warm boot %d: %d cycles after the wakeup\n\r", warm_boot_count(),
+           (uint32_t)(now() - sleep_start - SLEEP_CYCLES));
+    disarm();
+
+    // The values of the previous round were retained
+    if (*m != (MARKER | rounds) || warm_boot_count() != rounds) {
+        PRINTF("Error: the RAM was initialized again\n\r");
+        return EXIT_FAILURE;
+    }
+    if (rounds == N_ROUNDS) {
+        PRINTF("Success.\n\r");
+        return EXIT_SUCCESS;
+    }
+
+    rounds++;
+    *m = MARKER | rounds;
+    return sleep();
+}
+
+int main(int argc, char *argv[])
+{
+    power_manager.base_addr = mmio_region_from_addr(POWER_MANAGER_START_ADDRESS);
+
+    if (warm_boot_is_warm()) {
+        PRINTF("Error: cold boot expected\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // Same sequences as example_power_gating_core
+    if (power_gate_counters_init(&cpu_counters, 15, 30, 20, 10, 10, 35, 0, 0) != kPowerManagerOk_e ||
+        power_gate_core_fast_init(&power_manager, &cpu_counters) != kPowerManagerOk_e)
+    {
+        PRINTF("Error: power manager fail.\n\r");
+        return EXIT_FAILURE;
+    }
+
+    // The counter ticks every cycle
+    rv_timer_init(mmio_region_from_addr(RV_TIMER_AO_START_ADDRESS),
+                  (rv_timer_config_t){.hart_count = 2, .comparator_count = 1}, &timer_0_1);
+    rv_timer_set_tick_params(&timer_0_1, 0, (rv_timer_tick_params_t){.prescale = 0, .tick_step = 1});
+    disarm();
+    rv_timer_irq_enable(&timer_0_1, 0, 0, kRvTimerEnabled);
+    rv_timer_counter_set_enabled(&timer_0_1, 0, kRvTimerEnabled);
+
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+
+    marker = MARKER | rounds;
+    return sleep();
+}
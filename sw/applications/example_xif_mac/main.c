@@ -0,0 +1,174 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Example of the SIMD/MAC coprocessor of hw/ip_examples/xif_mac on the
+ *        eXtension Interface. Each instruction of xif_mac.h is checked against
+ *        a reference loop, then an int8 dot product is timed with the
+ *        coprocessor and with the CPU alone. Run it with:
+ *          make mcu-gen CPU=cv32e40px   (xif_coprocessor: xif_mac in mcu_cfg.hjson)
+ *          make verilator-sim FUSESOC_PARAM="--X_EXT=1"
+ *          make app PROJECT=example_xif_mac
+ *        With another configuration the C versions of the intrinsics run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "xif_mac.h"
+
+#define DOT_LEN 256
+
+/* By default, printfs are activated for FPGA and disabled for simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   0
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+static int8_t __attribute__((aligned(4))) va[DOT_LEN];
+static int8_t __attribute__((aligned(4))) vb[DOT_LEN];
+
+static const uint32_t operands[] = {
+    0x00000000, 0xFFFFFFFF, 0x7F80017F, 0x80808080, 0x12345678, 0xDEADBEEF, 0x01FF7F81, 0x7FFF8000,
+};
+
+#define NUM_OPERANDS (sizeof(operands) / sizeof(operands[0]))
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+/* Reference of the lane operations, lane i of the words a and b */
+static uint32_t ref_lanes(uint32_t a, uint32_t b, int bytes, int op)
+{
+    uint32_t r = 0;
+    int lanes = bytes ? 4 : 2, width = bytes ? 8 : 16;
+    uint32_t mask = bytes ? 0xFF : 0xFFFF;
+
+    for (int i = 0; i < lanes; i++)
+    {
+        int32_t x = (int32_t)((a >> (width * i)) & mask);
+        int32_t y = (int32_t)((b >> (width * i)) & mask);
+        x = bytes ? (int8_t)x : (int16_t)x;
+        y = bytes ? (int8_t)y : (int16_t)y;
+        int32_t z = op == 0 ? x + y : op == 1 ? x - y : op == 2 ? (x > y ? x : y) : (x < y ? x : y);
+        r |= ((uint32_t)z & mask) << (width * i);
+    }
+    return r;
+}
+
+static int32_t ref_dot(uint32_t a, uint32_t b, int bytes, int is_signed)
+{
+    int32_t r = 0;
+    int lanes = bytes ? 4 : 2, width = bytes ? 8 : 16;
+    uint32_t mask = bytes ? 0xFF : 0xFFFF;
+
+    for (int i = 0; i < lanes; i++)
+    {
+        int32_t x = (int32_t)((a >> (width * i)) & mask);
+        int32_t y = (int32_t)((b >> (width * i)) & mask);
+        if (is_signed)
+        {
+            x = bytes ? (int8_t)x : (int16_t)x;
+            y = bytes ? (int8_t)y : (int16_t)y;
+        }
+        r = (int32_t)((uint32_t)r + (uint32_t)(x * y));
+    }
+    return r;
+}
+
+static int check(const char *name, uint32_t got, uint32_t expected, uint32_t a, uint32_t b)
+{
+    if (got != expected)
+    {
+        PRINTF("%s(0x%08x, 0x%08x) = 0x%08x instead of 0x%08x\n\r", name, a, b, got, expected);
+        return 1;
+    }
+    return 0;
+}
+
+static int32_t dot_s8_cpu(const int8_t *a, const int8_t *b, uint32_t n)
+{
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int cycles_xif, cycles_cpu;
+    int32_t dot_xif, dot_cpu;
+    int errors = 0;
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("Intrinsics of xif_mac.h with the %s\n\r", XIF_MAC_HW ? "coprocessor" : "C versions");
+
+    for (uint32_t i = 0; i < NUM_OPERANDS; i++)
+    {
+        for (uint32_t j = 0; j < NUM_OPERANDS; j++)
+        {
+            uint32_t a = operands[i], b = operands[j], c = operands[(i + j) % NUM_OPERANDS];
+
+            errors += check("add4b", xmac_add4b(a, b), ref_lanes(a, b, 1, 0), a, b);
+            errors += check("sub4b", xmac_sub4b(a, b), ref_lanes(a, b, 1, 1), a, b);
+            errors += check("add2h", xmac_add2h(a, b), ref_lanes(a, b, 0, 0), a, b);
+            errors += check("sub2h", xmac_sub2h(a, b), ref_lanes(a, b, 0, 1), a, b);
+            errors += check("max4b", xmac_max4b(a, b), ref_lanes(a, b, 1, 2), a, b);
+            errors += check("min4b", xmac_min4b(a, b), ref_lanes(a, b, 1, 3), a, b);
+            errors += check("dot4b", xmac_dot4b(a, b), ref_dot(a, b, 1, 1), a, b);
+            errors += check("dotu4b", xmac_dotu4b(a, b), ref_dot(a, b, 1, 0), a, b);
+            errors += check("dot2h", xmac_dot2h(a, b), ref_dot(a, b, 0, 1), a, b);
+            errors += check("mac4b", xmac_mac4b(c, a, b), c + (uint32_t)ref_dot(a, b, 1, 1), a, b);
+            errors += check("macu4b", xmac_macu4b(c, a, b), c + (uint32_t)ref_dot(a, b, 1, 0), a, b);
+            errors += check("mac2h", xmac_mac2h(c, a, b), c + (uint32_t)ref_dot(a, b, 0, 1), a, b);
+            errors += check("mac", xmac_mac(c, a, b), c + a * b, a, b);
+        }
+    }
+
+    for (uint32_t i = 0; i < DOT_LEN; i++)
+    {
+        va[i] = (int8_t)(i * 37 + 11);
+        vb[i] = (int8_t)(i * 91 - 5);
+    }
+
+    cycles_start();
+    dot_xif = xif_mac_dot_s8(va, vb, DOT_LEN);
+    cycles_xif = cycles_stop();
+
+    cycles_start();
+    dot_cpu = dot_s8_cpu(va, vb, DOT_LEN);
+    cycles_cpu = cycles_stop();
+
+    errors += check("dot_s8", dot_xif, dot_cpu, DOT_LEN, 0);
+    PRINTF("int8 dot product of %u: %u cycles with xif_mac.h, %u with the CPU\n\r", DOT_LEN, cycles_xif, cycles_cpu);
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
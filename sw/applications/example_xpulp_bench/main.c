@@ -0,0 +1,152 @@
+/*
+ *  Copyright EPFL contributors.
+ *  Licensed under the Apache License, Version 2.0, see LICENSE for details.
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Info: Cycles of the hot paths of the libraries that XPULP_LIB builds with
+ *        the CORE-V extensions: the word copies of fast_memory.c, memrchr of
+ *        memory.c, the bitfield functions, the formatting of tiny_printf.c
+ *        and the FIFO loops of the SPI SDK, reading the flash. Built once
+ *        with XPULP_LIB=0 and once with the CORE-V compiler, the two runs
+ *        are compared by util/xpulp_bench.py. The results are checked.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "csr.h"
+#include "x-heep.h"
+#include "bitfield.h"
+#include "fast_memory.h"
+#include "memory.h"
+#include "spi_sdk.h"
+#include "tiny_printf.h"
+
+/* The cycles are the output of the application, also in simulation. */
+#define PRINTF_IN_FPGA  1
+#define PRINTF_IN_SIM   1
+
+#if TARGET_SIM && PRINTF_IN_SIM
+        #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#elif PRINTF_IN_FPGA && !TARGET_SIM
+    #define PRINTF(fmt, ...)    printf(fmt, ## __VA_ARGS__)
+#else
+    #define PRINTF(...)
+#endif
+
+#define LEN         1024
+#define BIT_WORDS   256
+#define FORMATS     32
+#define FLASH_READ  0x03
+#define FLASH_FREQ  (133*1000*1000)
+
+static uint32_t src[LEN / 4];
+static uint32_t dst[LEN / 4];
+static char text[64];
+
+// Through pointers, so that the functions of bitfield.c are called rather
+// than their inline copies of bitfield.h
+static int32_t (*volatile popcount)(uint32_t) = bitfield_popcount32;
+static int32_t (*volatile ctz)(uint32_t) = bitfield_count_trailing_zeroes32;
+static uint32_t (*volatile byteswap)(uint32_t) = bitfield_byteswap32;
+
+static inline void cycles_start(void)
+{
+    CSR_WRITE(CSR_REG_MCYCLE, 0);
+}
+
+static inline unsigned int cycles_stop(void)
+{
+    unsigned int cycles;
+    CSR_READ(CSR_REG_MCYCLE, &cycles);
+    return cycles;
+}
+
+static int flash_read(spi_t *spi, uint32_t addr, uint32_t *data, uint32_t len)
+{
+    spi_segment_t segments[2] = { SPI_SEG_TX(4), SPI_SEG_RX(len) };
+    uint32_t cmd = bitfield_byteswap32(addr & 0x00ffffff) | FLASH_READ;
+    return spi_execute(spi, segments, 2, &cmd, data) == SPI_CODE_OK ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int cycles;
+    int errors = 0;
+
+    for (uint32_t i = 0; i < LEN / 4; i++)
+    {
+        src[i] = i * 2654435761u;
+    }
+
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+
+    PRINTF("path               cycles\n\r");
+
+    // Word loops only
+    fast_mem_set_thresholds(16, SIZE_MAX);
+    cycles_start();
+    fast_memcpy(dst, src, LEN);
+    cycles = cycles_stop();
+    errors += memcmp(dst, src, LEN) != 0;
+    PRINTF("fast_memcpy  %12u\n\r", cycles);
+
+    cycles_start();
+    fast_memset(dst, 0x5A, LEN);
+    cycles = cycles_stop();
+    errors += ((uint8_t *)dst)[LEN - 1] != 0x5A;
+    PRINTF("fast_memset  %12u\n\r", cycles);
+
+    // Found in the first byte of the buffer, after a scan of all the others
+    ((uint8_t *)dst)[0] = 0xA5;
+    cycles_start();
+    void *found = memrchr(dst, 0xA5, LEN);
+    cycles = cycles_stop();
+    errors += found != (void *)dst;
+    PRINTF("memrchr      %12u\n\r", cycles);
+
+    int32_t bits = 0;
+    cycles_start();
+    for (uint32_t i = 0; i < BIT_WORDS; i++)
+    {
+        bits += popcount(src[i]) + ctz(src[i] | 0x80000000u) + (int32_t)(byteswap(src[i]) & 1);
+    }
+    cycles = cycles_stop();
+    errors += bits == 0;
+    PRINTF("bitfield     %12u\n\r", cycles);
+
+    int len = 0;
+    cycles_start();
+    for (uint32_t i = 0; i < FORMATS; i++)
+    {
+        len += tiny_snprintf(text, sizeof(text), "%u 0x%08x %d %s", (unsigned)i, (unsigned)src[i], -(int)i, "x-heep");
+    }
+    cycles = cycles_stop();
+    errors += len == 0;
+    PRINTF("tiny_printf  %12u\n\r", cycles);
+
+    spi_t spi = spi_init(SPI_IDX_HOST, SPI_SLAVE(0, FLASH_FREQ));
+    if (!spi.init)
+    {
+        errors++;
+    }
+    else
+    {
+        // The same data twice, the second read is timed and checked against the first
+        errors += flash_read(&spi, 0, src, LEN);
+        cycles_start();
+        errors += flash_read(&spi, 0, dst, LEN);
+        cycles = cycles_stop();
+        errors += memcmp(dst, src, LEN) != 0;
+        PRINTF("spi_read     %12u\n\r", cycles);
+    }
+
+    if (errors != 0)
+    {
+        PRINTF("%d errors\n\r", errors);
+        return EXIT_FAILURE;
+    }
+    PRINTF("success!\n\r");
+    return EXIT_SUCCESS;
+}
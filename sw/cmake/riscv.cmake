@@ -83,6 +83,12 @@ set( CMAKE_OBJCOPY      ${GCC_CROSS_COMPILE}objcopy
      CACHE FILEPATH "The toolchain objcopy command " FORCE )
 #message( "OBJCOPY PATH: ${CMAKE_OBJCOPY}" )
 
+set( CMAKE_SIZE         ${GCC_CROSS_COMPILE}size
+     CACHE FILEPATH "The toolchain size command " FORCE )
+
+set( CMAKE_NM           ${GCC_CROSS_COMPILE}nm
+     CACHE FILEPATH "The toolchain nm command " FORCE )
+
 if ($ENV{COMPILER} MATCHES "gcc")
      set( CMAKE_OBJDUMP      ${GCC_CROSS_COMPILE}objdump
           CACHE FILEPATH "The toolchain objdump command " FORCE )
@@ -37,6 +37,33 @@ build/Makefile : CMakeLists.txt ${CMAKE_DIR}/riscv.cmake
 			-DLINKER:STRING=${LINKER} \
 			-DCOMPILER:STRING=${COMPILER} \
 			-DCOMPILER_PREFIX:STRING=${COMPILER_PREFIX} \
+			-DCONSOLE:STRING=${CONSOLE} \
+			-DFAST_MEMCPY:STRING=${FAST_MEMCPY} \
+			-DMEMORY_WORD:STRING=${MEMORY_WORD} \
+			-DDMA_STATS:STRING=${DMA_STATS} \
+			-DMALLOC:STRING=${MALLOC} \
+			-DPRINTF:STRING=${PRINTF} \
+			-DPLIC_VECTORED:STRING=${PLIC_VECTORED} \
+			-DIRQ_NESTED:STRING=${IRQ_NESTED} \
+			-DPERF_TIMER:STRING=${PERF_TIMER} \
+			-DPERF_DUMP:STRING=${PERF_DUMP} \
+			-DMEM_WATERMARK:STRING=${MEM_WATERMARK} \
+			-DTIMER_SERVICE:STRING=${TIMER_SERVICE} \
+			-DFREERTOS_TRACE:STRING=${FREERTOS_TRACE} \
+			-DCLK_GATE:STRING=${CLK_GATE} \
+			-DFLASH_LOAD_DMA:STRING=${FLASH_LOAD_DMA} \
+			-DFLASH_LOAD_LZ:STRING=${FLASH_LOAD_LZ} \
+			-DCRT0_DMA:STRING=${CRT0_DMA} \
+			-DCOREMARK_OPT:STRING=${COREMARK_OPT} \
+			-DEMBENCH_BENCHMARK:STRING=${EMBENCH_BENCHMARK} \
+			-DHOT_FUNCTIONS:STRING=$(abspath ${HOT_FUNCTIONS}) \
+			-DHOT_RODATA:STRING=$(abspath ${HOT_RODATA}) \
+			-DPROFILE:STRING=${PROFILE} \
+			-DXPULP_LIB:STRING=${XPULP_LIB} \
+			-DPGO:STRING=${PGO} \
+			-DPGO_DIR:STRING=$(abspath ${PGO_DIR}) \
+			-DPGO_DUMP_SIZE:STRING=${PGO_DUMP_SIZE} \
+			-DSIZE_BASELINE:STRING=$(abspath ${SIZE_BASELINE}) \
 		    ../ 
 
 clean:
@@ -44,6 +44,9 @@
 /* To manage DMA. */
 #include "dma.h"
 
+/* To check the data with the CRC peripheral */
+#include "crc.h"
+
 /* To get TX and RX FIFO depth */
 #include "spi_host_regs.h"
 /* To get SPI functions */
@@ -55,9 +58,15 @@
 /* To get the soc_ctrl base address */
 #include "soc_ctrl_structs.h"
 
+/* To invalidate the read cache of the memory-mapped flash */
+#include "spi_memio.h"
+
 /* For word swap operations*/
 #include "bitfield.h"
 
+/* To keep the clock of the SPI host and of the CRC on while they are used */
+#include "clk_gate.h"
+
 /****************************************************************************/
 /**                                                                        **/
 /*                        DEFINITIONS AND MACROS                            */
@@ -117,10 +126,13 @@ static void flash_reset(void);
 /**
  * @brief Erase the flash and write the data.
  *
- * It read 4k (a sector) at a time, erase it and write the data back.
- * Befor writing the data back, it modifies the buffer in order to
- * add the new data without modifing the other bytes. All the bytes
- * that are not going to be modified will be copied back as is.
+ * The aligned 64kB and 32kB blocks fully covered by the data are erased
+ * with a single block erase and written directly.
+ * The other sectors (4kB) are read and compared with the data. If the data
+ * only clears bits (1->0), the sector is not erased and only the pages that
+ * change are programmed. Otherwise the data is merged into the sector, the
+ * sector is erased and the pages that are not blank are programmed back.
+ * All the bytes that are not going to be modified keep their value.
  *
  * @param addr 24-bit address to write to.
  * @param data pointer to the data buffer.
@@ -129,6 +141,62 @@ static void flash_reset(void);
 */
 static w25q_error_codes_t erase_and_write(uint32_t addr, uint8_t *data ,uint32_t length);
 
+/**
+ * @brief Read from flash at quad speed, with the DMA from RX_DMA_THRESHOLD
+ * bytes.
+ *
+ * w25q128jw_read without the sanity checks and the verification, also used
+ * to read back the sectors that are modified.
+ *
+ * @param addr 24-bit address to read from.
+ * @param data pointer to the data buffer.
+ * @param length number of bytes to read.
+ * @return FLASH_OK if the read is successful, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t read_auto(uint32_t addr, uint8_t *data, uint32_t length);
+
+/**
+ * @brief Check the flash content against data, see w25q128jw_set_verify.
+ *
+ * With the CRC peripheral, the CRC-32 of the flash (w25q128jw_crc32) is
+ * compared with the one of the data. Without it, the flash is read back
+ * sector by sector and compared with the data.
+ *
+ * @param addr 24-bit flash address of the data.
+ * @param data pointer to the data expected in flash.
+ * @param length number of bytes.
+ * @return FLASH_OK if they match, FLASH_ERROR_VERIFY if they do not,
+ * @ref error_codes otherwise.
+*/
+static w25q_error_codes_t verify(uint32_t addr, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Check if writing data over the current flash content needs an erase.
+ *
+ * NOR flash programming can only clear bits, so an erase is needed as soon
+ * as a bit goes from 0 to 1.
+ *
+ * @param old current flash content.
+ * @param data new content.
+ * @param length number of bytes to compare.
+ * @return 1 if an erase is needed, 0 otherwise.
+*/
+static uint8_t needs_erase(const uint8_t *old, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Program the pages whose content changes.
+ *
+ * The range is split on the page boundaries and only the parts that differ
+ * from the current content are programmed.
+ *
+ * @param addr 24-bit address to write to.
+ * @param data pointer to the data buffer.
+ * @param old current flash content of the range, or NULL if it is erased.
+ * @param length number of bytes to write.
+ * @return FLASH_OK if the write is successful, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t program_changed_pages(uint32_t addr, uint8_t *data, const uint8_t *old, uint32_t length);
+
 /**
  * @brief Wrapper for page write.
  *
@@ -158,7 +226,20 @@ static w25q_error_codes_t page_write_wrapper(uint32_t addr, uint8_t *data, uint3
 static w25q_error_codes_t page_write(uint32_t addr, uint8_t *data, uint32_t length, uint8_t quad, uint8_t dma);
 
 /**
- * @brief Copy length bytes from data to the SPI TX FIFO, using DMA.
+ * @brief Configure the DMA to copy length bytes from data to the SPI TX FIFO.
+ *
+ * The transaction is validated and loaded, but not launched, so that this
+ * can be done while the flash is still busy with the previous page.
+ *
+ * @param data pointer to the data buffer.
+ * @param length number of bytes to copy.
+ * @return FLASH_OK if the operation is successful, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t dma_prepare_toflash(uint8_t *data, uint32_t length);
+
+/**
+ * @brief Copy length bytes from data to the SPI TX FIFO, using the DMA
+ * transaction configured by dma_prepare_toflash.
  *
  * @param data pointer to the data buffer.
  * @param length number of bytes to copy.
@@ -167,6 +248,161 @@ static w25q_error_codes_t page_write(uint32_t addr, uint8_t *data, uint32_t leng
 */
 static w25q_error_codes_t dma_send_toflash(uint8_t *data, uint32_t length);
 
+/**
+ * @brief Send a Fast Read Quad I/O command and program DMA channel 0, through
+ * its registers, to copy the words of the SPI RX FIFO.
+ *
+ * Used by the crt0 loaders, which launch the DMA transactions chunk by chunk.
+ *
+ * @param addr 24-bit flash address to read from.
+ * @param length number of bytes to read.
+*/
+static void w25q128jw_load_quad_dma_crt0_start(uint32_t addr, uint32_t length);
+
+/**
+ * @brief Decode the sequences of a chunk of a compressed section.
+ *
+ * A sequence never crosses the end of a chunk, and the zero bytes padding
+ * the chunk are empty sequences (see w25q_lz_header_t).
+ *
+ * @param in the chunk, W25Q_LZ_CHUNK_BYTES bytes.
+ * @param out end of the data decoded from the previous chunks.
+ * @param end end of the section.
+ * @return The end of the decoded data, or NULL if it would overflow end.
+*/
+static uint8_t *w25q128jw_load_lz_crt0_chunk(const uint8_t *in, uint8_t *out, uint8_t *end);
+
+/**
+ * @brief Wait for the last page program to be committed, if any.
+ *
+ * Page programs do not wait for the flash, so that the next page can be
+ * prepared meanwhile. This is called before any other flash operation.
+*/
+static void program_complete(void);
+
+/**
+ * @brief Launch the copy of length bytes from the SPI RX FIFO to data, using DMA.
+ *
+ * Only the full words are copied, the extra bytes (if any) are read from the
+ * FIFO by w25q128jw_read_dma_wait. It does not wait for the copy to finish.
+ *
+ * @param handle read handle holding the DMA transaction.
+ * @param data pointer to the data buffer.
+ * @param length number of bytes to copy.
+ * @return FLASH_OK if the DMA is launched, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t dma_recv_fromflash(w25q128jw_read_handle_t *handle, uint8_t *data, uint32_t length);
+
+/**
+ * @brief dma_recv_fromflash of count chunks of chunk bytes, each one written
+ * stride bytes after the previous one.
+ *
+ * @param handle read handle holding the DMA transaction.
+ * @param data pointer to the first chunk.
+ * @param chunk number of bytes per chunk, a multiple of 4 if count > 1.
+ * @param count number of chunks.
+ * @param stride distance between two chunks in data, in bytes.
+ * @return FLASH_OK if the DMA is launched, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t dma_recv_fromflash_strided(w25q128jw_read_handle_t *handle, uint8_t *data,
+                                                     uint32_t chunk, uint32_t count, uint32_t stride);
+
+/**
+ * @brief DMA trigger slot of a FIFO of the SPI host of the selected flash.
+ *
+ * @param tx 1 for the TX FIFO, 0 for the RX FIFO.
+ * @return the slot, dma_trigger_slot_mask_t.
+*/
+static uint8_t spi_dma_slot(uint8_t tx);
+
+#ifdef CRC_IS_INCLUDED
+/**
+ * @brief Copy length bytes from the SPI RX FIFO to the CRC peripheral, using
+ * DMA, and wait for the copy.
+ *
+ * Only the full words are copied, the extra bytes (if any) are left in the
+ * FIFO.
+ *
+ * @param length number of bytes to copy.
+ * @return FLASH_OK if the copy is done, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t dma_recv_tocrc(uint32_t length);
+
+/**
+ * @brief w25q128jw_checksum with the CRC peripheral.
+ *
+ * Writes its registers directly, as the driver is not in the first bytes
+ * copied by the boot ROM. Its name is also the mark of the CRC-32 checksum
+ * for util/flash_lz.py, thus keep it out of line.
+*/
+static uint32_t w25q128jw_checksum_crc32(const void *data, uint32_t length, uint32_t checksum);
+#endif // CRC_IS_INCLUDED
+
+/**
+ * @brief Issue a Fast Read Quad I/O command of length bytes.
+ *
+ * The command byte is skipped if the flash is in continuous read mode,
+ * and the mode bits leave it in that mode if it is enabled.
+ *
+ * @param addr 24-bit address to read from.
+ * @param length number of bytes to read.
+*/
+static void quad_read_cmd(uint32_t addr, uint32_t length);
+
+/**
+ * @brief Take the flash out of continuous read mode and of QPI mode, if it
+ * is in them.
+ *
+ * Called before any command other than the quad reads, as in continuous
+ * read mode the flash would take the command byte as the first byte of an
+ * address, and in QPI mode it would read it on four lines.
+*/
+static void read_modes_exit(void);
+
+/**
+ * @brief Enter QPI mode and set the read parameters.
+*/
+static void qpi_enter(void);
+
+/**
+ * @brief Send the exit of QPI mode, whatever the mode of the flash.
+ *
+ * In SPI mode the flash takes it as an unknown command and ignores it.
+*/
+static void qpi_exit(void);
+
+/**
+ * @brief Send an erase command, without waiting for it to finish.
+ *
+ * @param cmd FC_SE, FC_BE32, FC_BE64 or FC_CE.
+ * @param addr 24-bit address of the sector or block, unused by FC_CE.
+*/
+static void erase_start(uint8_t cmd, uint32_t addr);
+
+/**
+ * @brief Start an erase that is polled by w25q128jw_erase_poll.
+ *
+ * @param cmd FC_SE, FC_BE32, FC_BE64 or FC_CE.
+ * @param addr 24-bit address of the sector or block, unused by FC_CE.
+ * @return FLASH_OK if the erase is started, FLASH_ERROR if the address is
+ * invalid or another erase is not finished.
+*/
+static w25q_error_codes_t erase_async(uint8_t cmd, uint32_t addr);
+
+/**
+ * @brief Terminate an asynchronous erase: invalidate the read cache of the
+ * memory-mapped flash and call the handler.
+*/
+static void erase_done(void);
+
+/**
+ * @brief Read a status register of the flash.
+ *
+ * @param cmd FC_RSR1, FC_RSR2 or FC_RSR3.
+ * @return the value of the register.
+*/
+static uint8_t flash_read_status(uint8_t cmd);
+
 /**
  * @brief Enable flash write.
  *
@@ -176,6 +412,40 @@ static w25q_error_codes_t dma_send_toflash(uint8_t *data, uint32_t length);
 */
 static void flash_write_enable(void);
 
+/**
+ * @brief Invalidate the read cache of the memory-mapped flash and the block
+ * cache.
+ *
+ * Called once the flash content has changed, so that spimemio and
+ * w25q128jw_read do not serve the old content from their cache.
+*/
+static void flash_cache_invalidate(void);
+
+/**
+ * @brief Read through the block cache, see w25q128jw_cache_enable.
+ *
+ * @param addr 24-bit flash address to read from.
+ * @param data pointer to the data buffer.
+ * @param length number of bytes to read, at most a block.
+ * @return FLASH_OK if the read is successful, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t cache_read(uint32_t addr, uint8_t *data, uint32_t length);
+
+/**
+ * @brief Start reading a block ahead into the least recently used line of
+ * the block cache, if it is not cached and no read ahead is in flight.
+ *
+ * @param addr flash address of the block.
+*/
+static void cache_prefetch(uint32_t addr);
+
+/**
+ * @brief Wait for the read ahead of the block cache in flight, if any.
+ *
+ * It holds the SPI host and the DMA, so it is called before any command.
+*/
+static void cache_prefetch_wait(void);
+
 /**
  * @brief Performs sanity checks on the input parameters.
  *
@@ -223,6 +493,85 @@ spi_host_t* __attribute__((section(".xheep_init_data_crt0"))) spi; //this variab
 */
 uint8_t sector_data[FLASH_SECTOR_SIZE];
 
+/**
+ * @brief Continuous read mode state.
+ *
+ * If continuous_read_en is set, the quad reads leave the flash in continuous
+ * read mode (M7-M0 = A0h), and continuous_read_on tells that the next one
+ * can skip the command byte. They are also used by the crt0 through
+ * w25q128jw_read_standard, thus keep them in this section.
+*/
+static uint8_t __attribute__((section(".xheep_init_data_crt0"))) continuous_read_en = 0;
+static uint8_t __attribute__((section(".xheep_init_data_crt0"))) continuous_read_on = 0;
+
+/**
+ * @brief QPI mode state.
+ *
+ * If qpi_en is set, the quad reads put the flash in QPI mode, and qpi_on
+ * tells that it is in it. burst_wrap is the length set by
+ * w25q128jw_set_burst_wrap, also set in QPI mode by Set Read Parameters.
+*/
+static uint8_t __attribute__((section(".xheep_init_data_crt0"))) qpi_en = 0;
+static uint8_t __attribute__((section(".xheep_init_data_crt0"))) qpi_on = 0;
+static uint8_t burst_wrap = 0;
+
+/**
+ * @brief State of the asynchronous erase.
+ *
+ * Volatile as it is also updated by w25q128jw_erase_poll from an interrupt.
+*/
+static volatile w25q_erase_state_t erase_state = W25Q_ERASE_IDLE;
+
+/**
+ * @brief Set by w25q128jw_set_verify.
+*/
+static uint8_t verify_en = 0;
+
+/**
+ * @brief Set by w25q128jw_set_read_dma_intr.
+*/
+static uint8_t read_dma_intr = 0;
+
+/**
+ * @brief Index in clk_gate.h of the SPI host whose clock is held, from
+ * w25q128jw_init() to w25q128jw_power_down(), CLK_GATE_NO_PERIPH if none.
+*/
+static uint8_t spi_clk_idx = CLK_GATE_NO_PERIPH;
+
+/**
+ * @brief Set by w25q128jw_cache_enable, NULL if the cache is disabled.
+*/
+static w25q128jw_cache_t *block_cache = NULL;
+
+/**
+ * @brief Set while the last page program may not be committed yet.
+ *
+ * Also checked by the crt0 through w25q128jw_read_standard, thus keep it
+ * in this section.
+*/
+static uint8_t __attribute__((section(".xheep_init_data_crt0"))) program_pending = 0;
+
+/**
+ * @brief Checksum of the data loaded by w25q128jw_load_quad_dma_crt0.
+ *
+ * Written by the crt0 before .bss is cleared, thus keep it in this section.
+*/
+static uint32_t __attribute__((section(".xheep_init_data_crt0"))) boot_checksum = 0;
+
+/**
+ * @brief Chip select and DMA channel of the selected flash, set by
+ * w25q128jw_select.
+*/
+static uint8_t flash_csid = 0;
+static uint8_t dma_channel = 0;
+
+/**
+ * @brief DMA transaction copying a page to the SPI TX FIFO.
+*/
+static dma_target_t tgt_src_toflash;
+static dma_target_t tgt_dst_toflash;
+static dma_trans_t trans_toflash;
+
 
 /****************************************************************************/
 /**                                                                        **/
@@ -249,6 +598,14 @@ w25q_error_codes_t w25q128jw_init(spi_host_t* spi_host) {
     // Set the global spi variable to the one passed as argument.
     spi = spi_host;
 
+    // The SPI hosts other than the flash one are in the peripheral domain
+    uint8_t clk_idx = spi == spi_host1 ? SPI_HOST_IDX
+                    : spi == spi_host2 ? SPI2_IDX
+                    : CLK_GATE_NO_PERIPH;
+    clk_gate_periph_acquire(clk_idx);
+    clk_gate_periph_release(spi_clk_idx);
+    spi_clk_idx = clk_idx;
+
     #ifdef USE_SPI_FLASH
     // Select SPI host as SPI output
     soc_ctrl_select_spi_host((soc_ctrl_t*)soc_ctrl_peri);
@@ -260,11 +617,15 @@ w25q_error_codes_t w25q128jw_init(spi_host_t* spi_host) {
     // Enable SPI output
     spi_output_enable(spi, true);
 
-    // Configure SPI<->Flash connection on CSID 0
+    // Configure SPI<->Flash connection on the CSID of the flash
     configure_spi();
 
     // Set CSID
-    spi_set_csid(spi, 0);
+    spi_set_csid(spi, flash_csid);
+
+    // A reset of the MCU may have left the flash in QPI mode
+    qpi_exit();
+    qpi_on = 0;
 
     // Power up flash
     flash_power_up();
@@ -274,25 +635,24 @@ w25q_error_codes_t w25q128jw_init(spi_host_t* spi_host) {
     if (set_QE_bit() == FLASH_ERROR) return FLASH_ERROR; // Error occurred while setting QE bit
     #endif // TARGET_SIM
 
-    return FLASH_OK; // Success
+    // Select the read mode, entered at the first quad read
+    return w25q128jw_set_read_mode(W25Q_READ_MODE_INIT);
 }
 
 w25q_error_codes_t w25q128jw_read(uint32_t addr, void *data, uint32_t length) {
     // Sanity checks
     if (w25q128jw_sanity_checks(addr, data, length) != FLASH_OK) return FLASH_ERROR;
 
-    // Define the status variable
     w25q_error_codes_t status;
-
-    if (length < RX_DMA_THRESHOLD) {
-        status = w25q128jw_read_quad(addr, data, length);
-        if (status != FLASH_OK) return status;
+    if (block_cache != NULL && length <= block_cache->block_size) {
+        status = cache_read(addr, data, length);
     } else {
-        // Wait DMA to be free
-        while(!dma_is_ready());
-        status = w25q128jw_read_quad_dma(addr, data, length);
-        if (status != FLASH_OK) return status;
+        status = read_auto(addr, data, length);
     }
+    if (status != FLASH_OK) return status;
+
+    // Read the flash again to check what was received
+    if (verify_en) return verify(addr, data, length);
 
     return FLASH_OK;
 }
@@ -308,10 +668,13 @@ w25q_error_codes_t w25q128jw_write(uint32_t addr, void *data, uint32_t length, u
         status = erase_and_write(addr, data, length);
     } else {
         // Wait DMA to be free
-        while(!dma_is_ready());
+        while(!dma_is_ready(dma_channel));
         status = w25q128jw_write_quad_dma(addr, data, length);
     }
 
+    // Read the flash back to check what was programmed
+    if (status == FLASH_OK && verify_en) status = verify(addr, data, length);
+
     return status;
 }
 
@@ -319,6 +682,12 @@ w25q_error_codes_t w25q128jw_read_standard(uint32_t addr, void* data, uint32_t l
     // Sanity checks
     if (w25q128jw_sanity_checks(addr, data, length) != FLASH_OK) return FLASH_ERROR;
 
+    // The read command is not accepted in continuous read mode
+    read_modes_exit();
+
+    // The flash does not accept reads while programming
+    program_complete();
+
     // Address + Read command
     uint32_t read_byte_cmd = ((REVERT_24b_ADDR(addr & 0x00ffffff) << 8) | FC_RD);
     // Load command to TX FIFO
@@ -389,6 +758,167 @@ w25q_error_codes_t w25q128jw_read_standard(uint32_t addr, void* data, uint32_t l
     return FLASH_OK; // Success
 }
 
+w25q_error_codes_t w25q128jw_load_quad_dma_crt0(uint32_t addr, void *data, uint32_t length) {
+    // The DMA copies whole words, to aligned buffers
+    if (((uintptr_t)data & 0x3) || length == 0) return FLASH_ERROR;
+
+    w25q128jw_load_quad_dma_crt0_start(addr, length);
+
+    volatile uint32_t *dma_regs = (volatile uint32_t *)DMA_START_ADDRESS;
+    uint32_t *data_32bit = (uint32_t *)data;
+    uint32_t words = length >> 2;
+    uint32_t *prev = data_32bit;
+    uint32_t prev_words = 0;
+    while (words > 0 || prev_words > 0) {
+        uint32_t n = words < W25Q_LOAD_CHUNK_WORDS ? words : W25Q_LOAD_CHUNK_WORDS;
+        if (n > 0) {
+            dma_regs[DMA_DST_PTR_REG_OFFSET >> 2] = (uintptr_t)data_32bit;
+            dma_regs[DMA_SIZE_D1_REG_OFFSET >> 2] = n << 2; // Launches the transaction
+        }
+        // The previous chunk is in RAM already
+        boot_checksum = w25q128jw_checksum(prev, prev_words << 2, boot_checksum);
+        while (!(dma_regs[DMA_STATUS_REG_OFFSET >> 2] & (1 << DMA_STATUS_READY_BIT)));
+        prev = data_32bit;
+        prev_words = n;
+        data_32bit += n;
+        words -= n;
+    }
+
+    // The extra bytes (if any) are read by the CPU, as the last word
+    if (length % 4 != 0) {
+        uint32_t last_word = 0;
+        spi_set_rx_watermark(spi, 1);
+        spi_wait_for_rx_watermark(spi);
+        spi_read_word(spi, &last_word);
+        memcpy(data_32bit, &last_word, length % 4);
+        boot_checksum = w25q128jw_checksum(data_32bit, length % 4, boot_checksum);
+    }
+
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q128jw_load_lz_crt0(uint32_t addr, void *stage) {
+    if ((uintptr_t)stage & 0x3) return FLASH_ERROR;
+    uint8_t *buf[2] = {(uint8_t *)stage, (uint8_t *)stage + W25Q_LZ_CHUNK_BYTES};
+    volatile uint32_t *dma_regs = (volatile uint32_t *)DMA_START_ADDRESS;
+
+    // The header fills the first chunk
+    w25q128jw_load_quad_dma_crt0_start(addr, W25Q_LZ_CHUNK_BYTES);
+    dma_regs[DMA_DST_PTR_REG_OFFSET >> 2] = (uintptr_t)buf[0];
+    dma_regs[DMA_SIZE_D1_REG_OFFSET >> 2] = W25Q_LZ_CHUNK_BYTES;
+    while (!(dma_regs[DMA_STATUS_REG_OFFSET >> 2] & (1 << DMA_STATUS_READY_BIT)));
+
+    const w25q_lz_header_t *header = (const w25q_lz_header_t *)buf[0];
+    if (header->magic != W25Q_LZ_MAGIC || header->count > W25Q_LZ_MAX_SECTIONS) return FLASH_ERROR;
+    uint32_t count = header->count;
+    w25q_lz_section_t sections[W25Q_LZ_MAX_SECTIONS];
+    memcpy(sections, header->section, count * sizeof(w25q_lz_section_t));
+
+    for (uint32_t s = 0; s < count; s++) {
+        uint8_t *out = (uint8_t *)sections[s].dst;
+        uint8_t *end = out + sections[s].length;
+        uint32_t *summed = (uint32_t *)out;
+        uint32_t checksum = boot_checksum;
+        uint32_t chunks = sections[s].packed / W25Q_LZ_CHUNK_BYTES;
+
+        /*
+         * A single read of the whole section, which the DMA copies chunk by
+         * chunk to the two buffers in turn, while the CPU decodes the
+         * previous chunk and adds the words it completed to the checksum.
+        */
+        w25q128jw_load_quad_dma_crt0_start(sections[s].addr, sections[s].packed);
+        for (uint32_t i = 0; i <= chunks; i++) {
+            if (i < chunks) {
+                dma_regs[DMA_DST_PTR_REG_OFFSET >> 2] = (uintptr_t)buf[i & 1];
+                dma_regs[DMA_SIZE_D1_REG_OFFSET >> 2] = W25Q_LZ_CHUNK_BYTES; // Launches the transaction
+            }
+            if (i > 0) {
+                out = w25q128jw_load_lz_crt0_chunk(buf[(i - 1) & 1], out, end);
+                if (out == NULL) return FLASH_ERROR;
+                uint32_t words = (uint32_t *)((uintptr_t)out & ~0x3) - summed;
+                checksum = w25q128jw_checksum(summed, words << 2, checksum);
+                summed += words;
+            }
+            while (!(dma_regs[DMA_STATUS_REG_OFFSET >> 2] & (1 << DMA_STATUS_READY_BIT)));
+        }
+        if (out != end) return FLASH_ERROR;
+
+        // The extra bytes (if any) count as the last word
+        checksum = w25q128jw_checksum(summed, end - (uint8_t *)summed, checksum);
+        if (checksum != sections[s].checksum) return FLASH_ERROR;
+        boot_checksum = checksum;
+    }
+
+    return FLASH_OK;
+}
+
+uint32_t w25q128jw_checksum(const void *data, uint32_t length, uint32_t checksum) {
+    #ifdef CRC_IS_INCLUDED
+    return w25q128jw_checksum_crc32(data, length, checksum);
+    #else
+    const uint32_t *data_32bit = (const uint32_t *)data;
+    for (uint32_t i = 0; i < length >> 2; i++) {
+        checksum = ((checksum << 5) | (checksum >> 27)) + data_32bit[i];
+    }
+    // The extra bytes count as a word padded with zeros
+    if (length % 4 != 0) {
+        uint32_t last_word = 0;
+        memcpy(&last_word, &data_32bit[length >> 2], length % 4);
+        checksum = ((checksum << 5) | (checksum >> 27)) + last_word;
+    }
+    return checksum;
+    #endif // CRC_IS_INCLUDED
+}
+
+uint32_t w25q128jw_boot_checksum(void) {
+    return boot_checksum;
+}
+
+w25q_error_codes_t w25q128jw_crc32(uint32_t addr, uint32_t length, uint32_t *crc) {
+    if (crc == NULL || length == 0 || addr + length > MAX_FLASH_ADDR) return FLASH_ERROR;
+
+    #ifdef CRC_IS_INCLUDED
+    // The DMA copies the data of a single read from the RX FIFO into the CRC
+    clk_gate_periph_acquire(CRC_IDX);
+    crc_start(&crc_crc32);
+    while(!dma_is_ready(dma_channel));
+    quad_read_cmd(addr, length);
+    w25q_error_codes_t status = dma_recv_tocrc(length);
+    if (status == FLASH_OK) {
+        // The extra bytes (if any) are added by the CPU
+        if (length % 4 != 0) {
+            uint32_t last_word = 0;
+            spi_wait_for_rx_not_empty(spi);
+            spi_read_word(spi, &last_word);
+            crc_update(&last_word, length % 4);
+        }
+        *crc = crc_result(&crc_crc32);
+    }
+    clk_gate_periph_release(CRC_IDX);
+    if (status != FLASH_OK) return FLASH_ERROR_DMA;
+    #else
+    // Without the peripheral, the CPU computes it sector by sector
+    uint32_t c = 0;
+    while (length > 0) {
+        uint32_t chunk = MIN(FLASH_SECTOR_SIZE, length);
+
+        w25q_error_codes_t status = read_auto(addr, sector_data, chunk);
+        if (status != FLASH_OK) return status;
+        c = crc_compute_sw(&crc_crc32, sector_data, chunk, c);
+
+        addr += chunk;
+        length -= chunk;
+    }
+    *crc = c;
+    #endif // CRC_IS_INCLUDED
+
+    return FLASH_OK;
+}
+
+void w25q128jw_set_verify(uint8_t enable) {
+    verify_en = enable ? 1 : 0;
+}
+
 w25q_error_codes_t w25q128jw_write_standard(uint32_t addr, void* data, uint32_t length) {
     // Call the wrapper with quad = 0, dma = 0
     return page_write_wrapper(addr, data, length, 0, 0);
@@ -439,57 +969,24 @@ w25q_error_codes_t w25q128jw_erase_and_write_standard(uint32_t addr, void* data,
 
 
 w25q_error_codes_t w25q128jw_read_standard_dma(uint32_t addr, void *data, uint32_t length) {
+    w25q128jw_read_handle_t handle;
+    w25q_error_codes_t status = w25q128jw_read_standard_dma_async(&handle, addr, data, length);
+    if (status != FLASH_OK) return status;
+    return w25q128jw_read_dma_wait(&handle);
+}
+
+w25q_error_codes_t w25q128jw_read_standard_dma_async(w25q128jw_read_handle_t *handle, uint32_t addr, void *data, uint32_t length) {
     // Sanity checks
     if (w25q128jw_sanity_checks(addr, data, length) != FLASH_OK) return FLASH_ERROR;
 
-    /*
-     * SET UP DMA
-    */
-    // SPI and SPI_FLASH are the same IP so same register map
-    uint32_t *fifo_ptr_rx = (uintptr_t)spi + SPI_HOST_RXDATA_REG_OFFSET;
-
-    // Init DMA, the integrated DMA is used (peri == NULL)
-    dma_init(NULL);
-
-    // The DMA will wait for the SPI HOST/FLASH RX FIFO valid signal
-    #ifndef USE_SPI_FLASH
-        uint8_t slot = DMA_TRIG_SLOT_SPI_RX;
-    #else
-        uint8_t slot = DMA_TRIG_SLOT_SPI_FLASH_RX;
-    #endif
-
-    // Set up DMA source target
-    static dma_target_t tgt_src = {
-        .inc_du = 0, // Target is peripheral, no increment
-        .type = DMA_DATA_TYPE_WORD, // Data type is word
-    };
-    // Size is in data units (words in this case)
-    tgt_src.size_du = length>>2;
-    // Target is SPI RX FIFO
-    tgt_src.ptr = (uint8_t*)fifo_ptr_rx;
-    // Trigger to control the data flow
-    tgt_src.trig = slot;
-
-    // Set up DMA destination target
-    static dma_target_t tgt_dst = {
-        .inc_du = 1, // Increment by 1 data unit (word)
-        .type = DMA_DATA_TYPE_WORD, // Data type is byte
-        .trig = DMA_TRIG_MEMORY, // Read-write operation to memory
-    };
-    tgt_dst.ptr = (uint8_t*)data; // Target is the data buffer
+    // The read command is not accepted in continuous read mode
+    read_modes_exit();
 
-    // Set up DMA transaction
-    static dma_trans_t trans = {
-        .src = &tgt_src,
-        .dst = &tgt_dst,
-        .end = DMA_TRANS_END_POLLING,
-    };
+    // The flash does not accept reads while programming
+    program_complete();
 
-    // Validate, load and launch DMA transaction
-    dma_config_flags_t res;
-    res = dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY );
-    res = dma_load_transaction(&trans);
-    res = dma_launch(&trans);
+    // The DMA waits for the RX FIFO, so it can be launched before the command
+    if (dma_recv_fromflash(handle, data, length) != FLASH_OK) return FLASH_ERROR_DMA;
 
     // Address + Read command
     uint32_t read_byte_cmd = ((REVERT_24b_ADDR(addr & 0x00ffffff) << 8) | FC_RD);
@@ -518,18 +1015,8 @@ w25q_error_codes_t w25q128jw_read_standard_dma(uint32_t addr, void *data, uint32
     spi_set_command(spi, cmd_read_2);
     spi_wait_for_ready(spi);
 
-    // Wait for DMA to finish transaction
-    while(!dma_is_ready());
-
-    // Take into account the extra bytes (if any)
-    if (length % 4 != 0) {
-        uint32_t last_word = 0;
-        spi_read_word(spi, &last_word);
-        memcpy(&data[length - length%4], &last_word, length%4);
-    }
-
-    return FLASH_OK;
-}
+    return FLASH_OK;
+}
 
 w25q_error_codes_t w25q128jw_write_standard_dma(uint32_t addr, void *data, uint32_t length) {
     // Call the wrapper with quad = 0, dma = 1
@@ -582,56 +1069,8 @@ w25q_error_codes_t w25q128jw_read_quad(uint32_t addr, void *data, uint32_t lengt
     // Sanity checks
     if (w25q128jw_sanity_checks(addr, data, length) != FLASH_OK) return FLASH_ERROR;
 
-    // Send quad read command at standard speed
-    uint32_t cmd_read_quadIO = FC_RDQIO;
-    spi_write_word(spi, cmd_read_quadIO);
-    const uint32_t cmd_read = spi_create_command((spi_command_t){
-        .len        = 0,                 // 1 Byte
-        .csaat      = true,              // Command not finished
-        .speed      = SPI_SPEED_STANDARD, // Single speed
-        .direction  = SPI_DIR_TX_ONLY      // Write only
-    });
-    spi_set_command(spi, cmd_read);
-    spi_wait_for_ready(spi);
-
-    /*
-     * Send address at quad speed.
-     * Last byte is Fxh (here FFh) required by W25Q128JW
-    */
-    uint32_t read_byte_cmd = (REVERT_24b_ADDR(addr) | (0xFF << 24));
-    spi_write_word(spi, read_byte_cmd);
-    const uint32_t cmd_address = spi_create_command((spi_command_t){
-        .len        = 3,                // 3 Byte
-        .csaat      = true,             // Command not finished
-        .speed      = SPI_SPEED_QUAD,    // Quad speed
-        .direction  = SPI_DIR_TX_ONLY     // Write only
-    });
-    spi_set_command(spi, cmd_address);
-    spi_wait_for_ready(spi);
-
-    // Quad read requires dummy clocks
-    const uint32_t dummy_clocks_cmd = spi_create_command((spi_command_t){
-        #ifndef TARGET_SIM
-        .len        = DUMMY_CLOCKS_FAST_READ_QUAD_IO-1,
-        #else
-        .len        = DUMMY_CLOCKS_SIM-1,
-        #endif
-        .csaat      = true,            // Command not finished
-        .speed      = SPI_SPEED_QUAD,   // Quad speed
-        .direction  = SPI_DIR_DUMMY     // Dummy
-    });
-    spi_set_command(spi, dummy_clocks_cmd);
-    spi_wait_for_ready(spi);
-
-    // Read back the requested data at quad speed
-    const uint32_t cmd_read_rx = spi_create_command((spi_command_t){
-        .len        = length-1,        // 32 Byte
-        .csaat      = false,           // End command
-        .speed      = SPI_SPEED_QUAD,   // Quad speed
-        .direction  = SPI_DIR_RX_ONLY    // Read only
-    });
-    spi_set_command(spi, cmd_read_rx);
-    spi_wait_for_ready(spi);
+    // Send the command, the address and the dummy clocks, then read length bytes
+    quad_read_cmd(addr, length);
 
     /* COMMAND FINISHED */
 
@@ -727,124 +1166,175 @@ w25q_error_codes_t w25q128jw_erase_and_write_quad(uint32_t addr, void *data, uin
 
 
 w25q_error_codes_t w25q128jw_read_quad_dma(uint32_t addr, void *data, uint32_t length) {
+    w25q128jw_read_handle_t handle;
+    w25q_error_codes_t status = w25q128jw_read_quad_dma_async(&handle, addr, data, length);
+    if (status != FLASH_OK) return status;
+    return w25q128jw_read_dma_wait(&handle);
+}
+
+w25q_error_codes_t w25q128jw_read_quad_dma_async(w25q128jw_read_handle_t *handle, uint32_t addr, void *data, uint32_t length) {
     // Sanity checks
     if (w25q128jw_sanity_checks(addr, data, length) != FLASH_OK) return FLASH_ERROR;
 
-    // Send quad read command at standard speed
-    uint32_t cmd_read_quadIO = FC_RDQIO;
-    spi_write_word(spi, cmd_read_quadIO);
-    const uint32_t cmd_read = spi_create_command((spi_command_t){
-        .len        = 0,                 // 1 Byte
-        .csaat      = true,              // Command not finished
-        .speed      = SPI_SPEED_STANDARD, // Single speed
-        .direction  = SPI_DIR_TX_ONLY      // Write only
-    });
-    spi_set_command(spi, cmd_read);
-    spi_wait_for_ready(spi);
+    // Send the command, the address and the dummy clocks, then read length bytes
+    quad_read_cmd(addr, length);
 
-    /*
-     * Send address at quad speed.
-     * Last byte is Fxh (here FFh) required by W25Q128JW
-    */
-    uint32_t read_byte_cmd = (REVERT_24b_ADDR(addr) | (0xFF << 24));
-    spi_write_word(spi, read_byte_cmd);
-    const uint32_t cmd_address = spi_create_command((spi_command_t){
-        .len        = 3,                // 3 Byte
-        .csaat      = true,             // Command not finished
-        .speed      = SPI_SPEED_QUAD,    // Quad speed
-        .direction  = SPI_DIR_TX_ONLY     // Write only
-    });
-    spi_set_command(spi, cmd_address);
-    spi_wait_for_ready(spi);
+    /* COMMAND FINISHED */
 
-    // Quad read requires dummy clocks
-    const uint32_t dummy_clocks_cmd = spi_create_command((spi_command_t){
-        #ifndef TARGET_SIM
-        .len        = DUMMY_CLOCKS_FAST_READ_QUAD_IO-1, // W25Q128JW flash needs 4 dummy cycles
-        #else
-        .len        = DUMMY_CLOCKS_SIM-1, // SPI flash simulation model needs 8 dummy cycles
-        #endif
-        .csaat      = true,              // Command not finished
-        .speed      = SPI_SPEED_QUAD,     // Quad speed
-        .direction  = SPI_DIR_DUMMY       // Dummy
-    });
-    spi_set_command(spi, dummy_clocks_cmd);
-    spi_wait_for_ready(spi);
+    // The data is copied from the RX FIFO by the DMA, while the CPU goes on
+    if (dma_recv_fromflash(handle, data, length) != FLASH_OK) return FLASH_ERROR_DMA;
 
-    // Read back the requested data at quad speed
-    const uint32_t cmd_read_rx = spi_create_command((spi_command_t){
-        .len        = length-1,        // length bytes
-        .csaat      = false,           // End command
-        .speed      = SPI_SPEED_QUAD,   // Quad speed
-        .direction  = SPI_DIR_RX_ONLY    // Read only
-    });
-    spi_set_command(spi, cmd_read_rx);
-    spi_wait_for_ready(spi);
+    return FLASH_OK;
+}
 
-    /* COMMAND FINISHED */
+w25q_error_codes_t w25q128jw_read_quad_dma_strided_async(w25q128jw_read_handle_t *handle, uint32_t addr, void *data,
+                                                        uint32_t chunk, uint32_t count, uint32_t stride) {
+    // Sanity checks, the DMA writes whole words
+    if (w25q128jw_sanity_checks(addr, data, chunk * count) != FLASH_OK) return FLASH_ERROR;
+    if (count == 0 || (count > 1 && (chunk % 4 != 0 || stride % 4 != 0 || stride < chunk))) return FLASH_ERROR;
 
-    /*
-     * SET UP DMA
-    */
-    // SPI and SPI_FLASH are the same IP so same register map
-    uint32_t *fifo_ptr_rx = (uintptr_t)spi + SPI_HOST_RXDATA_REG_OFFSET;
+    // The chunks are consecutive in the flash
+    quad_read_cmd(addr, chunk * count);
 
-    // Init DMA, the integrated DMA is used (peri == NULL)
-    dma_init(NULL);
+    if (dma_recv_fromflash_strided(handle, data, chunk, count, stride) != FLASH_OK) return FLASH_ERROR_DMA;
 
-    // The DMA will wait for the SPI HOST/FLASH RX FIFO valid signal
-    #ifndef USE_SPI_FLASH
-        uint8_t slot = DMA_TRIG_SLOT_SPI_RX;
-    #else
-        uint8_t slot = DMA_TRIG_SLOT_SPI_FLASH_RX;
-    #endif
+    return FLASH_OK;
+}
 
-    // Set up DMA source target
-    static dma_target_t tgt_src = {
-        .inc_du = 0, // Target is peripheral, no increment
-        .type = DMA_DATA_TYPE_WORD, // Data type is byte
-    };
-    // Size is in data units (words in this case)
-    tgt_src.size_du = length>>2;
-    // Target is SPI RX FIFO
-    tgt_src.ptr = (uint8_t*)fifo_ptr_rx;
-    // Trigger to control the data flow
-    tgt_src.trig = slot;
+void w25q128jw_select(const w25q128jw_flash_t *flash) {
+    // The flash in use is left ready for commands
+    read_modes_exit();
+    program_complete();
 
-    // Set up DMA destination target
-    static dma_target_t tgt_dst = {
-        .inc_du = 1, // Increment by 1 data unit (word)
-        .type = DMA_DATA_TYPE_WORD, // Data type is byte
-        .trig = DMA_TRIG_MEMORY, // Read-write operation to memory
-    };
-    tgt_dst.ptr = (uint8_t*)data; // Target is the data buffer
+    // The cached blocks are the ones of the flash in use
+    flash_cache_invalidate();
 
-    // Set up DMA transaction
-    static dma_trans_t trans = {
-        .src = &tgt_src,
-        .dst = &tgt_dst,
-        .end = DMA_TRANS_END_POLLING,
-    };
+    spi = flash->spi;
+    flash_csid = flash->csid;
+    dma_channel = flash->dma_channel;
+    spi_set_csid(spi, flash_csid);
+}
 
-    // Validate, load and launch DMA transaction
-    dma_config_flags_t res;
-    res = dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY );
-    res = dma_load_transaction(&trans);
-    res = dma_launch(&trans);
+uint8_t w25q128jw_read_dma_done(const w25q128jw_read_handle_t *handle) {
+    return handle->tgt_src.size_du == 0 || dma_is_ready(handle->trans.channel);
+}
 
+w25q_error_codes_t w25q128jw_read_dma_wait(w25q128jw_read_handle_t *handle) {
     // Wait for DMA to finish transaction
-    while(!dma_is_ready());
+    while(!w25q128jw_read_dma_done(handle));
 
     // Take into account the extra bytes (if any)
-    if (length % 4 != 0) {
+    if (handle->length % 4 != 0) {
         uint32_t last_word = 0;
-        spi_read_word(spi, &last_word);
-        memcpy(&data[length - length%4], &last_word, length%4);
+        spi_wait_for_rx_not_empty(handle->spi);
+        spi_read_word(handle->spi, &last_word);
+        memcpy(&handle->data[handle->length - handle->length%4], &last_word, handle->length%4);
+    }
+
+    return FLASH_OK;
+}
+
+void w25q128jw_set_read_dma_intr(uint8_t enable) {
+    read_dma_intr = enable ? 1 : 0;
+}
+
+w25q_error_codes_t w25q128jw_prefetch_start(w25q128jw_prefetch_t *prefetch, uint32_t addr, uint32_t length,
+                                            void *buf0, void *buf1, uint32_t chunk) {
+    if (chunk == 0 || chunk % 4 != 0 || length == 0 || addr + length - 1 > MAX_FLASH_ADDR) return FLASH_ERROR;
+    if (((uintptr_t)buf0 | (uintptr_t)buf1) % 4 != 0) return FLASH_ERROR;
+
+    prefetch->buf[0] = buf0;
+    prefetch->buf[1] = buf1;
+    prefetch->chunk = chunk;
+    prefetch->addr = addr;
+    prefetch->end = addr + length;
+    prefetch->idx = 0;
+
+    // Start reading the first chunk
+    uint32_t len = MIN(chunk, length);
+    w25q_error_codes_t status = w25q128jw_read_quad_dma_async(&prefetch->read, addr, buf0, len);
+    prefetch->busy = (status == FLASH_OK);
+    prefetch->addr += len;
+    return status;
+}
+
+void *w25q128jw_prefetch_next(w25q128jw_prefetch_t *prefetch, uint32_t *length) {
+    if (!prefetch->busy) return NULL;
+
+    // Wait for the chunk in flight
+    w25q128jw_read_dma_wait(&prefetch->read);
+    uint8_t *ready = prefetch->buf[prefetch->idx];
+    *length = prefetch->read.length;
+
+    // Start reading the following chunk into the other buffer
+    prefetch->busy = 0;
+    if (prefetch->addr < prefetch->end) {
+        uint32_t len = MIN(prefetch->chunk, prefetch->end - prefetch->addr);
+        prefetch->idx ^= 1;
+        if (w25q128jw_read_quad_dma_async(&prefetch->read, prefetch->addr,
+                                           prefetch->buf[prefetch->idx], len) == FLASH_OK) {
+            prefetch->busy = 1;
+            prefetch->addr += len;
+        }
+    }
+
+    return ready;
+}
+
+void w25q128jw_prefetch_stop(w25q128jw_prefetch_t *prefetch) {
+    if (prefetch->busy) {
+        w25q128jw_read_dma_wait(&prefetch->read);
+        prefetch->busy = 0;
+    }
+}
+
+w25q_error_codes_t w25q128jw_cache_enable(w25q128jw_cache_t *cache, void *blocks, w25q_cache_line_t *lines,
+                                          uint32_t block_size, uint32_t count) {
+    if (block_size < 4 || (block_size & (block_size - 1)) != 0 || count == 0) return FLASH_ERROR;
+    if (blocks == NULL || lines == NULL || (uintptr_t)blocks % 4 != 0) return FLASH_ERROR;
+
+    w25q128jw_cache_disable();
+
+    cache->blocks = blocks;
+    cache->lines = lines;
+    cache->block_size = block_size;
+    cache->count = count;
+    cache->clock = 0;
+    cache->last = W25Q_CACHE_EMPTY;
+    cache->prefetch = -1;
+    cache->stats = (w25q_cache_stats_t){0};
+    for (uint32_t i = 0; i < count; i++) {
+        lines[i].tag = W25Q_CACHE_EMPTY;
+        lines[i].used = 0;
     }
 
+    block_cache = cache;
     return FLASH_OK;
 }
 
+void w25q128jw_cache_disable(void) {
+    cache_prefetch_wait();
+    block_cache = NULL;
+}
+
+void w25q128jw_cache_invalidate(void) {
+    if (block_cache == NULL) return;
+
+    cache_prefetch_wait();
+    for (uint32_t i = 0; i < block_cache->count; i++) {
+        block_cache->lines[i].tag = W25Q_CACHE_EMPTY;
+    }
+    block_cache->last = W25Q_CACHE_EMPTY;
+}
+
+void w25q128jw_cache_get_stats(w25q_cache_stats_t *stats) {
+    *stats = block_cache != NULL ? block_cache->stats : (w25q_cache_stats_t){0};
+}
+
+void w25q128jw_cache_reset_stats(void) {
+    if (block_cache != NULL) block_cache->stats = (w25q_cache_stats_t){0};
+}
+
 w25q_error_codes_t w25q128jw_write_quad_dma(uint32_t addr, void *data, uint32_t length) {
     // Call the wrapper with quad = 1, dma = 1
     return page_write_wrapper(addr, data, length, 1, 1);
@@ -891,108 +1381,189 @@ w25q_error_codes_t w25q128jw_erase_and_write_quad_dma(uint32_t addr, void *data,
 
 }
 
-w25q_error_codes_t w25q128jw_4k_erase(uint32_t addr) {
-    // Sanity checks
-    if (addr > MAX_FLASH_ADDR || addr < 0) return FLASH_ERROR;
+void w25q128jw_set_continuous_read(uint8_t enable) {
+    if (!enable) read_modes_exit();
+    continuous_read_en = enable ? 1 : 0;
+}
+
+w25q_error_codes_t w25q128jw_set_burst_wrap(uint32_t wrap_length) {
+    /*
+     * W4 = 0 enables the wrap, W6-W5 select its length:
+     * 00 = 8 bytes, 01 = 16 bytes, 10 = 32 bytes, 11 = 64 bytes.
+     * The other bits are don't care and left to 1.
+    */
+    uint8_t wrap_bits;
+    switch (wrap_length) {
+        case 0:  wrap_bits = 0xFF; break;
+        case 8:  wrap_bits = 0x8F; break;
+        case 16: wrap_bits = 0xAF; break;
+        case 32: wrap_bits = 0xCF; break;
+        case 64: wrap_bits = 0xEF; break;
+        default: return FLASH_ERROR;
+    }
 
     // Wait any other operation to finish
     flash_wait();
 
-    // Enable flash write in order to erase
-    flash_write_enable();
-
-    // Build and send erase command
-    uint32_t erase_4k_cmd = ((REVERT_24b_ADDR(addr & 0x00ffffff) << 8) | FC_SE);
-    spi_write_word(spi, erase_4k_cmd);
-    spi_wait_for_ready(spi);
-    const uint32_t cmd_erase = spi_create_command((spi_command_t){
-        .len        = 3,                 // 4 Bytes
-        .csaat      = false,             // End command
+    // Send the command at standard speed
+    spi_write_word(spi, FC_SBW);
+    const uint32_t cmd_wrap = spi_create_command((spi_command_t){
+        .len        = 0,                 // 1 Byte
+        .csaat      = true,              // Command not finished
         .speed      = SPI_SPEED_STANDARD, // Single speed
         .direction  = SPI_DIR_TX_ONLY      // Write only
     });
-    spi_set_command(spi, cmd_erase);
+    spi_set_command(spi, cmd_wrap);
+    spi_wait_for_ready(spi);
+
+    // 24 dummy bits and the wrap bits, at quad speed
+    spi_write_word(spi, 0x00FFFFFF | ((uint32_t)wrap_bits << 24));
+    const uint32_t cmd_wrap_bits = spi_create_command((spi_command_t){
+        .len        = 3,                // 4 Bytes
+        .csaat      = false,            // End command
+        .speed      = SPI_SPEED_QUAD,    // Quad speed
+        .direction  = SPI_DIR_TX_ONLY     // Write only
+    });
+    spi_set_command(spi, cmd_wrap_bits);
     spi_wait_for_ready(spi);
 
+    // Also set by the next QPI entry
+    burst_wrap = wrap_length;
+
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q128jw_set_read_mode(w25q_read_mode_t mode) {
+    if (mode != W25Q_READ_MODE_QUAD_IO && mode != W25Q_READ_MODE_QPI) return FLASH_ERROR;
+
+    if (mode == W25Q_READ_MODE_QUAD_IO) read_modes_exit();
+    qpi_en = (mode == W25Q_READ_MODE_QPI);
+
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q128jw_4k_erase(uint32_t addr) {
+    // Sanity checks
+    if (addr > MAX_FLASH_ADDR) return FLASH_ERROR;
+
+    erase_start(FC_SE, addr);
+
     // Wait for the erase operation to be finished
     flash_wait();
+    flash_cache_invalidate();
+    return FLASH_OK;
 }
 
 w25q_error_codes_t w25q128jw_32k_erase(uint32_t addr) {
     // Sanity checks
-    if (addr > 0x00ffffff || addr < 0) return FLASH_ERROR;
+    if (addr > MAX_FLASH_ADDR) return FLASH_ERROR;
 
-    // Wait any other operation to finish
+    erase_start(FC_BE32, addr);
+
+    // Wait for the erase operation to be finished
     flash_wait();
+    flash_cache_invalidate();
+    return FLASH_OK;
+}
 
-    // Enable flash write in order to erase
-    flash_write_enable();
+w25q_error_codes_t w25q128jw_64k_erase(uint32_t addr) {
+    // Sanity checks
+    if (addr > MAX_FLASH_ADDR) return FLASH_ERROR;
 
-    // Build and send erase command
-    uint32_t erase_32k_cmd = ((REVERT_24b_ADDR(addr & 0x00ffffff) << 8) | FC_BE32);
-    spi_write_word(spi, erase_32k_cmd);
-    spi_wait_for_ready(spi);
-    const uint32_t cmd_erase = spi_create_command((spi_command_t){
-        .len        = 3,                 // 4 Bytes
-        .csaat      = false,             // End command
-        .speed      = SPI_SPEED_STANDARD, // Single speed
-        .direction  = SPI_DIR_TX_ONLY      // Write only
-    });
-    spi_set_command(spi, cmd_erase);
-    spi_wait_for_ready(spi);
+    erase_start(FC_BE64, addr);
 
     // Wait for the erase operation to be finished
     flash_wait();
+    flash_cache_invalidate();
+    return FLASH_OK;
 }
 
-w25q_error_codes_t w25q128jw_64k_erase(uint32_t addr) {
-    // Sanity checks
-    if (addr > 0x00ffffff || addr < 0) return FLASH_ERROR;
+void w25q128jw_chip_erase(void) {
+    erase_start(FC_CE, 0);
 
-    // Wait any other operation to finish
+    // Wait for the erase operation to be finished
     flash_wait();
+    flash_cache_invalidate();
+}
 
-    // Enable flash write in order to erase
-    flash_write_enable();
+w25q_error_codes_t w25q128jw_4k_erase_async(uint32_t addr) {
+    return erase_async(FC_SE, addr);
+}
 
-    // Build and send erase command
-    uint32_t erase_64k_cmd = ((REVERT_24b_ADDR(addr & 0x00ffffff) << 8) | FC_BE64);
-    spi_write_word(spi, erase_64k_cmd);
-    spi_wait_for_ready(spi);
-    const uint32_t cmd_erase = spi_create_command((spi_command_t){
-        .len        = 3,                 // 4 Bytes
+w25q_error_codes_t w25q128jw_32k_erase_async(uint32_t addr) {
+    return erase_async(FC_BE32, addr);
+}
+
+w25q_error_codes_t w25q128jw_64k_erase_async(uint32_t addr) {
+    return erase_async(FC_BE64, addr);
+}
+
+w25q_error_codes_t w25q128jw_chip_erase_async(void) {
+    return erase_async(FC_CE, 0);
+}
+
+w25q_erase_state_t w25q128jw_erase_poll(void) {
+    // A single status read, the flash is only polled while erasing
+    if (erase_state == W25Q_ERASE_BUSY && (flash_read_status(FC_RSR1) & FLASH_SR1_BUSY) == 0) {
+        erase_done();
+    }
+    return erase_state;
+}
+
+w25q_error_codes_t w25q128jw_erase_suspend(void) {
+    if (erase_state != W25Q_ERASE_BUSY) return FLASH_ERROR;
+
+    // Set first, so that a poll from an interrupt does not use the SPI meanwhile
+    erase_state = W25Q_ERASE_SUSPENDED;
+
+    // Build and send suspend command
+    spi_write_word(spi, FC_EPS);
+    const uint32_t cmd_suspend = spi_create_command((spi_command_t){
+        .len        = 0,                 // 1 Byte
         .csaat      = false,             // End command
         .speed      = SPI_SPEED_STANDARD, // Single speed
         .direction  = SPI_DIR_TX_ONLY      // Write only
     });
-    spi_set_command(spi, cmd_erase);
+    spi_set_command(spi, cmd_suspend);
     spi_wait_for_ready(spi);
 
-    // Wait for the erase operation to be finished
-    flash_wait();
+    // The flash is suspended within tSUS (20us at most)
+    while (flash_read_status(FC_RSR1) & FLASH_SR1_BUSY);
+
+    // If the SUS bit is not set, the erase finished before the suspend
+    if ((flash_read_status(FC_RSR2) & FLASH_SR2_SUS) == 0) {
+        erase_done();
+    }
+    return FLASH_OK;
 }
 
-void w25q128jw_chip_erase(void) {
-    // Wait any other operation to finish
-    flash_wait();
+w25q_error_codes_t w25q128jw_erase_resume(void) {
+    if (erase_state != W25Q_ERASE_SUSPENDED) return FLASH_ERROR;
 
-    // Enable flash write in order to erase
-    flash_write_enable();
+    // The reads served meanwhile may have left the flash in continuous read mode
+    read_modes_exit();
 
-    // Build and send erase command
-    spi_write_word(spi, FC_CE);
-    spi_wait_for_ready(spi);
-    const uint32_t cmd_erase = spi_create_command((spi_command_t){
-        .len        = 0,                 // 1 Bytes
+    // Build and send resume command
+    spi_write_word(spi, FC_EPR);
+    const uint32_t cmd_resume = spi_create_command((spi_command_t){
+        .len        = 0,                 // 1 Byte
         .csaat      = false,             // End command
         .speed      = SPI_SPEED_STANDARD, // Single speed
         .direction  = SPI_DIR_TX_ONLY      // Write only
     });
-    spi_set_command(spi, cmd_erase);
+    spi_set_command(spi, cmd_resume);
     spi_wait_for_ready(spi);
 
-    // Wait for the erase operation to be finished
-    flash_wait();
+    erase_state = W25Q_ERASE_BUSY;
+    return FLASH_OK;
+}
+
+__attribute__((weak)) void w25q128jw_erase_done_handler(void) {
+    /* Users should implement their non-weak version */
+}
+
+__attribute__((weak)) void w25q128jw_busy_handler(void) {
+    /* Users should implement their non-weak version */
 }
 
 void w25q128jw_reset(void) {
@@ -1015,6 +1586,9 @@ void w25q128jw_reset_force(void) {
 }
 
 void w25q128jw_power_down(void) {
+    read_modes_exit();
+    program_complete();
+
     // Build and send power down command
     spi_write_word(spi, FC_PD);
     const uint32_t cmd_power_down = spi_create_command((spi_command_t){
@@ -1025,6 +1599,15 @@ void w25q128jw_power_down(void) {
     });
     spi_set_command(spi, cmd_power_down);
     spi_wait_for_ready(spi);
+
+    // Until the next w25q128jw_init()
+    clk_gate_periph_release(spi_clk_idx);
+    spi_clk_idx = CLK_GATE_NO_PERIPH;
+}
+
+void w25q128jw_update_clock(void) {
+    if (spi == NULL) return;
+    configure_spi();
 }
 
 
@@ -1139,7 +1722,7 @@ static void configure_spi(void) {
         if (core_clk/(2 + 2 * clk_div) > FLASH_CLK_MAX_HZ) clk_div += 1; // Adjust if the truncation was not 0
     }
     // SPI Configuration
-    // Configure chip 0 (flash memory)
+    // Configure the chip select of the flash
     const uint32_t chip_cfg = spi_create_configopts((spi_configopts_t){
         .clkdiv     = clk_div,
         .csnidle    = 0xF,
@@ -1149,40 +1732,101 @@ static void configure_spi(void) {
         .cpha       = 0,
         .cpol       = 0
     });
-    spi_set_configopts(spi, 0, chip_cfg);
+    spi_set_configopts(spi, flash_csid, chip_cfg);
 }
 
 static void flash_wait(void) {
+    read_modes_exit();
+
+    while (flash_read_status(FC_RSR1) & FLASH_SR1_BUSY) w25q128jw_busy_handler();
+
+    // A pending page program is committed
+    program_complete();
+}
+
+static void program_complete(void) {
+    if (!program_pending) return;
+
+    // In simulation the flash is not polled
+    #ifndef TARGET_SIM
+    while (flash_read_status(FC_RSR1) & FLASH_SR1_BUSY) w25q128jw_busy_handler();
+    #endif // TARGET_SIM
+
+    program_pending = 0;
+    flash_cache_invalidate();
+}
+
+static uint8_t flash_read_status(uint8_t cmd) {
+    // A read ahead of the block cache holds the SPI host
+    cache_prefetch_wait();
+
     spi_set_rx_watermark(spi,1);
-    bool flash_busy = true;
     uint8_t flash_resp[4] = {0xff,0xff,0xff,0xff};
 
-    while(flash_busy){
-        uint32_t flash_cmd = FC_RSR1; // [CMD] Read status register 1
-        spi_write_word(spi, flash_cmd); // Push TX buffer
-        uint32_t spi_status_cmd = spi_create_command((spi_command_t){
-            .len        = 0,
-            .csaat      = true,
-            .speed      = SPI_SPEED_STANDARD,
-            .direction  = SPI_DIR_TX_ONLY
-        });
-        uint32_t spi_status_read_cmd = spi_create_command((spi_command_t){
-            .len        = 0,
-            .csaat      = false,
-            .speed      = SPI_SPEED_STANDARD,
-            .direction  = SPI_DIR_RX_ONLY
-        });
-        spi_set_command(spi, spi_status_cmd);
-        spi_wait_for_ready(spi);
-        spi_set_command(spi, spi_status_read_cmd);
-        spi_wait_for_ready(spi);
-        spi_wait_for_rx_watermark(spi);
-        spi_read_word(spi, (uint32_t *)flash_resp);
-        if ((flash_resp[0] & 0x01) == 0) flash_busy = false;
-    }
+    spi_write_word(spi, cmd); // Push TX buffer
+    uint32_t spi_status_cmd = spi_create_command((spi_command_t){
+        .len        = 0,
+        .csaat      = true,
+        .speed      = SPI_SPEED_STANDARD,
+        .direction  = SPI_DIR_TX_ONLY
+    });
+    uint32_t spi_status_read_cmd = spi_create_command((spi_command_t){
+        .len        = 0,
+        .csaat      = false,
+        .speed      = SPI_SPEED_STANDARD,
+        .direction  = SPI_DIR_RX_ONLY
+    });
+    spi_set_command(spi, spi_status_cmd);
+    spi_wait_for_ready(spi);
+    spi_set_command(spi, spi_status_read_cmd);
+    spi_wait_for_ready(spi);
+    // The core sleeps for the transfer, flash_wait() reads the status in a loop
+    spi_sleep_for_events(spi, SPI_EVENT_RXWM);
+    spi_read_word(spi, (uint32_t *)flash_resp);
+    return flash_resp[0];
+}
+
+static void erase_start(uint8_t cmd, uint32_t addr) {
+    // Wait any other operation to finish
+    flash_wait();
+
+    // Enable flash write in order to erase
+    flash_write_enable();
+
+    // Build and send erase command, with the address if it is not a chip erase
+    uint32_t erase_cmd = cmd == FC_CE ? FC_CE : ((REVERT_24b_ADDR(addr & 0x00ffffff) << 8) | cmd);
+    spi_write_word(spi, erase_cmd);
+    spi_wait_for_ready(spi);
+    const uint32_t cmd_erase = spi_create_command((spi_command_t){
+        .len        = cmd == FC_CE ? 0 : 3, // 1 or 4 Bytes
+        .csaat      = false,             // End command
+        .speed      = SPI_SPEED_STANDARD, // Single speed
+        .direction  = SPI_DIR_TX_ONLY      // Write only
+    });
+    spi_set_command(spi, cmd_erase);
+    spi_wait_for_ready(spi);
+
+    // The content is erased from now on
+    w25q128jw_cache_invalidate();
+}
+
+static w25q_error_codes_t erase_async(uint8_t cmd, uint32_t addr) {
+    // Sanity checks
+    if (addr > MAX_FLASH_ADDR || erase_state != W25Q_ERASE_IDLE) return FLASH_ERROR;
+
+    erase_start(cmd, addr);
+    erase_state = W25Q_ERASE_BUSY;
+    return FLASH_OK;
+}
+
+static void erase_done(void) {
+    erase_state = W25Q_ERASE_IDLE;
+    flash_cache_invalidate();
+    w25q128jw_erase_done_handler();
 }
 
 static void flash_reset(void) {
+    read_modes_exit();
     spi_write_word(spi, FC_ERESET);
     spi_write_word(spi, FC_RESET);
     spi_wait_for_ready(spi);
@@ -1214,27 +1858,62 @@ w25q_error_codes_t erase_and_write(uint32_t addr, uint8_t *data, uint32_t length
     w25q_error_codes_t status;
 
     while (remaining_length > 0) {
+        /*
+         * Blocks fully covered by the data are erased at once, nothing
+         * has to be kept.
+        */
+        uint32_t block_size = 0;
+        if ((current_addr & (FLASH_BLOCK64_SIZE-1)) == 0 && remaining_length >= FLASH_BLOCK64_SIZE) {
+            block_size = FLASH_BLOCK64_SIZE;
+        } else if ((current_addr & (FLASH_BLOCK32_SIZE-1)) == 0 && remaining_length >= FLASH_BLOCK32_SIZE) {
+            block_size = FLASH_BLOCK32_SIZE;
+        }
+
+        if (block_size != 0) {
+            // Erase the block (no need to do so in simulation)
+            #ifndef TARGET_SIM
+            if (block_size == FLASH_BLOCK64_SIZE) status = w25q128jw_64k_erase(current_addr);
+            else status = w25q128jw_32k_erase(current_addr);
+            if (status != FLASH_OK) return FLASH_ERROR;
+            #endif // TARGET_SIM
+
+            status = program_changed_pages(current_addr, current_data, NULL, block_size);
+            if (status != FLASH_OK) return FLASH_ERROR;
+
+            remaining_length -= block_size;
+            current_addr += block_size;
+            current_data += block_size;
+            continue;
+        }
+
         // Start address of the sector to erase, 4kB aligned
         uint32_t sector_start_addr = current_addr & 0xfffff000;
+        uint32_t offset = current_addr - sector_start_addr;
 
         // Read the full sector and save it into RAM
-        status = w25q128jw_read(sector_start_addr, sector_data, FLASH_SECTOR_SIZE);
+        status = read_auto(sector_start_addr, sector_data, FLASH_SECTOR_SIZE);
         if (status != FLASH_OK) return FLASH_ERROR;
 
-        // Erase the sector (no need to do so in simulation)
-        #ifndef TARGET_SIM
-        w25q128jw_4k_erase(sector_start_addr);
-        #endif // TARGET_SIM
-
         // Calculate the length of data to write in this sector
-        uint32_t write_length = MIN(FLASH_SECTOR_SIZE - (current_addr - sector_start_addr), remaining_length);
+        uint32_t write_length = MIN(FLASH_SECTOR_SIZE - offset, remaining_length);
 
-        // Modify the data in RAM to include the new data
-        memcpy(&sector_data[current_addr - sector_start_addr], current_data, write_length);
+        if (!needs_erase(&sector_data[offset], current_data, write_length)) {
+            // Only 1->0 transitions: program the changed pages over the current content
+            status = program_changed_pages(current_addr, current_data, &sector_data[offset], write_length);
+            if (status != FLASH_OK) return FLASH_ERROR;
+        } else {
+            // Erase the sector (no need to do so in simulation)
+            #ifndef TARGET_SIM
+            w25q128jw_4k_erase(sector_start_addr);
+            #endif // TARGET_SIM
 
-        // Write the modified data back to the flash (without erasing this time)
-        status = w25q128jw_write(sector_start_addr, sector_data, FLASH_SECTOR_SIZE, 0);
-        if (status != FLASH_OK) return FLASH_ERROR;
+            // Modify the data in RAM to include the new data
+            memcpy(&sector_data[offset], current_data, write_length);
+
+            // Write the modified data back to the flash, skipping the blank pages
+            status = program_changed_pages(sector_start_addr, sector_data, NULL, FLASH_SECTOR_SIZE);
+            if (status != FLASH_OK) return FLASH_ERROR;
+        }
 
         // Update the remaining length, address and data pointer
         remaining_length -= write_length;
@@ -1245,6 +1924,167 @@ w25q_error_codes_t erase_and_write(uint32_t addr, uint8_t *data, uint32_t length
     return FLASH_OK;
 }
 
+static w25q_error_codes_t cache_read(uint32_t addr, uint8_t *data, uint32_t length) {
+    w25q128jw_cache_t *cache = block_cache;
+
+    // A pending page program is committed first, it invalidates the cache
+    if (program_pending) program_complete();
+
+    while (length > 0) {
+        uint32_t base = addr & ~(cache->block_size - 1);
+        uint32_t len = MIN(cache->block_size - (addr - base), length);
+
+        // Look for the block, and for the least recently used line meanwhile
+        int32_t line = -1;
+        int32_t victim = -1;
+        for (uint32_t i = 0; i < cache->count; i++) {
+            if (cache->lines[i].tag == base) {
+                line = i;
+                break;
+            }
+            if ((int32_t)i != cache->prefetch &&
+                (victim < 0 || cache->lines[i].used < cache->lines[victim].used)) {
+                victim = i;
+            }
+        }
+
+        if (line >= 0) {
+            // The block may still be read ahead
+            if (line == cache->prefetch) cache_prefetch_wait();
+            cache->stats.hits++;
+        } else {
+            // The only line is read ahead, for another block
+            if (victim < 0) {
+                cache_prefetch_wait();
+                victim = 0;
+            }
+            line = victim;
+            cache->lines[line].tag = W25Q_CACHE_EMPTY;
+            w25q_error_codes_t status = read_auto(base, &cache->blocks[line * cache->block_size], cache->block_size);
+            if (status != FLASH_OK) return status;
+            cache->lines[line].tag = base;
+            cache->stats.misses++;
+        }
+        cache->lines[line].used = ++cache->clock;
+
+        memcpy(data, &cache->blocks[line * cache->block_size + (addr - base)], len);
+
+        // A sequential access reads the next block ahead
+        if (base != cache->last) {
+            if (base == cache->last + cache->block_size) cache_prefetch(base + cache->block_size);
+            cache->last = base;
+        }
+
+        addr += len;
+        data += len;
+        length -= len;
+    }
+
+    return FLASH_OK;
+}
+
+static void cache_prefetch(uint32_t addr) {
+    w25q128jw_cache_t *cache = block_cache;
+    if (cache->prefetch >= 0 || addr > MAX_FLASH_ADDR) return;
+
+    int32_t victim = -1;
+    for (uint32_t i = 0; i < cache->count; i++) {
+        if (cache->lines[i].tag == addr) return;
+        if (victim < 0 || cache->lines[i].used < cache->lines[victim].used) victim = i;
+    }
+
+    // The block just accessed stays cached
+    if (cache->lines[victim].used == cache->clock) return;
+
+    // Wait DMA to be free
+    while(!dma_is_ready(dma_channel));
+    cache->lines[victim].tag = W25Q_CACHE_EMPTY;
+    if (w25q128jw_read_quad_dma_async(&cache->read, addr, &cache->blocks[victim * cache->block_size],
+                                      cache->block_size) != FLASH_OK) return;
+
+    // Older than the block just accessed, until it is used
+    cache->lines[victim].tag = addr;
+    cache->lines[victim].used = cache->clock - 1;
+    cache->prefetch = victim;
+    cache->stats.prefetches++;
+}
+
+static void cache_prefetch_wait(void) {
+    if (block_cache == NULL || block_cache->prefetch < 0) return;
+
+    w25q128jw_read_dma_wait(&block_cache->read);
+    block_cache->prefetch = -1;
+}
+
+static w25q_error_codes_t read_auto(uint32_t addr, uint8_t *data, uint32_t length) {
+    if (length < RX_DMA_THRESHOLD) return w25q128jw_read_quad(addr, data, length);
+
+    // Wait DMA to be free
+    while(!dma_is_ready(dma_channel));
+    return w25q128jw_read_quad_dma(addr, data, length);
+}
+
+static w25q_error_codes_t verify(uint32_t addr, const uint8_t *data, uint32_t length) {
+    #ifdef CRC_IS_INCLUDED
+    uint32_t flash_crc, data_crc;
+    w25q_error_codes_t status = w25q128jw_crc32(addr, length, &flash_crc);
+    if (status != FLASH_OK) return status;
+    clk_gate_periph_acquire(CRC_IDX);
+    crc_result_t crc_status = crc_compute(&crc_crc32, data, length, 0, &data_crc);
+    clk_gate_periph_release(CRC_IDX);
+    if (crc_status != kCrcOk) return FLASH_ERROR_DMA;
+    if (flash_crc != data_crc) return FLASH_ERROR_VERIFY;
+    #else
+    while (length > 0) {
+        uint32_t chunk = MIN(FLASH_SECTOR_SIZE, length);
+
+        w25q_error_codes_t status = read_auto(addr, sector_data, chunk);
+        if (status != FLASH_OK) return status;
+        if (memcmp(sector_data, data, chunk) != 0) return FLASH_ERROR_VERIFY;
+
+        addr += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    #endif // CRC_IS_INCLUDED
+
+    return FLASH_OK;
+}
+
+static uint8_t needs_erase(const uint8_t *old, const uint8_t *data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        if ((old[i] & data[i]) != data[i]) return 1;
+    }
+    return 0;
+}
+
+static w25q_error_codes_t program_changed_pages(uint32_t addr, uint8_t *data, const uint8_t *old, uint32_t length) {
+    w25q_error_codes_t status;
+
+    while (length > 0) {
+        // Bytes up to the end of the page
+        uint32_t chunk = MIN(FLASH_PAGE_SIZE - (addr % FLASH_PAGE_SIZE), length);
+
+        // Compare with the current content, or with the erased state (FFh)
+        uint8_t changed = 0;
+        for (uint32_t i = 0; i < chunk && !changed; i++) {
+            changed = data[i] != (old != NULL ? old[i] : 0xFF);
+        }
+
+        if (changed) {
+            status = w25q128jw_write(addr, data, chunk, 0);
+            if (status != FLASH_OK) return FLASH_ERROR;
+        }
+
+        addr += chunk;
+        data += chunk;
+        if (old != NULL) old += chunk;
+        length -= chunk;
+    }
+
+    return FLASH_OK;
+}
+
 static w25q_error_codes_t page_write_wrapper(uint32_t addr, uint8_t *data, uint32_t length, uint8_t quad, uint8_t dma) {
     // Sanity checks
     if (w25q128jw_sanity_checks(addr, data, length) != FLASH_OK) return FLASH_ERROR;
@@ -1267,7 +2107,7 @@ static w25q_error_codes_t page_write_wrapper(uint32_t addr, uint8_t *data, uint3
     if (addr % FLASH_PAGE_SIZE != 0) {
         uint8_t tmp_len = FLASH_PAGE_SIZE - (addr % FLASH_PAGE_SIZE);
         tmp_len = MIN(tmp_len, length);
-        page_write(addr, data_8bit, tmp_len, speed, dma_flag);
+        if (page_write(addr, data_8bit, tmp_len, speed, dma_flag) != FLASH_OK) return FLASH_ERROR;
         addr += tmp_len;
         data_8bit += tmp_len;
         length -= tmp_len;
@@ -1280,12 +2120,12 @@ static w25q_error_codes_t page_write_wrapper(uint32_t addr, uint8_t *data, uint3
     int flag = 1;
     while (flag) {
         if (length > FLASH_PAGE_SIZE) {
-            page_write(addr, data_8bit, FLASH_PAGE_SIZE, speed, dma_flag);
+            if (page_write(addr, data_8bit, FLASH_PAGE_SIZE, speed, dma_flag) != FLASH_OK) return FLASH_ERROR;
             addr += FLASH_PAGE_SIZE;
             data_8bit += FLASH_PAGE_SIZE;
             length -= FLASH_PAGE_SIZE;
         } else {
-            page_write(addr, data_8bit, length, speed, dma_flag);
+            if (page_write(addr, data_8bit, length, speed, dma_flag) != FLASH_OK) return FLASH_ERROR;
             flag = 0;
         }
     }
@@ -1293,6 +2133,12 @@ static w25q_error_codes_t page_write_wrapper(uint32_t addr, uint8_t *data, uint3
 }
 
 static w25q_error_codes_t page_write(uint32_t addr, uint8_t *data, uint32_t length, uint8_t quad, uint8_t dma) {
+    // Configure the DMA while the previous page (if any) is being programmed
+    if (dma && dma_prepare_toflash(data, length) != FLASH_OK) return FLASH_ERROR_DMA;
+
+    // The flash accepts the next program only once the previous one is committed
+    program_complete();
+
     // Required every time before issuing a write command
     flash_write_enable();
 
@@ -1317,7 +2163,7 @@ static w25q_error_codes_t page_write(uint32_t addr, uint8_t *data, uint32_t leng
      * if the FIFO is full before writing.
     */
     if (dma) {
-        dma_send_toflash(data, length);
+        if (dma_send_toflash(data, length) != FLASH_OK) return FLASH_ERROR_DMA;
     } else {
         uint32_t *data_32bit = (uint32_t *)data;
         for (int i = 0; i < length>>2; i++) {
@@ -1345,13 +2191,15 @@ static w25q_error_codes_t page_write(uint32_t addr, uint8_t *data, uint32_t leng
     spi_set_command(spi, cmd_write_2);
     spi_wait_for_ready(spi);
 
-    // Wait for flash to be ready again (FPGA only)
-    #ifndef TARGET_SIM
-    flash_wait();
-    #endif // TARGET_SIM
+    /*
+     * Do not wait for the page to be committed: the next page is prepared
+     * meanwhile, and the next operation on the flash waits for it.
+    */
+    program_pending = 1;
+    return FLASH_OK;
 }
 
-static w25q_error_codes_t dma_send_toflash(uint8_t *data, uint32_t length) {
+static w25q_error_codes_t dma_prepare_toflash(uint8_t *data, uint32_t length) {
     // SPI and SPI_FLASH are the same IP so same register map
     uint32_t *fifo_ptr_tx = (uintptr_t)spi + SPI_HOST_TXDATA_REG_OFFSET;
 
@@ -1359,52 +2207,55 @@ static w25q_error_codes_t dma_send_toflash(uint8_t *data, uint32_t length) {
     dma_init(NULL);
 
     // The DMA will wait for the SPI HOST/FLASH TX FIFO valid signal
-    #ifndef USE_SPI_FLASH
-        uint8_t slot = DMA_TRIG_SLOT_SPI_TX;
-    #else
-        uint8_t slot = DMA_TRIG_SLOT_SPI_FLASH_TX;
-    #endif
+    uint8_t slot = spi_dma_slot(1);
 
     // Set up DMA source target
-    static dma_target_t tgt_src = {
+    tgt_src_toflash = (dma_target_t){
         .inc_du = 1, // Increment by 1 data unit (word)
         .type = DMA_DATA_TYPE_WORD, // Data type is word
     };
     // Size is in data units (words in this case)
-    tgt_src.size_du = length>>2;
+    tgt_src_toflash.size_du = length>>2;
     // Target is data buffer
-    tgt_src.ptr = data;
+    tgt_src_toflash.ptr = data;
     // Reads from memory
-    tgt_src.trig = DMA_TRIG_MEMORY;
+    tgt_src_toflash.trig = DMA_TRIG_MEMORY;
 
     // Set up DMA destination target
-    static dma_target_t tgt_dst = {
+    tgt_dst_toflash = (dma_target_t){
         .inc_du = 0, // It's a peripheral, no increment
         .type = DMA_DATA_TYPE_WORD, // Data type is word
     };
-    tgt_dst.trig = slot;
-    tgt_dst.ptr = (uint8_t*)fifo_ptr_tx; // Target is SPI TX FIFO
+    tgt_dst_toflash.trig = slot;
+    tgt_dst_toflash.ptr = (uint8_t*)fifo_ptr_tx; // Target is SPI TX FIFO
 
     // Set up DMA transaction
-    static dma_trans_t trans = {
-        .src = &tgt_src,
-        .dst = &tgt_dst,
+    trans_toflash = (dma_trans_t){
+        .src = &tgt_src_toflash,
+        .dst = &tgt_dst_toflash,
         .mode = DMA_TRANS_MODE_SINGLE,
         .win_du = 0,
         .end = DMA_TRANS_END_POLLING,
+        .channel = dma_channel,
     };
 
-    // Validate, load and launch DMA transaction
+    // Validate and load DMA transaction, it is launched by dma_send_toflash
     dma_config_flags_t res;
-    res = dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY );
+    res = dma_validate_transaction(&trans_toflash, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY );
     if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
-    res = dma_load_transaction(&trans);
+    res = dma_load_transaction(&trans_toflash);
     if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
-    res = dma_launch(&trans);
+
+    return FLASH_OK;
+}
+
+static w25q_error_codes_t dma_send_toflash(uint8_t *data, uint32_t length) {
+    dma_config_flags_t res;
+    res = dma_launch(&trans_toflash);
     if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
 
     // Wait for DMA to finish transaction
-    while(!dma_is_ready());
+    while(!dma_is_ready(dma_channel));
 
     // Take into account the extra bytes (if any)
     if (length % 4 != 0) {
@@ -1416,7 +2267,301 @@ static w25q_error_codes_t dma_send_toflash(uint8_t *data, uint32_t length) {
     return FLASH_OK;
 }
 
+static w25q_error_codes_t dma_recv_fromflash(w25q128jw_read_handle_t *handle, uint8_t *data, uint32_t length) {
+    return dma_recv_fromflash_strided(handle, data, length, 1, length);
+}
+
+static w25q_error_codes_t dma_recv_fromflash_strided(w25q128jw_read_handle_t *handle, uint8_t *data,
+                                                     uint32_t chunk, uint32_t count, uint32_t stride) {
+    uint32_t length = chunk * count;
+
+    // SPI and SPI_FLASH are the same IP so same register map
+    uint32_t *fifo_ptr_rx = (uintptr_t)spi + SPI_HOST_RXDATA_REG_OFFSET;
+
+    handle->data = data;
+    handle->length = length;
+    handle->spi = spi;
+
+    // Set up DMA source target
+    handle->tgt_src = (dma_target_t){
+        .ptr = (uint8_t*)fifo_ptr_rx, // Target is SPI RX FIFO
+        .inc_du = 0, // Target is peripheral, no increment
+        .size_du = length>>2, // Size is in data units (words in this case)
+        .type = DMA_DATA_TYPE_WORD, // Data type is word
+    };
+    // The DMA will wait for the SPI HOST/FLASH RX FIFO valid signal
+    handle->tgt_src.trig = spi_dma_slot(0);
+
+    // Set up DMA destination target
+    handle->tgt_dst = (dma_target_t){
+        .ptr = data, // Target is the data buffer
+        .inc_du = 1, // Increment by 1 data unit (word)
+        .type = DMA_DATA_TYPE_WORD, // Data type is word
+        .trig = DMA_TRIG_MEMORY, // Read-write operation to memory
+    };
+
+    // Set up DMA transaction
+    handle->trans = (dma_trans_t){
+        .src = &handle->tgt_src,
+        .dst = &handle->tgt_dst,
+        .end = read_dma_intr ? DMA_TRANS_END_INTR : DMA_TRANS_END_POLLING,
+        .channel = dma_channel,
+    };
+
+    /*
+     * Chunks apart in data: a 2D transaction of count rows of chunk bytes. The D2
+     * increment follows the last word of a row. The FIFO does not move along
+     * D2, which the integrity checks do not accept.
+    */
+    dma_perf_checks_t checks = DMA_PERFORM_CHECKS_INTEGRITY;
+    if (count > 1) {
+        handle->tgt_src.size_du = chunk>>2;
+        handle->tgt_src.size_d2_du = count;
+        handle->tgt_dst.inc_d2_du = (stride>>2) - (chunk>>2) + 1;
+        handle->trans.dim = DMA_DIM_CONF_2D;
+        checks = DMA_PERFORM_CHECKS_ONLY_SANITY;
+    }
+
+    // Less than a word: the bytes are only read from the FIFO
+    if (handle->tgt_src.size_du == 0) return FLASH_OK;
+
+    // Init DMA, the integrated DMA is used (peri == NULL)
+    dma_init(NULL);
+
+    // Validate, load and launch DMA transaction
+    dma_config_flags_t res;
+    res = dma_validate_transaction(&handle->trans, DMA_ENABLE_REALIGN, checks);
+    if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
+    res = dma_load_transaction(&handle->trans);
+    if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
+    res = dma_launch(&handle->trans);
+    if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
+
+    return FLASH_OK;
+}
+
+static uint8_t spi_dma_slot(uint8_t tx) {
+    if (spi == spi_flash) return tx ? DMA_TRIG_SLOT_SPI_FLASH_TX : DMA_TRIG_SLOT_SPI_FLASH_RX;
+    return tx ? DMA_TRIG_SLOT_SPI_TX : DMA_TRIG_SLOT_SPI_RX;
+}
+
+#ifdef CRC_IS_INCLUDED
+static w25q_error_codes_t dma_recv_tocrc(uint32_t length) {
+    // SPI and SPI_FLASH are the same IP so same register map
+    uint32_t *fifo_ptr_rx = (uintptr_t)spi + SPI_HOST_RXDATA_REG_OFFSET;
+
+    // Set up DMA source target
+    dma_target_t tgt_src = {
+        .ptr = (uint8_t*)fifo_ptr_rx, // Target is SPI RX FIFO
+        .inc_du = 0, // Target is peripheral, no increment
+        .size_du = length>>2, // Size is in data units (words in this case)
+        .type = DMA_DATA_TYPE_WORD, // Data type is word
+    };
+    // The DMA will wait for the SPI HOST/FLASH RX FIFO valid signal
+    tgt_src.trig = spi_dma_slot(0);
+
+    // Set up DMA destination target, the DATA window of the CRC
+    dma_target_t tgt_dst;
+    crc_dma_target(&tgt_dst, DMA_DATA_TYPE_WORD);
+
+    // Set up DMA transaction
+    dma_trans_t trans = {
+        .src = &tgt_src,
+        .dst = &tgt_dst,
+        .end = DMA_TRANS_END_POLLING,
+        .channel = dma_channel,
+    };
+
+    // Less than a word: the bytes are only read from the FIFO
+    if (tgt_src.size_du == 0) return FLASH_OK;
+
+    // Init DMA, the integrated DMA is used (peri == NULL)
+    dma_init(NULL);
+
+    // Validate, load and launch DMA transaction, the DATA window does not increment
+    dma_config_flags_t res;
+    res = dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_ONLY_CRITICAL);
+    if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
+    res = dma_load_transaction(&trans);
+    if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
+    res = dma_launch(&trans);
+    if (res != DMA_CONFIG_OK) return FLASH_ERROR_DMA;
+
+    // Wait for DMA to finish transaction
+    while(!dma_is_ready(dma_channel));
+
+    return FLASH_OK;
+}
+
+static uint32_t __attribute__((noinline)) w25q128jw_checksum_crc32(const void *data, uint32_t length, uint32_t checksum) {
+    volatile uint32_t *crc_regs = (volatile uint32_t *)CRC_START_ADDRESS;
+    volatile uint8_t *crc_data = (volatile uint8_t *)CRC_DATA_ADDRESS;
+
+    // CRC-32 as crc_crc32, the peripheral holds the CRC before the final XOR
+    crc_regs[CRC_CTRL_REG_OFFSET >> 2] = (CRC_CTRL_WIDTH_VALUE_32_BITS << CRC_CTRL_WIDTH_BIT)
+                                        | (1 << CRC_CTRL_REFLECT_BIT);
+    crc_regs[CRC_POLY_REG_OFFSET >> 2] = 0x04C11DB7;
+    crc_regs[CRC_CRC_REG_OFFSET >> 2] = ~checksum;
+
+    const uint32_t *data_32bit = (const uint32_t *)data;
+    for (uint32_t i = 0; i < length >> 2; i++) {
+        crc_regs[CRC_DATA_REG_OFFSET >> 2] = data_32bit[i];
+    }
+    // The extra bytes are written one by one
+    const uint8_t *tail = (const uint8_t *)&data_32bit[length >> 2];
+    for (uint32_t i = 0; i < length % 4; i++) {
+        *crc_data = tail[i];
+    }
+
+    return ~crc_regs[CRC_CRC_REG_OFFSET >> 2];
+}
+#endif // CRC_IS_INCLUDED
+
+static void quad_read_cmd(uint32_t addr, uint32_t length) {
+    // A read ahead of the block cache holds the SPI host
+    cache_prefetch_wait();
+
+    // The flash does not accept reads while programming
+    program_complete();
+
+    if (qpi_en && !qpi_on) qpi_enter();
+
+    // In QPI mode with a wrap, Burst Read with Wrap has no mode bits
+    uint8_t wrap_qpi = qpi_on && burst_wrap != 0;
+
+    // In continuous read mode the command is not sent again
+    if (!continuous_read_on) {
+        // Send quad read command, at quad speed in QPI mode
+        uint32_t cmd_read_quadIO = wrap_qpi ? FC_BRW : FC_RDQIO;
+        spi_write_word(spi, cmd_read_quadIO);
+        const uint32_t cmd_read = spi_create_command((spi_command_t){
+            .len        = 0,                 // 1 Byte
+            .csaat      = true,              // Command not finished
+            .speed      = qpi_on ? SPI_SPEED_QUAD : SPI_SPEED_STANDARD,
+            .direction  = SPI_DIR_TX_ONLY      // Write only
+        });
+        spi_set_command(spi, cmd_read);
+        spi_wait_for_ready(spi);
+    }
+
+    /*
+     * Send address at quad speed.
+     * Last byte holds the mode bits required by W25Q128JW: Axh keeps the
+     * flash in continuous read mode, Fxh (here FFh) does not.
+    */
+    uint32_t mode = continuous_read_en && !wrap_qpi ? 0xA0 : 0xFF;
+    uint32_t read_byte_cmd = (REVERT_24b_ADDR(addr) | (mode << 24));
+    spi_write_word(spi, read_byte_cmd);
+    const uint32_t cmd_address = spi_create_command((spi_command_t){
+        .len        = wrap_qpi ? 2 : 3, // 3 Bytes, and the mode bits
+        .csaat      = true,             // Command not finished
+        .speed      = SPI_SPEED_QUAD,    // Quad speed
+        .direction  = SPI_DIR_TX_ONLY     // Write only
+    });
+    spi_set_command(spi, cmd_address);
+    spi_wait_for_ready(spi);
+    continuous_read_on = continuous_read_en && !wrap_qpi;
+
+    // Quad read requires dummy clocks
+    const uint32_t dummy_clocks_cmd = spi_create_command((spi_command_t){
+        #ifndef TARGET_SIM
+        .len        = qpi_on ? DUMMY_CLOCKS_QPI-1 // Set by Set Read Parameters
+                             : DUMMY_CLOCKS_FAST_READ_QUAD_IO-1, // W25Q128JW flash needs 4 dummy cycles
+        #else
+        .len        = DUMMY_CLOCKS_SIM-1, // SPI flash simulation model needs 8 dummy cycles
+        #endif
+        .csaat      = true,              // Command not finished
+        .speed      = SPI_SPEED_QUAD,     // Quad speed
+        .direction  = SPI_DIR_DUMMY       // Dummy
+    });
+    spi_set_command(spi, dummy_clocks_cmd);
+    spi_wait_for_ready(spi);
+
+    // Read back the requested data at quad speed
+    const uint32_t cmd_read_rx = spi_create_command((spi_command_t){
+        .len        = length-1,        // length bytes
+        .csaat      = false,           // End command
+        .speed      = SPI_SPEED_QUAD,   // Quad speed
+        .direction  = SPI_DIR_RX_ONLY    // Read only
+    });
+    spi_set_command(spi, cmd_read_rx);
+    spi_wait_for_ready(spi);
+}
+
+static void read_modes_exit(void) {
+    // A read ahead of the block cache holds the SPI host
+    cache_prefetch_wait();
+
+    if (continuous_read_on) {
+        continuous_read_on = 0;
+
+        /*
+         * Send an address with mode bits FFh, at quad speed, and end the
+         * command: the flash goes back to accepting commands.
+        */
+        spi_write_word(spi, 0xFFFFFFFF);
+        const uint32_t cmd_exit = spi_create_command((spi_command_t){
+            .len        = 3,                // 4 Bytes
+            .csaat      = false,            // End command
+            .speed      = SPI_SPEED_QUAD,    // Quad speed
+            .direction  = SPI_DIR_TX_ONLY     // Write only
+        });
+        spi_set_command(spi, cmd_exit);
+        spi_wait_for_ready(spi);
+    }
+
+    if (qpi_on) {
+        qpi_exit();
+        qpi_on = 0;
+    }
+}
+
+static void qpi_enter(void) {
+    // Enter QPI mode, at standard speed
+    spi_write_word(spi, FC_QPI);
+    const uint32_t cmd_qpi = spi_create_command((spi_command_t){
+        .len        = 0,                 // 1 Byte
+        .csaat      = false,             // End command
+        .speed      = SPI_SPEED_STANDARD, // Single speed
+        .direction  = SPI_DIR_TX_ONLY      // Write only
+    });
+    spi_set_command(spi, cmd_qpi);
+    spi_wait_for_ready(spi);
+    qpi_on = 1;
+
+    /*
+     * Set Read Parameters, at quad speed: P5-P4 select the dummy clocks
+     * (00 = 2, 01 = 4, 10 = 6, 11 = 8), P1-P0 the wrap length of Burst Read
+     * with Wrap (00 = 8 bytes, 01 = 16, 10 = 32, 11 = 64).
+    */
+    uint32_t wrap_bits = burst_wrap ? __builtin_ctz(burst_wrap) - 3 : 0x3;
+    uint32_t params = ((DUMMY_CLOCKS_QPI/2 - 1) << 4) | wrap_bits;
+    spi_write_word(spi, FC_SRP | (params << 8));
+    const uint32_t cmd_params = spi_create_command((spi_command_t){
+        .len        = 1,                // 2 Bytes
+        .csaat      = false,            // End command
+        .speed      = SPI_SPEED_QUAD,    // Quad speed
+        .direction  = SPI_DIR_TX_ONLY     // Write only
+    });
+    spi_set_command(spi, cmd_params);
+    spi_wait_for_ready(spi);
+}
+
+static void qpi_exit(void) {
+    spi_write_word(spi, FC_QPIX);
+    const uint32_t cmd_exit = spi_create_command((spi_command_t){
+        .len        = 0,                // 1 Byte
+        .csaat      = false,            // End command
+        .speed      = SPI_SPEED_QUAD,    // Quad speed
+        .direction  = SPI_DIR_TX_ONLY     // Write only
+    });
+    spi_set_command(spi, cmd_exit);
+    spi_wait_for_ready(spi);
+}
+
 static void flash_write_enable(void) {
+    read_modes_exit();
+    program_complete();
     spi_write_word(spi, FC_WE);
     const uint32_t cmd_write_en = spi_create_command((spi_command_t){
         .len        = 0,
@@ -1428,6 +2573,13 @@ static void flash_write_enable(void) {
     spi_wait_for_ready(spi);
 }
 
+static void flash_cache_invalidate(void) {
+    spi_memio_t spi_memio = { .base_addr = mmio_region_from_addr(SPI_MEMIO_START_ADDRESS) };
+    spi_memio_invalidate_cache(&spi_memio);
+
+    w25q128jw_cache_invalidate();
+}
+
 static w25q_error_codes_t w25q128jw_sanity_checks(uint32_t addr, uint8_t *data, uint32_t length) {
     // Check if address is out of range
     if (addr > MAX_FLASH_ADDR || addr < 0) return FLASH_ERROR;
@@ -1444,6 +2596,98 @@ static w25q_error_codes_t w25q128jw_sanity_checks(uint32_t addr, uint8_t *data,
     return FLASH_OK; // Success
 }
 
+static void w25q128jw_load_quad_dma_crt0_start(uint32_t addr, uint32_t length) {
+    /*
+     * Same sequence as quad_read_cmd, which is not in the first bytes copied
+     * by the boot ROM: at boot the flash is neither programming nor in
+     * continuous read mode.
+    */
+    spi_write_word(spi, FC_RDQIO);
+    spi_set_command(spi, spi_create_command((spi_command_t){
+        .len        = 0,                 // 1 Byte
+        .csaat      = true,              // Command not finished
+        .speed      = SPI_SPEED_STANDARD, // Single speed
+        .direction  = SPI_DIR_TX_ONLY      // Write only
+    }));
+    spi_wait_for_ready(spi);
+    spi_write_word(spi, REVERT_24b_ADDR(addr & 0x00ffffff) | (0xFF << 24));
+    spi_set_command(spi, spi_create_command((spi_command_t){
+        .len        = 3,                // 3 Byte
+        .csaat      = true,             // Command not finished
+        .speed      = SPI_SPEED_QUAD,    // Quad speed
+        .direction  = SPI_DIR_TX_ONLY     // Write only
+    }));
+    spi_wait_for_ready(spi);
+    spi_set_command(spi, spi_create_command((spi_command_t){
+        #ifndef TARGET_SIM
+        .len        = DUMMY_CLOCKS_FAST_READ_QUAD_IO-1, // W25Q128JW flash needs 4 dummy cycles
+        #else
+        .len        = DUMMY_CLOCKS_SIM-1, // SPI flash simulation model needs 8 dummy cycles
+        #endif
+        .csaat      = true,              // Command not finished
+        .speed      = SPI_SPEED_QUAD,     // Quad speed
+        .direction  = SPI_DIR_DUMMY       // Dummy
+    }));
+    spi_wait_for_ready(spi);
+    spi_set_command(spi, spi_create_command((spi_command_t){
+        .len        = length-1,        // length bytes
+        .csaat      = false,           // End command
+        .speed      = SPI_SPEED_QUAD,   // Quad speed
+        .direction  = SPI_DIR_RX_ONLY    // Read only
+    }));
+    spi_wait_for_ready(spi);
+
+    /*
+     * DMA channel 0, programmed through its registers as the driver is not
+     * loaded yet: words from the RX FIFO, paced by its trigger. The SPI host
+     * stalls the flash while its RX FIFO is full, so the callers copy the
+     * transfer in chunks, the CPU working on each chunk while the DMA copies
+     * the next one.
+    */
+    volatile uint32_t *dma_regs = (volatile uint32_t *)DMA_START_ADDRESS;
+    dma_regs[DMA_SRC_DATA_TYPE_REG_OFFSET >> 2] = DMA_SRC_DATA_TYPE_DATA_TYPE_VALUE_DMA_32BIT_WORD;
+    dma_regs[DMA_DST_DATA_TYPE_REG_OFFSET >> 2] = DMA_SRC_DATA_TYPE_DATA_TYPE_VALUE_DMA_32BIT_WORD;
+    dma_regs[DMA_MODE_REG_OFFSET >> 2] = 0;
+    dma_regs[DMA_DIM_CONFIG_REG_OFFSET >> 2] = 0;
+    dma_regs[DMA_WIDE_REG_OFFSET >> 2] = 0;
+    dma_regs[DMA_INTERRUPT_EN_REG_OFFSET >> 2] = 0;
+    #ifndef USE_SPI_FLASH
+    dma_regs[DMA_SLOT_REG_OFFSET >> 2] = DMA_TRIG_SLOT_SPI_RX << DMA_SLOT_RX_TRIGGER_SLOT_OFFSET;
+    #else
+    dma_regs[DMA_SLOT_REG_OFFSET >> 2] = DMA_TRIG_SLOT_SPI_FLASH_RX << DMA_SLOT_RX_TRIGGER_SLOT_OFFSET;
+    #endif
+    dma_regs[DMA_SRC_PTR_INC_D1_REG_OFFSET >> 2] = 0;
+    dma_regs[DMA_DST_PTR_INC_D1_REG_OFFSET >> 2] = 4;
+    dma_regs[DMA_SRC_PTR_REG_OFFSET >> 2] = (uintptr_t)spi + SPI_HOST_RXDATA_REG_OFFSET;
+}
+
+static uint8_t *w25q128jw_load_lz_crt0_chunk(const uint8_t *in, uint8_t *out, uint8_t *end) {
+    const uint8_t *in_end = in + W25Q_LZ_CHUNK_BYTES;
+    while (in_end - in >= 3) {
+        uint32_t token = *in++;
+        uint32_t n = token >> 4;
+        uint32_t b;
+        if (n == 15) {
+            do { b = *in++; n += b; } while (b == 255);
+        }
+        if (n > (uint32_t)(end - out)) return NULL;
+        while (n--) *out++ = *in++;
+
+        uint32_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0) continue; // Literals only
+        n = (token & 15) + 4;
+        if ((token & 15) == 15) {
+            do { b = *in++; n += b; } while (b == 255);
+        }
+        if (n > (uint32_t)(end - out)) return NULL;
+        // Byte by byte, as the match may overlap the data it produces
+        const uint8_t *match = out - offset;
+        while (n--) *out++ = *match++;
+    }
+    return out;
+}
+
 /****************************************************************************/
 /**                                                                        **/
 /*                                 EOF                                      */
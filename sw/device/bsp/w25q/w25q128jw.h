@@ -37,6 +37,7 @@
 #include "spi_host.h"
 #include "soc_ctrl.h"
 #include "core_v_mini_mcu.h"
+#include "dma.h"
 
 /****************************************************************************/
 /**                                                                        **/
@@ -89,8 +90,12 @@
 #define FC_EPR     0x7A /** Erase / Program Resume */
 #define FC_PD      0xB9 /** Power-down */
 #define FC_QPI     0x38 /** Enter QPI mode */
+#define FC_QPIX    0xFF /** Exit QPI mode (in QPI mode) */
+#define FC_SRP     0xC0 /** Set Read Parameters (in QPI mode) */
+#define FC_BRW     0x0C /** Burst Read with Wrap (in QPI mode) */
 #define FC_ERESET  0x66 /** Enable Reset */
 #define FC_RESET   0x99 /** Reset Device */
+#define FC_SBW     0x77 /** Set Burst with Wrap */
 /** @} */
 
 /**
@@ -100,6 +105,7 @@
 #define FLASH_OK    0      /** No error @hideinitializer*/
 #define FLASH_ERROR 1      /** Generic error @hideinitializer*/
 #define FLASH_ERROR_DMA 2  /** DMA error @hideinitializer*/
+#define FLASH_ERROR_VERIFY 3  /** Flash content differs from the data @hideinitializer*/
 /** @} */
 
 /**
@@ -127,6 +133,16 @@
 */
 #define FLASH_SECTOR_SIZE 4096
 
+/**
+ * @brief Dimension of a small flash block, in bytes.
+*/
+#define FLASH_BLOCK32_SIZE (32*1024)
+
+/**
+ * @brief Dimension of a large flash block, in bytes.
+*/
+#define FLASH_BLOCK64_SIZE (64*1024)
+
 /**
  * @brief Number of dummy clocks cycles required by the simulation model.
 */
@@ -138,11 +154,62 @@
 */
 #define DUMMY_CLOCKS_FAST_READ_QUAD_IO 4
 
+/**
+ * @brief Number of dummy clocks cycles set by Set Read Parameters for the
+ * reads in QPI mode, the setting of the highest clock frequency.
+*/
+#define DUMMY_CLOCKS_QPI 8
+
+/**
+ * @brief Read mode selected by w25q128jw_init, see w25q_read_mode_t.
+*/
+#ifndef W25Q_READ_MODE_INIT
+#define W25Q_READ_MODE_INIT W25Q_READ_MODE_QUAD_IO
+#endif
+
+/**
+ * @brief Words of a DMA transaction of w25q128jw_load_quad_dma_crt0, which
+ * checksums each chunk while the DMA copies the next one.
+*/
+#define W25Q_LOAD_CHUNK_WORDS 256
+
+/**
+ * @brief Magic word of a compressed flash_load image (see w25q_lz_header_t).
+*/
+#define W25Q_LZ_MAGIC 0x5a4c5848
+
+/**
+ * @brief Bytes of a chunk of a compressed section, read by the DMA into one
+ * of the two buffers of w25q128jw_load_lz_crt0 while the CPU decodes the
+ * other one. Must be the --chunk of util/flash_lz.py.
+*/
+#define W25Q_LZ_CHUNK_BYTES 512
+
+/**
+ * @brief Most sections of a compressed image.
+*/
+#define W25Q_LZ_MAX_SECTIONS 16
+
+/**
+ * @brief BUSY bit of the Status Register 1.
+*/
+#define FLASH_SR1_BUSY 0x01
+
+/**
+ * @brief Erase/Program Suspend Status bit of the Status Register 2.
+*/
+#define FLASH_SR2_SUS 0x80
+
 /**
  * @brief Upper bound for the flash address.
 */
 #define MAX_FLASH_ADDR 0x00ffffff
 
+/**
+ * @brief Tag of an empty line of the block cache, above any flash address.
+*/
+#define W25Q_CACHE_EMPTY 0xffffffff
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -158,6 +225,127 @@ extern "C" {
 */
 typedef uint8_t w25q_error_codes_t;
 
+/**
+ * @brief Lines of the commands of the quad reads.
+*/
+typedef enum {
+    W25Q_READ_MODE_QUAD_IO = 0, /** Command on one line, address and data on four */
+    W25Q_READ_MODE_QPI     = 1, /** Command, address and data on four lines */
+} w25q_read_mode_t;
+
+/**
+ * @brief State of an asynchronous erase.
+*/
+typedef enum {
+    W25Q_ERASE_IDLE      = 0, /** No erase, or the last one has finished */
+    W25Q_ERASE_BUSY      = 1, /** The flash is erasing */
+    W25Q_ERASE_SUSPENDED = 2, /** The erase is suspended, reads are allowed */
+} w25q_erase_state_t;
+
+/**
+ * @brief Handle of a DMA read that has been started but may not be finished.
+ *
+ * It holds the DMA transaction, so it must stay allocated until
+ * w25q128jw_read_dma_wait returns. The fields are private.
+*/
+typedef struct {
+    uint8_t *data;        /** Destination buffer */
+    uint32_t length;      /** Number of bytes to read */
+    dma_target_t tgt_src; /** SPI RX FIFO */
+    dma_target_t tgt_dst; /** Destination buffer */
+    dma_trans_t trans;    /** DMA transaction */
+    spi_host_t *spi;      /** SPI host of the flash */
+} w25q128jw_read_handle_t;
+
+/**
+ * @brief Flash selected with w25q128jw_select, when more than one is
+ * connected.
+ *
+ * Two flashes read at the same time must be on different SPI hosts with a
+ * DMA trigger (spi_flash and spi_host1) and use different DMA channels.
+*/
+typedef struct {
+    spi_host_t *spi;     /** SPI host of the flash */
+    uint8_t csid;        /** Chip select of the flash on the host */
+    uint8_t dma_channel; /** DMA channel of the reads and writes */
+} w25q128jw_flash_t;
+
+/**
+ * @brief Sequential prefetcher, reading a flash area chunk by chunk into
+ * two buffers. While the application processes a chunk, the next one is
+ * read by the DMA. The fields are private.
+*/
+typedef struct {
+    w25q128jw_read_handle_t read; /** Read in flight */
+    uint8_t *buf[2];              /** Buffers filled in turn */
+    uint32_t chunk;               /** Bytes per chunk */
+    uint32_t addr;                /** Flash address of the next chunk to read */
+    uint32_t end;                 /** Flash address after the area */
+    uint8_t idx;                  /** Buffer of the read in flight */
+    uint8_t busy;                 /** 1 if a read is in flight */
+} w25q128jw_prefetch_t;
+
+/**
+ * @brief Line of the block cache. The fields are private.
+*/
+typedef struct {
+    uint32_t tag;  /** Flash address of the block, W25Q_CACHE_EMPTY if none */
+    uint32_t used; /** Access count of the last use, for the LRU replacement */
+} w25q_cache_line_t;
+
+/**
+ * @brief Statistics of the block cache.
+*/
+typedef struct {
+    uint32_t hits;       /** Blocks read from the cache */
+    uint32_t misses;     /** Blocks read from the flash */
+    uint32_t prefetches; /** Blocks read ahead of a sequential access */
+} w25q_cache_stats_t;
+
+/**
+ * @brief Block cache of w25q128jw_read, see w25q128jw_cache_enable.
+ * The fields are private.
+*/
+typedef struct {
+    uint8_t *blocks;              /** count blocks of block_size bytes */
+    w25q_cache_line_t *lines;     /** count lines */
+    uint32_t block_size;          /** Bytes per block */
+    uint32_t count;               /** Number of blocks */
+    uint32_t clock;               /** Access count */
+    uint32_t last;                /** Flash address of the last block accessed */
+    int32_t prefetch;             /** Line of the read in flight, -1 if none */
+    w25q128jw_read_handle_t read; /** Read in flight */
+    w25q_cache_stats_t stats;     /** Statistics */
+} w25q128jw_cache_t;
+
+/**
+ * @brief Section of a compressed flash_load image.
+*/
+typedef struct {
+    uint32_t addr;     /** Flash address of the compressed data */
+    uint32_t dst;      /** RAM address of the section */
+    uint32_t length;   /** Bytes of the section */
+    uint32_t packed;   /** Bytes of the compressed data, whole chunks */
+    uint32_t checksum; /** w25q128jw_boot_checksum() once the section is loaded */
+} w25q_lz_section_t;
+
+/**
+ * @brief Header of a compressed flash_load image, written by
+ * util/flash_lz.py in the chunk after the bytes copied by the boot ROM.
+ *
+ * The compressed data of a section is a list of LZ4 sequences, each one a
+ * token (literal count in the high nibble, match length - 4 in the low one),
+ * the extra bytes of the literal count, the literals, a 16-bit little-endian
+ * match offset and the extra bytes of the match length. An offset of 0 means
+ * that the sequence has no match. A sequence never crosses the end of a chunk
+ * of W25Q_LZ_CHUNK_BYTES, the rest of the chunk being zeros.
+*/
+typedef struct {
+    uint32_t magic;                 /** W25Q_LZ_MAGIC */
+    uint32_t count;                 /** Number of sections */
+    w25q_lz_section_t section[];    /** Sections, in the order of their loading */
+} w25q_lz_header_t;
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          EXPORTED VARIABLES                            **/
@@ -186,8 +374,9 @@ void w25q128jw_init_crt0();
  *
  * @param spi_host SPI host to use.
  *
- * @note The flash uses CSID 0. If the CSID register value is changed, it must be
- * restored back to 0 before using the flash again.
+ * @note The flash uses CSID 0, or the one selected with w25q128jw_select. If
+ * the CSID register value is changed, it must be restored before using the
+ * flash again.
  *
  * @return FLASH_OK if the flash is correctly initialized, @ref error_codes otherwise.
 */
@@ -214,6 +403,10 @@ w25q_error_codes_t w25q128jw_read(uint32_t addr, void* data, uint32_t length);
  * If erase_before_write is set, the function will take care of erasing
  * the correct sectors before writing. All the bytes not written will be
  * copied back in their current state before the write operation.
+ * The erase is skipped for the sectors where the data only clears bits,
+ * and only the pages that change are programmed.
+ * The function returns while the last page may still be programming: the
+ * next call to the BSP waits for it.
  *
  * @param addr 24-bit flash address to read from.
  * @param data pointer to the data buffer.
@@ -234,6 +427,94 @@ w25q_error_codes_t w25q128jw_write(uint32_t addr, void* data, uint32_t length, u
 */
 w25q_error_codes_t w25q128jw_read_standard(uint32_t addr, void* data, uint32_t length);
 
+/**
+ * @brief Read from flash at quad speed with the DMA, for the crt0 flash_load.
+ *
+ * Loads the sections when the program is linked with FLASH_LOAD_DMA=1. It
+ * programs the DMA through its registers, since the DMA driver is not in the
+ * first bytes copied by the boot ROM, and adds the data to the checksum of
+ * w25q128jw_boot_checksum() while the DMA copies it.
+ *
+ * @param addr 24-bit flash address to read from.
+ * @param data pointer to the data buffer to be filled, word aligned.
+ * @param length number of bytes to read.
+ * @retval FLASH_OK if the read is successful, @ref error_codes otherwise.
+ *
+ * @note The flash must accept Quad I/O commands: the QE bit is set by
+ * w25q128jw_init, in a non-volatile register.
+*/
+w25q_error_codes_t w25q128jw_load_quad_dma_crt0(uint32_t addr, void *data, uint32_t length);
+
+/**
+ * @brief Load a compressed image from flash, for the crt0 flash_load.
+ *
+ * Loads the sections when the program is linked with FLASH_LOAD_LZ=1. Each
+ * section is read at quad speed by the DMA, chunk by chunk into two buffers,
+ * and the CPU decompresses a chunk into the RAM bank of the section while
+ * the next one is read. The decompressed sections are checked against the
+ * checksums of the image, and w25q128jw_boot_checksum() is the checksum of
+ * the decompressed sections, as with w25q128jw_load_quad_dma_crt0.
+ *
+ * @param addr 24-bit flash address of the w25q_lz_header_t.
+ * @param stage 2 * W25Q_LZ_CHUNK_BYTES bytes of free RAM, word aligned.
+ * @retval FLASH_OK if the sections are loaded and their checksums match,
+ * @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_load_lz_crt0(uint32_t addr, void *stage);
+
+/**
+ * @brief Checksum of a buffer, as computed while loading from flash.
+ *
+ * A word rotation and addition, the last bytes counting as a word padded
+ * with zeros. When the CRC peripheral is included (CRC_IS_INCLUDED), the
+ * CRC-32 of zlib computed by the peripheral instead, with the same chaining.
+ * Computing it over data read back from the flash checks the loaded program
+ * against the flash.
+ *
+ * @param data pointer to the data, word aligned.
+ * @param length number of bytes.
+ * @param checksum checksum of the previous data, 0 for the first.
+ * @retval The checksum of the previous data and of data.
+*/
+uint32_t w25q128jw_checksum(const void *data, uint32_t length, uint32_t checksum);
+
+/**
+ * @brief Checksum of all the sections loaded by the crt0 with
+ * w25q128jw_load_quad_dma_crt0, in the order of their loading.
+ *
+ * @retval The checksum, 0 if nothing was loaded.
+*/
+uint32_t w25q128jw_boot_checksum(void);
+
+/**
+ * @brief CRC-32 (crc_crc32 of crc.h) of an area of the flash.
+ *
+ * With the CRC peripheral, the data is read at quad speed and copied by the
+ * DMA from the SPI RX FIFO into the peripheral, without going through RAM.
+ * Without it, the data is read sector by sector and the CPU computes the
+ * CRC with crc_compute_sw.
+ *
+ * @param addr 24-bit flash address.
+ * @param length number of bytes.
+ * @param crc set to the CRC-32 of the area.
+ * @retval FLASH_OK if successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_crc32(uint32_t addr, uint32_t length, uint32_t *crc);
+
+/**
+ * @brief Enable or disable the verification of w25q128jw_read and
+ * w25q128jw_write.
+ *
+ * When enabled, they read the flash back once done and compare it with the
+ * data, and return FLASH_ERROR_VERIFY if they differ. With the CRC
+ * peripheral, the CRC-32 of the flash (w25q128jw_crc32) is compared with the
+ * one of the data, both streamed by the DMA, so the check costs a second
+ * read of the flash but no RAM and little CPU time.
+ *
+ * @param enable 1 to enable, 0 to disable.
+*/
+void w25q128jw_set_verify(uint8_t enable);
+
 
 /**
  * @brief Write to flash at standard speed. Use this function only to write to unitialized data
@@ -349,6 +630,239 @@ w25q_error_codes_t w25q128jw_write_quad_dma(uint32_t addr, void* data, uint32_t
 */
 w25q_error_codes_t w25q128jw_erase_and_write_quad_dma(uint32_t addr, void* data, uint32_t length);
 
+/**
+ * @brief Start a read from flash at standard speed using DMA, without
+ * waiting for it to finish.
+ *
+ * The DMA copies the data while the CPU goes on. No other flash operation
+ * can be issued until w25q128jw_read_dma_wait has returned.
+ *
+ * @param handle handle of the read, to keep until the read is finished.
+ * @param addr 24-bit flash address to read from.
+ * @param data pointer to the data buffer, word aligned.
+ * @param length number of bytes to read.
+ * @return FLASH_OK if the read is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_read_standard_dma_async(w25q128jw_read_handle_t *handle, uint32_t addr, void* data, uint32_t length);
+
+/**
+ * @brief Start a read from flash at quad speed using DMA, without waiting
+ * for it to finish.
+ *
+ * The DMA copies the data while the CPU goes on. No other flash operation
+ * can be issued until w25q128jw_read_dma_wait has returned.
+ *
+ * @param handle handle of the read, to keep until the read is finished.
+ * @param addr 24-bit flash address to read from.
+ * @param data pointer to the data buffer, word aligned.
+ * @param length number of bytes to read.
+ * @return FLASH_OK if the read is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_read_quad_dma_async(w25q128jw_read_handle_t *handle, uint32_t addr, void* data, uint32_t length);
+
+/**
+ * @brief Check if the DMA of a started read has finished.
+ *
+ * @param handle handle of the read.
+ * @return 1 if the DMA has finished, 0 otherwise. The read still has to be
+ * completed with w25q128jw_read_dma_wait.
+*/
+uint8_t w25q128jw_read_dma_done(const w25q128jw_read_handle_t *handle);
+
+/**
+ * @brief Start a read from flash at quad speed using DMA, spreading the data
+ * in chunks, without waiting for it to finish.
+ *
+ * count * chunk consecutive bytes of the flash are read; chunk i is written
+ * at data + i * stride. The DMA copies the data as a 2D transaction while the
+ * CPU goes on, as with w25q128jw_read_quad_dma_async.
+ *
+ * @param handle handle of the read, to keep until the read is finished.
+ * @param addr 24-bit flash address to read from.
+ * @param data pointer to the first chunk, word aligned.
+ * @param chunk number of bytes per chunk, a multiple of 4 if count > 1.
+ * @param count number of chunks.
+ * @param stride bytes between the start of two chunks, a multiple of 4 not
+ * smaller than chunk.
+ * @return FLASH_OK if the read is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_read_quad_dma_strided_async(w25q128jw_read_handle_t *handle, uint32_t addr, void *data,
+                                                        uint32_t chunk, uint32_t count, uint32_t stride);
+
+/**
+ * @brief Select the flash used by the following operations.
+ *
+ * The flash in use is left ready for commands: its continuous read and QPI
+ * modes are exited and a pending page program is completed. The selected
+ * flash must then be initialized once with w25q128jw_init, and the reads of
+ * the block cache and the prefetcher must be finished.
+ *
+ * By default the flash is on CSID 0 of the host given to w25q128jw_init and
+ * uses DMA channel 0.
+ *
+ * @param flash flash to select.
+*/
+void w25q128jw_select(const w25q128jw_flash_t *flash);
+
+/**
+ * @brief Wait for a started read to finish.
+ *
+ * It also copies the last bytes of the read if the length is not a multiple
+ * of 4, as the DMA only copies full words.
+ *
+ * @param handle handle of the read.
+ * @return FLASH_OK if the read is successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_read_dma_wait(w25q128jw_read_handle_t *handle);
+
+/**
+ * @brief End the DMA transactions of the DMA reads with an interrupt.
+ *
+ * By default the transactions are polled by w25q128jw_read_dma_done. With
+ * the interrupt, the end of the transaction of each DMA read also completes
+ * ASYNC_SOURCE_DMA of the channel of the flash (async.h), so that the reader can sleep until then,
+ * e.g. a task of FreeRTOS (sw/freertos/rtos_io.h). The fast interrupt of the
+ * DMA must be enabled.
+ *
+ * @param enable 1 to enable, 0 to disable.
+*/
+void w25q128jw_set_read_dma_intr(uint8_t enable);
+
+/**
+ * @brief Start reading a flash area sequentially, chunk by chunk.
+ *
+ * The first chunk is read into buf0 at quad speed using DMA; the following
+ * ones are read by w25q128jw_prefetch_next. No other flash operation can be
+ * issued until the area has been consumed or w25q128jw_prefetch_stop is called.
+ *
+ * @param prefetch prefetcher state.
+ * @param addr 24-bit flash address of the area.
+ * @param length number of bytes of the area.
+ * @param buf0 first buffer of chunk bytes, word aligned.
+ * @param buf1 second buffer of chunk bytes, word aligned.
+ * @param chunk number of bytes per chunk, multiple of 4.
+ * @return FLASH_OK if the first read is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_prefetch_start(w25q128jw_prefetch_t *prefetch, uint32_t addr, uint32_t length,
+                                            void *buf0, void *buf1, uint32_t chunk);
+
+/**
+ * @brief Get the next chunk of the area.
+ *
+ * It waits for the chunk in flight, starts reading the following one into
+ * the other buffer and returns. The returned buffer stays valid until the
+ * next call.
+ *
+ * @param prefetch prefetcher state.
+ * @param length set to the number of bytes of the chunk.
+ * @return pointer to the chunk, or NULL if the whole area has been returned.
+*/
+void *w25q128jw_prefetch_next(w25q128jw_prefetch_t *prefetch, uint32_t *length);
+
+/**
+ * @brief Stop a prefetcher before the end of the area, waiting for the read
+ * in flight.
+ *
+ * @param prefetch prefetcher state.
+*/
+void w25q128jw_prefetch_stop(w25q128jw_prefetch_t *prefetch);
+
+/**
+ * @brief Enable the block cache of w25q128jw_read.
+ *
+ * The reads of at most block_size bytes go through a cache of count blocks
+ * in RAM, so that small reads at scattered addresses only pay the command,
+ * address and dummy overhead once per block. A missing block is read
+ * whole, in place of the least recently used one. When a block follows the
+ * one accessed before, the next block is read ahead by the DMA (channel 0)
+ * while the CPU goes on. Longer reads bypass the cache. The programs and
+ * erases of the BSP invalidate it.
+ *
+ * @param cache cache state, to keep until w25q128jw_cache_disable.
+ * @param blocks count * block_size bytes, word aligned.
+ * @param lines count lines.
+ * @param block_size bytes per block, a power of 2 of at least 4.
+ * @param count number of blocks, at least 1.
+ * @return FLASH_OK if the cache is enabled, FLASH_ERROR if the arguments are
+ * invalid.
+*/
+w25q_error_codes_t w25q128jw_cache_enable(w25q128jw_cache_t *cache, void *blocks, w25q_cache_line_t *lines,
+                                          uint32_t block_size, uint32_t count);
+
+/**
+ * @brief Disable the block cache, waiting for the read ahead in flight.
+*/
+void w25q128jw_cache_disable(void);
+
+/**
+ * @brief Invalidate the block cache, e.g. after the flash was changed
+ * without the BSP.
+*/
+void w25q128jw_cache_invalidate(void);
+
+/**
+ * @brief Get the statistics of the block cache.
+ *
+ * @param stats set to the statistics since the cache was enabled or its
+ * statistics reset, zeros if it is disabled.
+*/
+void w25q128jw_cache_get_stats(w25q_cache_stats_t *stats);
+
+/**
+ * @brief Reset the statistics of the block cache.
+*/
+void w25q128jw_cache_reset_stats(void);
+
+/**
+ * @brief Enable or disable the continuous read mode of the quad reads.
+ *
+ * When enabled, the quad reads leave the flash in continuous read mode
+ * (M7-M0 = A0h), so the following quad read only sends the address and
+ * the dummy clocks, without the command byte. This saves the command
+ * overhead of small random reads. Any other operation of the BSP takes
+ * the flash out of this mode first.
+ *
+ * @param enable 1 to enable, 0 to disable.
+*/
+void w25q128jw_set_continuous_read(uint8_t enable);
+
+/**
+ * @brief Set Burst with Wrap.
+ *
+ * Once set, the quad reads wrap around inside the aligned section of
+ * wrap_length bytes holding the start address: a read of wrap_length bytes
+ * from any address returns a full section, starting from the requested
+ * word. Reads longer than wrap_length are wrapped too.
+ *
+ * @param wrap_length 8, 16, 32 or 64 bytes, or 0 to disable the wrap.
+ * @return FLASH_OK if the wrap is set, FLASH_ERROR if the length is invalid.
+ *
+ * @note The memory-mapped flash (spimemio) streams consecutive words over
+ * the section boundaries, so the wrap must be disabled before enabling it.
+*/
+w25q_error_codes_t w25q128jw_set_burst_wrap(uint32_t wrap_length);
+
+/**
+ * @brief Select the read mode of the quad reads.
+ *
+ * In QPI mode the command byte is also sent on four lines, in 2 clock
+ * cycles instead of 8, and the dummy clocks are set by Set Read Parameters.
+ * The flash enters QPI mode at the first quad read, and stays in it until
+ * an operation that is not a quad read takes it out, as the continuous
+ * read mode. With a Burst with Wrap, the QPI reads use Burst Read with
+ * Wrap (0Ch), without continuous read mode. w25q128jw_init selects
+ * W25Q_READ_MODE_INIT.
+ *
+ * @param mode W25Q_READ_MODE_QUAD_IO or W25Q_READ_MODE_QPI.
+ * @return FLASH_OK if the mode is set, FLASH_ERROR if it is invalid.
+ *
+ * @note The boot ROM and the memory-mapped flash (spimemio) send their
+ * commands on one line, so the flash must be out of QPI mode when they use
+ * it: w25q128jw_power_down and w25q128jw_reset take it out, and
+ * w25q128jw_init takes it out if a reset of the MCU left it in.
+*/
+w25q_error_codes_t w25q128jw_set_read_mode(w25q_read_mode_t mode);
+
 /**
  * @brief Erase a 4kb sector.
  *
@@ -388,6 +902,103 @@ w25q_error_codes_t w25q128jw_64k_erase(uint32_t addr);
 void w25q128jw_chip_erase(void);
 
 
+/**
+ * @brief Start erasing a 4kb sector, without waiting for the erase to finish.
+ *
+ * The erase is then followed with w25q128jw_erase_poll, e.g. from a timer
+ * interrupt:
+ *
+ *     void fic_irq_timer_1(void) {
+ *         rv_timer_irq_clear(&timer, 0, 0);
+ *         w25q128jw_erase_poll();
+ *     }
+ *
+ * While the flash is erasing, the only functions of the BSP that can be
+ * called are w25q128jw_erase_poll and w25q128jw_erase_suspend: the other
+ * ones wait for the erase to finish, and they must not be interrupted by
+ * a poll.
+ *
+ * @param addr 24-bit address of the sector to erase.
+ * @return FLASH_OK if the erase is started, FLASH_ERROR if the address is
+ * invalid or another asynchronous erase is not finished.
+*/
+w25q_error_codes_t w25q128jw_4k_erase_async(uint32_t addr);
+
+/**
+ * @brief Start erasing a 32kb block, without waiting for the erase to finish.
+ * See w25q128jw_4k_erase_async.
+ *
+ * @param addr 24-bit address of the block to erase.
+ * @return FLASH_OK if the erase is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_32k_erase_async(uint32_t addr);
+
+/**
+ * @brief Start erasing a 64kb block, without waiting for the erase to finish.
+ * See w25q128jw_4k_erase_async.
+ *
+ * @param addr 24-bit address of the block to erase.
+ * @return FLASH_OK if the erase is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_64k_erase_async(uint32_t addr);
+
+/**
+ * @brief Start erasing the entire chip, without waiting for the erase to
+ * finish. See w25q128jw_4k_erase_async.
+ *
+ * @return FLASH_OK if the erase is started, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q128jw_chip_erase_async(void);
+
+/**
+ * @brief Check if the asynchronous erase has finished.
+ *
+ * The status register is read once, only while the flash is erasing. When
+ * the erase is found finished, the read cache of the memory-mapped flash is
+ * invalidated and w25q128jw_erase_done_handler is called.
+ *
+ * @return the state of the erase.
+*/
+w25q_erase_state_t w25q128jw_erase_poll(void);
+
+/**
+ * @brief Suspend the asynchronous erase (Erase/Program Suspend, 75h).
+ *
+ * It waits for the flash to be suspended (20us at most). Then the flash can
+ * be read, except in the sector or block being erased, until
+ * w25q128jw_erase_resume is called. If the erase finished before being
+ * suspended, the state goes back to W25Q_ERASE_IDLE.
+ *
+ * @return FLASH_OK if successful, FLASH_ERROR if the flash is not erasing.
+*/
+w25q_error_codes_t w25q128jw_erase_suspend(void);
+
+/**
+ * @brief Resume a suspended erase (Erase/Program Resume, 7Ah).
+ *
+ * @return FLASH_OK if successful, FLASH_ERROR if no erase is suspended.
+*/
+w25q_error_codes_t w25q128jw_erase_resume(void);
+
+/**
+ * @brief Called when an asynchronous erase is found finished.
+ *
+ * This is a weak implementation, the application can provide its own.
+ * It may be called from the interrupt polling the erase.
+*/
+void w25q128jw_erase_done_handler(void);
+
+/**
+ * @brief Called at each read of the status register while the BSP waits for
+ * the flash to finish a program or an erase. With the interrupts enabled, the
+ * core sleeps during each read, until the SPI host receives the status.
+ *
+ * This is a weak implementation that returns at once, the application can
+ * provide its own, e.g. to let other tasks run (sw/freertos/rtos_io.c). It
+ * must not use the flash.
+*/
+void w25q128jw_busy_handler(void);
+
 /**
  * @brief Reset the flash.
  *
@@ -416,6 +1027,16 @@ void w25q128jw_reset_force(void);
 */
 void w25q128jw_power_down(void);
 
+/**
+ * @brief Reprogram the SPI clock divider of the flash for the current
+ * SYSTEM_FREQUENCY_HZ of soc_ctrl.
+ *
+ * The divider is computed at w25q128jw_init, so it must be called after a
+ * change of the system clock (see clk_scale.h), with no flash operation
+ * running, between w25q128jw_init and w25q128jw_power_down.
+*/
+void w25q128jw_update_clock(void);
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          INLINE FUNCTIONS                              **/
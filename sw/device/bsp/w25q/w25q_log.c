@@ -0,0 +1,385 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *****************************
+**                            *******************
+**
+** project  : X-HEEP
+** filename : w25q_log.c
+** version  : 1
+** date     : 14/10/2024
+**
+***************************************************************************
+**
+** Copyright (c) EPFL contributors.
+** All rights reserved.
+**
+***************************************************************************
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+/**
+* @file   w25q_log.c
+* @date   14/10/2024
+* @brief  Append-only log of records stored in the W25Q128JW flash.
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+#include "string.h"
+
+#include "w25q_log.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        DEFINITIONS AND MACROS                            */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Bytes taken by a record in the flash: header, data and padding up
+ * to a word, so that all the headers are word aligned.
+*/
+#define LOG_RECORD_SIZE(length) ((W25Q_LOG_HEADER_SIZE + (length) + 3) & ~3u)
+
+/**
+ * @brief Result of the parsing of a header.
+*/
+#define LOG_HDR_ERASED  0 /** Never programmed: end of the records of the page */
+#define LOG_HDR_VALID   1 /** Header and data are consistent */
+#define LOG_HDR_INVALID 2 /** Torn by a power loss */
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       TYPEDEFS AND STRUCTURES                            */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Header programmed before each record.
+*/
+typedef struct {
+    uint16_t length; /** Number of bytes of the record */
+    uint16_t check;  /** Fletcher-16 of length, seq and the record */
+    uint32_t seq;    /** Sequence number */
+} log_header_t;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Compute the check of a record.
+ *
+ * @param hdr header of the record, the check field is not used.
+ * @param data record.
+ * @return seeded Fletcher-16 of the length, the sequence number and the record.
+*/
+static uint16_t log_check(const log_header_t *hdr, const uint8_t *data);
+
+/**
+ * @brief Parse the header at an offset of a page read from the flash.
+ *
+ * @param page content of the page.
+ * @param offset word aligned offset of the header in the page.
+ * @param hdr set to the header.
+ * @return LOG_HDR_ERASED, LOG_HDR_VALID or LOG_HDR_INVALID.
+*/
+static uint8_t log_parse(const uint8_t *page, uint32_t offset, log_header_t *hdr);
+
+/**
+ * @brief Erase a sector of the log and drop its records from the index.
+ *
+ * @param log log state.
+ * @param sector sector of the ring.
+ * @return FLASH_OK if successful, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t log_erase_sector(w25q_log_t *log, uint32_t sector);
+
+/**
+ * @brief Move the head of the log forward.
+ *
+ * When the head enters a new sector, an erased sector ahead is used if any.
+ *
+ * @param log log state.
+ * @param bytes number of bytes, not crossing a sector boundary.
+*/
+static void log_advance(w25q_log_t *log, uint32_t bytes);
+
+/**
+ * @brief Check the parameters shared by w25q_log_format and w25q_log_mount
+ * and initialize the state.
+*/
+static w25q_error_codes_t log_init(w25q_log_t *log, uint32_t base, uint32_t sectors, uint32_t *index);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            GLOBAL VARIABLES                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Page buffer used to build the records and to parse the flash.
+ *
+ * Word aligned, so that it can be used by the DMA reads and writes.
+*/
+static uint32_t log_page[FLASH_PAGE_SIZE / 4];
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           EXPORTED FUNCTIONS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+w25q_error_codes_t w25q_log_format(w25q_log_t *log, uint32_t base, uint32_t sectors, uint32_t *index) {
+    if (log_init(log, base, sectors, index) != FLASH_OK) return FLASH_ERROR;
+
+    for (uint32_t s = 0; s < sectors; s++) {
+        if (log_erase_sector(log, s) != FLASH_OK) return FLASH_ERROR;
+    }
+
+    // All the sectors are erased, the head one included
+    log->head_ready = 1;
+    log->erased = sectors - 1;
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q_log_mount(w25q_log_t *log, uint32_t base, uint32_t sectors, uint32_t *index) {
+    if (log_init(log, base, sectors, index) != FLASH_OK) return FLASH_ERROR;
+
+    uint8_t *page = (uint8_t *)log_page;
+    log_header_t hdr;
+
+    // Build the index from the first record of each sector
+    uint32_t head_sector = 0;
+    uint8_t found = 0;
+    for (uint32_t s = 0; s < sectors; s++) {
+        if (w25q128jw_read(base + s * FLASH_SECTOR_SIZE, page, FLASH_PAGE_SIZE) != FLASH_OK) return FLASH_ERROR;
+        if (log_parse(page, 0, &hdr) == LOG_HDR_VALID) {
+            index[s] = hdr.seq;
+            if (!found || hdr.seq > index[head_sector]) head_sector = s;
+            found = 1;
+        }
+    }
+
+    // Empty log: the first sector is erased before the first append
+    if (!found) return FLASH_OK;
+
+    // Scan the newest sector to find the end of the log
+    uint32_t end = 0;
+    uint32_t last_seq = index[head_sector];
+    for (uint32_t p = 0; p < FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE; p++) {
+        if (w25q128jw_read(base + head_sector * FLASH_SECTOR_SIZE + p * FLASH_PAGE_SIZE,
+                           page, FLASH_PAGE_SIZE) != FLASH_OK) return FLASH_ERROR;
+
+        uint32_t offset = 0;
+        uint8_t res = LOG_HDR_VALID;
+        while (offset + W25Q_LOG_HEADER_SIZE <= FLASH_PAGE_SIZE) {
+            res = log_parse(page, offset, &hdr);
+            if (res != LOG_HDR_VALID) break;
+            last_seq = hdr.seq;
+            offset += LOG_RECORD_SIZE(hdr.length);
+        }
+
+        // A blank page: the previous one was the last
+        if (offset == 0 && res == LOG_HDR_ERASED) break;
+
+        // A torn record ends its page
+        if (res == LOG_HDR_INVALID) offset = FLASH_PAGE_SIZE;
+
+        // The rest of the page may be too short for the next record, go on
+        end = p * FLASH_PAGE_SIZE + offset;
+    }
+
+    log->head = head_sector * FLASH_SECTOR_SIZE;
+    log->next_seq = last_seq + 1;
+    log->head_ready = 1;
+    log_advance(log, end);
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q_log_append(w25q_log_t *log, const void *data, uint32_t length, uint32_t *seq) {
+    if (length > W25Q_LOG_MAX_RECORD || (data == NULL && length != 0)) return FLASH_ERROR;
+
+    uint32_t size = LOG_RECORD_SIZE(length);
+
+    // Records do not cross pages
+    uint32_t page_offset = log->head % FLASH_PAGE_SIZE;
+    if (page_offset + size > FLASH_PAGE_SIZE) {
+        log_advance(log, FLASH_PAGE_SIZE - page_offset);
+    }
+
+    // The head sector has not been erased ahead
+    if (!log->head_ready) {
+        if (log_erase_sector(log, log->head / FLASH_SECTOR_SIZE) != FLASH_OK) return FLASH_ERROR;
+        log->head_ready = 1;
+    }
+
+    // Build the record, padded with the erased value
+    uint8_t *page = (uint8_t *)log_page;
+    log_header_t hdr = {
+        .length = (uint16_t)length,
+        .seq = log->next_seq,
+    };
+    hdr.check = log_check(&hdr, data);
+    memcpy(page, &hdr, W25Q_LOG_HEADER_SIZE);
+    if (length != 0) memcpy(&page[W25Q_LOG_HEADER_SIZE], data, length);
+    memset(&page[W25Q_LOG_HEADER_SIZE + length], 0xFF, size - W25Q_LOG_HEADER_SIZE - length);
+
+    // A single page program, on bytes that are still erased
+    if (w25q128jw_write(log->base + log->head, page, size, 0) != FLASH_OK) return FLASH_ERROR;
+
+    uint32_t sector = log->head / FLASH_SECTOR_SIZE;
+    if (log->index[sector] == W25Q_LOG_EMPTY) log->index[sector] = hdr.seq;
+
+    if (seq != NULL) *seq = hdr.seq;
+    log->next_seq++;
+    log_advance(log, size);
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q_log_read(w25q_log_t *log, uint32_t seq, void *data, uint32_t max_length, uint32_t *length) {
+    if (seq >= log->next_seq) return FLASH_ERROR;
+
+    // Sector whose first record is the closest before seq
+    uint32_t sector = log->sectors;
+    for (uint32_t s = 0; s < log->sectors; s++) {
+        if (log->index[s] != W25Q_LOG_EMPTY && log->index[s] <= seq
+            && (sector == log->sectors || log->index[s] > log->index[sector])) {
+            sector = s;
+        }
+    }
+    if (sector == log->sectors) return FLASH_ERROR;
+
+    uint8_t *page = (uint8_t *)log_page;
+    log_header_t hdr;
+    for (uint32_t p = 0; p < FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE; p++) {
+        if (w25q128jw_read(log->base + sector * FLASH_SECTOR_SIZE + p * FLASH_PAGE_SIZE,
+                           page, FLASH_PAGE_SIZE) != FLASH_OK) return FLASH_ERROR;
+
+        uint32_t offset = 0;
+        uint8_t res = LOG_HDR_VALID;
+        while (offset + W25Q_LOG_HEADER_SIZE <= FLASH_PAGE_SIZE) {
+            res = log_parse(page, offset, &hdr);
+            if (res != LOG_HDR_VALID) break;
+
+            if (hdr.seq == seq) {
+                if (hdr.length > max_length) return FLASH_ERROR;
+                memcpy(data, &page[offset + W25Q_LOG_HEADER_SIZE], hdr.length);
+                *length = hdr.length;
+                return FLASH_OK;
+            }
+            // Sequence numbers only grow: the record has been torn
+            if (hdr.seq > seq) return FLASH_ERROR;
+
+            offset += LOG_RECORD_SIZE(hdr.length);
+        }
+
+        // A blank page: no more records in this sector
+        if (offset == 0 && res == LOG_HDR_ERASED) break;
+    }
+
+    return FLASH_ERROR;
+}
+
+uint8_t w25q_log_maintain(w25q_log_t *log) {
+    uint32_t head_sector = log->head / FLASH_SECTOR_SIZE;
+
+    if (!log->head_ready) {
+        if (log_erase_sector(log, head_sector) != FLASH_OK) return 0;
+        log->head_ready = 1;
+        return 1;
+    }
+
+    // The sectors ahead are taken from the oldest ones, the head one is kept
+    if (log->erased >= W25Q_LOG_ERASE_AHEAD || log->erased >= log->sectors - 1) return 0;
+
+    uint32_t sector = (head_sector + 1 + log->erased) % log->sectors;
+    if (log_erase_sector(log, sector) != FLASH_OK) return 0;
+    log->erased++;
+    return 1;
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static uint16_t log_check(const log_header_t *hdr, const uint8_t *data) {
+    // Seeded, so that a zeroed header is not valid
+    uint32_t sum1 = 0x5A, sum2 = 0xA5;
+    uint8_t fields[6];
+    memcpy(&fields[0], &hdr->length, 2);
+    memcpy(&fields[2], &hdr->seq, 4);
+
+    for (uint32_t i = 0; i < sizeof(fields); i++) {
+        sum1 = (sum1 + fields[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    for (uint32_t i = 0; i < hdr->length; i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (uint16_t)((sum2 << 8) | sum1);
+}
+
+static uint8_t log_parse(const uint8_t *page, uint32_t offset, log_header_t *hdr) {
+    memcpy(hdr, &page[offset], W25Q_LOG_HEADER_SIZE);
+
+    if (hdr->length == 0xFFFF && hdr->check == 0xFFFF && hdr->seq == 0xFFFFFFFF) return LOG_HDR_ERASED;
+
+    if (offset + LOG_RECORD_SIZE(hdr->length) > FLASH_PAGE_SIZE) return LOG_HDR_INVALID;
+    if (log_check(hdr, &page[offset + W25Q_LOG_HEADER_SIZE]) != hdr->check) return LOG_HDR_INVALID;
+
+    return LOG_HDR_VALID;
+}
+
+static w25q_error_codes_t log_erase_sector(w25q_log_t *log, uint32_t sector) {
+    // Drop the records first, in case the erase is interrupted
+    log->index[sector] = W25Q_LOG_EMPTY;
+    return w25q128jw_4k_erase(log->base + sector * FLASH_SECTOR_SIZE);
+}
+
+static void log_advance(w25q_log_t *log, uint32_t bytes) {
+    log->head += bytes;
+    if (bytes == 0 || log->head % FLASH_SECTOR_SIZE != 0) return;
+
+    // Entering a new sector of the ring
+    if (log->head == log->sectors * FLASH_SECTOR_SIZE) log->head = 0;
+    if (log->erased > 0) {
+        log->erased--;
+        log->head_ready = 1;
+    } else {
+        log->head_ready = 0;
+    }
+}
+
+static w25q_error_codes_t log_init(w25q_log_t *log, uint32_t base, uint32_t sectors, uint32_t *index) {
+    if (base % FLASH_SECTOR_SIZE != 0 || sectors < 2 || index == NULL) return FLASH_ERROR;
+    if (base + sectors * FLASH_SECTOR_SIZE - 1 > MAX_FLASH_ADDR) return FLASH_ERROR;
+
+    log->base = base;
+    log->sectors = sectors;
+    log->index = index;
+    log->head = 0;
+    log->next_seq = 0;
+    log->erased = 0;
+    log->head_ready = 0;
+
+    for (uint32_t s = 0; s < sectors; s++) {
+        index[s] = W25Q_LOG_EMPTY;
+    }
+    return FLASH_OK;
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,181 @@
+/*
+                              *******************
+******************************* H HEADER FILE *****************************
+**                            *******************
+**
+** project  : X-HEEP
+** filename : w25q_log.h
+** version  : 1
+** date     : 14/10/2024
+**
+***************************************************************************
+**
+** Copyright (c) EPFL contributors.
+** All rights reserved.
+**
+***************************************************************************
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   w25q_log.h
+* @date   14/10/2024
+* @brief  Append-only log of records stored in the W25Q128JW flash.
+*
+* The log uses a ring of 4kB sectors. Records are programmed one after the
+* other and never cross a page, so an append costs a single page program.
+* The sectors following the one being filled are erased ahead of time by
+* w25q_log_maintain, called when the application is idle; when the ring is
+* full the oldest sector is dropped. A RAM index holds the first sequence
+* number of each sector, and the log is recovered after a power loss by
+* scanning the flash.
+*/
+
+#ifndef W25Q_LOG_H
+#define W25Q_LOG_H
+
+/****************************************************************************/
+/**                                                                        **/
+/**                            MODULES USED                                **/
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+
+#include "w25q128jw.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/**                       DEFINITIONS AND MACROS                           **/
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Size of the header programmed before each record, in bytes.
+*/
+#define W25Q_LOG_HEADER_SIZE 8
+
+/**
+ * @brief Largest record, in bytes. A record and its header fit in a page.
+*/
+#define W25Q_LOG_MAX_RECORD (FLASH_PAGE_SIZE - W25Q_LOG_HEADER_SIZE)
+
+/**
+ * @brief Index entry of a sector without records.
+*/
+#define W25Q_LOG_EMPTY 0xFFFFFFFF
+
+/**
+ * @brief Number of sectors w25q_log_maintain keeps erased ahead of the one
+ * being filled.
+*/
+#define W25Q_LOG_ERASE_AHEAD 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/**                                                                        **/
+/**                       TYPEDEFS AND STRUCTURES                          **/
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief State of a log. The fields are private.
+*/
+typedef struct {
+    uint32_t base;     /** Flash address of the first sector, 4kB aligned */
+    uint32_t sectors;  /** Number of sectors of the ring */
+    uint32_t *index;   /** First sequence number of each sector */
+    uint32_t head;     /** Offset from base of the next record */
+    uint32_t next_seq; /** Sequence number of the next record */
+    uint32_t erased;   /** Sectors after the head one known to be erased */
+    uint8_t head_ready; /** 1 if the rest of the head sector is erased */
+} w25q_log_t;
+
+/****************************************************************************/
+/**                                                                        **/
+/**                          EXPORTED FUNCTIONS                            **/
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Erase the flash area of a log and start it empty.
+ *
+ * @param log log state.
+ * @param base 4kB aligned flash address of the area.
+ * @param sectors number of sectors of the area, at least 2.
+ * @param index array of sectors words for the index.
+ * @return FLASH_OK if successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q_log_format(w25q_log_t *log, uint32_t base, uint32_t sectors, uint32_t *index);
+
+/**
+ * @brief Recover a log from the flash, e.g. at boot or after a power loss.
+ *
+ * The first record of each sector is read to build the index, then the
+ * sector holding the newest records is scanned to find the end of the log.
+ * A record torn by a power loss ends its page, the next record is appended
+ * in the following page.
+ *
+ * @param log log state.
+ * @param base 4kB aligned flash address of the area.
+ * @param sectors number of sectors of the area, at least 2.
+ * @param index array of sectors words for the index.
+ * @return FLASH_OK if successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q_log_mount(w25q_log_t *log, uint32_t base, uint32_t sectors, uint32_t *index);
+
+/**
+ * @brief Append a record.
+ *
+ * The record is programmed in the current page if it fits, otherwise in
+ * the next one. If the next sector is needed and has not been erased ahead
+ * by w25q_log_maintain, it is erased here.
+ *
+ * @param log log state.
+ * @param data record.
+ * @param length number of bytes of the record, up to W25Q_LOG_MAX_RECORD.
+ * @param seq if not NULL, set to the sequence number of the record.
+ * @return FLASH_OK if successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q_log_append(w25q_log_t *log, const void *data, uint32_t length, uint32_t *seq);
+
+/**
+ * @brief Read a record from its sequence number.
+ *
+ * @param log log state.
+ * @param seq sequence number of the record.
+ * @param data buffer of max_length bytes.
+ * @param max_length size of the buffer.
+ * @param length set to the number of bytes of the record.
+ * @return FLASH_OK if successful, FLASH_ERROR if the record is not in the
+ * log (dropped, torn or not written yet) or does not fit in the buffer.
+*/
+w25q_error_codes_t w25q_log_read(w25q_log_t *log, uint32_t seq, void *data, uint32_t max_length, uint32_t *length);
+
+/**
+ * @brief Erase the sectors ahead of the one being filled.
+ *
+ * Meant to be called when the application is idle, so that the appends do
+ * not wait for an erase. At most one sector is erased per call. If the ring
+ * is full, the sector holding the oldest records is dropped.
+ *
+ * @param log log state.
+ * @return 1 if a sector has been erased, 0 if there was nothing to do.
+*/
+uint8_t w25q_log_maintain(w25q_log_t *log);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* W25Q_LOG_H */
+/****************************************************************************/
+/**                                                                        **/
+/**                                EOF                                     **/
+/**                                                                        **/
+/****************************************************************************/
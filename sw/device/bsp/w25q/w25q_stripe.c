@@ -0,0 +1,225 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *****************************
+**                            *******************
+**
+** project  : X-HEEP
+** filename : w25q_stripe.c
+** version  : 1
+** date     : 21/10/2024
+**
+***************************************************************************
+**
+** Copyright (c) EPFL contributors.
+** All rights reserved.
+**
+***************************************************************************
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+/**
+* @file   w25q_stripe.c
+* @date   21/10/2024
+* @brief  Two W25Q128JW flashes seen as one address space, striped by page.
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+#include "w25q_stripe.h"
+
+#include "x-heep.h"
+#include "clk_gate.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        DEFINITIONS AND MACROS                            */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Bytes of a row, a unit of each flash.
+*/
+#define STRIPE_ROW (W25Q_STRIPE_UNIT * W25Q_STRIPE_FLASHES)
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Clock domain of the SPI host of a flash, CLK_GATE_NO_PERIPH for
+ * spi_flash which is always clocked.
+*/
+static uint32_t stripe_clk_idx(const w25q128jw_flash_t *flash);
+
+/**
+ * @brief Flash address of an address of the striped space.
+*/
+static uint32_t stripe_phys(uint32_t addr);
+
+/**
+ * @brief Read whole rows from both flashes in parallel.
+ *
+ * @param addr row aligned address in the striped space.
+ * @param data word aligned buffer.
+ * @param rows number of rows.
+ * @return FLASH_OK if the read is successful, @ref error_codes otherwise.
+*/
+static w25q_error_codes_t stripe_read_rows(uint32_t addr, uint8_t *data, uint32_t rows);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            GLOBAL VARIABLES                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Flashes of the even and odd pages.
+*/
+static w25q128jw_flash_t stripe_flash[W25Q_STRIPE_FLASHES];
+
+/**
+ * @brief Flash address of the area in both flashes.
+*/
+static uint32_t stripe_base;
+
+/**
+ * @brief Reads of the two flashes, in flight at the same time.
+*/
+static w25q128jw_read_handle_t stripe_read[W25Q_STRIPE_FLASHES];
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           EXPORTED FUNCTIONS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+w25q_error_codes_t w25q_stripe_init(const w25q128jw_flash_t *flash0, const w25q128jw_flash_t *flash1, uint32_t base) {
+    if (base % FLASH_PAGE_SIZE != 0 || base > MAX_FLASH_ADDR) return FLASH_ERROR;
+
+    // Both flashes are read at the same time, with their own DMA channel
+    if (flash0->dma_channel == flash1->dma_channel) return FLASH_ERROR;
+
+    stripe_flash[0] = *flash0;
+    stripe_flash[1] = *flash1;
+    stripe_base = base;
+
+    // Each w25q128jw_init releases the host of the previous flash
+    clk_gate_periph_acquire(stripe_clk_idx(flash0));
+    clk_gate_periph_acquire(stripe_clk_idx(flash1));
+
+    for (uint8_t f = 0; f < W25Q_STRIPE_FLASHES; f++) {
+        w25q128jw_select(&stripe_flash[f]);
+        if (w25q128jw_init(stripe_flash[f].spi) != FLASH_OK) return FLASH_ERROR;
+
+        // The modes would be exited at each change of flash
+        w25q128jw_set_continuous_read(0);
+        if (w25q128jw_set_read_mode(W25Q_READ_MODE_QUAD_IO) != FLASH_OK) return FLASH_ERROR;
+    }
+
+    return FLASH_OK;
+}
+
+void w25q_stripe_deinit(void) {
+    w25q128jw_select(&stripe_flash[0]);
+    clk_gate_periph_release(stripe_clk_idx(&stripe_flash[0]));
+    clk_gate_periph_release(stripe_clk_idx(&stripe_flash[1]));
+}
+
+uint32_t w25q_stripe_size(void) {
+    return W25Q_STRIPE_FLASHES * (MAX_FLASH_ADDR + 1 - stripe_base);
+}
+
+w25q_error_codes_t w25q_stripe_read(uint32_t addr, void *data, uint32_t length) {
+    if (data == NULL || length == 0 || addr + length > w25q_stripe_size()) return FLASH_ERROR;
+
+    uint8_t *dst = (uint8_t *)data;
+    while (length > 0) {
+        // Whole rows: both flashes at the same time
+        uint32_t rows = length / STRIPE_ROW;
+        if (addr % STRIPE_ROW == 0 && rows > 0 && (uintptr_t)dst % 4 == 0) {
+            if (stripe_read_rows(addr, dst, rows) != FLASH_OK) return FLASH_ERROR;
+            addr += rows * STRIPE_ROW;
+            dst += rows * STRIPE_ROW;
+            length -= rows * STRIPE_ROW;
+            continue;
+        }
+
+        // Up to the end of the page, from its flash
+        uint32_t n = W25Q_STRIPE_UNIT - addr % W25Q_STRIPE_UNIT;
+        if (n > length) n = length;
+        w25q128jw_select(&stripe_flash[(addr / W25Q_STRIPE_UNIT) % W25Q_STRIPE_FLASHES]);
+        if (w25q128jw_read(stripe_phys(addr), dst, n) != FLASH_OK) return FLASH_ERROR;
+        addr += n;
+        dst += n;
+        length -= n;
+    }
+
+    return FLASH_OK;
+}
+
+w25q_error_codes_t w25q_stripe_write(uint32_t addr, void *data, uint32_t length, uint8_t erase_before_write) {
+    if (data == NULL || length == 0 || addr + length > w25q_stripe_size()) return FLASH_ERROR;
+
+    uint8_t *src = (uint8_t *)data;
+    while (length > 0) {
+        uint32_t n = W25Q_STRIPE_UNIT - addr % W25Q_STRIPE_UNIT;
+        if (n > length) n = length;
+        w25q128jw_select(&stripe_flash[(addr / W25Q_STRIPE_UNIT) % W25Q_STRIPE_FLASHES]);
+        if (w25q128jw_write(stripe_phys(addr), src, n, erase_before_write) != FLASH_OK) return FLASH_ERROR;
+        addr += n;
+        src += n;
+        length -= n;
+    }
+
+    return FLASH_OK;
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static uint32_t stripe_clk_idx(const w25q128jw_flash_t *flash) {
+    return flash->spi == spi_host1 ? SPI_HOST_IDX
+         : flash->spi == spi_host2 ? SPI2_IDX
+         : CLK_GATE_NO_PERIPH;
+}
+
+static uint32_t stripe_phys(uint32_t addr) {
+    return stripe_base + (addr / STRIPE_ROW) * W25Q_STRIPE_UNIT + addr % W25Q_STRIPE_UNIT;
+}
+
+static w25q_error_codes_t stripe_read_rows(uint32_t addr, uint8_t *data, uint32_t rows) {
+    w25q_error_codes_t status = FLASH_OK;
+    uint8_t started = 0;
+
+    // Page i of each flash goes to row i of the buffer
+    for (uint8_t f = 0; f < W25Q_STRIPE_FLASHES; f++) {
+        w25q128jw_select(&stripe_flash[f]);
+        status = w25q128jw_read_quad_dma_strided_async(&stripe_read[f], stripe_phys(addr),
+                                                       data + f * W25Q_STRIPE_UNIT,
+                                                       W25Q_STRIPE_UNIT, rows, STRIPE_ROW);
+        if (status != FLASH_OK) break;
+        started++;
+    }
+
+    // The reads already started are finished in any case
+    for (uint8_t f = 0; f < started; f++) {
+        if (w25q128jw_read_dma_wait(&stripe_read[f]) != FLASH_OK) status = FLASH_ERROR;
+    }
+
+    return status;
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
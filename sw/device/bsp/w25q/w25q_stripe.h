@@ -0,0 +1,136 @@
+/*
+                              *******************
+******************************* H HEADER FILE *****************************
+**                            *******************
+**
+** project  : X-HEEP
+** filename : w25q_stripe.h
+** version  : 1
+** date     : 21/10/2024
+**
+***************************************************************************
+**
+** Copyright (c) EPFL contributors.
+** All rights reserved.
+**
+***************************************************************************
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   w25q_stripe.h
+* @date   21/10/2024
+* @brief  Two W25Q128JW flashes seen as one address space, striped by page.
+*
+* The pages of the address space alternate between the two flashes: page p
+* is page p / 2 of the area of flash p % 2, from the base address given to
+* w25q_stripe_init. A read of consecutive pages reads both flashes at the
+* same time, each one with its SPI host and DMA channel, so that the
+* bandwidth is doubled. The flashes are programmed with make
+* flash-prog-stripe, which splits a binary the same way (util/flash_stripe.py).
+*
+* The flashes are on different SPI hosts with a DMA trigger, spi_flash and
+* spi_host1. They can also share a host with two chip selects, but then the
+* reads of the two flashes follow each other.
+*/
+
+#ifndef W25Q_STRIPE_H
+#define W25Q_STRIPE_H
+
+/****************************************************************************/
+/**                                                                        **/
+/**                            MODULES USED                                **/
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+
+#include "w25q128jw.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/**                       DEFINITIONS AND MACROS                           **/
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Size of a stripe unit, the bytes read from one flash before the
+ * other one.
+*/
+#define W25Q_STRIPE_UNIT FLASH_PAGE_SIZE
+
+/**
+ * @brief Number of flashes of the stripe.
+*/
+#define W25Q_STRIPE_FLASHES 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/**                                                                        **/
+/**                          EXPORTED FUNCTIONS                            **/
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Initialize both flashes and the striped address space.
+ *
+ * The SPI hosts of both flashes stay clocked until w25q_stripe_deinit. The
+ * continuous read and QPI modes are disabled, as the driver switches from
+ * one flash to the other.
+ *
+ * @param flash0 flash of the even pages.
+ * @param flash1 flash of the odd pages.
+ * @param base flash address of the area in both flashes, page aligned.
+ * @return FLASH_OK if both flashes are initialized, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q_stripe_init(const w25q128jw_flash_t *flash0, const w25q128jw_flash_t *flash1, uint32_t base);
+
+/**
+ * @brief Release the clocks of the SPI hosts and select flash0 again.
+*/
+void w25q_stripe_deinit(void);
+
+/**
+ * @brief Size of the striped address space, in bytes.
+*/
+uint32_t w25q_stripe_size(void);
+
+/**
+ * @brief Read from the striped address space.
+ *
+ * The whole pairs of pages are read from both flashes in parallel using DMA,
+ * the pages at the ends of the area one after the other.
+ *
+ * @param addr address in the striped space.
+ * @param data buffer, word aligned.
+ * @param length number of bytes to read.
+ * @return FLASH_OK if the read is successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q_stripe_read(uint32_t addr, void *data, uint32_t length);
+
+/**
+ * @brief Write to the striped address space, as w25q128jw_write.
+ *
+ * @param addr address in the striped space.
+ * @param data data to write.
+ * @param length number of bytes to write.
+ * @param erase_before_write 1 to erase the sectors before writing.
+ * @return FLASH_OK if the write is successful, @ref error_codes otherwise.
+*/
+w25q_error_codes_t w25q_stripe_write(uint32_t addr, void *data, uint32_t length, uint8_t erase_before_write);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* W25Q_STRIPE_H */
+/****************************************************************************/
+/**                                                                        **/
+/**                                EOF                                     **/
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,116 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "ipc.h"
+
+#include "csr.h"
+#include "sync.h"
+
+int ipc_ring_init(ipc_ring_t *ring, void *buffer, uint32_t size,
+                  uint32_t count) {
+  if (buffer == NULL || size == 0 || count == 0 || (count & (count - 1)) != 0) {
+    return -1;
+  }
+  ring->buffer = (uint8_t *)buffer;
+  ring->size = size;
+  ring->mask = count - 1;
+  ring->head = 0;
+  ring->tail = 0;
+  return 0;
+}
+
+bool ipc_ring_push(ipc_ring_t *ring, const void *element) {
+  void *slot = ipc_ring_reserve(ring);
+  if (slot == NULL) {
+    return false;
+  }
+  __builtin_memcpy(slot, element, ring->size);
+  ipc_ring_commit(ring);
+  return true;
+}
+
+bool ipc_ring_pop(ipc_ring_t *ring, void *element) {
+  void *slot = ipc_ring_peek(ring);
+  if (slot == NULL) {
+    return false;
+  }
+  __builtin_memcpy(element, slot, ring->size);
+  ipc_ring_release(ring);
+  return true;
+}
+
+uint32_t ipc_ring_pop_n(ipc_ring_t *ring, void *elements, uint32_t max) {
+  uint32_t tail = ring->tail;
+  uint32_t n = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+  if (n > max) {
+    n = max;
+  }
+  uint8_t *out = (uint8_t *)elements;
+  for (uint32_t i = 0; i < n; i++) {
+    __builtin_memcpy(out, ring->buffer + ((tail + i) & ring->mask) * ring->size,
+                     ring->size);
+    out += ring->size;
+  }
+  // The slots are given back only once copied
+  __atomic_store_n(&ring->tail, tail + n, __ATOMIC_RELEASE);
+  return n;
+}
+
+int ipc_msgq_init(ipc_msgq_t *queue, void *buffer, uint32_t size,
+                  uint32_t count) {
+  queue->dropped = 0;
+  return ipc_ring_init(&queue->ring, buffer, size, count);
+}
+
+bool ipc_msgq_send(ipc_msgq_t *queue, const void *message) {
+  // The producers take turns, a handler cannot interrupt another send
+  uint32_t mstatus = sync_irq_save();
+  bool sent = ipc_ring_push(&queue->ring, message);
+  if (!sent) {
+    queue->dropped++;
+  }
+  sync_irq_restore(mstatus);
+  return sent;
+}
+
+void ipc_msgq_receive_wait(ipc_msgq_t *queue, void *message) {
+  // The interrupts are disabled between the check and the wfi, so the
+  // message of the last interrupt cannot arrive in between. Its pending
+  // interrupt still wakes the CPU up, and is served once they are enabled.
+  while (1) {
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    if (ipc_ring_pop(&queue->ring, message)) {
+      CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+      return;
+    }
+    asm volatile("wfi");
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
+
+void ipc_flags_set(ipc_flags_t *flags, uint32_t mask) {
+  sync_fetch_or(&flags->bits, mask);
+}
+
+void ipc_flags_clear(ipc_flags_t *flags, uint32_t mask) {
+  ipc_flags_take(flags, mask);
+}
+
+uint32_t ipc_flags_take(ipc_flags_t *flags, uint32_t mask) {
+  return sync_fetch_and(&flags->bits, ~mask) & mask;
+}
+
+uint32_t ipc_flags_wait(ipc_flags_t *flags, uint32_t mask, bool all) {
+  while (1) {
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    uint32_t bits = flags->bits & mask;
+    if (all ? bits == mask : bits != 0) {
+      flags->bits &= ~bits;
+      CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+      return bits;
+    }
+    asm volatile("wfi");
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
@@ -0,0 +1,237 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef IPC_H_
+#define IPC_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * @file
+ * @brief Communication between the interrupt handlers and the main program.
+ *
+ * - A ring moves fixed-size elements from one producer to one consumer, e.g.
+ *   from an interrupt handler to the main program, without disabling the
+ *   interrupts. The producer only writes `head` and the consumer only writes
+ *   `tail`: an element is written before `head` is published with a release
+ *   store, and read after `head` is loaded with an acquire load, so the
+ *   accesses are ordered by `fence` instructions for the other bus masters
+ *   too, e.g. a DMA filling or emptying the elements.
+ * - A message queue is a ring with any number of producers, e.g. several
+ *   interrupt handlers and the main program, which send with the interrupts
+ *   disabled, and one consumer, which can sleep until a message arrives.
+ * - Event flags are 32 bits set by the interrupt handlers and taken by the
+ *   main program, which can sleep until they are set. They are changed with
+ *   atomic instructions when the core has them (A extension), with the
+ *   interrupts disabled otherwise.
+ *
+ * The elements are copied with the rings, or written and read in place with
+ * ipc_ring_reserve() / ipc_ring_commit() and ipc_ring_peek() /
+ * ipc_ring_release():
+ *
+ *     static uint32_t samples[64];
+ *     static ipc_ring_t ring;
+ *     ipc_ring_init(&ring, samples, sizeof(uint32_t), 64);
+ *
+ *     // interrupt handler
+ *     ipc_ring_push(&ring, &sample);
+ *
+ *     // main program
+ *     uint32_t sample;
+ *     while (ipc_ring_pop(&ring, &sample)) { ... }
+ */
+
+/**
+ * Ring of `mask + 1` elements of `size` bytes. `head` and `tail` count the
+ * elements pushed and popped since the init, the slot of an element is its
+ * count modulo the number of elements.
+ */
+typedef struct ipc_ring {
+  uint8_t *buffer;
+  uint32_t size;
+  uint32_t mask;
+  uint32_t head;
+  uint32_t tail;
+} ipc_ring_t;
+
+/**
+ * Message queue, a ring with several producers.
+ */
+typedef struct ipc_msgq {
+  ipc_ring_t ring;
+  /** The messages dropped because the queue was full. */
+  volatile uint32_t dropped;
+} ipc_msgq_t;
+
+/**
+ * Event flags.
+ */
+typedef struct ipc_flags {
+  volatile uint32_t bits;
+} ipc_flags_t;
+
+/**
+ * Starts a ring, empty.
+ *
+ * @param ring The ring.
+ * @param buffer The elements, owned by the ring from now on.
+ * @param size The size of an element, in bytes.
+ * @param count The number of elements, a power of 2.
+ * @return 0, or -1 if the count is not a power of 2.
+ */
+int ipc_ring_init(ipc_ring_t *ring, void *buffer, uint32_t size,
+                  uint32_t count);
+
+/**
+ * The number of elements in the ring, for the producer or the consumer.
+ */
+static inline uint32_t ipc_ring_count(const ipc_ring_t *ring) {
+  return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) -
+         __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * The number of free elements of the ring, for the producer.
+ */
+static inline uint32_t ipc_ring_space(const ipc_ring_t *ring) {
+  return ring->mask + 1 - ipc_ring_count(ring);
+}
+
+/**
+ * The next free element of the ring, to be written by the producer before
+ * ipc_ring_commit().
+ *
+ * @return The element, or NULL if the ring is full.
+ */
+static inline void *ipc_ring_reserve(ipc_ring_t *ring) {
+  uint32_t head = ring->head;
+  if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+    return NULL;
+  }
+  return ring->buffer + (head & ring->mask) * ring->size;
+}
+
+/**
+ * Gives the element of ipc_ring_reserve() to the consumer.
+ */
+static inline void ipc_ring_commit(ipc_ring_t *ring) {
+  __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * The oldest element of the ring, to be read by the consumer before
+ * ipc_ring_release().
+ *
+ * @return The element, or NULL if the ring is empty.
+ */
+static inline void *ipc_ring_peek(ipc_ring_t *ring) {
+  uint32_t tail = ring->tail;
+  if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+    return NULL;
+  }
+  return ring->buffer + (tail & ring->mask) * ring->size;
+}
+
+/**
+ * Gives the element of ipc_ring_peek() back to the producer.
+ */
+static inline void ipc_ring_release(ipc_ring_t *ring) {
+  __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copies an element into the ring, from the producer.
+ *
+ * @return false if the ring is full.
+ */
+bool ipc_ring_push(ipc_ring_t *ring, const void *element);
+
+/**
+ * Copies the oldest element out of the ring, from the consumer.
+ *
+ * @return false if the ring is empty.
+ */
+bool ipc_ring_pop(ipc_ring_t *ring, void *element);
+
+/**
+ * Copies up to `max` of the oldest elements out of the ring, from the
+ * consumer, and gives their slots back at once.
+ *
+ * @return The number of elements copied.
+ */
+uint32_t ipc_ring_pop_n(ipc_ring_t *ring, void *elements, uint32_t max);
+
+/**
+ * Starts a message queue, empty.
+ *
+ * @param queue The queue.
+ * @param buffer The messages, owned by the queue from now on.
+ * @param size The size of a message, in bytes.
+ * @param count The number of messages, a power of 2.
+ * @return 0, or -1 if the count is not a power of 2.
+ */
+int ipc_msgq_init(ipc_msgq_t *queue, void *buffer, uint32_t size,
+                  uint32_t count);
+
+/**
+ * Copies a message into the queue, from any producer, or drops it.
+ *
+ * @return false if the queue is full.
+ */
+bool ipc_msgq_send(ipc_msgq_t *queue, const void *message);
+
+/**
+ * Copies the oldest message out of the queue, from the consumer.
+ *
+ * @return false if the queue is empty.
+ */
+static inline bool ipc_msgq_receive(ipc_msgq_t *queue, void *message) {
+  return ipc_ring_pop(&queue->ring, message);
+}
+
+/**
+ * Waits for a message and copies it out of the queue, sleeping while the
+ * queue is empty. Must not be called from an interrupt handler.
+ */
+void ipc_msgq_receive_wait(ipc_msgq_t *queue, void *message);
+
+/**
+ * Sets flags, from any context.
+ */
+void ipc_flags_set(ipc_flags_t *flags, uint32_t mask);
+
+/**
+ * Clears flags, from any context.
+ */
+void ipc_flags_clear(ipc_flags_t *flags, uint32_t mask);
+
+/**
+ * Clears flags, from any context.
+ *
+ * @return The flags of `mask` that were set.
+ */
+uint32_t ipc_flags_take(ipc_flags_t *flags, uint32_t mask);
+
+/**
+ * Waits for flags and clears them, sleeping while they are not set. Must
+ * not be called from an interrupt handler.
+ *
+ * @param flags The flags.
+ * @param mask The flags waited for.
+ * @param all Waits for all the flags of `mask` rather than any of them.
+ * @return The flags of `mask` that were set.
+ */
+uint32_t ipc_flags_wait(ipc_flags_t *flags, uint32_t mask, bool all);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IPC_H_
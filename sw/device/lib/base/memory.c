@@ -17,38 +17,141 @@ extern void write_32(uint32_t, void *);
 // This approach is used so that DIFs can depend on `memory.h`, but also be
 // built for host-side software.
 
-#if !defined(HOST_BUILD)
-void *memcpy(void *restrict dest, const void *restrict src, size_t len) {
+// The loops below must not be turned back into calls to the libc functions
+// they implement.
+#if defined(__GNUC__) && !defined(__clang__)
+#define MEMORY_NO_BUILTIN \
+  __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define MEMORY_NO_BUILTIN
+#endif
+
+enum {
+  kWordSize = sizeof(uint32_t),
+  kWordMask = sizeof(uint32_t) - 1,
+};
+
+// Number of bytes before the first word-aligned address from `ptr`, capped to
+// `len`.
+static inline size_t memory_prefix_len(const void *ptr, size_t len) {
+  size_t prefix = (kWordSize - ((uintptr_t)ptr & kWordMask)) & kWordMask;
+  return prefix < len ? prefix : len;
+}
+
+MEMORY_NO_BUILTIN
+void *memory_copy(void *restrict dest, const void *restrict src, size_t len) {
   uint8_t *dest8 = (uint8_t *)dest;
-  uint8_t *src8 = (uint8_t *)src;
+  const uint8_t *src8 = (const uint8_t *)src;
+
+  // Words can only be used if both regions have the same alignment, otherwise
+  // every word would need unaligned accesses.
+  if ((((uintptr_t)dest8 ^ (uintptr_t)src8) & kWordMask) == 0) {
+    size_t prefix = memory_prefix_len(dest8, len);
+    for (size_t i = 0; i < prefix; ++i) {
+      dest8[i] = src8[i];
+    }
+    dest8 += prefix;
+    src8 += prefix;
+    len -= prefix;
+
+    for (; len >= 4 * kWordSize; len -= 4 * kWordSize) {
+      uint32_t w0 = read_32(src8);
+      uint32_t w1 = read_32(src8 + kWordSize);
+      uint32_t w2 = read_32(src8 + 2 * kWordSize);
+      uint32_t w3 = read_32(src8 + 3 * kWordSize);
+      write_32(w0, dest8);
+      write_32(w1, dest8 + kWordSize);
+      write_32(w2, dest8 + 2 * kWordSize);
+      write_32(w3, dest8 + 3 * kWordSize);
+      dest8 += 4 * kWordSize;
+      src8 += 4 * kWordSize;
+    }
+    for (; len >= kWordSize; len -= kWordSize) {
+      write_32(read_32(src8), dest8);
+      dest8 += kWordSize;
+      src8 += kWordSize;
+    }
+  }
+
   for (size_t i = 0; i < len; ++i) {
     dest8[i] = src8[i];
   }
   return dest;
 }
-#endif  // !defined(HOST_BUILD)
 
-#if !defined(HOST_BUILD)
-void *memset(void *dest, int value, size_t len) {
+MEMORY_NO_BUILTIN
+void *memory_set(void *dest, int value, size_t len) {
   uint8_t *dest8 = (uint8_t *)dest;
   uint8_t value8 = (uint8_t)value;
+
+  size_t prefix = memory_prefix_len(dest8, len);
+  for (size_t i = 0; i < prefix; ++i) {
+    dest8[i] = value8;
+  }
+  dest8 += prefix;
+  len -= prefix;
+
+  uint32_t value32 = value8 * 0x01010101u;
+  for (; len >= 4 * kWordSize; len -= 4 * kWordSize) {
+    write_32(value32, dest8);
+    write_32(value32, dest8 + kWordSize);
+    write_32(value32, dest8 + 2 * kWordSize);
+    write_32(value32, dest8 + 3 * kWordSize);
+    dest8 += 4 * kWordSize;
+  }
+  for (; len >= kWordSize; len -= kWordSize) {
+    write_32(value32, dest8);
+    dest8 += kWordSize;
+  }
+
   for (size_t i = 0; i < len; ++i) {
     dest8[i] = value8;
   }
   return dest;
 }
-#endif  // !defined(HOST_BUILD)
 
-#if !defined(HOST_BUILD)
 enum {
   kMemCmpEq = 0,
   kMemCmpLt = -42,
   kMemCmpGt = 42,
 };
 
-int memcmp(const void *lhs, const void *rhs, size_t len) {
+MEMORY_NO_BUILTIN
+int memory_compare(const void *lhs, const void *rhs, size_t len) {
   const uint8_t *lhs8 = (uint8_t *)lhs;
   const uint8_t *rhs8 = (uint8_t *)rhs;
+
+  // Skip the equal words, the bytes of the first different one are compared
+  // below.
+  if ((((uintptr_t)lhs8 ^ (uintptr_t)rhs8) & kWordMask) == 0) {
+    size_t prefix = memory_prefix_len(lhs8, len);
+    for (size_t i = 0; i < prefix; ++i) {
+      if (lhs8[i] != rhs8[i]) {
+        return lhs8[i] < rhs8[i] ? kMemCmpLt : kMemCmpGt;
+      }
+    }
+    lhs8 += prefix;
+    rhs8 += prefix;
+    len -= prefix;
+
+    for (; len >= kWordSize; len -= kWordSize) {
+      uint32_t diff = read_32(lhs8) ^ read_32(rhs8);
+      if (diff != 0) {
+#if defined(__riscv_zbb)
+        // Little-endian: the first different byte holds the lowest set bit
+        uint32_t shift = __builtin_ctz(diff) & ~7u;
+        uint8_t l = (uint8_t)(read_32(lhs8) >> shift);
+        uint8_t r = (uint8_t)(read_32(rhs8) >> shift);
+        return l < r ? kMemCmpLt : kMemCmpGt;
+#else
+        break;
+#endif
+      }
+      lhs8 += kWordSize;
+      rhs8 += kWordSize;
+    }
+  }
+
   for (size_t i = 0; i < len; ++i) {
     if (lhs8[i] < rhs8[i]) {
       return kMemCmpLt;
@@ -58,6 +161,41 @@ int memcmp(const void *lhs, const void *rhs, size_t len) {
   }
   return kMemCmpEq;
 }
+
+#ifdef MEMORY_WORD
+// Called instead of memcpy, memset and memcmp when linked with --wrap (see
+// MEMORY_WORD in sw/CMakeLists.txt), FAST_MEMCPY keeps memcpy and memset.
+#ifndef FAST_MEMCPY
+void *__wrap_memcpy(void *dest, const void *src, size_t len) {
+  return memory_copy(dest, src, len);
+}
+
+void *__wrap_memset(void *dest, int value, size_t len) {
+  return memory_set(dest, value, len);
+}
+#endif  // FAST_MEMCPY
+
+int __wrap_memcmp(const void *lhs, const void *rhs, size_t len) {
+  return memory_compare(lhs, rhs, len);
+}
+#endif  // MEMORY_WORD
+
+#if !defined(HOST_BUILD)
+void *memcpy(void *restrict dest, const void *restrict src, size_t len) {
+  return memory_copy(dest, src, len);
+}
+#endif  // !defined(HOST_BUILD)
+
+#if !defined(HOST_BUILD)
+void *memset(void *dest, int value, size_t len) {
+  return memory_set(dest, value, len);
+}
+#endif  // !defined(HOST_BUILD)
+
+#if !defined(HOST_BUILD)
+int memcmp(const void *lhs, const void *rhs, size_t len) {
+  return memory_compare(lhs, rhs, len);
+}
 #endif  // !defined(HOST_BUILD)
 
 #if !defined(HOST_BUILD)
@@ -142,6 +142,50 @@ void *memset(void *dest, int value, size_t len);
  */
 int memcmp(const void *lhs, const void *rhs, size_t len);
 
+/**
+ * Copy memory between non-overlapping regions, with the semantics of
+ * `memcpy()`.
+ *
+ * The bulk of the copy is done one word at a time when both regions have the
+ * same alignment. The applications take `memcpy()` from libc (HOST_BUILD in
+ * sw/CMakeLists.txt) and only call this one by name, unless they are built
+ * with MEMORY_WORD=1, which routes the `memcpy()` of libc here.
+ *
+ * @param dest the region to copy to.
+ * @param src the region to copy from.
+ * @param len the number of bytes to copy.
+ * @return the value of `dest`.
+ */
+void *memory_copy(void *restrict dest, const void *restrict src, size_t len);
+
+/**
+ * Set a region of memory to a particular byte value, with the semantics of
+ * `memset()`.
+ *
+ * The bulk of the region is written one word at a time. Used instead of the
+ * `memset()` of libc with MEMORY_WORD=1, see `memory_copy()`.
+ *
+ * @param dest the region to write to.
+ * @param value the value, converted to a byte, to write to each byte cell.
+ * @param len the number of bytes to write.
+ * @return the value of `dest`.
+ */
+void *memory_set(void *dest, int value, size_t len);
+
+/**
+ * Compare two regions of memory, with the semantics of `memcmp()`.
+ *
+ * Equal words are skipped one at a time when both regions have the same
+ * alignment. Used instead of the `memcmp()` of libc with MEMORY_WORD=1, see
+ * `memory_copy()`.
+ *
+ * @param lhs the left-hand-side of the comparison.
+ * @param rhs the right-hand-side of the comparison.
+ * @param len the length of both regions, in bytes.
+ * @return a zero, positive, or negative integer, as `memcmp()`.
+ */
+int memory_compare(const void *lhs, const void *rhs, size_t len);
+
 /**
  * Search a region of memory for the first occurence of a particular byte value.
  *
@@ -0,0 +1,42 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "reg_prog.h"
+
+void reg_prog_apply(mmio_region_t base, const reg_prog_op_t *prog, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    uint32_t value = prog[i].value;
+    if (prog[i].mask != REG_PROG_ALL) {
+      value |= mmio_region_read32(base, prog[i].offset) & ~prog[i].mask;
+    }
+    mmio_region_write32(base, prog[i].offset, value);
+  }
+}
+
+void reg_prog_write_image(mmio_region_t base, ptrdiff_t offset,
+                          const uint32_t *image, size_t len) {
+  volatile uint32_t *reg = (volatile uint32_t *)base.base + offset / sizeof(uint32_t);
+  for (size_t i = 0; i < len; i++) {
+    reg[i] = image[i];
+  }
+}
+
+size_t reg_prog_compact(reg_prog_op_t *prog, size_t len) {
+  size_t out = 0;
+  for (size_t i = 0; i < len; i++) {
+    size_t j = 0;
+    while (j < out && prog[j].offset != prog[i].offset) {
+      j++;
+    }
+    if (j == out) {
+      prog[out++] = prog[i];
+    } else if (prog[i].mask == REG_PROG_ALL) {
+      prog[j] = prog[i];
+    } else {
+      prog[j].value = (prog[j].value & ~prog[i].mask) | prog[i].value;
+      prog[j].mask |= prog[i].mask;
+    }
+  }
+  return out;
+}
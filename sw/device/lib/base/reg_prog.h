@@ -0,0 +1,125 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef REG_PROG_H_
+#define REG_PROG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mmio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * @file
+ * @brief Register programs: the configuration of a peripheral as a table.
+ *
+ * A register program is an array of (offset, mask, value) operations on the
+ * registers of one peripheral, written as a `static const` table when the
+ * configuration is known at compile time, or filled once at init. Applying it
+ * is a short loop of stores: the operations on whole registers are written
+ * without reading them first, so that they follow each other on the bus, and
+ * only the operations on a part of a register read it.
+ *
+ * A block of consecutive registers can also be kept as an image, an array of
+ * words written with reg_prog_write_image(), or copied by the DMA in a single
+ * transaction (e.g. with dma_copy_32b() of the DMA SDK).
+ *
+ * The offsets are those of the `_regs.h` files, or of the register structures
+ * generated by structs_gen.py with REG_PROG_STRUCT():
+ *
+ *     static const reg_prog_op_t cfg[] = {
+ *       REG_PROG_WRITE(PDM2PCM_CLKDIVIDX_REG_OFFSET, 16),
+ *       REG_PROG_FIELD(DMA_SLOT_REG_OFFSET, DMA_SLOT_TX_TRIGGER_SLOT_MASK,
+ *                      DMA_SLOT_TX_TRIGGER_SLOT_OFFSET, 2),
+ *       REG_PROG_STRUCT(dma, MODE, DMA_TRANS_MODE_SINGLE),
+ *     };
+ *     reg_prog_apply(region, cfg, REG_PROG_LEN(cfg));
+ */
+
+/**
+ * The mask of an operation writing a whole register.
+ */
+#define REG_PROG_ALL 0xffffffffu
+
+/**
+ * One operation of a register program.
+ */
+typedef struct reg_prog_op {
+  /** The offset of the register from the base of the peripheral, in bytes. */
+  uint32_t offset;
+  /** The bits written, REG_PROG_ALL to write the register without reading
+   * it. */
+  uint32_t mask;
+  /** The value of the written bits, at their position in the register. */
+  uint32_t value;
+} reg_prog_op_t;
+
+/**
+ * Writes `value` into the whole register at `offset`.
+ */
+#define REG_PROG_WRITE(offset, value) \
+  { (uint32_t)(offset), REG_PROG_ALL, (uint32_t)(value) }
+
+/**
+ * Writes `value` into the field of `mask` at bit `index` of the register at
+ * `offset`, keeping its other bits.
+ */
+#define REG_PROG_FIELD(offset, mask, index, value)      \
+  {                                                     \
+    (uint32_t)(offset), (uint32_t)(mask) << (index),    \
+        ((uint32_t)(value) & (uint32_t)(mask)) << (index) \
+  }
+
+/**
+ * Writes `value` into the whole register `reg` of the register structure
+ * `type` generated by structs_gen.py.
+ */
+#define REG_PROG_STRUCT(type, reg, value) \
+  REG_PROG_WRITE(offsetof(type, reg), value)
+
+/**
+ * The number of operations of a register program declared as an array.
+ */
+#define REG_PROG_LEN(prog) (sizeof(prog) / sizeof((prog)[0]))
+
+/**
+ * Applies the operations of a register program in order.
+ *
+ * @param base The registers of the peripheral.
+ * @param prog The operations.
+ * @param len The number of operations.
+ */
+void reg_prog_apply(mmio_region_t base, const reg_prog_op_t *prog, size_t len);
+
+/**
+ * Writes an image of consecutive registers, without reading them.
+ *
+ * @param base The registers of the peripheral.
+ * @param offset The offset of the first register, in bytes.
+ * @param image The values of the registers.
+ * @param len The number of registers.
+ */
+void reg_prog_write_image(mmio_region_t base, ptrdiff_t offset,
+                          const uint32_t *image, size_t len);
+
+/**
+ * Merges the operations of a program on the same register into one, the
+ * later ones taking precedence, so that each register is written once.
+ * The order of the first operation on each register is kept.
+ *
+ * @param prog The operations, compacted in place.
+ * @param len The number of operations.
+ * @return The number of operations left.
+ */
+size_t reg_prog_compact(reg_prog_op_t *prog, size_t len);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // REG_PROG_H_
@@ -0,0 +1,53 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "sync.h"
+
+bool sync_sem_trywait(sync_sem_t *sem) {
+  uint32_t count = sync_load(&sem->count);
+  while (count != 0) {
+    uint32_t old = sync_cas(&sem->count, count, count - 1);
+    if (old == count) {
+      return true;
+    }
+    count = old;
+  }
+  return false;
+}
+
+void sync_sem_wait(sync_sem_t *sem) {
+  // The interrupts are disabled between the check and the wfi, so the post
+  // of the last interrupt cannot happen in between. Its pending interrupt
+  // still wakes the CPU up, and is served once they are enabled.
+  while (1) {
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    if (sync_sem_trywait(sem)) {
+      CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+      return;
+    }
+    asm volatile("wfi");
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
+
+bool sync_wait(sync_cond_t cond, void *arg) {
+  uint32_t mstatus;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  if ((mstatus & 0x8) == 0) {
+    while (!cond(arg)) {
+    }
+    return false;
+  }
+
+  // As sync_sem_wait()
+  while (1) {
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    if (cond(arg)) {
+      CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+      return true;
+    }
+    asm volatile("wfi");
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
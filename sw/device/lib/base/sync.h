@@ -0,0 +1,324 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef SYNC_H_
+#define SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "csr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * @file
+ * @brief Atomic operations, fences, spinlocks and semaphores.
+ *
+ * These are the primitives shared by the main program, the interrupt
+ * handlers, the other harts and the bus masters (DMA, accelerators):
+ *
+ * - sync_load() and sync_store() are acquire loads and release stores of a
+ *   word, to publish data with a flag rather than a `volatile` variable.
+ *   Aligned word accesses are atomic on any RISC-V core.
+ * - The read-modify-write operations (sync_cas(), sync_swap() and
+ *   sync_fetch_*()) use the A extension when the core has it
+ *   (`__riscv_atomic`), and disable the interrupts around a plain
+ *   read-modify-write otherwise. The latter is atomic for the interrupt
+ *   handlers of the same hart only: between harts without the A extension,
+ *   use the mutexes of the cluster controller.
+ * - sync_fence_dma_start() and sync_fence_dma_done() order the accesses to
+ *   a buffer with the register accesses that start a bus master and read
+ *   its end, see below.
+ * - Spinlocks protect short critical sections between harts, and between a
+ *   hart and its interrupt handlers with sync_spin_lock_irqsave().
+ * - Semaphores count events posted from any context, e.g. an interrupt
+ *   handler, and the waiting context sleeps until one is posted.
+ * - sync_wait() sleeps until a condition holds, for the blocking paths of
+ *   the drivers, and polls it when the interrupts are disabled.
+ *
+ * The fences are also compiler barriers: the buffers of a transaction need
+ * not be `volatile`, and the code around the transaction can be optimized.
+ *
+ *     fill(buffer);
+ *     sync_fence_dma_start();   // buffer written before the launch
+ *     dma_launch(&trans);
+ *     while (!dma_is_ready(0)); // fences with sync_fence_dma_done()
+ *     use(buffer);
+ */
+
+/**
+ * Disables the interrupts, also from a handler.
+ *
+ * @return The previous MSTATUS, for sync_irq_restore().
+ */
+static inline uint32_t sync_irq_save(void) {
+  uint32_t mstatus;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  return mstatus;
+}
+
+/**
+ * Enables the interrupts again if sync_irq_save() disabled them.
+ */
+static inline void sync_irq_restore(uint32_t mstatus) {
+  if (mstatus & 0x8) {
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
+
+/**
+ * Orders all the previous memory and I/O accesses before the next ones.
+ */
+static inline void sync_fence(void) { asm volatile("fence rw, rw" ::: "memory"); }
+
+/**
+ * Orders the previous accesses to the buffers of a bus master before the
+ * register write that starts it.
+ */
+static inline void sync_fence_dma_start(void) {
+  asm volatile("fence rw, o" ::: "memory");
+}
+
+/**
+ * Orders the register read that sees the end of a bus master before the
+ * next accesses to its buffers.
+ */
+static inline void sync_fence_dma_done(void) {
+  asm volatile("fence i, rw" ::: "memory");
+}
+
+/**
+ * Reads a word, with acquire ordering: the accesses that follow are not
+ * moved before it.
+ */
+static inline uint32_t sync_load(const volatile uint32_t *ptr) {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Writes a word, with release ordering: the accesses that precede are not
+ * moved after it.
+ */
+static inline void sync_store(volatile uint32_t *ptr, uint32_t value) {
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * Writes `desired` if the word is `expected`.
+ *
+ * @return The word before, equal to `expected` if it was written.
+ */
+static inline uint32_t sync_cas(volatile uint32_t *ptr, uint32_t expected,
+                                uint32_t desired) {
+#ifdef __riscv_atomic
+  __atomic_compare_exchange_n(ptr, &expected, desired, false,
+                              __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+  return expected;
+#else
+  uint32_t mstatus = sync_irq_save();
+  uint32_t old = *ptr;
+  if (old == expected) {
+    *ptr = desired;
+  }
+  sync_irq_restore(mstatus);
+  return old;
+#endif
+}
+
+/**
+ * Writes a word.
+ *
+ * @return The word before.
+ */
+static inline uint32_t sync_swap(volatile uint32_t *ptr, uint32_t value) {
+#ifdef __riscv_atomic
+  return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+#else
+  uint32_t mstatus = sync_irq_save();
+  uint32_t old = *ptr;
+  *ptr = value;
+  sync_irq_restore(mstatus);
+  return old;
+#endif
+}
+
+/**
+ * Adds to a word.
+ *
+ * @return The word before.
+ */
+static inline uint32_t sync_fetch_add(volatile uint32_t *ptr, uint32_t value) {
+#ifdef __riscv_atomic
+  return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL);
+#else
+  uint32_t mstatus = sync_irq_save();
+  uint32_t old = *ptr;
+  *ptr = old + value;
+  sync_irq_restore(mstatus);
+  return old;
+#endif
+}
+
+/**
+ * Sets bits of a word.
+ *
+ * @return The word before.
+ */
+static inline uint32_t sync_fetch_or(volatile uint32_t *ptr, uint32_t mask) {
+#ifdef __riscv_atomic
+  return __atomic_fetch_or(ptr, mask, __ATOMIC_ACQ_REL);
+#else
+  uint32_t mstatus = sync_irq_save();
+  uint32_t old = *ptr;
+  *ptr = old | mask;
+  sync_irq_restore(mstatus);
+  return old;
+#endif
+}
+
+/**
+ * Keeps the bits of `mask` of a word and clears the others.
+ *
+ * @return The word before.
+ */
+static inline uint32_t sync_fetch_and(volatile uint32_t *ptr, uint32_t mask) {
+#ifdef __riscv_atomic
+  return __atomic_fetch_and(ptr, mask, __ATOMIC_ACQ_REL);
+#else
+  uint32_t mstatus = sync_irq_save();
+  uint32_t old = *ptr;
+  *ptr = old & mask;
+  sync_irq_restore(mstatus);
+  return old;
+#endif
+}
+
+/**
+ * Spinlock, 0 when free.
+ */
+typedef struct sync_spinlock {
+  volatile uint32_t locked;
+} sync_spinlock_t;
+
+#define SYNC_SPINLOCK_INIT \
+  { .locked = 0 }
+
+/**
+ * Takes the lock if it is free.
+ *
+ * @return false if the lock was taken.
+ */
+static inline bool sync_spin_trylock(sync_spinlock_t *lock) {
+  return sync_swap(&lock->locked, 1) == 0;
+}
+
+/**
+ * Takes the lock, spinning while it is taken. A context must not take a
+ * lock that a context it interrupted holds: an interrupt handler and the
+ * main program share a lock with sync_spin_lock_irqsave().
+ */
+static inline void sync_spin_lock(sync_spinlock_t *lock) {
+  while (!sync_spin_trylock(lock)) {
+    // The swaps are left to the holder while the lock is taken
+    while (sync_load(&lock->locked) != 0) {
+    }
+  }
+}
+
+/**
+ * Frees the lock.
+ */
+static inline void sync_spin_unlock(sync_spinlock_t *lock) {
+  sync_store(&lock->locked, 0);
+}
+
+/**
+ * Disables the interrupts and takes the lock.
+ *
+ * @return The previous MSTATUS, for sync_spin_unlock_irqrestore().
+ */
+static inline uint32_t sync_spin_lock_irqsave(sync_spinlock_t *lock) {
+  uint32_t mstatus = sync_irq_save();
+  sync_spin_lock(lock);
+  return mstatus;
+}
+
+/**
+ * Frees the lock and enables the interrupts again.
+ */
+static inline void sync_spin_unlock_irqrestore(sync_spinlock_t *lock,
+                                               uint32_t mstatus) {
+  sync_spin_unlock(lock);
+  sync_irq_restore(mstatus);
+}
+
+/**
+ * Counting semaphore.
+ */
+typedef struct sync_sem {
+  volatile uint32_t count;
+} sync_sem_t;
+
+#define SYNC_SEM_INIT(n) \
+  { .count = (n) }
+
+/**
+ * Sets the count of the semaphore.
+ */
+static inline void sync_sem_init(sync_sem_t *sem, uint32_t count) {
+  sync_store(&sem->count, count);
+}
+
+/**
+ * Increments the count, from any context.
+ */
+static inline void sync_sem_post(sync_sem_t *sem) {
+  sync_fetch_add(&sem->count, 1);
+}
+
+/**
+ * Decrements the count if it is not 0.
+ *
+ * @return false if the count was 0.
+ */
+bool sync_sem_trywait(sync_sem_t *sem);
+
+/**
+ * Decrements the count, sleeping while it is 0. Must not be called from an
+ * interrupt handler. Any interrupt wakes the hart up to check the count
+ * again: another hart posting the semaphore also raises the software
+ * interrupt of the waiting hart.
+ */
+void sync_sem_wait(sync_sem_t *sem);
+
+/**
+ * Condition of sync_wait(), e.g. a flag set by an interrupt handler or a
+ * status bit of a peripheral.
+ */
+typedef bool (*sync_cond_t)(void *arg);
+
+/**
+ * Waits until `cond(arg)` holds. With the interrupts enabled, the hart sleeps
+ * with wfi between two checks, which are done with the interrupts disabled:
+ * the interrupt that ends the wait cannot be served between the check and the
+ * wfi, it stays pending and wakes the hart up. That interrupt must be enabled
+ * in MIE, and in the PLIC or the fast interrupt controller.
+ *
+ * With the interrupts disabled by the caller, e.g. in a critical section or a
+ * handler, the condition is polled: no handler can run, so only a condition
+ * on the status of a peripheral ends the wait.
+ *
+ * @return true if the hart slept, false if it polled.
+ */
+bool sync_wait(sync_cond_t cond, void *arg);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // SYNC_H_
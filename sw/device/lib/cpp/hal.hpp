@@ -0,0 +1,24 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef HAL_HPP_
+#define HAL_HPP_
+
+/**
+ * @file
+ * @brief Header-only C++ layer of the peripherals, for the .cpp files of the
+ * applications.
+ *
+ * The peripherals are templates on their instance and configuration
+ * (xheep::Gpio<Pin>, xheep::Dma<Channel>, xheep::Spi<Idx, Slave>), checked
+ * by static_assert and accessed at constant addresses. They use no
+ * exception, RTTI nor heap, and no state besides the registers: the buffers
+ * are the caller's, static arrays giving their sizes to the compiler.
+ */
+
+#include "hal_dma.hpp"
+#include "hal_gpio.hpp"
+#include "hal_spi.hpp"
+
+#endif  // HAL_HPP_
@@ -0,0 +1,92 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef HAL_DMA_HPP_
+#define HAL_DMA_HPP_
+
+extern "C" {
+#include "core_v_mini_mcu.h"
+#include "dma_regs.h"
+}
+#include "hal_reg.hpp"
+
+/**
+ * @file
+ * @brief Linear copies of a DMA channel known at compile time.
+ *
+ * The channel and the element type are checked by the compiler, and the
+ * registers of the channel are written with constant addresses, as
+ * dma_copy_32b() of the DMA SDK without the validation, the channel
+ * allocation and the interrupt:
+ *
+ *     static uint32_t src[64], dst[64];
+ *     xheep::Dma<1>::copy(dst, src);
+ *
+ * The channel must not be used by the C drivers at the same time. Its
+ * copies end with polling, they do not raise the DMA interrupt.
+ */
+
+namespace xheep {
+
+template <unsigned Channel>
+class Dma {
+  static_assert(Channel < DMA_CH_NUM, "DMA channel out of range");
+
+  using R = Regs<DMA_START_ADDRESS + Channel * DMA_CH_SIZE>;
+
+  template <typename T>
+  static constexpr uint32_t data_type() {
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4,
+                  "DMA elements of 1, 2 or 4 bytes");
+    return sizeof(T) == 4   ? DMA_SRC_DATA_TYPE_DATA_TYPE_VALUE_DMA_32BIT_WORD
+           : sizeof(T) == 2 ? DMA_SRC_DATA_TYPE_DATA_TYPE_VALUE_DMA_16BIT_WORD
+                            : DMA_SRC_DATA_TYPE_DATA_TYPE_VALUE_DMA_8BIT_WORD;
+  }
+
+ public:
+  static constexpr unsigned channel = Channel;
+
+  // Starts copying count elements, the size starts the channel
+  template <typename T>
+  static inline void start_copy(T *dst, const T *src, uint32_t count) {
+    constexpr uint32_t type = data_type<T>();
+    R::template write<DMA_SRC_PTR_REG_OFFSET>((uint32_t)(uintptr_t)src);
+    R::template write<DMA_DST_PTR_REG_OFFSET>((uint32_t)(uintptr_t)dst);
+    R::template write<DMA_SRC_PTR_INC_D1_REG_OFFSET>(sizeof(T));
+    R::template write<DMA_DST_PTR_INC_D1_REG_OFFSET>(sizeof(T));
+    R::template write<DMA_SLOT_REG_OFFSET>(0);
+    R::template write<DMA_SRC_DATA_TYPE_REG_OFFSET>(type);
+    R::template write<DMA_DST_DATA_TYPE_REG_OFFSET>(type);
+    R::template write<DMA_MODE_REG_OFFSET>(DMA_MODE_MODE_VALUE_LINEAR_MODE);
+    R::template write<DMA_DIM_CONFIG_REG_OFFSET>(0);
+    R::template write<DMA_WIDE_REG_OFFSET>(0);
+    R::template write<DMA_INTERRUPT_EN_REG_OFFSET>(0);
+    R::template write<DMA_SIZE_D1_REG_OFFSET>(count * sizeof(T));
+  }
+
+  static inline bool ready() { return R::template bit<DMA_STATUS_REG_OFFSET, DMA_STATUS_READY_BIT>(); }
+
+  static inline void wait() {
+    while (!ready()) {
+    }
+  }
+
+  template <typename T>
+  static inline void copy(T *dst, const T *src, uint32_t count) {
+    start_copy(dst, src, count);
+    wait();
+  }
+
+  // Copy between two static buffers, whose sizes are checked by the compiler
+  template <typename T, size_t N, size_t M>
+  static inline void copy(T (&dst)[N], const T (&src)[M]) {
+    static_assert(N >= M, "destination smaller than the source");
+    static_assert(M * sizeof(T) <= DMA_SIZE_D1_SIZE_MASK, "copy too long for a transaction");
+    copy(dst, src, M);
+  }
+};
+
+}  // namespace xheep
+
+#endif  // HAL_DMA_HPP_
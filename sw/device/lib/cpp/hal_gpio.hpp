@@ -0,0 +1,79 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef HAL_GPIO_HPP_
+#define HAL_GPIO_HPP_
+
+extern "C" {
+#include "core_v_mini_mcu.h"
+#include "gpio_regs.h"
+#include "x-heep.h"
+}
+#include "hal_reg.hpp"
+
+/**
+ * @file
+ * @brief GPIO pin known at compile time.
+ *
+ * The pin is checked by the compiler, and selects the GPIO_AO peripheral
+ * (pins 0 to GPIO_AO_DOMAIN_LIMIT - 1) or the GPIO one, so that write(),
+ * toggle() and read() are a single access, like gpio_write(), gpio_toggle()
+ * and gpio_read() of the C driver without their checks at run time:
+ *
+ *     using Led = xheep::Gpio<2>;
+ *     Led::mode(xheep::GpioMode::Out);
+ *     Led::toggle();
+ */
+
+namespace xheep {
+
+enum class GpioMode : uint32_t {
+  In = GPIO_GPIO_MODE_0_MODE_0_VALUE_INPUT_ONLY,
+  Out = GPIO_GPIO_MODE_0_MODE_0_VALUE_OUTPUT_ACTIVE,
+  OpenDrain0 = GPIO_GPIO_MODE_0_MODE_0_VALUE_OPEN_DRAIN0,
+  OpenDrain1 = GPIO_GPIO_MODE_0_MODE_0_VALUE_OPEN_DRAIN1,
+};
+
+template <unsigned Pin>
+class Gpio {
+  static_assert(Pin < MAX_PIN, "GPIO pin out of range");
+
+  using R = Regs<(Pin < GPIO_AO_DOMAIN_LIMIT) ? GPIO_AO_START_ADDRESS : GPIO_START_ADDRESS>;
+  static constexpr uint32_t bit = 1u << Pin;
+  // 16 pins of 2 bits in each mode register
+  static constexpr uint32_t mode_offset =
+      Pin < 16 ? GPIO_GPIO_MODE_0_REG_OFFSET : GPIO_GPIO_MODE_1_REG_OFFSET;
+  static constexpr unsigned mode_index = (Pin % 16) * 2;
+
+ public:
+  static constexpr unsigned pin = Pin;
+
+  static inline void mode(GpioMode mode) {
+    R::template modify<mode_offset>(field(GPIO_GPIO_MODE_0_MODE_0_MASK, mode_index, 0xffffffffu),
+                                    field(GPIO_GPIO_MODE_0_MODE_0_MASK, mode_index, (uint32_t)mode));
+  }
+
+  // The input of a pin is only sampled once enabled, see gpio_en_input_sampling()
+  static inline void input_sampling(bool enable) {
+    R::template modify<GPIO_GPIO_EN_REG_OFFSET>(bit, enable ? bit : 0);
+  }
+
+  static inline void set() { R::template write<GPIO_GPIO_SET_REG_OFFSET>(bit); }
+  static inline void clear() { R::template write<GPIO_GPIO_CLEAR_REG_OFFSET>(bit); }
+  static inline void toggle() { R::template write<GPIO_GPIO_TOGGLE_REG_OFFSET>(bit); }
+
+  static inline void write(bool value) {
+    if (value) {
+      set();
+    } else {
+      clear();
+    }
+  }
+
+  static inline bool read() { return (R::template read<GPIO_GPIO_IN_REG_OFFSET>() & bit) != 0; }
+};
+
+}  // namespace xheep
+
+#endif  // HAL_GPIO_HPP_
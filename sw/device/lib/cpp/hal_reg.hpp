@@ -0,0 +1,64 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef HAL_REG_HPP_
+#define HAL_REG_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Registers of a peripheral at a base address known at compile time.
+ *
+ * The address of every access is a constant, so an access is a single load
+ * or store, without the pointer to the peripheral of the C drivers.
+ */
+
+namespace xheep {
+
+template <uintptr_t Base>
+struct Regs {
+  static constexpr uintptr_t base = Base;
+
+  template <uint32_t Offset>
+  static inline volatile uint32_t &reg() {
+    static_assert(Offset % 4 == 0, "unaligned register");
+    return *reinterpret_cast<volatile uint32_t *>(Base + Offset);
+  }
+
+  template <uint32_t Offset>
+  static inline uint32_t read() {
+    return reg<Offset>();
+  }
+
+  template <uint32_t Offset>
+  static inline void write(uint32_t value) {
+    reg<Offset>() = value;
+  }
+
+  // Writes the bits of mask, keeping the others
+  template <uint32_t Offset>
+  static inline void modify(uint32_t mask, uint32_t value) {
+    reg<Offset>() = (reg<Offset>() & ~mask) | (value & mask);
+  }
+
+  template <uint32_t Offset, unsigned Bit>
+  static inline bool bit() {
+    static_assert(Bit < 32, "bit out of range");
+    return (reg<Offset>() >> Bit) & 1;
+  }
+};
+
+// The value of a field, at its position in the register
+constexpr uint32_t field(uint32_t mask, unsigned index, uint32_t value) {
+  return (value & mask) << index;
+}
+
+// Whether value fits in the field of mask
+constexpr bool fits(uint32_t mask, uint32_t value) { return (value & ~mask) == 0; }
+
+}  // namespace xheep
+
+#endif  // HAL_REG_HPP_
@@ -0,0 +1,164 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef HAL_SPI_HPP_
+#define HAL_SPI_HPP_
+
+extern "C" {
+#include "core_v_mini_mcu.h"
+#include "spi_host_regs.h"
+#include "x-heep.h"
+}
+#include "hal_reg.hpp"
+
+/**
+ * @file
+ * @brief Blocking standard-speed transfers with an SPI slave known at
+ * compile time.
+ *
+ * The slave is checked by the compiler, as spi_init() of the SPI SDK does at
+ * run time, and its CONFIGOPTS register is computed once, from the system
+ * frequency REFERENCE_CLOCK_Hz of the target unless given:
+ *
+ *     constexpr xheep::SpiSlave flash = {.csid = 0, .freq = 10000000};
+ *     using Flash = xheep::Spi<xheep::SpiIdx::Flash, flash>;
+ *     Flash::init();
+ *     Flash::write(cmd, 4, true);   // keeps CS low for the next segment
+ *     Flash::read(data, 256);
+ *
+ * The peripheral must not be used by the C drivers at the same time. The
+ * transfers poll the FIFOs and raise no interrupt.
+ */
+
+namespace xheep {
+
+enum class SpiIdx : unsigned { Flash = 0, Host = 1, Host2 = 2 };
+
+// The fields of spi_slave_t of the SPI SDK
+struct SpiSlave {
+  uint8_t csid = 0;
+  uint8_t data_mode = 0;  // spi_datamode_e, (cpol << 1) | cpha
+  bool full_cycle = false;
+  uint8_t csn_idle = 0;
+  uint8_t csn_trail = 0;
+  uint8_t csn_lead = 0;
+  uint32_t freq = 0;  // maximum frequency of the slave, in Hz
+};
+
+template <SpiIdx Idx, SpiSlave Slave, uint32_t SysFreq = REFERENCE_CLOCK_Hz>
+class Spi {
+  static constexpr uintptr_t base = Idx == SpiIdx::Flash  ? SPI_FLASH_START_ADDRESS
+                                    : Idx == SpiIdx::Host ? SPI_HOST_START_ADDRESS
+                                                          : SPI2_START_ADDRESS;
+  using R = Regs<base>;
+
+  static_assert(Slave.csid < SPI_HOST_PARAM_NUM_C_S, "SPI csid out of range");
+  static_assert(Slave.data_mode <= 3, "SPI data mode out of range");
+  static_assert(fits(SPI_HOST_CONFIGOPTS_0_CSNIDLE_0_MASK, Slave.csn_idle) &&
+                    fits(SPI_HOST_CONFIGOPTS_0_CSNTRAIL_0_MASK, Slave.csn_trail) &&
+                    fits(SPI_HOST_CONFIGOPTS_0_CSNLEAD_0_MASK, Slave.csn_lead),
+                "SPI CS timing out of range");
+  static_assert(Slave.freq >= SysFreq / (2 * 65535 + 2), "SPI slave frequency too low");
+
+  // The divider of the fastest SCK not above the frequency of the slave, as
+  // spi_freq_to_clk_div() of the SPI SDK
+  static constexpr uint32_t clk_div() {
+    if (Slave.freq >= SysFreq / 2) {
+      return 0;
+    }
+    uint32_t div = (SysFreq / Slave.freq - 2) / 2;
+    return SysFreq / (2 * div + 2) > Slave.freq ? div + 1 : div;
+  }
+
+  static constexpr uint32_t configopts =
+      field(SPI_HOST_CONFIGOPTS_0_CLKDIV_0_MASK, SPI_HOST_CONFIGOPTS_0_CLKDIV_0_OFFSET, clk_div()) |
+      field(SPI_HOST_CONFIGOPTS_0_CSNIDLE_0_MASK, SPI_HOST_CONFIGOPTS_0_CSNIDLE_0_OFFSET, Slave.csn_idle) |
+      field(SPI_HOST_CONFIGOPTS_0_CSNTRAIL_0_MASK, SPI_HOST_CONFIGOPTS_0_CSNTRAIL_0_OFFSET, Slave.csn_trail) |
+      field(SPI_HOST_CONFIGOPTS_0_CSNLEAD_0_MASK, SPI_HOST_CONFIGOPTS_0_CSNLEAD_0_OFFSET, Slave.csn_lead) |
+      (uint32_t)Slave.full_cycle << SPI_HOST_CONFIGOPTS_0_FULLCYC_0_BIT |
+      (uint32_t)(Slave.data_mode & 1) << SPI_HOST_CONFIGOPTS_0_CPHA_0_BIT |
+      (uint32_t)(Slave.data_mode >> 1) << SPI_HOST_CONFIGOPTS_0_CPOL_0_BIT;
+
+  // Directions of spi_dir_e
+  static constexpr uint32_t dir_rx = 1;
+  static constexpr uint32_t dir_tx = 2;
+
+  // Command of a standard-speed segment of len bytes
+  static constexpr uint32_t command(uint32_t direction, uint32_t len, bool csaat) {
+    return field(SPI_HOST_COMMAND_LEN_MASK, SPI_HOST_COMMAND_LEN_OFFSET, len - 1) |
+           (uint32_t)csaat << SPI_HOST_COMMAND_CSAAT_BIT |
+           field(SPI_HOST_COMMAND_DIRECTION_MASK, SPI_HOST_COMMAND_DIRECTION_OFFSET, direction);
+  }
+
+  static inline void start(uint32_t cmd) {
+    while (!R::template bit<SPI_HOST_STATUS_REG_OFFSET, SPI_HOST_STATUS_READY_BIT>()) {
+    }
+    R::template write<SPI_HOST_CSID_REG_OFFSET>(Slave.csid);
+    R::template write<SPI_HOST_COMMAND_REG_OFFSET>(cmd);
+  }
+
+  static inline void push(uint32_t word) {
+    while (R::template bit<SPI_HOST_STATUS_REG_OFFSET, SPI_HOST_STATUS_TXFULL_BIT>()) {
+    }
+    R::template write<SPI_HOST_TXDATA_REG_OFFSET>(word);
+  }
+
+  static inline uint32_t pop() {
+    while (R::template bit<SPI_HOST_STATUS_REG_OFFSET, SPI_HOST_STATUS_RXEMPTY_BIT>()) {
+    }
+    return R::template read<SPI_HOST_RXDATA_REG_OFFSET>();
+  }
+
+ public:
+  static constexpr uint32_t divider = clk_div();
+  static constexpr uint32_t frequency = SysFreq / (2 * divider + 2);
+
+  // Enables the peripheral and its outputs, and configures the slave
+  static inline void init() {
+    R::template modify<SPI_HOST_CONTROL_REG_OFFSET>(
+        1u << SPI_HOST_CONTROL_SPIEN_BIT | 1u << SPI_HOST_CONTROL_OUTPUT_EN_BIT,
+        1u << SPI_HOST_CONTROL_SPIEN_BIT | 1u << SPI_HOST_CONTROL_OUTPUT_EN_BIT);
+    R::template write<SPI_HOST_CONFIGOPTS_0_REG_OFFSET + 4 * Slave.csid>(configopts);
+  }
+
+  // Sends len bytes of words, keeping CS low afterwards if csaat
+  static inline void write(const uint32_t *words, uint32_t len, bool csaat = false) {
+    start(command(dir_tx, len, csaat));
+    for (uint32_t i = 0; i < (len + 3) / 4; i++) {
+      push(words[i]);
+    }
+    wait_idle();
+  }
+
+  // Receives len bytes into words, keeping CS low afterwards if csaat
+  static inline void read(uint32_t *words, uint32_t len, bool csaat = false) {
+    start(command(dir_rx, len, csaat));
+    for (uint32_t i = 0; i < (len + 3) / 4; i++) {
+      words[i] = pop();
+    }
+    wait_idle();
+  }
+
+  // Transfers of static buffers, whose lengths are checked by the compiler
+  template <size_t N>
+  static inline void write(const uint32_t (&words)[N], bool csaat = false) {
+    static_assert(N * 4 <= SPI_HOST_COMMAND_LEN_MASK + 1, "SPI segment too long");
+    write(words, N * 4, csaat);
+  }
+
+  template <size_t N>
+  static inline void read(uint32_t (&words)[N], bool csaat = false) {
+    static_assert(N * 4 <= SPI_HOST_COMMAND_LEN_MASK + 1, "SPI segment too long");
+    read(words, N * 4, csaat);
+  }
+
+  static inline void wait_idle() {
+    while (R::template bit<SPI_HOST_STATUS_REG_OFFSET, SPI_HOST_STATUS_ACTIVE_BIT>()) {
+    }
+  }
+};
+
+}  // namespace xheep
+
+#endif  // HAL_SPI_HPP_
@@ -13,9 +13,28 @@
 #include "x-heep.h"
 #include "core_v_mini_mcu.h"
 #include "soc_ctrl_regs.h"
+#include "dma_regs.h"
+#include "power_manager_regs.h"
+#include "warm_boot.h"
+#include "mem_watermark.h"
 
 #define RAMSIZE_COPIEDBY_BOOTROM 2048
 
+/* Largest copy of a DMA transaction, its size register has 16 bits */
+#define DMA_COPY_MAX_BYTES 0x8000
+
+/* Read of the flash_load sections: quad SPI and DMA with FLASH_LOAD_DMA,
+   standard SPI otherwise, both with the arguments (flash addr, dst, length) */
+#ifdef FLASH_LOAD_DMA
+#define FLASH_LOAD_READ w25q128jw_load_quad_dma_crt0
+#else
+#define FLASH_LOAD_READ w25q128jw_read_standard
+#endif
+
+/* Optional early initialization, run by the CRT0_DMA crt0 while the DMA
+   zeroes .bss: it must not use .bss nor, with FLASH_EXEC, .data */
+.weak crt0_early_init
+
 /* Entry point for bare metal programs */
 .section .text.start
 .global _start
@@ -41,10 +60,50 @@ _start:
    #include "external_crt0.S"
 #endif
 
+/* warm boot: the RAM was retained, skip its loading and initialization
+   and call the resume handler, see warm_boot.h */
+   la     t0, warm_boot_record
+   lw     t1, WARM_BOOT_MAGIC_OFFSET(t0)
+   li     t2, WARM_BOOT_MAGIC
+   bne    t1, t2, _cold_boot
+   lw     a0, WARM_BOOT_ARG_OFFSET(t0)
+   lw     a1, WARM_BOOT_HANDLER_OFFSET(t0)
+   lw     t3, WARM_BOOT_CHECK_OFFSET(t0)
+   xor    t1, t1, a0
+   xor    t1, t1, a1
+   bne    t1, t3, _cold_boot
+
+   // consume the record, so that a handler that crashes boots cold next time
+   sw     zero, WARM_BOOT_MAGIC_OFFSET(t0)
+   lw     t1, WARM_BOOT_COUNT_OFFSET(t0)
+   addi   t1, t1, 1
+   sw     t1, WARM_BOOT_COUNT_OFFSET(t0)
+
+   la     t1, __vector_start
+   ori    t1, t1, 0x1
+   csrw   mtvec, t1
+   jalr   a1
+   tail   exit
+
+_cold_boot:
+   sw     zero, WARM_BOOT_MAGIC_OFFSET(t0)
+   sw     zero, WARM_BOOT_COUNT_OFFSET(t0)
+
 #ifdef FLASH_LOAD
 
     call w25q128jw_init_crt0
 
+#ifdef FLASH_LOAD_LZ
+    // the whole image is compressed after the bytes copied by the boot ROM,
+    // decompressed through two chunks at the start of the heap, unused yet
+    li     a0, RAMSIZE_COPIEDBY_BOOTROM
+    la     a1, __heap_start
+    call   w25q128jw_load_lz_crt0
+    // a corrupted image does not start
+1:  bnez   a0, 1b
+    j      _init_bss
+#endif
+
     // This assumes ram base address is 0x00000000 and the section .text stars from ram0 (in the first RAMSIZE_COPIEDBY_BOOTROM Byte)
     li     s1, RAMSIZE_COPIEDBY_BOOTROM
     li     s2, FLASH_MEM_START_ADDRESS
@@ -64,16 +123,16 @@ _start:
     // dst ptr (ram)
     mv     a1, s1
 
-    // copy the remaining data --> w25q128jw_read_standard(a0 is src addr, a1 is dest ptr data, a2 is length)
+    // copy the remaining data --> FLASH_LOAD_READ(a0 is src addr, a1 is dest ptr data, a2 is length)
 
     // this sub is redundat as we could have simply set a0 to RAMSIZE_COPIEDBY_BOOTROM+0x0,
     // but like this is more readable as we set the FLASH address as memory mapped to FLASH_MEM_START_ADDRESS, and then remove the offset
-    // as required bz the w25q128jw_read_standard function
+    // as required bz the FLASH_LOAD_READ function
     sub    a0,a0,s2
-    call w25q128jw_read_standard
+    call FLASH_LOAD_READ
 
 % for i, section in enumerate(xheep.iter_linker_sections()):
-% if section.name != "code":
+% if section.name not in ["code", "stack"]:
 _load_${section.name}_section:
     // src ptr
     la     a0, _lma_${section.name}_start
@@ -86,7 +145,7 @@ _load_${section.name}_section:
     bltz   a2, _load_${section.name}_section_end // dont do anything if you do not have something in ${section.name}
 
     sub    a0,a0,s2
-    call w25q128jw_read_standard
+    call FLASH_LOAD_READ
 _load_${section.name}_section_end:
 
 % endif
@@ -96,13 +155,76 @@ _load_${section.name}_section_end:
 
 /* clear the bss segment */
 _init_bss:
+#ifdef CRT0_DMA
+/* with the DMA (channel 0), polling its status: the words are copied from a
+   zero word on the stack without source increment, in transactions of at most
+   DMA_COPY_MAX_BYTES, and the CPU runs crt0_early_init() during the first one.
+   The CPU zeroes the bytes before the first word and after the last one */
+    la     s3, __bss_start
+    la     s4, __bss_end
+    addi   s5, s3, 3
+    andi   s5, s5, -4
+    andi   s6, s4, -4
+    bgeu   s5, s6, _init_bss_cpu
+    mv     a0, s3
+    li     a1, 0
+    sub    a2, s5, s3
+    call   memset
+    mv     a0, s6
+    li     a1, 0
+    sub    a2, s4, s6
+    call   memset
+
+    addi   sp, sp, -16
+    sw     zero, 0(sp)
+    li     a3, DMA_START_ADDRESS
+    sw     zero, DMA_SRC_DATA_TYPE_REG_OFFSET(a3)
+    sw     zero, DMA_DST_DATA_TYPE_REG_OFFSET(a3)
+    sw     zero, DMA_MODE_REG_OFFSET(a3)
+    sw     zero, DMA_DIM_CONFIG_REG_OFFSET(a3)
+    sw     zero, DMA_SLOT_REG_OFFSET(a3)
+    sw     zero, DMA_INTERRUPT_EN_REG_OFFSET(a3)
+    sw     zero, DMA_SRC_PTR_INC_D1_REG_OFFSET(a3)
+    li     a4, 4
+    sw     a4, DMA_DST_PTR_INC_D1_REG_OFFSET(a3)
+    li     a5, DMA_COPY_MAX_BYTES
+    sub    s6, s6, s5
+    jal    t0, _init_bss_dma
+    la     t1, crt0_early_init
+    beqz   t1, 2f
+    jalr   t1
+    li     a3, DMA_START_ADDRESS
+    li     a5, DMA_COPY_MAX_BYTES
+2:  lw     a6, DMA_STATUS_REG_OFFSET(a3)
+    andi   a6, a6, 1 << DMA_STATUS_READY_BIT
+    beqz   a6, 2b
+    beqz   s6, 3f
+    jal    t0, _init_bss_dma
+    j      2b
+    /* starts the zeroing of the next min(s6, a5) bytes at s5, returns to t0 */
+_init_bss_dma:
+    sw     sp, DMA_SRC_PTR_REG_OFFSET(a3)
+    sw     s5, DMA_DST_PTR_REG_OFFSET(a3)
+    mv     a4, s6
+    bleu   a4, a5, 1f
+    mv     a4, a5
+1:  sw     a4, DMA_SIZE_D1_REG_OFFSET(a3)
+    add    s5, s5, a4
+    sub    s6, s6, a4
+    jr     t0
+3:  addi   sp, sp, 16
+    j      _init_bss_end
+_init_bss_cpu:
+#endif
     la     a0, __bss_start
     la     a2, __bss_end
     sub    a2, a2, a0
     li     a1, 0
     call   memset
+_init_bss_end:
 
 #ifdef FLASH_EXEC
+#ifndef CRT0_DMA
 /* copy initialized data sections from flash to ram (to be verified, copied from picosoc)*/
     la a0, _sidata
     la a1, _sdata
@@ -117,6 +239,78 @@ _init_bss:
     end_init_data:
 #endif
 
+/* copy the RAM_FUNC functions and the RAM_RODATA constants, and with CRT0_DMA
+   the initialized data, from flash to ram with the DMA (channel 0), polling
+   its status, in transactions of at most DMA_COPY_MAX_BYTES */
+    li a3, DMA_START_ADDRESS
+    sw zero, DMA_SRC_DATA_TYPE_REG_OFFSET(a3)
+    sw zero, DMA_DST_DATA_TYPE_REG_OFFSET(a3)
+    sw zero, DMA_MODE_REG_OFFSET(a3)
+    sw zero, DMA_DIM_CONFIG_REG_OFFSET(a3)
+    sw zero, DMA_SLOT_REG_OFFSET(a3)
+    sw zero, DMA_INTERRUPT_EN_REG_OFFSET(a3)
+    li a4, 4
+    sw a4, DMA_SRC_PTR_INC_D1_REG_OFFSET(a3)
+    sw a4, DMA_DST_PTR_INC_D1_REG_OFFSET(a3)
+    li a5, DMA_COPY_MAX_BYTES
+#ifdef CRT0_DMA
+    la a0, _sidata
+    la a1, _sdata
+    la a2, _edata
+    jal t0, init_ram_copy
+#endif
+    la a0, _siram_text
+    la a1, _sram_text
+    la a2, _eram_text
+    jal t0, init_ram_copy
+    la a0, _siram_rodata
+    la a1, _sram_rodata
+    la a2, _eram_rodata
+    jal t0, init_ram_copy
+    j end_init_ram_text
+    /* a0 is the flash address, a1 the ram start, a2 the ram end, returns to t0 */
+    init_ram_copy:
+    sub a2, a2, a1
+    beqz a2, 3f
+    loop_init_ram_text:
+    sw a0, DMA_SRC_PTR_REG_OFFSET(a3)
+    sw a1, DMA_DST_PTR_REG_OFFSET(a3)
+    mv a4, a2
+    bleu a4, a5, 1f
+    mv a4, a5
+1:  sw a4, DMA_SIZE_D1_REG_OFFSET(a3)
+2:  lw a6, DMA_STATUS_REG_OFFSET(a3)
+    andi a6, a6, 1 << DMA_STATUS_READY_BIT
+    beqz a6, 2b
+    add a0, a0, a4
+    add a1, a1, a4
+    sub a2, a2, a4
+    bnez a2, loop_init_ram_text
+3:  jr t0
+    end_init_ram_text:
+#endif
+
+#ifdef MEM_WATERMARK
+/* fill the heap and the free part of the stack with MEM_WATERMARK_PATTERN,
+   the peak use is scanned at exit, see mem_watermark.h */
+    li     a3, MEM_WATERMARK_PATTERN
+    la     a0, __heap_start
+    la     a1, __heap_end
+    jal    t0, _fill_watermark
+    la     a0, __stack_start
+    mv     a1, sp
+    jal    t0, _fill_watermark
+    j      _fill_watermark_end
+    /* fills the words from a0 to a1 with a3, returns to t0 */
+_fill_watermark:
+    bgeu   a0, a1, 2f
+1:  sw     a3, 0(a0)
+    addi   a0, a0, 4
+    bltu   a0, a1, 1b
+2:  jr     t0
+_fill_watermark_end:
+#endif
+
 /* set vector table address and vectored mode */
     la a0, __vector_start
     ori a0, a0, 0x1
@@ -136,6 +330,19 @@ _init_bss:
 
 .size  _start, .-_start
 
+/* Restore address of power_gate_core_warm(): the boot ROM jumps here when the
+   core is switched on again, with none of its state */
+.global _warm_start
+.type _warm_start, @function
+
+_warm_start:
+    li     a0, POWER_MANAGER_START_ADDRESS
+    sw     zero, POWER_MANAGER_POWER_GATE_CORE_REG_OFFSET(a0)
+    sw     zero, POWER_MANAGER_WAKEUP_STATE_REG_OFFSET(a0)
+    j      _start
+
+.size  _warm_start, .-_warm_start
+
 .global _init
 .type   _init, @function
 .global _fini
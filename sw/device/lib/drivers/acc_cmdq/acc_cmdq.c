@@ -0,0 +1,170 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : acc_cmdq.c                                                   **
+** date     : 14/10/2024                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   acc_cmdq.c
+* @date   14/10/2024
+* @brief  HAL of the standard command queue of the external accelerators
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "acc_cmdq.h"
+
+#include "mmio.h"
+#include "csr.h"
+#include "hart.h"
+#include "rv_plic.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+static inline uint32_t acc_cmdq_read(const acc_cmdq_t *q, uint32_t offset);
+static inline void acc_cmdq_write(const acc_cmdq_t *q, uint32_t offset, uint32_t value);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+acc_cmdq_result_t acc_cmdq_init(acc_cmdq_t *q, uintptr_t base, uint32_t id, uint32_t num_args,
+                                uint32_t irq, void (*handler)(uint32_t))
+{
+  if (num_args > ACC_CMDQ_MAX_ARGS) return kAccCmdqError;
+
+  q->base = base;
+  q->num_args = num_args;
+  q->irq = irq;
+  q->irq_seen = false;
+
+  if (acc_cmdq_read(q, ACC_CMDQ_ID_REG_OFFSET) != id) return kAccCmdqError;
+
+  acc_cmdq_write(q, ACC_CMDQ_CTRL_REG_OFFSET, 1 << ACC_CMDQ_CTRL_CLEAR_OVERFLOW_BIT);
+
+  if (irq != 0) {
+    plic_irq_set_priority(irq, 1);
+    plic_irq_set_enabled(irq, kPlicToggleEnabled);
+    plic_assign_external_irq_handler(irq, (void *)handler);
+  }
+
+  return kAccCmdqOk;
+}
+
+uint32_t acc_cmdq_free_slots(const acc_cmdq_t *q)
+{
+  return acc_cmdq_read(q, ACC_CMDQ_STATUS_REG_OFFSET) & ACC_CMDQ_STATUS_FREE_MASK;
+}
+
+bool acc_cmdq_busy(const acc_cmdq_t *q)
+{
+  return (acc_cmdq_read(q, ACC_CMDQ_STATUS_REG_OFFSET) >> ACC_CMDQ_STATUS_BUSY_BIT) & 0x1;
+}
+
+acc_cmdq_result_t acc_cmdq_submit(acc_cmdq_t *q, uint8_t opcode, uint8_t tag, const uint32_t *args)
+{
+  if (acc_cmdq_free_slots(q) == 0) return kAccCmdqFull;
+
+  for (uint32_t i = 0; i < q->num_args; i++) {
+    acc_cmdq_write(q, ACC_CMDQ_ARG_REG_OFFSET(i), args[i]);
+  }
+  acc_cmdq_write(q, ACC_CMDQ_DOORBELL_REG_OFFSET, ((uint32_t)tag << 8) | opcode);
+
+  return kAccCmdqOk;
+}
+
+acc_cmdq_result_t acc_cmdq_poll(acc_cmdq_t *q, acc_cmdq_cpl_t *cpl)
+{
+  uint32_t value = acc_cmdq_read(q, ACC_CMDQ_COMPLETION_REG_OFFSET);
+
+  if (((value >> ACC_CMDQ_COMPLETION_VALID_BIT) & 0x1) == 0) return kAccCmdqEmpty;
+
+  cpl->tag = (value >> 16) & 0xff;
+  cpl->status = value & 0xffff;
+  return kAccCmdqOk;
+}
+
+acc_cmdq_result_t acc_cmdq_wait(acc_cmdq_t *q, acc_cmdq_cpl_t *cpl)
+{
+  while (acc_cmdq_poll(q, cpl) != kAccCmdqOk) {
+    if (q->irq == 0) continue;
+
+    // The interrupt is high as long as a completion waits: it is only
+    // unmasked here, with the interrupts disabled so it cannot be missed
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    q->irq_seen = false;
+    acc_cmdq_write(q, ACC_CMDQ_CTRL_REG_OFFSET, 1 << ACC_CMDQ_CTRL_IRQ_EN_BIT);
+    while (!q->irq_seen) {
+      wait_for_interrupt();
+      CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+      CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+
+  return kAccCmdqOk;
+}
+
+bool acc_cmdq_overflow(acc_cmdq_t *q)
+{
+  bool overflow = (acc_cmdq_read(q, ACC_CMDQ_STATUS_REG_OFFSET) >> ACC_CMDQ_STATUS_OVERFLOW_BIT) & 0x1;
+
+  if (overflow) {
+    uint32_t ctrl = acc_cmdq_read(q, ACC_CMDQ_CTRL_REG_OFFSET);
+    acc_cmdq_write(q, ACC_CMDQ_CTRL_REG_OFFSET, ctrl | (1 << ACC_CMDQ_CTRL_CLEAR_OVERFLOW_BIT));
+  }
+  return overflow;
+}
+
+void acc_cmdq_irq_handler(acc_cmdq_t *q)
+{
+  acc_cmdq_write(q, ACC_CMDQ_CTRL_REG_OFFSET, 0);
+  q->irq_seen = true;
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static inline uint32_t acc_cmdq_read(const acc_cmdq_t *q, uint32_t offset)
+{
+  return mmio_region_read32(mmio_region_from_addr(q->base), offset);
+}
+
+static inline void acc_cmdq_write(const acc_cmdq_t *q, uint32_t offset, uint32_t value)
+{
+  mmio_region_write32(mmio_region_from_addr(q->base), offset, value);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,186 @@
+/*
+                              *******************
+******************************* H SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : acc_cmdq.h                                                   **
+** date     : 14/10/2024                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   acc_cmdq.h
+* @date   14/10/2024
+* @brief  HAL of the standard command queue of the external accelerators
+*
+* An accelerator wrapped in hw/ip/acc_cmdq queues jobs made of an opcode, a
+* tag and up to 8 arguments, and returns one completion per job with its tag
+* and a status. util/accgen.py generates, from the hjson description of an
+* accelerator, a typed driver on top of this one.
+*
+* The jobs are queued without waiting for the previous ones, up to the depth
+* of the queue. acc_cmdq_wait() sleeps until a completion arrives: the
+* interrupt of the queue stays high while completions are waiting, so the
+* handler masks it and acc_cmdq_wait() unmasks it before sleeping.
+*/
+
+#ifndef _DRIVERS_ACC_CMDQ_H_
+#define _DRIVERS_ACC_CMDQ_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       DEFINITIONS AND MACROS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+#define ACC_CMDQ_ID_REG_OFFSET          0x00
+#define ACC_CMDQ_STATUS_REG_OFFSET      0x04
+#define ACC_CMDQ_CTRL_REG_OFFSET        0x08
+#define ACC_CMDQ_DOORBELL_REG_OFFSET    0x0C
+#define ACC_CMDQ_COMPLETION_REG_OFFSET  0x10
+#define ACC_CMDQ_ARG_REG_OFFSET(i)      (0x20 + 4 * (i))
+
+#define ACC_CMDQ_STATUS_FREE_MASK       0xff
+#define ACC_CMDQ_STATUS_WAITING_OFFSET  8
+#define ACC_CMDQ_STATUS_BUSY_BIT        16
+#define ACC_CMDQ_STATUS_OVERFLOW_BIT    17
+
+#define ACC_CMDQ_CTRL_IRQ_EN_BIT        0
+#define ACC_CMDQ_CTRL_CLEAR_OVERFLOW_BIT 1
+
+#define ACC_CMDQ_COMPLETION_VALID_BIT   31
+
+#define ACC_CMDQ_MAX_ARGS 8
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        TYPEDEFS AND STRUCTURES                           */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Result of the functions of the driver.
+ */
+typedef enum acc_cmdq_result {
+  kAccCmdqOk    = 0,  /*!< Success. */
+  kAccCmdqFull  = 1,  /*!< No free slot in the command queue. */
+  kAccCmdqEmpty = 2,  /*!< No completion waiting. */
+  kAccCmdqError = 3,  /*!< Wrong argument or unexpected accelerator ID. */
+} acc_cmdq_result_t;
+
+/**
+ * An accelerator behind a command queue.
+ */
+typedef struct acc_cmdq {
+  uintptr_t base;         /*!< Start address of the registers. */
+  uint32_t num_args;      /*!< Arguments of a job. */
+  uint32_t irq;           /*!< PLIC interrupt ID, 0 to poll only. */
+  volatile bool irq_seen; /*!< Set by acc_cmdq_irq_handler(). */
+} acc_cmdq_t;
+
+/**
+ * Completion of a job.
+ */
+typedef struct acc_cmdq_cpl {
+  uint8_t tag;      /*!< Tag given with the job. */
+  uint16_t status;  /*!< Status returned by the accelerator, 0 for success. */
+} acc_cmdq_cpl_t;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Initializes the queue of an accelerator and, with an interrupt, enables it
+ * in the PLIC with handler as its handler. plic_Init() must have been called.
+ * @param q Queue to initialize.
+ * @param base Start address of the registers.
+ * @param id Expected ID of the accelerator.
+ * @param num_args Arguments of a job, up to ACC_CMDQ_MAX_ARGS.
+ * @param irq PLIC interrupt ID, 0 to only poll.
+ * @param handler Handler of the interrupt, calling acc_cmdq_irq_handler().
+ * @return kAccCmdqOk, or kAccCmdqError if the ID does not match.
+ */
+acc_cmdq_result_t acc_cmdq_init(acc_cmdq_t *q, uintptr_t base, uint32_t id, uint32_t num_args,
+                                uint32_t irq, void (*handler)(uint32_t));
+
+/**
+ * Number of jobs that can be queued without waiting.
+ */
+uint32_t acc_cmdq_free_slots(const acc_cmdq_t *q);
+
+/**
+ * Whether the accelerator has jobs in progress or queued.
+ */
+bool acc_cmdq_busy(const acc_cmdq_t *q);
+
+/**
+ * Queues a job, without waiting for the previous ones.
+ * @param q Queue.
+ * @param opcode Operation of the accelerator.
+ * @param tag Returned with the completion of the job.
+ * @param args num_args arguments.
+ * @return kAccCmdqOk, or kAccCmdqFull if the queue has no free slot.
+ */
+acc_cmdq_result_t acc_cmdq_submit(acc_cmdq_t *q, uint8_t opcode, uint8_t tag, const uint32_t *args);
+
+/**
+ * Takes the oldest completion, without waiting.
+ * @return kAccCmdqOk, or kAccCmdqEmpty if no completion is waiting.
+ */
+acc_cmdq_result_t acc_cmdq_poll(acc_cmdq_t *q, acc_cmdq_cpl_t *cpl);
+
+/**
+ * Takes the oldest completion, sleeping until there is one. Without an
+ * interrupt, polls.
+ */
+acc_cmdq_result_t acc_cmdq_wait(acc_cmdq_t *q, acc_cmdq_cpl_t *cpl);
+
+/**
+ * Whether a doorbell was refused because the queue was full, and clears it.
+ */
+bool acc_cmdq_overflow(acc_cmdq_t *q);
+
+/**
+ * To call from the handler of the interrupt of the queue: masks the
+ * interrupt until the next acc_cmdq_wait().
+ */
+void acc_cmdq_irq_handler(acc_cmdq_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_ACC_CMDQ_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
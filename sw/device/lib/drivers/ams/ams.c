@@ -0,0 +1,27 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+#include "ams.h"
+
+static inline volatile uint32_t *ams_reg(uint32_t offset)
+{
+    return (volatile uint32_t *)(AMS_START_ADDRESS + offset);
+}
+
+void ams_set_threshold(ams_threshold_t threshold)
+{
+    *ams_reg(AMS_SEL_REG_OFFSET) = (uint32_t)threshold & AMS_SEL_VALUE_MASK;
+}
+
+ams_threshold_t ams_get_threshold(void)
+{
+    return (ams_threshold_t)(*ams_reg(AMS_SEL_REG_OFFSET) & AMS_SEL_VALUE_MASK);
+}
+
+bool ams_read(void)
+{
+    return (*ams_reg(AMS_GET_REG_OFFSET) >> AMS_GET_VALUE_BIT) & 0x1;
+}
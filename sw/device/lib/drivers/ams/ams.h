@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+/**
+ * @file   ams.h
+ * @brief  Driver of the AMS example peripheral of the testharness
+ *
+ * The AMS peripheral is a 1-bit ADC: a comparator of its analog input with a
+ * threshold of 20%, 40%, 60% or 80% of VDD, simulated with the SPICE model of
+ * hw/ip_examples/ams. Its output is read from the GET register, which the DMA
+ * can copy continuously with ams_stream.h. The peripheral only exists in the
+ * testharness (external peripheral example).
+ */
+
+#ifndef _AMS_H_
+#define _AMS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core_v_mini_mcu.h"
+#include "ams_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// External peripheral 1 of the testharness
+#define AMS_START_ADDRESS (EXT_PERIPHERAL_START_ADDRESS + 0x1000)
+
+// Register of the output, the source of the DMA
+#define AMS_GET_ADDRESS (AMS_START_ADDRESS + AMS_GET_REG_OFFSET)
+
+/**
+ * Threshold of the comparator.
+ */
+typedef enum ams_threshold {
+    AMS_THRESHOLD_20 = 0,  // 20% of VDD
+    AMS_THRESHOLD_40 = 1,
+    AMS_THRESHOLD_60 = 2,
+    AMS_THRESHOLD_80 = 3,
+} ams_threshold_t;
+
+/**
+ * Selects the threshold of the comparator.
+ */
+void ams_set_threshold(ams_threshold_t threshold);
+
+/**
+ * @return The threshold of the comparator.
+ */
+ams_threshold_t ams_get_threshold(void);
+
+/**
+ * @return true if the input is above the threshold.
+ */
+bool ams_read(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // _AMS_H_
@@ -0,0 +1,256 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : cluster_ctrl.c                                               **
+** date     : 14/10/2026                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   cluster_ctrl.c
+* @date   14/10/2026
+* @brief  HAL of the cluster control and fork-join runtime of the harts
+*
+*/
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "cluster_ctrl.h"
+#include "mmio.h"
+#include "csr.h"
+#include "hart.h"
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      DEFINITIONS AND MACROS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+#define CLUSTER_CTRL_BASE mmio_region_from_addr((uintptr_t)CLUSTER_CTRL_START_ADDRESS)
+
+/**
+ * The harts of the cluster, bit h for hart h
+ */
+#define CLUSTER_HARTS_MASK ((1u << NUM_HARTS) - 1)
+
+/**
+ * Software interrupt enable of mie
+ */
+#define CLUSTER_MIE_MSIE (1u << 3)
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+#if NUM_HARTS > 1
+void cluster_hart_main(void) __attribute__((__noreturn__));
+#endif
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Work of the current fork, written by the main core before the barrier that
+ * starts it
+ */
+static volatile cluster_fn_t fork_fn;
+static void * volatile fork_arg;
+static volatile uint32_t fork_harts;
+
+static volatile uint8_t started;
+
+
+/**
+ * Entry of the extra harts, at the boot address of cluster_ctrl. It must be
+ * 256-byte aligned for the cv32e20. Each hart takes its stack at the end of
+ * its slot of hart_stacks (hart h in slot h - 1) and runs cluster_hart_main().
+ */
+#if NUM_HARTS > 1
+__asm__(
+  "  .section .text\n"
+  "  .balign 256\n"
+  "  .global cluster_hart_entry\n"
+  "cluster_hart_entry:\n"
+  "  .option push\n"
+  "  .option norelax\n"
+  "  la gp, __global_pointer$\n"
+  "  .option pop\n"
+  "  csrr t0, mhartid\n"
+  "  la t1, __hart_stacks_start\n"
+  "  la t2, __hart_stack_size\n"
+  "1:\n"
+  "  add t1, t1, t2\n"
+  "  addi t0, t0, -1\n"
+  "  bnez t0, 1b\n"
+  "  mv sp, t1\n"
+  "  j cluster_hart_main\n"
+);
+
+extern void cluster_hart_entry(void);
+#endif
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+cluster_ctrl_result_t cluster_start(void)
+{
+#ifndef CLUSTER_CTRL_IS_INCLUDED
+  return kClusterCtrlNotAvailable;
+#else
+#if NUM_HARTS > 1
+  if (!started) {
+    mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_BARRIER_MASK_REG_OFFSET, CLUSTER_HARTS_MASK);
+    mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_BOOT_ADDR_REG_OFFSET, (uint32_t)(uintptr_t)&cluster_hart_entry);
+    mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_FETCH_EN_REG_OFFSET, CLUSTER_HARTS_MASK);
+    started = 1;
+  }
+#endif
+  return kClusterCtrlOk;
+#endif
+}
+
+cluster_ctrl_result_t cluster_fork(cluster_fn_t fn, void *arg, uint32_t harts)
+{
+  if (harts < 1 || harts > NUM_HARTS) {
+    return kClusterCtrlBadArg;
+  }
+  if (harts == 1) {
+    fn(arg, 0, 1);
+    return kClusterCtrlOk;
+  }
+  if (!started) {
+    return kClusterCtrlNotAvailable;
+  }
+
+  fork_fn = fn;
+  fork_arg = arg;
+  fork_harts = harts;
+
+  // the first barrier starts the fork, the second one joins it
+  cluster_barrier();
+  fn(arg, 0, harts);
+  cluster_barrier();
+
+  return kClusterCtrlOk;
+}
+
+void cluster_barrier(void)
+{
+#if NUM_HARTS > 1
+  uint32_t hart = hart_id();
+  uint32_t gen = mmio_region_read32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_BARRIER_GEN_REG_OFFSET);
+
+  // the writes before the barrier are seen by the harts after it
+  __sync_synchronize();
+  mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_BARRIER_REG_OFFSET, 1u << hart);
+
+  if (hart == 0) {
+    while (mmio_region_read32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_BARRIER_GEN_REG_OFFSET) == gen);
+  } else {
+    // the software interrupt is cleared before checking, so that a barrier
+    // completing in between wakes up the wfi
+    while (1) {
+      mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_SW_IRQ_CLEAR_REG_OFFSET, 1u << hart);
+      if (mmio_region_read32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_BARRIER_GEN_REG_OFFSET) != gen) {
+        break;
+      }
+      wait_for_interrupt();
+    }
+  }
+  __sync_synchronize();
+#endif
+}
+
+void cluster_mutex_lock(uint32_t id)
+{
+  while (!cluster_mutex_trylock(id));
+}
+
+uint32_t cluster_mutex_trylock(uint32_t id)
+{
+  // reading the word takes the mutex, it returns 1 if it was already taken
+  return mmio_region_read32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_MUTEX_REG_OFFSET + 4 * id) == 0;
+}
+
+void cluster_mutex_unlock(uint32_t id)
+{
+  __sync_synchronize();
+  mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_MUTEX_REG_OFFSET + 4 * id, 0);
+}
+
+void cluster_sw_irq_set(uint32_t mask)
+{
+  mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_SW_IRQ_SET_REG_OFFSET, mask);
+}
+
+void cluster_sw_irq_clear(uint32_t mask)
+{
+  mmio_region_write32(CLUSTER_CTRL_BASE, CLUSTER_CTRL_SW_IRQ_CLEAR_REG_OFFSET, mask);
+}
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+#if NUM_HARTS > 1
+/**
+ * Loop of the extra harts: wait for a fork, run it if the hart takes part,
+ * and join. The interrupts stay globally disabled, the software interrupt
+ * only wakes up the wfi of the barrier.
+ */
+void cluster_hart_main(void)
+{
+  uint32_t hart = hart_id();
+
+  CSR_SET_BITS(CSR_REG_MIE, CLUSTER_MIE_MSIE);
+
+  while (1) {
+    cluster_barrier();
+    if (hart < fork_harts) {
+      fork_fn(fork_arg, hart, fork_harts);
+    }
+    cluster_barrier();
+  }
+}
+#endif
+
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,173 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : cluster_ctrl.h                                               **
+** date     : 14/10/2026                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   cluster_ctrl.h
+* @date   14/10/2026
+* @brief  HAL of the cluster control and fork-join runtime of the harts
+*
+* With num_harts > 1 in mcu_cfg.hjson, harts 1 to NUM_HARTS - 1 are extra
+* cores next to the main core (hart 0), on the same bus and sharing the
+* interleaved banks. They stay off until cluster_start() sets their boot
+* address and fetch enable in cluster_ctrl. Each one then takes its stack in
+* the hart_stacks linker section and waits for work.
+*
+* cluster_fork() runs a function on the harts and returns when all of them
+* have finished it (fork-join). The harts synchronise with the barrier of
+* cluster_ctrl: the extra harts sleep in wfi until the barrier wakes them up
+* with their software interrupt, the main core polls. With NUM_HARTS == 1
+* the same calls run the function on the main core alone.
+*/
+
+#ifndef _DRIVERS_CLUSTER_CTRL_H_
+#define _DRIVERS_CLUSTER_CTRL_H_
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cluster_ctrl_regs.h"
+#include "core_v_mini_mcu.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        TYPEDEFS AND STRUCTURES                           */
+/**                                                                        **/
+/****************************************************************************/
+
+
+/**
+ * The result of a cluster operation.
+ */
+typedef enum cluster_ctrl_result {
+  /**
+   * Indicates that the operation succeeded.
+   */
+  kClusterCtrlOk = 0,
+  /**
+   * Indicates that a parameter is out of range.
+   */
+  kClusterCtrlBadArg = 1,
+  /**
+   * Indicates that the cluster is not available: cluster_ctrl is not
+   * included or the harts were not started.
+   */
+  kClusterCtrlNotAvailable = 2,
+} cluster_ctrl_result_t;
+
+/**
+ * Function run by each hart of a fork.
+ * @param arg the argument given to cluster_fork().
+ * @param hart the hart running the function, 0 to harts - 1.
+ * @param harts the number of harts running the function.
+ */
+typedef void (*cluster_fn_t)(void *arg, uint32_t hart, uint32_t harts);
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+
+/**
+ * Starts the extra harts. Called once by the main core, before any fork.
+ * @return kClusterCtrlNotAvailable without cluster_ctrl, kClusterCtrlOk
+ * otherwise (also with NUM_HARTS == 1).
+ */
+cluster_ctrl_result_t cluster_start(void);
+
+/**
+ * Runs fn(arg, hart, harts) on harts 0 to harts - 1, the main core being
+ * hart 0, and returns once all of them have returned. The harts not taking
+ * part stay asleep.
+ * @param fn the function to run.
+ * @param arg its argument.
+ * @param harts the number of harts, 1 to NUM_HARTS.
+ * @return kClusterCtrlBadArg if harts is out of range,
+ * kClusterCtrlNotAvailable if harts > 1 and cluster_start() has not been
+ * called, kClusterCtrlOk otherwise.
+ */
+cluster_ctrl_result_t cluster_fork(cluster_fn_t fn, void *arg, uint32_t harts);
+
+/**
+ * Waits until all the harts of the cluster have reached the barrier. Inside
+ * a function run by cluster_fork() only when it runs on all NUM_HARTS harts.
+ */
+void cluster_barrier(void);
+
+/**
+ * Takes a mutex of cluster_ctrl, waiting until it is free.
+ * @param id the mutex, 0 to CLUSTER_CTRL_MUTEX_SIZE_WORDS - 1.
+ */
+void cluster_mutex_lock(uint32_t id);
+
+/**
+ * Takes a mutex of cluster_ctrl if it is free.
+ * @param id the mutex, 0 to CLUSTER_CTRL_MUTEX_SIZE_WORDS - 1.
+ * @return 1 if the mutex was taken, 0 if it was already taken.
+ */
+uint32_t cluster_mutex_trylock(uint32_t id);
+
+/**
+ * Frees a mutex taken with cluster_mutex_lock() or cluster_mutex_trylock().
+ * @param id the mutex, 0 to CLUSTER_CTRL_MUTEX_SIZE_WORDS - 1.
+ */
+void cluster_mutex_unlock(uint32_t id);
+
+/**
+ * Sets the software interrupts of extra harts, e.g. to wake them up from wfi.
+ * @param mask the harts, bit h for hart h (bit 0 is ignored).
+ */
+void cluster_sw_irq_set(uint32_t mask);
+
+/**
+ * Clears the software interrupts of extra harts.
+ * @param mask the harts, bit h for hart h (bit 0 is ignored).
+ */
+void cluster_sw_irq_clear(uint32_t mask);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_CLUSTER_CTRL_H_
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,75 @@
+// Generated register defines for cluster_ctrl
+
+// Copyright information found in source file:
+// Copyright 2024 EPFL
+
+// Licensing information found in source file:
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef _CLUSTER_CTRL_REG_DEFS_
+#define _CLUSTER_CTRL_REG_DEFS_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// Register width
+#define CLUSTER_CTRL_PARAM_REG_WIDTH 32
+
+// Address where the extra harts start, 256-byte aligned
+#define CLUSTER_CTRL_BOOT_ADDR_REG_OFFSET 0x0
+
+// Harts fetching instructions, bit h for hart h. Hart 0 always fetches,
+// the others start at BOOT_ADDR when their bit is set
+#define CLUSTER_CTRL_FETCH_EN_REG_OFFSET 0x4
+#define CLUSTER_CTRL_FETCH_EN_FETCH_EN_MASK 0xff
+#define CLUSTER_CTRL_FETCH_EN_FETCH_EN_OFFSET 0
+#define CLUSTER_CTRL_FETCH_EN_FETCH_EN_FIELD \
+  ((bitfield_field32_t) { .mask = CLUSTER_CTRL_FETCH_EN_FETCH_EN_MASK, .index = CLUSTER_CTRL_FETCH_EN_FETCH_EN_OFFSET })
+
+// Software interrupts of the extra harts, writing 1 sets the bits
+#define CLUSTER_CTRL_SW_IRQ_SET_REG_OFFSET 0x8
+#define CLUSTER_CTRL_SW_IRQ_SET_SW_IRQ_SET_MASK 0xff
+#define CLUSTER_CTRL_SW_IRQ_SET_SW_IRQ_SET_OFFSET 0
+#define CLUSTER_CTRL_SW_IRQ_SET_SW_IRQ_SET_FIELD \
+  ((bitfield_field32_t) { .mask = CLUSTER_CTRL_SW_IRQ_SET_SW_IRQ_SET_MASK, .index = CLUSTER_CTRL_SW_IRQ_SET_SW_IRQ_SET_OFFSET })
+
+// Software interrupts of the extra harts, writing 1 clears the bits
+#define CLUSTER_CTRL_SW_IRQ_CLEAR_REG_OFFSET 0xc
+#define CLUSTER_CTRL_SW_IRQ_CLEAR_SW_IRQ_CLEAR_MASK 0xff
+#define CLUSTER_CTRL_SW_IRQ_CLEAR_SW_IRQ_CLEAR_OFFSET 0
+#define CLUSTER_CTRL_SW_IRQ_CLEAR_SW_IRQ_CLEAR_FIELD \
+  ((bitfield_field32_t) { .mask = CLUSTER_CTRL_SW_IRQ_CLEAR_SW_IRQ_CLEAR_MASK, .index = CLUSTER_CTRL_SW_IRQ_CLEAR_SW_IRQ_CLEAR_OFFSET })
+
+// Harts taking part in the barrier
+#define CLUSTER_CTRL_BARRIER_MASK_REG_OFFSET 0x10
+#define CLUSTER_CTRL_BARRIER_MASK_BARRIER_MASK_MASK 0xff
+#define CLUSTER_CTRL_BARRIER_MASK_BARRIER_MASK_OFFSET 0
+#define CLUSTER_CTRL_BARRIER_MASK_BARRIER_MASK_FIELD \
+  ((bitfield_field32_t) { .mask = CLUSTER_CTRL_BARRIER_MASK_BARRIER_MASK_MASK, .index = CLUSTER_CTRL_BARRIER_MASK_BARRIER_MASK_OFFSET })
+
+// Harts arrived at the barrier, writing the bit of a hart adds it.
+// Once all the harts of BARRIER_MASK have arrived, BARRIER is cleared,
+// BARRIER_GEN toggles and the software interrupts of the extra harts of
+// BARRIER_MASK are set.
+#define CLUSTER_CTRL_BARRIER_REG_OFFSET 0x14
+#define CLUSTER_CTRL_BARRIER_BARRIER_MASK 0xff
+#define CLUSTER_CTRL_BARRIER_BARRIER_OFFSET 0
+#define CLUSTER_CTRL_BARRIER_BARRIER_FIELD \
+  ((bitfield_field32_t) { .mask = CLUSTER_CTRL_BARRIER_BARRIER_MASK, .index = CLUSTER_CTRL_BARRIER_BARRIER_OFFSET })
+
+// Toggles each time the barrier completes
+#define CLUSTER_CTRL_BARRIER_GEN_REG_OFFSET 0x18
+#define CLUSTER_CTRL_BARRIER_GEN_BARRIER_GEN_BIT 0
+
+// Memory area: Mutexes, one per word. Reading a word returns 0 and takes the
+// mutex if it was free, or returns 1 if it was taken. Writing it frees the
+// mutex.
+#define CLUSTER_CTRL_MUTEX_REG_OFFSET 0x20
+#define CLUSTER_CTRL_MUTEX_SIZE_WORDS 8
+#define CLUSTER_CTRL_MUTEX_SIZE_BYTES 32
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // _CLUSTER_CTRL_REG_DEFS_
+// End generated register defines for cluster_ctrl
\ No newline at end of file
@@ -0,0 +1,268 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : crc.c                                                        **
+** date     : 14/10/2026                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   crc.c
+* @date   14/10/2026
+* @brief  HAL of the CRC peripheral
+*
+*/
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "crc.h"
+#include "mmio.h"
+#include "core_v_mini_mcu.h"
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      DEFINITIONS AND MACROS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+#define CRC_BASE mmio_region_from_addr((uintptr_t)CRC_START_ADDRESS)
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+static uint32_t width_mask(const crc_config_t *config);
+static uint32_t reflect_bits(uint32_t value, uint8_t width);
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+const crc_config_t crc_crc32 = {
+  .width = 32, .reflect = true, .poly = 0x04C11DB7, .init = 0xFFFFFFFF, .xor_out = 0xFFFFFFFF
+};
+
+const crc_config_t crc_crc32c = {
+  .width = 32, .reflect = true, .poly = 0x1EDC6F41, .init = 0xFFFFFFFF, .xor_out = 0xFFFFFFFF
+};
+
+const crc_config_t crc_crc16_ccitt = {
+  .width = 16, .reflect = false, .poly = 0x1021, .init = 0xFFFF, .xor_out = 0
+};
+
+const crc_config_t crc_crc16_arc = {
+  .width = 16, .reflect = true, .poly = 0x8005, .init = 0, .xor_out = 0
+};
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+crc_result_t crc_start(const crc_config_t *config)
+{
+  return crc_resume(config, config->init ^ config->xor_out);
+}
+
+crc_result_t crc_resume(const crc_config_t *config, uint32_t crc)
+{
+  if (config->width != 32 && config->width != 16) {
+    return kCrcBadArg;
+  }
+
+  uint32_t ctrl = (config->width == 16 ? CRC_CTRL_WIDTH_VALUE_16_BITS : CRC_CTRL_WIDTH_VALUE_32_BITS)
+                  << CRC_CTRL_WIDTH_BIT;
+  ctrl |= (config->reflect ? 1 : 0) << CRC_CTRL_REFLECT_BIT;
+  mmio_region_write32(CRC_BASE, CRC_CTRL_REG_OFFSET, ctrl);
+  mmio_region_write32(CRC_BASE, CRC_POLY_REG_OFFSET, config->poly);
+  // the peripheral holds the CRC before the final XOR
+  mmio_region_write32(CRC_BASE, CRC_CRC_REG_OFFSET, crc ^ config->xor_out);
+
+  return kCrcOk;
+}
+
+void crc_update(const void *data, uint32_t length)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+
+  // a byte write adds one byte, a word write four, in the order of the addresses
+  while (length > 0 && ((uintptr_t)bytes & 0x3)) {
+    mmio_region_write8(CRC_BASE, CRC_DATA_REG_OFFSET, *bytes++);
+    length--;
+  }
+  for (; length >= 4; length -= 4, bytes += 4) {
+    mmio_region_write32(CRC_BASE, CRC_DATA_REG_OFFSET, *(const uint32_t *)bytes);
+  }
+  while (length > 0) {
+    mmio_region_write8(CRC_BASE, CRC_DATA_REG_OFFSET, *bytes++);
+    length--;
+  }
+}
+
+crc_result_t crc_update_dma(const void *data, uint32_t length, uint8_t channel)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+
+  // the bytes before the first word
+  uint32_t head = (4 - ((uintptr_t)bytes & 0x3)) & 0x3;
+  if (head > length) {
+    head = length;
+  }
+  crc_update(bytes, head);
+  bytes += head;
+  length -= head;
+
+  dma_target_t tgt_dst;
+  crc_dma_target(&tgt_dst, DMA_DATA_TYPE_WORD);
+
+  // the integrated DMA is used (peri == NULL), the busy channels are kept
+  dma_init(NULL);
+
+  // the DMA driver splits the copies larger than its size register
+  if (length >= 4) {
+    uint32_t words = length >> 2;
+
+    dma_target_t tgt_src = {
+      .ptr = (uint8_t *)bytes,
+      .inc_du = 1,
+      .size_du = words,
+      .type = DMA_DATA_TYPE_WORD,
+      .trig = DMA_TRIG_MEMORY,
+    };
+    dma_trans_t trans = {
+      .src = &tgt_src,
+      .dst = &tgt_dst,
+      .mode = DMA_TRANS_MODE_SINGLE,
+      .end = DMA_TRANS_END_POLLING,
+      .channel = channel,
+    };
+
+    // the destination does not increment, see crc_dma_target()
+    if (dma_validate_transaction(&trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_ONLY_CRITICAL) != DMA_CONFIG_OK
+        || dma_load_transaction(&trans) != DMA_CONFIG_OK
+        || dma_launch(&trans) != DMA_CONFIG_OK) {
+      return kCrcDmaError;
+    }
+    while (!dma_is_ready(channel));
+
+    bytes += words << 2;
+    length -= words << 2;
+  }
+
+  // the bytes after the last word
+  crc_update(bytes, length);
+
+  return kCrcOk;
+}
+
+uint32_t crc_result(const crc_config_t *config)
+{
+  return (mmio_region_read32(CRC_BASE, CRC_CRC_REG_OFFSET) ^ config->xor_out) & width_mask(config);
+}
+
+crc_result_t crc_compute(const crc_config_t *config, const void *data, uint32_t length,
+                         uint8_t channel, uint32_t *crc)
+{
+  crc_result_t res = crc_start(config);
+  if (res != kCrcOk) {
+    return res;
+  }
+  res = crc_update_dma(data, length, channel);
+  if (res != kCrcOk) {
+    return res;
+  }
+  *crc = crc_result(config);
+  return kCrcOk;
+}
+
+uint32_t crc_compute_sw(const crc_config_t *config, const void *data, uint32_t length, uint32_t crc)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t mask = width_mask(config);
+  uint32_t top = 1u << (config->width - 1);
+  uint32_t poly = config->reflect ? reflect_bits(config->poly, config->width) : config->poly & mask;
+  uint32_t c = (crc ^ config->xor_out) & mask;
+
+  // the same steps as the peripheral, one bit at a time
+  for (uint32_t i = 0; i < length; i++) {
+    for (uint32_t b = 0; b < 8; b++) {
+      if (config->reflect) {
+        uint32_t feedback = (c ^ (bytes[i] >> b)) & 1;
+        c >>= 1;
+        if (feedback) c ^= poly;
+      } else {
+        uint32_t feedback = ((c & top) != 0) ^ ((bytes[i] >> (7 - b)) & 1);
+        c = (c << 1) & mask;
+        if (feedback) c ^= poly;
+      }
+    }
+  }
+
+  return (c ^ config->xor_out) & mask;
+}
+
+void crc_dma_target(dma_target_t *target, dma_data_type_t type)
+{
+  *target = (dma_target_t){
+    .ptr = (uint8_t *)CRC_DATA_ADDRESS,
+    .inc_du = 0,
+    .type = type,
+    .trig = DMA_TRIG_MEMORY,
+  };
+}
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static uint32_t width_mask(const crc_config_t *config)
+{
+  return config->width == 16 ? 0xFFFF : 0xFFFFFFFF;
+}
+
+static uint32_t reflect_bits(uint32_t value, uint8_t width)
+{
+  uint32_t r = 0;
+  for (uint8_t i = 0; i < width; i++) {
+    r |= ((value >> i) & 1) << (width - 1 - i);
+  }
+  return r;
+}
+
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
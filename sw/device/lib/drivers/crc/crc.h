@@ -0,0 +1,235 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : crc.h                                                        **
+** date     : 14/10/2026                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   crc.h
+* @date   14/10/2026
+* @brief  HAL of the CRC peripheral
+*
+* The peripheral computes a 32-bit or 16-bit CRC of any polynomial over the
+* bytes written to its DATA window, one write per cycle. The DMA feeds it as a
+* destination that does not increment, from memory or from a peripheral
+* (e.g. the RX FIFO of the SPI host reading the flash), while the CPU goes on.
+* The peripheral is optional (crc in mcu_cfg.hjson), CRC_IS_INCLUDED is then
+* defined by core_v_mini_mcu.h. crc_compute_sw() gives the same results on
+* the CPU, without the peripheral.
+*/
+
+#ifndef _DRIVERS_CRC_H_
+#define _DRIVERS_CRC_H_
+
+/**
+ * Address of the DATA window, to be passed as destination to the DMA
+ */
+#define CRC_DATA_ADDRESS (uint32_t)(CRC_DATA_REG_OFFSET+CRC_START_ADDRESS)
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "crc_regs.h"
+#include "dma.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        TYPEDEFS AND STRUCTURES                           */
+/**                                                                        **/
+/****************************************************************************/
+
+
+/**
+ * The result of a CRC operation.
+ */
+typedef enum crc_result {
+  /**
+   * Indicates that the operation succeeded.
+   */
+  kCrcOk = 0,
+  /**
+   * Indicates that a parameter is out of range.
+   */
+  kCrcBadArg = 1,
+  /**
+   * Indicates that the DMA rejected the transaction.
+   */
+  kCrcDmaError = 2,
+} crc_result_t;
+
+
+/**
+ * Parameters of a CRC, as in the catalogue of parametrised CRC algorithms:
+ * the input bytes and the result are both reflected or both not.
+ */
+typedef struct crc_config {
+  uint8_t width;     // 32 or 16
+  bool reflect;      // Bytes LSB first and reflected result
+  uint32_t poly;     // Normal representation, without the x^width term
+  uint32_t init;     // Initial value
+  uint32_t xor_out;  // XOR of the result
+} crc_config_t;
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED VARIABLES                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * CRC-32 of IEEE 802.3 and zlib, check value 0xCBF43926
+ */
+extern const crc_config_t crc_crc32;
+
+/**
+ * CRC-32C (Castagnoli) of iSCSI and ext4, check value 0xE3069283
+ */
+extern const crc_config_t crc_crc32c;
+
+/**
+ * CRC-16/CCITT-FALSE, check value 0x29B1
+ */
+extern const crc_config_t crc_crc16_ccitt;
+
+/**
+ * CRC-16/ARC (IBM, Modbus with init 0xFFFF), check value 0xBB3D
+ */
+extern const crc_config_t crc_crc16_arc;
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Configure the peripheral and load the initial value of a computation.
+ *
+ * @param config Parameters of the CRC
+ * @return kCrcOk success
+ * @return kCrcBadArg the width is not 32 or 16
+ */
+crc_result_t crc_start(const crc_config_t *config);
+
+/**
+ * Resume a computation from the result of the previous data, so that a CRC
+ * can be computed in pieces: with crc the CRC of some data, resuming from it
+ * and adding more data gives the CRC of both, one after the other.
+ *
+ * @param config Parameters of the CRC
+ * @param crc Result of the previous data, with the final XOR
+ * @return kCrcOk success
+ * @return kCrcBadArg the width is not 32 or 16
+ */
+crc_result_t crc_resume(const crc_config_t *config, uint32_t crc);
+
+/**
+ * Add data to the CRC, written by the CPU: the words, then the bytes around
+ * them.
+ *
+ * @param data Data, of any alignment
+ * @param length Bytes
+ */
+void crc_update(const void *data, uint32_t length);
+
+/**
+ * Add data to the CRC, copied by the DMA into the DATA window. The bytes
+ * before the first word and after the last one are written by the CPU.
+ * Returns once the DMA has finished.
+ *
+ * @param data Data, of any alignment
+ * @param length Bytes
+ * @param channel DMA channel, which must be free
+ * @return kCrcOk success
+ * @return kCrcDmaError the DMA rejected the transaction
+ */
+crc_result_t crc_update_dma(const void *data, uint32_t length, uint8_t channel);
+
+/**
+ * Result of the data added since crc_start().
+ *
+ * @param config Parameters of the CRC given to crc_start()
+ * @return The CRC, with its final XOR
+ */
+uint32_t crc_result(const crc_config_t *config);
+
+/**
+ * CRC of a buffer, with the DMA.
+ *
+ * @param config Parameters of the CRC
+ * @param data Data, of any alignment
+ * @param length Bytes
+ * @param channel DMA channel, which must be free
+ * @param crc Set to the CRC
+ * @return kCrcOk success, or the error of crc_start() or crc_update_dma()
+ */
+crc_result_t crc_compute(const crc_config_t *config, const void *data, uint32_t length,
+                         uint8_t channel, uint32_t *crc);
+
+/**
+ * CRC of a buffer on the CPU, bit by bit, as computed by the peripheral.
+ *
+ * @param config Parameters of the CRC
+ * @param data Data
+ * @param length Bytes
+ * @param crc Result of the previous data as for crc_resume(), or
+ *        config->init ^ config->xor_out for the first
+ * @return The CRC of the previous data and of data
+ */
+uint32_t crc_compute_sw(const crc_config_t *config, const void *data, uint32_t length, uint32_t crc);
+
+/**
+ * Fill a DMA destination target writing into the DATA window.
+ *
+ * The window is a fixed address with no trigger, which dma_validate_transaction()
+ * takes for a memory target without increment: the transactions
+ * writing into it are to be validated with DMA_PERFORM_CHECKS_ONLY_CRITICAL.
+ *
+ * @param target Target to fill
+ * @param type Data type of the writes, each one adding its bytes
+ */
+void crc_dma_target(dma_target_t *target, dma_data_type_t type);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_CRC_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,42 @@
+// Generated register defines for crc
+
+// Copyright information found in source file:
+// Copyright 2024 EPFL
+
+// Licensing information found in source file:
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef _CRC_REG_DEFS_
+#define _CRC_REG_DEFS_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// Register width
+#define CRC_PARAM_REG_WIDTH 32
+
+// Configuration of the CRC, applied to the next writes of DATA
+#define CRC_CTRL_REG_OFFSET 0x0
+#define CRC_CTRL_WIDTH_BIT 0
+#define CRC_CTRL_WIDTH_VALUE_32_BITS 0x0
+#define CRC_CTRL_WIDTH_VALUE_16_BITS 0x1
+#define CRC_CTRL_REFLECT_BIT 1
+
+// Polynomial, in the normal representation (the x^width term is implicit)
+#define CRC_POLY_REG_OFFSET 0x4
+
+// Current CRC, without the final XOR, writing it sets the initial value
+#define CRC_CRC_REG_OFFSET 0x8
+
+// Memory area: Data to add to the CRC, by words, half words or bytes. Each
+// write adds its enabled bytes in the order of their addresses, so the DMA
+// can feed the CRC at this fixed address.
+#define CRC_DATA_REG_OFFSET 0xc
+#define CRC_DATA_SIZE_WORDS 1
+#define CRC_DATA_SIZE_BYTES 4
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // _CRC_REG_DEFS_
+// End generated register defines for crc
@@ -38,8 +38,14 @@
 
 /* To manage interrupts. */
 #include "fast_intr_ctrl.h"
+#include "async.h"
 #include "csr.h"
 #include "stdasm.h"
+#include "sync.h"
+
+/* To keep the clocks of the memory of a transaction on. */
+#include "clk_gate.h"
+#include "ram_bank.h"
 
 /****************************************************************************/
 /**                                                                        **/
@@ -202,26 +208,147 @@ static inline uint8_t is_region_outbound_2D(   uint8_t  *p_start,
  * register.
  * @param p_sel The selection index (i.e. From which bit inside the register
  * the value is to be written).
+ * @param p_peri The registers of the channel to write.
  */
 static inline void write_register(  uint32_t p_val,
                                     uint32_t p_offset,
                                     uint32_t p_mask,
-                                    uint8_t  p_sel );
+                                    uint8_t  p_sel,
+                                    volatile dma *p_peri );
+
 
+/**
+ * @brief Writes a given value into a register that only holds this field.
+ * Unlike write_register(), the register is not read first, so consecutive
+ * writes can be in flight on the peripheral bus at once.
+ * @param p_val The value to be written.
+ * @param p_offset The register's offset from the peripheral's base address
+ *  where the target register is located.
+ * @param p_mask The variable's mask.
+ * @param p_sel The selection index (i.e. From which bit inside the register
+ * the value is to be written).
+ * @param p_peri The registers of the channel to write.
+ */
+static inline void set_register(    uint32_t p_val,
+                                    uint32_t p_offset,
+                                    uint32_t p_mask,
+                                    uint8_t  p_sel,
+                                    volatile dma *p_peri );
 
 /**
  * @brief Analyzes a target to determine the size of its D1 increment (in bytes).
+ * @param p_trans A pointer to the transaction of the target.
  * @param p_tgt A pointer to the target to analyze.
  * @return The number of bytes of the increment.
  */
-static inline uint32_t get_increment_b_1D( dma_target_t * p_tgt );
+static inline uint32_t get_increment_b_1D( dma_trans_t * p_trans, dma_target_t * p_tgt );
 
 /**
  * @brief Analyzes a target to determine the size of its D2 increment (in bytes).
+ * @param p_trans A pointer to the transaction of the target.
  * @param p_tgt A pointer to the target to analyze.
  * @return The number of bytes of the increment.
  */
-static inline uint32_t get_increment_b_2D( dma_target_t * p_tgt );
+static inline uint32_t get_increment_b_2D( dma_trans_t * p_trans, dma_target_t * p_tgt );
+
+/**
+ * @brief Whether the window interrupt can come from a channel: a transaction
+ * with a window and interrupts was loaded in it.
+ * @param p_ch The channel.
+ * @return 1 if the channel is a candidate, 0 otherwise.
+ */
+static inline uint8_t windowed_channel( uint8_t p_ch );
+
+/**
+ * @brief Launches the next chunk of the split transaction of a channel, once
+ * the previous one has been copied. Must be called with the interrupts
+ * disabled.
+ * @param p_ch The channel.
+ */
+static void launch_next_chunk( uint8_t p_ch );
+
+/**
+ * @brief Launches the next plane of the ND transaction of a channel, once
+ * the previous one has been copied. Must be called with the interrupts
+ * disabled.
+ * @param p_ch The channel.
+ */
+static void launch_next_plane( uint8_t p_ch );
+
+/**
+ * @brief Clears the control block and the registers of a channel, unless it
+ * is running a transaction.
+ * @param p_ch The channel, its registers already set in the control block.
+ */
+static void reset_channel( uint8_t p_ch );
+
+/**
+ * @brief Condition of sync_wait() for the transaction of a channel to be
+ * done, i.e. its interrupt flag to be set.
+ * @param p_arg The channel, cast to a pointer.
+ * @return Whether the interrupt flag of the channel is set.
+ */
+static bool intr_flag_set( void *p_arg );
+
+/**
+ * @brief Whether a transaction can go through the wide ports of the DMA into
+ * the interleaved banks: a 1D copy of contiguous words between two buffers of
+ * the wide group, aligned on DMA_WIDE_LANES words, without window nor
+ * in-transfer operation.
+ * @param p_trans A pointer to the validated transaction.
+ * @return 1 if the wide ports can be used, 0 otherwise.
+ */
+static inline uint8_t is_wide_transaction( dma_trans_t * p_trans );
+
+#ifdef DMA_STATS
+/**
+ * @brief Reads the mcycle counter, used by the profiling counters.
+ * @return The lower 32 bits of mcycle.
+ */
+static inline uint32_t stats_cycle( void );
+
+/**
+ * @brief Accounts the end of the transaction running in a channel, if it was
+ * launched by the HAL and its end was not already accounted.
+ * @param p_ch The channel.
+ */
+static void stats_done( uint8_t p_ch );
+
+/**
+ * @brief Accounts the cycles the CPU spent waiting for a channel, to the
+ * channel and to the trigger slot of its transaction.
+ * @param p_ch The channel.
+ * @param p_cycles The number of cycles.
+ */
+static void stats_wait( uint8_t p_ch, uint32_t p_cycles );
+#endif
+
+#ifdef CLK_GATE
+/**
+ * @brief Returns the RAM banks that a target of a transaction can access, all
+ * its rows included, for the clock gating of clk_gate.h.
+ * @param p_trans The transaction.
+ * @param p_tgt The source or the destination of the transaction.
+ * @return Mask of the banks, 0 if the target is a peripheral.
+ */
+static uint32_t clk_banks_of_target( dma_trans_t * p_trans, dma_target_t * p_tgt );
+
+/**
+ * @brief Holds the clocks of the memory of the transaction launched in a
+ * channel until clk_done().
+ * @param p_ch The channel.
+ * @param p_banks Mask of the RAM banks of the transaction.
+ * @param p_plic Whether the transaction has window interrupts, which go
+ * through the PLIC.
+ */
+static void clk_hold( uint8_t p_ch, uint32_t p_banks, uint8_t p_plic );
+
+/**
+ * @brief Gives back the clocks held for the transaction of a channel, once.
+ * @param p_ch The channel.
+ */
+static void clk_done( uint8_t p_ch );
+#endif
 
 
 /****************************************************************************/
@@ -249,17 +376,83 @@ static struct
 
     /**
     * Flag to lower as soon as a transaction is launched, and raised by the
-    * interrupt handler once it has finished. Only used when the end event is
-    * set to INTR_WAIT.
+    * interrupt handler once it has finished. Used by the interrupt handlers
+    * to know which channels were running, and to wait when the end event is
+    * set to INTR_WAIT. Read with sync_load() outside of the handler.
     */
-    uint8_t intrFlag;
+    uint32_t intrFlag;
 
     /**
      * memory mapped structure of a DMA.
      */
-    dma *peri;
+    volatile dma *peri;
+
+    /**
+     * First transaction of the queue, the running one, and last transaction
+     * of the queue. NULL if the queue is empty.
+     */
+    dma_trans_t* queue_head;
+    dma_trans_t* queue_tail;
+
+    /**
+     * Number of queued transactions that have not finished yet. Decreased by
+     * the interrupt handler, read with sync_load() outside of it.
+     */
+    uint32_t queue_length;
+
+    /**
+     * Bytes of a split transaction that are left to launch after the running
+     * chunk, 0 if the running chunk is the last one or the transaction is not
+     * split. The next chunk starts at split_src and split_dst, which move by
+     * split_src_step and split_dst_step bytes every chunk.
+     */
+    uint32_t split_left_b;
+    uint32_t split_src;
+    uint32_t split_dst;
+    uint32_t split_src_step;
+    uint32_t split_dst_step;
+
+    /**
+     * ND transaction whose planes are left to launch after the running one,
+     * NULL if the running plane is the last one or there is none.
+     */
+    dma_nd_trans_t* nd;
+
+    /**
+     * First descriptor of the chain running with an interrupt end, NULL if
+     * there is none.
+     */
+    dma_desc_t* chain;
+
+}dma_cb[DMA_CH_NUM];
+
+/**
+ * The zero read by the planes of the padding of ND transactions. It is not
+ * const, so that it is in RAM also when the program runs from the flash.
+ */
+static uint32_t dma_nd_zero = 0;
+
+#ifdef DMA_STATS
+/**
+ * Profiling counters, see dma_get_stats().
+ */
+static dma_stats_t dma_stats;
+
+/**
+ * Whether each channel runs a transaction launched by the HAL whose end was
+ * not accounted yet.
+ */
+static volatile uint8_t dma_stats_running[DMA_CH_NUM];
+#endif
 
-}dma_cb;
+#ifdef CLK_GATE
+/**
+ * RAM banks whose clocks each channel holds for its transaction, and whether
+ * it holds the one of the PLIC, see clk_hold().
+ */
+static volatile uint32_t dma_clk_banks[DMA_CH_NUM];
+static volatile uint8_t dma_clk_plic[DMA_CH_NUM];
+#endif
 
 
 /****************************************************************************/
@@ -271,57 +464,149 @@ static struct
 void handler_irq_dma(uint32_t id)
 {
     /*
-     * Call the weak implementation provided in this module,
-     * or the non-weak implementation.
+     * The window interrupts of all the channels share the same PLIC line.
+     * The channels with windows are candidates. If there are several, the
+     * WINDOW_DONE bit of their status tells them apart (it is cleared when the
+     * status is read, so it can be missed if dma_is_ready() was called
+     * meanwhile).
      */
-    dma_intr_handler_window_done();
+    uint8_t candidates = 0;
+    for( uint8_t ch = 0; ch < DMA_CH_NUM; ch++ )
+    {
+        candidates += windowed_channel( ch );
+    }
+
+    for( uint8_t ch = 0; ch < DMA_CH_NUM; ch++ )
+    {
+        if(     windowed_channel( ch )
+            && (    ( candidates == 1 )
+                ||  ( dma_cb[ch].peri->STATUS & (1<<DMA_STATUS_WINDOW_DONE_BIT) ) ) )
+        {
+            /*
+             * Call the weak implementations provided in this module,
+             * or the non-weak implementations. The SDK streams are served
+             * before the application.
+             */
+            dma_sdk_intr_handler_window_done( ch );
+            dma_intr_handler_window_done( ch );
+        }
+    }
 }
 
 void fic_irq_dma(void)
 {
-    /* The flag is raised so the waiting loop can be broken.*/
-    dma_cb.intrFlag = 1;
-
     /*
-     * Call the weak implementation provided in this module,
-     * or the non-weak implementation.
+     * The transaction done interrupts of all the channels share the same
+     * fast interrupt. The finished transactions are the ones that were
+     * launched with an interrupt (by the HAL or announced with
+     * dma_expect_trans_done()) and whose channel is ready.
      */
-    dma_sdk_intr_handler_trans_done();
+    for( uint8_t ch = 0; ch < DMA_CH_NUM; ch++ )
+    {
+        /* A channel never initialized has not been launched. */
+        if( dma_cb[ch].peri == NULL )
+        {
+            continue;
+        }
+
+        /*
+         * The end of a chunk of a split transaction or of a plane of an ND
+         * transaction launches the next one (dma_is_ready() does it), the
+         * transaction is not finished yet.
+         */
+        if( ( dma_cb[ch].split_left_b != 0 ) || ( dma_cb[ch].nd != NULL ) )
+        {
+            dma_is_ready( ch );
+            continue;
+        }
+
+        /*
+         * A chain interrupts for its descriptors with the IRQ flag, which
+         * set the LL_IRQ bit of the status, and at its end. The bit is
+         * cleared when the status is read, so the ends of several
+         * descriptors seen by the same interrupt are merged into one call.
+         */
+        if( dma_cb[ch].chain != NULL )
+        {
+            uint32_t status = dma_cb[ch].peri->STATUS;
+            if( !( status & (1<<DMA_STATUS_READY_BIT) ) )
+            {
+                if( status & (1<<DMA_STATUS_LL_IRQ_BIT) )
+                {
+                    dma_sdk_intr_handler_trans_done( ch );
+                }
+                continue;
+            }
+            dma_cb[ch].chain = NULL;
+        }
+
+        if(     ( dma_cb[ch].intrFlag != 0 )
+            ||  (   ( dma_cb[ch].trans != NULL )
+                 && ( dma_cb[ch].trans->end == DMA_TRANS_END_POLLING ) )
+            ||  !dma_is_ready( ch ) )
+        {
+            continue;
+        }
+
+        /* The flag is raised so the waiting loop can be broken.*/
+        dma_cb[ch].intrFlag = 1;
+
+        /*
+         * If the finished transaction is the head of the queue, it is removed
+         * and the next one is launched straight away, before calling the
+         * handler.
+         * The queued transactions were validated when they were enqueued.
+         */
+        if(     ( dma_cb[ch].queue_head != NULL )
+            &&  ( dma_cb[ch].trans == dma_cb[ch].queue_head ) )
+        {
+            dma_cb[ch].queue_head = dma_cb[ch].queue_head->next;
+            dma_cb[ch].queue_length--;
+
+            if( dma_cb[ch].queue_head != NULL )
+            {
+                dma_load_transaction( dma_cb[ch].queue_head );
+                dma_launch( dma_cb[ch].queue_head );
+            }
+            else
+            {
+                dma_cb[ch].queue_tail = NULL;
+            }
+        }
+
+        /*
+         * Call the weak implementation provided in this module,
+         * or the non-weak implementation.
+         */
+        dma_sdk_intr_handler_trans_done( ch );
+
+        /* Complete the future bound to the channel, if any. */
+        async_notify( ASYNC_SOURCE_DMA( ch ), 0 );
+    }
 }
 
 void dma_init( dma *peri )
 {
-    /*
-     * If a DMA peripheral was provided, use that one, otherwise use the
-     * integrated one.
-     */
-    dma_cb.peri = peri ? peri : dma_peri;
+    for( uint8_t ch = 0; ch < DMA_CH_NUM; ch++ )
+    {
+        /*
+         * If a DMA peripheral was provided, use that one, otherwise use the
+         * integrated one. The register blocks of the channels follow each
+         * other, every DMA_CH_SIZE bytes.
+         */
+        dma_cb[ch].peri = peri ? (volatile dma *)( (uint32_t)peri + ch * DMA_CH_SIZE )
+                               : dma_ch_peri( ch );
+        reset_channel( ch );
+    }
+}
 
-    /* Clear the loaded transaction */
-    dma_cb.trans = NULL;
-    /* Clear all values in the DMA registers. */
-    dma_cb.peri->SRC_PTR        = 0;
-    dma_cb.peri->DST_PTR        = 0;
-    dma_cb.peri->ADDR_PTR       = 0;
-    dma_cb.peri->SIZE_D1        = 0;
-    dma_cb.peri->SIZE_D2        = 0;
-    dma_cb.peri->SRC_PTR_INC_D1 = 0;
-    dma_cb.peri->SRC_PTR_INC_D2 = 0;
-    dma_cb.peri->DST_PTR_INC_D1 = 0;
-    dma_cb.peri->DST_PTR_INC_D2 = 0;
-    dma_cb.peri->DIM_CONFIG     = 0;
-    dma_cb.peri->SLOT           = 0;
-    dma_cb.peri->SRC_DATA_TYPE  = 0;
-    dma_cb.peri->DST_DATA_TYPE  = 0;
-    dma_cb.peri->SIGN_EXT       = 0;
-    dma_cb.peri->MODE           = 0;
-    dma_cb.peri->WINDOW_SIZE    = 0;
-    dma_cb.peri->INTERRUPT_EN   = 0;
-    dma_cb.peri->PAD_TOP        = 0;
-    dma_cb.peri->PAD_BOTTOM     = 0;
-    dma_cb.peri->PAD_LEFT       = 0;
-    dma_cb.peri->PAD_RIGHT      = 0;
-    dma_cb.peri->DIM_INV        = 0;
+void dma_init_channel( uint8_t channel )
+{
+    if( dma_cb[channel].peri == NULL )
+    {
+        dma_cb[channel].peri = dma_ch_peri( channel );
+    }
+    reset_channel( channel );
 }
 
 dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
@@ -332,6 +617,14 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
     * SANITY CHECKS
     */
 
+    /* The channel must be one of the DMA. */
+    if( p_trans->channel >= DMA_CH_NUM )
+    {
+        p_trans->flags |= DMA_CONFIG_INCOMPATIBLE;
+        p_trans->flags |= DMA_CONFIG_CRITICAL_ERROR;
+        return p_trans->flags;
+    }
+
     /* Data type is not necessary. If something is provided anyways it should
      be valid.*/
     DMA_STATIC_ASSERT( p_trans->type   < DMA_DATA_TYPE__size,
@@ -364,10 +657,15 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
     /*
      * The transaction is NOT created if the targets include errors.
      * A successful target validation has to be done before loading it to the
-     * DMA.
+     * DMA. Trusted transactions skip it.
      */
-    uint8_t errorSrc = validate_target( p_trans->src );
-    uint8_t errorDst = validate_target( p_trans->dst );
+    uint8_t errorSrc = DMA_CONFIG_OK;
+    uint8_t errorDst = DMA_CONFIG_OK;
+    if( p_check != DMA_PERFORM_CHECKS_ONLY_CRITICAL )
+    {
+        errorSrc = validate_target( p_trans->src );
+        errorDst = validate_target( p_trans->dst );
+    }
 
     /*
      * If there are any errors or warnings in the valdiation of the targets,
@@ -392,7 +690,7 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
      * e.g. It's possible to copy a 1x9 matrix to a 3x3 matrix or to copy a 3x3 matrix to a 1x9 one.
      */
 
-    if (p_check)
+    if( p_check == DMA_PERFORM_CHECKS_INTEGRITY )
     {
         // If the transaction is 2D, check that the D2 increment of the targets are non zero.
         // If the transaction is 1D, check that the D2 increment of the targets are zero.
@@ -409,7 +707,7 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
      * CHECK IF THERE ARE PADDING INCONSISTENCIES
      */
 
-    if (p_check)
+    if( p_check == DMA_PERFORM_CHECKS_INTEGRITY )
     {
         // If the transaction is 1D, check that the top and bottom paddings are set to zero.
         if((p_trans->dim == DMA_DIM_CONF_1D && (p_trans->pad_top_du != 0 || p_trans->pad_bottom_du != 0)))
@@ -431,7 +729,7 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
      * inconsistency is probably a result of an error (likely wrong target
      * selection).
      */
-    if( p_check )
+    if( p_check == DMA_PERFORM_CHECKS_INTEGRITY )
     {
         if(     p_trans->src->trig != DMA_TRIG_MEMORY
             &&  p_trans->dst->trig != DMA_TRIG_MEMORY )
@@ -454,7 +752,7 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
      * This issue is less likely to happen with a properly set Memory-to-peripheral
      * configuration, so circular mode is allowed.
      */
-    if( p_check )
+    if( p_check == DMA_PERFORM_CHECKS_INTEGRITY )
     {
         if(    p_trans->src->trig == DMA_TRIG_MEMORY
             && p_trans->dst->trig == DMA_TRIG_MEMORY
@@ -489,11 +787,42 @@ dma_config_flags_t dma_validate_transaction(    dma_trans_t        *p_trans,
      */
     p_trans->inc_b = 0;
 
+    /*
+     * CHECK IF THE SIZES FIT THE REGISTERS
+     */
+
+    /*
+     * The SIZE_D1 and SIZE_D2 registers have 16 bits. A 1D copy in single mode
+     * that is larger is split into chunks by dma_launch(), as nothing but the
+     * pointers changes from one chunk to the next. The other transactions
+     * have to fit, as their windows, paddings, address lists or second
+     * dimension would be cut by the chunks.
+     */
+    if(     ( p_trans->size_b > DMA_SIZE_D1_SIZE_MASK )
+        &&  (   ( p_trans->dim          != DMA_DIM_CONF_1D )
+             || ( p_trans->mode         != DMA_TRANS_MODE_SINGLE )
+             || ( p_trans->win_du       != 0 )
+             || ( p_trans->pad_left_du  != 0 )
+             || ( p_trans->pad_right_du != 0 ) ) )
+    {
+        p_trans->flags |= DMA_CONFIG_INCOMPATIBLE;
+        p_trans->flags |= DMA_CONFIG_CRITICAL_ERROR;
+        return p_trans->flags;
+    }
+
+    if(     ( p_trans->dim == DMA_DIM_CONF_2D )
+        &&  ( p_trans->size_d2_b > DMA_SIZE_D2_SIZE_MASK ) )
+    {
+        p_trans->flags |= DMA_CONFIG_SRC;
+        p_trans->flags |= DMA_CONFIG_CRITICAL_ERROR;
+        return p_trans->flags;
+    }
+
     /*
      * CHECK IF THERE ARE MISALIGNMENTS
      */
 
-    if( p_check  )
+    if( p_check == DMA_PERFORM_CHECKS_INTEGRITY )
     {
         /*
          * The source and destination targets are analyzed.
@@ -720,6 +1049,14 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
      * CHECK FOR CRITICAL ERRORS
      */
 
+    /* The channel indexes the control blocks, so it is checked first. */
+    if( p_trans->channel >= DMA_CH_NUM )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    uint8_t ch = p_trans->channel;
+
     /*
      * The transaction is not allowed if it contain a critical error.
      * A successful transaction creation has to be done before loading it to
@@ -727,7 +1064,7 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
      */
     if( p_trans->flags & DMA_CONFIG_CRITICAL_ERROR )
     {
-        dma_cb.trans = NULL;
+        dma_cb[ch].trans = NULL;
         return DMA_CONFIG_CRITICAL_ERROR;
     }
 
@@ -742,13 +1079,20 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
      * until it has ended.
      * Transactions can still be validated in the meantime.
      */
-    if( !dma_is_ready() )
+    if( !dma_is_ready( ch ) )
     {
         return DMA_CONFIG_TRANS_OVERRIDE;
     }
 
     /* Save the current transaction */
-    dma_cb.trans = p_trans;
+    dma_cb[ch].trans = p_trans;
+
+#ifdef DMA_STATS
+    dma_stats.channel[ch].load_cycle = stats_cycle();
+#endif
+
+    /* The transaction is not running until it is launched. */
+    dma_cb[ch].intrFlag = 1;
 
     /*
      * ENABLE/DISABLE INTERRUPTS
@@ -758,35 +1102,44 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
      * If the selected en event is polling, interrupts are disabled.
      * Otherwise the mie.MEIE bit is set to one to enable machine-level
      * fast DMA interrupt.
+     * The fast interrupt is shared by all the channels, so it is left
+     * enabled for the other ones.
      */
-    dma_cb.peri->INTERRUPT_EN = INTR_EN_NONE;
-    CSR_CLEAR_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+    /*
+     * The enables are gathered and written at once, as the other registers,
+     * so that the writes of the load follow each other on the peripheral bus
+     * without waiting for a read.
+     */
+    uint32_t intr_en = INTR_EN_NONE;
 
-    if( dma_cb.trans->end != DMA_TRANS_END_POLLING )
+    if( dma_cb[ch].trans->end != DMA_TRANS_END_POLLING )
     {
         /* Enable global interrupt. */
         CSR_SET_BITS(CSR_REG_MSTATUS, 0x8 );
         /* Enable machine-level fast interrupt. */
         CSR_SET_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
 
-        write_register(  
-                        0x1,
-                        DMA_INTERRUPT_EN_REG_OFFSET,
-                        0xffff,
-                        DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT
-                    );
+        intr_en |= 1 << DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT;
 
         /* Only if a window is used should the window interrupt be set. */
         if( p_trans->win_du > 0 )
         {
-            write_register(  
-                        0x1,
-                        DMA_INTERRUPT_EN_REG_OFFSET,
-                        0xffff,
-                        DMA_INTERRUPT_EN_WINDOW_DONE_BIT
-                    );
+            intr_en |= 1 << DMA_INTERRUPT_EN_WINDOW_DONE_BIT;
         }
     }
+    else if( p_trans->size_b > DMA_SIZE_D1_SIZE_MASK )
+    {
+        /*
+         * The chunks of a split transaction are launched by the interrupt
+         * as soon as possible, even if the end is polled. The global enable
+         * is left as it is, dma_is_ready() launches them otherwise.
+         */
+        CSR_SET_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+
+        intr_en |= 1 << DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT;
+    }
+
+    dma_cb[ch].peri->INTERRUPT_EN = intr_en;
 
     /*
      * SET THE PADDING
@@ -804,56 +1157,62 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
         p_trans->src->inc_d2_du = DMA_DATA_TYPE_2_SIZE( p_trans->dst_type );
     }
 
-    if (dma_cb.trans->pad_top_du != 0 || dma_cb.trans->pad_bottom_du != 0 || dma_cb.trans->pad_left_du != 0 || dma_cb.trans->pad_right_du != 0)
-    {
-        write_register( dma_cb.trans->pad_top_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
-                        DMA_PAD_TOP_REG_OFFSET,
-                        DMA_PAD_TOP_PAD_MASK,
-                        DMA_PAD_TOP_PAD_OFFSET);
-
-        write_register( dma_cb.trans->pad_bottom_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
-                        DMA_PAD_BOTTOM_REG_OFFSET,
-                        DMA_PAD_BOTTOM_PAD_MASK,
-                        DMA_PAD_BOTTOM_PAD_OFFSET);
-
-        write_register( dma_cb.trans->pad_left_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
-                        DMA_PAD_LEFT_REG_OFFSET,
-                        DMA_PAD_LEFT_PAD_MASK,
-                        DMA_PAD_LEFT_PAD_OFFSET);
-
-        write_register( dma_cb.trans->pad_right_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
-                        DMA_PAD_RIGHT_REG_OFFSET,
-                        DMA_PAD_RIGHT_PAD_MASK,
-                        DMA_PAD_RIGHT_PAD_OFFSET);
-    }
+    /*
+     * The paddings are always written, so that a transaction without padding
+     * does not inherit the paddings of the previous one.
+     */
+    set_register( dma_cb[ch].trans->pad_top_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
+                    DMA_PAD_TOP_REG_OFFSET,
+                    DMA_PAD_TOP_PAD_MASK,
+                    DMA_PAD_TOP_PAD_OFFSET,
+                    dma_cb[ch].peri);
+
+    set_register( dma_cb[ch].trans->pad_bottom_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
+                    DMA_PAD_BOTTOM_REG_OFFSET,
+                    DMA_PAD_BOTTOM_PAD_MASK,
+                    DMA_PAD_BOTTOM_PAD_OFFSET,
+                    dma_cb[ch].peri);
+
+    set_register( dma_cb[ch].trans->pad_left_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
+                    DMA_PAD_LEFT_REG_OFFSET,
+                    DMA_PAD_LEFT_PAD_MASK,
+                    DMA_PAD_LEFT_PAD_OFFSET,
+                    dma_cb[ch].peri);
+
+    set_register( dma_cb[ch].trans->pad_right_du * DMA_DATA_TYPE_2_SIZE( p_trans->dst_type ),
+                    DMA_PAD_RIGHT_REG_OFFSET,
+                    DMA_PAD_RIGHT_PAD_MASK,
+                    DMA_PAD_RIGHT_PAD_OFFSET,
+                    dma_cb[ch].peri);
 
     /*
      * SET THE POINTERS
      */
-    dma_cb.peri->SRC_PTR = (uint32_t)dma_cb.trans->src->ptr;
+    dma_cb[ch].peri->SRC_PTR = (uint32_t)dma_cb[ch].trans->src->ptr;
 
-    if(dma_cb.trans->mode != DMA_TRANS_MODE_ADDRESS)
+    if(dma_cb[ch].trans->mode != DMA_TRANS_MODE_ADDRESS)
     {
         /*
         Write to the destination pointers only if we are not in address mode,
         otherwise the destination address is read in a separate port in parallel with the data
         from the address port
         */
-        dma_cb.peri->DST_PTR = (uint32_t)dma_cb.trans->dst->ptr;
+        dma_cb[ch].peri->DST_PTR = (uint32_t)dma_cb[ch].trans->dst->ptr;
     }
     else
     {
-        dma_cb.peri->ADDR_PTR = (uint32_t)dma_cb.trans->src_addr->ptr;
+        dma_cb[ch].peri->ADDR_PTR = (uint32_t)dma_cb[ch].trans->src_addr->ptr;
     }
 
     /*
      * SET THE TRANSPOSITION MODE
      */
 
-    write_register(dma_cb.trans->dim_inv,
+    set_register(dma_cb[ch].trans->dim_inv,
                    DMA_DIM_INV_REG_OFFSET,
                    0x1 << DMA_DIM_INV_SEL_BIT,
-                   DMA_DIM_INV_SEL_BIT);
+                   DMA_DIM_INV_SEL_BIT,
+                   dma_cb[ch].peri);
 
     /*
      * SET THE INCREMENTS
@@ -870,32 +1229,36 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
      * In case of a 2D DMA transaction, the second dimension increment is set.
      */
     
-    write_register(  get_increment_b_1D( dma_cb.trans->src ),
+    set_register(  get_increment_b_1D( dma_cb[ch].trans, dma_cb[ch].trans->src ),
                     DMA_SRC_PTR_INC_D1_REG_OFFSET,
                     DMA_SRC_PTR_INC_D1_INC_MASK,
-                    DMA_SRC_PTR_INC_D1_INC_OFFSET );
+                    DMA_SRC_PTR_INC_D1_INC_OFFSET,
+                    dma_cb[ch].peri );
 
-    if(dma_cb.trans->dim == DMA_DIM_CONF_2D)
+    if(dma_cb[ch].trans->dim == DMA_DIM_CONF_2D)
     {
-        write_register(  get_increment_b_2D( dma_cb.trans->src ),
+        set_register(  get_increment_b_2D( dma_cb[ch].trans, dma_cb[ch].trans->src ),
                         DMA_SRC_PTR_INC_D2_REG_OFFSET,
                         DMA_SRC_PTR_INC_D2_INC_MASK,
-                        DMA_SRC_PTR_INC_D2_INC_OFFSET );
+                        DMA_SRC_PTR_INC_D2_INC_OFFSET,
+                        dma_cb[ch].peri );
     }
 
-    if(dma_cb.trans->mode != DMA_TRANS_MODE_ADDRESS)
+    if(dma_cb[ch].trans->mode != DMA_TRANS_MODE_ADDRESS)
     {
-        write_register(  get_increment_b_1D( dma_cb.trans->dst ),
+        set_register(  get_increment_b_1D( dma_cb[ch].trans, dma_cb[ch].trans->dst ),
                         DMA_DST_PTR_INC_D1_REG_OFFSET,
                         DMA_DST_PTR_INC_D1_INC_MASK,
-                        DMA_DST_PTR_INC_D1_INC_OFFSET );
+                        DMA_DST_PTR_INC_D1_INC_OFFSET,
+                        dma_cb[ch].peri );
         
-        if(dma_cb.trans->dim == DMA_DIM_CONF_2D)
+        if(dma_cb[ch].trans->dim == DMA_DIM_CONF_2D)
         {
-            write_register(  get_increment_b_2D( dma_cb.trans->dst ),
+            set_register(  get_increment_b_2D( dma_cb[ch].trans, dma_cb[ch].trans->dst ),
                         DMA_DST_PTR_INC_D2_REG_OFFSET,
                         DMA_DST_PTR_INC_D2_INC_MASK,
-                        DMA_DST_PTR_INC_D2_INC_OFFSET );
+                        DMA_DST_PTR_INC_D2_INC_OFFSET,
+                        dma_cb[ch].peri );
         }
     }
 
@@ -903,53 +1266,86 @@ dma_config_flags_t dma_load_transaction( dma_trans_t *p_trans )
      * SET THE OPERATION MODE AND WINDOW SIZE
      */
 
-    dma_cb.peri->MODE = dma_cb.trans->mode;
+    dma_cb[ch].peri->MODE = dma_cb[ch].trans->mode;
     /* The window size is set to the transaction size if it was set to 0 in
     order to disable the functionality (it will never be triggered). */
 
-    dma_cb.peri->WINDOW_SIZE =   dma_cb.trans->win_du
-                            ? dma_cb.trans->win_du
-                            : dma_cb.trans->size_b;
+    dma_cb[ch].peri->WINDOW_SIZE =   dma_cb[ch].trans->win_du
+                            ? dma_cb[ch].trans->win_du
+                            : dma_cb[ch].trans->size_b;
 
     /* 
      * SET THE DIMENSIONALITY
      */
-    write_register(  dma_cb.trans->dim,
+    set_register(  dma_cb[ch].trans->dim,
                     DMA_DIM_CONFIG_REG_OFFSET,
                     0x1 << DMA_DIM_CONFIG_DMA_DIM_BIT,
-                    DMA_DIM_CONFIG_DMA_DIM_BIT );
+                    DMA_DIM_CONFIG_DMA_DIM_BIT,
+                    dma_cb[ch].peri );
 
     /*
      * SET THE SIGN EXTENSION BIT
      */
-    write_register( dma_cb.trans->sign_ext,
+    set_register( dma_cb[ch].trans->sign_ext,
                     DMA_SIGN_EXT_REG_OFFSET,
                     0x1 << DMA_SIGN_EXT_SIGNED_BIT,
-                    DMA_SIGN_EXT_SIGNED_BIT );
+                    DMA_SIGN_EXT_SIGNED_BIT,
+                    dma_cb[ch].peri );
 
 
     /*
      * SET TRIGGER SLOTS AND DATA TYPE
      */
-    write_register(  dma_cb.trans->src->trig,
-                    DMA_SLOT_REG_OFFSET,
-                    DMA_SLOT_RX_TRIGGER_SLOT_MASK,
-                    DMA_SLOT_RX_TRIGGER_SLOT_OFFSET );
+    dma_cb[ch].peri->SLOT =
+        ( ( dma_cb[ch].trans->src->trig & DMA_SLOT_RX_TRIGGER_SLOT_MASK )
+            << DMA_SLOT_RX_TRIGGER_SLOT_OFFSET )
+        | ( ( dma_cb[ch].trans->dst->trig & DMA_SLOT_TX_TRIGGER_SLOT_MASK )
+            << DMA_SLOT_TX_TRIGGER_SLOT_OFFSET );
 
-    write_register(  dma_cb.trans->dst->trig,
-                    DMA_SLOT_REG_OFFSET,
-                    DMA_SLOT_TX_TRIGGER_SLOT_MASK,
-                    DMA_SLOT_TX_TRIGGER_SLOT_OFFSET );
-
-    write_register(  dma_cb.trans->dst_type,
+    set_register(  dma_cb[ch].trans->dst_type,
                     DMA_DST_DATA_TYPE_REG_OFFSET,
                     DMA_DST_DATA_TYPE_DATA_TYPE_MASK,
-                    DMA_SELECTION_OFFSET_START );
+                    DMA_SELECTION_OFFSET_START,
+                    dma_cb[ch].peri );
     
-    write_register(  dma_cb.trans->src_type,
+    set_register(  dma_cb[ch].trans->src_type,
                     DMA_SRC_DATA_TYPE_REG_OFFSET,
                     DMA_SRC_DATA_TYPE_DATA_TYPE_MASK,
-                    DMA_SELECTION_OFFSET_START );
+                    DMA_SELECTION_OFFSET_START,
+                    dma_cb[ch].peri );
+
+    /*
+     * SET THE IN-TRANSFER OPERATIONS
+     */
+
+    /*
+     * Like WIDE, OP_CTRL is always written so that a transaction does not
+     * inherit the operations of the previous one.
+     */
+    if( dma_cb[ch].trans->ops.en )
+    {
+        dma_cb[ch].peri->OP_SCALE   = (uint16_t)dma_cb[ch].trans->ops.scale;
+        dma_cb[ch].peri->OP_ADD     = dma_cb[ch].trans->ops.add;
+        dma_cb[ch].peri->OP_MIN     = dma_cb[ch].trans->ops.min;
+        dma_cb[ch].peri->OP_MAX     = dma_cb[ch].trans->ops.max;
+    }
+    dma_cb[ch].peri->OP_CTRL = dma_cb[ch].trans->ops.en
+        | ( ( dma_cb[ch].trans->ops.shift & DMA_OP_CTRL_SHIFT_MASK )
+            << DMA_OP_CTRL_SHIFT_OFFSET );
+
+    /*
+     * SET THE WIDE TRANSFER BIT
+     */
+
+    /*
+     * It is always written, so that a transaction does not inherit the mode
+     * of the previous one, and before SIZE_D1, which starts the transaction.
+     */
+    set_register(  is_wide_transaction( dma_cb[ch].trans ),
+                    DMA_WIDE_REG_OFFSET,
+                    0x1 << DMA_WIDE_EN_BIT,
+                    DMA_WIDE_EN_BIT,
+                    dma_cb[ch].peri );
 
     return DMA_CONFIG_OK;
 }
@@ -962,11 +1358,14 @@ dma_config_flags_t dma_launch( dma_trans_t *p_trans)
      * launched.
      */
     if(     ( p_trans == NULL )
-        ||  ( dma_cb.trans != p_trans ) ) // @ToDo: Check per-element.
+        ||  ( p_trans->channel >= DMA_CH_NUM )
+        ||  ( dma_cb[p_trans->channel].trans != p_trans ) ) // @ToDo: Check per-element.
     {
         return DMA_CONFIG_CRITICAL_ERROR;
     }
 
+    uint8_t ch = p_trans->channel;
+
     /*
      * CHECK IF THERE IS A TRANSACTION RUNNING
      */
@@ -978,7 +1377,7 @@ dma_config_flags_t dma_launch( dma_trans_t *p_trans)
      * until it has ended.
      * Transactions can still be validated in the meantime.
      */
-    if( !dma_is_ready() )
+    if( !dma_is_ready( ch ) )
     {
         return DMA_CONFIG_TRANS_OVERRIDE;
     }
@@ -987,94 +1386,669 @@ dma_config_flags_t dma_launch( dma_trans_t *p_trans)
      * This has to be done prior to writing the register because otherwise
      * the interrupt could arrive before it is lowered.
      */
-    dma_cb.intrFlag = 0;
+    dma_cb[ch].intrFlag = 0;
+
+#ifdef DMA_STATS
+    dma_stats.channel[ch].launch_cycle = stats_cycle();
+    dma_stats.channel[ch].setup_cycles += dma_stats.channel[ch].launch_cycle
+                                        - dma_stats.channel[ch].load_cycle;
+    dma_stats_running[ch] = 1;
+#endif
+
+#ifdef CLK_GATE
+    /*
+     * In address mode the destinations are read from memory, they can be
+     * anywhere.
+     */
+    clk_hold( ch,
+              p_trans->mode == DMA_TRANS_MODE_ADDRESS
+                ? RAM_BANKS_ALL
+                : clk_banks_of_target( p_trans, p_trans->src )
+                  | clk_banks_of_target( p_trans, p_trans->dst ),
+              p_trans->win_du != 0 );
+#endif
+
+    /*
+     * The buffers written before the launch are seen by the DMA, and the
+     * compiler does not move their accesses after the size write.
+     */
+    sync_fence_dma_start();
 
     /* Load the size(s) and start the transaction. */
 
-    if(dma_cb.trans->dim == DMA_DIM_CONF_2D)
+    if(dma_cb[ch].trans->dim == DMA_DIM_CONF_2D)
     {
-        write_register( dma_cb.trans->size_d2_b,
+        set_register( dma_cb[ch].trans->size_d2_b,
                         DMA_SIZE_D2_REG_OFFSET,
                         DMA_SIZE_D2_SIZE_MASK,
-                        DMA_SIZE_D2_SIZE_OFFSET
+                        DMA_SIZE_D2_SIZE_OFFSET,
+                        dma_cb[ch].peri
                       );
     }
 
-    write_register( dma_cb.trans->size_b,
+    /*
+     * A transaction larger than SIZE_D1 is launched as its first chunk. The
+     * next chunks are recorded before the launch, as the interrupt of the
+     * first one could arrive right after.
+     */
+    uint32_t size_b = dma_cb[ch].trans->size_b;
+    dma_cb[ch].split_left_b = 0;
+
+    if( size_b > DMA_SIZE_D1_SIZE_MASK )
+    {
+        uint32_t chunk_du = DMA_SPLIT_CHUNK_B
+                          / DMA_DATA_TYPE_2_SIZE( dma_cb[ch].trans->dst_type );
+
+        dma_cb[ch].split_src_step = chunk_du * get_increment_b_1D( dma_cb[ch].trans,
+                                                                   dma_cb[ch].trans->src );
+        dma_cb[ch].split_dst_step = chunk_du * get_increment_b_1D( dma_cb[ch].trans,
+                                                                   dma_cb[ch].trans->dst );
+        dma_cb[ch].split_src = (uint32_t)dma_cb[ch].trans->src->ptr
+                             + dma_cb[ch].split_src_step;
+        dma_cb[ch].split_dst = (uint32_t)dma_cb[ch].trans->dst->ptr
+                             + dma_cb[ch].split_dst_step;
+        dma_cb[ch].split_left_b = size_b - DMA_SPLIT_CHUNK_B;
+        size_b = DMA_SPLIT_CHUNK_B;
+    }
+
+    set_register( size_b,
                 DMA_SIZE_D1_REG_OFFSET,
                 DMA_SIZE_D1_SIZE_MASK,
-                DMA_SIZE_D1_SIZE_OFFSET
+                DMA_SIZE_D1_SIZE_OFFSET,
+                dma_cb[ch].peri
     ); 
     /*
      * If the end event was set to wait for the interrupt, the dma_launch
      * will not return until the interrupt arrives.
      */
 
-    
-    while(    p_trans->end == DMA_TRANS_END_INTR_WAIT
-          && ( dma_cb.intrFlag != 0x0 ) ) {
-            wait_for_interrupt();
+#ifdef DMA_STATS
+    uint32_t wait_start = stats_cycle();
+#endif
+
+    /*
+     * sync_wait() checks the flag with the interrupts disabled, so the
+     * interrupt cannot arrive between the check and the wfi.
+     */
+    if( p_trans->end == DMA_TRANS_END_INTR_WAIT )
+    {
+        sync_wait( intr_flag_set, (void *)(uintptr_t)ch );
+    }
+
+#ifdef DMA_STATS
+    if( p_trans->end == DMA_TRANS_END_INTR_WAIT )
+    {
+        stats_wait( ch, stats_cycle() - wait_start );
     }
+#endif
 
     return DMA_CONFIG_OK;
 }
 
-__attribute__((optimize("O0"))) uint32_t dma_is_ready(void)
+dma_config_flags_t dma_enqueue_transaction( dma_trans_t       *p_trans,
+                                            dma_en_realign_t  p_enRealign,
+                                            dma_perf_checks_t p_check )
 {
-    /* The transaction READY bit is read from the status register*/
-    uint32_t ret = ( dma_cb.peri->STATUS & (1<<DMA_STATUS_READY_BIT) );
-    return ret;
-}
-/* @ToDo: Reconsider this decision.
- * In case a return wants to be forced in case of an error, there are 2
- * alternatives:
- *    1) Consider any value != 0 to be a valid 1 using a LOGIC AND:
- *  return ( 1 && dma_cb.peri->DONE );
- *    2) Consider only the LSB == 1 to be a valid 1 using a BITWISE AND.
- *  return ( 1 &  dma_cb.peri->DONE );
- * This would be fixed if the DONE register was a 1 bit field.
- */
+    /*
+     * The next transaction is launched by the transaction done interrupt, so
+     * the queued transactions cannot end by polling nor wait for their own
+     * interrupt inside the handler.
+     */
+    p_trans->end  = DMA_TRANS_END_INTR;
+    p_trans->next = NULL;
 
+    /*
+     * The transaction is validated only once, here, and not again when it is
+     * launched from the interrupt handler. This also checks its channel.
+     */
+    dma_validate_transaction( p_trans, p_enRealign, p_check );
 
-uint32_t dma_get_window_count()
-{
-    return dma_cb.peri->WINDOW_COUNT;
-}
+    /* A circular transaction never ends, so it would block the queue. */
+    if( p_trans->mode == DMA_TRANS_MODE_CIRCULAR )
+    {
+        p_trans->flags |= ( DMA_CONFIG_INCOMPATIBLE | DMA_CONFIG_CRITICAL_ERROR );
+    }
+
+    if( p_trans->flags & DMA_CONFIG_CRITICAL_ERROR )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
 
+    uint8_t ch = p_trans->channel;
+
+    /* A transaction that does not belong to the queue is running. */
+    if( ( dma_cb[ch].queue_head == NULL ) && !dma_is_ready( ch ) )
+    {
+        return DMA_CONFIG_TRANS_OVERRIDE;
+    }
 
-void dma_stop_circular()
-{
     /*
-     * The DMA finishes the current transaction before and does not start
-     * a new one.
+     * The DMA interrupt is masked while the queue is modified, so the handler
+     * cannot remove the last transaction in the meantime. If that transaction
+     * finishes, the interrupt is served once it is unmasked, and launches
+     * the new one.
      */
-    dma_cb.peri->MODE = DMA_TRANS_MODE_SINGLE;
+    CSR_CLEAR_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+
+    if( dma_cb[ch].queue_head == NULL )
+    {
+        dma_cb[ch].queue_head   = p_trans;
+        dma_cb[ch].queue_tail   = p_trans;
+        dma_cb[ch].queue_length = 1;
+
+        /* Loading the transaction unmasks the DMA interrupt again. */
+        dma_load_transaction( p_trans );
+        dma_launch( p_trans );
+    }
+    else
+    {
+        dma_cb[ch].queue_tail->next = p_trans;
+        dma_cb[ch].queue_tail       = p_trans;
+        dma_cb[ch].queue_length++;
+
+        CSR_SET_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+    }
+
+    return p_trans->flags;
 }
 
+uint32_t dma_queue_length( uint8_t channel )
+{
+    return sync_load( &dma_cb[channel].queue_length );
+}
 
-__attribute__((weak, optimize("O0"))) void dma_sdk_intr_handler_trans_done()
+void dma_queue_wait( uint8_t channel )
+{
+#ifdef DMA_STATS
+    uint32_t wait_start = stats_cycle();
+#endif
+
+    /*
+     * The global interrupts are disabled around the check, so the last
+     * interrupt cannot arrive between the check and the wfi. A pending
+     * interrupt still wakes the CPU up, and is served once they are enabled.
+     */
+    while( sync_load( &dma_cb[channel].queue_length ) != 0 )
+    {
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8 );
+        if( sync_load( &dma_cb[channel].queue_length ) != 0 )
+        {
+            wait_for_interrupt();
+        }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8 );
+    }
+
+#ifdef DMA_STATS
+    stats_wait( channel, stats_cycle() - wait_start );
+#endif
+}
+
+dma_config_flags_t dma_validate_nd( dma_nd_trans_t    *p_nd,
+                                    dma_perf_checks_t p_check )
+{
+    p_nd->flags = DMA_CONFIG_OK;
+
+    if(     ( p_nd->dims == 0 )
+        ||  ( p_nd->dims > DMA_ND_MAX_DIMS ) )
+    {
+        p_nd->flags |= ( DMA_CONFIG_INCOMPATIBLE | DMA_CONFIG_CRITICAL_ERROR );
+        return p_nd->flags;
+    }
+
+    /* The missing dimensions have a single element, right after the previous one. */
+    for( uint8_t d = p_nd->dims; d < DMA_ND_MAX_DIMS; d++ )
+    {
+        dma_nd_dim_t *prev = &p_nd->dim[d - 1];
+        p_nd->dim[d] = (dma_nd_dim_t){
+            .size_du    = 1,
+            .src_inc_du = prev->size_du * prev->src_inc_du,
+            .dst_inc_du = ( prev->pad_before_du + prev->size_du + prev->pad_after_du )
+                        * prev->dst_inc_du,
+        };
+    }
+
+    p_nd->planes = 1;
+    for( uint8_t d = 0; d < DMA_ND_MAX_DIMS; d++ )
+    {
+        if( p_nd->dim[d].size_du == 0 )
+        {
+            p_nd->flags |= ( DMA_CONFIG_SRC | DMA_CONFIG_CRITICAL_ERROR );
+            return p_nd->flags;
+        }
+        if( d >= 2 )
+        {
+            p_nd->planes *=   p_nd->dim[d].pad_before_du + p_nd->dim[d].size_du
+                            + p_nd->dim[d].pad_after_du;
+        }
+    }
+
+    dma_nd_dim_t *cols = &p_nd->dim[0];
+    dma_nd_dim_t *rows = &p_nd->dim[1];
+    uint32_t padded_cols = cols->pad_before_du + cols->size_du + cols->pad_after_du;
+
+    /*
+     * The D2 increments go from the last element of a row to the first one
+     * of the next row, so the rows cannot overlap. The D1 increments are
+     * 8-bit values in the targets.
+     */
+    if(     ( cols->src_inc_du > UINT8_MAX )
+        ||  ( cols->dst_inc_du > UINT8_MAX )
+        ||  ( rows->src_inc_du < ( cols->size_du - 1 ) * cols->src_inc_du )
+        ||  ( rows->dst_inc_du < ( padded_cols - 1 ) * cols->dst_inc_du ) )
+    {
+        p_nd->flags |= ( DMA_CONFIG_INCOMPATIBLE | DMA_CONFIG_CRITICAL_ERROR );
+        return p_nd->flags;
+    }
+
+    p_nd->src_tgt = (dma_target_t){
+        .ptr        = p_nd->src,
+        .inc_du     = cols->src_inc_du,
+        .inc_d2_du  = rows->src_inc_du - ( cols->size_du - 1 ) * cols->src_inc_du,
+        .size_du    = cols->size_du,
+        .size_d2_du = rows->size_du,
+        .type       = p_nd->type,
+        .trig       = DMA_TRIG_MEMORY,
+    };
+
+    p_nd->dst_tgt = (dma_target_t){
+        .ptr        = p_nd->dst,
+        .inc_du     = cols->dst_inc_du,
+        .inc_d2_du  = rows->dst_inc_du - ( padded_cols - 1 ) * cols->dst_inc_du,
+        .size_du    = padded_cols,
+        .size_d2_du = rows->pad_before_du + rows->size_du + rows->pad_after_du,
+        .type       = p_nd->type,
+        .trig       = DMA_TRIG_MEMORY,
+    };
+
+    /*
+     * The planes are launched from the interrupt handler, so they cannot
+     * wait for their own interrupt: dma_launch_nd() waits for the last one.
+     */
+    p_nd->trans = (dma_trans_t){
+        .src            = &p_nd->src_tgt,
+        .dst            = &p_nd->dst_tgt,
+        .src_addr       = NULL,
+        .dim            = DMA_DIM_CONF_2D,
+        .pad_top_du     = rows->pad_before_du,
+        .pad_bottom_du  = rows->pad_after_du,
+        .pad_left_du    = cols->pad_before_du,
+        .pad_right_du   = cols->pad_after_du,
+        .mode           = DMA_TRANS_MODE_SINGLE,
+        .win_du         = 0,
+        .end            = p_nd->end == DMA_TRANS_END_INTR_WAIT
+                        ? DMA_TRANS_END_INTR
+                        : p_nd->end,
+        .channel        = p_nd->channel,
+    };
+
+    p_nd->flags = dma_validate_transaction( &p_nd->trans,
+                                            DMA_DO_NOT_ENABLE_REALIGN,
+                                            p_check );
+    return p_nd->flags;
+}
+
+dma_config_flags_t dma_launch_nd( dma_nd_trans_t *p_nd )
+{
+    if( p_nd->flags & DMA_CONFIG_CRITICAL_ERROR )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    uint8_t ch = p_nd->channel;
+
+    /* The load writes all the registers and checks that the channel is free. */
+    dma_config_flags_t flags = dma_load_transaction( &p_nd->trans );
+    if( flags != DMA_CONFIG_OK )
+    {
+        return flags;
+    }
+
+    /* The planes are launched by the interrupt even if the end is polled. */
+    if( p_nd->trans.end == DMA_TRANS_END_POLLING )
+    {
+        CSR_SET_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+        dma_cb[ch].peri->INTERRUPT_EN = 1 << DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT;
+    }
+
+    p_nd->src_inc_b    = get_increment_b_1D( &p_nd->trans, &p_nd->src_tgt );
+    p_nd->src_inc_d2_b = get_increment_b_2D( &p_nd->trans, &p_nd->src_tgt );
+    p_nd->plane        = 0;
+    for( uint8_t d = 0; d < DMA_ND_MAX_DIMS; d++ )
+    {
+        p_nd->coord[d] = 0;
+    }
+
+    /*
+     * The first plane is launched as the next ones, with the interrupts
+     * disabled so that its end is not seen before it is.
+     */
+    uint32_t mstatus = sync_irq_save();
+
+    dma_cb[ch].intrFlag = 0;
+
+#ifdef DMA_STATS
+    dma_stats.channel[ch].launch_cycle = stats_cycle();
+    dma_stats.channel[ch].setup_cycles += dma_stats.channel[ch].launch_cycle
+                                        - dma_stats.channel[ch].load_cycle;
+    dma_stats_running[ch] = 1;
+#endif
+
+#ifdef CLK_GATE
+    /* The planes move over the whole memory of the dimensions. */
+    clk_hold( ch, RAM_BANKS_ALL, p_nd->trans.win_du != 0 );
+#endif
+
+    dma_cb[ch].nd = p_nd;
+    launch_next_plane( ch );
+
+    sync_irq_restore( mstatus );
+
+#ifdef DMA_STATS
+    uint32_t wait_start = stats_cycle();
+#endif
+
+    if( p_nd->end == DMA_TRANS_END_INTR_WAIT )
+    {
+        sync_wait( intr_flag_set, (void *)(uintptr_t)ch );
+    }
+
+#ifdef DMA_STATS
+    if( p_nd->end == DMA_TRANS_END_INTR_WAIT )
+    {
+        stats_wait( ch, stats_cycle() - wait_start );
+    }
+#endif
+
+    return DMA_CONFIG_OK;
+}
+
+dma_config_flags_t dma_fill_descriptor( dma_trans_t *p_trans,
+                                        dma_desc_t  *p_desc,
+                                        uint8_t     p_irq )
+{
+    if( p_trans->flags & DMA_CONFIG_CRITICAL_ERROR )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    /*
+     * The window, the operations and the wide ports are set once for the
+     * whole chain, and the size of a descriptor cannot be split.
+     */
+    if(     ( p_trans->mode == DMA_TRANS_MODE_CIRCULAR )
+        ||  ( p_trans->win_du != 0 )
+        ||  ( p_trans->ops.en != 0 )
+        ||  ( p_trans->size_b > DMA_SIZE_D1_SIZE_MASK ) )
+    {
+        return DMA_CONFIG_INCOMPATIBLE | DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    /* A 1D transaction with padding runs as a 2D one, see dma_load_transaction(). */
+    if( ( p_trans->dim == DMA_DIM_CONF_1D ) && ( p_trans->pad_left_du != 0 || p_trans->pad_right_du != 0 ) )
+    {
+        p_trans->dim = DMA_DIM_CONF_2D;
+        p_trans->size_d2_b = DMA_DATA_TYPE_2_SIZE( p_trans->dst_type );
+        p_trans->src->inc_d2_du = DMA_DATA_TYPE_2_SIZE( p_trans->dst_type );
+    }
+
+    uint32_t type_b = DMA_DATA_TYPE_2_SIZE( p_trans->dst_type );
+    uint8_t  is_2d  = p_trans->dim == DMA_DIM_CONF_2D;
+
+    p_desc->src_ptr  = (uint32_t)p_trans->src->ptr;
+    p_desc->dst_ptr  = 0;
+    p_desc->addr_ptr = 0;
+    p_desc->dst_inc  = 0;
+    if( p_trans->mode != DMA_TRANS_MODE_ADDRESS )
+    {
+        p_desc->dst_ptr = (uint32_t)p_trans->dst->ptr;
+        p_desc->dst_inc = get_increment_b_1D( p_trans, p_trans->dst )
+            | ( is_2d ? get_increment_b_2D( p_trans, p_trans->dst ) << DMA_DESC_INC_D2_OFFSET : 0 );
+    }
+    else
+    {
+        p_desc->addr_ptr = (uint32_t)p_trans->src_addr->ptr;
+    }
+
+    p_desc->size = p_trans->size_b
+        | ( is_2d ? p_trans->size_d2_b << DMA_DESC_SIZE_D2_OFFSET : 0 );
+    p_desc->src_inc = get_increment_b_1D( p_trans, p_trans->src )
+        | ( is_2d ? get_increment_b_2D( p_trans, p_trans->src ) << DMA_DESC_INC_D2_OFFSET : 0 );
+
+    p_desc->slot =
+        ( ( p_trans->src->trig & DMA_SLOT_RX_TRIGGER_SLOT_MASK )
+            << DMA_SLOT_RX_TRIGGER_SLOT_OFFSET )
+        | ( ( p_trans->dst->trig & DMA_SLOT_TX_TRIGGER_SLOT_MASK )
+            << DMA_SLOT_TX_TRIGGER_SLOT_OFFSET );
+
+    p_desc->pad = ( p_trans->pad_top_du * type_b )
+        | ( p_trans->pad_bottom_du * type_b ) << DMA_DESC_PAD_BOTTOM_OFFSET
+        | ( p_trans->pad_right_du * type_b ) << DMA_DESC_PAD_RIGHT_OFFSET
+        | ( p_trans->pad_left_du * type_b ) << DMA_DESC_PAD_LEFT_OFFSET;
+
+    p_desc->config = p_trans->src_type
+        | p_trans->dst_type << DMA_DESC_DST_TYPE_OFFSET
+        | ( p_trans->sign_ext != 0 ) << DMA_DESC_SIGN_EXT_BIT
+        | p_trans->mode << DMA_DESC_MODE_OFFSET
+        | p_trans->dim << DMA_DESC_DIM_BIT
+        | ( p_trans->dim_inv != 0 ) << DMA_DESC_DIM_INV_BIT
+        | ( p_irq != 0 ) << DMA_DESC_IRQ_BIT;
+
+    return DMA_CONFIG_OK;
+}
+
+dma_config_flags_t dma_launch_chain( dma_desc_t          *p_head,
+                                     uint8_t             channel,
+                                     dma_trans_end_evt_t end )
+{
+    if( ( p_head == NULL ) || ( channel >= DMA_CH_NUM ) )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    if( !dma_is_ready( channel ) )
+    {
+        return DMA_CONFIG_TRANS_OVERRIDE;
+    }
+
+    /* Nothing is left of a previous transaction of the HAL. */
+    dma_cb[channel].trans        = NULL;
+    dma_cb[channel].split_left_b = 0;
+    dma_cb[channel].nd           = NULL;
+
+    /* The registers that the descriptors do not hold are the same for all. */
+    dma_cb[channel].peri->WIDE        = 0;
+    dma_cb[channel].peri->OP_CTRL     = 0;
+    dma_cb[channel].peri->WINDOW_SIZE = 0;
+
+    if( end != DMA_TRANS_END_POLLING )
+    {
+        /* Enable global interrupt. */
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8 );
+        /* Enable machine-level fast interrupt. */
+        CSR_SET_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+
+        dma_cb[channel].peri->INTERRUPT_EN = 1 << DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT;
+        dma_cb[channel].chain    = p_head;
+        dma_cb[channel].intrFlag = 0;
+    }
+    else
+    {
+        dma_cb[channel].peri->INTERRUPT_EN = INTR_EN_NONE;
+        dma_cb[channel].chain    = NULL;
+        dma_cb[channel].intrFlag = 1;
+    }
+
+#ifdef CLK_GATE
+    /* The descriptors and their buffers can be anywhere. */
+    clk_hold( channel, RAM_BANKS_ALL, 0 );
+#endif
+
+    /*
+     * The descriptors and the buffers written before the launch are seen by
+     * the DMA. The write of the first descriptor starts the chain.
+     */
+    sync_fence_dma_start();
+    dma_cb[channel].peri->LL_PTR = (uint32_t)p_head;
+
+    if( end == DMA_TRANS_END_INTR_WAIT )
+    {
+        sync_wait( intr_flag_set, (void *)(uintptr_t)channel );
+    }
+
+    return DMA_CONFIG_OK;
+}
+
+uint32_t dma_is_ready( uint8_t channel )
+{
+    /* The transaction READY bit is read from the status register*/
+    uint32_t ret = ( dma_cb[channel].peri->STATUS & (1<<DMA_STATUS_READY_BIT) );
+
+    /*
+     * The end of a chunk of a split transaction or of a plane of an ND
+     * transaction launches the next one. The interrupt handler and a polling
+     * loop can both see it, so the chunk is launched with the interrupts
+     * disabled, once.
+     */
+    if( ret && ( ( dma_cb[channel].split_left_b != 0 ) || ( dma_cb[channel].nd != NULL ) ) )
+    {
+        uint32_t mstatus = sync_irq_save();
+        if( dma_cb[channel].peri->STATUS & (1<<DMA_STATUS_READY_BIT) )
+        {
+            if( dma_cb[channel].split_left_b != 0 )
+            {
+                launch_next_chunk( channel );
+            }
+            else if( dma_cb[channel].nd != NULL )
+            {
+                launch_next_plane( channel );
+            }
+        }
+        sync_irq_restore( mstatus );
+        return 0;
+    }
+
+    /* The buffers are read after the end of the transaction. */
+    if( ret )
+    {
+        sync_fence_dma_done();
+    }
+
+#ifdef DMA_STATS
+    if( ret && dma_stats_running[channel] )
+    {
+        stats_done( channel );
+    }
+#endif
+
+#ifdef CLK_GATE
+    if( ret && ( dma_clk_banks[channel] != 0 || dma_clk_plic[channel] != 0 ) )
+    {
+        clk_done( channel );
+    }
+#endif
+
+    return ret;
+}
+/* @ToDo: Reconsider this decision.
+ * In case a return wants to be forced in case of an error, there are 2
+ * alternatives:
+ *    1) Consider any value != 0 to be a valid 1 using a LOGIC AND:
+ *  return ( 1 && dma_cb.peri->DONE );
+ *    2) Consider only the LSB == 1 to be a valid 1 using a BITWISE AND.
+ *  return ( 1 &  dma_cb.peri->DONE );
+ * This would be fixed if the DONE register was a 1 bit field.
+ */
+
+
+uint32_t dma_get_window_count( uint8_t channel )
+{
+    return dma_cb[channel].peri->WINDOW_COUNT;
+}
+
+uint32_t dma_get_op_acc( uint8_t channel )
+{
+    return dma_cb[channel].peri->OP_ACC;
+}
+
+
+void dma_stop_circular( uint8_t channel )
+{
+    /*
+     * The DMA finishes the current transaction before and does not start
+     * a new one.
+     */
+    dma_cb[channel].peri->MODE = DMA_TRANS_MODE_SINGLE;
+}
+
+void dma_expect_trans_done( uint8_t channel )
+{
+    /*
+     * No transaction is loaded in the channel, so the interrupt handler only
+     * relies on the flag and the ready bit to find that it has finished.
+     */
+    dma_cb[channel].trans    = NULL;
+    dma_cb[channel].intrFlag = 0;
+
+    /* Enable machine-level fast interrupt. */
+    CSR_SET_BITS(CSR_REG_MIE, DMA_CSR_REG_MIE_MASK );
+}
+
+
+void dma_get_stats( dma_stats_t *stats )
+{
+#ifdef DMA_STATS
+    /* The counters are copied at once, so that the handlers do not modify them meanwhile. */
+    uint32_t mstatus = sync_irq_save();
+    *stats = dma_stats;
+    sync_irq_restore( mstatus );
+#else
+    *stats = (dma_stats_t){ 0 };
+#endif
+}
+
+void dma_reset_stats( void )
+{
+    /* The counters are meaningless if mcycle does not count. */
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1 );
+
+#ifdef DMA_STATS
+    uint32_t mstatus = sync_irq_save();
+    dma_stats = (dma_stats_t){ 0 };
+    sync_irq_restore( mstatus );
+#endif
+}
+
+__attribute__((weak)) void dma_sdk_intr_handler_trans_done( uint8_t channel )
 {
     /*
      * The DMA transaction has finished!
      * This is a weak implementation.
      * Create your own function called
-     * void dma_sdk_intr_handler_trans_done()
+     * void dma_sdk_intr_handler_trans_done( uint8_t channel )
      * to override this one.
      */
 }
 
-__attribute__((weak, optimize("O0"))) void dma_intr_handler_window_done()
+__attribute__((weak)) void dma_sdk_intr_handler_window_done( uint8_t channel )
+{
+    /*
+     * The DMA has copied another window.
+     * This is a weak implementation, overridden by the SDK streams.
+     */
+}
+
+__attribute__((weak)) void dma_intr_handler_window_done( uint8_t channel )
 {
     /*
      * The DMA has copied another window.
      * This is a weak implementation.
      * Create your own function called
-     * void dma_intr_handler_window_done()
+     * void dma_intr_handler_window_done( uint8_t channel )
      * to override this one.
      */
 }
 
-__attribute__((weak, optimize("O0"))) uint8_t dma_window_ratio_warning_threshold()
+__attribute__((weak)) uint8_t dma_window_ratio_warning_threshold()
 {
     /*
      * This is a weak implementation.
@@ -1105,10 +2079,9 @@ dma_config_flags_t validate_target( dma_target_t *p_tgt )
     /* Increment on D2 has to be 0 for 1D operations */
     DMA_STATIC_ASSERT( p_tgt->inc_d2_du  >= 0  &&  p_tgt->inc_d2_du < 4194304 , "Increment d2 not valid");
     /* The size could be 0 if the target is only going to be used as a
-    destination. */
-    DMA_STATIC_ASSERT( p_tgt->size_du  >= 0 && p_tgt->size_du  < 65536 , "Size not valid");
+    destination. A 1D size larger than SIZE_D1 is split by dma_launch(). */
     /* The size can be 0 or 1 if the target is involved in a 1D padded transaction */
-    DMA_STATIC_ASSERT( p_tgt->size_d2_du >= 0 && p_tgt->size_du  < 65536  , "Size d2 not valid");
+    DMA_STATIC_ASSERT( p_tgt->size_d2_du >= 0 && p_tgt->size_d2_du < 65536  , "Size d2 not valid");
     /* The data type must be a valid type */
     DMA_STATIC_ASSERT( p_tgt->type     < DMA_DATA_TYPE__size , "Source type not valid");
     /* The trigger must be among the valid trigger values. */
@@ -1343,7 +2316,8 @@ static inline uint8_t is_region_outbound_2D(   uint8_t  *p_start,
 static inline void write_register( uint32_t  p_val,
                                   uint32_t  p_offset,
                                   uint32_t  p_mask,
-                                  uint8_t   p_sel )
+                                  uint8_t   p_sel,
+                                  volatile dma *p_peri )
 {
     /*
      * The index is computed to avoid needing to access the structure
@@ -1354,17 +2328,27 @@ static inline void write_register( uint32_t  p_val,
      * An intermediate variable "value" is used to prevent writing twice into
      * the register.
      */
-    uint32_t value  =  (( uint32_t * ) dma_cb.peri ) [ index ];
+    uint32_t value  =  (( volatile uint32_t * ) p_peri ) [ index ];
     value           &= ~( p_mask << p_sel );
     value           |= (p_val & p_mask) << p_sel;
-    (( uint32_t * ) dma_cb.peri ) [ index ] = value;
+    (( volatile uint32_t * ) p_peri ) [ index ] = value;
 
 // @ToDo: mmio_region_write32(dma->base_addr, (ptrdiff_t)(DMA_SLOT_REG_OFFSET), (tx_slot_mask << DMA_SLOT_TX_TRIGGER_SLOT_OFFSET) + rx_slot_mask)
 
 }
 
 
-static inline uint32_t get_increment_b_1D( dma_target_t * p_tgt )
+static inline void set_register(   uint32_t  p_val,
+                                  uint32_t  p_offset,
+                                  uint32_t  p_mask,
+                                  uint8_t   p_sel,
+                                  volatile dma *p_peri )
+{
+    uint8_t index = p_offset / DMA_REGISTER_SIZE_BYTES;
+    (( volatile uint32_t * ) p_peri ) [ index ] = (p_val & p_mask) << p_sel;
+}
+
+static inline uint32_t get_increment_b_1D( dma_trans_t * p_trans, dma_target_t * p_tgt )
 {
     uint32_t inc_b = 0;
     /* If the target uses a trigger, the increment remains 0. */
@@ -1374,7 +2358,7 @@ static inline uint32_t get_increment_b_1D( dma_target_t * p_tgt )
          * If the transaction increment has been overriden (due to
          * misalignments), then that value is used (it's always set to 1).
          */
-        inc_b = dma_cb.trans->inc_b;
+        inc_b = p_trans->inc_b;
         /*
         * Otherwise, the target-specific increment is used transformed into
         * bytes).
@@ -1388,7 +2372,7 @@ static inline uint32_t get_increment_b_1D( dma_target_t * p_tgt )
     return inc_b;
 }
 
-static inline uint32_t get_increment_b_2D( dma_target_t * p_tgt )
+static inline uint32_t get_increment_b_2D( dma_trans_t * p_trans, dma_target_t * p_tgt )
 {
     uint32_t inc_b = 0;
     /* If the target uses a trigger, the increment remains 0. */
@@ -1398,7 +2382,7 @@ static inline uint32_t get_increment_b_2D( dma_target_t * p_tgt )
          * If the transaction increment has been overriden (due to
          * misalignments), then that value is used (it's always set to 1).
          */
-        inc_b = dma_cb.trans->inc_b;
+        inc_b = p_trans->inc_b;
 
         /*
         * Otherwise, the target-specific increment is used transformed into
@@ -1413,6 +2397,320 @@ static inline uint32_t get_increment_b_2D( dma_target_t * p_tgt )
     return inc_b;
 }
 
+static inline uint8_t is_wide_transaction( dma_trans_t * p_trans )
+{
+#if DMA_WIDE_LANES > 1
+    const uint32_t wide_b = 4 * DMA_WIDE_LANES;
+    uint32_t src = (uint32_t)p_trans->src->ptr;
+    uint32_t dst = (uint32_t)p_trans->dst->ptr;
+
+    /*
+     * The wide ports move DMA_WIDE_LANES words per request, from contiguous
+     * words to contiguous words, and raise no window event.
+     */
+    if(     p_trans->dim        != DMA_DIM_CONF_1D
+        ||  p_trans->mode       != DMA_TRANS_MODE_SINGLE
+        ||  p_trans->win_du     != 0
+        ||  p_trans->ops.en     != 0
+        ||  p_trans->src_type   != DMA_DATA_TYPE_WORD
+        ||  p_trans->dst_type   != DMA_DATA_TYPE_WORD
+        ||  p_trans->src->trig  != DMA_TRIG_MEMORY
+        ||  p_trans->dst->trig  != DMA_TRIG_MEMORY
+        ||  get_increment_b_1D( p_trans, p_trans->src ) != 4
+        ||  get_increment_b_1D( p_trans, p_trans->dst ) != 4 )
+    {
+        return 0;
+    }
+
+    /* Whole rows of the group, on both sides. */
+    if(     ( src % wide_b )
+        ||  ( dst % wide_b )
+        ||  ( p_trans->size_b % wide_b )
+        ||  ( p_trans->size_b == 0 ) )
+    {
+        return 0;
+    }
+
+    return      src >= DMA_WIDE_START_ADDRESS
+            &&  src + p_trans->size_b <= DMA_WIDE_END_ADDRESS
+            &&  dst >= DMA_WIDE_START_ADDRESS
+            &&  dst + p_trans->size_b <= DMA_WIDE_END_ADDRESS;
+#else
+    (void)p_trans;
+    return 0;
+#endif
+}
+
+static inline uint8_t windowed_channel( uint8_t p_ch )
+{
+    return     ( dma_cb[p_ch].trans != NULL )
+            && ( dma_cb[p_ch].trans->win_du > 0 )
+            && ( dma_cb[p_ch].trans->end != DMA_TRANS_END_POLLING );
+}
+
+static void reset_channel( uint8_t p_ch )
+{
+    /*
+     * A channel running a transaction is left untouched, so one user of
+     * the DMA can initialize it while another channel is copying.
+     */
+    if( !dma_is_ready( p_ch ) )
+    {
+        return;
+    }
+
+    /* Clear the loaded transaction and the queue */
+    dma_cb[p_ch].trans = NULL;
+    dma_cb[p_ch].intrFlag = 1;
+    dma_cb[p_ch].queue_head   = NULL;
+    dma_cb[p_ch].queue_tail   = NULL;
+    dma_cb[p_ch].queue_length = 0;
+    dma_cb[p_ch].split_left_b = 0;
+    dma_cb[p_ch].nd           = NULL;
+    dma_cb[p_ch].chain        = NULL;
+    /* Clear all values in the DMA registers. */
+    dma_cb[p_ch].peri->SRC_PTR        = 0;
+    dma_cb[p_ch].peri->DST_PTR        = 0;
+    dma_cb[p_ch].peri->ADDR_PTR       = 0;
+    dma_cb[p_ch].peri->SIZE_D1        = 0;
+    dma_cb[p_ch].peri->SIZE_D2        = 0;
+    dma_cb[p_ch].peri->SRC_PTR_INC_D1 = 0;
+    dma_cb[p_ch].peri->SRC_PTR_INC_D2 = 0;
+    dma_cb[p_ch].peri->DST_PTR_INC_D1 = 0;
+    dma_cb[p_ch].peri->DST_PTR_INC_D2 = 0;
+    dma_cb[p_ch].peri->DIM_CONFIG     = 0;
+    dma_cb[p_ch].peri->SLOT           = 0;
+    dma_cb[p_ch].peri->SRC_DATA_TYPE  = 0;
+    dma_cb[p_ch].peri->DST_DATA_TYPE  = 0;
+    dma_cb[p_ch].peri->SIGN_EXT       = 0;
+    dma_cb[p_ch].peri->MODE           = 0;
+    dma_cb[p_ch].peri->WIDE           = 0;
+    dma_cb[p_ch].peri->OP_CTRL        = 0;
+    dma_cb[p_ch].peri->WINDOW_SIZE    = 0;
+    dma_cb[p_ch].peri->INTERRUPT_EN   = 0;
+    dma_cb[p_ch].peri->PAD_TOP        = 0;
+    dma_cb[p_ch].peri->PAD_BOTTOM     = 0;
+    dma_cb[p_ch].peri->PAD_LEFT       = 0;
+    dma_cb[p_ch].peri->PAD_RIGHT      = 0;
+    dma_cb[p_ch].peri->DIM_INV        = 0;
+}
+
+static bool intr_flag_set( void *p_arg )
+{
+    return sync_load( &dma_cb[(uintptr_t)p_arg].intrFlag ) != 0x0;
+}
+
+static void launch_next_chunk( uint8_t p_ch )
+{
+    /* The registers other than the pointers and the size are kept. */
+    uint32_t size_b = dma_cb[p_ch].split_left_b < DMA_SPLIT_CHUNK_B
+                    ? dma_cb[p_ch].split_left_b
+                    : DMA_SPLIT_CHUNK_B;
+
+    dma_cb[p_ch].peri->SRC_PTR = dma_cb[p_ch].split_src;
+    dma_cb[p_ch].peri->DST_PTR = dma_cb[p_ch].split_dst;
+
+    dma_cb[p_ch].split_src    += dma_cb[p_ch].split_src_step;
+    dma_cb[p_ch].split_dst    += dma_cb[p_ch].split_dst_step;
+    dma_cb[p_ch].split_left_b -= size_b;
+
+    dma_cb[p_ch].peri->SIZE_D1 = size_b;
+}
+
+static void launch_next_plane( uint8_t p_ch )
+{
+    dma_nd_trans_t *nd = dma_cb[p_ch].nd;
+    uint32_t elem_b    = DMA_DATA_TYPE_2_SIZE( nd->type );
+    uint32_t src       = (uint32_t)nd->src;
+    uint32_t dst       = (uint32_t)nd->dst;
+    uint8_t  padding   = 0;
+
+    /* The pointers of the plane, from its coordinates. */
+    for( uint8_t d = 2; d < DMA_ND_MAX_DIMS; d++ )
+    {
+        uint32_t coord = nd->coord[d];
+        dst += coord * nd->dim[d].dst_inc_du * elem_b;
+
+        if(     ( coord < nd->dim[d].pad_before_du )
+            ||  ( coord >= nd->dim[d].pad_before_du + nd->dim[d].size_du ) )
+        {
+            padding = 1;
+        }
+        else
+        {
+            src += ( coord - nd->dim[d].pad_before_du ) * nd->dim[d].src_inc_du * elem_b;
+        }
+    }
+
+    /*
+     * The registers other than the pointers, the source increments and the
+     * sizes are kept. A plane of the padding reads the same zero for every
+     * element, and gets the padding of the rows and columns as the others.
+     */
+    dma_cb[p_ch].peri->SRC_PTR = padding ? (uint32_t)&dma_nd_zero : src;
+    dma_cb[p_ch].peri->DST_PTR = dst;
+
+    set_register(   padding ? 0 : nd->src_inc_b,
+                    DMA_SRC_PTR_INC_D1_REG_OFFSET,
+                    DMA_SRC_PTR_INC_D1_INC_MASK,
+                    DMA_SRC_PTR_INC_D1_INC_OFFSET,
+                    dma_cb[p_ch].peri );
+
+    set_register(   padding ? 0 : nd->src_inc_d2_b,
+                    DMA_SRC_PTR_INC_D2_REG_OFFSET,
+                    DMA_SRC_PTR_INC_D2_INC_MASK,
+                    DMA_SRC_PTR_INC_D2_INC_OFFSET,
+                    dma_cb[p_ch].peri );
+
+    /* The coordinates of the next plane, the outer dimensions last. */
+    for( uint8_t d = 2; d < DMA_ND_MAX_DIMS; d++ )
+    {
+        nd->coord[d]++;
+        if( nd->coord[d] < nd->dim[d].pad_before_du + nd->dim[d].size_du
+                         + nd->dim[d].pad_after_du )
+        {
+            break;
+        }
+        nd->coord[d] = 0;
+    }
+
+    nd->plane++;
+    if( nd->plane == nd->planes )
+    {
+        dma_cb[p_ch].nd = NULL;
+    }
+
+    sync_fence_dma_start();
+
+    set_register(   nd->trans.size_d2_b,
+                    DMA_SIZE_D2_REG_OFFSET,
+                    DMA_SIZE_D2_SIZE_MASK,
+                    DMA_SIZE_D2_SIZE_OFFSET,
+                    dma_cb[p_ch].peri );
+
+    set_register(   nd->trans.size_b,
+                    DMA_SIZE_D1_REG_OFFSET,
+                    DMA_SIZE_D1_SIZE_MASK,
+                    DMA_SIZE_D1_SIZE_OFFSET,
+                    dma_cb[p_ch].peri );
+}
+
+#ifdef DMA_STATS
+static inline uint32_t stats_cycle( void )
+{
+    uint32_t cycle;
+    CSR_READ(CSR_REG_MCYCLE, &cycle);
+    return cycle;
+}
+
+static void stats_done( uint8_t p_ch )
+{
+    /*
+     * The end can be seen by the interrupt handler and by a polling loop at
+     * the same time, so it is accounted with the interrupts disabled.
+     */
+    uint32_t mstatus = sync_irq_save();
+
+    dma_trans_t *trans = dma_cb[p_ch].trans;
+    if( dma_stats_running[p_ch] && trans != NULL )
+    {
+        dma_stats_running[p_ch] = 0;
+
+        dma_channel_stats_t *ch_stats = &dma_stats.channel[p_ch];
+        ch_stats->done_cycle = stats_cycle();
+        uint32_t busy = ch_stats->done_cycle - ch_stats->launch_cycle;
+
+        /* The D2 size is also in bytes of the destination. */
+        uint32_t bytes = trans->size_b;
+        if( trans->dim == DMA_DIM_CONF_2D )
+        {
+            bytes *= trans->size_d2_b / DMA_DATA_TYPE_2_SIZE( trans->dst_type );
+        }
+
+        ch_stats->transactions++;
+        ch_stats->bytes       += bytes;
+        ch_stats->busy_cycles += busy;
+
+        uint8_t trig = trans->src->trig != DMA_TRIG_MEMORY ? trans->src->trig
+                                                           : trans->dst->trig;
+        dma_slot_stats_t *slot_stats = &dma_stats.slot[DMA_STATS_SLOT( trig )];
+        slot_stats->transactions++;
+        slot_stats->bytes       += bytes;
+        slot_stats->busy_cycles += busy;
+    }
+
+    sync_irq_restore( mstatus );
+}
+
+static void stats_wait( uint8_t p_ch, uint32_t p_cycles )
+{
+    dma_stats.channel[p_ch].wait_cycles += p_cycles;
+
+    dma_trans_t *trans = dma_cb[p_ch].trans;
+    if( trans != NULL )
+    {
+        uint8_t trig = trans->src->trig != DMA_TRIG_MEMORY ? trans->src->trig
+                                                           : trans->dst->trig;
+        dma_stats.slot[DMA_STATS_SLOT( trig )].wait_cycles += p_cycles;
+    }
+}
+#endif
+
+#ifdef CLK_GATE
+static uint32_t clk_banks_of_target( dma_trans_t * p_trans, dma_target_t * p_tgt )
+{
+    if( p_tgt->trig != DMA_TRIG_MEMORY )
+    {
+        return 0;
+    }
+
+    /* The D1 size is in bytes of the source, the D2 size in bytes of the destination. */
+    uint32_t elements = p_trans->size_b / DMA_DATA_TYPE_2_SIZE( p_trans->src_type );
+    uint32_t span_b = elements * get_increment_b_1D( p_trans, p_tgt );
+    if( p_trans->dim == DMA_DIM_CONF_2D )
+    {
+        uint32_t rows = p_trans->size_d2_b / DMA_DATA_TYPE_2_SIZE( p_trans->dst_type );
+        span_b = rows * ( span_b + get_increment_b_2D( p_trans, p_tgt ) );
+    }
+
+    /* A null increment still reads or writes one element. */
+    return ram_banks_of( p_tgt->ptr, span_b > 4 ? span_b : 4 );
+}
+
+static void clk_hold( uint8_t p_ch, uint32_t p_banks, uint8_t p_plic )
+{
+    /* What a previous transaction held, if its end was not seen. */
+    clk_done( p_ch );
+
+    uint32_t mstatus = sync_irq_save();
+    clk_gate_ram_acquire( p_banks );
+    if( p_plic )
+    {
+        clk_gate_periph_acquire( RV_PLIC_IDX );
+    }
+    dma_clk_banks[p_ch] = p_banks;
+    dma_clk_plic[p_ch] = p_plic;
+    sync_irq_restore( mstatus );
+}
+
+static void clk_done( uint8_t p_ch )
+{
+    /*
+     * The end can be seen by the interrupt handler and by a polling loop at
+     * the same time, so the clocks are released with the interrupts disabled.
+     */
+    uint32_t mstatus = sync_irq_save();
+    clk_gate_ram_release( dma_clk_banks[p_ch] );
+    if( dma_clk_plic[p_ch] )
+    {
+        clk_gate_periph_release( RV_PLIC_IDX );
+    }
+    dma_clk_banks[p_ch] = 0;
+    dma_clk_plic[p_ch] = 0;
+    sync_irq_restore( mstatus );
+}
+#endif
+
 /****************************************************************************/
 /**                                                                        **/
 /*                                 EOF                                      */
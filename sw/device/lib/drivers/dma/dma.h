@@ -62,11 +62,13 @@
 #define DMA_SPI_MODE_SPI_FLASH_TX 0x04
 
 
-#define DMA_SPI_RX_SLOT           0x01
-#define DMA_SPI_TX_SLOT           0x02
-#define DMA_SPI_FLASH_RX_SLOT     0x04
-#define DMA_SPI_FLASH_TX_SLOT     0x08
-#define DMA_I2S_RX_SLOT           0x10
+#define DMA_SPI_RX_SLOT           DMA_TRIG_SLOT_SPI_RX
+#define DMA_SPI_TX_SLOT           DMA_TRIG_SLOT_SPI_TX
+#define DMA_SPI_FLASH_RX_SLOT     DMA_TRIG_SLOT_SPI_FLASH_RX
+#define DMA_SPI_FLASH_TX_SLOT     DMA_TRIG_SLOT_SPI_FLASH_TX
+#define DMA_I2S_RX_SLOT           DMA_TRIG_SLOT_I2S
+#define DMA_UART_RX_SLOT          DMA_TRIG_SLOT_UART_RX
+#define DMA_UART_TX_SLOT          DMA_TRIG_SLOT_UART_TX
 
 #define DMA_INT_TR_START     0x0
 
@@ -79,6 +81,20 @@ extern "C" {
  */
 #define DMA_DATA_TYPE_2_SIZE(type) (0b00000100 >> (type) )
 
+/**
+ * Returns the registers of a channel of the integrated DMA. The register
+ * blocks of the channels follow each other, every DMA_CH_SIZE bytes.
+ */
+#define dma_ch_peri(ch) ((volatile dma *)( (uint32_t)dma_peri + (ch) * DMA_CH_SIZE ))
+
+/**
+ * Size in bytes of the chunks of a split transaction. The SIZE_D1 register
+ * has 16 bits, so a larger 1D transaction is launched as chunks of this
+ * size. A multiple of 64 bytes, so that the chunks keep the alignment of the
+ * data types and of the wide transfers.
+ */
+#define DMA_SPLIT_CHUNK_B 0xFFC0
+
 /****************************************************************************/
 /**                                                                        **/
 /**                       TYPEDEFS AND STRUCTURES                          **/
@@ -86,29 +102,56 @@ extern "C" {
 /****************************************************************************/
 
 /**
- * SLOT_1~4 are the available slots for adding triggers.
- * These are defined in hardware, so it should be consistent with the
- * registers' assigned values.
+ * The trigger slots, one per request line given a slot by the trigger_slots
+ * of the DMA in mcu_cfg.hjson, in that order. core_v_mini_mcu.h defines
+ * DMA_TRIGGER_SLOT_<LINE> to the index of the slot of each of these lines,
+ * so a line without a slot has no value here.
  * It was considered during design time that slots could be masked, in case a
  * peripheral decided to use two or more slots for Tx or Rx. This is not the
  * case in the present moment, anyways.
- * @ToDo: What is connected to each slot should not be defined in the DMA HAL.
- * It is system-architecture-dependent, but not DMA-architecture-dependent.
- * As there is currently no way of including these definitions anywhere else,
- * they will be left here for the moment.
  */
 typedef enum
 {
     DMA_TRIG_MEMORY             = 0, /*!< Reads from memory or writes in
     memory. */
-    DMA_TRIG_SLOT_SPI_RX        = 1, /*!< Slot 1 (MEM < SPI). */
-    DMA_TRIG_SLOT_SPI_TX        = 2, /*!< Slot 2 (MEM > SPI). */
-    DMA_TRIG_SLOT_SPI_FLASH_RX  = 4, /*!< Slot 3 (MEM < SPI FLASH). */
-    DMA_TRIG_SLOT_SPI_FLASH_TX  = 8, /*!< Slot 4 (MEM > SPI FLASH). */
-    DMA_TRIG_SLOT_I2S           = 16,/*!< Slot 5 (I2S). */
-    DMA_TRIG_SLOT_EXT_TX        = 32,/*!< Slot 6 (External peripherals TX). */
-    DMA_TRIG_SLOT_EXT_RX        = 64,/*!< Slot 7 (External peripherals RX). */
-    DMA_TRIG__size,      /*!< Not used, only for sanity checks. */
+#ifdef DMA_TRIGGER_SLOT_SPI_RX
+    DMA_TRIG_SLOT_SPI_RX        = 1 << DMA_TRIGGER_SLOT_SPI_RX, /*!< MEM < SPI. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_SPI_TX
+    DMA_TRIG_SLOT_SPI_TX        = 1 << DMA_TRIGGER_SLOT_SPI_TX, /*!< MEM > SPI. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_SPI_FLASH_RX
+    DMA_TRIG_SLOT_SPI_FLASH_RX  = 1 << DMA_TRIGGER_SLOT_SPI_FLASH_RX, /*!< MEM < SPI FLASH. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_SPI_FLASH_TX
+    DMA_TRIG_SLOT_SPI_FLASH_TX  = 1 << DMA_TRIGGER_SLOT_SPI_FLASH_TX, /*!< MEM > SPI FLASH. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_I2S
+    DMA_TRIG_SLOT_I2S           = 1 << DMA_TRIGGER_SLOT_I2S, /*!< MEM < I2S. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_EXT_TX
+    DMA_TRIG_SLOT_EXT_TX        = 1 << DMA_TRIGGER_SLOT_EXT_TX, /*!< External peripherals TX. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_EXT_RX
+    DMA_TRIG_SLOT_EXT_RX        = 1 << DMA_TRIGGER_SLOT_EXT_RX, /*!< External peripherals RX. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_PDM2PCM
+    DMA_TRIG_SLOT_PDM2PCM       = 1 << DMA_TRIGGER_SLOT_PDM2PCM, /*!< MEM < PDM2PCM. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_UART_RX
+    DMA_TRIG_SLOT_UART_RX       = 1 << DMA_TRIGGER_SLOT_UART_RX, /*!< MEM < UART. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_UART_TX
+    DMA_TRIG_SLOT_UART_TX       = 1 << DMA_TRIGGER_SLOT_UART_TX, /*!< MEM > UART. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_EXT_ACC_TX
+    DMA_TRIG_SLOT_EXT_ACC_TX    = 1 << DMA_TRIGGER_SLOT_EXT_ACC_TX, /*!< External accelerator TX. */
+#endif
+#ifdef DMA_TRIGGER_SLOT_EXT_ACC_RX
+    DMA_TRIG_SLOT_EXT_ACC_RX    = 1 << DMA_TRIGGER_SLOT_EXT_ACC_RX, /*!< External accelerator RX. */
+#endif
+    DMA_TRIG__size              = 1 << DMA_TRIGGER_SLOT_NUM, /*!< Not used, only
+    for sanity checks. */
     DMA_TRIG__undef,     /*!< DMA will not be used. */
 } dma_trigger_slot_mask_t;
 
@@ -167,6 +210,11 @@ typedef enum{
     parameters is checked to make sure there are no inconsistencies.
     Not using this flag is only recommended when parameters are constant and
     the proper operation has been previously tested. */
+    DMA_PERFORM_CHECKS_ONLY_CRITICAL = 2, /*!< Trusted transaction: the
+    targets are not validated either, only the checks that prevent a
+    misconfiguration of the DMA itself (e.g. a non-existing channel) are
+    performed. Intended for production firmware with tested, constant
+    transactions, where the setup latency matters. */
     DMA_PERFORM_CHECKS__size,       /*!< Not used, only for sanity checks. */
 } dma_perf_checks_t;
 
@@ -299,16 +347,60 @@ typedef struct
     Can be left blank if the target is a peripheral. */
     uint32_t                inc_d2_du; /*!< How much the D2 pointer will increase
     every time the DMA finishes to read a #D1 of data units. */
-    uint16_t                size_du; /*!< The size (in data units) of the data to
-    be copied. Can be left blank if the target will only be used as destination.*/
-    uint16_t                size_d2_du; /*!< The size (in data units) of the data
-    to be copied along D2.*/
+    uint32_t                size_du; /*!< The size (in data units) of the data to
+    be copied. Can be left blank if the target will only be used as destination.
+    A single 1D transaction larger than the SIZE_D1 register is split into
+    chunks of DMA_SPLIT_CHUNK_B bytes. */
+    uint32_t                size_d2_du; /*!< The size (in data units) of the data
+    to be copied along D2. It is not split, so it must fit the SIZE_D2
+    register. */
     dma_data_type_t         type;    /*!< The type of data to be transferred.
     Can be left blank if the target will only be used as destination. */
     dma_trigger_slot_mask_t trig;    /*!< If the target is a peripheral, a
     trigger can be set to control the data flow.  */
 } dma_target_t;
 
+/**
+ * Operations the DMA applies to each element between the read and the write,
+ * in this order. They are combined in the en mask of dma_ops_t.
+ */
+typedef enum
+{
+    DMA_OP_SCALE     = 1 << DMA_OP_CTRL_SCALE_BIT, /*!< Multiply by scale, then
+    shift right by shift (arithmetic). */
+    DMA_OP_ADD       = 1 << DMA_OP_CTRL_ADD_BIT,   /*!< Add add. */
+    DMA_OP_MIN       = 1 << DMA_OP_CTRL_MIN_BIT,   /*!< Clamp to min from
+    below. */
+    DMA_OP_MAX       = 1 << DMA_OP_CTRL_MAX_BIT,   /*!< Clamp to max from
+    above. */
+    DMA_OP_THRESHOLD = 1 << DMA_OP_CTRL_THRESHOLD_BIT, /*!< With DMA_OP_MIN,
+    write 0 instead of min below min. */
+    DMA_OP_ACC       = 1 << DMA_OP_CTRL_ACC_BIT,   /*!< Add the elements
+    written, read with dma_get_op_acc(). */
+    DMA_OP_BSWAP     = 1 << DMA_OP_CTRL_BSWAP_BIT, /*!< Reverse the bytes of the
+    half-words and words written. */
+    DMA_OP_SIGNED    = 1 << DMA_OP_CTRL_SIGNED_DATA_BIT, /*!< The source
+    elements, add, min and max are signed. */
+} dma_op_t;
+
+/**
+ * In-transfer operations of a transaction. The element is extended to 32 bits
+ * (signed with DMA_OP_SIGNED), goes through the enabled operations and is
+ * truncated to the destination type, without saturation: DMA_OP_MIN and
+ * DMA_OP_MAX saturate to a narrower type. The padding goes through them as
+ * zeros. A transaction with operations does not use the wide ports.
+ */
+typedef struct
+{
+    uint8_t     en;     /*!< Mask of dma_op_t, 0 to copy the data as is. */
+    int16_t     scale;  /*!< Factor of DMA_OP_SCALE. */
+    uint8_t     shift;  /*!< Right shift of the product of DMA_OP_SCALE, up
+    to 31. */
+    uint32_t    add;    /*!< Constant of DMA_OP_ADD. */
+    uint32_t    min;    /*!< Lower bound of DMA_OP_MIN. */
+    uint32_t    max;    /*!< Upper bound of DMA_OP_MAX. */
+} dma_ops_t;
+
 /**
  * A transaction is an agreed transfer of data from one target to another.
  * It needs a source target and a destination target.
@@ -316,7 +408,7 @@ typedef struct
  * if needed.
  */
 
-typedef struct
+typedef struct dma_trans
 {
     dma_target_t*       src;   /*!< Target from where the data will be
     copied. */
@@ -341,6 +433,8 @@ typedef struct
     dma_data_type_t     dst_type;   /*!< Destination data type to use. One is chosen among
     the targets. */
     uint8_t             sign_ext;   /*!< Whether to sign extend the data. */
+    dma_ops_t           ops;    /*!< Operations applied to the data on the
+    way, none if left blank. */
     dma_trans_mode_t    mode;   /*!< The copy mode to use. */
     uint8_t                dim_inv; /*!< If the D1 and D2 dimensions are inverted, i.e. perform transposition. */
     uint32_t            win_du;  /*!< The amount of data units every which the
@@ -348,10 +442,170 @@ typedef struct
     can be set to 0 to disable this functionality. */
     dma_trans_end_evt_t end;    /*!< What should happen after the transaction
     is launched. */
+    uint8_t             channel; /*!< The DMA channel where the transaction is
+    loaded and launched, from 0 to DMA_CH_NUM-1 (0 by default). */
     dma_config_flags_t  flags;  /*!< A mask with possible issues aroused from
     the creation of the transaction. */
+    struct dma_trans*   next;   /*!< Next transaction of the queue, set by
+    dma_enqueue_transaction(). */
 } dma_trans_t;
 
+/**
+ * Maximum number of dimensions of an ND transaction.
+ */
+#define DMA_ND_MAX_DIMS 4
+
+/**
+ * A dimension of an ND transaction. Dimension 0 is the innermost one (the
+ * columns of a tensor tile), dimension 1 the rows and the next ones the
+ * planes (channels, batches).
+ */
+typedef struct
+{
+    uint32_t    size_du;       /*!< Number of elements copied from the source
+    along the dimension, without the padding. At least 1. */
+    uint32_t    src_inc_du;    /*!< Distance between two consecutive elements
+    of the source along the dimension, in data units. */
+    uint32_t    dst_inc_du;    /*!< Distance between two consecutive elements
+    of the destination along the dimension, in data units. */
+    uint8_t     pad_before_du; /*!< Number of elements of padding (zeros)
+    before the source elements along the dimension. */
+    uint8_t     pad_after_du;  /*!< Number of elements of padding after the
+    source elements along the dimension. */
+} dma_nd_dim_t;
+
+/**
+ * An ND transaction copies a tensor tile with up to DMA_ND_MAX_DIMS
+ * dimensions and a padding of zeros on both sides of each of them. It is
+ * submitted once, and lowered by the HAL to one 2D transaction per plane
+ * (dimensions 0 and 1 with their padding): each plane is launched by the
+ * transaction done interrupt of the previous one. The planes of the padding
+ * of the outer dimensions read a zero instead of the source.
+ */
+typedef struct
+{
+    uint8_t*            src;     /*!< First element of the source that is not
+    padding. */
+    uint8_t*            dst;     /*!< First element of the destination, which
+    includes the padding. */
+    dma_data_type_t     type;    /*!< The type of the elements. */
+    uint8_t             dims;    /*!< Number of dimensions, from 1 to
+    DMA_ND_MAX_DIMS. The next ones are set to a single element. */
+    dma_nd_dim_t        dim[DMA_ND_MAX_DIMS]; /*!< The dimensions. The
+    paddings of dimensions 0 and 1 are limited as the ones of the 2D
+    transactions. */
+    dma_trans_end_evt_t end;     /*!< What should happen after the transaction
+    is launched, once all its planes have been copied. */
+    uint8_t             channel; /*!< The DMA channel of the transaction. */
+    dma_config_flags_t  flags;   /*!< A mask with possible issues aroused from
+    the validation. */
+
+    /* Filled by dma_validate_nd() and dma_launch_nd(). */
+    dma_target_t        src_tgt; /*!< The source of the first plane. */
+    dma_target_t        dst_tgt; /*!< The destination of the first plane. */
+    dma_trans_t         trans;   /*!< The 2D transaction of a plane. */
+    uint32_t            planes;  /*!< Number of planes, padding included. */
+    uint32_t            plane;   /*!< Next plane to launch. */
+    uint32_t            coord[DMA_ND_MAX_DIMS]; /*!< Coordinates of the
+    next plane along the outer dimensions, padding included. */
+    uint32_t            src_inc_b;    /*!< SRC_PTR_INC_D1 of the planes. */
+    uint32_t            src_inc_d2_b; /*!< SRC_PTR_INC_D2 of the planes. */
+} dma_nd_trans_t;
+
+/**
+ * Fields of the SIZE, SRC_INC, DST_INC, PAD and CONFIG words of a descriptor.
+ */
+#define DMA_DESC_SIZE_D2_OFFSET       16
+#define DMA_DESC_INC_D2_OFFSET        6
+#define DMA_DESC_PAD_BOTTOM_OFFSET    8
+#define DMA_DESC_PAD_RIGHT_OFFSET     16
+#define DMA_DESC_PAD_LEFT_OFFSET      24
+#define DMA_DESC_DST_TYPE_OFFSET      2
+#define DMA_DESC_SIGN_EXT_BIT         4
+#define DMA_DESC_MODE_OFFSET          5
+#define DMA_DESC_DIM_BIT              7
+#define DMA_DESC_DIM_INV_BIT          8
+#define DMA_DESC_IRQ_BIT              9
+
+/**
+ * A descriptor of a linked-list transaction, read by the DMA from memory.
+ * Each one holds the registers of a transaction and the address of the next
+ * descriptor, so that a chain of transactions runs without the CPU. The
+ * window, the in-transfer operations and the wide ports are not used by
+ * chains. Filled by dma_fill_descriptor(), the words are the ones of the
+ * linked-list mode of the DMA (see dma.sv).
+ */
+typedef struct dma_desc
+{
+    struct dma_desc*    next;       /*!< Next descriptor, NULL for the last
+    one. */
+    uint32_t            src_ptr;    /*!< SRC_PTR. */
+    uint32_t            dst_ptr;    /*!< DST_PTR. */
+    uint32_t            addr_ptr;   /*!< ADDR_PTR, in address mode. */
+    uint32_t            size;       /*!< SIZE_D1 and SIZE_D2. */
+    uint32_t            src_inc;    /*!< SRC_PTR_INC_D1 and SRC_PTR_INC_D2. */
+    uint32_t            dst_inc;    /*!< DST_PTR_INC_D1 and DST_PTR_INC_D2. */
+    uint32_t            slot;       /*!< SLOT. */
+    uint32_t            pad;        /*!< The four paddings. */
+    uint32_t            config;     /*!< Data types, sign extension, mode,
+    dimensionality, transposition and the IRQ flag. */
+} dma_desc_t;
+
+/**
+ * Number of entries of the per-slot profiling counters: memory-to-memory
+ * transactions, then one per trigger slot.
+ */
+#define DMA_STATS_SLOTS ( DMA_TRIGGER_SLOT_NUM + 1 )
+
+/**
+ * Index in the per-slot profiling counters of a trigger slot mask:
+ * 0 for DMA_TRIG_MEMORY, i for the slot i (mask 1 << (i-1)).
+ */
+#define DMA_STATS_SLOT( trig ) ( ( trig ) == DMA_TRIG_MEMORY ? 0 : __builtin_ctz( trig ) + 1 )
+
+/**
+ * Profiling counters of a channel, only updated if the driver is built with
+ * DMA_STATS. Cycles are read from mcycle, and only the transactions loaded
+ * and launched by the HAL are accounted.
+ */
+typedef struct
+{
+    uint32_t transactions;  /*!< Number of finished transactions. */
+    uint32_t bytes;         /*!< Bytes copied by these transactions, without
+    padding. Circular transactions count one lap. */
+    uint32_t setup_cycles;  /*!< Cycles from the loads to the launches. */
+    uint32_t busy_cycles;   /*!< Cycles from the launches to the end of the
+    transactions. The end of a polled transaction is only seen when
+    dma_is_ready() is called, so it adds the polling latency. */
+    uint32_t wait_cycles;   /*!< Cycles the CPU spent waiting for the channel
+    in dma_launch() (DMA_TRANS_END_INTR_WAIT) and dma_queue_wait(). */
+    uint32_t load_cycle;    /*!< mcycle when the last transaction was loaded. */
+    uint32_t launch_cycle;  /*!< mcycle when the last transaction was launched. */
+    uint32_t done_cycle;    /*!< mcycle when the end of the last transaction
+    was seen. */
+} dma_channel_stats_t;
+
+/**
+ * Profiling counters of the transactions using a trigger slot (or none).
+ */
+typedef struct
+{
+    uint32_t transactions;  /*!< Number of finished transactions. */
+    uint32_t bytes;         /*!< Bytes copied by these transactions. */
+    uint32_t busy_cycles;   /*!< Cycles from their launches to their end. */
+    uint32_t wait_cycles;   /*!< Cycles the CPU spent waiting for them. */
+} dma_slot_stats_t;
+
+/**
+ * Profiling counters of the DMA, see dma_get_stats().
+ */
+typedef struct
+{
+    dma_channel_stats_t channel[DMA_CH_NUM]; /*!< Counters of each channel. */
+    dma_slot_stats_t    slot[DMA_STATS_SLOTS]; /*!< Counters of each trigger
+    slot, indexed with DMA_STATS_SLOT(). */
+} dma_stats_t;
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          EXPORTED VARIABLES                            **/
@@ -379,11 +633,23 @@ void fic_irq_dma(void);
  *@brief Takes all DMA configurations to a state where no accidental
  * transaction can be performed.
  * It can be called anytime to reset the DMA control block.
+ * All the DMA_CH_NUM channels are reset, except the ones running a
+ * transaction.
  * @param peri Pointer to a register address following the dma structure. By
- * default (peri == NULL), the integrated DMA will be used.
+ * default (peri == NULL), the integrated DMA will be used. The registers of
+ * the other channels must follow, every DMA_CH_SIZE bytes.
  */
 void dma_init( dma *peri );
 
+/**
+ * @brief Resets a single channel as dma_init() does, leaving the others
+ * untouched, e.g. for a channel taken by a user of the DMA while the
+ * application drives the other ones. The channel keeps the registers given
+ * to a previous dma_init(), or uses the integrated DMA.
+ * @param channel The channel to reset.
+ */
+void dma_init_channel( uint8_t channel );
+
 /**
  * @brief Creates a transaction that can be loaded into the DMA.
  * @param p_trans Pointer to the dma_transaction_t structure where configuration
@@ -393,7 +659,8 @@ void dma_init( dma *peri );
  * @param p_enRealign Whether to allow the DMA to take a smaller data type
  * in order to counter misalignments between the selected data type and the
  * start pointer.
- * @param p_check Whether integrity checks should be performed.
+ * @param p_check Whether integrity checks should be performed, or only the
+ * critical ones for trusted transactions.
  * @retval DMA_CONFIG_CRITICAL_ERROR if an error was detected in the transaction
  * to be loaded.
  * @retval DMA_CONFIG_OK == 0 otherwise.
@@ -424,9 +691,120 @@ dma_config_flags_t dma_load_transaction( dma_trans_t* p_trans );
  * itself with the loaded transaction (i.e. it is likely the transaction to be
  * loaded is not the desired one).
  * @retval DMA_CONFIG_OK == 0 otherwise.
+ * @note A transaction larger than the SIZE_D1 register is launched as its
+ * first chunk of DMA_SPLIT_CHUNK_B bytes. Each of the next chunks is launched
+ * as soon as the previous one has been copied, by the transaction done
+ * interrupt (enabled for such transactions even if their end is polled) or
+ * by dma_is_ready(), whichever sees the end first.
  */
 dma_config_flags_t dma_launch( dma_trans_t* p_trans);
 
+/**
+ * @brief Validates a transaction and adds it at the end of the transaction
+ * queue. If the DMA is idle, the transaction is loaded and launched right
+ * away, otherwise it is loaded and launched from the DMA interrupt handler as
+ * soon as the previous transaction of the queue has finished, without waiting
+ * for the CPU.
+ * Queued transactions are always ended with DMA_TRANS_END_INTR, and must be
+ * SINGLE or ADDRESS mode transactions.
+ * @param p_trans Pointer to the transaction to be queued. The content of this
+ * pointer must be a static variable, and must not be modified until the
+ * transaction has finished.
+ * @param p_enRealign Whether to allow the DMA to take a smaller data type
+ * in order to counter misalignments, see dma_validate_transaction().
+ * @param p_check Whether integrity checks should be performed, see
+ * dma_validate_transaction().
+ * @retval DMA_CONFIG_CRITICAL_ERROR if the transaction is not valid, it is not
+ * queued.
+ * @retval DMA_CONFIG_TRANS_OVERRIDE if a transaction that is not part of the
+ * queue is running, it is not queued.
+ * @retval The flags of the validation otherwise.
+ */
+dma_config_flags_t dma_enqueue_transaction( dma_trans_t       *p_trans,
+                                            dma_en_realign_t  p_enRealign,
+                                            dma_perf_checks_t p_check );
+
+/**
+ * @brief Gets the number of queued transactions that have not finished yet,
+ * including the running one. Each channel has its own queue.
+ * @param channel The DMA channel.
+ * @return The number of transactions in the queue.
+ */
+uint32_t dma_queue_length( uint8_t channel );
+
+/**
+ * @brief Checks an ND transaction and builds the 2D transaction of its
+ * planes, which is validated as any transaction.
+ * @param p_nd Pointer to the ND transaction.
+ * @param p_check Whether integrity checks should be performed, see
+ * dma_validate_transaction(). They apply to the first plane only.
+ * @retval DMA_CONFIG_INCOMPATIBLE | DMA_CONFIG_CRITICAL_ERROR if the number
+ * of dimensions is not supported, or if the rows of the source or of the
+ * destination overlap.
+ * @retval DMA_CONFIG_SRC | DMA_CONFIG_CRITICAL_ERROR if a dimension is empty.
+ * @retval The flags of the validation of the planes otherwise.
+ */
+dma_config_flags_t dma_validate_nd( dma_nd_trans_t    *p_nd,
+                                    dma_perf_checks_t p_check );
+
+/**
+ * @brief Loads and launches a validated ND transaction. The first plane is
+ * launched right away, the next ones by the transaction done interrupt of
+ * the previous one (enabled even if the end is polled) or by dma_is_ready(),
+ * whichever sees the end first.
+ * @param p_nd Pointer to the ND transaction. It must not be modified until
+ * the transaction has finished.
+ * @retval DMA_CONFIG_CRITICAL_ERROR if the transaction is not valid.
+ * @retval DMA_CONFIG_TRANS_OVERRIDE if a transaction is running.
+ * @retval DMA_CONFIG_OK == 0 otherwise. If the end is INTR_WAIT, once all
+ * the planes have been copied.
+ */
+dma_config_flags_t dma_launch_nd( dma_nd_trans_t *p_nd );
+
+/**
+ * @brief Writes a validated transaction to a descriptor of a linked list.
+ * The next pointer of the descriptor is left as it is.
+ * @param p_trans Pointer to the transaction. Its end, window, in-transfer
+ * operations and channel are not part of the descriptor.
+ * @param p_desc Pointer to the descriptor, word-aligned.
+ * @param p_irq Whether the end of this transaction raises the transaction
+ * done interrupt of the chain (the last one always does).
+ * @retval DMA_CONFIG_CRITICAL_ERROR if the transaction is not valid.
+ * @retval DMA_CONFIG_INCOMPATIBLE | DMA_CONFIG_CRITICAL_ERROR if it cannot be
+ * described: circular mode, a window, in-transfer operations or a size above
+ * the one of SIZE_D1.
+ * @retval DMA_CONFIG_OK == 0 otherwise.
+ */
+dma_config_flags_t dma_fill_descriptor( dma_trans_t *p_trans,
+                                        dma_desc_t  *p_desc,
+                                        uint8_t     p_irq );
+
+/**
+ * @brief Launches a chain of descriptors. The DMA fetches each descriptor
+ * after the previous transaction and runs it, without the CPU.
+ * With an interrupt end, dma_sdk_intr_handler_trans_done() is called for the
+ * descriptors with the IRQ flag and once the chain is over. The ends that are
+ * close enough to be seen by the same interrupt are merged into one call.
+ * @param p_head The first descriptor. The descriptors must not be modified
+ * until the chain has finished.
+ * @param channel The DMA channel.
+ * @param end What should happen after the chain is launched.
+ * @retval DMA_CONFIG_CRITICAL_ERROR if the channel does not exist.
+ * @retval DMA_CONFIG_TRANS_OVERRIDE if a transaction is running.
+ * @retval DMA_CONFIG_OK == 0 otherwise. If the end is INTR_WAIT, once the
+ * whole chain has been copied.
+ */
+dma_config_flags_t dma_launch_chain( dma_desc_t          *p_head,
+                                     uint8_t             channel,
+                                     dma_trans_end_evt_t end );
+
+/**
+ * @brief Waits in wait_for_interrupt (wfi) until all the queued
+ * transactions of a channel have finished.
+ * @param channel The DMA channel.
+ */
+void dma_queue_wait( uint8_t channel );
+
 /**
  * @brief Read from the done register of the DMA. Additionally decreases the
  * count of simultaneously-launched transactions. Be careful when calling this
@@ -436,39 +814,90 @@ dma_config_flags_t dma_launch( dma_trans_t* p_trans);
  * event.
  * @return Whether the DMA is working or not. It starts returning 0 as soon as
  * the dma_launch function has returned.
+ * @param channel The DMA channel.
  * @retval 0 - DMA is working.
  * @retval 1 - DMA has finished the transmission. DMA is idle.
+ * @note A split transaction is ready once its last chunk has been copied,
+ * and an ND transaction once its last plane has been copied.
  */
-uint32_t dma_is_ready(void);
+uint32_t dma_is_ready( uint8_t channel );
 
 /**
  * @brief Get the number of windows that have already been written. Resets on
  * the start of each transaction.
+ * @param channel The DMA channel.
  * @return The number of windows that have been written from this transaction.
  */
-uint32_t dma_get_window_count(void);
+uint32_t dma_get_window_count( uint8_t channel );
+
+/**
+ * @brief Get the sum of the elements written with DMA_OP_ACC, on 32 bits and
+ * before the truncation to the destination type. Resets on the start of each
+ * transaction.
+ * @param channel The DMA channel.
+ * @return The sum of the elements written by this transaction.
+ */
+uint32_t dma_get_op_acc( uint8_t channel );
 
 /**
  * @brief Prevent the DMA from relaunching the transaction automatically after
  * finishing the current one. It does not affect the currently running
  * transaction. It has no effect if the DMA is operating in SINGLE
  * transaction mode.
+ * @param channel The DMA channel.
  */
-void dma_stop_circular(void);
+void dma_stop_circular( uint8_t channel );
 
 /**
-* @brief DMA interrupt handler.
+ * @brief Forward the transaction done interrupt of a channel launched by
+ * writing its registers directly, bypassing the HAL, to
+ * dma_sdk_intr_handler_trans_done(). Must be called right after the launch,
+ * with the interrupts disabled.
+ * @param channel The DMA channel.
+ */
+void dma_expect_trans_done( uint8_t channel );
+
+/**
+* @brief DMA interrupt handler, called for each channel whose transaction has
+* finished.
 * `dma.c` provides a weak definition of this symbol, which can be overridden
 * at link-time by providing an additional non-weak definition.
+* @param channel The DMA channel.
+*/
+void dma_sdk_intr_handler_trans_done( uint8_t channel );
+
+/**
+* @brief DMA interrupt handler of the SDK, called for each channel that has
+* copied a window, before dma_intr_handler_window_done().
+* `dma.c` provides a weak definition of this symbol, which is overridden by
+* the streams of the SDK (dma_stream.h).
+* @param channel The DMA channel.
 */
-void dma_sdk_intr_handler_trans_done(void);
+void dma_sdk_intr_handler_window_done( uint8_t channel );
 
 /**
-* @brief DMA interrupt handler.
+* @brief DMA interrupt handler, called for each channel that has copied a
+* window.
 * `dma.c` provides a weak definition of this symbol, which can be overridden
 * at link-time by providing an additional non-weak definition.
+* @param channel The DMA channel.
 */
-void dma_intr_handler_window_done(void);
+void dma_intr_handler_window_done( uint8_t channel );
+
+/**
+ * @brief Copy the profiling counters of all the channels and trigger slots.
+ * They are only updated if the driver is built with DMA_STATS (e.g. with
+ * `make app DMA_STATS=1`), otherwise they are all 0.
+ * The achieved bandwidth of a slot is its bytes over its busy cycles.
+ * @param stats Where the counters are copied.
+ */
+void dma_get_stats( dma_stats_t *stats );
+
+/**
+ * @brief Set all the profiling counters to 0, and enable the mcycle counter
+ * they are based on.
+ */
+void dma_reset_stats( void );
 
 /**
  * @brief This weak implementation allows the user to override the threshold
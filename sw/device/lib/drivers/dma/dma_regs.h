@@ -44,6 +44,7 @@ extern "C" {
 #define DMA_STATUS_REG_OFFSET 0x14
 #define DMA_STATUS_READY_BIT 0
 #define DMA_STATUS_WINDOW_DONE_BIT 1
+#define DMA_STATUS_LL_IRQ_BIT 2
 
 // Increment the D1 source pointer every time a word is copied
 #define DMA_SRC_PTR_INC_D1_REG_OFFSET 0x18
@@ -176,6 +177,48 @@ extern "C" {
 #define DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT 0
 #define DMA_INTERRUPT_EN_WINDOW_DONE_BIT 1
 
+// Wide transfer, written before SIZE_D1
+#define DMA_WIDE_REG_OFFSET 0x60
+#define DMA_WIDE_EN_BIT 0
+
+// Operations applied to each element between the read and the write, in the order of the fields.
+#define DMA_OP_CTRL_REG_OFFSET 0x64
+#define DMA_OP_CTRL_SCALE_BIT 0
+#define DMA_OP_CTRL_ADD_BIT 1
+#define DMA_OP_CTRL_MIN_BIT 2
+#define DMA_OP_CTRL_MAX_BIT 3
+#define DMA_OP_CTRL_THRESHOLD_BIT 4
+#define DMA_OP_CTRL_ACC_BIT 5
+#define DMA_OP_CTRL_BSWAP_BIT 6
+#define DMA_OP_CTRL_SIGNED_DATA_BIT 7
+#define DMA_OP_CTRL_SHIFT_MASK 0x1f
+#define DMA_OP_CTRL_SHIFT_OFFSET 8
+#define DMA_OP_CTRL_SHIFT_FIELD \
+  ((bitfield_field32_t) { .mask = DMA_OP_CTRL_SHIFT_MASK, .index = DMA_OP_CTRL_SHIFT_OFFSET })
+
+// Signed factor of the SCALE operation
+#define DMA_OP_SCALE_REG_OFFSET 0x68
+#define DMA_OP_SCALE_SCALE_MASK 0xffff
+#define DMA_OP_SCALE_SCALE_OFFSET 0
+#define DMA_OP_SCALE_SCALE_FIELD \
+  ((bitfield_field32_t) { .mask = DMA_OP_SCALE_SCALE_MASK, .index = DMA_OP_SCALE_SCALE_OFFSET })
+
+// Constant of the ADD operation
+#define DMA_OP_ADD_REG_OFFSET 0x6c
+
+// Lower bound of the MIN operation
+#define DMA_OP_MIN_REG_OFFSET 0x70
+
+// Upper bound of the MAX operation
+#define DMA_OP_MAX_REG_OFFSET 0x74
+
+// Sum of the elements written with ACC, on 32 bits, before the truncation to the destination type.
+#define DMA_OP_ACC_REG_OFFSET 0x78
+
+// Address of the next descriptor of a linked-list transaction (word
+// aligned), 0 at the end of the chain.
+#define DMA_LL_PTR_REG_OFFSET 0x7c
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
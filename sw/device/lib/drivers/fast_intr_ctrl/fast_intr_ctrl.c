@@ -34,6 +34,8 @@
 #include "core_v_mini_mcu.h"
 #include "fast_intr_ctrl_regs.h"  // Generated.
 #include "fast_intr_ctrl_structs.h"
+#include "async.h"
+#include "isr.h"
 
 /****************************************************************************/
 /**                                                                        **/
@@ -61,6 +63,20 @@
  */
 #define INTERRUPT_HANDLER_ABI __attribute__((aligned(4), interrupt))
 
+/**
+ * With IRQ_NESTED, the handlers run their fic handler with the interrupts
+ * enabled, preempted by the lines above the level of their own (see isr.h).
+ */
+#ifdef IRQ_NESTED
+#define FIC_NEST_ENTER(fic) \
+    isr_nest_t nest; \
+    isr_nest_enter(&nest, isr_level[ISR_IRQ_FAST(fic)], 0)
+#define FIC_NEST_EXIT() isr_nest_exit(&nest)
+#else
+#define FIC_NEST_ENTER(fic)
+#define FIC_NEST_EXIT()
+#endif
+
 /****************************************************************************/
 /**                                                                        **/
 /*                        TYPEDEFS AND STRUCTURES                           */
@@ -307,116 +323,203 @@ __attribute__((weak, optimize("O0"))) void fic_irq_gpio_7(void)
 /**                                                                        **/
 /****************************************************************************/
 
-void handler_irq_fast_timer_1(void)
+/*
+ * The handlers are weak, so that an application can replace the one of a
+ * source with a leaf, naked or nested handler of isr.h.
+ */
+
+__attribute__((weak)) void handler_irq_fast_timer_1(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kTimer_1_fic_e);
+    FIC_NEST_ENTER(kTimer_1_fic_e);
     // call the weak fic handler
     fic_irq_timer_1();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kTimer_1_fic_e), 0);
 }
 
-void handler_irq_fast_timer_2(void)
+__attribute__((weak)) void handler_irq_fast_timer_2(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kTimer_2_fic_e);
+    FIC_NEST_ENTER(kTimer_2_fic_e);
     // call the weak fic handler
     fic_irq_timer_2();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kTimer_2_fic_e), 0);
 }
 
-void handler_irq_fast_timer_3(void)
+__attribute__((weak)) void handler_irq_fast_timer_3(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kTimer_3_fic_e);
+    FIC_NEST_ENTER(kTimer_3_fic_e);
     // call the weak fic handler
     fic_irq_timer_3();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kTimer_3_fic_e), 0);
 }
 
-void handler_irq_fast_dma(void)
+__attribute__((weak)) void handler_irq_fast_dma(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kDma_fic_e);
+    FIC_NEST_ENTER(kDma_fic_e);
     // call the weak fic handler
     fic_irq_dma();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kDma_fic_e), 0);
 }
 
-void handler_irq_fast_spi(void)
+__attribute__((weak)) void handler_irq_fast_spi(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kSpi_fic_e);
+    FIC_NEST_ENTER(kSpi_fic_e);
     // call the weak fic handler
     fic_irq_spi();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kSpi_fic_e), 0);
 }
 
-void handler_irq_fast_spi_flash(void)
+__attribute__((weak)) void handler_irq_fast_spi_flash(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kSpiFlash_fic_e);
+    FIC_NEST_ENTER(kSpiFlash_fic_e);
     // call the weak fic handler
     fic_irq_spi_flash();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kSpiFlash_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_0(void)
+__attribute__((weak)) void handler_irq_fast_gpio_0(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_0_fic_e);
+    FIC_NEST_ENTER(kGpio_0_fic_e);
     // call the weak fic handler
     fic_irq_gpio_0();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_0_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_1(void)
+__attribute__((weak)) void handler_irq_fast_gpio_1(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_1_fic_e);
+    FIC_NEST_ENTER(kGpio_1_fic_e);
     // call the weak fic handler
     fic_irq_gpio_1();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_1_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_2(void)
+__attribute__((weak)) void handler_irq_fast_gpio_2(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_2_fic_e);
+    FIC_NEST_ENTER(kGpio_2_fic_e);
     // call the weak fic handler
     fic_irq_gpio_2();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_2_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_3(void)
+__attribute__((weak)) void handler_irq_fast_gpio_3(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_3_fic_e);
+    FIC_NEST_ENTER(kGpio_3_fic_e);
     // call the weak fic handler
     fic_irq_gpio_3();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_3_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_4(void)
+__attribute__((weak)) void handler_irq_fast_gpio_4(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_4_fic_e);
+    FIC_NEST_ENTER(kGpio_4_fic_e);
     // call the weak fic handler
     fic_irq_gpio_4();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_4_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_5(void)
+__attribute__((weak)) void handler_irq_fast_gpio_5(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_5_fic_e);
+    FIC_NEST_ENTER(kGpio_5_fic_e);
     // call the weak fic handler
     fic_irq_gpio_5();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_5_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_6(void)
+__attribute__((weak)) void handler_irq_fast_gpio_6(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_6_fic_e);
+    FIC_NEST_ENTER(kGpio_6_fic_e);
     // call the weak fic handler
     fic_irq_gpio_6();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_6_fic_e), 0);
 }
 
-void handler_irq_fast_gpio_7(void)
+__attribute__((weak)) void handler_irq_fast_gpio_7(void)
 {
     // The interrupt is cleared.
     clear_fast_interrupt(kGpio_7_fic_e);
+    FIC_NEST_ENTER(kGpio_7_fic_e);
     // call the weak fic handler
     fic_irq_gpio_7();
+    FIC_NEST_EXIT();
+    // complete the future bound to the interrupt, if any
+    async_notify(ASYNC_SOURCE_FAST(kGpio_7_fic_e), 0);
+}
+
+void fic_irq_dispatch(fast_intr_ctrl_fast_interrupt_t fast_interrupt)
+{
+    static void (*const fic_irq[])(void) = {
+        [kTimer_1_fic_e]  = fic_irq_timer_1,
+        [kTimer_2_fic_e]  = fic_irq_timer_2,
+        [kTimer_3_fic_e]  = fic_irq_timer_3,
+        [kDma_fic_e]      = fic_irq_dma,
+        [kSpi_fic_e]      = fic_irq_spi,
+        [kSpiFlash_fic_e] = fic_irq_spi_flash,
+        [kGpio_0_fic_e]   = fic_irq_gpio_0,
+        [kGpio_1_fic_e]   = fic_irq_gpio_1,
+        [kGpio_2_fic_e]   = fic_irq_gpio_2,
+        [kGpio_3_fic_e]   = fic_irq_gpio_3,
+        [kGpio_4_fic_e]   = fic_irq_gpio_4,
+        [kGpio_5_fic_e]   = fic_irq_gpio_5,
+        [kGpio_6_fic_e]   = fic_irq_gpio_6,
+        [kGpio_7_fic_e]   = fic_irq_gpio_7,
+    };
+
+    if (fast_interrupt > kGpio_7_fic_e) return;
+
+    clear_fast_interrupt(fast_interrupt);
+    fic_irq[fast_interrupt]();
+    async_notify(ASYNC_SOURCE_FAST(fast_interrupt), 0);
 }
 
 /****************************************************************************/
@@ -36,6 +36,8 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "mmio.h"
+#include "core_v_mini_mcu.h"
+#include "fast_intr_ctrl_regs.h"  // Generated.
 
 /****************************************************************************/
 /**                                                                        **/
@@ -236,6 +238,16 @@ void fic_irq_gpio_6(void);
  */
 void fic_irq_gpio_7(void);
 
+/**
+ * @brief Serve a fast interrupt from a C function, for the trap handlers
+ * that do not jump to the handlers of the vector table (e.g. the one of
+ * FreeRTOS, see sw/freertos/port_irq.c). Same as the handler of the vector
+ * table, without nesting: the bit is cleared in FAST_INTR_PENDING, the fic
+ * irq is called and the future bound to the interrupt is completed.
+ * @param fast_interrupt the peripheral that raised the interrupt
+ */
+void fic_irq_dispatch(fast_intr_ctrl_fast_interrupt_t fast_interrupt);
+
 
 /****************************************************************************/
 /**                                                                        **/
@@ -243,6 +255,18 @@ void fic_irq_gpio_7(void);
 /**                                                                        **/
 /****************************************************************************/
 
+/**
+ * @brief clear_fast_interrupt() without a call, for the leaf handlers of
+ * isr.h which replace the handlers of fast_intr_ctrl.c
+ * @param fast_interrupt specify the peripheral that will be cleared
+ */
+static inline void clear_fast_interrupt_inline(fast_intr_ctrl_fast_interrupt_t\
+ fast_interrupt)
+{
+    *(volatile uint32_t *)(FAST_INTR_CTRL_START_ADDRESS +
+        FAST_INTR_CTRL_FAST_INTR_CLEAR_REG_OFFSET) = 1u << fast_interrupt;
+}
+
 /****************************************************************************/
 /**                                                                        **/
 /**                                EOF                                     **/
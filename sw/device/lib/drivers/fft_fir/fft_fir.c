@@ -0,0 +1,103 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : fft_fir.c                                                    **
+** date     : 15/10/2026                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   fft_fir.c
+* @date   15/10/2026
+* @brief  HAL of the FFT and FIR accelerator of the testharness
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "fft_fir.h"
+
+#include "mmio.h"
+#include "bitfield.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+void fft_fir_configure(const fft_fir_config_t *config)
+{
+  uint32_t ctrl = 0;
+
+  ctrl = bitfield_bit32_write(ctrl, FFT_FIR_CTRL_FIR_EN_BIT, config->fir);
+  ctrl = bitfield_bit32_write(ctrl, FFT_FIR_CTRL_FFT_EN_BIT, config->fft);
+  ctrl = bitfield_bit32_write(ctrl, FFT_FIR_CTRL_HALF_BIT, config->half);
+  ctrl = bitfield_field32_write(ctrl, FFT_FIR_CTRL_LOG2N_FIELD, config->log2n);
+  ctrl = bitfield_field32_write(ctrl, FFT_FIR_CTRL_IN_SHIFT_FIELD, config->in_shift);
+  ctrl = bitfield_field32_write(ctrl, FFT_FIR_CTRL_TAPS_FIELD, config->taps);
+  mmio_region_write32(mmio_region_from_addr(FFT_FIR_START_ADDRESS), FFT_FIR_CTRL_REG_OFFSET, ctrl);
+}
+
+void fft_fir_load_coeffs(const int16_t *coeffs, uint32_t taps)
+{
+  mmio_region_t base = mmio_region_from_addr(FFT_FIR_START_ADDRESS);
+
+  // The accelerator takes h[0] first, the newest sample's coefficient
+  for (uint32_t k = 0; k < taps; k++) {
+    mmio_region_write32(base, FFT_FIR_COEF_REG_OFFSET, (uint16_t)coeffs[taps - 1 - k]);
+  }
+}
+
+void fft_fir_load_twiddles(const uint32_t *tw, uint32_t count)
+{
+  mmio_region_t base = mmio_region_from_addr(FFT_FIR_START_ADDRESS);
+
+  for (uint32_t k = 0; k < count; k++) {
+    mmio_region_write32(base, FFT_FIR_TWIDDLE_REG_OFFSET, tw[k]);
+  }
+}
+
+uint32_t fft_fir_frame_words(const fft_fir_config_t *config)
+{
+  uint32_t n = 1u << config->log2n;
+
+  return config->half ? n / 2 + 1 : n;
+}
+
+uint32_t fft_fir_status(void)
+{
+  return mmio_region_read32(mmio_region_from_addr(FFT_FIR_START_ADDRESS), FFT_FIR_STATUS_REG_OFFSET);
+}
+
+void fft_fir_push(uint32_t word)
+{
+  mmio_region_write32(mmio_region_from_addr(FFT_FIR_START_ADDRESS), FFT_FIR_DATA_IN_REG_OFFSET, word);
+}
+
+uint32_t fft_fir_pop(void)
+{
+  return mmio_region_read32(mmio_region_from_addr(FFT_FIR_START_ADDRESS), FFT_FIR_DATA_OUT_REG_OFFSET);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
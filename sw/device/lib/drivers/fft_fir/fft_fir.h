@@ -0,0 +1,155 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : fft_fir.h                                                    **
+** date     : 15/10/2026                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   fft_fir.h
+* @date   15/10/2026
+* @brief  HAL of the FFT and FIR accelerator of the testharness
+*
+* The accelerator sits on the external peripheral bus of the testharness and
+* processes a stream of samples written to DATA_IN, e.g. by the DMA from the
+* PDM2PCM: each word is shifted left by in_shift and its upper 16 bits taken
+* as a Q15 sample, optionally filtered by a FIR, then either output as is or
+* gathered in frames of 2^log2n samples for a radix-2 FFT. The results are
+* read from DATA_OUT. The input drives the DMA_TRIG_SLOT_EXT_ACC_TX trigger
+* slot (room for a sample) and the output the DMA_TRIG_SLOT_EXT_ACC_RX one (a
+* result to read), so the DMA feeds and drains it at its own pace.
+*
+* The results are the ones of dsp_fir_q15() and dsp_fft_radix2_q15() of the
+* DSP SDK. fft_fir_stream.h chains the PDM2PCM, the accelerator and a ring of
+* output buffers with two DMA channels.
+*/
+
+#ifndef _DRIVERS_FFT_FIR_H_
+#define _DRIVERS_FFT_FIR_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core_v_mini_mcu.h"
+#include "fft_fir_regs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       DEFINITIONS AND MACROS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+/** Start address of the accelerator (testharness_pkg::FFT_FIR_START_ADDRESS). */
+#define FFT_FIR_START_ADDRESS (EXT_PERIPHERAL_START_ADDRESS + 0x8000)
+
+/** Largest log2 of the points of the FFT (LOG2N_MAX of fft_fir.sv). */
+#define FFT_FIR_LOG2N_MAX 8
+
+/** Most coefficients of the FIR (TAPS_MAX of fft_fir.sv). */
+#define FFT_FIR_TAPS_MAX 32
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       TYPEDEFS AND STRUCTURES                            */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Configuration of the datapath.
+ */
+typedef struct {
+  bool fir;         /*!< Filters the samples. */
+  bool fft;         /*!< Transforms frames of 2^log2n samples. */
+  bool half;        /*!< Outputs the bins 0 to 2^(log2n-1) only, for a real input. */
+  uint8_t log2n;    /*!< Log2 of the points of the FFT, 1 to FFT_FIR_LOG2N_MAX. */
+  uint8_t in_shift; /*!< Left shift of the input words, e.g. 14 for the 18-bit
+                         samples of the PDM2PCM. */
+  uint8_t taps;     /*!< Coefficients of the FIR, 1 to FFT_FIR_TAPS_MAX. */
+} fft_fir_config_t;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Writes the configuration, which clears the samples in flight, the history
+ * of the FIR and the frame of the FFT. The coefficients and the twiddle
+ * factors are loaded after it.
+ */
+void fft_fir_configure(const fft_fir_config_t *config);
+
+/**
+ * Loads the coefficients of the FIR.
+ * @param coeffs Q15 coefficients reversed in time, as for dsp_fir_q15_init().
+ * @param taps Number of coefficients, the one of the configuration.
+ */
+void fft_fir_load_coeffs(const int16_t *coeffs, uint32_t taps);
+
+/**
+ * Loads the twiddle factors of the FFT.
+ * @param tw The first 2^(log2n-1) factors of dsp_fft_q15_twiddles(), the
+ * imaginary part in the upper halfword of each word as in dsp_cq15_t.
+ * @param count Number of factors, 2^(log2n-1).
+ */
+void fft_fir_load_twiddles(const uint32_t *tw, uint32_t count);
+
+/**
+ * @return The words output for a frame of the FFT: 2^log2n bins, or
+ * 2^(log2n-1)+1 with half.
+ */
+uint32_t fft_fir_frame_words(const fft_fir_config_t *config);
+
+/**
+ * @return The STATUS register, see FFT_FIR_STATUS_*_BIT.
+ */
+uint32_t fft_fir_status(void);
+
+/**
+ * Writes an input word, STATUS.IN_READY must be set.
+ */
+void fft_fir_push(uint32_t word);
+
+/**
+ * Reads an output word, STATUS.OUT_VALID must be set: a Q15 sample
+ * sign-extended without the FFT, a bin with the imaginary part in the upper
+ * halfword with it.
+ */
+uint32_t fft_fir_pop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_FFT_FIR_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
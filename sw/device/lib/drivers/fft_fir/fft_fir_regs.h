@@ -0,0 +1,64 @@
+// Generated register defines for fft_fir
+
+// Copyright information found in source file:
+// Copyright EPFL contributors.
+
+// Licensing information found in source file:
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _FFT_FIR_REG_DEFS_
+#define _FFT_FIR_REG_DEFS_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// Register width
+#define FFT_FIR_PARAM_REG_WIDTH 32
+
+// Input sample, written by the DMA when the TX slot is high
+#define FFT_FIR_DATA_IN_REG_OFFSET 0x0
+
+// Output, read by the DMA when the RX slot is high: a Q15
+#define FFT_FIR_DATA_OUT_REG_OFFSET 0x4
+
+// Configuration. A write clears the samples in flight, the
+#define FFT_FIR_CTRL_REG_OFFSET 0x8
+#define FFT_FIR_CTRL_FIR_EN_BIT 0
+#define FFT_FIR_CTRL_FFT_EN_BIT 1
+#define FFT_FIR_CTRL_HALF_BIT 2
+#define FFT_FIR_CTRL_LOG2N_MASK 0xf
+#define FFT_FIR_CTRL_LOG2N_OFFSET 4
+#define FFT_FIR_CTRL_LOG2N_FIELD \
+  ((bitfield_field32_t) { .mask = FFT_FIR_CTRL_LOG2N_MASK, .index = FFT_FIR_CTRL_LOG2N_OFFSET })
+#define FFT_FIR_CTRL_IN_SHIFT_MASK 0x1f
+#define FFT_FIR_CTRL_IN_SHIFT_OFFSET 8
+#define FFT_FIR_CTRL_IN_SHIFT_FIELD \
+  ((bitfield_field32_t) { .mask = FFT_FIR_CTRL_IN_SHIFT_MASK, .index = FFT_FIR_CTRL_IN_SHIFT_OFFSET })
+#define FFT_FIR_CTRL_TAPS_MASK 0x3f
+#define FFT_FIR_CTRL_TAPS_OFFSET 16
+#define FFT_FIR_CTRL_TAPS_FIELD \
+  ((bitfield_field32_t) { .mask = FFT_FIR_CTRL_TAPS_MASK, .index = FFT_FIR_CTRL_TAPS_OFFSET })
+
+// Writes the next coefficient of the FIR, Q15, from h[0]
+#define FFT_FIR_COEF_REG_OFFSET 0xc
+#define FFT_FIR_COEF_COEF_MASK 0xffff
+#define FFT_FIR_COEF_COEF_OFFSET 0
+#define FFT_FIR_COEF_COEF_FIELD \
+  ((bitfield_field32_t) { .mask = FFT_FIR_COEF_COEF_MASK, .index = FFT_FIR_COEF_COEF_OFFSET })
+
+// Writes the next twiddle factor of the FFT from k = 0, the imaginary part in
+// [31:16] and the real part in [15:0]
+#define FFT_FIR_TWIDDLE_REG_OFFSET 0x10
+
+// Status of the datapath
+#define FFT_FIR_STATUS_REG_OFFSET 0x14
+#define FFT_FIR_STATUS_IN_READY_BIT 0
+#define FFT_FIR_STATUS_OUT_VALID_BIT 1
+#define FFT_FIR_STATUS_BUSY_BIT 2
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // _FFT_FIR_REG_DEFS_
+// End generated register defines for fft_fir
\ No newline at end of file
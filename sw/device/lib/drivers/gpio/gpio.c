@@ -35,6 +35,8 @@
 #include "gpio_structs.h"
 #include "core_v_mini_mcu.h"
 #include "bitfield.h"
+#include "csr.h"
+#include "ipc.h"
 #include "x-heep.h"
 
 /****************************************************************************/
@@ -49,6 +51,13 @@
 #define gpio_ao_peri ((volatile gpio *) GPIO_AO_START_ADDRESS)
 
 
+/**
+ * Pins of the GPIO_AO peripheral, the others are in the GPIO peripheral.
+ * The write-only GPIO_SET, GPIO_CLEAR and GPIO_TOGGLE registers change the
+ * pins whose bit is 1 and leave the others.
+ */
+#define GPIO_AO_PINS_MASK ((1u << GPIO_AO_DOMAIN_LIMIT) - 1)
+
 /**
  * GPIO_EN values
  */
@@ -116,6 +125,17 @@
  */
 void (*gpio_handlers[ GPIO_INTR_QTY ])( void );
 
+/**
+ * Ring buffer of the capture mode, filled by gpio_capture_record() and
+ * emptied by gpio_capture_read().
+ */
+static struct
+{
+    ipc_ring_t ring;
+    volatile uint32_t dropped;
+    volatile uint32_t pins;     /* capture pins, bit i for pin i */
+} gpio_capture;
+
 
 /****************************************************************************/
 /**                                                                        **/
@@ -131,6 +151,12 @@ volatile gpio * gpio_perif;
 
 __attribute__((optimize("O0"))) static void gpio_handler_irq_dummy( uint32_t dummy );
 
+/**
+ * Adds an event to the ring buffer of the capture mode, or drops it.
+ */
+static inline void gpio_capture_push( uint32_t cycle, gpio_pin_number_t pin,
+                                      uint8_t edge );
+
 
 __attribute__((always_inline)) void select_gpio_domain(gpio_pin_number_t pin)
 {
@@ -166,6 +192,13 @@ void gpio_reset_handlers_list( )
 
 void handler_irq_gpio( uint32_t id )
 {
+    gpio_pin_number_t pin = id - GPIO_INTR_START + GPIO_AO_DOMAIN_LIMIT;
+
+    if( gpio_capture.pins & ( 1u << pin ) )
+    {
+        gpio_capture_record( pin );
+        return;
+    }
     gpio_handlers[ id - GPIO_INTR_START ]();
 }
 
@@ -198,12 +231,7 @@ gpio_result_t gpio_set_mode (gpio_pin_number_t pin, gpio_mode_t mode)
 
     select_gpio_domain(pin);
 
-    if (pin >= 0 && pin < 1*GPIO_MODE_NUM_PINS)
-        gpio_perif->GPIO_MODE0 = bitfield_write(gpio_perif->GPIO_MODE0,
-                                               BIT_MASK_3, 2*pin, mode);
-    else
-        gpio_perif->GPIO_MODE1 = bitfield_write(gpio_perif->GPIO_MODE1,
-                                               BIT_MASK_3, 2*(pin-GPIO_MODE_NUM_PINS), mode);
+    gpio_gpio_mode_set(gpio_perif, pin, mode);
     return GpioOk;
 }
 
@@ -212,8 +240,7 @@ gpio_result_t gpio_en_input_sampling (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->GPIO_EN0 = bitfield_write(gpio_perif->GPIO_EN0,
-                                         BIT_MASK_1, pin, GPIO_EN__ENABLED);
+    gpio_gpio_en_set(gpio_perif, pin, GPIO_EN__ENABLED);
     return GpioOk;
 }
 
@@ -222,8 +249,7 @@ gpio_result_t gpio_dis_input_sampling (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->GPIO_EN0 = bitfield_write(gpio_perif->GPIO_EN0,
-                                         BIT_MASK_1, pin, GPIO_EN__DISABLED);
+    gpio_gpio_en_set(gpio_perif, pin, GPIO_EN__DISABLED);
     return GpioOk;
 }
 
@@ -236,10 +262,8 @@ gpio_result_t gpio_reset (gpio_pin_number_t pin)
     gpio_set_mode (pin, GpioModeIn);
     gpio_dis_input_sampling (pin);
     select_gpio_domain(pin);
-    gpio_perif->GPIO_CLEAR0 = bitfield_write(gpio_perif->GPIO_CLEAR0,
-                                         BIT_MASK_1, pin, GPIO_REMOVE_MASK);
-    gpio_perif->GPIO_SET0 = bitfield_write(gpio_perif->GPIO_SET0,
-                                         BIT_MASK_1, pin, GPIO_REMOVE_MASK);
+    gpio_gpio_clear_write(gpio_perif, pin, GPIO_REMOVE_MASK);
+    gpio_gpio_set_write(gpio_perif, pin, GPIO_REMOVE_MASK);
     gpio_intr_dis_all(pin);
     gpio_intr_clear_stat(pin);
     return GpioOk;
@@ -283,7 +307,7 @@ gpio_result_t gpio_read (gpio_pin_number_t pin, bool *val)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    *val = bitfield_read(gpio_perif->GPIO_IN0, BIT_MASK_1, pin);
+    *val = gpio_gpio_in_get(gpio_perif, pin);
     return GpioOk;
 }
 
@@ -292,8 +316,7 @@ gpio_result_t gpio_toggle (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->GPIO_OUT0 = bitfield_write(gpio_perif->GPIO_OUT0, BIT_MASK_1,
-        pin, !(bitfield_read(gpio_perif->GPIO_OUT0, BIT_MASK_1, pin)));
+    gpio_gpio_toggle_write(gpio_perif, pin, 1);
     return GpioOk;
 }
 
@@ -302,8 +325,11 @@ gpio_result_t gpio_write (gpio_pin_number_t pin, bool val)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->GPIO_OUT0 = bitfield_write(gpio_perif->GPIO_OUT0,
-        BIT_MASK_1, pin, val);
+    /* A single store to SET or CLEAR, without reading OUT */
+    if (val)
+        gpio_gpio_set_write(gpio_perif, pin, 1);
+    else
+        gpio_gpio_clear_write(gpio_perif, pin, 1);
     return GpioOk;
 
 }
@@ -313,8 +339,7 @@ gpio_result_t gpio_intr_en_rise (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_RISE_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_RISE_EN0, BIT_MASK_1, pin, GPIO_INTR_ENABLE);
+    gpio_intrpt_rise_en_set(gpio_perif, pin, GPIO_INTR_ENABLE);
     return GpioOk;
 }
 
@@ -323,8 +348,7 @@ gpio_result_t gpio_intr_en_fall (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_FALL_EN0 =  bitfield_write(gpio_perif->INTRPT_FALL_EN0,
-        BIT_MASK_1, pin, GPIO_INTR_ENABLE);
+    gpio_intrpt_fall_en_set(gpio_perif, pin, GPIO_INTR_ENABLE);
     return GpioOk;
 }
 
@@ -333,8 +357,7 @@ gpio_result_t gpio_intr_en_lvl_high (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_LVL_HIGH_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_LVL_HIGH_EN0, BIT_MASK_1, pin, GPIO_INTR_ENABLE);
+    gpio_intrpt_lvl_high_en_set(gpio_perif, pin, GPIO_INTR_ENABLE);
     return GpioOk;
 }
 
@@ -343,8 +366,7 @@ gpio_result_t gpio_intr_en_lvl_low (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_LVL_LOW_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_LVL_LOW_EN0, BIT_MASK_1, pin, GPIO_INTR_ENABLE);
+    gpio_intrpt_lvl_low_en_set(gpio_perif, pin, GPIO_INTR_ENABLE);
     return GpioOk;
 }
 
@@ -353,8 +375,7 @@ gpio_result_t gpio_intr_dis_rise (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_RISE_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_RISE_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_rise_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
     return GpioOk;
 }
 
@@ -363,8 +384,7 @@ gpio_result_t gpio_intr_dis_fall (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_FALL_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_FALL_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_fall_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
     return GpioOk;
 }
 
@@ -373,8 +393,7 @@ gpio_result_t gpio_intr_dis_lvl_high (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_LVL_HIGH_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_LVL_HIGH_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_lvl_high_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
     return GpioOk;
 }
 
@@ -383,8 +402,7 @@ gpio_result_t gpio_intr_dis_lvl_low (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_LVL_LOW_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_LVL_LOW_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_lvl_low_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
     return GpioOk;
 }
 
@@ -392,14 +410,10 @@ gpio_result_t gpio_intr_dis_all (gpio_pin_number_t pin){
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_RISE_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_RISE_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
-    gpio_perif->INTRPT_FALL_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_FALL_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
-    gpio_perif->INTRPT_LVL_HIGH_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_LVL_HIGH_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
-    gpio_perif->INTRPT_LVL_LOW_EN0 =  bitfield_write(
-        gpio_perif->INTRPT_LVL_LOW_EN0, BIT_MASK_1, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_rise_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_fall_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_lvl_high_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
+    gpio_intrpt_lvl_low_en_set(gpio_perif, pin, GPIO_INTR_DISABLE);
     return GpioOk;
 }
 
@@ -448,7 +462,7 @@ gpio_result_t gpio_intr_check_stat_rise (gpio_pin_number_t pin, bool *is_pending
         return GpioPinNotAcceptable;
     }
     select_gpio_domain(pin);
-    *is_pending = bitfield_read(gpio_perif->INTRPT_RISE_STATUS0, BIT_MASK_1, pin);
+    *is_pending = gpio_intrpt_rise_status_get(gpio_perif, pin);
     return GpioOk;
 }
 
@@ -460,7 +474,7 @@ gpio_result_t gpio_intr_check_stat_fall (gpio_pin_number_t pin, bool *is_pending
         return GpioPinNotAcceptable;
     }
     select_gpio_domain(pin);
-    *is_pending = bitfield_read(gpio_perif->INTRPT_FALL_STATUS0, BIT_MASK_1, pin);
+    *is_pending = gpio_intrpt_fall_status_get(gpio_perif, pin);
     return GpioOk;
 }
 
@@ -472,7 +486,7 @@ gpio_result_t gpio_intr_check_stat_lvl_low (gpio_pin_number_t pin, bool *is_pend
         return GpioPinNotAcceptable;
     }
     select_gpio_domain(pin);
-    *is_pending = bitfield_read(gpio_perif->INTRPT_LVL_LOW_STATUS0, BIT_MASK_1, pin);
+    *is_pending = gpio_intrpt_lvl_low_status_get(gpio_perif, pin);
     return GpioOk;
 }
 
@@ -484,7 +498,7 @@ gpio_result_t gpio_intr_check_stat_lvl_high (gpio_pin_number_t pin, bool *is_pen
         return GpioPinNotAcceptable;
     }
     select_gpio_domain(pin);
-     *is_pending = bitfield_read(gpio_perif->INTRPT_LVL_HIGH_STATUS0, BIT_MASK_1, pin);
+     *is_pending = gpio_intrpt_lvl_high_status_get(gpio_perif, pin);
     return GpioOk;
 }
 
@@ -495,7 +509,7 @@ gpio_result_t gpio_intr_check_stat (gpio_pin_number_t pin, bool *is_pending)
         *is_pending = GPIO_INTR_IS_NOT_TRIGGERED;
         return GpioPinNotAcceptable;
     }
-    *is_pending = bitfield_read(gpio_perif->INTRPT_STATUS0, BIT_MASK_1, pin);
+    *is_pending = gpio_intrpt_status_get(gpio_perif, pin);
     return GpioOk;
 }
 
@@ -504,8 +518,7 @@ gpio_result_t gpio_intr_clear_stat_rise (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_RISE_STATUS0 = bitfield_write(
-        gpio_perif->INTRPT_RISE_STATUS0, BIT_MASK_1, pin, GPIO_INTR_CLEAR);
+    gpio_intrpt_rise_status_write(gpio_perif, pin, GPIO_INTR_CLEAR);
     return GpioOk;
 
 }
@@ -515,8 +528,7 @@ gpio_result_t gpio_intr_clear_stat_fall (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_FALL_STATUS0 = bitfield_write(
-        gpio_perif->INTRPT_FALL_STATUS0, BIT_MASK_1, pin, GPIO_INTR_CLEAR);
+    gpio_intrpt_fall_status_write(gpio_perif, pin, GPIO_INTR_CLEAR);
     return GpioOk;
 }
 
@@ -525,8 +537,7 @@ gpio_result_t gpio_intr_clear_stat_lvl_low (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_LVL_LOW_STATUS0 = bitfield_write(
-        gpio_perif->INTRPT_LVL_LOW_STATUS0, BIT_MASK_1, pin, GPIO_INTR_CLEAR);
+    gpio_intrpt_lvl_low_status_write(gpio_perif, pin, GPIO_INTR_CLEAR);
     return GpioOk;
 }
 
@@ -535,8 +546,7 @@ gpio_result_t gpio_intr_clear_stat_lvl_high (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_LVL_HIGH_STATUS0 = bitfield_write(
-        gpio_perif->INTRPT_LVL_HIGH_STATUS0, BIT_MASK_1, pin, GPIO_INTR_CLEAR);
+    gpio_intrpt_lvl_high_status_write(gpio_perif, pin, GPIO_INTR_CLEAR);
     return GpioOk;
 }
 
@@ -545,8 +555,7 @@ gpio_result_t gpio_intr_clear_stat (gpio_pin_number_t pin)
     if (pin > (MAX_PIN-1) || pin < 0)
         return GpioPinNotAcceptable;
     select_gpio_domain(pin);
-    gpio_perif->INTRPT_STATUS0 = bitfield_write(
-        gpio_perif->INTRPT_STATUS0, BIT_MASK_1, pin, GPIO_INTR_CLEAR);
+    gpio_intrpt_status_write(gpio_perif, pin, GPIO_INTR_CLEAR);
     return GpioOk;
 }
 
@@ -557,6 +566,121 @@ void gpio_intr_set_mode (gpio_pin_number_t pin, gpio_intr_general_mode_t mode)
         gpio_perif->CFG, BIT_MASK_1, GPIO_CFG_INTR_MODE_INDEX, mode);
 }
 
+void gpio_set_mask (uint32_t mask)
+{
+    if (mask & GPIO_AO_PINS_MASK)
+        gpio_ao_peri->GPIO_SET0 = mask & GPIO_AO_PINS_MASK;
+    if (mask & ~GPIO_AO_PINS_MASK)
+        gpio_peri->GPIO_SET0 = mask & ~GPIO_AO_PINS_MASK;
+}
+
+void gpio_clear_mask (uint32_t mask)
+{
+    if (mask & GPIO_AO_PINS_MASK)
+        gpio_ao_peri->GPIO_CLEAR0 = mask & GPIO_AO_PINS_MASK;
+    if (mask & ~GPIO_AO_PINS_MASK)
+        gpio_peri->GPIO_CLEAR0 = mask & ~GPIO_AO_PINS_MASK;
+}
+
+void gpio_toggle_mask (uint32_t mask)
+{
+    if (mask & GPIO_AO_PINS_MASK)
+        gpio_ao_peri->GPIO_TOGGLE0 = mask & GPIO_AO_PINS_MASK;
+    if (mask & ~GPIO_AO_PINS_MASK)
+        gpio_peri->GPIO_TOGGLE0 = mask & ~GPIO_AO_PINS_MASK;
+}
+
+void gpio_write_mask (uint32_t mask, uint32_t value)
+{
+    gpio_set_mask (mask & value);
+    gpio_clear_mask (mask & ~value);
+}
+
+uint32_t gpio_read_mask (uint32_t mask)
+{
+    uint32_t value = 0;
+    if (mask & GPIO_AO_PINS_MASK)
+        value |= gpio_ao_peri->GPIO_IN0 & GPIO_AO_PINS_MASK;
+    if (mask & ~GPIO_AO_PINS_MASK)
+        value |= gpio_peri->GPIO_IN0 & ~GPIO_AO_PINS_MASK;
+    return value & mask;
+}
+
+gpio_result_t gpio_capture_init (gpio_capture_event_t *buffer, uint32_t len)
+{
+    gpio_capture.pins = 0;
+    if (ipc_ring_init(&gpio_capture.ring, buffer, sizeof(gpio_capture_event_t), len) != 0)
+        return GpioError;
+    gpio_capture.dropped = 0;
+    /* start mcycle, used for the timestamps */
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    return GpioOk;
+}
+
+gpio_result_t gpio_capture_enable (gpio_pin_number_t pin, gpio_intr_type_t type)
+{
+    if (type != GpioIntrEdgeRising && type != GpioIntrEdgeFalling &&
+        type != GpioIntrEdgeRisingFalling)
+        return GpioIntrTypeNotAcceptable;
+    gpio_cfg_t cfg = {
+        .pin = pin,
+        .mode = GpioModeIn,
+        .en_input_sampling = true,
+        .en_intr = false,
+    };
+    gpio_result_t res = gpio_config(cfg);
+    if (res != GpioOk)
+        return res;
+    /* capture before the first edge can be served */
+    gpio_capture.pins |= 1u << pin;
+    return gpio_intr_en(pin, type);
+}
+
+gpio_result_t gpio_capture_disable (gpio_pin_number_t pin)
+{
+    if (pin > (MAX_PIN-1) || pin < 0)
+        return GpioPinNotAcceptable;
+    gpio_intr_dis_all(pin);
+    gpio_intr_clear_stat(pin);
+    gpio_capture.pins &= ~(1u << pin);
+    return GpioOk;
+}
+
+void gpio_capture_record (gpio_pin_number_t pin)
+{
+    uint32_t cycle;
+    CSR_READ(CSR_REG_MCYCLE, &cycle);
+
+    volatile gpio *perif = pin < GPIO_AO_DOMAIN_LIMIT ? gpio_ao_peri : gpio_peri;
+    uint32_t bit = 1u << pin;
+    bool rise = (perif->INTRPT_RISE_STATUS0 & bit) != 0;
+    bool fall = (perif->INTRPT_FALL_STATUS0 & bit) != 0;
+    bool level = (perif->GPIO_IN0 & bit) != 0;
+    /* rw1c, clears all the pending interrupts of this pin only */
+    perif->INTRPT_STATUS0 = bit;
+
+    if (rise && fall)
+    {
+        /* the last edge is the one that gave the current level */
+        gpio_capture_push(cycle, pin, level ? GpioCaptureFalling : GpioCaptureRising);
+        gpio_capture_push(cycle, pin, level ? GpioCaptureRising : GpioCaptureFalling);
+    }
+    else if (rise)
+        gpio_capture_push(cycle, pin, GpioCaptureRising);
+    else if (fall)
+        gpio_capture_push(cycle, pin, GpioCaptureFalling);
+}
+
+uint32_t gpio_capture_read (gpio_capture_event_t *events, uint32_t max)
+{
+    return ipc_ring_pop_n(&gpio_capture.ring, events, max);
+}
+
+uint32_t gpio_capture_dropped (void)
+{
+    return gpio_capture.dropped;
+}
+
 /****************************************************************************/
 /**                                                                        **/
 /*                            LOCAL FUNCTIONS                               */
@@ -568,6 +692,22 @@ __attribute__((optimize("O0"))) static void gpio_handler_irq_dummy( uint32_t dum
   return;
 }
 
+static inline void gpio_capture_push( uint32_t cycle, gpio_pin_number_t pin,
+                                      uint8_t edge )
+{
+    gpio_capture_event_t *event = gpio_capture.ring.buffer != NULL
+                                  ? ipc_ring_reserve(&gpio_capture.ring) : NULL;
+    if (event == NULL)
+    {
+        gpio_capture.dropped++;
+        return;
+    }
+    event->cycle = cycle;
+    event->pin = pin;
+    event->edge = edge;
+    ipc_ring_commit(&gpio_capture.ring);
+}
+
 /****************************************************************************/
 /**                                                                        **/
 /*                                 EOF                                      */
@@ -125,6 +125,25 @@ typedef struct gpio_cfg
     gpio_intr_type_t intr_type; /*!< intr type (enabling intr is req). */
 } gpio_cfg_t;
 
+/**
+ * Edge of a captured event.
+ */
+typedef enum gpio_capture_edge
+{
+    GpioCaptureFalling = 0, /*!< Falling edge. */
+    GpioCaptureRising  = 1, /*!< Rising edge. */
+} gpio_capture_edge_t;
+
+/**
+ * An edge recorded by the capture mode, see gpio_capture_enable().
+ */
+typedef struct gpio_capture_event
+{
+    uint32_t cycle;             /*!< mcycle when the interrupt was served. */
+    gpio_pin_number_t pin;      /*!< pin of the edge. */
+    uint8_t edge;               /*!< gpio_capture_edge_t of the edge. */
+} gpio_capture_event_t;
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          EXPORTED FUNCTIONS                            **/
@@ -349,6 +368,96 @@ gpio_result_t gpio_intr_clear_stat (gpio_pin_number_t pin);
  */
 void gpio_intr_set_mode (gpio_pin_number_t pin, gpio_intr_general_mode_t mode);
 
+/**
+ * @brief Sets the outputs of several pins at once, with one store per GPIO
+ * peripheral (AO for pins 0 to 7) and no read. The pins must already be
+ * outputs.
+ * @param mask pins to set, bit i for pin i.
+ */
+void gpio_set_mask (uint32_t mask);
+
+/**
+ * @brief Clears the outputs of several pins at once, see gpio_set_mask().
+ * @param mask pins to clear, bit i for pin i.
+ */
+void gpio_clear_mask (uint32_t mask);
+
+/**
+ * @brief Toggles the outputs of several pins at once, see gpio_set_mask().
+ * @param mask pins to toggle, bit i for pin i.
+ */
+void gpio_toggle_mask (uint32_t mask);
+
+/**
+ * @brief Writes the outputs of several pins, as a parallel port. The pins
+ * going high change one store before the ones going low. Other pins are left
+ * untouched, also when changed concurrently by an interrupt handler.
+ * @param mask pins to write, bit i for pin i.
+ * @param value new values, bit i for pin i.
+ */
+void gpio_write_mask (uint32_t mask, uint32_t value);
+
+/**
+ * @brief Reads the inputs of several pins at once (their input sampling must
+ * be enabled).
+ * @param mask pins to read, bit i for pin i.
+ * @return the values, bit i for pin i, 0 outside of the mask.
+ */
+uint32_t gpio_read_mask (uint32_t mask);
+
+/**
+ * @brief Starts the capture mode, in which the interrupts of the capture pins
+ * are served by recording their edges with a timestamp in a ring buffer,
+ * without calling their handlers. Also starts mcycle.
+ * @param buffer ring buffer, owned by the capture from now on.
+ * @param len number of events of the buffer, a power of 2.
+ * @return GpioError if the length is not a power of 2.
+ */
+gpio_result_t gpio_capture_init (gpio_capture_event_t *buffer, uint32_t len);
+
+/**
+ * @brief Configures a pin as a capture input. The interrupts of pins 8 to 31
+ * are recorded by handler_irq_gpio(), once enabled in the PLIC. The ones of
+ * pins 0 to 7 come through the fast interrupt controller, whose
+ * fic_irq_gpio_<pin>() handler must call gpio_capture_record(<pin>) and then
+ * clear_fast_interrupt() again.
+ * @param pin pin number.
+ * @param type GpioIntrEdgeRising, GpioIntrEdgeFalling or
+ * GpioIntrEdgeRisingFalling.
+ */
+gpio_result_t gpio_capture_enable (gpio_pin_number_t pin, gpio_intr_type_t type);
+
+/**
+ * @brief Stops capturing a pin and disables its interrupts.
+ * @param pin pin number.
+ */
+gpio_result_t gpio_capture_disable (gpio_pin_number_t pin);
+
+/**
+ * @brief Records the pending edges of a pin and clears its interrupt, to be
+ * called from its interrupt handler. If both edges are pending, the one
+ * matching the current level is recorded last. Events are dropped while the
+ * ring buffer is full.
+ * @param pin pin number.
+ */
+void gpio_capture_record (gpio_pin_number_t pin);
+
+/**
+ * @brief Moves the recorded events to the caller, oldest first. It can run
+ * while events are recorded, the capture being the only producer and the
+ * caller the only consumer.
+ * @param events where to copy the events.
+ * @param max largest number of events to copy.
+ * @return number of events copied.
+ */
+uint32_t gpio_capture_read (gpio_capture_event_t *events, uint32_t max);
+
+/**
+ * @brief Number of events dropped because the ring buffer was full, since the
+ * capture was started.
+ */
+uint32_t gpio_capture_dropped (void);
+
 #endif  // _GPIO_H_
 /****************************************************************************/
 /**                                                                        **/
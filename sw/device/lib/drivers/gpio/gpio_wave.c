@@ -0,0 +1,193 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *****************************
+**                            *******************
+**
+** project  : X-HEEP
+** filename : gpio_wave.c
+**
+***************************************************************************
+**
+** Copyright (c) EPFL contributors.
+** All rights reserved.
+**
+***************************************************************************
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+/**
+* @file     gpio_wave.c
+* @version  1
+* @brief    Waveform output on the GPIOs, paced by an rv_timer.
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stddef.h>
+#include "gpio_wave.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        DEFINITIONS AND MACROS                            */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Comparator of the counter used to pace the waveform
+ */
+#define GPIO_WAVE_COMP 0
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Disarms the comparator and clears its interrupt.
+ */
+static void gpio_wave_disarm (void);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * State of the waveform, updated by gpio_wave_tick() in the interrupt
+ */
+static struct
+{
+    const rv_timer_t *timer;
+    uint32_t hart_id;
+    const uint32_t *pattern;
+    uint32_t len;
+    uint32_t mask;
+    uint32_t period;
+    bool loop;
+    uint32_t index;
+    uint64_t next;          // Counter value of the word at index
+    uint32_t late;
+    volatile bool busy;
+} gpio_wave;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           EXPORTED FUNCTIONS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+gpio_result_t gpio_wave_start (const rv_timer_t *timer, uint32_t hart_id,
+                               const uint32_t *pattern, uint32_t len,
+                               uint32_t mask, uint32_t period, bool loop)
+{
+    uint64_t now;
+
+    if (gpio_wave.busy || timer == NULL || pattern == NULL || len == 0 ||
+        period == 0)
+        return GpioError;
+    if (rv_timer_counter_read(timer, hart_id, &now) != kRvTimerOk)
+        return GpioError;
+
+    gpio_wave.timer = timer;
+    gpio_wave.hart_id = hart_id;
+    gpio_wave.pattern = pattern;
+    gpio_wave.len = len;
+    gpio_wave.mask = mask;
+    gpio_wave.period = period;
+    gpio_wave.loop = loop;
+    gpio_wave.index = 0;
+    gpio_wave.next = now + period;
+    gpio_wave.late = 0;
+    gpio_wave.busy = true;
+
+    rv_timer_irq_clear(timer, hart_id, GPIO_WAVE_COMP);
+    rv_timer_arm(timer, hart_id, GPIO_WAVE_COMP, gpio_wave.next);
+    rv_timer_irq_enable(timer, hart_id, GPIO_WAVE_COMP, kRvTimerEnabled);
+    return GpioOk;
+}
+
+void gpio_wave_tick (void)
+{
+    uint64_t now;
+
+    if (!gpio_wave.busy)
+    {
+        if (gpio_wave.timer != NULL)
+            rv_timer_irq_clear(gpio_wave.timer, gpio_wave.hart_id,
+                               GPIO_WAVE_COMP);
+        return;
+    }
+
+    // The word first, so that its time only depends on the interrupt latency
+    gpio_write_mask(gpio_wave.mask, gpio_wave.pattern[gpio_wave.index]);
+
+    if (++gpio_wave.index == gpio_wave.len)
+    {
+        if (!gpio_wave.loop)
+        {
+            gpio_wave_disarm();
+            gpio_wave.busy = false;
+            return;
+        }
+        gpio_wave.index = 0;
+    }
+
+    // Absolute comparator value: a late handler does not delay the next words
+    gpio_wave.next += gpio_wave.period;
+    rv_timer_arm(gpio_wave.timer, gpio_wave.hart_id, GPIO_WAVE_COMP,
+                 gpio_wave.next);
+    // Writing the comparator only clears the interrupt of the counter 0 (see
+    // the rv_timer RTL), so it is cleared explicitly. If the new value is
+    // already passed, the interrupt is raised again right away.
+    rv_timer_irq_clear(gpio_wave.timer, gpio_wave.hart_id, GPIO_WAVE_COMP);
+
+    rv_timer_counter_read(gpio_wave.timer, gpio_wave.hart_id, &now);
+    if (now >= gpio_wave.next)
+        gpio_wave.late++;
+}
+
+void gpio_wave_stop (void)
+{
+    if (!gpio_wave.busy)
+        return;
+    gpio_wave_disarm();
+    gpio_wave.busy = false;
+}
+
+bool gpio_wave_busy (void)
+{
+    return gpio_wave.busy;
+}
+
+uint32_t gpio_wave_late (void)
+{
+    return gpio_wave.late;
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static void gpio_wave_disarm (void)
+{
+    rv_timer_irq_enable(gpio_wave.timer, gpio_wave.hart_id, GPIO_WAVE_COMP,
+                        kRvTimerDisabled);
+    rv_timer_arm(gpio_wave.timer, gpio_wave.hart_id, GPIO_WAVE_COMP,
+                 UINT64_MAX);
+    rv_timer_irq_clear(gpio_wave.timer, gpio_wave.hart_id, GPIO_WAVE_COMP);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,102 @@
+/*
+                              *******************
+******************************* H SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : X-HEEP                                                       **
+** filename : gpio_wave.h                                                  **
+**                                                                         **
+*****************************************************************************
+**
+** Copyright (c) EPFL contributors.
+** All rights reserved.
+**
+*****************************************************************************
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+/**
+* @file     gpio_wave.h
+* @version  1
+* @brief    Waveform output on the GPIOs, paced by an rv_timer.
+*
+* A buffer of pattern words is written to a set of pins, one word per period
+* of a counter of an rv_timer. The comparator of the counter is re-armed at
+* an absolute time from the timer interrupt, so late interrupts do not drift
+* the waveform. The application forwards the interrupt of the comparator to
+* gpio_wave_tick(), e.g. from fic_irq_timer_1() for the counter 1 of the AO
+* rv_timer, and clears the fast interrupt after it.
+*
+* No DMA trigger of the system is driven by a timer, so the words are written
+* by the interrupt handler; the shortest period is bound by its latency, a few
+* tens of cycles.
+*/
+
+#ifndef GPIO_WAVE_H_
+#define GPIO_WAVE_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/**                            MODULES USED                                **/
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+#include "rv_timer.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/**                          EXPORTED FUNCTIONS                            **/
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * @brief Starts the output of a waveform. The first word is written one
+ * period after the call. The pins must already be outputs and the counter
+ * must be running, with the tick parameters that give the period its unit.
+ * @param timer rv_timer, initialized.
+ * @param hart_id counter of the rv_timer, its comparator 0 is used.
+ * @param pattern words to write, bit i for pin i. The buffer is read while the
+ * waveform is output.
+ * @param len number of words, at least 1.
+ * @param mask pins driven by the waveform, the others are left untouched.
+ * @param period ticks of the counter between two words.
+ * @param loop if true, output the pattern until gpio_wave_stop().
+ * @return GpioOk: no problem, GpioError: bad argument or a waveform is
+ * already output.
+ */
+gpio_result_t gpio_wave_start (const rv_timer_t *timer, uint32_t hart_id,
+                               const uint32_t *pattern, uint32_t len,
+                               uint32_t mask, uint32_t period, bool loop);
+
+/**
+ * @brief Writes the next word of the waveform and arms the timer for the
+ * following one. To be called from the interrupt handler of the comparator.
+ */
+void gpio_wave_tick (void);
+
+/**
+ * @brief Stops the waveform, the pins keep their last value.
+ */
+void gpio_wave_stop (void);
+
+/**
+ * @brief Whether a waveform is being output.
+ */
+bool gpio_wave_busy (void);
+
+/**
+ * @brief Number of ticks where the handler was later than the next word, so
+ * that two words were output closer than one period.
+ */
+uint32_t gpio_wave_late (void);
+
+#endif  // _GPIO_WAVE_H_
+/****************************************************************************/
+/**                                                                        **/
+/**                                EOF                                     **/
+/**                                                                        **/
+/****************************************************************************/
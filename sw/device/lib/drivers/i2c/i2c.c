@@ -5,6 +5,7 @@
 #include "i2c.h"
 
 #include "bitfield.h"
+#include "csr.h"
 #include "i2c_regs.h"  // Generated
 
 /**
@@ -292,6 +293,9 @@ static bool irq_index(i2c_irq_t irq, bitfield_bit32_index_t *bit_index) {
     case kDifI2cIrqSdaUnstable:
       *bit_index = I2C_INTR_COMMON_SDA_UNSTABLE_BIT;
       break;
+    case kDifI2cIrqTransComplete:
+      *bit_index = I2C_INTR_COMMON_TRANS_COMPLETE_BIT;
+      break;
     default:
       return false;
   }
@@ -554,10 +558,10 @@ i2c_result_t i2c_write_byte_raw(const i2c_t *i2c, uint8_t byte,
     return kDifI2cBadArg;
   }
   // Validate that "write only" flags and "read only" flags are not set
-  // simultaneously.
-  bool has_write_flags = flags.start || flags.stop || flags.suppress_nak_irq;
+  // simultaneously. A stop may follow a read, unless it continues.
+  bool has_write_flags = flags.start || flags.suppress_nak_irq;
   bool has_read_flags = flags.read || flags.read_cont;
-  if (has_write_flags && has_read_flags) {
+  if ((has_write_flags && has_read_flags) || (flags.stop && flags.read_cont)) {
     return kDifI2cBadArg;
   }
   // Also, read_cont requires read.
@@ -626,7 +630,272 @@ i2c_result_t i2c_write_byte(const i2c_t *i2c, uint8_t byte,
   return i2c_write_byte_raw(i2c, byte, flags);
 }
 
+/**
+ * Entries of the FMT and RX FIFOs.
+ */
+static const uint32_t kFifoDepth = 32;
+
+/**
+ * Longest read of one FMT entry.
+ */
+static const uint32_t kMaxReadLen = 256;
+
+/**
+ * Interrupts served by the transactions.
+ */
+static const uint32_t kXferIrqs = 1 << I2C_INTR_COMMON_FMT_WATERMARK_BIT |
+                                  1 << I2C_INTR_COMMON_RX_WATERMARK_BIT |
+                                  1 << I2C_INTR_COMMON_FMT_OVERFLOW_BIT |
+                                  1 << I2C_INTR_COMMON_RX_OVERFLOW_BIT |
+                                  1 << I2C_INTR_COMMON_NAK_BIT |
+                                  1 << I2C_INTR_COMMON_TRANS_COMPLETE_BIT;
+
+/**
+ * Queue of the transactions and progress of the head one. The FMT entries
+ * are generated ahead of the RX bytes, so each has its own cursor. At most
+ * kFifoDepth bytes are requested and not read yet, so the RX FIFO cannot
+ * overflow.
+ */
+static struct {
+  const i2c_t *i2c;
+  i2c_xfer_t *head;
+  i2c_xfer_t *tail;
+  uint8_t fmt_segment;
+  uint16_t fmt_offset;
+  bool fmt_addr_sent;
+  bool fmt_done;
+  uint8_t rx_segment;
+  uint16_t rx_offset;
+  uint32_t rx_outstanding;
+  bool stopped;
+  bool nak;
+  bool error;
+} xfer;
+
+static void xfer_push(uint8_t byte, bool start, bool stop, bool read,
+                      bool read_cont) {
+  uint32_t fmt_byte = 0;
+  fmt_byte = bitfield_field32_write(fmt_byte, I2C_FDATA_FBYTE_FIELD, byte);
+  fmt_byte = bitfield_bit32_write(fmt_byte, I2C_FDATA_START_BIT, start);
+  fmt_byte = bitfield_bit32_write(fmt_byte, I2C_FDATA_STOP_BIT, stop);
+  fmt_byte = bitfield_bit32_write(fmt_byte, I2C_FDATA_READ_BIT, read);
+  fmt_byte = bitfield_bit32_write(fmt_byte, I2C_FDATA_RCONT_BIT, read_cont);
+  mmio_region_write32(xfer.i2c->params.base_addr, I2C_FDATA_REG_OFFSET,
+                      fmt_byte);
+}
+
+/**
+ * Pushes the next entries of `x` while the FMT FIFO has room.
+ */
+static void xfer_fill(i2c_xfer_t *x) {
+  uint8_t fmt_level;
+  i2c_get_fifo_levels(xfer.i2c, &fmt_level, NULL);
+  uint32_t room = kFifoDepth - fmt_level;
+
+  while (room > 0 && !xfer.fmt_done) {
+    const i2c_segment_t *seg = &x->segments[xfer.fmt_segment];
+    bool last = xfer.fmt_segment + 1 == x->segment_count;
+
+    if (!xfer.fmt_addr_sent) {
+      xfer_push(x->addr << 1 | seg->read, true, false, false, false);
+      xfer.fmt_addr_sent = true;
+      room--;
+      continue;
+    }
+
+    if (seg->read) {
+      uint32_t n = seg->len - xfer.fmt_offset;
+      if (n > kMaxReadLen) {
+        n = kMaxReadLen;
+      }
+      if (n > kFifoDepth - xfer.rx_outstanding) {
+        n = kFifoDepth - xfer.rx_outstanding;
+      }
+      if (n == 0) {
+        // Resumed once the RX FIFO is drained
+        break;
+      }
+      bool end = xfer.fmt_offset + n == seg->len;
+      // A length of 256 is written as 0
+      xfer_push(n, false, end && last, true, !end);
+      xfer.rx_outstanding += n;
+      xfer.fmt_offset += n;
+    } else {
+      bool end = xfer.fmt_offset + 1 == seg->len;
+      xfer_push(seg->data[xfer.fmt_offset], false, end && last, false, false);
+      xfer.fmt_offset++;
+    }
+    room--;
+
+    if (xfer.fmt_offset == seg->len) {
+      xfer.fmt_segment++;
+      xfer.fmt_offset = 0;
+      xfer.fmt_addr_sent = false;
+      xfer.fmt_done = xfer.fmt_segment == x->segment_count;
+    }
+  }
+}
+
+/**
+ * Pops the RX FIFO into the read segments of `x`.
+ */
+static void xfer_drain(i2c_xfer_t *x) {
+  uint8_t rx_level;
+  i2c_get_fifo_levels(xfer.i2c, NULL, &rx_level);
+
+  while (rx_level-- > 0) {
+    uint8_t byte;
+    i2c_read_byte(xfer.i2c, &byte);
+    if (xfer.rx_outstanding > 0) {
+      xfer.rx_outstanding--;
+    }
+
+    while (xfer.rx_segment < x->segment_count &&
+           (!x->segments[xfer.rx_segment].read ||
+            xfer.rx_offset == x->segments[xfer.rx_segment].len)) {
+      xfer.rx_segment++;
+      xfer.rx_offset = 0;
+    }
+    if (xfer.rx_segment == x->segment_count) {
+      // Not requested by this transaction
+      xfer.error = true;
+      continue;
+    }
+    x->segments[xfer.rx_segment].data[xfer.rx_offset++] = byte;
+  }
+}
+
+/**
+ * Moves the queue forward, with the I2C interrupts masked.
+ */
+static void xfer_pump(void) {
+  i2c_xfer_t *x;
+
+  while ((x = xfer.head) != NULL) {
+    if (x->status == kDifI2cXferQueued) {
+      x->status = kDifI2cXferBusy;
+      xfer.fmt_segment = 0;
+      xfer.fmt_offset = 0;
+      xfer.fmt_addr_sent = false;
+      xfer.fmt_done = false;
+      xfer.rx_segment = 0;
+      xfer.rx_offset = 0;
+      xfer.rx_outstanding = 0;
+      xfer.stopped = false;
+      xfer.nak = false;
+      xfer.error = false;
+    }
+
+    xfer_drain(x);
+    xfer_fill(x);
+    if (!xfer.fmt_done || !xfer.stopped || xfer.rx_outstanding > 0) {
+      return;
+    }
+
+    xfer.head = x->next;
+    if (xfer.head == NULL) {
+      xfer.tail = NULL;
+    }
+    x->next = NULL;
+    x->status = xfer.error ? kDifI2cXferError
+                           : (xfer.nak ? kDifI2cXferNak : kDifI2cXferDone);
+    if (x->callback != NULL) {
+      x->callback(x);
+    }
+  }
+}
+
+i2c_result_t i2c_xfer_init(const i2c_t *i2c) {
+  if (i2c == NULL) {
+    return kDifI2cBadArg;
+  }
+
+  xfer.i2c = i2c;
+  xfer.head = NULL;
+  xfer.tail = NULL;
+
+  // Refilled with 4 entries left; the bytes of short reads come with the stop
+  i2c_set_watermarks(i2c, kDifI2cLevel16Byte, kDifI2cLevel4Byte);
+  mmio_region_write32(i2c->params.base_addr, I2C_INTR_STATE_REG_OFFSET,
+                      kXferIrqs);
+  uint32_t reg =
+      mmio_region_read32(i2c->params.base_addr, I2C_INTR_ENABLE_REG_OFFSET);
+  mmio_region_write32(i2c->params.base_addr, I2C_INTR_ENABLE_REG_OFFSET,
+                      reg | kXferIrqs);
+
+  return kDifI2cOk;
+}
+
+i2c_result_t i2c_xfer_submit(i2c_xfer_t *x) {
+  if (xfer.i2c == NULL || x == NULL || x->segments == NULL ||
+      x->segment_count == 0 || x->addr > 0x7f) {
+    return kDifI2cBadArg;
+  }
+  for (uint8_t i = 0; i < x->segment_count; i++) {
+    if (x->segments[i].len == 0 || x->segments[i].data == NULL) {
+      return kDifI2cBadArg;
+    }
+  }
+
+  uint32_t mstatus;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+
+  if (x->status == kDifI2cXferQueued || x->status == kDifI2cXferBusy) {
+    CSR_WRITE(CSR_REG_MSTATUS, mstatus);
+    return kDifI2cBadArg;
+  }
+  x->status = kDifI2cXferQueued;
+  x->next = NULL;
+  if (xfer.tail == NULL) {
+    xfer.head = x;
+  } else {
+    xfer.tail->next = x;
+  }
+  xfer.tail = x;
+  if (xfer.head == x) {
+    xfer_pump();
+  }
+
+  CSR_WRITE(CSR_REG_MSTATUS, mstatus);
+  return kDifI2cOk;
+}
+
+bool i2c_xfer_busy(void) {
+  return xfer.head != NULL;
+}
+
 __attribute__((weak, optimize("O0"))) void handler_irq_i2c(uint32_t id)
 {
- // Replace this function with a non-weak implementation
+  // The transactions serve all the I2C lines. Replace this function with a
+  // non-weak implementation to serve them otherwise.
+  if (xfer.i2c == NULL) {
+    return;
+  }
+
+  uint32_t state =
+      mmio_region_read32(xfer.i2c->params.base_addr, I2C_INTR_STATE_REG_OFFSET);
+  state &= kXferIrqs;
+  mmio_region_write32(xfer.i2c->params.base_addr, I2C_INTR_STATE_REG_OFFSET,
+                      state);
+
+  if (bitfield_bit32_read(state, I2C_INTR_COMMON_NAK_BIT)) {
+    xfer.nak = true;
+  }
+  if (bitfield_bit32_read(state, I2C_INTR_COMMON_FMT_OVERFLOW_BIT) ||
+      bitfield_bit32_read(state, I2C_INTR_COMMON_RX_OVERFLOW_BIT)) {
+    xfer.error = true;
+  }
+  // A repeated start also completes a transfer for the hardware: only the
+  // stop after the last entry counts, once the FMT FIFO is empty
+  if (bitfield_bit32_read(state, I2C_INTR_COMMON_TRANS_COMPLETE_BIT) &&
+      xfer.fmt_done) {
+    uint32_t status =
+        mmio_region_read32(xfer.i2c->params.base_addr, I2C_STATUS_REG_OFFSET);
+    if (bitfield_bit32_read(status, I2C_STATUS_FMTEMPTY_BIT)) {
+      xfer.stopped = true;
+    }
+  }
+
+  xfer_pump();
 }
\ No newline at end of file
@@ -214,6 +214,10 @@ typedef enum i2c_irq {
    * Fired when the target does not maintain a stable SDA line.
    */
   kDifI2cIrqSdaUnstable,
+  /**
+   * Fired when the host issues a stop, or a repeated start.
+   */
+  kDifI2cIrqTransComplete,
 } i2c_irq_t;
 
 /**
@@ -603,6 +607,123 @@ i2c_result_t i2c_write_byte_raw(const i2c_t *i2c, uint8_t byte,
 i2c_result_t i2c_write_byte(const i2c_t *i2c, uint8_t byte,
                                     i2c_fmt_t code, bool suppress_nak_irq);
 
+/**
+ * One part of an I2C transaction: a start (repeated after the first part), the
+ * target address with the direction, and the data bytes.
+ */
+typedef struct i2c_segment {
+  /**
+   * Bytes to write, or buffer for the bytes read.
+   */
+  uint8_t *data;
+  /**
+   * Number of bytes, at least 1. Reads longer than 256 bytes are split by the
+   * driver.
+   */
+  uint16_t len;
+  /**
+   * Whether the bytes are read from the target.
+   */
+  bool read;
+} i2c_segment_t;
+
+/**
+ * State of an `i2c_xfer_t`.
+ */
+typedef enum i2c_xfer_status {
+  /**
+   * Not submitted, or completed and seen by the caller.
+   */
+  kDifI2cXferIdle = 0,
+  /**
+   * Waiting for the transactions submitted before it.
+   */
+  kDifI2cXferQueued,
+  /**
+   * On the bus.
+   */
+  kDifI2cXferBusy,
+  /**
+   * Completed.
+   */
+  kDifI2cXferDone,
+  /**
+   * Completed, but the target did not ACK a byte. The remaining bytes were
+   * still sent, and the bytes read are not valid.
+   */
+  kDifI2cXferNak,
+  /**
+   * Completed with a FIFO overflow, the bytes read are not valid.
+   */
+  kDifI2cXferError,
+} i2c_xfer_status_t;
+
+/**
+ * An I2C transaction: its segments, then a stop. The FMT FIFO is filled and
+ * the RX FIFO drained from the I2C interrupts, so that the core is free
+ * between the submission and the completion.
+ *
+ * The descriptor, its segments and their buffers belong to the driver from
+ * `i2c_xfer_submit()` until the status leaves `kDifI2cXferBusy`.
+ */
+typedef struct i2c_xfer {
+  /**
+   * 7-bit address of the target.
+   */
+  uint8_t addr;
+  /**
+   * Segments of the transaction, in bus order.
+   */
+  const i2c_segment_t *segments;
+  /**
+   * Number of segments, at least 1.
+   */
+  uint8_t segment_count;
+  /**
+   * Called from the interrupt handler at the completion; may be `NULL`. The
+   * descriptor may be submitted again from it.
+   */
+  void (*callback)(struct i2c_xfer *xfer);
+  /**
+   * Free for the caller, e.g. for the callback.
+   */
+  void *arg;
+  /**
+   * Updated by the driver.
+   */
+  volatile i2c_xfer_status_t status;
+  /**
+   * Queue link, owned by the driver.
+   */
+  struct i2c_xfer *next;
+} i2c_xfer_t;
+
+/**
+ * Prepares I2C for `i2c_xfer_submit()`: sets the FIFO watermarks and enables
+ * the FMT watermark, RX watermark, FIFO overflow, NAK and transfer complete
+ * interrupts. The caller enables the matching PLIC lines (INTR_FMT_WATERMARK,
+ * INTR_RX_WATERMARK, INTR_FMT_OVERFLOW, INTR_RX_OVERFLOW, INTR_NAK and
+ * INTR_TRANS_COMPLETE) and the host.
+ *
+ * @param i2c An I2C handle, configured, that lives as long as the program.
+ * @return The result of the operation.
+ */
+i2c_result_t i2c_xfer_init(const i2c_t *i2c);
+
+/**
+ * Queues a transaction, which goes on the bus behind the ones already queued.
+ * Each segment can be read or written; for instance, a register read is a
+ * write segment of the register address followed by a read segment.
+ *
+ * @param xfer A transaction, not queued yet.
+ * @return The result of the operation.
+ */
+i2c_result_t i2c_xfer_submit(i2c_xfer_t *xfer);
+
+/**
+ * Returns whether transactions are queued or on the bus.
+ */
+bool i2c_xfer_busy(void);
 
 /**
  * @brief Attends the plic interrupt.
@@ -37,6 +37,42 @@
 
 #include "i2s.h"
 #include "i2s_structs.h"
+#include "clk_gate.h"
+#include "core_v_mini_mcu.h"
+#include "csr.h"
+#include "rv_plic.h"
+#include "sync.h"
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            GLOBAL VARIABLES                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * The clock of the peripheral domain is held from i2s_init() to
+ * i2s_terminate(), see clk_gate.h.
+ */
+static bool i2s_clk_held = false;
+
+/**
+ * Set by the watermark interrupt while i2s_rx_wait_watermark() sleeps.
+ */
+static volatile bool i2s_watermark_waiting = false;
+static volatile bool i2s_watermark_reached = false;
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static bool i2s_watermark_cond(void *arg)
+{
+  return i2s_watermark_reached;
+}
 
 
 /****************************************************************************/
@@ -45,6 +81,15 @@
 /**                                                                        **/
 /****************************************************************************/
 
+void i2s_irq_dispatch(uint32_t id)
+{
+  if (i2s_watermark_waiting) {
+    i2s_watermark_reached = true;
+  }
+  // the handler of the application still attends the interrupt
+  handler_irq_i2s(id);
+}
+
 __attribute__((weak, optimize("O0"))) void handler_irq_i2s(uint32_t id)
 {
  // Replace this function with a non-weak implementation
@@ -53,6 +98,12 @@ __attribute__((weak, optimize("O0"))) void handler_irq_i2s(uint32_t id)
 // i2s base functions
 i2s_result_t i2s_init(uint16_t div_value, i2s_word_length_t word_length)
 {
+  // the clock runs until i2s_terminate()
+  if (!i2s_clk_held) {
+    i2s_clk_held = true;
+    clk_gate_periph_acquire(I2S_IDX);
+  }
+
   // already on ?
   if (i2s_is_running()) {
     //printf("ERROR: [I2S HAL] I2S peripheral already running");
@@ -84,15 +135,30 @@ i2s_result_t i2s_init(uint16_t div_value, i2s_word_length_t word_length)
 
 void i2s_terminate(void)
 {
+#ifdef CLK_GATE
+  // not started, or already terminated
+  if (!i2s_clk_held) return;
+#endif
+
   i2s_peri->CONTROL &= ~(
     (1 << I2S_CONTROL_EN_WS_BIT)    // disable WS gen
     + (1 << I2S_CONTROL_EN_BIT)     // disable SCK
     + (1 << I2S_CONTROL_EN_IO_BIT)  // disconnect IO
   );
+
+  if (i2s_clk_held) {
+    i2s_clk_held = false;
+    clk_gate_periph_release(I2S_IDX);
+  }
 }
 
 bool i2s_is_running(void)
 {
+#ifdef CLK_GATE
+  // the registers cannot be read with the clock gated
+  if (!i2s_clk_held) return false;
+#endif
+
   // check "running" bit in the STATUS register
   return (i2s_peri->STATUS & (1 << I2S_STATUS_RUNNING_BIT));
 }
@@ -225,6 +291,43 @@ void i2s_rx_reset_waterlevel(void)
   i2s_peri->CONTROL |= (1 << I2S_CONTROL_RESET_WATERMARK_BIT);
 }
 
+i2s_result_t i2s_rx_wait_watermark(void)
+{
+  if (! i2s_is_running()) {
+    return kI2sErrUninit;
+  }
+  uint32_t control = i2s_peri->CONTROL;
+  if (!(control & (1 << I2S_CONTROL_EN_WATERMARK_BIT)) || i2s_peri->WATERMARK == 0) {
+    return kI2sError;
+  }
+
+  uint32_t mstatus;
+  plic_irq_wake_t wake;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  if (!(control & (1 << I2S_CONTROL_INTR_EN_BIT)) || !(mstatus & 0x8) ||
+      plic_irq_wake_enable(I2S_INTR_EVENT, &wake) != kPlicOk) {
+    // the counter goes back to 0 when it reaches the watermark, many core
+    // cycles apart from its previous increment
+    uint16_t level = i2s_rx_read_waterlevel();
+    uint16_t prev;
+    do {
+      prev = level;
+      level = i2s_rx_read_waterlevel();
+    } while (level >= prev);
+    return kI2sOk;
+  }
+
+  // sleep until the watermark interrupt, served by i2s_irq_dispatch()
+  i2s_watermark_reached = false;
+  i2s_watermark_waiting = true;
+
+  sync_wait(i2s_watermark_cond, NULL);
+
+  i2s_watermark_waiting = false;
+  plic_irq_wake_restore(I2S_INTR_EVENT, &wake);
+  return kI2sOk;
+}
+
 
 
 /****************************************************************************/
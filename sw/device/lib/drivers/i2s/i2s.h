@@ -109,9 +109,18 @@ typedef enum i2s_channel_sel {
 
 /**
  * @brief Attends the plic interrupt.
+ *
+ * Called by i2s_irq_dispatch(), the event needs no clearing.
  */
 __attribute__((weak, optimize("O0"))) void handler_irq_i2s(uint32_t id);
 
+/**
+ * @brief Handler of the I2S interrupt called by the PLIC.
+ *
+ * Wakes i2s_rx_wait_watermark() up and calls handler_irq_i2s().
+ */
+void i2s_irq_dispatch(uint32_t id);
+
 /**
  * Initialize I2S peripheral
  * Starts devices connected on the I2S bus
@@ -240,6 +249,22 @@ uint16_t i2s_rx_read_waterlevel(void);
 void i2s_rx_reset_waterlevel(void);
 
 
+/**
+ * I2S wait until the watermark counter reaches the watermark
+ *
+ * With the watermark interrupt enabled (see i2s_rx_enable_watermark()) and the
+ * interrupts of the core enabled, the core sleeps until the interrupt, which
+ * is enabled in the PLIC above its threshold and still calls handler_irq_i2s().
+ * The priority and enable bit of the source are restored after. Otherwise the
+ * waterlevel is polled until it goes back to 0.
+ *
+ * @return kI2sOk success
+ * @return kI2sError the watermark counter is not enabled
+ * @return kI2sErrUninit error peripheral was not initialized
+ */
+i2s_result_t i2s_rx_wait_watermark(void);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,224 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : iffifo.c                                                     **
+** date     : 14/10/2024                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   iffifo.c
+* @date   14/10/2024
+* @brief  HAL of the IFFIFO peripheral
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "iffifo.h"
+
+#include "mmio.h"
+#include "csr.h"
+#include "hart.h"
+#include "rv_plic.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Targets and transaction of the stream of each DMA channel, kept until its
+ * end as dma_enqueue_transaction() requires.
+ */
+static dma_target_t iffifo_mem[DMA_CH_NUM];
+static dma_target_t iffifo_port[DMA_CH_NUM];
+static dma_trans_t iffifo_trans[DMA_CH_NUM];
+
+/**
+ * Set by the handler when the watermark is reached.
+ */
+static volatile uint8_t iffifo_reached_flag;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+static dma_config_flags_t iffifo_stream(uint32_t *buffer, uint32_t words, uint8_t channel, bool in);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+void iffifo_init(void)
+{
+  mmio_region_t base = mmio_region_from_addr(IFFIFO_START_ADDRESS);
+
+  // Writing INTERRUPTS lowers the line, writing 0 also disables it
+  mmio_region_write32(base, IFFIFO_INTERRUPTS_REG_OFFSET, 0);
+  iffifo_reached_flag = 0;
+
+  plic_irq_set_priority(IFFIFO_IRQ, 1);
+  plic_irq_set_enabled(IFFIFO_IRQ, kPlicToggleEnabled);
+  plic_assign_external_irq_handler(IFFIFO_IRQ, (void *)&handler_irq_iffifo);
+}
+
+uint32_t iffifo_status(void)
+{
+  return mmio_region_read32(mmio_region_from_addr(IFFIFO_START_ADDRESS), IFFIFO_STATUS_REG_OFFSET);
+}
+
+uint32_t iffifo_occupancy(void)
+{
+  return mmio_region_read32(mmio_region_from_addr(IFFIFO_START_ADDRESS), IFFIFO_OCCUPANCY_REG_OFFSET);
+}
+
+void iffifo_push(uint32_t word)
+{
+  mmio_region_write32(mmio_region_from_addr(IFFIFO_START_ADDRESS), IFFIFO_FIFO_IN_REG_OFFSET, word);
+}
+
+uint32_t iffifo_pop(void)
+{
+  return mmio_region_read32(mmio_region_from_addr(IFFIFO_START_ADDRESS), IFFIFO_FIFO_OUT_REG_OFFSET);
+}
+
+dma_config_flags_t iffifo_stream_in(const uint32_t *buffer, uint32_t words, uint8_t channel)
+{
+  return iffifo_stream((uint32_t *)buffer, words, channel, true);
+}
+
+dma_config_flags_t iffifo_stream_out(uint32_t *buffer, uint32_t words, uint8_t channel)
+{
+  return iffifo_stream(buffer, words, channel, false);
+}
+
+void iffifo_stream_wait(uint8_t channel)
+{
+  dma_queue_wait(channel);
+}
+
+void iffifo_wait_reached(uint32_t words)
+{
+  mmio_region_t base = mmio_region_from_addr(IFFIFO_START_ADDRESS);
+
+  mmio_region_write32(base, IFFIFO_WATERMARK_REG_OFFSET, words);
+
+  /*
+   * The global interrupts are disabled from the enable of REACHED to the
+   * wfi, so the interrupt cannot be served before the CPU sleeps. A pending
+   * interrupt still wakes the CPU up, and is served once they are enabled.
+   */
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  iffifo_reached_flag = 0;
+  mmio_region_write32(base, IFFIFO_INTERRUPTS_REG_OFFSET, 1 << IFFIFO_INTERRUPTS_REACHED_BIT);
+  while (!iffifo_reached_flag) {
+    wait_for_interrupt();
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+  CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+}
+
+dma_config_flags_t iffifo_read_blocks(uint32_t *buffer, uint32_t words, uint32_t block, uint8_t channel)
+{
+  dma_config_flags_t res = DMA_CONFIG_OK;
+
+  while (words > 0) {
+    uint32_t n = words < block ? words : block;
+
+    iffifo_wait_reached(n);
+    res = iffifo_stream_out(buffer, n, channel);
+    if (res & DMA_CONFIG_CRITICAL_ERROR) return res;
+    iffifo_stream_wait(channel);
+
+    buffer += n;
+    words -= n;
+  }
+  return res;
+}
+
+void handler_irq_iffifo(uint32_t id)
+{
+  // The line stays high until INTERRUPTS is written: disable REACHED, the
+  // next wait enables it again
+  mmio_region_write32(mmio_region_from_addr(IFFIFO_START_ADDRESS), IFFIFO_INTERRUPTS_REG_OFFSET, 0);
+  iffifo_reached_flag = 1;
+  iffifo_intr_handler_reached();
+}
+
+__attribute__((weak)) void iffifo_intr_handler_reached(void)
+{
+  /*
+   * The application should implement this function,
+   * this is a weak implementation.
+   */
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static dma_config_flags_t iffifo_stream(uint32_t *buffer, uint32_t words, uint8_t channel, bool in)
+{
+  if (channel >= DMA_CH_NUM || words == 0 || dma_queue_length(channel) != 0) {
+    return DMA_CONFIG_CRITICAL_ERROR;
+  }
+
+  dma_target_t *mem = &iffifo_mem[channel];
+  dma_target_t *port = &iffifo_port[channel];
+  dma_trans_t *trans = &iffifo_trans[channel];
+
+  *mem = (dma_target_t){
+    .ptr = (uint8_t *)buffer,
+    .inc_du = 1,
+    .size_du = words,
+    .type = DMA_DATA_TYPE_WORD,
+    .trig = DMA_TRIG_MEMORY,
+  };
+  *port = (dma_target_t){
+    .ptr = (uint8_t *)(IFFIFO_START_ADDRESS + (in ? IFFIFO_FIFO_IN_REG_OFFSET : IFFIFO_FIFO_OUT_REG_OFFSET)),
+    .inc_du = 0,
+    .size_du = words,
+    .type = DMA_DATA_TYPE_WORD,
+    .trig = in ? DMA_TRIG_SLOT_EXT_TX : DMA_TRIG_SLOT_EXT_RX,
+  };
+  *trans = (dma_trans_t){
+    .src = in ? mem : port,
+    .dst = in ? port : mem,
+    .mode = DMA_TRANS_MODE_SINGLE,
+    .end = DMA_TRANS_END_INTR,
+    .channel = channel,
+  };
+
+  return dma_enqueue_transaction(trans, DMA_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -4,7 +4,7 @@
 **                            *******************                          **
 **                                                                         **
 ** project  : x-heep                                                       **
-** filename : i2s.h                                                        **
+** filename : iffifo.h                                                     **
 ** date     : 28/10/2023                                                   **
 **                                                                         **
 *****************************************************************************
@@ -25,6 +25,14 @@
 * @author Pierre Guillod
 * @brief  HAL of the IFFIFO peripheral
 *
+* The IFFIFO is the FIFO of the testharness between the DMA and an external
+* peripheral: its input drives the DMA_TRIG_SLOT_EXT_TX trigger slot (room in
+* the FIFO) and its output the DMA_TRIG_SLOT_EXT_RX one (data in the FIFO), so
+* the DMA streams whole buffers into and out of it at the pace of the FIFO.
+* The REACHED interrupt fires when the occupancy reaches the watermark, for
+* the CPU to sleep until a block of data is there.
+*
+* The example IFFIFO returns each word incremented by 1.
 */
 
 #ifndef _DRIVERS_IFFIFO_H_
@@ -36,12 +44,122 @@
 /**                                                                        **/
 /****************************************************************************/
 
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core_v_mini_mcu.h"
+#include "iffifo_regs.h"
+#include "dma.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-__attribute__((weak)) void handler_irq_iffifo(uint32_t id);
+/****************************************************************************/
+/**                                                                        **/
+/*                       DEFINITIONS AND MACROS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+/** Start address of the IFFIFO (testharness_pkg::IFFIFO_START_ADDRESS). */
+#define IFFIFO_START_ADDRESS (EXT_PERIPHERAL_START_ADDRESS + 0x2000)
+
+/** PLIC interrupt of the IFFIFO (intr_vector_ext[1] of the testharness). */
+#define IFFIFO_IRQ EXT_INTR_1
+
+/** Words of the FIFO. */
+#define IFFIFO_DEPTH 4
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Disables the REACHED interrupt and assigns its handler in the PLIC, where
+ * it is enabled. plic_Init() and dma_init() must have been called.
+ */
+void iffifo_init(void);
+
+/**
+ * @return The STATUS register, see IFFIFO_STATUS_*_BIT.
+ */
+uint32_t iffifo_status(void);
+
+/**
+ * @return The number of words in the FIFO.
+ */
+uint32_t iffifo_occupancy(void);
+
+/**
+ * Writes a word into the FIFO, which must not be full.
+ */
+void iffifo_push(uint32_t word);
+
+/**
+ * Reads a word out of the FIFO, which must not be empty.
+ */
+uint32_t iffifo_pop(void);
+
+/**
+ * Starts a DMA stream of a buffer into the FIFO, paced by the
+ * DMA_TRIG_SLOT_EXT_TX slot, and returns. It ends when the whole buffer is in
+ * the FIFO, so something must read the FIFO for more than IFFIFO_DEPTH words.
+ * @param buffer Words to write, left untouched until the end of the stream.
+ * @param words Length of the buffer.
+ * @param channel DMA channel, with no transaction running or queued.
+ * @return The flags of the validation of the transaction, see
+ * dma_enqueue_transaction().
+ */
+dma_config_flags_t iffifo_stream_in(const uint32_t *buffer, uint32_t words, uint8_t channel);
+
+/**
+ * Starts a DMA stream of the FIFO into a buffer, paced by the
+ * DMA_TRIG_SLOT_EXT_RX slot, and returns. It ends when the buffer is full.
+ * @param buffer Words read.
+ * @param words Length of the buffer.
+ * @param channel DMA channel, with no transaction running or queued.
+ * @return The flags of the validation of the transaction, see
+ * dma_enqueue_transaction().
+ */
+dma_config_flags_t iffifo_stream_out(uint32_t *buffer, uint32_t words, uint8_t channel);
+
+/**
+ * Sleeps until the stream of a DMA channel has ended.
+ */
+void iffifo_stream_wait(uint8_t channel);
+
+/**
+ * Sleeps until the FIFO holds at least a number of words, with the REACHED
+ * interrupt.
+ * @param words Watermark, from 1 to IFFIFO_DEPTH.
+ */
+void iffifo_wait_reached(uint32_t words);
+
+/**
+ * Reads the FIFO into a buffer by blocks: sleeps until a block is in the FIFO,
+ * then streams it out with the DMA and sleeps until the end of the stream.
+ * For producers slower than the DMA, so the CPU and the DMA sleep between the
+ * blocks.
+ * @param buffer Words read.
+ * @param words Length of the buffer.
+ * @param block Words of a block, from 1 to IFFIFO_DEPTH.
+ * @param channel DMA channel, with no transaction running or queued.
+ * @return The flags of the validation of the last transaction.
+ */
+dma_config_flags_t iffifo_read_blocks(uint32_t *buffer, uint32_t words, uint32_t block, uint8_t channel);
+
+/**
+ * Handler of the IFFIFO interrupt, assigned by iffifo_init().
+ */
+void handler_irq_iffifo(uint32_t id);
+
+/**
+ * Called by handler_irq_iffifo() when the watermark is reached. This is a
+ * weak implementation that does nothing.
+ */
+void iffifo_intr_handler_reached(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+#include "irq_trigger.h"
+
+void irq_trigger_set_delay(uint32_t cycles)
+{
+    *(volatile uint32_t *)(IRQ_TRIGGER_START_ADDRESS + IRQ_TRIGGER_DELAY_REG_OFFSET) = cycles;
+}
+
+void irq_trigger_clear(void)
+{
+    irq_trigger_arm(0);
+}
+
+bool irq_trigger_raised(void)
+{
+    return (*(volatile uint32_t *)(IRQ_TRIGGER_START_ADDRESS + IRQ_TRIGGER_STATUS_REG_OFFSET) >> 1) & 0x1;
+}
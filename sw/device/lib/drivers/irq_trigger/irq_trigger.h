@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+/**
+ * @file   irq_trigger.h
+ * @brief  Driver of the interrupt trigger of the testharness
+ *
+ * The trigger raises an external interrupt line of the PLIC (EXT_INTR_2)
+ * and/or GPIO 1, which goes through the fast interrupt controller, a known
+ * number of cycles after it is armed. Reading mcycle just before
+ * irq_trigger_arm() gives the reference of the interrupt latency. The trigger
+ * only exists in the testharness (external peripheral example), it must not be
+ * used on FPGA or silicon.
+ */
+
+#ifndef _IRQ_TRIGGER_H_
+#define _IRQ_TRIGGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core_v_mini_mcu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IRQ_TRIGGER_START_ADDRESS (EXT_PERIPHERAL_START_ADDRESS + 0x05000)
+
+// Cycles between the write to CTRL and the raise of the lines
+#define IRQ_TRIGGER_DELAY_REG_OFFSET 0x0
+// Arms the selected lines and lowers the raised ones
+#define IRQ_TRIGGER_CTRL_REG_OFFSET 0x4
+// Bit 0 armed, bit 1 raised
+#define IRQ_TRIGGER_STATUS_REG_OFFSET 0x8
+
+#define IRQ_TRIGGER_LINE_PLIC (1 << 0)
+#define IRQ_TRIGGER_LINE_GPIO (1 << 1)
+
+// PLIC interrupt and GPIO driven by the trigger
+#define IRQ_TRIGGER_PLIC_INTR EXT_INTR_2
+#define IRQ_TRIGGER_GPIO 1
+
+// The lines are raised that many cycles after the write to CTRL plus the delay
+#define IRQ_TRIGGER_ARM_CYCLES 1
+
+/**
+ * Sets the delay between irq_trigger_arm() and the raise of the lines.
+ * @param cycles delay in clock cycles.
+ */
+void irq_trigger_set_delay(uint32_t cycles);
+
+/**
+ * Arms the trigger: the lines are raised IRQ_TRIGGER_ARM_CYCLES + delay cycles
+ * after the store reaches the trigger, and stay high until the next call or
+ * irq_trigger_clear(). Inlined, so that it is a single store after the read
+ * of the reference cycle.
+ * @param lines IRQ_TRIGGER_LINE_PLIC and/or IRQ_TRIGGER_LINE_GPIO.
+ */
+static inline void irq_trigger_arm(uint32_t lines)
+{
+    *(volatile uint32_t *)(IRQ_TRIGGER_START_ADDRESS + IRQ_TRIGGER_CTRL_REG_OFFSET) = lines;
+}
+
+/**
+ * Lowers the raised lines and disarms the trigger.
+ */
+void irq_trigger_clear(void);
+
+/**
+ * @return true if the lines have been raised since the last arm.
+ */
+bool irq_trigger_raised(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // _IRQ_TRIGGER_H_
@@ -0,0 +1,184 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : pdm2pcm.c                                                    **
+** date     : 14/10/2024                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   pdm2pcm.c
+* @date   14/10/2024
+* @brief  HAL of the PDM2PCM peripheral
+*
+*/
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "pdm2pcm.h"
+#include "mmio.h"
+#include "reg_prog.h"
+#include "core_v_mini_mcu.h"
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      DEFINITIONS AND MACROS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+#define PDM2PCM_BASE mmio_region_from_addr((uintptr_t)PDM2PCM_START_ADDRESS)
+#define PDM2PCM_COEFF_MASK PDM2PCM_HB1COEF00_COEFF_MASK
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+static void write_coeffs(ptrdiff_t offset, const int32_t *coeffs, uint32_t count);
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Hamming-windowed sinc filters, with a DC gain of 1. The halfbands are 11
+ * and 23 taps long, the FIR 27 taps long.
+ */
+static const pdm2pcm_coeffs_t pdm2pcm_presets[PDM2PCM_PASSBAND__size] = {
+  [PDM2PCM_PASSBAND_40] = {
+    .hb1 = { 32558, 18906, -2749, 332 },
+    .hb2 = { 32842, 20517, -5863, 2532, -1042, 355, -152 },
+    .fir = { 26198, 19564, 5805, -3612, -3972, 0, 1968, 848, -577, -614, 0, 239, 95, -75 },
+  },
+  [PDM2PCM_PASSBAND_60] = {
+    .hb1 = { 32558, 18906, -2749, 332 },
+    .hb2 = { 32842, 20517, -5863, 2532, -1042, 355, -152 },
+    .fir = { 39404, 19616, -5820, -3622, 3983, 0, -1973, 851, 579, -616, 0, 240, -96, -76 },
+  },
+  [PDM2PCM_PASSBAND_80] = {
+    .hb1 = { 32558, 18906, -2749, 332 },
+    .hb2 = { 32842, 20517, -5863, 2532, -1042, 355, -152 },
+    .fir = { 52342, 12078, -9382, 5839, -2452, 0, 1215, -1371, 933, -379, 0, 148, -154, 122 },
+  },
+};
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           EXPORTED FUNCTIONS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+pdm2pcm_result_t pdm2pcm_init(uint16_t clk_div, uint8_t decimation, pdm2pcm_passband_t passband)
+{
+  if (decimation < PDM2PCM_DECIMATION_MIN || decimation > PDM2PCM_DECIMATION_MAX
+      || passband >= PDM2PCM_PASSBAND__size) {
+    return kPdm2PcmBadArg;
+  }
+
+  pdm2pcm_stop();
+
+  // The decimators count the input samples, each stage runs at half the rate
+  // of the previous one
+  const reg_prog_op_t cfg[] = {
+    REG_PROG_WRITE(PDM2PCM_CLKDIVIDX_REG_OFFSET, clk_div),
+    REG_PROG_WRITE(PDM2PCM_DECIMCIC_REG_OFFSET, decimation - 1),
+    REG_PROG_WRITE(PDM2PCM_DECIMHB1_REG_OFFSET, 2 * decimation - 1),
+    REG_PROG_WRITE(PDM2PCM_DECIMHB2_REG_OFFSET, 4 * decimation - 1),
+  };
+  reg_prog_apply(PDM2PCM_BASE, cfg, REG_PROG_LEN(cfg));
+
+  pdm2pcm_set_coeffs(&pdm2pcm_presets[passband]);
+
+  return kPdm2PcmOk;
+}
+
+void pdm2pcm_set_coeffs(const pdm2pcm_coeffs_t *coeffs)
+{
+  write_coeffs(PDM2PCM_HB1COEF00_REG_OFFSET, coeffs->hb1, PDM2PCM_HB1_COEFFS);
+  write_coeffs(PDM2PCM_HB2COEF00_REG_OFFSET, coeffs->hb2, PDM2PCM_HB2_COEFFS);
+  write_coeffs(PDM2PCM_FIRCOEF00_REG_OFFSET, coeffs->fir, PDM2PCM_FIR_COEFFS);
+}
+
+const pdm2pcm_coeffs_t *pdm2pcm_preset_coeffs(pdm2pcm_passband_t passband)
+{
+  if (passband >= PDM2PCM_PASSBAND__size) {
+    return NULL;
+  }
+  return &pdm2pcm_presets[passband];
+}
+
+void pdm2pcm_start(void)
+{
+  // flush the FIFO, the clear bit is a level
+  mmio_region_write32(PDM2PCM_BASE, PDM2PCM_CONTROL_REG_OFFSET, 1 << PDM2PCM_CONTROL_CLEAR_BIT);
+  mmio_region_write32(PDM2PCM_BASE, PDM2PCM_CONTROL_REG_OFFSET, 1 << PDM2PCM_CONTROL_ENABL_BIT);
+}
+
+void pdm2pcm_stop(void)
+{
+  mmio_region_write32(PDM2PCM_BASE, PDM2PCM_CONTROL_REG_OFFSET, 0);
+}
+
+bool pdm2pcm_data_available(void)
+{
+  // the EMPTY bit of the STATUS register
+  return !mmio_region_get_bit32(PDM2PCM_BASE, PDM2PCM_STATUS_REG_OFFSET, PDM2PCM_STATUS_EMPTY_BIT);
+}
+
+uint32_t pdm2pcm_read_data(void)
+{
+  return mmio_region_read32(PDM2PCM_BASE, PDM2PCM_RXDATA_REG_OFFSET);
+}
+
+bool pdm2pcm_fifo_full(void)
+{
+  return mmio_region_get_bit32(PDM2PCM_BASE, PDM2PCM_STATUS_REG_OFFSET, PDM2PCM_STATUS_FULLL_BIT);
+}
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static void write_coeffs(ptrdiff_t offset, const int32_t *coeffs, uint32_t count)
+{
+  // the coefficient registers of a filter follow each other
+  for (uint32_t i = 0; i < count; i++) {
+    mmio_region_write32(PDM2PCM_BASE, offset + 4 * i, (uint32_t)coeffs[i] & PDM2PCM_COEFF_MASK);
+  }
+}
+
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
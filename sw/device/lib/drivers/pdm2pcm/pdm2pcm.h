@@ -0,0 +1,222 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : pdm2pcm.h                                                    **
+** date     : 14/10/2024                                                   **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   pdm2pcm.h
+* @date   14/10/2024
+* @brief  HAL of the PDM2PCM peripheral
+*
+* The PDM bitstream goes through a 4-stage CIC filter decimating by
+* `decimation`, then two halfband filters and a FIR filter, each one running at
+* half the rate of the previous one. The filters are set from presets, see
+* pdm2pcm_init().
+*
+* @note In the current version of the peripheral the FIFO is fed from the CIC
+* output, so the PCM samples come at the PDM clock frequency divided by
+* `decimation`, and the halfband and FIR stages do not shape them yet.
+*/
+
+#ifndef _DRIVERS_PDM2PCM_H_
+#define _DRIVERS_PDM2PCM_H_
+
+/**
+ * Address of the PCM data to be passed as source address to the DMA
+ */
+#define PDM2PCM_RX_DATA_ADDRESS (uint32_t)(PDM2PCM_RXDATA_REG_OFFSET+PDM2PCM_START_ADDRESS)
+
+/**
+ * Sign-extend an 18-bit PCM sample read from the peripheral
+ */
+#define PDM2PCM_SAMPLE_TO_INT(sample) (((int32_t)((sample) << 14)) >> 14)
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pdm2pcm_regs.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       DEFINITIONS AND MACROS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Range of the decimation of the CIC filter, bounded by the width of the
+ * decimation counters of the halfband and FIR stages
+ */
+#define PDM2PCM_DECIMATION_MIN 2
+#define PDM2PCM_DECIMATION_MAX 16
+
+/**
+ * Number of free coefficients of each filter: the halfbands and the FIR are
+ * symmetric, and every other coefficient of the halfbands is 0
+ */
+#define PDM2PCM_HB1_COEFFS 4
+#define PDM2PCM_HB2_COEFFS 7
+#define PDM2PCM_FIR_COEFFS 14
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        TYPEDEFS AND STRUCTURES                           */
+/**                                                                        **/
+/****************************************************************************/
+
+
+/**
+ * The result of a PDM2PCM operation.
+ */
+typedef enum pdm2pcm_result {
+  /**
+   * Indicates that the operation succeeded.
+   */
+  kPdm2PcmOk = 0,
+  /**
+   * Indicates that a parameter is out of range.
+   */
+  kPdm2PcmBadArg = 1,
+} pdm2pcm_result_t;
+
+
+/**
+ * Passband of the FIR filter, in percent of the Nyquist frequency of its
+ * input. The halfband filters keep the lower half of their input band.
+ */
+typedef enum pdm2pcm_passband {
+  PDM2PCM_PASSBAND_40 = 0,
+  PDM2PCM_PASSBAND_60 = 1,
+  PDM2PCM_PASSBAND_80 = 2,
+  PDM2PCM_PASSBAND__size
+} pdm2pcm_passband_t;
+
+
+/**
+ * Coefficients of the filters, in Q2.16 (65536 is 1.0). Index 0 is the
+ * center of the impulse response, then one side of it; for the halfbands only
+ * the odd offsets from the center (1, 3, 5...) are given after the center.
+ */
+typedef struct pdm2pcm_coeffs {
+  int32_t hb1[PDM2PCM_HB1_COEFFS];
+  int32_t hb2[PDM2PCM_HB2_COEFFS];
+  int32_t fir[PDM2PCM_FIR_COEFFS];
+} pdm2pcm_coeffs_t;
+
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Configure the PDM2PCM peripheral from a preset, leaving it disabled.
+ *
+ * The PDM clock is clk / (2 * clk_div). The CIC filter decimates by
+ * `decimation`, the first halfband by 2 more and the second one by 2 more, the
+ * FIR runs at PDM clock / (4 * decimation). The halfband filters are the same
+ * for all the presets, the FIR filter is chosen by `passband`.
+ *
+ * @param clk_div Divider of the system clock generating the PDM clock
+ * @param decimation Decimation of the CIC filter,
+ *        PDM2PCM_DECIMATION_MIN to PDM2PCM_DECIMATION_MAX
+ * @param passband Passband of the FIR filter (see pdm2pcm_passband_t)
+ * @return kPdm2PcmOk success
+ * @return kPdm2PcmBadArg a parameter is out of range
+ */
+pdm2pcm_result_t pdm2pcm_init(uint16_t clk_div, uint8_t decimation, pdm2pcm_passband_t passband);
+
+/**
+ * Replace the coefficients of the filters set by pdm2pcm_init().
+ *
+ * @param coeffs Coefficients of the three filters
+ */
+void pdm2pcm_set_coeffs(const pdm2pcm_coeffs_t *coeffs);
+
+/**
+ * Get the coefficients of the filters of a preset.
+ *
+ * @param passband Passband of the FIR filter (see pdm2pcm_passband_t)
+ * @return The coefficients, or NULL if the passband is not valid
+ */
+const pdm2pcm_coeffs_t *pdm2pcm_preset_coeffs(pdm2pcm_passband_t passband);
+
+/**
+ * Empty the FIFO and start the conversion.
+ *
+ * (Start the DMA before)
+ */
+void pdm2pcm_start(void);
+
+/**
+ * Stop the conversion and the PDM clock.
+ */
+void pdm2pcm_stop(void);
+
+/**
+ * PDM2PCM check data availability
+ *
+ * @return true if a PCM sample can be read
+ */
+bool pdm2pcm_data_available(void);
+
+/**
+ * PDM2PCM read a PCM sample
+ *
+ * @note The sample is 18-bit, sign-extend it with PDM2PCM_SAMPLE_TO_INT().
+ *
+ * @return uint32_t PCM sample
+ */
+uint32_t pdm2pcm_read_data(void);
+
+/**
+ * PDM2PCM check whether the FIFO is full, in which case the new samples are
+ * dropped until it is read
+ *
+ * @return true if the FIFO is full
+ */
+bool pdm2pcm_fifo_full(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_PDM2PCM_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
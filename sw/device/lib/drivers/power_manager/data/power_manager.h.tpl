@@ -149,6 +149,30 @@ power_manager_result_t power_gate_counters_init(power_manager_counters_t* counte
 
 power_manager_result_t power_gate_core(const power_manager_t *power_manager, power_manager_sel_intr_t sel_intr, power_manager_counters_t* cpu_counters);
 
+/**
+ * Prepares power_gate_core_fast(): keeps the CPU counters and writes the
+ * configuration of the power manager that is the same for every power-gate.
+ */
+power_manager_result_t power_gate_core_fast_init(const power_manager_t *power_manager, power_manager_counters_t* cpu_counters);
+
+/**
+ * Power-gates the core until `sel_intr`, like power_gate_core() after
+ * power_gate_core_fast_init(). Only the counters, which the power manager
+ * consumes, and the wakeup source are written, and only the registers that a
+ * call preserves are saved. It must not be called from an interrupt handler,
+ * whose mepc, mcause and mtval are not saved.
+ */
+power_manager_result_t power_gate_core_fast(power_manager_sel_intr_t sel_intr);
+
+/**
+ * Power-gates the core until `sel_intr` without saving anything, after
+ * power_gate_core_fast_init(): the wake-up starts the program again through
+ * the warm boot of crt0, into the handler of warm_boot_register(), or cold
+ * without one. It only returns, with kPowerManagerOk_e, if the core was not
+ * switched off because the interrupt was already pending.
+ */
+power_manager_result_t power_gate_core_warm(power_manager_sel_intr_t sel_intr);
+
 power_manager_result_t power_gate_periph(const power_manager_t *power_manager, power_manager_sel_state_t sel_state, power_manager_counters_t* periph_counters);
 
 power_manager_result_t power_gate_ram_block(const power_manager_t *power_manager, uint32_t sel_block, power_manager_sel_state_t sel_state, power_manager_counters_t* ram_block_counters);
@@ -13,8 +13,36 @@
 
 #include "power_manager_regs.h"  // Generated.
 
+#include "power_manager_structs.h"  // Generated.
+
 #include "x-heep.h"
 
+#include "warm_boot.h"
+
+// All the stop bits of the CPU counters
+#define CPU_COUNTERS_STOP_ALL \
+    (POWER_MANAGER_CPU_COUNTERS_STOP_CPU_RESET_ASSERT_STOP_BIT_COUNTER(1) | \
+     POWER_MANAGER_CPU_COUNTERS_STOP_CPU_RESET_DEASSERT_STOP_BIT_COUNTER(1) | \
+     POWER_MANAGER_CPU_COUNTERS_STOP_CPU_SWITCH_OFF_STOP_BIT_COUNTER(1) | \
+     POWER_MANAGER_CPU_COUNTERS_STOP_CPU_SWITCH_ON_STOP_BIT_COUNTER(1) | \
+     POWER_MANAGER_CPU_COUNTERS_STOP_CPU_ISO_OFF_STOP_BIT_COUNTER(1) | \
+     POWER_MANAGER_CPU_COUNTERS_STOP_CPU_ISO_ON_STOP_BIT_COUNTER(1))
+
+// The registers of a power manager, for the accessors of power_manager_structs.h
+static inline volatile power_manager *power_manager_get_regs(const power_manager_t *pm)
+{
+    return (volatile power_manager *)pm->base_addr.base;
+}
+
+static inline void power_manager_set_cpu_counters(volatile power_manager *regs, const power_manager_counters_t *cpu_counter)
+{
+    power_manager_cpu_reset_assert_counter_write(regs, cpu_counter->reset_off);
+    power_manager_cpu_reset_deassert_counter_write(regs, cpu_counter->reset_on);
+    power_manager_cpu_switch_off_counter_write(regs, cpu_counter->switch_off);
+    power_manager_cpu_switch_on_counter_write(regs, cpu_counter->switch_on);
+    power_manager_cpu_iso_off_counter_write(regs, cpu_counter->iso_off);
+    power_manager_cpu_iso_on_counter_write(regs, cpu_counter->iso_on);
+}
 
 void __attribute__ ((noinline)) power_gate_core_asm()
 {
@@ -189,12 +217,7 @@ power_manager_result_t __attribute__ ((noinline)) power_gate_core(const power_ma
     uint32_t reg = 0;
 
     // set counters
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_RESET_ASSERT_COUNTER_REG_OFFSET), cpu_counter->reset_off);
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_RESET_DEASSERT_COUNTER_REG_OFFSET), cpu_counter->reset_on);
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_SWITCH_OFF_COUNTER_REG_OFFSET), cpu_counter->switch_off);
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_SWITCH_ON_COUNTER_REG_OFFSET), cpu_counter->switch_on);
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_ISO_OFF_COUNTER_REG_OFFSET), cpu_counter->iso_off);
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_ISO_ON_COUNTER_REG_OFFSET), cpu_counter->iso_on);
+    power_manager_set_cpu_counters(power_manager_get_regs(power_manager), cpu_counter);
 
     // enable wakeup timers
     mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_EN_WAIT_FOR_INTR_REG_OFFSET), 1 << sel_intr);
@@ -215,14 +238,195 @@ power_manager_result_t __attribute__ ((noinline)) power_gate_core(const power_ma
     mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_INTR_STATE_REG_OFFSET), 0x0);
 
     // stop counters
-    reg = 0;
-    reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_COUNTERS_STOP_CPU_RESET_ASSERT_STOP_BIT_COUNTER_BIT, true);
-    reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_COUNTERS_STOP_CPU_RESET_DEASSERT_STOP_BIT_COUNTER_BIT, true);
-    reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_COUNTERS_STOP_CPU_SWITCH_OFF_STOP_BIT_COUNTER_BIT, true);
-    reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_COUNTERS_STOP_CPU_SWITCH_ON_STOP_BIT_COUNTER_BIT, true);
-    reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_COUNTERS_STOP_CPU_ISO_OFF_STOP_BIT_COUNTER_BIT, true);
-    reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_COUNTERS_STOP_CPU_ISO_ON_STOP_BIT_COUNTER_BIT, true);
-    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_COUNTERS_STOP_REG_OFFSET), reg);
+    power_manager_cpu_counters_stop_write(power_manager_get_regs(power_manager), CPU_COUNTERS_STOP_ALL);
+
+    return kPowerManagerOk_e;
+}
+
+// Counters of the sequences, consumed by the power manager at each power-gate
+static struct {
+    mmio_region_t base_addr;
+    power_manager_counters_t cpu_counters;
+    uint32_t armed;
+} power_gate_core_fast_cfg;
+
+void __attribute__ ((noinline)) power_gate_core_fast_asm()
+{
+    // A single asm statement, so that no value of the function lives in a
+    // caller-saved register across the power-gate. Only the registers that a
+    // call preserves are saved: the caller already saved the others.
+    asm volatile (
+
+        // write POWER_GATE_CORE[0] = 1, WAKEUP_STATE[0] = 1 and RESTORE_ADDRESS
+        "lui a0, %[base_address_20bit]\n"
+        "li  a1, 1\n"
+        "sw  a1, %[power_manager_power_gate_core_reg_offset](a0)\n"
+        "sw  a1, %[power_manager_wakeup_state_reg_offset](a0)\n"
+        "la  a1, power_gate_core_fast_wakeup\n"
+        "sw  a1, %[power_manager_restore_address_reg_offset](a0)\n"
+
+        // write registers
+        "la a0, __power_manager_start\n"
+        "sw x1,  0(a0)\n"
+        "sw x2,  4(a0)\n"
+        "sw x3,  8(a0)\n"
+        "sw x4,  12(a0)\n"
+        "sw x8,  16(a0)\n"
+        "sw x9,  20(a0)\n"
+        "sw x18, 24(a0)\n"
+        "sw x19, 28(a0)\n"
+        "sw x20, 32(a0)\n"
+        "sw x21, 36(a0)\n"
+        "sw x22, 40(a0)\n"
+        "sw x23, 44(a0)\n"
+        "sw x24, 48(a0)\n"
+        "sw x25, 52(a0)\n"
+        "sw x26, 56(a0)\n"
+        "sw x27, 60(a0)\n"
+        //csr
+        "csrr a1, mstatus\n"
+        "sw a1, 64(a0)\n"
+        "csrr a1, mie\n"
+        "sw a1, 68(a0)\n"
+        "csrr a1, mtvec\n"
+        "sw a1, 72(a0)\n"
+        "csrr a1, mscratch\n"
+        "sw a1, 76(a0)\n"
+        "csrr a1, mcycle\n"
+        "sw a1, 80(a0)\n"
+        "csrr a1, minstret\n"
+        "sw a1, 84(a0)\n"
+
+        // wait for interrupt
+        "wfi\n"
+
+        // ----------------------------
+        // power-gate
+        // ----------------------------
+
+        // ----------------------------
+        // wake-up
+        // ----------------------------
+
+        // write POWER_GATE_CORE[0] = 0 and WAKEUP_STATE[0] = 0, RESTORE_ADDRESS
+        // is only used when WAKEUP_STATE is set
+        ".global power_gate_core_fast_wakeup\n"
+        "power_gate_core_fast_wakeup:\n"
+        "lui a0, %[base_address_20bit]\n"
+        "sw  x0, %[power_manager_power_gate_core_reg_offset](a0)\n"
+        "sw  x0, %[power_manager_wakeup_state_reg_offset](a0)\n"
+
+        "la a0, __power_manager_start\n"
+        "lw x1,  0(a0)\n"
+        "lw x2,  4(a0)\n"
+        "lw x3,  8(a0)\n"
+        "lw x4,  12(a0)\n"
+        "lw x8,  16(a0)\n"
+        "lw x9,  20(a0)\n"
+        "lw x18, 24(a0)\n"
+        "lw x19, 28(a0)\n"
+        "lw x20, 32(a0)\n"
+        "lw x21, 36(a0)\n"
+        "lw x22, 40(a0)\n"
+        "lw x23, 44(a0)\n"
+        "lw x24, 48(a0)\n"
+        "lw x25, 52(a0)\n"
+        "lw x26, 56(a0)\n"
+        "lw x27, 60(a0)\n"
+        //csr
+        "lw a1, 64(a0)\n"
+        "csrw mstatus, a1\n"
+        "lw a1, 68(a0)\n"
+        "csrw mie, a1\n"
+        "lw a1, 72(a0)\n"
+        "csrw mtvec, a1\n"
+        "lw a1, 76(a0)\n"
+        "csrw mscratch, a1\n"
+        "lw a1, 80(a0)\n"
+        "csrw mcycle, a1\n"
+        "lw a1, 84(a0)\n"
+        "csrw minstret, a1\n" : : \
+        \
+        [base_address_20bit] "i" (POWER_MANAGER_START_ADDRESS >> 12), \
+        [power_manager_power_gate_core_reg_offset] "i" (POWER_MANAGER_POWER_GATE_CORE_REG_OFFSET), \
+        [power_manager_wakeup_state_reg_offset] "i" (POWER_MANAGER_WAKEUP_STATE_REG_OFFSET), \
+        [power_manager_restore_address_reg_offset] "i" (POWER_MANAGER_RESTORE_ADDRESS_REG_OFFSET) : \
+        "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", \
+        "t0", "t1", "t2", "t3", "t4", "t5", "t6", "memory" \
+    );
+
+    return;
+}
+
+power_manager_result_t power_gate_core_fast_init(const power_manager_t *power_manager, power_manager_counters_t* cpu_counters)
+{
+    uint32_t reg = 0;
+
+    power_gate_core_fast_cfg.base_addr = power_manager->base_addr;
+    power_gate_core_fast_cfg.cpu_counters = *cpu_counters;
+
+    // enable wait for SWITCH ACK
+    #ifdef TARGET_PYNQ_Z2
+        reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_WAIT_ACK_SWITCH_ON_COUNTER_CPU_WAIT_ACK_SWITCH_ON_COUNTER_BIT, 0x0);
+    #else
+        reg = bitfield_bit32_write(reg, POWER_MANAGER_CPU_WAIT_ACK_SWITCH_ON_COUNTER_CPU_WAIT_ACK_SWITCH_ON_COUNTER_BIT, 0x1);
+    #endif
+    mmio_region_write32(power_manager->base_addr, (ptrdiff_t)(POWER_MANAGER_CPU_WAIT_ACK_SWITCH_ON_COUNTER_REG_OFFSET), reg);
+
+    // The stop bits only bring the expired counters back to idle, they stay set
+    power_manager_cpu_counters_stop_write(power_manager_get_regs(power_manager), CPU_COUNTERS_STOP_ALL);
+
+    power_gate_core_fast_cfg.armed = 1;
+
+    return kPowerManagerOk_e;
+}
+
+static void power_gate_core_fast_set_counters(power_manager_sel_intr_t sel_intr)
+{
+    mmio_region_t base_addr = power_gate_core_fast_cfg.base_addr;
+
+    // set counters, they count down to 0 during the sequences
+    power_manager_set_cpu_counters((volatile power_manager *)base_addr.base, &power_gate_core_fast_cfg.cpu_counters);
+
+    // enable the wakeup source, it only matters while the core is off
+    mmio_region_write32(base_addr, (ptrdiff_t)(POWER_MANAGER_EN_WAIT_FOR_INTR_REG_OFFSET), 1 << sel_intr);
+}
+
+power_manager_result_t __attribute__ ((noinline)) power_gate_core_fast(power_manager_sel_intr_t sel_intr)
+{
+    if (!power_gate_core_fast_cfg.armed)
+    {
+        return kPowerManagerError_e;
+    }
+
+    power_gate_core_fast_set_counters(sel_intr);
+
+    power_gate_core_fast_asm();
+
+    return kPowerManagerOk_e;
+}
+
+power_manager_result_t power_gate_core_warm(power_manager_sel_intr_t sel_intr)
+{
+    mmio_region_t base_addr = power_gate_core_fast_cfg.base_addr;
+
+    if (!power_gate_core_fast_cfg.armed)
+    {
+        return kPowerManagerError_e;
+    }
+
+    power_gate_core_fast_set_counters(sel_intr);
+
+    // nothing is saved, the wake-up goes through the warm boot of crt0
+    mmio_region_write32(base_addr, (ptrdiff_t)(POWER_MANAGER_RESTORE_ADDRESS_REG_OFFSET), (uint32_t)(uintptr_t)_warm_start);
+    mmio_region_write32(base_addr, (ptrdiff_t)(POWER_MANAGER_POWER_GATE_CORE_REG_OFFSET), 1);
+    mmio_region_write32(base_addr, (ptrdiff_t)(POWER_MANAGER_WAKEUP_STATE_REG_OFFSET), 1);
+
+    asm volatile ("wfi");
+
+    // still on: an interrupt was already pending
+    mmio_region_write32(base_addr, (ptrdiff_t)(POWER_MANAGER_POWER_GATE_CORE_REG_OFFSET), 0);
+    mmio_region_write32(base_addr, (ptrdiff_t)(POWER_MANAGER_WAKEUP_STATE_REG_OFFSET), 0);
 
     return kPowerManagerOk_e;
 }
@@ -39,8 +39,11 @@
 #include "rv_plic_structs.h"
 #include <stddef.h>
 #include "bitfield.h"
+#include "csr.h"
 #include "rv_plic_regs.h"  // Generated.
 #include "handler.h"
+#include "async.h"
+#include "isr.h"
 
 // Peripheral modules from where to obtain the irq handlers
 #include "uart.h"
@@ -121,13 +124,49 @@ __attribute__((optimize("O0"))) static void handler_irq_dummy( uint32_t dummy );
 /**                                                                        **/
 /****************************************************************************/
 
+#ifdef PLIC_VECTORED
+
+/**
+ * Handlers of the interrupts of the MCU, resolved at compile time from the
+ * interrupt list of mcu_cfg.hjson (the IDs of core_v_mini_mcu.h). Being
+ * constant, the table needs no initialization and cannot be changed.
+*/
+static const handler_funct_t plic_vector[EXT_IRQ_START] = {
+  [NULL_INTR ... EXT_IRQ_START - 1]   = &handler_irq_dummy,
+  [NULL_INTR + 1 ... UART_ID_END]     = &uart_irq_dispatch,
+  [UART_ID_END + 1 ... GPIO_ID_END]   = &handler_irq_gpio,
+  [GPIO_ID_END + 1 ... I2C_ID_END]    = &handler_irq_i2c,
+  [SPI_ID]                            = &handler_irq_spi,
+  [I2S_ID]                            = &i2s_irq_dispatch,
+  [DMA_ID]                            = &handler_irq_dma,
+};
+
+/**
+ * Handlers of the external interrupts, assigned at run time with
+ * plic_assign_external_irq_handler().
+*/
+static handler_funct_t ext_handlers[QTY_INTR - EXT_IRQ_START];
+
+#else
+
 /**
  * Array for the ISRs. Length automatically generated when compiling and 
  * assigned to QTY_INTR.
  * Each element will be initialized to be the address of the handler function
- * relative to its index. So each element will be a callable function.
+ * relative to its index. So each element will be a callable function, also
+ * before plic_Init(), which fills it again with plic_reset_handlers_list().
 */
-handler_funct_t handlers[QTY_INTR];
+handler_funct_t handlers[QTY_INTR] = {
+  [NULL_INTR ... QTY_INTR - 1]        = &handler_irq_dummy,
+  [NULL_INTR + 1 ... UART_ID_END]     = &uart_irq_dispatch,
+  [UART_ID_END + 1 ... GPIO_ID_END]   = &handler_irq_gpio,
+  [GPIO_ID_END + 1 ... I2C_ID_END]    = &handler_irq_i2c,
+  [SPI_ID]                            = &handler_irq_spi,
+  [I2S_ID]                            = &i2s_irq_dispatch,
+  [DMA_ID]                            = &handler_irq_dma,
+};
+
+#endif
 
 /****************************************************************************/
 /**                                                                        **/
@@ -135,16 +174,81 @@ handler_funct_t handlers[QTY_INTR];
 /**                                                                        **/
 /****************************************************************************/
 
+#ifdef IRQ_NESTED
+
+/**
+ * The PLIC only raises the sources of a higher priority than the one being
+ * served, which preempt its handler with the lines above the level of the
+ * external line (see isr.h).
+*/
+static inline uint32_t plic_nest_enter(isr_nest_t *nest, uint32_t int_id)
+{
+  uint32_t threshold = rv_plic_peri->THRESHOLD0;
+  rv_plic_peri->THRESHOLD0 = (&rv_plic_peri->PRIO0)[int_id];
+  isr_nest_enter(nest, isr_level[ISR_IRQ_EXTERNAL], 1u << ISR_IRQ_EXTERNAL);
+  return threshold;
+}
+
+static inline void plic_nest_exit(const isr_nest_t *nest, uint32_t threshold)
+{
+  isr_nest_exit(nest);
+  rv_plic_peri->THRESHOLD0 = threshold;
+}
+
+#endif
+
+#ifdef PLIC_VECTORED
+
+void handler_irq_external(void)
+{
+  uint32_t int_id;
+
+  // Claim until no source is pending, so that the sources raised while a
+  // handler runs are served without leaving and re-entering the trap
+  while ((int_id = rv_plic_peri->CC0) != NULL_INTR)
+  {
+#ifdef IRQ_NESTED
+    isr_nest_t nest;
+    uint32_t threshold = plic_nest_enter(&nest, int_id);
+#endif
+    if (int_id < EXT_IRQ_START)
+    {
+      plic_vector[int_id](int_id);
+    }
+    else
+    {
+      ext_handlers[int_id - EXT_IRQ_START](int_id);
+    }
+#ifdef IRQ_NESTED
+    plic_nest_exit(&nest, threshold);
+#endif
+    async_notify(ASYNC_SOURCE_PLIC(int_id), 0);
+    rv_plic_peri->CC0 = int_id;
+  }
+}
+
+#else
+
 void handler_irq_external(void)
 {
   uint32_t int_id = NULL_INTR;
   plic_result_t res = plic_irq_claim(&int_id);
 
+#ifdef IRQ_NESTED
+    isr_nest_t nest;
+    uint32_t threshold = plic_nest_enter(&nest, int_id);
+#endif
     // Calls the proper handler
     handlers[int_id](int_id);
+#ifdef IRQ_NESTED
+    plic_nest_exit(&nest, threshold);
+#endif
+    async_notify(ASYNC_SOURCE_PLIC(int_id), 0);
     plic_irq_complete(&int_id);
 }
 
+#endif
+
 /*!
   Resets relevant registers of the PLIC (Level/Edge,
   priority, target, threshold, interrupts).
@@ -300,6 +404,43 @@ plic_result_t plic_target_set_threshold(uint32_t threshold)
 }
 
 
+plic_result_t plic_irq_wake_enable( uint32_t irq,
+                                    plic_irq_wake_t *saved)
+{
+  uint32_t threshold = rv_plic_peri->THRESHOLD0;
+  if(irq >= RV_PLIC_PARAM_NUM_SRC || threshold >= plicMaxPriority)
+  {
+    return kPlicBadArg;
+  }
+
+  saved->priority = (&rv_plic_peri->PRIO0)[irq];
+  plic_irq_get_enabled(irq, &saved->enabled);
+  CSR_READ(CSR_REG_MIE, &saved->mie);
+
+  // Only a source of a higher priority than the threshold raises the line
+  if(saved->priority <= threshold)
+  {
+    (&rv_plic_peri->PRIO0)[irq] = threshold + 1;
+  }
+  plic_irq_set_enabled(irq, kPlicToggleEnabled);
+  CSR_SET_BITS(CSR_REG_MIE, 1 << 11);
+
+  return kPlicOk;
+}
+
+
+void plic_irq_wake_restore( uint32_t irq,
+                            const plic_irq_wake_t *saved)
+{
+  if(!(saved->mie & (1 << 11)))
+  {
+    CSR_CLEAR_BITS(CSR_REG_MIE, 1 << 11);
+  }
+  plic_irq_set_enabled(irq, saved->enabled);
+  (&rv_plic_peri->PRIO0)[irq] = saved->priority;
+}
+
+
 plic_result_t plic_irq_is_pending( uint32_t irq,
                                           bool *is_pending)
 {
@@ -369,14 +510,31 @@ plic_result_t plic_software_irq_is_pending(void)
 plic_result_t plic_assign_external_irq_handler( uint32_t id,
                                                 void *handler )
 {
-  if( id >= EXT_IRQ_START && id <= QTY_INTR )
+  if( id >= EXT_IRQ_START && id < QTY_INTR )
   {
+#ifdef PLIC_VECTORED
+    ext_handlers[ id - EXT_IRQ_START ] = (handler_funct_t) handler;
+#else
     handlers[ id ] = (handler_funct_t) handler;
+#endif
     return kPlicOk;
   }
   return kPlicBadArg;
 }
 
+#ifdef PLIC_VECTORED
+
+void plic_reset_handlers_list(void)
+{
+  // The handlers of the MCU interrupts are constant
+  for( uint8_t i = 0; i < QTY_INTR - EXT_IRQ_START; i++ )
+  {
+    ext_handlers[i] = &handler_irq_dummy;
+  }
+}
+
+#else
+
 void plic_reset_handlers_list(void)
 {
   handlers[NULL_INTR] = &handler_irq_dummy;
@@ -385,7 +543,7 @@ void plic_reset_handlers_list(void)
   {
     if ( i <= UART_ID_END)
     {
-      handlers[i] = &handler_irq_uart;
+      handlers[i] = &uart_irq_dispatch;
     }
     else if ( i <= GPIO_ID_END)
     {
@@ -401,7 +559,7 @@ void plic_reset_handlers_list(void)
     }
     else if ( i == I2S_ID)
     {
-      handlers[i] = &handler_irq_i2s;
+      handlers[i] = &i2s_irq_dispatch;
     }
     else if ( i == DMA_ID)
     {
@@ -414,6 +572,8 @@ void plic_reset_handlers_list(void)
   }
 }
 
+#endif
+
 /****************************************************************************/
 /**                                                                        **/
 /*                            LOCAL FUNCTIONS                               */
@@ -160,6 +160,17 @@ typedef enum plic_irq_trigger {
 } plic_irq_trigger_t;
 
 
+/**
+ * The state of an interrupt source and of the external interrupt of the core
+ * saved by plic_irq_wake_enable(), for plic_irq_wake_restore().
+ */
+typedef struct plic_irq_wake {
+  uint32_t priority;      // Priority of the source
+  plic_toggle_t enabled;  // Enable bit of the source
+  uint32_t mie;           // MIE register of the core
+} plic_irq_wake_t;
+
+
 /****************************************************************************/
 /**                                                                        **/
 /*                          EXPORTED FUNCTIONS                              */
@@ -175,6 +186,10 @@ typedef enum plic_irq_trigger {
  * Once the interrupt routine is finished, this function sets to 1 the
  * external_intr_flag and calls plic_irq_complete() function to conclude
  * the handling.
+ *
+ * When built with PLIC_VECTORED=1, the handlers of the MCU interrupts come
+ * from a constant table resolved at compile time, and the sources are claimed
+ * and served one after the other until none is pending, in the same trap.
 */
 void handler_irq_external(void);
 
@@ -259,6 +274,30 @@ plic_result_t plic_irq_set_priority(  uint32_t irq,
 */
 plic_result_t plic_target_set_threshold(uint32_t threshold);
 
+/**
+ * Enables an interrupt source so that it wakes the core up from a wait, e.g.
+ * with sync_wait(): the source is enabled with a priority above the threshold,
+ * and so is the external interrupt in MIE. The handler of the source must
+ * clear the event of the peripheral.
+ *
+ * @param irq An interrupt source identification
+ * @param saved The state to restore with plic_irq_wake_restore()
+ * @return kPlicBadArg if the threshold masks every source, in which case
+ * nothing is changed and the caller polls
+*/
+plic_result_t plic_irq_wake_enable( uint32_t irq,
+                                    plic_irq_wake_t *saved);
+
+/**
+ * Restores the priority and the enable bit of a source and the MIE register
+ * saved by plic_irq_wake_enable().
+ *
+ * @param irq An interrupt source identification
+ * @param saved The state saved by plic_irq_wake_enable()
+*/
+void plic_irq_wake_restore( uint32_t irq,
+                            const plic_irq_wake_t *saved);
+
 /**
  * Returns whether a particular interrupt is currently pending.
  *
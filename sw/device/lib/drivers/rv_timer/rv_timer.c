@@ -11,6 +11,7 @@
 
 #include "bitfield.h"
 #include "rv_timer_regs.h"  // Generated.
+#include "rv_timer_structs.h"  // Generated.
 
 /**
  * The factor to multiply by to find the registers for the Nth hart.
@@ -32,6 +33,16 @@ static ptrdiff_t reg_for_hart(uint32_t hart, ptrdiff_t reg_offset) {
   return kHartRegisterSpacing * hart + reg_offset;
 }
 
+/**
+ * Returns the registers of the zero-indexed `hart`, for the accessors of
+ * `rv_timer_structs.h` on the registers repeated for each hart.
+ */
+static volatile rv_timer *regs_for_hart(const rv_timer_t *timer,
+                                        uint32_t hart) {
+  return (volatile rv_timer *)((volatile uint8_t *)timer->base_addr.base +
+                               reg_for_hart(hart, 0));
+}
+
 rv_timer_result_t rv_timer_init(mmio_region_t base_addr,
                                         rv_timer_config_t config,
                                         rv_timer_t *timer_out) {
@@ -96,14 +107,9 @@ rv_timer_result_t rv_timer_set_tick_params(
     return kRvTimerBadArg;
   }
 
-  uint32_t config_value = 0;
-  config_value = bitfield_field32_write(
-      config_value, RV_TIMER_CFG0_PRESCALE_FIELD, params.prescale);
-  config_value = bitfield_field32_write(config_value, RV_TIMER_CFG0_STEP_FIELD,
-                                        params.tick_step);
-  mmio_region_write32(timer->base_addr,
-                      reg_for_hart(hart_id, RV_TIMER_CFG0_REG_OFFSET),
-                      config_value);
+  rv_timer_cfg0_write(regs_for_hart(timer, hart_id),
+                      RV_TIMER_CFG0_PRESCALE(params.prescale) |
+                          RV_TIMER_CFG0_STEP(params.tick_step));
 
   return kRvTimerOk;
 }
@@ -142,17 +148,12 @@ rv_timer_result_t rv_timer_counter_read(const rv_timer_t *timer,
   // we first read the upper half, then the lower half. Then, we check if the
   // upper half reads the same value again. If it doesn't, it means that the
   // lower half overflowed and we need to re-take the measurement.
+  volatile rv_timer *regs = regs_for_hart(timer, hart_id);
   while (true) {
-    uint32_t upper = mmio_region_read32(
-        timer->base_addr,
-        reg_for_hart(hart_id, RV_TIMER_TIMER_V_UPPER0_REG_OFFSET));
-    uint32_t lower = mmio_region_read32(
-        timer->base_addr,
-        reg_for_hart(hart_id, RV_TIMER_TIMER_V_LOWER0_REG_OFFSET));
+    uint32_t upper = rv_timer_timer_v_upper0_read(regs);
+    uint32_t lower = rv_timer_timer_v_lower0_read(regs);
 
-    uint32_t overflow_check = mmio_region_read32(
-        timer->base_addr,
-        reg_for_hart(hart_id, RV_TIMER_TIMER_V_UPPER0_REG_OFFSET));
+    uint32_t overflow_check = rv_timer_timer_v_upper0_read(regs);
 
     if (upper == overflow_check) {
       *out = (((uint64_t)upper) << 32) | lower;
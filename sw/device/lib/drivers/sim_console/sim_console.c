@@ -0,0 +1,25 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+#include "sim_console.h"
+
+void sim_console_write(const uint8_t *buf, size_t len)
+{
+    volatile uint8_t  *data = (volatile uint8_t *)(SIM_CONSOLE_START_ADDRESS + SIM_CONSOLE_DATA_REG_OFFSET);
+    volatile uint32_t *word = (volatile uint32_t *)(SIM_CONSOLE_START_ADDRESS + SIM_CONSOLE_WORD_REG_OFFSET);
+    size_t i = 0;
+
+    // unaligned head and tail byte by byte, the rest one word at a time
+    for (; i < len && ((uintptr_t)(buf + i) & 0x3); i++) {
+        *data = buf[i];
+    }
+    for (; i + 4 <= len; i += 4) {
+        *word = *(const uint32_t *)(buf + i);
+    }
+    for (; i < len; i++) {
+        *data = buf[i];
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+/**
+ * @file   sim_console.h
+ * @brief  Driver of the simulation-only console of the testharness
+ *
+ * Every write to the console is printed to the host stdout in one cycle,
+ * without going through the UART. The console only exists in the testharness
+ * (external peripheral example), it must not be used on FPGA or silicon.
+ * Build the application with CONSOLE=sim_console to redirect printf to it.
+ */
+
+#ifndef _SIM_CONSOLE_H_
+#define _SIM_CONSOLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "core_v_mini_mcu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_CONSOLE_START_ADDRESS (EXT_PERIPHERAL_START_ADDRESS + 0x04000)
+
+// Prints the byte in bits [7:0]
+#define SIM_CONSOLE_DATA_REG_OFFSET 0x0
+// Prints the bytes enabled by the write strobes, from the least significant one
+#define SIM_CONSOLE_WORD_REG_OFFSET 0x4
+
+/**
+ * Prints a buffer on the host stdout, four bytes per write when aligned.
+ * @param buf buffer to print.
+ * @param len number of bytes to print.
+ */
+void sim_console_write(const uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // _SIM_CONSOLE_H_
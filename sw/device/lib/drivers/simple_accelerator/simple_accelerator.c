@@ -0,0 +1,112 @@
+/*
+                              *******************
+******************************* C SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : simple_accelerator.c                                                **
+** date     : 14/10/2026                                                      **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   simple_accelerator.c
+* @date   14/10/2026
+* @brief  Driver of simple_accelerator, generated by util/accgen.py from
+* hw/ip_examples/simple_accelerator/simple_accelerator.hjson, do not edit.
+*/
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include "simple_accelerator.h"
+
+/****************************************************************************/
+/**                                                                        **/
+/*                           GLOBAL VARIABLES                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static acc_cmdq_t simple_accelerator_queue;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
+/**                                                                        **/
+/****************************************************************************/
+
+static void handler_irq_simple_accelerator(uint32_t id);
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+acc_cmdq_result_t simple_accelerator_init(void)
+{
+  return acc_cmdq_init(&simple_accelerator_queue, SIMPLE_ACCELERATOR_START_ADDRESS, SIMPLE_ACCELERATOR_ID, 4,
+                       SIMPLE_ACCELERATOR_IRQ, &handler_irq_simple_accelerator);
+}
+
+uint32_t simple_accelerator_free_slots(void)
+{
+  return acc_cmdq_free_slots(&simple_accelerator_queue);
+}
+
+bool simple_accelerator_busy(void)
+{
+  return acc_cmdq_busy(&simple_accelerator_queue);
+}
+
+acc_cmdq_result_t simple_accelerator_submit(simple_accelerator_opcode_t opcode, uint8_t tag, const simple_accelerator_args_t *args)
+{
+  const uint32_t words[4] = {
+    args->src,
+    args->dst,
+    args->threshold,
+    args->size,
+  };
+
+  return acc_cmdq_submit(&simple_accelerator_queue, opcode, tag, words);
+}
+
+acc_cmdq_result_t simple_accelerator_poll(acc_cmdq_cpl_t *cpl)
+{
+  return acc_cmdq_poll(&simple_accelerator_queue, cpl);
+}
+
+acc_cmdq_result_t simple_accelerator_wait(acc_cmdq_cpl_t *cpl)
+{
+  return acc_cmdq_wait(&simple_accelerator_queue, cpl);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                            LOCAL FUNCTIONS                               */
+/**                                                                        **/
+/****************************************************************************/
+
+static void handler_irq_simple_accelerator(uint32_t id)
+{
+  acc_cmdq_irq_handler(&simple_accelerator_queue);
+}
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -0,0 +1,136 @@
+/*
+                              *******************
+******************************* H SOURCE FILE *******************************
+**                            *******************                          **
+**                                                                         **
+** project  : x-heep                                                       **
+** filename : simple_accelerator.h                                                **
+** date     : 14/10/2026                                                      **
+**                                                                         **
+*****************************************************************************
+**                                                                         **
+** Copyright (c) EPFL contributors.                                        **
+** All rights reserved.                                                    **
+**                                                                         **
+*****************************************************************************
+
+*/
+
+/***************************************************************************/
+/***************************************************************************/
+
+/**
+* @file   simple_accelerator.h
+* @date   14/10/2026
+* @brief  Driver of simple_accelerator, generated by util/accgen.py from
+* hw/ip_examples/simple_accelerator/simple_accelerator.hjson, do not edit.
+*
+* simple_accelerator is behind the standard command queue of hw/ip/acc_cmdq, see
+* acc_cmdq.h: jobs are queued with simple_accelerator_submit() and their completions are
+* taken with simple_accelerator_poll() or simple_accelerator_wait().
+*/
+
+#ifndef _DRIVERS_SIMPLE_ACCELERATOR_H_
+#define _DRIVERS_SIMPLE_ACCELERATOR_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                             MODULES USED                                 */
+/**                                                                        **/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core_v_mini_mcu.h"
+#include "acc_cmdq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/**                                                                        **/
+/*                       DEFINITIONS AND MACROS                             */
+/**                                                                        **/
+/****************************************************************************/
+
+#define SIMPLE_ACCELERATOR_START_ADDRESS (EXT_PERIPHERAL_START_ADDRESS + 0x3000)
+#define SIMPLE_ACCELERATOR_ID 0x5AC00001
+#define SIMPLE_ACCELERATOR_IRQ EXT_INTR_3
+#define SIMPLE_ACCELERATOR_CMD_DEPTH 4
+
+/****************************************************************************/
+/**                                                                        **/
+/*                        TYPEDEFS AND STRUCTURES                           */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Operations of simple_accelerator.
+ */
+typedef enum simple_accelerator_opcode {
+  kSimpleAcceleratorOpCopy = 1,  /*!< Copies size words from src to dst, clamped from below at threshold */
+} simple_accelerator_opcode_t;
+
+/**
+ * Arguments of a job of simple_accelerator.
+ */
+typedef struct simple_accelerator_args {
+  uint32_t src;  /*!< Address of the words to read */
+  uint32_t dst;  /*!< Address of the words to write */
+  uint32_t threshold;  /*!< Words below it are written as it */
+  uint32_t size;  /*!< Words to copy, up to 1023 */
+} simple_accelerator_args_t;
+
+/****************************************************************************/
+/**                                                                        **/
+/*                          EXPORTED FUNCTIONS                              */
+/**                                                                        **/
+/****************************************************************************/
+
+/**
+ * Checks the ID of simple_accelerator and enables its interrupt. plic_Init() must have
+ * been called.
+ * @return kAccCmdqOk, or kAccCmdqError if simple_accelerator is not there.
+ */
+acc_cmdq_result_t simple_accelerator_init(void);
+
+/**
+ * Number of jobs that can be queued without waiting.
+ */
+uint32_t simple_accelerator_free_slots(void);
+
+/**
+ * Whether simple_accelerator has jobs in progress or queued.
+ */
+bool simple_accelerator_busy(void);
+
+/**
+ * Queues a job, without waiting for the previous ones.
+ * @return kAccCmdqOk, or kAccCmdqFull if the queue has no free slot.
+ */
+acc_cmdq_result_t simple_accelerator_submit(simple_accelerator_opcode_t opcode, uint8_t tag, const simple_accelerator_args_t *args);
+
+/**
+ * Takes the oldest completion, without waiting.
+ * @return kAccCmdqOk, or kAccCmdqEmpty if no completion is waiting.
+ */
+acc_cmdq_result_t simple_accelerator_poll(acc_cmdq_cpl_t *cpl);
+
+/**
+ * Takes the oldest completion, sleeping until there is one.
+ */
+acc_cmdq_result_t simple_accelerator_wait(acc_cmdq_cpl_t *cpl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DRIVERS_SIMPLE_ACCELERATOR_H_
+
+/****************************************************************************/
+/**                                                                        **/
+/*                                 EOF                                      */
+/**                                                                        **/
+/****************************************************************************/
@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "bitfield.h"
 #include "mmio.h"
 
 #include "soc_ctrl.h"
@@ -40,4 +41,76 @@ void soc_ctrl_select_spi_host(const soc_ctrl_t *soc_ctrl) {
 
 uint32_t get_spi_flash_mode(const soc_ctrl_t *soc_ctrl) {
   return mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_USE_SPIMEMIO_REG_OFFSET));
-}
\ No newline at end of file
+}
+
+uint32_t soc_ctrl_get_flash_cache_hits(const soc_ctrl_t *soc_ctrl) {
+  return mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_FLASH_CACHE_HITS_REG_OFFSET));
+}
+
+uint32_t soc_ctrl_get_flash_cache_misses(const soc_ctrl_t *soc_ctrl) {
+  return mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_FLASH_CACHE_MISSES_REG_OFFSET));
+}
+
+void soc_ctrl_set_bus_qos(const soc_ctrl_t *soc_ctrl, uint32_t priority,
+                          uint32_t budget, uint16_t window) {
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_BUS_QOS_PRIORITY_REG_OFFSET), priority);
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_BUS_QOS_BUDGET_REG_OFFSET), budget);
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_BUS_QOS_CTRL_REG_OFFSET),
+                      ((uint32_t)window << SOC_CTRL_BUS_QOS_CTRL_WINDOW_OFFSET) |
+                          (1 << SOC_CTRL_BUS_QOS_CTRL_OVERRIDE_BIT));
+}
+
+void soc_ctrl_clear_bus_qos(const soc_ctrl_t *soc_ctrl) {
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_BUS_QOS_CTRL_REG_OFFSET), 0);
+}
+
+void soc_ctrl_perf_freeze(const soc_ctrl_t *soc_ctrl, bool freeze) {
+  uint32_t ctrl = mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_CTRL_REG_OFFSET));
+  ctrl = bitfield_bit32_write(ctrl, SOC_CTRL_PERF_CTRL_FREEZE_BIT, freeze);
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_CTRL_REG_OFFSET), ctrl);
+}
+
+void soc_ctrl_perf_clear(const soc_ctrl_t *soc_ctrl) {
+  // The counters are held at 0 while CLEAR is set
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_CTRL_REG_OFFSET),
+                      1 << SOC_CTRL_PERF_CTRL_CLEAR_BIT);
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_CTRL_REG_OFFSET), 0);
+}
+
+uint32_t soc_ctrl_perf_read(const soc_ctrl_t *soc_ctrl,
+                            soc_ctrl_perf_group_t group, uint32_t index) {
+  uint32_t ctrl = mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_CTRL_REG_OFFSET));
+  ctrl = bitfield_field32_write(ctrl, SOC_CTRL_PERF_CTRL_SEL_FIELD, ((uint32_t)group << 5) | (index & 0x1F));
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_CTRL_REG_OFFSET), ctrl);
+  // The selected counter is registered a cycle after the write, before the read
+  return mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_PERF_VALUE_REG_OFFSET));
+}
+
+void soc_ctrl_set_scratch(const soc_ctrl_t *soc_ctrl, uint32_t value) {
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_SCRATCH_REG_OFFSET), value);
+}
+
+void soc_ctrl_instr_buffer_enable(const soc_ctrl_t *soc_ctrl, bool enable,
+                                  bool prefetch) {
+  uint32_t ctrl = 0;
+  ctrl = bitfield_bit32_write(ctrl, SOC_CTRL_INSTR_BUF_CTRL_ENABLE_BIT, enable);
+  ctrl = bitfield_bit32_write(ctrl, SOC_CTRL_INSTR_BUF_CTRL_PREFETCH_BIT, prefetch);
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_INSTR_BUF_CTRL_REG_OFFSET), ctrl);
+}
+
+void soc_ctrl_instr_buffer_clear(const soc_ctrl_t *soc_ctrl) {
+  // The lines are dropped when CLEAR is set, the counters are held at 0 while it is
+  uint32_t ctrl = mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_INSTR_BUF_CTRL_REG_OFFSET));
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_INSTR_BUF_CTRL_REG_OFFSET),
+                      bitfield_bit32_write(ctrl, SOC_CTRL_INSTR_BUF_CTRL_CLEAR_BIT, true));
+  mmio_region_write32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_INSTR_BUF_CTRL_REG_OFFSET),
+                      bitfield_bit32_write(ctrl, SOC_CTRL_INSTR_BUF_CTRL_CLEAR_BIT, false));
+}
+
+uint32_t soc_ctrl_get_instr_buffer_hits(const soc_ctrl_t *soc_ctrl) {
+  return mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_INSTR_BUF_HITS_REG_OFFSET));
+}
+
+uint32_t soc_ctrl_get_instr_buffer_misses(const soc_ctrl_t *soc_ctrl) {
+  return mmio_region_read32(soc_ctrl->base_addr, (ptrdiff_t)(SOC_CTRL_INSTR_BUF_MISSES_REG_OFFSET));
+}
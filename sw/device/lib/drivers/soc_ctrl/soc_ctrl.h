@@ -5,6 +5,7 @@
 #ifndef _DRIVERS_SOC_CTRL_H_
 #define _DRIVERS_SOC_CTRL_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -17,6 +18,65 @@ extern "C" {
 #define SOC_CTRL_SPI_FLASH_MODE_SPIMEMIO 1
 #define SOC_CTRL_SPI_FLASH_MODE_SPIHOST 0
 
+/**
+ * Masters of the system crossbar, in the order of the QoS registers.
+ */
+typedef enum soc_ctrl_bus_master {
+  SOC_CTRL_BUS_MASTER_CORE_INSTR = 0,
+  SOC_CTRL_BUS_MASTER_CORE_DATA = 1,
+  SOC_CTRL_BUS_MASTER_DEBUG = 2,
+  SOC_CTRL_BUS_MASTER_DMA_READ = 3,
+  SOC_CTRL_BUS_MASTER_DMA_WRITE = 4,
+  SOC_CTRL_BUS_MASTER_DMA_ADDR = 5,
+} soc_ctrl_bus_master_t;
+
+/**
+ * Priority of a master for soc_ctrl_set_bus_qos(), from 0 to 3. The values of
+ * the masters are ORed together.
+ */
+#define SOC_CTRL_BUS_QOS_PRIORITY(master, priority) \
+  (((uint32_t)(priority) & 0x3) << (2 * (master)))
+
+/**
+ * Budget of a master for soc_ctrl_set_bus_qos(), in sixteenths of the window,
+ * 0 is unlimited. Only the first 8 masters have a budget.
+ */
+#define SOC_CTRL_BUS_QOS_BUDGET(master, sixteenths) \
+  (((uint32_t)(sixteenths) & 0xF) << (4 * (master)))
+
+/**
+ * Groups of the performance counters of the system crossbar, read with
+ * soc_ctrl_perf_read(). The counters of the first three groups are indexed by
+ * master, as in soc_ctrl_bus_master_t, the ones of the bank groups by RAM
+ * bank. Only the first 32 masters and banks can be read.
+ */
+typedef enum soc_ctrl_perf_group {
+  SOC_CTRL_PERF_REQ_CYCLES = 0,     /*!< Cycles with a request. */
+  SOC_CTRL_PERF_GNT = 1,            /*!< Requests granted. */
+  SOC_CTRL_PERF_RVALID = 2,         /*!< Read responses. */
+  SOC_CTRL_PERF_BANK_ACCESSES = 3,  /*!< Accesses of the bank. */
+  SOC_CTRL_PERF_BANK_CONFLICTS = 4, /*!< Cycles with a request to the bank
+                                         waiting for its grant (NtoM bus). */
+  SOC_CTRL_PERF_GLOBAL = 5,         /*!< SOC_CTRL_PERF_GLOBAL_* counters. */
+  SOC_CTRL_PERF_INFO = 7,           /*!< SOC_CTRL_PERF_INFO_* constants. */
+} soc_ctrl_perf_group_t;
+
+/**
+ * Indices of the SOC_CTRL_PERF_GLOBAL group: the cycles, the cycles with a
+ * DMA channel busy and the cycles with a request of the core waiting for its
+ * grant.
+ */
+#define SOC_CTRL_PERF_GLOBAL_CYCLES 0
+#define SOC_CTRL_PERF_GLOBAL_DMA_BUSY 1
+#define SOC_CTRL_PERF_GLOBAL_CORE_STALL 2
+
+/**
+ * Indices of the SOC_CTRL_PERF_INFO group: the number of masters and of RAM
+ * banks that have counters.
+ */
+#define SOC_CTRL_PERF_INFO_MASTERS 0
+#define SOC_CTRL_PERF_INFO_BANKS 1
+
 /**
  * Initialization parameters for SOC CTRL.
  *
@@ -66,6 +126,105 @@ void soc_ctrl_select_spi_host(const soc_ctrl_t *soc_ctrl);
 
 uint32_t get_spi_flash_mode(const soc_ctrl_t *soc_ctrl);
 
+/**
+ * Get the number of reads of the memory-mapped flash served by its read cache
+ * since the last invalidation
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+uint32_t soc_ctrl_get_flash_cache_hits(const soc_ctrl_t *soc_ctrl);
+
+/**
+ * Get the number of line fills of the read cache of the memory-mapped flash
+ * since the last invalidation
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+uint32_t soc_ctrl_get_flash_cache_misses(const soc_ctrl_t *soc_ctrl);
+
+/**
+ * Override the arbitration settings of the system crossbar set by bus_qos in
+ * mcu_cfg.hjson. A master requesting a slave is served before the masters of
+ * lower priority requesting it, unless it used up its budget of grants for
+ * the current window.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ * @param priority Priorities built with SOC_CTRL_BUS_QOS_PRIORITY().
+ * @param budget Budgets built with SOC_CTRL_BUS_QOS_BUDGET().
+ * @param window Length of the budget window in cycles, 0 disables the budgets.
+ */
+void soc_ctrl_set_bus_qos(const soc_ctrl_t *soc_ctrl, uint32_t priority,
+                          uint32_t budget, uint16_t window);
+
+/**
+ * Go back to the arbitration settings of mcu_cfg.hjson.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+void soc_ctrl_clear_bus_qos(const soc_ctrl_t *soc_ctrl);
+
+/**
+ * Stop or restart the performance counters of the system crossbar. They count
+ * from the reset, and wrap at 2^32.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ * @param freeze The counters keep their values while true.
+ */
+void soc_ctrl_perf_freeze(const soc_ctrl_t *soc_ctrl, bool freeze);
+
+/**
+ * Set the performance counters of the system crossbar to 0, and restart them.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+void soc_ctrl_perf_clear(const soc_ctrl_t *soc_ctrl);
+
+/**
+ * Read a performance counter of the system crossbar.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ * @param group Group of the counter.
+ * @param index Master, bank or SOC_CTRL_PERF_GLOBAL_* index in the group.
+ * @return The counter, 0 for a master or a bank without counters.
+ */
+uint32_t soc_ctrl_perf_read(const soc_ctrl_t *soc_ctrl,
+                            soc_ctrl_perf_group_t group, uint32_t index);
+
+/**
+ * Write the scratch register. On the virtual platform run with +vp_switch,
+ * the write is the marker where the simulation switches to the RTL, see
+ * docs/source/How_to/SystemC.md. Elsewhere it has no effect.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ * @param value Value of the register.
+ */
+void soc_ctrl_set_scratch(const soc_ctrl_t *soc_ctrl, uint32_t value);
+
+/**
+ * Enable or disable the instruction buffer of the main core (INSTR_BUFFER_LINES
+ * lines of INSTR_BUFFER_LINE_SIZE bytes, see mcu_cfg.hjson). Enabling it drops
+ * its lines. It is disabled at reset.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ * @param enable The fetches go through the buffer while true.
+ * @param prefetch The buffer fills the line after the last one fetched.
+ */
+void soc_ctrl_instr_buffer_enable(const soc_ctrl_t *soc_ctrl, bool enable,
+                                  bool prefetch);
+
+/**
+ * Drop the lines of the instruction buffer and clear its counters. The buffer
+ * does not see the writes to the code: call it after loading or modifying code
+ * in the memory, after the fence.i.
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+void soc_ctrl_instr_buffer_clear(const soc_ctrl_t *soc_ctrl);
+
+/**
+ * Get the number of fetches of the main core served by the instruction buffer
+ * since the last clear
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+uint32_t soc_ctrl_get_instr_buffer_hits(const soc_ctrl_t *soc_ctrl);
+
+/**
+ * Get the number of line fills of the instruction buffer for a fetch of the
+ * main core since the last clear
+ * @param soc_ctrl Pointer to soc_ctrl_t represting the target SOC CTRL.
+ */
+uint32_t soc_ctrl_get_instr_buffer_misses(const soc_ctrl_t *soc_ctrl);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,62 @@ extern "C" {
 // system is running (in Hz)
 #define SOC_CTRL_SYSTEM_FREQUENCY_HZ_REG_OFFSET 0x1c
 
+// Flash Cache Hits - Number of reads of the memory-mapped flash served by the
+// read cache
+#define SOC_CTRL_FLASH_CACHE_HITS_REG_OFFSET 0x20
+
+// Flash Cache Misses - Number of line fills of the read cache of the
+// memory-mapped flash
+#define SOC_CTRL_FLASH_CACHE_MISSES_REG_OFFSET 0x24
+
+// Bus QoS Control - Selects the arbitration settings of the system crossbar
+#define SOC_CTRL_BUS_QOS_CTRL_REG_OFFSET 0x28
+#define SOC_CTRL_BUS_QOS_CTRL_OVERRIDE_BIT 0
+#define SOC_CTRL_BUS_QOS_CTRL_WINDOW_MASK 0xffff
+#define SOC_CTRL_BUS_QOS_CTRL_WINDOW_OFFSET 16
+#define SOC_CTRL_BUS_QOS_CTRL_WINDOW_FIELD \
+  ((bitfield_field32_t) { .mask = SOC_CTRL_BUS_QOS_CTRL_WINDOW_MASK, .index = SOC_CTRL_BUS_QOS_CTRL_WINDOW_OFFSET })
+
+// Bus QoS Priority - Arbitration priority of the crossbar masters, when
+// BUS_QOS_CTRL.OVERRIDE is set
+#define SOC_CTRL_BUS_QOS_PRIORITY_REG_OFFSET 0x2c
+
+// Bus QoS Budget - Bandwidth budget of the crossbar masters, when
+// BUS_QOS_CTRL.OVERRIDE is set
+#define SOC_CTRL_BUS_QOS_BUDGET_REG_OFFSET 0x30
+
+// Scratch - Free register of the software, a write marks the switch of the
+// simulation from the virtual platform to the RTL (+vp_switch)
+#define SOC_CTRL_SCRATCH_REG_OFFSET 0x34
+
+// Performance Counters Control - Controls the hardware counters of the
+// system crossbar and selects the one read by PERF_VALUE
+#define SOC_CTRL_PERF_CTRL_REG_OFFSET 0x38
+#define SOC_CTRL_PERF_CTRL_FREEZE_BIT 0
+#define SOC_CTRL_PERF_CTRL_CLEAR_BIT 1
+#define SOC_CTRL_PERF_CTRL_SEL_MASK 0xff
+#define SOC_CTRL_PERF_CTRL_SEL_OFFSET 8
+#define SOC_CTRL_PERF_CTRL_SEL_FIELD \
+  ((bitfield_field32_t) { .mask = SOC_CTRL_PERF_CTRL_SEL_MASK, .index = SOC_CTRL_PERF_CTRL_SEL_OFFSET })
+
+// Performance Counter Value - Value of the counter selected by PERF_CTRL.SEL
+#define SOC_CTRL_PERF_VALUE_REG_OFFSET 0x3c
+
+// Instruction Buffer Control - Controls the instruction buffer between the
+// main core and the system bus
+#define SOC_CTRL_INSTR_BUF_CTRL_REG_OFFSET 0x40
+#define SOC_CTRL_INSTR_BUF_CTRL_ENABLE_BIT 0
+#define SOC_CTRL_INSTR_BUF_CTRL_PREFETCH_BIT 1
+#define SOC_CTRL_INSTR_BUF_CTRL_CLEAR_BIT 2
+
+// Instruction Buffer Hits - Number of fetches of the main core served by the
+// instruction buffer
+#define SOC_CTRL_INSTR_BUF_HITS_REG_OFFSET 0x44
+
+// Instruction Buffer Misses - Number of line fills of the instruction buffer
+// for a fetch of the main core
+#define SOC_CTRL_INSTR_BUF_MISSES_REG_OFFSET 0x48
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -35,6 +35,9 @@
 #include "spi_host.h"
 
 #include "bitfield.h"
+#include "csr.h"
+#include "sync.h"
+#include "fast_intr_ctrl_structs.h"  // Generated
 
 
 /****************************************************************************/
@@ -54,6 +57,13 @@
 /**                                                                        **/
 /****************************************************************************/
 
+// Events of spi_sleep_for_events
+typedef struct
+{
+    spi_host_t* spi;
+    spi_event_e events;
+} spi_wait_t;
+
 /****************************************************************************/
 /**                                                                        **/
 /*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
@@ -337,6 +347,59 @@ spi_return_flags_e spi_enable_evt_intr(spi_host_t* spi, bool enable)
     return SPI_FLAG_OK;
 }
 
+// Whether the status of a SPI shows one of the events
+static bool spi_events_reached(void* arg)
+{
+    const spi_wait_t* wait = (const spi_wait_t*) arg;
+    const spi_event_e events = wait->events;
+    const volatile spi_status_t* status = spi_get_status(wait->spi);
+    return ((events & SPI_EVENT_RXFULL)  && status->rxfull)
+        || ((events & SPI_EVENT_TXEMPTY) && status->txempty)
+        || ((events & SPI_EVENT_RXWM)    && status->rxwm)
+        || ((events & SPI_EVENT_TXWM)    && status->txwm)
+        || ((events & SPI_EVENT_READY)   && status->ready)
+        || ((events & SPI_EVENT_IDLE)    && !status->active);
+}
+
+spi_return_flags_e spi_sleep_for_events(spi_host_t* spi, spi_event_e events)
+{
+    SPI_NULL_CHECK(spi, SPI_FLAG_NULL_PTR)
+    if (events == SPI_EVENT_NONE || events > SPI_EVENT_ALL) return SPI_FLAG_EVENT_INVALID;
+
+    spi_wait_t wait = { spi, events };
+
+    fast_intr_ctrl_fast_interrupt_t fic;
+    if      (spi == spi_flash) fic = kSpiFlash_fic_e;
+    else if (spi == spi_host1) fic = kSpi_fic_e;
+    else
+    {
+        while (!spi_events_reached(&wait));
+        return SPI_FLAG_OK;
+    }
+
+    // Fast interrupts are the lines 16 and up of MIE
+    const uint32_t mie_bit = 1u << (16 + fic);
+    uint32_t mie, fic_enable;
+    CSR_READ(CSR_REG_MIE, &mie);
+    fic_enable = fast_intr_ctrl_peri->FAST_INTR_ENABLE;
+    const uint32_t evt_enable  = SPI_HW(spi)->EVENT_ENABLE;
+    const uint32_t intr_enable = SPI_HW(spi)->INTR_ENABLE;
+
+    // Any condition already true raises no event, it is seen by the check
+    SPI_HW(spi)->EVENT_ENABLE = evt_enable | events;
+    spi_enable_evt_intr(spi, true);
+    enable_fast_interrupt(fic, true);
+    CSR_SET_BITS(CSR_REG_MIE, mie_bit);
+
+    sync_wait(spi_events_reached, &wait);
+
+    if (!(mie & mie_bit)) CSR_CLEAR_BITS(CSR_REG_MIE, mie_bit);
+    if (!(fic_enable & (1u << fic))) enable_fast_interrupt(fic, false);
+    SPI_HW(spi)->INTR_ENABLE  = intr_enable;
+    SPI_HW(spi)->EVENT_ENABLE = evt_enable;
+    return SPI_FLAG_OK;
+}
+
 spi_return_flags_e spi_enable_error_intr(spi_host_t* spi, bool enable)
 {
     SPI_NULL_CHECK(spi, SPI_FLAG_NULL_PTR)
@@ -867,6 +867,25 @@ spi_return_flags_e spi_wait_for_rx_watermark(spi_host_t* spi)
     return SPI_FLAG_OK;
 }
 
+/**
+ * @brief Sleep until one of the conditions of events holds (e.g. SPI_EVENT_IDLE
+ * for the end of the commands, SPI_EVENT_RXWM for the RX watermark), rather
+ * than polling the status register as the spi_wait_for_* functions do.
+ *
+ * The events are enabled for the time of the wait, with the event interrupt
+ * and its fast interrupt, and their previous configuration is restored. The
+ * event handler of the SPI SDK ignores the events outside of its
+ * transactions. The status is polled with the interrupts disabled, and for
+ * SPI Host 2, whose interrupt goes through the PLIC.
+ *
+ * @param spi Pointer to spi_host_t representing the target SPI.
+ * @param events Events to wait for, one of them is enough.
+ * @return SPI_FLAG_NULL_PTR      if spi NULL pointer.
+ * @return SPI_FLAG_EVENT_INVALID if events not valid.
+ * @return SPI_FLAG_OK            if success.
+ */
+spi_return_flags_e spi_sleep_for_events(spi_host_t* spi, spi_event_e events);
+
 /**
  * @brief Create SPI target device configuration word.
  *
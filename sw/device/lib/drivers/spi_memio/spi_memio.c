@@ -0,0 +1,27 @@
+// Copyright EPFL contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "spi_memio.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mmio.h"
+
+#include "spi_memio_regs.h"  // Generated.
+
+void spi_memio_invalidate_cache(const spi_memio_t *spi_memio) {
+  mmio_region_write32(spi_memio->base_addr, (ptrdiff_t)(OBI_SPIMEMIO_CACHE_INVALIDATE_REG_OFFSET),
+                      1 << OBI_SPIMEMIO_CACHE_INVALIDATE_CACHE_INVALIDATE_BIT);
+}
+
+void spi_memio_set_config(const spi_memio_t *spi_memio, spi_memio_config_t config) {
+  // Keep spimemio in control of the flash pins (memory-mapped mode)
+  uint32_t reg = 1 << SPI_MEMIO_CFG_EN_BIT;
+  reg |= (uint32_t)config.ddr << SPI_MEMIO_CFG_DDR_BIT;
+  reg |= (uint32_t)config.qspi << SPI_MEMIO_CFG_QSPI_BIT;
+  reg |= (uint32_t)config.cont << SPI_MEMIO_CFG_CONT_BIT;
+  reg |= (uint32_t)(config.dummy & SPI_MEMIO_CFG_DUMMY_MASK) << SPI_MEMIO_CFG_DUMMY_OFFSET;
+  mmio_region_write32(spi_memio->base_addr, (ptrdiff_t)(OBI_SPIMEMIO_CFG_SPIMEM_REG_OFFSET), reg);
+}
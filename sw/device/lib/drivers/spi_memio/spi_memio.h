@@ -7,10 +7,11 @@
 #ifndef _DRIVERS_SPI_MEMIO_H_
 #define _DRIVERS_SPI_MEMIO_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "mmio.h"
-#include "spimem_regs.h"
+#include "spi_memio_regs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +28,58 @@ typedef struct spi_memio {
     mmio_region_t base_addr;
 } spi_memio_t;
 
+/**
+ * Fields of the CFG_SPIMEM register of spimemio.
+ */
+#define SPI_MEMIO_CFG_EN_BIT 31
+#define SPI_MEMIO_CFG_DDR_BIT 22
+#define SPI_MEMIO_CFG_QSPI_BIT 21
+#define SPI_MEMIO_CFG_CONT_BIT 20
+#define SPI_MEMIO_CFG_DUMMY_OFFSET 16
+#define SPI_MEMIO_CFG_DUMMY_MASK 0xf
+
+/**
+ * Read command used by spimemio for the memory-mapped flash.
+ */
+typedef struct spi_memio_config {
+    /**
+    * Quad I/O read (EBh) instead of the standard read (03h).
+    */
+    bool qspi;
+    /**
+    * DTR read (EDh with qspi, BBh without).
+    */
+    bool ddr;
+    /**
+    * Continuous read mode: with qspi or ddr, the mode bits are A5h instead of
+    * FFh and a jump to a non-consecutive address only sends the new address,
+    * without the command byte.
+    */
+    bool cont;
+    /**
+    * Dummy clocks after the mode bits (4 for the W25Q128JW Quad I/O read).
+    */
+    uint8_t dummy;
+} spi_memio_config_t;
+
+/**
+ * Drop all the lines of the read cache of the memory-mapped flash and clear
+ * its hit and miss counters. Must be called after the flash content has been
+ * changed through the SPI host (e.g. w25q128jw_write), otherwise code and data
+ * read through spimemio may be stale.
+ * @param spi_memio Pointer to spi_memio_t represting the target SPI MEMIO.
+ */
+void spi_memio_invalidate_cache(const spi_memio_t *spi_memio);
+
+/**
+ * Set the read command of the memory-mapped flash. The flash must accept it,
+ * e.g. the QE bit must be set for the quad reads. spimemio is restarted and
+ * wakes up the flash again before the next access.
+ * @param spi_memio Pointer to spi_memio_t represting the target SPI MEMIO.
+ * @param config Read command.
+ */
+void spi_memio_set_config(const spi_memio_t *spi_memio, spi_memio_config_t config);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,11 @@ extern "C" {
 // Cfg SPIMEM
 #define OBI_SPIMEMIO_CFG_SPIMEM_REG_OFFSET 0x4
 
+// Cache Invalidate - Writing 1 drops all the lines of the read cache and
+// clears its counters
+#define OBI_SPIMEMIO_CACHE_INVALIDATE_REG_OFFSET 0x8
+#define OBI_SPIMEMIO_CACHE_INVALIDATE_CACHE_INVALIDATE_BIT 0
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -26,7 +26,7 @@
 */
 
 #ifndef _${peripheral_name_upper}_STRUCTS_H
-#define ${peripheral_name_upper}_STRUCTS
+#define _${peripheral_name_upper}_STRUCTS_H
 
 /****************************************************************************/
 /**                                                                        **/
@@ -80,6 +80,14 @@ ${structures_definitions}
 /**                                                                        **/
 /****************************************************************************/
 
+/*
+ * Accessors of the registers: <name>_<reg>_read/write/update() and, for each
+ * field, <name>_<reg>_<field>_get/set() and <NAME>_<REG>_<FIELD>(v) to build
+ * the value of a whole register. With a constant pointer, e.g. the _peri
+ * define above, each access is a single load or store.
+ */
+
+${inline_functions}
 
 
 #endif /* _${peripheral_name_upper}_STRUCTS_H */
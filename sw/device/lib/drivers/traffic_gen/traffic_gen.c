@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+#include "traffic_gen.h"
+
+static inline volatile uint32_t *traffic_gen_reg(uint32_t id, uint32_t offset)
+{
+    return (volatile uint32_t *)(TRAFFIC_GEN_START_ADDRESS(id) + offset);
+}
+
+void traffic_gen_config(uint32_t id, const traffic_gen_cfg_t *cfg)
+{
+    *traffic_gen_reg(id, TRAFFIC_GEN_ADDR_REG_OFFSET) = cfg->addr;
+    *traffic_gen_reg(id, TRAFFIC_GEN_MASK_REG_OFFSET) = cfg->words - 1;
+    *traffic_gen_reg(id, TRAFFIC_GEN_COUNT_REG_OFFSET) = cfg->count;
+    *traffic_gen_reg(id, TRAFFIC_GEN_PERIOD_REG_OFFSET) = cfg->period;
+    *traffic_gen_reg(id, TRAFFIC_GEN_HIST_SHIFT_REG_OFFSET) = cfg->hist_shift;
+}
+
+bool traffic_gen_busy(uint32_t id)
+{
+    return *traffic_gen_reg(id, TRAFFIC_GEN_CTRL_REG_OFFSET) & 0x1;
+}
+
+void traffic_gen_wait(uint32_t id)
+{
+    while (traffic_gen_busy(id))
+        ;
+}
+
+void traffic_gen_read_stats(uint32_t id, traffic_gen_stats_t *stats)
+{
+    stats->done = *traffic_gen_reg(id, TRAFFIC_GEN_DONE_REG_OFFSET);
+    stats->cycles = *traffic_gen_reg(id, TRAFFIC_GEN_CYCLES_REG_OFFSET);
+    stats->lat_sum = *traffic_gen_reg(id, TRAFFIC_GEN_LAT_SUM_REG_OFFSET);
+    stats->lat_max = *traffic_gen_reg(id, TRAFFIC_GEN_LAT_MAX_REG_OFFSET);
+    stats->hist_shift = *traffic_gen_reg(id, TRAFFIC_GEN_HIST_SHIFT_REG_OFFSET);
+    for (uint32_t i = 0; i < TRAFFIC_GEN_NUM_BINS; i++)
+    {
+        stats->hist[i] = *traffic_gen_reg(id, TRAFFIC_GEN_HIST_REG_OFFSET + 4 * i);
+    }
+}
+
+uint32_t traffic_gen_bandwidth(const traffic_gen_stats_t *stats)
+{
+    return stats->cycles ? (uint32_t)((uint64_t)stats->done * 100 / stats->cycles) : 0;
+}
+
+uint32_t traffic_gen_percentile(const traffic_gen_stats_t *stats, uint32_t percent)
+{
+    uint64_t target = (uint64_t)stats->done * percent;
+    uint64_t seen = 0;
+
+    for (uint32_t i = 0; i < TRAFFIC_GEN_NUM_BINS - 1; i++)
+    {
+        seen += stats->hist[i];
+        if (seen * 100 >= target)
+        {
+            uint32_t high = ((i + 1) << stats->hist_shift) - 1;
+            return high < stats->lat_max ? high : stats->lat_max;
+        }
+    }
+    return stats->lat_max;
+}
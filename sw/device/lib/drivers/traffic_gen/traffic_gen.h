@@ -0,0 +1,129 @@
+/*
+ * Copyright 2024 EPFL
+ * Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+ * SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+
+/**
+ * @file   traffic_gen.h
+ * @brief  Driver of the bus traffic generators of the testharness
+ *
+ * Each generator is an external master of the system crossbar which issues
+ * reads or writes of words at a programmed rate, at most 4 on the bus at once,
+ * and measures their latency from the cycle each one is due, so that a
+ * saturated bus shows as latency. Running them with the core and the DMA
+ * gives the bandwidth left to each master and the saturation point of the
+ * bus. The generators only exist in the testharness (external peripheral
+ * example), they must not be used on FPGA or silicon.
+ */
+
+#ifndef _TRAFFIC_GEN_H_
+#define _TRAFFIC_GEN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core_v_mini_mcu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Generators of the testharness, external masters 4 and 5
+#define TRAFFIC_GEN_NUM 2
+#define TRAFFIC_GEN_START_ADDRESS(id) (EXT_PERIPHERAL_START_ADDRESS + 0x06000 + 0x1000 * (id))
+
+// Bit 0 start, bit 1 writes, bit 2 random addresses; reads bit 0 busy
+#define TRAFFIC_GEN_CTRL_REG_OFFSET 0x00
+#define TRAFFIC_GEN_ADDR_REG_OFFSET 0x04
+#define TRAFFIC_GEN_MASK_REG_OFFSET 0x08
+#define TRAFFIC_GEN_COUNT_REG_OFFSET 0x0C
+#define TRAFFIC_GEN_PERIOD_REG_OFFSET 0x10
+#define TRAFFIC_GEN_HIST_SHIFT_REG_OFFSET 0x14
+#define TRAFFIC_GEN_DONE_REG_OFFSET 0x18
+#define TRAFFIC_GEN_CYCLES_REG_OFFSET 0x1C
+#define TRAFFIC_GEN_LAT_SUM_REG_OFFSET 0x20
+#define TRAFFIC_GEN_LAT_MAX_REG_OFFSET 0x24
+#define TRAFFIC_GEN_HIST_REG_OFFSET 0x40
+
+#define TRAFFIC_GEN_CTRL_START (1 << 0)
+#define TRAFFIC_GEN_CTRL_WRITE (1 << 1)
+#define TRAFFIC_GEN_CTRL_RANDOM (1 << 2)
+
+// Bins of the latency histogram, the last one counts the higher latencies
+#define TRAFFIC_GEN_NUM_BINS 16
+
+/**
+ * Traffic of a run.
+ */
+typedef struct traffic_gen_cfg {
+    uint32_t addr;       // First word, word aligned
+    uint32_t words;      // Words of the window the addresses wrap in, a power of 2
+    uint32_t count;      // Transactions
+    uint32_t period;     // Cycles between two due transactions, 1 for back to back
+    bool write;          // Writes of the address instead of reads
+    bool random;         // Pseudo-random addresses in the window instead of sequential
+    uint8_t hist_shift;  // A latency L is counted in the bin L >> hist_shift
+} traffic_gen_cfg_t;
+
+/**
+ * Results of a run.
+ */
+typedef struct traffic_gen_stats {
+    uint32_t done;      // Completed transactions
+    uint32_t cycles;    // Cycles from the start to the last response
+    uint32_t lat_sum;   // Sum of the latencies
+    uint32_t lat_max;   // Highest latency
+    uint8_t hist_shift;
+    uint32_t hist[TRAFFIC_GEN_NUM_BINS];
+} traffic_gen_stats_t;
+
+/**
+ * Configures a generator, which must not be busy.
+ * @param id generator, below TRAFFIC_GEN_NUM.
+ */
+void traffic_gen_config(uint32_t id, const traffic_gen_cfg_t *cfg);
+
+/**
+ * Starts a run of a configured generator, clearing its statistics. Inlined,
+ * so that several generators start a few cycles apart.
+ */
+static inline void traffic_gen_start(uint32_t id, const traffic_gen_cfg_t *cfg)
+{
+    *(volatile uint32_t *)(TRAFFIC_GEN_START_ADDRESS(id) + TRAFFIC_GEN_CTRL_REG_OFFSET) =
+        TRAFFIC_GEN_CTRL_START | (cfg->write ? TRAFFIC_GEN_CTRL_WRITE : 0) |
+        (cfg->random ? TRAFFIC_GEN_CTRL_RANDOM : 0);
+}
+
+/**
+ * @return true while the run of a generator is not over.
+ */
+bool traffic_gen_busy(uint32_t id);
+
+/**
+ * Polls a generator until the end of its run.
+ */
+void traffic_gen_wait(uint32_t id);
+
+/**
+ * Reads the results of the last run of a generator.
+ */
+void traffic_gen_read_stats(uint32_t id, traffic_gen_stats_t *stats);
+
+/**
+ * @return Words per 100 cycles achieved by a run.
+ */
+uint32_t traffic_gen_bandwidth(const traffic_gen_stats_t *stats);
+
+/**
+ * @return A bound of a percentile of the latency: the highest latency of the
+ * first bin reaching the percentile, the highest latency of all for the last
+ * bin.
+ * @param percent from 1 to 100.
+ */
+uint32_t traffic_gen_percentile(const traffic_gen_stats_t *stats, uint32_t percent);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // _TRAFFIC_GEN_H_
@@ -13,21 +13,48 @@
 #include "bitfield.h"
 #include "mmio.h"
 #include "error.h"
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "rv_plic.h"
+#include "sync.h"
 
 #include "uart_regs.h"  // Generated.
+#include "uart_structs.h"  // Generated.
 
 #define NCO_WIDTH 16
 _Static_assert((1UL << NCO_WIDTH) - 1 == UART_CTRL_NCO_MASK,
                "Bad value for NCO_WIDTH");
 
+/**
+ * TX ring buffer of the buffered mode, see uart_tx_buffered_enable().
+ *
+ * Only uart_write() moves `head` and only the drain moves `tail`. The drain
+ * runs in the TX watermark interrupt, or with the interrupts disabled.
+ */
+static struct {
+  uart_t uart;
+  uint8_t *buffer;
+  size_t mask;
+  volatile size_t head;
+  volatile size_t tail;
+  bool enabled;
+} uart_tx_ring;
+
+static bool uart_tx_is_buffered(const uart_t *uart);
+
+/**
+ * The registers of a UART, for the accessors of uart_structs.h.
+ */
+static inline volatile uart *uart_get_regs(const uart_t *u) {
+  return (volatile uart *)u->base_addr.base;
+}
+
 static void uart_reset(const uart_t *uart) {
   mmio_region_write32(uart->base_addr, UART_CTRL_REG_OFFSET, 0u);
 
   // Write to the relevant bits clears the FIFOs.
-  uint32_t reg = 0;
-  reg = bitfield_bit32_write(reg, UART_FIFO_CTRL_RXRST_BIT, true);
-  reg = bitfield_bit32_write(reg, UART_FIFO_CTRL_TXRST_BIT, true);
-  mmio_region_write32(uart->base_addr, UART_FIFO_CTRL_REG_OFFSET, reg);
+  uart_fifo_ctrl_write(uart_get_regs(uart), UART_FIFO_CTRL_RXRST(1) |
+                                                UART_FIFO_CTRL_TXRST(1));
 
   mmio_region_write32(uart->base_addr, UART_OVRD_REG_OFFSET, 0u);
   mmio_region_write32(uart->base_addr, UART_TIMEOUT_CTRL_REG_OFFSET, 0u);
@@ -35,74 +62,301 @@ static void uart_reset(const uart_t *uart) {
   mmio_region_write32(uart->base_addr, UART_INTR_STATE_REG_OFFSET, UINT32_MAX);
 }
 
-system_error_t uart_init(const uart_t *uart) {
-  if (uart == NULL) {
-    return kErrorUartInvalidArgument;
-  }
-
-  if (uart->baudrate == 0 || uart->clk_freq_hz == 0) {
+static system_error_t uart_nco(uint32_t baudrate, uint32_t clk_freq_hz,
+                               uint32_t *nco_masked) {
+  if (baudrate == 0 || clk_freq_hz == 0) {
     return kErrorUartInvalidArgument;
   }
 
   // Calculation formula: NCO = 16 * 2^nco_width * baud / fclk.
   // NCO creates 16x of baudrate. So, in addition to the nco_width,
   // 2^4 should be multiplied.
-  uint64_t nco =
-      ((uint64_t)uart->baudrate << (NCO_WIDTH + 4)) / uart->clk_freq_hz;
-  uint32_t nco_masked = nco & UART_CTRL_NCO_MASK;
+  uint64_t nco = ((uint64_t)baudrate << (NCO_WIDTH + 4)) / clk_freq_hz;
+  *nco_masked = nco & UART_CTRL_NCO_MASK;
 
   // Requested baudrate is too high for the given clock frequency.
-  if (nco != nco_masked) {
+  if (nco != *nco_masked) {
     return kErrorUartBadBaudRate;
   }
+  return kErrorOk;
+}
+
+system_error_t uart_init(const uart_t *uart) {
+  if (uart == NULL) {
+    return kErrorUartInvalidArgument;
+  }
+
+  uint32_t nco_masked;
+  system_error_t error = uart_nco(uart->baudrate, uart->clk_freq_hz, &nco_masked);
+  if (error != kErrorOk) {
+    return error;
+  }
+
+  // The reset clears the TX FIFO, send what is buffered first.
+  if (uart_tx_is_buffered(uart)) {
+    uart_tx_flush(uart);
+    uart_tx_ring.enabled = false;
+  }
 
   // Must be called before the first write to any of the UART registers.
   uart_reset(uart);
 
   // Set baudrate, TX, no parity bits.
-  uint32_t reg = 0;
-  reg = bitfield_field32_write(reg, UART_CTRL_NCO_FIELD, nco_masked);
-  reg = bitfield_bit32_write(reg, UART_CTRL_TX_BIT, true);
-  reg = bitfield_bit32_write(reg, UART_CTRL_PARITY_EN_BIT, false);
-  reg = bitfield_bit32_write(reg, UART_CTRL_RX_BIT, true);
-  mmio_region_write32(uart->base_addr, UART_CTRL_REG_OFFSET, reg);
+  uart_ctrl_write(uart_get_regs(uart), UART_CTRL_NCO(nco_masked) |
+                                           UART_CTRL_TX(1) |
+                                           UART_CTRL_PARITY_EN(0) |
+                                           UART_CTRL_RX(1));
 
   // Disable interrupts.
   mmio_region_write32(uart->base_addr, UART_INTR_ENABLE_REG_OFFSET, 0u);
   return kErrorOk;
 }
 
+system_error_t uart_check_clk_freq(const uart_t *uart, uint32_t clk_freq_hz) {
+  if (uart == NULL) {
+    return kErrorUartInvalidArgument;
+  }
+  uint32_t nco_masked;
+  return uart_nco(uart->baudrate, clk_freq_hz, &nco_masked);
+}
+
+system_error_t uart_set_clk_freq(uart_t *uart, uint32_t clk_freq_hz) {
+  if (uart == NULL) {
+    return kErrorUartInvalidArgument;
+  }
+
+  uint32_t nco_masked;
+  system_error_t error = uart_nco(uart->baudrate, clk_freq_hz, &nco_masked);
+  if (error != kErrorOk) {
+    return error;
+  }
+
+  // Only the divider changes, the FIFOs and the buffered mode are kept.
+  uint32_t ctrl = mmio_region_read32(uart->base_addr, UART_CTRL_REG_OFFSET);
+  ctrl = bitfield_field32_write(ctrl, UART_CTRL_NCO_FIELD, nco_masked);
+  mmio_region_write32(uart->base_addr, UART_CTRL_REG_OFFSET, ctrl);
+
+  uart->clk_freq_hz = clk_freq_hz;
+  if (uart_tx_is_buffered(uart)) {
+    uart_tx_ring.uart.clk_freq_hz = clk_freq_hz;
+  }
+  return kErrorOk;
+}
+
 static bool uart_tx_full(const uart_t *uart) {
-  uint32_t reg = mmio_region_read32(uart->base_addr, UART_STATUS_REG_OFFSET);
-  return bitfield_bit32_read(reg, UART_STATUS_TXFULL_BIT);
+  return uart_status_txfull_get(uart_get_regs(uart));
 }
 
 static bool uart_tx_idle(const uart_t *uart) {
-  uint32_t reg = mmio_region_read32(uart->base_addr, UART_STATUS_REG_OFFSET);
-  return bitfield_bit32_read(reg, UART_STATUS_TXIDLE_BIT);
+  return uart_status_txidle_get(uart_get_regs(uart));
 }
 
 static bool uart_rx_empty(const uart_t *uart) {
-  uint32_t reg = mmio_region_read32(uart->base_addr, UART_STATUS_REG_OFFSET);
-  return bitfield_bit32_read(reg, UART_STATUS_RXEMPTY_BIT);
+  return uart_status_rxempty_get(uart_get_regs(uart));
+}
+
+/**
+ * UART sleeping in uart_tx_sleep_empty(), for the TX empty interrupt.
+ */
+static uart_t uart_tx_sleeper;
+static volatile bool uart_tx_sleeping = false;
+
+static bool uart_tx_empty(void *arg) {
+  return uart_status_txempty_get(uart_get_regs((const uart_t *)arg));
+}
+
+static void uart_tx_empty_irq_handler(uint32_t id) {
+  // The event only wakes the core up, uart_tx_sleep_empty() checks the FIFO
+  mmio_region_nonatomic_clear_bit32(uart_tx_sleeper.base_addr,
+                                    UART_INTR_ENABLE_REG_OFFSET,
+                                    UART_INTR_ENABLE_TX_EMPTY_BIT);
+  mmio_region_write32(uart_tx_sleeper.base_addr, UART_INTR_STATE_REG_OFFSET,
+                      1u << UART_INTR_STATE_TX_EMPTY_BIT);
+}
+
+/**
+ * Wait until the TX FIFO is empty, asleep on the TX empty interrupt when the
+ * interrupts are enabled. The UART of the PLIC line is the one of the MCU.
+ */
+static void uart_tx_sleep_empty(const uart_t *uart) {
+  uint32_t mstatus;
+  plic_irq_wake_t wake;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  if (!(mstatus & 0x8) || uart->base_addr.base != (void *)UART_START_ADDRESS ||
+      plic_irq_wake_enable(UART_INTR_TX_EMPTY, &wake) != kPlicOk) {
+    while (!uart_tx_empty((void *)uart)) {
+    }
+    return;
+  }
+
+  uart_tx_sleeper = *uart;
+  uart_tx_sleeping = true;
+
+  // An event raised before is stale, the FIFO is checked before sleeping
+  mmio_region_write32(uart->base_addr, UART_INTR_STATE_REG_OFFSET,
+                      1u << UART_INTR_STATE_TX_EMPTY_BIT);
+  mmio_region_nonatomic_set_bit32(uart->base_addr, UART_INTR_ENABLE_REG_OFFSET,
+                                  UART_INTR_ENABLE_TX_EMPTY_BIT);
+  sync_wait(uart_tx_empty, (void *)uart);
+
+  uint32_t irq = sync_irq_save();
+  uart_tx_empty_irq_handler(UART_INTR_TX_EMPTY);
+  uart_tx_sleeping = false;
+  plic_irq_wake_restore(UART_INTR_TX_EMPTY, &wake);
+  sync_irq_restore(irq);
 }
 
 void uart_putchar(const uart_t *uart, uint8_t byte) {
   // If the transmit FIFO is full, wait.
   while (uart_tx_full(uart)) {
   }
-  uint32_t reg = bitfield_field32_write(0, UART_WDATA_WDATA_FIELD, byte);
-  mmio_region_write32(uart->base_addr, UART_WDATA_REG_OFFSET, reg);
+  uart_wdata_write(uart_get_regs(uart), UART_WDATA_WDATA(byte));
 
   // If the transmitter is active, wait.
   while (!uart_tx_idle(uart)) {
   }
 }
 
-static uint8_t uart_rx_fifo_read(const uart_t *uart) {
-  uint32_t reg = mmio_region_read32(uart->base_addr, UART_RDATA_REG_OFFSET);
+static bool uart_tx_is_buffered(const uart_t *uart) {
+  return uart_tx_ring.enabled &&
+         uart->base_addr.base == uart_tx_ring.uart.base_addr.base;
+}
+
+static void uart_tx_irq_set_enabled(bool enabled) {
+  if (enabled) {
+    mmio_region_nonatomic_set_bit32(uart_tx_ring.uart.base_addr,
+                                    UART_INTR_ENABLE_REG_OFFSET,
+                                    UART_INTR_ENABLE_TX_WATERMARK_BIT);
+  } else {
+    mmio_region_nonatomic_clear_bit32(uart_tx_ring.uart.base_addr,
+                                      UART_INTR_ENABLE_REG_OFFSET,
+                                      UART_INTR_ENABLE_TX_WATERMARK_BIT);
+  }
+}
+
+/**
+ * Move bytes from the ring to the TX FIFO until one of them is full or empty.
+ */
+static void uart_tx_drain(void) {
+  volatile uart *regs = uart_get_regs(&uart_tx_ring.uart);
+  size_t tail = uart_tx_ring.tail;
+  while (tail != uart_tx_ring.head && !uart_status_txfull_get(regs)) {
+    uart_wdata_write(regs, UART_WDATA_WDATA(uart_tx_ring.buffer[tail]));
+    tail = (tail + 1) & uart_tx_ring.mask;
+  }
+  uart_tx_ring.tail = tail;
+}
+
+/**
+ * Drain from thread context, with the interrupts disabled: a watermark event
+ * already latched by the PLIC would drain from the same tail.
+ */
+static void uart_tx_kick(void) {
+  uint32_t mstatus = sync_irq_save();
+  uart_tx_drain();
+  // Any watermark event raised meanwhile is kept pending in INTR_STATE
+  uart_tx_irq_set_enabled(uart_tx_ring.tail != uart_tx_ring.head);
+  sync_irq_restore(mstatus);
+}
+
+static void uart_tx_irq_handler(uint32_t id) {
+  uart_intr_state_write(uart_get_regs(&uart_tx_ring.uart),
+                        1u << UART_INTR_STATE_TX_WATERMARK_BIT);
+  uart_tx_drain();
+  // Nothing left to send, uart_tx_kick() enables the event again
+  if (uart_tx_ring.tail == uart_tx_ring.head) {
+    uart_tx_irq_set_enabled(false);
+  }
+}
+
+/**
+ * Whether the TX watermark interrupt can be taken, i.e. the external and the
+ * global interrupts are enabled and the core is not in a handler.
+ */
+static bool uart_tx_irq_served(void) {
+  uint32_t mstatus, mie;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_READ(CSR_REG_MIE, &mie);
+  return (mstatus & 0x8) && (mie & (1 << 11));
+}
+
+static size_t uart_write_buffered(const uint8_t *data, size_t len) {
+  size_t total = len;
+  while (len) {
+    size_t head = uart_tx_ring.head;
+    size_t next = (head + 1) & uart_tx_ring.mask;
+    if (next == uart_tx_ring.tail) {
+      // The ring is full, the FIFO accepts bytes as soon as they are sent
+      uart_tx_kick();
+      continue;
+    }
+    uart_tx_ring.buffer[head] = *data;
+    uart_tx_ring.head = next;
+    data++;
+    len--;
+  }
+  // The FIFO is filled here, the interrupt refills it once it is half empty
+  uart_tx_kick();
+  return total;
+}
+
+system_error_t uart_tx_buffered_enable(const uart_t *uart, uint8_t *buffer,
+                                       size_t size) {
+  if (uart == NULL || buffer == NULL || size < 2 || (size & (size - 1)) != 0) {
+    return kErrorUartInvalidArgument;
+  }
+
+  uart_tx_ring.uart = *uart;
+  uart_tx_ring.buffer = buffer;
+  uart_tx_ring.mask = size - 1;
+  uart_tx_ring.head = 0;
+  uart_tx_ring.tail = 0;
+
+  // Watermark event when the FIFO goes below 16 bytes
+  uint32_t reg =
+      mmio_region_read32(uart->base_addr, UART_FIFO_CTRL_REG_OFFSET);
+  reg = bitfield_bit32_write(reg, UART_FIFO_CTRL_RXRST_BIT, false);
+  reg = bitfield_bit32_write(reg, UART_FIFO_CTRL_TXRST_BIT, false);
+  reg = bitfield_field32_write(reg, UART_FIFO_CTRL_TXILVL_FIELD,
+                               UART_FIFO_CTRL_TXILVL_VALUE_TXLVL16);
+  mmio_region_write32(uart->base_addr, UART_FIFO_CTRL_REG_OFFSET, reg);
+  mmio_region_write32(uart->base_addr, UART_INTR_STATE_REG_OFFSET,
+                      1u << UART_INTR_STATE_TX_WATERMARK_BIT);
+
+  // uart_irq_dispatch() serves the event, the UART of the PLIC line is the
+  // one of the MCU
+  if (uart->base_addr.base != (void *)UART_START_ADDRESS ||
+      plic_irq_set_priority(UART_INTR_TX_WATERMARK, 1) != kPlicOk ||
+      plic_irq_set_enabled(UART_INTR_TX_WATERMARK, kPlicToggleEnabled) !=
+          kPlicOk) {
+    return kErrorUartInvalidArgument;
+  }
+
+  // The interrupts of the core are left to the application, uart_write()
+  // blocks while they are disabled. The event is enabled once there is
+  // something to send.
+  uart_tx_ring.enabled = true;
+  return kErrorOk;
+}
+
+bool uart_tx_buffered_is_enabled(const uart_t *uart) {
+  return uart_tx_is_buffered(uart);
+}
 
-  return bitfield_field32_read(reg, UART_RDATA_RDATA_FIELD);
+void uart_tx_flush(const uart_t *uart) {
+  if (uart_tx_is_buffered(uart)) {
+    // Drain here as well, the interrupts may be disabled
+    while (uart_tx_ring.tail != uart_tx_ring.head) {
+      uart_tx_kick();
+      uart_tx_sleep_empty(uart);
+    }
+  }
+  while (!uart_tx_idle(uart)) {
+  }
+}
+
+static uint8_t uart_rx_fifo_read(const uart_t *uart) {
+  return uart_rdata_rdata_get(uart_get_regs(uart));
 }
 
 /**
@@ -118,12 +372,28 @@ size_t uart_getchar(const uart_t *uart, uint8_t *data) {
  * Write `len` bytes to the UART TX FIFO.
  */
 size_t uart_write(const uart_t *uart, const uint8_t *data, size_t len) {
+  if (uart_tx_is_buffered(uart)) {
+    if (uart_tx_irq_served()) {
+      return uart_write_buffered(data, len);
+    }
+    // Nothing would drain the ring: send it, then the data without it
+    while (uart_tx_ring.tail != uart_tx_ring.head) {
+      uart_tx_kick();
+    }
+  }
+
+  // Fill the FIFO and sleep while it drains, then wait for the last byte
   size_t total = len;
   while (len) {
-    uart_putchar(uart, *data);
+    if (uart_tx_full(uart)) {
+      uart_tx_sleep_empty(uart);
+    }
+    uart_wdata_write(uart_get_regs(uart), UART_WDATA_WDATA(*data));
     data++;
     len--;
   }
+  while (!uart_tx_idle(uart)) {
+  }
   return total;
 }
 
@@ -144,6 +414,16 @@ size_t uart_sink(void *uart, const char *data, size_t len) {
   return uart_write((const uart_t *)uart, (const uint8_t *)data, len);
 }
 
+void uart_irq_dispatch(uint32_t id) {
+  if (id == UART_INTR_TX_WATERMARK && uart_tx_ring.enabled) {
+    uart_tx_irq_handler(id);
+  } else if (id == UART_INTR_TX_EMPTY && uart_tx_sleeping) {
+    uart_tx_empty_irq_handler(id);
+  } else {
+    handler_irq_uart(id);
+  }
+}
+
 __attribute__((weak, optimize("O0"))) void handler_irq_uart(uint32_t id)
 {
  // Replace this function with a non-weak implementation
@@ -8,6 +8,7 @@
 #ifndef _DRIVERS_UART_H_
 #define _DRIVERS_UART_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -37,6 +38,12 @@ typedef struct uart {
   uint32_t clk_freq_hz;
 } uart_t;
 
+/**
+ * Highest baudrate uart_init() accepts for a clock frequency: the NCO makes
+ * 16 ticks per bit from one increment of at most 2^16 - 1 per cycle.
+ */
+#define UART_MAX_BAUDRATE(clk_freq_hz) (((clk_freq_hz) - 1) / 16)
+
 /**
  * Initialize the UART with the request parameters.
  *
@@ -45,6 +52,30 @@ typedef struct uart {
  */
 system_error_t uart_init(const uart_t *uart);
 
+/**
+ * Check that the baudrate of a UART can be made from a clock frequency.
+ *
+ * @param uart Pointer to uart_t represting the target UART.
+ * @param clk_freq_hz Peripheral clock frequency.
+ * @return kErrorOk if it can, else an error code.
+ */
+system_error_t uart_check_clk_freq(const uart_t *uart, uint32_t clk_freq_hz);
+
+/**
+ * Reprogram the baudrate divisor of an initialized UART for a new clock
+ * frequency, e.g. after the system clock was scaled (see clk_scale.h).
+ *
+ * Unlike uart_init(), the FIFOs are not reset and the buffered TX mode is
+ * kept. The UART must be idle across the clock change, so that no character
+ * is sent with the wrong divisor: call uart_tx_flush() before it.
+ *
+ * @param uart Pointer to uart_t represting the target UART, its clk_freq_hz
+ * is updated.
+ * @param clk_freq_hz New peripheral clock frequency.
+ * @return kErrorOk if successful, else an error code.
+ */
+system_error_t uart_set_clk_freq(uart_t *uart, uint32_t clk_freq_hz);
+
 /**
  * Write a single byte to the UART.
  *
@@ -57,6 +88,12 @@ void uart_putchar(const uart_t *uart, uint8_t byte);
  * Write a buffer to the UART.
  *
  * Writes the complete buffer to the UART and wait for transmision to complete.
+ * With the interrupts enabled, the core sleeps on the TX empty interrupt of
+ * the PLIC while the FIFO drains, else it polls.
+ * In buffered mode (see uart_tx_buffered_enable()), the buffer is copied to
+ * the ring buffer instead and the function only waits if the ring is full.
+ * While the interrupts are disabled, e.g. in a handler, the ring is sent
+ * first and the buffer is then written as in the blocking mode.
  *
  * @param uart Pointer to uart_t represting the target UART.
  * @param data Pointer to buffer to write.
@@ -84,11 +121,61 @@ size_t uart_read(const uart_t *uart, const uint8_t *data, size_t len);
 size_t uart_sink(void *uart, const char *data, size_t len);
 
 
+/**
+ * Enable the buffered TX mode of a UART.
+ *
+ * uart_write() then copies the data to a ring buffer and returns, and the TX
+ * FIFO is refilled from the ring in the TX watermark interrupt, when the FIFO
+ * goes below 16 bytes, served by uart_irq_dispatch(). Only the UART of the
+ * MCU is supported. The interrupt is enabled in the PLIC, so this must be
+ * called after plic_Init(), but not in the core: the ring is only drained in
+ * the background once the application has set MIE.MEIE and MSTATUS.MIE.
+ * Calling uart_init() again flushes the ring and goes back to the blocking
+ * mode.
+ *
+ * @param uart Pointer to uart_t represting the target UART, initialized.
+ * @param buffer Ring buffer, owned by the driver from now on.
+ * @param size Size of the ring buffer in bytes, a power of 2.
+ * @return kErrorOk if successful, else an error code.
+ */
+system_error_t uart_tx_buffered_enable(const uart_t *uart, uint8_t *buffer,
+                                       size_t size);
+
+/**
+ * Check if the buffered TX mode is enabled for a UART.
+ *
+ * @param uart Pointer to uart_t represting the target UART.
+ * @return true if uart_write() is buffered for this UART.
+ */
+bool uart_tx_buffered_is_enabled(const uart_t *uart);
+
+/**
+ * Wait until all the data written to the UART has been sent.
+ *
+ * Must be called before exiting or before a sleep that stops the UART, so
+ * that the buffered data is not lost. The ring is drained from here as well,
+ * so this also works with the interrupts disabled, and the core sleeps while
+ * the FIFO empties when they are enabled.
+ *
+ * @param uart Pointer to uart_t represting the target UART.
+ */
+void uart_tx_flush(const uart_t *uart);
+
 /**
  * @brief Attends the plic interrupt.
+ *
+ * Called by uart_irq_dispatch() for the events not used by the driver.
  */
 __attribute__((weak, optimize("O0"))) void handler_irq_uart(uint32_t id);
 
+/**
+ * @brief Handler of the UART interrupts called by the PLIC.
+ *
+ * Serves the TX watermark event of the buffered mode and the TX empty event
+ * of the blocking writes, and passes the other ones to handler_irq_uart().
+ */
+void uart_irq_dispatch(uint32_t id);
+
 #ifdef __cplusplus
 }
 #endif
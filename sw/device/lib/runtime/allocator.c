@@ -0,0 +1,361 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "allocator.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "clk_gate.h"
+
+void *_sbrk(ptrdiff_t incr);
+
+static void alloc_stats_add(alloc_stats_t *stats, uint32_t size) {
+  stats->used += size;
+  stats->allocs++;
+  if (stats->used > stats->peak) {
+    stats->peak = stats->used;
+  }
+}
+
+static void alloc_stats_sub(alloc_stats_t *stats, uint32_t size) {
+  stats->used -= size;
+  stats->frees++;
+}
+
+/****************************************************************************/
+/*                                 POOLS                                    */
+/****************************************************************************/
+
+uint32_t alloc_pool_init(alloc_pool_t *pool, void *mem, size_t size,
+                         size_t block_size) {
+  block_size = (block_size + 3) & ~(size_t)3;
+  if (block_size < sizeof(void *)) {
+    block_size = sizeof(void *);
+  }
+
+  memset(pool, 0, sizeof(*pool));
+  pool->block_size = block_size;
+
+  // The free blocks are chained through their first word
+  uint32_t blocks = size / block_size;
+  if (blocks == 0) {
+    return 0;
+  }
+  uint8_t *block = (uint8_t *)mem + (blocks - 1) * block_size;
+  for (uint32_t i = 0; i < blocks; i++) {
+    *(void **)block = pool->free;
+    pool->free = block;
+    block -= block_size;
+  }
+
+  pool->stats.size = blocks * block_size;
+  return blocks;
+}
+
+void *alloc_pool_get(alloc_pool_t *pool) {
+  void *block = pool->free;
+  if (block == NULL) {
+    pool->stats.failures++;
+    return NULL;
+  }
+  pool->free = *(void **)block;
+  alloc_stats_add(&pool->stats, pool->block_size);
+  return block;
+}
+
+void alloc_pool_put(alloc_pool_t *pool, void *block) {
+  if (block == NULL) {
+    return;
+  }
+  *(void **)block = pool->free;
+  pool->free = block;
+  alloc_stats_sub(&pool->stats, pool->block_size);
+}
+
+const alloc_stats_t *alloc_pool_stats(const alloc_pool_t *pool) {
+  return &pool->stats;
+}
+
+/****************************************************************************/
+/*                                 ARENAS                                   */
+/****************************************************************************/
+
+void alloc_arena_init(alloc_arena_t *arena, void *mem, size_t size) {
+  memset(arena, 0, sizeof(*arena));
+  arena->base = (uint8_t *)mem;
+  arena->stats.size = size;
+}
+
+void *alloc_arena_alloc(alloc_arena_t *arena, size_t size, size_t align) {
+  uintptr_t start = (uintptr_t)arena->base + arena->offset;
+  start = (start + align - 1) & ~(uintptr_t)(align - 1);
+  uint32_t offset = start - (uintptr_t)arena->base;
+
+  if (offset > arena->stats.size || size > arena->stats.size - offset) {
+    arena->stats.failures++;
+    return NULL;
+  }
+
+  arena->offset = offset + size;
+  arena->stats.allocs++;
+  arena->stats.used = arena->offset;
+  if (arena->stats.used > arena->stats.peak) {
+    arena->stats.peak = arena->stats.used;
+  }
+  return (void *)start;
+}
+
+uint32_t alloc_arena_mark(const alloc_arena_t *arena) { return arena->offset; }
+
+void alloc_arena_release(alloc_arena_t *arena, uint32_t mark) {
+  if (mark < arena->offset) {
+    arena->offset = mark;
+    arena->stats.used = mark;
+    arena->stats.frees++;
+  }
+}
+
+void alloc_arena_reset(alloc_arena_t *arena) { alloc_arena_release(arena, 0); }
+
+const alloc_stats_t *alloc_arena_stats(const alloc_arena_t *arena) {
+  return &arena->stats;
+}
+
+/****************************************************************************/
+/*                        GENERAL-PURPOSE ALLOCATOR                         */
+/****************************************************************************/
+
+// Header before each block of alloc_malloc(), ALLOC_ALIGN bytes
+typedef struct {
+  uint8_t region;
+  uint8_t size_class;
+  uint16_t magic;
+  uint32_t size;  // Requested size, for realloc
+} alloc_header_t;
+
+_Static_assert(sizeof(alloc_header_t) == ALLOC_ALIGN,
+               "The header must keep the blocks aligned");
+
+#define ALLOC_MAGIC 0xA110
+#define ALLOC_MIN_BLOCK 16
+
+typedef struct {
+  uint8_t *next;  // Bump pointer of the memory never allocated
+  uint8_t *end;
+  void *free[ALLOC_CLASSES];  // Freed blocks of each class
+  bool grows;                 // Takes more memory from _sbrk()
+  alloc_stats_t stats;
+} alloc_region_t;
+
+static alloc_region_t alloc_regions[ALLOC_MAX_REGIONS] = {
+    [0] = {.grows = true},
+};
+static int alloc_num_regions = 1;
+
+static int alloc_size_class(size_t size) {
+  if (size > ((size_t)ALLOC_MIN_BLOCK << (ALLOC_CLASSES - 1)) -
+                 sizeof(alloc_header_t)) {
+    return -1;
+  }
+  size_t block = ALLOC_MIN_BLOCK;
+  int size_class = 0;
+  while (block < size + sizeof(alloc_header_t)) {
+    block <<= 1;
+    size_class++;
+  }
+  return size_class;
+}
+
+// Takes a block of `block` bytes from the memory never allocated
+static uint8_t *alloc_region_bump(alloc_region_t *region, uint32_t block) {
+  if (region->next == NULL || (uint32_t)(region->end - region->next) < block) {
+    if (!region->grows) {
+      return NULL;
+    }
+    // Room to align the chunk, the rest of the current memory is lost if
+    // the chunk does not follow it
+    uint32_t chunk =
+        (block > ALLOC_SBRK_CHUNK ? block : ALLOC_SBRK_CHUNK) + ALLOC_ALIGN;
+    uint8_t *mem = (uint8_t *)_sbrk(chunk);
+    if (mem == (uint8_t *)-1 || mem == NULL) {
+      return NULL;
+    }
+    if (mem != region->end) {
+      region->next = (uint8_t *)(((uintptr_t)mem + ALLOC_ALIGN - 1) &
+                                 ~(uintptr_t)(ALLOC_ALIGN - 1));
+    }
+    region->end = mem + chunk;
+    region->stats.size += chunk;
+  }
+  uint8_t *mem = region->next;
+  region->next += block;
+  return mem;
+}
+
+int alloc_region_add(void *mem, size_t size) {
+  if (alloc_num_regions == ALLOC_MAX_REGIONS) {
+    return -1;
+  }
+
+  uintptr_t start =
+      ((uintptr_t)mem + ALLOC_ALIGN - 1) & ~(uintptr_t)(ALLOC_ALIGN - 1);
+  uintptr_t end = (uintptr_t)mem + size;
+  alloc_region_t *region = &alloc_regions[alloc_num_regions];
+  memset(region, 0, sizeof(*region));
+  region->next = (uint8_t *)start;
+  region->end = (uint8_t *)(end > start ? end : start);
+  region->stats.size = region->end - region->next;
+  // Its banks are gated while they hold no block
+  clk_gate_ram_manage(region->next, region->stats.size);
+  return alloc_num_regions++;
+}
+
+// Allocates from a region, without counting the failures
+static void *alloc_region_malloc(int region_idx, size_t size) {
+  alloc_region_t *region = &alloc_regions[region_idx];
+
+  int size_class = alloc_size_class(size);
+  if (size_class < 0) {
+    return NULL;
+  }
+  uint32_t block_size = ALLOC_MIN_BLOCK << size_class;
+
+  alloc_header_t *header = region->free[size_class];
+  if (header != NULL) {
+    // The link to the next free block is in the block
+    clk_gate_ram_alloc(header, block_size);
+    region->free[size_class] = *(void **)(header + 1);
+  } else {
+    header = (alloc_header_t *)alloc_region_bump(region, block_size);
+    if (header == NULL) {
+      return NULL;
+    }
+    clk_gate_ram_alloc(header, block_size);
+  }
+
+  header->region = region_idx;
+  header->size_class = size_class;
+  header->magic = ALLOC_MAGIC;
+  header->size = size;
+  alloc_stats_add(&region->stats, block_size);
+  return header + 1;
+}
+
+void *alloc_malloc_in(int region, size_t size) {
+  if (region < 0 || region >= alloc_num_regions) {
+    return NULL;
+  }
+  void *ptr = alloc_region_malloc(region, size);
+  if (ptr == NULL) {
+    alloc_regions[region].stats.failures++;
+  }
+  return ptr;
+}
+
+void *alloc_malloc(size_t size) {
+  for (int i = 0; i < alloc_num_regions; i++) {
+    void *ptr = alloc_region_malloc(i, size);
+    if (ptr != NULL) {
+      return ptr;
+    }
+  }
+  // Counted once, in the heap
+  alloc_regions[0].stats.failures++;
+  return NULL;
+}
+
+void alloc_free(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  alloc_header_t *header = (alloc_header_t *)ptr - 1;
+  if (header->magic != ALLOC_MAGIC) {
+    // Not a block of alloc_malloc(), or freed twice
+    return;
+  }
+  header->magic = 0;
+
+  alloc_region_t *region = &alloc_regions[header->region];
+  *(void **)ptr = region->free[header->size_class];
+  region->free[header->size_class] = header;
+  alloc_stats_sub(&region->stats, ALLOC_MIN_BLOCK << header->size_class);
+  clk_gate_ram_free(header, ALLOC_MIN_BLOCK << header->size_class);
+}
+
+void *alloc_calloc(size_t count, size_t size) {
+  if (size != 0 && count > SIZE_MAX / size) {
+    return NULL;
+  }
+  void *ptr = alloc_malloc(count * size);
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+void *alloc_realloc(void *ptr, size_t size) {
+  if (ptr == NULL) {
+    return alloc_malloc(size);
+  }
+  if (size == 0) {
+    alloc_free(ptr);
+    return NULL;
+  }
+
+  alloc_header_t *header = (alloc_header_t *)ptr - 1;
+  if (alloc_size_class(size) == header->size_class) {
+    header->size = size;
+    return ptr;
+  }
+
+  // Preferably in the same region
+  void *new_ptr = alloc_region_malloc(header->region, size);
+  if (new_ptr == NULL) {
+    new_ptr = alloc_malloc(size);
+    if (new_ptr == NULL) {
+      return NULL;
+    }
+  }
+  memcpy(new_ptr, ptr, header->size < size ? header->size : size);
+  alloc_free(ptr);
+  return new_ptr;
+}
+
+const alloc_stats_t *alloc_region_stats(int region) {
+  if (region < 0 || region >= alloc_num_regions) {
+    return NULL;
+  }
+  return &alloc_regions[region].stats;
+}
+
+/****************************************************************************/
+/*                             MALLOC BACKEND                               */
+/****************************************************************************/
+
+#ifdef RUNTIME_MALLOC
+// Selected with MALLOC=runtime, which wraps these symbols at link time. The
+// reentrant versions are used inside newlib (e.g. by printf).
+struct _reent;
+
+void *__wrap_malloc(size_t size) { return alloc_malloc(size); }
+void __wrap_free(void *ptr) { alloc_free(ptr); }
+void *__wrap_calloc(size_t count, size_t size) {
+  return alloc_calloc(count, size);
+}
+void *__wrap_realloc(void *ptr, size_t size) {
+  return alloc_realloc(ptr, size);
+}
+
+void *__wrap__malloc_r(struct _reent *r, size_t size) {
+  return alloc_malloc(size);
+}
+void __wrap__free_r(struct _reent *r, void *ptr) { alloc_free(ptr); }
+void *__wrap__calloc_r(struct _reent *r, size_t count, size_t size) {
+  return alloc_calloc(count, size);
+}
+void *__wrap__realloc_r(struct _reent *r, void *ptr, size_t size) {
+  return alloc_realloc(ptr, size);
+}
+#endif  // RUNTIME_MALLOC
@@ -0,0 +1,216 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef ALLOCATOR_H_
+#define ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Allocators of the runtime: pools of fixed-size blocks, arenas that
+ * are reset at once (e.g. per frame), and a general-purpose allocator with
+ * size classes that can replace the malloc of newlib.
+ *
+ * The pools and arenas manage memory given by the application, so they can
+ * be placed in a chosen RAM bank, e.g. with a static buffer in a section of
+ * that bank. The general-purpose allocator takes memory from regions: region
+ * 0 grows with _sbrk() in the heap of the linker script, and more regions
+ * (e.g. one per bank) are added with alloc_region_add(). Every allocator
+ * keeps usage statistics. Built with CLK_GATE, the banks entirely in a region
+ * are clock-gated while no block is allocated in them, see clk_gate.h.
+ *
+ * Building with MALLOC=runtime routes malloc, free, calloc and realloc of
+ * libc, and so C++ new and delete, through alloc_malloc() and co, with the
+ * --wrap option of the linker.
+ *
+ * None of the functions can be called from interrupt handlers.
+ */
+
+/**
+ * Alignment of the blocks of alloc_malloc(), in bytes.
+ */
+#define ALLOC_ALIGN 8
+
+/**
+ * Number of size classes of alloc_malloc(): blocks of 16 bytes to
+ * 16 << (ALLOC_CLASSES - 1) bytes, header included.
+ */
+#define ALLOC_CLASSES 16
+
+/**
+ * Largest number of regions of alloc_malloc(), region 0 included.
+ */
+#ifndef ALLOC_MAX_REGIONS
+#define ALLOC_MAX_REGIONS 4
+#endif
+
+/**
+ * Smallest amount of memory, in bytes, region 0 takes from _sbrk() at once.
+ */
+#ifndef ALLOC_SBRK_CHUNK
+#define ALLOC_SBRK_CHUNK 1024
+#endif
+
+/**
+ * Usage statistics of an allocator. The sizes are in bytes and include the
+ * rounding of the blocks.
+ */
+typedef struct {
+  uint32_t size;      // Memory managed by the allocator
+  uint32_t used;      // Memory currently allocated
+  uint32_t peak;      // Highest value of used
+  uint32_t allocs;    // Successful allocations
+  uint32_t frees;     // Releases
+  uint32_t failures;  // Failed allocations
+} alloc_stats_t;
+
+/**
+ * Pool of fixed-size blocks. The fields are private.
+ */
+typedef struct {
+  void *free;
+  uint32_t block_size;
+  alloc_stats_t stats;
+} alloc_pool_t;
+
+/**
+ * Bump allocator, freed at once. The fields are private.
+ */
+typedef struct {
+  uint8_t *base;
+  uint32_t offset;
+  alloc_stats_t stats;
+} alloc_arena_t;
+
+/**
+ * Creates a pool of blocks in `mem`.
+ *
+ * @param pool Pool to initialize.
+ * @param mem Memory of the blocks, aligned on a word.
+ * @param size Size of `mem` in bytes.
+ * @param block_size Size of the blocks in bytes, rounded up to a word.
+ * @return Number of blocks of the pool.
+ */
+uint32_t alloc_pool_init(alloc_pool_t *pool, void *mem, size_t size,
+                         size_t block_size);
+
+/**
+ * Takes a block from a pool.
+ *
+ * @param pool Pool.
+ * @return The block, or NULL if the pool is empty.
+ */
+void *alloc_pool_get(alloc_pool_t *pool);
+
+/**
+ * Gives a block back to its pool.
+ *
+ * @param pool Pool the block was taken from.
+ * @param block Block, or NULL.
+ */
+void alloc_pool_put(alloc_pool_t *pool, void *block);
+
+/**
+ * Creates an arena in `mem`.
+ *
+ * @param arena Arena to initialize.
+ * @param mem Memory of the arena.
+ * @param size Size of `mem` in bytes.
+ */
+void alloc_arena_init(alloc_arena_t *arena, void *mem, size_t size);
+
+/**
+ * Allocates from an arena. The memory is only released by
+ * alloc_arena_release() or alloc_arena_reset().
+ *
+ * @param arena Arena.
+ * @param size Size in bytes.
+ * @param align Alignment in bytes, a power of 2.
+ * @return The memory, or NULL if the arena is full.
+ */
+void *alloc_arena_alloc(alloc_arena_t *arena, size_t size, size_t align);
+
+/**
+ * Returns the current position of an arena, for alloc_arena_release().
+ */
+uint32_t alloc_arena_mark(const alloc_arena_t *arena);
+
+/**
+ * Releases everything allocated from an arena since `mark`.
+ *
+ * @param arena Arena.
+ * @param mark Value returned by alloc_arena_mark().
+ */
+void alloc_arena_release(alloc_arena_t *arena, uint32_t mark);
+
+/**
+ * Releases everything allocated from an arena.
+ */
+void alloc_arena_reset(alloc_arena_t *arena);
+
+/**
+ * Adds a region to the general-purpose allocator.
+ *
+ * @param mem Memory of the region, e.g. a buffer in a given RAM bank.
+ * @param size Size of `mem` in bytes.
+ * @return Index of the region for alloc_malloc_in(), or -1 if
+ * ALLOC_MAX_REGIONS regions already exist.
+ */
+int alloc_region_add(void *mem, size_t size);
+
+/**
+ * Allocates from a given region.
+ *
+ * The size is rounded up to a power of 2 with the header, and the freed
+ * blocks are reused for the allocations of the same size class, in O(1).
+ *
+ * @param region Index of the region, 0 for the heap.
+ * @param size Size in bytes.
+ * @return The memory, aligned on ALLOC_ALIGN, or NULL.
+ */
+void *alloc_malloc_in(int region, size_t size);
+
+/**
+ * Allocates from region 0, then from the other regions in order.
+ *
+ * @param size Size in bytes.
+ * @return The memory, aligned on ALLOC_ALIGN, or NULL.
+ */
+void *alloc_malloc(size_t size);
+
+/**
+ * Frees memory of alloc_malloc() and co.
+ *
+ * @param ptr Memory, or NULL.
+ */
+void alloc_free(void *ptr);
+
+/**
+ * Allocates `count` zeroed elements of `size` bytes.
+ */
+void *alloc_calloc(size_t count, size_t size);
+
+/**
+ * Resizes memory of alloc_malloc(), in place when the size class allows.
+ */
+void *alloc_realloc(void *ptr, size_t size);
+
+/**
+ * Returns the statistics of a region, or NULL if it does not exist.
+ */
+const alloc_stats_t *alloc_region_stats(int region);
+
+/**
+ * Returns the statistics of a pool.
+ */
+const alloc_stats_t *alloc_pool_stats(const alloc_pool_t *pool);
+
+/**
+ * Returns the statistics of an arena.
+ */
+const alloc_stats_t *alloc_arena_stats(const alloc_arena_t *arena);
+
+#endif  // ALLOCATOR_H_
@@ -0,0 +1,178 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "async.h"
+
+#include <stddef.h>
+
+#include "csr.h"
+#include "hart.h"
+
+// The ready queue and the futures are also changed by the interrupt handlers,
+// through async_future_complete(), so the other functions change them with the
+// interrupts disabled.
+static struct {
+  async_task_t *head;
+  async_task_t *tail;
+  uint32_t alive;
+  async_future_t *volatile bound[ASYNC_SOURCES];
+} async;
+
+static inline uint32_t irq_save(void) {
+  uint32_t mstatus;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  return mstatus;
+}
+
+static inline void irq_restore(uint32_t mstatus) {
+  if (mstatus & 0x8) {
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
+
+// Called with the interrupts disabled
+static void enqueue(async_task_t *task) {
+  if (task->queued) {
+    return;
+  }
+  task->queued = 1;
+  task->next = NULL;
+  if (async.tail == NULL) {
+    async.head = task;
+  } else {
+    async.tail->next = task;
+  }
+  async.tail = task;
+}
+
+void async_task_init(async_task_t *task, async_task_fn_t fn, void *arg) {
+  task->fn = fn;
+  task->arg = arg;
+  task->state = 0;
+  task->done = NULL;
+  task->next = NULL;
+  task->queued = 0;
+  task->waiting = 0;
+}
+
+void async_spawn(async_task_t *task) {
+  uint32_t mstatus = irq_save();
+  async.alive++;
+  enqueue(task);
+  irq_restore(mstatus);
+}
+
+void async_run(void) {
+  while (1) {
+    // The interrupts are disabled between the check of the queue and the
+    // wfi, so a future completed in between is not missed: its pending
+    // interrupt still wakes the CPU up, and is served once they are enabled.
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    async_task_t *task = async.head;
+    if (task == NULL) {
+      if (async.alive == 0) {
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+        return;
+      }
+      wait_for_interrupt();
+      CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+      continue;
+    }
+    async.head = task->next;
+    if (async.head == NULL) {
+      async.tail = NULL;
+    }
+    task->queued = 0;
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    task->fn(task);
+
+    // Neither waiting for a future nor yielding: the task is done, and may be
+    // freed by its done function.
+    uint32_t mstatus = irq_save();
+    bool done = !task->waiting && !task->queued;
+    irq_restore(mstatus);
+    if (done) {
+      async.alive--;
+      if (task->done != NULL) {
+        task->done(task);
+      }
+    }
+  }
+}
+
+void async_future_init(async_future_t *future) {
+  future->ready = 0;
+  future->value = 0;
+  future->waiter = NULL;
+}
+
+void async_future_complete(async_future_t *future, int32_t value) {
+  uint32_t mstatus = irq_save();
+  if (!future->ready) {
+    future->value = value;
+    future->ready = 1;
+    async_task_t *task = future->waiter;
+    future->waiter = NULL;
+    if (task != NULL) {
+      task->waiting = 0;
+      enqueue(task);
+    }
+  }
+  irq_restore(mstatus);
+}
+
+void async_future_callback(int32_t value, void *future) {
+  async_future_complete((async_future_t *)future, value);
+}
+
+bool async_await(async_task_t *task, async_future_t *future) {
+  uint32_t mstatus = irq_save();
+  bool ready = future->ready;
+  if (!ready) {
+    future->waiter = task;
+    task->waiting = 1;
+  }
+  irq_restore(mstatus);
+  return ready;
+}
+
+void async_yield(async_task_t *task) {
+  uint32_t mstatus = irq_save();
+  enqueue(task);
+  irq_restore(mstatus);
+}
+
+int async_bind(uint32_t source, async_future_t *future) {
+  if (source >= ASYNC_SOURCES) {
+    return -1;
+  }
+  async.bound[source] = future;
+  return 0;
+}
+
+void async_unbind(uint32_t source) {
+  if (source < ASYNC_SOURCES) {
+    async.bound[source] = NULL;
+  }
+}
+
+__attribute__((weak)) void async_source_notified(uint32_t source,
+                                                  int32_t value) {
+  (void)source;
+  (void)value;
+}
+
+void async_notify(uint32_t source, int32_t value) {
+  if (source >= ASYNC_SOURCES) {
+    return;
+  }
+  async_source_notified(source, value);
+  async_future_t *future = async.bound[source];
+  if (future != NULL) {
+    async.bound[source] = NULL;
+    async_future_complete(future, value);
+  }
+}
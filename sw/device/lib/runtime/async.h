@@ -0,0 +1,240 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef ASYNC_H_
+#define ASYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core_v_mini_mcu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * @brief Run-to-completion executor of cooperative tasks, woken by the
+ * interrupts of the drivers.
+ *
+ * A task is a function run by async_run() until it returns. Before returning,
+ * it can wait for a future with async_await() or ASYNC_AWAIT(): it is then run
+ * again once the future is completed, from the point saved in its state with
+ * ASYNC_BEGIN() and ASYNC_AWAIT(). A task that returns without waiting is
+ * done. The local variables of the function are lost between two runs, the
+ * task keeps its data in the structure given as argument. The resume points
+ * are the cases of a switch: there can be one ASYNC_AWAIT() or ASYNC_YIELD()
+ * per line, and none of them inside another switch.
+ *
+ * A future is completed with async_future_complete(), from a task or from an
+ * interrupt handler, e.g. as the callback of dma_copy_32b_async() with
+ * async_future_callback(). The drivers also complete the future bound to
+ * their interrupt sources with async_bind():
+ * - ASYNC_SOURCE_PLIC(id): the PLIC interrupt id (GPIO, I2S, SPI, UART...),
+ *   after its handler;
+ * - ASYNC_SOURCE_FAST(fic): the fast interrupt fic (timers, GPIO 0 to 7),
+ *   after its handler;
+ * - ASYNC_SOURCE_DMA(channel): the end of a DMA transaction launched with an
+ *   interrupt, after the handlers of the SDK and of the application;
+ * - ASYNC_SOURCE_SPI(idx): the end of a non-blocking transaction of the SPI
+ *   SDK on the peripheral idx (spi_idx_e), with 0 or the errors (spi_error_e).
+ * A binding is used once: it is removed when its future is completed.
+ *
+ * When no task is ready, async_run() sleeps with wait_for_interrupt(). It
+ * returns once all the tasks are done. The functions are meant for the main
+ * program, except async_future_complete() and async_notify(). The C++20
+ * coroutines of async.hpp are tasks of the same executor.
+ */
+
+/**
+ * Interrupt sources of async_bind().
+ */
+#define ASYNC_FAST_SOURCES 16
+#define ASYNC_SPI_SOURCES 3
+#define ASYNC_SOURCE_PLIC(id) (id)
+#define ASYNC_SOURCE_FAST(fic) (QTY_INTR + (fic))
+#define ASYNC_SOURCE_DMA(channel) (QTY_INTR + ASYNC_FAST_SOURCES + (channel))
+#define ASYNC_SOURCE_SPI(idx) \
+  (QTY_INTR + ASYNC_FAST_SOURCES + DMA_CH_NUM + (idx))
+#define ASYNC_SOURCES \
+  (QTY_INTR + ASYNC_FAST_SOURCES + DMA_CH_NUM + ASYNC_SPI_SOURCES)
+
+typedef struct async_task async_task_t;
+
+/**
+ * Function of a task, run until it returns.
+ */
+typedef void (*async_task_fn_t)(async_task_t *task);
+
+struct async_task {
+  async_task_fn_t fn;
+  void *arg;
+  uint32_t state;         // Resume point of ASYNC_BEGIN(), 0 at the start
+  async_task_fn_t done;   // Called once the task is done, or NULL
+  async_task_t *next;     // Ready queue
+  volatile uint8_t queued;
+  volatile uint8_t waiting;
+};
+
+/**
+ * Result of an operation, completed once.
+ */
+typedef struct async_future {
+  volatile uint8_t ready;
+  volatile int32_t value;
+  async_task_t *waiter;
+} async_future_t;
+
+/**
+ * Resume point of a task, at the start of its function.
+ */
+#define ASYNC_BEGIN(task) \
+  switch ((task)->state) { \
+    case 0:
+
+/**
+ * Returns from the function of the task until the future is completed, and
+ * goes on from here when the task is run again.
+ */
+#define ASYNC_AWAIT(task, future) \
+  do { \
+    (task)->state = __LINE__; \
+    case __LINE__: \
+      if (!async_await((task), (future))) { \
+        return; \
+      } \
+  } while (0)
+
+/**
+ * Returns from the function of the task, which is run again after the other
+ * ready tasks, and goes on from here.
+ */
+#define ASYNC_YIELD(task) \
+  do { \
+    (task)->state = __LINE__; \
+    async_yield(task); \
+    return; \
+    case __LINE__:; \
+  } while (0)
+
+/**
+ * End of the function of the task, once done.
+ */
+#define ASYNC_END(task) \
+  } \
+  (task)->state = 0
+
+/**
+ * Prepares a task.
+ *
+ * @param task Task, that lives until it is done.
+ * @param fn Function of the task.
+ * @param arg Data of the task, in task->arg.
+ */
+void async_task_init(async_task_t *task, async_task_fn_t fn, void *arg);
+
+/**
+ * Makes a task ready, to be run by async_run().
+ *
+ * @param task Task prepared with async_task_init(), not running.
+ */
+void async_spawn(async_task_t *task);
+
+/**
+ * Runs the ready tasks, sleeping while none is ready, until all the tasks
+ * are done.
+ */
+void async_run(void);
+
+/**
+ * Prepares a future, not completed.
+ *
+ * @param future Future.
+ */
+void async_future_init(async_future_t *future);
+
+/**
+ * Completes a future and makes its task ready. A future is only completed
+ * once, until async_future_init().
+ *
+ * @param future Future.
+ * @param value Result, given by async_future_value().
+ */
+void async_future_complete(async_future_t *future, int32_t value);
+
+/**
+ * Completes a future, with the signature of the callbacks of the SDK, e.g.
+ * dma_copy_32b_async(dst, src, size, async_future_callback, &future).
+ *
+ * @param value Result of the future.
+ * @param future Future.
+ */
+void async_future_callback(int32_t value, void *future);
+
+static inline bool async_future_ready(const async_future_t *future) {
+  return future->ready;
+}
+
+static inline int32_t async_future_value(const async_future_t *future) {
+  return future->value;
+}
+
+/**
+ * Makes the task wait for the future, if not completed yet.
+ *
+ * @param task Task running.
+ * @param future Future.
+ * @return true if the future is completed, false if the task must return.
+ */
+bool async_await(async_task_t *task, async_future_t *future);
+
+/**
+ * Makes the running task ready again, after the other ready tasks.
+ *
+ * @param task Task running, that must return.
+ */
+void async_yield(async_task_t *task);
+
+/**
+ * Completes the future at the next interrupt of a source. It is bound before
+ * the operation is started, so that its interrupt is not missed.
+ *
+ * @param source ASYNC_SOURCE_*().
+ * @param future Future, initialised.
+ * @return 0, or -1 if the source does not exist.
+ */
+int async_bind(uint32_t source, async_future_t *future);
+
+/**
+ * Removes the binding of a source.
+ *
+ * @param source ASYNC_SOURCE_*().
+ */
+void async_unbind(uint32_t source);
+
+/**
+ * Completes the future bound to a source, if any, from its interrupt handler.
+ *
+ * @param source ASYNC_SOURCE_*().
+ * @param value Result of the future.
+ */
+void async_notify(uint32_t source, int32_t value);
+
+/**
+ * Called by async_notify() for each interrupt of a source, bound or not, from
+ * the interrupt handler. The weak definition does nothing; the blocking
+ * drivers of FreeRTOS (sw/freertos/rtos_io.h) wake up the task waiting for
+ * the source from it.
+ *
+ * @param source ASYNC_SOURCE_*().
+ * @param value Value given to async_notify().
+ */
+void async_source_notified(uint32_t source, int32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // ASYNC_H_
@@ -0,0 +1,137 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef ASYNC_HPP_
+#define ASYNC_HPP_
+
+#include <coroutine>
+#include <stdlib.h>
+
+#include "async.h"
+
+/**
+ * @file
+ * @brief C++20 coroutines on the executor of async.h.
+ *
+ * A function returning xheep::task is a coroutine, which runs once spawned
+ * with xheep::spawn() and awaits the futures with co_await:
+ *
+ *   xheep::task copy(uint32_t *dst, uint32_t *src, uint32_t size) {
+ *     async_future_t done;
+ *     async_future_init(&done);
+ *     dma_copy_32b_async(dst, src, size, async_future_callback, &done);
+ *     int32_t ticket = co_await xheep::wait(&done);
+ *     co_await xheep::yield();
+ *   }
+ *
+ *   xheep::spawn(copy(dst, src, size));
+ *   async_run();
+ *
+ * The frame of the coroutine is allocated with malloc() when it is called,
+ * and freed once it is done. A coroutine that cannot be allocated is not
+ * spawned.
+ */
+
+namespace xheep {
+
+class task {
+ public:
+  struct promise_type {
+    async_task_t async;
+
+    static void resume(async_task_t *t) {
+      std::coroutine_handle<promise_type>::from_promise(
+          *static_cast<promise_type *>(t->arg))
+          .resume();
+    }
+
+    static void destroy(async_task_t *t) {
+      std::coroutine_handle<promise_type>::from_promise(
+          *static_cast<promise_type *>(t->arg))
+          .destroy();
+    }
+
+    promise_type() {
+      async_task_init(&async, &resume, this);
+      async.done = &destroy;
+    }
+
+    task get_return_object() {
+      return task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    static task get_return_object_on_allocation_failure() { return task(); }
+
+    // Started by spawn(), and destroyed by the executor once done
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+
+    static void *operator new(size_t size) noexcept { return malloc(size); }
+    static void operator delete(void *ptr) { free(ptr); }
+  };
+
+  task() : handle() {}
+  explicit task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+  task(task &&other) : handle(other.handle) { other.handle = nullptr; }
+  task(const task &) = delete;
+  task &operator=(const task &) = delete;
+
+  // Not spawned, the coroutine is freed with its task
+  ~task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  explicit operator bool() const { return (bool)handle; }
+
+ private:
+  friend bool spawn(task &&t);
+  std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Makes the coroutine ready, run by async_run().
+ *
+ * @return false if the coroutine could not be allocated.
+ */
+inline bool spawn(task &&t) {
+  if (!t.handle) {
+    return false;
+  }
+  async_spawn(&t.handle.promise().async);
+  t.handle = nullptr;
+  return true;
+}
+
+/**
+ * Awaits a future, giving its value.
+ */
+struct wait {
+  async_future_t *future;
+
+  explicit wait(async_future_t *future) : future(future) {}
+
+  bool await_ready() const { return async_future_ready(future); }
+  bool await_suspend(std::coroutine_handle<task::promise_type> h) {
+    return !async_await(&h.promise().async, future);
+  }
+  int32_t await_resume() const { return async_future_value(future); }
+};
+
+/**
+ * Lets the other ready tasks run.
+ */
+struct yield {
+  bool await_ready() const { return false; }
+  void await_suspend(std::coroutine_handle<task::promise_type> h) {
+    async_yield(&h.promise().async);
+  }
+  void await_resume() const {}
+};
+
+}  // namespace xheep
+
+#endif  // ASYNC_HPP_
@@ -0,0 +1,202 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "clk_gate.h"
+
+#ifdef CLK_GATE
+
+#include "mmio.h"
+#include "power_manager.h"
+#include "ram_bank.h"
+#include "sync.h"
+
+static struct {
+  uint32_t users[CLK_GATE_DOMAINS];  // Acquires not released yet
+  uint32_t live[MEMORY_BANKS];       // Blocks allocated in each bank
+  uint32_t gatings[CLK_GATE_DOMAINS];
+  uint32_t managed;  // Banks that can be gated
+  uint32_t gated;    // Banks gated
+  uint8_t periph_users[CLK_GATE_MAX_PERIPHS];
+  uint8_t periph_gated;
+  uint8_t external_gated[EXTERNAL_DOMAINS > 0 ? EXTERNAL_DOMAINS : 1];
+} clk;
+
+// Register of the clock gate of a domain
+static uint32_t clk_gate_reg(uint32_t d) {
+  if (d < MEMORY_BANKS) {
+    return power_manager_ram_map[d].clk_gate;
+  }
+  if (d == CLK_GATE_PERIPH_DOMAIN) {
+    return POWER_MANAGER_PERIPH_CLK_GATE_REG_OFFSET;
+  }
+  return power_manager_external_map[d - CLK_GATE_EXTERNAL_DOMAIN(0)].clk_gate;
+}
+
+static int clk_gate_get(uint32_t d) {
+  if (d < MEMORY_BANKS) {
+    return clk.gated >> d & 1;
+  }
+  if (d == CLK_GATE_PERIPH_DOMAIN) {
+    return clk.periph_gated;
+  }
+  return clk.external_gated[d - CLK_GATE_EXTERNAL_DOMAIN(0)];
+}
+
+static void clk_gate_set(uint32_t d, int gated) {
+  if (clk_gate_get(d) == gated) {
+    return;
+  }
+  // The accesses to the domain are done before it is gated
+  if (gated) {
+    sync_fence();
+  }
+  mmio_region_write32(mmio_region_from_addr(POWER_MANAGER_START_ADDRESS),
+                      (ptrdiff_t)clk_gate_reg(d), gated ? 0x1 : 0x0);
+  if (d < MEMORY_BANKS) {
+    clk.gated = gated ? clk.gated | 1u << d : clk.gated & ~(1u << d);
+  } else if (d == CLK_GATE_PERIPH_DOMAIN) {
+    clk.periph_gated = gated;
+  } else {
+    clk.external_gated[d - CLK_GATE_EXTERNAL_DOMAIN(0)] = gated;
+  }
+  if (gated) {
+    clk.gatings[d]++;
+  }
+}
+
+// Gates a domain that has no user, and for banks no block, if it can be
+static void clk_gate_update(uint32_t d) {
+  if (clk.users[d] != 0) {
+    return;
+  }
+  if (d < MEMORY_BANKS && (!(clk.managed >> d & 1) || clk.live[d] != 0)) {
+    return;
+  }
+  clk_gate_set(d, 1);
+}
+
+static void clk_gate_acquire(uint32_t d) {
+  clk.users[d]++;
+  clk_gate_set(d, 0);
+}
+
+static void clk_gate_release(uint32_t d) {
+  if (clk.users[d] == 0) {
+    return;
+  }
+  clk.users[d]--;
+  clk_gate_update(d);
+}
+
+void clk_gate_periph_acquire(uint32_t idx) {
+  if (idx >= CLK_GATE_MAX_PERIPHS) {
+    return;
+  }
+  uint32_t mstatus = sync_irq_save();
+  clk.periph_users[idx]++;
+  clk_gate_acquire(CLK_GATE_PERIPH_DOMAIN);
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_periph_release(uint32_t idx) {
+  if (idx >= CLK_GATE_MAX_PERIPHS) {
+    return;
+  }
+  uint32_t mstatus = sync_irq_save();
+  if (clk.periph_users[idx] != 0) {
+    clk.periph_users[idx]--;
+    clk_gate_release(CLK_GATE_PERIPH_DOMAIN);
+  }
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_external_acquire(uint32_t external) {
+  if (external >= EXTERNAL_DOMAINS) {
+    return;
+  }
+  uint32_t mstatus = sync_irq_save();
+  clk_gate_acquire(CLK_GATE_EXTERNAL_DOMAIN(external));
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_external_release(uint32_t external) {
+  if (external >= EXTERNAL_DOMAINS) {
+    return;
+  }
+  uint32_t mstatus = sync_irq_save();
+  clk_gate_release(CLK_GATE_EXTERNAL_DOMAIN(external));
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_ram_acquire(uint32_t banks) {
+  uint32_t mstatus = sync_irq_save();
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      clk_gate_acquire(d);
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_ram_release(uint32_t banks) {
+  uint32_t mstatus = sync_irq_save();
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      clk_gate_release(d);
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_ram_manage(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_within(ptr, size) & ~ram_banks_in_use();
+  uint32_t mstatus = sync_irq_save();
+  clk.managed |= banks;
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      clk_gate_update(d);
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_ram_alloc(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_of(ptr, size) & clk.managed;
+  if (banks == 0) {
+    return;
+  }
+  uint32_t mstatus = sync_irq_save();
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      clk.live[d]++;
+      clk_gate_set(d, 0);
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+void clk_gate_ram_free(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_of(ptr, size) & clk.managed;
+  if (banks == 0) {
+    return;
+  }
+  uint32_t mstatus = sync_irq_save();
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if ((banks >> d & 1) && clk.live[d] != 0) {
+      clk.live[d]--;
+      clk_gate_update(d);
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+int clk_gate_is_gated(uint32_t domain) {
+  return domain < CLK_GATE_DOMAINS ? clk_gate_get(domain) : 0;
+}
+
+uint32_t clk_gate_gatings(uint32_t domain) {
+  return domain < CLK_GATE_DOMAINS ? clk.gatings[domain] : 0;
+}
+
+#endif  // CLK_GATE
@@ -0,0 +1,166 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef CLK_GATE_H_
+#define CLK_GATE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core_v_mini_mcu.h"
+
+/**
+ * @file
+ * @brief Clock gating of the RAM banks, the peripheral domain and the
+ * external domains, from the use the drivers make of them.
+ *
+ * The drivers count the users of the domain of their peripheral around each
+ * use, so that its clock runs only meanwhile:
+ * - the SPI SDK around each transaction of the SPI hosts of the peripheral
+ *   domain, and around the register writes of its other functions;
+ * - the I2S driver from i2s_init() to i2s_terminate();
+ * - the flash BSP from w25q128jw_init() to w25q128jw_power_down(), when the
+ *   flash is on the SPI host of the peripheral domain;
+ * - the DMA HAL around each transaction, for the banks of its source and
+ *   destination, and for the PLIC when the transaction has windows.
+ *
+ * The RAM banks entirely in a region of the allocator (alloc_region_add())
+ * and out of the program (ram_banks_in_use()) are gated while they hold no
+ * block of alloc_malloc() and no one uses them. The banks keep their content
+ * when gated, but cannot be accessed: such a region must be the only data of
+ * its banks.
+ *
+ * The domain is gated at the release of its last user, ungated at the first
+ * acquire. A program that accesses the other peripherals of the peripheral
+ * domain itself (GPIO, I2C, timers, the PLIC for the interrupts of the
+ * always-on peripherals, ...) acquires them with clk_gate_periph_acquire().
+ *
+ * The gating is only built with CLK_GATE (e.g. `make app CLK_GATE=1`); the
+ * functions compile to nothing otherwise and the clocks stay on. The
+ * functions can be called from interrupt handlers.
+ */
+
+/**
+ * Domain numbers, as in power_policy.h: the RAM banks, then the peripheral
+ * domain, then the external domains.
+ */
+#define CLK_GATE_PERIPH_DOMAIN MEMORY_BANKS
+#define CLK_GATE_EXTERNAL_DOMAIN(i) (MEMORY_BANKS + 1 + (i))
+#define CLK_GATE_DOMAINS (MEMORY_BANKS + 1 + EXTERNAL_DOMAINS)
+
+/**
+ * Largest index of the peripherals plus one, the *_IDX of
+ * core_v_mini_mcu.h.
+ */
+#define CLK_GATE_MAX_PERIPHS 32
+
+/**
+ * Index of no peripheral, e.g. for the always-on peripherals; ignored.
+ */
+#define CLK_GATE_NO_PERIPH 0xFF
+
+#ifdef CLK_GATE
+
+/**
+ * Ungates the peripheral domain until clk_gate_periph_release().
+ *
+ * @param idx Index of the peripheral, e.g. SPI_HOST_IDX.
+ */
+void clk_gate_periph_acquire(uint32_t idx);
+
+/**
+ * Ends a use of clk_gate_periph_acquire(), the domain is gated if it was
+ * the last one.
+ *
+ * @param idx Index of the peripheral.
+ */
+void clk_gate_periph_release(uint32_t idx);
+
+/**
+ * Ungates an external domain until clk_gate_external_release().
+ *
+ * @param external Number of the external domain.
+ */
+void clk_gate_external_acquire(uint32_t external);
+
+/**
+ * Ends a use of clk_gate_external_acquire().
+ *
+ * @param external Number of the external domain.
+ */
+void clk_gate_external_release(uint32_t external);
+
+/**
+ * Ungates RAM banks until clk_gate_ram_release(), e.g. while the DMA
+ * accesses them.
+ *
+ * @param banks Mask of the banks, bit i for bank i (ram_banks_of()).
+ */
+void clk_gate_ram_acquire(uint32_t banks);
+
+/**
+ * Ends a use of clk_gate_ram_acquire().
+ *
+ * @param banks Mask of the banks.
+ */
+void clk_gate_ram_release(uint32_t banks);
+
+/**
+ * Lets the banks entirely in a range be gated when unused, at once if they
+ * are. The banks of the program are left on.
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+void clk_gate_ram_manage(const void *ptr, size_t size);
+
+/**
+ * Marks a block of a range managed by clk_gate_ram_manage() as allocated,
+ * its banks are ungated. Called before the block is accessed.
+ *
+ * @param ptr Start of the block.
+ * @param size Size of the block in bytes.
+ */
+void clk_gate_ram_alloc(const void *ptr, size_t size);
+
+/**
+ * Marks a block of clk_gate_ram_alloc() as freed. Called after the last
+ * access to the block.
+ *
+ * @param ptr Start of the block.
+ * @param size Size of the block in bytes.
+ */
+void clk_gate_ram_free(const void *ptr, size_t size);
+
+/**
+ * Returns whether the clock of a domain is gated.
+ *
+ * @param domain Domain number.
+ */
+int clk_gate_is_gated(uint32_t domain);
+
+/**
+ * Returns the number of times a domain was gated.
+ *
+ * @param domain Domain number.
+ */
+uint32_t clk_gate_gatings(uint32_t domain);
+
+#else
+
+#define clk_gate_periph_acquire(idx) ((void)(idx))
+#define clk_gate_periph_release(idx) ((void)(idx))
+#define clk_gate_external_acquire(external) ((void)(external))
+#define clk_gate_external_release(external) ((void)(external))
+#define clk_gate_ram_acquire(banks) ((void)(banks))
+#define clk_gate_ram_release(banks) ((void)(banks))
+#define clk_gate_ram_manage(ptr, size) ((void)(ptr), (void)(size))
+#define clk_gate_ram_alloc(ptr, size) ((void)(ptr), (void)(size))
+#define clk_gate_ram_free(ptr, size) ((void)(ptr), (void)(size))
+#define clk_gate_is_gated(domain) ((void)(domain), 0)
+#define clk_gate_gatings(domain) ((void)(domain), 0u)
+
+#endif  // CLK_GATE
+
+#endif  // CLK_GATE_H_
@@ -0,0 +1,144 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "clk_scale.h"
+
+#include "core_v_mini_mcu.h"
+#include "mmio.h"
+#include "soc_ctrl.h"
+#include "sync.h"
+
+static struct {
+  const clk_scale_generator_t *generator;
+  clk_scale_client_t *clients;
+} scale;
+
+static soc_ctrl_t clk_scale_soc_ctrl(void) {
+  soc_ctrl_t soc_ctrl;
+  soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+  return soc_ctrl;
+}
+
+// Records the frequency for the drivers and reprograms the clients
+static void clk_scale_update(uint32_t hz) {
+  soc_ctrl_t soc_ctrl = clk_scale_soc_ctrl();
+  soc_ctrl_set_frequency(&soc_ctrl, hz);
+  for (clk_scale_client_t *c = scale.clients; c != NULL; c = c->next) {
+    c->update(c->arg, hz);
+  }
+}
+
+void clk_scale_set_generator(const clk_scale_generator_t *generator) {
+  scale.generator = generator;
+}
+
+void clk_scale_register(clk_scale_client_t *client) {
+  uint32_t mstatus = sync_irq_save();
+  client->next = scale.clients;
+  scale.clients = client;
+  sync_irq_restore(mstatus);
+}
+
+void clk_scale_unregister(clk_scale_client_t *client) {
+  uint32_t mstatus = sync_irq_save();
+  for (clk_scale_client_t **c = &scale.clients; *c != NULL; c = &(*c)->next) {
+    if (*c == client) {
+      *c = client->next;
+      break;
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+uint32_t clk_scale_set_frequency(uint32_t hz) {
+  if (scale.generator == NULL) {
+    return 0;
+  }
+  hz = scale.generator->round(hz);
+  if (hz == 0) {
+    return 0;
+  }
+
+  uint32_t mstatus = sync_irq_save();
+  for (clk_scale_client_t *c = scale.clients; c != NULL; c = c->next) {
+    if (c->prepare != NULL && c->prepare(c->arg, hz) != 0) {
+      sync_irq_restore(mstatus);
+      return 0;
+    }
+  }
+  if (hz != clk_scale_get_frequency()) {
+    scale.generator->set(hz);
+    clk_scale_update(hz);
+  }
+  sync_irq_restore(mstatus);
+  return hz;
+}
+
+void clk_scale_notify(uint32_t hz) {
+  uint32_t mstatus = sync_irq_save();
+  for (clk_scale_client_t *c = scale.clients; c != NULL; c = c->next) {
+    if (c->prepare != NULL) {
+      (void)c->prepare(c->arg, hz);
+    }
+  }
+  clk_scale_update(hz);
+  sync_irq_restore(mstatus);
+}
+
+uint32_t clk_scale_get_frequency(void) {
+  soc_ctrl_t soc_ctrl = clk_scale_soc_ctrl();
+  return soc_ctrl_get_frequency(&soc_ctrl);
+}
+
+// The last character is sent at the old rate, and the new one checked
+static int clk_scale_uart_prepare(void *arg, uint32_t hz) {
+  uart_t *uart = arg;
+  if (uart_check_clk_freq(uart, hz) != kErrorOk) {
+    return -1;
+  }
+  uart_tx_flush(uart);
+  return 0;
+}
+
+static void clk_scale_uart_update(void *arg, uint32_t hz) {
+  (void)uart_set_clk_freq(arg, hz);
+}
+
+clk_scale_client_t *clk_scale_uart_client(clk_scale_client_t *client,
+                                          uart_t *uart) {
+  client->prepare = clk_scale_uart_prepare;
+  client->update = clk_scale_uart_update;
+  client->arg = uart;
+  return client;
+}
+
+static int clk_scale_rv_timer_prepare(void *arg, uint32_t hz) {
+  clk_scale_rv_timer_t *t = arg;
+  rv_timer_tick_params_t params;
+  return rv_timer_approximate_tick_params(hz, t->counter_hz, &params) ==
+                 kRvTimerApproximateTickParamsOk
+             ? 0
+             : -1;
+}
+
+// The counter keeps its value, only its increments change
+static void clk_scale_rv_timer_update(void *arg, uint32_t hz) {
+  clk_scale_rv_timer_t *t = arg;
+  rv_timer_tick_params_t params;
+  if (rv_timer_approximate_tick_params(hz, t->counter_hz, &params) !=
+      kRvTimerApproximateTickParamsOk) {
+    return;
+  }
+  rv_timer_counter_set_enabled(t->timer, t->hart_id, kRvTimerDisabled);
+  rv_timer_set_tick_params(t->timer, t->hart_id, params);
+  rv_timer_counter_set_enabled(t->timer, t->hart_id, kRvTimerEnabled);
+}
+
+clk_scale_client_t *clk_scale_rv_timer_client(clk_scale_client_t *client,
+                                              clk_scale_rv_timer_t *timer) {
+  client->prepare = clk_scale_rv_timer_prepare;
+  client->update = clk_scale_rv_timer_update;
+  client->arg = timer;
+  return client;
+}
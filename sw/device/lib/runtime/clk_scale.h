@@ -0,0 +1,149 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef CLK_SCALE_H_
+#define CLK_SCALE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rv_timer.h"
+#include "uart.h"
+
+/**
+ * @file
+ * @brief Scaling of the system clock at run time, and update of the rates
+ * the peripherals derive from it.
+ *
+ * X-HEEP has no clock generator of its own: the platform (the clocking
+ * wizard of an FPGA, the PLL of an ASIC) gives its control to
+ * clk_scale_set_generator(). clk_scale_set_frequency() then switches the
+ * clock and writes the new frequency to SYSTEM_FREQUENCY_HZ of soc_ctrl,
+ * which the drivers read for their dividers. Around the switch, the clients
+ * given to clk_scale_register() are called:
+ * - prepare() before it, with the new frequency: a client that cannot run at
+ *   it returns nonzero and the clock is not changed, the others make their
+ *   peripheral idle (e.g. send what is in the UART FIFO);
+ * - update() after it, to reprogram the peripheral.
+ *
+ * Clients are provided for a UART (clk_scale_uart_client()), and for an
+ * rv_timer counting at a fixed rate (clk_scale_rv_timer_client()). A FreeRTOS
+ * program keeps the period of its tick by registering the AO timer 0 with
+ * `counter_hz = configCPU_CLOCK_HZ`, the rate the port computes the tick
+ * from. The buffered stdout of syscalls.c registers itself. The SPI SDK
+ * computes its dividers from SYSTEM_FREQUENCY_HZ at each transaction, and the
+ * flash BSP reprograms its own with w25q128jw_update_clock().
+ *
+ * The switch is made with the interrupts disabled, and with no transfer
+ * running on the peripherals that are not clients (e.g. SPI transactions).
+ * The mcycle counts (perf_timer.h, the FreeRTOS run-time statistics) stay in
+ * cycles.
+ */
+
+/**
+ * A peripheral that derives a rate from the system clock.
+ */
+typedef struct clk_scale_client {
+  /**
+   * Called before the switch, NULL if not needed. Returns nonzero if the
+   * peripheral cannot run at the new frequency.
+   */
+  int (*prepare)(void *arg, uint32_t hz);
+  /**
+   * Called after the switch, to reprogram the peripheral.
+   */
+  void (*update)(void *arg, uint32_t hz);
+  void *arg;
+  struct clk_scale_client *next;  // Set by clk_scale_register()
+} clk_scale_client_t;
+
+/**
+ * Control of the clock generator, given by the platform.
+ */
+typedef struct clk_scale_generator {
+  /**
+   * Returns the highest frequency the generator makes not above hz, 0 if
+   * none.
+   */
+  uint32_t (*round)(uint32_t hz);
+  /**
+   * Switches the clock to hz, one of round(), and returns once it is stable.
+   */
+  void (*set)(uint32_t hz);
+} clk_scale_generator_t;
+
+/**
+ * An rv_timer kept counting at a fixed rate.
+ */
+typedef struct clk_scale_rv_timer {
+  const rv_timer_t *timer;
+  uint32_t hart_id;
+  uint64_t counter_hz;  // Rate of the counter
+} clk_scale_rv_timer_t;
+
+/**
+ * Gives the control of the clock generator, NULL for none.
+ *
+ * @param generator Generator, kept by the library.
+ */
+void clk_scale_set_generator(const clk_scale_generator_t *generator);
+
+/**
+ * Adds a client, called at each change of the frequency from now on.
+ *
+ * @param client Client, owned by the library until clk_scale_unregister().
+ */
+void clk_scale_register(clk_scale_client_t *client);
+
+/**
+ * Removes a client of clk_scale_register().
+ *
+ * @param client Client.
+ */
+void clk_scale_unregister(clk_scale_client_t *client);
+
+/**
+ * Switches the system clock to the highest frequency of the generator not
+ * above hz, and updates the clients.
+ *
+ * @param hz Requested frequency in Hz.
+ * @return The new frequency, 0 if there is no generator, it makes no such
+ * frequency or a client cannot run at it (the clock is then unchanged).
+ */
+uint32_t clk_scale_set_frequency(uint32_t hz);
+
+/**
+ * Records a frequency set outside of the library (e.g. by the testbench, or
+ * a generator with no control from the core) and updates the clients. The
+ * prepare() of the clients cannot refuse it.
+ *
+ * @param hz New frequency in Hz.
+ */
+void clk_scale_notify(uint32_t hz);
+
+/**
+ * Returns the current frequency of the system clock, SYSTEM_FREQUENCY_HZ.
+ */
+uint32_t clk_scale_get_frequency(void);
+
+/**
+ * Returns a client that reprograms the baudrate divisor of a UART.
+ *
+ * @param client Client to fill.
+ * @param uart UART, initialized, kept by the client.
+ */
+clk_scale_client_t *clk_scale_uart_client(clk_scale_client_t *client,
+                                          uart_t *uart);
+
+/**
+ * Returns a client that reprograms the prescaler and the step of an rv_timer
+ * so that its counter keeps the rate of timer->counter_hz.
+ *
+ * @param client Client to fill.
+ * @param timer Timer, kept by the client.
+ */
+clk_scale_client_t *clk_scale_rv_timer_client(clk_scale_client_t *client,
+                                              clk_scale_rv_timer_t *timer);
+
+#endif  // CLK_SCALE_H_
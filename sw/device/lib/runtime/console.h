@@ -0,0 +1,38 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+/**
+ * @file
+ * @brief Console of printf, selected at build time with CONSOLE (see
+ * sw/CMakeLists.txt).
+ *
+ * With CONSOLE=uart_buffered (UART_TX_BUFFERED), printf writes to the UART
+ * like the default console until console_buffered_enable() is called, then
+ * copies the strings to a ring buffer of UART_TX_BUFFER_SIZE bytes, drained
+ * by the TX watermark interrupt. The interrupts of the core are left to the
+ * application: printf blocks as before while MSTATUS.MIE or MIE.MEIE is
+ * cleared, e.g. in a handler.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Switches printf to the buffered UART TX mode. It enables the TX watermark
+ * interrupt in the PLIC, so call it after plic_Init(). Does nothing with the
+ * other consoles.
+ *
+ * @return 0 if successful, -1 if the UART or the PLIC could not be set up.
+ */
+int console_buffered_enable(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // CONSOLE_H_
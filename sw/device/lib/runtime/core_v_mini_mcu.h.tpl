@@ -9,11 +9,50 @@
 extern "C" {
 #endif  // __cplusplus
 
+// CPU of the configuration, "cv32e20", "cv32e40p", "cv32e40x" or "cv32e40px"
+#define CPU_TYPE "${cpu_type}"
+// The same for the preprocessor, e.g. CPU_TYPE_CV32E40PX
+#define CPU_TYPE_${cpu_type.upper()}
+
+// Coprocessor on the eXtension Interface with X_EXT=1, "none", "fpu_ss" or
+// "xif_mac", e.g. XIF_COPROCESSOR_XIF_MAC for the preprocessor
+#define XIF_COPROCESSOR "${xif_coprocessor}"
+#define XIF_COPROCESSOR_${xif_coprocessor.upper()}
+
+// Harts of the cluster, hart 0 being the main core
+#define NUM_HARTS ${num_harts}
+
 #define MEMORY_BANKS ${xheep.ram_numbanks()}
 % if xheep.has_il_ram():
 #define HAS_MEMORY_BANKS_IL
 % endif
 
+// RAM banks, indexed like the RAM blocks of the power manager. The banks of an
+// interleaved group all span the whole group, see ram_bank.h.
+% for bank in xheep.iter_ram_banks():
+#define RAM_BANK${bank.name()}_START_ADDRESS ${f"{bank.start_address():#010x}"}
+#define RAM_BANK${bank.name()}_END_ADDRESS ${f"{bank.end_address():#010x}"}
+#define RAM_BANK${bank.name()}_SIZE ${f"{bank.size():#x}"}
+#define RAM_BANK${bank.name()}_IL_LEVEL ${bank.il_level()}
+#define RAM_BANK${bank.name()}_IL_GRANULARITY ${bank.il_granularity()}
+% endfor
+#define RAM_BANK_START_ADDRESSES {${", ".join(f"{bank.start_address():#010x}" for bank in xheep.iter_ram_banks())}}
+#define RAM_BANK_END_ADDRESSES {${", ".join(f"{bank.end_address():#010x}" for bank in xheep.iter_ram_banks())}}
+#define RAM_BANK_IL_LEVELS {${", ".join(str(bank.il_level()) for bank in xheep.iter_ram_banks())}}
+#define RAM_BANK_IL_OFFSETS {${", ".join(str(bank.il_offset()) for bank in xheep.iter_ram_banks())}}
+#define RAM_BANK_IL_SHIFTS {${", ".join(str(bank.il_shift()) for bank in xheep.iter_ram_banks())}}
+
+// Linker sections, data is placed in the named ones with the attribute
+// RAM_SECTION(name) of ram_bank.h
+% for section in xheep.iter_linker_sections():
+#define LINKER_SECTION_${section.name.upper()}_START_ADDRESS ${f"{section.start:#010x}"}
+#define LINKER_SECTION_${section.name.upper()}_END_ADDRESS ${f"{section.end:#010x}"}
+% endfor
+
+// The linker sections other than code and data as X(name, NAME), e.g. for the
+// FreeRTOS heap regions of sw/freertos/heap_regions.h
+#define LINKER_SECTIONS_EXTRA(X) ${"".join(f"X({section.name}, {section.name.upper()}) " for section in xheep.iter_linker_sections() if section.name not in ["code", "data"])}
+
 #define EXTERNAL_DOMAINS ${external_domains}
 
 #define DEBUG_START_ADDRESS 0x${debug_start_address}
@@ -33,6 +72,34 @@ extern "C" {
 
 %endfor
 
+//DMA channels
+#define DMA_CH_NUM ${dma_ch_count}
+#define DMA_CH_SIZE 0x${dma_ch_size}
+
+//DMA trigger slot of each request line, see dma_trigger_slot_mask_t
+#define DMA_TRIGGER_SLOT_NUM ${len(dma_trigger_slots)}
+% for slot in dma_trigger_slots:
+#define DMA_TRIGGER_SLOT_${slot.upper()} ${loop.index}
+% endfor
+
+//Wide port of the DMA into the first interleaved group, see dma.h
+#define DMA_WIDE_LANES ${dma_wide_lanes}
+% if dma_wide_lanes > 1:
+#define DMA_WIDE_START_ADDRESS ${f"{dma_wide_group.start:#010x}"}
+#define DMA_WIDE_END_ADDRESS ${f"{dma_wide_group.start + dma_wide_group.size:#010x}"}
+% endif
+
+//Read cache of the memory-mapped flash
+#define FLASH_CACHE_SIZE 0x${flash_cache_size}
+#define FLASH_CACHE_LINE_SIZE 0x${flash_cache_line_size}
+
+//Instruction buffer of the main core, none with 0 lines
+#define INSTR_BUFFER_LINES ${instr_buffer_lines}
+#define INSTR_BUFFER_LINE_SIZE 0x${instr_buffer_line_size}
+
+//Posted write buffer of the main core towards the peripherals, none with depth 0
+#define POSTED_WRITE_BUFFER_DEPTH ${posted_write_buffer_depth}
+
 //switch-on/off peripherals
 #define PERIPHERAL_START_ADDRESS 0x${peripheral_start_address}
 #define PERIPHERAL_SIZE 0x${peripheral_size_address}
@@ -0,0 +1,108 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "dlog.h"
+
+#include "csr.h"
+
+// Only dlog_write() moves `head` and only dlog_dump() moves `tail`, so the
+// words between them can be sent while records are added.
+static struct {
+  uint32_t *buffer;
+  uint32_t mask;
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  volatile uint32_t dropped;
+} dlog;
+
+int dlog_init(uint32_t *buffer, size_t words) {
+  if (buffer == NULL || words < 2 || (words & (words - 1)) != 0) {
+    return -1;
+  }
+
+  dlog.buffer = buffer;
+  dlog.mask = words - 1;
+  dlog.head = 0;
+  dlog.tail = 0;
+  dlog.dropped = 0;
+
+  // Start mcycle, used for the timestamps
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+  return 0;
+}
+
+void dlog_write(uint32_t id, const uint32_t *args, uint32_t nargs) {
+  if (dlog.buffer == NULL) {
+    return;
+  }
+
+  uint32_t mstatus, cycles;
+  // A record is written with the interrupts disabled, so that the records of
+  // the handlers are not interleaved with it.
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  CSR_READ(CSR_REG_MCYCLE, &cycles);
+
+  uint32_t head = dlog.head;
+  // One word is kept free, so that a full ring can be told from an empty one
+  uint32_t free = (dlog.tail - head - 1) & dlog.mask;
+  if (free < nargs + 2) {
+    dlog.dropped++;
+  } else {
+    dlog.buffer[head] = nargs << 28 | (id & 0x0FFFFFFF);
+    head = (head + 1) & dlog.mask;
+    dlog.buffer[head] = cycles;
+    head = (head + 1) & dlog.mask;
+    for (uint32_t i = 0; i < nargs; i++) {
+      dlog.buffer[head] = args[i];
+      head = (head + 1) & dlog.mask;
+    }
+    dlog.head = head;
+  }
+
+  if (mstatus & 0x8) {
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+}
+
+uint32_t dlog_dropped(void) { return dlog.dropped; }
+
+size_t dlog_dump(size_t (*sink)(void *ctx, const char *data, size_t len),
+                 void *ctx) {
+  size_t sent = 0;
+  uint32_t word;
+
+  word = DLOG_DUMP_MAGIC;
+  sent += sink(ctx, (const char *)&word, sizeof(word));
+
+  uint32_t dropped = dlog.dropped;
+  sent += sink(ctx, (const char *)&dropped, sizeof(dropped));
+
+  if (dlog.buffer != NULL) {
+    // The records added from here on are left for the next dump
+    uint32_t head = dlog.head;
+    uint32_t tail = dlog.tail;
+    if (head < tail) {
+      sent += sink(ctx, (const char *)&dlog.buffer[tail],
+                   (dlog.mask + 1 - tail) * sizeof(uint32_t));
+      tail = 0;
+    }
+    sent += sink(ctx, (const char *)&dlog.buffer[tail],
+                 (head - tail) * sizeof(uint32_t));
+    dlog.tail = head;
+  }
+
+  // Drops counted meanwhile are reported in the next dump
+  uint32_t mstatus;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  dlog.dropped -= dropped;
+  if (mstatus & 0x8) {
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+  }
+
+  word = DLOG_DUMP_END;
+  sent += sink(ctx, (const char *)&word, sizeof(word));
+  return sent;
+}
@@ -0,0 +1,101 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef DLOG_H_
+#define DLOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Deferred logging: DLOG() stores the ID of its format string, a
+ * timestamp and its raw arguments in a RAM ring buffer, without formatting.
+ *
+ * The format strings are placed in the .dlog_fmt section, which the linker
+ * scripts keep in the ELF but do not load, and the ID of a string is its
+ * offset in that section. dlog_dump() sends the records to a sink, e.g.
+ * uart_sink(), and util/dlog_decode.py formats them on the host with the
+ * strings of the ELF.
+ *
+ * Each record is a header word (number of arguments in bits 31:28, ID in
+ * bits 27:0), the mcycle counter and one word per argument.
+ */
+
+/**
+ * Largest number of arguments of DLOG().
+ */
+#define DLOG_MAX_ARGS 8
+
+/**
+ * First word of a dump, "DLOG" in ASCII.
+ */
+#define DLOG_DUMP_MAGIC 0x474F4C44u
+
+/**
+ * Last word of a dump, never a valid record header.
+ */
+#define DLOG_DUMP_END 0xFFFFFFFFu
+
+/**
+ * Store a log record without formatting it.
+ *
+ * The arguments are converted to 32-bit words, so only integer conversions
+ * (%d, %i, %u, %x, %X, %o, %c, with or without length modifiers) can be
+ * used; pointers must be cast to an integer by the caller. The record is
+ * dropped if the ring buffer is full. Can be used in interrupt handlers.
+ *
+ * @param fmt printf-like format string literal.
+ */
+#define DLOG(fmt, ...)                                                       \
+  do {                                                                       \
+    static const char dlog_fmt_[] __attribute__((section(".dlog_fmt"),      \
+                                                 used)) = fmt;               \
+    const uint32_t dlog_args_[] = {0, ##__VA_ARGS__};                        \
+    _Static_assert(sizeof(dlog_args_) / 4 - 1 <= DLOG_MAX_ARGS,              \
+                   "Too many DLOG arguments");                               \
+    dlog_write((uint32_t)(uintptr_t)dlog_fmt_, &dlog_args_[1],               \
+               sizeof(dlog_args_) / 4 - 1);                                  \
+  } while (0)
+
+/**
+ * Start logging to a ring buffer. Also starts the mcycle counter used for
+ * the timestamps.
+ *
+ * @param buffer Ring buffer, owned by the log from now on.
+ * @param words Size of the ring buffer in words, a power of 2.
+ * @return 0 if successful, -1 if the size is not a power of 2.
+ */
+int dlog_init(uint32_t *buffer, size_t words);
+
+/**
+ * Store a record, see DLOG().
+ *
+ * @param id ID of the format string.
+ * @param args Arguments.
+ * @param nargs Number of arguments, up to DLOG_MAX_ARGS.
+ */
+void dlog_write(uint32_t id, const uint32_t *args, uint32_t nargs);
+
+/**
+ * Number of records dropped because the ring buffer was full, since the
+ * last dump.
+ */
+uint32_t dlog_dropped(void);
+
+/**
+ * Send the stored records to a sink and empty the ring buffer.
+ *
+ * The dump is DLOG_DUMP_MAGIC, the number of dropped records, the records
+ * and DLOG_DUMP_END, as little-endian words. The records stored meanwhile
+ * (e.g. by interrupt handlers) are kept for the next dump.
+ *
+ * @param sink Function writing `len` bytes of `data`, e.g. uart_sink().
+ * @param ctx First argument of the sink, e.g. a uart_t.
+ * @return Number of bytes sent.
+ */
+size_t dlog_dump(size_t (*sink)(void *ctx, const char *data, size_t len),
+                 void *ctx);
+
+#endif  // DLOG_H_
@@ -0,0 +1,134 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "fast_memory.h"
+
+#include <stdbool.h>
+
+#include "csr.h"
+#include "dma_sdk.h"
+
+static size_t fast_mem_word_threshold = FAST_MEM_WORD_THRESHOLD;
+static size_t fast_mem_dma_threshold = FAST_MEM_DMA_THRESHOLD;
+
+void fast_mem_set_thresholds(size_t word_threshold, size_t dma_threshold) {
+  fast_mem_word_threshold = word_threshold;
+  fast_mem_dma_threshold = dma_threshold;
+}
+
+// The DMA SDK sleeps until the transfer done interrupt, which can only be
+// served if the interrupts are enabled (i.e. not in a handler).
+static bool fast_mem_use_dma(size_t len) {
+  if (len < fast_mem_dma_threshold) {
+    return false;
+  }
+  uint32_t mstatus;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  return (mstatus & 0x8) != 0;
+}
+
+// The loops below must not be turned back into calls to memcpy and memset by
+// the compiler, as these may be wrapped to the functions of this file.
+__attribute__((optimize("no-tree-loop-distribute-patterns"))) void *
+fast_memcpy(void *dest, const void *src, size_t len) {
+  uint8_t *dest8 = (uint8_t *)dest;
+  const uint8_t *src8 = (const uint8_t *)src;
+
+  if (fast_mem_use_dma(len)) {
+    // Align the destination, the DMA then copies words if the source is
+    // aligned too, and half-words or bytes otherwise.
+    while ((uintptr_t)dest8 & 0x3) {
+      *dest8++ = *src8++;
+      len--;
+    }
+    dma_data_type_t type;
+    if (((uintptr_t)src8 & 0x3) == 0) {
+      type = DMA_DATA_TYPE_WORD;
+    } else if (((uintptr_t)src8 & 0x1) == 0) {
+      type = DMA_DATA_TYPE_HALF_WORD;
+    } else {
+      type = DMA_DATA_TYPE_BYTE;
+    }
+    if (dma_copy(dest8, src8, len, type) == 0) {
+      return dest;
+    }
+    // The copy is done by the CPU if the DMA refused it.
+  }
+
+  if (len >= fast_mem_word_threshold &&
+      (((uintptr_t)dest8 ^ (uintptr_t)src8) & 0x3) == 0) {
+    while ((uintptr_t)dest8 & 0x3) {
+      *dest8++ = *src8++;
+      len--;
+    }
+    uint32_t *dest32 = (uint32_t *)dest8;
+    const uint32_t *src32 = (const uint32_t *)src8;
+    for (; len >= 16; len -= 16) {
+      dest32[0] = src32[0];
+      dest32[1] = src32[1];
+      dest32[2] = src32[2];
+      dest32[3] = src32[3];
+      dest32 += 4;
+      src32 += 4;
+    }
+    for (; len >= 4; len -= 4) {
+      *dest32++ = *src32++;
+    }
+    dest8 = (uint8_t *)dest32;
+    src8 = (const uint8_t *)src32;
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    dest8[i] = src8[i];
+  }
+  return dest;
+}
+
+__attribute__((optimize("no-tree-loop-distribute-patterns"))) void *
+fast_memset(void *dest, int value, size_t len) {
+  uint8_t *dest8 = (uint8_t *)dest;
+  uint8_t value8 = (uint8_t)value;
+  uint32_t value32 = value8 * 0x01010101u;
+
+  if (len >= fast_mem_word_threshold || fast_mem_use_dma(len)) {
+    while ((uintptr_t)dest8 & 0x3) {
+      *dest8++ = value8;
+      len--;
+    }
+    uint32_t *dest32 = (uint32_t *)dest8;
+    if (fast_mem_use_dma(len)) {
+      dma_fill(dest32, &value32, len >> 2);
+      dest32 += len >> 2;
+      len &= 0x3;
+    }
+    for (; len >= 16; len -= 16) {
+      dest32[0] = value32;
+      dest32[1] = value32;
+      dest32[2] = value32;
+      dest32[3] = value32;
+      dest32 += 4;
+    }
+    for (; len >= 4; len -= 4) {
+      *dest32++ = value32;
+    }
+    dest8 = (uint8_t *)dest32;
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    dest8[i] = value8;
+  }
+  return dest;
+}
+
+#ifdef FAST_MEMCPY
+// Called instead of memcpy and memset when linked with --wrap=memcpy and
+// --wrap=memset (see FAST_MEMCPY in sw/CMakeLists.txt).
+void *__wrap_memcpy(void *dest, const void *src, size_t len) {
+  return fast_memcpy(dest, src, len);
+}
+
+void *__wrap_memset(void *dest, int value, size_t len) {
+  return fast_memset(dest, value, len);
+}
+#endif  // FAST_MEMCPY
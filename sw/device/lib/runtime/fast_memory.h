@@ -0,0 +1,71 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef FAST_MEMORY_H_
+#define FAST_MEMORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Size-dependent memcpy and memset: byte loops for tiny sizes,
+ * unrolled word loops for medium sizes and the DMA for large sizes.
+ *
+ * Building with FAST_MEMCPY=1 routes the libc memcpy and memset through them,
+ * with the --wrap option of the linker.
+ */
+
+/**
+ * Smallest size, in bytes, copied or set by words instead of bytes.
+ * Can be overridden at compile time or with fast_mem_set_thresholds().
+ */
+#ifndef FAST_MEM_WORD_THRESHOLD
+#define FAST_MEM_WORD_THRESHOLD 16
+#endif
+
+/**
+ * Smallest size, in bytes, copied or set by the DMA.
+ * Can be overridden at compile time or with fast_mem_set_thresholds().
+ */
+#ifndef FAST_MEM_DMA_THRESHOLD
+#define FAST_MEM_DMA_THRESHOLD 512
+#endif
+
+/**
+ * Changes the sizes at which the word loops and the DMA are used.
+ *
+ * @param word_threshold Smallest size, in bytes, handled by words.
+ * @param dma_threshold Smallest size, in bytes, handled by the DMA. SIZE_MAX
+ * never uses the DMA.
+ */
+void fast_mem_set_thresholds(size_t word_threshold, size_t dma_threshold);
+
+/**
+ * Copies `len` bytes from `src` to `dest`, which must not overlap.
+ *
+ * The DMA is only used when the interrupts are enabled, as it sleeps until
+ * the transfer is done, so the function is also safe in interrupt handlers.
+ *
+ * @param dest Destination address.
+ * @param src Source address.
+ * @param len Number of bytes to copy.
+ * @return `dest`.
+ */
+void *fast_memcpy(void *dest, const void *src, size_t len);
+
+/**
+ * Sets `len` bytes from `dest` to the byte `value`.
+ *
+ * The DMA is only used when the interrupts are enabled, as for
+ * fast_memcpy().
+ *
+ * @param dest Destination address.
+ * @param value Byte written, converted to `uint8_t`.
+ * @param len Number of bytes to set.
+ * @return `dest`.
+ */
+void *fast_memset(void *dest, int value, size_t len);
+
+#endif  // FAST_MEMORY_H_
@@ -0,0 +1,59 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "gcov_dump.h"
+
+#ifdef PGO_GENERATE
+
+#include <gcov.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Provided by the linker scripts around the .gcov_info input sections
+extern const struct gcov_info *const __gcov_info_start[];
+extern const struct gcov_info *const __gcov_info_end[];
+
+gcov_dump_t gcov_dump;
+
+// The dump itself is not instrumented, its counters would change while they are written
+#define GCOV_DUMP_FUNC __attribute__((no_profile_instrument_function))
+
+GCOV_DUMP_FUNC static void gcov_dump_write(const void *data, unsigned length,
+                                           void *arg) {
+  uint32_t room = GCOV_DUMP_SIZE - gcov_dump.length;
+  if (gcov_dump.overflow || length > room) {
+    gcov_dump.overflow += length;
+    return;
+  }
+  memcpy(&gcov_dump.data[gcov_dump.length], data, length);
+  gcov_dump.length += length;
+}
+
+GCOV_DUMP_FUNC static void gcov_dump_filename(const char *filename, void *arg) {
+  __gcov_filename_to_gcfn(filename, gcov_dump_write, arg);
+}
+
+GCOV_DUMP_FUNC static void *gcov_dump_allocate(unsigned length, void *arg) {
+  return malloc(length);
+}
+
+GCOV_DUMP_FUNC __attribute__((destructor)) static void gcov_dump_at_exit(void) {
+  const struct gcov_info *const *info = __gcov_info_start;
+  const struct gcov_info *const *end = __gcov_info_end;
+
+  // Keeps the compiler from assuming that the two symbols are different arrays
+  __asm__("" : "+r"(info));
+
+  gcov_dump.length = 0;
+  gcov_dump.overflow = 0;
+  gcov_dump.objects = 0;
+  for (; info != end; info++) {
+    __gcov_info_to_gcda(*info, gcov_dump_filename, gcov_dump_write,
+                        gcov_dump_allocate, NULL);
+    gcov_dump.objects++;
+  }
+  gcov_dump.magic = GCOV_DUMP_MAGIC;
+}
+
+#endif  // PGO_GENERATE
@@ -0,0 +1,56 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef GCOV_DUMP_H_
+#define GCOV_DUMP_H_
+
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Edge counters of an application built with `make app PGO=generate`,
+ * dumped to RAM at exit for the profile-guided optimisation of util/app_pgo.py.
+ *
+ * The instrumented objects are compiled with -fprofile-info-section, so they
+ * do not register themselves with libgcov and no file is ever opened: their
+ * gcov_info are gathered by the linker scripts between __gcov_info_start and
+ * __gcov_info_end. At the exit of the program, a destructor serialises them
+ * with __gcov_info_to_gcda() into the gcov_dump buffer, in the stream format
+ * of `gcov-tool merge-stream`. The testharness copies the buffer to a file
+ * with +mem_dump=<file>, and gcov-tool turns it into the .gcda files that
+ * `make app PGO=use` reads.
+ *
+ * The dump is only built with PGO_GENERATE (GCC 13 or later, for
+ * __gcov_filename_to_gcfn() and gcov-tool merge-stream), otherwise
+ * gcov_dump.c is empty.
+ */
+
+/**
+ * Bytes of the gcov stream kept in RAM, the rest is counted in overflow.
+ */
+#ifndef GCOV_DUMP_SIZE
+#define GCOV_DUMP_SIZE 16384
+#endif
+
+/**
+ * Written in magic once the whole stream is in the buffer ("GCDP").
+ */
+#define GCOV_DUMP_MAGIC 0x50444347
+
+/**
+ * The buffer read by the testharness at exit.
+ */
+typedef struct gcov_dump {
+  uint32_t magic;                /*!< GCOV_DUMP_MAGIC when complete. */
+  uint32_t length;               /*!< Bytes of the stream in data. */
+  uint32_t overflow;             /*!< Bytes that did not fit in data. */
+  uint32_t objects;              /*!< Number of instrumented objects. */
+  uint8_t data[GCOV_DUMP_SIZE];  /*!< The gcov stream. */
+} gcov_dump_t;
+
+#ifdef PGO_GENERATE
+extern gcov_dump_t gcov_dump;
+#endif
+
+#endif  // GCOV_DUMP_H_
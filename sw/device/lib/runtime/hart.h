@@ -6,6 +6,7 @@
 #define OPENTITAN_SW_DEVICE_LIB_RUNTIME_HART_H_
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdnoreturn.h>
 
 #include "stdasm.h"
@@ -24,4 +25,14 @@
  */
 inline void wait_for_interrupt(void) { asm volatile("wfi"); }
 
+/**
+ * Returns the index of the hart running the code (mhartid), 0 for the main
+ * core and 1 to NUM_HARTS - 1 for the extra harts of the cluster.
+ */
+inline uint32_t hart_id(void) {
+  uint32_t id;
+  asm volatile("csrr %0, mhartid" : "=r"(id));
+  return id;
+}
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_RUNTIME_HART_H_
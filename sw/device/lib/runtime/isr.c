@@ -0,0 +1,23 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "isr.h"
+
+// Every line at the default level, above the main program only
+uint32_t isr_preempt[ISR_LEVELS] = {0xffffffff};
+uint8_t isr_level[32] = {[0 ... 31] = ISR_LEVEL_DEFAULT};
+
+void isr_set_level(uint32_t irq, uint32_t level) {
+  if (irq > 31 || level >= ISR_LEVELS) {
+    return;
+  }
+  isr_level[irq] = level;
+  for (uint32_t l = 0; l < ISR_LEVELS; l++) {
+    if (level > l) {
+      isr_preempt[l] |= 1u << irq;
+    } else {
+      isr_preempt[l] &= ~(1u << irq);
+    }
+  }
+}
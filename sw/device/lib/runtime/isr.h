@@ -0,0 +1,182 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef ISR_H_
+#define ISR_H_
+
+#include <stdint.h>
+
+#include "csr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * @file
+ * @brief Interrupt handlers with a shorter entry, and nested interrupts with
+ * priority levels.
+ *
+ * The vector table jumps straight to `handler_irq_fast_<source>` of
+ * fast_intr_ctrl.c, which clears the pending bit and calls `fic_irq_<source>`.
+ * As the handler calls functions, the compiler saves every caller-saved
+ * register at its entry and restores them at its exit. The handlers of
+ * fast_intr_ctrl.c are weak, so an application replaces the one of a
+ * hard-real-time source with:
+ *
+ * - a leaf handler, ISR_LEAF_HANDLER(), which calls no function, so that the
+ *   compiler only saves the registers it uses. The pending bits are cleared
+ *   with the inline functions of the drivers, e.g.
+ *   clear_fast_interrupt_inline():
+ *
+ *       ISR_LEAF_HANDLER(handler_irq_fast_gpio_1) {
+ *         *(volatile uint32_t *)(GPIO_AO_START_ADDRESS +
+ *                                GPIO_INTRPT_STATUS_REG_OFFSET) = 1 << 1;
+ *         clear_fast_interrupt_inline(kGpio_1_fic_e);
+ *         events++;
+ *       }
+ *
+ * - a naked handler, ISR_NAKED_HANDLER(), made of basic asm only, which saves
+ *   what it uses and returns with mret.
+ *
+ * - a nested handler, ISR_NESTED_HANDLER(), which runs with the interrupts
+ *   enabled and is preempted by the sources of a higher level. The core has no
+ *   level of its own for the CLINT and fast lines (the CLIC of the CPUs is not
+ *   connected), so the levels are kept in software, like the levels of a CLIC:
+ *   the lines at or below the level of the handler are masked in MIE while it
+ *   runs. The PLIC keeps its own priorities; with IRQ_NESTED=1 the PLIC
+ *   handler raises its threshold to the source it serves and is nested the
+ *   same way.
+ *
+ * The lines are numbered as their bit in MIE and their code in MCAUSE.
+ */
+
+/** Number of interrupt levels, as the priorities of the PLIC. */
+#define ISR_LEVELS 8
+
+/** Level of every line after reset, preempting the main program only. */
+#define ISR_LEVEL_DEFAULT 1
+
+#define ISR_IRQ_SOFTWARE 3
+#define ISR_IRQ_TIMER 7
+#define ISR_IRQ_EXTERNAL 11
+/** Line of a fast interrupt, fast_intr_ctrl_fast_interrupt_t. */
+#define ISR_IRQ_FAST(fic) (16 + (fic))
+
+/** ABI of the first function entered from the vector table. */
+#define ISR_ABI __attribute__((aligned(4), interrupt))
+
+/**
+ * Defines a handler that must not call any function, so that its entry and
+ * exit only save and restore the registers it uses.
+ */
+#define ISR_LEAF_HANDLER(handler) ISR_ABI void handler(void)
+
+/**
+ * Defines a handler with no prologue nor epilogue, of basic asm only, which
+ * must save the registers it uses and end with mret.
+ */
+#define ISR_NAKED_HANDLER(handler) \
+  __attribute__((aligned(4), naked)) void handler(void)
+
+/**
+ * Lines preempting each level: bit `irq` of `isr_preempt[level]` is set if
+ * the line is above the level.
+ */
+extern uint32_t isr_preempt[ISR_LEVELS];
+
+/** Level of each line. */
+extern uint8_t isr_level[32];
+
+/**
+ * Return of nested code to the code it preempted.
+ */
+typedef struct isr_nest {
+  uint32_t mepc;
+  uint32_t mstatus;
+  uint32_t masked;
+} isr_nest_t;
+
+/**
+ * Sets the level of a line, which only preempts the handlers of lower lines.
+ *
+ * @param irq The line.
+ * @param level 1 to ISR_LEVELS - 1; 0 never preempts.
+ */
+void isr_set_level(uint32_t irq, uint32_t level);
+
+/**
+ * Masks the lines at or below a level, like the threshold of a CLIC, e.g.
+ * around a section of the main program that the lower handlers cannot
+ * preempt.
+ *
+ * @return The lines masked, to be given to isr_restore().
+ */
+static inline uint32_t isr_raise(uint32_t level) {
+  uint32_t mie;
+  CSR_READ(CSR_REG_MIE, &mie);
+  uint32_t masked = mie & ~isr_preempt[level];
+  CSR_CLEAR_BITS(CSR_REG_MIE, masked);
+  return masked;
+}
+
+/**
+ * Unmasks the lines of isr_raise().
+ */
+static inline void isr_restore(uint32_t masked) {
+  CSR_SET_BITS(CSR_REG_MIE, masked);
+}
+
+/**
+ * Enables the interrupts in a handler and keeps only the lines above a level,
+ * its own line included in the masked ones. The lines of `keep` stay enabled.
+ */
+static inline void isr_nest_enter(isr_nest_t *nest, uint32_t level,
+                                  uint32_t keep) {
+  // A nested trap overwrites mepc and mstatus
+  CSR_READ(CSR_REG_MEPC, &nest->mepc);
+  CSR_READ(CSR_REG_MSTATUS, &nest->mstatus);
+  uint32_t mie;
+  CSR_READ(CSR_REG_MIE, &mie);
+  nest->masked = mie & ~isr_preempt[level] & ~keep;
+  CSR_CLEAR_BITS(CSR_REG_MIE, nest->masked);
+  CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+}
+
+/**
+ * Disables the interrupts and restores the handler of isr_nest_enter() before
+ * its return.
+ */
+static inline void isr_nest_exit(const isr_nest_t *nest) {
+  CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+  CSR_SET_BITS(CSR_REG_MIE, nest->masked);
+  CSR_WRITE(CSR_REG_MEPC, nest->mepc);
+  CSR_WRITE(CSR_REG_MSTATUS, nest->mstatus);
+}
+
+/**
+ * Defines a handler of the line `irq`, whose body runs with the lines above
+ * its level enabled. The body must clear the pending bit of its source before
+ * it returns.
+ *
+ *     ISR_NESTED_HANDLER(handler_irq_fast_spi, ISR_IRQ_FAST(kSpi_fic_e)) {
+ *       fic_irq_spi();
+ *       clear_fast_interrupt_inline(kSpi_fic_e);
+ *     }
+ */
+#define ISR_NESTED_HANDLER(handler, irq)                  \
+  static void handler##_nested(void);                     \
+  ISR_ABI void handler(void) {                            \
+    isr_nest_t nest;                                      \
+    isr_nest_enter(&nest, isr_level[(irq)], 0);           \
+    handler##_nested();                                   \
+    isr_nest_exit(&nest);                                 \
+  }                                                       \
+  static void handler##_nested(void)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // ISR_H_
@@ -0,0 +1,45 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "mem_watermark.h"
+
+#ifdef MEM_WATERMARK
+
+#include <stdio.h>
+
+extern uint32_t __stack_start[];
+extern uint32_t __stack_end[];
+extern uint32_t __heap_start[];
+extern uint32_t __heap_end[];
+
+mem_watermark_t mem_watermark_stack(void) {
+  mem_watermark_t region = {0, (uint32_t)((char *)__stack_end - (char *)__stack_start)};
+  const uint32_t *word = __stack_start;
+
+  while (word < __stack_end && *word == MEM_WATERMARK_PATTERN) word++;
+  region.peak = (uint32_t)((char *)__stack_end - (char *)word);
+  return region;
+}
+
+mem_watermark_t mem_watermark_heap(void) {
+  mem_watermark_t region = {0, (uint32_t)((char *)__heap_end - (char *)__heap_start)};
+  const uint32_t *word = __heap_end;
+
+  while (word > __heap_start && word[-1] == MEM_WATERMARK_PATTERN) word--;
+  region.peak = (uint32_t)((char *)word - (char *)__heap_start);
+  return region;
+}
+
+__attribute__((weak)) void mem_watermark_tasks(void) {}
+
+__attribute__((destructor)) static void mem_watermark_at_exit(void) {
+  mem_watermark_t stack = mem_watermark_stack();
+  mem_watermark_t heap = mem_watermark_heap();
+
+  printf("MEM stack %lu %lu\n", (unsigned long)stack.peak, (unsigned long)stack.size);
+  printf("MEM heap %lu %lu\n", (unsigned long)heap.peak, (unsigned long)heap.size);
+  mem_watermark_tasks();
+}
+
+#endif  // MEM_WATERMARK
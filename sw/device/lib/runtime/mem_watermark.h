@@ -0,0 +1,76 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef MEM_WATERMARK_H_
+#define MEM_WATERMARK_H_
+
+/**
+ * @file
+ * @brief Peak use of the stack and of the heap of the linker script, to size
+ * stack_size and heap_size of mcu_cfg.hjson from a run.
+ *
+ * With MEM_WATERMARK (e.g. `make app MEM_WATERMARK=1`), crt0 fills the heap
+ * and the free part of the stack with MEM_WATERMARK_PATTERN before the
+ * constructors. The stack grows down from __stack_end, so its peak use is
+ * counted from __stack_end to the lowest word that no longer holds the
+ * pattern; the heap grows up from __heap_start, so its peak use is counted
+ * from __heap_start to the highest such word. When the program exits, a
+ * destructor prints one line per region:
+ *
+ *   MEM stack <peak bytes> <size bytes>
+ *   MEM heap <peak bytes> <size bytes>
+ *
+ * followed by the lines of mem_watermark_tasks(), which the FreeRTOS
+ * applications get from sw/freertos/port_watermark.c:
+ *
+ *   MEM task <peak bytes> <size bytes> <name>
+ *   MEM rtos_heap <peak bytes> <size bytes> <region>
+ *
+ * A word written with the pattern itself is taken as unused, so the peaks
+ * may be short by a few words: keep a margin when shrinking the regions. The
+ * stack of the interrupts of FreeRTOS is the stack of the linker script.
+ *
+ * Without MEM_WATERMARK, nothing is filled and mem_watermark.c is empty.
+ */
+
+/**
+ * Fill word, the fill byte of the FreeRTOS task stacks.
+ */
+#define MEM_WATERMARK_PATTERN 0xa5a5a5a5
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+/**
+ * Peak use of a region.
+ */
+typedef struct mem_watermark {
+  uint32_t peak;  /*!< Bytes used at the peak. */
+  uint32_t size;  /*!< Bytes of the region. */
+} mem_watermark_t;
+
+/**
+ * Scans the stack of the linker script, at any time of the program.
+ *
+ * @return Peak use of the stack since crt0.
+ */
+mem_watermark_t mem_watermark_stack(void);
+
+/**
+ * Scans the heap of the linker script, at any time of the program.
+ *
+ * @return Peak use of the heap since crt0.
+ */
+mem_watermark_t mem_watermark_heap(void);
+
+/**
+ * Prints the MEM lines of the regions that the runtime does not know, after
+ * the stack and the heap at exit. The weak definition prints nothing.
+ */
+void mem_watermark_tasks(void);
+
+#endif  // __ASSEMBLER__
+
+#endif  // MEM_WATERMARK_H_
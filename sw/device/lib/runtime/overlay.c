@@ -0,0 +1,78 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "overlay.h"
+
+#include "core_v_mini_mcu.h"
+#include "csr.h"
+#include "dma_sdk.h"
+#include "soc_ctrl.h"
+
+// From the linker script, only in link_flash_exec.ld: the flash start, the
+// flash end and the RAM start of each overlay
+extern const uint32_t __overlay_table[] __attribute__((weak));
+
+// Overlay in each region, -1 for none
+static int32_t overlay_resident[OVERLAY_REGIONS] = {-1, -1};
+
+static overlay_stats_t overlay_stats;
+
+bool overlay_load(uint32_t n) {
+  if (n >= OVERLAY_NUM || __overlay_table == NULL) {
+    return false;
+  }
+
+  uint32_t region = n / OVERLAYS_PER_REGION;
+  if (overlay_resident[region] == (int32_t)n) {
+    overlay_stats.hits++;
+    return false;
+  }
+
+  uint32_t *src = (uint32_t *)__overlay_table[3 * n];
+  uint32_t size = __overlay_table[3 * n + 1] - __overlay_table[3 * n];
+  uint32_t *dst = (uint32_t *)__overlay_table[3 * n + 2];
+  uint32_t start, end;
+
+  CSR_READ(CSR_REG_MCYCLE, &start);
+  if (size > 0) {
+    // The sections are word-aligned
+    dma_copy_32b(dst, src, size >> 2);
+  }
+  // The fetches after the copy see the new code, neither the core nor the
+  // instruction buffer keep the previous overlay
+  asm volatile("fence.i" ::: "memory");
+#if INSTR_BUFFER_LINES > 0
+  soc_ctrl_t soc_ctrl;
+  soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+  soc_ctrl_instr_buffer_clear(&soc_ctrl);
+#endif
+  CSR_READ(CSR_REG_MCYCLE, &end);
+
+  overlay_resident[region] = (int32_t)n;
+  overlay_stats.loads++;
+  overlay_stats.bytes += size;
+  overlay_stats.load_cycles += end - start;
+  return true;
+}
+
+bool overlay_is_resident(uint32_t n) {
+  if (n >= OVERLAY_NUM) {
+    return false;
+  }
+  return __overlay_table == NULL ||
+         overlay_resident[n / OVERLAYS_PER_REGION] == (int32_t)n;
+}
+
+void overlay_invalidate(void) {
+  for (uint32_t i = 0; i < OVERLAY_REGIONS; i++) {
+    overlay_resident[i] = -1;
+  }
+}
+
+void overlay_get_stats(overlay_stats_t *stats) { *stats = overlay_stats; }
+
+void overlay_reset_stats(void) {
+  overlay_stats = (overlay_stats_t){0};
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef OVERLAY_H_
+#define OVERLAY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Code overlays loaded from the flash on demand.
+ *
+ * With the flash_exec linker script the code runs from the memory-mapped
+ * flash, and RAM_FUNC (see ram_func.h) moves hot functions to RAM for the
+ * whole run, which the RAM must hold at once. Overlays let more code run
+ * from RAM than fits there: the functions marked with OVERLAY(n) are linked
+ * at the RAM address of a region, shared by the overlays of the region, and
+ * stay in the flash until overlay_load() copies them with the DMA, through
+ * the quad-SPI reads of the memory-mapped flash.
+ *
+ * There are OVERLAY_REGIONS regions of OVERLAYS_PER_REGION overlays each,
+ * overlay n being in region n / OVERLAYS_PER_REGION. A region is as large as
+ * its largest overlay, and holds one of them at a time: loading an overlay
+ * evicts the one of its region. Put the functions used together in the same
+ * overlay, and those alternating with them in another region.
+ *
+ * The calls into an overlay go through OVERLAY_CALL(), which loads it when it
+ * is not resident, the stub of the call. The code of an overlay calls the
+ * resident code and the overlays of the other regions only, the linker
+ * rejects the direct calls between the overlays of a region. The interrupt
+ * handlers do not call overlays, as the overlay may be evicted while they
+ * run.
+ *
+ * With the other linker scripts the whole code is already in RAM or directly
+ * executable, the overlays are linked with the rest of the code and
+ * overlay_load() does nothing.
+ */
+
+/**
+ * Overlays of the flash_exec linker script, see link_flash_exec.ld.tpl.
+ */
+#define OVERLAY_REGIONS 2
+#define OVERLAYS_PER_REGION 4
+#define OVERLAY_NUM (OVERLAY_REGIONS * OVERLAYS_PER_REGION)
+
+/**
+ * Links the function in overlay n, a constant from 0 to OVERLAY_NUM - 1. The
+ * function is never inlined, so that it does not run from its callers.
+ */
+#define OVERLAY(n) __attribute__((section(".overlay" #n), noinline))
+
+/**
+ * Links a constant in overlay n, loaded with its functions.
+ */
+#define OVERLAY_RODATA(n) __attribute__((section(".overlay" #n ".rodata")))
+
+/**
+ * Calls fn, a function of overlay n, after loading the overlay, e.g.
+ * `y = OVERLAY_CALL(2, fir_filter, x, len);`.
+ */
+#define OVERLAY_CALL(n, fn, ...) (overlay_load(n), fn(__VA_ARGS__))
+
+/**
+ * Counters of the overlays since the start or overlay_reset_stats().
+ */
+typedef struct {
+  uint32_t loads;        // Overlays copied from the flash
+  uint32_t hits;         // Calls of overlay_load() on a resident overlay
+  uint32_t bytes;        // Bytes copied
+  uint32_t load_cycles;  // Cycles of the copies, with mcycle
+} overlay_stats_t;
+
+/**
+ * Makes overlay n resident in its region, copying it from the flash with the
+ * DMA if another overlay of the region is there. The core sleeps during the
+ * copy.
+ *
+ * @param n Overlay, from 0 to OVERLAY_NUM - 1
+ * @return true if the overlay was copied, false if it was resident, or out of
+ * range
+ */
+bool overlay_load(uint32_t n);
+
+/**
+ * Checks if overlay n is in its region.
+ */
+bool overlay_is_resident(uint32_t n);
+
+/**
+ * Forgets the overlays in the regions, e.g. after the RAM lost its content in
+ * a sleep. The next overlay_load() of each one copies it again.
+ */
+void overlay_invalidate(void);
+
+/**
+ * Copies the counters of the overlays.
+ */
+void overlay_get_stats(overlay_stats_t *stats);
+
+/**
+ * Clears the counters of the overlays and enables mcycle.
+ */
+void overlay_reset_stats(void);
+
+#endif  // OVERLAY_H_
@@ -0,0 +1,83 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "perf_dump.h"
+
+#ifdef PERF_DUMP
+
+#include <stdio.h>
+
+#include "core_v_mini_mcu.h"
+#include "csr.h"
+#include "perf_timer.h"
+#include "soc_ctrl.h"
+
+perf_dump_t perf_dump;
+
+static uint64_t perf_dump_instret64(void) {
+  uint32_t hi, lo, hi2;
+  do {
+    CSR_READ(CSR_REG_MINSTRETH, &hi);
+    CSR_READ(CSR_REG_MINSTRET, &lo);
+    CSR_READ(CSR_REG_MINSTRETH, &hi2);
+  } while (hi != hi2);
+  return (uint64_t)hi << 32 | lo;
+}
+
+__attribute__((constructor)) static void perf_dump_start(void) {
+  soc_ctrl_t soc_ctrl;
+  soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+  perf_dump.magic = 0;
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x5);
+  perf_dump.mcycle = perf_cycles64();
+  perf_dump.minstret = perf_dump_instret64();
+  soc_ctrl_perf_clear(&soc_ctrl);
+}
+
+__attribute__((destructor)) static void perf_dump_at_exit(void) {
+  soc_ctrl_t soc_ctrl;
+  soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+  soc_ctrl_perf_freeze(&soc_ctrl, true);
+  perf_dump.mcycle = perf_cycles64() - perf_dump.mcycle;
+  perf_dump.minstret = perf_dump_instret64() - perf_dump.minstret;
+
+  perf_dump.masters = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_INFO, SOC_CTRL_PERF_INFO_MASTERS);
+  perf_dump.banks = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_INFO, SOC_CTRL_PERF_INFO_BANKS);
+  if (perf_dump.masters > PERF_DUMP_MAX) perf_dump.masters = PERF_DUMP_MAX;
+  if (perf_dump.banks > PERF_DUMP_MAX) perf_dump.banks = PERF_DUMP_MAX;
+
+  perf_dump.cycles = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_GLOBAL, SOC_CTRL_PERF_GLOBAL_CYCLES);
+  perf_dump.dma_busy = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_GLOBAL, SOC_CTRL_PERF_GLOBAL_DMA_BUSY);
+  perf_dump.core_stall = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_GLOBAL, SOC_CTRL_PERF_GLOBAL_CORE_STALL);
+  for (uint32_t i = 0; i < perf_dump.masters; i++) {
+    perf_dump.master[i][0] = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_REQ_CYCLES, i);
+    perf_dump.master[i][1] = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_GNT, i);
+    perf_dump.master[i][2] = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_RVALID, i);
+  }
+  for (uint32_t i = 0; i < perf_dump.banks; i++) {
+    perf_dump.bank[i][0] = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_BANK_ACCESSES, i);
+    perf_dump.bank[i][1] = soc_ctrl_perf_read(&soc_ctrl, SOC_CTRL_PERF_BANK_CONFLICTS, i);
+  }
+  perf_dump.magic = PERF_DUMP_MAGIC;
+
+  // 64-bit values in hex, for the printf without long long
+  printf("PERF core 0x%08lx%08lx 0x%08lx%08lx\n", (unsigned long)(perf_dump.mcycle >> 32),
+         (unsigned long)perf_dump.mcycle, (unsigned long)(perf_dump.minstret >> 32),
+         (unsigned long)perf_dump.minstret);
+  printf("PERF global %lu %lu %lu\n", (unsigned long)perf_dump.cycles,
+         (unsigned long)perf_dump.dma_busy, (unsigned long)perf_dump.core_stall);
+  for (uint32_t i = 0; i < perf_dump.masters; i++) {
+    printf("PERF master %lu %lu %lu %lu\n", (unsigned long)i, (unsigned long)perf_dump.master[i][0],
+           (unsigned long)perf_dump.master[i][1], (unsigned long)perf_dump.master[i][2]);
+  }
+  for (uint32_t i = 0; i < perf_dump.banks; i++) {
+    printf("PERF bank %lu %lu %lu\n", (unsigned long)i, (unsigned long)perf_dump.bank[i][0],
+           (unsigned long)perf_dump.bank[i][1]);
+  }
+  printf("PERF end\n");
+}
+
+#endif  // PERF_DUMP
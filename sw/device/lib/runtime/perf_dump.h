@@ -0,0 +1,66 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef PERF_DUMP_H_
+#define PERF_DUMP_H_
+
+#include <stdint.h>
+
+/**
+ * @file
+ * @brief Performance counters of an application dumped at its exit, for
+ * util/fpga_perf.py.
+ *
+ * Before main(), a constructor clears the counters of the system crossbar
+ * (see soc_ctrl_perf_read()) and enables mcycle and minstret. When the
+ * program exits, a destructor freezes the crossbar counters and copies them,
+ * with the cycles and instructions of the core since the constructor, to the
+ * perf_dump structure, where the debugger reads them at _exit. It then prints
+ * them, one line per record:
+ *
+ *   PERF core <mcycle> <minstret>            (64-bit, in hex)
+ *   PERF global <cycles> <dma busy cycles> <core stall cycles>
+ *   PERF master <index> <request cycles> <grants> <read responses>
+ *   PERF bank <index> <accesses> <conflict cycles>
+ *   PERF end
+ *
+ * util/fpga_perf.py reads either and writes the JSON file of the simulation
+ * testbench (see perf_counters.json in Simulate.md). The printing itself is
+ * not counted.
+ *
+ * The dump is only built with PERF_DUMP (e.g. `make app PERF_DUMP=1`),
+ * otherwise perf_dump.c is empty.
+ */
+
+/**
+ * Masters and banks with counters, as many as PERF_CTRL.SEL can select.
+ */
+#define PERF_DUMP_MAX 32
+
+/**
+ * Written in magic once the counters are in the structure ("PFDP").
+ */
+#define PERF_DUMP_MAGIC 0x50444650
+
+/**
+ * The counters, read by util/fpga_perf.py at _exit.
+ */
+typedef struct perf_dump {
+  uint64_t mcycle;      /*!< Core cycles since the constructor. */
+  uint64_t minstret;    /*!< Instructions retired since the constructor. */
+  uint32_t magic;       /*!< PERF_DUMP_MAGIC when complete. */
+  uint32_t masters;     /*!< Entries of master. */
+  uint32_t banks;       /*!< Entries of bank. */
+  uint32_t cycles;      /*!< Cycles counted by the crossbar. */
+  uint32_t dma_busy;    /*!< Cycles with a DMA channel busy. */
+  uint32_t core_stall;  /*!< Cycles with a core request waiting. */
+  uint32_t master[PERF_DUMP_MAX][3]; /*!< Request cycles, grants, reads. */
+  uint32_t bank[PERF_DUMP_MAX][2];   /*!< Accesses, conflict cycles. */
+} perf_dump_t;
+
+#ifdef PERF_DUMP
+extern perf_dump_t perf_dump;
+#endif
+
+#endif  // PERF_DUMP_H_
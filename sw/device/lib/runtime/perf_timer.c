@@ -0,0 +1,182 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "perf_timer.h"
+
+#ifdef PERF_TIMER
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  const char *name;
+  uint32_t calls;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+  uint64_t self;
+} perf_section_t;
+
+typedef struct {
+  int8_t slot;     // -1 if the section is not timed
+  uint64_t start;
+  uint64_t nested; // Cycles of the sections nested in it
+} perf_frame_t;
+
+static struct {
+  perf_section_t section[PERF_TIMER_MAX_SECTIONS];
+  uint32_t nsections;
+  perf_frame_t stack[PERF_TIMER_MAX_DEPTH];
+  uint32_t depth;
+  uint32_t hidden;     // Open sections deeper than PERF_TIMER_MAX_DEPTH
+  uint32_t overflows;  // Sections not timed, for lack of a slot or depth
+  const rv_timer_t *wall_timer;
+  uint32_t wall_hart;
+  uint64_t wall_start;
+  bool at_exit;
+} perf;
+
+void perf_timer_init(void) {
+  bool at_exit = perf.at_exit;
+  memset(&perf, 0, sizeof(perf));
+  perf.at_exit = at_exit;
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+}
+
+static int8_t perf_slot_of(const char *name) {
+  for (uint32_t i = 0; i < perf.nsections; i++) {
+    if (strcmp(perf.section[i].name, name) == 0) {
+      return i;
+    }
+  }
+  if (perf.nsections == PERF_TIMER_MAX_SECTIONS) {
+    return -1;
+  }
+  perf.section[perf.nsections].name = name;
+  perf.section[perf.nsections].min = UINT32_MAX;
+  return perf.nsections++;
+}
+
+void perf_section_begin(int8_t *slot, const char *name) {
+  if (perf.depth == PERF_TIMER_MAX_DEPTH) {
+    perf.hidden++;
+    perf.overflows++;
+    return;
+  }
+  // The slot of a call site is looked up once, and again after an init
+  if (*slot < 0 || *slot >= (int8_t)perf.nsections ||
+      perf.section[*slot].name != name) {
+    *slot = perf_slot_of(name);
+  }
+  if (*slot < 0) {
+    perf.overflows++;
+  }
+
+  perf_frame_t *frame = &perf.stack[perf.depth++];
+  frame->slot = *slot;
+  frame->nested = 0;
+  // Last, so that the begin itself is not counted
+  frame->start = perf_cycles64();
+}
+
+void perf_section_end(void) {
+  uint64_t now = perf_cycles64();
+  if (perf.hidden > 0) {
+    perf.hidden--;
+    return;
+  }
+  if (perf.depth == 0) {
+    return;
+  }
+
+  perf_frame_t *frame = &perf.stack[--perf.depth];
+  uint64_t elapsed = now - frame->start;
+  if (perf.depth > 0) {
+    perf.stack[perf.depth - 1].nested += elapsed;
+  }
+  if (frame->slot < 0) {
+    return;
+  }
+
+  perf_section_t *s = &perf.section[frame->slot];
+  uint32_t call = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+  s->calls++;
+  s->total += elapsed;
+  s->self += elapsed - frame->nested;
+  if (call < s->min) s->min = call;
+  if (call > s->max) s->max = call;
+}
+
+int perf_timer_wall_init(const rv_timer_t *timer, uint32_t hart_id,
+                         uint64_t clk_hz) {
+  rv_timer_tick_params_t params;
+  if (rv_timer_approximate_tick_params(clk_hz, 1000000, &params) !=
+      kRvTimerApproximateTickParamsOk) {
+    return -1;
+  }
+  rv_timer_counter_set_enabled(timer, hart_id, kRvTimerDisabled);
+  if (rv_timer_set_tick_params(timer, hart_id, params) != kRvTimerOk) {
+    return -1;
+  }
+  rv_timer_counter_set_enabled(timer, hart_id, kRvTimerEnabled);
+
+  perf.wall_timer = timer;
+  perf.wall_hart = hart_id;
+  rv_timer_counter_read(timer, hart_id, &perf.wall_start);
+  return 0;
+}
+
+uint64_t perf_timer_wall_us(void) {
+  uint64_t now;
+  if (perf.wall_timer == NULL ||
+      rv_timer_counter_read(perf.wall_timer, perf.wall_hart, &now) !=
+          kRvTimerOk) {
+    return 0;
+  }
+  return now - perf.wall_start;
+}
+
+// Decimal digits of a 64-bit value, printf of newlib-nano has no %llu
+static const char *perf_u64_str(uint64_t value, char buf[21]) {
+  char *p = &buf[20];
+  *p = '\0';
+  do {
+    *--p = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  return p;
+}
+
+void perf_timer_print(void) {
+  char total[21], self[21], mean[21];
+  printf("%-16s %8s %12s %12s %10s %10s %10s\n\r", "section", "calls",
+         "total", "self", "min", "mean", "max");
+  for (uint32_t i = 0; i < perf.nsections; i++) {
+    const perf_section_t *s = &perf.section[i];
+    if (s->calls == 0) {
+      continue;
+    }
+    printf("%-16s %8u %12s %12s %10u %10s %10u\n\r", s->name, s->calls,
+           perf_u64_str(s->total, total), perf_u64_str(s->self, self), s->min,
+           perf_u64_str(s->total / s->calls, mean), s->max);
+  }
+  if (perf.overflows) {
+    printf("%u sections not timed, raise PERF_TIMER_MAX_SECTIONS or "
+           "PERF_TIMER_MAX_DEPTH\n\r", perf.overflows);
+  }
+  if (perf.wall_timer != NULL) {
+    printf("wall clock: %s us\n\r", perf_u64_str(perf_timer_wall_us(), total));
+  }
+}
+
+void perf_timer_print_at_exit(void) {
+  if (!perf.at_exit) {
+    perf.at_exit = true;
+    atexit(perf_timer_print);
+  }
+}
+
+#endif  // PERF_TIMER
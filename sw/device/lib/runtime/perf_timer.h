@@ -0,0 +1,173 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef PERF_TIMER_H_
+#define PERF_TIMER_H_
+
+#include <stdint.h>
+
+#include "csr.h"
+#include "rv_timer.h"
+
+/**
+ * @file
+ * @brief Cycle timing of code, from the mcycle counter of the core.
+ *
+ * perf_region_start() and perf_region_stop() time a region inline, in a
+ * perf_region_t of the caller. Named sections are opened with
+ * PERF_SECTION_BEGIN() and closed with PERF_SECTION_END(); they can be nested
+ * and the same name can be used in several places. For each name, the number
+ * of calls, the total cycles (nested sections included), the self cycles
+ * (nested sections excluded), and the shortest and longest call are kept.
+ * PERF_TIMER_PRINT_AT_EXIT() prints a summary of the sections at the exit of
+ * the program, with the wall-clock time of the rv_timer given to
+ * PERF_TIMER_WALL_INIT(), if any.
+ *
+ * The timing is only built with PERF_TIMER (e.g. `make app PERF_TIMER=1`);
+ * otherwise the macros expand to nothing, the regions measure 0 and
+ * perf_timer.c is empty. The sections are meant for the main program, not
+ * for interrupt handlers.
+ */
+
+/**
+ * Largest number of names of sections, the others are not timed.
+ */
+#define PERF_TIMER_MAX_SECTIONS 16
+
+/**
+ * Largest nesting of sections, the deeper ones are not timed.
+ */
+#define PERF_TIMER_MAX_DEPTH 8
+
+/**
+ * A region timed inline.
+ */
+typedef struct perf_region {
+  uint64_t start;   /*!< mcycle at the last start. */
+  uint64_t cycles;  /*!< Cycles of all the start/stop pairs. */
+} perf_region_t;
+
+/**
+ * Returns the 64-bit mcycle counter. mcycleh is read before and after
+ * mcycle, so that a carry between the two halves is never seen.
+ */
+static inline uint64_t perf_cycles64(void) {
+  uint32_t hi, lo, hi2;
+  do {
+    CSR_READ(CSR_REG_MCYCLEH, &hi);
+    CSR_READ(CSR_REG_MCYCLE, &lo);
+    CSR_READ(CSR_REG_MCYCLEH, &hi2);
+  } while (hi != hi2);
+  return (uint64_t)hi << 32 | lo;
+}
+
+/**
+ * Start timing a region.
+ *
+ * @param r Region, zero-initialized before its first start.
+ */
+static inline void perf_region_start(perf_region_t *r) {
+#ifdef PERF_TIMER
+  r->start = perf_cycles64();
+#else
+  (void)r;
+#endif
+}
+
+/**
+ * Stop timing a region and add the cycles since its start to it.
+ *
+ * @param r Region.
+ * @return Cycles since the start, 0 without PERF_TIMER.
+ */
+static inline uint64_t perf_region_stop(perf_region_t *r) {
+#ifdef PERF_TIMER
+  uint64_t elapsed = perf_cycles64() - r->start;
+  r->cycles += elapsed;
+  return elapsed;
+#else
+  (void)r;
+  return 0;
+#endif
+}
+
+#ifdef PERF_TIMER
+
+/**
+ * Start mcycle and forget the sections timed so far.
+ */
+#define PERF_TIMER_INIT() perf_timer_init()
+
+/**
+ * Open the section `name`, a string that lives as long as the program.
+ */
+#define PERF_SECTION_BEGIN(name)                    \
+  do {                                              \
+    static int8_t perf_slot_ = -1;                  \
+    perf_section_begin(&perf_slot_, name);          \
+  } while (0)
+
+/**
+ * Close the innermost open section.
+ */
+#define PERF_SECTION_END() perf_section_end()
+
+/**
+ * Count the wall-clock time from now with a counter of an rv_timer, set to
+ * tick every microsecond.
+ *
+ * @param timer rv_timer, initialized.
+ * @param hart_id Counter of the rv_timer to use.
+ * @param clk_hz Clock frequency of the rv_timer.
+ */
+#define PERF_TIMER_WALL_INIT(timer, hart_id, clk_hz) \
+  perf_timer_wall_init(timer, hart_id, clk_hz)
+
+/**
+ * Print the summary of the sections now.
+ */
+#define PERF_TIMER_PRINT() perf_timer_print()
+
+/**
+ * Print the summary of the sections when the program exits.
+ */
+#define PERF_TIMER_PRINT_AT_EXIT() perf_timer_print_at_exit()
+
+void perf_timer_init(void);
+void perf_section_begin(int8_t *slot, const char *name);
+void perf_section_end(void);
+int perf_timer_wall_init(const rv_timer_t *timer, uint32_t hart_id,
+                         uint64_t clk_hz);
+void perf_timer_print(void);
+void perf_timer_print_at_exit(void);
+
+/**
+ * Microseconds since PERF_TIMER_WALL_INIT(), 0 without it.
+ */
+uint64_t perf_timer_wall_us(void);
+
+#else
+
+#define PERF_TIMER_INIT() \
+  do {                    \
+  } while (0)
+#define PERF_SECTION_BEGIN(name) \
+  do {                           \
+  } while (0)
+#define PERF_SECTION_END() \
+  do {                     \
+  } while (0)
+#define PERF_TIMER_WALL_INIT(timer, hart_id, clk_hz) \
+  do {                                               \
+  } while (0)
+#define PERF_TIMER_PRINT() \
+  do {                     \
+  } while (0)
+#define PERF_TIMER_PRINT_AT_EXIT() \
+  do {                             \
+  } while (0)
+
+#endif  // PERF_TIMER
+
+#endif  // PERF_TIMER_H_
@@ -0,0 +1,319 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "power_policy.h"
+
+#include "perf_timer.h"
+#include "ram_bank.h"
+
+typedef struct {
+  power_policy_state_t state;
+  uint32_t users;        // Acquires not released yet
+  uint32_t live;         // Banks only: allocations not freed yet
+  uint64_t idle_since;   // mcycle of the last release
+  uint32_t break_even;
+  uint32_t gatings;
+  power_manager_counters_t counters;
+} power_policy_domain_t;
+
+static struct {
+  const power_manager_t *power_manager;
+  power_policy_domain_t domain[POWER_POLICY_DOMAINS];
+  uint8_t periph_users[POWER_POLICY_MAX_PERIPHS];
+} policy;
+
+// Switches a domain in hardware, through the other state for retention and
+// off
+static void power_policy_gate(uint32_t d, power_policy_state_t from,
+                              power_policy_state_t to,
+                              const power_manager_counters_t *c) {
+  const power_manager_t *pm = policy.power_manager;
+  // The drivers do not change the counters
+  power_manager_counters_t *counters = (power_manager_counters_t *)c;
+
+  if (d < MEMORY_BANKS) {
+    if (from == kPowerPolicyRetention) {
+      power_gate_ram_block(pm, d, kRetOff_e, counters);
+    } else if (from == kPowerPolicyOff) {
+      power_gate_ram_block(pm, d, kOn_e, counters);
+    }
+    if (to == kPowerPolicyRetention) {
+      power_gate_ram_block(pm, d, kRetOn_e, counters);
+    } else if (to == kPowerPolicyOff) {
+      power_gate_ram_block(pm, d, kOff_e, counters);
+    }
+  } else if (d == POWER_POLICY_PERIPH_DOMAIN) {
+    power_gate_periph(pm, to == kPowerPolicyOn ? kOn_e : kOff_e, counters);
+  } else {
+    power_gate_external(pm, d - POWER_POLICY_EXTERNAL_DOMAIN(0),
+                        to == kPowerPolicyOn ? kOn_e : kOff_e, counters);
+  }
+}
+
+static void power_policy_switch(uint32_t d, power_policy_state_t to) {
+  power_policy_domain_t *dom = &policy.domain[d];
+
+  if (dom->state == to) {
+    return;
+  }
+  power_policy_gate(d, dom->state, to, &dom->counters);
+  if (dom->state == kPowerPolicyOn) {
+    dom->gatings++;
+  }
+  dom->state = to;
+}
+
+// Whether the switch of a domain acknowledges off
+static uint32_t power_policy_is_off(uint32_t d) {
+  const power_manager_t *pm = policy.power_manager;
+
+  if (d < MEMORY_BANKS) {
+    return ram_block_power_domain_is_off(pm, d);
+  } else if (d == POWER_POLICY_PERIPH_DOMAIN) {
+    return periph_power_domain_is_off(pm);
+  }
+  return external_power_domain_is_off(pm, d - POWER_POLICY_EXTERNAL_DOMAIN(0));
+}
+
+// Whether the switch, the isolation and the reset of a domain are released
+static uint32_t power_policy_is_on(uint32_t d) {
+  const power_manager_t *pm = policy.power_manager;
+  monitor_signals_t m;
+
+  if (d < MEMORY_BANKS) {
+    m = monitor_power_gate_ram_block(pm, d);
+  } else if (d == POWER_POLICY_PERIPH_DOMAIN) {
+    m = monitor_power_gate_periph(pm);
+  } else {
+    m = monitor_power_gate_external(pm, d - POWER_POLICY_EXTERNAL_DOMAIN(0));
+  }
+  return m.kSwitch_e && m.kIso_e && m.kReset_e;
+}
+
+// Cycles from start until the domain is off (on = 0) or on (on = 1), or -1
+// after the timeout
+static int64_t power_policy_wait(uint32_t d, uint32_t on, uint64_t start) {
+  uint64_t now;
+
+  do {
+    now = perf_cycles64();
+    if (on ? power_policy_is_on(d) : power_policy_is_off(d)) {
+      return now - start;
+    }
+  } while (now - start < POWER_POLICY_MEASURE_TIMEOUT);
+  return -1;
+}
+
+static int power_policy_acquire(uint32_t d) {
+  power_policy_domain_t *dom = &policy.domain[d];
+  int was_off = dom->state == kPowerPolicyOff;
+  dom->users++;
+  power_policy_switch(d, kPowerPolicyOn);
+  return was_off;
+}
+
+static void power_policy_release(uint32_t d) {
+  power_policy_domain_t *dom = &policy.domain[d];
+  if (dom->users == 0) {
+    return;
+  }
+  if (--dom->users == 0) {
+    dom->idle_since = perf_cycles64();
+  }
+}
+
+void power_policy_init(const power_manager_t *power_manager) {
+  uint32_t pinned = ram_banks_in_use();
+
+  // The idle times are counted with mcycle
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+  policy.power_manager = power_manager;
+  uint64_t now = perf_cycles64();
+  for (uint32_t d = 0; d < POWER_POLICY_DOMAINS; d++) {
+    power_policy_domain_t *dom = &policy.domain[d];
+    dom->state = kPowerPolicyOn;
+    dom->users = d < MEMORY_BANKS && (pinned >> d & 1) ? 1 : 0;
+    dom->live = 0;
+    dom->idle_since = now;
+    dom->break_even = POWER_POLICY_DEFAULT_BREAK_EVEN;
+    dom->gatings = 0;
+    power_gate_counters_init(&dom->counters, 30, 30, 30, 30, 30, 30, 30, 30);
+  }
+  for (uint32_t i = 0; i < POWER_POLICY_MAX_PERIPHS; i++) {
+    policy.periph_users[i] = 0;
+  }
+}
+
+int power_policy_set_counters(uint32_t domain,
+                              const power_manager_counters_t *counters) {
+  if (domain >= POWER_POLICY_DOMAINS) {
+    return -1;
+  }
+  policy.domain[domain].counters = *counters;
+  return 0;
+}
+
+int power_policy_set_break_even(uint32_t domain, uint32_t cycles) {
+  if (domain >= POWER_POLICY_DOMAINS) {
+    return -1;
+  }
+  policy.domain[domain].break_even = cycles;
+  return 0;
+}
+
+int power_policy_measure(uint32_t domain, power_policy_state_t state,
+                         const power_manager_counters_t *counters,
+                         power_policy_latency_t *latency) {
+  if (domain >= POWER_POLICY_DOMAINS) {
+    return -1;
+  }
+  power_policy_domain_t *dom = &policy.domain[domain];
+  if (dom->users > 0 || dom->state != kPowerPolicyOn ||
+      (state == kPowerPolicyOff && dom->live > 0) ||
+      (state == kPowerPolicyRetention && domain >= MEMORY_BANKS) ||
+      state == kPowerPolicyOn) {
+    return -1;
+  }
+
+  int64_t entry_cycles, exit_cycles;
+  uint64_t start = perf_cycles64();
+  power_policy_gate(domain, kPowerPolicyOn, state, counters);
+  if (state == kPowerPolicyOff) {
+    entry_cycles = power_policy_wait(domain, 0, start);
+  } else {
+    entry_cycles = perf_cycles64() - start;
+  }
+
+  start = perf_cycles64();
+  power_policy_gate(domain, state, kPowerPolicyOn, counters);
+  if (state == kPowerPolicyOff) {
+    exit_cycles = power_policy_wait(domain, 1, start);
+  } else {
+    exit_cycles = perf_cycles64() - start;
+  }
+  dom->idle_since = perf_cycles64();
+
+  if (entry_cycles < 0 || exit_cycles < 0) {
+    return -1;
+  }
+  latency->entry = (uint32_t)entry_cycles;
+  latency->exit = (uint32_t)exit_cycles;
+  return 0;
+}
+
+int power_policy_calibrate(uint32_t domain, uint32_t switch_energy) {
+  power_policy_latency_t latency;
+
+  if (domain >= POWER_POLICY_DOMAINS ||
+      power_policy_measure(domain, kPowerPolicyOff,
+                           &policy.domain[domain].counters, &latency) != 0) {
+    return -1;
+  }
+  policy.domain[domain].break_even =
+      power_policy_break_even_of(&latency, switch_energy);
+  return 0;
+}
+
+void power_policy_ram_alloc(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_of(ptr, size);
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      policy.domain[d].live++;
+      if (policy.domain[d].state == kPowerPolicyOff) {
+        power_policy_switch(d, kPowerPolicyOn);
+        policy.domain[d].idle_since = perf_cycles64();
+      }
+    }
+  }
+}
+
+void power_policy_ram_free(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_of(ptr, size);
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if ((banks >> d & 1) && policy.domain[d].live > 0) {
+      policy.domain[d].live--;
+    }
+  }
+}
+
+void power_policy_ram_acquire(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_of(ptr, size);
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      power_policy_acquire(d);
+    }
+  }
+}
+
+void power_policy_ram_release(const void *ptr, size_t size) {
+  uint32_t banks = ram_banks_of(ptr, size);
+  for (uint32_t d = 0; d < MEMORY_BANKS; d++) {
+    if (banks >> d & 1) {
+      power_policy_release(d);
+    }
+  }
+}
+
+int power_policy_periph_acquire(uint32_t idx) {
+  if (idx >= POWER_POLICY_MAX_PERIPHS) {
+    return -1;
+  }
+  policy.periph_users[idx]++;
+  return power_policy_acquire(POWER_POLICY_PERIPH_DOMAIN);
+}
+
+void power_policy_periph_release(uint32_t idx) {
+  if (idx >= POWER_POLICY_MAX_PERIPHS || policy.periph_users[idx] == 0) {
+    return;
+  }
+  policy.periph_users[idx]--;
+  power_policy_release(POWER_POLICY_PERIPH_DOMAIN);
+}
+
+int power_policy_external_acquire(uint32_t external) {
+  if (external >= EXTERNAL_DOMAINS) {
+    return -1;
+  }
+  return power_policy_acquire(POWER_POLICY_EXTERNAL_DOMAIN(external));
+}
+
+void power_policy_external_release(uint32_t external) {
+  if (external >= EXTERNAL_DOMAINS) {
+    return;
+  }
+  power_policy_release(POWER_POLICY_EXTERNAL_DOMAIN(external));
+}
+
+uint32_t power_policy_idle(uint64_t expected_idle_cycles) {
+  uint64_t now = perf_cycles64();
+  uint32_t switched = 0;
+
+  for (uint32_t d = 0; d < POWER_POLICY_DOMAINS; d++) {
+    power_policy_domain_t *dom = &policy.domain[d];
+    if (dom->users > 0) {
+      continue;
+    }
+    power_policy_state_t to = dom->live > 0 ? kPowerPolicyRetention
+                                            : kPowerPolicyOff;
+    if (dom->state == to) {
+      continue;
+    }
+    // Switching costs more than it saves below the break-even time
+    if (now - dom->idle_since + expected_idle_cycles < dom->break_even) {
+      continue;
+    }
+    power_policy_switch(d, to);
+    switched++;
+  }
+  return switched;
+}
+
+power_policy_state_t power_policy_state(uint32_t domain) {
+  return domain < POWER_POLICY_DOMAINS ? policy.domain[domain].state
+                                       : kPowerPolicyOff;
+}
+
+uint32_t power_policy_gatings(uint32_t domain) {
+  return domain < POWER_POLICY_DOMAINS ? policy.domain[domain].gatings : 0;
+}
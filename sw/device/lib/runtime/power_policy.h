@@ -0,0 +1,249 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef POWER_POLICY_H_
+#define POWER_POLICY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core_v_mini_mcu.h"
+#include "power_manager.h"
+
+/**
+ * @file
+ * @brief Power states of the RAM banks, the peripheral domain and the
+ * external domains, from their use.
+ *
+ * The program declares what it uses instead of switching the domains:
+ * - power_policy_ram_alloc() and power_policy_ram_free() mark the data of a
+ *   range as live, so that its banks keep it, in retention when not accessed;
+ * - power_policy_ram_acquire() and power_policy_ram_release() mark a range as
+ *   accessed, so that its banks are on;
+ * - power_policy_periph_acquire() and power_policy_periph_release() count the
+ *   users of each peripheral of the peripheral domain (e.g. SPI_HOST_IDX);
+ * - power_policy_external_acquire() and power_policy_external_release() count
+ *   the users of an external domain.
+ *
+ * A domain in use is switched on at once by the acquire. An unused domain is
+ * only switched off (or to retention for banks with live data) by
+ * power_policy_idle(), once it has been unused for long enough: the time
+ * since its last release plus the expected idle time must reach its
+ * break-even time, below which switching costs more than it saves.
+ *
+ * The banks of the program (ram_banks_in_use()) are always on. The other
+ * domains are only on while acquired, so a program that uses the PLIC must
+ * acquire RV_PLIC_IDX. The functions are meant for the main program, not for
+ * interrupt handlers.
+ *
+ * power_policy_measure() times the switching of an unused domain with given
+ * counters, and power_policy_calibrate() sets the break-even time of a domain
+ * from it, see example_power_latency.
+ */
+
+/**
+ * Domain numbers: the RAM banks, then the peripheral domain, then the
+ * external domains.
+ */
+#define POWER_POLICY_PERIPH_DOMAIN MEMORY_BANKS
+#define POWER_POLICY_EXTERNAL_DOMAIN(i) (MEMORY_BANKS + 1 + (i))
+#define POWER_POLICY_DOMAINS (MEMORY_BANKS + 1 + EXTERNAL_DOMAINS)
+
+/**
+ * Largest index of the peripherals plus one, the *_IDX of
+ * core_v_mini_mcu.h.
+ */
+#define POWER_POLICY_MAX_PERIPHS 32
+
+/**
+ * Break-even time of all the domains after power_policy_init(), in cycles.
+ * It depends on the technology; measure it for the target.
+ */
+#define POWER_POLICY_DEFAULT_BREAK_EVEN 10000
+
+/**
+ * Longest wait, in cycles, for a domain to reach a state in
+ * power_policy_measure().
+ */
+#define POWER_POLICY_MEASURE_TIMEOUT 100000
+
+/**
+ * Power state of a domain.
+ */
+typedef enum power_policy_state {
+  kPowerPolicyOn = 0,
+  kPowerPolicyRetention = 1,
+  kPowerPolicyOff = 2,
+} power_policy_state_t;
+
+/**
+ * Latencies of a domain, in cycles of the core.
+ */
+typedef struct power_policy_latency {
+  uint32_t entry;  /*!< From the switch off (or to retention) until done. */
+  uint32_t exit;   /*!< From the switch on until the domain is usable. */
+} power_policy_latency_t;
+
+/**
+ * Starts the policy with all the domains on, the counters of
+ * power_gate_counters_init() at 30 cycles and the default break-even time.
+ *
+ * @param power_manager Power manager, that lives as long as the program.
+ */
+void power_policy_init(const power_manager_t *power_manager);
+
+/**
+ * Sets the counters used to switch a domain.
+ *
+ * @param domain Domain number.
+ * @param counters Counters, copied.
+ * @return 0, or -1 if the domain does not exist.
+ */
+int power_policy_set_counters(uint32_t domain,
+                              const power_manager_counters_t *counters);
+
+/**
+ * Sets the break-even time of a domain.
+ *
+ * @param domain Domain number.
+ * @param cycles Shortest unused time for which the domain is switched.
+ * @return 0, or -1 if the domain does not exist.
+ */
+int power_policy_set_break_even(uint32_t domain, uint32_t cycles);
+
+/**
+ * Switches an unused domain to a state and back on, and times both. Off is
+ * done when the acknowledge of the switch reads off, on when the switch,
+ * the isolation and the reset of the domain are all released. The
+ * retention of the banks has no acknowledge: its latency is the one of the
+ * software. The domain is on at the return.
+ *
+ * @param domain Domain number.
+ * @param state kPowerPolicyOff, or kPowerPolicyRetention for the banks.
+ * @param counters Counters of the switch.
+ * @param latency Measured latencies.
+ * @return 0, or -1 if the domain does not exist, is in use, is not on, holds
+ * live data for kPowerPolicyOff, or does not reach the state within
+ * POWER_POLICY_MEASURE_TIMEOUT cycles.
+ */
+int power_policy_measure(uint32_t domain, power_policy_state_t state,
+                         const power_manager_counters_t *counters,
+                         power_policy_latency_t *latency);
+
+/**
+ * Returns the break-even time of a domain: the shortest idle time for which
+ * switching it off saves energy. The domain must be off for longer than its
+ * latencies, plus the time it takes to leak the energy of a switch off and
+ * on.
+ *
+ * @param latency Latencies of the domain.
+ * @param switch_energy Energy of a switch off and on, in cycles of the
+ * leakage of the domain when on. It depends on the technology and the size
+ * of the domain; 0 gives the shortest idle time the latencies allow.
+ */
+static inline uint32_t power_policy_break_even_of(
+    const power_policy_latency_t *latency, uint32_t switch_energy) {
+  return latency->entry + latency->exit + switch_energy;
+}
+
+/**
+ * Measures a domain off with its counters and sets its break-even time from
+ * it, see power_policy_measure() and power_policy_break_even_of().
+ *
+ * @param domain Domain number.
+ * @param switch_energy Energy of a switch off and on, see
+ * power_policy_break_even_of().
+ * @return 0, or -1 if the domain could not be measured.
+ */
+int power_policy_calibrate(uint32_t domain, uint32_t switch_energy);
+
+/**
+ * Marks the data of a range as live. Its banks are switched on if they are
+ * off, since their content is lost anyway.
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+void power_policy_ram_alloc(const void *ptr, size_t size);
+
+/**
+ * Marks the data of a range as dead, see power_policy_ram_alloc().
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+void power_policy_ram_free(const void *ptr, size_t size);
+
+/**
+ * Switches the banks of a range on until power_policy_ram_release().
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+void power_policy_ram_acquire(const void *ptr, size_t size);
+
+/**
+ * Ends an access of power_policy_ram_acquire().
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+void power_policy_ram_release(const void *ptr, size_t size);
+
+/**
+ * Switches the peripheral domain on until power_policy_periph_release().
+ *
+ * @param idx Index of the peripheral, e.g. SPI_HOST_IDX.
+ * @return 1 if the domain was off, so that its peripherals must be configured
+ * again, 0 if not, or -1 for a bad index.
+ */
+int power_policy_periph_acquire(uint32_t idx);
+
+/**
+ * Ends a use of power_policy_periph_acquire().
+ *
+ * @param idx Index of the peripheral.
+ */
+void power_policy_periph_release(uint32_t idx);
+
+/**
+ * Switches an external domain on until power_policy_external_release().
+ *
+ * @param external Number of the external domain.
+ * @return 1 if the domain was off, 0 if not, or -1 for a bad number.
+ */
+int power_policy_external_acquire(uint32_t external);
+
+/**
+ * Ends a use of power_policy_external_acquire().
+ *
+ * @param external Number of the external domain.
+ */
+void power_policy_external_release(uint32_t external);
+
+/**
+ * Switches the unused domains that reach their break-even time off, or to
+ * retention for the banks with live data. To be called before the core
+ * waits, e.g. with the time until its next timer.
+ *
+ * @param expected_idle_cycles Cycles until the next acquire is expected.
+ * @return Number of domains switched.
+ */
+uint32_t power_policy_idle(uint64_t expected_idle_cycles);
+
+/**
+ * Returns the power state of a domain.
+ *
+ * @param domain Domain number.
+ */
+power_policy_state_t power_policy_state(uint32_t domain);
+
+/**
+ * Returns the number of times a domain left the on state.
+ *
+ * @param domain Domain number.
+ */
+uint32_t power_policy_gatings(uint32_t domain);
+
+#endif  // POWER_POLICY_H_
@@ -0,0 +1,101 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "ram_bank.h"
+
+static const uint32_t ram_bank_start[MEMORY_BANKS] = RAM_BANK_START_ADDRESSES;
+static const uint32_t ram_bank_end[MEMORY_BANKS] = RAM_BANK_END_ADDRESSES;
+static const uint8_t ram_bank_il_level[MEMORY_BANKS] = RAM_BANK_IL_LEVELS;
+static const uint8_t ram_bank_il_offset[MEMORY_BANKS] = RAM_BANK_IL_OFFSETS;
+static const uint8_t ram_bank_il_shift[MEMORY_BANKS] = RAM_BANK_IL_SHIFTS;
+
+// From the linker script, the interleaved, hot and cold sections only exist in
+// link.ld
+extern char __heap_end[];
+extern char __stack_start[];
+extern char __stack_end[];
+extern char __xheep_data_interleaved_start[] __attribute__((weak));
+extern char __xheep_data_interleaved_end[] __attribute__((weak));
+extern char __xheep_hot_start[] __attribute__((weak));
+extern char __xheep_hot_end[] __attribute__((weak));
+extern char __xheep_cold_start[] __attribute__((weak));
+extern char __xheep_cold_end[] __attribute__((weak));
+
+int ram_bank_of(const void *addr) {
+  uint32_t a = (uint32_t)(uintptr_t)addr;
+  for (int i = 0; i < MEMORY_BANKS; i++) {
+    if (a < ram_bank_start[i] || a >= ram_bank_end[i]) {
+      continue;
+    }
+    uint32_t n = 1u << ram_bank_il_level[i];
+    if ((((a - ram_bank_start[i]) >> ram_bank_il_shift[i]) & (n - 1)) ==
+        ram_bank_il_offset[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+uint32_t ram_banks_of(const void *ptr, size_t size) {
+  uint32_t lo = (uint32_t)(uintptr_t)ptr;
+  uint32_t hi = lo + size;
+  uint32_t mask = 0;
+  if (size == 0) {
+    return 0;
+  }
+
+  for (int i = 0; i < MEMORY_BANKS; i++) {
+    uint32_t start = lo > ram_bank_start[i] ? lo : ram_bank_start[i];
+    uint32_t end = hi < ram_bank_end[i] ? hi : ram_bank_end[i];
+    if (start >= end) {
+      continue;
+    }
+    // Blocks of the granularity of the range in the group, the bank holds one
+    // out of n
+    uint32_t n = 1u << ram_bank_il_level[i];
+    uint32_t first = (start - ram_bank_start[i]) >> ram_bank_il_shift[i];
+    uint32_t last = (end - 1 - ram_bank_start[i]) >> ram_bank_il_shift[i];
+    if (((ram_bank_il_offset[i] - first) & (n - 1)) <= last - first) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
+uint32_t ram_banks_within(const void *ptr, size_t size) {
+  uint32_t lo = (uint32_t)(uintptr_t)ptr;
+  uint32_t hi = lo + size;
+  uint32_t mask = 0;
+
+  // The range of a bank of an interleaved group is the one of the group
+  for (int i = 0; i < MEMORY_BANKS; i++) {
+    if (ram_bank_start[i] >= lo && ram_bank_end[i] <= hi) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
+uint32_t ram_banks_in_use(void) {
+  // The code and data sections are contiguous from the start of the RAM,
+  // and the heap is the last of them. The stack follows it or is in the stack
+  // section.
+  uint32_t mask = ram_banks_of((const void *)(uintptr_t)ram_bank_start[0],
+                               (uintptr_t)__heap_end - ram_bank_start[0]);
+  mask |= ram_banks_of(__stack_start, __stack_end - __stack_start);
+  if (__xheep_data_interleaved_start != NULL) {
+    mask |= ram_banks_of(__xheep_data_interleaved_start,
+                         __xheep_data_interleaved_end -
+                             __xheep_data_interleaved_start);
+  }
+  if (__xheep_hot_start != NULL) {
+    mask |= ram_banks_of(__xheep_hot_start,
+                         __xheep_hot_end - __xheep_hot_start);
+  }
+  if (__xheep_cold_start != NULL) {
+    mask |= ram_banks_of(__xheep_cold_start,
+                         __xheep_cold_end - __xheep_cold_start);
+  }
+  return mask;
+}
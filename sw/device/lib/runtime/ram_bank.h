@@ -0,0 +1,90 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef RAM_BANK_H_
+#define RAM_BANK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core_v_mini_mcu.h"
+
+/**
+ * @file
+ * @brief Placement of data in the RAM banks, from the configuration of
+ * mcu_gen.py.
+ *
+ * Data is placed in a linker section of the configuration with
+ * RAM_SECTION(), e.g. a section added with `auto_section: auto` to a group
+ * of banks, or in the interleaved banks with RAM_INTERLEAVED. Placing the
+ * operands of a kernel in different banks lets the bus serve them in
+ * parallel.
+ *
+ * The banks are numbered like the RAM blocks of the power manager, so the
+ * masks of ram_banks_of() and ram_banks_in_use() tell which blocks must be
+ * retained and which can be power-gated with power_gate_ram_block(). The
+ * banks of an interleaved group hold every 2^il_level-th block of the group,
+ * of RAM_BANK<n>_IL_GRANULARITY bytes (a word by default).
+ */
+
+_Static_assert(MEMORY_BANKS <= 32, "The bank masks are 32-bit");
+
+/**
+ * Place a variable in the linker section `name` of the configuration.
+ */
+#define RAM_SECTION(name) __attribute__((section(".xheep_" #name)))
+
+/**
+ * Place a variable in the interleaved banks, if there are any.
+ */
+#ifdef HAS_MEMORY_BANKS_IL
+#define RAM_INTERLEAVED RAM_SECTION(data_interleaved)
+#else
+#define RAM_INTERLEAVED
+#endif
+
+/**
+ * Mask of all the RAM banks.
+ */
+#define RAM_BANKS_ALL \
+  ((uint32_t)(MEMORY_BANKS == 32 ? 0xFFFFFFFF : (1u << MEMORY_BANKS) - 1))
+
+/**
+ * Returns the bank of an address.
+ *
+ * @param addr Address.
+ * @return The index of the bank, or -1 if the address is not in RAM.
+ */
+int ram_bank_of(const void *addr);
+
+/**
+ * Returns the banks holding a range of memory.
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ * @return Mask of the banks, bit i for bank i.
+ */
+uint32_t ram_banks_of(const void *ptr, size_t size);
+
+/**
+ * Returns the banks all of whose words are in a range of memory. The banks of
+ * an interleaved group are only in it with the whole group.
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ * @return Mask of the banks, bit i for bank i.
+ */
+uint32_t ram_banks_within(const void *ptr, size_t size);
+
+/**
+ * Returns the banks holding the program: its code, data, heap and stack, the
+ * hot and cold sections, and the interleaved section. The other sections of the configuration are not
+ * included, use ram_banks_of() on their variables. The remaining banks can be
+ * power-gated.
+ *
+ * @return Mask of the banks, bit i for bank i.
+ */
+uint32_t ram_banks_in_use(void);
+
+#endif  // RAM_BANK_H_
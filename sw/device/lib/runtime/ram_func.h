@@ -0,0 +1,43 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef RAM_FUNC_H_
+#define RAM_FUNC_H_
+
+/**
+ * @file
+ * @brief Placement of hot functions in RAM when the code executes from flash.
+ *
+ * With the flash_exec linker script the code runs from the memory-mapped
+ * flash, and each instruction fetch is a SPI transaction. The functions
+ * marked with RAM_FUNC are instead linked in RAM, and the crt0 copies them
+ * there with the DMA before main. With the other linker scripts the whole
+ * code is already in RAM, and the attribute has no effect.
+ *
+ * Mark interrupt callbacks (e.g. fic_irq_*() or the handlers registered in
+ * the PLIC) and inner loops. The vector table and the interrupt entry
+ * functions of the runtime stay in flash, as the table jumps to them with a
+ * single j instruction, which cannot reach the RAM from the flash.
+ *
+ * The constants are read from the flash as well, each load being a SPI
+ * transaction on a miss of the read cache. The lookup tables and the
+ * coefficients read in the loops (e.g. filter taps) are marked with
+ * RAM_RODATA, or listed in the hot_rodata.ld fragment written by
+ * util/hot_rodata.py from a bus trace, and copied to RAM by the crt0 with the
+ * functions.
+ */
+
+/**
+ * Links the function in RAM. The function is never inlined, so that it does
+ * not run from flash inside its callers.
+ */
+#define RAM_FUNC __attribute__((section(".ram_text"), noinline))
+
+/**
+ * Links a constant in RAM, e.g.
+ * `static const int16_t RAM_RODATA taps[64] = {...};`
+ */
+#define RAM_RODATA __attribute__((section(".ram_rodata")))
+
+#endif  // RAM_FUNC_H_
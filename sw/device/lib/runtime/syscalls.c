@@ -24,6 +24,11 @@
 #include <reent.h>
 #include <errno.h>
 #include "uart.h"
+#include "console.h"
+#include "clk_scale.h"
+#ifdef SIM_CONSOLE
+#include "sim_console.h"
+#endif
 #include "soc_ctrl.h"
 #include "core_v_mini_mcu.h"
 #include "error.h"
@@ -100,8 +105,60 @@ int _execve(const char *name, char *const argv[], char *const env[])
     return -1;
 }
 
+#ifdef UART_TX_BUFFERED
+/* Size of the TX ring buffer of printf, a power of 2 */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 1024
+#endif
+
+static uint8_t uart_tx_buffer[UART_TX_BUFFER_SIZE];
+static uart_t stdout_uart;
+/* Keeps the baudrate of stdout across clk_scale_set_frequency() */
+static clk_scale_client_t stdout_clk_client;
+
+/* The UART is initialized once, re-initializing it would drop the ring */
+static int stdout_uart_init(void)
+{
+    if (stdout_uart.base_addr.base != NULL) {
+        return 0;
+    }
+
+    soc_ctrl_t soc_ctrl;
+    soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
+
+    uart_t uart;
+    uart.base_addr   = mmio_region_from_addr((uintptr_t)UART_START_ADDRESS);
+    uart.baudrate    = UART_BAUDRATE;
+    uart.clk_freq_hz = soc_ctrl_get_frequency(&soc_ctrl);
+    if (uart_init(&uart) != kErrorOk) {
+        return -1;
+    }
+    stdout_uart = uart;
+    clk_scale_register(clk_scale_uart_client(&stdout_clk_client, &stdout_uart));
+    return 0;
+}
+#endif
+
+int console_buffered_enable(void)
+{
+#ifdef UART_TX_BUFFERED
+    if (stdout_uart_init() != 0 ||
+        uart_tx_buffered_enable(&stdout_uart, uart_tx_buffer, UART_TX_BUFFER_SIZE) != kErrorOk) {
+        return -1;
+    }
+#endif
+    return 0;
+}
+
 void _exit(int exit_status)
 {
+#ifdef UART_TX_BUFFERED
+    // Send what printf left in the ring buffer before stopping
+    if (uart_tx_buffered_is_enabled(&stdout_uart)) {
+        uart_tx_flush(&stdout_uart);
+    }
+#endif
+
     soc_ctrl_t soc_ctrl;
     soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
     soc_ctrl_set_exit_value(&soc_ctrl, exit_status);
@@ -247,6 +304,19 @@ ssize_t _write(int file, const void *ptr, size_t len)
         return -1;
     }
 
+#ifdef SIM_CONSOLE
+    // simulation-only console of the testharness, selected with CONSOLE=sim_console
+    sim_console_write((const uint8_t *)ptr, len);
+    return len;
+#elif defined(UART_TX_BUFFERED)
+    // Blocking until console_buffered_enable() is called
+    if (stdout_uart_init() != 0) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    return uart_write(&stdout_uart,(uint8_t *)ptr,len);
+#else
     soc_ctrl_t soc_ctrl;
     soc_ctrl.base_addr = mmio_region_from_addr((uintptr_t)SOC_CTRL_START_ADDRESS);
 
@@ -261,6 +331,7 @@ ssize_t _write(int file, const void *ptr, size_t len)
     }
 
     return uart_write(&uart,(uint8_t *)ptr,len);
+#endif
 
 }
 
@@ -278,14 +349,13 @@ void *_sbrk(ptrdiff_t incr)
 {
     char *old_brk = brk;
 
-    if (__heap_start == __heap_end) {
-        return NULL;
+    // The break was moved twice and never failed, which let malloc hand out
+    // memory past the heap
+    if (incr > __heap_end - brk || incr < __heap_start - brk) {
+        errno = ENOMEM;
+        return (void *)-1;
     }
 
-    if ((brk += incr) < __heap_end) {
-        brk += incr;
-    } else {
-        brk = __heap_end;
-    }
+    brk += incr;
     return old_brk;
 }
@@ -0,0 +1,334 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "timer_service.h"
+
+#include <stddef.h>
+
+#include "csr.h"
+#include "handler.h"
+#include "sync.h"
+
+// Counter and comparator of handler_irq_timer
+#define TS_HART 0
+#define TS_COMP 0
+
+// Bit of the timer interrupt in MIE
+#define MIE_MTIE (1 << 7)
+
+// Lists: the slots of the levels, the timers beyond the last level, and the
+// timers expired and not yet called
+#define TS_FAR (TIMER_SERVICE_LEVELS * TIMER_SERVICE_SLOTS)
+#define TS_EXPIRED (TS_FAR + 1)
+#define TS_LISTS (TS_FAR + 2)
+
+#define TS_SLOT_MASK (TIMER_SERVICE_SLOTS - 1)
+
+// The wheel is also changed by the callbacks, in the interrupt handler, so
+// the other functions change it with the interrupts disabled.
+static struct {
+  const rv_timer_t *timer;
+  uint8_t coalesce;
+  uint64_t now;       // Last slot expired
+  uint64_t armed;     // Counter value of the comparator
+  timer_service_timer_t *list[TS_LISTS];
+  uint64_t occupied[TIMER_SERVICE_LEVELS];  // Slots with timers, per level
+  bool dispatching;
+  timer_service_stats_t stats;
+} ts;
+
+static uint64_t counter_read(void) {
+  uint64_t now = 0;
+  rv_timer_counter_read(ts.timer, TS_HART, &now);
+  return now;
+}
+
+static void list_push(uint16_t list, timer_service_timer_t *timer) {
+  timer->bucket = list;
+  timer->prev = NULL;
+  timer->next = ts.list[list];
+  if (timer->next != NULL) {
+    timer->next->prev = timer;
+  }
+  ts.list[list] = timer;
+  if (list < TS_FAR) {
+    ts.occupied[list / TIMER_SERVICE_SLOTS] |= 1ull << (list & TS_SLOT_MASK);
+  }
+}
+
+static void list_remove(timer_service_timer_t *timer) {
+  uint16_t list = timer->bucket;
+  if (timer->prev != NULL) {
+    timer->prev->next = timer->next;
+  } else {
+    ts.list[list] = timer->next;
+  }
+  if (timer->next != NULL) {
+    timer->next->prev = timer->prev;
+  }
+  if (list < TS_FAR && ts.list[list] == NULL) {
+    ts.occupied[list / TIMER_SERVICE_SLOTS] &= ~(1ull << (list & TS_SLOT_MASK));
+  }
+}
+
+// Inserts a timer in the level of its slot from ts.now: level i when the slot
+// and ts.now only differ in the bits of level i and below. A slot not after
+// ts.now goes to the slot of ts.now at level 0, expired at the next wake-up.
+static void wheel_insert(timer_service_timer_t *timer) {
+  uint64_t slot = timer->slot > ts.now ? timer->slot : ts.now;
+  uint64_t diff = slot ^ ts.now;
+  for (uint32_t level = 0; level < TIMER_SERVICE_LEVELS; level++) {
+    uint32_t shift = level * TIMER_SERVICE_SLOT_BITS;
+    if ((diff >> (shift + TIMER_SERVICE_SLOT_BITS)) == 0) {
+      list_push(level * TIMER_SERVICE_SLOTS + ((slot >> shift) & TS_SLOT_MASK),
+                timer);
+      return;
+    }
+  }
+  list_push(TS_FAR, timer);
+}
+
+// Moves the timers of a list to the expired list or to their level from the
+// new ts.now
+static void wheel_requeue(uint16_t list) {
+  timer_service_timer_t *timer = ts.list[list];
+  ts.list[list] = NULL;
+  if (list < TS_FAR) {
+    ts.occupied[list / TIMER_SERVICE_SLOTS] &= ~(1ull << (list & TS_SLOT_MASK));
+  }
+  while (timer != NULL) {
+    timer_service_timer_t *next = timer->next;
+    if (timer->slot <= ts.now) {
+      list_push(TS_EXPIRED, timer);
+    } else {
+      wheel_insert(timer);
+      ts.stats.cascaded++;
+    }
+    timer = next;
+  }
+}
+
+// Sets ts.now to the slot `now`. At each level, the slots passed since the
+// previous ts.now are emptied, from the top level down so that the timers
+// moved down are expired in the same pass.
+static void wheel_advance(uint64_t now) {
+  uint64_t old = ts.now;
+  if (now <= old) {
+    // The timers started in the slot of ts.now
+    if (ts.occupied[0] & (1ull << (old & TS_SLOT_MASK))) {
+      wheel_requeue(old & TS_SLOT_MASK);
+    }
+    return;
+  }
+  ts.now = now;
+
+  uint32_t top = TIMER_SERVICE_LEVELS * TIMER_SERVICE_SLOT_BITS;
+  if ((old >> top) != (now >> top)) {
+    wheel_requeue(TS_FAR);
+  }
+
+  for (int32_t level = TIMER_SERVICE_LEVELS - 1; level >= 0; level--) {
+    uint32_t shift = level * TIMER_SERVICE_SLOT_BITS;
+    uint64_t passed;
+    if ((old >> (shift + TIMER_SERVICE_SLOT_BITS)) !=
+        (now >> (shift + TIMER_SERVICE_SLOT_BITS))) {
+      passed = ~0ull;
+    } else {
+      uint32_t from = (old >> shift) & TS_SLOT_MASK;
+      uint32_t to = (now >> shift) & TS_SLOT_MASK;
+      passed = (~0ull << from) & (~0ull >> (TS_SLOT_MASK - to));
+    }
+    passed &= ts.occupied[level];
+    while (passed != 0) {
+      uint32_t slot = __builtin_ctzll(passed);
+      passed &= passed - 1;
+      wheel_requeue(level * TIMER_SERVICE_SLOTS + slot);
+    }
+  }
+}
+
+// Earliest slot of the pending timers, UINT64_MAX if none. The levels hold
+// later and later timers, and the slots of a level are in the order of their
+// timers, so the earliest timer is in the first occupied slot of the first
+// occupied level. At level 0 all the timers of a slot expire in it.
+static uint64_t wheel_earliest(void) {
+  if (ts.list[TS_EXPIRED] != NULL) {
+    return ts.now;
+  }
+  for (uint32_t level = 0; level < TIMER_SERVICE_LEVELS; level++) {
+    if (ts.occupied[level] == 0) {
+      continue;
+    }
+    uint32_t slot = __builtin_ctzll(ts.occupied[level]);
+    if (level == 0) {
+      return (ts.now & ~(uint64_t)TS_SLOT_MASK) | slot;
+    }
+    uint64_t earliest = UINT64_MAX;
+    for (timer_service_timer_t *t = ts.list[level * TIMER_SERVICE_SLOTS + slot];
+         t != NULL; t = t->next) {
+      if (t->slot < earliest) {
+        earliest = t->slot;
+      }
+    }
+    return earliest;
+  }
+  uint64_t earliest = UINT64_MAX;
+  for (timer_service_timer_t *t = ts.list[TS_FAR]; t != NULL; t = t->next) {
+    if (t->slot < earliest) {
+      earliest = t->slot;
+    }
+  }
+  return earliest;
+}
+
+// Arms the comparator for the earliest timer. Writing the comparator only
+// clears the interrupt of the counter 0, so it is cleared explicitly; if the
+// value has already passed, the interrupt is raised again right away.
+static void arm_next(void) {
+  uint64_t slot = wheel_earliest();
+  uint64_t armed = UINT64_MAX;
+  if (slot != UINT64_MAX) {
+    armed = slot << ts.coalesce;
+    // Saturated, see rv_timer_arm()
+    if ((armed >> ts.coalesce) != slot) {
+      armed = UINT64_MAX;
+    }
+  }
+  if (armed == ts.armed) {
+    return;
+  }
+  ts.armed = armed;
+  rv_timer_arm(ts.timer, TS_HART, TS_COMP, armed);
+  rv_timer_irq_clear(ts.timer, TS_HART, TS_COMP);
+}
+
+// Called with the interrupts disabled
+static void timer_insert(timer_service_timer_t *timer, uint64_t deadline) {
+  uint64_t round = (1ull << ts.coalesce) - 1;
+  timer->deadline = deadline;
+  timer->slot = deadline > UINT64_MAX - round ? UINT64_MAX >> ts.coalesce
+                                              : (deadline + round) >> ts.coalesce;
+  timer->pending = true;
+  wheel_insert(timer);
+}
+
+void timer_service_init(const rv_timer_t *timer, uint8_t coalesce) {
+  ts.timer = timer;
+  ts.coalesce = coalesce < 32 ? coalesce : 31;
+  for (uint32_t i = 0; i < TS_LISTS; i++) {
+    ts.list[i] = NULL;
+  }
+  for (uint32_t level = 0; level < TIMER_SERVICE_LEVELS; level++) {
+    ts.occupied[level] = 0;
+  }
+  ts.dispatching = false;
+  ts.stats = (timer_service_stats_t){0};
+  ts.now = counter_read() >> ts.coalesce;
+
+  ts.armed = UINT64_MAX;
+  rv_timer_arm(timer, TS_HART, TS_COMP, UINT64_MAX);
+  rv_timer_irq_clear(timer, TS_HART, TS_COMP);
+  rv_timer_irq_enable(timer, TS_HART, TS_COMP, kRvTimerEnabled);
+  CSR_SET_BITS(CSR_REG_MIE, MIE_MTIE);
+}
+
+void timer_service_timer_init(timer_service_timer_t *timer,
+                              timer_service_fn_t fn, void *arg) {
+  timer->next = NULL;
+  timer->prev = NULL;
+  timer->fn = fn;
+  timer->arg = arg;
+  timer->period = 0;
+  timer->pending = false;
+}
+
+void timer_service_start(timer_service_timer_t *timer, uint64_t delay,
+                         uint64_t period) {
+  uint64_t now = counter_read();
+  timer_service_start_at(timer, delay > UINT64_MAX - now ? UINT64_MAX : now + delay,
+                         period);
+}
+
+void timer_service_start_at(timer_service_timer_t *timer, uint64_t deadline,
+                            uint64_t period) {
+  uint32_t mstatus = sync_irq_save();
+  if (timer->pending) {
+    list_remove(timer);
+  }
+  timer->period = period;
+  timer_insert(timer, deadline);
+  if (!ts.dispatching) {
+    arm_next();
+  }
+  sync_irq_restore(mstatus);
+}
+
+void timer_service_cancel(timer_service_timer_t *timer) {
+  uint32_t mstatus = sync_irq_save();
+  if (timer->pending) {
+    list_remove(timer);
+    timer->pending = false;
+    // No wake-up for it
+    if (!ts.dispatching && (timer->slot << ts.coalesce) == ts.armed) {
+      arm_next();
+    }
+  }
+  sync_irq_restore(mstatus);
+}
+
+uint64_t timer_service_now(void) {
+  return counter_read();
+}
+
+uint64_t timer_service_next(void) {
+  return ts.armed;
+}
+
+timer_service_stats_t timer_service_stats(void) {
+  uint32_t mstatus = sync_irq_save();
+  timer_service_stats_t stats = ts.stats;
+  sync_irq_restore(mstatus);
+  return stats;
+}
+
+void timer_service_irq(void) {
+  uint64_t now = counter_read();
+  ts.stats.wakeups++;
+
+  ts.dispatching = true;
+  wheel_advance(now >> ts.coalesce);
+
+  uint32_t called = 0;
+  timer_service_timer_t *timer;
+  while ((timer = ts.list[TS_EXPIRED]) != NULL) {
+    list_remove(timer);
+    timer->pending = false;
+
+    // Periodic: the next deadline keeps the phase, the missed ones are skipped
+    if (timer->period != 0) {
+      uint64_t next = timer->deadline + timer->period;
+      if (next <= now) {
+        next += ((now - next) / timer->period + 1) * timer->period;
+      }
+      timer_insert(timer, next);
+    }
+
+    if (called++ != 0) {
+      ts.stats.coalesced++;
+    }
+    ts.stats.expired++;
+    timer->fn(timer, timer->arg);
+  }
+  ts.dispatching = false;
+
+  // A wake-up without timer, e.g. after a cancel, leaves the comparator armed
+  ts.armed = 0;
+  arm_next();
+}
+
+#ifdef TIMER_SERVICE
+void handler_irq_timer(void) {
+  timer_service_irq();
+}
+#endif  // TIMER_SERVICE
@@ -0,0 +1,171 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef TIMER_SERVICE_H_
+#define TIMER_SERVICE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rv_timer.h"
+
+/**
+ * @file
+ * @brief Software timers multiplexed over the comparator of the machine timer
+ * interrupt.
+ *
+ * Any number of timers, one-shot or periodic, share the comparator 0 of the
+ * counter 0 of an rv_timer, the one of handler_irq_timer. The comparator is
+ * always armed for the nearest deadline, so the core only wakes up when a
+ * timer expires.
+ *
+ * The timers are kept in a hierarchical timer wheel of
+ * TIMER_SERVICE_LEVELS levels of TIMER_SERVICE_SLOTS slots, so that starting
+ * and cancelling a timer take a constant time whatever the number of timers.
+ * Level 0 holds the timers of the current TIMER_SERVICE_SLOTS slots, one slot
+ * per deadline; level i holds the later ones in slots TIMER_SERVICE_SLOTS
+ * times wider than those of level i - 1, and its timers move down as their
+ * deadline comes closer.
+ *
+ * The deadlines are rounded up to a slot of 2^coalesce ticks of the counter
+ * (timer_service_init()): the timers of a slot expire together, in one
+ * interrupt. A larger slot trades the accuracy of the timers for fewer
+ * wake-ups.
+ *
+ * With TIMER_SERVICE (e.g. `make app TIMER_SERVICE=1`), handler_irq_timer is
+ * defined by the service; otherwise the application calls
+ * timer_service_irq() from its own handler. The callbacks run in the
+ * interrupt handler, and may start and cancel timers.
+ */
+
+/**
+ * Number of levels of the wheel.
+ */
+#define TIMER_SERVICE_LEVELS 4
+
+/**
+ * log2 of the number of slots of a level.
+ */
+#define TIMER_SERVICE_SLOT_BITS 6
+
+/**
+ * Number of slots of a level.
+ */
+#define TIMER_SERVICE_SLOTS (1u << TIMER_SERVICE_SLOT_BITS)
+
+typedef struct timer_service_timer timer_service_timer_t;
+
+/**
+ * Callback of a timer, called from the interrupt handler.
+ */
+typedef void (*timer_service_fn_t)(timer_service_timer_t *timer, void *arg);
+
+/**
+ * A timer. Its members should be considered private, and are only provided
+ * so that callers can allocate it. It must stay allocated while it is
+ * pending.
+ */
+struct timer_service_timer {
+  timer_service_timer_t *next;
+  timer_service_timer_t *prev;
+  uint64_t deadline;   /*!< Counter value of the expiry. */
+  uint64_t slot;       /*!< Slot of the expiry, deadline rounded up. */
+  uint64_t period;     /*!< Ticks between two expiries, 0 for one shot. */
+  timer_service_fn_t fn;
+  void *arg;
+  uint16_t bucket;     /*!< List the timer is in, if pending. */
+  bool pending;
+};
+
+/**
+ * Counts of the service since timer_service_init().
+ */
+typedef struct timer_service_stats {
+  uint32_t wakeups;    /*!< Timer interrupts handled. */
+  uint32_t expired;    /*!< Callbacks called. */
+  uint32_t coalesced;  /*!< Callbacks called in the wake-up of another. */
+  uint32_t cascaded;   /*!< Timers moved down a level. */
+} timer_service_stats_t;
+
+/**
+ * Starts the service on the counter 0 of an rv_timer, with no timer. The
+ * counter must be configured and enabled by the caller, and the interrupts
+ * enabled globally (MSTATUS.MIE); the timer interrupt is enabled here.
+ *
+ * @param timer rv_timer, initialized, that lives as long as the program.
+ * @param coalesce log2 of the ticks of a slot, 0 for the accuracy of the
+ *        counter.
+ */
+void timer_service_init(const rv_timer_t *timer, uint8_t coalesce);
+
+/**
+ * Initializes a timer, not pending.
+ *
+ * @param timer Timer.
+ * @param fn Callback.
+ * @param arg Argument of the callback.
+ */
+void timer_service_timer_init(timer_service_timer_t *timer,
+                              timer_service_fn_t fn, void *arg);
+
+/**
+ * Starts a timer that expires in `delay` ticks, then every `period` ticks
+ * if `period` is not 0. A pending timer is restarted.
+ *
+ * @param timer Timer, initialized.
+ * @param delay Ticks of the counter from now.
+ * @param period Ticks between two expiries, 0 for a one-shot timer.
+ */
+void timer_service_start(timer_service_timer_t *timer, uint64_t delay,
+                         uint64_t period);
+
+/**
+ * Starts a timer that expires when the counter reaches `deadline`, then
+ * every `period` ticks if `period` is not 0. A deadline already passed
+ * expires at once. A pending timer is restarted.
+ *
+ * @param timer Timer, initialized.
+ * @param deadline Value of the counter.
+ * @param period Ticks between two expiries, 0 for a one-shot timer.
+ */
+void timer_service_start_at(timer_service_timer_t *timer, uint64_t deadline,
+                            uint64_t period);
+
+/**
+ * Cancels a timer; nothing is done if it is not pending.
+ *
+ * @param timer Timer.
+ */
+void timer_service_cancel(timer_service_timer_t *timer);
+
+/**
+ * Returns whether a timer is pending.
+ */
+static inline bool timer_service_pending(const timer_service_timer_t *timer) {
+  return timer->pending;
+}
+
+/**
+ * Returns the value of the counter.
+ */
+uint64_t timer_service_now(void);
+
+/**
+ * Returns the value of the counter the comparator is armed for, UINT64_MAX
+ * if no timer is pending.
+ */
+uint64_t timer_service_next(void);
+
+/**
+ * Returns the counts of the service.
+ */
+timer_service_stats_t timer_service_stats(void);
+
+/**
+ * Expires the timers whose deadline has passed, calls their callbacks and
+ * arms the comparator for the next one. Called from handler_irq_timer.
+ */
+void timer_service_irq(void);
+
+#endif  // TIMER_SERVICE_H_
@@ -0,0 +1,467 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "tiny_printf.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+ssize_t _write(int file, const void *ptr, size_t len);
+
+typedef struct {
+  tiny_printf_sink_t sink;
+  void *ctx;
+  int count;
+} tiny_out_t;
+
+// Conversion specification
+typedef struct {
+  bool left;   // '-'
+  bool zero;   // '0'
+  bool alt;    // '#'
+  char sign;   // '+', ' ' or 0
+  int width;
+  int prec;    // -1 if not given
+} tiny_spec_t;
+
+static const char tiny_digits_lower[] = "0123456789abcdef";
+static const char tiny_digits_upper[] = "0123456789ABCDEF";
+
+static void tiny_out(tiny_out_t *out, const char *s, size_t len) {
+  if (len != 0) {
+    out->sink(out->ctx, s, len);
+    out->count += len;
+  }
+}
+
+static void tiny_pad(tiny_out_t *out, char c, int n) {
+  char pad[8];
+  memset(pad, c, sizeof(pad));
+  while (n > 0) {
+    int len = n < (int)sizeof(pad) ? n : (int)sizeof(pad);
+    tiny_out(out, pad, len);
+    n -= len;
+  }
+}
+
+// Writes the digits of v backwards from end, returns their number. The
+// 32-bit values, the common case, avoid the 64-bit divisions of libgcc.
+static int tiny_utoa(char *end, uint64_t v, unsigned base,
+                     const char *digits) {
+  char *p = end;
+  while (v > UINT32_MAX) {
+    *--p = digits[v % base];
+    v /= base;
+  }
+  uint32_t w = (uint32_t)v;
+  do {
+    *--p = digits[w % base];
+    w /= base;
+  } while (w != 0);
+  return end - p;
+}
+
+// Prefix, zeros up to the precision and digits, padded to the width
+static void tiny_field(tiny_out_t *out, const tiny_spec_t *spec,
+                       const char *prefix, int prefix_len, const char *body,
+                       int body_len, int zeros) {
+  int pad = spec->width - prefix_len - zeros - body_len;
+  if (pad < 0) {
+    pad = 0;
+  }
+  if (!spec->left && !spec->zero) {
+    tiny_pad(out, ' ', pad);
+  }
+  tiny_out(out, prefix, prefix_len);
+  if (!spec->left && spec->zero) {
+    tiny_pad(out, '0', pad);
+  }
+  tiny_pad(out, '0', zeros);
+  tiny_out(out, body, body_len);
+  if (spec->left) {
+    tiny_pad(out, ' ', pad);
+  }
+}
+
+static void tiny_integer(tiny_out_t *out, tiny_spec_t *spec, uint64_t v,
+                         bool negative, unsigned base, bool upper) {
+  char buf[22];
+  char prefix[3];
+  int prefix_len = 0;
+  int len = 0;
+
+  // The digits of 0 with a precision of 0 are empty
+  if (v != 0 || spec->prec != 0) {
+    len = tiny_utoa(buf + sizeof(buf), v, base,
+                    upper ? tiny_digits_upper : tiny_digits_lower);
+  }
+  if (negative) {
+    prefix[prefix_len++] = '-';
+  } else if (spec->sign) {
+    prefix[prefix_len++] = spec->sign;
+  }
+  if (spec->alt && base == 16 && v != 0) {
+    prefix[prefix_len++] = '0';
+    prefix[prefix_len++] = upper ? 'X' : 'x';
+  }
+  int zeros = spec->prec > len ? spec->prec - len : 0;
+  if (spec->alt && base == 8 && zeros == 0 &&
+      (len == 0 || buf[sizeof(buf) - len] != '0')) {
+    zeros = 1;
+  }
+  // A precision disables the '0' flag
+  if (spec->prec >= 0) {
+    spec->zero = false;
+  }
+  tiny_field(out, spec, prefix, prefix_len, buf + sizeof(buf) - len, len,
+             zeros);
+}
+
+#ifdef TINY_PRINTF_FIXED
+static const uint32_t tiny_pow10[] = {1,      10,      100,      1000,
+                                      10000,  100000,  1000000,  10000000,
+                                      100000000, 1000000000};
+
+static void tiny_fixed(tiny_out_t *out, tiny_spec_t *spec, double x,
+                       bool upper) {
+  char buf[32];
+  char sign = spec->sign;
+  char *end = buf + sizeof(buf);
+  int len;
+
+  if (x != x) {
+    spec->zero = false;
+    tiny_field(out, spec, NULL, 0, upper ? "NAN" : "nan", 3, 0);
+    return;
+  }
+  if (x < 0) {
+    sign = '-';
+    x = -x;
+  }
+  // Beyond the integers of 64 bits, including the infinites
+  if (x >= 18446744073709551616.0) {
+    spec->zero = false;
+    tiny_field(out, spec, &sign, sign != 0, upper ? "INF" : "inf", 3, 0);
+    return;
+  }
+
+  int prec = spec->prec < 0 ? 6 : spec->prec > 9 ? 9 : spec->prec;
+  uint64_t ip = (uint64_t)x;
+  uint32_t fp = (uint32_t)((x - (double)ip) * tiny_pow10[prec] + 0.5);
+  if (fp >= tiny_pow10[prec]) {
+    fp -= tiny_pow10[prec];
+    ip++;
+  }
+
+  char *p = end;
+  if (prec != 0) {
+    p -= tiny_utoa(p, fp, 10, tiny_digits_lower);
+    while (end - p < prec) {
+      *--p = '0';
+    }
+  }
+  if (prec != 0 || spec->alt) {
+    *--p = '.';
+  }
+  p -= tiny_utoa(p, ip, 10, tiny_digits_lower);
+  len = end - p;
+  tiny_field(out, spec, &sign, sign != 0, p, len, 0);
+}
+#endif  // TINY_PRINTF_FIXED
+
+int tiny_vformat(tiny_printf_sink_t sink, void *ctx, const char *fmt,
+                 va_list ap) {
+  tiny_out_t out = {.sink = sink, .ctx = ctx, .count = 0};
+
+  while (*fmt != '\0') {
+    const char *start = fmt;
+    while (*fmt != '\0' && *fmt != '%') {
+      fmt++;
+    }
+    tiny_out(&out, start, fmt - start);
+    if (*fmt == '\0') {
+      break;
+    }
+    start = fmt++;
+
+    tiny_spec_t spec = {.prec = -1};
+    for (;; fmt++) {
+      if (*fmt == '-') {
+        spec.left = true;
+      } else if (*fmt == '0') {
+        spec.zero = true;
+      } else if (*fmt == '#') {
+        spec.alt = true;
+      } else if (*fmt == '+') {
+        spec.sign = '+';
+      } else if (*fmt == ' ') {
+        if (spec.sign == 0) {
+          spec.sign = ' ';
+        }
+      } else {
+        break;
+      }
+    }
+    if (*fmt == '*') {
+      spec.width = va_arg(ap, int);
+      if (spec.width < 0) {
+        spec.left = true;
+        spec.width = -spec.width;
+      }
+      fmt++;
+    } else {
+      while (*fmt >= '0' && *fmt <= '9') {
+        spec.width = spec.width * 10 + (*fmt++ - '0');
+      }
+    }
+    if (*fmt == '.') {
+      fmt++;
+      spec.prec = 0;
+      if (*fmt == '*') {
+        spec.prec = va_arg(ap, int);
+        if (spec.prec < 0) {
+          spec.prec = -1;
+        }
+        fmt++;
+      } else {
+        while (*fmt >= '0' && *fmt <= '9') {
+          spec.prec = spec.prec * 10 + (*fmt++ - '0');
+        }
+      }
+    }
+
+    // Size of the argument in bytes, 0 for int
+    int size = 0;
+    if (*fmt == 'h') {
+      size = fmt[1] == 'h' ? 1 : 2;
+      fmt += size == 1 ? 2 : 1;
+    } else if (*fmt == 'l') {
+      size = fmt[1] == 'l' ? 8 : sizeof(long);
+      fmt += fmt[1] == 'l' ? 2 : 1;
+    } else if (*fmt == 'j') {
+      size = sizeof(intmax_t);
+      fmt++;
+    } else if (*fmt == 'z') {
+      size = sizeof(size_t);
+      fmt++;
+    } else if (*fmt == 't') {
+      size = sizeof(ptrdiff_t);
+      fmt++;
+    }
+    if (spec.left) {
+      spec.zero = false;
+    }
+
+    char c = *fmt;
+    if (c == '\0') {
+      tiny_out(&out, start, fmt - start);
+      break;
+    }
+    fmt++;
+
+    switch (c) {
+      case 'd':
+      case 'i': {
+        int64_t v = size == 8 ? va_arg(ap, long long) : va_arg(ap, int);
+        if (size == 1) {
+          v = (signed char)v;
+        } else if (size == 2) {
+          v = (short)v;
+        }
+        tiny_integer(&out, &spec, v < 0 ? -(uint64_t)v : (uint64_t)v, v < 0,
+                     10, false);
+        break;
+      }
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o': {
+        uint64_t v =
+            size == 8 ? va_arg(ap, unsigned long long) : va_arg(ap, unsigned);
+        if (size == 1) {
+          v = (unsigned char)v;
+        } else if (size == 2) {
+          v = (unsigned short)v;
+        }
+        spec.sign = 0;
+        tiny_integer(&out, &spec, v, false,
+                     c == 'u' ? 10 : c == 'o' ? 8 : 16, c == 'X');
+        break;
+      }
+      case 'p':
+        spec.sign = 0;
+        spec.alt = true;
+        tiny_integer(&out, &spec, (uintptr_t)va_arg(ap, void *), false, 16,
+                     false);
+        break;
+      case 'c': {
+        char ch = (char)va_arg(ap, int);
+        spec.zero = false;
+        tiny_field(&out, &spec, NULL, 0, &ch, 1, 0);
+        break;
+      }
+      case 's': {
+        const char *s = va_arg(ap, const char *);
+        if (s == NULL) {
+          s = "(null)";
+        }
+        int len = 0;
+        while (s[len] != '\0' && (spec.prec < 0 || len < spec.prec)) {
+          len++;
+        }
+        spec.zero = false;
+        tiny_field(&out, &spec, NULL, 0, s, len, 0);
+        break;
+      }
+#ifdef TINY_PRINTF_FIXED
+      case 'f':
+      case 'F':
+        tiny_fixed(&out, &spec, va_arg(ap, double), c == 'F');
+        break;
+#endif
+      case '%':
+        tiny_out(&out, "%", 1);
+        break;
+      default:
+        tiny_out(&out, start, fmt - start);
+        break;
+    }
+  }
+  return out.count;
+}
+
+// Chunk of the standard output, sent to _write() once full
+typedef struct {
+  char buf[TINY_PRINTF_CHUNK];
+  size_t len;
+} tiny_stdout_t;
+
+static void tiny_stdout_flush(tiny_stdout_t *chunk) {
+  if (chunk->len != 0) {
+    _write(STDOUT_FILENO, chunk->buf, chunk->len);
+    chunk->len = 0;
+  }
+}
+
+static void tiny_stdout_sink(void *ctx, const char *s, size_t len) {
+  tiny_stdout_t *chunk = ctx;
+  while (len != 0) {
+    if (chunk->len == sizeof(chunk->buf)) {
+      tiny_stdout_flush(chunk);
+    }
+    size_t n = sizeof(chunk->buf) - chunk->len;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(chunk->buf + chunk->len, s, n);
+    chunk->len += n;
+    s += n;
+    len -= n;
+  }
+}
+
+int tiny_vprintf(const char *fmt, va_list ap) {
+  tiny_stdout_t chunk;
+  chunk.len = 0;
+  int count = tiny_vformat(tiny_stdout_sink, &chunk, fmt, ap);
+  tiny_stdout_flush(&chunk);
+  return count;
+}
+
+int tiny_printf(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int count = tiny_vprintf(fmt, ap);
+  va_end(ap);
+  return count;
+}
+
+// Buffer of snprintf, the characters beyond size - 1 are dropped
+typedef struct {
+  char *buf;
+  size_t size;
+  size_t len;
+} tiny_buffer_t;
+
+static void tiny_buffer_sink(void *ctx, const char *s, size_t len) {
+  tiny_buffer_t *buffer = ctx;
+  if (buffer->len + 1 < buffer->size) {
+    size_t n = buffer->size - 1 - buffer->len;
+    memcpy(buffer->buf + buffer->len, s, n < len ? n : len);
+  }
+  buffer->len += len;
+}
+
+int tiny_vsnprintf(char *buf, size_t size, const char *fmt, va_list ap) {
+  tiny_buffer_t buffer = {.buf = buf, .size = size, .len = 0};
+  int count = tiny_vformat(tiny_buffer_sink, &buffer, fmt, ap);
+  if (size != 0) {
+    buf[buffer.len < size ? buffer.len : size - 1] = '\0';
+  }
+  return count;
+}
+
+int tiny_snprintf(char *buf, size_t size, const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int count = tiny_vsnprintf(buf, size, fmt, ap);
+  va_end(ap);
+  return count;
+}
+
+#ifdef TINY_PRINTF
+// Routed from libc with -Wl,--wrap, see sw/CMakeLists.txt
+int __wrap_printf(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int count = tiny_vprintf(fmt, ap);
+  va_end(ap);
+  return count;
+}
+
+int __wrap_vprintf(const char *fmt, va_list ap) {
+  return tiny_vprintf(fmt, ap);
+}
+
+int __wrap_puts(const char *s) {
+  size_t len = strlen(s);
+  if (_write(STDOUT_FILENO, s, len) < 0 ||
+      _write(STDOUT_FILENO, "\n", 1) < 0) {
+    return -1;
+  }
+  return len + 1;
+}
+
+int __wrap_putchar(int c) {
+  char ch = (char)c;
+  return _write(STDOUT_FILENO, &ch, 1) < 0 ? -1 : (unsigned char)ch;
+}
+
+int __wrap_vsnprintf(char *buf, size_t size, const char *fmt, va_list ap) {
+  return tiny_vsnprintf(buf, size, fmt, ap);
+}
+
+int __wrap_snprintf(char *buf, size_t size, const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int count = tiny_vsnprintf(buf, size, fmt, ap);
+  va_end(ap);
+  return count;
+}
+
+int __wrap_vsprintf(char *buf, const char *fmt, va_list ap) {
+  return tiny_vsnprintf(buf, SIZE_MAX, fmt, ap);
+}
+
+int __wrap_sprintf(char *buf, const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int count = tiny_vsnprintf(buf, SIZE_MAX, fmt, ap);
+  va_end(ap);
+  return count;
+}
+#endif  // TINY_PRINTF
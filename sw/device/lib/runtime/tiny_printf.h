@@ -0,0 +1,76 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef TINY_PRINTF_H_
+#define TINY_PRINTF_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+
+/**
+ * @file
+ * @brief Compact printf formatter, an alternative to the one of newlib.
+ *
+ * The conversions are %d, %i, %u, %x, %X, %o, %c, %s, %p and %%, with the
+ * flags '-', '0', '+', ' ' and '#', a width and a precision (also given with
+ * '*'), and the length modifiers hh, h, l, ll, j, z and t. With
+ * TINY_PRINTF_FIXED, %f and %F print a double in fixed point with at most 9
+ * decimals (6 by default), computed with integer arithmetic: the last
+ * decimal is rounded half up, and the values of 2^64 and more print as inf.
+ * There is no %e nor %g. Any other conversion is printed as is.
+ *
+ * The formatter keeps all of its state on the stack, so it can be called
+ * from interrupt handlers and by several harts at once. tiny_printf() formats
+ * into a small chunk on the stack and passes each full chunk to _write(),
+ * i.e. straight into the TX ring buffer of the UART with UART_TX_BUFFERED.
+ *
+ * With TINY_PRINTF (e.g. `make app PRINTF=tiny`), the printf(), vprintf(),
+ * puts(), putchar(), sprintf(), vsprintf(), snprintf() and vsnprintf() of
+ * libc are routed here at link time, and the formatter of newlib is not
+ * linked in unless the application uses another function of stdio.
+ */
+
+/**
+ * Receives the formatted characters, not terminated.
+ */
+typedef void (*tiny_printf_sink_t)(void *ctx, const char *s, size_t len);
+
+/**
+ * Largest chunk passed to _write() by tiny_printf().
+ */
+#ifndef TINY_PRINTF_CHUNK
+#define TINY_PRINTF_CHUNK 64
+#endif
+
+/**
+ * Format to a sink.
+ *
+ * @param sink Function receiving the characters, in order.
+ * @param ctx Argument of the sink.
+ * @param fmt printf format string.
+ * @param ap Arguments.
+ * @return Number of characters sent to the sink.
+ */
+int tiny_vformat(tiny_printf_sink_t sink, void *ctx, const char *fmt,
+                 va_list ap);
+
+/**
+ * Format to the standard output, through _write().
+ *
+ * @return Number of characters written.
+ */
+int tiny_printf(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+int tiny_vprintf(const char *fmt, va_list ap);
+
+/**
+ * Format to a buffer of `size` bytes, terminated if `size` is not 0.
+ *
+ * @return Number of characters of the whole output, as snprintf().
+ */
+int tiny_snprintf(char *buf, size_t size, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+int tiny_vsnprintf(char *buf, size_t size, const char *fmt, va_list ap);
+
+#endif  // TINY_PRINTF_H_
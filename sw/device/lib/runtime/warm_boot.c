@@ -0,0 +1,37 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#include "warm_boot.h"
+
+#include <stddef.h>
+
+_Static_assert(offsetof(warm_boot_record_t, magic) == WARM_BOOT_MAGIC_OFFSET &&
+               offsetof(warm_boot_record_t, handler) == WARM_BOOT_HANDLER_OFFSET &&
+               offsetof(warm_boot_record_t, arg) == WARM_BOOT_ARG_OFFSET &&
+               offsetof(warm_boot_record_t, check) == WARM_BOOT_CHECK_OFFSET &&
+               offsetof(warm_boot_record_t, count) == WARM_BOOT_COUNT_OFFSET,
+               "crt0 reads the record with the WARM_BOOT_*_OFFSET");
+
+// Neither loaded nor zeroed, crt0 reads it before initializing the RAM
+__attribute__((section(".warm_boot"), used))
+warm_boot_record_t warm_boot_record;
+
+void warm_boot_register(warm_boot_handler_t handler, void *arg) {
+  volatile warm_boot_record_t *record = &warm_boot_record;
+  record->magic = 0;
+  record->handler = handler;
+  record->arg = arg;
+  record->check = WARM_BOOT_MAGIC ^ (uint32_t)(uintptr_t)handler ^
+                  (uint32_t)(uintptr_t)arg;
+  // Last, so that a reset in the middle leaves no valid record
+  record->magic = WARM_BOOT_MAGIC;
+}
+
+void warm_boot_cancel(void) {
+  ((volatile warm_boot_record_t *)&warm_boot_record)->magic = 0;
+}
+
+bool warm_boot_is_warm(void) { return warm_boot_record.count != 0; }
+
+uint32_t warm_boot_count(void) { return warm_boot_record.count; }
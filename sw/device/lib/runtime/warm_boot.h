@@ -0,0 +1,96 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+#ifndef WARM_BOOT_H_
+#define WARM_BOOT_H_
+
+/**
+ * @file
+ * @brief Warm boot of a program whose RAM was retained, into a resume handler.
+ *
+ * warm_boot_register() records a resume handler in a section of RAM that is
+ * neither loaded nor initialized. When crt0 finds the record at its start,
+ * it skips the loading from flash, the initialization of .data and .bss and
+ * the constructors, since the RAM still holds them, and calls the handler
+ * instead of main(). The record is consumed by the warm boot, the handler
+ * registers it again before the next sleep if it wants to be called again.
+ *
+ * Nothing is checked but the record itself, so it must only be registered
+ * while all the banks of the program are retained (see ram_banks_in_use()):
+ * cancel it with warm_boot_cancel() before switching a bank off.
+ *
+ * Two paths use it:
+ * - a reset of the system, e.g. a wake-up of the board from deep sleep,
+ *   reaches crt0 through the boot ROM;
+ * - power_gate_core_warm() power-gates the core without saving its context,
+ *   and the boot ROM jumps to _warm_start on the wake-up.
+ *
+ * This header is also included by crt0, for the layout of the record.
+ */
+
+#define WARM_BOOT_MAGIC 0x57524d42
+
+// Offsets of the fields of warm_boot_record_t
+#define WARM_BOOT_MAGIC_OFFSET 0
+#define WARM_BOOT_HANDLER_OFFSET 4
+#define WARM_BOOT_ARG_OFFSET 8
+#define WARM_BOOT_CHECK_OFFSET 12
+#define WARM_BOOT_COUNT_OFFSET 16
+
+#ifndef __ASSEMBLER__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Resume handler, called with the stack and the global pointer of crt0.
+ * Its return value is given to exit(), like the one of main().
+ */
+typedef int (*warm_boot_handler_t)(void *arg);
+
+/**
+ * Warm boot record, in the .warm_boot section.
+ */
+typedef struct warm_boot_record {
+  uint32_t magic;               /*!< WARM_BOOT_MAGIC when armed. */
+  warm_boot_handler_t handler;  /*!< Resume handler. */
+  void *arg;                    /*!< Argument of the handler. */
+  uint32_t check;               /*!< magic ^ handler ^ arg. */
+  uint32_t count;               /*!< Warm boots since the last cold one. */
+} warm_boot_record_t;
+
+extern warm_boot_record_t warm_boot_record;
+
+/**
+ * Entry point of the warm boot for the RESTORE_ADDRESS of the power manager,
+ * in crt0. Without a valid record, it boots cold.
+ */
+void _warm_start(void);
+
+/**
+ * Registers the handler of the next warm boot.
+ *
+ * @param handler Resume handler.
+ * @param arg Argument of the handler, which must be retained too.
+ */
+void warm_boot_register(warm_boot_handler_t handler, void *arg);
+
+/**
+ * Cancels the next warm boot, the next boot is cold.
+ */
+void warm_boot_cancel(void);
+
+/**
+ * Returns true if the program was started by a warm boot.
+ */
+bool warm_boot_is_warm(void);
+
+/**
+ * Returns the number of warm boots since the last cold boot.
+ */
+uint32_t warm_boot_count(void);
+
+#endif  // __ASSEMBLER__
+
+#endif  // WARM_BOOT_H_
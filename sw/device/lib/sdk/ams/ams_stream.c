@@ -0,0 +1,100 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: ams_stream.c
+// Description: Continuous sampling of the AMS peripheral into a ring through the DMA
+
+#include "ams_stream.h"
+#include "ams.h"
+#include "dma_stream.h"
+#include "dma.h"
+#include "core_v_mini_mcu.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// Reduce a filled buffer in place, the values take its first words
+static void ams_stream_reduce(ams_stream_t *stream, uint32_t *samples)
+{
+    uint32_t block = stream->block;
+
+    for (uint32_t i = 0; i < stream->count; i++)
+    {
+        const uint32_t *s = samples + i * block;
+        uint32_t value;
+
+        if (stream->reduce == AMS_STREAM_AVERAGE)
+        {
+            uint32_t ones = 0;
+            for (uint32_t j = 0; j < block; j++)
+            {
+                ones += (s[j] >> AMS_GET_VALUE_BIT) & 0x1;
+            }
+            value = (uint32_t)(((uint64_t)ones * AMS_STREAM_FULL_SCALE) / block);
+        }
+        else
+        {
+            value = (s[0] >> AMS_GET_VALUE_BIT) & 0x1;
+        }
+        samples[i] = value;
+    }
+}
+
+static void ams_stream_filled(dma_stream_t *dma, uint8_t *buffer, uint32_t index, void *arg)
+{
+    ams_stream_t *stream = arg;
+    (void)dma;
+
+    ams_stream_reduce(stream, (uint32_t *)buffer);
+    if (stream->callback != NULL)
+    {
+        stream->callback(stream, (const uint32_t *)buffer, stream->count, index, stream->arg);
+    }
+}
+
+int ams_stream_init(ams_stream_t *stream, uint32_t *ring, uint32_t buffer_words,
+                    uint32_t buffer_count, ams_stream_reduce_t reduce, uint32_t block,
+                    ams_stream_callback_t callback, void *arg)
+{
+    if (reduce == AMS_STREAM_RAW)
+    {
+        block = 1;
+    }
+    if (block == 0 || buffer_words % block != 0)
+    {
+        return -1;
+    }
+
+    stream->reduce = reduce;
+    stream->block = block;
+    stream->count = buffer_words / block;
+    stream->callback = callback;
+    stream->arg = arg;
+
+    return dma_stream_init(&stream->dma, (uint8_t *)ring, buffer_words, buffer_count,
+                           DMA_DATA_TYPE_WORD, (uint8_t *)AMS_GET_ADDRESS, 0,
+                           DMA_TRIG_SLOT_EXT_RX, ams_stream_filled, stream);
+}
+
+int ams_stream_start(ams_stream_t *stream)
+{
+    return dma_stream_start(&stream->dma);
+}
+
+const uint32_t *ams_stream_get(ams_stream_t *stream, uint32_t *count)
+{
+    *count = stream->count;
+    return (const uint32_t *)dma_stream_get(&stream->dma);
+}
+
+void ams_stream_release(ams_stream_t *stream)
+{
+    dma_stream_release(&stream->dma);
+}
+
+void ams_stream_stop(ams_stream_t *stream)
+{
+    dma_stream_stop(&stream->dma);
+}
@@ -0,0 +1,124 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: ams_stream.h
+// Description: Continuous sampling of the AMS peripheral into a ring through the DMA
+
+#ifndef AMS_STREAM_H_
+#define AMS_STREAM_H_
+
+#include <stdint.h>
+
+#include "ams.h"
+#include "dma_stream.h"
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief What is kept of each block of samples of a buffer.
+ */
+typedef enum
+{
+    AMS_STREAM_RAW,      // Every sample, 0 or 1
+    AMS_STREAM_DECIMATE, // The first sample of each block
+    AMS_STREAM_AVERAGE,  // The share of samples at 1 in each block, over AMS_STREAM_FULL_SCALE
+} ams_stream_reduce_t;
+
+/**
+ * @brief Value of AMS_STREAM_AVERAGE for a block with all its samples at 1.
+ */
+#define AMS_STREAM_FULL_SCALE 65536
+
+typedef struct ams_stream ams_stream_t;
+
+/**
+ * @brief Called from the window interrupt handler when a buffer of the ring
+ * has been filled and reduced.
+ *
+ * @param stream Stream of the buffer
+ * @param values The values of the buffer, one per block
+ * @param count Number of values
+ * @param index Number of buffers filled before this one since the start
+ * @param arg Argument given to ams_stream_init()
+ */
+typedef void (*ams_stream_callback_t)(ams_stream_t *stream, const uint32_t *values, uint32_t count,
+                                      uint32_t index, void *arg);
+
+/**
+ * @brief A DMA stream of the output of the AMS peripheral. The fields are
+ * private, the stream must stay allocated while it runs.
+ */
+struct ams_stream
+{
+    dma_stream_t dma;
+    ams_stream_reduce_t reduce;
+    uint32_t block;                 // Samples of a block, 1 for AMS_STREAM_RAW
+    uint32_t count;                 // Values of a buffer
+    ams_stream_callback_t callback; // Called when a buffer is filled, or NULL
+    void *arg;                      // Argument of the callback
+};
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Set up a DMA stream copying the output of the AMS peripheral into a
+ * ring of buffers, one word per sample. The DMA copies a sample at each pulse
+ * of the external RX trigger slot (DMA_TRIG_SLOT_EXT_RX), which sets the
+ * sampling rate: the platform drives it with its sampling timer. The CPU only
+ * runs at the window interrupt of each filled buffer, which reduces the
+ * buffer in place to a value per block of samples and calls the callback.
+ *
+ * @param stream Stream to initialize
+ * @param ring Memory of the ring, buffer_count * buffer_words words
+ * @param buffer_words Number of samples of a buffer, a multiple of block
+ * @param buffer_count Number of buffers in the ring, at least 2
+ * @param reduce What is kept of each block
+ * @param block Samples of a block, ignored for AMS_STREAM_RAW
+ * @param callback Called from the interrupt handler when a buffer is filled, or NULL
+ * @param arg Argument passed to the callback
+ * @return int 0 if success, -1 if the ring or the blocks are not valid
+ */
+int ams_stream_init(ams_stream_t *stream, uint32_t *ring, uint32_t buffer_words,
+                    uint32_t buffer_count, ams_stream_reduce_t reduce, uint32_t block,
+                    ams_stream_callback_t callback, void *arg);
+
+/**
+ * @brief Start the DMA stream. The threshold is selected with
+ * ams_set_threshold() and the PLIC initialized with plic_Init() before.
+ *
+ * @param stream Stream initialized by ams_stream_init()
+ * @return int 0 if success, -1 if no DMA channel is free
+ */
+int ams_stream_start(ams_stream_t *stream);
+
+/**
+ * @brief Get the values of the oldest filled buffer that has not been
+ * released yet, when there is no callback.
+ *
+ * @param stream Running stream
+ * @param count Set to the number of values
+ * @return const uint32_t* The values, or NULL if no buffer is ready
+ */
+const uint32_t *ams_stream_get(ams_stream_t *stream, uint32_t *count);
+
+/**
+ * @brief Release the buffer returned by ams_stream_get(), so the DMA can fill
+ * it again.
+ *
+ * @param stream Running stream
+ */
+void ams_stream_release(ams_stream_t *stream);
+
+/**
+ * @brief Stop the DMA stream once it reaches the end of the ring.
+ *
+ * @param stream Running stream
+ */
+void ams_stream_stop(ams_stream_t *stream);
+
+#endif /* AMS_STREAM_H_ */
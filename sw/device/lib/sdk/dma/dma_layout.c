@@ -0,0 +1,344 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_layout.c
+// Description: Tensor layout transforms (transposition, NCHW and NHWC, channel
+// interleaving) planned as chains of DMA transactions, with CPU fallbacks
+
+#include "dma_layout.h"
+#include "dma_sdk.h"
+#include "dma.h"
+#include "dma_regs.h"
+
+/**********************************/
+/* ---- LOCAL VARIABLES ---- */
+/**********************************/
+
+static uint32_t dma_layout_threshold = DMA_LAYOUT_CPU_THRESHOLD;
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+void dma_layout_set_threshold(uint32_t elements)
+{
+    dma_layout_threshold = elements;
+}
+
+// Whether the DMA can take pointers of elements of size_b bytes, which are not realigned
+static int dma_layout_aligned(const void *a, const void *b, uint32_t size_b)
+{
+    return (((uintptr_t)a | (uintptr_t)b) & (size_b - 1)) == 0;
+}
+
+// Transposition by the CPU, one loop per element size
+static void dma_layout_cpu_transpose(uint8_t *dst, const uint8_t *src, uint32_t rows, uint32_t cols,
+                                     uint32_t size_b)
+{
+    for (uint32_t r = 0; r < rows; r++)
+    {
+        if (size_b == 4)
+        {
+            for (uint32_t c = 0; c < cols; c++)
+            {
+                ((uint32_t *)dst)[c * rows + r] = ((const uint32_t *)src)[r * cols + c];
+            }
+        }
+        else if (size_b == 2)
+        {
+            for (uint32_t c = 0; c < cols; c++)
+            {
+                ((uint16_t *)dst)[c * rows + r] = ((const uint16_t *)src)[r * cols + c];
+            }
+        }
+        else
+        {
+            for (uint32_t c = 0; c < cols; c++)
+            {
+                dst[c * rows + r] = src[r * cols + c];
+            }
+        }
+    }
+}
+
+// Strided copy by the CPU of count elements, the increments are in elements
+static void dma_layout_cpu_strided(uint8_t *dst, uint32_t dst_inc, const uint8_t *src, uint32_t src_inc,
+                                   uint32_t count, uint32_t size_b)
+{
+    if (size_b == 4)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ((uint32_t *)dst)[i * dst_inc] = ((const uint32_t *)src)[i * src_inc];
+        }
+    }
+    else if (size_b == 2)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ((uint16_t *)dst)[i * dst_inc] = ((const uint16_t *)src)[i * src_inc];
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            dst[i * dst_inc] = src[i * src_inc];
+        }
+    }
+}
+
+// Append the descriptors transposing a rows x cols matrix, one per tile of
+// the output that fits the 16-bit size registers. The source is read by
+// columns (dim_inv): its D2 increment is the distance between two rows, and
+// the destination goes from the end of a tile row to the start of the next.
+// Returns -1 if the plan is too short or the rows too long for the increments.
+static int dma_layout_plan_transpose(dma_layout_desc_t *plan, uint32_t *length, uint32_t plan_len,
+                                     uint8_t *dst, const uint8_t *src, uint32_t rows, uint32_t cols,
+                                     dma_data_type_t type)
+{
+    uint32_t size_b = DMA_DATA_TYPE_2_SIZE(type);
+    uint32_t max_du = DMA_LAYOUT_MAX_DU(size_b);
+
+    if (cols * size_b > DMA_SRC_PTR_INC_D2_INC_MASK || rows * size_b > DMA_DST_PTR_INC_D2_INC_MASK)
+    {
+        return -1;
+    }
+
+    // Tile of the output rows i0.. (source columns) and columns j0.. (source rows)
+    for (uint32_t i0 = 0; i0 < cols; i0 += max_du)
+    {
+        for (uint32_t j0 = 0; j0 < rows; j0 += max_du)
+        {
+            uint32_t ni = cols - i0 < max_du ? cols - i0 : max_du;
+            uint32_t nj = rows - j0 < max_du ? rows - j0 : max_du;
+            if (*length == plan_len)
+            {
+                return -1;
+            }
+            dma_layout_desc_t *desc = &plan[(*length)++];
+
+            desc->src = (dma_target_t){
+                .ptr = (uint8_t *)src + (j0 * cols + i0) * size_b,
+                .inc_du = 1,
+                .inc_d2_du = cols,
+                .size_du = nj,
+                .size_d2_du = ni,
+                .trig = DMA_TRIG_MEMORY,
+                .type = type,
+            };
+            desc->dst = (dma_target_t){
+                .ptr = dst + (i0 * rows + j0) * size_b,
+                .inc_du = 1,
+                .inc_d2_du = rows - nj + 1,
+                .size_du = nj,
+                .size_d2_du = ni,
+                .trig = DMA_TRIG_MEMORY,
+                .type = type,
+            };
+            desc->trans = (dma_trans_t){
+                .src = &desc->src,
+                .dst = &desc->dst,
+                .src_addr = NULL,
+                .mode = DMA_TRANS_MODE_SINGLE,
+                .dim = DMA_DIM_CONF_2D,
+                .dim_inv = 1,
+                .win_du = 0,
+                .end = DMA_TRANS_END_INTR,
+            };
+        }
+    }
+    return 0;
+}
+
+// Append the descriptors of a strided copy of count elements, in chunks that
+// fit the size register. The increments are 8-bit, in elements.
+static int dma_layout_plan_strided(dma_layout_desc_t *plan, uint32_t *length, uint32_t plan_len,
+                                   uint8_t *dst, uint32_t dst_inc, const uint8_t *src, uint32_t src_inc,
+                                   uint32_t count, dma_data_type_t type)
+{
+    uint32_t size_b = DMA_DATA_TYPE_2_SIZE(type);
+    uint32_t max_du = DMA_LAYOUT_MAX_DU(size_b);
+
+    if (dst_inc > UINT8_MAX || src_inc > UINT8_MAX)
+    {
+        return -1;
+    }
+
+    for (uint32_t i0 = 0; i0 < count; i0 += max_du)
+    {
+        if (*length == plan_len)
+        {
+            return -1;
+        }
+        dma_layout_desc_t *desc = &plan[(*length)++];
+
+        desc->src = (dma_target_t){
+            .ptr = (uint8_t *)src + i0 * src_inc * size_b,
+            .inc_du = (uint8_t)src_inc,
+            .size_du = count - i0 < max_du ? count - i0 : max_du,
+            .trig = DMA_TRIG_MEMORY,
+            .type = type,
+        };
+        desc->dst = (dma_target_t){
+            .ptr = dst + i0 * dst_inc * size_b,
+            .inc_du = (uint8_t)dst_inc,
+            .trig = DMA_TRIG_MEMORY,
+            .type = type,
+        };
+        desc->trans = (dma_trans_t){
+            .src = &desc->src,
+            .dst = &desc->dst,
+            .src_addr = NULL,
+            .mode = DMA_TRANS_MODE_SINGLE,
+            .dim = DMA_DIM_CONF_1D,
+            .win_du = 0,
+            .end = DMA_TRANS_END_INTR,
+        };
+    }
+    return 0;
+}
+
+// Run descriptors through the transaction queue of a free channel. The
+// transactions write each destination element once, so the CPU can redo the
+// whole transform after an error.
+static int dma_layout_run(dma_layout_desc_t *plan, uint32_t length)
+{
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+
+    int res = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        plan[i].trans.channel = (uint8_t)channel;
+        plan[i].trans.flags = DMA_CONFIG_OK;
+
+        // The descriptors are valid by construction, only the critical checks are kept
+        if (dma_enqueue_transaction(&plan[i].trans, DMA_DO_NOT_ENABLE_REALIGN,
+                                    DMA_PERFORM_CHECKS_ONLY_CRITICAL) & DMA_CONFIG_CRITICAL_ERROR)
+        {
+            res = -1;
+            break;
+        }
+    }
+
+    dma_queue_wait((uint8_t)channel);
+
+    // The registers no longer hold the image of an SDK handle
+    dma_sdk_handle_invalidate((uint8_t)channel);
+    dma_sdk_channel_free((uint8_t)channel);
+
+    return res;
+}
+
+// Transpose images of rows x cols elements, one after another
+static dma_layout_done_t dma_layout_images(uint8_t *dst, const uint8_t *src, uint32_t images, uint32_t rows,
+                                           uint32_t cols, dma_data_type_t type, dma_layout_desc_t *plan,
+                                           uint32_t plan_len)
+{
+    uint32_t size_b = DMA_DATA_TYPE_2_SIZE(type);
+    uint32_t image_b = rows * cols * size_b;
+    uint32_t length = 0;
+
+    if (images * rows * cols >= dma_layout_threshold && dma_layout_aligned(dst, src, size_b))
+    {
+        uint32_t n = 0;
+        while (n < images &&
+               dma_layout_plan_transpose(plan, &length, plan_len, dst + n * image_b, src + n * image_b,
+                                         rows, cols, type) == 0)
+        {
+            n++;
+        }
+        if (n == images && dma_layout_run(plan, length) == 0)
+        {
+            return DMA_LAYOUT_DONE_DMA;
+        }
+    }
+
+    for (uint32_t n = 0; n < images; n++)
+    {
+        dma_layout_cpu_transpose(dst + n * image_b, src + n * image_b, rows, cols, size_b);
+    }
+    return DMA_LAYOUT_DONE_CPU;
+}
+
+dma_layout_done_t dma_layout_transpose(void *dst, const void *src, uint32_t rows, uint32_t cols,
+                                       dma_data_type_t type, dma_layout_desc_t *plan, uint32_t plan_len)
+{
+    return dma_layout_images((uint8_t *)dst, (const uint8_t *)src, 1, rows, cols, type, plan, plan_len);
+}
+
+dma_layout_done_t dma_layout_nchw_to_nhwc(void *dst, const void *src, uint32_t n, uint32_t c, uint32_t h,
+                                          uint32_t w, dma_data_type_t type, dma_layout_desc_t *plan,
+                                          uint32_t plan_len)
+{
+    return dma_layout_images((uint8_t *)dst, (const uint8_t *)src, n, c, h * w, type, plan, plan_len);
+}
+
+dma_layout_done_t dma_layout_nhwc_to_nchw(void *dst, const void *src, uint32_t n, uint32_t c, uint32_t h,
+                                          uint32_t w, dma_data_type_t type, dma_layout_desc_t *plan,
+                                          uint32_t plan_len)
+{
+    return dma_layout_images((uint8_t *)dst, (const uint8_t *)src, n, h * w, c, type, plan, plan_len);
+}
+
+// Strided copies between each channel buffer and its elements of the frames
+static dma_layout_done_t dma_layout_channels(uint8_t *frames_buf, void *const *planes, uint32_t channels,
+                                             uint32_t frames, dma_data_type_t type, int interleave,
+                                             dma_layout_desc_t *plan, uint32_t plan_len)
+{
+    uint32_t size_b = DMA_DATA_TYPE_2_SIZE(type);
+    uint32_t length = 0;
+    uint32_t ch = 0;
+
+    if (channels * frames >= dma_layout_threshold)
+    {
+        for (; ch < channels; ch++)
+        {
+            uint8_t *plane = (uint8_t *)planes[ch];
+            uint8_t *slot = frames_buf + ch * size_b;
+            if (!dma_layout_aligned(plane, slot, size_b) ||
+                (interleave ? dma_layout_plan_strided(plan, &length, plan_len, slot, channels, plane, 1, frames, type)
+                            : dma_layout_plan_strided(plan, &length, plan_len, plane, 1, slot, channels, frames, type)) != 0)
+            {
+                break;
+            }
+        }
+        if (ch == channels && dma_layout_run(plan, length) == 0)
+        {
+            return DMA_LAYOUT_DONE_DMA;
+        }
+    }
+
+    for (ch = 0; ch < channels; ch++)
+    {
+        uint8_t *plane = (uint8_t *)planes[ch];
+        uint8_t *slot = frames_buf + ch * size_b;
+        if (interleave)
+        {
+            dma_layout_cpu_strided(slot, channels, plane, 1, frames, size_b);
+        }
+        else
+        {
+            dma_layout_cpu_strided(plane, 1, slot, channels, frames, size_b);
+        }
+    }
+    return DMA_LAYOUT_DONE_CPU;
+}
+
+dma_layout_done_t dma_layout_interleave(void *dst, void *const *planes, uint32_t channels, uint32_t frames,
+                                        dma_data_type_t type, dma_layout_desc_t *plan, uint32_t plan_len)
+{
+    return dma_layout_channels((uint8_t *)dst, planes, channels, frames, type, 1, plan, plan_len);
+}
+
+dma_layout_done_t dma_layout_deinterleave(void *const *planes, const void *src, uint32_t channels,
+                                          uint32_t frames, dma_data_type_t type, dma_layout_desc_t *plan,
+                                          uint32_t plan_len)
+{
+    return dma_layout_channels((uint8_t *)src, planes, channels, frames, type, 0, plan, plan_len);
+}
@@ -0,0 +1,167 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_layout.h
+// Description: Tensor layout transforms (transposition, NCHW and NHWC, channel
+// interleaving) planned as chains of DMA transactions, with CPU fallbacks
+
+#ifndef DMA_LAYOUT_H_
+#define DMA_LAYOUT_H_
+
+#include <stdint.h>
+
+#include "dma.h"
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief Transforms of fewer elements are done by the CPU, as the setup of the
+ * transactions would cost more than the copy. Can be overridden at compile
+ * time or with dma_layout_set_threshold().
+ */
+#ifndef DMA_LAYOUT_CPU_THRESHOLD
+#define DMA_LAYOUT_CPU_THRESHOLD 64
+#endif
+
+/**
+ * @brief Largest number of elements of size size_b along a dimension of one
+ * transaction, from the 16-bit size registers, in bytes.
+ */
+#define DMA_LAYOUT_MAX_DU(size_b) (0xFFFF / (size_b))
+
+/**
+ * @brief Descriptors needed to transpose a rows x cols matrix of elements of
+ * size_b bytes, one per tile of the output that fits the size registers.
+ */
+#define DMA_LAYOUT_PLAN_LEN(rows, cols, size_b)                                  \
+    ((((rows) + DMA_LAYOUT_MAX_DU(size_b) - 1) / DMA_LAYOUT_MAX_DU(size_b)) *    \
+     (((cols) + DMA_LAYOUT_MAX_DU(size_b) - 1) / DMA_LAYOUT_MAX_DU(size_b)))
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief One transaction of a transform, with its own targets. The fields are
+ * private, the array only provides the memory of the transactions.
+ */
+typedef struct
+{
+    dma_target_t src;
+    dma_target_t dst;
+    dma_trans_t trans;
+} dma_layout_desc_t;
+
+/**
+ * @brief Which engine did a transform.
+ */
+typedef enum
+{
+    DMA_LAYOUT_DONE_DMA = 0, // By a chain of DMA transactions
+    DMA_LAYOUT_DONE_CPU = 1, // By the CPU: small, misaligned, too many descriptors or no free channel
+} dma_layout_done_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Change the number of elements below which the CPU does the
+ * transforms. 0 always uses the DMA when it can, UINT32_MAX never does.
+ *
+ * @param elements Smallest transform, in elements, done by the DMA
+ */
+void dma_layout_set_threshold(uint32_t elements);
+
+/**
+ * @brief Transpose a row-major matrix of rows x cols elements into a matrix
+ * of cols x rows elements, and sleep until it is done. The DMA reads the
+ * source by columns (dim_inv) and writes the destination by rows.
+ *
+ * @param dst Destination, cols x rows elements, not overlapping the source
+ * @param src Source, rows x cols elements
+ * @param rows Number of rows of the source
+ * @param cols Number of columns of the source
+ * @param type Type of the elements
+ * @param plan Memory of plan_len descriptors, DMA_LAYOUT_PLAN_LEN(rows, cols,
+ * size of the type) are enough
+ * @param plan_len Number of descriptors of plan
+ * @return DMA_LAYOUT_DONE_DMA or DMA_LAYOUT_DONE_CPU
+ */
+dma_layout_done_t dma_layout_transpose(void *dst, const void *src, uint32_t rows, uint32_t cols,
+                                       dma_data_type_t type, dma_layout_desc_t *plan, uint32_t plan_len);
+
+/**
+ * @brief Convert a tensor from NCHW (channel planes) to NHWC (interleaved
+ * channels), and sleep until it is done: each image is a transposition of its
+ * C x HW matrix.
+ *
+ * @param dst Destination, n x h x w x c elements, not overlapping the source
+ * @param src Source, n x c x h x w elements
+ * @param n, c, h, w Dimensions of the tensor
+ * @param type Type of the elements
+ * @param plan Memory of plan_len descriptors, n * DMA_LAYOUT_PLAN_LEN(c, h * w,
+ * size of the type) are enough
+ * @param plan_len Number of descriptors of plan
+ * @return DMA_LAYOUT_DONE_DMA or DMA_LAYOUT_DONE_CPU
+ */
+dma_layout_done_t dma_layout_nchw_to_nhwc(void *dst, const void *src, uint32_t n, uint32_t c, uint32_t h,
+                                          uint32_t w, dma_data_type_t type, dma_layout_desc_t *plan,
+                                          uint32_t plan_len);
+
+/**
+ * @brief Convert a tensor from NHWC to NCHW, and sleep until it is done: each
+ * image is a transposition of its HW x C matrix.
+ *
+ * @param dst Destination, n x c x h x w elements, not overlapping the source
+ * @param src Source, n x h x w x c elements
+ * @param n, c, h, w Dimensions of the tensor
+ * @param type Type of the elements
+ * @param plan Memory of plan_len descriptors, n * DMA_LAYOUT_PLAN_LEN(h * w, c,
+ * size of the type) are enough
+ * @param plan_len Number of descriptors of plan
+ * @return DMA_LAYOUT_DONE_DMA or DMA_LAYOUT_DONE_CPU
+ */
+dma_layout_done_t dma_layout_nhwc_to_nchw(void *dst, const void *src, uint32_t n, uint32_t c, uint32_t h,
+                                          uint32_t w, dma_data_type_t type, dma_layout_desc_t *plan,
+                                          uint32_t plan_len);
+
+/**
+ * @brief Interleave separate channel buffers into frames (e.g. the left and
+ * right buffers into the stereo frames of I2S), and sleep until it is done.
+ * Each channel is a strided copy.
+ *
+ * @param dst Destination, frames x channels elements
+ * @param planes The buffers of the channels, of frames elements each
+ * @param channels Number of channels, up to 255
+ * @param frames Number of frames
+ * @param type Type of the elements
+ * @param plan Memory of plan_len descriptors, channels * DMA_LAYOUT_PLAN_LEN(1,
+ * frames, size of the type) are enough
+ * @param plan_len Number of descriptors of plan
+ * @return DMA_LAYOUT_DONE_DMA or DMA_LAYOUT_DONE_CPU
+ */
+dma_layout_done_t dma_layout_interleave(void *dst, void *const *planes, uint32_t channels, uint32_t frames,
+                                        dma_data_type_t type, dma_layout_desc_t *plan, uint32_t plan_len);
+
+/**
+ * @brief Split frames into separate channel buffers (e.g. the stereo frames
+ * of I2S into the left and right buffers), and sleep until it is done.
+ *
+ * @param planes The buffers of the channels, of frames elements each
+ * @param src Source, frames x channels elements
+ * @param channels Number of channels, up to 255
+ * @param frames Number of frames
+ * @param type Type of the elements
+ * @param plan Memory of plan_len descriptors, as dma_layout_interleave()
+ * @param plan_len Number of descriptors of plan
+ * @return DMA_LAYOUT_DONE_DMA or DMA_LAYOUT_DONE_CPU
+ */
+dma_layout_done_t dma_layout_deinterleave(void *const *planes, const void *src, uint32_t channels,
+                                          uint32_t frames, dma_data_type_t type, dma_layout_desc_t *plan,
+                                          uint32_t plan_len);
+
+#endif /* DMA_LAYOUT_H_ */
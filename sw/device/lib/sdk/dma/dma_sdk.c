@@ -14,6 +14,14 @@
 #include "fast_intr_ctrl.h"
 #include "core_v_mini_mcu.h"
 #include "csr.h"
+#include "sync.h"
+
+/******************************/
+/* ---- DEFINES ---- */
+/******************************/
+
+// Bits of the sequence number in a ticket, above the 8 bits of the channel
+#define DMA_SDK_TICKET_SEQ_MASK 0x7FFFFF
 
 /******************************/
 /* ---- GLOBAL VARIABLES ---- */
@@ -21,10 +29,96 @@
 
 volatile uint8_t dma_sdk_intr_flag;
 
+/* Handle whose register image is loaded in each channel, NULL if unknown. */
+static const dma_sdk_handle_t *dma_sdk_loaded_handle[DMA_CH_NUM];
+
+/* Mask of the channels allocated by dma_sdk_channel_alloc(). */
+static volatile uint32_t dma_sdk_channels_used = 0;
+
+/* Mask of the channels initialized by their first allocation. */
+static uint32_t dma_sdk_channels_init = 0;
+
+/* Asynchronous copy running in each channel. */
+static volatile struct
+{
+    dma_sdk_ticket_t ticket;     // Ticket returned to the caller
+    dma_sdk_callback_t callback; // Called from the interrupt handler, or NULL
+    void *arg;                   // Argument of the callback
+    uint8_t busy;                // The copy has not finished yet
+    uint32_t left_b;             // Bytes left to launch after the running chunk
+    uint32_t src;                // Source of the next chunk
+    uint32_t dst;                // Destination of the next chunk
+    uint32_t src_step;           // Bytes of the source read by a chunk
+} dma_sdk_async[DMA_CH_NUM];
+
+/* Sequence number of the next ticket. */
+static uint32_t dma_sdk_ticket_seq = 0;
+
 /**********************************/
 /* ---- FUNCTION DEFINITIONS ---- */
 /**********************************/
 
+// Record the asynchronous copy about to be launched in a channel
+static dma_sdk_ticket_t dma_sdk_async_start(uint8_t channel, dma_sdk_callback_t callback, void *arg)
+{
+    uint32_t mstatus = sync_irq_save();
+    dma_sdk_ticket_t ticket = (dma_sdk_ticket_t)(((dma_sdk_ticket_seq++ & DMA_SDK_TICKET_SEQ_MASK) << 8) | channel);
+    dma_sdk_async[channel].ticket = ticket;
+    dma_sdk_async[channel].callback = callback;
+    dma_sdk_async[channel].arg = arg;
+    dma_sdk_async[channel].busy = 1;
+    dma_sdk_async[channel].left_b = 0;
+    sync_irq_restore(mstatus);
+    return ticket;
+}
+
+// Start an asynchronous copy of size_b bytes into contiguous words, whose
+// registers other than the size are loaded. A copy larger than SIZE_D1 is
+// launched as chunks of DMA_SPLIT_CHUNK_B bytes, the next ones by the
+// interrupt handler. src_inc_b is the source increment of a word.
+static void dma_sdk_async_launch(uint8_t channel, uint32_t src, uint32_t dst,
+                                 uint32_t size_b, uint32_t src_inc_b)
+{
+    volatile dma *peri = dma_ch_peri(channel);
+    uint32_t chunk_b = size_b > DMA_SIZE_D1_SIZE_MASK ? DMA_SPLIT_CHUNK_B : size_b;
+
+    // The interrupts are disabled until the HAL knows that the channel is running
+    uint32_t mstatus = sync_irq_save();
+    dma_sdk_async[channel].src_step = (DMA_SPLIT_CHUNK_B / sizeof(uint32_t)) * src_inc_b;
+    dma_sdk_async[channel].src = src + dma_sdk_async[channel].src_step;
+    dma_sdk_async[channel].dst = dst + chunk_b;
+    dma_sdk_async[channel].left_b = size_b - chunk_b;
+    peri->SIZE_D1 = chunk_b;
+    dma_expect_trans_done(channel);
+    sync_irq_restore(mstatus);
+}
+
+// Launch the next chunk of an asynchronous copy, from the interrupt handler
+static void dma_sdk_async_next_chunk(uint8_t channel)
+{
+    volatile dma *peri = dma_ch_peri(channel);
+    uint32_t chunk_b = dma_sdk_async[channel].left_b < DMA_SPLIT_CHUNK_B
+                           ? dma_sdk_async[channel].left_b
+                           : DMA_SPLIT_CHUNK_B;
+
+    peri->SRC_PTR = dma_sdk_async[channel].src;
+    peri->DST_PTR = dma_sdk_async[channel].dst;
+    dma_sdk_async[channel].src += dma_sdk_async[channel].src_step;
+    dma_sdk_async[channel].dst += chunk_b;
+    dma_sdk_async[channel].left_b -= chunk_b;
+    peri->SIZE_D1 = chunk_b;
+    dma_expect_trans_done(channel);
+}
+
+// Wait until a channel is released by another user of the DMA, and take it
+static uint8_t dma_sdk_channel_wait(void)
+{
+    int channel;
+    while ((channel = dma_sdk_channel_alloc()) < 0)
+        ;
+    return (uint8_t)channel;
+}
+
 #ifndef USE_HEEP_DMA_HAL
 
 #define DMA_REGISTER_SIZE_BYTES sizeof(int)
@@ -34,7 +128,7 @@ static inline void write_register(uint32_t p_val,
                                   uint32_t p_offset,
                                   uint32_t p_mask,
                                   uint8_t p_sel,
-                                  dma *peri)
+                                  volatile dma *peri)
 {
     /*
      * The index is computed to avoid needing to access the structure
@@ -45,17 +139,21 @@ static inline void write_register(uint32_t p_val,
      * An intermediate variable "value" is used to prevent writing twice into
      * the register.
      */
-    uint32_t value = ((uint32_t *)peri)[index];
+    uint32_t value = ((volatile uint32_t *)peri)[index];
     value &= ~(p_mask << p_sel);
     value |= (p_val & p_mask) << p_sel;
-    ((uint32_t *)peri)[index] = value;
+    ((volatile uint32_t *)peri)[index] = value;
 }
 
 #endif
 
 // Copy data from source to destination using DMA peripheral
-void dma_copy_32b(uint32_t *dst, uint32_t *src, uint32_t size)
+dma_sdk_ticket_t dma_copy_32b_async(uint32_t *dst, uint32_t *src, uint32_t size,
+                                    dma_sdk_callback_t callback, void *arg)
 {
+    uint8_t channel = dma_sdk_channel_wait();
+    dma_sdk_handle_invalidate(channel);
+    dma_sdk_ticket_t ticket = dma_sdk_async_start(channel, callback, arg);
 
     dma_config_flags_t res;
 
@@ -81,6 +179,7 @@ void dma_copy_32b(uint32_t *dst, uint32_t *src, uint32_t size)
         .mode = DMA_TRANS_MODE_SINGLE,
         .win_du = 0,
         .end = DMA_TRANS_END_INTR,
+        .channel = channel,
     };
 
 #ifdef USE_HEEP_DMA_HAL
@@ -89,7 +188,7 @@ void dma_copy_32b(uint32_t *dst, uint32_t *src, uint32_t size)
     res = dma_launch(&trans);
 #else
 
-    dma *peri = dma_peri;
+    volatile dma *peri = dma_ch_peri(channel);
 
     uint8_t dataSize_b = DMA_DATA_TYPE_2_SIZE(trans.src->type);
     trans.size_b = trans.src->size_du * dataSize_b;
@@ -123,6 +222,7 @@ void dma_copy_32b(uint32_t *dst, uint32_t *src, uint32_t size)
      */
 
     peri->MODE = trans.mode;
+    peri->WIDE = 0;
 
     write_register(trans.src_type,
                    DMA_SRC_DATA_TYPE_REG_OFFSET,
@@ -132,31 +232,27 @@ void dma_copy_32b(uint32_t *dst, uint32_t *src, uint32_t size)
 
     peri->INTERRUPT_EN = 0x1;
 
-    /* Load the size and start the transaction. */
-    peri->SIZE_D1 = trans.size_b;
+    /* Load the size and start the transaction, chunk by chunk. */
+    dma_sdk_async_launch(channel, (uint32_t)src, (uint32_t)dst, trans.size_b, 4);
 
 #endif
 
-    while (!dma_is_ready())
-    {
-        // disable_interrupts
-        // this does not prevent waking up the core as this is controlled by the MIP register
-        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-        if (dma_is_ready() == 0)
-        {
-            wait_for_interrupt();
-            // from here we wake up even if we did not jump to the ISR
-        }
-        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
-    }
+    return ticket;
+}
 
-    return;
+void dma_copy_32b(uint32_t *dst, uint32_t *src, uint32_t size)
+{
+    dma_sdk_wait(dma_copy_32b_async(dst, src, size, NULL, NULL));
 }
 
-void dma_fill(uint32_t *dst, uint32_t *value, uint32_t size)
+dma_sdk_ticket_t dma_fill_async(uint32_t *dst, uint32_t *value, uint32_t size,
+                                dma_sdk_callback_t callback, void *arg)
 {
+    uint8_t channel = dma_sdk_channel_wait();
+    dma_sdk_handle_invalidate(channel);
+    dma_sdk_ticket_t ticket = dma_sdk_async_start(channel, callback, arg);
 
-    dma *peri = dma_peri;
+    volatile dma *peri = dma_ch_peri(channel);
 
     /*
      * SET THE POINTERS
@@ -185,6 +281,7 @@ void dma_fill(uint32_t *dst, uint32_t *value, uint32_t size)
      */
 
     peri->MODE = DMA_TRANS_MODE_SINGLE;
+    peri->WIDE = 0;
 
     write_register(DMA_DATA_TYPE_WORD,
                    DMA_SRC_DATA_TYPE_REG_OFFSET,
@@ -194,29 +291,25 @@ void dma_fill(uint32_t *dst, uint32_t *value, uint32_t size)
 
     peri->INTERRUPT_EN = 0x1;
 
-    /* Load the size and start the transaction. */
-    peri->SIZE_D1 = size * sizeof(uint32_t);
+    /* Load the size and start the transaction, chunk by chunk. */
+    dma_sdk_async_launch(channel, (uint32_t)value, (uint32_t)dst, size * sizeof(uint32_t), 0);
 
-    while (!dma_is_ready())
-    {
-        // disable_interrupts
-        // this does not prevent waking up the core as this is controlled by the MIP register
-        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-        if (dma_is_ready() == 0)
-        {
-            wait_for_interrupt();
-            // from here we wake up even if we did not jump to the ISR
-        }
-        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
-    }
+    return ticket;
+}
 
-    return;
+void dma_fill(uint32_t *dst, uint32_t *value, uint32_t size)
+{
+    dma_sdk_wait(dma_fill_async(dst, value, size, NULL, NULL));
 }
 
-void dma_copy_16_32(uint32_t *dst, uint16_t *src, uint32_t size)
+dma_sdk_ticket_t dma_copy_16_32_async(uint32_t *dst, uint16_t *src, uint32_t size,
+                                      dma_sdk_callback_t callback, void *arg)
 {
+    uint8_t channel = dma_sdk_channel_wait();
+    dma_sdk_handle_invalidate(channel);
+    dma_sdk_ticket_t ticket = dma_sdk_async_start(channel, callback, arg);
 
-    dma *peri = dma_peri;
+    volatile dma *peri = dma_ch_peri(channel);
 
     uint8_t dataSize_b = DMA_DATA_TYPE_2_SIZE(DMA_DATA_TYPE_WORD);
 
@@ -246,6 +339,7 @@ void dma_copy_16_32(uint32_t *dst, uint16_t *src, uint32_t size)
      */
 
     peri->MODE = DMA_TRANS_MODE_SINGLE;
+    peri->WIDE = 0;
 
     write_register(DMA_DATA_TYPE_HALF_WORD,
                    DMA_SRC_DATA_TYPE_REG_OFFSET,
@@ -255,31 +349,25 @@ void dma_copy_16_32(uint32_t *dst, uint16_t *src, uint32_t size)
 
     peri->INTERRUPT_EN = 0x1;
 
-    /* Load the size and start the transaction. */
-    peri->SIZE_D1 = dataSize_b * size;
+    /* Load the size and start the transaction, chunk by chunk. */
+    dma_sdk_async_launch(channel, (uint32_t)src, (uint32_t)dst, dataSize_b * size, 2);
 
     // #endif
 
-    while (!dma_is_ready())
-    {
-        // disable_interrupts
-        // this does not prevent waking up the core as this is controlled by the MIP register
-        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-        if (dma_is_ready() == 0)
-        {
-            wait_for_interrupt();
-            // from here we wake up even if we did not jump to the ISR
-        }
-        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
-    }
+    return ticket;
+}
 
-    return;
+void dma_copy_16_32(uint32_t *dst, uint16_t *src, uint32_t size)
+{
+    dma_sdk_wait(dma_copy_16_32_async(dst, src, size, NULL, NULL));
 }
 
 
 // Copy data from source to destination using DMA peripheral
 void dma_copy_to_addr_32b(uint32_t *dst_addr, uint32_t *src, uint32_t size)
 {
+    uint8_t channel = dma_sdk_channel_wait();
+    dma_sdk_handle_invalidate(channel);
 
     dma_config_flags_t res;
 
@@ -304,13 +392,14 @@ void dma_copy_to_addr_32b(uint32_t *dst_addr, uint32_t *src, uint32_t size)
         .mode = DMA_TRANS_MODE_ADDRESS,
         .win_du = 0,
         .end = DMA_TRANS_END_INTR,
+        .channel = channel,
     };
 
 #ifdef USE_HEEP_DMA_HAL
     /** TO BE DONE */
 #else
 
-    dma *peri = dma_peri;
+    volatile dma *peri = dma_ch_peri(channel);
 
     uint8_t dataSize_b = DMA_DATA_TYPE_2_SIZE(trans.src->type);
     trans.size_b = trans.src->size_du * dataSize_b;
@@ -338,6 +427,7 @@ void dma_copy_to_addr_32b(uint32_t *dst_addr, uint32_t *src, uint32_t size)
      */
 
     peri->MODE = trans.mode;
+    peri->WIDE = 0;
 
     write_register(trans.src_type,
                    DMA_SRC_DATA_TYPE_REG_OFFSET,
@@ -347,30 +437,52 @@ void dma_copy_to_addr_32b(uint32_t *dst_addr, uint32_t *src, uint32_t size)
 
     peri->INTERRUPT_EN = 0x1;
 
-    /* Load the size and start the transaction. */
-    peri->SIZE_D1 = trans.size_b;
-
-#endif
+    /*
+     * Load the size and start the transaction. A copy larger than SIZE_D1 is
+     * copied chunk by chunk, the source and the address list moving by a
+     * word per data unit.
+     */
+    uint32_t src_addr = (uint32_t)trans.src->ptr;
+    uint32_t addr_addr = (uint32_t)trans.src_addr->ptr;
+    uint32_t left_b = trans.size_b;
 
-    while (!dma_is_ready())
+    while (left_b > 0)
     {
-        // disable_interrupts
-        // this does not prevent waking up the core as this is controlled by the MIP register
-        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-        if (dma_is_ready() == 0)
+        uint32_t chunk_b = left_b > DMA_SIZE_D1_SIZE_MASK ? DMA_SPLIT_CHUNK_B : left_b;
+
+        peri->SRC_PTR = src_addr;
+        peri->ADDR_PTR = addr_addr;
+        peri->SIZE_D1 = chunk_b;
+
+        while (!dma_is_ready(channel))
         {
-            wait_for_interrupt();
-            // from here we wake up even if we did not jump to the ISR
+            // disable_interrupts
+            // this does not prevent waking up the core as this is controlled by the MIP register
+            CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+            if (dma_is_ready(channel) == 0)
+            {
+                wait_for_interrupt();
+                // from here we wake up even if we did not jump to the ISR
+            }
+            CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
         }
-        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+        src_addr += chunk_b;
+        addr_addr += chunk_b;
+        left_b -= chunk_b;
     }
 
+#endif
+
+    dma_sdk_channel_free(channel);
     return;
 }
 
 // Copy data from source to destination using DMA peripheral
 int dma_copy(const uint8_t *dst, const uint8_t *src, const size_t bytes, const dma_data_type_t type)
 {
+    uint8_t channel = dma_sdk_channel_wait();
+    dma_sdk_handle_invalidate(channel);
     // Number of words
     size_t num_du = bytes >> 2;
 
@@ -440,38 +552,39 @@ int dma_copy(const uint8_t *dst, const uint8_t *src, const size_t bytes, const d
         .mode = DMA_TRANS_MODE_SINGLE,
         .win_du = 0,
         .end = DMA_TRANS_END_INTR,
+        .channel = channel,
     };
 
     // Configure and launch DMA transfer
     dma_ret = dma_validate_transaction(&trans, DMA_DO_NOT_ENABLE_REALIGN, DMA_PERFORM_CHECKS_ONLY_SANITY);
-    if (dma_ret != DMA_CONFIG_OK)
+    if (dma_ret == DMA_CONFIG_OK)
     {
-        return -1;
+        dma_ret = dma_load_transaction(&trans);
     }
-    dma_ret = dma_load_transaction(&trans);
-    if (dma_ret != DMA_CONFIG_OK)
+    if (dma_ret == DMA_CONFIG_OK)
     {
-        return -1;
+        dma_ret = dma_launch(&trans);
     }
-    dma_ret = dma_launch(&trans);
     if (dma_ret != DMA_CONFIG_OK)
     {
+        dma_sdk_channel_free(channel);
         return -1;
     }
 
     // Wait for DMA transfer to finish
-    while (!dma_is_ready())
+    while (!dma_is_ready(channel))
     {
         // disable_interrupts
         // this does not prevent waking up the core as this is controlled by the MIP register
         CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
-        if (dma_is_ready() == 0)
+        if (dma_is_ready(channel) == 0)
         {
             wait_for_interrupt();
             // from here we wake up even if we did not jump to the ISR
         }
         CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
     }
+    dma_sdk_channel_free(channel);
 
     // Manually copy the last bytes (unaligned transfers not supported by DMA)
     for (size_t i = 0; i < last_bytes; i++)
@@ -482,8 +595,251 @@ int dma_copy(const uint8_t *dst, const uint8_t *src, const size_t bytes, const d
     return 0;
 }
 
+int dma_sdk_handle_init(dma_sdk_handle_t *handle, const uint8_t channel, const uint8_t *dst, const uint8_t *src, const size_t size_du, const dma_data_type_t type)
+{
+    dma_target_t tgt_src = {
+        .ptr = (uint8_t *)src,
+        .inc_du = 1,
+        .size_du = size_du,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    dma_target_t tgt_dst = {
+        .ptr = (uint8_t *)dst,
+        .inc_du = 1,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    dma_trans_t trans = {
+        .src = &tgt_src,
+        .dst = &tgt_dst,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .win_du = 0,
+        .end = DMA_TRANS_END_INTR,
+        .channel = channel,
+    };
+
+    // Full validation, done only once for all the launches of the handle
+    if (dma_validate_transaction(&trans, DMA_DO_NOT_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY) != DMA_CONFIG_OK)
+    {
+        return -1;
+    }
+
+    // A launch writes the size once, so the copy is not split
+    if (trans.size_b > DMA_SIZE_D1_SIZE_MASK)
+    {
+        return -1;
+    }
+
+    uint8_t dataSize_b = DMA_DATA_TYPE_2_SIZE(type);
+    handle->size_b = trans.size_b;
+    handle->src_inc_b = tgt_src.inc_du * dataSize_b;
+    handle->dst_inc_b = tgt_dst.inc_du * dataSize_b;
+    handle->src_type = trans.src_type;
+    handle->dst_type = trans.dst_type;
+    handle->align_mask = dataSize_b - 1;
+
+    // The handle may be re-initialized while its old image is loaded
+    for (uint8_t ch = 0; ch < DMA_CH_NUM; ch++)
+    {
+        if (dma_sdk_loaded_handle[ch] == handle)
+        {
+            dma_sdk_handle_invalidate(ch);
+        }
+    }
+    handle->channel = channel;
+
+    return 0;
+}
+
+int dma_sdk_handle_launch(const dma_sdk_handle_t *handle, uint8_t *dst, const uint8_t *src)
+{
+    uint8_t channel = handle->channel;
+
+    if ((((uintptr_t)dst | (uintptr_t)src) & handle->align_mask) || !dma_is_ready(channel))
+    {
+        return -1;
+    }
+
+    volatile dma *peri = dma_ch_peri(channel);
+
+    /*
+     * LOAD THE REGISTER IMAGE
+     * Whole registers are written, without read-modify-write, and only if
+     * another transaction was loaded since the last launch of this handle.
+     */
+    if (dma_sdk_loaded_handle[channel] != handle)
+    {
+        peri->SRC_PTR_INC_D1 = handle->src_inc_b;
+        peri->DST_PTR_INC_D1 = handle->dst_inc_b;
+        peri->SRC_PTR_INC_D2 = 0;
+        peri->DST_PTR_INC_D2 = 0;
+        peri->DIM_CONFIG = DMA_DIM_CONF_1D;
+        peri->DIM_INV = 0;
+        peri->SLOT = 0;
+        peri->SRC_DATA_TYPE = handle->src_type;
+        peri->DST_DATA_TYPE = handle->dst_type;
+        peri->SIGN_EXT = 0;
+        peri->MODE = DMA_TRANS_MODE_SINGLE;
+        peri->WIDE = 0;
+        peri->WINDOW_SIZE = handle->size_b;
+        peri->PAD_TOP = 0;
+        peri->PAD_BOTTOM = 0;
+        peri->PAD_LEFT = 0;
+        peri->PAD_RIGHT = 0;
+        peri->INTERRUPT_EN = 1 << DMA_INTERRUPT_EN_TRANSACTION_DONE_BIT;
+        dma_sdk_loaded_handle[channel] = handle;
+    }
+
+    /*
+     * REBASE THE POINTERS
+     */
+    peri->SRC_PTR = (uint32_t)src;
+    peri->DST_PTR = (uint32_t)dst;
+
+    /* Load the size and start the transaction. */
+    uint32_t mstatus = sync_irq_save();
+    peri->SIZE_D1 = handle->size_b;
+    dma_expect_trans_done(channel);
+    sync_irq_restore(mstatus);
+
+    return 0;
+}
+
+int dma_sdk_handle_copy(const dma_sdk_handle_t *handle, uint8_t *dst, const uint8_t *src)
+{
+    if (dma_sdk_handle_launch(handle, dst, src) != 0)
+    {
+        return -1;
+    }
+
+    while (!dma_is_ready(handle->channel))
+    {
+        // disable_interrupts
+        // this does not prevent waking up the core as this is controlled by the MIP register
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        if (dma_is_ready(handle->channel) == 0)
+        {
+            wait_for_interrupt();
+            // from here we wake up even if we did not jump to the ISR
+        }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+
+    return 0;
+}
+
+void dma_sdk_handle_invalidate(uint8_t channel)
+{
+    dma_sdk_loaded_handle[channel] = NULL;
+}
+
+int dma_sdk_channel_alloc(void)
+{
+    int channel = -1;
+
+    // The interrupts are disabled so that a handler cannot take the same channel
+    uint32_t mstatus = sync_irq_save();
+    for (uint8_t ch = 0; ch < DMA_CH_NUM; ch++)
+    {
+        if (!(dma_sdk_channels_used & (1 << ch)))
+        {
+            dma_sdk_channels_used |= (1 << ch);
+            channel = ch;
+            // The HAL state of a channel is reset once, by its first allocation. The
+            // other channels are left to the application, which may drive them
+            // through the HAL
+            if (!(dma_sdk_channels_init & (1 << ch)))
+            {
+                dma_init_channel(ch);
+                dma_sdk_channels_init |= (1 << ch);
+            }
+            break;
+        }
+    }
+    sync_irq_restore(mstatus);
+
+    return channel;
+}
+
+void dma_sdk_channel_free(uint8_t channel)
+{
+    uint32_t mstatus = sync_irq_save();
+    dma_sdk_channels_used &= ~(1 << channel);
+    sync_irq_restore(mstatus);
+}
+
+int dma_sdk_is_done(dma_sdk_ticket_t ticket)
+{
+    if (ticket < 0)
+    {
+        return 1;
+    }
+
+    // A ticket is done once its channel runs another copy or is idle
+    uint8_t channel = ticket & 0xFF;
+    return !(dma_sdk_async[channel].busy && dma_sdk_async[channel].ticket == ticket);
+}
+
+void dma_sdk_wait(dma_sdk_ticket_t ticket)
+{
+    while (!dma_sdk_is_done(ticket))
+    {
+        // disable_interrupts
+        // this does not prevent waking up the core as this is controlled by the MIP register
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        if (!dma_sdk_is_done(ticket))
+        {
+            wait_for_interrupt();
+            // from here we wake up even if we did not jump to the ISR
+        }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+}
+
+void dma_sdk_fence(void)
+{
+    for (uint8_t ch = 0; ch < DMA_CH_NUM; ch++)
+    {
+        while (dma_sdk_async[ch].busy)
+        {
+            CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+            if (dma_sdk_async[ch].busy)
+            {
+                wait_for_interrupt();
+            }
+            CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+        }
+    }
+}
+
 // DMA interrupt handler
-void dma_sdk_intr_handler_trans_done()
+void dma_sdk_intr_handler_trans_done(uint8_t channel)
 {
     dma_sdk_intr_flag = 1;
+
+    // A chunk of an asynchronous copy has been copied, the next one follows
+    if (dma_sdk_async[channel].busy && dma_sdk_async[channel].left_b != 0)
+    {
+        dma_sdk_async_next_chunk(channel);
+        return;
+    }
+
+    // The channel of a finished asynchronous copy is released before calling
+    // the callback, so that the callback can launch the next copy
+    if (dma_sdk_async[channel].busy)
+    {
+        dma_sdk_callback_t callback = dma_sdk_async[channel].callback;
+        void *arg = dma_sdk_async[channel].arg;
+        dma_sdk_ticket_t ticket = dma_sdk_async[channel].ticket;
+
+        dma_sdk_async[channel].busy = 0;
+        dma_sdk_channel_free(channel);
+
+        if (callback != NULL)
+        {
+            callback(ticket, arg);
+        }
+    }
 }
@@ -15,6 +15,37 @@
 
 #include "dma.h"
 
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Register image of a validated memory-to-memory transaction, that can
+ * be launched again with other source and destination pointers.
+ */
+typedef struct
+{
+    uint32_t size_b;      /*!< Size of the copy in bytes (SIZE_D1). */
+    uint32_t src_inc_b;   /*!< Source increment in bytes (SRC_PTR_INC_D1). */
+    uint32_t dst_inc_b;   /*!< Destination increment in bytes (DST_PTR_INC_D1). */
+    uint32_t src_type;    /*!< Source data type (SRC_DATA_TYPE). */
+    uint32_t dst_type;    /*!< Destination data type (DST_DATA_TYPE). */
+    uint32_t align_mask;  /*!< Pointers must have these bits cleared. */
+    uint8_t channel;      /*!< DMA channel where the handle is launched. */
+} dma_sdk_handle_t;
+
+/**
+ * @brief Ticket of an asynchronous copy, to wait for it to finish.
+ * Negative tickets are invalid and are always done.
+ */
+typedef int32_t dma_sdk_ticket_t;
+
+/**
+ * @brief Completion callback of an asynchronous copy, called from the DMA
+ * interrupt handler once the copy has finished.
+ */
+typedef void (*dma_sdk_callback_t)(dma_sdk_ticket_t ticket, void *arg);
+
 /********************************/
 /* ---- EXPORTED VARIABLES ---- */
 /********************************/
@@ -73,10 +104,144 @@ void dma_fill(uint32_t *dst, uint32_t *value, uint32_t size);
  */
 void dma_copy_16_32(uint32_t *dst, uint16_t *src, uint32_t size);
 
+/**
+ * @brief Start copying data words from source address to destination
+ * address, without waiting for the copy to finish.
+ * The source and destination buffers must not be used until the copy is done.
+ * A copy larger than the 16-bit SIZE_D1 register is launched as chunks of
+ * DMA_SPLIT_CHUNK_B bytes, each one by the interrupt of the previous one. The
+ * same holds for the other copies and fills.
+ *
+ * @param dst Destination address
+ * @param src Source address
+ * @param size Number of words (not bytes) to copy
+ * @param callback Called from the interrupt handler when the copy is done, or NULL
+ * @param arg Argument passed to the callback
+ * @return dma_sdk_ticket_t Ticket of the copy
+ */
+dma_sdk_ticket_t dma_copy_32b_async(uint32_t *dst, uint32_t *src, uint32_t size,
+                                    dma_sdk_callback_t callback, void *arg);
+
+/**
+ * @brief Start filling a memory region with a 32-bit value, without waiting
+ * for the fill to finish.
+ *
+ * @param dst Destination address
+ * @param value Pointer to the value to fill the memory with
+ * @param size Number of words (not bytes) to fill
+ * @param callback Called from the interrupt handler when the fill is done, or NULL
+ * @param arg Argument passed to the callback
+ * @return dma_sdk_ticket_t Ticket of the fill
+ */
+dma_sdk_ticket_t dma_fill_async(uint32_t *dst, uint32_t *value, uint32_t size,
+                                dma_sdk_callback_t callback, void *arg);
+
+/**
+ * @brief Start copying data from source address to destination address
+ * (16-bit aligned), without waiting for the copy to finish.
+ *
+ * @param dst Destination address (32-bit aligned)
+ * @param src Source address (16-bit aligned)
+ * @param size Number of bytes to copy
+ * @param callback Called from the interrupt handler when the copy is done, or NULL
+ * @param arg Argument passed to the callback
+ * @return dma_sdk_ticket_t Ticket of the copy
+ */
+dma_sdk_ticket_t dma_copy_16_32_async(uint32_t *dst, uint16_t *src, uint32_t size,
+                                      dma_sdk_callback_t callback, void *arg);
+
+/**
+ * @brief Check whether an asynchronous copy has finished
+ *
+ * @param ticket Ticket returned by the asynchronous function
+ * @return int 1 if the copy is done, 0 otherwise
+ */
+int dma_sdk_is_done(dma_sdk_ticket_t ticket);
+
+/**
+ * @brief Sleep until an asynchronous copy has finished
+ *
+ * @param ticket Ticket returned by the asynchronous function
+ */
+void dma_sdk_wait(dma_sdk_ticket_t ticket);
+
+/**
+ * @brief Sleep until all the asynchronous copies have finished
+ */
+void dma_sdk_fence(void);
+
+/**
+ * @brief Validate a memory-to-memory copy once and save its register image
+ * in a handle, to launch it again later with other pointers.
+ * The full validation of the HAL (alignment, outbound and overlap checks) is
+ * performed with the given pointers. The copy is launched at once, so it must
+ * fit the SIZE_D1 register (64kB).
+ *
+ * @param handle Handle to initialize
+ * @param channel DMA channel where the handle is launched, e.g. taken with
+ * dma_sdk_channel_alloc()
+ * @param dst Destination address used for the validation
+ * @param src Source address used for the validation
+ * @param size_du Number of data units to copy
+ * @param type Data type of the source and destination
+ * @return int 0 if success, -1 if the transaction is not valid or too large
+ */
+int dma_sdk_handle_init(dma_sdk_handle_t *handle, const uint8_t channel, const uint8_t *dst, const uint8_t *src, const size_t size_du, const dma_data_type_t type);
+
+/**
+ * @brief Launch the transaction of a handle with new source and destination
+ * pointers, without waiting for it to finish.
+ * Only the alignment of the new pointers is checked. If the same handle was
+ * the last one launched, only the pointers and the size are written.
+ *
+ * @param handle Handle initialized by dma_sdk_handle_init()
+ * @param dst Destination address
+ * @param src Source address
+ * @return int 0 if success, -1 if a pointer is misaligned or the DMA is busy
+ */
+int dma_sdk_handle_launch(const dma_sdk_handle_t *handle, uint8_t *dst, const uint8_t *src);
+
+/**
+ * @brief Launch the transaction of a handle with new source and destination
+ * pointers, and wait for it to finish.
+ *
+ * @param handle Handle initialized by dma_sdk_handle_init()
+ * @param dst Destination address
+ * @param src Source address
+ * @return int 0 if success, -1 if a pointer is misaligned or the DMA is busy
+ */
+int dma_sdk_handle_copy(const dma_sdk_handle_t *handle, uint8_t *dst, const uint8_t *src);
+
+/**
+ * @brief Forget the last handle launched in a channel, so the next launch
+ * writes its whole register image. Must be called after configuring the
+ * channel through the HAL (the other functions of this file already do it).
+ *
+ * @param channel DMA channel
+ */
+void dma_sdk_handle_invalidate(uint8_t channel);
+
+/**
+ * @brief Take a free DMA channel, to use it without interfering with the
+ * other users of the DMA. The copy functions of this file take a channel for
+ * the duration of the copy, waiting for one to be free.
+ *
+ * @return int The channel, or -1 if all the DMA_CH_NUM channels are taken
+ */
+int dma_sdk_channel_alloc(void);
+
+/**
+ * @brief Release a channel taken with dma_sdk_channel_alloc()
+ *
+ * @param channel DMA channel
+ */
+void dma_sdk_channel_free(uint8_t channel);
+
 /**
  * @brief DMA interrupt handler (overrides the weak one from dma.c)
  * 
+ * @param channel DMA channel whose transaction has finished
  */
-void dma_sdk_intr_handler_trans_done();
+void dma_sdk_intr_handler_trans_done(uint8_t channel);
 
 #endif /* DMA_UTIL_H_ */
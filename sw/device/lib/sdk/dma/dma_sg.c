@@ -0,0 +1,191 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_sg.c
+// Description: Scatter and gather DMA copies between a buffer and a list of fragments
+
+#include "dma_sg.h"
+#include "dma_sdk.h"
+#include "dma.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// Fill a descriptor copying size_b contiguous bytes, with the largest data
+// type allowed by the alignment of the pointers and of the size
+static int dma_sg_desc(dma_sg_desc_t *desc, uint8_t *dst, const uint8_t *src, uint32_t size_b)
+{
+    uint32_t align = (uintptr_t)dst | (uintptr_t)src | size_b;
+    dma_data_type_t type = (align & 0x3) == 0   ? DMA_DATA_TYPE_WORD
+                           : (align & 0x1) == 0 ? DMA_DATA_TYPE_HALF_WORD
+                                                : DMA_DATA_TYPE_BYTE;
+
+    uint32_t size_du = size_b / DMA_DATA_TYPE_2_SIZE(type);
+    if (size_du >= 65536)
+    {
+        return -1;
+    }
+
+    desc->src = (dma_target_t){
+        .ptr = (uint8_t *)src,
+        .inc_du = 1,
+        .size_du = size_du,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    desc->dst = (dma_target_t){
+        .ptr = dst,
+        .inc_du = 1,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    desc->trans = (dma_trans_t){
+        .src = &desc->src,
+        .dst = &desc->dst,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .dim = DMA_DIM_CONF_1D,
+        .win_du = 0,
+        .end = DMA_TRANS_END_INTR,
+    };
+    return 0;
+}
+
+// Run descriptors through the transaction queue of a free channel
+static int dma_sg_run(dma_sg_desc_t *plan, uint32_t length)
+{
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+
+    int res = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        plan[i].trans.channel = (uint8_t)channel;
+        plan[i].trans.flags = DMA_CONFIG_OK;
+
+        // The descriptors are valid by construction, only the critical checks are kept
+        if (dma_enqueue_transaction(&plan[i].trans, DMA_DO_NOT_ENABLE_REALIGN,
+                                    DMA_PERFORM_CHECKS_ONLY_CRITICAL) & DMA_CONFIG_CRITICAL_ERROR)
+        {
+            res = -1;
+            break;
+        }
+    }
+
+    dma_queue_wait((uint8_t)channel);
+
+    // The registers no longer hold the image of an SDK handle
+    dma_sdk_handle_invalidate((uint8_t)channel);
+    dma_sdk_channel_free((uint8_t)channel);
+
+    return res;
+}
+
+// Fill the address table and the ADDRESS mode descriptor of a scatter.
+// Returns -1 if the fragments cannot be scattered this way.
+static int dma_sg_scatter_addr(const uint8_t *src, const dma_sg_frag_t *frags, uint32_t count,
+                               uint32_t *addr_table, uint32_t table_len, dma_sg_desc_t *desc)
+{
+    uint32_t words = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (frags[i].size_b != 0 && (((uintptr_t)frags[i].ptr | frags[i].size_b) & 0x3))
+        {
+            return -1;
+        }
+        words += frags[i].size_b >> 2;
+    }
+    if (addr_table == NULL || ((uintptr_t)src & 0x3) || words == 0 || words > table_len || words >= 65536)
+    {
+        return -1;
+    }
+
+    uint32_t *addr = addr_table;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t off = 0; off < frags[i].size_b; off += 4)
+        {
+            *addr++ = (uint32_t)(frags[i].ptr + off);
+        }
+    }
+
+    desc->src = (dma_target_t){
+        .ptr = (uint8_t *)src,
+        .inc_du = 1,
+        .size_du = words,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    // Only the type of the destination is used, the addresses come from the table
+    desc->dst = (dma_target_t){
+        .ptr = (uint8_t *)addr_table[0],
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    desc->addr = (dma_target_t){
+        .ptr = (uint8_t *)addr_table,
+        .inc_du = 1,
+        .size_du = words,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    desc->trans = (dma_trans_t){
+        .src = &desc->src,
+        .dst = &desc->dst,
+        .src_addr = &desc->addr,
+        .mode = DMA_TRANS_MODE_ADDRESS,
+        .dim = DMA_DIM_CONF_1D,
+        .win_du = 0,
+        .end = DMA_TRANS_END_INTR,
+    };
+    return 0;
+}
+
+int dma_sg_scatter(const uint8_t *src, const dma_sg_frag_t *frags, uint32_t count,
+                   uint32_t *addr_table, uint32_t table_len, dma_sg_desc_t *plan)
+{
+    if (dma_sg_scatter_addr(src, frags, count, addr_table, table_len, &plan[0]) == 0)
+    {
+        return dma_sg_run(plan, 1);
+    }
+
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (frags[i].size_b == 0)
+        {
+            continue;
+        }
+        if (dma_sg_desc(&plan[length++], frags[i].ptr, src, frags[i].size_b) != 0)
+        {
+            return -1;
+        }
+        src += frags[i].size_b;
+    }
+
+    return dma_sg_run(plan, length);
+}
+
+int dma_sg_gather(uint8_t *dst, const dma_sg_frag_t *frags, uint32_t count, dma_sg_desc_t *plan)
+{
+    uint32_t length = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (frags[i].size_b == 0)
+        {
+            continue;
+        }
+        if (dma_sg_desc(&plan[length++], dst, frags[i].ptr, frags[i].size_b) != 0)
+        {
+            return -1;
+        }
+        dst += frags[i].size_b;
+    }
+
+    return dma_sg_run(plan, length);
+}
@@ -0,0 +1,83 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_sg.h
+// Description: Scatter and gather DMA copies between a buffer and a list of fragments
+
+#ifndef DMA_SG_H_
+#define DMA_SG_H_
+
+#include <stdint.h>
+
+#include "dma.h"
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief A piece of memory to scatter to or gather from.
+ */
+typedef struct
+{
+    uint8_t *ptr;    // Start of the fragment
+    uint32_t size_b; // Size of the fragment in bytes
+} dma_sg_frag_t;
+
+/**
+ * @brief One transaction of a scatter or gather, with its own targets. The
+ * fields are private, the array only provides the memory of the transactions.
+ */
+typedef struct
+{
+    dma_target_t src;
+    dma_target_t dst;
+    dma_target_t addr;
+    dma_trans_t trans;
+} dma_sg_desc_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Copy a contiguous buffer into a list of fragments, one after another,
+ * and sleep until the copy has finished.
+ *
+ * If an address table is given, the fragments and the source are word aligned
+ * and the table can hold one address per copied word, a single ADDRESS mode
+ * transaction is used: the table is filled with the address of each word of
+ * the fragments, and the DMA writes each source word at its address. This is
+ * the fastest for many short fragments. Otherwise a transaction is chained per
+ * fragment, with the largest data type allowed by its alignment.
+ *
+ * @param src Source buffer, as long as all the fragments together
+ * @param frags Destination fragments, empty fragments are skipped
+ * @param count Number of fragments
+ * @param addr_table Word-aligned memory of table_len words for the addresses,
+ * or NULL to always chain transactions
+ * @param table_len Number of words of addr_table
+ * @param plan Memory of count descriptors
+ * @return int 0 if success, -1 if no channel is free or a fragment is too
+ * large for a transaction (65536 data units or more)
+ */
+int dma_sg_scatter(const uint8_t *src, const dma_sg_frag_t *frags, uint32_t count,
+                   uint32_t *addr_table, uint32_t table_len, dma_sg_desc_t *plan);
+
+/**
+ * @brief Copy a list of fragments, one after another, into a contiguous
+ * buffer and sleep until the copy has finished. The DMA can only take the
+ * destination addresses from a table, so a transaction is chained per
+ * fragment, with the largest data type allowed by its alignment.
+ *
+ * @param dst Destination buffer, as long as all the fragments together
+ * @param frags Source fragments, empty fragments are skipped
+ * @param count Number of fragments
+ * @param plan Memory of count descriptors
+ * @return int 0 if success, -1 if no channel is free or a fragment is too
+ * large for a transaction (65536 data units or more)
+ */
+int dma_sg_gather(uint8_t *dst, const dma_sg_frag_t *frags, uint32_t count, dma_sg_desc_t *plan);
+
+#endif /* DMA_SG_H_ */
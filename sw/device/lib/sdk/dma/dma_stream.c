@@ -0,0 +1,212 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_stream.c
+// Description: Continuous DMA capture into a ring of buffers
+
+#include "dma_stream.h"
+#include "dma_sdk.h"
+#include "dma.h"
+#include "hart.h"
+#include "csr.h"
+#include "rv_plic.h"
+#include "core_v_mini_mcu.h"
+
+/******************************/
+/* ---- GLOBAL VARIABLES ---- */
+/******************************/
+
+/* Stream running in each channel, NULL if none. */
+static dma_stream_t *volatile dma_streams[DMA_CH_NUM];
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// Account for the windows copied since the last call, must run with the interrupts disabled
+static void dma_stream_update(dma_stream_t *stream)
+{
+    uint32_t count = dma_get_window_count(stream->channel);
+
+    // The window count restarts from 0 with each lap of the ring
+    uint32_t windows = count >= stream->window_count
+                           ? count - stream->window_count
+                           : stream->buffer_count - stream->window_count + count;
+    stream->window_count = count;
+
+    for (uint32_t i = 0; i < windows; i++)
+    {
+        uint32_t index = stream->produced;
+        uint8_t *buffer = stream->ring + (index % stream->buffer_count) * stream->buffer_b;
+        stream->produced = index + 1;
+
+        // The DMA is now filling the buffer of index + 1 - buffer_count, which
+        // is dropped if the consumer still did not release it
+        if (stream->produced - stream->consumed >= stream->buffer_count)
+        {
+            stream->overruns++;
+            stream->consumed = stream->produced - stream->buffer_count + 1;
+        }
+
+        if (stream->callback != NULL)
+        {
+            stream->callback(stream, buffer, index, stream->arg);
+        }
+    }
+}
+
+int dma_stream_init(dma_stream_t *stream, uint8_t *ring, uint32_t buffer_du, uint32_t buffer_count,
+                    dma_data_type_t type, uint8_t *src, uint32_t src_inc_du,
+                    dma_trigger_slot_mask_t trig, dma_stream_callback_t callback, void *arg)
+{
+    if (buffer_count < 2 || buffer_du == 0)
+    {
+        return -1;
+    }
+
+    stream->ring = ring;
+    stream->buffer_b = buffer_du * DMA_DATA_TYPE_2_SIZE(type);
+    stream->buffer_count = buffer_count;
+    stream->callback = callback;
+    stream->arg = arg;
+    stream->running = 0;
+
+    stream->src = (dma_target_t){
+        .ptr = src,
+        .inc_du = src_inc_du,
+        .size_du = buffer_du * buffer_count,
+        .trig = trig,
+        .type = type,
+    };
+    stream->dst = (dma_target_t){
+        .ptr = ring,
+        .inc_du = 1,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    stream->trans = (dma_trans_t){
+        .src = &stream->src,
+        .dst = &stream->dst,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_CIRCULAR,
+        .win_du = buffer_du,
+        .end = DMA_TRANS_END_INTR,
+    };
+
+    return 0;
+}
+
+int dma_stream_start(dma_stream_t *stream)
+{
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+
+    stream->channel = (uint8_t)channel;
+    stream->trans.channel = (uint8_t)channel;
+    stream->produced = 0;
+    stream->consumed = 0;
+    stream->overruns = 0;
+    stream->window_count = 0;
+
+    // Only the critical errors are refused, the window size may raise a warning
+    dma_validate_transaction(&stream->trans, DMA_DO_NOT_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    if (stream->trans.flags & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        dma_sdk_channel_free(stream->channel);
+        return -1;
+    }
+
+    plic_irq_set_priority(DMA_WINDOW_INTR, 1);
+    plic_irq_set_enabled(DMA_WINDOW_INTR, kPlicToggleEnabled);
+
+    dma_streams[stream->channel] = stream;
+    stream->running = 1;
+
+    if (dma_load_transaction(&stream->trans) != DMA_CONFIG_OK || dma_launch(&stream->trans) != DMA_CONFIG_OK)
+    {
+        stream->running = 0;
+        dma_streams[stream->channel] = NULL;
+        dma_sdk_channel_free(stream->channel);
+        return -1;
+    }
+
+    return 0;
+}
+
+uint8_t *dma_stream_get(dma_stream_t *stream)
+{
+    uint32_t consumed = stream->consumed;
+    if (stream->produced == consumed)
+    {
+        return NULL;
+    }
+    return stream->ring + (consumed % stream->buffer_count) * stream->buffer_b;
+}
+
+void dma_stream_release(dma_stream_t *stream)
+{
+    // The handler may drop buffers meanwhile. The previous state of the
+    // interrupts is restored, as this can be called from the callback.
+    uint32_t mstatus;
+    CSR_READ(CSR_REG_MSTATUS, &mstatus);
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    if (stream->consumed != stream->produced)
+    {
+        stream->consumed++;
+    }
+    if (mstatus & 0x8)
+    {
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+}
+
+uint32_t dma_stream_overruns(dma_stream_t *stream)
+{
+    return stream->overruns;
+}
+
+void dma_stream_stop(dma_stream_t *stream)
+{
+    if (!stream->running)
+    {
+        return;
+    }
+
+    dma_stop_circular(stream->channel);
+
+    while (!dma_is_ready(stream->channel))
+    {
+        // disable_interrupts
+        // this does not prevent waking up the core as this is controlled by the MIP register
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        if (dma_is_ready(stream->channel) == 0)
+        {
+            wait_for_interrupt();
+            // from here we wake up even if we did not jump to the ISR
+        }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+
+    // The interrupts of the last windows may still be pending in the PLIC
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+    dma_stream_update(stream);
+    dma_streams[stream->channel] = NULL;
+    stream->running = 0;
+    CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+
+    dma_sdk_channel_free(stream->channel);
+}
+
+// DMA window interrupt handler of the SDK (overrides the weak one from dma.c)
+void dma_sdk_intr_handler_window_done(uint8_t channel)
+{
+    dma_stream_t *stream = dma_streams[channel];
+    if (stream != NULL)
+    {
+        dma_stream_update(stream);
+    }
+}
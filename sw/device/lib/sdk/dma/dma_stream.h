@@ -0,0 +1,122 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_stream.h
+// Description: Continuous DMA capture into a ring of buffers
+
+#ifndef DMA_STREAM_H_
+#define DMA_STREAM_H_
+
+#include <stdint.h>
+
+#include "dma.h"
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+typedef struct dma_stream dma_stream_t;
+
+/**
+ * @brief Called from the window interrupt handler when a buffer of the ring
+ * has been filled.
+ *
+ * @param stream Stream of the buffer
+ * @param buffer The filled buffer
+ * @param index Number of buffers filled before this one since the start
+ * @param arg Argument given to dma_stream_init()
+ */
+typedef void (*dma_stream_callback_t)(dma_stream_t *stream, uint8_t *buffer, uint32_t index, void *arg);
+
+/**
+ * @brief Ring of buffers filled by a circular DMA transaction, one window per
+ * buffer. The fields are private, the stream must stay allocated while it runs.
+ */
+struct dma_stream
+{
+    uint8_t *ring;                  // The buffers, one after another
+    uint32_t buffer_b;              // Size of a buffer in bytes
+    uint32_t buffer_count;          // Number of buffers in the ring
+    dma_stream_callback_t callback; // Called when a buffer is filled, or NULL
+    void *arg;                      // Argument of the callback
+    dma_target_t src;               // The HAL keeps pointers to the targets
+    dma_target_t dst;               // and to the transaction while it runs
+    dma_trans_t trans;
+    volatile uint32_t produced;     // Buffers filled since the start
+    volatile uint32_t consumed;     // Buffers released or dropped
+    volatile uint32_t overruns;     // Buffers dropped because the consumer fell behind
+    volatile uint32_t window_count; // Last window count read in the transaction
+    volatile uint8_t running;
+    uint8_t channel;
+};
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Set up a stream, copying from a source (usually a peripheral FIFO)
+ * into a ring of buffers.
+ *
+ * @param stream Stream to initialize
+ * @param ring Memory of the ring, buffer_count * buffer_du data units
+ * @param buffer_du Number of data units of a buffer
+ * @param buffer_count Number of buffers in the ring, at least 2
+ * @param type Data type of the source and of the buffers
+ * @param src Source address
+ * @param src_inc_du Source increment in data units, 0 for a FIFO
+ * @param trig Trigger slot of the source, DMA_TRIG_MEMORY for a memory
+ * @param callback Called from the interrupt handler when a buffer is filled, or NULL
+ * @param arg Argument passed to the callback
+ * @return int 0 if success, -1 if the ring is not valid
+ */
+int dma_stream_init(dma_stream_t *stream, uint8_t *ring, uint32_t buffer_du, uint32_t buffer_count,
+                    dma_data_type_t type, uint8_t *src, uint32_t src_inc_du,
+                    dma_trigger_slot_mask_t trig, dma_stream_callback_t callback, void *arg);
+
+/**
+ * @brief Take a free DMA channel and start filling the ring, until
+ * dma_stream_stop() is called. The window interrupt of the DMA is enabled in
+ * the PLIC, which must have been initialized with plic_Init().
+ *
+ * @param stream Stream initialized by dma_stream_init()
+ * @return int 0 if success, -1 if no channel is free or the transaction is not valid
+ */
+int dma_stream_start(dma_stream_t *stream);
+
+/**
+ * @brief Get the oldest filled buffer that has not been released yet.
+ *
+ * @param stream Running stream
+ * @return uint8_t* The buffer, or NULL if no buffer is ready
+ */
+uint8_t *dma_stream_get(dma_stream_t *stream);
+
+/**
+ * @brief Release the buffer returned by dma_stream_get(), so the DMA can fill
+ * it again.
+ *
+ * @param stream Running stream
+ */
+void dma_stream_release(dma_stream_t *stream);
+
+/**
+ * @brief Get the number of buffers dropped because the DMA wrapped around the
+ * ring before the consumer released them.
+ *
+ * @param stream Stream
+ * @return uint32_t Number of dropped buffers since the start
+ */
+uint32_t dma_stream_overruns(dma_stream_t *stream);
+
+/**
+ * @brief Stop the stream once the DMA reaches the end of the ring, and release
+ * its channel. Sleeps until the last transaction has finished; the buffers
+ * filled until then can still be taken with dma_stream_get().
+ *
+ * @param stream Running stream
+ */
+void dma_stream_stop(dma_stream_t *stream);
+
+#endif /* DMA_STREAM_H_ */
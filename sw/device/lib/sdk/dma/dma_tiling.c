@@ -0,0 +1,248 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_tiling.c
+// Description: Tile extraction and im2col planned as sequences of 2D DMA transactions
+
+#include "dma_tiling.h"
+#include "dma_sdk.h"
+#include "dma.h"
+
+/******************************/
+/* ---- GLOBAL VARIABLES ---- */
+/******************************/
+
+/* Source of the descriptors made only of padding. */
+static const uint32_t dma_tiling_zero = 0;
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// Split count positions origin + i * step along a dimension of extent elements
+// into the ones before the start, inside, and after the end of the dimension.
+// Returns the number of positions inside.
+static uint32_t dma_tiling_clip(int32_t origin, uint32_t step, uint32_t count, uint32_t extent,
+                                uint32_t *lead, uint32_t *trail)
+{
+    *lead = 0;
+    *trail = count;
+    if (origin >= (int32_t)extent)
+    {
+        return 0;
+    }
+
+    if (origin < 0)
+    {
+        *lead = ((uint32_t)(-origin) + step - 1) / step;
+        if (*lead >= count)
+        {
+            *lead = count;
+            *trail = 0;
+            return 0;
+        }
+    }
+
+    uint32_t last = (uint32_t)((int32_t)extent - 1 - origin) / step;
+    *trail = last >= count - 1 ? 0 : count - 1 - last;
+    return count - *lead - *trail;
+}
+
+// Fill a descriptor copying rows x cols elements from src, with the given
+// paddings around them. The destination rows follow each other, with a
+// distance of dst_inc_du between all the elements.
+static int dma_tiling_desc(dma_tiling_desc_t *desc, dma_data_type_t type,
+                           const uint8_t *src, uint32_t src_inc_du, uint32_t src_row_du,
+                           uint8_t *dst, uint32_t dst_inc_du, uint32_t rows, uint32_t cols,
+                           uint32_t top, uint32_t bottom, uint32_t left, uint32_t right)
+{
+    if (dst_inc_du >= 64)
+    {
+        return -1;
+    }
+
+    desc->dst = (dma_target_t){
+        .ptr = dst,
+        .inc_du = dst_inc_du,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    desc->trans = (dma_trans_t){
+        .src = &desc->src,
+        .dst = &desc->dst,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .win_du = 0,
+        .end = DMA_TRANS_END_INTR,
+    };
+
+    if (rows == 0 || cols == 0)
+    {
+        // Only padding: the zero is read again for every element
+        uint32_t size_du = (rows + top + bottom) * (cols + left + right);
+        if (size_du >= 65536)
+        {
+            return -1;
+        }
+        desc->src = (dma_target_t){
+            .ptr = (uint8_t *)&dma_tiling_zero,
+            .inc_du = 0,
+            .size_du = size_du,
+            .trig = DMA_TRIG_MEMORY,
+            .type = type,
+        };
+        desc->dst.size_du = size_du;
+        desc->trans.dim = DMA_DIM_CONF_1D;
+        return 0;
+    }
+
+    // The D2 increments go from the last element of a row to the first of the next one
+    uint32_t src_inc_d2_du = src_row_du - (cols - 1) * src_inc_du;
+    if (src_inc_du >= 64 || src_inc_d2_du >= 4194304 || rows >= 65536 || cols >= 65536
+        || top >= 64 || bottom >= 64 || left >= 64 || right >= 64)
+    {
+        return -1;
+    }
+
+    desc->src = (dma_target_t){
+        .ptr = (uint8_t *)src,
+        .inc_du = src_inc_du,
+        .inc_d2_du = src_inc_d2_du,
+        .size_du = cols,
+        .size_d2_du = rows,
+        .trig = DMA_TRIG_MEMORY,
+        .type = type,
+    };
+    desc->dst.inc_d2_du = dst_inc_du;
+    desc->dst.size_du = cols + left + right;
+    desc->dst.size_d2_du = rows + top + bottom;
+    desc->trans.dim = DMA_DIM_CONF_2D;
+    desc->trans.pad_top_du = top;
+    desc->trans.pad_bottom_du = bottom;
+    desc->trans.pad_left_du = left;
+    desc->trans.pad_right_du = right;
+    return 0;
+}
+
+int dma_tiling_tile(dma_tiling_desc_t *desc, const uint8_t *src, uint16_t rows, uint16_t cols,
+                    int32_t row, int32_t col, uint16_t tile_rows, uint16_t tile_cols,
+                    dma_data_type_t type, uint8_t *dst)
+{
+    uint32_t top, bottom, left, right;
+    uint32_t valid_rows = dma_tiling_clip(row, 1, tile_rows, rows, &top, &bottom);
+    uint32_t valid_cols = dma_tiling_clip(col, 1, tile_cols, cols, &left, &right);
+
+    const uint8_t *first = src + ((row + (int32_t)top) * cols + col + (int32_t)left) * DMA_DATA_TYPE_2_SIZE(type);
+
+    return dma_tiling_desc(desc, type, first, 1, cols, dst, 1,
+                           valid_rows, valid_cols, top, bottom, left, right);
+}
+
+uint32_t dma_tiling_im2col_length(const dma_tiling_im2col_t *shape)
+{
+    return (uint32_t)shape->batch * shape->ch * shape->fh * shape->fw;
+}
+
+int dma_tiling_im2col(const dma_tiling_im2col_t *shape, const uint8_t *input, uint8_t *output,
+                      dma_tiling_desc_t *plan)
+{
+    uint32_t size_b = DMA_DATA_TYPE_2_SIZE(shape->type);
+    uint32_t patches_h = DMA_TILING_PATCHES(shape->ih, shape->fh, shape->stride, shape->pad);
+    uint32_t patches_w = DMA_TILING_PATCHES(shape->iw, shape->fw, shape->stride, shape->pad);
+    uint32_t patches = patches_h * patches_w;
+    uint32_t cols = (uint32_t)shape->ch * shape->fh * shape->fw;
+
+    // Distances in elements between neighbours of the input along each dimension
+    uint32_t w_du, h_du, c_du;
+    if (shape->format == DMA_TILING_NCHW)
+    {
+        w_du = 1;
+        h_du = shape->iw;
+        c_du = (uint32_t)shape->ih * shape->iw;
+    }
+    else
+    {
+        c_du = 1;
+        w_du = shape->ch;
+        h_du = (uint32_t)shape->iw * shape->ch;
+    }
+    uint32_t b_du = (uint32_t)shape->ch * shape->ih * shape->iw;
+
+    int n = 0;
+    for (uint32_t b = 0; b < shape->batch; b++)
+    {
+        for (uint32_t c = 0; c < cols; c++)
+        {
+            uint32_t fw = c % shape->fw;
+            uint32_t fh = (c / shape->fw) % shape->fh;
+            uint32_t ch = c / (shape->fh * shape->fw);
+
+            uint32_t top, bottom, left, right;
+            uint32_t rows = dma_tiling_clip((int32_t)fh - shape->pad, shape->stride, patches_h,
+                                            shape->ih, &top, &bottom);
+            uint32_t row_len = dma_tiling_clip((int32_t)fw - shape->pad, shape->stride, patches_w,
+                                               shape->iw, &left, &right);
+
+            // First input element that is not padding
+            uint32_t im_row = fh + top * shape->stride - shape->pad;
+            uint32_t im_col = fw + left * shape->stride - shape->pad;
+            const uint8_t *src = input + (b * b_du + ch * c_du + im_row * h_du + im_col * w_du) * size_b;
+
+            // NCHW outputs a row of patches per filter element, NHWC a row per patch
+            uint8_t *dst;
+            uint32_t dst_inc_du;
+            if (shape->format == DMA_TILING_NCHW)
+            {
+                dst = output + (c * shape->batch + b) * patches * size_b;
+                dst_inc_du = 1;
+            }
+            else
+            {
+                dst = output + (b * patches * cols + c) * size_b;
+                dst_inc_du = cols;
+            }
+
+            if (dma_tiling_desc(&plan[n], shape->type, src, shape->stride * w_du, shape->stride * h_du,
+                                dst, dst_inc_du, rows, row_len, top, bottom, left, right) != 0)
+            {
+                return -1;
+            }
+            n++;
+        }
+    }
+
+    return n;
+}
+
+int dma_tiling_run(dma_tiling_desc_t *plan, uint32_t length)
+{
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+
+    int res = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        plan[i].trans.channel = (uint8_t)channel;
+        plan[i].trans.flags = DMA_CONFIG_OK;
+
+        // The descriptors are valid by construction, only the critical checks are kept
+        if (dma_enqueue_transaction(&plan[i].trans, DMA_DO_NOT_ENABLE_REALIGN,
+                                    DMA_PERFORM_CHECKS_ONLY_CRITICAL) & DMA_CONFIG_CRITICAL_ERROR)
+        {
+            res = -1;
+            break;
+        }
+    }
+
+    dma_queue_wait((uint8_t)channel);
+
+    // The registers no longer hold the image of an SDK handle
+    dma_sdk_handle_invalidate((uint8_t)channel);
+    dma_sdk_channel_free((uint8_t)channel);
+
+    return res;
+}
@@ -0,0 +1,129 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dma_tiling.h
+// Description: Tile extraction and im2col planned as sequences of 2D DMA transactions
+
+#ifndef DMA_TILING_H_
+#define DMA_TILING_H_
+
+#include <stdint.h>
+
+#include "dma.h"
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Layout of the input tensor of an im2col.
+ */
+typedef enum
+{
+    DMA_TILING_NCHW = 0, // Batch, channel, row, column
+    DMA_TILING_NHWC = 1, // Batch, row, column, channel
+} dma_tiling_format_t;
+
+/**
+ * @brief Shape of an im2col: input tensor, filter, stride and padding. The
+ * output has one row per patch (NHWC) or one row per filter element (NCHW),
+ * as the im2col of im2col.h.
+ */
+typedef struct
+{
+    dma_tiling_format_t format;
+    dma_data_type_t type; // Type of the input and output elements
+    uint16_t batch;
+    uint16_t ch;
+    uint16_t ih;          // Input height
+    uint16_t iw;          // Input width
+    uint16_t fh;          // Filter height
+    uint16_t fw;          // Filter width
+    uint16_t stride;      // Same stride along both dimensions
+    uint16_t pad;         // Zeros added on each border of the input
+} dma_tiling_im2col_t;
+
+/**
+ * @brief One 2D transaction of a plan, with its own targets. The fields are
+ * private, the descriptors must stay allocated until the plan has run.
+ */
+typedef struct
+{
+    dma_target_t src;
+    dma_target_t dst;
+    dma_trans_t trans;
+} dma_tiling_desc_t;
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief Number of patches of an im2col along a dimension.
+ */
+#define DMA_TILING_PATCHES(in, f, stride, pad) (((in) + 2 * (pad) - (f)) / (stride) + 1)
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Plan the copy of a tile of a row-major matrix into a contiguous
+ * buffer. The tile may go beyond the borders of the matrix, the elements
+ * outside of it are set to zero by the padding of the DMA.
+ *
+ * @param desc Descriptor to fill
+ * @param src Matrix
+ * @param rows Number of rows of the matrix
+ * @param cols Number of columns of the matrix
+ * @param row Row of the top left corner of the tile, may be negative
+ * @param col Column of the top left corner of the tile, may be negative
+ * @param tile_rows Number of rows of the tile
+ * @param tile_cols Number of columns of the tile
+ * @param type Type of the elements
+ * @param dst Buffer of tile_rows * tile_cols elements
+ * @return int 0 if success, -1 if the tile cannot be copied by the DMA (e.g.
+ * a padding of 64 elements or more)
+ */
+int dma_tiling_tile(dma_tiling_desc_t *desc, const uint8_t *src, uint16_t rows, uint16_t cols,
+                    int32_t row, int32_t col, uint16_t tile_rows, uint16_t tile_cols,
+                    dma_data_type_t type, uint8_t *dst);
+
+/**
+ * @brief Get the number of descriptors of the plan of an im2col, one per
+ * filter element, channel and batch.
+ *
+ * @param shape Shape of the im2col
+ * @return uint32_t Number of descriptors
+ */
+uint32_t dma_tiling_im2col_length(const dma_tiling_im2col_t *shape);
+
+/**
+ * @brief Plan an im2col. Each descriptor gathers one filter element of
+ * one channel over all the patches, with the stride as source increment and
+ * the padding of the DMA for the patches that overlap the borders.
+ *
+ * @param shape Shape of the im2col
+ * @param input Input tensor
+ * @param output Output matrix, ch * fh * fw * batch * patches elements
+ * @param plan Array of dma_tiling_im2col_length() descriptors
+ * @return int Number of descriptors if success, -1 if the shape cannot be
+ * copied by the DMA (increments of 64 elements or more, paddings of more than
+ * 63 patches, more than 65535 patches)
+ */
+int dma_tiling_im2col(const dma_tiling_im2col_t *shape, const uint8_t *input, uint8_t *output,
+                      dma_tiling_desc_t *plan);
+
+/**
+ * @brief Run a plan on a free DMA channel through the transaction queue, and
+ * sleep until it has finished. The plan can be run again as long as the
+ * buffers do not move.
+ *
+ * @param plan Descriptors
+ * @param length Number of descriptors
+ * @return int 0 if success, -1 if no channel is free or a descriptor was refused
+ */
+int dma_tiling_run(dma_tiling_desc_t *plan, uint32_t length);
+
+#endif /* DMA_TILING_H_ */
@@ -0,0 +1,509 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dsp.c
+// Description: Q15 and Q31 fixed-point FIR, decimation, biquad cascade,
+//              RMS and peak, and radix-2 and radix-4 FFT, processing blocks
+
+#include <math.h>
+#include <string.h>
+
+#include "dsp.h"
+
+/********************************/
+/* ---- LOCAL MACROS ---- */
+/********************************/
+
+#define Q15_MAX 32767
+#define Q15_MIN (-32768)
+#define Q31_MAX 2147483647
+#define Q31_MIN (-2147483647 - 1)
+
+/********************************/
+/* ---- LOCAL FUNCTIONS ---- */
+/********************************/
+
+static inline q15_t sat_q15(int64_t v)
+{
+    return v > Q15_MAX ? Q15_MAX : v < Q15_MIN ? Q15_MIN : (q15_t)v;
+}
+
+static inline q31_t sat_q31(int64_t v)
+{
+    return v > Q31_MAX ? Q31_MAX : v < Q31_MIN ? Q31_MIN : (q31_t)v;
+}
+
+// v / 2^shift, rounded to the nearest
+static inline int64_t round_shift(int64_t v, uint32_t shift)
+{
+    return shift ? (v + ((int64_t)1 << (shift - 1))) >> shift : v;
+}
+
+/* ---- Dot products of the FIR filters ---- */
+
+#if KERNELS_VERSION == KERNELS_XPULP
+
+// Word load from any address, the CV32E40P cores split the misaligned ones
+static inline uint32_t load_word(const void *p)
+{
+    uint32_t w;
+    asm("lw %0, %1" : "=r"(w) : "m"(*(const uint32_t *)p));
+    return w;
+}
+
+// acc += dot product of the 2 halfwords of x and y, signed
+static inline int32_t sdotsp_h(int32_t acc, uint32_t x, uint32_t y)
+{
+    asm("cv.sdotsp.h %0, %1, %2" : "+r"(acc) : "r"(x), "r"(y));
+    return acc;
+}
+
+static inline int32_t dot_q15(const q15_t *a, const q15_t *b, uint32_t n)
+{
+    int32_t acc0 = 0, acc1 = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = sdotsp_h(acc0, load_word(&a[i]), load_word(&b[i]));
+        acc1 = sdotsp_h(acc1, load_word(&a[i + 2]), load_word(&b[i + 2]));
+    }
+    for (; i < n; i++)
+    {
+        acc0 += (int32_t)a[i] * b[i];
+    }
+    return acc0 + acc1;
+}
+
+#else
+
+static inline int32_t dot_q15(const q15_t *a, const q15_t *b, uint32_t n)
+{
+    int32_t acc0 = 0, acc1 = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        acc0 += (int32_t)a[i] * b[i];
+        acc1 += (int32_t)a[i + 1] * b[i + 1];
+    }
+    if (i < n)
+    {
+        acc0 += (int32_t)a[i] * b[i];
+    }
+    return acc0 + acc1;
+}
+
+#endif // KERNELS_VERSION == KERNELS_XPULP
+
+static inline int64_t dot_q31(const q31_t *a, const q31_t *b, uint32_t n)
+{
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        acc += (int64_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+/* ---- Square roots of the RMS ---- */
+
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+/* ---- FFT ---- */
+
+static inline dsp_cq15_t cmul_q15(dsp_cq15_t a, dsp_cq15_t w)
+{
+    dsp_cq15_t r;
+    r.re = (q15_t)(((int32_t)a.re * w.re - (int32_t)a.im * w.im) >> 15);
+    r.im = (q15_t)(((int32_t)a.re * w.im + (int32_t)a.im * w.re) >> 15);
+    return r;
+}
+
+static inline void swap_cq15(dsp_cq15_t *x, uint32_t i, uint32_t j)
+{
+    dsp_cq15_t t = x[i];
+    x[i] = x[j];
+    x[j] = t;
+}
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+/* ---- FIR ---- */
+
+int dsp_fir_q15_init(dsp_fir_q15_t *fir, const q15_t *coeffs, uint32_t taps, q15_t *history,
+                     uint32_t block_max, uint32_t factor)
+{
+    if (fir == NULL || coeffs == NULL || history == NULL || taps == 0 || block_max == 0 || factor == 0)
+    {
+        return -1;
+    }
+    fir->coeffs = coeffs;
+    fir->history = history;
+    fir->taps = taps;
+    fir->block_max = block_max;
+    fir->factor = factor;
+    fir->phase = 0;
+    memset(history, 0, DSP_FIR_HISTORY(taps, block_max) * sizeof(q15_t));
+    return 0;
+}
+
+uint32_t dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t n)
+{
+    // The block follows the taps - 1 last samples of the previous one, so
+    // that every output is a single dot product over contiguous samples
+    q15_t *h = fir->history;
+    uint32_t past = fir->taps - 1;
+    uint32_t count = 0;
+    uint32_t i = fir->phase;
+
+    if (n > fir->block_max)
+    {
+        n = fir->block_max;
+    }
+    memcpy(&h[past], in, n * sizeof(q15_t));
+    for (; i < n; i += fir->factor)
+    {
+        out[count++] = sat_q15(round_shift(dot_q15(fir->coeffs, &h[i], fir->taps), 15));
+    }
+    fir->phase = i - n;
+    memmove(h, &h[n], past * sizeof(q15_t));
+    return count;
+}
+
+int dsp_fir_q31_init(dsp_fir_q31_t *fir, const q31_t *coeffs, uint32_t taps, q31_t *history,
+                     uint32_t block_max, uint32_t factor)
+{
+    if (fir == NULL || coeffs == NULL || history == NULL || taps == 0 || block_max == 0 || factor == 0)
+    {
+        return -1;
+    }
+    fir->coeffs = coeffs;
+    fir->history = history;
+    fir->taps = taps;
+    fir->block_max = block_max;
+    fir->factor = factor;
+    fir->phase = 0;
+    memset(history, 0, DSP_FIR_HISTORY(taps, block_max) * sizeof(q31_t));
+    return 0;
+}
+
+uint32_t dsp_fir_q31(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t n)
+{
+    q31_t *h = fir->history;
+    uint32_t past = fir->taps - 1;
+    uint32_t count = 0;
+    uint32_t i = fir->phase;
+
+    if (n > fir->block_max)
+    {
+        n = fir->block_max;
+    }
+    memcpy(&h[past], in, n * sizeof(q31_t));
+    for (; i < n; i += fir->factor)
+    {
+        out[count++] = sat_q31(round_shift(dot_q31(fir->coeffs, &h[i], fir->taps), 31));
+    }
+    fir->phase = i - n;
+    memmove(h, &h[n], past * sizeof(q31_t));
+    return count;
+}
+
+/* ---- Biquads ---- */
+
+int dsp_biquad_q15_init(dsp_biquad_q15_t *iir, const q15_t *coeffs, uint32_t stages, q15_t *state,
+                        uint32_t post_shift)
+{
+    if (iir == NULL || coeffs == NULL || state == NULL || stages == 0 || post_shift > 15)
+    {
+        return -1;
+    }
+    iir->coeffs = coeffs;
+    iir->state = state;
+    iir->stages = stages;
+    iir->post_shift = post_shift;
+    memset(state, 0, DSP_BIQUAD_STATE(stages) * sizeof(q15_t));
+    return 0;
+}
+
+void dsp_biquad_q15(dsp_biquad_q15_t *iir, const q15_t *in, q15_t *out, uint32_t n)
+{
+    // Stage by stage over the whole block, the coefficients and the state of
+    // a stage kept in registers
+    uint32_t shift = 15 - iir->post_shift;
+    const q15_t *src = in;
+    for (uint32_t s = 0; s < iir->stages; s++)
+    {
+        const q15_t *c = &iir->coeffs[5 * s];
+        q15_t *st = &iir->state[4 * s];
+        int32_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        int32_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+        for (uint32_t i = 0; i < n; i++)
+        {
+            int32_t x0 = src[i];
+            int64_t acc = (int64_t)(b0 * x0) + b1 * x1 + b2 * x2 - (int64_t)(a1 * y1) - a2 * y2;
+            int32_t y0 = sat_q15(round_shift(acc, shift));
+            out[i] = (q15_t)y0;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+        }
+        st[0] = (q15_t)x1;
+        st[1] = (q15_t)x2;
+        st[2] = (q15_t)y1;
+        st[3] = (q15_t)y2;
+        src = out;
+    }
+}
+
+int dsp_biquad_q31_init(dsp_biquad_q31_t *iir, const q31_t *coeffs, uint32_t stages, q31_t *state,
+                        uint32_t post_shift)
+{
+    if (iir == NULL || coeffs == NULL || state == NULL || stages == 0 || post_shift > 15)
+    {
+        return -1;
+    }
+    iir->coeffs = coeffs;
+    iir->state = state;
+    iir->stages = stages;
+    iir->post_shift = post_shift;
+    memset(state, 0, DSP_BIQUAD_STATE(stages) * sizeof(q31_t));
+    return 0;
+}
+
+void dsp_biquad_q31(dsp_biquad_q31_t *iir, const q31_t *in, q31_t *out, uint32_t n)
+{
+    // The products are accumulated in Q60, so that the five of them fit in
+    // 64 bits
+    uint32_t shift = 29 - iir->post_shift;
+    const q31_t *src = in;
+    for (uint32_t s = 0; s < iir->stages; s++)
+    {
+        const q31_t *c = &iir->coeffs[5 * s];
+        q31_t *st = &iir->state[4 * s];
+        int64_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        q31_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+        for (uint32_t i = 0; i < n; i++)
+        {
+            q31_t x0 = src[i];
+            int64_t acc = ((b0 * x0) >> 2) + ((b1 * x1) >> 2) + ((b2 * x2) >> 2) - ((a1 * y1) >> 2) -
+                          ((a2 * y2) >> 2);
+            q31_t y0 = sat_q31(round_shift(acc, shift));
+            out[i] = y0;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+        }
+        st[0] = x1;
+        st[1] = x2;
+        st[2] = y1;
+        st[3] = y2;
+        src = out;
+    }
+}
+
+/* ---- Levels ---- */
+
+q15_t dsp_rms_q15(const q15_t *in, uint32_t n)
+{
+    uint64_t sum = 0;
+    if (n == 0)
+    {
+        return 0;
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += (uint32_t)((int32_t)in[i] * in[i]);
+    }
+    // The root of a mean square in Q30 is in Q15
+    uint32_t rms = isqrt64(sum / n);
+    return rms > Q15_MAX ? Q15_MAX : (q15_t)rms;
+}
+
+q31_t dsp_rms_q31(const q31_t *in, uint32_t n)
+{
+    uint64_t sum = 0;
+    if (n == 0)
+    {
+        return 0;
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += (uint64_t)(((int64_t)in[i] * in[i]) >> 31);
+    }
+    // Mean square in Q31, its root taken in Q62
+    uint32_t rms = isqrt64((sum / n) << 31);
+    return rms > Q31_MAX ? Q31_MAX : (q31_t)rms;
+}
+
+q15_t dsp_peak_q15(const q15_t *in, uint32_t n)
+{
+    int32_t max = 0, min = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        max = in[i] > max ? in[i] : max;
+        min = in[i] < min ? in[i] : min;
+    }
+    return sat_q15(-min > max ? -min : max);
+}
+
+q31_t dsp_peak_q31(const q31_t *in, uint32_t n)
+{
+    q31_t max = 0, min = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        max = in[i] > max ? in[i] : max;
+        min = in[i] < min ? in[i] : min;
+    }
+    return sat_q31(-(int64_t)min > max ? -(int64_t)min : max);
+}
+
+void dsp_s32_to_q15(const int32_t *in, q15_t *out, uint32_t n, uint32_t shift)
+{
+    // In increasing order, so that out can overlap the start of in
+    for (uint32_t i = 0; i < n; i++)
+    {
+        out[i] = (q15_t)((int32_t)((uint32_t)in[i] << shift) >> 16);
+    }
+}
+
+/* ---- FFT ---- */
+
+void dsp_fft_q15_twiddles(dsp_cq15_t *tw, uint32_t n)
+{
+    const float step = -6.28318530717958647692f / (float)n;
+    for (uint32_t k = 0; k < DSP_FFT_TWIDDLES(n); k++)
+    {
+        float re = cosf(step * (float)k) * 32767.0f;
+        float im = sinf(step * (float)k) * 32767.0f;
+        tw[k].re = (q15_t)(re < 0 ? re - 0.5f : re + 0.5f);
+        tw[k].im = (q15_t)(im < 0 ? im - 0.5f : im + 0.5f);
+    }
+}
+
+void dsp_fft_radix2_q15(dsp_cq15_t *x, const dsp_cq15_t *tw, uint32_t n)
+{
+    // Bit-reversal permutation
+    for (uint32_t i = 1, j = 0; i < n; i++)
+    {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            swap_cq15(x, i, j);
+        }
+    }
+
+    // Butterflies, each twiddle loaded once for all the groups of a stage
+    for (uint32_t len = 2; len <= n; len <<= 1)
+    {
+        uint32_t half = len >> 1;
+        uint32_t stride = n / len;
+        for (uint32_t j = 0; j < half; j++)
+        {
+            dsp_cq15_t w = tw[j * stride];
+            for (uint32_t i = j; i < n; i += len)
+            {
+                dsp_cq15_t u = x[i];
+                dsp_cq15_t v = x[i + half];
+                v.re >>= 1;
+                v.im >>= 1;
+                dsp_cq15_t t = cmul_q15(v, w);
+                int32_t ur = u.re >> 1, ui = u.im >> 1;
+                x[i].re = (q15_t)(ur + t.re);
+                x[i].im = (q15_t)(ui + t.im);
+                x[i + half].re = (q15_t)(ur - t.re);
+                x[i + half].im = (q15_t)(ui - t.im);
+            }
+        }
+    }
+}
+
+void dsp_fft_radix4_q15(dsp_cq15_t *x, const dsp_cq15_t *tw, uint32_t n)
+{
+    // Butterflies from the whole transform down to the groups of 4, the
+    // three twiddles of a position loaded once for all the groups
+    uint32_t digits = 0;
+    for (uint32_t len = n; len >= 4; len >>= 2)
+    {
+        uint32_t quarter = len >> 2;
+        uint32_t stride = n / len;
+        digits++;
+        for (uint32_t j = 0; j < quarter; j++)
+        {
+            dsp_cq15_t w1 = tw[j * stride];
+            dsp_cq15_t w2 = tw[2 * j * stride];
+            dsp_cq15_t w3 = tw[3 * j * stride];
+            for (uint32_t i = j; i < n; i += len)
+            {
+                dsp_cq15_t *p = &x[i];
+                int32_t x0r = p[0].re >> 2, x0i = p[0].im >> 2;
+                int32_t x1r = p[quarter].re >> 2, x1i = p[quarter].im >> 2;
+                int32_t x2r = p[2 * quarter].re >> 2, x2i = p[2 * quarter].im >> 2;
+                int32_t x3r = p[3 * quarter].re >> 2, x3i = p[3 * quarter].im >> 2;
+                int32_t ar = x0r + x2r, ai = x0i + x2i;
+                int32_t br = x0r - x2r, bi = x0i - x2i;
+                int32_t cr = x1r + x3r, ci = x1i + x3i;
+                int32_t dr = x1r - x3r, di = x1i - x3i;
+                dsp_cq15_t y;
+                p[0].re = (q15_t)(ar + cr);
+                p[0].im = (q15_t)(ai + ci);
+                // b - j d
+                y.re = (q15_t)(br + di);
+                y.im = (q15_t)(bi - dr);
+                p[quarter] = cmul_q15(y, w1);
+                // a - c
+                y.re = (q15_t)(ar - cr);
+                y.im = (q15_t)(ai - ci);
+                p[2 * quarter] = cmul_q15(y, w2);
+                // b + j d
+                y.re = (q15_t)(br - di);
+                y.im = (q15_t)(bi + dr);
+                p[3 * quarter] = cmul_q15(y, w3);
+            }
+        }
+    }
+
+    // Base-4 digit-reversal permutation
+    for (uint32_t i = 1; i < n; i++)
+    {
+        uint32_t r = 0;
+        for (uint32_t d = 0, v = i; d < digits; d++, v >>= 2)
+        {
+            r = (r << 2) | (v & 3);
+        }
+        if (i < r)
+        {
+            swap_cq15(x, i, r);
+        }
+    }
+}
@@ -0,0 +1,242 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: dsp.h
+// Description: Q15 and Q31 fixed-point FIR, decimation, biquad cascade,
+//              RMS and peak, and radix-2 and radix-4 FFT, processing blocks
+
+#ifndef DSP_H_
+#define DSP_H_
+
+#include <stdint.h>
+
+#include "kernels_int.h"
+
+/*
+ * The filters keep their state between calls, so that a signal can be
+ * processed one block at a time, e.g. in the callback of an i2s_stream, a
+ * dma_stream or a pdm2pcm_stream, each block continuing the previous one: the
+ * signal cut in blocks gives the same output as the whole signal at once. The blocks of a filter
+ * can have any length up to the one given to its init function.
+ *
+ * The Q15 FIR accumulates on 32 bits, with the SIMD dot products of Xpulp
+ * when kernels_int.h uses them (KERNELS_XPULP): the sum of the magnitudes of
+ * its coefficients must stay below 2.0. The other filters accumulate on 64
+ * bits. The outputs saturate.
+ */
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+typedef int16_t q15_t; // Q1.15, [-1, 1)
+typedef int32_t q31_t; // Q1.31, [-1, 1)
+
+/**
+ * @brief Complex Q15 sample, as interleaved real and imaginary parts.
+ */
+typedef struct
+{
+    q15_t re;
+    q15_t im;
+} dsp_cq15_t;
+
+/**
+ * @brief State of a Q15 FIR filter, optionally decimating. The fields are
+ * private.
+ */
+typedef struct
+{
+    const q15_t *coeffs; // Reversed in time
+    q15_t *history;      // taps - 1 past samples, then the current block
+    uint32_t taps;
+    uint32_t block_max;
+    uint32_t factor;     // Decimation factor, 1 without
+    uint32_t phase;      // Input samples to skip before the next output
+} dsp_fir_q15_t;
+
+/**
+ * @brief State of a Q31 FIR filter, see dsp_fir_q15_t.
+ */
+typedef struct
+{
+    const q31_t *coeffs;
+    q31_t *history;
+    uint32_t taps;
+    uint32_t block_max;
+    uint32_t factor;
+    uint32_t phase;
+} dsp_fir_q31_t;
+
+/**
+ * @brief State of a cascade of Q15 biquads, direct form 1. Each stage has
+ * the coefficients {b0, b1, b2, a1, a2} of
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2],
+ * scaled down by 2^post_shift so that they fit in Q15 (e.g. post_shift 1 for
+ * coefficients in [-2, 2)). The fields are private.
+ */
+typedef struct
+{
+    const q15_t *coeffs; // 5 per stage
+    q15_t *state;        // 4 per stage: x[n-1], x[n-2], y[n-1], y[n-2]
+    uint32_t stages;
+    uint32_t post_shift;
+} dsp_biquad_q15_t;
+
+/**
+ * @brief State of a cascade of Q31 biquads, see dsp_biquad_q15_t.
+ */
+typedef struct
+{
+    const q31_t *coeffs;
+    q31_t *state;
+    uint32_t stages;
+    uint32_t post_shift;
+} dsp_biquad_q31_t;
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief Elements of the history buffer of a FIR filter.
+ */
+#define DSP_FIR_HISTORY(taps, block_max) ((taps) - 1 + (block_max))
+
+/**
+ * @brief Elements of the state buffer of a biquad cascade.
+ */
+#define DSP_BIQUAD_STATE(stages) (4 * (stages))
+
+/**
+ * @brief Twiddle factors of an FFT of n points, for both radices.
+ */
+#define DSP_FFT_TWIDDLES(n) (3 * (n) / 4)
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Starts a Q15 FIR filter, out[i] = sum of h[j] * x[i - j].
+ *
+ * @param fir State to initialize
+ * @param coeffs taps coefficients h, reversed in time (coeffs[j] is
+ * h[taps - 1 - j]), kept by the filter
+ * @param taps Number of coefficients
+ * @param history Buffer of DSP_FIR_HISTORY(taps, block_max) samples, kept
+ * @param block_max Largest block
+ * @param factor Decimation factor: one output every factor samples, 1 for none
+ * @return 0, or -1 for a bad argument
+ */
+int dsp_fir_q15_init(dsp_fir_q15_t *fir, const q15_t *coeffs, uint32_t taps, q15_t *history,
+                     uint32_t block_max, uint32_t factor);
+
+/**
+ * @brief Filters a block.
+ *
+ * @param fir Filter
+ * @param in n samples
+ * @param out Output, up to n / factor + 1 samples
+ * @param n Samples of the block, up to block_max
+ * @return Number of output samples
+ */
+uint32_t dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t n);
+
+/**
+ * @brief Starts a Q31 FIR filter, see dsp_fir_q15_init().
+ */
+int dsp_fir_q31_init(dsp_fir_q31_t *fir, const q31_t *coeffs, uint32_t taps, q31_t *history,
+                     uint32_t block_max, uint32_t factor);
+
+/**
+ * @brief Filters a block, see dsp_fir_q15().
+ */
+uint32_t dsp_fir_q31(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t n);
+
+/**
+ * @brief Starts a Q15 biquad cascade, with a zero state.
+ *
+ * @param iir State to initialize
+ * @param coeffs 5 coefficients per stage, kept
+ * @param stages Number of stages
+ * @param state Buffer of DSP_BIQUAD_STATE(stages) samples, kept
+ * @param post_shift Scaling of the coefficients, 0 to 15
+ * @return 0, or -1 for a bad argument
+ */
+int dsp_biquad_q15_init(dsp_biquad_q15_t *iir, const q15_t *coeffs, uint32_t stages, q15_t *state,
+                        uint32_t post_shift);
+
+/**
+ * @brief Filters a block through every stage, in may be out.
+ */
+void dsp_biquad_q15(dsp_biquad_q15_t *iir, const q15_t *in, q15_t *out, uint32_t n);
+
+/**
+ * @brief Starts a Q31 biquad cascade, see dsp_biquad_q15_init().
+ */
+int dsp_biquad_q31_init(dsp_biquad_q31_t *iir, const q31_t *coeffs, uint32_t stages, q31_t *state,
+                        uint32_t post_shift);
+
+/**
+ * @brief Filters a block through every stage, in may be out.
+ */
+void dsp_biquad_q31(dsp_biquad_q31_t *iir, const q31_t *in, q31_t *out, uint32_t n);
+
+/**
+ * @brief Root mean square of a block.
+ */
+q15_t dsp_rms_q15(const q15_t *in, uint32_t n);
+q31_t dsp_rms_q31(const q31_t *in, uint32_t n);
+
+/**
+ * @brief Largest magnitude of a block, saturated (-1.0 gives the largest
+ * positive value).
+ */
+q15_t dsp_peak_q15(const q15_t *in, uint32_t n);
+q31_t dsp_peak_q31(const q31_t *in, uint32_t n);
+
+/**
+ * @brief Converts the 32-bit words of a stream (e.g. of i2s_stream) to Q15,
+ * keeping their upper bits.
+ *
+ * @param in n words
+ * @param out n samples, may be in
+ * @param n Number of samples
+ * @param shift Left shift of the words before their upper 16 bits are taken,
+ * e.g. 8 for 24-bit samples right-aligned in the words
+ */
+void dsp_s32_to_q15(const int32_t *in, q15_t *out, uint32_t n, uint32_t shift);
+
+/**
+ * @brief Twiddle factors of the FFTs of n points, exp(-2 pi i k / n) for k
+ * below DSP_FFT_TWIDDLES(n).
+ *
+ * @param tw Output
+ * @param n Number of points, a power of 2
+ */
+void dsp_fft_q15_twiddles(dsp_cq15_t *tw, uint32_t n);
+
+/**
+ * @brief In-place radix-2 FFT, decimation in time. Each stage halves its
+ * input so that it cannot overflow with samples of a modulus below 1 (e.g.
+ * any real signal): the output is the transform divided by n.
+ *
+ * @param x n samples, replaced by their transform in natural order
+ * @param tw Twiddle factors of n points
+ * @param n Number of points, a power of 2
+ */
+void dsp_fft_radix2_q15(dsp_cq15_t *x, const dsp_cq15_t *tw, uint32_t n);
+
+/**
+ * @brief In-place radix-4 FFT, decimation in frequency, about 25% fewer
+ * complex multiplications than the radix-2 one. Same scaling by 1 / n.
+ *
+ * @param x n samples, replaced by their transform in natural order
+ * @param tw Twiddle factors of n points
+ * @param n Number of points, a power of 4
+ */
+void dsp_fft_radix4_q15(dsp_cq15_t *x, const dsp_cq15_t *tw, uint32_t n);
+
+#endif // DSP_H_
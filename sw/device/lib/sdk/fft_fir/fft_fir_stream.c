@@ -0,0 +1,145 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: fft_fir_stream.c
+// Description: PDM2PCM capture filtered and transformed by the FFT and FIR accelerator through the DMA
+
+#include "fft_fir_stream.h"
+#include "fft_fir.h"
+#include "pdm2pcm.h"
+#include "dma_stream.h"
+#include "dma_sdk.h"
+#include "dma.h"
+#include "dsp.h"
+#include "core_v_mini_mcu.h"
+
+/******************************/
+/* ---- GLOBAL VARIABLES ---- */
+/******************************/
+
+/* Twiddle factors of the largest FFT, computed at each init. */
+static dsp_cq15_t fft_fir_twiddles[DSP_FFT_TWIDDLES(1 << FFT_FIR_LOG2N_MAX)];
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+int fft_fir_stream_init(fft_fir_stream_t *stream, const fft_fir_config_t *config,
+                        const q15_t *coeffs, uint32_t *ring, uint32_t block,
+                        uint32_t buffer_count, dma_stream_callback_t callback, void *arg)
+{
+    if ((config->fir && (coeffs == NULL || config->taps == 0 || config->taps > FFT_FIR_TAPS_MAX)) ||
+        (config->fft && (config->log2n == 0 || config->log2n > FFT_FIR_LOG2N_MAX)) ||
+        (!config->fft && block == 0))
+    {
+        return -1;
+    }
+
+    // One buffer per frame with the FFT, the samples of a lap of the ring
+    // are copied by each lap of the feeding transaction
+    uint32_t in_words = config->fft ? 1u << config->log2n : block;
+    uint32_t out_words = config->fft ? fft_fir_frame_words(config) : block;
+    if (dma_stream_init(&stream->out, (uint8_t *)ring, out_words, buffer_count, DMA_DATA_TYPE_WORD,
+                        (uint8_t *)(FFT_FIR_START_ADDRESS + FFT_FIR_DATA_OUT_REG_OFFSET), 0,
+                        DMA_TRIG_SLOT_EXT_ACC_RX, callback, arg) != 0)
+    {
+        return -1;
+    }
+
+    stream->pcm = (dma_target_t){
+        .ptr = (uint8_t *)PDM2PCM_RX_DATA_ADDRESS,
+        .inc_du = 0,
+        .size_du = in_words * buffer_count,
+        .trig = DMA_TRIG_SLOT_PDM2PCM,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    stream->acc = (dma_target_t){
+        .ptr = (uint8_t *)(FFT_FIR_START_ADDRESS + FFT_FIR_DATA_IN_REG_OFFSET),
+        .inc_du = 0,
+        .trig = DMA_TRIG_SLOT_EXT_ACC_TX,
+        .type = DMA_DATA_TYPE_WORD,
+    };
+    stream->feed = (dma_trans_t){
+        .src = &stream->pcm,
+        .dst = &stream->acc,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_CIRCULAR,
+        .win_du = 0,
+        .end = DMA_TRANS_END_POLLING,
+    };
+    stream->running = 0;
+
+    fft_fir_configure(config);
+    if (config->fir)
+    {
+        fft_fir_load_coeffs(coeffs, config->taps);
+    }
+    if (config->fft)
+    {
+        // dsp_cq15_t keeps the real part in the lower halfword, as TWIDDLE
+        dsp_fft_q15_twiddles(fft_fir_twiddles, 1u << config->log2n);
+        fft_fir_load_twiddles((const uint32_t *)fft_fir_twiddles, 1u << (config->log2n - 1));
+    }
+    return 0;
+}
+
+int fft_fir_stream_start(fft_fir_stream_t *stream)
+{
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+    stream->feed_channel = (uint8_t)channel;
+    stream->feed.channel = (uint8_t)channel;
+
+    // The DMA waits on the slots of both ends, which the integrity checks of
+    // the HAL refuse
+    dma_validate_transaction(&stream->feed, DMA_DO_NOT_ENABLE_REALIGN, DMA_PERFORM_CHECKS_ONLY_SANITY);
+    if ((stream->feed.flags & DMA_CONFIG_CRITICAL_ERROR) || dma_stream_start(&stream->out) != 0)
+    {
+        dma_sdk_channel_free(stream->feed_channel);
+        return -1;
+    }
+
+    // The results are drained before the samples come in, and the DMA waits
+    // for the samples, so it is started before the conversion
+    stream->running = 1;
+    if (dma_load_transaction(&stream->feed) != DMA_CONFIG_OK || dma_launch(&stream->feed) != DMA_CONFIG_OK)
+    {
+        fft_fir_stream_stop(stream);
+        return -1;
+    }
+    pdm2pcm_start();
+    return 0;
+}
+
+void fft_fir_stream_stop(fft_fir_stream_t *stream)
+{
+    if (!stream->running)
+    {
+        return;
+    }
+
+    // The samples must keep coming until the feeding transaction ends its lap
+    dma_stop_circular(stream->feed_channel);
+    while (!dma_is_ready(stream->feed_channel))
+    {
+    }
+    pdm2pcm_stop();
+    dma_sdk_channel_free(stream->feed_channel);
+    stream->running = 0;
+
+    // The results usually end the lap of the ring, unless the DMA of the
+    // results was a lap behind when the feeding transaction was stopped
+    dma_stop_circular(stream->out.channel);
+    while (!dma_is_ready(stream->out.channel))
+    {
+        if (fft_fir_status() & (1 << FFT_FIR_STATUS_IN_READY_BIT))
+        {
+            fft_fir_push(0);
+        }
+    }
+    dma_stream_stop(&stream->out);
+}
@@ -0,0 +1,84 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: fft_fir_stream.h
+// Description: PDM2PCM capture filtered and transformed by the FFT and FIR accelerator through the DMA
+
+#ifndef FFT_FIR_STREAM_H_
+#define FFT_FIR_STREAM_H_
+
+#include <stdint.h>
+
+#include "fft_fir.h"
+#include "dma_stream.h"
+#include "dsp.h"
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Chain of two DMA channels: one copies the PCM samples of the PDM2PCM
+ * into the accelerator, the other its results into a ring of buffers. The
+ * fields are private, the chain must stay allocated while it runs.
+ */
+typedef struct
+{
+    dma_stream_t out;  // Results into the ring
+    dma_target_t pcm;  // The HAL keeps pointers to the targets
+    dma_target_t acc;  // and to the transaction while it runs
+    dma_trans_t feed;  // PDM2PCM into the accelerator
+    uint8_t feed_channel;
+    uint8_t running;
+} fft_fir_stream_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Configure the accelerator and set up the chain. With the FFT, each
+ * buffer of the ring holds the spectrum of a frame, fft_fir_frame_words()
+ * words, each bin with the imaginary part in the upper halfword as in
+ * dsp_cq15_t. Without it, each buffer holds block samples, sign-extended to
+ * words. The twiddle factors are computed with dsp_fft_q15_twiddles().
+ *
+ * @param stream Chain to initialize
+ * @param config Configuration of the accelerator
+ * @param coeffs Q15 coefficients of the FIR reversed in time, as for
+ * dsp_fir_q15_init(), or NULL without the FIR
+ * @param ring Memory of the ring, buffer_count buffers
+ * @param block Samples of a buffer without the FFT, ignored with it
+ * @param buffer_count Number of buffers in the ring, at least 2
+ * @param callback Called from the interrupt handler when a buffer is filled, or NULL
+ * @param arg Argument passed to the callback
+ * @return int 0 if success, -1 if the configuration or the ring is not valid
+ */
+int fft_fir_stream_init(fft_fir_stream_t *stream, const fft_fir_config_t *config,
+                        const q15_t *coeffs, uint32_t *ring, uint32_t block,
+                        uint32_t buffer_count, dma_stream_callback_t callback, void *arg);
+
+/**
+ * @brief Start the stream of the results, the copy of the samples into the
+ * accelerator, then the conversion. The PDM2PCM must have been configured with
+ * pdm2pcm_init() and the PLIC initialized with plic_Init(). The buffers are
+ * taken and released with dma_stream_get() and dma_stream_release() on
+ * stream->out when there is no callback.
+ *
+ * @param stream Chain initialized by fft_fir_stream_init()
+ * @return int 0 if success, -1 if two DMA channels are not free
+ */
+int fft_fir_stream_start(fft_fir_stream_t *stream);
+
+/**
+ * @brief Stop the copy into the accelerator at the end of a lap of the ring,
+ * then the conversion, then the stream of the results once the DMA reaches
+ * the end of the ring. If the results of the last samples do not end the
+ * ring, it is completed with the results of silence.
+ *
+ * @param stream Running chain
+ */
+void fft_fir_stream_stop(fft_fir_stream_t *stream);
+
+#endif /* FFT_FIR_STREAM_H_ */
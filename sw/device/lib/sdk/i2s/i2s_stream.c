@@ -0,0 +1,117 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: i2s_stream.c
+// Description: Continuous I2S capture into a ring of PCM blocks through the DMA
+
+#include "i2s_stream.h"
+#include "i2s.h"
+#include "i2s_structs.h"
+#include "dma_stream.h"
+#include "dma.h"
+#include "bitfield.h"
+#include "core_v_mini_mcu.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// Called by the DMA stream for each filled window
+static void i2s_stream_block_done(dma_stream_t *dma, uint8_t *buffer, uint32_t index, void *arg)
+{
+    i2s_stream_t *stream = (i2s_stream_t *)arg;
+
+    // The flag stays set until i2s_rx_stop()
+    if (i2s_rx_overflow())
+    {
+        stream->overflow = true;
+    }
+
+    if (stream->callback != NULL)
+    {
+        stream->callback(stream, (const uint32_t *)buffer, index, stream->arg);
+        // This is the only block not released yet, unless the callback fell
+        // behind and the DMA stream dropped the older ones
+        dma_stream_release(dma);
+    }
+}
+
+int i2s_stream_init(i2s_stream_t *stream, uint32_t *ring, uint32_t block_words, uint32_t block_count,
+                    i2s_stream_callback_t callback, void *arg)
+{
+    stream->block_words = block_words;
+    stream->callback = callback;
+    stream->arg = arg;
+    stream->overflow = false;
+
+    return dma_stream_init(&stream->dma, (uint8_t *)ring, block_words, block_count,
+                           DMA_DATA_TYPE_WORD, (uint8_t *)I2S_RX_DATA_ADDRESS, 0,
+                           DMA_TRIG_SLOT_I2S, i2s_stream_block_done, stream);
+}
+
+i2s_result_t i2s_stream_start(i2s_stream_t *stream, i2s_channel_sel_t channels)
+{
+    // Everything that could make i2s_rx_start() fail is checked first, as the
+    // DMA cannot be stopped before the end of the ring without samples
+    if (!i2s_is_running())
+    {
+        return kI2sErrUninit;
+    }
+    if (i2s_rx_overflow())
+    {
+        return kI2sOverflow;
+    }
+    if (channels == I2S_DISABLE ||
+        bitfield_field32_read(i2s_peri->CONTROL, I2S_CONTROL_EN_RX_FIELD) != 0x00)
+    {
+        return kI2sError;
+    }
+
+    stream->overflow = false;
+
+    // The DMA waits for the samples, so it is started before the RX channels
+    if (dma_stream_start(&stream->dma) != 0)
+    {
+        return kI2sError;
+    }
+    return i2s_rx_start(channels);
+}
+
+const uint32_t *i2s_stream_get(i2s_stream_t *stream)
+{
+    return (const uint32_t *)dma_stream_get(&stream->dma);
+}
+
+void i2s_stream_release(i2s_stream_t *stream)
+{
+    dma_stream_release(&stream->dma);
+}
+
+uint32_t i2s_stream_overruns(i2s_stream_t *stream)
+{
+    return dma_stream_overruns(&stream->dma);
+}
+
+bool i2s_stream_overflow(i2s_stream_t *stream)
+{
+    return stream->overflow || i2s_rx_overflow();
+}
+
+i2s_result_t i2s_stream_stop(i2s_stream_t *stream)
+{
+    if (!stream->dma.running)
+    {
+        return stream->overflow ? kI2sOverflow : kI2sOk;
+    }
+
+    // The samples must keep coming until the DMA reaches the end of the ring
+    dma_stream_stop(&stream->dma);
+
+    i2s_result_t res = i2s_rx_stop();
+    if (stream->overflow)
+    {
+        res = kI2sOverflow;
+    }
+    return res;
+}
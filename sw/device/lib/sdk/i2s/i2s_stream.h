@@ -0,0 +1,137 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: i2s_stream.h
+// Description: Continuous I2S capture into a ring of PCM blocks through the DMA
+
+#ifndef I2S_STREAM_H_
+#define I2S_STREAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "i2s.h"
+#include "dma_stream.h"
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+typedef struct i2s_stream i2s_stream_t;
+
+/**
+ * @brief Called from the DMA window interrupt handler when a block has been
+ * captured. The block is given back to the DMA when the callback returns.
+ *
+ * @param stream Stream of the block
+ * @param block The samples, one per word with the MSBs outside of the word
+ * length set to 0, alternating left and right when both channels are captured
+ * @param index Number of blocks captured before this one since the start
+ * @param arg Argument given to i2s_stream_init()
+ */
+typedef void (*i2s_stream_callback_t)(i2s_stream_t *stream, const uint32_t *block, uint32_t index, void *arg);
+
+/**
+ * @brief Ring of PCM blocks filled by the DMA from the RX FIFO of the I2S
+ * peripheral, so that the core only wakes up once per block. The fields are
+ * private, the stream must stay allocated while it runs.
+ */
+struct i2s_stream
+{
+    dma_stream_t dma;               // Ring filled by the DMA, one window per block
+    uint32_t block_words;           // Samples of a block
+    i2s_stream_callback_t callback; // Called when a block is captured, or NULL
+    void *arg;                      // Argument of the callback
+    volatile bool overflow;         // The RX FIFO overflowed since the start
+};
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Set up a stream capturing the I2S RX channels into a ring of blocks.
+ *
+ * With a callback, each block is handled from the interrupt handler and given
+ * back to the DMA when the callback returns. Without one, the blocks are taken
+ * with i2s_stream_get() and given back with i2s_stream_release().
+ *
+ * @param stream Stream to initialize
+ * @param ring Memory of the ring, block_count * block_words words
+ * @param block_words Number of samples of a block, even to keep the left and
+ * right samples at the same positions of each block when both are captured
+ * @param block_count Number of blocks in the ring, at least 2
+ * @param callback Called from the interrupt handler when a block is captured, or NULL
+ * @param arg Argument passed to the callback
+ * @return int 0 if success, -1 if the ring is not valid
+ */
+int i2s_stream_init(i2s_stream_t *stream, uint32_t *ring, uint32_t block_words, uint32_t block_count,
+                    i2s_stream_callback_t callback, void *arg);
+
+/**
+ * @brief Start filling the ring from the given RX channels, until
+ * i2s_stream_stop() is called. The I2S peripheral must have been initialized
+ * with i2s_init() and the PLIC with plic_Init().
+ *
+ * @param stream Stream initialized by i2s_stream_init()
+ * @param channels Channels to capture (see i2s_channel_sel_t)
+ * @return kI2sOk success
+ * @return kI2sErrUninit the I2S peripheral was not initialized
+ * @return kI2sOverflow the RX FIFO overflowed before, call i2s_rx_stop() first
+ * @return kI2sError the RX channels are already running, no channel is
+ * selected or no DMA channel is free
+ */
+i2s_result_t i2s_stream_start(i2s_stream_t *stream, i2s_channel_sel_t channels);
+
+/**
+ * @brief Get the oldest captured block that has not been released yet, for
+ * streams without a callback.
+ *
+ * @param stream Running stream
+ * @return const uint32_t* The block, or NULL if no block is ready
+ */
+const uint32_t *i2s_stream_get(i2s_stream_t *stream);
+
+/**
+ * @brief Release the block returned by i2s_stream_get(), so the DMA can fill
+ * it again.
+ *
+ * @param stream Running stream
+ */
+void i2s_stream_release(i2s_stream_t *stream);
+
+/**
+ * @brief Get the number of blocks dropped because the DMA wrapped around the
+ * ring before they were released.
+ *
+ * @param stream Stream
+ * @return uint32_t Number of dropped blocks since the start
+ */
+uint32_t i2s_stream_overruns(i2s_stream_t *stream);
+
+/**
+ * @brief Check whether the RX FIFO overflowed, i.e. some samples were lost
+ * before the DMA read them, which i2s_rx_overflow() reports. It is checked
+ * after each block; the following blocks are then no longer contiguous and the
+ * left and right samples may have swapped. The stream has to be stopped and
+ * started again to clear it.
+ *
+ * @param stream Stream
+ * @return true if the RX FIFO overflowed since the start
+ */
+bool i2s_stream_overflow(i2s_stream_t *stream);
+
+/**
+ * @brief Stop the stream once the DMA reaches the end of the ring, then stop
+ * the RX channels, clearing the overflow. Sleeps until the last block has
+ * been captured; the blocks captured until then can still be taken with
+ * i2s_stream_get().
+ *
+ * @param stream Running stream
+ * @return kI2sOk success
+ * @return kI2sOverflow the RX FIFO overflowed since the start
+ */
+i2s_result_t i2s_stream_stop(i2s_stream_t *stream);
+
+#endif /* I2S_STREAM_H_ */
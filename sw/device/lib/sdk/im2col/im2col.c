@@ -0,0 +1,234 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: im2col.c
+// Description: im2col of NCHW and NHWC tensors of runtime shapes, computed by
+//              the CPU or by a plan of 2D DMA transactions
+
+#include "im2col.h"
+
+/********************************/
+/* ---- LOCAL FUNCTIONS ---- */
+/********************************/
+
+// Split count positions origin + i * step along a dimension of extent
+// elements into the ones before the start (lead), inside, and after the end
+// (trail) of the dimension. Returns the number of positions inside.
+static uint32_t im2col_clip(int32_t origin, uint32_t step, uint32_t count, uint32_t extent,
+                            uint32_t *lead, uint32_t *trail)
+{
+    *lead = 0;
+    *trail = count;
+    if (count == 0 || origin >= (int32_t)extent)
+    {
+        return 0;
+    }
+
+    if (origin < 0)
+    {
+        *lead = ((uint32_t)(-origin) + step - 1) / step;
+        if (*lead >= count)
+        {
+            *lead = count;
+            *trail = 0;
+            return 0;
+        }
+    }
+
+    uint32_t last = (uint32_t)((int32_t)extent - 1 - origin) / step;
+    *trail = last >= count - 1 ? 0 : count - 1 - last;
+    return count - *lead - *trail;
+}
+
+/*
+ * The CPU backend for each element type. NCHW: each filter element is
+ * copied over all the patches, its borders clipped once, the source moved
+ * by the stride. NHWC: each patch is copied filter row by filter row, with
+ * the rows and columns of the filter that fall in the padding computed once
+ * per patch.
+ */
+#define IM2COL_DEFINE_CPU(T, S)                                                                      \
+    static T *im2col_zeros_##S(T *out, uint32_t n)                                                   \
+    {                                                                                                \
+        for (uint32_t i = 0; i < n; i++)                                                             \
+        {                                                                                            \
+            *out++ = 0;                                                                              \
+        }                                                                                            \
+        return out;                                                                                  \
+    }                                                                                                \
+                                                                                                     \
+    static void im2col_nchw_##S(const dma_tiling_im2col_t *s, const T *in, T *out)                   \
+    {                                                                                                \
+        uint32_t ph = DMA_TILING_PATCHES(s->ih, s->fh, s->stride, s->pad);                           \
+        uint32_t pw = DMA_TILING_PATCHES(s->iw, s->fw, s->stride, s->pad);                           \
+        uint32_t plane = (uint32_t)s->ih * s->iw;                                                    \
+        uint32_t row_step = (uint32_t)s->stride * s->iw;                                             \
+        for (uint32_t ch = 0; ch < s->ch; ch++)                                                      \
+        {                                                                                            \
+            for (uint32_t fh = 0; fh < s->fh; fh++)                                                  \
+            {                                                                                        \
+                uint32_t top, bottom;                                                                \
+                uint32_t rows = im2col_clip((int32_t)fh - s->pad, s->stride, ph, s->ih, &top, &bottom); \
+                for (uint32_t fw = 0; fw < s->fw; fw++)                                              \
+                {                                                                                    \
+                    uint32_t left, right;                                                            \
+                    uint32_t cols = im2col_clip((int32_t)fw - s->pad, s->stride, pw, s->iw, &left, &right); \
+                    int32_t first = ((int32_t)fh + (int32_t)(top * s->stride) - s->pad) * s->iw      \
+                                    + (int32_t)fw + (int32_t)(left * s->stride) - s->pad;            \
+                    for (uint32_t b = 0; b < s->batch; b++)                                          \
+                    {                                                                                \
+                        if (rows == 0 || cols == 0)                                                  \
+                        {                                                                            \
+                            out = im2col_zeros_##S(out, ph * pw);                                    \
+                            continue;                                                                \
+                        }                                                                            \
+                        const T *src = in + (b * s->ch + ch) * plane + first;                        \
+                        out = im2col_zeros_##S(out, top * pw);                                       \
+                        for (uint32_t r = 0; r < rows; r++, src += row_step)                         \
+                        {                                                                            \
+                            const T *p = src;                                                        \
+                            out = im2col_zeros_##S(out, left);                                       \
+                            for (uint32_t c = 0; c < cols; c++, p += s->stride)                      \
+                            {                                                                        \
+                                *out++ = *p;                                                         \
+                            }                                                                        \
+                            out = im2col_zeros_##S(out, right);                                      \
+                        }                                                                            \
+                        out = im2col_zeros_##S(out, bottom * pw);                                    \
+                    }                                                                                \
+                }                                                                                    \
+            }                                                                                        \
+        }                                                                                            \
+    }                                                                                                \
+                                                                                                     \
+    static void im2col_nhwc_##S(const dma_tiling_im2col_t *s, const T *in, T *out)                   \
+    {                                                                                                \
+        uint32_t ph = DMA_TILING_PATCHES(s->ih, s->fh, s->stride, s->pad);                           \
+        uint32_t pw = DMA_TILING_PATCHES(s->iw, s->fw, s->stride, s->pad);                           \
+        uint32_t row_du = (uint32_t)s->iw * s->ch;                                                   \
+        for (uint32_t b = 0; b < s->batch; b++)                                                      \
+        {                                                                                            \
+            const T *image = in + b * s->ih * row_du;                                                \
+            int32_t im_row = -(int32_t)s->pad;                                                       \
+            for (uint32_t h = 0; h < ph; h++, im_row += s->stride)                                   \
+            {                                                                                        \
+                uint32_t top, bottom;                                                                \
+                uint32_t rows = im2col_clip(im_row, 1, s->fh, s->ih, &top, &bottom);                 \
+                int32_t im_col = -(int32_t)s->pad;                                                   \
+                for (uint32_t w = 0; w < pw; w++, im_col += s->stride)                               \
+                {                                                                                    \
+                    uint32_t left, right;                                                            \
+                    uint32_t cols = im2col_clip(im_col, 1, s->fw, s->iw, &left, &right);             \
+                    if (rows == 0 || cols == 0)                                                      \
+                    {                                                                                \
+                        out = im2col_zeros_##S(out, (uint32_t)s->ch * s->fh * s->fw);                \
+                        continue;                                                                    \
+                    }                                                                                \
+                    const T *first = image + ((im_row + (int32_t)top) * (int32_t)s->iw               \
+                                              + im_col + (int32_t)left) * s->ch;                     \
+                    for (uint32_t ch = 0; ch < s->ch; ch++)                                          \
+                    {                                                                                \
+                        const T *src = first + ch;                                                   \
+                        out = im2col_zeros_##S(out, top * s->fw);                                    \
+                        for (uint32_t r = 0; r < rows; r++, src += row_du)                           \
+                        {                                                                            \
+                            const T *p = src;                                                        \
+                            out = im2col_zeros_##S(out, left);                                       \
+                            for (uint32_t c = 0; c < cols; c++, p += s->ch)                          \
+                            {                                                                        \
+                                *out++ = *p;                                                         \
+                            }                                                                        \
+                            out = im2col_zeros_##S(out, right);                                      \
+                        }                                                                            \
+                        out = im2col_zeros_##S(out, bottom * s->fw);                                 \
+                    }                                                                                \
+                }                                                                                    \
+            }                                                                                        \
+        }                                                                                            \
+    }
+
+IM2COL_DEFINE_CPU(uint8_t, byte)
+IM2COL_DEFINE_CPU(uint16_t, half)
+IM2COL_DEFINE_CPU(uint32_t, word)
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+uint32_t im2col_patches(const dma_tiling_im2col_t *shape)
+{
+    return (uint32_t)shape->batch * DMA_TILING_PATCHES(shape->ih, shape->fh, shape->stride, shape->pad) *
+           DMA_TILING_PATCHES(shape->iw, shape->fw, shape->stride, shape->pad);
+}
+
+uint32_t im2col_patch_length(const dma_tiling_im2col_t *shape)
+{
+    return (uint32_t)shape->ch * shape->fh * shape->fw;
+}
+
+uint32_t im2col_output_length(const dma_tiling_im2col_t *shape)
+{
+    return im2col_patches(shape) * im2col_patch_length(shape);
+}
+
+int im2col_cpu(const dma_tiling_im2col_t *shape, const void *input, void *output)
+{
+    if (shape->stride == 0)
+    {
+        return -1;
+    }
+
+    int nchw = shape->format == DMA_TILING_NCHW;
+    switch (shape->type)
+    {
+    case DMA_DATA_TYPE_BYTE:
+        nchw ? im2col_nchw_byte(shape, input, output) : im2col_nhwc_byte(shape, input, output);
+        return 0;
+    case DMA_DATA_TYPE_HALF_WORD:
+        nchw ? im2col_nchw_half(shape, input, output) : im2col_nhwc_half(shape, input, output);
+        return 0;
+    case DMA_DATA_TYPE_WORD:
+        nchw ? im2col_nchw_word(shape, input, output) : im2col_nhwc_word(shape, input, output);
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+int im2col_dma(const dma_tiling_im2col_t *shape, const void *input, void *output,
+               dma_tiling_desc_t *plan, uint32_t plan_length)
+{
+    if (plan == NULL || shape->stride == 0 || dma_tiling_im2col_length(shape) > plan_length)
+    {
+        return -1;
+    }
+
+    int length = dma_tiling_im2col(shape, (const uint8_t *)input, (uint8_t *)output, plan);
+    if (length < 0)
+    {
+        return -1;
+    }
+
+    return dma_tiling_run(plan, (uint32_t)length);
+}
+
+int im2col_run(im2col_backend_t backend, const dma_tiling_im2col_t *shape, const void *input,
+               void *output, dma_tiling_desc_t *plan, uint32_t plan_length)
+{
+    switch (backend)
+    {
+    case IM2COL_CPU:
+        return im2col_cpu(shape, input, output) == 0 ? IM2COL_CPU : -1;
+    case IM2COL_DMA:
+        return im2col_dma(shape, input, output, plan, plan_length) == 0 ? IM2COL_DMA : -1;
+    case IM2COL_AUTO:
+        if (im2col_dma(shape, input, output, plan, plan_length) == 0)
+        {
+            return IM2COL_DMA;
+        }
+        return im2col_cpu(shape, input, output) == 0 ? IM2COL_CPU : -1;
+    default:
+        return -1;
+    }
+}
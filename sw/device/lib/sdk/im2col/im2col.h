@@ -0,0 +1,100 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: im2col.h
+// Description: im2col of NCHW and NHWC tensors of runtime shapes, computed by
+//              the CPU or by a plan of 2D DMA transactions
+
+#ifndef IM2COL_H_
+#define IM2COL_H_
+
+#include <stdint.h>
+
+#include "dma_tiling.h"
+
+/*
+ * The shape of an im2col is the dma_tiling_im2col_t of dma_tiling.h: layout,
+ * element type (byte, half word or word), batch, channels, input height and
+ * width, filter height and width, stride and padding. Both backends give the
+ * same output: for NCHW, one row of patches per filter element, the rows
+ * ordered by channel, filter row, filter column and batch; for NHWC, one row
+ * per patch, ordered by batch, patch row and patch column, with the filter
+ * elements in the same order as the NCHW rows.
+ *
+ * The CPU backend walks the output in order, with the input pointers moved by
+ * the strides and the borders computed once per filter element, without any
+ * division in the loops. The DMA backend plans one 2D transaction per filter
+ * element, channel and batch (DMA_TILING_... limits apply: NHWC needs fewer
+ * than 64 filter elements times channels), then runs them while the CPU
+ * sleeps.
+ */
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Backend of im2col_run().
+ */
+typedef enum
+{
+    IM2COL_CPU = 0,
+    IM2COL_DMA = 1,
+    IM2COL_AUTO = 2, // DMA if the shape can be planned in the given descriptors, CPU otherwise
+} im2col_backend_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Number of patches of an im2col, over the whole batch.
+ */
+uint32_t im2col_patches(const dma_tiling_im2col_t *shape);
+
+/**
+ * @brief Number of elements of a patch: channels times filter elements.
+ */
+uint32_t im2col_patch_length(const dma_tiling_im2col_t *shape);
+
+/**
+ * @brief Number of elements of the output of an im2col.
+ */
+uint32_t im2col_output_length(const dma_tiling_im2col_t *shape);
+
+/**
+ * @brief im2col on the CPU.
+ *
+ * @param shape Shape of the im2col
+ * @param input Input tensor
+ * @param output Output, im2col_output_length() elements
+ * @return 0 if success, -1 for an unknown type or a null stride
+ */
+int im2col_cpu(const dma_tiling_im2col_t *shape, const void *input, void *output);
+
+/**
+ * @brief im2col by the DMA, through dma_tiling_im2col() and dma_tiling_run().
+ *
+ * @param shape Shape of the im2col
+ * @param input Input tensor
+ * @param output Output, im2col_output_length() elements
+ * @param plan Descriptors, kept until the function returns
+ * @param plan_length Number of descriptors, at least dma_tiling_im2col_length()
+ * @return 0 if success, -1 if the shape needs more descriptors or cannot be
+ * planned, or the DMA refused the plan
+ */
+int im2col_dma(const dma_tiling_im2col_t *shape, const void *input, void *output,
+               dma_tiling_desc_t *plan, uint32_t plan_length);
+
+/**
+ * @brief im2col by a backend.
+ *
+ * @param backend IM2COL_AUTO falls back on the CPU when the DMA cannot plan
+ * the shape. plan may be NULL with IM2COL_CPU
+ * @return The backend that ran, or -1 on failure
+ */
+int im2col_run(im2col_backend_t backend, const dma_tiling_im2col_t *shape, const void *input,
+               void *output, dma_tiling_desc_t *plan, uint32_t plan_length);
+
+#endif // IM2COL_H_
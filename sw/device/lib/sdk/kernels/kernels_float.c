@@ -0,0 +1,208 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: kernels_float.c
+// Description: float GEMM, dot product, axpy, FIR and FFT kernels, with fused
+//              multiply-adds on the FPU and register blocking
+
+#include <math.h>
+
+#include "kernels_float.h"
+#include "csr.h"
+
+/********************************/
+/* ---- LOCAL MACROS ---- */
+/********************************/
+
+/* Initial state of the FS field of mstatus, which enables the FPU. */
+#define MSTATUS_FS_INITIAL (0x1 << 13)
+
+/* a * b + c, fused with the FPU (fmadd.s), as the soft-float library has no
+   cheap fused version. */
+#if KERNELS_HARD_FLOAT
+#define FMA(a, b, c) __builtin_fmaf((a), (b), (c))
+#else
+#define FMA(a, b, c) ((a) * (b) + (c))
+#endif
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+void kernels_float_init(void)
+{
+#if KERNELS_HARD_FLOAT
+    CSR_SET_BITS(CSR_REG_MSTATUS, MSTATUS_FS_INITIAL);
+#endif
+}
+
+void kernel_gemm_f32(const float *a, const float *bt, float *c, uint32_t m, uint32_t n, uint32_t k)
+{
+    // Blocks of 2 x 2 outputs: four independent accumulators, and each of the
+    // four loads of an iteration used by two multiply-adds
+    uint32_t i = 0;
+    for (; i + 2 <= m; i += 2)
+    {
+        const float *a0 = &a[i * k];
+        const float *a1 = a0 + k;
+        uint32_t j = 0;
+        for (; j + 2 <= n; j += 2)
+        {
+            const float *b0 = &bt[j * k];
+            const float *b1 = b0 + k;
+            float c00 = 0.0f, c01 = 0.0f, c10 = 0.0f, c11 = 0.0f;
+            for (uint32_t l = 0; l < k; l++)
+            {
+                float x0 = a0[l];
+                float x1 = a1[l];
+                float y0 = b0[l];
+                float y1 = b1[l];
+                c00 = FMA(x0, y0, c00);
+                c01 = FMA(x0, y1, c01);
+                c10 = FMA(x1, y0, c10);
+                c11 = FMA(x1, y1, c11);
+            }
+            c[i * n + j] = c00;
+            c[i * n + j + 1] = c01;
+            c[(i + 1) * n + j] = c10;
+            c[(i + 1) * n + j + 1] = c11;
+        }
+        for (; j < n; j++)
+        {
+            c[i * n + j] = kernel_dot_f32(a0, &bt[j * k], k);
+            c[(i + 1) * n + j] = kernel_dot_f32(a1, &bt[j * k], k);
+        }
+    }
+    for (; i < m; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            c[i * n + j] = kernel_dot_f32(&a[i * k], &bt[j * k], k);
+        }
+    }
+}
+
+float kernel_dot_f32(const float *x, const float *y, uint32_t n)
+{
+    float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        float x0 = x[i], x1 = x[i + 1], x2 = x[i + 2], x3 = x[i + 3];
+        float y0 = y[i], y1 = y[i + 1], y2 = y[i + 2], y3 = y[i + 3];
+        acc0 = FMA(x0, y0, acc0);
+        acc1 = FMA(x1, y1, acc1);
+        acc2 = FMA(x2, y2, acc2);
+        acc3 = FMA(x3, y3, acc3);
+    }
+    for (; i < n; i++)
+    {
+        acc0 = FMA(x[i], y[i], acc0);
+    }
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+void kernel_axpy_f32(float alpha, const float *x, float *y, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        float x0 = x[i], x1 = x[i + 1], x2 = x[i + 2], x3 = x[i + 3];
+        float y0 = y[i], y1 = y[i + 1], y2 = y[i + 2], y3 = y[i + 3];
+        y[i] = FMA(alpha, x0, y0);
+        y[i + 1] = FMA(alpha, x1, y1);
+        y[i + 2] = FMA(alpha, x2, y2);
+        y[i + 3] = FMA(alpha, x3, y3);
+    }
+    for (; i < n; i++)
+    {
+        y[i] = FMA(alpha, x[i], y[i]);
+    }
+}
+
+void kernel_fir_f32(const float *x, const float *h, float *out, uint32_t n, uint32_t taps)
+{
+    // Four outputs at once: each tap is loaded once for the four, and each
+    // sample for up to four taps
+    uint32_t len = KERNELS_FIR_OUT(n, taps);
+    uint32_t i = 0;
+    for (; i + 4 <= len; i += 4)
+    {
+        float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+        float x0 = x[i], x1 = x[i + 1], x2 = x[i + 2];
+        for (uint32_t j = 0; j < taps; j++)
+        {
+            float hj = h[j];
+            float x3 = x[i + j + 3];
+            acc0 = FMA(hj, x0, acc0);
+            acc1 = FMA(hj, x1, acc1);
+            acc2 = FMA(hj, x2, acc2);
+            acc3 = FMA(hj, x3, acc3);
+            x0 = x1;
+            x1 = x2;
+            x2 = x3;
+        }
+        out[i] = acc0;
+        out[i + 1] = acc1;
+        out[i + 2] = acc2;
+        out[i + 3] = acc3;
+    }
+    for (; i < len; i++)
+    {
+        out[i] = kernel_dot_f32(&x[i], h, taps);
+    }
+}
+
+void kernel_fft_f32_twiddles(kernel_complex_t *tw, uint32_t n)
+{
+    const float step = -6.28318530717958647692f / (float)n;
+    for (uint32_t j = 0; j < n / 2; j++)
+    {
+        tw[j].re = cosf(step * (float)j);
+        tw[j].im = sinf(step * (float)j);
+    }
+}
+
+void kernel_fft_f32(kernel_complex_t *x, const kernel_complex_t *tw, uint32_t n)
+{
+    // Bit-reversal permutation
+    for (uint32_t i = 1, j = 0; i < n; i++)
+    {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            kernel_complex_t t = x[i];
+            x[i] = x[j];
+            x[j] = t;
+        }
+    }
+
+    // Butterflies, each twiddle loaded once for all the groups of a stage
+    for (uint32_t len = 2; len <= n; len <<= 1)
+    {
+        uint32_t half = len >> 1;
+        uint32_t stride = n / len;
+        for (uint32_t j = 0; j < half; j++)
+        {
+            float wr = tw[j * stride].re;
+            float wi = tw[j * stride].im;
+            for (uint32_t i = j; i < n; i += len)
+            {
+                kernel_complex_t u = x[i];
+                kernel_complex_t v = x[i + half];
+                float tr = FMA(wr, v.re, -wi * v.im);
+                float ti = FMA(wr, v.im, wi * v.re);
+                x[i].re = u.re + tr;
+                x[i].im = u.im + ti;
+                x[i + half].re = u.re - tr;
+                x[i + half].im = u.im - ti;
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: kernels_float.h
+// Description: float GEMM, dot product, axpy, FIR and FFT kernels, with fused
+//              multiply-adds on the FPU and register blocking
+
+#ifndef KERNELS_FLOAT_H_
+#define KERNELS_FLOAT_H_
+
+#include <stdint.h>
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief 1 when the kernels use the FPU (ARCH with the F extension, e.g.
+ * rv32imfc, on a CPU built with FPU=1), 0 when they are built for soft-float.
+ */
+#if defined(__riscv_flen) && __riscv_flen >= 32
+#define KERNELS_HARD_FLOAT 1
+#else
+#define KERNELS_HARD_FLOAT 0
+#endif
+
+/**
+ * @brief Size of the output of a FIR filter without padding.
+ */
+#define KERNELS_FIR_OUT(n, taps) ((n) - (taps) + 1)
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Complex float, as interleaved real and imaginary parts.
+ */
+typedef struct
+{
+    float re;
+    float im;
+} kernel_complex_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/*
+ * The multiply-adds are fused (fmadd.s) with the FPU, and a multiply and an
+ * add of the soft-float library otherwise. The loops keep several independent
+ * accumulators and load their operands ahead of their use, since a
+ * multiply-add waits for the result of the previous one on the same
+ * accumulator and for its loads. The results can thus differ from the ones of
+ * a plain loop in their last bits.
+ *
+ * For the highest throughput, place the operands of a kernel in banks that
+ * the NtoM bus serves in parallel, e.g. interleaved banks with
+ * RAM_INTERLEAVED of ram_bank.h: the successive loads of a vector then go to
+ * successive banks.
+ */
+
+/**
+ * @brief Enables the FPU in mstatus, to call before the kernels or any other
+ * float code with the FPU. Does nothing with soft-float.
+ */
+void kernels_float_init(void);
+
+/**
+ * @brief GEMM, c = a * b, the matrices row-major. The second operand is
+ * transposed so that the dot products read contiguous vectors: with A of
+ * m x k and B of k x n, bt is B transposed, n x k, and c is m x n.
+ *
+ * @param a Matrix of m x k
+ * @param bt Transposed second matrix, n x k
+ * @param c Output, m x n
+ */
+void kernel_gemm_f32(const float *a, const float *bt, float *c, uint32_t m, uint32_t n, uint32_t k);
+
+/**
+ * @brief Dot product of two vectors of n elements.
+ */
+float kernel_dot_f32(const float *x, const float *y, uint32_t n);
+
+/**
+ * @brief y = alpha * x + y, on vectors of n elements.
+ */
+void kernel_axpy_f32(float alpha, const float *x, float *y, uint32_t n);
+
+/**
+ * @brief FIR filter without padding, out[i] = sum of h[j] * x[i + j].
+ *
+ * @param x Input of n samples
+ * @param h Taps
+ * @param out Output of KERNELS_FIR_OUT(n, taps) samples
+ */
+void kernel_fir_f32(const float *x, const float *h, float *out, uint32_t n, uint32_t taps);
+
+/**
+ * @brief Twiddle factors of kernel_fft_f32(), exp(-2 pi i j / n) for j
+ * below n / 2.
+ *
+ * @param tw Output, n / 2 factors
+ * @param n Size of the FFT, a power of 2
+ */
+void kernel_fft_f32_twiddles(kernel_complex_t *tw, uint32_t n);
+
+/**
+ * @brief In-place radix-2 decimation-in-time FFT.
+ *
+ * @param x Data of n samples, replaced by its transform
+ * @param tw Twiddle factors of kernel_fft_f32_twiddles() for n
+ * @param n Size of the FFT, a power of 2
+ */
+void kernel_fft_f32(kernel_complex_t *x, const kernel_complex_t *tw, uint32_t n);
+
+#endif // KERNELS_FLOAT_H_
@@ -0,0 +1,379 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: kernels_int.c
+// Description: int8 and int16 GEMM, GEMV and 2D convolution kernels, with the
+//              Xpulp SIMD, RV32IM and portable versions chosen at compile time
+
+#include "kernels_int.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// Every kernel is made of dot products of two contiguous vectors: a row of A
+// and a column of B (a row of bt), or a row of the filter and a part of a row
+// of the input. Each version only differs by its dot products.
+
+/* ---- Portable ---- */
+
+static inline int32_t dot_s8_portable(const int8_t *a, const int8_t *b, uint32_t n)
+{
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        acc += (int32_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+static inline int32_t dot_s16_portable(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        acc += (int32_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+/* ---- RV32IM ---- */
+
+// Words are loaded when both vectors are aligned, and their elements extracted
+// with shifts, which is cheaper than one load per element. Two accumulators
+// break the dependency between the multiply-adds.
+static inline int32_t dot_s8_rv32im(const int8_t *a, const int8_t *b, uint32_t n)
+{
+    int32_t acc0 = 0, acc1 = 0;
+    uint32_t i = 0;
+    if ((((uintptr_t)a | (uintptr_t)b) & 0x3) == 0)
+    {
+        const uint32_t *a32 = (const uint32_t *)a;
+        const uint32_t *b32 = (const uint32_t *)b;
+        for (; i + 4 <= n; i += 4)
+        {
+            uint32_t x = *a32++;
+            uint32_t y = *b32++;
+            acc0 += (int32_t)(int8_t)x * (int8_t)y;
+            acc1 += (int32_t)(int8_t)(x >> 8) * (int8_t)(y >> 8);
+            acc0 += (int32_t)(int8_t)(x >> 16) * (int8_t)(y >> 16);
+            acc1 += (int32_t)(int8_t)(x >> 24) * (int8_t)(y >> 24);
+        }
+    }
+    else
+    {
+        for (; i + 4 <= n; i += 4)
+        {
+            acc0 += (int32_t)a[i] * b[i];
+            acc1 += (int32_t)a[i + 1] * b[i + 1];
+            acc0 += (int32_t)a[i + 2] * b[i + 2];
+            acc1 += (int32_t)a[i + 3] * b[i + 3];
+        }
+    }
+    for (; i < n; i++)
+    {
+        acc0 += (int32_t)a[i] * b[i];
+    }
+    return acc0 + acc1;
+}
+
+static inline int32_t dot_s16_rv32im(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    int32_t acc0 = 0, acc1 = 0;
+    uint32_t i = 0;
+    if ((((uintptr_t)a | (uintptr_t)b) & 0x3) == 0)
+    {
+        const uint32_t *a32 = (const uint32_t *)a;
+        const uint32_t *b32 = (const uint32_t *)b;
+        for (; i + 2 <= n; i += 2)
+        {
+            uint32_t x = *a32++;
+            uint32_t y = *b32++;
+            acc0 += (int32_t)(int16_t)x * (int16_t)y;
+            acc1 += (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+        }
+    }
+    else
+    {
+        for (; i + 2 <= n; i += 2)
+        {
+            acc0 += (int32_t)a[i] * b[i];
+            acc1 += (int32_t)a[i + 1] * b[i + 1];
+        }
+    }
+    for (; i < n; i++)
+    {
+        acc0 += (int32_t)a[i] * b[i];
+    }
+    return acc0 + acc1;
+}
+
+/* ---- Xpulp ---- */
+
+#if KERNELS_VERSION == KERNELS_XPULP
+
+// Word load from any address, the CV32E40P cores split the misaligned ones
+static inline uint32_t load_word(const void *p)
+{
+    uint32_t w;
+    asm("lw %0, %1" : "=r"(w) : "m"(*(const uint32_t *)p));
+    return w;
+}
+
+// acc += dot product of the 4 bytes of x and y, signed
+static inline int32_t sdotsp_b(int32_t acc, uint32_t x, uint32_t y)
+{
+    asm("cv.sdotsp.b %0, %1, %2" : "+r"(acc) : "r"(x), "r"(y));
+    return acc;
+}
+
+// acc += dot product of the 2 halfwords of x and y, signed
+static inline int32_t sdotsp_h(int32_t acc, uint32_t x, uint32_t y)
+{
+    asm("cv.sdotsp.h %0, %1, %2" : "+r"(acc) : "r"(x), "r"(y));
+    return acc;
+}
+
+static inline int32_t dot_s8_xpulp(const int8_t *a, const int8_t *b, uint32_t n)
+{
+    int32_t acc = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc = sdotsp_b(acc, load_word(&a[i]), load_word(&b[i]));
+    }
+    for (; i < n; i++)
+    {
+        acc += (int32_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+static inline int32_t dot_s16_xpulp(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    int32_t acc = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        acc = sdotsp_h(acc, load_word(&a[i]), load_word(&b[i]));
+    }
+    for (; i < n; i++)
+    {
+        acc += (int32_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+#endif // KERNELS_VERSION == KERNELS_XPULP
+
+/* ---- Kernels ---- */
+
+// GEMV and convolution of a version, from its dot products
+#define KERNELS_DEFINE_GEMV_CONV(T, S, V)                                                          \
+    void kernel_gemv_##S##_##V(const T *a, const T *x, int32_t *y, uint32_t m, uint32_t k)        \
+    {                                                                                              \
+        for (uint32_t i = 0; i < m; i++)                                                           \
+        {                                                                                          \
+            y[i] = dot_##S##_##V(&a[i * k], x, k);                                                 \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    void kernel_conv2d_##S##_##V(const T *in, const T *f, int32_t *out, uint32_t h, uint32_t w,   \
+                                 uint32_t fh, uint32_t fw)                                         \
+    {                                                                                              \
+        uint32_t oh = KERNELS_CONV_OUT(h, fh);                                                     \
+        uint32_t ow = KERNELS_CONV_OUT(w, fw);                                                     \
+        for (uint32_t oy = 0; oy < oh; oy++)                                                       \
+        {                                                                                          \
+            for (uint32_t ox = 0; ox < ow; ox++)                                                   \
+            {                                                                                      \
+                int32_t acc = 0;                                                                   \
+                for (uint32_t fy = 0; fy < fh; fy++)                                               \
+                {                                                                                  \
+                    acc += dot_##S##_##V(&in[(oy + fy) * w + ox], &f[fy * fw], fw);                \
+                }                                                                                  \
+                out[oy * ow + ox] = acc;                                                           \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+// GEMM of a version, one dot product per output
+#define KERNELS_DEFINE_GEMM(T, S, V)                                                               \
+    void kernel_gemm_##S##_##V(const T *a, const T *bt, int32_t *c, uint32_t m, uint32_t n,       \
+                               uint32_t k)                                                         \
+    {                                                                                              \
+        for (uint32_t i = 0; i < m; i++)                                                           \
+        {                                                                                          \
+            for (uint32_t j = 0; j < n; j++)                                                       \
+            {                                                                                      \
+                c[i * n + j] = dot_##S##_##V(&a[i * k], &bt[j * k], k);                            \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+KERNELS_DEFINE_GEMM(int8_t, s8, portable)
+KERNELS_DEFINE_GEMM(int16_t, s16, portable)
+KERNELS_DEFINE_GEMV_CONV(int8_t, s8, portable)
+KERNELS_DEFINE_GEMV_CONV(int16_t, s16, portable)
+
+KERNELS_DEFINE_GEMM(int8_t, s8, rv32im)
+KERNELS_DEFINE_GEMM(int16_t, s16, rv32im)
+KERNELS_DEFINE_GEMV_CONV(int8_t, s8, rv32im)
+KERNELS_DEFINE_GEMV_CONV(int16_t, s16, rv32im)
+
+#if KERNELS_VERSION == KERNELS_XPULP
+
+KERNELS_DEFINE_GEMV_CONV(int8_t, s8, xpulp)
+KERNELS_DEFINE_GEMV_CONV(int16_t, s16, xpulp)
+
+// The GEMM computes blocks of 2 x 2 outputs, so that each word loaded from a
+// row of a or of bt is used by two dot products. The rows and columns left
+// over are computed one output at a time.
+void kernel_gemm_s8_xpulp(const int8_t *a, const int8_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k)
+{
+    uint32_t kw = k & ~0x3u;
+    uint32_t i = 0;
+    for (; i + 2 <= m; i += 2)
+    {
+        const int8_t *a0 = &a[i * k];
+        const int8_t *a1 = a0 + k;
+        uint32_t j = 0;
+        for (; j + 2 <= n; j += 2)
+        {
+            const int8_t *b0 = &bt[j * k];
+            const int8_t *b1 = b0 + k;
+            int32_t c00 = 0, c01 = 0, c10 = 0, c11 = 0;
+            for (uint32_t l = 0; l < kw; l += 4)
+            {
+                uint32_t x0 = load_word(&a0[l]);
+                uint32_t x1 = load_word(&a1[l]);
+                uint32_t y0 = load_word(&b0[l]);
+                uint32_t y1 = load_word(&b1[l]);
+                c00 = sdotsp_b(c00, x0, y0);
+                c01 = sdotsp_b(c01, x0, y1);
+                c10 = sdotsp_b(c10, x1, y0);
+                c11 = sdotsp_b(c11, x1, y1);
+            }
+            for (uint32_t l = kw; l < k; l++)
+            {
+                c00 += (int32_t)a0[l] * b0[l];
+                c01 += (int32_t)a0[l] * b1[l];
+                c10 += (int32_t)a1[l] * b0[l];
+                c11 += (int32_t)a1[l] * b1[l];
+            }
+            c[i * n + j] = c00;
+            c[i * n + j + 1] = c01;
+            c[(i + 1) * n + j] = c10;
+            c[(i + 1) * n + j + 1] = c11;
+        }
+        for (; j < n; j++)
+        {
+            c[i * n + j] = dot_s8_xpulp(a0, &bt[j * k], k);
+            c[(i + 1) * n + j] = dot_s8_xpulp(a1, &bt[j * k], k);
+        }
+    }
+    for (; i < m; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            c[i * n + j] = dot_s8_xpulp(&a[i * k], &bt[j * k], k);
+        }
+    }
+}
+
+void kernel_gemm_s16_xpulp(const int16_t *a, const int16_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k)
+{
+    uint32_t kw = k & ~0x1u;
+    uint32_t i = 0;
+    for (; i + 2 <= m; i += 2)
+    {
+        const int16_t *a0 = &a[i * k];
+        const int16_t *a1 = a0 + k;
+        uint32_t j = 0;
+        for (; j + 2 <= n; j += 2)
+        {
+            const int16_t *b0 = &bt[j * k];
+            const int16_t *b1 = b0 + k;
+            int32_t c00 = 0, c01 = 0, c10 = 0, c11 = 0;
+            for (uint32_t l = 0; l < kw; l += 2)
+            {
+                uint32_t x0 = load_word(&a0[l]);
+                uint32_t x1 = load_word(&a1[l]);
+                uint32_t y0 = load_word(&b0[l]);
+                uint32_t y1 = load_word(&b1[l]);
+                c00 = sdotsp_h(c00, x0, y0);
+                c01 = sdotsp_h(c01, x0, y1);
+                c10 = sdotsp_h(c10, x1, y0);
+                c11 = sdotsp_h(c11, x1, y1);
+            }
+            if (kw < k)
+            {
+                c00 += (int32_t)a0[kw] * b0[kw];
+                c01 += (int32_t)a0[kw] * b1[kw];
+                c10 += (int32_t)a1[kw] * b0[kw];
+                c11 += (int32_t)a1[kw] * b1[kw];
+            }
+            c[i * n + j] = c00;
+            c[i * n + j + 1] = c01;
+            c[(i + 1) * n + j] = c10;
+            c[(i + 1) * n + j + 1] = c11;
+        }
+        for (; j < n; j++)
+        {
+            c[i * n + j] = dot_s16_xpulp(a0, &bt[j * k], k);
+            c[(i + 1) * n + j] = dot_s16_xpulp(a1, &bt[j * k], k);
+        }
+    }
+    for (; i < m; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            c[i * n + j] = dot_s16_xpulp(&a[i * k], &bt[j * k], k);
+        }
+    }
+}
+
+#endif // KERNELS_VERSION == KERNELS_XPULP
+
+/* ---- Version of the configuration ---- */
+
+#if KERNELS_VERSION == KERNELS_XPULP
+#define KERNELS_CALL(name, ...) name##_xpulp(__VA_ARGS__)
+#elif KERNELS_VERSION == KERNELS_RV32IM
+#define KERNELS_CALL(name, ...) name##_rv32im(__VA_ARGS__)
+#else
+#define KERNELS_CALL(name, ...) name##_portable(__VA_ARGS__)
+#endif
+
+void kernel_gemm_s8(const int8_t *a, const int8_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k)
+{
+    KERNELS_CALL(kernel_gemm_s8, a, bt, c, m, n, k);
+}
+
+void kernel_gemm_s16(const int16_t *a, const int16_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k)
+{
+    KERNELS_CALL(kernel_gemm_s16, a, bt, c, m, n, k);
+}
+
+void kernel_gemv_s8(const int8_t *a, const int8_t *x, int32_t *y, uint32_t m, uint32_t k)
+{
+    KERNELS_CALL(kernel_gemv_s8, a, x, y, m, k);
+}
+
+void kernel_gemv_s16(const int16_t *a, const int16_t *x, int32_t *y, uint32_t m, uint32_t k)
+{
+    KERNELS_CALL(kernel_gemv_s16, a, x, y, m, k);
+}
+
+void kernel_conv2d_s8(const int8_t *in, const int8_t *f, int32_t *out, uint32_t h, uint32_t w,
+                      uint32_t fh, uint32_t fw)
+{
+    KERNELS_CALL(kernel_conv2d_s8, in, f, out, h, w, fh, fw);
+}
+
+void kernel_conv2d_s16(const int16_t *in, const int16_t *f, int32_t *out, uint32_t h, uint32_t w,
+                       uint32_t fh, uint32_t fw)
+{
+    KERNELS_CALL(kernel_conv2d_s16, in, f, out, h, w, fh, fw);
+}
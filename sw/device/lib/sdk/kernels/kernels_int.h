@@ -0,0 +1,142 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: kernels_int.h
+// Description: int8 and int16 GEMM, GEMV and 2D convolution kernels, with the
+//              Xpulp SIMD, RV32IM and portable versions chosen at compile time
+
+#ifndef KERNELS_INT_H_
+#define KERNELS_INT_H_
+
+#include <stdint.h>
+
+#include "core_v_mini_mcu.h"
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief Version of the kernels used by kernel_gemm_s8() and co:
+ * - KERNELS_XPULP with the CORE-V SIMD dot products (cv.sdotsp), on the CPUs
+ *   that have them (cv32e40p and cv32e40px built with COREV_PULP=1) when the
+ *   compiler targets them (the xcvsimd extension of ARCH);
+ * - KERNELS_RV32IM with the multiplier, the operands loaded by words;
+ * - KERNELS_PORTABLE otherwise, the reference loops.
+ * The hardware loops and post-increment loads of Xpulp are generated by the
+ * compiler from the loops of every version, when ARCH has them.
+ */
+#define KERNELS_PORTABLE 0
+#define KERNELS_RV32IM   1
+#define KERNELS_XPULP    2
+
+#if (defined(CPU_TYPE_CV32E40P) || defined(CPU_TYPE_CV32E40PX)) && defined(__riscv_xcvsimd)
+#define KERNELS_VERSION KERNELS_XPULP
+#elif defined(__riscv_mul)
+#define KERNELS_VERSION KERNELS_RV32IM
+#else
+#define KERNELS_VERSION KERNELS_PORTABLE
+#endif
+
+/**
+ * @brief Size of the output of a 2D convolution without padding, stride 1.
+ */
+#define KERNELS_CONV_OUT(in, f) ((in) - (f) + 1)
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/*
+ * All the matrices are row-major. The GEMM takes its second operand
+ * transposed, so that both operands of each dot product are contiguous: with
+ * A of m x k and B of k x n, bt is B transposed, n x k, and c = A * B is
+ * m x n. The accumulation is on 32 bits, without saturation.
+ *
+ * The SIMD and RV32IM versions are fastest with word aligned rows (k multiple
+ * of 4 for int8, of 2 for int16), the remaining elements of a row are
+ * computed one by one. The SIMD version loads words from any address, which
+ * the CV32E40P cores split in two accesses when misaligned, e.g. for the
+ * input of the convolution; the RV32IM one loads elements then.
+ */
+
+/**
+ * @brief int8 GEMM, c = a * b.
+ *
+ * @param a Matrix of m x k
+ * @param bt Transposed second matrix, n x k
+ * @param c Output, m x n
+ */
+void kernel_gemm_s8(const int8_t *a, const int8_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+
+/**
+ * @brief int16 GEMM, c = a * b, see kernel_gemm_s8().
+ */
+void kernel_gemm_s16(const int16_t *a, const int16_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+
+/**
+ * @brief int8 GEMV, y = a * x.
+ *
+ * @param a Matrix of m x k
+ * @param x Vector of k
+ * @param y Output, vector of m
+ */
+void kernel_gemv_s8(const int8_t *a, const int8_t *x, int32_t *y, uint32_t m, uint32_t k);
+
+/**
+ * @brief int16 GEMV, y = a * x, see kernel_gemv_s8().
+ */
+void kernel_gemv_s16(const int16_t *a, const int16_t *x, int32_t *y, uint32_t m, uint32_t k);
+
+/**
+ * @brief int8 2D convolution (correlation) of one channel, stride 1, no
+ * padding.
+ *
+ * @param in Input of h x w
+ * @param f Filter of fh x fw
+ * @param out Output of KERNELS_CONV_OUT(h, fh) x KERNELS_CONV_OUT(w, fw)
+ */
+void kernel_conv2d_s8(const int8_t *in, const int8_t *f, int32_t *out, uint32_t h, uint32_t w,
+                      uint32_t fh, uint32_t fw);
+
+/**
+ * @brief int16 2D convolution, see kernel_conv2d_s8().
+ */
+void kernel_conv2d_s16(const int16_t *in, const int16_t *f, int32_t *out, uint32_t h, uint32_t w,
+                       uint32_t fh, uint32_t fw);
+
+/*
+ * Every version, for the benchmarks and the tests: the functions above are
+ * the ones of KERNELS_VERSION. The Xpulp ones only exist with it.
+ */
+void kernel_gemm_s8_portable(const int8_t *a, const int8_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+void kernel_gemm_s16_portable(const int16_t *a, const int16_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+void kernel_gemv_s8_portable(const int8_t *a, const int8_t *x, int32_t *y, uint32_t m, uint32_t k);
+void kernel_gemv_s16_portable(const int16_t *a, const int16_t *x, int32_t *y, uint32_t m, uint32_t k);
+void kernel_conv2d_s8_portable(const int8_t *in, const int8_t *f, int32_t *out, uint32_t h, uint32_t w,
+                               uint32_t fh, uint32_t fw);
+void kernel_conv2d_s16_portable(const int16_t *in, const int16_t *f, int32_t *out, uint32_t h, uint32_t w,
+                                uint32_t fh, uint32_t fw);
+
+void kernel_gemm_s8_rv32im(const int8_t *a, const int8_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+void kernel_gemm_s16_rv32im(const int16_t *a, const int16_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+void kernel_gemv_s8_rv32im(const int8_t *a, const int8_t *x, int32_t *y, uint32_t m, uint32_t k);
+void kernel_gemv_s16_rv32im(const int16_t *a, const int16_t *x, int32_t *y, uint32_t m, uint32_t k);
+void kernel_conv2d_s8_rv32im(const int8_t *in, const int8_t *f, int32_t *out, uint32_t h, uint32_t w,
+                             uint32_t fh, uint32_t fw);
+void kernel_conv2d_s16_rv32im(const int16_t *in, const int16_t *f, int32_t *out, uint32_t h, uint32_t w,
+                              uint32_t fh, uint32_t fw);
+
+#if KERNELS_VERSION == KERNELS_XPULP
+void kernel_gemm_s8_xpulp(const int8_t *a, const int8_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+void kernel_gemm_s16_xpulp(const int16_t *a, const int16_t *bt, int32_t *c, uint32_t m, uint32_t n, uint32_t k);
+void kernel_gemv_s8_xpulp(const int8_t *a, const int8_t *x, int32_t *y, uint32_t m, uint32_t k);
+void kernel_gemv_s16_xpulp(const int16_t *a, const int16_t *x, int32_t *y, uint32_t m, uint32_t k);
+void kernel_conv2d_s8_xpulp(const int8_t *in, const int8_t *f, int32_t *out, uint32_t h, uint32_t w,
+                            uint32_t fh, uint32_t fw);
+void kernel_conv2d_s16_xpulp(const int16_t *in, const int16_t *f, int32_t *out, uint32_t h, uint32_t w,
+                             uint32_t fh, uint32_t fw);
+#endif
+
+#endif // KERNELS_INT_H_
@@ -0,0 +1,403 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: nn.c
+// Description: int8 inference of sequential networks, on the kernels of
+//              kernels_int.h and the im2col of im2col.h, with the weights
+//              kept in RAM or streamed from the W25Q flash
+
+#include <stddef.h>
+
+#include "nn.h"
+#include "im2col.h"
+#include "kernels_int.h"
+#include "w25q128jw.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+static inline uint32_t nn_min(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline uint32_t nn_length(const nn_shape_t *shape)
+{
+    return (uint32_t)shape->h * shape->w * shape->c;
+}
+
+// Elements of a row of weights: one patch, or the whole input of a dense layer
+static inline uint32_t nn_row_length(const nn_layer_t *layer)
+{
+    if (layer->op == NN_DENSE)
+    {
+        return nn_length(&layer->in);
+    }
+    return (uint32_t)layer->fh * layer->fw * layer->in.c;
+}
+
+// A 1x1 convolution of stride 1 takes its input as the patches
+static inline int nn_needs_im2col(const nn_layer_t *layer)
+{
+    return layer->op == NN_CONV2D &&
+           !(layer->fh == 1 && layer->fw == 1 && layer->stride == 1 && layer->pad == 0);
+}
+
+// Rows of weights of which a block must be made for the chunks of the
+// prefetcher to be whole words, except the last one
+static inline uint32_t nn_row_align(uint32_t k)
+{
+    return (k & 0x3) == 0 ? 1 : (k & 0x1) == 0 ? 2 : 4;
+}
+
+// Output channels computed at a time: as many as the accumulators hold, and
+// as the stream buffers hold when the weights are in the flash
+static uint32_t nn_block(const nn_model_t *model, const nn_layer_t *layer, uint32_t patches, uint32_t k)
+{
+    uint32_t block = nn_min(model->acc_length / patches, layer->oc);
+
+    if (layer->weights == NULL)
+    {
+        if (model->stream[0] == NULL || model->stream[1] == NULL)
+        {
+            return 0;
+        }
+        block = nn_min(block, (model->stream_length & ~0x3u) / k);
+        if (block < layer->oc)
+        {
+            block -= block % nn_row_align(k);
+        }
+    }
+
+    return block;
+}
+
+static inline int8_t nn_requantize(const nn_layer_t *layer, int32_t acc)
+{
+    int64_t v = (int64_t)acc * layer->mult;
+    if (layer->shift != 0)
+    {
+        v = (v + ((int64_t)1 << (layer->shift - 1))) >> layer->shift;
+    }
+    if (v < layer->act_min)
+    {
+        v = layer->act_min;
+    }
+    if (v > layer->act_max)
+    {
+        v = layer->act_max;
+    }
+    return (int8_t)v;
+}
+
+// Output channels oc0 to oc0 + rows - 1 of a convolution or dense layer,
+// from their rows of weights w
+static void nn_block_run(const nn_model_t *model, const nn_layer_t *layer, const int8_t *a,
+                         const int8_t *w, uint32_t patches, uint32_t k, uint32_t oc0, uint32_t rows,
+                         int8_t *out)
+{
+    int32_t *acc = model->acc;
+
+    if (patches == 1)
+    {
+        kernel_gemv_s8(w, a, acc, rows, k);
+    }
+    else
+    {
+        kernel_gemm_s8(a, w, acc, patches, rows, k);
+    }
+
+    for (uint32_t p = 0; p < patches; p++)
+    {
+        int8_t *o = out + p * layer->oc + oc0;
+        for (uint32_t j = 0; j < rows; j++)
+        {
+            int32_t bias = layer->bias != NULL ? layer->bias[oc0 + j] : 0;
+            o[j] = nn_requantize(layer, acc[j] + bias);
+        }
+        acc += rows;
+    }
+}
+
+// Every output channel of a convolution or dense layer, of the patches a, one
+// row of k elements each
+static nn_status_t nn_mac_run(const nn_model_t *model, const nn_layer_t *layer, const int8_t *a,
+                              uint32_t patches, int8_t *out)
+{
+    uint32_t k = nn_row_length(layer);
+    uint32_t block = nn_block(model, layer, patches, k);
+    if (block == 0)
+    {
+        return NN_ERROR_BUFFER;
+    }
+
+    if (layer->weights != NULL)
+    {
+        for (uint32_t oc0 = 0; oc0 < layer->oc; oc0 += block)
+        {
+            nn_block_run(model, layer, a, layer->weights + oc0 * k, patches, k, oc0,
+                         nn_min(block, layer->oc - oc0), out);
+        }
+        return NN_OK;
+    }
+
+    // The DMA reads the next block into the other buffer while this one is
+    // computed. A single block may end in the middle of a word: its chunk is
+    // rounded up, the buffers holding it
+    w25q128jw_prefetch_t prefetch;
+    uint32_t chunk = (block * k + 3) & ~0x3u;
+    if (w25q128jw_prefetch_start(&prefetch, layer->weights_flash, (uint32_t)layer->oc * k,
+                                 model->stream[0], model->stream[1], chunk) != FLASH_OK)
+    {
+        return NN_ERROR_FLASH;
+    }
+
+    uint32_t oc0 = 0;
+    uint32_t length;
+    const int8_t *w;
+    while (oc0 < layer->oc && (w = w25q128jw_prefetch_next(&prefetch, &length)) != NULL)
+    {
+        uint32_t rows = length / k;
+        nn_block_run(model, layer, a, w, patches, k, oc0, rows, out);
+        oc0 += rows;
+    }
+    w25q128jw_prefetch_stop(&prefetch);
+
+    return oc0 == layer->oc ? NN_OK : NN_ERROR_FLASH;
+}
+
+static nn_status_t nn_conv2d_run(const nn_model_t *model, const nn_layer_t *layer, const int8_t *in,
+                                 const nn_shape_t *out_shape, int8_t *out)
+{
+    uint32_t patches = (uint32_t)out_shape->h * out_shape->w;
+    const int8_t *a = in;
+
+    if (nn_needs_im2col(layer))
+    {
+        const dma_tiling_im2col_t shape = {
+            .format = DMA_TILING_NHWC,
+            .type = DMA_DATA_TYPE_BYTE,
+            .batch = 1,
+            .ch = layer->in.c,
+            .ih = layer->in.h,
+            .iw = layer->in.w,
+            .fh = layer->fh,
+            .fw = layer->fw,
+            .stride = layer->stride,
+            .pad = layer->pad,
+        };
+        if (im2col_output_length(&shape) > model->col_length)
+        {
+            return NN_ERROR_BUFFER;
+        }
+        // Before the reads of the weights, which also take the DMA
+        im2col_backend_t backend = model->plan != NULL ? IM2COL_AUTO : IM2COL_CPU;
+        if (im2col_run(backend, &shape, in, model->col, model->plan, model->plan_length) < 0)
+        {
+            return NN_ERROR_SHAPE;
+        }
+        a = model->col;
+    }
+
+    return nn_mac_run(model, layer, a, patches, out);
+}
+
+static void nn_maxpool_run(const nn_layer_t *layer, const int8_t *in, const nn_shape_t *out_shape,
+                           int8_t *out)
+{
+    uint32_t c = layer->in.c;
+    uint32_t row = (uint32_t)layer->in.w * c;
+
+    // Channels are contiguous in NHWC: each pixel of a window updates a
+    // whole output pixel
+    for (uint32_t oy = 0; oy < out_shape->h; oy++)
+    {
+        for (uint32_t ox = 0; ox < out_shape->w; ox++)
+        {
+            const int8_t *win = in + oy * layer->stride * row + ox * layer->stride * c;
+            for (uint32_t i = 0; i < c; i++)
+            {
+                out[i] = win[i];
+            }
+            for (uint32_t fy = 0; fy < layer->fh; fy++)
+            {
+                for (uint32_t fx = 0; fx < layer->fw; fx++)
+                {
+                    const int8_t *px = win + fy * row + fx * c;
+                    for (uint32_t i = 0; i < c; i++)
+                    {
+                        if (px[i] > out[i])
+                        {
+                            out[i] = px[i];
+                        }
+                    }
+                }
+            }
+            out += c;
+        }
+    }
+}
+
+nn_status_t nn_output_shape(const nn_layer_t *layer, nn_shape_t *out)
+{
+    const nn_shape_t *in = &layer->in;
+
+    if (in->h == 0 || in->w == 0 || in->c == 0)
+    {
+        return NN_ERROR_SHAPE;
+    }
+
+    switch (layer->op)
+    {
+    case NN_CONV2D:
+        if (layer->oc == 0 || layer->fh == 0 || layer->fw == 0 || layer->stride == 0 ||
+            layer->fh > in->h + 2 * layer->pad || layer->fw > in->w + 2 * layer->pad)
+        {
+            return NN_ERROR_SHAPE;
+        }
+        out->h = DMA_TILING_PATCHES(in->h, layer->fh, layer->stride, layer->pad);
+        out->w = DMA_TILING_PATCHES(in->w, layer->fw, layer->stride, layer->pad);
+        out->c = layer->oc;
+        return NN_OK;
+
+    case NN_DENSE:
+        if (layer->oc == 0)
+        {
+            return NN_ERROR_SHAPE;
+        }
+        out->h = 1;
+        out->w = 1;
+        out->c = layer->oc;
+        return NN_OK;
+
+    case NN_MAXPOOL:
+        if (layer->fh == 0 || layer->fw == 0 || layer->stride == 0 ||
+            layer->fh > in->h || layer->fw > in->w)
+        {
+            return NN_ERROR_SHAPE;
+        }
+        out->h = DMA_TILING_PATCHES(in->h, layer->fh, layer->stride, 0);
+        out->w = DMA_TILING_PATCHES(in->w, layer->fw, layer->stride, 0);
+        out->c = in->c;
+        return NN_OK;
+
+    default:
+        return NN_ERROR_SHAPE;
+    }
+}
+
+nn_status_t nn_model_check(const nn_model_t *model, nn_requirements_t *req)
+{
+    nn_requirements_t min = {0};
+    nn_status_t status = NN_OK;
+    nn_shape_t shape = {0};
+
+    if (model->count == 0)
+    {
+        return NN_ERROR_SHAPE;
+    }
+
+    for (uint32_t l = 0; l < model->count; l++)
+    {
+        const nn_layer_t *layer = &model->layers[l];
+        const nn_shape_t in = layer->in;
+
+        if ((l > 0 && (in.h != shape.h || in.w != shape.w || in.c != shape.c)) ||
+            nn_output_shape(layer, &shape) != NN_OK)
+        {
+            return NN_ERROR_SHAPE;
+        }
+
+        if (nn_length(&in) > min.act_length)
+        {
+            min.act_length = nn_length(&in);
+        }
+        if (nn_length(&shape) > min.act_length)
+        {
+            min.act_length = nn_length(&shape);
+        }
+        if (layer->op == NN_MAXPOOL)
+        {
+            continue;
+        }
+
+        uint32_t patches = (uint32_t)shape.h * shape.w;
+        uint32_t k = nn_row_length(layer);
+        if (nn_needs_im2col(layer) && patches * k > min.col_length)
+        {
+            min.col_length = patches * k;
+        }
+        // A block of the flash is made of nn_row_align() rows
+        uint32_t rows = layer->weights == NULL ? nn_min(nn_row_align(k), layer->oc) : 1;
+        if (patches * rows > min.acc_length)
+        {
+            min.acc_length = patches * rows;
+        }
+        if (layer->weights == NULL && ((rows * k + 3) & ~0x3u) > min.stream_length)
+        {
+            min.stream_length = (rows * k + 3) & ~0x3u;
+        }
+        if (status == NN_OK && nn_block(model, layer, patches, k) == 0)
+        {
+            status = NN_ERROR_BUFFER;
+        }
+    }
+
+    if (status == NN_OK &&
+        (min.act_length > model->act_length || min.col_length > model->col_length))
+    {
+        status = NN_ERROR_BUFFER;
+    }
+
+    if (req != NULL)
+    {
+        *req = min;
+    }
+    return status;
+}
+
+nn_status_t nn_layer_run(const nn_model_t *model, const nn_layer_t *layer, const int8_t *in, int8_t *out)
+{
+    nn_shape_t out_shape;
+    nn_status_t status = nn_output_shape(layer, &out_shape);
+    if (status != NN_OK)
+    {
+        return status;
+    }
+
+    switch (layer->op)
+    {
+    case NN_CONV2D:
+        return nn_conv2d_run(model, layer, in, &out_shape, out);
+    case NN_DENSE:
+        return nn_mac_run(model, layer, in, 1, out);
+    default:
+        nn_maxpool_run(layer, in, &out_shape, out);
+        return NN_OK;
+    }
+}
+
+nn_status_t nn_model_run(const nn_model_t *model, int8_t **output)
+{
+    nn_status_t status = nn_model_check(model, NULL);
+    if (status != NN_OK)
+    {
+        return status;
+    }
+
+    uint32_t idx = 0;
+    for (uint32_t l = 0; l < model->count; l++)
+    {
+        status = nn_layer_run(model, &model->layers[l], model->act[idx], model->act[idx ^ 1]);
+        if (status != NN_OK)
+        {
+            return status;
+        }
+        idx ^= 1;
+    }
+
+    *output = model->act[idx];
+    return NN_OK;
+}
@@ -0,0 +1,181 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: nn.h
+// Description: int8 inference of sequential networks, on the kernels of
+//              kernels_int.h and the im2col of im2col.h, with the weights
+//              kept in RAM or streamed from the W25Q flash
+
+#ifndef NN_H_
+#define NN_H_
+
+#include <stdint.h>
+
+#include "dma_tiling.h"
+
+/*
+ * A model is a sequence of layers, each one taking the output of the previous
+ * one. The tensors are int8 NHWC of a single batch, quantized symmetrically
+ * as the s8 kernels of CMSIS-NN with null offsets: the zero of every tensor
+ * is 0, so the padding of the convolutions is the zero padding of im2col.
+ *
+ * A convolution is an im2col of its input (by the DMA when the shape can be
+ * planned in the descriptors of the model, by the CPU otherwise, and skipped
+ * for the 1x1 convolutions of stride 1) followed by kernel_gemm_s8() of the
+ * patches and the filters. A dense layer is kernel_gemv_s8() of its weights
+ * and its input, flattened. The 32-bit accumulators are then requantized:
+ *
+ *     out = clamp((acc + bias) * mult >> shift, act_min, act_max)
+ *
+ * rounded to the nearest, a fused ReLU being act_min = 0.
+ *
+ * The weights of a layer are one row of k = fh * fw * in.c elements per
+ * output channel, in the order of the patches of im2col: input channel, then
+ * filter row, then filter column; a dense layer has one row of its whole
+ * input per unit, in the NHWC order. k should be a multiple of 4, for the
+ * word loads of the kernels. The weights are either in RAM, or in the flash: they
+ * are then read by w25q128jw_prefetch_next() into the two stream buffers of
+ * the model in turn, a block of output channels at a time, and the DMA reads
+ * the next block while the CPU computes the current one. The blocks are read
+ * as whole words, so with k not a multiple of 4 they are made of 2 or 4
+ * output channels. A model larger than the RAM only needs the stream buffers
+ * for its weights, which are best put in the interleaved banks
+ * (RAM_INTERLEAVED of ram_bank.h), so that the writes of the DMA and the
+ * reads of the kernels are spread over the banks.
+ *
+ * The flash must be initialized with w25q128jw_init() before a model with
+ * weights in the flash runs, and no other flash operation can be issued while
+ * it runs. The flash reads and the DMA im2col of a layer do not overlap.
+ */
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Operator of a layer.
+ */
+typedef enum
+{
+    NN_CONV2D = 0,  // Convolution, fh x fw filters, stride and zero padding
+    NN_DENSE = 1,   // Fully connected, on the flattened input
+    NN_MAXPOOL = 2, // Max pooling per channel, fh x fw windows, stride, no padding
+} nn_op_t;
+
+/**
+ * @brief Status of the functions of the runtime.
+ */
+typedef enum
+{
+    NN_OK = 0,
+    NN_ERROR_SHAPE = -1,  // A layer does not fit its input, or an empty shape
+    NN_ERROR_BUFFER = -2, // A buffer of the model is too small for a layer
+    NN_ERROR_FLASH = -3,  // A read of the weights failed
+} nn_status_t;
+
+/**
+ * @brief Shape of an NHWC tensor.
+ */
+typedef struct
+{
+    uint16_t h;
+    uint16_t w;
+    uint16_t c;
+} nn_shape_t;
+
+/**
+ * @brief Layer of a model.
+ */
+typedef struct
+{
+    nn_op_t op;
+    nn_shape_t in;          // Shape of the input
+    uint16_t oc;            // Output channels of a convolution, units of a dense layer
+    uint16_t fh;            // Filter or window height
+    uint16_t fw;            // Filter or window width
+    uint16_t stride;        // Same stride along both dimensions
+    uint16_t pad;           // Zeros added on each border of the input of a convolution
+    const int8_t *weights;  // oc rows of k elements in RAM, or NULL if in the flash
+    uint32_t weights_flash; // 24-bit flash address of the weights, if weights is NULL
+    const int32_t *bias;    // oc biases, or NULL
+    int32_t mult;           // Requantization multiplier
+    uint8_t shift;          // Requantization shift, 0 to 62
+    int8_t act_min;         // Clamp of the output
+    int8_t act_max;
+} nn_layer_t;
+
+/**
+ * @brief Model and its buffers, allocated by the application and given
+ * sizes at least those of nn_model_check().
+ */
+typedef struct
+{
+    const nn_layer_t *layers;
+    uint32_t count;
+    int8_t *act[2];           // Activations, the input of the model in act[0]
+    uint32_t act_length;      // Bytes of each one
+    int8_t *col;              // Patches of the convolutions
+    uint32_t col_length;      // Bytes
+    int32_t *acc;             // Accumulators of a block of output channels
+    uint32_t acc_length;      // Words
+    int8_t *stream[2];        // Weights read from the flash, word aligned, or NULL
+    uint32_t stream_length;   // Bytes of each one
+    dma_tiling_desc_t *plan;  // Descriptors of the DMA im2col, or NULL for the CPU
+    uint32_t plan_length;
+} nn_model_t;
+
+/**
+ * @brief Sizes of the buffers needed by a model.
+ */
+typedef struct
+{
+    uint32_t act_length;    // Largest tensor
+    uint32_t col_length;    // Largest im2col
+    uint32_t acc_length;    // Accumulators of the smallest block of the largest layer
+    uint32_t stream_length; // Smallest block of weights of the layers in the flash
+} nn_requirements_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Shape of the output of a layer.
+ *
+ * @return NN_OK, or NN_ERROR_SHAPE if the layer does not fit its input
+ */
+nn_status_t nn_output_shape(const nn_layer_t *layer, nn_shape_t *out);
+
+/**
+ * @brief Check that each layer takes the output of the previous one and that
+ * the buffers of the model hold every layer.
+ *
+ * With larger accumulators and stream buffers than the minimum, the layers
+ * are computed and read by larger blocks of output channels: fewer, longer
+ * flash reads and GEMMs of more columns.
+ *
+ * @param req Set to the minimal sizes of the buffers, may be NULL
+ * @return NN_OK, or the first error
+ */
+nn_status_t nn_model_check(const nn_model_t *model, nn_requirements_t *req);
+
+/**
+ * @brief Run a layer.
+ *
+ * @param in Input of the layer's input shape
+ * @param out Output, which must not overlap the input
+ * @return NN_OK, or an error, the output being then incomplete
+ */
+nn_status_t nn_layer_run(const nn_model_t *model, const nn_layer_t *layer, const int8_t *in, int8_t *out);
+
+/**
+ * @brief Run a model on the input in model->act[0], the layers taking the
+ * activation buffers in turn.
+ *
+ * @param output Set to the buffer of the output of the last layer
+ * @return NN_OK, or the error of the first layer that failed
+ */
+nn_status_t nn_model_run(const nn_model_t *model, int8_t **output);
+
+#endif // NN_H_
@@ -0,0 +1,42 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: pdm2pcm_stream.c
+// Description: Continuous PDM2PCM capture into a ring of PCM buffers through the DMA
+
+#include "pdm2pcm_stream.h"
+#include "pdm2pcm.h"
+#include "dma_stream.h"
+#include "dma.h"
+#include "core_v_mini_mcu.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+int pdm2pcm_stream_init(dma_stream_t *stream, uint32_t *ring, uint32_t buffer_words,
+                        uint32_t buffer_count, dma_stream_callback_t callback, void *arg)
+{
+    return dma_stream_init(stream, (uint8_t *)ring, buffer_words, buffer_count,
+                           DMA_DATA_TYPE_WORD, (uint8_t *)PDM2PCM_RX_DATA_ADDRESS, 0,
+                           DMA_TRIG_SLOT_PDM2PCM, callback, arg);
+}
+
+int pdm2pcm_stream_start(dma_stream_t *stream)
+{
+    // The DMA waits for the samples, so it is started before the conversion
+    if (dma_stream_start(stream) != 0)
+    {
+        return -1;
+    }
+    pdm2pcm_start();
+    return 0;
+}
+
+void pdm2pcm_stream_stop(dma_stream_t *stream)
+{
+    // The samples must keep coming until the DMA reaches the end of the ring
+    dma_stream_stop(stream);
+    pdm2pcm_stop();
+}
@@ -0,0 +1,56 @@
+// Copyright 2024 EPFL and Politecnico di Torino.
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: pdm2pcm_stream.h
+// Description: Continuous PDM2PCM capture into a ring of PCM buffers through the DMA
+
+#ifndef PDM2PCM_STREAM_H_
+#define PDM2PCM_STREAM_H_
+
+#include <stdint.h>
+
+#include "pdm2pcm.h"
+#include "dma_stream.h"
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Set up a DMA stream copying the PCM samples of the PDM2PCM
+ * peripheral into a ring of buffers, one word per sample (see
+ * PDM2PCM_SAMPLE_TO_INT()). The DMA waits on the PDM2PCM trigger slot, and
+ * its window interrupt marks each filled buffer and calls the callback.
+ *
+ * @param stream Stream to initialize
+ * @param ring Memory of the ring, buffer_count * buffer_words words
+ * @param buffer_words Number of samples of a buffer
+ * @param buffer_count Number of buffers in the ring, at least 2
+ * @param callback Called from the interrupt handler when a buffer is filled, or NULL
+ * @param arg Argument passed to the callback
+ * @return int 0 if success, -1 if the ring is not valid
+ */
+int pdm2pcm_stream_init(dma_stream_t *stream, uint32_t *ring, uint32_t buffer_words,
+                        uint32_t buffer_count, dma_stream_callback_t callback, void *arg);
+
+/**
+ * @brief Start the DMA stream, then the conversion. The peripheral must have
+ * been configured with pdm2pcm_init() and the PLIC initialized with
+ * plic_Init(). The buffers are taken and released with dma_stream_get() and
+ * dma_stream_release() when there is no callback.
+ *
+ * @param stream Stream initialized by pdm2pcm_stream_init()
+ * @return int 0 if success, -1 if no DMA channel is free
+ */
+int pdm2pcm_stream_start(dma_stream_t *stream);
+
+/**
+ * @brief Stop the DMA stream once it reaches the end of the ring, then the
+ * conversion.
+ *
+ * @param stream Running stream
+ */
+void pdm2pcm_stream_stop(dma_stream_t *stream);
+
+#endif /* PDM2PCM_STREAM_H_ */
@@ -38,6 +38,11 @@
 #include "soc_ctrl_structs.h"
 #include "bitfield.h"
 #include "csr.h"
+#include "sync.h"
+#include "dma.h"
+#include "dma_sdk.h"
+#include "async.h"
+#include "clk_gate.h"
 
 /****************************************************************************/
 /**                                                                        **/
@@ -80,6 +85,21 @@
 // Check command length validity
 #define SPI_INVALID_LEN(len) (len == 0 || len > MAX_COMMAND_LENGTH)
 
+// Value of the DMA channel of a direction moved by the CPU
+#define SPI_DMA_NO_CHANNEL -1
+// Maximum number of words of a DMA transaction, the length of a segment. The
+// DMA driver splits the transactions larger than its 16-bit size registers.
+#define SPI_DMA_MAX_WORDS  ((SPI_HOST_COMMAND_LEN_MASK + 1) / 4)
+
+// Critical sections against the SPI interrupts, restoring the previous state
+#define SPI_IRQ_SAVE(mstatus) do { \
+    CSR_READ(CSR_REG_MSTATUS, &mstatus); \
+    CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8); \
+} while (0)
+#define SPI_IRQ_RESTORE(mstatus) do { \
+    if (mstatus & 0x8) CSR_SET_BITS(CSR_REG_MSTATUS, 0x8); \
+} while (0)
+
 /**
  * @brief Allows easy TX Transaction instantiation.
  */
@@ -144,6 +164,9 @@ typedef struct {
     uint32_t             txlen;     // Size of TX array/buffer
     uint32_t*            rxbuffer;  // Pointer to array/buffer for RX data
     uint32_t             rxlen;     // Size of RX array/buffer
+    bool                 bytes;     // Buffers are byte streams of any alignment
+    uint8_t              headlen;   // Bytes of the head segment of byte buffers (0 if none)
+    uint32_t             bytelen;   // Number of bytes of byte buffers
 } spi_transaction_t;
 
 /**
@@ -164,8 +187,36 @@ typedef struct {
     uint32_t          txcnt;     // Counter to track TX word being processed
     uint32_t          rxcnt;     // Counter to track RX word being processed
     spi_callbacks_t   callbacks; // Callback functions to call
+    uint8_t           dma_tx_slot; // DMA trigger slot of the TX FIFO (MEMORY if none)
+    uint8_t           dma_rx_slot; // DMA trigger slot of the RX FIFO (MEMORY if none)
+    int8_t            dma_tx_ch;   // DMA channel moving the TX words, if any
+    int8_t            dma_rx_ch;   // DMA channel moving the RX words, if any
+    spi_queued_txn_t* queue;     // Queued transactions, by decreasing priority
+    bool              blocking;  // A blocking function waits for the current transaction
+    uint8_t           clk_idx;   // Index of its clock in clk_gate.h, CLK_GATE_NO_PERIPH if always-on
+    bool              clk_held;  // Its clock is held by spi_clk_hold()
+    spi_segment_t     byte_segs[2]; // Segments of the transaction with byte buffers
 } spi_peripheral_t;
 
+/**
+ * @brief DMA targets and transaction moving one direction of a transaction in
+ *  DMA mode. They must stay allocated while the DMA runs, hence one per channel.
+ */
+typedef struct {
+    dma_target_t mem;   // TX or RX buffer
+    dma_target_t fifo;  // TX or RX FIFO of the SPI peripheral
+    dma_trans_t  trans; // Transaction between both
+} spi_dma_desc_t;
+
+/**
+ * @brief State of spi_wait_transaction_done, shared with its wake-up condition.
+ */
+typedef struct {
+    spi_peripheral_t* peri;
+    uint64_t          start;         // Tick counter value at the start
+    uint64_t          timeout_ticks; // Timeout of the transaction in ticks
+} spi_wait_t;
+
 /****************************************************************************/
 /**                                                                        **/
 /*                      PROTOTYPES OF LOCAL FUNCTIONS                       */
@@ -213,6 +264,15 @@ spi_codes_e spi_prepare_transfer(spi_t* spi);
  */
 uint32_t spi_true_slave_freq(uint32_t freq);
 
+/**
+ * @brief Computes the SPI clk divider giving the highest frequency not above
+ *  the user desired frequency.
+ * 
+ * @param freq Frequency defined by user
+ * @return uint16_t The clk divider
+ */
+uint16_t spi_clk_div(uint32_t freq);
+
 /**
  * @brief Validates all the provided segments and counts the number of words for
  *  TX and RX buffers.
@@ -227,6 +287,52 @@ uint32_t spi_true_slave_freq(uint32_t freq);
 bool spi_validate_segments(const spi_segment_t* segments, uint32_t segments_len, 
                            uint32_t* tx_count, uint32_t* rx_count);
 
+/**
+ * @brief Builds a transaction with byte buffers. If the buffer to align (RX if
+ *  any, since it is written, TX otherwise) does not start on a word boundary, 
+ *  a first segment ends at the boundary so that the words of the second one
+ *  are aligned in memory.
+ * 
+ * @param peri Pointer to the spi_peripheral_t instance holding the segments
+ * @param mode Mode of the segments
+ * @param src TX bytes, NULL if none
+ * @param dst RX bytes, NULL if none
+ * @param len Number of bytes
+ * @return spi_transaction_t The transaction
+ */
+spi_transaction_t spi_bytes_txn(spi_peripheral_t* peri, spi_mode_e mode, 
+                                const uint8_t* src, uint8_t* dst, uint32_t len);
+
+/**
+ * @brief Gets the position in the byte buffers of a FIFO word of a transaction
+ *  with byte buffers.
+ * 
+ * @param txn The transaction
+ * @param k Index of the word
+ * @param n Variable to store the number of bytes of the buffers in the word
+ * @return uint32_t The offset of the first byte of the word in the buffers
+ */
+uint32_t spi_byte_word_offset(const spi_transaction_t* txn, uint32_t k, uint32_t* n);
+
+/**
+ * @brief Builds a TX FIFO word from a TX buffer of bytes.
+ * 
+ * @param peri Pointer to the spi_peripheral_t instance with the relevant data
+ * @param k Index of the word
+ * @return uint32_t The word, with the first byte in the least significant bits
+ */
+uint32_t spi_tx_byte_word(spi_peripheral_t* peri, uint32_t k);
+
+/**
+ * @brief Stores an RX FIFO word in an RX buffer of bytes, without writing
+ *  beyond the buffer.
+ * 
+ * @param peri Pointer to the spi_peripheral_t instance with the relevant data
+ * @param k Index of the word
+ * @param word The word read from the RX FIFO
+ */
+void spi_rx_byte_store(spi_peripheral_t* peri, uint32_t k, uint32_t word);
+
 /**
  * @brief Fills the TX FIFO until no more space or no more data.
  * 
@@ -258,9 +364,59 @@ void spi_launch(spi_peripheral_t* peri, spi_t* spi, spi_transaction_t txn,
                 spi_callbacks_t callbacks);
 
 /**
- * @brief Issues a command segment and increments counter (post inc.).
- *  Determines value of CSAAT bit based on if it is last segment of transaction 
- *  or not.
+ * @brief Launches a DMA channel moving one direction of the transaction, if the
+ *  peripheral has a trigger slot for it, the transfer is long enough and a
+ *  channel is free.
+ * 
+ * @param slot DMA trigger slot of the FIFO, DMA_TRIG_MEMORY if none
+ * @param fifo Address of the TX or RX FIFO
+ * @param buffer TX or RX buffer of the transaction
+ * @param len Number of words to move
+ * @param tx true if the words go from the buffer to the FIFO
+ * @return int8_t The DMA channel moving the words, SPI_DMA_NO_CHANNEL if they
+ *  are left to the CPU
+ */
+int8_t spi_dma_launch(uint8_t slot, uint8_t* fifo, uint8_t* buffer, 
+                      uint32_t len, bool tx);
+
+/**
+ * @brief Releases the DMA channels of the peripheral that have finished. A
+ *  channel still running (transaction aborted by an error or a timeout) is
+ *  kept until a later call finds it finished.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ */
+void spi_dma_release(spi_peripheral_t* peri);
+
+/**
+ * @brief Waits for the DMA channels of a transaction that has finished on the 
+ *  SPI side (the RX channel may still be emptying the RX FIFO) and releases them.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ */
+void spi_dma_finish(spi_peripheral_t* peri);
+
+/**
+ * @brief Launches a transaction and waits until it is over or timed-out. The
+ *  queued transactions are only resumed once the caller has its result.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ * @param spi Pointer to the spi_t that requested transaction
+ * @param txn Transaction data (segments, buffers, lengths)
+ */
+void spi_launch_blocking(spi_peripheral_t* peri, spi_t* spi, spi_transaction_t txn);
+
+/**
+ * @brief Launches the first queued transaction, after setting its slave, if the
+ *  peripheral is not busy. Must be called with the interrupts disabled or from
+ *  the SPI interrupts.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ */
+void spi_queue_next(spi_peripheral_t* peri);
+
+/**
+ * @brief Waits until the current transaction is over or timed-out.
  * 
  * @param peri Pointer to the relevant spi_peripheral_t instance
  */
@@ -275,6 +431,15 @@ void spi_wait_transaction_done(spi_peripheral_t* peri);
  */
 void spi_issue_next_seg(spi_peripheral_t* peri);
 
+/**
+ * @brief Issues command segments while there are some left and the command FIFO
+ *  of the SPI Host can take them, so that it chains them without waiting for
+ *  the CPU.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ */
+void spi_issue_segs(spi_peripheral_t* peri);
+
 /**
  * @brief Resets the entire peripheral, hardware included
  * 
@@ -308,6 +473,24 @@ void spi_event_handler(spi_peripheral_t* peri, spi_event_e events);
  */
 void spi_error_handler(spi_peripheral_t* peri, spi_error_e error);
 
+/**
+ * @brief Keeps the clock of the peripheral domain on for the peripheral until
+ *  spi_clk_drop(), if it is in that domain (clk_gate.h). Called before each
+ *  access to its registers.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ */
+void spi_clk_hold(spi_peripheral_t* peri);
+
+/**
+ * @brief Gives back the clock of spi_clk_hold(), unless a transaction runs.
+ *  A transfer that fails its checks after spi_prepare_transfer() keeps it
+ *  until the next drop.
+ * 
+ * @param peri Pointer to the relevant spi_peripheral_t instance
+ */
+void spi_clk_drop(spi_peripheral_t* peri);
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          EXPORTED VARIABLES                            **/
@@ -325,6 +508,11 @@ void spi_error_handler(spi_peripheral_t* peri, spi_error_e error);
  */
 static uint32_t global_id = 0;
 
+/**
+ * @brief DMA descriptors of the transactions in DMA mode, indexed by channel.
+ */
+static spi_dma_desc_t spi_dma_descs[DMA_CH_NUM];
+
 /**
  * @brief Static variable representing each SPI peripheral (FLASH, HOST, HOST2)
  *  We can have infinitely many spi_t variables but all reference one of these 
@@ -343,7 +531,15 @@ static volatile spi_peripheral_t peripherals[] = {
         .scnt      = 0,
         .txcnt     = 0,
         .rxcnt     = 0,
-        .callbacks = {0}
+        .callbacks = {0},
+        .dma_tx_slot = DMA_TRIG_SLOT_SPI_FLASH_TX,
+        .dma_rx_slot = DMA_TRIG_SLOT_SPI_FLASH_RX,
+        .dma_tx_ch   = SPI_DMA_NO_CHANNEL,
+        .dma_rx_ch   = SPI_DMA_NO_CHANNEL,
+        .queue       = NULL,
+        .blocking    = false,
+        .clk_idx     = CLK_GATE_NO_PERIPH,
+        .clk_held    = false
     },
     (spi_peripheral_t) {
         .instance  = spi_host1,
@@ -356,7 +552,15 @@ static volatile spi_peripheral_t peripherals[] = {
         .scnt      = 0,
         .txcnt     = 0,
         .rxcnt     = 0,
-        .callbacks = {0}
+        .callbacks = {0},
+        .dma_tx_slot = DMA_TRIG_SLOT_SPI_TX,
+        .dma_rx_slot = DMA_TRIG_SLOT_SPI_RX,
+        .dma_tx_ch   = SPI_DMA_NO_CHANNEL,
+        .dma_rx_ch   = SPI_DMA_NO_CHANNEL,
+        .queue       = NULL,
+        .blocking    = false,
+        .clk_idx     = SPI_HOST_IDX,
+        .clk_held    = false
     },
     (spi_peripheral_t) {
         .instance  = spi_host2,
@@ -369,7 +573,15 @@ static volatile spi_peripheral_t peripherals[] = {
         .scnt      = 0,
         .txcnt     = 0,
         .rxcnt     = 0,
-        .callbacks = {0}
+        .callbacks = {0},
+        .dma_tx_slot = DMA_TRIG_MEMORY,
+        .dma_rx_slot = DMA_TRIG_MEMORY,
+        .dma_tx_ch   = SPI_DMA_NO_CHANNEL,
+        .dma_rx_ch   = SPI_DMA_NO_CHANNEL,
+        .queue       = NULL,
+        .blocking    = false,
+        .clk_idx     = SPI2_IDX,
+        .clk_held    = false
     }
 };
 
@@ -393,8 +605,10 @@ spi_t spi_init(spi_idx_e idx, spi_slave_t slave)
             .idx   = UINT32_MAX,
             .id    = 0,
             .init  = false,
-            .slave = (spi_slave_t) {0}
+            .slave = (spi_slave_t) {0},
+            .dma   = false
         };
+    spi_clk_hold(&peripherals[idx]);
     // Enable SPI peripheral. We do not check return value since we know here that
     // it will never return an error.
     spi_set_enable(peripherals[idx].instance, true);
@@ -408,6 +622,7 @@ spi_t spi_init(spi_idx_e idx, spi_slave_t slave)
     spi_set_rx_watermark(peripherals[idx].instance, peripherals[idx].rxwm);
     // Just set a state so user can see it has been initialized somewhen.
     peripherals[idx].state = SPI_STATE_INIT;
+    spi_clk_drop(&peripherals[idx]);
     // Set the true frequency at which the SCK will be for that particular slave
     // so the user can know the real frequency.
     slave.freq = spi_true_slave_freq(slave.freq);
@@ -415,7 +630,8 @@ spi_t spi_init(spi_idx_e idx, spi_slave_t slave)
         .idx   = idx,
         .id    = ++global_id, // Pre-increment because id 0 defined as invalid
         .init  = true,
-        .slave = slave
+        .slave = slave,
+        .dma   = false
     };
 }
 
@@ -426,12 +642,15 @@ void spi_deinit(spi_t* spi)
     spi->id    = 0;
     spi->init  = false;
     spi->slave = (spi_slave_t) {0};
+    spi->dma   = false;
 }
 
 spi_codes_e spi_reset(spi_t* spi) 
 {
     spi_codes_e error = spi_check_valid(spi);
     if (error) return error;
+    // Drop the queued transactions, their callbacks will never be called
+    peripherals[spi->idx].queue = NULL;
     // Reset entire peripheral
     spi_reset_peri(&peripherals[spi->idx]);
 
@@ -445,8 +664,10 @@ spi_codes_e spi_set_txwm(spi_t* spi, uint8_t watermark)
     // Do not change watermark if SPI is busy
     if (SPI_BUSY(peripherals[spi->idx])) return SPI_CODE_IS_BUSY;
     // Set the new value at hardware level
-    if (spi_set_tx_watermark(peripherals[spi->idx].instance, watermark))
-        return SPI_CODE_WM_EXCEEDS;
+    spi_clk_hold(&peripherals[spi->idx]);
+    spi_return_flags_e wm_error = spi_set_tx_watermark(peripherals[spi->idx].instance, watermark);
+    spi_clk_drop(&peripherals[spi->idx]);
+    if (wm_error) return SPI_CODE_WM_EXCEEDS;
     // Store the watermark if previous operation succeeded
     peripherals[spi->idx].txwm = watermark;
 
@@ -470,8 +691,10 @@ spi_codes_e spi_set_rxwm(spi_t* spi, uint8_t watermark)
     // Do not change watermark if SPI is busy
     if (SPI_BUSY(peripherals[spi->idx])) return SPI_CODE_IS_BUSY;
     // Set the new value at hardware level
-    if (spi_set_rx_watermark(peripherals[spi->idx].instance, watermark))
-        return SPI_CODE_WM_EXCEEDS;
+    spi_clk_hold(&peripherals[spi->idx]);
+    spi_return_flags_e wm_error = spi_set_rx_watermark(peripherals[spi->idx].instance, watermark);
+    spi_clk_drop(&peripherals[spi->idx]);
+    if (wm_error) return SPI_CODE_WM_EXCEEDS;
     // Store the watermark if previous operation succeeded
     peripherals[spi->idx].rxwm = watermark;
 
@@ -508,6 +731,79 @@ spi_codes_e spi_get_timeout(spi_t* spi, uint32_t* timeout)
     return SPI_CODE_OK;
 }
 
+spi_codes_e spi_set_dma(spi_t* spi, bool enable)
+{
+    spi_codes_e error = spi_check_valid(spi);
+    if (error) return error;
+    // Without trigger slots the DMA cannot follow the FIFOs
+    if (enable && peripherals[spi->idx].dma_tx_slot == DMA_TRIG_MEMORY)
+        return SPI_CODE_DMA_UNAVAIL;
+
+    spi->dma = enable;
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_tune(spi_t* spi, spi_segment_t seg, spi_tuning_t* tuning)
+{
+    spi_codes_e error = spi_check_valid(spi);
+    if (error) return error;
+    // Do not change watermarks if SPI is busy
+    if (SPI_BUSY(peripherals[spi->idx])) return SPI_CODE_IS_BUSY;
+    if (SPI_INVALID_LEN(seg.len)) return SPI_CODE_TXN_LEN_INVAL;
+    uint8_t direction = bitfield_read(seg.mode, DIR_SPD_MASK, DIR_INDEX);
+    uint8_t speed     = bitfield_read(seg.mode, DIR_SPD_MASK, SPD_INDEX);
+    if (!spi_validate_cmd(direction, speed)) return SPI_CODE_SEGMENT_INVAL;
+
+    // The slave frequency is its maximum, the true one being the highest that
+    // the divider can reach without exceeding it
+    uint16_t clk_div = spi_clk_div(spi->slave.freq);
+    // Core cycles to shift a word: 32 bits over 1, 2 or 4 lines
+    uint32_t word_cycles = (2 * clk_div + 2) * (32 >> speed);
+    // Words shifted while the CPU answers a watermark interrupt
+    uint32_t lag   = (SPI_TUNE_IRQ_CYCLES + word_cycles - 1) / word_cycles;
+    uint32_t words = LEN_WORDS(seg.len);
+
+    // TX: the lowest watermark still refilled before the FIFO runs dry gives
+    // the largest refills. RX: the highest one still emptied before it is full.
+    bool     stall_free = lag + 1 < SPI_HOST_PARAM_RX_DEPTH;
+    uint32_t txwm = stall_free ? lag + 1 : SPI_HOST_PARAM_TX_DEPTH / 2;
+    uint32_t rxwm = stall_free ? SPI_HOST_PARAM_RX_DEPTH - lag - 1 : SPI_HOST_PARAM_RX_DEPTH / 2;
+
+    // One interrupt ends the transaction. The watermark ones are saved by a DMA.
+    bool     dma  = spi->dma && peripherals[spi->idx].dma_tx_slot != DMA_TRIG_MEMORY 
+                    && words >= SPI_DMA_MIN_WORDS && words <= SPI_DMA_MAX_WORDS;
+    uint32_t irqs = 1;
+    if (!dma && (direction == SPI_DIR_TX_ONLY || direction == SPI_DIR_BIDIR) 
+        && words > SPI_HOST_PARAM_TX_DEPTH)
+    {
+        // The FIFO is full at launch, then each interrupt refills what was sent
+        uint32_t refill = SPI_HOST_PARAM_TX_DEPTH - txwm + (stall_free ? lag : 0);
+        irqs += (words - SPI_HOST_PARAM_TX_DEPTH + refill - 1) / refill;
+    }
+    if (!dma && (direction == SPI_DIR_RX_ONLY || direction == SPI_DIR_BIDIR))
+    {
+        // The words left at the end are read by the last interrupt
+        uint32_t drain = stall_free ? rxwm + lag : rxwm;
+        irqs += words / drain;
+    }
+
+    error = spi_set_txwm(spi, txwm);
+    if (error) return error;
+    error = spi_set_rxwm(spi, rxwm);
+    if (error) return error;
+
+    *tuning = (spi_tuning_t) {
+        .freq       = SYS_FREQ / (2 * clk_div + 2),
+        .clk_div    = clk_div,
+        .txwm       = txwm,
+        .rxwm       = rxwm,
+        .interrupts = irqs,
+        .stall_free = stall_free
+    };
+    return SPI_CODE_OK;
+}
+
 spi_codes_e spi_set_slave_freq(spi_t* spi, uint32_t freq)
 {
     spi_codes_e error = spi_check_valid(spi);
@@ -549,10 +845,7 @@ spi_codes_e spi_transmit(spi_t* spi, const uint32_t* src_buffer, uint32_t len)
 
     // Launch the transaction. All data has been verified, launch doesn't check 
     // anything. No callbacks since function is blocking.
-    spi_launch(&peripherals[spi->idx], spi, txn, NULL_CALLBACKS);
-
-    spi_wait_transaction_done(&peripherals[spi->idx]);
-    // while (SPI_BUSY(peripherals[spi->idx])) wait_for_interrupt();
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
 
     return SPI_CODE_OK;
 }
@@ -572,10 +865,7 @@ spi_codes_e spi_receive(spi_t* spi, uint32_t* dest_buffer, uint32_t len)
 
     // Launch the transaction. All data has been verified, launch doesn't check 
     // anything. No callbacks since function is blocking.
-    spi_launch(&peripherals[spi->idx], spi, txn, NULL_CALLBACKS);
-
-    spi_wait_transaction_done(&peripherals[spi->idx]);
-    // while (SPI_BUSY(peripherals[spi->idx])) wait_for_interrupt();
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
 
     return SPI_CODE_OK;
 }
@@ -596,10 +886,7 @@ spi_codes_e spi_transceive(spi_t* spi, const uint32_t* src_buffer,
 
     // Launch the transaction. All data has been verified, launch doesn't check 
     // anything. No callbacks since function is blocking.
-    spi_launch(&peripherals[spi->idx], spi, txn, NULL_CALLBACKS);
-
-    spi_wait_transaction_done(&peripherals[spi->idx]);
-    // while (SPI_BUSY(peripherals[spi->idx])) wait_for_interrupt();
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
 
     return SPI_CODE_OK;
 }
@@ -623,10 +910,7 @@ spi_codes_e spi_execute(spi_t* spi, const spi_segment_t* segments,
 
     // Launch the transaction. All data has been verified, launch doesn't check 
     // anything. No callbacks since function is blocking.
-    spi_launch(&peripherals[spi->idx], spi, txn, NULL_CALLBACKS);
-
-    spi_wait_transaction_done(&peripherals[spi->idx]);
-    // while (SPI_BUSY(peripherals[spi->idx])) wait_for_interrupt();
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
 
     return SPI_CODE_OK;
 }
@@ -719,6 +1003,162 @@ spi_codes_e spi_execute_nb(spi_t* spi, const spi_segment_t* segments,
     return SPI_CODE_OK;
 }
 
+spi_codes_e spi_transmit_bytes(spi_t* spi, const uint8_t* src_buffer, uint32_t len) 
+{
+    // Make validity checks and set the slave at hardware level
+    spi_codes_e error = spi_prepare_transfer(spi);
+    // Check that length doesn't exceed maximum and is not 0
+    if (SPI_INVALID_LEN(len)) error |= SPI_CODE_TXN_LEN_INVAL;
+    if (error) return error;
+
+    spi_transaction_t txn = spi_bytes_txn(&peripherals[spi->idx], SPI_MODE_TX_STD, 
+                                          src_buffer, NULL, len);
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_receive_bytes(spi_t* spi, uint8_t* dest_buffer, uint32_t len) 
+{
+    // Make validity checks and set the slave at hardware level
+    spi_codes_e error = spi_prepare_transfer(spi);
+    // Check that length doesn't exceed maximum and is not 0
+    if (SPI_INVALID_LEN(len)) error |= SPI_CODE_TXN_LEN_INVAL;
+    if (error) return error;
+
+    spi_transaction_t txn = spi_bytes_txn(&peripherals[spi->idx], SPI_MODE_RX_STD, 
+                                          NULL, dest_buffer, len);
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_transceive_bytes(spi_t* spi, const uint8_t* src_buffer, 
+                                 uint8_t* dest_buffer, uint32_t len) 
+{
+    // Make validity checks and set the slave at hardware level
+    spi_codes_e error = spi_prepare_transfer(spi);
+    // Check that length doesn't exceed maximum and is not 0
+    if (SPI_INVALID_LEN(len)) error |= SPI_CODE_TXN_LEN_INVAL;
+    if (error) return error;
+
+    spi_transaction_t txn = spi_bytes_txn(&peripherals[spi->idx], SPI_MODE_BIDIR, 
+                                          src_buffer, dest_buffer, len);
+    spi_launch_blocking(&peripherals[spi->idx], spi, txn);
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_transmit_bytes_nb(spi_t* spi, const uint8_t* src_buffer, uint32_t len, 
+                                  spi_callbacks_t callbacks) 
+{
+    // Make validity checks and set the slave at hardware level
+    spi_codes_e error = spi_prepare_transfer(spi);
+    // Check that length doesn't exceed maximum and is not 0
+    if (SPI_INVALID_LEN(len)) error |= SPI_CODE_TXN_LEN_INVAL;
+    if (error) return error;
+
+    // The segments are kept in the peripheral instance, they outlive this call
+    spi_transaction_t txn = spi_bytes_txn(&peripherals[spi->idx], SPI_MODE_TX_STD, 
+                                          src_buffer, NULL, len);
+    spi_launch(&peripherals[spi->idx], spi, txn, callbacks);
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_receive_bytes_nb(spi_t* spi, uint8_t* dest_buffer, uint32_t len, 
+                                 spi_callbacks_t callbacks) 
+{
+    // Make validity checks and set the slave at hardware level
+    spi_codes_e error = spi_prepare_transfer(spi);
+    // Check that length doesn't exceed maximum and is not 0
+    if (SPI_INVALID_LEN(len)) error |= SPI_CODE_TXN_LEN_INVAL;
+    if (error) return error;
+
+    // The segments are kept in the peripheral instance, they outlive this call
+    spi_transaction_t txn = spi_bytes_txn(&peripherals[spi->idx], SPI_MODE_RX_STD, 
+                                          NULL, dest_buffer, len);
+    spi_launch(&peripherals[spi->idx], spi, txn, callbacks);
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_transceive_bytes_nb(spi_t* spi, const uint8_t* src_buffer, 
+                                    uint8_t* dest_buffer, uint32_t len, 
+                                    spi_callbacks_t callbacks) 
+{
+    // Make validity checks and set the slave at hardware level
+    spi_codes_e error = spi_prepare_transfer(spi);
+    // Check that length doesn't exceed maximum and is not 0
+    if (SPI_INVALID_LEN(len)) error |= SPI_CODE_TXN_LEN_INVAL;
+    if (error) return error;
+
+    // The segments are kept in the peripheral instance, they outlive this call
+    spi_transaction_t txn = spi_bytes_txn(&peripherals[spi->idx], SPI_MODE_BIDIR, 
+                                          src_buffer, dest_buffer, len);
+    spi_launch(&peripherals[spi->idx], spi, txn, callbacks);
+
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_enqueue(spi_queued_txn_t* qtxn) 
+{
+    spi_codes_e error = spi_check_valid(qtxn->spi);
+    if (error) return error;
+    // The slave is set when the transaction leaves the queue, from an interrupt,
+    // where it can no longer be refused.
+    error = spi_validate_slave(qtxn->spi->slave);
+    if (error) return error;
+    // Same for the segments. The words are counted again at launch.
+    uint32_t txlen, rxlen;
+    if (qtxn->seglen > UINT8_MAX 
+        || !spi_validate_segments(qtxn->segments, qtxn->seglen, &txlen, &rxlen)) 
+        return SPI_CODE_SEGMENT_INVAL;
+
+    spi_peripheral_t* peri = &peripherals[qtxn->spi->idx];
+    uint32_t mstatus;
+    SPI_IRQ_SAVE(mstatus);
+
+    // An idle device busy at hardware level would never drain the queue
+    spi_clk_hold(peri);
+    if (SPI_NOT_BUSY((*peri)) && spi_get_active(peri->instance) == SPI_TRISTATE_TRUE)
+    {
+        spi_clk_drop(peri);
+        SPI_IRQ_RESTORE(mstatus);
+        return SPI_CODE_NOT_IDLE;
+    }
+
+    // Insert after the transactions of higher or equal priority, so that
+    // transactions of the same priority are served in order of arrival
+    spi_queued_txn_t** pos = &peri->queue;
+    while (*pos != NULL && (*pos)->priority >= qtxn->priority) pos = &(*pos)->next;
+    qtxn->next = *pos;
+    *pos       = qtxn;
+
+    // If the device is idle start right away, otherwise the end of the current
+    // transaction will launch the next one.
+    if (!peri->blocking) spi_queue_next(peri);
+    spi_clk_drop(peri);
+
+    SPI_IRQ_RESTORE(mstatus);
+    return SPI_CODE_OK;
+}
+
+spi_codes_e spi_get_queue_len(spi_t* spi, uint32_t* len) 
+{
+    spi_codes_e error = spi_check_valid(spi);
+    if (error) return error;
+
+    uint32_t mstatus;
+    SPI_IRQ_SAVE(mstatus);
+    *len = 0;
+    for (spi_queued_txn_t* q = peripherals[spi->idx].queue; q != NULL; q = q->next) 
+        (*len)++;
+    SPI_IRQ_RESTORE(mstatus);
+
+    return SPI_CODE_OK;
+}
+
 /****************************************************************************/
 /**                                                                        **/
 /*                            LOCAL FUNCTIONS                               */
@@ -747,12 +1187,7 @@ spi_codes_e spi_validate_slave(spi_slave_t slave)
 spi_codes_e spi_set_slave(spi_t* spi) 
 {
     // Compute the best clock divider
-    uint16_t clk_div = 0;
-    if (spi->slave.freq < SYS_FREQ / 2)
-    {
-        clk_div = (SYS_FREQ / spi->slave.freq - 2) / 2;
-        if (SYS_FREQ / (2 * clk_div + 2) > spi->slave.freq) clk_div++;
-    }
+    uint16_t clk_div = spi_clk_div(spi->slave.freq);
     // Build the HAL configopts to be set based on our slave
     spi_configopts_t config = {
         .clkdiv   = clk_div,
@@ -787,17 +1222,26 @@ spi_codes_e spi_prepare_transfer(spi_t* spi)
 
     // If busy don't start a new transaction...
     if (SPI_BUSY(peripherals[spi->idx])) return SPI_CODE_IS_BUSY;
+    // The clock is held until the end of the transaction
+    spi_clk_hold(&peripherals[spi->idx]);
     // Check also at hardware level if busy, we don't know if maybe there is a
     // problem somewhere
     if (spi_get_active(peripherals[spi->idx].instance) == SPI_TRISTATE_TRUE) 
+    {
+        spi_clk_drop(&peripherals[spi->idx]);
         return SPI_CODE_NOT_IDLE;
+    }
 
     // If the last spi instance was NOT the same as the current, slave may have
     // changed, therefore set the "new" slave. Otherwise don't bother.
     if (spi->id != peripherals[spi->idx].last_id)
     {
         error = spi_set_slave(spi);
-        if (error) return error;
+        if (error) 
+        {
+            spi_clk_drop(&peripherals[spi->idx]);
+            return error;
+        }
     }
 
     return SPI_CODE_OK;
@@ -806,14 +1250,20 @@ spi_codes_e spi_prepare_transfer(spi_t* spi)
 uint32_t spi_true_slave_freq(uint32_t freq) 
 {
     // Compute the best clock divider
+    uint16_t clk_div = spi_clk_div(freq);
+    // Based on the computed divider return the true frequency the SCK will be at
+    return SYS_FREQ / (2 * clk_div + 2);
+}
+
+uint16_t spi_clk_div(uint32_t freq) 
+{
     uint16_t clk_div = 0;
     if (freq < SYS_FREQ / 2) 
     {
         clk_div = (SYS_FREQ / freq - 2) / 2;
         if (SYS_FREQ / (2 * clk_div + 2) > freq) clk_div++;
     }
-    // Based on the computed divider return the true frequency the SCK will be at
-    return SYS_FREQ / (2 * clk_div + 2);
+    return clk_div;
 }
 
 bool spi_validate_segments(const spi_segment_t* segments, uint32_t segments_len, 
@@ -850,6 +1300,75 @@ bool spi_validate_segments(const spi_segment_t* segments, uint32_t segments_len,
     return true;
 }
 
+spi_transaction_t spi_bytes_txn(spi_peripheral_t* peri, spi_mode_e mode, 
+                                const uint8_t* src, uint8_t* dst, uint32_t len) 
+{
+    uintptr_t addr = dst != NULL ? (uintptr_t) dst : (uintptr_t) src;
+    uint32_t  head = (BYTES_PER_WORD - addr % BYTES_PER_WORD) % BYTES_PER_WORD;
+    // Nothing to align if all the bytes fit before the boundary
+    if (head >= len) head = 0;
+
+    uint8_t seglen = 0;
+    if (head) peri->byte_segs[seglen++] = (spi_segment_t) {.len = head, .mode = mode};
+    peri->byte_segs[seglen++] = (spi_segment_t) {.len = len - head, .mode = mode};
+    // Each segment starts with a new FIFO word
+    uint32_t words = LEN_WORDS((len - head)) + (head ? 1 : 0);
+
+    return (spi_transaction_t) {
+        .segments = peri->byte_segs,
+        .seglen   = seglen,
+        .txbuffer = (const uint32_t*) src,
+        .txlen    = src != NULL ? words : 0,
+        .rxbuffer = (uint32_t*) dst,
+        .rxlen    = dst != NULL ? words : 0,
+        .bytes    = true,
+        .headlen  = head,
+        .bytelen  = len
+    };
+}
+
+uint32_t spi_byte_word_offset(const spi_transaction_t* txn, uint32_t k, uint32_t* n) 
+{
+    uint32_t offset;
+    if (txn->headlen == 0) offset = k * BYTES_PER_WORD;
+    else if (k == 0)
+    {
+        *n = txn->headlen;
+        return 0;
+    }
+    else offset = txn->headlen + (k - 1) * BYTES_PER_WORD;
+    *n = txn->bytelen - offset < BYTES_PER_WORD ? txn->bytelen - offset : BYTES_PER_WORD;
+    return offset;
+}
+
+uint32_t spi_tx_byte_word(spi_peripheral_t* peri, uint32_t k) 
+{
+    uint32_t n;
+    uintptr_t addr  = (uintptr_t) peri->txn.txbuffer 
+                      + spi_byte_word_offset(&peri->txn, k, &n);
+    uint32_t  shift = (addr % BYTES_PER_WORD) * 8;
+    const uint32_t* word = (const uint32_t*) (addr - addr % BYTES_PER_WORD);
+    // Aligned words are read as a whole, the bytes beyond the buffer are dropped
+    // by the segment length. Unaligned ones are built from the words they span.
+    if (shift == 0) return word[0];
+    uint32_t wdata = word[0] >> shift;
+    if (n > BYTES_PER_WORD - shift / 8) wdata |= word[1] << (32 - shift);
+    return wdata;
+}
+
+void spi_rx_byte_store(spi_peripheral_t* peri, uint32_t k, uint32_t word) 
+{
+    uint32_t n;
+    uint8_t* dst = (uint8_t*) peri->txn.rxbuffer + spi_byte_word_offset(&peri->txn, k, &n);
+    // Full aligned words are written at once, the others byte by byte
+    if (n == BYTES_PER_WORD && (uintptr_t) dst % BYTES_PER_WORD == 0) 
+    {
+        *(uint32_t*) dst = word;
+        return;
+    }
+    for (uint32_t i = 0; i < n; i++) dst[i] = (uint8_t) (word >> (8 * i));
+}
+
 bool spi_fill_tx(spi_peripheral_t* peri) 
 {
     // If we have a TX buffer and didn't exceed the count then fill the TX FIFO
@@ -857,6 +1376,14 @@ bool spi_fill_tx(spi_peripheral_t* peri)
         // While there is still data to be fed and there wasn't an error from HAL
         // continue. HAL error in this case means that the fifo is full since
         // it's the only possibility.
+        if (peri->txn.bytes)
+        {
+            while (
+                peri->txcnt < peri->txn.txlen 
+                && !spi_write_word(peri->instance, spi_tx_byte_word(peri, peri->txcnt))
+            ) peri->txcnt++; // Keep track of counter
+            return true;
+        }
         while (
             peri->txcnt < peri->txn.txlen 
             && !spi_write_word(peri->instance, peri->txn.txbuffer[peri->txcnt])
@@ -873,6 +1400,15 @@ bool spi_empty_rx(spi_peripheral_t* peri)
         // While there is still data to be read and there wasn't an error from HAL
         // continue. HAL error in this case means that the fifo is empty since
         // it's the only possibility.
+        if (peri->txn.bytes)
+        {
+            uint32_t word;
+            while (
+                peri->rxcnt < peri->txn.rxlen 
+                && !spi_read_word(peri->instance, &word)
+            ) spi_rx_byte_store(peri, peri->rxcnt++, word);
+            return true;
+        }
         while (
             peri->rxcnt < peri->txn.rxlen 
             && !spi_read_word(peri->instance, &peri->txn.rxbuffer[peri->rxcnt])
@@ -888,55 +1424,234 @@ void spi_launch(spi_peripheral_t* peri, spi_t* spi, spi_transaction_t txn,
     // All checks have been made, therefore there can't be any error here.
     // This also means that we can safely set the state since we know we will
     // proceed to launch without any doubt.
+    spi_clk_hold(peri);
     peri->state     = SPI_STATE_BUSY;
     // Set all transaction data to our static peripheral variable
     peri->txn       = txn;
     // Indicate the callbacks that should be called
     peri->callbacks = callbacks;
 
+    uint32_t events = TRIGGERING_EVENTS;
+    if (spi->dma)
+    {
+        // Take back the channels of a previous transaction that was aborted
+        spi_dma_release(peri);
+        if (peri->dma_tx_ch == SPI_DMA_NO_CHANNEL && peri->dma_rx_ch == SPI_DMA_NO_CHANNEL)
+        {
+            // The DMA moves the words of a direction as soon as the FIFO can
+            // take or give them, the counters mark them as already handled so
+            // the CPU leaves that direction alone.
+            // With byte buffers the DMA only takes the aligned words: the TX head
+            // word is pushed before by the CPU (the tail word is read aligned,
+            // its extra bytes are dropped by the segment length), and RX is only
+            // moved without head, the partial tail word being read at the end.
+            uint32_t       tx_head = txn.bytes && txn.headlen ? 1 : 0;
+            const uint8_t* tx_body = (const uint8_t*) txn.txbuffer + (tx_head ? txn.headlen : 0);
+            if (txn.txbuffer != NULL && (uintptr_t) tx_body % BYTES_PER_WORD == 0) 
+            {
+                // The FIFO is empty, the head word is always accepted
+                if (tx_head) 
+                {
+                    spi_write_word(peri->instance, spi_tx_byte_word(peri, 0));
+                    peri->txcnt = 1;
+                }
+                peri->dma_tx_ch = spi_dma_launch(peri->dma_tx_slot, 
+                    (uint8_t*) peri->instance + SPI_HOST_TXDATA_REG_OFFSET, 
+                    (uint8_t*) tx_body, txn.txlen - tx_head, true);
+                if (peri->dma_tx_ch != SPI_DMA_NO_CHANNEL)
+                {
+                    peri->txcnt = txn.txlen;
+                    events &= ~SPI_EVENT_TXWM;
+                }
+            }
+            uint32_t rx_words = txn.bytes ? txn.bytelen / BYTES_PER_WORD : txn.rxlen;
+            if (!(txn.bytes && txn.headlen) && (uintptr_t) txn.rxbuffer % BYTES_PER_WORD == 0) 
+            {
+                peri->dma_rx_ch = spi_dma_launch(peri->dma_rx_slot, 
+                    (uint8_t*) peri->instance + SPI_HOST_RXDATA_REG_OFFSET, 
+                    (uint8_t*) txn.rxbuffer, rx_words, false);
+                if (peri->dma_rx_ch != SPI_DMA_NO_CHANNEL)
+                {
+                    peri->rxcnt = rx_words;
+                    events &= ~SPI_EVENT_RXWM;
+                }
+            }
+        }
+    }
+
     // Fill the TX fifo before starting so there is data once command launched
     spi_fill_tx(peri);
 
     // Enable event interrupts since they are enabled only during a transaction
-    spi_set_events_enabled(peri->instance, TRIGGERING_EVENTS, true);
+    spi_set_events_enabled(peri->instance, events, true);
     spi_enable_evt_intr   (peri->instance, true);
 
     // Wait for the SPI peripheral to be ready before writing a command segment.
+    spi_wait_for_cmdqd_not_full(peri->instance);
     spi_wait_for_ready(peri->instance);
-    // Write command segment. This immediately triggers the SPI peripheral into action.
-    spi_issue_next_seg(peri);
+    // Write command segments. This immediately triggers the SPI peripheral into action.
+    spi_issue_segs(peri);
+}
+
+int8_t spi_dma_launch(uint8_t slot, uint8_t* fifo, uint8_t* buffer, 
+                      uint32_t len, bool tx)
+{
+    // Short transfers fit in the FIFOs and are faster through the CPU
+    if (slot == DMA_TRIG_MEMORY || buffer == NULL || len < SPI_DMA_MIN_WORDS 
+        || len > SPI_DMA_MAX_WORDS) return SPI_DMA_NO_CHANNEL;
+
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0) return SPI_DMA_NO_CHANNEL;
+
+    spi_dma_desc_t* desc = &spi_dma_descs[channel];
+    desc->mem = (dma_target_t) {
+        .ptr     = buffer,
+        .inc_du  = 1,
+        .size_du = len,
+        .trig    = DMA_TRIG_MEMORY,
+        .type    = DMA_DATA_TYPE_WORD
+    };
+    // The FIFO is a single register, the slot paces the DMA on its fill level
+    desc->fifo = (dma_target_t) {
+        .ptr     = fifo,
+        .inc_du  = 0,
+        .size_du = len,
+        .trig    = slot,
+        .type    = DMA_DATA_TYPE_WORD
+    };
+    desc->trans = (dma_trans_t) {
+        .src      = tx ? &desc->mem : &desc->fifo,
+        .dst      = tx ? &desc->fifo : &desc->mem,
+        .src_addr = NULL,
+        .mode     = DMA_TRANS_MODE_SINGLE,
+        .dim      = DMA_DIM_CONF_1D,
+        .win_du   = 0,
+        .end      = DMA_TRANS_END_POLLING,
+        .channel  = (uint8_t) channel,
+        .flags    = DMA_CONFIG_OK
+    };
+
+    // The buffers are word arrays, only the critical checks are kept
+    if ((dma_validate_transaction(&desc->trans, DMA_DO_NOT_ENABLE_REALIGN, 
+                                  DMA_PERFORM_CHECKS_ONLY_CRITICAL) & DMA_CONFIG_CRITICAL_ERROR)
+        || dma_load_transaction(&desc->trans) != DMA_CONFIG_OK
+        || dma_launch(&desc->trans) != DMA_CONFIG_OK)
+    {
+        dma_sdk_handle_invalidate((uint8_t) channel);
+        dma_sdk_channel_free((uint8_t) channel);
+        return SPI_DMA_NO_CHANNEL;
+    }
+    return (int8_t) channel;
+}
+
+void spi_dma_release(spi_peripheral_t* peri) 
+{
+    if (peri->dma_tx_ch != SPI_DMA_NO_CHANNEL && dma_is_ready(peri->dma_tx_ch))
+    {
+        // The registers no longer hold the image of an SDK handle
+        dma_sdk_handle_invalidate(peri->dma_tx_ch);
+        dma_sdk_channel_free(peri->dma_tx_ch);
+        peri->dma_tx_ch = SPI_DMA_NO_CHANNEL;
+    }
+    if (peri->dma_rx_ch != SPI_DMA_NO_CHANNEL && dma_is_ready(peri->dma_rx_ch))
+    {
+        dma_sdk_handle_invalidate(peri->dma_rx_ch);
+        dma_sdk_channel_free(peri->dma_rx_ch);
+        peri->dma_rx_ch = SPI_DMA_NO_CHANNEL;
+    }
+}
+
+void spi_dma_finish(spi_peripheral_t* peri) 
+{
+    // The SPI is idle, so all the TX words were taken and all the RX words are
+    // at most a FIFO away from the buffer: the wait is short.
+    if (peri->dma_tx_ch != SPI_DMA_NO_CHANNEL)
+        while (!dma_is_ready(peri->dma_tx_ch));
+    if (peri->dma_rx_ch != SPI_DMA_NO_CHANNEL)
+        while (!dma_is_ready(peri->dma_rx_ch));
+    spi_dma_release(peri);
+}
+
+void spi_launch_blocking(spi_peripheral_t* peri, spi_t* spi, spi_transaction_t txn) 
+{
+    // Keep the interrupts from launching a queued transaction meanwhile
+    peri->blocking = true;
+    spi_launch(peri, spi, txn, NULL_CALLBACKS);
+    spi_wait_transaction_done(peri);
+
+    uint32_t mstatus;
+    SPI_IRQ_SAVE(mstatus);
+    peri->blocking = false;
+    spi_queue_next(peri);
+    spi_clk_drop(peri);
+    SPI_IRQ_RESTORE(mstatus);
+}
+
+void spi_queue_next(spi_peripheral_t* peri) 
+{
+    // A callback may have launched a transaction by itself
+    if (SPI_BUSY((*peri)) || peri->queue == NULL) return;
+
+    spi_queued_txn_t* qtxn = peri->queue;
+    peri->queue = qtxn->next;
+    qtxn->next  = NULL;
+
+    // Each slave has its own configopts and chip select
+    spi_clk_hold(peri);
+    spi_set_slave(qtxn->spi);
+
+    spi_transaction_t txn = SPI_TXN(qtxn->segments, qtxn->seglen, 
+                                    qtxn->src_buffer, qtxn->dest_buffer);
+    spi_validate_segments(txn.segments, txn.seglen, &txn.txlen, &txn.rxlen);
+    spi_launch(peri, qtxn->spi, txn, qtxn->callbacks);
+}
+
+// Condition of spi_wait_transaction_done: the end of the transaction or the
+// timeout
+static bool spi_wait_over(void* arg)
+{
+    spi_wait_t* wait = (spi_wait_t*) arg;
+    uint32_t now[2];
+
+    if (SPI_NOT_BUSY((*wait->peri))) return true;
+    // Read tick counter value
+    CSR_READ(CSR_REG_MCYCLE,  &now[0]);
+    CSR_READ(CSR_REG_MCYCLEH, &now[1]);
+    return *((uint64_t*)now) - wait->start > wait->timeout_ticks;
 }
 
 void spi_wait_transaction_done(spi_peripheral_t* peri) 
 {
     // Convert ms timeout to clock ticks
-    uint64_t timeout_ticks = ((uint64_t) peri->timeout) * (SYS_FREQ / 1000);
+    spi_wait_t wait = {
+        .peri          = peri,
+        .timeout_ticks = ((uint64_t) peri->timeout) * (SYS_FREQ / 1000)
+    };
     uint32_t start[2];
-    uint32_t end[2];
 
     // Enable tick counter
     CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
     // Record start tick counter value
     CSR_READ(CSR_REG_MCYCLE,  &start[0]);
     CSR_READ(CSR_REG_MCYCLEH, &start[1]);
-
-    // Wait until transaction has finished or timed-out
-    do
+    wait.start = *((uint64_t*)start);
+
+    // Wait until transaction has finished or timed-out. The events and errors
+    // of the transaction wake the core up.
+#if SPI_WAIT_SLEEP
+    sync_wait(spi_wait_over, &wait);
+#else
+    while (!spi_wait_over(&wait));
+#endif
+
+    // If ticks elapsed exceed timeout ticks, cancel transaction
+    if (SPI_BUSY((*peri)))
     {
-        // Read tick counter value
-        CSR_READ(CSR_REG_MCYCLE,  &end[0]);
-        CSR_READ(CSR_REG_MCYCLEH, &end[1]);
-        // If ticks elapsed exceed timeout ticks, cancel transaction and return
-        if (*((uint64_t*)end) - *((uint64_t*)start) > timeout_ticks)
-        {
-            // Fully reset spi peripheral to cancel transaction, empty fifos, etc.
-            spi_reset_peri(peri);
-            // Indicate to user the transaction has timed-out
-            peri->state = SPI_STATE_TIMEOUT;
-            break;
-        }
-        
-    } while (SPI_BUSY((*peri)));
+        // Fully reset spi peripheral to cancel transaction, empty fifos, etc.
+        spi_reset_peri(peri);
+        // Indicate to user the transaction has timed-out
+        peri->state = SPI_STATE_TIMEOUT;
+    }
 }
 
 void spi_issue_next_seg(spi_peripheral_t* peri) 
@@ -954,10 +1669,22 @@ void spi_issue_next_seg(spi_peripheral_t* peri)
     spi_set_command(peri->instance, cmd_reg);
 }
 
+void spi_issue_segs(spi_peripheral_t* peri) 
+{
+    // The first segment is issued anyway, the caller knows the SPI is ready
+    do spi_issue_next_seg(peri);
+    while (
+        peri->scnt < peri->txn.seglen 
+        && spi_get_status(peri->instance)->cmdqd < SPI_HOST_PARAM_CMD_DEPTH
+        && spi_get_ready(peri->instance) == SPI_TRISTATE_TRUE
+    );
+}
+
 void spi_reset_peri(spi_peripheral_t* peri) 
 {
     // Reset static peripheral variables
     spi_reset_transaction(peri);
+    spi_clk_hold(peri);
     // Reset the SPI peripheral (at hardware level)
     spi_sw_reset(peri->instance);
     // Enable SPI peripheral. We do not check return value since we know here that
@@ -975,6 +1702,7 @@ void spi_reset_peri(spi_peripheral_t* peri)
     peri->state = SPI_STATE_INIT;
     // Force the next transaction to set the slave at hardware level
     peri->last_id = 0;
+    spi_clk_drop(peri);
 }
 
 void spi_reset_transaction(spi_peripheral_t* peri) 
@@ -986,6 +1714,8 @@ void spi_reset_transaction(spi_peripheral_t* peri)
     peri->rxcnt     = 0;
     peri->txn       = (spi_transaction_t) {0};
     peri->callbacks = NULL_CALLBACKS;
+    // Release the DMA channels of an aborted transaction if they have finished
+    spi_dma_release(peri);
 }
 
 void spi_event_handler(spi_peripheral_t* peri, spi_event_e events) 
@@ -996,10 +1726,10 @@ void spi_event_handler(spi_peripheral_t* peri, spi_event_e events)
     //  2) It is ready and idle
     if (events & SPI_EVENT_READY) 
     {
-        // If SPI is ready and there are still commands to execute, issue next command
+        // If SPI is ready and there are still commands to execute, issue next commands
         if (peri->txn.segments != NULL && peri->scnt < peri->txn.seglen) 
         {
-            spi_issue_next_seg(peri);
+            spi_issue_segs(peri);
         }
         // If no more commands and SPI is idle, it means the transaction is over
         else if (events & SPI_EVENT_IDLE) 
@@ -1007,6 +1737,8 @@ void spi_event_handler(spi_peripheral_t* peri, spi_event_e events)
             // Disable all event interrupts
             spi_set_events_enabled(peri->instance, SPI_EVENT_ALL, false);
             spi_enable_evt_intr   (peri->instance, false);
+            // Let the DMA move its last words, if it was used
+            spi_dma_finish(peri);
             // Read the last data from the RX fifo
             spi_empty_rx(peri);
             // Set the state to Transaction is done (meaning successful)
@@ -1019,6 +1751,12 @@ void spi_event_handler(spi_peripheral_t* peri, spi_event_e events)
             }
             // Reset all transaction related variables
             spi_reset_transaction(peri);
+            // Complete the future bound to the peripheral, if any
+            async_notify(ASYNC_SOURCE_SPI(peri - peripherals), 0);
+            // Go on with the queue, unless a blocking function waits for this result
+            if (!peri->blocking) spi_queue_next(peri);
+            // The clock stops with the last transaction
+            spi_clk_drop(peri);
             return;
         }
     }
@@ -1058,6 +1796,39 @@ void spi_error_handler(spi_peripheral_t* peri, spi_error_e error)
     spi_reset_peri(peri);
     // Set the state to error
     peri->state = SPI_STATE_ERROR;
+    // Complete the future bound to the peripheral, if any, with the errors
+    async_notify(ASYNC_SOURCE_SPI(peri - peripherals), error);
+    // Go on with the queue, unless a blocking function waits for this result
+    if (!peri->blocking) spi_queue_next(peri);
+    spi_clk_drop(peri);
+}
+
+void spi_clk_hold(spi_peripheral_t* peri) 
+{
+#ifdef CLK_GATE
+    uint32_t mstatus;
+    SPI_IRQ_SAVE(mstatus);
+    if (!peri->clk_held) 
+    {
+        peri->clk_held = true;
+        clk_gate_periph_acquire(peri->clk_idx);
+    }
+    SPI_IRQ_RESTORE(mstatus);
+#endif
+}
+
+void spi_clk_drop(spi_peripheral_t* peri) 
+{
+#ifdef CLK_GATE
+    uint32_t mstatus;
+    SPI_IRQ_SAVE(mstatus);
+    if (peri->clk_held && SPI_NOT_BUSY((*peri))) 
+    {
+        peri->clk_held = false;
+        clk_gate_periph_release(peri->clk_idx);
+    }
+    SPI_IRQ_RESTORE(mstatus);
+#endif
 }
 
 /****************************************************************************/
@@ -48,6 +48,24 @@
 #define SPI_CSN_TIMES_DEFAULT 15
 // Default timeout for blocking transactions in milliseconds
 #define SPI_TIMEOUT_DEFAULT   100
+// Minimum number of words of a direction (TX or RX) of a transaction for the DMA
+// to move them in DMA mode. Shorter transfers fit in the FIFOs and are faster
+// through the CPU.
+#ifndef SPI_DMA_MIN_WORDS
+#define SPI_DMA_MIN_WORDS     64
+#endif
+// Core cycles assumed by spi_tune between a watermark event and the first FIFO
+// access of the interrupt handler
+#ifndef SPI_TUNE_IRQ_CYCLES
+#define SPI_TUNE_IRQ_CYCLES   200
+#endif
+// 1 for the blocking transactions to sleep until their end or error interrupt,
+// 0 to poll. The timeout counts the cycles of the core, which stop while it
+// sleeps on the CPUs that clock-gate their counters: it then only covers the
+// time the core is awake, the interrupts of the transaction ending the sleep.
+#ifndef SPI_WAIT_SLEEP
+#define SPI_WAIT_SLEEP        1
+#endif
 
 /**
  * @brief Macro to create a Slave SPI device with standard parameters.
@@ -70,6 +88,22 @@
     .mode = SPI_MODE_DUMMY \
 }
 
+/**
+ * @brief Macro to instantiate a Dual Speed Dummy Segment (IO0 and IO1 released)
+ */
+#define SPI_SEG_DUMMY_DUAL(cycles) (spi_segment_t) { \
+    .len  = cycles, \
+    .mode = SPI_MODE_DUMMY_DUAL \
+}
+
+/**
+ * @brief Macro to instantiate a Quad Speed Dummy Segment (IO0 to IO3 released)
+ */
+#define SPI_SEG_DUMMY_QUAD(cycles) (spi_segment_t) { \
+    .len  = cycles, \
+    .mode = SPI_MODE_DUMMY_QUAD \
+}
+
 /**
  * @brief Macro to instantiate a TX Segment
  */
@@ -158,7 +192,8 @@ typedef enum {
     SPI_CODE_SEGMENT_INVAL      = 0x0100, // The spi_mode_e of the segment was invalid
     SPI_CODE_IS_BUSY            = 0x0200, // The SPI device is busy
     SPI_CODE_TXN_LEN_INVAL      = 0x0400, // The transaction length is 0 or too long
-    SPI_CODE_TIMEOUT_INVAL      = 0x0800  // The specified timeout is invalid
+    SPI_CODE_TIMEOUT_INVAL      = 0x0800, // The specified timeout is invalid
+    SPI_CODE_DMA_UNAVAIL        = 0x1000  // The SPI device has no DMA trigger slot
 } spi_codes_e;
 
 typedef enum {
@@ -173,11 +208,11 @@ typedef enum {
     SPI_MODE_RX_STD  = 1,   // Standard receive command segment
     SPI_MODE_TX_STD  = 2,   // Standard transmit command segment
     SPI_MODE_BIDIR   = 3,   // Standard bidirectional command segment
-    // 4 is same than DUMMY
+    SPI_MODE_DUMMY_DUAL = 4, // Dummy SCK command segment of a dual speed command
     SPI_MODE_RX_DUAL = 5,   // Dual speed receive command segment
     SPI_MODE_TX_DUAL = 6,   // Dual speed transmit command segment
     // 7 is invalid
-    // 8 is same than DUMMY
+    SPI_MODE_DUMMY_QUAD = 8, // Dummy SCK command segment of a quad speed command
     SPI_MODE_RX_QUAD = 9,   // Quad speed receive command segment
     SPI_MODE_TX_QUAD = 10   // Quad speed transmit command segment
     // everything > 10 is invalid
@@ -255,8 +290,39 @@ typedef struct {
     uint32_t    id;    // spi_t instance ID
     bool        init;  // Indicates if initialization was successful
     spi_slave_t slave; // The slave with whom to communicate configuration 
+    bool        dma;   // Indicates if long transfers are moved by the DMA
 } spi_t;
 
+/**
+ * @brief Settings chosen by spi_tune for a transfer.
+ */
+typedef struct {
+    uint32_t freq;       // True SCK frequency in hertz
+    uint16_t clk_div;    // SPI clk divider giving this frequency
+    uint8_t  txwm;       // TX watermark set on the SPI device
+    uint8_t  rxwm;       // RX watermark set on the SPI device
+    uint32_t interrupts; // Expected number of event interrupts of the transfer
+    bool     stall_free; // false if the interrupts cannot keep up with the SCK, 
+                         // the SPI device then pauses until the FIFO is served
+} spi_tuning_t;
+
+/**
+ * @brief A transaction waiting in the queue of an SPI device. The structure is
+ *        provided by the user and must stay untouched, as well as the spi_t, the
+ *        segments and the buffers it points to, until its done or error 
+ *        callback has been called.
+ */
+typedef struct spi_queued_txn_s {
+    spi_t*                   spi;         // Slave to communicate with, set at launch
+    const spi_segment_t*     segments;    // An array of command segments
+    uint32_t                 seglen;      // The size of segments array (at most 255)
+    const uint32_t*          src_buffer;  // Data to send (NULL if no TX segment)
+    uint32_t*                dest_buffer; // Buffer for the received data (NULL if no RX)
+    spi_callbacks_t          callbacks;   // Callbacks of the transaction
+    uint8_t                  priority;    // Higher first, in order of arrival if equal
+    struct spi_queued_txn_s* next;        // Private, used by the queue
+} spi_queued_txn_t;
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          EXPORTED VARIABLES                            **/
@@ -292,7 +358,7 @@ void spi_deinit(spi_t* spi);
 
 /**
  * @brief Completely reset the SPI device (clears all status, stops all transactions,
- *        empties FIFOs)
+ *        empties FIFOs and the queue of transactions)
  * 
  * @param spi Pointer to spi_t structure obtained through spi_init call
  * @return SPI_CODE_IDX_INVAL if spi.idx not valid
@@ -375,6 +441,52 @@ spi_codes_e spi_set_timeout(spi_t* spi, uint32_t timeout);
  */
 spi_codes_e spi_get_timeout(spi_t* spi, uint32_t* timeout);
 
+/**
+ * @brief Enable or disable the DMA mode. In DMA mode, each direction of a 
+ *        transaction with at least SPI_DMA_MIN_WORDS words is moved between the
+ *        buffer and the FIFO by a DMA channel, triggered by the FIFO of the SPI
+ *        device, instead of by the CPU from the watermark interrupts.
+ *        Shorter transfers, and all of them when no DMA channel is free, keep 
+ *        using the CPU. Only SPI_IDX_FLASH and SPI_IDX_HOST have DMA trigger slots.
+ *        /!\ The DMA cannot be aborted: if a transaction in DMA mode ends with
+ *            an error or a timeout, its channel is only released once the DMA
+ *            has moved all its words.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param enable true to move long transfers with the DMA, false to use the CPU
+ * @return SPI_CODE_IDX_INVAL   if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT    if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_DMA_UNAVAIL if DMA mode is enabled on a device without DMA slots
+ * @return SPI_CODE_OK          if success
+ */
+spi_codes_e spi_set_dma(spi_t* spi, bool enable);
+
+/**
+ * @brief Choose and set the watermarks of the SPI device minimizing the event
+ *        interrupts of a transfer without making the SPI device wait for the 
+ *        FIFOs, and report them with the SCK frequency and the expected number
+ *        of interrupts.
+ *        The SCK runs at the highest frequency reachable with the clk divider
+ *        without exceeding the frequency of the slave (spi->slave.freq). Given
+ *        the core cycles per transferred word and SPI_TUNE_IRQ_CYCLES, the TX
+ *        watermark is the lowest and the RX watermark the highest that the 
+ *        interrupt handler can still serve in time. Transfers moved by the DMA
+ *        (see spi_set_dma) only count the interrupt ending the transaction.
+ *        /!\ The watermarks are those of the SPI device, they apply to all
+ *            the spi_t using it.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param seg The typical command segment of the transfers (length and mode)
+ * @param tuning The chosen settings will be stored in this variable
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_IS_BUSY       if the SPI device is busy
+ * @return SPI_CODE_TXN_LEN_INVAL if the length of the segment is 0 or too long
+ * @return SPI_CODE_SEGMENT_INVAL if the mode of the segment is invalid
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_tune(spi_t* spi, spi_segment_t seg, spi_tuning_t* tuning);
+
 /**
  * @brief Change the communication frequency of the slave
  *        /!\ If the frequency is higher than the maximum frequency it will just
@@ -449,6 +561,9 @@ spi_codes_e spi_transceive(spi_t* spi, const uint32_t* src_buffer,
 
 /**
  * @brief Executes a transacton composed of multiple command segments.
+ *        The segments are queued ahead in the command FIFO of the SPI Host, so
+ *        that multi-phase commands (e.g. cmd + addr + dummy + data) run 
+ *        back to back with the chip select kept asserted.
  *        Each segment already contains the Information about the length and the 
  *        src/dest buffer concerned. Therefore no need for length parameter here.
  *        /!\ Caution: please be consistent with the length of src_buffer/dest_buffer
@@ -556,6 +671,139 @@ spi_codes_e spi_execute_nb(spi_t* spi, const spi_segment_t* segments,
                            uint32_t segments_len, const uint32_t* src_buffer, 
                            uint32_t* dest_buffer, spi_callbacks_t callbacks);
 
+/**
+ * @brief Executes a TX command from a buffer of bytes of any alignment and 
+ *        length. If the buffer is not word-aligned, the bytes up to the first
+ *        word boundary are sent in a first segment (chip select kept asserted), 
+ *        so that the rest goes at full word rate or through the DMA.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param src_buffer The bytes to send
+ * @param len The number of bytes to send
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_TXN_LEN_INVAL if len is 0 or too long
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_transmit_bytes(spi_t* spi, const uint8_t* src_buffer, uint32_t len);
+
+/**
+ * @brief Executes an RX command into a buffer of bytes of any alignment and 
+ *        length. Nothing is written beyond the len bytes of the buffer. If the
+ *        buffer is not word-aligned, the bytes up to the first word boundary
+ *        are received in a first segment (chip select kept asserted), so that 
+ *        the rest goes at full word rate (or through the DMA if aligned).
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param dest_buffer The buffer to store the received bytes
+ * @param len The number of bytes to receive
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_TXN_LEN_INVAL if len is 0 or too long
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_receive_bytes(spi_t* spi, uint8_t* dest_buffer, uint32_t len);
+
+/**
+ * @brief Executes a Bidirectional (TX and RX) command with buffers of bytes of
+ *        any alignment. The segments are split on the alignment of dest_buffer.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param src_buffer The bytes to send
+ * @param dest_buffer The buffer to store the received bytes
+ * @param len The number of bytes to send and receive
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_TXN_LEN_INVAL if len is 0 or too long
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_transceive_bytes(spi_t* spi, const uint8_t* src_buffer, 
+                                 uint8_t* dest_buffer, uint32_t len);
+
+/**
+ * @brief Non-Blocking variant of spi_transmit_bytes.
+ *        The txlen of the callbacks counts FIFO words, not bytes.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param src_buffer The bytes to send
+ * @param len The number of bytes to send
+ * @param callbacks The callbacks of the transaction
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_TXN_LEN_INVAL if len is 0 or too long
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_transmit_bytes_nb(spi_t* spi, const uint8_t* src_buffer, uint32_t len, 
+                                  spi_callbacks_t callbacks);
+
+/**
+ * @brief Non-Blocking variant of spi_receive_bytes.
+ *        The rxlen of the callbacks counts FIFO words, not bytes.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param dest_buffer The buffer to store the received bytes
+ * @param len The number of bytes to receive
+ * @param callbacks The callbacks of the transaction
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_TXN_LEN_INVAL if len is 0 or too long
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_receive_bytes_nb(spi_t* spi, uint8_t* dest_buffer, uint32_t len, 
+                                 spi_callbacks_t callbacks);
+
+/**
+ * @brief Non-Blocking variant of spi_transceive_bytes.
+ *        The txlen and rxlen of the callbacks count FIFO words, not bytes.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param src_buffer The bytes to send
+ * @param dest_buffer The buffer to store the received bytes
+ * @param len The number of bytes to send and receive
+ * @param callbacks The callbacks of the transaction
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_TXN_LEN_INVAL if len is 0 or too long
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_transceive_bytes_nb(spi_t* spi, const uint8_t* src_buffer, 
+                                    uint8_t* dest_buffer, uint32_t len, 
+                                    spi_callbacks_t callbacks);
+
+/**
+ * @brief Queues a transaction on the SPI device of its spi_t. This is 
+ *        Non-Blocking: if the device is idle the transaction is launched 
+ *        immediately, otherwise it waits in the queue of the device, sorted by
+ *        priority, and is launched from the interrupt that ends the previous 
+ *        transaction, after setting its own slave (configopts and chip select).
+ *        The queue thus drains without the CPU, and transactions to several 
+ *        slaves on the same device can be queued at once.
+ *        A running transaction is never interrupted, and a blocking transaction
+ *        can still be executed when the device is idle (it returns 
+ *        SPI_CODE_IS_BUSY while the queue drains).
+ * 
+ * @param qtxn The transaction to queue, it must not be queued already
+ * @return SPI_CODE_IDX_INVAL     if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT      if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_SLAVE_*       if the slave of the spi_t is not valid
+ * @return SPI_CODE_SEGMENT_INVAL if segments contains an invalid segment
+ * @return SPI_CODE_NOT_IDLE      if the SPI device is busy (but not from SDK)
+ * @return SPI_CODE_OK            if success
+ */
+spi_codes_e spi_enqueue(spi_queued_txn_t* qtxn);
+
+/**
+ * @brief Get the number of transactions waiting in the queue of the SPI device,
+ *        the running one excluded.
+ * 
+ * @param spi Pointer to spi_t structure obtained through spi_init call
+ * @param len The number of queued transactions will be stored in this variable
+ * @return SPI_CODE_IDX_INVAL if spi.idx not valid
+ * @return SPI_CODE_NOT_INIT  if spi.init false (indicates if spi was initialized)
+ * @return SPI_CODE_OK        if success
+ */
+spi_codes_e spi_get_queue_len(spi_t* spi, uint32_t* len);
+
 /****************************************************************************/
 /**                                                                        **/
 /**                          INLINE FUNCTIONS                              **/
@@ -0,0 +1,59 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: spi_slave_host.c
+// Description: Memory accesses through the SPI slave of hw/ip_examples/obi_spi_slave,
+//              from an SPI host of X-HEEP
+
+#include <stddef.h>
+
+#include "spi_slave_host.h"
+#include "bitfield.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+static void spi_slave_host_swap(uint32_t *words, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        words[i] = bitfield_byteswap32(words[i]);
+    }
+}
+
+spi_codes_e spi_slave_host_init(spi_t *spi)
+{
+    uint32_t cmd = SPI_SLAVE_CMD_WRITE_REG1 | (SPI_SLAVE_DUMMY_CYCLES - 1) << 8;
+    return spi_transmit(spi, &cmd, 2);
+}
+
+spi_codes_e spi_slave_host_write(spi_t *spi, uint32_t addr, uint32_t *buffer, uint32_t len)
+{
+    // The command and the address in their own words, the segments start on a word
+    spi_segment_t segments[3] = {SPI_SEG_TX(1), SPI_SEG_TX(4), SPI_SEG_TX(4 * len)};
+    buffer[0] = SPI_SLAVE_CMD_WRITE_MEM;
+    buffer[1] = bitfield_byteswap32(addr);
+
+    uint32_t *data = buffer + SPI_SLAVE_HOST_HEADER_WORDS;
+    spi_slave_host_swap(data, len);
+    spi_codes_e error = spi_execute(spi, segments, 3, buffer, NULL);
+    spi_slave_host_swap(data, len);
+    return error;
+}
+
+spi_codes_e spi_slave_host_read(spi_t *spi, uint32_t addr, uint32_t *dest, uint32_t len)
+{
+    spi_segment_t segments[4] = {SPI_SEG_TX(1), SPI_SEG_TX(4),
+                                 SPI_SEG_DUMMY(SPI_SLAVE_DUMMY_CYCLES), SPI_SEG_RX(4 * len)};
+    uint32_t header[SPI_SLAVE_HOST_HEADER_WORDS] = {SPI_SLAVE_CMD_READ_MEM,
+                                                    bitfield_byteswap32(addr)};
+
+    spi_codes_e error = spi_execute(spi, segments, 4, header, dest);
+    if (error == SPI_CODE_OK)
+    {
+        spi_slave_host_swap(dest, len);
+    }
+    return error;
+}
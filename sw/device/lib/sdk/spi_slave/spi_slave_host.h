@@ -0,0 +1,94 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: spi_slave_host.h
+// Description: Memory accesses through the SPI slave of hw/ip_examples/obi_spi_slave,
+//              from an SPI host of X-HEEP
+
+#ifndef SPI_SLAVE_HOST_H_
+#define SPI_SLAVE_HOST_H_
+
+#include <stdint.h>
+
+#include "spi_sdk.h"
+
+/**
+ * The SPI slave takes an 8-bit command, then a 32-bit address and the words,
+ * each MSB first. The SPI host sends the bytes of a word of its FIFO from
+ * the least significant one, so the address and the words are byte-swapped
+ * on the way. The commands are segments of one spi_execute(), with the chip
+ * select kept asserted: long transfers are moved by the DMA of the SPI SDK
+ * (spi_set_dma()).
+ *
+ * In the testharness the slave is on the chip select 1 of the SPI host, so
+ * that X-HEEP plays the external host of its own memory map.
+ */
+
+/********************************/
+/* ---- EXPORTED DEFINES ---- */
+/********************************/
+
+// Commands of the SPI slave
+#define SPI_SLAVE_CMD_WRITE_REG0 0x01
+#define SPI_SLAVE_CMD_WRITE_MEM  0x02
+#define SPI_SLAVE_CMD_READ_REG0  0x05
+#define SPI_SLAVE_CMD_READ_REG1  0x07
+#define SPI_SLAVE_CMD_READ_MEM   0x0B
+#define SPI_SLAVE_CMD_WRITE_REG1 0x11
+
+/**
+ * @brief Dummy cycles between the address and the data of a read, set by
+ * spi_slave_host_init(). REG1 holds them minus 1, and they are a whole
+ * number of bytes for the hosts that only clock bytes.
+ */
+#define SPI_SLAVE_DUMMY_CYCLES 32
+
+/**
+ * @brief Words in front of the data of spi_slave_host_write(), for the
+ * command and the address.
+ */
+#define SPI_SLAVE_HOST_HEADER_WORDS 2
+
+/**
+ * @brief Highest SCK frequency of the slave, a fraction of the system clock
+ * for its clock domain crossings.
+ */
+#define SPI_SLAVE_MAX_FREQ(clk_freq_hz) ((clk_freq_hz) / 2)
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Set the dummy cycles of the reads of the slave.
+ *
+ * @param spi SPI of the slave, from spi_init() with a slave in mode 0
+ * @return SPI_CODE_OK, or an error of spi_execute()
+ */
+spi_codes_e spi_slave_host_init(spi_t *spi);
+
+/**
+ * @brief Write words to the memory map behind the slave.
+ *
+ * @param spi SPI of the slave
+ * @param addr Word-aligned address
+ * @param buffer SPI_SLAVE_HOST_HEADER_WORDS free words then the len words to
+ * write; the words are byte-swapped and back around the transfer
+ * @param len Number of words
+ * @return SPI_CODE_OK, or an error of spi_execute()
+ */
+spi_codes_e spi_slave_host_write(spi_t *spi, uint32_t addr, uint32_t *buffer, uint32_t len);
+
+/**
+ * @brief Read words from the memory map behind the slave.
+ *
+ * @param spi SPI of the slave
+ * @param addr Word-aligned address
+ * @param dest Buffer of the len words read
+ * @param len Number of words
+ * @return SPI_CODE_OK, or an error of spi_execute()
+ */
+spi_codes_e spi_slave_host_read(spi_t *spi, uint32_t addr, uint32_t *dest, uint32_t len);
+
+#endif /* SPI_SLAVE_HOST_H_ */
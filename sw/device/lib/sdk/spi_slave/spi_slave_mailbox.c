@@ -0,0 +1,60 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: spi_slave_mailbox.c
+// Description: Mailbox in RAM that an external host polls through the SPI slave
+
+#include <stddef.h>
+
+#include "spi_slave_mailbox.h"
+
+/**********************************/
+/* ---- VARIABLE DEFINITIONS ---- */
+/**********************************/
+
+volatile spi_slave_mailbox_t spi_slave_mailbox __attribute__((aligned(4)));
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+void spi_slave_mailbox_init(void)
+{
+    spi_slave_mailbox.ack = spi_slave_mailbox.doorbell;
+    spi_slave_mailbox.status = 0;
+    for (int i = 0; i < SPI_SLAVE_MAILBOX_RETS; i++)
+    {
+        spi_slave_mailbox.ret[i] = 0;
+    }
+    spi_slave_mailbox.magic = SPI_SLAVE_MAILBOX_MAGIC;
+}
+
+bool spi_slave_mailbox_pending(uint32_t *cmd, uint32_t *arg)
+{
+    if (spi_slave_mailbox.doorbell == spi_slave_mailbox.ack)
+    {
+        return false;
+    }
+    *cmd = spi_slave_mailbox.cmd;
+    if (arg != NULL)
+    {
+        for (int i = 0; i < SPI_SLAVE_MAILBOX_ARGS; i++)
+        {
+            arg[i] = spi_slave_mailbox.arg[i];
+        }
+    }
+    return true;
+}
+
+void spi_slave_mailbox_reply(uint32_t status, const uint32_t *ret)
+{
+    spi_slave_mailbox.status = status;
+    for (int i = 0; i < SPI_SLAVE_MAILBOX_RETS; i++)
+    {
+        spi_slave_mailbox.ret[i] = ret != NULL ? ret[i] : 0;
+    }
+    // The answer before the ack, which the host reads first
+    __asm__ volatile("fence w, w" ::: "memory");
+    spi_slave_mailbox.ack = spi_slave_mailbox.doorbell;
+}
@@ -0,0 +1,89 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: spi_slave_mailbox.h
+// Description: Mailbox in RAM that an external host polls through the SPI slave
+
+#ifndef SPI_SLAVE_MAILBOX_H_
+#define SPI_SLAVE_MAILBOX_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The external host reaches the memory map through the SPI slave of the
+ * testharness (hw/ip_examples/obi_spi_slave), one word at a time in
+ * increasing addresses. The mailbox is the global spi_slave_mailbox, which
+ * the host finds in the ELF of the application (util/spi_slave_host.py).
+ *
+ * A request of the host is one write of cmd, arg and doorbell, so that the
+ * doorbell, the last word, lands after the rest: it is ack + 1. The device
+ * answers with status and ret, then copies the doorbell into ack. The host
+ * polls with one read of ack, status and ret, where ack is read first: when
+ * it is the doorbell, the rest is the answer.
+ */
+
+/********************************/
+/* ---- EXPORTED DEFINES ---- */
+/********************************/
+
+/**
+ * @brief Set in magic by spi_slave_mailbox_init(), "XHMB".
+ */
+#define SPI_SLAVE_MAILBOX_MAGIC 0x424d4858
+
+#define SPI_SLAVE_MAILBOX_ARGS 4
+#define SPI_SLAVE_MAILBOX_RETS 2
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+typedef struct
+{
+    // Written by the device
+    uint32_t magic;
+    uint32_t ack;                          // doorbell of the last request served
+    uint32_t status;
+    uint32_t ret[SPI_SLAVE_MAILBOX_RETS];
+    // Written by the host
+    uint32_t cmd;
+    uint32_t arg[SPI_SLAVE_MAILBOX_ARGS];
+    uint32_t doorbell;
+} spi_slave_mailbox_t;
+
+/********************************/
+/* ---- EXPORTED VARIABLES ---- */
+/********************************/
+
+extern volatile spi_slave_mailbox_t spi_slave_mailbox;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Clear the mailbox and set its magic, after which the host can send
+ * requests.
+ */
+void spi_slave_mailbox_init(void);
+
+/**
+ * @brief Get the request of the host, if one is pending.
+ *
+ * @param cmd Set to the command
+ * @param arg Set to the SPI_SLAVE_MAILBOX_ARGS arguments, or NULL
+ * @return true if a request is pending, until spi_slave_mailbox_reply()
+ */
+bool spi_slave_mailbox_pending(uint32_t *cmd, uint32_t *arg);
+
+/**
+ * @brief Answer the pending request.
+ *
+ * @param status Status of the request
+ * @param ret SPI_SLAVE_MAILBOX_RETS results, or NULL
+ */
+void spi_slave_mailbox_reply(uint32_t status, const uint32_t *ret);
+
+#endif /* SPI_SLAVE_MAILBOX_H_ */
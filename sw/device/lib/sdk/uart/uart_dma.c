@@ -0,0 +1,207 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: uart_dma.c
+// Description: UART transfers through the DMA, with an idle timeout on reception
+
+#include "uart_dma.h"
+#include "uart.h"
+#include "uart_regs.h"
+#include "dma.h"
+#include "dma_sdk.h"
+#include "hart.h"
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+static inline uint32_t uart_dma_cycles(void)
+{
+    uint32_t c;
+    CSR_READ(CSR_REG_MCYCLE, &c);
+    return c;
+}
+
+// Cycles of a number of bit times, UINT32_MAX if longer
+static uint32_t uart_dma_bit_cycles(const uart_t *uart, uint32_t bits)
+{
+    uint64_t cycles = (uint64_t)bits * uart->clk_freq_hz / uart->baudrate;
+    return cycles > UINT32_MAX ? UINT32_MAX : (uint32_t)cycles;
+}
+
+// Validate, load and launch a transaction, the end is polled or waited for by the caller
+static int uart_dma_launch(dma_trans_t *trans)
+{
+    dma_validate_transaction(trans, DMA_DO_NOT_ENABLE_REALIGN, DMA_PERFORM_CHECKS_INTEGRITY);
+    if (trans->flags & DMA_CONFIG_CRITICAL_ERROR)
+    {
+        return -1;
+    }
+    if (dma_load_transaction(trans) != DMA_CONFIG_OK || dma_launch(trans) != DMA_CONFIG_OK)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int uart_dma_write(const uart_t *uart, const uint8_t *data, uint32_t len)
+{
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+    dma_sdk_handle_invalidate(channel);
+
+    dma_target_t tgt_src = {
+        .ptr = (uint8_t *)data,
+        .inc_du = 1,
+        .size_du = len,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_BYTE,
+    };
+    dma_target_t tgt_dst = {
+        .ptr = (uint8_t *)(uart->base_addr.base + UART_WDATA_REG_OFFSET),
+        .inc_du = 0,
+        .trig = DMA_TRIG_SLOT_UART_TX,
+        .type = DMA_DATA_TYPE_BYTE,
+    };
+    dma_trans_t trans = {
+        .src = &tgt_src,
+        .dst = &tgt_dst,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .win_du = 0,
+        .end = DMA_TRANS_END_INTR,
+        .channel = (uint8_t)channel,
+    };
+
+    // Nothing else may write into the FIFO meanwhile
+    uart_tx_flush(uart);
+
+    if (uart_dma_launch(&trans) != 0)
+    {
+        dma_sdk_channel_free(channel);
+        return -1;
+    }
+
+    while (!dma_is_ready(channel))
+    {
+        // disable_interrupts
+        // this does not prevent waking up the core as this is controlled by the MIP register
+        CSR_CLEAR_BITS(CSR_REG_MSTATUS, 0x8);
+        if (dma_is_ready(channel) == 0)
+        {
+            wait_for_interrupt();
+            // from here we wake up even if we did not jump to the ISR
+        }
+        CSR_SET_BITS(CSR_REG_MSTATUS, 0x8);
+    }
+    dma_sdk_channel_free(channel);
+
+    return 0;
+}
+
+int uart_dma_read(const uart_t *uart, uint8_t *data, uint32_t len, uint32_t first_bits,
+                  uint32_t idle_bits, uint32_t *received)
+{
+    int channel = dma_sdk_channel_alloc();
+    if (channel < 0)
+    {
+        return -1;
+    }
+    dma_sdk_handle_invalidate(channel);
+
+    // The timeouts are measured on mcycle
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, 0x1);
+    uint32_t first_cycles = uart_dma_bit_cycles(uart, first_bits);
+    uint32_t idle_cycles = uart_dma_bit_cycles(uart, idle_bits);
+
+    dma_target_t tgt_src = {
+        .ptr = (uint8_t *)(uart->base_addr.base + UART_RDATA_REG_OFFSET),
+        .inc_du = 0,
+        .trig = DMA_TRIG_SLOT_UART_RX,
+        .type = DMA_DATA_TYPE_BYTE,
+    };
+    dma_target_t tgt_dst = {
+        .inc_du = 1,
+        .trig = DMA_TRIG_MEMORY,
+        .type = DMA_DATA_TYPE_BYTE,
+    };
+    // Each byte is a window, counted by the channel without interrupt
+    dma_trans_t trans = {
+        .src = &tgt_src,
+        .dst = &tgt_dst,
+        .src_addr = NULL,
+        .mode = DMA_TRANS_MODE_SINGLE,
+        .win_du = 1,
+        .end = DMA_TRANS_END_POLLING,
+        .channel = (uint8_t)channel,
+    };
+
+    uint32_t got = 0;
+    int ret = 0;
+    uint32_t last = uart_dma_cycles();
+
+    while (got < len && ret == 0)
+    {
+        uint32_t chunk = len - got < UART_DMA_RX_CHUNK ? len - got : UART_DMA_RX_CHUNK;
+        tgt_src.size_du = chunk;
+        tgt_dst.ptr = data + got;
+        if (uart_dma_launch(&trans) != 0)
+        {
+            ret = -1;
+            break;
+        }
+
+        uint32_t count = 0;
+        while (!dma_is_ready(channel))
+        {
+            uint32_t now = uart_dma_cycles();
+            uint32_t n = dma_get_window_count(channel);
+            if (n != count)
+            {
+                count = n;
+                last = now;
+                continue;
+            }
+
+            uint32_t limit = got + count == 0 ? first_cycles : idle_cycles;
+            if (limit != 0 && now - last >= limit)
+            {
+                // The rest of the chunk reads the empty FIFO, after the count
+                count = dma_get_window_count(channel);
+                dma_ch_peri(channel)->SLOT = DMA_TRIG_MEMORY;
+                while (!dma_is_ready(channel))
+                    ;
+                ret = UART_DMA_TIMEOUT;
+                break;
+            }
+        }
+        if (ret == UART_DMA_TIMEOUT)
+        {
+            got += count;
+        }
+        else
+        {
+            // The last byte of the chunk was not seen by the loop
+            got += chunk;
+            last = uart_dma_cycles();
+        }
+    }
+    dma_sdk_channel_free(channel);
+
+    if (received != NULL)
+    {
+        *received = got;
+    }
+    return ret;
+}
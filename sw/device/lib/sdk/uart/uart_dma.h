@@ -0,0 +1,70 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: uart_dma.h
+// Description: UART transfers through the DMA, with an idle timeout on reception
+
+#ifndef UART_DMA_H_
+#define UART_DMA_H_
+
+#include <stdint.h>
+
+#include "uart.h"
+
+/********************************/
+/* ---- EXPORTED DEFINES ---- */
+/********************************/
+
+/**
+ * @brief Return of uart_dma_read() when it stopped on a timeout before
+ * receiving all the bytes.
+ */
+#define UART_DMA_TIMEOUT 1
+
+/**
+ * @brief Largest bytes of a chunk of reception: the received bytes are
+ * counted by the window counter of the DMA, which has 8 bits.
+ */
+#define UART_DMA_RX_CHUNK 255
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Send a buffer through the DMA, paced by the TX FIFO of the UART
+ * (DMA_TRIG_SLOT_UART_TX). Sleeps until the DMA has written the last byte
+ * into the FIFO: call uart_tx_flush() to wait until it is on the line.
+ *
+ * @param uart UART, initialized with uart_init() and not in buffered TX mode
+ * @param data Bytes to send
+ * @param len Number of bytes
+ * @return int 0 if success, -1 if no DMA channel is free or the transaction is not valid
+ */
+int uart_dma_write(const uart_t *uart, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Receive bytes through the DMA, paced by the RX FIFO of the UART
+ * (DMA_TRIG_SLOT_UART_RX). The DMA copies chunks of at most
+ * UART_DMA_RX_CHUNK bytes, whose progress the CPU follows with the window
+ * counter of the channel, so as to stop the reception once the line has been
+ * idle for a number of bit times. The CPU polls meanwhile.
+ *
+ * On a timeout, the DMA is let through the rest of its chunk without waiting
+ * for the FIFO, which it reads while empty into the buffer after the received
+ * bytes: a byte arriving at that moment is lost.
+ *
+ * @param uart UART, initialized with uart_init()
+ * @param data Buffer of the bytes
+ * @param len Number of bytes expected
+ * @param first_bits Bit times to wait for the first byte, 0 for no limit
+ * @param idle_bits Bit times without a byte after which the reception stops, 0 for no limit
+ * @param received Set to the number of bytes received, or NULL
+ * @return int 0 if the len bytes were received, UART_DMA_TIMEOUT if it stopped on a
+ * timeout, -1 if no DMA channel is free or the transaction is not valid
+ */
+int uart_dma_read(const uart_t *uart, uint8_t *data, uint32_t len, uint32_t first_bits,
+                  uint32_t idle_bits, uint32_t *received);
+
+#endif /* UART_DMA_H_ */
@@ -0,0 +1,262 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: uart_frame.c
+// Description: Framed binary transfers of bulk data over the UART, through the DMA
+
+#include "uart_frame.h"
+#include "uart_dma.h"
+#include "crc.h"
+#include "clk_gate.h"
+#include "core_v_mini_mcu.h"
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+// CRC-32 of the header after the sync bytes, then of the payload
+static uint32_t uart_frame_crc(const uint8_t *header, const uint8_t *payload, uint16_t len)
+{
+    uint32_t crc = crc_compute_sw(&crc_crc32, header + 2, UART_FRAME_HEADER_SIZE - 2,
+                                  crc_crc32.init ^ crc_crc32.xor_out);
+    if (len == 0)
+    {
+        return crc;
+    }
+#ifdef CRC_IS_INCLUDED
+    clk_gate_periph_acquire(CRC_IDX);
+    crc_resume(&crc_crc32, crc);
+    crc_update(payload, len);
+    crc = crc_result(&crc_crc32);
+    clk_gate_periph_release(CRC_IDX);
+#else
+    crc = crc_compute_sw(&crc_crc32, payload, len, crc);
+#endif
+    return crc;
+}
+
+static void uart_frame_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static uint32_t uart_frame_get32(const uint8_t *p)
+{
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Drop the bytes received until the line is idle, the rest of a bad frame
+static uart_frame_error_t uart_frame_drain(const uart_t *uart)
+{
+    uint8_t scratch[16];
+    int r;
+    do
+    {
+        r = uart_dma_read(uart, scratch, sizeof(scratch), UART_FRAME_IDLE_BITS,
+                          UART_FRAME_IDLE_BITS, NULL);
+    } while (r == 0);
+    return r < 0 ? UART_FRAME_ERR_DMA : UART_FRAME_OK;
+}
+
+uart_frame_error_t uart_frame_send(const uart_t *uart, uart_frame_type_t type, uint8_t seq,
+                                   const uint8_t *payload, uint16_t len)
+{
+    // The CRC follows the header at once when there is no payload
+    uint8_t header[UART_FRAME_HEADER_SIZE + UART_FRAME_CRC_SIZE] = {
+        UART_FRAME_SYNC0, UART_FRAME_SYNC1, type, seq, len & 0xFF, len >> 8};
+    uint8_t *trailer = header + UART_FRAME_HEADER_SIZE;
+    uart_frame_put32(trailer, uart_frame_crc(header, payload, len));
+
+    if (len == 0)
+    {
+        return uart_dma_write(uart, header, sizeof(header)) == 0 ? UART_FRAME_OK
+                                                                 : UART_FRAME_ERR_DMA;
+    }
+    if (uart_dma_write(uart, header, UART_FRAME_HEADER_SIZE) != 0 ||
+        uart_dma_write(uart, payload, len) != 0 ||
+        uart_dma_write(uart, trailer, UART_FRAME_CRC_SIZE) != 0)
+    {
+        return UART_FRAME_ERR_DMA;
+    }
+    return UART_FRAME_OK;
+}
+
+uart_frame_error_t uart_frame_recv(const uart_t *uart, uart_frame_type_t *type, uint8_t *seq,
+                                   uint8_t *payload, uint16_t size, uint16_t *len,
+                                   uint32_t timeout_bits)
+{
+    uint8_t header[UART_FRAME_HEADER_SIZE];
+    uint8_t trailer[UART_FRAME_CRC_SIZE];
+    uint32_t n;
+
+    int r = uart_dma_read(uart, header, sizeof(header), timeout_bits, UART_FRAME_IDLE_BITS, &n);
+    if (r < 0)
+    {
+        return UART_FRAME_ERR_DMA;
+    }
+    if (r == UART_DMA_TIMEOUT)
+    {
+        return n == 0 ? UART_FRAME_ERR_TIMEOUT : UART_FRAME_ERR_CRC;
+    }
+    if (header[0] != UART_FRAME_SYNC0 || header[1] != UART_FRAME_SYNC1)
+    {
+        return uart_frame_drain(uart) == UART_FRAME_OK ? UART_FRAME_ERR_CRC : UART_FRAME_ERR_DMA;
+    }
+
+    uint16_t l = header[4] | header[5] << 8;
+    if (l > size)
+    {
+        return uart_frame_drain(uart) == UART_FRAME_OK ? UART_FRAME_ERR_SIZE : UART_FRAME_ERR_DMA;
+    }
+
+    // The rest of the frame follows the header without a pause
+    if (l > 0)
+    {
+        r = uart_dma_read(uart, payload, l, UART_FRAME_IDLE_BITS, UART_FRAME_IDLE_BITS, NULL);
+    }
+    if (r == 0)
+    {
+        r = uart_dma_read(uart, trailer, sizeof(trailer), UART_FRAME_IDLE_BITS,
+                          UART_FRAME_IDLE_BITS, NULL);
+    }
+    if (r < 0)
+    {
+        return UART_FRAME_ERR_DMA;
+    }
+    if (r == UART_DMA_TIMEOUT || uart_frame_get32(trailer) != uart_frame_crc(header, payload, l))
+    {
+        return UART_FRAME_ERR_CRC;
+    }
+
+    *type = header[2];
+    *seq = header[3];
+    *len = l;
+    return UART_FRAME_OK;
+}
+
+// Send a frame until its ACK comes back
+static uart_frame_error_t uart_frame_send_acked(const uart_t *uart, uart_frame_type_t type,
+                                                uint8_t seq, const uint8_t *payload,
+                                                uint16_t len)
+{
+    for (int tries = 0; tries < UART_FRAME_RETRIES; tries++)
+    {
+        uart_frame_error_t r = uart_frame_send(uart, type, seq, payload, len);
+        if (r != UART_FRAME_OK)
+        {
+            return r;
+        }
+
+        uart_frame_type_t reply;
+        uint8_t reply_seq;
+        uint16_t reply_len;
+        r = uart_frame_recv(uart, &reply, &reply_seq, NULL, 0, &reply_len,
+                            UART_FRAME_TIMEOUT_BITS);
+        if (r == UART_FRAME_ERR_DMA)
+        {
+            return r;
+        }
+        if (r == UART_FRAME_OK && reply == UART_FRAME_ACK && reply_seq == seq)
+        {
+            return UART_FRAME_OK;
+        }
+        // A NAK, a timeout or a bad reply: the frame is sent again
+    }
+    return UART_FRAME_ERR_TIMEOUT;
+}
+
+uart_frame_error_t uart_frame_upload(const uart_t *uart, const uint8_t *data, uint32_t len)
+{
+    uint32_t offset = 0;
+    uint8_t seq = 0;
+
+    while (offset < len)
+    {
+        uint32_t n = len - offset;
+        if (n > UART_FRAME_MAX_PAYLOAD)
+        {
+            n = UART_FRAME_MAX_PAYLOAD;
+        }
+        uart_frame_error_t r = uart_frame_send_acked(uart, UART_FRAME_DATA, seq, data + offset, n);
+        if (r != UART_FRAME_OK)
+        {
+            return r;
+        }
+        offset += n;
+        seq++;
+    }
+    return uart_frame_send_acked(uart, UART_FRAME_END, seq, NULL, 0);
+}
+
+uart_frame_error_t uart_frame_download(const uart_t *uart, uint8_t *buffer, uint32_t size,
+                                       uint32_t *received)
+{
+    uint32_t got = 0;
+    uint8_t expected = 0;
+    uart_frame_error_t r = UART_FRAME_ERR_TIMEOUT;
+
+    for (int tries = 0; tries < UART_FRAME_RETRIES;)
+    {
+        uint32_t room = size - got;
+        if (room > UINT16_MAX)
+        {
+            room = UINT16_MAX;
+        }
+
+        uart_frame_type_t type;
+        uint8_t seq;
+        uint16_t n;
+        r = uart_frame_recv(uart, &type, &seq, buffer + got, room, &n, UART_FRAME_TIMEOUT_BITS);
+        if (r == UART_FRAME_ERR_DMA)
+        {
+            break;
+        }
+        if (r != UART_FRAME_OK)
+        {
+            uart_frame_send(uart, UART_FRAME_NAK, expected, NULL, 0);
+            if (r == UART_FRAME_ERR_SIZE)
+            {
+                break;
+            }
+            tries++;
+            continue;
+        }
+        tries = 0;
+
+        if (type == UART_FRAME_DATA && seq == expected)
+        {
+            got += n;
+            expected++;
+            r = uart_frame_send(uart, UART_FRAME_ACK, seq, NULL, 0);
+        }
+        else if ((type == UART_FRAME_DATA && seq == (uint8_t)(expected - 1)) ||
+                 (type == UART_FRAME_END && seq == expected))
+        {
+            // The ACK of a frame already received was lost, or the end
+            r = uart_frame_send(uart, UART_FRAME_ACK, seq, NULL, 0);
+            if (type == UART_FRAME_END)
+            {
+                break;
+            }
+        }
+        else
+        {
+            r = uart_frame_send(uart, UART_FRAME_NAK, expected, NULL, 0);
+        }
+        if (r != UART_FRAME_OK)
+        {
+            break;
+        }
+        r = UART_FRAME_ERR_TIMEOUT;
+    }
+
+    if (received != NULL)
+    {
+        *received = got;
+    }
+    return r;
+}
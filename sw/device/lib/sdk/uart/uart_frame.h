@@ -0,0 +1,145 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: uart_frame.h
+// Description: Framed binary transfers of bulk data over the UART, through the DMA
+
+#ifndef UART_FRAME_H_
+#define UART_FRAME_H_
+
+#include <stdint.h>
+
+#include "uart.h"
+
+/**
+ * A frame is:
+ *
+ *   0xA5 0x5A | type | seq | length (16 bits) | payload | CRC-32 (32 bits)
+ *
+ * with the multi-byte fields little endian, and the CRC-32 of zlib computed
+ * on type, seq, length and the payload. The sender of the data sends DATA
+ * frames of consecutive seq (modulo 256) and waits for the ACK of each, then
+ * an END frame, also acknowledged. The receiver answers a frame with a bad
+ * CRC or a timeout with a NAK of the seq it expects, upon which the sender
+ * sends that frame again, and a frame it already has with its ACK again.
+ * util/uart_frame.py is the peer on the host.
+ *
+ * The frames are sent and received by uart_dma_write() and uart_dma_read(),
+ * so that the UART can run at the highest baudrate of uart_init(),
+ * UART_MAX_BAUDRATE(clk_freq_hz), with the CPU only polling the reception.
+ */
+
+/********************************/
+/* ---- EXPORTED DEFINES ---- */
+/********************************/
+
+#define UART_FRAME_SYNC0 0xA5
+#define UART_FRAME_SYNC1 0x5A
+
+/**
+ * @brief Bytes of the header and of the CRC around the payload.
+ */
+#define UART_FRAME_HEADER_SIZE 6
+#define UART_FRAME_CRC_SIZE 4
+
+/**
+ * @brief Largest payload the device sends, a multiple of 4 so that the CRC
+ * of a payload in a word-aligned buffer is fed by words.
+ */
+#define UART_FRAME_MAX_PAYLOAD 1024
+
+/**
+ * @brief Tries of a frame without an ACK, and of a frame expected, before
+ * the transfer is given up.
+ */
+#define UART_FRAME_RETRIES 8
+
+/**
+ * @brief Bit times to wait for a frame, and of silence that ends a frame
+ * early: about 100 ms at 1 Mbaud, and 4 characters.
+ */
+#define UART_FRAME_TIMEOUT_BITS 100000
+#define UART_FRAME_IDLE_BITS 40
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+typedef enum
+{
+    UART_FRAME_DATA = 1,
+    UART_FRAME_ACK = 2,
+    UART_FRAME_NAK = 3,
+    UART_FRAME_END = 4,
+} uart_frame_type_t;
+
+typedef enum
+{
+    UART_FRAME_OK = 0,
+    UART_FRAME_ERR_TIMEOUT = -1,  // No frame, or no ACK after the retries
+    UART_FRAME_ERR_CRC = -2,      // A frame with a bad sync or CRC
+    UART_FRAME_ERR_SIZE = -3,     // A payload larger than the buffer
+    UART_FRAME_ERR_DMA = -4,      // No DMA channel, or a transaction not valid
+} uart_frame_error_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Send one frame.
+ *
+ * @param uart UART, initialized with uart_init() and not in buffered TX mode
+ * @param type Type of the frame
+ * @param seq Sequence number
+ * @param payload Payload, NULL if len is 0
+ * @param len Bytes of the payload
+ * @return UART_FRAME_OK, or UART_FRAME_ERR_DMA
+ */
+uart_frame_error_t uart_frame_send(const uart_t *uart, uart_frame_type_t type, uint8_t seq,
+                                   const uint8_t *payload, uint16_t len);
+
+/**
+ * @brief Receive one frame. After a bad frame, the bytes received until the
+ * line is idle are dropped.
+ *
+ * @param uart UART, initialized with uart_init()
+ * @param type Set to the type of the frame
+ * @param seq Set to its sequence number
+ * @param payload Buffer of the payload
+ * @param size Bytes of the buffer
+ * @param len Set to the bytes of the payload
+ * @param timeout_bits Bit times to wait for the frame, 0 for no limit
+ * @return UART_FRAME_OK, or an error of uart_frame_error_t
+ */
+uart_frame_error_t uart_frame_recv(const uart_t *uart, uart_frame_type_t *type, uint8_t *seq,
+                                   uint8_t *payload, uint16_t size, uint16_t *len,
+                                   uint32_t timeout_bits);
+
+/**
+ * @brief Send a buffer to the host, in DATA frames of UART_FRAME_MAX_PAYLOAD
+ * bytes each acknowledged, then an END frame.
+ *
+ * @param uart UART, initialized with uart_init() and not in buffered TX mode
+ * @param data Bytes to send
+ * @param len Number of bytes
+ * @return UART_FRAME_OK, or an error of uart_frame_error_t
+ */
+uart_frame_error_t uart_frame_upload(const uart_t *uart, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Receive a buffer from the host, the DATA frames until an END frame.
+ * The payloads are received in place, one after the other.
+ *
+ * @param uart UART, initialized with uart_init() and not in buffered TX mode
+ * @param buffer Buffer of the bytes
+ * @param size Bytes of the buffer
+ * @param received Set to the number of bytes received, or NULL
+ * @return UART_FRAME_OK, or an error of uart_frame_error_t (UART_FRAME_ERR_SIZE
+ * if the data does not fit, after a NAK to the host)
+ */
+uart_frame_error_t uart_frame_download(const uart_t *uart, uint8_t *buffer, uint32_t size,
+                                       uint32_t *received);
+
+#endif /* UART_FRAME_H_ */
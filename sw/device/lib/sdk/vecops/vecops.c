@@ -0,0 +1,246 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: vecops.c
+// Description: int32 vector operations (add, mul, MAC, dot, scale, compare)
+//              on buffers placed across the RAM banks, and DMA gathers of
+//              strided operands
+
+#include "vecops.h"
+
+#include "core_v_mini_mcu.h"
+#include "dma_sdk.h"
+#include "ram_bank.h"
+
+/**********************************/
+/* ---- PRIVATE VARIABLES ---- */
+/**********************************/
+
+static const uint32_t vec_bank_start[MEMORY_BANKS] = RAM_BANK_START_ADDRESSES;
+static const uint32_t vec_bank_end[MEMORY_BANKS] = RAM_BANK_END_ADDRESSES;
+static const uint8_t vec_bank_il_level[MEMORY_BANKS] = RAM_BANK_IL_LEVELS;
+static const uint8_t vec_bank_il_shift[MEMORY_BANKS] = RAM_BANK_IL_SHIFTS;
+
+/**********************************/
+/* ---- FUNCTION DEFINITIONS ---- */
+/**********************************/
+
+/* ---- Placement ---- */
+
+void vec_arena_init(vec_arena_t *arena, void *mem, size_t size)
+{
+    arena->base = (uint8_t *)mem;
+    arena->size = (uint32_t)size;
+    vec_arena_reset(arena);
+}
+
+void vec_arena_reset(vec_arena_t *arena)
+{
+    arena->offset = 0;
+    arena->count = 0;
+    arena->last_banks = 0;
+}
+
+int32_t *vec_alloc(vec_arena_t *arena, uint32_t n)
+{
+    uint32_t size = n * sizeof(int32_t);
+    uint32_t first = (arena->offset + 3) & ~3u;
+    uint32_t pos = first;
+    int bank = ram_bank_of(arena->base + pos);
+
+    if (bank >= 0 && vec_bank_il_level[bank] > 0)
+    {
+        // Start the k-th buffer in the k-th bank of the group, at the start of
+        // a block of its granularity
+        uint32_t banks = 1u << vec_bank_il_level[bank];
+        uint32_t shift = vec_bank_il_shift[bank];
+        uint32_t offset = (uint32_t)(uintptr_t)(arena->base + pos) - vec_bank_start[bank];
+        uint32_t block = (offset + (1u << shift) - 1) >> shift;
+        pos += (block << shift) - offset + (((arena->count - block) & (banks - 1)) << shift);
+    }
+    else
+    {
+        // Move to the next bank while the buffer shares one with the previous
+        // buffer, and stay packed if none is free in the arena
+        while (bank >= 0 && pos + size <= arena->size &&
+               (ram_banks_of(arena->base + pos, size) & arena->last_banks) != 0)
+        {
+            pos = vec_bank_end[bank] - (uint32_t)(uintptr_t)arena->base;
+            bank = ram_bank_of(arena->base + pos);
+        }
+        if (bank < 0 || pos + size > arena->size)
+        {
+            pos = first;
+        }
+    }
+
+    if (pos + size > arena->size)
+    {
+        return NULL;
+    }
+    arena->offset = pos + size;
+    arena->count++;
+    arena->last_banks = ram_banks_of(arena->base + pos, size);
+    return (int32_t *)(arena->base + pos);
+}
+
+/* ---- Operations ---- */
+
+// Two elements per iteration, loaded before their use, so that the loads of
+// the second do not wait for the result of the first.
+
+void vec_add(int32_t *c, const int32_t *a, const int32_t *b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        int32_t a0 = a[i], a1 = a[i + 1];
+        int32_t b0 = b[i], b1 = b[i + 1];
+        c[i] = a0 + b0;
+        c[i + 1] = a1 + b1;
+    }
+    for (; i < n; i++)
+    {
+        c[i] = a[i] + b[i];
+    }
+}
+
+void vec_mul(int32_t *c, const int32_t *a, const int32_t *b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        int32_t a0 = a[i], a1 = a[i + 1];
+        int32_t b0 = b[i], b1 = b[i + 1];
+        c[i] = a0 * b0;
+        c[i + 1] = a1 * b1;
+    }
+    for (; i < n; i++)
+    {
+        c[i] = a[i] * b[i];
+    }
+}
+
+void vec_mac(int32_t *acc, const int32_t *a, const int32_t *b, uint32_t n)
+{
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        int32_t a0 = a[i], a1 = a[i + 1];
+        int32_t b0 = b[i], b1 = b[i + 1];
+        acc[i] += a0 * b0;
+        acc[i + 1] += a1 * b1;
+    }
+    for (; i < n; i++)
+    {
+        acc[i] += a[i] * b[i];
+    }
+}
+
+int32_t vec_dot(const int32_t *a, const int32_t *b, uint32_t n)
+{
+    int32_t acc0 = 0, acc1 = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        int32_t a0 = a[i], a1 = a[i + 1];
+        int32_t b0 = b[i], b1 = b[i + 1];
+        acc0 += a0 * b0;
+        acc1 += a1 * b1;
+    }
+    for (; i < n; i++)
+    {
+        acc0 += a[i] * b[i];
+    }
+    return acc0 + acc1;
+}
+
+void vec_scale(int32_t *c, const int32_t *a, int32_t scale, uint32_t shift, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        c[i] = (a[i] * scale) >> shift;
+    }
+}
+
+uint32_t vec_cmp(uint8_t *mask, const int32_t *a, const int32_t *b, uint32_t n, vec_cmp_t op)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint8_t hit = op == VEC_CMP_LT ? a[i] < b[i] : op == VEC_CMP_EQ ? a[i] == b[i] : a[i] > b[i];
+        if (mask != NULL)
+        {
+            mask[i] = hit;
+        }
+        count += hit;
+    }
+    return count;
+}
+
+/* ---- Gather ---- */
+
+int vec_gather_start(vec_gather_t *g, int32_t *dst, const int32_t *src, uint32_t stride, uint32_t n)
+{
+    g->channel = -1;
+
+    if (n > 0 && n <= VEC_GATHER_MAX && stride <= UINT8_MAX)
+    {
+        g->channel = dma_sdk_channel_alloc();
+    }
+    if (g->channel >= 0)
+    {
+        g->src = (dma_target_t){
+            .ptr = (uint8_t *)src,
+            .inc_du = (uint8_t)stride,
+            .size_du = n,
+            .trig = DMA_TRIG_MEMORY,
+            .type = DMA_DATA_TYPE_WORD,
+        };
+        g->dst = (dma_target_t){
+            .ptr = (uint8_t *)dst,
+            .inc_du = 1,
+            .trig = DMA_TRIG_MEMORY,
+            .type = DMA_DATA_TYPE_WORD,
+        };
+        g->trans = (dma_trans_t){
+            .src = &g->src,
+            .dst = &g->dst,
+            .src_addr = NULL,
+            .mode = DMA_TRANS_MODE_SINGLE,
+            .dim = DMA_DIM_CONF_1D,
+            .win_du = 0,
+            .end = DMA_TRANS_END_INTR,
+            .channel = (uint8_t)g->channel,
+            .flags = DMA_CONFIG_OK,
+        };
+        if (!(dma_enqueue_transaction(&g->trans, DMA_DO_NOT_ENABLE_REALIGN, DMA_PERFORM_CHECKS_ONLY_CRITICAL) &
+              DMA_CONFIG_CRITICAL_ERROR))
+        {
+            return 0;
+        }
+        dma_sdk_channel_free((uint8_t)g->channel);
+        g->channel = -1;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i * stride];
+    }
+    return 1;
+}
+
+void vec_gather_wait(vec_gather_t *g)
+{
+    if (g->channel < 0)
+    {
+        return;
+    }
+    dma_queue_wait((uint8_t)g->channel);
+
+    // The registers no longer hold the image of an SDK handle
+    dma_sdk_handle_invalidate((uint8_t)g->channel);
+    dma_sdk_channel_free((uint8_t)g->channel);
+    g->channel = -1;
+}
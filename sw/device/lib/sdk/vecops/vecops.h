@@ -0,0 +1,167 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: vecops.h
+// Description: int32 vector operations (add, mul, MAC, dot, scale, compare)
+//              on buffers placed across the RAM banks, and DMA gathers of
+//              strided operands
+
+#ifndef VECOPS_H_
+#define VECOPS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dma.h"
+
+/*
+ * The operands of an operation are fastest in different banks, which the
+ * NtoM bus serves in parallel to the core and the DMA: a DMA gathering the
+ * next operand then does not stall the loads of the core on the current one.
+ *
+ * vec_alloc() places the buffers of an arena so: in an interleaved group
+ * (e.g. an arena in a RAM_INTERLEAVED buffer of ram_bank.h), the k-th buffer
+ * starts k words after the first bank, so that the i-th elements of
+ * successive buffers are in successive banks; in contiguous banks, a buffer
+ * is moved to the next bank when it would share one with the previous buffer,
+ * as long as the arena has room.
+ */
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief Largest number of elements of a DMA gather, from the 16-bit size
+ * register, in bytes. Longer gathers, and strides above 255 elements, are
+ * done by the CPU.
+ */
+#define VEC_GATHER_MAX (0xFFFF / sizeof(int32_t))
+
+/********************************/
+/* ---- EXPORTED TYPES ---- */
+/********************************/
+
+/**
+ * @brief Arena of vector buffers, freed at once. The fields are private.
+ */
+typedef struct
+{
+    uint8_t *base;
+    uint32_t size;
+    uint32_t offset;
+    uint32_t count;      // Buffers allocated since the last reset
+    uint32_t last_banks; // Banks of the previous buffer
+} vec_arena_t;
+
+/**
+ * @brief Comparison of vec_cmp().
+ */
+typedef enum
+{
+    VEC_CMP_LT = 0, // a < b
+    VEC_CMP_EQ = 1, // a == b
+    VEC_CMP_GT = 2, // a > b
+} vec_cmp_t;
+
+/**
+ * @brief Gather in flight, the transaction of the DMA. It must stay in memory
+ * until vec_gather_wait(). The fields are private.
+ */
+typedef struct
+{
+    dma_target_t src;
+    dma_target_t dst;
+    dma_trans_t trans;
+    int channel; // -1 when the CPU did the gather
+} vec_gather_t;
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief Creates an arena of vector buffers in mem.
+ *
+ * @param arena Arena to initialize
+ * @param mem Memory of the arena, aligned on a word
+ * @param size Size of mem in bytes
+ */
+void vec_arena_init(vec_arena_t *arena, void *mem, size_t size);
+
+/**
+ * @brief Allocates a buffer from an arena, in banks other than the ones of
+ * the previous buffer when the memory allows.
+ *
+ * @param arena Arena
+ * @param n Number of elements
+ * @return The buffer, aligned on a word, or NULL if the arena is full
+ */
+int32_t *vec_alloc(vec_arena_t *arena, uint32_t n);
+
+/**
+ * @brief Releases all the buffers of an arena.
+ */
+void vec_arena_reset(vec_arena_t *arena);
+
+/**
+ * @brief c = a + b, on vectors of n elements. c can be a or b.
+ */
+void vec_add(int32_t *c, const int32_t *a, const int32_t *b, uint32_t n);
+
+/**
+ * @brief c = a * b element-wise, the low 32 bits of the products. c can be a
+ * or b.
+ */
+void vec_mul(int32_t *c, const int32_t *a, const int32_t *b, uint32_t n);
+
+/**
+ * @brief acc = acc + a * b element-wise.
+ */
+void vec_mac(int32_t *acc, const int32_t *a, const int32_t *b, uint32_t n);
+
+/**
+ * @brief Dot product of two vectors of n elements, on 32 bits without
+ * saturation.
+ */
+int32_t vec_dot(const int32_t *a, const int32_t *b, uint32_t n);
+
+/**
+ * @brief c = (a * scale) >> shift, e.g. a Q-format scaling with shift the
+ * fractional bits of scale. The products are on 32 bits. c can be a.
+ */
+void vec_scale(int32_t *c, const int32_t *a, int32_t scale, uint32_t shift, uint32_t n);
+
+/**
+ * @brief Compares two vectors element-wise.
+ *
+ * @param mask Output, 1 where the comparison holds and 0 elsewhere, or NULL
+ * @param a, b Vectors of n elements
+ * @param n Number of elements
+ * @param op Comparison
+ * @return Number of elements where the comparison holds
+ */
+uint32_t vec_cmp(uint8_t *mask, const int32_t *a, const int32_t *b, uint32_t n, vec_cmp_t op);
+
+/**
+ * @brief Starts gathering every stride-th element of src into the contiguous
+ * dst, e.g. a column of a row-major matrix, without waiting. The buffers must
+ * not be used until vec_gather_wait(). Without a free DMA channel, or when
+ * the gather does not fit a transaction, the CPU does it before returning.
+ *
+ * @param g Gather, kept in memory until vec_gather_wait()
+ * @param dst Output, n elements
+ * @param src First element to gather
+ * @param stride Distance between the elements of src, in elements
+ * @param n Number of elements
+ * @return 0 if the DMA gathers, 1 if the CPU did
+ */
+int vec_gather_start(vec_gather_t *g, int32_t *dst, const int32_t *src, uint32_t stride, uint32_t n);
+
+/**
+ * @brief Sleeps until a gather has finished and frees its DMA channel.
+ */
+void vec_gather_wait(vec_gather_t *g);
+
+#endif // VECOPS_H_
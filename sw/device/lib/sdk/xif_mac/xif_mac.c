@@ -0,0 +1,44 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: xif_mac.c
+// Description: Dot products on the SIMD/MAC coprocessor of xif_mac.h
+
+#include "xif_mac.h"
+
+int32_t xif_mac_dot_s8(const int8_t *a, const int8_t *b, uint32_t n)
+{
+    const uint32_t *wa = (const uint32_t *)a;
+    const uint32_t *wb = (const uint32_t *)b;
+    int32_t acc = 0;
+    uint32_t i;
+
+    for (i = 0; i < n / 4; i++)
+    {
+        acc = xmac_mac4b(acc, wa[i], wb[i]);
+    }
+    for (i *= 4; i < n; i++)
+    {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+int32_t xif_mac_dot_s16(const int16_t *a, const int16_t *b, uint32_t n)
+{
+    const uint32_t *wa = (const uint32_t *)a;
+    const uint32_t *wb = (const uint32_t *)b;
+    int32_t acc = 0;
+    uint32_t i;
+
+    for (i = 0; i < n / 2; i++)
+    {
+        acc = xmac_mac2h(acc, wa[i], wb[i]);
+    }
+    if (n & 1)
+    {
+        acc += a[n - 1] * b[n - 1];
+    }
+    return acc;
+}
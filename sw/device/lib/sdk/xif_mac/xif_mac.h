@@ -0,0 +1,148 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: xif_mac.h
+// Description: Intrinsics of the SIMD/MAC coprocessor of hw/ip_examples/xif_mac
+//              on the CORE-V eXtension Interface, with portable C versions
+
+#ifndef XIF_MAC_H_
+#define XIF_MAC_H_
+
+#include <stdint.h>
+
+#include "core_v_mini_mcu.h"
+
+/********************************/
+/* ---- EXPORTED MACROS ---- */
+/********************************/
+
+/**
+ * @brief 1 when the intrinsics are the custom-0 instructions of the
+ * coprocessor: xif_coprocessor is xif_mac in mcu_cfg.hjson and the CPU is the
+ * cv32e40x or cv32e40px. The simulation must then be built with
+ * FUSESOC_PARAM="--X_EXT=1", else the instructions are illegal. 0 when they
+ * are the C versions, e.g. to check the results with another configuration.
+ */
+#if defined(XIF_COPROCESSOR_XIF_MAC) && (defined(CPU_TYPE_CV32E40X) || defined(CPU_TYPE_CV32E40PX))
+#define XIF_MAC_HW 1
+#else
+#define XIF_MAC_HW 0
+#endif
+
+/* The b intrinsics work on the 4 bytes of the words, byte 0 the lowest, and
+ * the h ones on their 2 half words. The SIMD additions and subtractions wrap,
+ * the dot products and accumulations are on 32 bits without saturation. */
+
+#if XIF_MAC_HW
+
+/* R-type custom-0 instruction, rd = f(rs1, rs2) */
+#define XIF_MAC_R(f3, f7, a, b)                                                       \
+    ({                                                                                \
+        uint32_t _rd;                                                                 \
+        asm volatile(".insn r 0x0B, " #f3 ", " #f7 ", %0, %1, %2"                     \
+                     : "=r"(_rd) : "r"((uint32_t)(a)), "r"((uint32_t)(b)));           \
+        _rd;                                                                          \
+    })
+
+/* R4-type custom-0 instruction, rd = f(rs1, rs2, rs3) */
+#define XIF_MAC_R4(f2, a, b, c)                                                       \
+    ({                                                                                \
+        uint32_t _rd;                                                                 \
+        asm volatile(".insn r4 0x0B, 2, " #f2 ", %0, %1, %2, %3"                      \
+                     : "=r"(_rd) : "r"((uint32_t)(a)), "r"((uint32_t)(b)), "r"((uint32_t)(c))); \
+        _rd;                                                                          \
+    })
+
+static inline uint32_t xmac_add4b(uint32_t a, uint32_t b) { return XIF_MAC_R(0, 0, a, b); }
+static inline uint32_t xmac_sub4b(uint32_t a, uint32_t b) { return XIF_MAC_R(0, 1, a, b); }
+static inline uint32_t xmac_add2h(uint32_t a, uint32_t b) { return XIF_MAC_R(0, 2, a, b); }
+static inline uint32_t xmac_sub2h(uint32_t a, uint32_t b) { return XIF_MAC_R(0, 3, a, b); }
+static inline uint32_t xmac_max4b(uint32_t a, uint32_t b) { return XIF_MAC_R(0, 4, a, b); }
+static inline uint32_t xmac_min4b(uint32_t a, uint32_t b) { return XIF_MAC_R(0, 5, a, b); }
+
+static inline int32_t xmac_dot4b(uint32_t a, uint32_t b) { return (int32_t)XIF_MAC_R(1, 0, a, b); }
+static inline uint32_t xmac_dotu4b(uint32_t a, uint32_t b) { return XIF_MAC_R(1, 1, a, b); }
+static inline int32_t xmac_dot2h(uint32_t a, uint32_t b) { return (int32_t)XIF_MAC_R(1, 2, a, b); }
+
+static inline int32_t xmac_mac4b(int32_t acc, uint32_t a, uint32_t b) { return (int32_t)XIF_MAC_R4(0, a, b, acc); }
+static inline uint32_t xmac_macu4b(uint32_t acc, uint32_t a, uint32_t b) { return XIF_MAC_R4(1, a, b, acc); }
+static inline int32_t xmac_mac2h(int32_t acc, uint32_t a, uint32_t b) { return (int32_t)XIF_MAC_R4(2, a, b, acc); }
+static inline int32_t xmac_mac(int32_t acc, int32_t a, int32_t b) { return (int32_t)XIF_MAC_R4(3, a, b, acc); }
+
+#else
+
+#define XIF_MAC_B(x, i) ((int8_t)((x) >> (8 * (i))))
+#define XIF_MAC_UB(x, i) ((uint8_t)((x) >> (8 * (i))))
+#define XIF_MAC_H(x, i) ((int16_t)((x) >> (16 * (i))))
+
+static inline uint32_t xmac_lanes4b(uint32_t a, uint32_t b, int op)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int8_t x = XIF_MAC_B(a, i), y = XIF_MAC_B(b, i);
+        uint8_t z = op == 0 ? (uint8_t)(x + y) : op == 1 ? (uint8_t)(x - y) : op == 4 ? (uint8_t)(x > y ? x : y) : (uint8_t)(x < y ? x : y);
+        r |= (uint32_t)z << (8 * i);
+    }
+    return r;
+}
+
+static inline uint32_t xmac_add4b(uint32_t a, uint32_t b) { return xmac_lanes4b(a, b, 0); }
+static inline uint32_t xmac_sub4b(uint32_t a, uint32_t b) { return xmac_lanes4b(a, b, 1); }
+static inline uint32_t xmac_add2h(uint32_t a, uint32_t b) { return ((a & 0xFFFF0000u) + (b & 0xFFFF0000u)) | ((a + b) & 0xFFFFu); }
+static inline uint32_t xmac_sub2h(uint32_t a, uint32_t b) { return ((a & 0xFFFF0000u) - (b & 0xFFFF0000u)) | ((a - b) & 0xFFFFu); }
+static inline uint32_t xmac_max4b(uint32_t a, uint32_t b) { return xmac_lanes4b(a, b, 4); }
+static inline uint32_t xmac_min4b(uint32_t a, uint32_t b) { return xmac_lanes4b(a, b, 5); }
+
+static inline int32_t xmac_dot4b(uint32_t a, uint32_t b)
+{
+    int32_t r = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        r += XIF_MAC_B(a, i) * XIF_MAC_B(b, i);
+    }
+    return r;
+}
+
+static inline uint32_t xmac_dotu4b(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        r += (uint32_t)XIF_MAC_UB(a, i) * XIF_MAC_UB(b, i);
+    }
+    return r;
+}
+
+static inline int32_t xmac_dot2h(uint32_t a, uint32_t b)
+{
+    return XIF_MAC_H(a, 0) * XIF_MAC_H(b, 0) + XIF_MAC_H(a, 1) * XIF_MAC_H(b, 1);
+}
+
+static inline int32_t xmac_mac4b(int32_t acc, uint32_t a, uint32_t b) { return (int32_t)((uint32_t)acc + (uint32_t)xmac_dot4b(a, b)); }
+static inline uint32_t xmac_macu4b(uint32_t acc, uint32_t a, uint32_t b) { return acc + xmac_dotu4b(a, b); }
+static inline int32_t xmac_mac2h(int32_t acc, uint32_t a, uint32_t b) { return (int32_t)((uint32_t)acc + (uint32_t)xmac_dot2h(a, b)); }
+static inline int32_t xmac_mac(int32_t acc, int32_t a, int32_t b) { return (int32_t)((uint32_t)acc + (uint32_t)a * (uint32_t)b); }
+
+#endif // XIF_MAC_HW
+
+/********************************/
+/* ---- EXPORTED FUNCTIONS ---- */
+/********************************/
+
+/**
+ * @brief int8 dot product with xmac_mac4b(), the vectors read by words.
+ *
+ * @param a First vector, word aligned
+ * @param b Second vector, word aligned
+ * @param n Number of elements, the last n % 4 computed one by one
+ */
+int32_t xif_mac_dot_s8(const int8_t *a, const int8_t *b, uint32_t n);
+
+/**
+ * @brief int16 dot product with xmac_mac2h(), see xif_mac_dot_s8().
+ */
+int32_t xif_mac_dot_s16(const int16_t *a, const int16_t *b, uint32_t n);
+
+#endif // XIF_MAC_H_
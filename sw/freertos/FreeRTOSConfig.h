@@ -74,11 +74,16 @@
 #define configMAX_PRIORITIES	 (5)
 /* Can be as low as 60 but some of the demo tasks that use this constant require it to be higher. */
 #define configMINIMAL_STACK_SIZE ((unsigned short)80)
-/* we want to put the heap into special section */
+/* we want to put the heap into special section. It is the default region of
+sw/freertos/heap_regions.c, the other linker sections are the other regions. */
 #define configAPPLICATION_ALLOCATED_HEAP 1
 #define configTOTAL_HEAP_SIZE		 ((size_t)(6 * 1024))
+/* Task stacks from their own region, see vPortSetHeapStackRegion() */
+#define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 1
 #define configMAX_TASK_NAME_LEN		 (12)
-#define configUSE_TRACE_FACILITY	 0 /* TODO: 0 */
+/* Task numbers and uxTaskGetSystemState(), also named by the trace of
+sw/freertos/port_trace.h */
+#define configUSE_TRACE_FACILITY	 1
 #define configUSE_16_BIT_TICKS		 0
 #define configIDLE_SHOULD_YIELD		 0
 #define configUSE_MUTEXES		 1
@@ -88,7 +93,15 @@
 #define configUSE_MALLOC_FAILED_HOOK	 1
 #define configUSE_APPLICATION_TASK_TAG	 0
 #define configUSE_COUNTING_SEMAPHORES	 1
-#define configGENERATE_RUN_TIME_STATS	 0
+/* Cycles run by each task, on mcycle, see sw/freertos/port_trace.h */
+#ifndef configGENERATE_RUN_TIME_STATS
+	#define configGENERATE_RUN_TIME_STATS 1
+#endif
+#define configRUN_TIME_COUNTER_TYPE uint64_t
+/* Log the scheduler and the interrupts with DLOG, set by FREERTOS_TRACE=1 */
+#ifndef configUSE_DLOG_TRACE
+	#define configUSE_DLOG_TRACE 0
+#endif
 #define configUSE_QUEUE_SETS                        1
 #define configTASK_NOTIFICATION_ARRAY_ENTRIES       3
 
@@ -123,6 +136,8 @@ to exclude the API function. */
 #define INCLUDE_xTaskAbortDelay                     1
 #define INCLUDE_xTaskGetHandle                      1
 #define INCLUDE_xSemaphoreGetMutexHolder            1
+#define INCLUDE_xTaskGetCurrentTaskHandle           1
+#define INCLUDE_xTaskGetSchedulerState              1
 
 /* Normal assert() semantics without relying on the provision of an assert.h
 header file. */
@@ -136,5 +151,29 @@ header file. */
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
 #define configKERNEL_INTERRUPT_PRIORITY 7
 
+/* Tickless idle: while all the tasks are blocked, the tick timer is moved to
+the next deadline and the core sleeps until it or another interrupt, see
+sw/freertos/port_tickless.c. */
+#ifndef configUSE_TICKLESS_IDLE
+	#define configUSE_TICKLESS_IDLE 1
+#endif
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+
+/* Idle periods of at least that many ticks power-gate the core instead of
+gating its clock. Only the tick timer wakes the core up from power gating, so
+keep it 0 (never) when tasks wait for other interrupts. */
+#ifndef configTICKLESS_POWER_GATE_TICKS
+	#define configTICKLESS_POWER_GATE_TICKS 0
+#endif
+
+#if( configUSE_TICKLESS_IDLE == 1 ) && !defined( __ASSEMBLER__ )
+	void vPortSuppressTicksAndSleep( uint32_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+
+#if !defined( __ASSEMBLER__ )
+	#include "port_trace.h"
+#endif
+
 
 #endif /* FREERTOS_CONFIG_H */
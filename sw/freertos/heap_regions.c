@@ -0,0 +1,470 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: heap_regions.c
+// Description: FreeRTOS heap over the RAM regions of the linker sections, a
+//              heap_4 free list per region (see heap_regions.h)
+
+#include <stdint.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers, like in heap_4.c. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "heap_regions.h"
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* Blocks smaller than this are not split off */
+#define heapMINIMUM_BLOCK_SIZE         ( ( size_t ) ( xHeapStructSize << 1 ) )
+
+/* Top bit of xBlockSize, set while the block is allocated */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * 8 ) - 1 ) )
+
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxNextFreeBlock;
+    size_t xBlockSize;
+} BlockLink_t;
+
+/* Bounds of a region, before alignment */
+typedef struct
+{
+    const char * pcName;
+    uintptr_t uxStart;
+    uintptr_t uxEnd;
+} HeapRegionBounds_t;
+
+/* A region and its free list, sorted by address */
+typedef struct
+{
+    BlockLink_t xStart;
+    BlockLink_t * pxEnd;
+    BaseType_t xInitialised;
+    size_t xTotalSize;
+    size_t xFreeSize;
+    size_t xMinimumEverFreeSize;
+    size_t xAllocations;
+    size_t xFrees;
+} HeapRegionArea_t;
+
+/* The default region */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif
+
+/* End of the data of the linker sections, weak since only link.ld has them */
+#define X( name, NAME )    extern char __xheep_##name##_end[] __attribute__( ( weak ) );
+LINKER_SECTIONS_EXTRA( X )
+#undef X
+
+static const HeapRegionBounds_t xRegionBounds[ heapREGION_COUNT ] =
+{
+    { "heap", ( uintptr_t ) ucHeap, ( uintptr_t ) ucHeap + configTOTAL_HEAP_SIZE },
+#define X( name, NAME )    { #name, ( uintptr_t ) __xheep_##name##_end, LINKER_SECTION_##NAME##_END_ADDRESS },
+    LINKER_SECTIONS_EXTRA( X )
+#undef X
+};
+
+static HeapRegionArea_t xRegionAreas[ heapREGION_COUNT ];
+
+static BaseType_t xStackRegion = heapREGION_DEFAULT;
+
+static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/*-----------------------------------------------------------*/
+
+/* Aligned start and end marker of a region, returns pdFALSE if it is too small */
+static BaseType_t prvRegionLimits( BaseType_t xRegion,
+                                   uintptr_t * puxStart,
+                                   uintptr_t * puxEnd )
+{
+    const HeapRegionBounds_t * pxBounds = &xRegionBounds[ xRegion ];
+    uintptr_t uxStart, uxEnd;
+
+    /* The section is not in the linker script */
+    if( pxBounds->uxStart == 0 )
+    {
+        return pdFALSE;
+    }
+
+    uxStart = ( pxBounds->uxStart + portBYTE_ALIGNMENT_MASK ) & ~( ( uintptr_t ) portBYTE_ALIGNMENT_MASK );
+    uxEnd = ( pxBounds->uxEnd - xHeapStructSize ) & ~( ( uintptr_t ) portBYTE_ALIGNMENT_MASK );
+
+    if( ( pxBounds->uxEnd < pxBounds->uxStart + xHeapStructSize ) || ( uxEnd <= uxStart + heapMINIMUM_BLOCK_SIZE ) )
+    {
+        return pdFALSE;
+    }
+
+    *puxStart = uxStart;
+    *puxEnd = uxEnd;
+    return pdTRUE;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Done on the first allocation, to leave the memory of unused regions untouched */
+static void prvInitialiseRegion( BaseType_t xRegion )
+{
+    HeapRegionArea_t * pxArea = &xRegionAreas[ xRegion ];
+    BlockLink_t * pxFirstFreeBlock;
+    uintptr_t uxStart, uxEnd;
+
+    pxArea->xInitialised = pdTRUE;
+
+    if( prvRegionLimits( xRegion, &uxStart, &uxEnd ) == pdFALSE )
+    {
+        return;
+    }
+
+    pxArea->pxEnd = ( BlockLink_t * ) uxEnd;
+    pxArea->pxEnd->xBlockSize = 0;
+    pxArea->pxEnd->pxNextFreeBlock = NULL;
+
+    pxFirstFreeBlock = ( BlockLink_t * ) uxStart;
+    pxFirstFreeBlock->xBlockSize = uxEnd - uxStart;
+    pxFirstFreeBlock->pxNextFreeBlock = pxArea->pxEnd;
+
+    pxArea->xStart.pxNextFreeBlock = pxFirstFreeBlock;
+    pxArea->xStart.xBlockSize = 0;
+
+    pxArea->xTotalSize = pxFirstFreeBlock->xBlockSize;
+    pxArea->xFreeSize = pxFirstFreeBlock->xBlockSize;
+    pxArea->xMinimumEverFreeSize = pxFirstFreeBlock->xBlockSize;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvInsertBlockIntoFreeList( HeapRegionArea_t * pxArea,
+                                        BlockLink_t * pxBlockToInsert )
+{
+    BlockLink_t * pxIterator;
+    uint8_t * puc;
+
+    for( pxIterator = &pxArea->xStart; pxIterator->pxNextFreeBlock < pxBlockToInsert; pxIterator = pxIterator->pxNextFreeBlock )
+    {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    /* Merge with the block before */
+    puc = ( uint8_t * ) pxIterator;
+
+    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    {
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+
+    /* Merge with the block after, unless it is the end marker */
+    puc = ( uint8_t * ) pxBlockToInsert;
+
+    if( ( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) pxIterator->pxNextFreeBlock ) &&
+        ( pxIterator->pxNextFreeBlock != pxArea->pxEnd ) )
+    {
+        pxBlockToInsert->xBlockSize += pxIterator->pxNextFreeBlock->xBlockSize;
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+    }
+
+    if( pxIterator != pxBlockToInsert )
+    {
+        pxIterator->pxNextFreeBlock = pxBlockToInsert;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocRegion( size_t xWantedSize,
+                           BaseType_t xRegion )
+{
+    HeapRegionArea_t * pxArea;
+    BlockLink_t * pxBlock, * pxPreviousBlock, * pxNewBlockLink;
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+
+    configASSERT( ( xRegion >= 0 ) && ( xRegion < heapREGION_COUNT ) );
+    pxArea = &xRegionAreas[ xRegion ];
+
+    /* Room for the header and the alignment, 0 if it overflows */
+    if( xWantedSize > 0 )
+    {
+        if( xWantedSize + xHeapStructSize > xWantedSize )
+        {
+            xWantedSize += xHeapStructSize;
+
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+                xWantedSize = ( xWantedSize + xAdditionalRequiredSize > xWantedSize ) ? xWantedSize + xAdditionalRequiredSize : 0;
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+
+    vTaskSuspendAll();
+    {
+        if( pxArea->xInitialised == pdFALSE )
+        {
+            prvInitialiseRegion( xRegion );
+        }
+
+        if( ( xWantedSize > 0 ) && ( ( xWantedSize & heapBLOCK_ALLOCATED_BITMASK ) == 0 ) &&
+            ( xWantedSize <= pxArea->xFreeSize ) )
+        {
+            /* First fit, the list is sorted by address */
+            pxPreviousBlock = &pxArea->xStart;
+            pxBlock = pxArea->xStart.pxNextFreeBlock;
+
+            while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != NULL ) )
+            {
+                pxPreviousBlock = pxBlock;
+                pxBlock = pxBlock->pxNextFreeBlock;
+            }
+
+            if( pxBlock != pxArea->pxEnd )
+            {
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+                /* Give the rest of a larger block back to the list */
+                if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+                {
+                    pxNewBlockLink = ( BlockLink_t * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+                    pxBlock->xBlockSize = xWantedSize;
+                    prvInsertBlockIntoFreeList( pxArea, pxNewBlockLink );
+                }
+
+                pxArea->xFreeSize -= pxBlock->xBlockSize;
+
+                if( pxArea->xFreeSize < pxArea->xMinimumEverFreeSize )
+                {
+                    pxArea->xMinimumEverFreeSize = pxArea->xFreeSize;
+                }
+
+                pxBlock->xBlockSize |= heapBLOCK_ALLOCATED_BITMASK;
+                pxBlock->pxNextFreeBlock = NULL;
+                pxArea->xAllocations++;
+            }
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            extern void vApplicationMallocFailedHook( void );
+            vApplicationMallocFailedHook();
+        }
+    }
+    #endif
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    return pvPortMallocRegion( xWantedSize, heapREGION_DEFAULT );
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+    HeapRegionArea_t * pxArea = NULL;
+    BaseType_t xRegion;
+
+    if( pv == NULL )
+    {
+        return;
+    }
+
+    puc -= xHeapStructSize;
+    pxLink = ( BlockLink_t * ) puc;
+
+    for( xRegion = 0; xRegion < heapREGION_COUNT; xRegion++ )
+    {
+        if( ( xRegionAreas[ xRegion ].pxEnd != NULL ) &&
+            ( puc >= ( uint8_t * ) xRegionBounds[ xRegion ].uxStart ) &&
+            ( puc < ( uint8_t * ) xRegionAreas[ xRegion ].pxEnd ) )
+        {
+            pxArea = &xRegionAreas[ xRegion ];
+            break;
+        }
+    }
+
+    configASSERT( pxArea != NULL );
+    configASSERT( ( pxLink->xBlockSize & heapBLOCK_ALLOCATED_BITMASK ) != 0 );
+    configASSERT( pxLink->pxNextFreeBlock == NULL );
+
+    if( ( pxArea != NULL ) && ( ( pxLink->xBlockSize & heapBLOCK_ALLOCATED_BITMASK ) != 0 ) &&
+        ( pxLink->pxNextFreeBlock == NULL ) )
+    {
+        pxLink->xBlockSize &= ~heapBLOCK_ALLOCATED_BITMASK;
+
+        vTaskSuspendAll();
+        {
+            pxArea->xFreeSize += pxLink->xBlockSize;
+            traceFREE( pv, pxLink->xBlockSize );
+            prvInsertBlockIntoFreeList( pxArea, pxLink );
+            pxArea->xFrees++;
+        }
+        ( void ) xTaskResumeAll();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+
+void * pvPortMallocStack( size_t xSize )
+{
+    return pvPortMallocRegion( xSize, xStackRegion );
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortFreeStack( void * pv )
+{
+    vPortFree( pv );
+}
+
+#endif /* configSTACK_ALLOCATION_FROM_SEPARATE_HEAP */
+
+/*-----------------------------------------------------------*/
+
+void vPortSetHeapStackRegion( BaseType_t xRegion )
+{
+    configASSERT( ( xRegion >= 0 ) && ( xRegion < heapREGION_COUNT ) );
+    xStackRegion = xRegion;
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    HeapRegionStats_t xStats;
+
+    vPortGetHeapRegionStats( heapREGION_DEFAULT, &xStats );
+    return xStats.xFreeSize;
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    HeapRegionStats_t xStats;
+
+    vPortGetHeapRegionStats( heapREGION_DEFAULT, &xStats );
+    return xStats.xMinimumEverFreeSize;
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapRegionStats( BaseType_t xRegion,
+                              HeapRegionStats_t * pxStats )
+{
+    HeapRegionArea_t * pxArea;
+    BlockLink_t * pxBlock;
+    uintptr_t uxStart, uxEnd;
+
+    configASSERT( ( xRegion >= 0 ) && ( xRegion < heapREGION_COUNT ) );
+    pxArea = &xRegionAreas[ xRegion ];
+
+    pxStats->pcName = xRegionBounds[ xRegion ].pcName;
+    pxStats->pvStart = ( void * ) xRegionBounds[ xRegion ].uxStart;
+    pxStats->xTotalSize = 0;
+    pxStats->xFreeSize = 0;
+    pxStats->xMinimumEverFreeSize = 0;
+    pxStats->xLargestFreeBlock = 0;
+    pxStats->xAllocations = 0;
+    pxStats->xFrees = 0;
+
+    vTaskSuspendAll();
+    {
+        if( pxArea->xInitialised == pdTRUE )
+        {
+            pxStats->xTotalSize = pxArea->xTotalSize;
+            pxStats->xFreeSize = pxArea->xFreeSize;
+            pxStats->xMinimumEverFreeSize = pxArea->xMinimumEverFreeSize;
+            pxStats->xAllocations = pxArea->xAllocations;
+            pxStats->xFrees = pxArea->xFrees;
+
+            for( pxBlock = pxArea->xStart.pxNextFreeBlock; ( pxBlock != NULL ) && ( pxBlock != pxArea->pxEnd ); pxBlock = pxBlock->pxNextFreeBlock )
+            {
+                if( pxBlock->xBlockSize > pxStats->xLargestFreeBlock )
+                {
+                    pxStats->xLargestFreeBlock = pxBlock->xBlockSize;
+                }
+            }
+        }
+        else if( prvRegionLimits( xRegion, &uxStart, &uxEnd ) == pdTRUE )
+        {
+            /* Not used yet, the whole region is free */
+            pxStats->xTotalSize = uxEnd - uxStart;
+            pxStats->xFreeSize = pxStats->xTotalSize;
+            pxStats->xMinimumEverFreeSize = pxStats->xTotalSize;
+            pxStats->xLargestFreeBlock = pxStats->xTotalSize;
+        }
+    }
+    ( void ) xTaskResumeAll();
+}
+
+/*-----------------------------------------------------------*/
+
+size_t xPortGetAllocationSize( void * pv )
+{
+    BlockLink_t * pxLink;
+    uintptr_t uxStart, uxEnd;
+    BaseType_t xRegion;
+
+    for( xRegion = 0; xRegion < heapREGION_COUNT; xRegion++ )
+    {
+        if( ( xRegionAreas[ xRegion ].xInitialised == pdFALSE ) ||
+            ( prvRegionLimits( xRegion, &uxStart, &uxEnd ) == pdFALSE ) ||
+            ( ( uintptr_t ) pv < uxStart + xHeapStructSize ) || ( ( uintptr_t ) pv >= uxEnd ) )
+        {
+            continue;
+        }
+
+        pxLink = ( BlockLink_t * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+
+        if( ( pxLink->xBlockSize & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+        {
+            return ( pxLink->xBlockSize & ~heapBLOCK_ALLOCATED_BITMASK ) - xHeapStructSize;
+        }
+    }
+
+    return 0;
+}
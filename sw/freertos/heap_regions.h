@@ -0,0 +1,86 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: heap_regions.h
+// Description: FreeRTOS heap over the RAM regions of the linker sections
+
+#ifndef HEAP_REGIONS_H
+#define HEAP_REGIONS_H
+
+#include <stddef.h>
+
+#include "FreeRTOS.h"
+#include "core_v_mini_mcu.h"
+
+/*
+ * The heap has one region per linker section of the configuration (mcu_gen.py)
+ * besides code and data: the space of the section after the data placed in
+ * it with RAM_SECTION(). The default region is ucHeap (configTOTAL_HEAP_SIZE)
+ * in the data section. Each region has its own free list, so an allocation
+ * stays in the banks of the region it asks for.
+ *
+ * pvPortMalloc() allocates from the default region and the task stacks from
+ * the stack region (configSTACK_ALLOCATION_FROM_SEPARATE_HEAP), the default
+ * region unless vPortSetHeapStackRegion() is called. The other regions are
+ * only used through pvPortMallocRegion(), so their banks can still be
+ * power-gated when nothing is allocated there; they span to the end of their
+ * section, use ram_banks_of() on pvStart and xTotalSize of their stats.
+ */
+
+/* Regions, heapREGION_<NAME> for the linker section <name> */
+enum
+{
+    heapREGION_DEFAULT = 0,
+#define X( name, NAME )    heapREGION_##NAME,
+    LINKER_SECTIONS_EXTRA( X )
+#undef X
+    heapREGION_COUNT
+};
+
+/* Region of the interleaved banks, for the large buffers that are read and
+ * written in parallel. The default one if there are no interleaved banks. */
+#ifdef HAS_MEMORY_BANKS_IL
+    #define heapREGION_INTERLEAVED    heapREGION_DATA_INTERLEAVED
+#else
+    #define heapREGION_INTERLEAVED    heapREGION_DEFAULT
+#endif
+
+typedef struct xHEAP_REGION_STATS
+{
+    const char * pcName;          /* Name of the linker section, "heap" for the default one */
+    void * pvStart;               /* First byte of the region */
+    size_t xTotalSize;            /* Bytes that can be allocated, headers included */
+    size_t xFreeSize;             /* Bytes free now */
+    size_t xMinimumEverFreeSize;  /* High-water mark: xTotalSize minus the peak use */
+    size_t xLargestFreeBlock;     /* Largest allocation that would succeed now, header included */
+    size_t xAllocations;          /* Successful pvPortMallocRegion() calls */
+    size_t xFrees;                /* vPortFree() calls */
+} HeapRegionStats_t;
+
+/*
+ * Allocates xWantedSize bytes in the region xRegion, calls the malloc failed
+ * hook and returns NULL if it does not fit.
+ */
+void * pvPortMallocRegion( size_t xWantedSize,
+                           BaseType_t xRegion );
+
+/*
+ * Sets the region of the stacks of the tasks created after it.
+ */
+void vPortSetHeapStackRegion( BaseType_t xRegion );
+
+/*
+ * Fills pxStats with the use of the region xRegion.
+ */
+void vPortGetHeapRegionStats( BaseType_t xRegion,
+                              HeapRegionStats_t * pxStats );
+
+/*
+ * Bytes that the application can use in the block pv returned by
+ * pvPortMallocRegion() or pvPortMallocStack(), 0 if pv is not such a block
+ * (e.g. the stack given to xTaskCreateStatic()).
+ */
+size_t xPortGetAllocationSize( void * pv );
+
+#endif /* HEAP_REGIONS_H */
@@ -0,0 +1,60 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: port_irq.c
+// Description: Default dispatch of the interrupts of the FreeRTOS RISC-V port
+
+#include "FreeRTOS.h"
+
+#include "rv_plic.h"
+#include "fast_intr_ctrl.h"
+
+/* Logged with configUSE_DLOG_TRACE, see port_trace.h */
+#ifndef traceISR_ENTER
+    #define traceISR_ENTER( ulMcause )
+#endif
+#ifndef traceISR_EXIT
+    #define traceISR_EXIT()
+#endif
+
+/* mcause of the interrupts, without the interrupt bit */
+#define portirqMCAUSE_CODE_MASK    0x7FFFFFFF
+#define portirqMCAUSE_EXTERNAL     11
+#define portirqMCAUSE_FAST_FIRST   16
+#define portirqMCAUSE_FAST_LAST    ( portirqMCAUSE_FAST_FIRST + kGpio_7_fic_e )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by the port for the interrupts other than the machine timer, on the
+ * stack of the interrupts (vectors_freertos.S sends all of them to the trap
+ * handler of the port). The handlers of vectors.S return with mret, so the
+ * sources are served by their C dispatchers: the PLIC claims and serves its
+ * sources, the fast interrupts call their fic_irq_*(). Both also notify the
+ * async sources (async.h), on which the tasks of rtos_io.h wait. Weak, the
+ * application can serve the interrupts itself.
+ */
+__attribute__( ( weak ) ) void freertos_risc_v_application_interrupt_handler( uint32_t ulMcause )
+{
+    uint32_t ulCode = ulMcause & portirqMCAUSE_CODE_MASK;
+
+    if( ulCode == portirqMCAUSE_EXTERNAL )
+    {
+        handler_irq_external();
+    }
+    else if( ( ulCode >= portirqMCAUSE_FAST_FIRST ) && ( ulCode <= portirqMCAUSE_FAST_LAST ) )
+    {
+        fic_irq_dispatch( ( fast_intr_ctrl_fast_interrupt_t ) ( ulCode - portirqMCAUSE_FAST_FIRST ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Same handler under the name given to portasmHANDLE_INTERRUPT in sw/CMakeLists.txt */
+__attribute__( ( weak ) ) void vSystemIrqHandler( uint32_t ulMcause )
+{
+    traceISR_ENTER( ulMcause );
+    freertos_risc_v_application_interrupt_handler( ulMcause );
+    traceISR_EXIT();
+}
@@ -0,0 +1,134 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: port_tickless.c
+// Description: Tickless idle of the FreeRTOS RISC-V port on the AO rv_timer
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "csr.h"
+#include "core_v_mini_mcu.h"
+#include "power_manager.h"
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+/* Defined by the RISC-V port (port.c): the compare value of the next tick and
+ * the timer increments of one tick. */
+extern uint64_t ullNextTime;
+extern const size_t uxTimerIncrementsForOneTick;
+
+#define MTIME_LOW     ( ( volatile uint32_t * ) ( configMTIME_BASE_ADDRESS ) )
+#define MTIME_HIGH    ( ( volatile uint32_t * ) ( configMTIME_BASE_ADDRESS + 4 ) )
+#define MTIMECMP_LOW  ( ( volatile uint32_t * ) ( configMTIMECMP_BASE_ADDRESS ) )
+#define MTIMECMP_HIGH ( ( volatile uint32_t * ) ( configMTIMECMP_BASE_ADDRESS + 4 ) )
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvReadMtime( void )
+{
+    uint32_t ulHigh, ulLow;
+
+    /* Read the high word again if the low one wrapped in between */
+    do
+    {
+        ulHigh = *MTIME_HIGH;
+        ulLow = *MTIME_LOW;
+    } while( ulHigh != *MTIME_HIGH );
+
+    return ( ( uint64_t ) ulHigh << 32 ) | ulLow;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvWriteMtimecmp( uint64_t ullCompare )
+{
+    /* Same order as the port, so that no intermediate value is in the past.
+     * The write also clears a pending compare interrupt. */
+    *MTIMECMP_HIGH = UINT32_MAX;
+    *MTIMECMP_LOW = ( uint32_t ) ullCompare;
+    *MTIMECMP_HIGH = ( uint32_t ) ( ullCompare >> 32 );
+}
+
+/*-----------------------------------------------------------*/
+
+#if( configTICKLESS_POWER_GATE_TICKS > 0 )
+
+static void prvPowerGateCore( void )
+{
+    static power_manager_t xPowerManager;
+    static power_manager_counters_t xCpuCounters;
+    static BaseType_t xInitialized = pdFALSE;
+
+    if( xInitialized == pdFALSE )
+    {
+        xPowerManager.base_addr = mmio_region_from_addr( POWER_MANAGER_START_ADDRESS );
+        /* Isolate, reset and switch off; switch on, release the reset and the isolation */
+        power_gate_counters_init( &xCpuCounters, 15, 30, 20, 10, 10, 35, 0, 0 );
+        power_gate_core_fast_init( &xPowerManager, &xCpuCounters );
+        xInitialized = pdTRUE;
+    }
+
+    /* Only the tick timer (timer 0) wakes the core up. Called from the idle
+     * task, so the short save of power_gate_core_fast() is enough */
+    power_gate_core_fast( kTimer_0_pm_e );
+}
+
+#endif /* configTICKLESS_POWER_GATE_TICKS */
+
+/*-----------------------------------------------------------*/
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+    const uint64_t ullTick = ( uint64_t ) uxTimerIncrementsForOneTick;
+    uint64_t ullLastTick, ullNow;
+    TickType_t xCompleteTicks;
+
+    /* Interrupts stay disabled until the tick count is corrected, a pending
+     * one still wakes the core up from wfi */
+    CSR_CLEAR_BITS( CSR_REG_MSTATUS, 0x8 );
+
+    if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+    {
+        CSR_SET_BITS( CSR_REG_MSTATUS, 0x8 );
+        return;
+    }
+
+    /* Move the compare of the next tick to the last tick of the idle period */
+    ullLastTick = ullNextTime - ullTick;
+    prvWriteMtimecmp( ullLastTick + ( uint64_t ) xExpectedIdleTime * ullTick );
+
+    #if( configTICKLESS_POWER_GATE_TICKS > 0 )
+        if( xExpectedIdleTime >= configTICKLESS_POWER_GATE_TICKS )
+        {
+            prvPowerGateCore();
+        }
+        else
+    #endif
+    {
+        /* The core clock is gated until an interrupt is pending */
+        __asm volatile( "wfi" );
+    }
+
+    /* Count the ticks that went by, whether the timer or another interrupt
+     * woke the core up, and put the compare back on the next tick boundary */
+    ullNow = prvReadMtime();
+    xCompleteTicks = ( TickType_t ) ( ( ullNow - ullLastTick ) / ullTick );
+    if( xCompleteTicks > xExpectedIdleTime )
+    {
+        xCompleteTicks = xExpectedIdleTime;
+    }
+
+    ullNextTime = ullLastTick + ( ( uint64_t ) xCompleteTicks + 1 ) * ullTick;
+    prvWriteMtimecmp( ullNextTime );
+
+    if( xCompleteTicks > 0 )
+    {
+        vTaskStepTick( xCompleteTicks );
+    }
+
+    CSR_SET_BITS( CSR_REG_MSTATUS, 0x8 );
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
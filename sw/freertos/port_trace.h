@@ -0,0 +1,85 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: port_trace.h
+// Description: Run-time statistics on mcycle and trace of the kernel with DLOG
+
+#ifndef PORT_TRACE_H
+#define PORT_TRACE_H
+
+#include <stdint.h>
+
+#include "csr.h"
+
+/*
+ * Included at the end of FreeRTOSConfig.h. The run-time counter of the tasks
+ * (configGENERATE_RUN_TIME_STATS) is the 64-bit mcycle counter of the core,
+ * so the ulRunTimeCounter of uxTaskGetSystemState() are in cycles and do not
+ * wrap. Do not write mcycle while the scheduler runs.
+ *
+ * With configUSE_DLOG_TRACE (make app FREERTOS_TRACE=1), the context
+ * switches, the ticks, the queue operations and the interrupts of
+ * port_irq.c are logged with DLOG() (dlog.h), a few tens of cycles each:
+ * call dlog_init() before the scheduler starts and decode the dump with
+ * util/dlog_decode.py. The tasks are named by their number, see
+ * vTaskSetTaskNumber() and the uxTaskNumber of uxTaskGetSystemState().
+ */
+
+static inline void vPortConfigureRunTimeCounter( void )
+{
+    CSR_CLEAR_BITS( CSR_REG_MCOUNTINHIBIT, 0x1 );
+}
+
+static inline uint64_t ullPortGetRunTimeCounterValue( void )
+{
+    uint32_t ulHigh, ulLow, ulHighAgain;
+
+    /* Read the low word again if it wrapped in between */
+    do
+    {
+        CSR_READ( CSR_REG_MCYCLEH, &ulHigh );
+        CSR_READ( CSR_REG_MCYCLE, &ulLow );
+        CSR_READ( CSR_REG_MCYCLEH, &ulHighAgain );
+    } while( ulHigh != ulHighAgain );
+
+    return ( ( uint64_t ) ulHigh << 32 ) | ulLow;
+}
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vPortConfigureRunTimeCounter()
+    #define portGET_RUN_TIME_COUNTER_VALUE()            ullPortGetRunTimeCounterValue()
+#endif
+
+#if ( configUSE_DLOG_TRACE == 1 )
+
+    #include "dlog.h"
+
+    /* pxCurrentTCB is the TCB of tasks.c, where the macros are expanded */
+    #define traceTASK_SWITCHED_IN() \
+    DLOG( "freertos: switch in task %u\n", ( uint32_t ) pxCurrentTCB->uxTCBNumber )
+    #define traceTASK_SWITCHED_OUT() \
+    DLOG( "freertos: switch out task %u\n", ( uint32_t ) pxCurrentTCB->uxTCBNumber )
+    #define traceTASK_INCREMENT_TICK( xTickCount ) \
+    DLOG( "freertos: tick %u\n", ( uint32_t ) ( xTickCount ) )
+
+    #define traceQUEUE_SEND( pxQueue ) \
+    DLOG( "freertos: queue 0x%08x send\n", ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+    #define traceQUEUE_SEND_FROM_ISR( pxQueue ) \
+    DLOG( "freertos: queue 0x%08x send from isr\n", ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+    #define traceQUEUE_RECEIVE( pxQueue ) \
+    DLOG( "freertos: queue 0x%08x receive\n", ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+    #define traceBLOCKING_ON_QUEUE_SEND( pxQueue ) \
+    DLOG( "freertos: queue 0x%08x full, blocking\n", ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+    #define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue ) \
+    DLOG( "freertos: queue 0x%08x empty, blocking\n", ( uint32_t ) ( uintptr_t ) ( pxQueue ) )
+
+    /* Not kernel hooks, expanded by port_irq.c */
+    #define traceISR_ENTER( ulMcause ) \
+    DLOG( "freertos: isr enter mcause %u\n", ( uint32_t ) ( ulMcause ) )
+    #define traceISR_EXIT() \
+    DLOG( "freertos: isr exit\n" )
+
+#endif /* configUSE_DLOG_TRACE */
+
+#endif /* PORT_TRACE_H */
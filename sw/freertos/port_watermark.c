@@ -0,0 +1,72 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: port_watermark.c
+// Description: Peak use of the task stacks and of the heap regions, printed at exit with MEM_WATERMARK
+
+#include "mem_watermark.h"
+
+#ifdef MEM_WATERMARK
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_regions.h"
+
+/* Tasks reported, the other ones are counted */
+#define portwatermarkMAX_TASKS    16
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Replaces the weak definition of the runtime, called at exit after the stack
+ * and the heap of the linker script. The kernel fills the new stacks with
+ * tskSTACK_FILL_BYTE (configCHECK_FOR_STACK_OVERFLOW > 1), the byte of
+ * MEM_WATERMARK_PATTERN, and keeps the lowest free space of each one. Only
+ * the tasks that still exist are reported; the size of the stacks given to
+ * xTaskCreateStatic() is not known, their size and peak are printed as 0.
+ * The names come last, they may have spaces (e.g. "Tmr Svc").
+ */
+void mem_watermark_tasks( void )
+{
+    static TaskStatus_t xTasks[ portwatermarkMAX_TASKS ];
+    HeapRegionStats_t xStats;
+    UBaseType_t uxTasks, uxTask;
+    size_t xSize, xFree;
+    BaseType_t xRegion;
+
+    uxTasks = uxTaskGetNumberOfTasks();
+
+    if( uxTasks > portwatermarkMAX_TASKS )
+    {
+        printf( "MEM tasks %lu, only %d reported\n", ( unsigned long ) uxTasks, portwatermarkMAX_TASKS );
+        uxTasks = 0;
+    }
+    else
+    {
+        uxTasks = uxTaskGetSystemState( xTasks, portwatermarkMAX_TASKS, NULL );
+    }
+
+    for( uxTask = 0; uxTask < uxTasks; uxTask++ )
+    {
+        xSize = xPortGetAllocationSize( xTasks[ uxTask ].pxStackBase );
+        xFree = ( size_t ) xTasks[ uxTask ].usStackHighWaterMark * sizeof( StackType_t );
+        printf( "MEM task %lu %lu %s\n", ( unsigned long ) ( ( xSize > xFree ) ? xSize - xFree : 0 ),
+                ( unsigned long ) xSize, xTasks[ uxTask ].pcTaskName );
+    }
+
+    for( xRegion = 0; xRegion < heapREGION_COUNT; xRegion++ )
+    {
+        vPortGetHeapRegionStats( xRegion, &xStats );
+
+        if( xStats.xTotalSize != 0 )
+        {
+            printf( "MEM rtos_heap %lu %lu %s\n", ( unsigned long ) ( xStats.xTotalSize - xStats.xMinimumEverFreeSize ),
+                    ( unsigned long ) xStats.xTotalSize, xStats.pcName );
+        }
+    }
+}
+
+#endif /* MEM_WATERMARK */
@@ -0,0 +1,440 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: rtos_io.c
+// Description: Blocking DMA, SPI, flash and I2S transfers for the FreeRTOS tasks
+
+#include "rtos_io.h"
+
+#include "semphr.h"
+
+#include "core_v_mini_mcu.h"
+#include "dma_sdk.h"
+
+/* Task waiting for each source, NULL if none. Cleared by the interrupt that
+ * wakes the task up, or by the task itself when it stops waiting. */
+static TaskHandle_t volatile pxWaiters[ ASYNC_SOURCES ];
+
+static SemaphoreHandle_t xFlashMutex = NULL;
+
+/* The flash reads of the BSP use the channel 0 of the integrated DMA */
+#define rtosioFLASH_DMA_SOURCE    ASYNC_SOURCE_DMA( 0 )
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xRtosIoPrepare( uint32_t ulSource )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    if( ulSource >= ASYNC_SOURCES )
+    {
+        return pdFAIL;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        if( pxWaiters[ ulSource ] == NULL )
+        {
+            /* Drop the notification of a source that was given up on */
+            ( void ) xTaskNotifyStateClearIndexed( NULL, rtosioNOTIFY_INDEX );
+            pxWaiters[ ulSource ] = xTaskGetCurrentTaskHandle();
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xRtosIoWait( uint32_t ulSource,
+                        TickType_t xTicksToWait,
+                        int32_t * plValue )
+{
+    uint32_t ulValue = 0;
+    BaseType_t xReturn;
+
+    xReturn = xTaskNotifyWaitIndexed( rtosioNOTIFY_INDEX, 0, UINT32_MAX, &ulValue, xTicksToWait );
+
+    if( xReturn == pdFALSE )
+    {
+        BaseType_t xNotified;
+
+        taskENTER_CRITICAL();
+        {
+            /* The interrupt may have come after the timeout */
+            xNotified = ( pxWaiters[ ulSource ] == NULL ) ? pdTRUE : pdFALSE;
+            pxWaiters[ ulSource ] = NULL;
+        }
+        taskEXIT_CRITICAL();
+
+        if( xNotified == pdTRUE )
+        {
+            xReturn = xTaskNotifyWaitIndexed( rtosioNOTIFY_INDEX, 0, UINT32_MAX, &ulValue, 0 );
+        }
+    }
+
+    if( ( xReturn == pdTRUE ) && ( plValue != NULL ) )
+    {
+        *plValue = ( int32_t ) ulValue;
+    }
+
+    return ( xReturn == pdTRUE ) ? pdPASS : pdFAIL;
+}
+
+/*-----------------------------------------------------------*/
+
+void vRtosIoCancel( uint32_t ulSource )
+{
+    if( ulSource < ASYNC_SOURCES )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( pxWaiters[ ulSource ] == xTaskGetCurrentTaskHandle() )
+            {
+                pxWaiters[ ulSource ] = NULL;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Called by async_notify() from the interrupt handlers of the drivers */
+void async_source_notified( uint32_t source,
+                            int32_t value )
+{
+    TaskHandle_t xTask = pxWaiters[ source ];
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if( xTask != NULL )
+    {
+        pxWaiters[ source ] = NULL;
+        ( void ) xTaskNotifyIndexedFromISR( xTask, rtosioNOTIFY_INDEX, ( uint32_t ) value,
+                                            eSetValueWithOverwrite, &xHigherPriorityTaskWoken );
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+void vRtosIoInit( void )
+{
+    if( xFlashMutex == NULL )
+    {
+        xFlashMutex = xSemaphoreCreateMutex();
+        configASSERT( xFlashMutex != NULL );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+dma_config_flags_t xRtosIoDmaTransfer( dma_trans_t * pxTrans,
+                                       dma_en_realign_t xRealign,
+                                       dma_perf_checks_t xCheck,
+                                       TickType_t xTicksToWait )
+{
+    uint32_t ulSource = ASYNC_SOURCE_DMA( pxTrans->channel );
+    dma_config_flags_t xFlags;
+
+    pxTrans->end = DMA_TRANS_END_INTR;
+
+    xFlags = dma_validate_transaction( pxTrans, xRealign, xCheck );
+    if( ( xFlags & DMA_CONFIG_CRITICAL_ERROR ) != 0 )
+    {
+        return xFlags;
+    }
+
+    if( dma_load_transaction( pxTrans ) != DMA_CONFIG_OK )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    if( xRtosIoPrepare( ulSource ) == pdFAIL )
+    {
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    if( dma_launch( pxTrans ) != DMA_CONFIG_OK )
+    {
+        vRtosIoCancel( ulSource );
+        return DMA_CONFIG_CRITICAL_ERROR;
+    }
+
+    if( xRtosIoWait( ulSource, xTicksToWait, NULL ) == pdFAIL )
+    {
+        return DMA_CONFIG_TRANS_OVERRIDE;
+    }
+
+    return xFlags;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvDmaCopyDone( dma_sdk_ticket_t xTicket,
+                            void * pvTask )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    ( void ) xTicket;
+    vTaskNotifyGiveIndexedFromISR( ( TaskHandle_t ) pvTask, rtosioNOTIFY_INDEX, &xHigherPriorityTaskWoken );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+BaseType_t xRtosIoDmaCopy( uint32_t * pulDst,
+                           uint32_t * pulSrc,
+                           uint32_t ulWords,
+                           TickType_t xTicksToWait )
+{
+    ( void ) xTaskNotifyStateClearIndexed( NULL, rtosioNOTIFY_INDEX );
+    ( void ) dma_copy_32b_async( pulDst, pulSrc, ulWords, prvDmaCopyDone, xTaskGetCurrentTaskHandle() );
+
+    return ( ulTaskNotifyTakeIndexed( rtosioNOTIFY_INDEX, pdTRUE, xTicksToWait ) != 0 ) ? pdPASS : pdFAIL;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Waits for the end of the transaction started with xCode, if it started */
+static spi_codes_e prvSpiWait( spi_t * pxSpi,
+                               spi_codes_e xCode,
+                               TickType_t xTicksToWait )
+{
+    uint32_t ulSource = ASYNC_SOURCE_SPI( pxSpi->idx );
+    int32_t lErrors = 0;
+
+    if( xCode != SPI_CODE_OK )
+    {
+        vRtosIoCancel( ulSource );
+        return xCode;
+    }
+
+    if( xRtosIoWait( ulSource, xTicksToWait, &lErrors ) == pdFAIL )
+    {
+        return SPI_CODE_IS_BUSY;
+    }
+
+    return ( lErrors == 0 ) ? SPI_CODE_OK : SPI_CODE_BASE_ERROR;
+}
+
+static const spi_callbacks_t xNoCallbacks = { 0 };
+
+spi_codes_e xRtosIoSpiTransmit( spi_t * pxSpi,
+                                const uint32_t * pulSrc,
+                                uint32_t ulLength,
+                                TickType_t xTicksToWait )
+{
+    if( xRtosIoPrepare( ASYNC_SOURCE_SPI( pxSpi->idx ) ) == pdFAIL )
+    {
+        return SPI_CODE_IS_BUSY;
+    }
+
+    return prvSpiWait( pxSpi, spi_transmit_nb( pxSpi, pulSrc, ulLength, xNoCallbacks ), xTicksToWait );
+}
+
+spi_codes_e xRtosIoSpiReceive( spi_t * pxSpi,
+                               uint32_t * pulDst,
+                               uint32_t ulLength,
+                               TickType_t xTicksToWait )
+{
+    if( xRtosIoPrepare( ASYNC_SOURCE_SPI( pxSpi->idx ) ) == pdFAIL )
+    {
+        return SPI_CODE_IS_BUSY;
+    }
+
+    return prvSpiWait( pxSpi, spi_receive_nb( pxSpi, pulDst, ulLength, xNoCallbacks ), xTicksToWait );
+}
+
+spi_codes_e xRtosIoSpiTransceive( spi_t * pxSpi,
+                                  const uint32_t * pulSrc,
+                                  uint32_t * pulDst,
+                                  uint32_t ulLength,
+                                  TickType_t xTicksToWait )
+{
+    if( xRtosIoPrepare( ASYNC_SOURCE_SPI( pxSpi->idx ) ) == pdFAIL )
+    {
+        return SPI_CODE_IS_BUSY;
+    }
+
+    return prvSpiWait( pxSpi, spi_transceive_nb( pxSpi, pulSrc, pulDst, ulLength, xNoCallbacks ), xTicksToWait );
+}
+
+spi_codes_e xRtosIoSpiExecute( spi_t * pxSpi,
+                               const spi_segment_t * pxSegments,
+                               uint32_t ulSegments,
+                               const uint32_t * pulSrc,
+                               uint32_t * pulDst,
+                               TickType_t xTicksToWait )
+{
+    if( xRtosIoPrepare( ASYNC_SOURCE_SPI( pxSpi->idx ) ) == pdFAIL )
+    {
+        return SPI_CODE_IS_BUSY;
+    }
+
+    return prvSpiWait( pxSpi,
+                       spi_execute_nb( pxSpi, pxSegments, ulSegments, pulSrc, pulDst, xNoCallbacks ),
+                       xTicksToWait );
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xRtosIoFlashTake( TickType_t xTicksToWait )
+{
+    configASSERT( xFlashMutex != NULL );
+    return xSemaphoreTake( xFlashMutex, xTicksToWait );
+}
+
+void vRtosIoFlashGive( void )
+{
+    ( void ) xSemaphoreGive( xFlashMutex );
+}
+
+/*-----------------------------------------------------------*/
+
+typedef w25q_error_codes_t ( * ReadStart_t )( w25q128jw_read_handle_t * pxHandle,
+                                              uint32_t ulAddr,
+                                              void * pvData,
+                                              uint32_t ulLength );
+
+static w25q_error_codes_t prvFlashRead( ReadStart_t pxStart,
+                                        uint32_t ulAddr,
+                                        void * pvData,
+                                        uint32_t ulLength )
+{
+    w25q128jw_read_handle_t xHandle;
+    w25q_error_codes_t xStatus = FLASH_ERROR_DMA;
+
+    ( void ) xRtosIoFlashTake( portMAX_DELAY );
+
+    if( xRtosIoPrepare( rtosioFLASH_DMA_SOURCE ) == pdPASS )
+    {
+        w25q128jw_set_read_dma_intr( 1 );
+        xStatus = pxStart( &xHandle, ulAddr, pvData, ulLength );
+
+        if( ( xStatus == FLASH_OK ) && ( w25q128jw_read_dma_done( &xHandle ) == 0 ) )
+        {
+            ( void ) xRtosIoWait( rtosioFLASH_DMA_SOURCE, portMAX_DELAY, NULL );
+        }
+        else
+        {
+            vRtosIoCancel( rtosioFLASH_DMA_SOURCE );
+        }
+
+        /* Also reads the bytes after the last full word */
+        if( xStatus == FLASH_OK )
+        {
+            xStatus = w25q128jw_read_dma_wait( &xHandle );
+        }
+
+        w25q128jw_set_read_dma_intr( 0 );
+    }
+
+    vRtosIoFlashGive();
+
+    return xStatus;
+}
+
+w25q_error_codes_t xRtosIoFlashReadQuadDma( uint32_t ulAddr,
+                                            void * pvData,
+                                            uint32_t ulLength )
+{
+    return prvFlashRead( w25q128jw_read_quad_dma_async, ulAddr, pvData, ulLength );
+}
+
+w25q_error_codes_t xRtosIoFlashReadStandardDma( uint32_t ulAddr,
+                                                void * pvData,
+                                                uint32_t ulLength )
+{
+    return prvFlashRead( w25q128jw_read_standard_dma_async, ulAddr, pvData, ulLength );
+}
+
+/*-----------------------------------------------------------*/
+
+w25q_error_codes_t xRtosIoFlashErase( uint32_t ulAddr,
+                                      uint32_t ulLength )
+{
+    w25q_error_codes_t xStatus;
+
+    ( void ) xRtosIoFlashTake( portMAX_DELAY );
+
+    switch( ulLength )
+    {
+        case 4 * 1024:
+            xStatus = w25q128jw_4k_erase_async( ulAddr );
+            break;
+
+        case 32 * 1024:
+            xStatus = w25q128jw_32k_erase_async( ulAddr );
+            break;
+
+        case 64 * 1024:
+            xStatus = w25q128jw_64k_erase_async( ulAddr );
+            break;
+
+        default:
+            xStatus = FLASH_ERROR;
+            break;
+    }
+
+    if( xStatus == FLASH_OK )
+    {
+        /* A sector takes tens of milliseconds, a block hundreds */
+        while( w25q128jw_erase_poll() != W25Q_ERASE_IDLE )
+        {
+            vTaskDelay( 1 );
+        }
+    }
+
+    vRtosIoFlashGive();
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+/* Called by the BSP while the flash programs or erases */
+void w25q128jw_busy_handler( void )
+{
+    if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+    {
+        vTaskDelay( 1 );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+const uint32_t * pulRtosIoI2sGet( i2s_stream_t * pxStream,
+                                  TickType_t xTicksToWait )
+{
+    const uint32_t * pulBlock;
+    TimeOut_t xTimeOut;
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        /* Prepared before the check, so that a block captured in between wakes the task up */
+        if( xRtosIoPrepare( ASYNC_SOURCE_PLIC( DMA_WINDOW_INTR ) ) == pdFAIL )
+        {
+            return NULL;
+        }
+
+        pulBlock = i2s_stream_get( pxStream );
+
+        if( pulBlock != NULL )
+        {
+            vRtosIoCancel( ASYNC_SOURCE_PLIC( DMA_WINDOW_INTR ) );
+            return pulBlock;
+        }
+
+        /* The window interrupt is shared by all the DMA streams, wait again for another one */
+        if( ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE ) ||
+            ( xRtosIoWait( ASYNC_SOURCE_PLIC( DMA_WINDOW_INTR ), xTicksToWait, NULL ) == pdFAIL ) )
+        {
+            vRtosIoCancel( ASYNC_SOURCE_PLIC( DMA_WINDOW_INTR ) );
+            return i2s_stream_get( pxStream );
+        }
+    }
+}
@@ -0,0 +1,164 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: rtos_io.h
+// Description: Blocking DMA, SPI, flash and I2S transfers for the FreeRTOS tasks
+
+#ifndef RTOS_IO_H
+#define RTOS_IO_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "async.h"
+#include "dma.h"
+#include "spi_sdk.h"
+#include "w25q128jw.h"
+#include "i2s_stream.h"
+
+/*
+ * The drivers wait for the end of a transfer by spinning on a register or with
+ * wait_for_interrupt(), which keeps the core busy for the other tasks. The
+ * functions below start the transfer and block the calling task on a task
+ * notification instead, given from the interrupt handler of the transfer:
+ * the drivers call async_notify() for each of their interrupt sources
+ * (ASYNC_SOURCE_*() of async.h), and rtos_io.c wakes up the task waiting for
+ * the source from async_source_notified(). The interrupts reach the drivers
+ * through the dispatcher of port_irq.c, and their sources must be enabled
+ * (mie, PLIC) as without FreeRTOS.
+ *
+ * The notifications use the index rtosioNOTIFY_INDEX of the task, that the
+ * application must not use for anything else. A source has at most one
+ * waiting task: the functions fail if another task already waits for it.
+ *
+ * When any of them is linked in, the waits of the flash BSP for a program or
+ * an erase (w25q128jw_busy_handler) also sleep for a tick between the reads of
+ * the status register once the scheduler runs.
+ */
+
+/* Index of the task notifications used to wait for a source */
+#define rtosioNOTIFY_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+
+/*
+ * Makes the calling task the one woken up by the next interrupt of ulSource.
+ * Called before the transfer is started, so that its interrupt is not missed.
+ * Returns pdFAIL if another task waits for ulSource or if it does not exist.
+ */
+BaseType_t xRtosIoPrepare( uint32_t ulSource );
+
+/*
+ * Blocks the calling task until the interrupt of ulSource, prepared with
+ * xRtosIoPrepare(), or for xTicksToWait ticks. Stores the value given to
+ * async_notify() in *plValue if plValue is not NULL. Returns pdFAIL on a
+ * timeout, after which the source is no longer waited for.
+ */
+BaseType_t xRtosIoWait( uint32_t ulSource,
+                        TickType_t xTicksToWait,
+                        int32_t * plValue );
+
+/*
+ * Stops waiting for ulSource, e.g. when the transfer could not be started.
+ */
+void vRtosIoCancel( uint32_t ulSource );
+
+/*
+ * Creates the mutex of the flash. Called once before the tasks use the flash.
+ */
+void vRtosIoInit( void );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Validates, loads and launches a transaction of the integrated DMA with the
+ * transaction done interrupt (its end is set to DMA_TRANS_END_INTR), and
+ * blocks until it has finished. Returns the flags of the validation,
+ * DMA_CONFIG_CRITICAL_ERROR if it failed, or DMA_CONFIG_TRANS_OVERRIDE if the
+ * transaction still runs after xTicksToWait ticks.
+ */
+dma_config_flags_t xRtosIoDmaTransfer( dma_trans_t * pxTrans,
+                                       dma_en_realign_t xRealign,
+                                       dma_perf_checks_t xCheck,
+                                       TickType_t xTicksToWait );
+
+/*
+ * dma_copy_32b() that blocks the calling task until the copy is done, or for
+ * xTicksToWait ticks. Returns pdFAIL on a timeout, the copy then goes on.
+ */
+BaseType_t xRtosIoDmaCopy( uint32_t * pulDst,
+                           uint32_t * pulSrc,
+                           uint32_t ulWords,
+                           TickType_t xTicksToWait );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * spi_transmit(), spi_receive(), spi_transceive() and spi_execute() of the
+ * SPI SDK that block the calling task until the transaction is done, or for
+ * xTicksToWait ticks. Return the code of the non-blocking function that
+ * starts the transaction, SPI_CODE_BASE_ERROR if the transaction ended with
+ * an error (spi_get_state() tells which), or SPI_CODE_IS_BUSY if it still runs
+ * after xTicksToWait ticks or if another task waits for the same SPI.
+ */
+spi_codes_e xRtosIoSpiTransmit( spi_t * pxSpi,
+                                const uint32_t * pulSrc,
+                                uint32_t ulLength,
+                                TickType_t xTicksToWait );
+spi_codes_e xRtosIoSpiReceive( spi_t * pxSpi,
+                               uint32_t * pulDst,
+                               uint32_t ulLength,
+                               TickType_t xTicksToWait );
+spi_codes_e xRtosIoSpiTransceive( spi_t * pxSpi,
+                                  const uint32_t * pulSrc,
+                                  uint32_t * pulDst,
+                                  uint32_t ulLength,
+                                  TickType_t xTicksToWait );
+spi_codes_e xRtosIoSpiExecute( spi_t * pxSpi,
+                               const spi_segment_t * pxSegments,
+                               uint32_t ulSegments,
+                               const uint32_t * pulSrc,
+                               uint32_t * pulDst,
+                               TickType_t xTicksToWait );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Takes and gives back the mutex of the flash, for the functions of the BSP
+ * used directly by several tasks. The functions below take it themselves.
+ */
+BaseType_t xRtosIoFlashTake( TickType_t xTicksToWait );
+void vRtosIoFlashGive( void );
+
+/*
+ * w25q128jw_read_quad_dma() and w25q128jw_read_standard_dma() that block the
+ * calling task while the DMA reads the flash, on its transaction done
+ * interrupt (w25q128jw_set_read_dma_intr()). The reads use DMA channel 0.
+ */
+w25q_error_codes_t xRtosIoFlashReadQuadDma( uint32_t ulAddr,
+                                            void * pvData,
+                                            uint32_t ulLength );
+w25q_error_codes_t xRtosIoFlashReadStandardDma( uint32_t ulAddr,
+                                                void * pvData,
+                                                uint32_t ulLength );
+
+/*
+ * Erases the sector or the block of ulLength bytes (4 KiB, 32 KiB or 64 KiB)
+ * at ulAddr, polling the end of the erase once per tick
+ * (w25q128jw_erase_poll()). Returns FLASH_ERROR for the other lengths.
+ */
+w25q_error_codes_t xRtosIoFlashErase( uint32_t ulAddr,
+                                      uint32_t ulLength );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * i2s_stream_get() that blocks the calling task until a block is captured,
+ * on the DMA window interrupt, or for xTicksToWait ticks. Returns NULL on a
+ * timeout. The stream must have no callback.
+ */
+const uint32_t * pulRtosIoI2sGet( i2s_stream_t * pxStream,
+                                  TickType_t xTicksToWait );
+
+#endif /* RTOS_IO_H */
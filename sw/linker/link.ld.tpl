@@ -27,8 +27,13 @@ MEMORY
 
 /*
  * This linker script try to put data in ram1 and code
- * in ram0.
+ * in ram0. The hot code, the cold code and the stack go to the linker
+ * sections named hot, cold and stack when there are.
 */
+<%
+  regions = {section.name: i for i, section in enumerate(xheep.iter_linker_sections())}
+  aligns = {section.name: section.align for section in xheep.iter_linker_sections()}
+%>
 
 SECTIONS
 {
@@ -38,6 +43,10 @@ SECTIONS
   /* stack and heap related settings */
   __stack_size = DEFINED(__stack_size) ? __stack_size : 0x${stack_size};
   PROVIDE(__stack_size = __stack_size);
+% if num_harts > 1:
+  __hart_stack_size = DEFINED(__hart_stack_size) ? __hart_stack_size : 0x${hart_stack_size};
+  PROVIDE(__hart_stack_size = __hart_stack_size);
+% endif
   __heap_size = DEFINED(__heap_size) ? __heap_size : 0x${heap_size};
 
   /* Read-only sections, merged into text segment: */
@@ -57,6 +66,37 @@ SECTIONS
     KEEP (*(.text.start))
   } >ram0
 
+% if "hot" in regions:
+  /* hot code, before .text to take its input sections: the functions marked
+     __attribute__((hot)) and those listed in hot_functions.ld, generated from
+     a PC profile by util/hot_functions.py (empty by default) */
+  .text_hot :
+  {
+    . = ALIGN(${aligns["hot"]});
+    PROVIDE(__xheep_hot_start = .);
+    INCLUDE hot_functions.ld
+    *(.text.hot .text.hot.*)
+    *(.xheep_hot)
+    . = ALIGN(4);
+    PROVIDE(__xheep_hot_end = .);
+  } >ram${regions["hot"]}
+
+% endif
+% if "cold" in regions:
+  /* cold code, out of the code region: the functions marked
+     __attribute__((cold)) and the exit code */
+  .text_cold :
+  {
+    . = ALIGN(${aligns["cold"]});
+    PROVIDE(__xheep_cold_start = .);
+    *(.text.unlikely .text.*_unlikely .text.unlikely.*)
+    *(.text.exit .text.exit.*)
+    *(.xheep_cold)
+    . = ALIGN(4);
+    PROVIDE(__xheep_cold_end = .);
+  } >ram${regions["cold"]}
+
+% endif
 
   /* the bulk of the program: main, libc, functions etc. */
   .text           :
@@ -66,6 +106,8 @@ SECTIONS
     *(.text.startup .text.startup.*)
     *(.text.hot .text.hot.*)
     *(.text .stub .text.* .gnu.linkonce.t.*)
+    *(.ram_text .ram_text.*) /* RAM_FUNC functions, already in RAM */
+    *(.overlay*)             /* overlays (see overlay.h), resident */
     /* .gnu.warning sections are handled specially by elf32.em.  */
     *(.gnu.warning)
   } >ram0
@@ -76,6 +118,12 @@ SECTIONS
      . += 256;
   } >ram0
 
+  /* warm boot record (see warm_boot.h), kept over a reset, never loaded nor zeroed */
+  .warm_boot (NOLOAD) : ALIGN(4)
+  {
+     KEEP(*(.warm_boot))
+  } >ram0
+
   /* not used by RISC-V*/
   .fini           :
   {
@@ -90,12 +138,21 @@ SECTIONS
   .rodata         :
   {
     *(.rodata .rodata.* .gnu.linkonce.r.*)
+    *(.ram_rodata .ram_rodata.*) /* RAM_RODATA constants, already in RAM */
   } >ram1
   .rodata1        :
   {
     *(.rodata1)
   } >ram1
 
+  /* gcov_info of the objects built with make app PGO=generate, serialised at exit (see gcov_dump.h) */
+  .gcov_info      :
+  {
+    PROVIDE (__gcov_info_start = .);
+    KEEP (*(.gcov_info))
+    PROVIDE (__gcov_info_end = .);
+  } >ram1
+
   /* second level sbss and sdata, I don't think we need this */
   /* .sdata2         : {*(.sdata2 .sdata2.* .gnu.linkonce.s2.*)} */
   /* .sbss2          : { *(.sbss2 .sbss2.* .gnu.linkonce.sb2.*) } */
@@ -281,24 +338,39 @@ SECTIONS
    PROVIDE(__heap_end = .);
   } >ram1
 
-  /* stack: we should consider putting this further to the top of the address
-    space */
-  .stack         : ALIGN(16) /* this is a requirement of the ABI(?) */
+  /* stack: at the end of the data, or alone in the stack section so that the
+    core does not wait on the data streams of the DMA for its stack */
+  .stack         : ALIGN(${max(16, aligns.get("stack", 16))}) /* this is a requirement of the ABI(?) */
   {
    PROVIDE(__stack_start = .);
    . = __stack_size;
    PROVIDE(_sp = .);
    PROVIDE(__stack_end = .);
    PROVIDE(__freertos_irq_stack_top = .);
-  } >ram1
+% if "stack" in regions:
+   PROVIDE(__xheep_stack_end = .);
+% endif
+  } >ram${regions.get("stack", 1)}
+
+% if num_harts > 1:
+  /* stacks of the extra harts of the cluster, __hart_stack_size each */
+  .hart_stacks   : ALIGN(16)
+  {
+   PROVIDE(__hart_stacks_start = .);
+   . = __hart_stack_size * ${num_harts - 1};
+   PROVIDE(__hart_stacks_end = .);
+  } >ram${regions.get("stack", 1)}
+% endif
 
 % for i, section in enumerate(xheep.iter_linker_sections()):
-% if not section.name in ["code", "data"]:
+% if not section.name in ["code", "data", "hot", "cold", "stack"]:
   .${section.name} :
   {
-    . = ALIGN(4);
+    . = ALIGN(${section.align});
+    PROVIDE(__xheep_${section.name}_start = .);
     *(.xheep_${section.name})
-    . = ALIGN(4);
+    . = ALIGN(${section.align});
+    PROVIDE(__xheep_${section.name}_end = .);
   } >ram${i}
 % endif
 % endfor
@@ -311,6 +383,9 @@ SECTIONS
   .stab.index    0 : { *(.stab.index) }
   .stab.indexstr 0 : { *(.stab.indexstr) }
   .comment       0 : { *(.comment) }
+  /* Format strings of the deferred logs (see dlog.h), not loaded. Their
+     offsets from 0 are the IDs stored in the logs. */
+  .dlog_fmt      0 (INFO) : { KEEP (*(.dlog_fmt)) }
   /* DWARF debug sections.
      Symbols in the DWARF debugging sections are relative to the beginning
      of the section so we begin them at 0.  */
@@ -0,0 +1,434 @@
+/* Script for -z combreloc: combine and sort reloc sections */
+/* Copyright (C) 2014-2018 Free Software Foundation, Inc.
+   Copyright (C) 2019 ETH Zürich and University of Bologna
+   Copying and distribution of this script, with or without modification,
+   are permitted in any medium without royalty provided the copyright
+   notice and this notice are preserved.  */
+
+/* This linker script is derived from the default linker script of the RISC-V
+   gcc compiler. We have made a few changes to make it suitable for linking bare
+   metal programs. These are mostly removing dynamic linking related sections and
+   putting sections into our memory regions. */
+
+/* Execute-in-place variant (LINKER=ext_exec): the code runs from the upper half
+   of the external slave region, ext_systemc1 in the SystemC testbench, which
+   preloads it from the ELF (see SystemC.md). The vectors, the crt0, the RAM_FUNC
+   functions, the constants and the data stay in the on-chip RAM, so that the
+   external memory only serves instruction fetches. */
+
+OUTPUT_FORMAT("elf32-littleriscv", "elf32-littleriscv",
+        "elf32-littleriscv")
+OUTPUT_ARCH(riscv)
+ENTRY(_start)
+
+MEMORY
+{
+  /* Our testbench is a bit weird in that we initialize the RAM (thus
+     allowing initialized sections to be placed there). Infact we dump all
+     sections to ram. */
+  % for i, section in enumerate(xheep.iter_linker_sections()):
+    ram${i} (rwxai) : ORIGIN = ${f"{section.start:#08x}"}, LENGTH = ${f"{section.size:#08x}"}
+% endfor
+    ext (rx)        : ORIGIN = ${f"{int(ext_slave_start_address,16) + int(ext_slave_size_address,16)//2:#08x}"}, LENGTH = ${f"{int(ext_slave_size_address,16)//2:#08x}"}
+}
+
+/*
+ * This linker script puts the code in ext and the data in ram1. The hot code,
+ * the cold code and the stack go to the linker sections named hot, cold and
+ * stack when there are, so that the hot functions can be kept on chip.
+*/
+<%
+  regions = {section.name: i for i, section in enumerate(xheep.iter_linker_sections())}
+  aligns = {section.name: section.align for section in xheep.iter_linker_sections()}
+%>
+
+SECTIONS
+{
+  /* we want a fixed entry point */
+  PROVIDE(__boot_address = 0x180);
+
+  /* stack and heap related settings */
+  __stack_size = DEFINED(__stack_size) ? __stack_size : 0x${stack_size};
+  PROVIDE(__stack_size = __stack_size);
+% if num_harts > 1:
+  __hart_stack_size = DEFINED(__hart_stack_size) ? __hart_stack_size : 0x${hart_stack_size};
+  PROVIDE(__hart_stack_size = __hart_stack_size);
+% endif
+  __heap_size = DEFINED(__heap_size) ? __heap_size : 0x${heap_size};
+
+  /* Read-only sections, merged into text segment: */
+  PROVIDE (__executable_start = SEGMENT_START("text-segment", 0x10000)); . = SEGMENT_START("text-segment", 0x10000) + SIZEOF_HEADERS;
+
+  /* interrupt vectors */
+  .vectors (ORIGIN(ram0)):
+  {
+    PROVIDE(__vector_start = .);
+    KEEP(*(.vectors));
+  } >ram0
+
+  /* crt0 init code */
+  .init (__boot_address):
+  {
+    KEEP (*(SORT_NONE(.init)))
+    KEEP (*(.text.start))
+  } >ram0
+
+% if "hot" in regions:
+  /* hot code, before .text to take its input sections: the functions marked
+     __attribute__((hot)) and those listed in hot_functions.ld, generated from
+     a PC profile by util/hot_functions.py (empty by default) */
+  .text_hot :
+  {
+    . = ALIGN(${aligns["hot"]});
+    PROVIDE(__xheep_hot_start = .);
+    INCLUDE hot_functions.ld
+    *(.text.hot .text.hot.*)
+    *(.xheep_hot)
+    . = ALIGN(4);
+    PROVIDE(__xheep_hot_end = .);
+  } >ram${regions["hot"]}
+
+% endif
+% if "cold" in regions:
+  /* cold code, out of the code region: the functions marked
+     __attribute__((cold)) and the exit code */
+  .text_cold :
+  {
+    . = ALIGN(${aligns["cold"]});
+    PROVIDE(__xheep_cold_start = .);
+    *(.text.unlikely .text.*_unlikely .text.unlikely.*)
+    *(.text.exit .text.exit.*)
+    *(.xheep_cold)
+    . = ALIGN(4);
+    PROVIDE(__xheep_cold_end = .);
+  } >ram${regions["cold"]}
+
+% endif
+
+  /* RAM_FUNC functions (see ram_func.h), loaded on chip with the data */
+  .ram_text       :
+  {
+    *(.ram_text .ram_text.*)
+  } >ram0
+
+  /* the bulk of the program: main, libc, functions etc., in the external memory */
+  .text           :
+  {
+    *(.text.unlikely .text.*_unlikely .text.unlikely.*)
+    *(.text.exit .text.exit.*)
+    *(.text.startup .text.startup.*)
+    *(.text.hot .text.hot.*)
+    *(.text .stub .text.* .gnu.linkonce.t.*)
+    *(.overlay*) /* overlays (see overlay.h), resident */
+    /* .gnu.warning sections are handled specially by elf32.em.  */
+    *(.gnu.warning)
+  } >ext
+
+  .power_manager : ALIGN(4096)
+  {
+     PROVIDE(__power_manager_start = .);
+     . += 256;
+  } >ram0
+
+  /* warm boot record (see warm_boot.h), kept over a reset, never loaded nor zeroed */
+  .warm_boot (NOLOAD) : ALIGN(4)
+  {
+     KEEP(*(.warm_boot))
+  } >ram0
+
+  /* not used by RISC-V*/
+  .fini           :
+  {
+    KEEP (*(SORT_NONE(.fini)))
+  } >ext
+
+  PROVIDE (__etext = .);
+  PROVIDE (_etext = .);
+  PROVIDE (etext = .);
+
+  /* read-only sections */
+  .rodata         :
+  {
+    *(.rodata .rodata.* .gnu.linkonce.r.*)
+    *(.ram_rodata .ram_rodata.*) /* RAM_RODATA constants, already in RAM */
+  } >ram1
+  .rodata1        :
+  {
+    *(.rodata1)
+  } >ram1
+
+  /* gcov_info of the objects built with make app PGO=generate, serialised at exit (see gcov_dump.h) */
+  .gcov_info      :
+  {
+    PROVIDE (__gcov_info_start = .);
+    KEEP (*(.gcov_info))
+    PROVIDE (__gcov_info_end = .);
+  } >ram1
+
+  /* second level sbss and sdata, I don't think we need this */
+  /* .sdata2         : {*(.sdata2 .sdata2.* .gnu.linkonce.s2.*)} */
+  /* .sbss2          : { *(.sbss2 .sbss2.* .gnu.linkonce.sb2.*) } */
+
+  /* gcc language agnostic exception related sections (try-catch-finally) */
+  .eh_frame_hdr :
+  {
+    *(.eh_frame_hdr) *(.eh_frame_entry .eh_frame_entry.*)
+  } >ram0
+  .eh_frame       : ONLY_IF_RO
+  {
+    KEEP (*(.eh_frame)) *(.eh_frame.*)
+  } >ram0
+  .gcc_except_table   : ONLY_IF_RO
+  {
+    *(.gcc_except_table .gcc_except_table.*)
+  } >ram0
+  .gnu_extab   : ONLY_IF_RO
+  {
+    *(.gnu_extab*)
+  } >ram0
+  /* These sections are generated by the Sun/Oracle C++ compiler.  */
+  /*
+  .exception_ranges   : ONLY_IF_RO { *(.exception_ranges
+  .exception_ranges*) }
+  */
+  /* Adjust the address for the data segment.  We want to adjust up to
+     the same address within the page on the next page up.  */
+  . = DATA_SEGMENT_ALIGN (CONSTANT (MAXPAGESIZE), CONSTANT (COMMONPAGESIZE));
+
+  /* Exception handling  */
+  .eh_frame       : ONLY_IF_RW
+  {
+    KEEP (*(.eh_frame)) *(.eh_frame.*)
+  } >ram0
+  .gnu_extab      : ONLY_IF_RW
+  {
+    *(.gnu_extab)
+  } >ram0
+  .gcc_except_table   : ONLY_IF_RW
+  {
+    *(.gcc_except_table .gcc_except_table.*)
+  } >ram0
+  .exception_ranges   : ONLY_IF_RW
+  {
+    *(.exception_ranges .exception_ranges*)
+  } >ram0
+
+  /* Thread Local Storage sections  */
+  .tdata    :
+  {
+    PROVIDE_HIDDEN (__tdata_start = .);
+    *(.tdata .tdata.* .gnu.linkonce.td.*)
+  } >ram1
+  .tbss     :
+  {
+    *(.tbss .tbss.* .gnu.linkonce.tb.*) *(.tcommon)
+  } >ram1
+
+  /* initialization and termination routines */
+  .preinit_array     :
+  {
+    PROVIDE_HIDDEN (__preinit_array_start = .);
+    KEEP (*(.preinit_array))
+    PROVIDE_HIDDEN (__preinit_array_end = .);
+  } >ram1
+  .init_array     :
+  {
+    PROVIDE_HIDDEN (__init_array_start = .);
+    KEEP (*(SORT_BY_INIT_PRIORITY(.init_array.*) SORT_BY_INIT_PRIORITY(.ctors.*)))
+    KEEP (*(.init_array EXCLUDE_FILE (*crtbegin.o *crtbegin?.o *crtend.o *crtend?.o ) .ctors))
+    PROVIDE_HIDDEN (__init_array_end = .);
+  } >ram1
+  .fini_array     :
+  {
+    PROVIDE_HIDDEN (__fini_array_start = .);
+    KEEP (*(SORT_BY_INIT_PRIORITY(.fini_array.*) SORT_BY_INIT_PRIORITY(.dtors.*)))
+    KEEP (*(.fini_array EXCLUDE_FILE (*crtbegin.o *crtbegin?.o *crtend.o *crtend?.o ) .dtors))
+    PROVIDE_HIDDEN (__fini_array_end = .);
+  } >ram1
+  .ctors          :
+  {
+    /* gcc uses crtbegin.o to find the start of
+       the constructors, so we make sure it is
+       first.  Because this is a wildcard, it
+       doesn't matter if the user does not
+       actually link against crtbegin.o; the
+       linker won't look for a file to match a
+       wildcard.  The wildcard also means that it
+       doesn't matter which directory crtbegin.o
+       is in.  */
+    KEEP (*crtbegin.o(.ctors))
+    KEEP (*crtbegin?.o(.ctors))
+    /* We don't want to include the .ctor section from
+       the crtend.o file until after the sorted ctors.
+       The .ctor section from the crtend file contains the
+       end of ctors marker and it must be last */
+    KEEP (*(EXCLUDE_FILE (*crtend.o *crtend?.o ) .ctors))
+    KEEP (*(SORT(.ctors.*)))
+    KEEP (*(.ctors))
+  } >ram0
+  .dtors          :
+  {
+    KEEP (*crtbegin.o(.dtors))
+    KEEP (*crtbegin?.o(.dtors))
+    KEEP (*(EXCLUDE_FILE (*crtend.o *crtend?.o ) .dtors))
+    KEEP (*(SORT(.dtors.*)))
+    KEEP (*(.dtors))
+  } >ram0
+
+  /* .jcr            : { KEEP (*(.jcr)) } */
+  /* .data.rel.ro : { *(.data.rel.ro.local* .gnu.linkonce.d.rel.ro.local.*) *(.data.rel.ro .data.rel.ro.* .gnu.linkonce.d.rel.ro.*) } */
+  /* .dynamic        : { *(.dynamic) } */
+  . = DATA_SEGMENT_RELRO_END (0, .);
+
+  /* data sections for initalized data */
+  .data           :
+  {
+    __DATA_BEGIN__ = .;
+    *(.data .data.* .gnu.linkonce.d.*)
+    SORT(CONSTRUCTORS)
+  } >ram1
+  .data1          :
+  {
+    *(.data1)
+  } >ram1
+
+  _lma_vma_data_offset = 0x0;
+
+  /* no dynamic linking, no object tables required */
+  /* .got            : { *(.got.plt) *(.igot.plt) *(.got) *(.igot) } */
+
+  /* We want the small data sections together, so single-instruction offsets
+     can access them all, and initialized data all before uninitialized, so
+     we can shorten the on-disk segment size.  */
+  .sdata          :
+  {
+    __SDATA_BEGIN__ = .;
+    *(.srodata.cst16) *(.srodata.cst8) *(.srodata.cst4) *(.srodata.cst2) *(.srodata .srodata.*)
+    *(.sdata .sdata.* .gnu.linkonce.s.*)
+  } >ram1
+  _edata = .; PROVIDE (edata = .);
+  . = .;
+
+  /* zero initialized sections */
+  __bss_start = .;
+  .sbss           :
+  {
+    *(.dynsbss)
+    *(.sbss .sbss.* .gnu.linkonce.sb.*)
+    *(.scommon)
+  } >ram1
+  .bss            :
+  {
+   *(.dynbss)
+   *(.bss .bss.* .gnu.linkonce.b.*)
+   *(COMMON)
+   /* Align here to ensure that the .bss section occupies space up to
+      _end.  Align after .bss to ensure correct alignment even if the
+      .bss section disappears because there are no input sections.
+      FIXME: Why do we need it? When there is no .bss section, we don't
+      pad the .data section.  */
+   . = ALIGN(. != 0 ? 32 / 8 : 1);
+  } >ram1
+  . = ALIGN(32 / 8);
+  . = SEGMENT_START("ldata-segment", .);
+  . = ALIGN(32 / 8);
+  __BSS_END__ = .;
+  __bss_end = .;
+
+  /* The compiler uses this to access data in the .sdata, .data, .sbss and .bss
+     sections with fewer instructions (relaxation). This reduces code size. */
+    __global_pointer$ = MIN(__SDATA_BEGIN__ + 0x800,
+          MAX(__DATA_BEGIN__ + 0x800, __BSS_END__ - 0x800));
+  _end = .; PROVIDE (end = .);
+  . = DATA_SEGMENT_END (.);
+
+  /* heap: we should consider putting this to the bottom of the address space */
+  .heap          :
+  {
+   PROVIDE(__heap_start = .);
+   . = __heap_size;
+   PROVIDE(__heap_end = .);
+  } >ram1
+
+  /* stack: at the end of the data, or alone in the stack section so that the
+    core does not wait on the data streams of the DMA for its stack */
+  .stack         : ALIGN(${max(16, aligns.get("stack", 16))}) /* this is a requirement of the ABI(?) */
+  {
+   PROVIDE(__stack_start = .);
+   . = __stack_size;
+   PROVIDE(_sp = .);
+   PROVIDE(__stack_end = .);
+   PROVIDE(__freertos_irq_stack_top = .);
+% if "stack" in regions:
+   PROVIDE(__xheep_stack_end = .);
+% endif
+  } >ram${regions.get("stack", 1)}
+
+% if num_harts > 1:
+  /* stacks of the extra harts of the cluster, __hart_stack_size each */
+  .hart_stacks   : ALIGN(16)
+  {
+   PROVIDE(__hart_stacks_start = .);
+   . = __hart_stack_size * ${num_harts - 1};
+   PROVIDE(__hart_stacks_end = .);
+  } >ram${regions.get("stack", 1)}
+% endif
+
+% for i, section in enumerate(xheep.iter_linker_sections()):
+% if not section.name in ["code", "data", "hot", "cold", "stack"]:
+  .${section.name} :
+  {
+    . = ALIGN(${section.align});
+    PROVIDE(__xheep_${section.name}_start = .);
+    *(.xheep_${section.name})
+    . = ALIGN(${section.align});
+    PROVIDE(__xheep_${section.name}_end = .);
+  } >ram${i}
+% endif
+% endfor
+
+  /* Stabs debugging sections.  */
+  .stab          0 : { *(.stab) }
+  .stabstr       0 : { *(.stabstr) }
+  .stab.excl     0 : { *(.stab.excl) }
+  .stab.exclstr  0 : { *(.stab.exclstr) }
+  .stab.index    0 : { *(.stab.index) }
+  .stab.indexstr 0 : { *(.stab.indexstr) }
+  .comment       0 : { *(.comment) }
+  /* Format strings of the deferred logs (see dlog.h), not loaded. Their
+     offsets from 0 are the IDs stored in the logs. */
+  .dlog_fmt      0 (INFO) : { KEEP (*(.dlog_fmt)) }
+  /* DWARF debug sections.
+     Symbols in the DWARF debugging sections are relative to the beginning
+     of the section so we begin them at 0.  */
+  /* DWARF 1 */
+  .debug          0 : { *(.debug) }
+  .line           0 : { *(.line) }
+  /* GNU DWARF 1 extensions */
+  .debug_srcinfo  0 : { *(.debug_srcinfo) }
+  .debug_sfnames  0 : { *(.debug_sfnames) }
+  /* DWARF 1.1 and DWARF 2 */
+  .debug_aranges  0 : { *(.debug_aranges) }
+  .debug_pubnames 0 : { *(.debug_pubnames) }
+  /* DWARF 2 */
+  .debug_info     0 : { *(.debug_info .gnu.linkonce.wi.*) }
+  .debug_abbrev   0 : { *(.debug_abbrev) }
+  .debug_line     0 : { *(.debug_line .debug_line.* .debug_line_end ) }
+  .debug_frame    0 : { *(.debug_frame) }
+  .debug_str      0 : { *(.debug_str) }
+  .debug_loc      0 : { *(.debug_loc) }
+  .debug_macinfo  0 : { *(.debug_macinfo) }
+  /* SGI/MIPS DWARF 2 extensions */
+  .debug_weaknames 0 : { *(.debug_weaknames) }
+  .debug_funcnames 0 : { *(.debug_funcnames) }
+  .debug_typenames 0 : { *(.debug_typenames) }
+  .debug_varnames  0 : { *(.debug_varnames) }
+  /* DWARF 3 */
+  .debug_pubtypes 0 : { *(.debug_pubtypes) }
+  .debug_ranges   0 : { *(.debug_ranges) }
+  /* DWARF Extension.  */
+  .debug_macro    0 : { *(.debug_macro) }
+  .debug_addr     0 : { *(.debug_addr) }
+  .gnu.attributes 0 : { KEEP (*(.gnu.attributes)) }
+  /DISCARD/ : { *(.note.GNU-stack) *(.gnu_debuglink) *(.gnu.lto_*) }
+}
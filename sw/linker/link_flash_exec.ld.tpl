@@ -19,6 +19,10 @@ SECTIONS {
     /* stack and heap related settings */
     __stack_size = DEFINED(__stack_size) ? __stack_size : 0x${stack_size};
     PROVIDE(__stack_size = __stack_size);
+% if num_harts > 1:
+    __hart_stack_size = DEFINED(__hart_stack_size) ? __hart_stack_size : 0x${hart_stack_size};
+    PROVIDE(__hart_stack_size = __hart_stack_size);
+% endif
     __heap_size = DEFINED(__heap_size) ? __heap_size : 0x${heap_size};
 
     /* interrupt vectors */
@@ -35,6 +39,22 @@ SECTIONS {
 	KEEP (*(.text.start))
     } >FLASH
 
+    /* Constants marked with RAM_RODATA (see ram_func.h) and those listed in
+    hot_rodata.ld, generated from a bus trace by util/hot_rodata.py (empty by
+    default), are read from RAM: the startup copies them like the RAM_FUNC
+    functions. Before .text to take their input sections. */
+    .ram_rodata :
+    {
+        . = ALIGN(4);
+        _siram_rodata = LOADADDR(.ram_rodata);
+        _sram_rodata = .;
+        *(.ram_rodata)
+        *(.ram_rodata*)
+        INCLUDE hot_rodata.ld
+        . = ALIGN(4);
+        _eram_rodata = .;
+    } >RAM AT >FLASH
+
     /* The program code and other data goes into FLASH */
     .text :
     {
@@ -46,9 +66,51 @@ SECTIONS {
         *(.srodata)        /* .rodata sections (constants, strings, etc.) */
         *(.srodata*)       /* .rodata* sections (constants, strings, etc.) */
         . = ALIGN(4);
+        __gcov_info_start = .;
+        KEEP(*(.gcov_info)) /* gcov_info of make app PGO=generate (see gcov_dump.h) */
+        __gcov_info_end = .;
+        . = ALIGN(4);
         _etext = .;        /* define a global symbol at end of code */
     } >FLASH
 
+    /* Functions marked with RAM_FUNC (see ram_func.h) run from RAM: the loader
+    puts them in the FLASH and the startup copies them to RAM with the DMA,
+    like the initialized data below. */
+    .ram_text :
+    {
+        . = ALIGN(4);
+        _siram_text = LOADADDR(.ram_text);
+        _sram_text = .;
+        *(.ram_text)
+        *(.ram_text*)
+        . = ALIGN(4);
+        _eram_text = .;
+    } >RAM AT >FLASH
+
+    /* Overlays (see overlay.h): the overlays of a region share its RAM, and
+    overlay_load() copies one of them from the FLASH with the DMA before its
+    functions are called. NOCROSSREFS rejects the direct calls between two
+    overlays of a region. */
+% for r in range(2):
+    OVERLAY : NOCROSSREFS
+    {
+% for i in range(r * 4, r * 4 + 4):
+        .overlay${i} { *(.overlay${i}) *(.overlay${i}.*) . = ALIGN(4); }
+% endfor
+    } >RAM AT >FLASH
+
+% endfor
+    /* The FLASH start and end and the RAM start of each overlay, for
+    overlay_load() */
+    .overlay_table :
+    {
+        . = ALIGN(4);
+        __overlay_table = .;
+% for i in range(8):
+        LONG(__load_start_overlay${i}) LONG(__load_stop_overlay${i}) LONG(ADDR(.overlay${i}))
+% endfor
+    } >FLASH
+
     /* This is the initialized data section
     The program executes knowing that the data is in the RAM
     but the loader puts the initial values in the FLASH (inidata).
@@ -78,6 +140,12 @@ SECTIONS {
        . += 256;
     } >RAM
 
+    /* warm boot record (see warm_boot.h), kept over a reset, never loaded nor zeroed */
+    .warm_boot (NOLOAD) : ALIGN(4)
+    {
+       KEEP(*(.warm_boot))
+    } >RAM
+
     /* Uninitialized data section */
     .bss :
     {
@@ -117,4 +185,18 @@ SECTIONS {
    PROVIDE(__stack_end = .);
    PROVIDE(__freertos_irq_stack_top = .);
   } >RAM
+
+% if num_harts > 1:
+  /* stacks of the extra harts of the cluster, __hart_stack_size each */
+  .hart_stacks   : ALIGN(16)
+  {
+   PROVIDE(__hart_stacks_start = .);
+   . = __hart_stack_size * ${num_harts - 1};
+   PROVIDE(__hart_stacks_end = .);
+  } >RAM
+% endif
+
+    /* Format strings of the deferred logs (see dlog.h), not loaded. Their
+       offsets from 0 are the IDs stored in the logs. */
+    .dlog_fmt 0 (INFO) : { KEEP(*(.dlog_fmt)) }
 }
@@ -26,6 +26,10 @@ SECTIONS {
     /* stack and heap related settings */
     __stack_size = DEFINED(__stack_size) ? __stack_size : 0x${stack_size};
     PROVIDE(__stack_size = __stack_size);
+% if num_harts > 1:
+    __hart_stack_size = DEFINED(__hart_stack_size) ? __hart_stack_size : 0x${hart_stack_size};
+    PROVIDE(__hart_stack_size = __hart_stack_size);
+% endif
     __heap_size = DEFINED(__heap_size) ? __heap_size : 0x${heap_size};
 
     /* interrupt vectors */
@@ -61,6 +65,9 @@ SECTIONS {
         KEEP (*(.text.spi_read_word*))
         KEEP (*(.text.memcpy))
         KEEP (*(.text.w25q128jw_read_standard*)) /* as this function is used in the crt0, link it in the top, should be before 1024 Bytes loaded by the bootrom */
+        KEEP (*(.text.w25q128jw_load_quad_dma_crt0*)) /* used instead with FLASH_LOAD_DMA */
+        KEEP (*(.text.w25q128jw_load_lz_crt0*)) /* used instead with FLASH_LOAD_LZ */
+        KEEP (*(.text.w25q128jw_checksum*))
         *(.xheep_init_data_crt0) /* this global variables are used in the crt0 */
     } >ram0 AT >FLASH0
 
@@ -71,11 +78,18 @@ SECTIONS {
         __text_start = .; /* define a global symbol at data end; used by startup code in order to initialise the .data section in RAM */
         *(.text)           /* .text sections (code) */
         *(.text*)          /* .text* sections (code) */
+        *(.ram_text*)      /* RAM_FUNC functions, the whole code is copied to RAM anyway */
+        *(.overlay*)       /* overlays (see overlay.h), resident as well */
         *(.rodata)         /* .rodata sections (constants, strings, etc.) */
         *(.rodata*)        /* .rodata* sections (constants, strings, etc.) */
+        *(.ram_rodata*)    /* RAM_RODATA constants, copied to RAM with the code */
         *(.srodata)        /* .rodata sections (constants, strings, etc.) */
         *(.srodata*)       /* .rodata* sections (constants, strings, etc.) */
         . = ALIGN(4);
+        __gcov_info_start = .;
+        KEEP(*(.gcov_info)) /* gcov_info of make app PGO=generate (see gcov_dump.h) */
+        __gcov_info_end = .;
+        . = ALIGN(4);
         _etext = .;        /* define a global symbol at end of code */
     } >ram0 AT >FLASH0
 
@@ -125,6 +139,13 @@ SECTIONS {
         __BSS_END__ = .;
     } >ram1 AT >FLASH1
 
+    /* warm boot record (see warm_boot.h), kept over a reset, never loaded nor zeroed,
+       after .bss so that the loaded sections stay contiguous in flash */
+    .warm_boot (NOLOAD) : ALIGN(4)
+    {
+       KEEP(*(.warm_boot))
+    } >ram1
+
     _lma_data_end = _lma_data_start + SIZEOF(.data) + SIZEOF(.power_manager) + SIZEOF(.bss);
     _lma_vma_data_offset = _lma_data_start - __data_start;
 
@@ -145,8 +166,11 @@ SECTIONS {
         PROVIDE(__heap_end = .);
     } >ram1
 
-    /* stack: we should consider putting this further to the top of the address
-    space */
+    /* stack: at the end of the data, or alone in the stack section */
+<%
+  names = [section.name for section in xheep.iter_linker_sections()]
+  stack_region = names.index("stack") if "stack" in names else 1
+%>
     .stack         : ALIGN(16) /* this is a requirement of the ABI(?) */
     {
        PROVIDE(__stack_start = .);
@@ -154,17 +178,27 @@ SECTIONS {
        PROVIDE(_sp = .);
        PROVIDE(__stack_end = .);
        PROVIDE(__freertos_irq_stack_top = .);
-    } >ram1
+    } >ram${stack_region}
+
+% if num_harts > 1:
+    /* stacks of the extra harts of the cluster, __hart_stack_size each */
+    .hart_stacks   : ALIGN(16)
+    {
+       PROVIDE(__hart_stacks_start = .);
+       . = __hart_stack_size * ${num_harts - 1};
+       PROVIDE(__hart_stacks_end = .);
+    } >ram${stack_region}
+% endif
 
   % for i, section in enumerate(xheep.iter_linker_sections()):
-  % if not section.name in ["code", "data"]:
+  % if not section.name in ["code", "data", "stack"]:
     .${section.name} : ALIGN_WITH_INPUT
     {
         PROVIDE(__${section.name}_start = .);
         _lma_${section.name}_start = LOADADDR(.${section.name});
-        . = ALIGN(4);
+        . = ALIGN(${section.align});
         *(.xheep_${section.name})
-        . = ALIGN(4);
+        . = ALIGN(${section.align});
     } >ram${i} AT >FLASH${i}
 
    . = ALIGN(4);
@@ -181,4 +215,7 @@ SECTIONS {
         . = ALIGN(4);
     } >FLASH_left
 
+    /* Format strings of the deferred logs (see dlog.h), not loaded. Their
+       offsets from 0 are the IDs stored in the logs. */
+    .dlog_fmt 0 (INFO) : { KEEP(*(.dlog_fmt)) }
 }
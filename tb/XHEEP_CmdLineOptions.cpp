@@ -1,6 +1,9 @@
 #include "XHEEP_CmdLineOptions.hh"
+#include "XHEEP_FirmwareLoader.hh"
 #include <iostream>
 #include <string>
+#include <fstream>
+#include <thread>
 
 XHEEP_CmdLineOptions::XHEEP_CmdLineOptions(int argc, char* argv[]) // define default constructor
 {
@@ -57,24 +60,64 @@ std::string XHEEP_CmdLineOptions::get_firmware()
 }
 
 
-unsigned int XHEEP_CmdLineOptions::get_max_sim_time(bool& run_all)
+uint64_t XHEEP_CmdLineOptions::get_max_sim_time(bool& run_all)
 {
 
   std::string arg_max_sim_time = this->getCmdOption(this->argc, this->argv, "+max_sim_time=");
-  unsigned int max_sim_time;
+  uint64_t max_sim_time;
 
   max_sim_time     = 0;
   if(arg_max_sim_time.empty()){
     std::cout<<"[TESTBENCH]: No Max time specified"<<std::endl;
     run_all = true;
   } else {
-    max_sim_time = stoi(arg_max_sim_time);
+    max_sim_time = stoull(arg_max_sim_time);
     std::cout<<"[TESTBENCH]: Max Times is  "<<max_sim_time<<std::endl;
   }
 
   return max_sim_time;
 }
 
+// Upper bound of the simulated cycles, also when running until the exit
+uint64_t XHEEP_CmdLineOptions::get_max_cycles()
+{
+  std::string arg_max_cycles = this->getCmdOption(this->argc, this->argv, "+max_cycles=");
+  uint64_t max_cycles = UINT64_MAX;
+
+  if(!arg_max_cycles.empty()){
+    max_cycles = stoull(arg_max_cycles);
+    std::cout<<"[TESTBENCH]: The simulation stops after "<<max_cycles<<" cycles"<<std::endl;
+  }
+
+  return max_cycles;
+}
+
+double XHEEP_CmdLineOptions::get_heartbeat()
+{
+  std::string arg_heartbeat = this->getCmdOption(this->argc, this->argv, "+heartbeat=");
+  double heartbeat = 0;
+
+  if(!arg_heartbeat.empty()){
+    heartbeat = stod(arg_heartbeat);
+    std::cout<<"[TESTBENCH]: Printing the simulation progress every "<<heartbeat<<" s"<<std::endl;
+  }
+
+  return heartbeat;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_hang_cycles()
+{
+  std::string arg_hang_cycles = this->getCmdOption(this->argc, this->argv, "+hang_cycles=");
+  uint64_t hang_cycles = 0;
+
+  if(!arg_hang_cycles.empty()){
+    hang_cycles = stoull(arg_hang_cycles);
+    std::cout<<"[TESTBENCH]: The simulation stops after "<<hang_cycles<<" cycles without progress"<<std::endl;
+  }
+
+  return hang_cycles;
+}
+
 unsigned int XHEEP_CmdLineOptions::get_boot_sel()
 {
   std::string arg_boot_sel = this->getCmdOption(this->argc, this->argv, "+boot_sel=");
@@ -98,3 +141,939 @@ unsigned int XHEEP_CmdLineOptions::get_boot_sel()
 
   return boot_sel;
 }
+
+bool XHEEP_CmdLineOptions::get_execute_from_flash()
+{
+  std::string arg_execute = this->getCmdOption(this->argc, this->argv, "+execute_from_flash=");
+  bool execute_from_flash = arg_execute.compare("0") != 0;
+
+  if(execute_from_flash) {
+    std::cout<<"[TESTBENCH]: Executing from flash"<<std::endl;
+  } else {
+    std::cout<<"[TESTBENCH]: Copying the firmware from flash to RAM"<<std::endl;
+  }
+
+  return execute_from_flash;
+}
+
+std::string XHEEP_CmdLineOptions::get_flash_image()
+{
+  std::string flash_image = this->getCmdOption(this->argc, this->argv, "+flash_image=");
+
+  if(!flash_image.empty()){
+    std::cout<<"[TESTBENCH]: Preloading the boot flash with "<<flash_image<<std::endl;
+  }
+
+  return flash_image;
+}
+
+trace_mode_t XHEEP_CmdLineOptions::get_trace_mode()
+{
+  std::string arg_trace = this->getCmdOption(this->argc, this->argv, "+trace=");
+  trace_mode_t trace_mode = TRACE_FULL;
+
+  if(arg_trace.empty() || arg_trace.compare("full") == 0){
+    std::cout<<"[TESTBENCH]: Tracing every cycle"<<std::endl;
+    trace_mode = TRACE_FULL;
+  } else if(arg_trace.compare("off") == 0) {
+    std::cout<<"[TESTBENCH]: Tracing disabled"<<std::endl;
+    trace_mode = TRACE_OFF;
+  } else if(arg_trace.compare("window") == 0) {
+    std::cout<<"[TESTBENCH]: Tracing a cycle window"<<std::endl;
+    trace_mode = TRACE_WINDOW;
+  } else if(arg_trace.compare("exit") == 0) {
+    std::cout<<"[TESTBENCH]: Tracing triggered on program exit"<<std::endl;
+    trace_mode = TRACE_EXIT;
+  } else if(arg_trace.compare("pc") == 0) {
+    std::cout<<"[TESTBENCH]: Tracing triggered on PC"<<std::endl;
+    trace_mode = TRACE_PC;
+  } else {
+    std::cout<<"[TESTBENCH]: Wrong Trace Option specified (off, full, window, exit, pc) - tracing every cycle"<<std::endl;
+    trace_mode = TRACE_FULL;
+  }
+
+  return trace_mode;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_trace_start()
+{
+  std::string arg_trace_start = this->getCmdOption(this->argc, this->argv, "+trace_start=");
+  uint64_t trace_start = 0;
+
+  if(!arg_trace_start.empty()){
+    trace_start = stoull(arg_trace_start);
+    std::cout<<"[TESTBENCH]: Trace starts at cycle "<<trace_start<<std::endl;
+  }
+
+  return trace_start;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_trace_end()
+{
+  std::string arg_trace_end = this->getCmdOption(this->argc, this->argv, "+trace_end=");
+  uint64_t trace_end = UINT64_MAX;
+
+  if(!arg_trace_end.empty()){
+    trace_end = stoull(arg_trace_end);
+    std::cout<<"[TESTBENCH]: Trace ends at cycle "<<trace_end<<std::endl;
+  }
+
+  return trace_end;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_trace_cycles(uint64_t default_cycles)
+{
+  std::string arg_trace_cycles = this->getCmdOption(this->argc, this->argv, "+trace_cycles=");
+  uint64_t trace_cycles = default_cycles;
+
+  if(!arg_trace_cycles.empty()){
+    trace_cycles = stoull(arg_trace_cycles);
+  }
+  std::cout<<"[TESTBENCH]: Tracing "<<trace_cycles<<" cycles"<<std::endl;
+
+  return trace_cycles;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_trace_pc()
+{
+  std::string arg_trace_pc = this->getCmdOption(this->argc, this->argv, "+trace_pc=");
+  uint32_t trace_pc = 0;
+
+  if(arg_trace_pc.empty()){
+    std::cout<<"[TESTBENCH]: No trace PC specified, using 0x0"<<std::endl;
+  } else {
+    trace_pc = stoul(arg_trace_pc, nullptr, 16);
+    std::cout<<"[TESTBENCH]: Trace triggers at PC 0x"<<std::hex<<trace_pc<<std::dec<<std::endl;
+  }
+
+  return trace_pc;
+}
+
+bool XHEEP_CmdLineOptions::get_startup_pc(uint32_t& startup_pc)
+{
+  std::string arg_startup_pc = this->getCmdOption(this->argc, this->argv, "+startup_pc=");
+
+  if(arg_startup_pc.empty()) return false;
+
+  startup_pc = stoul(arg_startup_pc, nullptr, 16);
+  std::cout<<"[TESTBENCH]: Startup time measured up to the fetch of PC 0x"<<std::hex<<startup_pc<<std::dec<<std::endl;
+  return true;
+}
+
+std::string XHEEP_CmdLineOptions::get_save_checkpoint()
+{
+  std::string checkpoint = this->getCmdOption(this->argc, this->argv, "+save_checkpoint=");
+
+  if(!checkpoint.empty()){
+    std::cout<<"[TESTBENCH]: Saving checkpoint to "<<checkpoint<<std::endl;
+  }
+
+  return checkpoint;
+}
+
+std::string XHEEP_CmdLineOptions::get_restore_checkpoint()
+{
+  std::string checkpoint = this->getCmdOption(this->argc, this->argv, "+restore_checkpoint=");
+
+  if(!checkpoint.empty()){
+    std::cout<<"[TESTBENCH]: Restoring checkpoint from "<<checkpoint<<std::endl;
+  }
+
+  return checkpoint;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_checkpoint_cycle()
+{
+  std::string arg_checkpoint_cycle = this->getCmdOption(this->argc, this->argv, "+checkpoint_cycle=");
+  uint64_t checkpoint_cycle = UINT64_MAX;
+
+  if(arg_checkpoint_cycle.empty()){
+    std::cout<<"[TESTBENCH]: Checkpoint saved once memory is loaded"<<std::endl;
+  } else {
+    checkpoint_cycle = stoull(arg_checkpoint_cycle);
+    std::cout<<"[TESTBENCH]: Checkpoint saved at cycle "<<checkpoint_cycle<<std::endl;
+  }
+
+  return checkpoint_cycle;
+}
+
+bool XHEEP_CmdLineOptions::get_fast_loader(const std::string& firmware)
+{
+  std::string arg_loader = this->getCmdOption(this->argc, this->argv, "+loader=");
+  bool is_hex = XHEEP_FirmwareLoader::is_hex(firmware);
+  bool fast_loader = true;
+
+  if(arg_loader.compare("dpi") == 0) {
+    if(!is_hex) std::cout<<"[TESTBENCH]: The DPI loader only supports .hex files - using the fast loader"<<std::endl;
+    fast_loader = !is_hex;
+  } else if(!arg_loader.empty() && arg_loader.compare("fast") != 0) {
+    std::cout<<"[TESTBENCH]: Wrong Loader Option specified (dpi, fast)"<<std::endl;
+  }
+
+  if(fast_loader) {
+    std::cout<<"[TESTBENCH]: Loading firmware with the fast C++ loader"<<std::endl;
+  } else {
+    std::cout<<"[TESTBENCH]: Loading firmware with tb_loadHEX"<<std::endl;
+  }
+
+  return fast_loader;
+}
+
+std::string XHEEP_CmdLineOptions::get_perf_json()
+{
+  std::string perf_json = this->getCmdOption(this->argc, this->argv, "+perf_json=");
+
+  if(perf_json.empty()){
+    perf_json = "perf_counters.json";
+  }
+  std::cout<<"[TESTBENCH]: Writing performance counters to "<<perf_json<<std::endl;
+
+  return perf_json;
+}
+
+bool XHEEP_CmdLineOptions::get_fast_forward()
+{
+  std::string arg_fast_forward = this->getCmdOption(this->argc, this->argv, "+fast_forward=");
+
+  bool fast_forward = !arg_fast_forward.empty() && arg_fast_forward != "0";
+
+  if(fast_forward){
+    std::cout<<"[TESTBENCH]: Fast-forward of the sleep periods enabled"<<std::endl;
+  }
+
+  return fast_forward;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_fast_forward_idle()
+{
+  std::string arg_fast_forward_idle = this->getCmdOption(this->argc, this->argv, "+fast_forward_idle=");
+  uint64_t fast_forward_idle = 1000;
+
+  if(!arg_fast_forward_idle.empty()){
+    fast_forward_idle = stoull(arg_fast_forward_idle);
+  }
+  std::cout<<"[TESTBENCH]: Fast-forward after "<<fast_forward_idle<<" idle cycles"<<std::endl;
+
+  return fast_forward_idle;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_size()
+{
+  std::string arg_cache_size = this->getCmdOption(this->argc, this->argv, "+cache_size=");
+  uint32_t cache_size = 4*1024;
+
+  if(!arg_cache_size.empty()){
+    cache_size = stoul(arg_cache_size);
+  }
+  std::cout<<"[TESTBENCH]: Cache size "<<cache_size<<" bytes"<<std::endl;
+
+  return cache_size;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_block_size()
+{
+  std::string arg_cache_block_size = this->getCmdOption(this->argc, this->argv, "+cache_block_size=");
+  uint32_t cache_block_size = 16;
+
+  if(!arg_cache_block_size.empty()){
+    cache_block_size = stoul(arg_cache_block_size);
+  }
+  std::cout<<"[TESTBENCH]: Cache block size "<<cache_block_size<<" bytes"<<std::endl;
+
+  return cache_block_size;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_ways()
+{
+  std::string arg_cache_ways = this->getCmdOption(this->argc, this->argv, "+cache_ways=");
+  uint32_t cache_ways = 1;
+
+  if(!arg_cache_ways.empty()){
+    cache_ways = stoul(arg_cache_ways);
+  }
+  std::cout<<"[TESTBENCH]: Cache with "<<cache_ways<<" ways"<<std::endl;
+
+  return cache_ways;
+}
+
+std::string XHEEP_CmdLineOptions::get_cache_policy()
+{
+  std::string cache_policy = this->getCmdOption(this->argc, this->argv, "+cache_policy=");
+
+  if(cache_policy.empty()){
+    cache_policy = "lru";
+  }
+  std::cout<<"[TESTBENCH]: Cache replacement policy "<<cache_policy<<std::endl;
+
+  return cache_policy;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_mem_burst_len()
+{
+  std::string arg_mem_burst_len = this->getCmdOption(this->argc, this->argv, "+mem_burst_len=");
+  uint32_t mem_burst_len = 0;
+
+  if(!arg_mem_burst_len.empty()){
+    mem_burst_len = stoul(arg_mem_burst_len);
+    std::cout<<"[TESTBENCH]: Memory bursts of up to "<<mem_burst_len<<" words"<<std::endl;
+  } else {
+    std::cout<<"[TESTBENCH]: Memory bursts of a whole cache line"<<std::endl;
+  }
+
+  return mem_burst_len;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_mem_beat_latency()
+{
+  std::string arg_mem_beat_latency = this->getCmdOption(this->argc, this->argv, "+mem_beat_latency=");
+  uint32_t mem_beat_latency = 0;
+
+  if(!arg_mem_beat_latency.empty()){
+    mem_beat_latency = stoul(arg_mem_beat_latency);
+  }
+  std::cout<<"[TESTBENCH]: Memory latency of "<<mem_beat_latency<<" ns per word"<<std::endl;
+
+  return mem_beat_latency;
+}
+
+std::string XHEEP_CmdLineOptions::get_mem_profile()
+{
+  std::string mem_profile = this->getCmdOption(this->argc, this->argv, "+mem_profile=");
+
+  if(mem_profile.empty()){
+    mem_profile = "ideal";
+  }
+  std::cout<<"[TESTBENCH]: Memory timing profile "<<mem_profile<<std::endl;
+
+  return mem_profile;
+}
+
+std::string XHEEP_CmdLineOptions::get_mem_tlm()
+{
+  std::string mem_tlm = this->getCmdOption(this->argc, this->argv, "+mem_tlm=");
+
+  if(mem_tlm.empty()){
+    mem_tlm = "blocking";
+  }
+  std::cout<<"[TESTBENCH]: Memory TLM-2 protocol "<<mem_tlm<<std::endl;
+
+  return mem_tlm;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_mem_quantum()
+{
+  std::string arg_mem_quantum = this->getCmdOption(this->argc, this->argv, "+mem_quantum=");
+  uint32_t mem_quantum = 1000;
+
+  if(!arg_mem_quantum.empty()){
+    mem_quantum = stoul(arg_mem_quantum);
+    std::cout<<"[TESTBENCH]: Quantum of the loosely-timed memories of "<<mem_quantum<<" ns"<<std::endl;
+  }
+
+  return mem_quantum;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_mem_size()
+{
+  std::string arg_mem_size = this->getCmdOption(this->argc, this->argv, "+mem_size=");
+  uint64_t mem_size = 32*1024;
+
+  if(!arg_mem_size.empty()){
+    mem_size = stoull(arg_mem_size, nullptr, 0);
+  }
+  std::cout<<"[TESTBENCH]: External memory of "<<mem_size<<" bytes"<<std::endl;
+
+  return mem_size;
+}
+
+std::string XHEEP_CmdLineOptions::get_mem_preload()
+{
+  std::string mem_preload = this->getCmdOption(this->argc, this->argv, "+mem_preload=");
+
+  if(!mem_preload.empty()){
+    std::cout<<"[TESTBENCH]: Preloading the external memory with "<<mem_preload<<std::endl;
+  }
+
+  return mem_preload;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_mem_preload_addr()
+{
+  std::string arg_mem_preload_addr = this->getCmdOption(this->argc, this->argv, "+mem_preload_addr=");
+  uint64_t mem_preload_addr = 0;
+
+  if(!arg_mem_preload_addr.empty()){
+    mem_preload_addr = stoull(arg_mem_preload_addr, nullptr, 16);
+    std::cout<<"[TESTBENCH]: Preloading the external memory at offset 0x"<<std::hex<<mem_preload_addr<<std::dec<<std::endl;
+  }
+
+  return mem_preload_addr;
+}
+
+std::string XHEEP_CmdLineOptions::get_sc_log()
+{
+  std::string sc_log = this->getCmdOption(this->argc, this->argv, "+sc_log=");
+
+  if(sc_log.empty()){
+    sc_log = "transactions";
+  }
+  std::cout<<"[TESTBENCH]: SystemC log level "<<sc_log<<std::endl;
+
+  return sc_log;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_snapshot()
+{
+  std::string arg_cache_snapshot = this->getCmdOption(this->argc, this->argv, "+cache_snapshot=");
+  uint32_t cache_snapshot = 0;
+
+  if(!arg_cache_snapshot.empty()){
+    cache_snapshot = stoul(arg_cache_snapshot);
+    std::cout<<"[TESTBENCH]: Dumping the cache every "<<cache_snapshot<<" transactions"<<std::endl;
+  }
+
+  return cache_snapshot;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_obi_depth()
+{
+  std::string arg_obi_depth = this->getCmdOption(this->argc, this->argv, "+obi_depth=");
+  uint32_t obi_depth = 1;
+
+  if(!arg_obi_depth.empty()){
+    obi_depth = stoul(arg_obi_depth);
+  }
+  std::cout<<"[TESTBENCH]: Up to "<<obi_depth<<" outstanding OBI requests"<<std::endl;
+
+  return obi_depth;
+}
+
+std::string XHEEP_CmdLineOptions::get_cache_prefetch()
+{
+  std::string cache_prefetch = this->getCmdOption(this->argc, this->argv, "+cache_prefetch=");
+
+  if(cache_prefetch.empty()){
+    cache_prefetch = "off";
+  }
+  std::cout<<"[TESTBENCH]: Cache prefetcher "<<cache_prefetch<<std::endl;
+
+  return cache_prefetch;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_prefetch_degree()
+{
+  std::string arg_cache_prefetch_degree = this->getCmdOption(this->argc, this->argv, "+cache_prefetch_degree=");
+  uint32_t cache_prefetch_degree = 1;
+
+  if(!arg_cache_prefetch_degree.empty()){
+    cache_prefetch_degree = stoul(arg_cache_prefetch_degree);
+    std::cout<<"[TESTBENCH]: Prefetching "<<cache_prefetch_degree<<" lines ahead"<<std::endl;
+  }
+
+  return cache_prefetch_degree;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_hit_latency()
+{
+  std::string arg_cache_hit_latency = this->getCmdOption(this->argc, this->argv, "+cache_hit_latency=");
+  uint32_t cache_hit_latency = 20;
+
+  if(!arg_cache_hit_latency.empty()){
+    cache_hit_latency = stoul(arg_cache_hit_latency);
+  }
+  std::cout<<"[TESTBENCH]: Cache hit latency of "<<cache_hit_latency<<" ns"<<std::endl;
+
+  return cache_hit_latency;
+}
+
+std::string XHEEP_CmdLineOptions::get_cache_write_policy()
+{
+  std::string cache_write_policy = this->getCmdOption(this->argc, this->argv, "+cache_write_policy=");
+
+  if(cache_write_policy.empty()){
+    cache_write_policy = "back";
+  }
+  std::cout<<"[TESTBENCH]: Cache write policy "<<cache_write_policy<<std::endl;
+
+  return cache_write_policy;
+}
+
+std::string XHEEP_CmdLineOptions::get_cache_write_miss()
+{
+  std::string cache_write_miss = this->getCmdOption(this->argc, this->argv, "+cache_write_miss=");
+
+  if(cache_write_miss.empty()){
+    cache_write_miss = "allocate";
+  }
+  std::cout<<"[TESTBENCH]: Cache write misses "<<cache_write_miss<<std::endl;
+
+  return cache_write_miss;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_write_buffer()
+{
+  std::string arg_cache_write_buffer = this->getCmdOption(this->argc, this->argv, "+cache_write_buffer=");
+  uint32_t cache_write_buffer = 0;
+
+  if(!arg_cache_write_buffer.empty()){
+    cache_write_buffer = stoul(arg_cache_write_buffer);
+    std::cout<<"[TESTBENCH]: Write buffer of "<<cache_write_buffer<<" lines"<<std::endl;
+  }
+
+  return cache_write_buffer;
+}
+
+std::string XHEEP_CmdLineOptions::get_cache_report()
+{
+  std::string cache_report = this->getCmdOption(this->argc, this->argv, "+cache_report=");
+
+  if(!cache_report.empty()){
+    std::cout<<"[TESTBENCH]: Writing the cache statistics to "<<cache_report<<std::endl;
+  }
+
+  return cache_report;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_cache_report_region()
+{
+  std::string arg_cache_report_region = this->getCmdOption(this->argc, this->argv, "+cache_report_region=");
+  uint32_t cache_report_region = 4096;
+
+  if(!arg_cache_report_region.empty()){
+    cache_report_region = stoul(arg_cache_report_region, nullptr, 0);
+  }
+  std::cout<<"[TESTBENCH]: Cache statistics per region of "<<cache_report_region<<" bytes"<<std::endl;
+
+  return cache_report_region;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_l2_size()
+{
+  std::string arg_l2_size = this->getCmdOption(this->argc, this->argv, "+l2_size=");
+  uint32_t l2_size = 0;
+
+  if(!arg_l2_size.empty()){
+    l2_size = stoul(arg_l2_size);
+    std::cout<<"[TESTBENCH]: L2 cache size "<<l2_size<<" bytes"<<std::endl;
+  }
+
+  return l2_size;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_l2_ways()
+{
+  std::string arg_l2_ways = this->getCmdOption(this->argc, this->argv, "+l2_ways=");
+  uint32_t l2_ways = 1;
+
+  if(!arg_l2_ways.empty()){
+    l2_ways = stoul(arg_l2_ways);
+  }
+  std::cout<<"[TESTBENCH]: L2 cache with "<<l2_ways<<" ways"<<std::endl;
+
+  return l2_ways;
+}
+
+std::string XHEEP_CmdLineOptions::get_l2_policy()
+{
+  std::string l2_policy = this->getCmdOption(this->argc, this->argv, "+l2_policy=");
+
+  if(l2_policy.empty()){
+    l2_policy = "lru";
+  }
+  std::cout<<"[TESTBENCH]: L2 cache replacement policy "<<l2_policy<<std::endl;
+
+  return l2_policy;
+}
+
+std::string XHEEP_CmdLineOptions::get_l2_inclusion()
+{
+  std::string l2_inclusion = this->getCmdOption(this->argc, this->argv, "+l2_inclusion=");
+
+  if(l2_inclusion.empty()){
+    l2_inclusion = "nine";
+  }
+  std::cout<<"[TESTBENCH]: L2 cache inclusion policy "<<l2_inclusion<<std::endl;
+
+  return l2_inclusion;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_l2_hit_latency()
+{
+  std::string arg_l2_hit_latency = this->getCmdOption(this->argc, this->argv, "+l2_hit_latency=");
+  uint32_t l2_hit_latency = 40;
+
+  if(!arg_l2_hit_latency.empty()){
+    l2_hit_latency = stoul(arg_l2_hit_latency);
+  }
+  std::cout<<"[TESTBENCH]: L2 cache lookup latency of "<<l2_hit_latency<<" ns"<<std::endl;
+
+  return l2_hit_latency;
+}
+
+std::string XHEEP_CmdLineOptions::get_power_report()
+{
+  std::string power_report = this->getCmdOption(this->argc, this->argv, "+power_report=");
+
+  if(!power_report.empty()){
+    std::cout<<"[TESTBENCH]: Writing the power report to "<<power_report<<std::endl;
+  }
+
+  return power_report;
+}
+
+std::string XHEEP_CmdLineOptions::get_power_table()
+{
+  std::string power_table = this->getCmdOption(this->argc, this->argv, "+power_table=");
+
+  if(power_table.empty()){
+    std::cout<<"[TESTBENCH]: No power table specified, only the residency is reported"<<std::endl;
+  }
+
+  return power_table;
+}
+
+std::string XHEEP_CmdLineOptions::get_power_trace()
+{
+  std::string power_trace = this->getCmdOption(this->argc, this->argv, "+power_trace=");
+
+  if(!power_trace.empty()){
+    std::cout<<"[TESTBENCH]: Writing the power states over time to "<<power_trace<<std::endl;
+  }
+
+  return power_trace;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_power_sample()
+{
+  std::string arg_power_sample = this->getCmdOption(this->argc, this->argv, "+power_sample=");
+  uint64_t power_sample = 100;
+
+  if(!arg_power_sample.empty()){
+    power_sample = stoull(arg_power_sample);
+  }
+  std::cout<<"[TESTBENCH]: Sampling the power states every "<<power_sample<<" cycles"<<std::endl;
+
+  return power_sample;
+}
+
+std::string XHEEP_CmdLineOptions::get_pc_profile()
+{
+  std::string pc_profile = this->getCmdOption(this->argc, this->argv, "+pc_profile=");
+
+  if(!pc_profile.empty()){
+    std::cout<<"[TESTBENCH]: Writing the fetch counts of each PC to "<<pc_profile<<std::endl;
+  }
+
+  return pc_profile;
+}
+
+std::string XHEEP_CmdLineOptions::get_profile()
+{
+  std::string profile = this->getCmdOption(this->argc, this->argv, "+profile=");
+
+  if(!profile.empty()){
+    std::cout<<"[TESTBENCH]: Writing the profile of the retired PC to "<<profile<<std::endl;
+  }
+
+  return profile;
+}
+
+std::string XHEEP_CmdLineOptions::get_profile_folded()
+{
+  std::string profile_folded = this->getCmdOption(this->argc, this->argv, "+profile_folded=");
+
+  if(!profile_folded.empty()){
+    std::cout<<"[TESTBENCH]: Writing the folded call stacks to "<<profile_folded<<std::endl;
+  }
+
+  return profile_folded;
+}
+
+// The ELF of the application, by default next to the firmware with the .elf extension
+std::string XHEEP_CmdLineOptions::get_profile_elf(const std::string& firmware)
+{
+  std::string profile_elf = this->getCmdOption(this->argc, this->argv, "+profile_elf=");
+
+  if(profile_elf.empty()){
+    size_t dot = firmware.find_last_of('.');
+    profile_elf = (dot == std::string::npos ? firmware : firmware.substr(0, dot)) + ".elf";
+  }
+  std::cout<<"[TESTBENCH]: Symbols of the profile read from "<<profile_elf<<std::endl;
+
+  return profile_elf;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_profile_period()
+{
+  std::string arg_profile_period = this->getCmdOption(this->argc, this->argv, "+profile_period=");
+  uint64_t profile_period = 0;
+
+  if(!arg_profile_period.empty()){
+    profile_period = stoull(arg_profile_period);
+  }
+  if(profile_period) {
+    std::cout<<"[TESTBENCH]: Sampling the retired PC every "<<profile_period<<" cycles"<<std::endl;
+  } else {
+    std::cout<<"[TESTBENCH]: Counting every retired PC"<<std::endl;
+  }
+
+  return profile_period;
+}
+
+std::string XHEEP_CmdLineOptions::get_event_trace()
+{
+  std::string event_trace = this->getCmdOption(this->argc, this->argv, "+event_trace=");
+
+  if(!event_trace.empty()){
+    std::cout<<"[TESTBENCH]: Writing the binary event trace to "<<event_trace<<std::endl;
+  }
+
+  return event_trace;
+}
+
+std::string XHEEP_CmdLineOptions::get_mem_heatmap()
+{
+  std::string mem_heatmap = this->getCmdOption(this->argc, this->argv, "+mem_heatmap=");
+
+  if(!mem_heatmap.empty()){
+    std::cout<<"[TESTBENCH]: Writing the heatmap of the RAM accesses to "<<mem_heatmap<<std::endl;
+  }
+
+  return mem_heatmap;
+}
+
+std::string XHEEP_CmdLineOptions::get_mem_heatmap_csv()
+{
+  std::string mem_heatmap_csv = this->getCmdOption(this->argc, this->argv, "+mem_heatmap_csv=");
+
+  if(!mem_heatmap_csv.empty()){
+    std::cout<<"[TESTBENCH]: Writing the requests of each bank and window to "<<mem_heatmap_csv<<std::endl;
+  }
+
+  return mem_heatmap_csv;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_mem_heatmap_window()
+{
+  std::string arg_mem_heatmap_window = this->getCmdOption(this->argc, this->argv, "+mem_heatmap_window=");
+  uint32_t mem_heatmap_window = 256;
+
+  if(!arg_mem_heatmap_window.empty()){
+    mem_heatmap_window = stoul(arg_mem_heatmap_window);
+  }
+  std::cout<<"[TESTBENCH]: Heatmap windows of "<<mem_heatmap_window<<" bytes"<<std::endl;
+
+  return mem_heatmap_window;
+}
+
+unsigned int XHEEP_CmdLineOptions::get_mem_heatmap_top()
+{
+  std::string arg_mem_heatmap_top = this->getCmdOption(this->argc, this->argv, "+mem_heatmap_top=");
+  unsigned int mem_heatmap_top = 20;
+
+  if(!arg_mem_heatmap_top.empty()){
+    mem_heatmap_top = stoul(arg_mem_heatmap_top);
+  }
+
+  return mem_heatmap_top;
+}
+
+std::string XHEEP_CmdLineOptions::get_mem_dump()
+{
+  std::string mem_dump = this->getCmdOption(this->argc, this->argv, "+mem_dump=");
+
+  if(!mem_dump.empty()){
+    std::cout<<"[TESTBENCH]: Dumping the memory to "<<mem_dump<<" at exit"<<std::endl;
+  }
+
+  return mem_dump;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_mem_dump_addr()
+{
+  std::string arg_mem_dump_addr = this->getCmdOption(this->argc, this->argv, "+mem_dump_addr=");
+  uint32_t mem_dump_addr = 0;
+
+  if(!arg_mem_dump_addr.empty()){
+    mem_dump_addr = stoul(arg_mem_dump_addr, nullptr, 16);
+  }
+  std::cout<<"[TESTBENCH]: Memory dump from 0x"<<std::hex<<mem_dump_addr<<std::dec<<std::endl;
+
+  return mem_dump_addr;
+}
+
+uint32_t XHEEP_CmdLineOptions::get_mem_dump_size()
+{
+  std::string arg_mem_dump_size = this->getCmdOption(this->argc, this->argv, "+mem_dump_size=");
+  uint32_t mem_dump_size = 4;
+
+  if(!arg_mem_dump_size.empty()){
+    mem_dump_size = stoul(arg_mem_dump_size, nullptr, 0);
+  }
+  std::cout<<"[TESTBENCH]: Memory dump of "<<mem_dump_size<<" bytes"<<std::endl;
+
+  return mem_dump_size;
+}
+
+// One firmware image per line, the empty lines and the text after # are ignored
+std::vector<std::string> XHEEP_CmdLineOptions::get_firmware_list()
+{
+  std::string firmware_list = this->getCmdOption(this->argc, this->argv, "+firmware_list=");
+  std::vector<std::string> firmwares;
+
+  if(firmware_list.empty()) return firmwares;
+
+  std::ifstream list(firmware_list);
+  if(!list.is_open()) {
+    std::cout<<"[TESTBENCH]: ERROR: cannot read "<<firmware_list<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::string line;
+  while(std::getline(list, line)) {
+    line = line.substr(0, line.find('#'));
+    size_t start = line.find_first_not_of(" \t\r");
+    if(start == std::string::npos) continue;
+    firmwares.push_back(line.substr(start, line.find_last_not_of(" \t\r") - start + 1));
+  }
+  std::cout<<"[TESTBENCH]: Running the "<<firmwares.size()<<" firmware images of "<<firmware_list<<std::endl;
+
+  return firmwares;
+}
+
+std::string XHEEP_CmdLineOptions::get_batch_report()
+{
+  std::string batch_report = this->getCmdOption(this->argc, this->argv, "+batch_report=");
+
+  if(batch_report.empty()){
+    batch_report = "batch_report.json";
+  }
+  std::cout<<"[TESTBENCH]: Writing the batch report to "<<batch_report<<std::endl;
+
+  return batch_report;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_batch_max_cycles()
+{
+  std::string arg_batch_max_cycles = this->getCmdOption(this->argc, this->argv, "+batch_max_cycles=");
+  uint64_t batch_max_cycles = UINT64_MAX;
+
+  if(!arg_batch_max_cycles.empty()){
+    batch_max_cycles = stoull(arg_batch_max_cycles);
+    std::cout<<"[TESTBENCH]: Each image of the batch stops after "<<batch_max_cycles<<" cycles"<<std::endl;
+  } else {
+    std::cout<<"[TESTBENCH]: Each image of the batch runs until its exit"<<std::endl;
+  }
+
+  return batch_max_cycles;
+}
+
+// The plusargs of one run per line, the empty lines and the text after # are ignored
+std::vector<std::string> XHEEP_CmdLineOptions::get_sweep()
+{
+  std::string sweep = this->getCmdOption(this->argc, this->argv, "+sweep=");
+  std::vector<std::string> runs;
+
+  if(sweep.empty()) return runs;
+
+  std::ifstream list(sweep);
+  if(!list.is_open()) {
+    std::cout<<"[TESTBENCH]: ERROR: cannot read "<<sweep<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::string line;
+  while(std::getline(list, line)) {
+    line = line.substr(0, line.find('#'));
+    size_t start = line.find_first_not_of(" \t\r");
+    if(start == std::string::npos) continue;
+    runs.push_back(line.substr(start, line.find_last_not_of(" \t\r") - start + 1));
+  }
+  std::cout<<"[TESTBENCH]: Running the "<<runs.size()<<" runs of "<<sweep<<std::endl;
+
+  return runs;
+}
+
+unsigned int XHEEP_CmdLineOptions::get_sweep_threads()
+{
+  std::string arg_sweep_threads = this->getCmdOption(this->argc, this->argv, "+sweep_threads=");
+  unsigned int sweep_threads = std::thread::hardware_concurrency();
+
+  if(!arg_sweep_threads.empty()){
+    sweep_threads = stoul(arg_sweep_threads);
+  }
+  if(sweep_threads == 0) sweep_threads = 1;
+  std::cout<<"[TESTBENCH]: Running "<<sweep_threads<<" models at a time"<<std::endl;
+
+  return sweep_threads;
+}
+
+std::string XHEEP_CmdLineOptions::get_sweep_dir()
+{
+  std::string sweep_dir = this->getCmdOption(this->argc, this->argv, "+sweep_dir=");
+
+  if(sweep_dir.empty()){
+    sweep_dir = "sweep";
+  }
+  std::cout<<"[TESTBENCH]: Writing the logs of the runs to "<<sweep_dir<<std::endl;
+
+  return sweep_dir;
+}
+
+std::string XHEEP_CmdLineOptions::get_sweep_report()
+{
+  std::string sweep_report = this->getCmdOption(this->argc, this->argv, "+sweep_report=");
+
+  if(sweep_report.empty()){
+    sweep_report = "sweep_report.json";
+  }
+  std::cout<<"[TESTBENCH]: Writing the sweep report to "<<sweep_report<<std::endl;
+
+  return sweep_report;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_vp_quantum()
+{
+  std::string arg_vp_quantum = this->getCmdOption(this->argc, this->argv, "+vp_quantum=");
+  uint64_t vp_quantum = 10000;
+
+  if(!arg_vp_quantum.empty()){
+    vp_quantum = stoull(arg_vp_quantum);
+  }
+  std::cout<<"[TESTBENCH]: Global quantum of the virtual platform "<<vp_quantum<<" ns"<<std::endl;
+
+  return vp_quantum;
+}
+
+uint64_t XHEEP_CmdLineOptions::get_vp_max_cycles()
+{
+  std::string arg_vp_max_cycles = this->getCmdOption(this->argc, this->argv, "+vp_max_cycles=");
+  uint64_t vp_max_cycles = 0;
+
+  if(!arg_vp_max_cycles.empty()){
+    vp_max_cycles = stoull(arg_vp_max_cycles);
+    std::cout<<"[TESTBENCH]: The virtual platform stops after "<<vp_max_cycles<<" cycles"<<std::endl;
+  }
+
+  return vp_max_cycles;
+}
+
+std::string XHEEP_CmdLineOptions::get_vp_switch()
+{
+  std::string vp_switch = this->getCmdOption(this->argc, this->argv, "+vp_switch=");
+
+  if(!vp_switch.empty()){
+    std::cout<<"[TESTBENCH]: The virtual platform writes its state to "<<vp_switch<<" at the first write of SOC_CTRL SCRATCH"<<std::endl;
+  }
+
+  return vp_switch;
+}
+
+std::string XHEEP_CmdLineOptions::get_vp_state()
+{
+  std::string vp_state = this->getCmdOption(this->argc, this->argv, "+vp_state=");
+
+  if(!vp_state.empty()){
+    std::cout<<"[TESTBENCH]: Starting from the state of the virtual platform "<<vp_state<<std::endl;
+  }
+
+  return vp_state;
+}
@@ -2,6 +2,18 @@
 #define XHEEP_TB_UTIL_H
 
 #include <iostream>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Waveform tracing modes selected with +trace=<mode>
+typedef enum {
+  TRACE_OFF,    // no tracing at all, the trace is never set up
+  TRACE_FULL,   // dump every cycle (default)
+  TRACE_WINDOW, // dump only cycles in [+trace_start, +trace_end)
+  TRACE_EXIT,   // keep the last cycles before exit_valid_o rises
+  TRACE_PC      // start dumping when the core fetches +trace_pc
+} trace_mode_t;
 
 class XHEEP_CmdLineOptions // declare Calculator class
 {
@@ -12,8 +24,82 @@ class XHEEP_CmdLineOptions // declare Calculator class
     std::string getCmdOption(int argc, char* argv[], const std::string& option); // get options from cmd lines
     bool get_use_openocd();
     std::string get_firmware();
-    unsigned int get_max_sim_time(bool& run_all);
+    uint64_t get_max_sim_time(bool& run_all);
+    uint64_t get_max_cycles();
+    double get_heartbeat();
+    uint64_t get_hang_cycles();
     unsigned int get_boot_sel();
+    bool get_execute_from_flash();
+    std::string get_flash_image();
+    trace_mode_t get_trace_mode();
+    uint64_t get_trace_start();
+    uint64_t get_trace_end();
+    uint64_t get_trace_cycles(uint64_t default_cycles);
+    uint32_t get_trace_pc();
+    bool get_startup_pc(uint32_t& startup_pc);
+    std::string get_save_checkpoint();
+    std::string get_restore_checkpoint();
+    uint64_t get_checkpoint_cycle();
+    bool get_fast_loader(const std::string& firmware);
+    std::string get_perf_json();
+    bool get_fast_forward();
+    uint64_t get_fast_forward_idle();
+    uint32_t get_cache_size();
+    uint32_t get_cache_block_size();
+    uint32_t get_cache_ways();
+    std::string get_cache_policy();
+    uint32_t get_mem_burst_len();
+    uint32_t get_mem_beat_latency();
+    std::string get_mem_profile();
+    std::string get_mem_tlm();
+    uint32_t get_mem_quantum();
+    uint64_t get_mem_size();
+    std::string get_mem_preload();
+    uint64_t get_mem_preload_addr();
+    std::string get_sc_log();
+    uint32_t get_cache_snapshot();
+    uint32_t get_obi_depth();
+    std::string get_cache_prefetch();
+    uint32_t get_cache_prefetch_degree();
+    uint32_t get_cache_hit_latency();
+    std::string get_cache_write_policy();
+    std::string get_cache_write_miss();
+    uint32_t get_cache_write_buffer();
+    std::string get_cache_report();
+    uint32_t get_cache_report_region();
+    uint32_t get_l2_size();
+    uint32_t get_l2_ways();
+    std::string get_l2_policy();
+    std::string get_l2_inclusion();
+    uint32_t get_l2_hit_latency();
+    std::string get_power_report();
+    std::string get_power_table();
+    std::string get_power_trace();
+    uint64_t get_power_sample();
+    std::string get_pc_profile();
+    std::string get_profile();
+    std::string get_profile_folded();
+    std::string get_profile_elf(const std::string& firmware);
+    uint64_t get_profile_period();
+    std::string get_event_trace();
+    std::string get_mem_heatmap();
+    std::string get_mem_heatmap_csv();
+    uint32_t get_mem_heatmap_window();
+    unsigned int get_mem_heatmap_top();
+    std::string get_mem_dump();
+    uint32_t get_mem_dump_addr();
+    uint32_t get_mem_dump_size();
+    std::vector<std::string> get_firmware_list();
+    std::string get_batch_report();
+    uint64_t get_batch_max_cycles();
+    std::vector<std::string> get_sweep();
+    unsigned int get_sweep_threads();
+    std::string get_sweep_dir();
+    std::string get_sweep_report();
+    uint64_t get_vp_quantum();
+    uint64_t get_vp_max_cycles();
+    std::string get_vp_switch();
+    std::string get_vp_state();
     int argc;
     char** argv;
 
@@ -0,0 +1,131 @@
+#include "XHEEP_EventTrace.hh"
+#include <iostream>
+
+// bytes of events handed to the compression thread at once
+#define BLOCK_SIZE (1 << 20)
+// blocks waiting for the compression, the simulation waits beyond
+#define MAX_QUEUED_BLOCKS 16
+
+XHEEP_EventTrace::XHEEP_EventTrace(unsigned int nmaster, unsigned int nsystem)
+{
+    this->nmaster    = nmaster;
+    this->nsystem    = nsystem;
+    this->last_cycle = 0;
+    this->nevents    = 0;
+    this->last_pc    = 0;
+    this->last_addr.assign(nmaster, 0);
+    this->out        = NULL;
+    this->closing    = false;
+}
+
+XHEEP_EventTrace::~XHEEP_EventTrace()
+{
+    this->close();
+}
+
+bool XHEEP_EventTrace::open(const std::string& file)
+{
+    // fast compression, the trace is written while simulating
+    this->out = gzopen(file.c_str(), "wb1");
+    if(this->out == NULL) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot write "<<file<<std::endl;
+      return false;
+    }
+
+    const char magic[] = "XHEEPEVT";
+    this->block.reserve(BLOCK_SIZE + 64);
+    this->block.insert(this->block.end(), magic, magic + 8);
+    this->block.push_back(1);
+    this->block.push_back(this->nmaster);
+    this->block.push_back(this->nsystem);
+    this->block.push_back(0);
+
+    this->thread = std::thread(&XHEEP_EventTrace::writer, this);
+    return true;
+}
+
+void XHEEP_EventTrace::varint(uint64_t value)
+{
+    while(value >= 0x80) {
+      this->block.push_back((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    this->block.push_back((uint8_t)value);
+}
+
+void XHEEP_EventTrace::header(uint64_t cycle, event_t event, unsigned int master)
+{
+    this->block.push_back((uint8_t)(master << 2 | event));
+    // the grants of the masters are traced in order of the master, not of the request
+    this->varint(cycle >= this->last_cycle ? cycle - this->last_cycle : 0);
+    if(cycle > this->last_cycle) this->last_cycle = cycle;
+    this->nevents++;
+}
+
+void XHEEP_EventTrace::retire(uint64_t cycle, uint32_t pc)
+{
+    if(this->out == NULL) return;
+    this->header(cycle, EVENT_RETIRE, 0);
+    this->zigzag((int32_t)(pc - this->last_pc));
+    this->last_pc = pc;
+    if(this->block.size() >= BLOCK_SIZE) this->flush();
+}
+
+void XHEEP_EventTrace::bus(uint64_t request_cycle, uint64_t grant_cycle, unsigned int master, uint32_t addr, bool we)
+{
+    if(this->out == NULL || master >= this->nmaster) return;
+    this->header(grant_cycle, we ? EVENT_BUS_WRITE : EVENT_BUS_READ, master);
+    this->varint(grant_cycle - request_cycle);
+    this->zigzag((int32_t)(addr - this->last_addr[master]));
+    this->last_addr[master] = addr;
+    if(this->block.size() >= BLOCK_SIZE) this->flush();
+}
+
+void XHEEP_EventTrace::irq(uint64_t cycle, uint32_t lines)
+{
+    if(this->out == NULL) return;
+    this->header(cycle, EVENT_IRQ, 0);
+    this->varint(lines);
+    if(this->block.size() >= BLOCK_SIZE) this->flush();
+}
+
+void XHEEP_EventTrace::flush()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->ready.wait(guard, [this] { return this->queue.size() < MAX_QUEUED_BLOCKS; });
+    this->queue.push_back(std::move(this->block));
+    this->ready.notify_all();
+    this->block.clear();
+    this->block.reserve(BLOCK_SIZE + 64);
+}
+
+// Compression thread, writes the blocks in order until the trace is closed
+void XHEEP_EventTrace::writer()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    while(true) {
+      this->ready.wait(guard, [this] { return !this->queue.empty() || this->closing; });
+      if(this->queue.empty()) break;
+      std::vector<uint8_t> data = std::move(this->queue.front());
+      this->queue.pop_front();
+      this->ready.notify_all();
+      guard.unlock();
+      gzwrite(this->out, data.data(), data.size());
+      guard.lock();
+    }
+}
+
+void XHEEP_EventTrace::close()
+{
+    if(this->out == NULL) return;
+    if(!this->block.empty()) this->flush();
+    {
+      std::lock_guard<std::mutex> guard(this->lock);
+      this->closing = true;
+    }
+    this->ready.notify_all();
+    this->thread.join();
+    gzclose(this->out);
+    this->out = NULL;
+    std::cout<<"[TESTBENCH]: "<<this->nevents<<" events traced"<<std::endl;
+}
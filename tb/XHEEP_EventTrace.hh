@@ -0,0 +1,72 @@
+#ifndef XHEEP_EVENT_TRACE_H
+#define XHEEP_EVENT_TRACE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+// Compact binary trace of the retired instructions, of the transactions of the masters of the
+// system crossbar and of the interrupt lines of the core, written with +event_trace=<file>.
+// The events are encoded in blocks, which a background thread compresses into a gzip file,
+// so that the simulation only appends a few bytes per event.
+//
+// After an 8-byte "XHEEPEVT" magic, a version byte, the number of masters and of system
+// masters and a reserved byte, each event is a tag byte followed by unsigned LEB128 varints,
+// the signed values being zigzag encoded:
+//   tag bits 1:0  0 retire, 1 bus read, 2 bus write, 3 interrupts
+//   tag bits 7:2  master of a bus transaction
+//   cycle         cycles since the previous event
+//   retire        signed PC difference with the previous retired PC
+//   bus           cycles between the request and the grant, signed address difference with
+//                 the previous transaction of the master
+//   interrupts    the new value of the interrupt lines
+// util/event_trace.py reads it.
+class XHEEP_EventTrace
+{
+
+  public:
+    typedef enum {
+      EVENT_RETIRE,
+      EVENT_BUS_READ,
+      EVENT_BUS_WRITE,
+      EVENT_IRQ
+    } event_t;
+
+    XHEEP_EventTrace(unsigned int nmaster, unsigned int nsystem);
+    ~XHEEP_EventTrace();
+
+    bool open(const std::string& file);  // returns false if the file cannot be written
+    void retire(uint64_t cycle, uint32_t pc);
+    void bus(uint64_t request_cycle, uint64_t grant_cycle, unsigned int master, uint32_t addr, bool we);
+    void irq(uint64_t cycle, uint32_t lines);
+    void close();
+    uint64_t events() { return this->nevents; }
+
+  private:
+    void header(uint64_t cycle, event_t event, unsigned int master);
+    void varint(uint64_t value);
+    void zigzag(int32_t value) { this->varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31)); }
+    void flush();
+    void writer();
+
+    unsigned int nmaster, nsystem;
+    uint64_t last_cycle, nevents;
+    uint32_t last_pc;
+    std::vector<uint32_t> last_addr;
+    std::vector<uint8_t> block;
+
+    gzFile out;
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::vector<uint8_t>> queue;
+    bool closing;
+
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "XHEEP_FirmwareLoader.hh"
+#include <elf.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include <string.h>
+
+XHEEP_FirmwareLoader::XHEEP_FirmwareLoader(write_word_t write_word)
+{
+    this->write_word   = write_word;
+    this->loaded_words = 0;
+}
+
+void XHEEP_FirmwareLoader::add_byte(uint32_t addr, uint8_t byte)
+{
+    uint32_t shift = (addr & 0x3) * 8;
+    uint32_t& word = this->words[addr & ~0x3u];
+    word = (word & ~(0xFFu << shift)) | ((uint32_t)byte << shift);
+}
+
+bool XHEEP_FirmwareLoader::parse_elf(const std::string& firmware)
+{
+    std::ifstream file(firmware, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Elf32_Ehdr ehdr;
+
+    if(image.size() < sizeof(Elf32_Ehdr)) return false;
+    memcpy(&ehdr, image.data(), sizeof(Elf32_Ehdr));
+
+    if(memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_ident[EI_CLASS] != ELFCLASS32 || ehdr.e_ident[EI_DATA] != ELFDATA2LSB){
+      std::cout<<"[TESTBENCH]: ERROR: "<<firmware<<" is not a 32-bit little-endian ELF"<<std::endl;
+      return false;
+    }
+
+    for(int i = 0; i < ehdr.e_phnum; i++) {
+      Elf32_Phdr phdr;
+      size_t phdr_offset = ehdr.e_phoff + i * ehdr.e_phentsize;
+      if(phdr_offset + sizeof(Elf32_Phdr) > image.size()) return false;
+      memcpy(&phdr, &image[phdr_offset], sizeof(Elf32_Phdr));
+
+      if(phdr.p_type != PT_LOAD || phdr.p_filesz == 0) continue;
+      if(phdr.p_offset + phdr.p_filesz > image.size()) return false;
+
+      // use the load address, as objcopy does when generating the .hex
+      for(uint32_t j = 0; j < phdr.p_filesz; j++)
+        this->add_byte(phdr.p_paddr + j, image[phdr.p_offset + j]);
+    }
+    return true;
+}
+
+bool XHEEP_FirmwareLoader::parse_bin(const std::string& firmware)
+{
+    std::ifstream file(firmware, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // raw images are linked at address 0
+    for(uint32_t i = 0; i < image.size(); i++)
+      this->add_byte(i, image[i]);
+    return true;
+}
+
+bool XHEEP_FirmwareLoader::parse_hex(const std::string& firmware)
+{
+    std::ifstream file(firmware);
+    std::string token;
+    uint32_t addr = 0;
+
+    // Verilog hex as generated by objcopy -O verilog: @<byte address> followed by bytes
+    try {
+      while(file >> token) {
+        if(token[0] == '@') {
+          addr = stoul(token.substr(1), nullptr, 16);
+        } else {
+          this->add_byte(addr++, (uint8_t)stoul(token, nullptr, 16));
+        }
+      }
+    } catch(const std::logic_error&) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot parse "<<token<<" in "<<firmware<<std::endl;
+      return false;
+    }
+    return true;
+}
+
+bool XHEEP_FirmwareLoader::is_hex(const std::string& firmware)
+{
+    return firmware.size() > 4 && firmware.compare(firmware.size() - 4, 4, ".hex") == 0;
+}
+
+bool XHEEP_FirmwareLoader::load(const std::string& firmware)
+{
+    std::ifstream file(firmware);
+    bool parsed;
+
+    if(!file.good()){
+      std::cout<<"[TESTBENCH]: ERROR: cannot open firmware "<<firmware<<std::endl;
+      return false;
+    }
+
+    this->words.clear();
+    if(firmware.size() > 4 && firmware.compare(firmware.size() - 4, 4, ".elf") == 0) {
+      parsed = this->parse_elf(firmware);
+    } else if(firmware.size() > 4 && firmware.compare(firmware.size() - 4, 4, ".bin") == 0) {
+      parsed = this->parse_bin(firmware);
+    } else {
+      parsed = this->parse_hex(firmware);
+    }
+
+    if(!parsed) return false;
+
+    for(auto const& word : this->words)
+      this->write_word(word.first, word.second);
+
+    this->loaded_words = this->words.size();
+    std::cout<<"[TESTBENCH]: Loaded "<<this->loaded_words<<" words from "<<firmware<<std::endl;
+    return true;
+}
+
+unsigned int XHEEP_FirmwareLoader::get_loaded_words()
+{
+    return this->loaded_words;
+}
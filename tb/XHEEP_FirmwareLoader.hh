@@ -0,0 +1,37 @@
+#ifndef XHEEP_FIRMWARE_LOADER_H
+#define XHEEP_FIRMWARE_LOADER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+// Loads a firmware image (.elf, .bin or Verilog .hex) on the host and writes it
+// word by word to the on-chip RAM banks through write_word, bypassing the
+// $readmemh based tb_loadHEX path.
+class XHEEP_FirmwareLoader
+{
+
+  public:
+    typedef std::function<void(uint32_t addr, uint32_t data)> write_word_t;
+
+    XHEEP_FirmwareLoader(write_word_t write_word);
+
+    bool load(const std::string& firmware); // returns false if the file cannot be parsed
+    unsigned int get_loaded_words();
+
+    static bool is_hex(const std::string& firmware); // also readable by tb_loadHEX
+
+  private:
+    write_word_t write_word;
+    std::map<uint32_t, uint32_t> words; // word aligned address -> data
+    unsigned int loaded_words;
+
+    void add_byte(uint32_t addr, uint8_t byte);
+    bool parse_elf(const std::string& firmware);
+    bool parse_bin(const std::string& firmware);
+    bool parse_hex(const std::string& firmware);
+
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "XHEEP_MemHeatmap.hh"
+#include <algorithm>
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+// width of the bars of the heatmap
+#define BAR_WIDTH 32
+
+XHEEP_MemHeatmap::XHEEP_MemHeatmap(unsigned int nbanks, const std::vector<std::string>& masters, uint32_t ram_size, uint32_t window_bytes)
+{
+    this->banks.resize(nbanks);
+    this->masters      = masters;
+    this->ram_size     = ram_size;
+    this->window_bytes = window_bytes ? window_bytes : 256;
+}
+
+// Objects and functions of the symbol table of a 32-bit little-endian ELF, and its allocated
+// sections for the words that no symbol covers (e.g. the stack and the heap)
+bool XHEEP_MemHeatmap::load_symbols(const std::string& elf)
+{
+    std::ifstream file(elf, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Elf32_Ehdr ehdr;
+
+    if(image.size() < sizeof(ehdr) || memcmp(image.data(), ELFMAG, SELFMAG) != 0 ||
+       image[EI_CLASS] != ELFCLASS32 || image[EI_DATA] != ELFDATA2LSB) {
+      std::cout<<"[TESTBENCH]: ERROR: "<<elf<<" is not a 32-bit little-endian ELF"<<std::endl;
+      return false;
+    }
+    memcpy(&ehdr, image.data(), sizeof(ehdr));
+
+    std::vector<Elf32_Shdr> shdrs(ehdr.e_shnum);
+    if(ehdr.e_shoff + (uint64_t)ehdr.e_shnum * sizeof(Elf32_Shdr) > image.size()) return false;
+    memcpy(shdrs.data(), image.data() + ehdr.e_shoff, ehdr.e_shnum * sizeof(Elf32_Shdr));
+    const char* shstrtab = ehdr.e_shstrndx < shdrs.size() ? image.data() + shdrs[ehdr.e_shstrndx].sh_offset : NULL;
+
+    for(const Elf32_Shdr& shdr : shdrs) {
+      if(shdr.sh_type == SHT_SYMTAB && shdr.sh_link < shdrs.size()) {
+        const char* strtab = image.data() + shdrs[shdr.sh_link].sh_offset;
+        for(uint32_t off = 0; off + sizeof(Elf32_Sym) <= shdr.sh_size; off += sizeof(Elf32_Sym)) {
+          Elf32_Sym sym;
+          memcpy(&sym, image.data() + shdr.sh_offset + off, sizeof(sym));
+          int type = ELF32_ST_TYPE(sym.st_info);
+          if((type != STT_OBJECT && type != STT_FUNC) || sym.st_size == 0 || strtab[sym.st_name] == '\0') continue;
+          this->symbols.push_back({sym.st_value, sym.st_value + sym.st_size, strtab + sym.st_name});
+        }
+      } else if((shdr.sh_flags & SHF_ALLOC) && shdr.sh_size && shstrtab) {
+        this->sections.push_back({shdr.sh_addr, shdr.sh_addr + shdr.sh_size, std::string("[") + (shstrtab + shdr.sh_name) + "]"});
+      }
+    }
+
+    auto by_address = [](const object_t& a, const object_t& b) { return a.start != b.start ? a.start < b.start : a.end > b.end; };
+    std::sort(this->symbols.begin(), this->symbols.end(), by_address);
+    std::sort(this->sections.begin(), this->sections.end(), by_address);
+    // aliases of the same address
+    this->symbols.erase(std::unique(this->symbols.begin(), this->symbols.end(),
+                                    [](const object_t& a, const object_t& b) { return a.start == b.start; }), this->symbols.end());
+
+    std::cout<<"[TESTBENCH]: Heatmap of the RAM accesses with "<<this->symbols.size()<<" symbols of "<<elf<<std::endl;
+    return true;
+}
+
+const XHEEP_MemHeatmap::object_t* XHEEP_MemHeatmap::lookup(uint32_t addr)
+{
+    for(const std::vector<object_t>* objects : {&this->symbols, &this->sections}) {
+      auto it = std::upper_bound(objects->begin(), objects->end(), addr,
+                                 [](uint32_t addr, const object_t& o) { return addr < o.start; });
+      if(it != objects->begin() && addr < (it - 1)->end) return &*(it - 1);
+    }
+    return NULL;
+}
+
+XHEEP_MemHeatmap::word_t& XHEEP_MemHeatmap::word(uint32_t addr)
+{
+    word_t& w = this->words[addr & ~3u];
+    if(w.accesses.empty()) {
+      w.accesses.assign(this->masters.size(), 0);
+      w.stalls.assign(this->masters.size(), 0);
+    }
+    return w;
+}
+
+// Request at the port of a bank, granted in the cycle
+void XHEEP_MemHeatmap::bank_request(unsigned int bank, uint32_t addr, bool we)
+{
+    rw_t& rw = this->banks[bank][addr / this->window_bytes];
+    if(we) rw.writes++;
+    else rw.reads++;
+}
+
+// Request of a master, counted once when granted and for every cycle it waits before
+void XHEEP_MemHeatmap::master_request(unsigned int master, uint32_t addr, bool gnt)
+{
+    if(addr >= this->ram_size || master >= this->masters.size()) return;
+    word_t& w = this->word(addr);
+    if(gnt) w.accesses[master]++;
+    else w.stalls[master]++;
+}
+
+bool XHEEP_MemHeatmap::write_report(const std::string& report, const std::string& csv, unsigned int top)
+{
+    size_t nbanks = this->banks.size(), nmasters = this->masters.size();
+
+    // accesses of the masters per window, and per object
+    typedef struct {
+      std::string name;
+      uint32_t start, end;
+      std::vector<uint64_t> accesses, stalls;
+      std::set<unsigned int> banks;
+    } usage_t;
+    std::map<uint32_t, std::vector<uint64_t>> window_masters;
+    std::map<std::pair<uint32_t, std::string>, usage_t> usage;
+    for(const auto& w : this->words) {
+      std::vector<uint64_t>& wm = window_masters[w.first / this->window_bytes];
+      wm.resize(nmasters, 0);
+      const object_t* object = this->lookup(w.first);
+      std::string name = object ? object->name : "[unknown]";
+      uint32_t start = object ? object->start : w.first - w.first % this->window_bytes;
+      usage_t& u = usage[{start, name}];
+      if(u.accesses.empty()) {
+        u.name  = name;
+        u.start = start;
+        u.end   = object ? object->end : start + this->window_bytes;
+        u.accesses.assign(nmasters, 0);
+        u.stalls.assign(nmasters, 0);
+      }
+      for(size_t m = 0; m < nmasters; m++) {
+        wm[m]         += w.second.accesses[m];
+        u.accesses[m] += w.second.accesses[m];
+        u.stalls[m]   += w.second.stalls[m];
+      }
+    }
+
+    // the banks holding each object, from the windows of its range they served
+    for(auto& u : usage) {
+      for(size_t b = 0; b < nbanks; b++) {
+        auto it = this->banks[b].lower_bound(u.second.start / this->window_bytes);
+        if(it != this->banks[b].end() && it->first <= (u.second.end - 1) / this->window_bytes) u.second.banks.insert(b);
+      }
+    }
+
+    std::ofstream out(report);
+    if(!out.is_open()) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot write "<<report<<std::endl;
+      return false;
+    }
+
+    out<<"Requests at the ports of the RAM banks"<<std::endl<<std::endl;
+    out<<"  bank       reads      writes  windows"<<std::endl;
+    std::map<uint32_t, std::vector<uint64_t>> window_banks;
+    for(size_t b = 0; b < nbanks; b++) {
+      uint64_t reads = 0, writes = 0;
+      for(const auto& w : this->banks[b]) {
+        reads  += w.second.reads;
+        writes += w.second.writes;
+        std::vector<uint64_t>& wb = window_banks[w.first];
+        wb.resize(nbanks, 0);
+        wb[b] += w.second.reads + w.second.writes;
+      }
+      out<<std::setw(6)<<("ram" + std::to_string(b))<<std::setw(12)<<reads<<std::setw(12)<<writes
+         <<std::setw(9)<<this->banks[b].size()<<std::endl;
+    }
+
+    uint64_t peak = 1;
+    for(const auto& w : window_banks) {
+      uint64_t total = 0;
+      for(uint64_t n : w.second) total += n;
+      peak = std::max(peak, total);
+    }
+
+    // one line per window served by a bank, the bar is relative to the busiest window
+    out<<std::endl<<"Heatmap, requests per "<<this->window_bytes<<"-byte window at the bank ports and granted to the masters"<<std::endl<<std::endl;
+    out<<"   address";
+    for(size_t b = 0; b < nbanks; b++) out<<std::setw(9)<<("ram" + std::to_string(b));
+    for(size_t m = 0; m < nmasters; m++) out<<" "<<std::setw(std::max<size_t>(8, this->masters[m].size()))<<this->masters[m];
+    out<<"  "<<std::left<<std::setw(BAR_WIDTH)<<"heat"<<std::right<<"  object"<<std::endl;
+    for(const auto& w : window_banks) {
+      uint64_t total = 0;
+      out<<"0x"<<std::hex<<std::setw(8)<<std::setfill('0')<<w.first * this->window_bytes<<std::dec<<std::setfill(' ');
+      for(uint64_t n : w.second) {
+        out<<std::setw(9)<<n;
+        total += n;
+      }
+      auto wm = window_masters.find(w.first);
+      for(size_t m = 0; m < nmasters; m++)
+        out<<" "<<std::setw(std::max<size_t>(8, this->masters[m].size()))<<(wm != window_masters.end() ? wm->second[m] : 0);
+      const object_t* object = this->lookup(w.first * this->window_bytes);
+      out<<"  "<<std::left<<std::setw(BAR_WIDTH)<<std::string((total * BAR_WIDTH + peak - 1) / peak, '#')<<std::right
+         <<"  "<<(object ? object->name : "")<<std::endl;
+    }
+
+    // the objects the masters waited the most for, with the waits of each master
+    std::vector<const usage_t*> order;
+    for(const auto& u : usage) {
+      uint64_t stalls = 0;
+      for(uint64_t n : u.second.stalls) stalls += n;
+      if(stalls) order.push_back(&u.second);
+    }
+    auto sum = [](const std::vector<uint64_t>& v) { uint64_t s = 0; for(uint64_t n : v) s += n; return s; };
+    std::sort(order.begin(), order.end(), [&](const usage_t* a, const usage_t* b) { return sum(a->stalls) > sum(b->stalls); });
+    if(order.size() > top) order.resize(top);
+
+    out<<std::endl<<"Top contended objects, cycles the masters waited for a grant"<<std::endl<<std::endl;
+    out<<"    address      size      stalls    accesses  banks       object (stalls per master)"<<std::endl;
+    for(const usage_t* u : order) {
+      std::string banks;
+      for(unsigned int b : u->banks) banks += (banks.empty() ? "" : ",") + std::to_string(b);
+      out<<"0x"<<std::hex<<std::setw(8)<<std::setfill('0')<<u->start<<std::dec<<std::setfill(' ')
+         <<std::setw(10)<<(u->end - u->start)<<std::setw(12)<<sum(u->stalls)<<std::setw(12)<<sum(u->accesses)
+         <<"  "<<std::left<<std::setw(10)<<(banks.empty() ? "-" : banks)<<std::right<<"  "<<u->name<<" (";
+      bool first = true;
+      for(size_t m = 0; m < nmasters; m++) {
+        if(!u->stalls[m]) continue;
+        out<<(first ? "" : " ")<<this->masters[m]<<":"<<u->stalls[m];
+        first = false;
+      }
+      out<<")"<<std::endl;
+    }
+
+    if(!csv.empty()) {
+      std::ofstream table(csv);
+      if(!table.is_open()) {
+        std::cout<<"[TESTBENCH]: ERROR: cannot write "<<csv<<std::endl;
+        return false;
+      }
+      table<<"address,bank,reads,writes"<<std::endl;
+      for(size_t b = 0; b < nbanks; b++) {
+        for(const auto& w : this->banks[b])
+          table<<"0x"<<std::hex<<w.first * this->window_bytes<<std::dec<<",ram"<<b<<","<<w.second.reads<<","<<w.second.writes<<std::endl;
+      }
+    }
+
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef XHEEP_MEM_HEATMAP_H
+#define XHEEP_MEM_HEATMAP_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Heatmap of the accesses to the on-chip RAM, to place the buffers in the banks and tune the
+// interleaving. Every cycle, the testbench passes the requests at the ports of the RAM banks,
+// counted per bank and per window of window_bytes bytes, and the requests of the masters of the
+// system crossbar to the RAM, counted per word when granted and per cycle while they wait. At
+// the end, the words are mapped to the objects and functions of the symbol table of the ELF
+// (or to their section when no symbol covers them), and the objects are sorted by the cycles
+// the masters waited for them.
+class XHEEP_MemHeatmap
+{
+
+  public:
+    XHEEP_MemHeatmap(unsigned int nbanks, const std::vector<std::string>& masters, uint32_t ram_size, uint32_t window_bytes);
+
+    bool load_symbols(const std::string& elf);  // returns false if the file is not an ELF
+    void bank_request(unsigned int bank, uint32_t addr, bool we);
+    void master_request(unsigned int master, uint32_t addr, bool gnt);
+    bool write_report(const std::string& report, const std::string& csv, unsigned int top);
+
+  private:
+    typedef struct {
+      uint32_t start;
+      uint32_t end;
+      std::string name;
+    } object_t;
+
+    typedef struct {
+      uint64_t reads;
+      uint64_t writes;
+    } rw_t;
+
+    typedef struct {
+      std::vector<uint64_t> accesses;  // per master
+      std::vector<uint64_t> stalls;    // cycles waited, per master
+    } word_t;
+
+    word_t& word(uint32_t addr);
+    const object_t* lookup(uint32_t addr);
+
+    std::vector<object_t> symbols;   // sorted by address
+    std::vector<object_t> sections;  // allocated sections, for the words without symbol
+    std::vector<std::map<uint32_t, rw_t>> banks;     // per bank, window -> requests
+    std::unordered_map<uint32_t, word_t> words;      // word address -> requests of the masters
+    std::vector<std::string> masters;
+    uint32_t ram_size, window_bytes;
+
+};
+
+#endif
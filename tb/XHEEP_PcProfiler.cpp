@@ -0,0 +1,257 @@
+#include "XHEEP_PcProfiler.hh"
+#include <algorithm>
+#include <cstring>
+#include <elf.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+// deeper stacks are taken as jumps, e.g. a recursion without returns
+#define MAX_DEPTH 512
+
+XHEEP_PcProfiler::XHEEP_PcProfiler(uint64_t sample_cycles)
+{
+    node_t root = {};
+    root.function = -1;
+    root.parent   = -1;
+    this->nodes.push_back(root);
+
+    this->current       = 0;
+    this->current_start = 0;
+    this->current_end   = 0;
+    this->sample_cycles = sample_cycles;
+    this->next_sample   = 0;
+    this->samples       = 0;
+}
+
+// Functions of the symbol table of a 32-bit little-endian ELF. The assembly labels of the
+// code have no size, they are taken to extend to the next symbol.
+bool XHEEP_PcProfiler::load_symbols(const std::string& elf)
+{
+    std::ifstream file(elf, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Elf32_Ehdr ehdr;
+
+    if(image.size() < sizeof(ehdr) || memcmp(image.data(), ELFMAG, SELFMAG) != 0 ||
+       image[EI_CLASS] != ELFCLASS32 || image[EI_DATA] != ELFDATA2LSB) {
+      std::cout<<"[TESTBENCH]: ERROR: "<<elf<<" is not a 32-bit little-endian ELF"<<std::endl;
+      return false;
+    }
+    memcpy(&ehdr, image.data(), sizeof(ehdr));
+
+    std::vector<Elf32_Shdr> shdrs(ehdr.e_shnum);
+    if(ehdr.e_shoff + (uint64_t)ehdr.e_shnum * sizeof(Elf32_Shdr) > image.size()) return false;
+    memcpy(shdrs.data(), image.data() + ehdr.e_shoff, ehdr.e_shnum * sizeof(Elf32_Shdr));
+
+    std::vector<function_t> symbols;
+    for(const Elf32_Shdr& shdr : shdrs) {
+      if(shdr.sh_type != SHT_SYMTAB || shdr.sh_link >= shdrs.size()) continue;
+      const char* strtab = image.data() + shdrs[shdr.sh_link].sh_offset;
+      for(uint32_t off = 0; off + sizeof(Elf32_Sym) <= shdr.sh_size; off += sizeof(Elf32_Sym)) {
+        Elf32_Sym sym;
+        memcpy(&sym, image.data() + shdr.sh_offset + off, sizeof(sym));
+        int type = ELF32_ST_TYPE(sym.st_info);
+        bool code = sym.st_shndx < shdrs.size() && (shdrs[sym.st_shndx].sh_flags & SHF_EXECINSTR);
+        if(!code || (type != STT_FUNC && type != STT_NOTYPE) || strtab[sym.st_name] == '\0') continue;
+        // local labels of the assembler
+        if(type == STT_NOTYPE && (ELF32_ST_BIND(sym.st_info) == STB_LOCAL || strtab[sym.st_name] == '.')) continue;
+        symbols.push_back({sym.st_value, sym.st_value + sym.st_size, strtab + sym.st_name});
+      }
+    }
+
+    std::sort(symbols.begin(), symbols.end(), [](const function_t& a, const function_t& b) {
+      return a.start != b.start ? a.start < b.start : a.end > b.end;
+    });
+    for(size_t i = 0; i < symbols.size(); i++) {
+      // aliases of the same address
+      if(!this->functions.empty() && this->functions.back().start == symbols[i].start) continue;
+      if(!this->functions.empty() && this->functions.back().end > symbols[i].start) this->functions.back().end = symbols[i].start;
+      if(symbols[i].end == symbols[i].start) {
+        size_t j = i + 1;
+        while(j < symbols.size() && symbols[j].start == symbols[i].start) j++;
+        symbols[i].end = j < symbols.size() ? symbols[j].start : symbols[i].start + 4;
+      }
+      this->functions.push_back(symbols[i]);
+    }
+
+    if(this->functions.empty()) {
+      std::cout<<"[TESTBENCH]: ERROR: no function symbols in "<<elf<<", is it stripped?"<<std::endl;
+      return false;
+    }
+    this->functions.push_back({0, 0, "[unknown]"});
+    std::cout<<"[TESTBENCH]: Profiling "<<this->functions.size() - 1<<" functions of "<<elf<<std::endl;
+    return true;
+}
+
+int XHEEP_PcProfiler::lookup(uint32_t pc)
+{
+    auto it = std::upper_bound(this->functions.begin(), this->functions.end() - 1, pc,
+                               [](uint32_t pc, const function_t& f) { return pc < f.start; });
+    if(it != this->functions.begin() && pc < (it - 1)->end) return it - 1 - this->functions.begin();
+    return this->functions.size() - 1;
+}
+
+int XHEEP_PcProfiler::child(int node, int function)
+{
+    auto it = this->nodes[node].children.find(function);
+    if(it != this->nodes[node].children.end()) return it->second;
+
+    node_t n = {};
+    n.function = function;
+    n.parent   = node;
+    n.depth    = this->nodes[node].depth + 1;
+    this->nodes.push_back(n);
+    this->nodes[node].children[function] = this->nodes.size() - 1;
+    return this->nodes.size() - 1;
+}
+
+void XHEEP_PcProfiler::enter(uint32_t pc)
+{
+    int f = this->lookup(pc);
+    const function_t& function = this->functions[f];
+    bool unknown = (size_t)f == this->functions.size() - 1;
+
+    this->current_start = unknown ? pc : function.start;
+    this->current_end   = unknown ? pc + 1 : function.end;
+    if(f == this->nodes[this->current].function) return;
+
+    // call, or tail call, of a function
+    if(!unknown && pc == function.start) {
+      int parent = this->nodes[this->current].depth < MAX_DEPTH ? this->current : this->nodes[this->current].parent;
+      this->current = this->child(parent, f);
+      this->nodes[this->current].calls++;
+      return;
+    }
+
+    // return to a function of the stack, e.g. the end of a call or of an interrupt handler
+    for(int n = this->nodes[this->current].parent; n > 0; n = this->nodes[n].parent) {
+      if(this->nodes[n].function == f) {
+        this->current = n;
+        return;
+      }
+    }
+
+    // jump into another stack, e.g. a context switch of FreeRTOS
+    this->current = this->child(0, f);
+}
+
+void XHEEP_PcProfiler::retire(uint32_t pc)
+{
+    if(pc < this->current_start || pc >= this->current_end) this->enter(pc);
+    if(this->sample_cycles == 0) {
+      this->nodes[this->current].self++;
+      this->samples++;
+    }
+}
+
+void XHEEP_PcProfiler::sample(uint64_t cycle)
+{
+    // the periods skipped by the fast-forward of the sleep are credited to the same function
+    uint64_t n = (cycle - this->next_sample) / this->sample_cycles + 1;
+    this->nodes[this->current].self += n;
+    this->samples += n;
+    this->next_sample += n * this->sample_cycles;
+}
+
+std::string XHEEP_PcProfiler::stack_of(int node)
+{
+    std::string stack;
+    for(int n = node; n > 0; n = this->nodes[n].parent) {
+      stack = this->functions[this->nodes[n].function].name + (stack.empty() ? "" : ";") + stack;
+    }
+    return stack;
+}
+
+bool XHEEP_PcProfiler::write_report(const std::string& report, const std::string& folded)
+{
+    size_t nfunctions = this->functions.size();
+    std::vector<uint64_t> self(nfunctions, 0), total(nfunctions, 0), calls(nfunctions, 0), node_total(this->nodes.size(), 0);
+    // (caller, callee) -> calls, samples of the callee and its children
+    std::map<std::pair<int, int>, std::pair<uint64_t, uint64_t>> edges;
+    std::vector<unsigned int> on_stack(nfunctions, 0);
+
+    // the children are created after their parent, the totals are summed from the leaves
+    for(size_t n = this->nodes.size(); n-- > 0;) {
+      node_total[n] += this->nodes[n].self;
+      if(n > 0) node_total[this->nodes[n].parent] += node_total[n];
+    }
+
+    // depth-first walk, the samples of a recursive function are only counted once in its total
+    std::vector<std::pair<int, bool>> walk = {{0, true}};
+    while(!walk.empty()) {
+      int n = walk.back().first;
+      bool enter = walk.back().second;
+      walk.pop_back();
+      const node_t& node = this->nodes[n];
+      if(n > 0) {
+        int f = node.function;
+        if(!enter) {
+          on_stack[f]--;
+          continue;
+        }
+        if(on_stack[f] == 0) total[f] += node_total[n];
+        on_stack[f]++;
+        self[f]  += node.self;
+        calls[f] += node.calls;
+        auto& edge = edges[{this->nodes[node.parent].function, f}];
+        edge.first  += node.calls;
+        edge.second += node_total[n];
+        walk.push_back({n, false});
+      }
+      for(const auto& c : node.children) walk.push_back({c.second, true});
+    }
+
+    std::ofstream out(report);
+    if(!out.is_open()) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot write "<<report<<std::endl;
+      return false;
+    }
+
+    std::vector<int> order;
+    for(size_t f = 0; f < nfunctions; f++) if(total[f]) order.push_back(f);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return self[a] != self[b] ? self[a] > self[b] : total[a] > total[b]; });
+
+    double scale = this->samples ? 100.0 / this->samples : 0.0;
+    out<<"Flat profile, "<<this->samples<<" samples";
+    if(this->sample_cycles) out<<" of the retired PC every "<<this->sample_cycles<<" cycles"<<std::endl;
+    else out<<", one per retired instruction"<<std::endl;
+    out<<std::endl<<"  %self        self  %total       total       calls  name"<<std::endl;
+    out<<std::fixed<<std::setprecision(2);
+    for(int f : order) {
+      out<<std::setw(7)<<self[f] * scale<<std::setw(12)<<self[f]<<std::setw(8)<<total[f] * scale
+         <<std::setw(12)<<total[f]<<std::setw(12)<<calls[f]<<"  "<<this->functions[f].name<<std::endl;
+    }
+
+    // one entry per function, its callers above and its callees below, like gprof
+    out<<std::endl<<"Call graph, calls and samples of the callee and its children"<<std::endl;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return total[a] > total[b]; });
+    for(int f : order) {
+      out<<std::endl;
+      for(const auto& e : edges) {
+        if(e.first.second != f) continue;
+        std::string caller = e.first.first < 0 ? "<spontaneous>" : this->functions[e.first.first].name;
+        out<<"                "<<std::setw(12)<<e.second.first<<std::setw(12)<<e.second.second<<"      "<<caller<<std::endl;
+      }
+      out<<std::setw(7)<<total[f] * scale<<"%        "<<std::setw(12)<<calls[f]<<std::setw(12)<<total[f]
+         <<"  "<<this->functions[f].name<<std::endl;
+      for(const auto& e : edges) {
+        if(e.first.first != f || e.first.second == f) continue;
+        out<<"                "<<std::setw(12)<<e.second.first<<std::setw(12)<<e.second.second<<"      "
+           <<this->functions[e.first.second].name<<std::endl;
+      }
+    }
+
+    if(!folded.empty()) {
+      std::ofstream stacks(folded);
+      if(!stacks.is_open()) {
+        std::cout<<"[TESTBENCH]: ERROR: cannot write "<<folded<<std::endl;
+        return false;
+      }
+      for(size_t n = 1; n < this->nodes.size(); n++) {
+        if(this->nodes[n].self) stacks<<this->stack_of(n)<<" "<<this->nodes[n].self<<std::endl;
+      }
+    }
+
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef XHEEP_PC_PROFILER_H
+#define XHEEP_PC_PROFILER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Profile of the PC retired by the core, symbolised with the function symbols of the
+// application ELF. The testbench passes every retired PC, which keeps a shadow call stack:
+// entering a function at its first instruction is a call, going back to a function of the
+// stack is a return. Every retired instruction is a sample, or, with a sample period, the
+// function of the last retired instruction is sampled every sample_cycles cycles.
+// The report has a flat profile and a call graph, and the folded stacks can be given to
+// flamegraph.pl.
+class XHEEP_PcProfiler
+{
+
+  public:
+    XHEEP_PcProfiler(uint64_t sample_cycles);
+
+    bool load_symbols(const std::string& elf);  // returns false if the ELF has no function symbols
+    void retire(uint32_t pc);
+    bool due(uint64_t cycle) { return this->sample_cycles && cycle >= this->next_sample; }
+    void sample(uint64_t cycle);
+    bool write_report(const std::string& report, const std::string& folded);
+
+  private:
+    typedef struct {
+      uint32_t start;
+      uint32_t end;
+      std::string name;
+    } function_t;
+
+    // Node of the tree of the call stacks, the root has no function
+    typedef struct {
+      int function;
+      int parent;
+      unsigned int depth;
+      uint64_t self;
+      uint64_t calls;
+      std::map<int, int> children;
+    } node_t;
+
+    int lookup(uint32_t pc);
+    int child(int node, int function);
+    void enter(uint32_t pc);
+    std::string stack_of(int node);
+
+    std::vector<function_t> functions;  // sorted by address, the last one is [unknown]
+    std::vector<node_t> nodes;
+    int current;
+    uint32_t current_start, current_end;
+    uint64_t sample_cycles, next_sample, samples;
+
+};
+
+#endif
@@ -0,0 +1,199 @@
+#include "XHEEP_PowerProfiler.hh"
+#include <iostream>
+#include <sstream>
+
+static const char* state_names[] = {"on", "clkgate", "retentive", "off"};
+
+XHEEP_PowerProfiler::XHEEP_PowerProfiler(unsigned int nbanks, unsigned int nexternal, uint64_t sample_cycles)
+{
+    std::vector<std::string> names = {"cpu", "periph"};
+    for(unsigned int i = 0; i < nbanks; i++) names.push_back("ram" + std::to_string(i));
+    for(unsigned int i = 0; i < nexternal; i++) names.push_back("ext" + std::to_string(i));
+
+    for(const std::string& name : names) {
+      domain_t domain = {};
+      domain.name  = name;
+      domain.state = POWER_ON;
+      this->domains.push_back(domain);
+    }
+
+    this->nbanks        = nbanks;
+    this->sample_cycles = sample_cycles ? sample_cycles : 1;
+    this->next_sample   = 0;
+    this->first_cycle   = 0;
+    this->last_cycle    = 0;
+    this->clock_mhz     = 100.0;
+    this->started       = false;
+    this->last_accesses.assign(nbanks, 0);
+}
+
+XHEEP_PowerProfiler::~XHEEP_PowerProfiler()
+{
+    if(this->trace.is_open()) this->trace.close();
+}
+
+// One entry per line, '#' starts a comment:
+//   clock_mhz <MHz>
+//   <domain> <on|clkgate|retentive|off> <uW>
+//   <ram bank> access <pJ>
+// where <domain> is cpu, periph, ram<i> or ext<i>; ram and ext set all the banks or external domains.
+bool XHEEP_PowerProfiler::load_power_table(const std::string& power_table)
+{
+    std::ifstream file(power_table);
+    std::string line;
+    unsigned int line_number = 0;
+
+    if(!file.is_open()) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot read the power table "<<power_table<<std::endl;
+      return false;
+    }
+
+    while(std::getline(file, line)) {
+      line_number++;
+      line = line.substr(0, line.find('#'));
+      std::istringstream fields(line);
+      std::string name, state;
+      double value;
+
+      if(!(fields >> name)) continue;
+
+      if(name == "clock_mhz") {
+        if(!(fields >> this->clock_mhz) || this->clock_mhz <= 0) {
+          std::cout<<"[TESTBENCH]: ERROR: "<<power_table<<":"<<line_number<<": wrong clock frequency"<<std::endl;
+          return false;
+        }
+        continue;
+      }
+
+      if(!(fields >> state >> value)) {
+        std::cout<<"[TESTBENCH]: ERROR: "<<power_table<<":"<<line_number<<": expected <domain> <state> <value>"<<std::endl;
+        return false;
+      }
+
+      int s = -1;
+      for(int i = 0; i < POWER_STATES; i++) {
+        if(state == state_names[i]) s = i;
+      }
+      if(s < 0 && state != "access") {
+        std::cout<<"[TESTBENCH]: ERROR: "<<power_table<<":"<<line_number<<": unknown state "<<state<<std::endl;
+        return false;
+      }
+
+      bool found = false;
+      for(domain_t& domain : this->domains) {
+        bool group = (name == "ram" || name == "ext") && domain.name.compare(0, name.size(), name) == 0;
+        if(domain.name != name && !group) continue;
+        if(s < 0) domain.access_energy = value;
+        else domain.power[s] = value;
+        found = true;
+      }
+      // the table can describe more banks or external domains than the configuration has
+      if(!found && name.compare(0, 3, "ram") != 0 && name.compare(0, 3, "ext") != 0) {
+        std::cout<<"[TESTBENCH]: ERROR: "<<power_table<<":"<<line_number<<": unknown domain "<<name<<std::endl;
+        return false;
+      }
+    }
+
+    std::cout<<"[TESTBENCH]: Power table "<<power_table<<" loaded, clock at "<<this->clock_mhz<<" MHz"<<std::endl;
+    return true;
+}
+
+bool XHEEP_PowerProfiler::open_trace(const std::string& power_trace)
+{
+    this->trace.open(power_trace);
+    if(!this->trace.is_open()) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot write "<<power_trace<<std::endl;
+      return false;
+    }
+
+    this->trace<<"cycle";
+    for(const domain_t& domain : this->domains) this->trace<<","<<domain.name;
+    for(unsigned int i = 0; i < this->nbanks; i++) this->trace<<",ram"<<i<<"_accesses";
+    this->trace<<std::endl;
+    return true;
+}
+
+void XHEEP_PowerProfiler::sample(uint64_t cycle, const sample_t& state, const std::vector<uint64_t>& bank_accesses)
+{
+    std::vector<power_state_t> states;
+
+    states.push_back(state.cpu_off ? POWER_OFF : state.cpu_sleep ? POWER_CLKGATE : POWER_ON);
+    states.push_back(state.periph_off ? POWER_OFF : state.periph_clkgate ? POWER_CLKGATE : POWER_ON);
+    for(unsigned int i = 0; i < this->nbanks; i++) {
+      states.push_back((state.banks_off >> i & 1) ? POWER_OFF : (state.banks_retentive >> i & 1) ? POWER_RETENTIVE :
+                       (state.banks_clkgate >> i & 1) ? POWER_CLKGATE : POWER_ON);
+    }
+    for(unsigned int i = 0; i + 2 + this->nbanks < this->domains.size(); i++) {
+      states.push_back((state.ext_off >> i & 1) ? POWER_OFF : (state.ext_retentive >> i & 1) ? POWER_RETENTIVE :
+                       (state.ext_clkgate >> i & 1) ? POWER_CLKGATE : POWER_ON);
+    }
+
+    // the cycles since the previous sample were spent in the previous state
+    uint64_t elapsed = this->started ? cycle - this->last_cycle : 0;
+    for(size_t d = 0; d < this->domains.size(); d++) {
+      domain_t& domain = this->domains[d];
+      domain.cycles[domain.state] += elapsed;
+      if(this->started && domain.state != states[d]) domain.transitions++;
+      domain.state = states[d];
+    }
+
+    std::vector<uint64_t> delta(this->nbanks, 0);
+    for(unsigned int i = 0; i < this->nbanks && i < bank_accesses.size(); i++) {
+      delta[i] = bank_accesses[i] - this->last_accesses[i];
+      this->domains[2 + i].accesses += delta[i];
+      this->last_accesses[i] = bank_accesses[i];
+    }
+
+    if(this->trace.is_open()) {
+      this->trace<<cycle;
+      for(const domain_t& domain : this->domains) this->trace<<","<<state_names[domain.state];
+      for(unsigned int i = 0; i < this->nbanks; i++) this->trace<<","<<delta[i];
+      this->trace<<std::endl;
+    }
+
+    if(!this->started) this->first_cycle = cycle;
+    this->started     = true;
+    this->last_cycle  = cycle;
+    this->next_sample = cycle + this->sample_cycles;
+}
+
+bool XHEEP_PowerProfiler::write_report(const std::string& power_report)
+{
+    std::ofstream json(power_report);
+    double total_energy = 0;
+    uint64_t cycles = this->last_cycle - this->first_cycle;
+
+    if(!json.is_open()) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot write "<<power_report<<std::endl;
+      return false;
+    }
+
+    json<<"{"<<std::endl;
+    json<<"  \"cycles\": "<<cycles<<","<<std::endl;
+    json<<"  \"sample_cycles\": "<<this->sample_cycles<<","<<std::endl;
+    json<<"  \"clock_mhz\": "<<this->clock_mhz<<","<<std::endl;
+    json<<"  \"domains\": {"<<std::endl;
+    for(size_t d = 0; d < this->domains.size(); d++) {
+      const domain_t& domain = this->domains[d];
+      // uW * us = pJ
+      double energy = domain.accesses * domain.access_energy;
+      for(int s = 0; s < POWER_STATES; s++) energy += domain.power[s] * domain.cycles[s] / this->clock_mhz;
+      total_energy += energy;
+
+      json<<"    \""<<domain.name<<"\": {";
+      for(int s = 0; s < POWER_STATES; s++) {
+        json<<" \""<<state_names[s]<<"\": { \"cycles\": "<<domain.cycles[s]<<", \"residency\": "
+            <<(cycles ? (double)domain.cycles[s] / cycles : 0.0)<<" },";
+      }
+      if(d >= 2 && d < 2 + this->nbanks) json<<" \"accesses\": "<<domain.accesses<<",";
+      json<<" \"transitions\": "<<domain.transitions<<", \"energy_pj\": "<<energy<<" }"
+          <<(d < this->domains.size() - 1 ? "," : "")<<std::endl;
+    }
+    json<<"  },"<<std::endl;
+    json<<"  \"energy_pj\": "<<total_energy<<","<<std::endl;
+    json<<"  \"average_power_uw\": "<<(cycles ? total_energy * this->clock_mhz / cycles : 0.0)<<std::endl;
+    json<<"}"<<std::endl;
+
+    std::cout<<"[TESTBENCH]: Estimated energy "<<total_energy<<" pJ, written to "<<power_report<<std::endl;
+    return true;
+}
@@ -0,0 +1,70 @@
+#ifndef XHEEP_POWER_PROFILER_H
+#define XHEEP_POWER_PROFILER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Residency of the power domains (CPU, peripheral subsystem, RAM banks and
+// external domains) in their on, clock gated, retentive and off states, and
+// energy estimate from a table of the power of each state and the energy of a
+// RAM bank access. The testbench samples the state every sample_cycles cycles,
+// the cycles since the previous sample are counted in the previous state.
+class XHEEP_PowerProfiler
+{
+
+  public:
+    typedef enum {
+      POWER_ON,
+      POWER_CLKGATE,
+      POWER_RETENTIVE,
+      POWER_OFF,
+      POWER_STATES
+    } power_state_t;
+
+    // Power state read with tb_getPowerState, the masks have one bit per bank or external domain
+    typedef struct {
+      bool cpu_off;
+      bool cpu_sleep;
+      bool periph_off;
+      bool periph_clkgate;
+      uint32_t banks_off;
+      uint32_t banks_retentive;
+      uint32_t banks_clkgate;
+      uint32_t ext_off;
+      uint32_t ext_retentive;
+      uint32_t ext_clkgate;
+    } sample_t;
+
+    XHEEP_PowerProfiler(unsigned int nbanks, unsigned int nexternal, uint64_t sample_cycles);
+    ~XHEEP_PowerProfiler();
+
+    bool load_power_table(const std::string& power_table); // returns false if the file cannot be parsed
+    bool open_trace(const std::string& power_trace);       // CSV of the states and bank accesses at each sample
+    bool due(uint64_t cycle) { return cycle >= this->next_sample; }
+    void sample(uint64_t cycle, const sample_t& state, const std::vector<uint64_t>& bank_accesses);
+    bool write_report(const std::string& power_report);    // JSON of the residency and energy
+
+  private:
+    typedef struct {
+      std::string name;
+      uint64_t cycles[POWER_STATES];
+      double power[POWER_STATES];  // uW
+      double access_energy;        // pJ, RAM banks only
+      uint64_t accesses;
+      uint64_t transitions;
+      power_state_t state;
+    } domain_t;
+
+    std::vector<domain_t> domains;
+    unsigned int nbanks;
+    uint64_t sample_cycles, next_sample, first_cycle, last_cycle;
+    double clock_mhz;
+    bool started;
+    std::vector<uint64_t> last_accesses;
+    std::ofstream trace;
+
+};
+
+#endif
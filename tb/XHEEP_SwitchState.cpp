@@ -0,0 +1,153 @@
+#include "XHEEP_SwitchState.hh"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+#define CSR_MSTATUS     0x300
+#define CSR_MEPC        0x341
+#define MSTATUS_MIE     (1u << 3)
+#define MSTATUS_MPIE    (1u << 7)
+#define MSTATUS_MPP     (3u << 11)
+
+// registers used by the restore program before the registers of the core are loaded
+#define REG_T0 5
+#define REG_T1 6
+#define REG_T6 31
+
+static uint32_t lui(unsigned int rd, uint32_t imm20)                   { return (imm20 & 0xFFFFF) << 12 | rd << 7 | 0x37; }
+static uint32_t addi(unsigned int rd, unsigned int rs1, int32_t imm)   { return ((uint32_t)imm & 0xFFF) << 20 | rs1 << 15 | rd << 7 | 0x13; }
+static uint32_t lw(unsigned int rd, unsigned int rs1, int32_t imm)     { return ((uint32_t)imm & 0xFFF) << 20 | rs1 << 15 | 2 << 12 | rd << 7 | 0x03; }
+static uint32_t sw(unsigned int rs2, unsigned int rs1, int32_t imm)    { return ((uint32_t)imm >> 5 & 0x7F) << 25 | rs2 << 20 | rs1 << 15 | 2 << 12 | ((uint32_t)imm & 0x1F) << 7 | 0x23; }
+static uint32_t csrw(uint32_t csr, unsigned int rs1)                   { return csr << 20 | rs1 << 15 | 1 << 12 | 0x73; }
+
+#define INSN_FENCE 0x0FF0000F
+#define INSN_MRET  0x30200073
+
+static void li(std::vector<uint32_t>& words, unsigned int rd, uint32_t value)
+{
+    uint32_t hi = (value + 0x800) >> 12;
+    int32_t  lo = (int32_t)(value << 20) >> 20;
+    if(hi == 0) {
+      words.push_back(addi(rd, 0, lo));
+      return;
+    }
+    words.push_back(lui(rd, hi));
+    if(lo != 0) words.push_back(addi(rd, rd, lo));
+}
+
+XHEEP_SwitchState::XHEEP_SwitchState()
+{
+    this->pc       = 0;
+    memset(this->x, 0, sizeof(this->x));
+    this->ram_base = 0;
+    this->cycle    = 0;
+}
+
+bool XHEEP_SwitchState::write(const std::string& file)
+{
+    std::ofstream out(file);
+    if(!out.is_open()) return false;
+
+    out<<"# X-HEEP state at the switch from the virtual platform, see tb/XHEEP_SwitchState.hh"<<std::endl;
+    out<<"cycle "<<this->cycle<<std::endl;
+    out<<std::hex;
+    out<<"pc 0x"<<this->pc<<std::endl;
+    for(unsigned int i = 1; i < 32; i++)
+      out<<"x "<<std::dec<<i<<std::hex<<" 0x"<<this->x[i]<<std::endl;
+    for(size_t i = 0; i < this->csrs.size(); i++)
+      out<<"csr 0x"<<this->csrs[i].first<<" 0x"<<this->csrs[i].second<<std::endl;
+    for(size_t i = 0; i < this->regs.size(); i++)
+      out<<"reg 0x"<<this->regs[i].first<<" 0x"<<this->regs[i].second<<std::endl;
+    out<<"ram 0x"<<this->ram_base<<" "<<std::dec<<this->ram.size()<<std::hex<<std::endl;
+    for(size_t i = 0; i < this->ram.size(); i++)
+      out<<this->ram[i]<<((i % 8 == 7 || i == this->ram.size() - 1) ? "\n" : " ");
+    return out.good();
+}
+
+bool XHEEP_SwitchState::read(const std::string& file)
+{
+    std::ifstream in(file);
+    std::string line;
+
+    if(!in.is_open()) {
+      std::cout<<"[TESTBENCH]: ERROR: cannot open "<<file<<std::endl;
+      return false;
+    }
+
+    while(std::getline(in, line)) {
+      std::istringstream fields(line);
+      std::string key;
+      if(!(fields>>key) || key[0] == '#') continue;
+
+      if(key == "cycle") {
+        fields>>std::dec>>this->cycle;
+      } else if(key == "pc") {
+        fields>>std::hex>>this->pc;
+      } else if(key == "x") {
+        unsigned int i;
+        uint32_t value;
+        if(fields>>std::dec>>i>>std::hex>>value && i < 32) this->x[i] = value;
+      } else if(key == "csr" || key == "reg") {
+        write_t w;
+        fields>>std::hex>>w.first>>w.second;
+        (key == "csr" ? this->csrs : this->regs).push_back(w);
+      } else if(key == "ram") {
+        size_t count;
+        fields>>std::hex>>this->ram_base>>std::dec>>count;
+        this->ram.resize(count);
+        for(size_t i = 0; i < count; i++) in>>std::hex>>this->ram[i];
+      } else {
+        std::cout<<"[TESTBENCH]: ERROR: unknown line in "<<file<<": "<<line<<std::endl;
+        return false;
+      }
+      if(fields.fail() || in.bad()) {
+        std::cout<<"[TESTBENCH]: ERROR: cannot parse "<<file<<": "<<line<<std::endl;
+        return false;
+      }
+    }
+    return true;
+}
+
+uint32_t XHEEP_SwitchState::restore_program(uint32_t address, std::vector<uint32_t>& words)
+{
+    uint32_t mstatus = MSTATUS_MPP;
+
+    words.clear();
+
+    // the peripherals first, with the interrupts of the core still disabled
+    for(size_t i = 0; i < this->regs.size(); i++) {
+      li(words, REG_T0, this->regs[i].first);
+      li(words, REG_T1, this->regs[i].second);
+      words.push_back(sw(REG_T1, REG_T0, 0));
+    }
+    words.push_back(INSN_FENCE);
+
+    for(size_t i = 0; i < this->csrs.size(); i++) {
+      if(this->csrs[i].first == CSR_MSTATUS) {
+        mstatus = this->csrs[i].second;
+        continue;
+      }
+      if(this->csrs[i].first == CSR_MEPC) continue;
+      li(words, REG_T0, this->csrs[i].second);
+      words.push_back(csrw(this->csrs[i].first, REG_T0));
+    }
+
+    // mret enables the interrupts again and jumps to pc, mepc and MPIE are lost
+    li(words, REG_T0, this->pc);
+    words.push_back(csrw(CSR_MEPC, REG_T0));
+    li(words, REG_T0, ((mstatus & MSTATUS_MIE) ? MSTATUS_MPIE : 0) | MSTATUS_MPP);
+    words.push_back(csrw(CSR_MSTATUS, REG_T0));
+
+    // the registers are loaded from the words following the program, t6 last as it holds their address
+    uint32_t mret_address = address + 4 * (words.size() + 2 + 31);
+    uint32_t slots        = mret_address + 4;
+    words.push_back(lui(REG_T6, (slots + 0x800) >> 12));
+    words.push_back(addi(REG_T6, REG_T6, (int32_t)(slots << 20) >> 20));
+    for(unsigned int i = 1; i < 32; i++) words.push_back(lw(i, REG_T6, 4 * (i - 1)));
+    words.push_back(INSN_MRET);
+
+    for(unsigned int i = 1; i < 32; i++) words.push_back(this->x[i]);
+
+    return mret_address;
+}
@@ -0,0 +1,41 @@
+#ifndef XHEEP_SWITCH_STATE_H
+#define XHEEP_SWITCH_STATE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Architectural state of X-HEEP handed from the virtual platform (make vp, +vp_switch) to the
+// Verilator model (+vp_state): the registers and CSRs of the core, the RAM and the register
+// writes that bring the peripherals to their state.
+//
+// The RTL is not written through its hierarchy: the testbench loads the RAM and, at the boot
+// address, a restore program built by restore_program(). The program does the register writes
+// of the peripherals, writes the CSRs, loads the registers of the core and returns to pc with
+// mret. Once the mret retires, the words of the RAM it covered are written back.
+class XHEEP_SwitchState
+{
+
+  public:
+    typedef std::pair<uint32_t, uint32_t> write_t; // address or CSR number, value
+
+    uint32_t pc;
+    uint32_t x[32];
+    std::vector<write_t> csrs;      // written in this order, mstatus and mepc excepted
+    std::vector<write_t> regs;      // register writes of the peripherals, in this order
+    uint32_t ram_base;
+    std::vector<uint32_t> ram;      // words from ram_base
+    uint64_t cycle;                 // cycle of the virtual platform at the switch
+
+    XHEEP_SwitchState();
+
+    bool write(const std::string& file);
+    bool read(const std::string& file); // returns false if the file cannot be parsed
+
+    // Restore program placed at address, returns the address of its final mret
+    uint32_t restore_program(uint32_t address, std::vector<uint32_t>& words);
+
+};
+
+#endif
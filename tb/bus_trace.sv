@@ -0,0 +1,66 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+//
+// File: bus_trace.sv
+// Description: trace of the transactions of the masters of the system crossbar, written when the
+//              simulation is run with +bus_trace=<file>. Each granted transaction is a line
+//                <request cycle> <grant cycle> <master> <address> <r|w>
+//              the request cycle being the first cycle the master asked for it. The trace is read
+//              by util/mcu_gen.py --analyze_trace, see docs/source/Configuration/Configuration.rst.
+
+module bus_trace #(
+    parameter int unsigned NMASTER = 1,
+    parameter int unsigned SYSTEM_NMASTER = 1
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input obi_pkg::obi_req_t  [NMASTER-1:0] master_req_i,
+    input obi_pkg::obi_resp_t [NMASTER-1:0] master_resp_i
+);
+
+  int fd;
+  string filename;
+  logic [63:0] cycle_q;
+  logic [NMASTER-1:0] pending_q;
+  logic [NMASTER-1:0][63:0] start_q;
+
+  initial begin
+    fd = 0;
+    if ($value$plusargs("bus_trace=%s", filename)) begin
+      fd = $fopen(filename, "w");
+      $fdisplay(fd, "# x-heep bus trace, masters %0d, system masters %0d", NMASTER, SYSTEM_NMASTER);
+      $fdisplay(fd, "# request_cycle grant_cycle master address r/w");
+    end
+  end
+
+  final begin
+    if (fd != 0) $fclose(fd);
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      cycle_q   <= '0;
+      pending_q <= '0;
+      start_q   <= '0;
+    end else begin
+      cycle_q <= cycle_q + 64'd1;
+      for (int i = 0; i < NMASTER; i++) begin
+        if (master_req_i[i].req) begin
+          if (master_resp_i[i].gnt) begin
+            pending_q[i] <= 1'b0;
+            if (fd != 0) begin
+              $fdisplay(fd, "%0d %0d %0d %08x %s", pending_q[i] ? start_q[i] : cycle_q, cycle_q, i,
+                        master_req_i[i].addr, master_req_i[i].we ? "w" : "r");
+            end
+          end else if (!pending_q[i]) begin
+            pending_q[i] <= 1'b1;
+            start_q[i]   <= cycle_q;
+          end
+        end
+      end
+    end
+  end
+
+endmodule  // bus_trace
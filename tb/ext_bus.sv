@@ -84,6 +84,10 @@ module ext_bus #(
   assign master_req[DMA_WRITE_CH0_IDX] = heep_dma_write_ch0_req_i;
   assign master_req[DMA_ADDR_CH0_IDX] = heep_dma_addr_ch0_req_i;
   generate
+    // the extra harts of the cluster only reach the internal slaves
+    for (genvar i = DMA_ADDR_CH0_IDX + 1; i < SYSTEM_XBAR_NMASTER; i++) begin : gen_hart_master_req_tie
+      assign master_req[i] = '0;
+    end
     for (genvar i = 0; i < EXT_XBAR_NMASTER; i++) begin : gen_ext_master_req_map
       assign master_req[SYSTEM_XBAR_NMASTER+i] = demux_xbar_req[i][DEMUX_XBAR_EXT_SLAVE_IDX];
     end
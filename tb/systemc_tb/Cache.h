@@ -5,15 +5,30 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
 
 
-// Target module representing a simple direct mapped cache
+// Target module representing a simple N-way set associative cache (direct mapped by default)
 class CacheMemory
 {
 
 public:
+  // Replacement policies, selected with +cache_policy=lru|plru|fifo|random
+  typedef enum {
+    REPLACEMENT_LRU,    // least recently used way
+    REPLACEMENT_PLRU,   // tree pseudo-LRU, ways must be a power of 2
+    REPLACEMENT_FIFO,   // oldest added way
+    REPLACEMENT_RANDOM  // random way
+  } replacement_policy_t;
+
   uint32_t cache_size_byte    = 4*1024;
   uint32_t number_of_blocks   = 256;
+  uint32_t number_of_ways     = 1;
+  uint32_t number_of_sets     = 0;
+  replacement_policy_t replacement_policy = REPLACEMENT_LRU;
 
   uint32_t nbits_blocks       = 0;
   uint32_t nbits_tags         = 0;
@@ -27,49 +42,93 @@ public:
   typedef struct cache_line {
     uint32_t tag;
     bool    valid;
+    bool    dirty;        // written since it was added, must be written back
+    bool    prefetched;   // added by the prefetcher and not accessed yet
     uint8_t* data;
+    uint64_t last_access; // LRU
+    uint64_t added;       // FIFO
   } cache_line_t;
 
+  // lines are stored set by set, line i belongs to set i / number_of_ways
   cache_line_t* cache_array;
+  // data of all the lines, line i at i * block_size_byte
+  uint8_t* data_arena;
+  // pseudo-LRU tree of each set, bit set means the victim is in the upper half
+  uint32_t* plru_tree;
+  uint64_t access_counter = 0;
 
 
-  CacheMemory(): cacheFile("cache_status.log")
+  CacheMemory(const char* status_file = "cache_status.log"): cacheFile(status_file)
   {
     cache_array = NULL;
+    plru_tree   = NULL;
+    data_arena  = NULL;
+  }
+
+  static bool parse_replacement_policy(const std::string& name, replacement_policy_t& policy) {
+    if(name == "lru")         policy = REPLACEMENT_LRU;
+    else if(name == "plru")   policy = REPLACEMENT_PLRU;
+    else if(name == "fifo")   policy = REPLACEMENT_FIFO;
+    else if(name == "random") policy = REPLACEMENT_RANDOM;
+    else return false;
+    return true;
   }
 
   void create_cache() {
-      cache_array = new cache_line_t[number_of_blocks];
-      this->block_size_byte = get_block_size();
-      this->nbits_blocks    = log2(block_size_byte);
-      this->nbits_index     = log2(number_of_blocks);
-      this->nbits_tags      = ARCHITECTURE_bits - nbits_index - nbits_blocks;
+      create_cache(cache_size_byte, number_of_blocks);
       printf("bits block %d, index %d, tags %d\n",nbits_blocks, nbits_index, nbits_tags );
   }
 
   void create_cache(uint32_t cache_size_byte, uint32_t number_of_blocks) {
-      this->cache_size_byte = cache_size_byte;
-      this->number_of_blocks = number_of_blocks;
+      create_cache(cache_size_byte, number_of_blocks, 1, REPLACEMENT_LRU);
+  }
+
+  void create_cache(uint32_t cache_size_byte, uint32_t number_of_blocks, uint32_t number_of_ways, replacement_policy_t replacement_policy) {
+      this->cache_size_byte    = cache_size_byte;
+      this->number_of_blocks   = number_of_blocks;
+      this->number_of_ways     = number_of_ways;
+      this->number_of_sets     = number_of_blocks / number_of_ways;
+      this->replacement_policy = replacement_policy;
       cache_array = new cache_line_t[number_of_blocks];
+      plru_tree   = new uint32_t[number_of_sets];
       this->block_size_byte = get_block_size();
       this->nbits_blocks    = log2(block_size_byte);
-      this->nbits_index     = log2(number_of_blocks);
+      this->nbits_index     = log2(number_of_sets);
       this->nbits_tags      = ARCHITECTURE_bits - nbits_index - nbits_blocks;
   }
 
+  // Returns an error message if the geometry cannot be built, empty otherwise
+  static std::string check_geometry(uint32_t cache_size_byte, uint32_t block_size_byte, uint32_t number_of_ways, replacement_policy_t replacement_policy) {
+    auto is_pow2 = [](uint32_t x) { return x != 0 && (x & (x - 1)) == 0; };
+    if(!is_pow2(cache_size_byte) || !is_pow2(block_size_byte) || block_size_byte < 4 || block_size_byte > cache_size_byte)
+      return "cache size and block size must be powers of 2, with 4 <= block size <= cache size";
+    if(!is_pow2(number_of_ways) || number_of_ways > cache_size_byte / block_size_byte)
+      return "the number of ways must be a power of 2, at most the number of blocks";
+    if(replacement_policy == REPLACEMENT_PLRU && number_of_ways > 32)
+      return "pseudo-LRU supports up to 32 ways";
+    return "";
+  }
+
   uint32_t initialize_cache() {
       if(cache_array == NULL) {
         return -1;
       }
       // Initialize memory with random data
+      data_arena = new uint8_t[number_of_blocks * block_size_byte];
       for (int i = 0; i < number_of_blocks; i++) {
         cache_array[i].valid = false;
+        cache_array[i].dirty = false;
+        cache_array[i].prefetched = false;
         cache_array[i].tag   = 0;
-        cache_array[i].data = new uint8_t[block_size_byte];
+        cache_array[i].last_access = 0;
+        cache_array[i].added = 0;
+        cache_array[i].data = &data_arena[i * block_size_byte];
         for(int j = 0; j<block_size_byte;j++) {
           cache_array[i].data[j] = (uint8_t)(i*j);
         }
       }
+      for (int i = 0; i < number_of_sets; i++)
+        plru_tree[i] = 0;
       return 0;
   }
 
@@ -77,6 +136,7 @@ public:
     return (uint32_t)(cache_size_byte / number_of_blocks);
   }
 
+  // set of the address
   uint32_t get_index(uint32_t address) {
     uint32_t mask_index = (1 << nbits_index) - 1;
     return (uint32_t)((address >> nbits_blocks) & mask_index );
@@ -99,83 +159,187 @@ public:
     return cache_array[index].tag;
   }
 
+  // line holding the address, -1 on miss
+  int32_t find_line(uint32_t address) {
+    uint32_t first = get_index(address) * number_of_ways;
+    uint32_t tag   = get_tag(address);
+    for(uint32_t way = 0; way < number_of_ways; way++) {
+      if(cache_array[first + way].valid && cache_array[first + way].tag == tag)
+        return first + way;
+    }
+    return -1;
+  }
 
   bool cache_hit(uint32_t address) {
-    uint32_t index = get_index(address);
-    uint32_t tag   = get_tag(address);
-    return ( cache_array[index].valid && tag == cache_array[index].tag);
+    return find_line(address) >= 0;
+  }
 
+  // updates the replacement state of a line on a hit or a refill
+  void touch_line(uint32_t line) {
+    uint32_t set = line / number_of_ways;
+    uint32_t way = line % number_of_ways;
+    cache_array[line].last_access = ++access_counter;
+    // walk the tree from the root, pointing every node away from the accessed way
+    for(uint32_t node = 1, half = number_of_ways >> 1; half > 0; half >>= 1) {
+      bool upper = way & half;
+      if(upper) plru_tree[set] &= ~(1u << node);
+      else      plru_tree[set] |=  (1u << node);
+      node = 2 * node + (upper ? 1 : 0);
+    }
   }
 
-  void add_entry(uint32_t address, uint8_t* new_data) {
-    uint32_t index = get_index(address);
-    uint32_t tag   = get_tag(address);
+  // line to be replaced to add the address, an invalid way if any
+  uint32_t get_victim(uint32_t address) {
+    uint32_t set   = get_index(address);
+    uint32_t first = set * number_of_ways;
+    uint32_t victim = first;
+
+    for(uint32_t way = 0; way < number_of_ways; way++) {
+      if(!cache_array[first + way].valid) return first + way;
+    }
+
+    switch(replacement_policy) {
+      case REPLACEMENT_PLRU: {
+        uint32_t way = 0;
+        for(uint32_t node = 1, half = number_of_ways >> 1; half > 0; half >>= 1) {
+          bool upper = plru_tree[set] & (1u << node);
+          if(upper) way |= half;
+          node = 2 * node + (upper ? 1 : 0);
+        }
+        victim = first + way;
+        break;
+      }
+      case REPLACEMENT_FIFO:
+        for(uint32_t way = 1; way < number_of_ways; way++) {
+          if(cache_array[first + way].added < cache_array[victim].added) victim = first + way;
+        }
+        break;
+      case REPLACEMENT_RANDOM:
+        victim = first + (rand() % number_of_ways);
+        break;
+      default:
+        for(uint32_t way = 1; way < number_of_ways; way++) {
+          if(cache_array[first + way].last_access < cache_array[victim].last_access) victim = first + way;
+        }
+        break;
+    }
+    return victim;
+  }
+
+  void add_entry_at_index(uint32_t index, uint32_t address, uint8_t* new_data) {
     cache_array[index].valid = true;
-    cache_array[index].tag   = tag;
+    cache_array[index].dirty = false;
+    cache_array[index].prefetched = false;
+    cache_array[index].tag   = get_tag(address);
+    cache_array[index].added = ++access_counter;
     memcpy(cache_array[index].data, new_data, block_size_byte);
+    touch_line(index);
+  }
+
+  // adds the address in the line holding it, or in the victim line
+  void add_entry(uint32_t address, uint8_t* new_data) {
+    int32_t line = find_line(address);
+    add_entry_at_index(line >= 0 ? line : get_victim(address), address, new_data);
   }
 
   void get_data(uint32_t address, uint8_t* new_data) {
-    uint32_t index = get_index(address);
-    memcpy(new_data, cache_array[index].data, block_size_byte);
+    int32_t line = find_line(address);
+    memcpy(new_data, cache_array[line >= 0 ? line : get_victim(address)].data, block_size_byte);
   }
 
   void get_data_at_index(uint32_t index, uint8_t* new_data) {
     memcpy(new_data, cache_array[index].data, block_size_byte);
   }
 
-  uint32_t get_address(uint32_t address){
-    uint32_t index = get_index(address);
+  uint32_t get_address_at_index(uint32_t index){
     uint32_t tag   = cache_array[index].tag;
-    uint32_t new_address = (tag << (nbits_index+nbits_blocks)) | (index<<nbits_blocks); //<<2 as words
+    uint32_t set   = index / number_of_ways;
+    uint32_t new_address = tag << (nbits_index+nbits_blocks) | (set<<nbits_blocks); //<<2 as words
     return new_address;
   }
 
-  uint32_t get_address_at_index(uint32_t index){
-    uint32_t tag   = cache_array[index].tag;
-    uint32_t new_address = tag << (nbits_index+nbits_blocks) | (index<<nbits_blocks); //<<2 as words
-    return new_address;
+  // address held by the line holding the address, or by the victim line
+  uint32_t get_address(uint32_t address){
+    int32_t line = find_line(address);
+    return get_address_at_index(line >= 0 ? line : get_victim(address));
+  }
+
+  // in-place accessors of a line found with find_line, they update the replacement state
+  int32_t get_word_at_index(uint32_t index, uint32_t address) {
+    touch_line(index);
+    return *((int32_t *)&cache_array[index].data[get_block_offset(address) & ~3u]);
+  }
+
+  // writes the bytes of data_word selected by the byte enables be
+  void set_word_at_index(uint32_t index, uint32_t address, int32_t data_word, uint32_t be = 0xF) {
+    uint8_t* word = &cache_array[index].data[get_block_offset(address) & ~3u];
+    touch_line(index);
+    cache_array[index].dirty = true;
+    if (be == 0xF) {
+      *((int32_t *)word) = data_word;
+    } else {
+      for (int j = 0; j < 4; j++)
+        if ((be >> j) & 1) word[j] = (uint8_t)(data_word >> (8*j));
+    }
+  }
+
+  uint8_t get_byte_at_index(uint32_t index, uint32_t address) {
+    touch_line(index);
+    return cache_array[index].data[get_block_offset(address)];
+  }
+
+  void set_byte_at_index(uint32_t index, uint32_t address, uint8_t data_byte) {
+    touch_line(index);
+    cache_array[index].dirty = true;
+    cache_array[index].data[get_block_offset(address)] = data_byte;
   }
 
   int32_t get_word(uint32_t address) {
-    int32_t data_word = 0;
+    int32_t line = find_line(address);
     uint32_t block_offset = this->get_block_offset(address);
-    uint8_t* new_data = new uint8_t[block_size_byte];
-    this->get_data(address, new_data);
-    data_word = *((int32_t *)&new_data[block_offset]);
-    delete new_data;
-    return data_word;
+    if(line < 0) return 0;
+    touch_line(line);
+    return *((int32_t *)&cache_array[line].data[block_offset]);
   }
 
   void set_word(uint32_t address, int32_t data_word) {
+    int32_t line = find_line(address);
     uint32_t block_offset = this->get_block_offset(address);
-    uint8_t* new_data = new uint8_t[block_size_byte];
-    this->get_data(address, new_data);
-    *((int32_t *)&new_data[block_offset]) = data_word;
-    for(int i=0;i<block_size_byte;i++)
-    this->add_entry(address, new_data);
-    delete new_data;
+    if(line < 0) return;
+    touch_line(line);
+    cache_array[line].dirty = true;
+    *((int32_t *)&cache_array[line].data[block_offset]) = data_word;
   }
 
   bool is_entry_valid(uint32_t address) {
-    uint32_t index = get_index(address);
-    return cache_array[index].valid;
+    int32_t line = find_line(address);
+    return line >= 0 || cache_array[get_victim(address)].valid;
   }
 
   bool is_entry_valid_at_index(uint32_t index) {
     return cache_array[index].valid;
   }
 
+  bool is_entry_dirty_at_index(uint32_t index) {
+    return cache_array[index].valid && cache_array[index].dirty;
+  }
+
+  // called once the line is written back
+  void clean_entry_at_index(uint32_t index) {
+    cache_array[index].dirty = false;
+  }
+
   void print_cache_status(uint32_t operation_id, std::string time_str) {
     if (cacheFile.is_open()) {
       std::string log_cache = "";
       std::ostringstream ss;
 
       log_cache+= std::to_string(operation_id) + "):  " + time_str + "\n";
-      log_cache+= "INDEX | TAG | DATA BLOCK | VALID\n";
+      log_cache+= "INDEX | TAG | DATA BLOCK | VALID | DIRTY\n";
 
       for(int i=0;i<number_of_blocks;i++) {
-        ss << "0x" << std::setw(this->nbits_index/4) << std::setfill('0') << std::hex << static_cast<uint32_t>(i);
+        ss << "0x" << std::setw(this->nbits_index/4) << std::setfill('0') << std::hex << static_cast<uint32_t>(i / number_of_ways);
+        if(number_of_ways > 1) ss << "." << std::dec << (i % number_of_ways);
         log_cache+= ss.str() + " | ";
         ss.str("");
         ss.clear();
@@ -186,7 +350,8 @@ public:
         for(int j = 0; j<block_size_byte; j++)
           ss << ":" << std::setw(2) << std::setfill('0') << std::hex << static_cast<uint16_t>(cache_array[i].data[j]);
         log_cache+= ss.str() + " | ";
-        log_cache+= std::string( cache_array[i].valid ? "1" : "0" ) + "\n";
+        log_cache+= std::string( cache_array[i].valid ? "1" : "0" ) + " | ";
+        log_cache+= std::string( cache_array[i].dirty ? "1" : "0" ) + "\n";
 
         cacheFile << log_cache;
         ss.str("");
@@ -202,7 +367,7 @@ public:
     0x7052 = 'b111_0000_0101_0010'
 
     cache size = 4KB,
-    number_of_blocks = 256, thus index is on 8bit
+    number_of_blocks = 256, direct mapped, thus index is on 8bit
     block_size_in_byte = 4KB/256 = 16bytes, i.e. 4 words
 
     111:       tag
@@ -214,6 +379,8 @@ public:
       get_index(0x7052) --> 0x5
       get_block_offset(0x7052) --> 0x2
 
+    With 4 ways, there are 64 sets, the index is on 6 bits and the tag on 22 bits.
+    The lines of a set are stored contiguously: line = get_index(address) * ways + way.
 
   */
 };
@@ -11,56 +11,225 @@ using namespace std;
 
 #include "tlm.h"
 #include "tlm_utils/simple_target_socket.h"
+#include "tlm_utils/peq_with_cb_and_phase.h"
 
+#include "MemoryTiming.h"
 
-// Target module representing a simple direct mapped cache
+#include <deque>
+#include <fstream>
+#include <vector>
+
+
+// Target module representing the external memory, allocated in pages on first touch
 SC_MODULE(MainMemory)
 {
   // TLM-2 socket, defaults to 32-bits wide, base protocol
   tlm_utils::simple_target_socket<MainMemory> socket;
 
-  enum { SIZE = 32*1024/4 }; //32KB word addressable
+  enum { PAGE_SIZE = 4*1024 };
+
+  sc_dt::uint64 size = 32*1024; // bytes, up to 4GB
+
+  std::vector<unsigned char*> pages; // one entry per PAGE_SIZE bytes, NULL until touched
+
+  unsigned int burst_len_word = 0;           // longest burst accepted in words, 0 for unlimited
+  sc_time      beat_latency   = SC_ZERO_TIME; // latency annotated for every word of a transaction
 
-  int32_t mem[SIZE];
+  MemoryTiming timing; // replaces beat_latency when a profile other than ideal is selected
+
+  // Approximately-timed protocol: the requests are accepted at once and served in order, each response
+  // is sent when the memory is done with its transaction, one at a time
+  tlm_utils::peq_with_cb_and_phase<MainMemory> peq;
+  sc_time                                     busy_until = SC_ZERO_TIME; // end of the last transaction accepted
+  std::deque<tlm::tlm_generic_payload*>       responses; // done, waiting for the END_RESP of the previous one
+  bool                                        response_in_progress = false;
 
 
   SC_CTOR(MainMemory)
   : socket("socket")
+  , peq(this, &MainMemory::peq_callback)
   {
     // Register callback for incoming b_transport interface method call
     socket.register_b_transport(this, &MainMemory::b_transport);
+    socket.register_nb_transport_fw(this, &MainMemory::nb_transport_fw);
+    socket.register_get_direct_mem_ptr(this, &MainMemory::get_direct_mem_ptr);
 
-    // Initialize memory with random data
-    for (int i = 0; i < SIZE; i++)
-      mem[i] = 0xAA000000 | (rand() % 256);
+    pages.assign(size / PAGE_SIZE, (unsigned char*)NULL);
   }
 
-  // TLM-2 blocking transport method
-  virtual void b_transport( tlm::tlm_generic_payload& trans, sc_time& delay )
+  // Sets the size of the memory, to be called before the simulation starts
+  void configure_size(sc_dt::uint64 size) {
+    for (size_t i = 0; i < pages.size(); i++)
+      delete[] pages[i];
+    this->size = size;
+    pages.assign(size / PAGE_SIZE, (unsigned char*)NULL);
+  }
+
+  // Sets the burst behaviour of the memory, to be called before the simulation starts
+  void configure_burst(unsigned int burst_len_word, sc_time beat_latency) {
+    this->burst_len_word = burst_len_word;
+    this->beat_latency   = beat_latency;
+  }
+
+  // Sets the timing profile of the memory, to be called before the simulation starts
+  void configure_timing(const MemoryTiming::profile_t& profile) {
+    timing.configure(profile);
+  }
+
+  // Page holding the address, allocated with random data on first touch
+  unsigned char* get_page(sc_dt::uint64 address) {
+    unsigned char*& page = pages[address / PAGE_SIZE];
+    if (page == NULL) {
+      page = new unsigned char[PAGE_SIZE];
+      int32_t* words = reinterpret_cast<int32_t*>(page);
+      for (int i = 0; i < PAGE_SIZE/4; i++)
+        words[i] = 0xAA000000 | (rand() % 256);
+    }
+    return page;
+  }
+
+  // Copies len bytes from/to the memory, page by page
+  void copy(sc_dt::uint64 address, unsigned char* ptr, unsigned int len, bool write_enable) {
+    while (len > 0) {
+      unsigned int offset = address % PAGE_SIZE;
+      unsigned int chunk  = (PAGE_SIZE - offset) < len ? (PAGE_SIZE - offset) : len;
+      unsigned char* page = get_page(address);
+      if (write_enable)
+        memcpy(page + offset, ptr, chunk);
+      else
+        memcpy(ptr, page + offset, chunk);
+      address += chunk;
+      ptr     += chunk;
+      len     -= chunk;
+    }
+  }
+
+  // Loads a binary file at the address, only the pages it covers are allocated
+  bool preload(const std::string& filename, sc_dt::uint64 address) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+      return false;
+    std::vector<char> buffer(PAGE_SIZE);
+    while (file.read(buffer.data(), PAGE_SIZE) || file.gcount() > 0) {
+      unsigned int len = file.gcount();
+      if (address + len > size)
+        return false;
+      copy(address, reinterpret_cast<unsigned char*>(buffer.data()), len, true);
+      address += len;
+    }
+    return true;
+  }
+
+  // Executes a transaction starting at start and returns its latency
+  sc_time execute( tlm::tlm_generic_payload& trans, const sc_time& start )
   {
     tlm::tlm_command cmd = trans.get_command();
-    sc_dt::uint64    adr = trans.get_address() / 4;
+    sc_dt::uint64    adr = trans.get_address();
     unsigned char*   ptr = trans.get_data_ptr();
     unsigned int     len = trans.get_data_length();
     unsigned char*   byt = trans.get_byte_enable_ptr();
+    unsigned int     bel = trans.get_byte_enable_length();
     unsigned int     wid = trans.get_streaming_width();
 
     // Obliged to check address range and check for unsupported features,
-    //   i.e. byte enables, streaming, and bursts
+    //   i.e. streaming and bursts longer than burst_len_word words
     // Can ignore DMI hint and extensions
     // Using the SystemC report handler is an acceptable way of signalling an error
 
-    if (adr >= sc_dt::uint64(SIZE) || byt != 0 || len > 4 || wid < len)
+    if (adr + len > size || (byt != 0 && bel == 0) || wid < len)
       SC_REPORT_ERROR("TLM-2", "Target does not support given generic payload transaction");
 
-    // Obliged to implement read and write commands
-    if ( cmd == tlm::TLM_READ_COMMAND )
-      memcpy(ptr, &mem[adr], len);
+    if (burst_len_word != 0 && len > burst_len_word * 4) {
+      trans.set_response_status( tlm::TLM_BURST_ERROR_RESPONSE );
+      return SC_ZERO_TIME;
+    }
+
+    // Obliged to implement read and write commands, and the byte enables
+    if ( byt != 0 ) {
+      for (unsigned int i = 0; i < len; i++)
+        if ( byt[i % bel] == tlm::TLM_BYTE_ENABLE_ENABLED )
+          copy(adr + i, ptr + i, 1, cmd == tlm::TLM_WRITE_COMMAND);
+    } else if ( cmd == tlm::TLM_READ_COMMAND )
+      copy(adr, ptr, len, false);
     else if ( cmd == tlm::TLM_WRITE_COMMAND )
-      memcpy(&mem[adr], ptr, len);
+      copy(adr, ptr, len, true);
+
+    // Every page can be accessed directly, unless each access is timed by the device
+    trans.set_dmi_allowed( !timing.enabled() );
 
     // Obliged to set response status to indicate successful completion
     trans.set_response_status( tlm::TLM_OK_RESPONSE );
+
+    // one beat per word, or the timing of the device from the start
+    if ( timing.enabled() )
+      return timing.access(adr, len, cmd == tlm::TLM_WRITE_COMMAND, start);
+    return beat_latency * ((len + 3) / 4);
+  }
+
+  // TLM-2 blocking transport method, the transaction starts at the end of the delay of the initiator
+  virtual void b_transport( tlm::tlm_generic_payload& trans, sc_time& delay )
+  {
+    delay += execute(trans, sc_time_stamp() + delay);
+  }
+
+  // TLM-2 non-blocking transport method, forward path
+  virtual tlm::tlm_sync_enum nb_transport_fw( tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_time& delay )
+  {
+    if (phase == tlm::BEGIN_REQ) {
+      // the transaction starts once the previous ones are done, and its response is sent at its end
+      sc_time start = sc_time_stamp() + delay;
+      if (busy_until > start)
+        start = busy_until;
+      busy_until = start + execute(trans, start);
+      peq.notify(trans, tlm::BEGIN_RESP, busy_until - sc_time_stamp());
+      phase = tlm::END_REQ;
+      return tlm::TLM_UPDATED;
+    }
+    if (phase == tlm::END_RESP) {
+      send_next_response();
+      return tlm::TLM_COMPLETED;
+    }
+    SC_REPORT_ERROR("TLM-2", "Illegal phase received by the memory");
+    return tlm::TLM_COMPLETED;
+  }
+
+  // Responses at the end of their transaction, in order
+  void peq_callback( tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase )
+  {
+    responses.push_back(&trans);
+    if (!response_in_progress)
+      send_next_response();
+  }
+
+  // Sends the oldest response waiting, the initiator completes it at once or with END_RESP
+  void send_next_response()
+  {
+    response_in_progress = false;
+    while (!responses.empty()) {
+      tlm::tlm_generic_payload* trans = responses.front();
+      tlm::tlm_phase phase = tlm::BEGIN_RESP;
+      sc_time delay = SC_ZERO_TIME;
+      responses.pop_front();
+      if (socket->nb_transport_bw(*trans, phase, delay) == tlm::TLM_ACCEPTED) {
+        response_in_progress = true;
+        return;
+      }
+    }
+  }
+
+  // TLM-2 forward DMI method, grants read and write access to the page of the address
+  virtual bool get_direct_mem_ptr( tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data )
+  {
+    sc_dt::uint64 page_address = trans.get_address() - (trans.get_address() % PAGE_SIZE);
+    if (page_address >= size || timing.enabled())
+      return false;
+    dmi_data.allow_read_write();
+    dmi_data.set_dmi_ptr( get_page(page_address) );
+    dmi_data.set_start_address( page_address );
+    dmi_data.set_end_address( page_address + PAGE_SIZE - 1 );
+    dmi_data.set_read_latency( beat_latency );
+    dmi_data.set_write_latency( beat_latency );
+    return true;
   }
 
 };
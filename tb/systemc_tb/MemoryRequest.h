@@ -8,100 +8,747 @@ using namespace std;
 
 #include "tlm.h"
 #include "tlm_utils/simple_initiator_socket.h"
+#include "tlm_utils/tlm_quantumkeeper.h"
 
 #include "Cache.h"
+#include "TransactionLogger.h"
+#include "Prefetcher.h"
+#include "WriteBuffer.h"
+#include "MissClassifier.h"
 
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <vector>
 
 // MemoryRequest module generating generic payload transactions
 
 SC_MODULE(MemoryRequest)
 {
+  // Writing 1 flushes the cache, writing 2 bypasses it
+  enum { CACHE_CFG_ADDRESS = 0x7FFC };
+
+  // Content of the L2 with respect to the cache (L1), selected with +l2_inclusion=inclusive|nine|victim
+  typedef enum {
+    L2_INCLUSIVE, // filled on the L1 misses, evicting a line invalidates it in the L1
+    L2_NINE,      // filled on the L1 misses, evictions do not affect the L1 (non-inclusive non-exclusive)
+    L2_VICTIM     // only filled with the lines evicted from the L1, a hit moves the line back to the L1
+  } l2_inclusion_t;
+
+  // Write policies of the cache, selected with +cache_write_policy=back|through
+  typedef enum {
+    WRITE_BACK,   // the written lines are dirty and written back when evicted or flushed
+    WRITE_THROUGH // every write also goes to the memory, the lines stay clean
+  } write_policy_t;
+
+  // Protocol towards the memory, selected with +mem_tlm=blocking|lt|at
+  typedef enum {
+    TLM_BLOCKING, // b_transport, every latency is waited for where it occurs
+    TLM_LT,       // b_transport, the latencies are added to a local time, synchronized at the quantum and when idle
+    TLM_AT        // nb_transport, the bursts of a line are sent back to back and their responses waited for
+  } tlm_mode_t;
+
   // TLM-2 socket, defaults to 32-bits wide, base protocol
   tlm_utils::simple_initiator_socket<MemoryRequest> socket;
+  // request being served
   bool                                          we_i;
   uint32_t                                      be_i;
   uint32_t                                      addr_i;
   uint32_t                                      rwdata_io;
   CacheMemory*                                  cache;
-  std::ofstream                                 heep_mem_transactions;
+  CachePrefetcher                               prefetcher;
+  write_policy_t                                write_policy = WRITE_BACK;
+  bool                                          write_allocate = true; // a write miss refills the line, otherwise it only writes the memory
+  WriteBuffer                                   write_buffer;
+  MissClassifier*                               classifier = NULL; // 3C classification of the misses, NULL if not reported
+  TransactionLogger*                            logger;
+  uint32_t                                      cache_snapshot = 0; // transactions between two cache dumps, 0 for none
   bool                                          bypass_state = false;
+  int                                           burst_len_word = 0; // words per memory transaction, 0 for a whole line
+  uint32_t                                      mem_addr_mask = 0x00007FFF; // memory size - 1, 32KB by default
+  bool                                          dmi_ptr_valid = false;
+  sc_time                                       delay_gnt_miss    = sc_time(100, SC_NS); // before the memory is accessed on a miss or a bypassed access
+  sc_time                                       delay_rvalid_miss = sc_time(100, SC_NS); // after it
+  sc_time                                       delay_rvalid_hit  = sc_time(20, SC_NS);
+  // optional second level between the cache and the memory, with the block size of the cache, NULL for none
+  CacheMemory*                                  l2 = NULL;
+  l2_inclusion_t                                l2_inclusion = L2_NINE;
+  sc_time                                       delay_l2_hit = sc_time(40, SC_NS); // lookup of the L2 on a miss of the L1
+  tlm::tlm_dmi                                  dmi_data;
+  tlm_mode_t                                    tlm_mode = TLM_BLOCKING;
+  tlm_utils::tlm_quantumkeeper                  quantum_keeper; // local time of TLM_LT
+  std::vector<tlm::tlm_generic_payload*>        at_trans;       // one per burst in flight with TLM_AT
+  uint32_t                                      at_end_req = 0;  // requests accepted by the memory
+  uint32_t                                      at_done = 0;     // responses received
+  sc_event                                      at_event;        // a request was accepted or a response received
+
+  typedef struct obi_request
+  {
+    bool     we;
+    uint32_t be;
+    uint32_t addr;
+    uint32_t wdata;
+  } obi_request_t;
+
+  typedef struct obi_response
+  {
+    uint32_t rdata;
+    sc_time  ready; // rvalid can be given from this time on
+  } obi_response_t;
+
+  // requests granted and not served yet, and responses not given back yet, in order
+  std::deque<obi_request_t>                     obi_requests;
+  std::deque<obi_response_t>                    obi_responses;
+  uint32_t                                      obi_depth = 1; // outstanding requests
+  sc_event                                      obi_new_req;   // a request was queued
+
+  // tells the log and cache dump files of the instances apart, empty for the first one
+  std::string                                   file_suffix;
 
   typedef struct cache_statistics
   {
     uint32_t number_of_transactions;
     uint32_t number_of_hit;
     uint32_t number_of_miss;
+    uint32_t number_of_writeback;       // dirty lines written back on eviction or flush
+    uint32_t number_of_writeback_saved; // clean lines evicted or flushed without writing them back
   } cache_statistics_t;
 
   cache_statistics_t cache_stat;
+  cache_statistics_t l2_stat;
+  uint32_t           l2_back_invalidations = 0; // L1 lines invalidated by the evictions of an inclusive L2
+
+  SC_HAS_PROCESS(MemoryRequest);
 
-  SC_CTOR(MemoryRequest)
-  : socket("socket"),  // Construct and name socket
-    heep_mem_transactions("heep_mem_transactions.log")
+  MemoryRequest(sc_module_name name, const std::string& file_suffix = "")
+  : sc_module(name)
+  , socket("socket")  // Construct and name socket
+  , file_suffix(file_suffix)
   {
 
-    cache = new CacheMemory;
-    cache->create_cache();
-    cache->initialize_cache();
+    cache = new CacheMemory(("cache_status" + file_suffix + ".log").c_str());
+    logger = NULL;
     cache_stat.number_of_transactions = 0;
     cache_stat.number_of_hit = 0;
     cache_stat.number_of_miss = 0;
-    cache->print_cache_status(cache_stat.number_of_transactions++, sc_time_stamp().to_string());
+    cache_stat.number_of_writeback = 0;
+    cache_stat.number_of_writeback_saved = 0;
+    l2_stat = cache_stat;
+
+    socket.register_invalidate_direct_mem_ptr(this, &MemoryRequest::invalidate_direct_mem_ptr);
+    socket.register_nb_transport_bw(this, &MemoryRequest::nb_transport_bw);
 
     SC_THREAD(thread_process);
   }
 
+  // TLM-2 backward DMI method
+  virtual void invalidate_direct_mem_ptr(sc_dt::uint64 start_range, sc_dt::uint64 end_range)
+  {
+    dmi_ptr_valid = false;
+  }
+
+  // TLM-2 non-blocking transport method, backward path of TLM_AT: the responses are completed at once
+  virtual tlm::tlm_sync_enum nb_transport_bw(tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_time& delay)
+  {
+    if (phase == tlm::END_REQ) {
+      at_end_req++;
+      at_event.notify(delay);
+      return tlm::TLM_ACCEPTED;
+    }
+    if (phase == tlm::BEGIN_RESP) {
+      at_done++;
+      at_event.notify(delay);
+      return tlm::TLM_COMPLETED;
+    }
+    SC_REPORT_ERROR("TLM-2", "Illegal phase received by the cache");
+    return tlm::TLM_COMPLETED;
+  }
+
+  // Current time of the thread, ahead of the simulation time by the local time of TLM_LT
+  sc_time local_time() {
+    return tlm_mode == TLM_LT ? quantum_keeper.get_current_time() : sc_time_stamp();
+  }
+
+  // Lets a latency elapse: waits for it, or adds it to the local time with TLM_LT
+  void consume(const sc_time& delay) {
+    if (tlm_mode != TLM_LT) {
+      if (delay != SC_ZERO_TIME)
+        wait(delay);
+      return;
+    }
+    quantum_keeper.inc(delay);
+    if (quantum_keeper.need_sync())
+      quantum_keeper.sync();
+  }
+
+  bool dmi_covers(uint32_t addr, int N) {
+    return dmi_ptr_valid && addr >= dmi_data.get_start_address() && sc_dt::uint64(addr) + N*4 - 1 <= dmi_data.get_end_address();
+  }
+
+  // Copies N words with the DMI pointer, if granted for the whole range, waiting once for the latency of all the words
+  bool memory_copy_dmi(uint32_t addr, int32_t* buffer_data, int N, bool write_enable, uint32_t be) {
+    if ( !dmi_covers(addr, N) )
+      return false;
+    if ( write_enable ? !dmi_data.is_write_allowed() : !dmi_data.is_read_allowed() )
+      return false;
+
+    unsigned char* ptr = dmi_data.get_dmi_ptr() + (addr - dmi_data.get_start_address());
+    if ( write_enable && be != 0xF ) {
+      for (int j = 0; j < 4; j++)
+        if ( (be >> j) & 1 ) ptr[j] = reinterpret_cast<unsigned char*>(buffer_data)[j];
+    } else if ( write_enable )
+      memcpy(ptr, buffer_data, N*4);
+    else
+      memcpy(buffer_data, ptr, N*4);
+    logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_DMI, now_ns(), addr, 0, N, write_enable);
+
+    consume((write_enable ? dmi_data.get_write_latency() : dmi_data.get_read_latency()) * N);
+    return true;
+  }
+
+  // Queues a granted OBI request
+  void push_request(bool we, uint32_t be, uint32_t addr, uint32_t wdata) {
+    obi_request_t req = { we, be, addr, wdata };
+    obi_requests.push_back(req);
+    obi_new_req.notify();
+  }
+
+  // Gets the oldest response if its latency elapsed
+  bool pop_response(uint32_t& rdata) {
+    if (obi_responses.empty() || obi_responses.front().ready > sc_time_stamp())
+      return false;
+    rdata = obi_responses.front().rdata;
+    obi_responses.pop_front();
+    return true;
+  }
+
+  // Sets the size of the memory, a power of 2, to be called before the simulation starts
+  void configure_memory(sc_dt::uint64 mem_size_byte) {
+    mem_addr_mask = (uint32_t)(mem_size_byte - 1);
+  }
+
+  static bool parse_tlm_mode(const std::string& name, tlm_mode_t& mode) {
+    if(name == "blocking") mode = TLM_BLOCKING;
+    else if(name == "lt")  mode = TLM_LT;
+    else if(name == "at")  mode = TLM_AT;
+    else return false;
+    return true;
+  }
+
+  // Sets the protocol towards the memory and the quantum of TLM_LT (shared by all the instances), to be called
+  // before the simulation starts
+  void configure_tlm(tlm_mode_t mode, sc_time quantum) {
+    tlm_mode = mode;
+    if (mode == TLM_LT)
+      tlm_utils::tlm_quantumkeeper::set_global_quantum(quantum);
+    quantum_keeper.reset();
+  }
+
+  // Sets the latencies of the controller around the memory accesses, to be called before the simulation starts
+  void configure_delays(sc_time gnt_miss, sc_time rvalid_miss, sc_time rvalid_hit) {
+    delay_gnt_miss    = gnt_miss;
+    delay_rvalid_miss = rvalid_miss;
+    delay_rvalid_hit  = rvalid_hit;
+  }
+
+  // Sets the cache geometry, to be called before the simulation starts
+  void configure_cache(uint32_t cache_size_byte, uint32_t block_size_byte, uint32_t number_of_ways, CacheMemory::replacement_policy_t policy) {
+    cache->create_cache(cache_size_byte, cache_size_byte / block_size_byte, number_of_ways, policy);
+    cache->initialize_cache();
+    cache->print_cache_status(cache_stat.number_of_transactions++, sc_time_stamp().to_string());
+  }
+
+  static bool parse_l2_inclusion(const std::string& name, l2_inclusion_t& inclusion) {
+    if(name == "inclusive")   inclusion = L2_INCLUSIVE;
+    else if(name == "nine")   inclusion = L2_NINE;
+    else if(name == "victim") inclusion = L2_VICTIM;
+    else return false;
+    return true;
+  }
+
+  // Adds the L2, with the block size of the cache, to be called after configure_cache and before the simulation starts
+  void configure_l2(uint32_t l2_size_byte, uint32_t number_of_ways, CacheMemory::replacement_policy_t policy, l2_inclusion_t inclusion, sc_time hit_delay) {
+    delete l2;
+    l2 = new CacheMemory(("l2_cache_status" + file_suffix + ".log").c_str());
+    l2->create_cache(l2_size_byte, l2_size_byte / cache->get_block_size(), number_of_ways, policy);
+    l2->initialize_cache();
+    l2_inclusion = inclusion;
+    delay_l2_hit = hit_delay;
+  }
+
+  static bool parse_write_policy(const std::string& name, write_policy_t& policy) {
+    if(name == "back")         policy = WRITE_BACK;
+    else if(name == "through") policy = WRITE_THROUGH;
+    else return false;
+    return true;
+  }
+
+  // Sets the write policy, the allocation on write misses and the entries of the write buffer (0 for none),
+  // to be called after configure_cache and before the simulation starts
+  void configure_write(write_policy_t policy, bool allocate, uint32_t buffer_entries) {
+    write_policy   = policy;
+    write_allocate = allocate;
+    write_buffer.configure(buffer_entries, cache->get_block_size());
+  }
+
+  // Classifies the misses and counts them per region of region_size_byte bytes for write_report,
+  // to be called after configure_cache and before the simulation starts
+  void configure_report(uint32_t region_size_byte) {
+    delete classifier;
+    classifier = new MissClassifier;
+    classifier->configure(cache->get_block_size(), cache->number_of_blocks, region_size_byte);
+  }
+
+  // Sets the prefetcher, to be called after configure_cache and before the simulation starts
+  void configure_prefetch(CachePrefetcher::prefetch_mode_t mode, uint32_t degree) {
+    prefetcher.configure(mode, degree, cache->get_block_size());
+  }
+
+  // Sets the log level and the cache dump interval, to be called before the simulation starts
+  void configure_log(TransactionLogger::log_level_t level, uint32_t cache_snapshot) {
+    delete logger;
+    logger = new TransactionLogger("heep_mem_transactions" + file_suffix + ".log", level);
+    this->cache_snapshot = cache_snapshot;
+  }
+
+  // Writes the pending log records, to be called at the end of the simulation
+  void close_log() {
+    if (logger) logger->close();
+  }
+
+  double now_ns() {
+    return local_time().to_seconds() * 1e9;
+  }
+
+  static double hit_rate(const cache_statistics_t& stat) {
+    uint32_t accesses = stat.number_of_hit + stat.number_of_miss;
+    return accesses ? 100.0 * stat.number_of_hit / accesses : 0.0;
+  }
+
+  void print_cache_statistics() {
+    std::ostringstream ss;
+    ss<<(l2 ? "L1 cache " : "Cache ")<<dec<<cache_stat.number_of_hit<<" hits, "<<cache_stat.number_of_miss<<" misses, "
+      <<cache_stat.number_of_writeback<<" write-backs, "<<cache_stat.number_of_writeback_saved<<" write-backs saved by the dirty bits";
+    if (l2)
+      ss<<", hit rate "<<fixed<<setprecision(2)<<hit_rate(cache_stat)<<"%";
+    std::cout<<"[TESTBENCH]: "<<ss.str()<<std::endl;
+    if (logger) logger->message(TransactionLogger::LOG_SUMMARY, ss.str());
+    if (l2) {
+      // the L2 is looked up on the misses of the L1 and on the prefetches
+      ss.str("");
+      ss<<"L2 cache "<<dec<<l2_stat.number_of_hit<<" hits, "<<l2_stat.number_of_miss<<" misses, "
+        <<l2_stat.number_of_writeback<<" write-backs, "<<l2_stat.number_of_writeback_saved<<" write-backs saved by the dirty bits, "
+        <<l2_back_invalidations<<" back-invalidations, hit rate "<<fixed<<setprecision(2)<<hit_rate(l2_stat)<<"%";
+      std::cout<<"[TESTBENCH]: "<<ss.str()<<std::endl;
+      if (logger) logger->message(TransactionLogger::LOG_SUMMARY, ss.str());
+    }
+    if (classifier) {
+      ss.str("");
+      ss<<"Misses "<<dec<<classifier->total.misses[MissClassifier::MISS_COMPULSORY]<<" compulsory, "
+        <<classifier->total.misses[MissClassifier::MISS_CAPACITY]<<" capacity, "
+        <<classifier->total.misses[MissClassifier::MISS_CONFLICT]<<" conflict";
+      std::cout<<"[TESTBENCH]: "<<ss.str()<<std::endl;
+      if (logger) logger->message(TransactionLogger::LOG_SUMMARY, ss.str());
+    }
+    if (write_buffer.enabled()) {
+      ss.str("");
+      ss<<"Write buffer "<<dec<<write_buffer.stat.number_of_writes<<" writes, "<<write_buffer.stat.number_of_merged<<" merged, "
+        <<write_buffer.stat.number_of_drained<<" entries drained with "<<write_buffer.stat.number_of_bursts<<" memory transactions";
+      std::cout<<"[TESTBENCH]: "<<ss.str()<<std::endl;
+      if (logger) logger->message(TransactionLogger::LOG_SUMMARY, ss.str());
+    }
+    if (!prefetcher.enabled())
+      return;
+    ss.str("");
+    ss<<"Prefetcher "<<prefetcher.stat.number_of_issued<<" issued, "<<prefetcher.stat.number_of_useful<<" useful (hit), "
+      <<prefetcher.stat.number_of_late<<" late, "<<prefetcher.stat.number_of_useless<<" useless, "<<prefetcher.stat.number_of_redundant<<" redundant";
+    std::cout<<"[TESTBENCH]: "<<ss.str()<<std::endl;
+    if (logger) logger->message(TransactionLogger::LOG_SUMMARY, ss.str());
+  }
+
+  static void write_level_json(std::ostream& json, const cache_statistics_t& stat) {
+    json<<"\"hits\": "<<stat.number_of_hit<<", \"misses\": "<<stat.number_of_miss
+        <<", \"hit_rate\": "<<hit_rate(stat) / 100<<", \"writebacks\": "<<stat.number_of_writeback
+        <<", \"writebacks_saved\": "<<stat.number_of_writeback_saved;
+  }
+
+  // Writes the statistics of the cache as a JSON object, with the classification of the misses and the regions
+  // if configure_report was called
+  void write_report(std::ostream& json, const std::string& indent) {
+    json<<"{"<<std::endl;
+    json<<indent<<"  \"cache\": { \"size\": "<<cache->cache_size_byte<<", \"block_size\": "<<cache->get_block_size()
+        <<", \"ways\": "<<cache->number_of_ways<<", ";
+    write_level_json(json, cache_stat);
+    json<<" },"<<std::endl;
+    if (l2) {
+      json<<indent<<"  \"l2\": { \"size\": "<<l2->cache_size_byte<<", \"ways\": "<<l2->number_of_ways<<", ";
+      write_level_json(json, l2_stat);
+      json<<", \"back_invalidations\": "<<l2_back_invalidations<<" },"<<std::endl;
+    }
+    if (prefetcher.enabled()) {
+      json<<indent<<"  \"prefetcher\": { \"issued\": "<<prefetcher.stat.number_of_issued<<", \"useful\": "<<prefetcher.stat.number_of_useful
+          <<", \"late\": "<<prefetcher.stat.number_of_late<<", \"useless\": "<<prefetcher.stat.number_of_useless
+          <<", \"redundant\": "<<prefetcher.stat.number_of_redundant<<" },"<<std::endl;
+    }
+    if (classifier) {
+      json<<indent<<"  \"misses\": { ";
+      for (int c = 0; c < 3; c++)
+        json<<"\""<<MissClassifier::class_name(c)<<"\": "<<classifier->total.misses[c]<<(c < 2 ? ", " : "");
+      json<<" },"<<std::endl;
+      json<<indent<<"  \"region_size\": "<<classifier->region_size_byte<<","<<std::endl;
+      json<<indent<<"  \"regions\": ["<<std::endl;
+      size_t i = 0;
+      for (auto& region : classifier->regions) {
+        const MissClassifier::region_statistics_t& r = region.second;
+        json<<indent<<"    { \"base\": \"0x"<<hex<<setw(8)<<setfill('0')<<region.first<<dec<<setfill(' ')<<"\", \"accesses\": "<<r.accesses
+            <<", \"hits\": "<<r.hits;
+        for (int c = 0; c < 3; c++)
+          json<<", \""<<MissClassifier::class_name(c)<<"\": "<<r.misses[c];
+        json<<", \"writebacks\": "<<r.writebacks<<" }"<<(++i < classifier->regions.size() ? "," : "")<<std::endl;
+      }
+      json<<indent<<"  ],"<<std::endl;
+    }
+    // configure_cache counted the first cache dump as a transaction
+    json<<indent<<"  \"requests\": "<<cache_stat.number_of_transactions - 1<<std::endl;
+    json<<indent<<"}";
+  }
+
+  // Prepares a transaction of len bytes, byte_enable is NULL for whole words
+  void set_payload(tlm::tlm_generic_payload* trans, tlm::tlm_command cmd, uint32_t addr, int32_t* data, uint32_t len, unsigned char* byte_enable) {
+    trans->set_command( cmd );
+    trans->set_address( addr );
+    trans->set_data_ptr( reinterpret_cast<unsigned char*>(data) );
+    trans->set_data_length( len );
+    trans->set_streaming_width( len ); // = data_length to indicate no streaming
+    trans->set_byte_enable_ptr( byte_enable ); // 0 indicates unused
+    trans->set_byte_enable_length( byte_enable ? 4 : 0 );
+    trans->set_dmi_allowed( false ); // Mandatory initial value
+    trans->set_response_status( tlm::TLM_INCOMPLETE_RESPONSE ); // Mandatory initial value
+  }
+
+  // Initiator obliged to check response status, then asks for the DMI pointer of the region if the target allows it
+  void check_response(tlm::tlm_generic_payload* trans) {
+    if ( trans->is_response_error() )
+      SC_REPORT_ERROR("TLM-2", "Response error from the memory");
+
+    uint32_t addr = trans->get_address();
+    if ( trans->is_dmi_allowed() && !dmi_covers(addr, trans->get_data_length()/4) ) {
+      dmi_data.init();
+      dmi_ptr_valid = socket->get_direct_mem_ptr( *trans, dmi_data );
+    }
+  }
 
-  uint32_t memory_copy(uint32_t addr, int32_t* buffer_data, int N, bool write_enable, tlm::tlm_generic_payload* trans, sc_time delay) {
+  // Copies N words from/to the memory with one transaction per burst of at most burst_len_word words,
+  // waiting for the latency annotated by the memory.
+  // be are the OBI byte enables of a single word write, the whole words are read and written otherwise
+  uint32_t memory_copy(uint32_t addr, int32_t* buffer_data, int N, bool write_enable, tlm::tlm_generic_payload* trans, uint32_t be = 0xF) {
 
     tlm::tlm_command cmd = write_enable ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND;
+    unsigned char byte_enable[4];
+
+    if ( !write_enable || N != 1 )
+      be = 0xF;
+    for (int j = 0; j < 4; j++)
+      byte_enable[j] = ((be >> j) & 1) ? tlm::TLM_BYTE_ENABLE_ENABLED : tlm::TLM_BYTE_ENABLE_DISABLED;
+
+    // accesses bypassing the cache are untimed, they do not need a transaction when DMI is granted
+    if ( bypass_state && memory_copy_dmi(addr & mem_addr_mask, buffer_data, N, write_enable, be) )
+      return N;
+
+    // the buffered writes to these words reach the memory first
+    write_buffer_entry_t pending;
+    while ( write_buffer.take_overlapping(addr & mem_addr_mask, N, pending) )
+      drain_entry(pending, trans);
+
+    int beats = (burst_len_word == 0 || burst_len_word > N) ? N : burst_len_word;
 
-    //first read block_size bytes from memory to place them in cache regardless of the cmd
-    for(int i=0; i < N; i++){
-      trans->set_command( cmd );
-      trans->set_address( (addr + i*4) & 0x00007FFF ); //15bits
-      trans->set_data_ptr( reinterpret_cast<unsigned char*>(&buffer_data[i]) );
-      trans->set_data_length( 4 );
-      trans->set_streaming_width( 4 ); // = data_length to indicate no streaming
-      trans->set_byte_enable_ptr( 0 ); // 0 indicates unused
-      trans->set_dmi_allowed( false ); // Mandatory initial value
-      trans->set_response_status( tlm::TLM_INCOMPLETE_RESPONSE ); // Mandatory initial value
+    if ( tlm_mode == TLM_AT )
+      return memory_copy_at(addr, buffer_data, N, write_enable, be == 0xF ? 0 : byte_enable, beats);
+
+    for(int i=0; i < N; i+=beats){
+      uint32_t burst_addr = (addr + i*4) & mem_addr_mask;
+      uint32_t burst_len  = (N - i < beats ? N - i : beats) * 4;
+      // the memory times the transaction from the local time
+      sc_time  delay      = tlm_mode == TLM_LT ? quantum_keeper.get_local_time() : SC_ZERO_TIME;
+      set_payload(trans, cmd, burst_addr, &buffer_data[i], burst_len, be == 0xF ? 0 : byte_enable);
       socket->b_transport( *trans, delay );  // Blocking transport call
 
-      if(bypass_state){
-        if(write_enable)
-          heep_mem_transactions << "Writing to Mem[" << hex << ((addr + i*4) & 0x00007FFF) << "]: " << buffer_data[i] << " at time " << sc_time_stamp() <<std::endl;
-        else
-          heep_mem_transactions << "Reading from Mem[" << hex << ((addr + i*4) & 0x00007FFF) << "]: " << buffer_data[i] << " at time " << sc_time_stamp() <<std::endl;
-      } else {
-        if(write_enable)
-          heep_mem_transactions << "Cache Writing to Mem[" << hex << ((addr + i*4) & 0x00007FFF) << "]: " << buffer_data[i] << " at time " << sc_time_stamp() <<std::endl;
-        else
-          heep_mem_transactions << "Cache Reading from Mem[" << hex << ((addr + i*4) & 0x00007FFF) << "]: " << buffer_data[i] << " at time " << sc_time_stamp() <<std::endl;
+      logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_MEM, now_ns(), burst_addr, buffer_data[i], burst_len/4, write_enable, bypass_state);
+
+      check_response(trans);
+
+      if ( tlm_mode == TLM_LT ) {
+        quantum_keeper.set(delay);
+        if ( quantum_keeper.need_sync() )
+          quantum_keeper.sync();
+      } else if ( delay != SC_ZERO_TIME )
+        wait(delay);
+    }
+    return N;
+  }
+
+  // memory_copy with the approximately-timed protocol: each burst is sent as soon as the memory accepted the
+  // previous one, then the responses of all of them are waited for
+  uint32_t memory_copy_at(uint32_t addr, int32_t* buffer_data, int N, bool write_enable, unsigned char* byte_enable, int beats) {
+    tlm::tlm_command cmd = write_enable ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND;
+    uint32_t bursts = (N + beats - 1) / beats;
+
+    while (at_trans.size() < bursts)
+      at_trans.push_back(new tlm::tlm_generic_payload);
+    at_end_req = 0;
+    at_done    = 0;
+
+    for(uint32_t b = 0; b < bursts; b++){
+      int      i          = b * beats;
+      uint32_t burst_addr = (addr + i*4) & mem_addr_mask;
+      uint32_t burst_len  = (N - i < beats ? N - i : beats) * 4;
+      tlm::tlm_phase phase = tlm::BEGIN_REQ;
+      sc_time        delay = SC_ZERO_TIME;
+      set_payload(at_trans[b], cmd, burst_addr, &buffer_data[i], burst_len, byte_enable);
+
+      tlm::tlm_sync_enum status = socket->nb_transport_fw( *at_trans[b], phase, delay );
+      if ( status == tlm::TLM_COMPLETED ) {
+        at_end_req++;
+        at_done++;
+      } else if ( status == tlm::TLM_UPDATED && phase == tlm::END_REQ ) {
+        at_end_req++;
+      } else if ( status == tlm::TLM_UPDATED ) {
+        SC_REPORT_ERROR("TLM-2", "Unexpected phase from the memory");
       }
-      // Initiator obliged to check response status and delay
-      if ( trans->is_response_error() )
-        SC_REPORT_ERROR("TLM-2", "Response error from b_transport");
+      if ( delay != SC_ZERO_TIME )
+        wait(delay);
+
+      logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_MEM, now_ns(), burst_addr, buffer_data[i], burst_len/4, write_enable, bypass_state);
+
+      // the base protocol allows a single request in progress
+      while ( at_end_req <= b )
+        wait(at_event);
     }
+
+    while ( at_done < bursts )
+      wait(at_event);
+    for(uint32_t b = 0; b < bursts; b++)
+      check_response(at_trans[b]);
     return N;
   }
 
 
+  typedef WriteBuffer::write_buffer_entry_t write_buffer_entry_t;
+
+  // Writes an entry of the write buffer to the memory, with one transaction per run of whole words
+  void drain_entry(write_buffer_entry_t& entry, tlm::tlm_generic_payload* trans) {
+    uint32_t words = entry.data.size();
+    write_buffer.stat.number_of_drained++;
+    for (uint32_t i = 0; i < words; ) {
+      uint32_t run = 1;
+      if (entry.be[i] == 0) {
+        i++;
+        continue;
+      }
+      if (entry.be[i] == 0xF) {
+        while (i + run < words && entry.be[i + run] == 0xF)
+          run++;
+      }
+      memory_copy(entry.base + i*4, &entry.data[i], run, true, trans, entry.be[i]);
+      write_buffer.stat.number_of_bursts += (burst_len_word == 0) ? 1 : (run + burst_len_word - 1) / burst_len_word;
+      i += run;
+    }
+  }
+
+  // Writes all the entries of the write buffer to the memory
+  void drain_write_buffer(tlm::tlm_generic_payload* trans) {
+    write_buffer_entry_t entry;
+    while (write_buffer.pop(entry))
+      drain_entry(entry, trans);
+  }
+
+  // Writes a word below the cache, on a write-through or a write miss without allocation: into the copy of the L2 if
+  // any, where it stays with a write-back policy, and to the memory through the write buffer.
+  // Returns true if the write is posted, false if it waited for the memory
+  bool write_word_below(uint32_t addr, uint32_t data, uint32_t be, tlm::tlm_generic_payload* trans) {
+    int32_t line = l2 ? l2->find_line(addr) : -1;
+    if (line >= 0) {
+      l2->set_word_at_index(line, addr, data, be);
+      if (write_policy == WRITE_BACK)
+        return true;
+      l2->clean_entry_at_index(line);
+    }
+
+    if (write_buffer.enabled()) {
+      write_buffer_entry_t entry;
+      while (!write_buffer.write(addr & mem_addr_mask, data, be) && write_buffer.pop(entry))
+        drain_entry(entry, trans);
+      return true;
+    }
+
+    consume(delay_gnt_miss);
+    memory_copy(addr, (int32_t *)&data, 1, true, trans, be);
+    return false;
+  }
+
+  // Adds a line to the L2, writing back its victim if dirty. With an inclusive L2, the victim is invalidated
+  // in the L1 too, and the L1 copy is written back instead if it is dirty
+  void l2_add_line(uint32_t addr, uint8_t* line_data, bool dirty, tlm::tlm_generic_payload* trans) {
+    uint32_t block_size_byte = l2->get_block_size();
+    int32_t  line = l2->find_line(addr);
+
+    if (line >= 0) {
+      memcpy(l2->cache_array[line].data, line_data, block_size_byte);
+      l2->touch_line(line);
+    } else {
+      line = l2->get_victim(addr);
+      if (l2->is_entry_valid_at_index(line)) {
+        uint32_t victim_addr = l2->get_address_at_index(line);
+        uint8_t* victim_data = l2->cache_array[line].data;
+        bool     write_back  = l2->is_entry_dirty_at_index(line);
+        int32_t  l1_line     = l2_inclusion == L2_INCLUSIVE ? cache->find_line(victim_addr) : -1;
+        if (l1_line >= 0) {
+          l2_back_invalidations++;
+          if (cache->is_entry_dirty_at_index(l1_line)) {
+            victim_data = cache->cache_array[l1_line].data;
+            write_back  = true;
+          }
+          cache->cache_array[l1_line].valid = false;
+        }
+        if (write_back) {
+          l2_stat.number_of_writeback++;
+          memory_copy(victim_addr, (int32_t *)victim_data, block_size_byte/4, true, trans);
+        } else {
+          l2_stat.number_of_writeback_saved++;
+        }
+      }
+      l2->add_entry_at_index(line, addr, line_data);
+    }
+    if (dirty)
+      l2->cache_array[line].dirty = true;
+  }
+
+  // Reads a line of the cache from the L2 or, on a miss of the L2 or without it, from the memory.
+  // Returns true if the L2 held it, dirty tells if the line moved from a victim L2 must be written back
+  bool fetch_line(uint32_t addr, int32_t* line_data, bool& dirty, tlm::tlm_generic_payload* trans) {
+    uint32_t block_size_byte = cache->get_block_size();
+    dirty = false;
+
+    if (l2 == NULL) {
+      memory_copy(addr, line_data, block_size_byte/4, false, trans);
+      return false;
+    }
+
+    consume(delay_l2_hit);
+    int32_t line = l2->find_line(addr);
+    if (line >= 0) {
+      l2_stat.number_of_hit++;
+      l2->get_data_at_index(line, (uint8_t*)line_data);
+      if (l2_inclusion == L2_VICTIM) {
+        dirty = l2->is_entry_dirty_at_index(line);
+        l2->cache_array[line].valid = false;
+      } else {
+        l2->touch_line(line);
+      }
+      return true;
+    }
+
+    l2_stat.number_of_miss++;
+    consume(delay_gnt_miss);
+    memory_copy(addr, line_data, block_size_byte/4, false, trans);
+    if (l2_inclusion != L2_VICTIM)
+      l2_add_line(addr, (uint8_t*)line_data, false, trans);
+    return false;
+  }
+
+  // Writes back a line evicted from the cache: to the memory without an L2, into the copy of the L2 if any and to
+  // the memory otherwise, or into a victim L2 whether it is dirty or not
+  void write_back_line(uint32_t addr, uint8_t* line_data, bool dirty, tlm::tlm_generic_payload* trans) {
+    uint32_t block_size_byte = cache->get_block_size();
+
+    if (l2 != NULL && l2_inclusion == L2_VICTIM) {
+      l2_add_line(addr, line_data, dirty, trans);
+      return;
+    }
+    if (!dirty)
+      return;
+
+    int32_t line = l2 ? l2->find_line(addr) : -1;
+    if (line >= 0) {
+      memcpy(l2->cache_array[line].data, line_data, block_size_byte);
+      l2->cache_array[line].dirty = true;
+    } else {
+      memory_copy(addr, (int32_t *)line_data, block_size_byte/4, true, trans);
+    }
+  }
+
+  // Reads the line of the address into the cache, writing back the replaced line if dirty (or to a victim L2).
+  // Returns the line index, line_data holds the data read, from_l2 tells if the L2 held it
+  uint32_t refill_line(uint32_t addr, tlm::tlm_generic_payload* trans, int32_t* line_data, uint8_t* victim_data, bool* from_l2 = NULL) {
+    uint32_t addr_to_read = cache->get_base_address(addr);
+    uint32_t address_to_replace;
+    bool     dirty;
+
+    bool l2_hit = fetch_line(addr_to_read, line_data, dirty, trans);
+    if (from_l2) *from_l2 = l2_hit;
+    uint32_t index_to_add     = cache->get_index(addr);
+    uint32_t tag_to_add       = cache->get_tag(addr);
+    uint32_t line_to_replace  = cache->get_victim(addr);
+
+    logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_ADD, now_ns(), tag_to_add, index_to_add, line_to_replace % cache->number_of_ways);
+
+    if (cache->is_entry_valid_at_index(line_to_replace) && cache->cache_array[line_to_replace].prefetched)
+      prefetcher.stat.number_of_useless++;
+
+    //write back what will be replaced only if it was written
+    if (cache->is_entry_dirty_at_index(line_to_replace)) {
+      //if we are going to replace a dirty entry
+      cache_stat.number_of_writeback++;
+      if (classifier) classifier->writeback(cache->get_address_at_index(line_to_replace));
+      uint32_t tag_to_replace = cache->get_tag_from_index(line_to_replace);
+      logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_REPLACE, now_ns(), addr, cache->get_address_at_index(line_to_replace), tag_to_replace);
+    } else if (cache->is_entry_valid_at_index(line_to_replace)) {
+      cache_stat.number_of_writeback_saved++;
+    }
+
+    if (cache->is_entry_valid_at_index(line_to_replace)) {
+      cache->get_data_at_index(line_to_replace, victim_data);
+      address_to_replace = cache->get_address_at_index(line_to_replace);
+      write_back_line(address_to_replace, victim_data, cache->is_entry_dirty_at_index(line_to_replace), trans);
+    }
+
+    //now replace the entry in cache
+    cache->add_entry_at_index(line_to_replace, addr, (uint8_t*)line_data);
+    if (dirty)
+      cache->cache_array[line_to_replace].dirty = true;
+    return line_to_replace;
+  }
+
+  // Reads a queued prefetch into the cache, if it is not there yet
+  void issue_prefetch(tlm::tlm_generic_payload* trans, int32_t* line_data, uint8_t* victim_data) {
+    uint32_t addr;
+    if (!prefetcher.pop(addr))
+      return;
+    addr &= mem_addr_mask;
+    if (addr == (CACHE_CFG_ADDRESS & ~(cache->get_block_size() - 1)) || cache->find_line(addr) >= 0) {
+      prefetcher.stat.number_of_redundant++;
+      return;
+    }
+    prefetcher.stat.number_of_issued++;
+    uint32_t line = refill_line(addr, trans, line_data, victim_data);
+    cache->cache_array[line].prefetched = true;
+  }
+
   void thread_process()
   {
     // TLM-2 generic payload transaction, reused across calls to b_transport
     tlm::tlm_generic_payload* trans = new tlm::tlm_generic_payload;
 
-    sc_time delay_gnt_miss = sc_time(100, SC_NS);
-    sc_time delay_rvalid_miss = sc_time(100, SC_NS);
+    // the engine serves the next request while waiting for the rvalid latency of the previous one
+    sc_time delay_rvalid;
 
-    sc_time delay_rvalid_hit = sc_time(20, SC_NS); //as of today, it must be >=20
+    if(logger == NULL)
+      configure_log(TransactionLogger::LOG_TRANSACTIONS, 0);
 
-    sc_time delay = sc_time(1, SC_NS);
+    if(cache->cache_array == NULL)
+      configure_cache(cache->cache_size_byte, cache->cache_size_byte / cache->number_of_blocks, 1, CacheMemory::REPLACEMENT_LRU);
 
     uint32_t cache_block_size_byte = cache->get_block_size();
     uint32_t cache_block_size_word = cache->get_block_size()/4;
@@ -112,127 +759,169 @@ SC_MODULE(MemoryRequest)
 
     while(true) {
 
-      wait(obi_new_req);
+      // demand requests first, prefetches when idle. With TLM_LT, the requests that arrived before the local time
+      // are only seen once it is synchronized, which is done before the thread takes anything else
+      while(obi_requests.empty()) {
+        if(tlm_mode == TLM_LT && quantum_keeper.get_local_time() != SC_ZERO_TIME)
+          quantum_keeper.sync();
+        else if(!bypass_state && !prefetcher.queue.empty())
+          issue_prefetch(trans, main_mem_data, cache_data);
+        else
+          wait(obi_new_req);
+      }
 
-      heep_mem_transactions << "X-HEEP tlm_generic_payload REQ: { " << (we_i ? 'W' : 'R') << ", @0x" << hex << addr_i
-                << " , DATA = 0x" << hex << rwdata_io << " BE = " << hex << be_i <<", at time " << sc_time_stamp() << " }" << std::endl;
+      we_i      = obi_requests.front().we;
+      be_i      = obi_requests.front().be;
+      addr_i    = obi_requests.front().addr;
+      rwdata_io = obi_requests.front().wdata;
+      obi_requests.pop_front();
 
-      if(be_i!=0xF) {
-        SC_REPORT_ERROR("OBI External Memory SystemC", "ByteEnable different than 0xF is not supported");
-      }
+      logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_REQ, now_ns(), addr_i, rwdata_io, be_i, we_i);
+
+      //the OBI address of a sub-word access selects the bytes with be_i
+      addr_i &= ~0x3;
 
       //if we are writing 1 or 2 to last address, flush cache or bypass
-      if(we_i && ((addr_i & 0x00007FFF) == 0x7FFC)){
+      if(we_i && ((addr_i & mem_addr_mask) == CACHE_CFG_ADDRESS)){
 
         if(rwdata_io == 1){
           //FLUSH Cache
-          heep_mem_transactions << "X-HEEP Flush Cache, at time " << sc_time_stamp() << " }" << std::endl;
+          logger->log(TransactionLogger::LOG_SUMMARY, TransactionLogger::EVENT_FLUSH, now_ns());
           uint32_t cache_number_of_blocks = cache->number_of_blocks;
-          heep_mem_transactions<<"Cache Flushing at time "<<sc_time_stamp()<<std::endl;
           cache_flushed=0;
           for(int i=0;i<cache_number_of_blocks;i++){
-              if (cache->is_entry_valid_at_index(i)) {
+              if (cache->is_entry_dirty_at_index(i)) {
                 cache_flushed++;
-                //if we are going to replace a valid entry
+                cache_stat.number_of_writeback++;
+                //only dirty entries differ from the memory
                 cache->get_data_at_index(i, cache_data);
                 address_to_replace = cache->get_address_at_index(i);
+                if (classifier) classifier->writeback(address_to_replace);
+                //the copy of the L2, if any, becomes up to date
+                int32_t l2_line = l2 ? l2->find_line(address_to_replace) : -1;
+                if (l2_line >= 0) {
+                  memcpy(l2->cache_array[l2_line].data, cache_data, cache_block_size_byte);
+                  l2->clean_entry_at_index(l2_line);
+                }
                 //write back
-                memory_copy(address_to_replace, (uint32_t *)cache_data, cache_block_size_word, true, trans, delay);
+                memory_copy(address_to_replace, (int32_t *)cache_data, cache_block_size_word, true, trans);
+                cache->clean_entry_at_index(i);
+            } else if (cache->is_entry_valid_at_index(i)) {
+                cache_stat.number_of_writeback_saved++;
+            }
+          }
+          //then the lines only written in the L2
+          for(int i=0; l2 != NULL && i<l2->number_of_blocks; i++){
+              if (l2->is_entry_dirty_at_index(i)) {
+                cache_flushed++;
+                l2_stat.number_of_writeback++;
+                memory_copy(l2->get_address_at_index(i), (int32_t *)l2->cache_array[i].data, cache_block_size_word, true, trans);
+                l2->clean_entry_at_index(i);
+            } else if (l2->is_entry_valid_at_index(i)) {
+                l2_stat.number_of_writeback_saved++;
             }
           }
-          heep_mem_transactions<<"Cache Flushed "<< dec << cache_flushed << " entries"<<std::endl;
+          drain_write_buffer(trans);
+          logger->log(TransactionLogger::LOG_SUMMARY, TransactionLogger::EVENT_FLUSHED, now_ns(), 0, 0, cache_flushed);
         } else if (rwdata_io == 2){
           //ByPass Flash from next transaction
+          drain_write_buffer(trans);
           bypass_state = true;
-          heep_mem_transactions<<"Cache ByPass set at time "<<sc_time_stamp()<<std::endl;
-          heep_mem_transactions << "X-HEEP Bypass Cache, at time " << sc_time_stamp() << " }" << std::endl;
+          logger->log(TransactionLogger::LOG_SUMMARY, TransactionLogger::EVENT_BYPASS, now_ns());
         }
-        obi_new_gnt.notify();
-        wait(delay_rvalid_miss);
+        delay_rvalid = delay_rvalid_miss;
       }
 
       else{
 
         if (bypass_state) {
-          heep_mem_transactions << "Cache in bypass state at time " << sc_time_stamp() <<std::endl;
-          wait(delay_gnt_miss);
-          obi_new_gnt.notify();
-          memory_copy(addr_i, &rwdata_io, 1, we_i == true, trans, delay);
-          wait(delay_rvalid_miss);
+          logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_BYPASS_ACCESS, now_ns());
+          consume(delay_gnt_miss);
+          memory_copy(addr_i, &rwdata_io, 1, we_i == true, trans, be_i);
+          delay_rvalid = delay_rvalid_miss;
         } else {
           // we use the cache only to read
-          if(cache->cache_hit(addr_i)){
+          int32_t line_hit = cache->find_line(addr_i);
+          if(line_hit >= 0){
 
-            heep_mem_transactions << "Cache HIT on address " << hex << addr_i << " at time " << sc_time_stamp() <<std::endl;
+            logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_HIT, now_ns(), addr_i);
 
             cache_stat.number_of_hit++;
+            if (classifier) classifier->access(addr_i & mem_addr_mask, true);
 
-            obi_new_gnt.notify();
-            main_mem_data[0] = cache->get_word(addr_i);
-            //if Write, writes to cache
-            if(we_i)
-              cache->set_word(addr_i, rwdata_io);
+            if(cache->cache_array[line_hit].prefetched) {
+              cache->cache_array[line_hit].prefetched = false;
+              prefetcher.stat.number_of_useful++;
+              prefetcher.train(addr_i);
+            }
+
+            //if Write, writes to cache, and to the memory with write-through
+            delay_rvalid = delay_rvalid_hit;
+            if(we_i) {
+              cache->set_word_at_index(line_hit, addr_i, rwdata_io, be_i);
+              if(write_policy == WRITE_THROUGH) {
+                cache->clean_entry_at_index(line_hit);
+                if(!write_word_below(addr_i, rwdata_io, be_i, trans))
+                  delay_rvalid = delay_rvalid_miss;
+              }
+            }
             else
-              rwdata_io = main_mem_data[0];
-            wait(delay_rvalid_hit);
+              rwdata_io = cache->get_word_at_index(line_hit, addr_i);
           }
 
           else { //miss case
 
             cache_stat.number_of_miss++;
+            if (classifier) classifier->access(addr_i & mem_addr_mask, false);
 
-            heep_mem_transactions << "Cache MISS on address " << hex << addr_i << " at time " << sc_time_stamp() <<std::endl;
+            if(prefetcher.enabled()) {
+              prefetcher.demand_miss(addr_i);
+              prefetcher.train(addr_i);
+            }
 
-            //wait some time before giving the gnt as we have a miss
-            wait(delay_gnt_miss);
-            obi_new_gnt.notify();
+            logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_MISS, now_ns(), addr_i);
 
-            uint32_t addr_to_read = cache->get_base_address(addr_i);
-            uint32_t addr_offset  = cache->get_block_offset(addr_i);
+            //without allocation, a write miss leaves the cache as it is
+            if(we_i && !write_allocate) {
+              delay_rvalid = write_word_below(addr_i, rwdata_io, be_i, trans) ? delay_rvalid_hit : delay_rvalid_miss;
+            } else {
+              //wait some time before accessing the memory as we have a miss, the L2 waits itself after its lookup
+              if (l2 == NULL)
+                consume(delay_gnt_miss);
 
-            //first read block_size bytes from memory to place them in cache regardless of the cmd
-            memory_copy(addr_to_read, main_mem_data, cache_block_size_word, false, trans, delay);
-            uint32_t index_to_add = cache->get_index(addr_i);
-            uint32_t tag_to_add       = cache->get_tag(addr_i);
+              uint32_t addr_offset  = cache->get_block_offset(addr_i);
+              bool     l2_hit;
 
-            heep_mem_transactions << "Adding to Cache TAG " << hex << tag_to_add << " and index " << hex << index_to_add <<std::endl;
+              //first read block_size bytes from the L2 or the memory to place them in cache regardless of the cmd
+              uint32_t line_to_replace = refill_line(addr_i, trans, main_mem_data, cache_data, &l2_hit);
 
-            //always write back what will be replace if valid as we do not have dirty bits for simplicity
-            if (cache->is_entry_valid(addr_i)) {
-              //if we are going to replace a valid entry
-              cache->get_data(addr_i, cache_data);
-              address_to_replace = cache->get_address(addr_i);
-              uint32_t index_to_replace = cache->get_index(addr_i);
-              uint32_t tag_to_replace = cache->get_tag_from_index(index_to_replace);
+              //wait some time before giving the rvalid
+              delay_rvalid = l2_hit ? delay_rvalid_hit : delay_rvalid_miss;
 
-              heep_mem_transactions << "Cache Replace address " << hex << addr_i << " with address " << hex << address_to_replace << " due to the MISS at time " << sc_time_stamp() <<std::endl;
-              heep_mem_transactions << "Index to replace " << hex << index_to_replace << " Tag to replace " << tag_to_replace <<std::endl;
+              //if Write, writes to cache, and to the memory with write-through
+              if(we_i) {
+                cache->set_word_at_index(line_to_replace, addr_i, rwdata_io, be_i);
+                if(write_policy == WRITE_THROUGH) {
+                  cache->clean_entry_at_index(line_to_replace);
+                  write_word_below(addr_i, rwdata_io, be_i, trans);
+                }
+              }
 
-              //write back
-              memory_copy(address_to_replace, (uint32_t *)cache_data, cache_block_size_word, true, trans, delay);
+              //now give back the rdata
+              rwdata_io = main_mem_data[addr_offset>>2]; //>>2 as addr_offset is for byte address, not words
             }
 
-            //now replace the entry in cache
-            cache->add_entry(addr_i, (uint8_t*)main_mem_data);
-
-            //if Write, writes to cache
-            if(we_i)
-              cache->set_word(addr_i, rwdata_io);
-
-            //now give back the rdata
-            rwdata_io = main_mem_data[addr_offset>>2]; //>>2 as addr_offset is for byte address, not words
-
-            //wait some time before giving the rvalid
-            wait(delay_rvalid_miss);
-
           }
         }
       }
 
-      heep_mem_transactions << "X-HEEP tlm_generic_payload RESP: { DATA = 0x" << hex << rwdata_io <<", at time " << sc_time_stamp() << " }" << std::endl;
-      cache->print_cache_status(cache_stat.number_of_transactions++, sc_time_stamp().to_string());
+      logger->log(TransactionLogger::LOG_TRANSACTIONS, TransactionLogger::EVENT_RESP, now_ns(), addr_i, rwdata_io);
+      cache_stat.number_of_transactions++;
+      if(logger->enabled(TransactionLogger::LOG_FULL) || (cache_snapshot != 0 && cache_stat.number_of_transactions % cache_snapshot == 0))
+        cache->print_cache_status(cache_stat.number_of_transactions, local_time().to_string());
 
-      obi_new_rvalid.notify();
+      obi_response_t resp = { rwdata_io, local_time() + delay_rvalid };
+      obi_responses.push_back(resp);
 
     }
   }
@@ -0,0 +1,168 @@
+#ifndef MEMORYTIMING_H
+#define MEMORYTIMING_H
+
+#include "systemc"
+using namespace sc_core;
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// Timing of the external memory, selected with +mem_profile=<profile>.
+// A transaction costs the command and address clocks, the access latency (of a row hit with a
+// row buffer, the initial latency of the device otherwise), the activation of the row if it is
+// not open and the precharge of the row it replaces, then the data clocks of the interface.
+// A transaction that would overlap a refresh of the device waits for its end, and a refresh
+// closes the rows. A burst crossing a page or a row is split in transactions, each one with
+// its command, address and latency.
+class MemoryTiming
+{
+
+public:
+  typedef struct profile {
+    const char* name;
+    double   clk_ns;           // period of the memory interface
+    double   bytes_per_clk;    // width of the data bus, twice for DDR
+    uint32_t cmd_clks;         // command and address clocks of each transaction
+    double   read_latency_ns;  // read access on a row hit, or initial latency without row buffer
+    double   write_latency_ns; // write access on a row hit, or initial latency without row buffer
+    double   activate_ns;      // added when the row is not open
+    double   precharge_ns;     // added when another row of the bank is open
+    uint32_t row_size_byte;    // 0 without row buffer
+    uint32_t banks;            // each with its open row
+    double   refresh_interval_ns; // 0 without refresh stall
+    double   refresh_ns;
+    uint32_t page_size_byte;   // longest transaction, 0 for unlimited
+  } profile_t;
+
+  typedef struct timing_statistics {
+    uint64_t number_of_transactions;
+    uint64_t number_of_row_hits;
+    uint64_t number_of_row_misses;
+    uint64_t number_of_refresh_stalls;
+    double   busy_ns;          // time spent in the transactions, stalls included
+  } timing_statistics_t;
+
+  // Presets of the memories, from the datasheets of common parts
+  static const profile_t* profiles(unsigned int& count) {
+    static const profile_t list[] = {
+      // single-cycle memory, the timing is only given by +mem_beat_latency
+      { "ideal",      0,    0,   0,  0,  0,  0,  0,    0, 0,    0,  0,    0 },
+      // 16-bit SDR SDRAM at 100 MHz, CL2, tRCD = tRP = 20 ns, 1 KB rows, 4 banks, 8K refreshes in 64 ms, tRFC 70 ns
+      { "sdram",      10,   2,   1, 20,  0, 20, 20, 1024, 4, 7800, 70,    0 },
+      // 8-bit DDR HyperRAM at 100 MHz, 48-bit command-address, latency of 6 clocks, doubled by a refresh collision
+      { "hyperram",   10,   2,   3, 60, 60,  0,  0,    0, 1, 4000, 60,    0 },
+      // QSPI PSRAM at 80 MHz, quad read (8 command and address clocks, 6 wait clocks), 1 KB pages, CE low under 8 us
+      { "psram_qspi", 12.5, 0.5, 8, 75,  0,  0,  0,    0, 1, 8000, 50, 1024 },
+    };
+    count = sizeof(list) / sizeof(list[0]);
+    return list;
+  }
+
+  static bool parse_profile(const std::string& name, profile_t& profile) {
+    unsigned int count;
+    const profile_t* list = profiles(count);
+    for (unsigned int i = 0; i < count; i++) {
+      if (name == list[i].name) {
+        profile = list[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  profile_t             profile;
+  timing_statistics_t   stat = {0, 0, 0, 0, 0};
+  std::vector<int64_t>  open_row; // per bank, -1 when closed
+  uint64_t              refresh_count = 0; // refreshes before the last transaction
+
+  MemoryTiming()
+  {
+    parse_profile("ideal", profile);
+  }
+
+  void configure(const profile_t& profile) {
+    this->profile = profile;
+    open_row.assign(profile.banks ? profile.banks : 1, -1);
+  }
+
+  bool enabled() {
+    return profile.clk_ns != 0;
+  }
+
+  // Time of a transaction of len bytes at address starting at start, stalls included
+  sc_time access(uint64_t address, unsigned int len, bool write, const sc_time& start) {
+    double begin = start.to_seconds() * 1e9;
+    double t     = begin;
+    uint32_t page = profile.page_size_byte;
+
+    while (len > 0) {
+      unsigned int chunk = len;
+      if (page != 0 && (address % page) + len > page)
+        chunk = page - (address % page);
+      if (profile.row_size_byte != 0 && (address % profile.row_size_byte) + chunk > profile.row_size_byte)
+        chunk = profile.row_size_byte - (address % profile.row_size_byte);
+      t = transaction(address, chunk, write, t);
+      address += chunk;
+      len     -= chunk;
+    }
+
+    stat.busy_ns += t - begin;
+    return sc_time(t - begin, SC_NS);
+  }
+
+  void print_statistics(std::ostream& out) {
+    if (!enabled())
+      return;
+    out<<"[TESTBENCH]: Memory "<<profile.name<<" "<<stat.number_of_transactions<<" transactions";
+    if (profile.row_size_byte != 0)
+      out<<", "<<stat.number_of_row_hits<<" row hits, "<<stat.number_of_row_misses<<" row misses";
+    out<<", "<<stat.number_of_refresh_stalls<<" refresh stalls, busy "<<(uint64_t)stat.busy_ns<<" ns"<<std::endl;
+  }
+
+private:
+  // Ends a transaction within a page and a row starting at t, returns its end
+  double transaction(uint64_t address, unsigned int len, bool write, double t) {
+    double data_ns  = std::ceil(len / profile.bytes_per_clk) * profile.clk_ns;
+    double duration = profile.cmd_clks * profile.clk_ns + (write ? profile.write_latency_ns : profile.read_latency_ns) + data_ns;
+
+    // the device refreshes at the start of every interval, a transaction that could overlap it waits for its end
+    if (profile.refresh_interval_ns != 0) {
+      uint64_t count = (uint64_t)(t / profile.refresh_interval_ns);
+      double refresh = count * profile.refresh_interval_ns;
+      if (t < refresh + profile.refresh_ns) {
+        t = refresh + profile.refresh_ns;
+        stat.number_of_refresh_stalls++;
+      } else if (t + duration + profile.activate_ns + profile.precharge_ns > refresh + profile.refresh_interval_ns) {
+        count++;
+        t = refresh + profile.refresh_interval_ns + profile.refresh_ns;
+        stat.number_of_refresh_stalls++;
+      }
+      if (count != refresh_count)
+        open_row.assign(open_row.size(), -1);
+      refresh_count = count;
+    }
+
+    if (profile.row_size_byte != 0) {
+      uint64_t row  = address / profile.row_size_byte;
+      uint32_t bank = row % open_row.size();
+      int64_t  bank_row = row / open_row.size();
+      if (open_row[bank] == bank_row) {
+        stat.number_of_row_hits++;
+      } else {
+        stat.number_of_row_misses++;
+        duration += profile.activate_ns + (open_row[bank] >= 0 ? profile.precharge_ns : 0);
+        open_row[bank] = bank_row;
+      }
+    }
+
+    stat.number_of_transactions++;
+    return t + duration;
+  }
+
+};
+
+#endif
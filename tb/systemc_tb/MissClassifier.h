@@ -0,0 +1,108 @@
+#ifndef MISSCLASSIFIER_H
+#define MISSCLASSIFIER_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+
+// Classification of the misses of the cache in the three Cs:
+//   compulsory  first access to the line
+//   capacity    the line would also miss in a fully-associative LRU cache of the same size
+//   conflict    the line would hit in that cache, it was evicted by the mapping of the sets
+// The fully-associative cache is a shadow of the demand accesses, it holds no data.
+// The accesses, misses and write-backs are also counted per region of region_size_byte bytes.
+class MissClassifier
+{
+
+public:
+  typedef enum {
+    MISS_COMPULSORY,
+    MISS_CAPACITY,
+    MISS_CONFLICT
+  } miss_class_t;
+
+  typedef struct region_statistics {
+    uint64_t accesses;
+    uint64_t hits;
+    uint64_t misses[3];  // per miss_class_t
+    uint64_t writebacks; // dirty lines of the region written back
+  } region_statistics_t;
+
+  uint32_t block_size_byte  = 16;
+  uint32_t number_of_blocks = 256;
+  uint32_t region_size_byte = 4096;
+
+  region_statistics_t                     total;
+  std::map<uint32_t, region_statistics_t> regions; // by base address
+
+  std::unordered_set<uint32_t> seen;    // lines ever accessed
+  std::list<uint32_t>          lru;     // lines of the shadow cache, most recent first
+  std::unordered_map<uint32_t, std::list<uint32_t>::iterator> shadow;
+
+  MissClassifier()
+  {
+    total = region_statistics_t();
+  }
+
+  void configure(uint32_t block_size_byte, uint32_t number_of_blocks, uint32_t region_size_byte) {
+    this->block_size_byte  = block_size_byte;
+    this->number_of_blocks = number_of_blocks;
+    this->region_size_byte = region_size_byte;
+  }
+
+  static const char* class_name(int miss_class) {
+    static const char* names[] = { "compulsory", "capacity", "conflict" };
+    return names[miss_class];
+  }
+
+  region_statistics_t& region(uint32_t addr) {
+    return regions[addr - addr % region_size_byte];
+  }
+
+  // Counts a demand access of the cache, hit or not
+  void access(uint32_t addr, bool hit) {
+    uint32_t line = addr / block_size_byte;
+    bool shadow_hit = touch(line);
+    bool first      = seen.insert(line).second;
+    region_statistics_t& r = region(addr);
+
+    total.accesses++;
+    r.accesses++;
+    if (hit) {
+      total.hits++;
+      r.hits++;
+      return;
+    }
+    miss_class_t miss_class = first ? MISS_COMPULSORY : (shadow_hit ? MISS_CONFLICT : MISS_CAPACITY);
+    total.misses[miss_class]++;
+    r.misses[miss_class]++;
+  }
+
+  // Counts a dirty line written back
+  void writeback(uint32_t addr) {
+    total.writebacks++;
+    region(addr).writebacks++;
+  }
+
+private:
+  // Accesses the line in the shadow cache, returns true on a hit
+  bool touch(uint32_t line) {
+    auto it = shadow.find(line);
+    if (it != shadow.end()) {
+      lru.splice(lru.begin(), lru, it->second);
+      return true;
+    }
+    lru.push_front(line);
+    shadow[line] = lru.begin();
+    if (lru.size() > number_of_blocks) {
+      shadow.erase(lru.back());
+      lru.pop_back();
+    }
+    return false;
+  }
+};
+
+#endif
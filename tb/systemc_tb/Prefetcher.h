@@ -0,0 +1,163 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+
+// Next-line and stride prefetcher of the cache.
+// Without a PC, the streams are told apart by their address: an access belongs to the
+// stream whose last line is within STREAM_WINDOW lines, otherwise it starts a new stream.
+class CachePrefetcher
+{
+
+public:
+  // Prefetch modes, selected with +cache_prefetch=off|next_line|stride
+  typedef enum {
+    PREFETCH_OFF,
+    PREFETCH_NEXT_LINE, // the degree lines after the missing one
+    PREFETCH_STRIDE     // the degree next lines of a stream once its stride is seen twice
+  } prefetch_mode_t;
+
+  enum { NUMBER_OF_STREAMS = 8, STREAM_WINDOW = 16, QUEUE_DEPTH = 16 };
+
+  typedef struct stream {
+    bool     valid;
+    uint32_t last_line;
+    int32_t  stride;      // in lines
+    uint32_t confidence;  // times the stride was seen again
+    uint64_t last_use;
+  } stream_t;
+
+  typedef struct prefetch_statistics {
+    uint32_t number_of_issued;    // lines read from memory by the prefetcher
+    uint32_t number_of_redundant; // prefetches dropped as the line was already in the cache
+    uint32_t number_of_useful;    // prefetched lines hit by a demand access (prefetch hits)
+    uint32_t number_of_late;      // demand misses on a line still waiting to be prefetched
+    uint32_t number_of_useless;   // prefetched lines evicted before any demand access
+  } prefetch_statistics_t;
+
+  prefetch_mode_t       mode            = PREFETCH_OFF;
+  uint32_t              degree          = 1;
+  uint32_t              block_size_byte = 16;
+  prefetch_statistics_t stat            = {0, 0, 0, 0, 0};
+
+  stream_t              streams[NUMBER_OF_STREAMS];
+  std::deque<uint32_t>  queue; // base address of the lines to prefetch
+  uint64_t              access_counter = 0;
+
+  CachePrefetcher()
+  {
+    for (int i = 0; i < NUMBER_OF_STREAMS; i++)
+      streams[i].valid = false;
+  }
+
+  static bool parse_mode(const std::string& name, prefetch_mode_t& mode) {
+    if(name == "off")            mode = PREFETCH_OFF;
+    else if(name == "next_line") mode = PREFETCH_NEXT_LINE;
+    else if(name == "stride")    mode = PREFETCH_STRIDE;
+    else return false;
+    return true;
+  }
+
+  void configure(prefetch_mode_t mode, uint32_t degree, uint32_t block_size_byte) {
+    this->mode            = mode;
+    this->degree          = degree;
+    this->block_size_byte = block_size_byte;
+  }
+
+  bool enabled() {
+    return mode != PREFETCH_OFF;
+  }
+
+  // Trains on a demand miss, or a demand hit on a prefetched line, and queues the lines to prefetch
+  void train(uint32_t address) {
+    uint32_t line = address / block_size_byte;
+
+    if (mode == PREFETCH_NEXT_LINE) {
+      for (uint32_t k = 1; k <= degree; k++)
+        enqueue(line + k);
+      return;
+    }
+    if (mode != PREFETCH_STRIDE)
+      return;
+
+    stream_t* s = find_stream(line);
+    if (s == NULL) {
+      s = allocate_stream();
+      s->valid      = true;
+      s->last_line  = line;
+      s->stride     = 0;
+      s->confidence = 0;
+    } else {
+      int32_t stride = (int32_t)(line - s->last_line);
+      if (stride == s->stride && stride != 0) {
+        s->confidence++;
+      } else {
+        s->stride     = stride;
+        s->confidence = 0;
+      }
+      s->last_line = line;
+    }
+    s->last_use = ++access_counter;
+
+    if (s->confidence >= 1) {
+      for (uint32_t k = 1; k <= degree; k++)
+        enqueue(line + s->stride * (int32_t)k);
+    }
+  }
+
+  // A demand miss on a queued line: the prefetch is too late, it is dropped
+  bool demand_miss(uint32_t address) {
+    uint32_t base = address - (address % block_size_byte);
+    for (std::deque<uint32_t>::iterator it = queue.begin(); it != queue.end(); ++it) {
+      if (*it == base) {
+        queue.erase(it);
+        stat.number_of_late++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool pop(uint32_t& address) {
+    if (queue.empty())
+      return false;
+    address = queue.front();
+    queue.pop_front();
+    return true;
+  }
+
+private:
+  stream_t* find_stream(uint32_t line) {
+    for (int i = 0; i < NUMBER_OF_STREAMS; i++) {
+      int32_t distance = (int32_t)(line - streams[i].last_line);
+      if (streams[i].valid && distance >= -STREAM_WINDOW && distance <= STREAM_WINDOW)
+        return &streams[i];
+    }
+    return NULL;
+  }
+
+  stream_t* allocate_stream() {
+    stream_t* victim = &streams[0];
+    for (int i = 0; i < NUMBER_OF_STREAMS; i++) {
+      if (!streams[i].valid)
+        return &streams[i];
+      if (streams[i].last_use < victim->last_use)
+        victim = &streams[i];
+    }
+    return victim;
+  }
+
+  void enqueue(uint32_t line) {
+    uint32_t base = line * block_size_byte;
+    for (size_t i = 0; i < queue.size(); i++)
+      if (queue[i] == base) return;
+    if (queue.size() == QUEUE_DEPTH)
+      queue.pop_front();
+    queue.push_back(base);
+  }
+};
+
+#endif
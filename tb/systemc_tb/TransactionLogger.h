@@ -0,0 +1,195 @@
+#ifndef TRANSACTIONLOGGER_H
+#define TRANSACTIONLOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Logger of the external memory transactions.
+// The SystemC thread only pushes fixed-size binary records in a ring buffer,
+// a background thread formats them and writes them to the log file.
+class TransactionLogger
+{
+
+public:
+  // Log levels, selected with +sc_log=off|summary|transactions|full
+  typedef enum {
+    LOG_OFF,          // no log
+    LOG_SUMMARY,      // flush and bypass commands, and the final statistics
+    LOG_TRANSACTIONS, // every transaction (default)
+    LOG_FULL          // every transaction and the cache dump after each of them
+  } log_level_t;
+
+  typedef enum {
+    EVENT_REQ,          // a: address, b: data, c: byte enable, we
+    EVENT_RESP,         // b: data
+    EVENT_HIT,          // a: address
+    EVENT_MISS,         // a: address
+    EVENT_ADD,          // a: tag, b: index, c: way
+    EVENT_REPLACE,      // a: address, b: replaced address, c: replaced tag
+    EVENT_MEM,          // a: address, b: first word, c: number of words, we, bypass
+    EVENT_DMI,          // a: address, c: number of words, we
+    EVENT_BYPASS_ACCESS,
+    EVENT_FLUSH,
+    EVENT_FLUSHED,      // c: number of lines written back
+    EVENT_BYPASS,
+    EVENT_MESSAGE       // text written as is, see message()
+  } event_t;
+
+  typedef struct log_record {
+    double   time_ns;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint8_t  event;
+    bool     we;
+    bool     bypass;
+  } log_record_t;
+
+  log_level_t level;
+
+  TransactionLogger(const std::string& filename, log_level_t level, size_t capacity = 64*1024)
+  : level(level), ring(capacity), head(0), tail(0), done(false)
+  {
+    if (level == LOG_OFF)
+      return;
+    logFile.open(filename);
+    writer = std::thread(&TransactionLogger::drain, this);
+  }
+
+  ~TransactionLogger() {
+    close();
+  }
+
+  static bool parse_level(const std::string& name, log_level_t& level) {
+    if(name == "off")               level = LOG_OFF;
+    else if(name == "summary")      level = LOG_SUMMARY;
+    else if(name == "transactions") level = LOG_TRANSACTIONS;
+    else if(name == "full")         level = LOG_FULL;
+    else return false;
+    return true;
+  }
+
+  bool enabled(log_level_t min_level) {
+    return level >= min_level;
+  }
+
+  // Records an event, called from the SystemC thread
+  void log(log_level_t min_level, event_t event, double time_ns, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, bool we = false, bool bypass = false) {
+    if (level < min_level)
+      return;
+    size_t h = head.load(std::memory_order_relaxed);
+    // wait for the writer if the ring is full
+    while (h - tail.load(std::memory_order_acquire) >= ring.size())
+      std::this_thread::yield();
+    log_record_t& r = ring[h % ring.size()];
+    r.time_ns = time_ns;
+    r.a = a;
+    r.b = b;
+    r.c = c;
+    r.event = event;
+    r.we = we;
+    r.bypass = bypass;
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  // Records a text line, formatted by the caller: only for rare events
+  void message(log_level_t min_level, const std::string& text) {
+    if (level < min_level)
+      return;
+    while (head.load() != tail.load())
+      std::this_thread::yield();
+    messages.push_back(text);
+    log(min_level, EVENT_MESSAGE, 0, messages.size() - 1);
+  }
+
+  // Writes the pending records and stops the writer
+  void close() {
+    if (writer.joinable()) {
+      done.store(true);
+      writer.join();
+      logFile.close();
+    }
+  }
+
+private:
+  std::vector<log_record_t> ring;
+  std::atomic<size_t>       head; // next record written by the SystemC thread
+  std::atomic<size_t>       tail; // next record read by the writer
+  std::atomic<bool>         done;
+  std::vector<std::string>  messages;
+  std::thread               writer;
+  std::ofstream             logFile;
+
+  void drain() {
+    while (true) {
+      size_t t = tail.load(std::memory_order_relaxed);
+      if (t == head.load(std::memory_order_acquire)) {
+        if (done.load())
+          break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      write_record(ring[t % ring.size()]);
+      tail.store(t + 1, std::memory_order_release);
+    }
+    logFile.flush();
+  }
+
+  void write_record(const log_record_t& r) {
+    std::ostream& out = logFile;
+    std::string time = " at time " + std::to_string((uint64_t)r.time_ns) + " ns";
+    out << std::hex;
+    switch (r.event) {
+      case EVENT_REQ:
+        out << "X-HEEP tlm_generic_payload REQ: { " << (r.we ? 'W' : 'R') << ", @0x" << r.a << " , DATA = 0x" << r.b << " BE = " << r.c << "," << time << " }" << std::endl;
+        break;
+      case EVENT_RESP:
+        out << "X-HEEP tlm_generic_payload RESP: { DATA = 0x" << r.b << "," << time << " }" << std::endl;
+        break;
+      case EVENT_HIT:
+        out << "Cache HIT on address " << r.a << time << std::endl;
+        break;
+      case EVENT_MISS:
+        out << "Cache MISS on address " << r.a << time << std::endl;
+        break;
+      case EVENT_ADD:
+        out << "Adding to Cache TAG " << r.a << " and index " << r.b << " way " << std::dec << r.c << std::endl;
+        break;
+      case EVENT_REPLACE:
+        out << "Cache Replace address " << r.a << " with address " << r.b << " due to the MISS" << time << std::endl;
+        out << "Tag to replace " << r.c << std::endl;
+        break;
+      case EVENT_MEM:
+        out << (r.bypass ? "" : "Cache ") << (r.we ? "Writing to Mem[" : "Reading from Mem[") << r.a << "]: " << r.b;
+        out << (r.c > 1 ? " (" + std::to_string(r.c) + " words)" : std::string("")) << time << std::endl;
+        break;
+      case EVENT_DMI:
+        out << "DMI " << (r.we ? "Writing to Mem[" : "Reading from Mem[") << r.a << "]: " << std::dec << r.c << " words" << time << std::endl;
+        break;
+      case EVENT_BYPASS_ACCESS:
+        out << "Cache in bypass state" << time << std::endl;
+        break;
+      case EVENT_FLUSH:
+        out << "X-HEEP Flush Cache," << time << std::endl;
+        break;
+      case EVENT_FLUSHED:
+        out << "Cache Flushed " << std::dec << r.c << " dirty entries" << std::endl;
+        break;
+      case EVENT_BYPASS:
+        out << "X-HEEP Bypass Cache," << time << std::endl;
+        break;
+      case EVENT_MESSAGE:
+        out << messages[r.a] << std::endl;
+        break;
+    }
+  }
+};
+
+#endif
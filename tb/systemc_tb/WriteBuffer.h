@@ -0,0 +1,97 @@
+#ifndef WRITEBUFFER_H
+#define WRITEBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+
+// Write-combining buffer between the cache and the memory, for the writes that do not stay in the cache
+// (write-through, or write misses without allocation).
+// Each entry holds the words written in an aligned block: the writes to a block already in the buffer are
+// merged in its entry, so that the words are written to the memory with one burst when the entry drains.
+class WriteBuffer
+{
+
+public:
+  typedef struct write_buffer_entry {
+    uint32_t             base; // address of the block
+    std::vector<int32_t> data;
+    std::vector<uint8_t> be;   // byte enables of each word, 0 for a word not written
+  } write_buffer_entry_t;
+
+  typedef struct write_buffer_statistics {
+    uint32_t number_of_writes;  // words written into the buffer
+    uint32_t number_of_merged;  // writes to a block already in the buffer
+    uint32_t number_of_drained; // entries written to the memory
+    uint32_t number_of_bursts;  // memory transactions of the drained entries
+  } write_buffer_statistics_t;
+
+  uint32_t                          depth           = 0; // entries, 0 without buffer
+  uint32_t                          block_size_byte = 16;
+  write_buffer_statistics_t         stat            = {0, 0, 0, 0};
+  std::deque<write_buffer_entry_t>  entries;             // oldest first
+
+  bool enabled() {
+    return depth != 0;
+  }
+
+  void configure(uint32_t depth, uint32_t block_size_byte) {
+    this->depth           = depth;
+    this->block_size_byte = block_size_byte;
+    entries.clear();
+  }
+
+  // Adds the bytes of a word selected by be, false if its block is not in the buffer and the buffer is full
+  bool write(uint32_t addr, uint32_t data, uint32_t be) {
+    uint32_t base = addr & ~(block_size_byte - 1);
+    uint32_t word = (addr - base) >> 2;
+    write_buffer_entry_t* entry = NULL;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (entries[i].base == base) {
+        entry = &entries[i];
+        stat.number_of_merged++;
+        break;
+      }
+    }
+    if (entry == NULL) {
+      if (entries.size() >= depth)
+        return false;
+      write_buffer_entry_t new_entry = { base, std::vector<int32_t>(block_size_byte/4, 0), std::vector<uint8_t>(block_size_byte/4, 0) };
+      entries.push_back(new_entry);
+      entry = &entries.back();
+    }
+
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&entry->data[word]);
+    for (int j = 0; j < 4; j++)
+      if ((be >> j) & 1) bytes[j] = (uint8_t)(data >> (8*j));
+    entry->be[word] |= be;
+    stat.number_of_writes++;
+    return true;
+  }
+
+  // Removes the oldest entry
+  bool pop(write_buffer_entry_t& entry) {
+    if (entries.empty())
+      return false;
+    entry = entries.front();
+    entries.pop_front();
+    return true;
+  }
+
+  // Removes an entry overlapping the N words from addr, to be written before they are accessed in the memory
+  bool take_overlapping(uint32_t addr, uint32_t N, write_buffer_entry_t& entry) {
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (entries[i].base < addr + N*4 && addr < entries[i].base + block_size_byte) {
+        entry = entries[i];
+        entries.erase(entries.begin() + i);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+#endif
@@ -9,12 +9,14 @@
 #include "systemc.h"
 #include <stdlib.h>
 #include <iostream>
+#include <chrono>
+#include <fstream>
 #include "XHEEP_CmdLineOptions.hh"
+#include "XHEEP_FirmwareLoader.hh"
+#include "XHEEP_PowerProfiler.hh"
+#include <vector>
 
 sc_event reset_done_event;
-sc_event obi_new_gnt;
-sc_event obi_new_rvalid;
-sc_event obi_new_req;
 
 
 #include "systemc_tb/MemoryRequest.h"
@@ -23,6 +25,13 @@ sc_event obi_new_req;
 
 #define CLK_PERIOD 10
 
+// The simulation loop of sc_main hands over to SystemC for this many cycles at a time
+#define SIM_CHUNK_CYCLES 500
+
+// External memory ports of the testharness, ext_systemc (the default slave of the external
+// region) and ext_systemc1 (its upper half, SYSTEMC_MEMORY1 in testharness_pkg)
+#define EXT_SYSTEMC_PORTS 2
+
 SC_MODULE(external_memory)
 {
   MemoryRequest *memory_request;
@@ -38,46 +47,55 @@ SC_MODULE(external_memory)
   sc_out<bool>         ext_systemc_resp_rvalid_o;
   sc_out<uint32_t>     ext_systemc_resp_rdata_o;
 
-  void notify_obi_transaction () {
-    if(ext_systemc_req_req_i) {
-      obi_new_req.notify();
-      memory_request->we_i    = ext_systemc_req_we_i;
-      memory_request->be_i    = ext_systemc_req_be_i;
-      memory_request->addr_i  = ext_systemc_req_addr_i;
-      memory_request->rwdata_io = ext_systemc_req_wdata_i;
+  // requests granted and not given back with rvalid yet
+  uint32_t outstanding = 0;
+  bool gnt = false, rvalid = false;
+
+  // OBI handshake, run at the clock edges only while a request or a response is pending: when the
+  // port is idle, gnt is high and the method waits for the rise of req, then samples it at the next
+  // edge. At each edge, a request is granted while less than obi_depth are outstanding, and the
+  // responses are given back in order, one per cycle.
+  void obi_handshake () {
+    if (!clk_i.posedge()) {
+      next_trigger(clk_i.posedge_event());
+      return;
     }
-  }
 
-  void give_gnt_back () {
-    while (true) {
-      ext_systemc_resp_gnt_o.write(false);
-      wait(obi_new_gnt);
-      ext_systemc_resp_gnt_o.write(true);
-      wait();
+    if (gnt && ext_systemc_req_req_i) {
+      memory_request->push_request(ext_systemc_req_we_i, ext_systemc_req_be_i, ext_systemc_req_addr_i, ext_systemc_req_wdata_i);
+      outstanding++;
     }
-  }
 
-  void give_rvalid_rdata_back () {
-    while (true) {
-      ext_systemc_resp_rvalid_o.write(false);
-      wait(obi_new_rvalid);
-      ext_systemc_resp_rvalid_o.write(true);
-      ext_systemc_resp_rdata_o.write(memory_request->rwdata_io);
-      wait();
+    uint32_t rdata;
+    bool rvalid_d = memory_request->pop_response(rdata);
+    if (rvalid_d) {
+      outstanding--;
+      ext_systemc_resp_rdata_o.write(rdata);
+    }
+    if (rvalid_d != rvalid) ext_systemc_resp_rvalid_o.write(rvalid_d);
+    rvalid = rvalid_d;
+
+    bool gnt_d = outstanding < memory_request->obi_depth;
+    if (gnt_d != gnt) ext_systemc_resp_gnt_o.write(gnt_d);
+    gnt = gnt_d;
+
+    if (outstanding == 0 && !rvalid && gnt && !ext_systemc_req_req_i) {
+      next_trigger(ext_systemc_req_req_i.posedge_event());
+    } else {
+      next_trigger(clk_i.posedge_event());
     }
   }
 
-  SC_CTOR(external_memory)
+  SC_HAS_PROCESS(external_memory);
+
+  external_memory(sc_module_name name, const std::string& file_suffix = "")
+  : sc_module(name)
   {
     // Instantiate components
-    memory_request = new MemoryRequest("memory_request");
+    memory_request = new MemoryRequest("memory_request", file_suffix);
     memory         = new MainMemory   ("main_memory");
 
-    SC_METHOD(notify_obi_transaction);
-    sensitive << ext_systemc_req_req_i;
-
-    SC_CTHREAD(give_gnt_back, clk_i.pos());
-    SC_CTHREAD(give_rvalid_rdata_back, clk_i.pos());
+    SC_METHOD(obi_handshake);
 
     // Bind memory_request socket to target socket
     memory_request->socket.bind( memory->socket );
@@ -89,7 +107,6 @@ SC_MODULE(testbench)
 {
 
   sc_in<bool> clk_i;
-  sc_out<bool> clk_o;
   sc_out<bool> rst_no;
   sc_out<bool> boot_select_o;
   sc_out<bool> execute_from_flash_o;
@@ -102,16 +119,8 @@ SC_MODULE(testbench)
   std::string* firmware;
 
   bool boot_select_option;
-  unsigned int reset_cycles = 30;
-
-  void make_clock () {
-    while(1) {
-      clk_o.write(false);
-      wait();
-      clk_o.write(true);
-      wait();
-    }
-  }
+  bool fast_loader;
+  unsigned int reset_cycles = 15;
 
   void do_reset_cycle () {
     //active low
@@ -136,7 +145,20 @@ SC_MODULE(testbench)
 
   void load_firmware () {
     wait();
-    dut->tb_loadHEX(firmware->c_str());
+    Vtestharness* top = dut;
+    XHEEP_FirmwareLoader loader([top](uint32_t addr, uint32_t data) { top->tb_writeWord(addr, data); });
+    if(fast_loader && !loader.load(*firmware)) {
+      // $readmemh accepts more of the .hex syntax than the C++ parser
+      if(!XHEEP_FirmwareLoader::is_hex(*firmware)) {
+        sc_stop();
+        return;
+      }
+      std::cout<<"[TESTBENCH]: Falling back to tb_loadHEX"<<std::endl;
+      fast_loader = false;
+    }
+    if(!fast_loader) {
+      dut->tb_loadHEX(firmware->c_str());
+    }
   }
 
   void set_exit_loop () {
@@ -171,7 +193,6 @@ SC_MODULE(testbench)
   SC_CTOR(testbench)
   {
 
-    SC_CTHREAD(make_clock, clk_i.pos());
     SC_CTHREAD(make_stimuli, clk_i.pos());
 
   }
@@ -180,18 +201,255 @@ SC_MODULE(testbench)
 
 };
 
+// Power profiling, the domain states and the RAM bank accesses are sampled every +power_sample cycles
+void samplePower(Vtestharness *dut, XHEEP_PowerProfiler *power_profiler, uint64_t cycle){
+  XHEEP_PowerProfiler::sample_t state;
+  svBit cpu_off, cpu_sleep, periph_off, periph_clkgate;
+  int banks_off, banks_retentive, banks_clkgate, ext_off, ext_retentive, ext_clkgate, nbanks, nexternal;
+  long long gnt;
+
+  dut->tb_getPowerState(&cpu_off, &cpu_sleep, &periph_off, &periph_clkgate, &banks_off, &banks_retentive, &banks_clkgate,
+                        &ext_off, &ext_retentive, &ext_clkgate);
+  state.cpu_off         = cpu_off;
+  state.cpu_sleep       = cpu_sleep;
+  state.periph_off      = periph_off;
+  state.periph_clkgate  = periph_clkgate;
+  state.banks_off       = banks_off;
+  state.banks_retentive = banks_retentive;
+  state.banks_clkgate   = banks_clkgate;
+  state.ext_off         = ext_off;
+  state.ext_retentive   = ext_retentive;
+  state.ext_clkgate     = ext_clkgate;
+
+  dut->tb_getPowerDomains(&nbanks, &nexternal);
+  std::vector<uint64_t> accesses(nbanks);
+  for(int i = 0; i < nbanks; i++) {
+    dut->tb_getSlaveCounters(i + 1, &gnt);
+    accesses[i] = gnt;
+  }
+
+  power_profiler->sample(cycle, state, accesses);
+}
+
+// Settings of an external memory port and of its cache
+typedef struct ext_port_options {
+  uint32_t cache_size, cache_block_size, cache_ways, cache_hit_latency;
+  CacheMemory::replacement_policy_t cache_policy;
+  CachePrefetcher::prefetch_mode_t cache_prefetch;
+  uint32_t cache_prefetch_degree;
+  MemoryRequest::write_policy_t cache_write_policy;
+  bool cache_write_allocate;
+  uint32_t cache_write_buffer;
+  uint32_t l2_size, l2_ways, l2_hit_latency;
+  CacheMemory::replacement_policy_t l2_policy;
+  MemoryRequest::l2_inclusion_t l2_inclusion;
+  uint32_t mem_burst_len, mem_beat_latency;
+  uint64_t mem_size, mem_preload_addr;
+  std::string mem_preload;
+  MemoryTiming::profile_t mem_profile;
+  MemoryRequest::tlm_mode_t mem_tlm;
+  uint32_t cache_snapshot, obi_depth;
+} ext_port_options_t;
+
+// Arguments of the port: those of the command line, followed by the +extN_<option>=<value> ones of the
+// port as +<option>=<value>, which override them as the last occurrence of an option is used
+std::vector<std::string> portArgs(int argc, char* argv[], int port)
+{
+  std::vector<std::string> args(argv, argv + argc);
+  std::string prefix = "+ext" + std::to_string(port) + "_";
+  for(int i = 0; i < argc; i++) {
+    std::string arg = argv[i];
+    if(arg.compare(0, prefix.length(), prefix) == 0)
+      args.push_back("+" + arg.substr(prefix.length()));
+  }
+  return args;
+}
+
+// Reads the settings of a port, stops the simulation if they are wrong
+void parsePortOptions(XHEEP_CmdLineOptions* cmd_lines_options, ext_port_options_t& port)
+{
+  port.cache_size       = cmd_lines_options->get_cache_size();
+  port.cache_block_size = cmd_lines_options->get_cache_block_size();
+  port.cache_ways       = cmd_lines_options->get_cache_ways();
+
+  if(!CacheMemory::parse_replacement_policy(cmd_lines_options->get_cache_policy(), port.cache_policy)) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong cache replacement policy (lru, plru, fifo, random)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if(!CachePrefetcher::parse_mode(cmd_lines_options->get_cache_prefetch(), port.cache_prefetch)) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong cache prefetcher (off, next_line, stride)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  port.cache_prefetch_degree = cmd_lines_options->get_cache_prefetch_degree();
+
+  std::string cache_error = CacheMemory::check_geometry(port.cache_size, port.cache_block_size, port.cache_ways, port.cache_policy);
+  if(!cache_error.empty()) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong cache configuration, "<<cache_error<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  port.cache_hit_latency = cmd_lines_options->get_cache_hit_latency();
+
+  if(!MemoryRequest::parse_write_policy(cmd_lines_options->get_cache_write_policy(), port.cache_write_policy)) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong cache write policy (back, through)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::string cache_write_miss = cmd_lines_options->get_cache_write_miss();
+  if(cache_write_miss != "allocate" && cache_write_miss != "no_allocate") {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong cache write miss policy (allocate, no_allocate)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  port.cache_write_allocate = cache_write_miss == "allocate";
+  port.cache_write_buffer   = cmd_lines_options->get_cache_write_buffer();
+
+  // the L2 has the block size of the cache
+  port.l2_size = cmd_lines_options->get_l2_size();
+  if(port.l2_size != 0) {
+    port.l2_ways        = cmd_lines_options->get_l2_ways();
+    port.l2_hit_latency = cmd_lines_options->get_l2_hit_latency();
+    if(!CacheMemory::parse_replacement_policy(cmd_lines_options->get_l2_policy(), port.l2_policy)) {
+      std::cout<<"[TESTBENCH]: ERROR: Wrong L2 cache replacement policy (lru, plru, fifo, random)"<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if(!MemoryRequest::parse_l2_inclusion(cmd_lines_options->get_l2_inclusion(), port.l2_inclusion)) {
+      std::cout<<"[TESTBENCH]: ERROR: Wrong L2 cache inclusion policy (inclusive, nine, victim)"<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+    cache_error = CacheMemory::check_geometry(port.l2_size, port.cache_block_size, port.l2_ways, port.l2_policy);
+    if(!cache_error.empty()) {
+      std::cout<<"[TESTBENCH]: ERROR: Wrong L2 cache configuration, "<<cache_error<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  port.mem_burst_len    = cmd_lines_options->get_mem_burst_len();
+  port.mem_beat_latency = cmd_lines_options->get_mem_beat_latency();
+  if(!MemoryTiming::parse_profile(cmd_lines_options->get_mem_profile(), port.mem_profile)) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong memory timing profile (ideal, sdram, hyperram, psram_qspi)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if(!MemoryRequest::parse_tlm_mode(cmd_lines_options->get_mem_tlm(), port.mem_tlm)) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong memory TLM-2 protocol (blocking, lt, at)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  port.mem_size         = cmd_lines_options->get_mem_size();
+  port.mem_preload      = cmd_lines_options->get_mem_preload();
+  port.mem_preload_addr = cmd_lines_options->get_mem_preload_addr();
+
+  port.cache_snapshot   = cmd_lines_options->get_cache_snapshot();
+  port.obi_depth        = cmd_lines_options->get_obi_depth();
+
+  if(port.obi_depth == 0) {
+    std::cout<<"[TESTBENCH]: ERROR: The OBI depth must be at least 1"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // at least 32KB, as the last word of the first 32KB is the cache configuration register
+  if(port.mem_size < 32*1024 || port.mem_size > (1ULL << 32) || (port.mem_size & (port.mem_size - 1)) != 0) {
+    std::cout<<"[TESTBENCH]: ERROR: The external memory size must be a power of 2 between 32KB and 4GB"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// Applies the settings of a port to its cache and memory, to be called before the simulation starts
+void configurePort(external_memory* ext_mem, const ext_port_options_t& port, TransactionLogger::log_level_t sc_log, sc_time mem_quantum)
+{
+  ext_mem->memory_request->configure_log(sc_log, port.cache_snapshot);
+  ext_mem->memory_request->obi_depth = port.obi_depth;
+  ext_mem->memory_request->configure_cache(port.cache_size, port.cache_block_size, port.cache_ways, port.cache_policy);
+  if(port.l2_size != 0)
+    ext_mem->memory_request->configure_l2(port.l2_size, port.l2_ways, port.l2_policy, port.l2_inclusion, sc_time(port.l2_hit_latency, SC_NS));
+  ext_mem->memory_request->configure_prefetch(port.cache_prefetch, port.cache_prefetch_degree);
+  ext_mem->memory_request->configure_write(port.cache_write_policy, port.cache_write_allocate, port.cache_write_buffer);
+  ext_mem->memory_request->delay_rvalid_hit = sc_time(port.cache_hit_latency, SC_NS);
+  ext_mem->memory_request->burst_len_word = port.mem_burst_len;
+  ext_mem->memory->configure_burst(port.mem_burst_len, sc_time(port.mem_beat_latency, SC_NS));
+  ext_mem->memory->configure_size(port.mem_size);
+  ext_mem->memory->configure_timing(port.mem_profile);
+  // with the timing of a device, the controller only costs a cycle before and after the memory accesses
+  if(ext_mem->memory->timing.enabled())
+    ext_mem->memory_request->configure_delays(sc_time(CLK_PERIOD, SC_NS), sc_time(CLK_PERIOD, SC_NS), ext_mem->memory_request->delay_rvalid_hit);
+  ext_mem->memory_request->configure_memory(port.mem_size);
+  ext_mem->memory_request->configure_tlm(port.mem_tlm, mem_quantum);
+}
+
+// Loads +mem_preload in the memory of a port, stops the simulation if it does not fit. A binary file is
+// loaded at +mem_preload_addr, while an ELF gives the segments in the window of the port, e.g. the code
+// of an application linked with LINKER=ext_exec, at their offset in the window
+void preloadPort(external_memory* ext_mem, const ext_port_options_t& port, uint32_t window_start, uint32_t window_size)
+{
+  bool loaded;
+
+  if(port.mem_preload.empty())
+    return;
+
+  if(port.mem_preload.size() > 4 && port.mem_preload.compare(port.mem_preload.size() - 4, 4, ".elf") == 0) {
+    MainMemory* memory = ext_mem->memory;
+    bool fits = true;
+    XHEEP_FirmwareLoader loader([=, &fits](uint32_t addr, uint32_t data) {
+      uint32_t offset = addr - window_start;
+      if(offset >= window_size)
+        return;
+      if(offset + 4 > memory->size)
+        fits = false;
+      else
+        memory->copy(offset, reinterpret_cast<unsigned char*>(&data), 4, true);
+    });
+    loaded = loader.load(port.mem_preload) && fits;
+  } else {
+    loaded = ext_mem->memory->preload(port.mem_preload, port.mem_preload_addr);
+  }
+
+  if(!loaded) {
+    std::cout<<"[TESTBENCH]: ERROR: Cannot preload "<<port.mem_preload<<" in the external memory"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// Writes the statistics of the caches of all the ports, see +cache_report
+void writeCacheReport(const std::string& cache_report, external_memory* ext_mem[], uint64_t cycles)
+{
+  std::ofstream json(cache_report);
+
+  if(!json.is_open()) {
+    std::cout<<"[TESTBENCH]: ERROR: cannot write "<<cache_report<<std::endl;
+    return;
+  }
+
+  json<<"{"<<std::endl;
+  json<<"  \"cycles\": "<<cycles<<","<<std::endl;
+  json<<"  \"ports\": ["<<std::endl;
+  for(int i = 0; i < EXT_SYSTEMC_PORTS; i++) {
+    json<<"    ";
+    ext_mem[i]->memory_request->write_report(json, "    ");
+    json<<(i < EXT_SYSTEMC_PORTS - 1 ? "," : "")<<std::endl;
+  }
+  json<<"  ]"<<std::endl;
+  json<<"}"<<std::endl;
+}
+
 int sc_main (int argc, char * argv[])
 {
 
-  std::string firmware;
-  unsigned int max_sim_time, boot_sel, exit_val;
-  bool use_openocd;
+  std::string firmware, power_report, cache_report;
+  uint32_t cache_report_region, mem_quantum;
+  trace_mode_t trace_mode;
+  uint64_t max_sim_time;
+  unsigned int boot_sel, exit_val;
+  bool use_openocd, fast_loader;
   bool run_all = false;
+  ext_port_options_t ports[EXT_SYSTEMC_PORTS];
+  TransactionLogger::log_level_t sc_log;
   Verilated::commandArgs(argc, argv);
-  Verilated::traceEverOn(true);
+
+  auto wall_start = std::chrono::steady_clock::now();
 
   XHEEP_CmdLineOptions* cmd_lines_options = new XHEEP_CmdLineOptions(argc,argv);
 
+  // only +trace=off is supported, the other modes trace the whole simulation
+  trace_mode = cmd_lines_options->get_trace_mode();
+  if(trace_mode != TRACE_OFF) Verilated::traceEverOn(true);
+
   use_openocd = cmd_lines_options->get_use_openocd();
   firmware = cmd_lines_options->get_firmware();
 
@@ -200,10 +458,46 @@ int sc_main (int argc, char * argv[])
     exit(EXIT_FAILURE);
   }
 
+  fast_loader  = cmd_lines_options->get_fast_loader(firmware);
+
   max_sim_time = cmd_lines_options->get_max_sim_time(run_all);
 
   boot_sel     = cmd_lines_options->get_boot_sel();
 
+  // the settings of every port, with the +extN_ options of port N
+  for(int i = 0; i < EXT_SYSTEMC_PORTS; i++) {
+    if(i == 0) {
+      parsePortOptions(cmd_lines_options, ports[i]);
+    } else {
+      std::cout<<"[TESTBENCH]: External memory port "<<i<<std::endl;
+      std::vector<std::string> port_args = portArgs(argc, argv, i);
+      std::vector<char*> port_argv;
+      for(std::string& arg : port_args) port_argv.push_back(&arg[0]);
+      XHEEP_CmdLineOptions port_options(port_argv.size(), port_argv.data());
+      parsePortOptions(&port_options, ports[i]);
+    }
+  }
+
+  if(!TransactionLogger::parse_level(cmd_lines_options->get_sc_log(), sc_log)) {
+    std::cout<<"[TESTBENCH]: ERROR: Wrong SystemC log level (off, summary, transactions, full)"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // the quantum of the loosely-timed ports is global
+  mem_quantum      = cmd_lines_options->get_mem_quantum();
+  if(mem_quantum == 0) {
+    std::cout<<"[TESTBENCH]: ERROR: The quantum of the loosely-timed memory must be at least 1 ns"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  power_report     = cmd_lines_options->get_power_report();
+  cache_report     = cmd_lines_options->get_cache_report();
+  if(!cache_report.empty()) {
+    cache_report_region = cmd_lines_options->get_cache_report_region();
+    if(cache_report_region == 0) {
+      std::cout<<"[TESTBENCH]: ERROR: The cache statistics regions must be at least 1 byte"<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
   if(use_openocd) {
     std::cout<<"[TESTBENCH]: ERROR: Executing from OpenOCD in SystemC is not supported (yet) in X-HEEP"<<std::endl;
     std::cout<<"exit simulation..."<<std::endl;
@@ -216,12 +510,20 @@ int sc_main (int argc, char * argv[])
     exit(EXIT_FAILURE);
   }
 
-  // generate clock, twice the speed as we generate it by dividing it by 2
-  sc_clock clock_sig("clock", CLK_PERIOD>>1, SC_NS, 0.5);
+  // the clock of the DUT, the testbench and the external memory, first rising edge after half a period
+  sc_clock clock_sig("clock", CLK_PERIOD, SC_NS, 0.5, CLK_PERIOD>>1, SC_NS, true);
 
   Vtestharness dut("TOP");
   testbench tb("testbench");
-  external_memory ext_mem("external_memory");
+  // the files of port N are suffixed with _extN, those of port 0 keep their names
+  external_memory* ext_mem[EXT_SYSTEMC_PORTS];
+  for(int i = 0; i < EXT_SYSTEMC_PORTS; i++) {
+    std::string suffix = i == 0 ? "" : "_ext" + std::to_string(i);
+    ext_mem[i] = new external_memory(("external_memory" + suffix).c_str(), suffix);
+    configurePort(ext_mem[i], ports[i], sc_log, sc_time(mem_quantum, SC_NS));
+    if(!cache_report.empty())
+      ext_mem[i]->memory_request->configure_report(cache_report_region);
+  }
 
   svSetScope(svGetScopeFromName("TOP.testharness"));
   svScope scope = svGetScope();
@@ -230,13 +532,29 @@ int sc_main (int argc, char * argv[])
     exit(EXIT_FAILURE);
   }
 
+  // the ports share the external slave region, port 0 its lower half and port 1 its upper half
+  int ext_start, ext_size;
+  dut.tb_getExtSlaveRegion(&ext_start, &ext_size);
+  for(int i = 0; i < EXT_SYSTEMC_PORTS; i++)
+    preloadPort(ext_mem[i], ports[i], (uint32_t)ext_start + i * ((uint32_t)ext_size / 2), (uint32_t)ext_size / 2);
+
+  XHEEP_PowerProfiler *power_profiler = NULL;
+  if(!power_report.empty()) {
+    int nbanks, nexternal;
+    dut.tb_getPowerDomains(&nbanks, &nexternal);
+    power_profiler = new XHEEP_PowerProfiler(nbanks, nexternal, cmd_lines_options->get_power_sample());
+    std::string power_table = cmd_lines_options->get_power_table();
+    std::string power_trace = cmd_lines_options->get_power_trace();
+    if((!power_table.empty() && !power_profiler->load_power_table(power_table)) ||
+       (!power_trace.empty() && !power_profiler->open_trace(power_trace))) exit(EXIT_FAILURE);
+  }
 
   // static values
   tb.boot_select_option = boot_sel == 1;
+  tb.fast_loader        = fast_loader;
 
 
   // Vtestharness interface
-  sc_signal<bool, SC_MANY_WRITERS>     clk;
   sc_signal<bool, SC_MANY_WRITERS>     rst_n;
   sc_signal<bool, SC_MANY_WRITERS>     boot_select;
   sc_signal<bool, SC_MANY_WRITERS>     execute_from_flash;
@@ -247,19 +565,18 @@ int sc_main (int argc, char * argv[])
   sc_signal<bool>     jtag_tdo;
   sc_signal<uint32_t> exit_value;
   sc_signal<bool, SC_MANY_WRITERS>     exit_valid;
-  sc_signal<bool>      ext_systemc_req_req;
-  sc_signal<bool>      ext_systemc_req_we;
-  sc_signal<uint32_t>  ext_systemc_req_be;
-  sc_signal<uint32_t>  ext_systemc_req_addr;
-  sc_signal<uint32_t>  ext_systemc_req_wdata;
-  sc_signal<bool>      ext_systemc_resp_gnt;
-  sc_signal<bool>      ext_systemc_resp_rvalid;
-  sc_signal<uint32_t>  ext_systemc_resp_rdata;
+  sc_signal<bool>      ext_systemc_req_req[EXT_SYSTEMC_PORTS];
+  sc_signal<bool>      ext_systemc_req_we[EXT_SYSTEMC_PORTS];
+  sc_signal<uint32_t>  ext_systemc_req_be[EXT_SYSTEMC_PORTS];
+  sc_signal<uint32_t>  ext_systemc_req_addr[EXT_SYSTEMC_PORTS];
+  sc_signal<uint32_t>  ext_systemc_req_wdata[EXT_SYSTEMC_PORTS];
+  sc_signal<bool>      ext_systemc_resp_gnt[EXT_SYSTEMC_PORTS];
+  sc_signal<bool>      ext_systemc_resp_rvalid[EXT_SYSTEMC_PORTS];
+  sc_signal<uint32_t>  ext_systemc_resp_rdata[EXT_SYSTEMC_PORTS];
 
 
 
   tb.clk_i(clock_sig);
-  tb.clk_o(clk);
   tb.rst_no(rst_n);
   tb.boot_select_o(boot_select);
   tb.execute_from_flash_o(execute_from_flash);
@@ -271,7 +588,7 @@ int sc_main (int argc, char * argv[])
   tb.dut = &dut;
   tb.firmware = &firmware;
 
-  dut.clk_i(clk);
+  dut.clk_i(clock_sig);
   dut.rst_ni(rst_n);
   dut.boot_select_i(boot_select);
   dut.execute_from_flash_i(execute_from_flash);
@@ -282,24 +599,34 @@ int sc_main (int argc, char * argv[])
   dut.jtag_tdo_o(jtag_tdo);
   dut.exit_value_o(exit_value);
   dut.exit_valid_o(exit_valid);
-  dut.ext_systemc_req_req_o(ext_systemc_req_req);
-  dut.ext_systemc_req_we_o(ext_systemc_req_we);
-  dut.ext_systemc_req_be_o(ext_systemc_req_be);
-  dut.ext_systemc_req_addr_o(ext_systemc_req_addr);
-  dut.ext_systemc_req_wdata_o(ext_systemc_req_wdata);
-  dut.ext_systemc_resp_gnt_i(ext_systemc_resp_gnt);
-  dut.ext_systemc_resp_rvalid_i(ext_systemc_resp_rvalid);
-  dut.ext_systemc_resp_rdata_i(ext_systemc_resp_rdata);
-
-  ext_mem.clk_i(clk);
-  ext_mem.ext_systemc_req_req_i(ext_systemc_req_req);
-  ext_mem.ext_systemc_req_we_i(ext_systemc_req_we);
-  ext_mem.ext_systemc_req_be_i(ext_systemc_req_be);
-  ext_mem.ext_systemc_req_addr_i(ext_systemc_req_addr);
-  ext_mem.ext_systemc_req_wdata_i(ext_systemc_req_wdata);
-  ext_mem.ext_systemc_resp_gnt_o(ext_systemc_resp_gnt);
-  ext_mem.ext_systemc_resp_rdata_o(ext_systemc_resp_rdata);
-  ext_mem.ext_systemc_resp_rvalid_o(ext_systemc_resp_rvalid);
+  dut.ext_systemc_req_req_o(ext_systemc_req_req[0]);
+  dut.ext_systemc_req_we_o(ext_systemc_req_we[0]);
+  dut.ext_systemc_req_be_o(ext_systemc_req_be[0]);
+  dut.ext_systemc_req_addr_o(ext_systemc_req_addr[0]);
+  dut.ext_systemc_req_wdata_o(ext_systemc_req_wdata[0]);
+  dut.ext_systemc_resp_gnt_i(ext_systemc_resp_gnt[0]);
+  dut.ext_systemc_resp_rvalid_i(ext_systemc_resp_rvalid[0]);
+  dut.ext_systemc_resp_rdata_i(ext_systemc_resp_rdata[0]);
+  dut.ext_systemc1_req_req_o(ext_systemc_req_req[1]);
+  dut.ext_systemc1_req_we_o(ext_systemc_req_we[1]);
+  dut.ext_systemc1_req_be_o(ext_systemc_req_be[1]);
+  dut.ext_systemc1_req_addr_o(ext_systemc_req_addr[1]);
+  dut.ext_systemc1_req_wdata_o(ext_systemc_req_wdata[1]);
+  dut.ext_systemc1_resp_gnt_i(ext_systemc_resp_gnt[1]);
+  dut.ext_systemc1_resp_rvalid_i(ext_systemc_resp_rvalid[1]);
+  dut.ext_systemc1_resp_rdata_i(ext_systemc_resp_rdata[1]);
+
+  for(int i = 0; i < EXT_SYSTEMC_PORTS; i++) {
+    ext_mem[i]->clk_i(clock_sig);
+    ext_mem[i]->ext_systemc_req_req_i(ext_systemc_req_req[i]);
+    ext_mem[i]->ext_systemc_req_we_i(ext_systemc_req_we[i]);
+    ext_mem[i]->ext_systemc_req_be_i(ext_systemc_req_be[i]);
+    ext_mem[i]->ext_systemc_req_addr_i(ext_systemc_req_addr[i]);
+    ext_mem[i]->ext_systemc_req_wdata_i(ext_systemc_req_wdata[i]);
+    ext_mem[i]->ext_systemc_resp_gnt_o(ext_systemc_resp_gnt[i]);
+    ext_mem[i]->ext_systemc_resp_rdata_o(ext_systemc_resp_rdata[i]);
+    ext_mem[i]->ext_systemc_resp_rvalid_o(ext_systemc_resp_rvalid[i]);
+  }
 
 
 
@@ -309,17 +636,22 @@ int sc_main (int argc, char * argv[])
 
 
   VerilatedVcdSc* tfp = nullptr;
-  tfp = new VerilatedVcdSc;
-  dut.trace(tfp, 99);  // Trace 99 levels of hierarchy
-  tfp->open("waveform.vcd");
+  if(trace_mode != TRACE_OFF) {
+    tfp = new VerilatedVcdSc;
+    dut.trace(tfp, 99);  // Trace 99 levels of hierarchy
+    tfp->open("waveform.vcd");
+  }
 
-  // Simulate until $finish
-  while (!Verilated::gotFinish() && exit_valid !=1 ) {
-      // Flush the wave files each cycle so we can immediately see the output
-      // Don't do this in "real" programs, do it in an abort() handler instead
-      if (tfp) tfp->flush();
-      // Simulate 1ns
-      sc_start(1, SC_NS);
+  // Simulate until $finish, the exit or +max_sim_time (in half cycles), SIM_CHUNK_CYCLES cycles at a
+  // time, or cycle by cycle when the power states are sampled
+  sc_time chunk = sc_time((power_profiler ? 1 : SIM_CHUNK_CYCLES) * CLK_PERIOD, SC_NS);
+  sc_time end_time = sc_time((double)max_sim_time * CLK_PERIOD / 2, SC_NS);
+  while (!Verilated::gotFinish() && exit_valid != 1 && (run_all || sc_time_stamp() < end_time)) {
+      sc_start(run_all ? chunk : std::min(chunk, end_time - sc_time_stamp()));
+      if(power_profiler) {
+        uint64_t cycle = sc_time_stamp().value() / sc_time(CLK_PERIOD, SC_NS).value();
+        if(power_profiler->due(cycle)) samplePower(&dut, power_profiler, cycle);
+      }
   }
 
   if(exit_valid == 1) {
@@ -327,6 +659,26 @@ int sc_main (int argc, char * argv[])
     exit_val = EXIT_SUCCESS;
   } else exit_val = EXIT_FAILURE;
 
+  if(power_profiler) {
+    samplePower(&dut, power_profiler, sc_time_stamp().value() / sc_time(CLK_PERIOD, SC_NS).value());
+    power_profiler->write_report(power_report);
+    delete power_profiler;
+  }
+
+  for(int i = 0; i < EXT_SYSTEMC_PORTS; i++) {
+    std::cout<<"[TESTBENCH]: External memory port "<<i<<std::endl;
+    ext_mem[i]->memory_request->print_cache_statistics();
+    ext_mem[i]->memory->timing.print_statistics(std::cout);
+    ext_mem[i]->memory_request->close_log();
+  }
+
+  uint64_t cycles = sc_time_stamp().value() / sc_time(CLK_PERIOD, SC_NS).value();
+  if(!cache_report.empty())
+    writeCacheReport(cache_report, ext_mem, cycles);
+  double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+  std::cout<<"[TESTBENCH]: Simulated "<<cycles<<" cycles in "<<wall_time<<" s ("
+           <<(unsigned long)(cycles / wall_time)<<" cycles/s)"<<std::endl;
+
   // Final model cleanup
   dut.final();
 
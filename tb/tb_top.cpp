@@ -6,119 +6,1157 @@
 #include "verilated_fst_c.h"
 #include "Vtestharness.h"
 #include "Vtestharness__Syms.h"
+#ifdef XHEEP_VERILATOR_SAVABLE
+#include "verilated_save.h"
+#endif
 
 #include <stdlib.h>
+#include <cstdio>
 #include <iostream>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <sys/stat.h>
 
 #include "XHEEP_CmdLineOptions.hh"
+#include "XHEEP_FirmwareLoader.hh"
+#include "XHEEP_PowerProfiler.hh"
+#include "XHEEP_PcProfiler.hh"
+#include "XHEEP_MemHeatmap.hh"
+#include "XHEEP_EventTrace.hh"
+#include "XHEEP_SwitchState.hh"
+#include "spi_flash_dpi.h"
 
 vluint64_t sim_time = 0;
 
-void runCycles(unsigned int ncycles, Vtestharness *dut, VerilatedFstC *m_trace){
+// Waveform tracing, the trace file is only opened once the window [trace_start, trace_end) is reached
+trace_mode_t trace_mode;
+VerilatedFstC *m_trace = NULL;
+vluint64_t trace_start, trace_end, trace_cycles; // in clock cycles
+uint32_t trace_pc;
+bool trace_triggered = false;
+
+// TRACE_EXIT keeps the last trace_cycles cycles: the trace alternates between two segment files of
+// trace_cycles cycles, so the previous and the current segment always hold the cycles before the exit
+const char *trace_segments[2] = {"waveform_seg0.vcd", "waveform_seg1.vcd"};
+int trace_segment = -1;
+vluint64_t trace_segment_start, trace_prev_start;
+bool trace_wrapped = false;
+
+void triggerTrace(vluint64_t cycle){
+  trace_triggered = true;
+  trace_start     = cycle;
+  trace_end       = (trace_cycles > UINT64_MAX - cycle) ? UINT64_MAX : cycle + trace_cycles;
+  std::cout<<"[TESTBENCH]: Trace triggered at cycle "<<cycle<<std::endl;
+}
+
+void rotateTrace(vluint64_t cycle){
+  if(m_trace->isOpen()) m_trace->close();
+  trace_wrapped       = trace_segment >= 0;
+  trace_segment       = (trace_segment + 1) & 1;
+  trace_prev_start    = trace_segment_start;
+  trace_segment_start = cycle;
+  m_trace->open(trace_segments[trace_segment]);
+}
+
+// Closes the ring of TRACE_EXIT, the current segment becomes waveform.vcd and the previous one waveform_prev.vcd
+void keepTrace(vluint64_t cycle){
+  trace_triggered = true;
+  if(trace_segment < 0) return;
+  if(m_trace->isOpen()) m_trace->close();
+  std::remove("waveform_prev.vcd");
+  std::rename(trace_segments[trace_segment], "waveform.vcd");
+  if(trace_wrapped) {
+    std::rename(trace_segments[trace_segment ^ 1], "waveform_prev.vcd");
+    std::cout<<"[TESTBENCH]: Trace of cycles ["<<trace_prev_start<<", "<<trace_segment_start
+             <<") in waveform_prev.vcd and ["<<trace_segment_start<<", "<<cycle<<"] in waveform.vcd"<<std::endl;
+  } else {
+    std::cout<<"[TESTBENCH]: Trace of cycles [0, "<<cycle<<"] in waveform.vcd"<<std::endl;
+  }
+}
+
+void dumpTrace(Vtestharness *dut){
+  vluint64_t cycle = sim_time >> 1;
+
+  if(trace_mode == TRACE_EXIT) {
+    if(trace_triggered) return;
+    if(trace_segment < 0 || cycle - trace_segment_start >= trace_cycles) rotateTrace(cycle);
+    m_trace->dump(sim_time);
+    if(dut->clk_i && dut->exit_valid_o) keepTrace(cycle);
+    return;
+  }
+
+  if(!trace_triggered && dut->clk_i && trace_mode == TRACE_PC) {
+    svBit req;
+    int addr;
+    dut->tb_get_core_instr_req(&req, &addr);
+    if(req && (uint32_t)addr == trace_pc) triggerTrace(cycle);
+  }
+
+  if(cycle >= trace_start && cycle < trace_end) {
+    if(!m_trace->isOpen()) m_trace->open("waveform.vcd");
+    m_trace->dump(sim_time);
+  } else if(cycle >= trace_end && m_trace->isOpen()) {
+    m_trace->close();
+    std::cout<<"[TESTBENCH]: Trace closed at cycle "<<cycle<<std::endl;
+  }
+}
+
+// Checkpointing, the model state is saved once at checkpoint_cycle (or after the memory is loaded)
+std::string save_checkpoint;
+vluint64_t checkpoint_cycle = UINT64_MAX;
+
+void saveCheckpoint(Vtestharness *dut){
+#ifdef XHEEP_VERILATOR_SAVABLE
+  VerilatedSave os;
+  os.open(save_checkpoint.c_str());
+  os << sim_time;
+  os << *dut;
+  os.close();
+  std::cout<<"[TESTBENCH]: Checkpoint saved at cycle "<<(sim_time >> 1)<<" to "<<save_checkpoint<<std::endl;
+#else
+  std::cout<<"[TESTBENCH]: ERROR: the model is not built with --savable, cannot save "<<save_checkpoint<<std::endl;
+#endif
+  save_checkpoint.clear();
+}
+
+bool restoreCheckpoint(Vtestharness *dut, const std::string& checkpoint){
+#ifdef XHEEP_VERILATOR_SAVABLE
+  VerilatedRestore os;
+  os.open(checkpoint.c_str());
+  if(!os.isOpen()) return false;
+  os >> sim_time;
+  os >> *dut;
+  os.close();
+  std::cout<<"[TESTBENCH]: Checkpoint restored at cycle "<<(sim_time >> 1)<<std::endl;
+  return true;
+#else
+  std::cout<<"[TESTBENCH]: ERROR: the model is not built with --savable"<<std::endl;
+  return false;
+#endif
+}
+
+// Power profiling, the domain states and the RAM bank accesses are sampled every +power_sample cycles
+XHEEP_PowerProfiler *power_profiler = NULL;
+
+void samplePower(Vtestharness *dut){
+  XHEEP_PowerProfiler::sample_t state;
+  svBit cpu_off, cpu_sleep, periph_off, periph_clkgate;
+  int banks_off, banks_retentive, banks_clkgate, ext_off, ext_retentive, ext_clkgate, nbanks, nexternal;
+  long long gnt;
+
+  dut->tb_getPowerState(&cpu_off, &cpu_sleep, &periph_off, &periph_clkgate, &banks_off, &banks_retentive, &banks_clkgate,
+                        &ext_off, &ext_retentive, &ext_clkgate);
+  state.cpu_off         = cpu_off;
+  state.cpu_sleep       = cpu_sleep;
+  state.periph_off      = periph_off;
+  state.periph_clkgate  = periph_clkgate;
+  state.banks_off       = banks_off;
+  state.banks_retentive = banks_retentive;
+  state.banks_clkgate   = banks_clkgate;
+  state.ext_off         = ext_off;
+  state.ext_retentive   = ext_retentive;
+  state.ext_clkgate     = ext_clkgate;
+
+  dut->tb_getPowerDomains(&nbanks, &nexternal);
+  std::vector<uint64_t> accesses(nbanks);
+  for(int i = 0; i < nbanks; i++) {
+    dut->tb_getSlaveCounters(i + 1, &gnt);
+    accesses[i] = gnt;
+  }
+
+  power_profiler->sample(sim_time >> 1, state, accesses);
+}
+
+// PC profile, the number of fetches granted to the core at each address, see util/hot_functions.py
+std::string pc_profile;
+std::map<uint32_t, uint64_t> pc_histogram;
+
+void samplePc(Vtestharness *dut){
+  svBit gnt;
+  int addr;
+  dut->tb_get_core_instr_fetch(&gnt, &addr);
+  if(gnt) pc_histogram[(uint32_t)addr]++;
+}
+
+void writePcProfile(const std::string& file){
+  std::ofstream out(file);
+  if(!out.is_open()) {
+    std::cout<<"[TESTBENCH]: ERROR: cannot write "<<file<<std::endl;
+    return;
+  }
+  out<<"# address fetches"<<std::endl;
+  for(const auto& pc : pc_histogram) {
+    out<<"0x"<<std::hex<<pc.first<<std::dec<<" "<<pc.second<<std::endl;
+  }
+}
+
+// Raw copy of the RAM from addr at exit, e.g. the edge counters of gcov_dump.h for util/app_pgo.py
+void writeMemDump(Vtestharness *dut, const std::string& file, uint32_t addr, uint32_t size){
+  std::ofstream out(file, std::ios::binary);
+  if(!out.is_open()) {
+    std::cout<<"[TESTBENCH]: ERROR: cannot write "<<file<<std::endl;
+    return;
+  }
+  for(uint32_t offset = 0; offset < size; offset += 4) {
+    int word;
+    dut->tb_readWord(addr + offset, &word);
+    uint8_t bytes[4] = {(uint8_t)word, (uint8_t)(word >> 8), (uint8_t)(word >> 16), (uint8_t)(word >> 24)};
+    out.write((const char *)bytes, size - offset < 4 ? size - offset : 4);
+  }
+}
+
+// Profile of the retired PC, flat, call graph and folded stacks, see XHEEP_PcProfiler.hh
+XHEEP_PcProfiler *pc_profiler = NULL;
+
+void sampleRetire(Vtestharness *dut){
+  svBit valid;
+  int pc;
+  dut->tb_get_core_retire(&valid, &pc);
+  if(valid) pc_profiler->retire((uint32_t)pc);
+  if(pc_profiler->due(sim_time >> 1)) pc_profiler->sample(sim_time >> 1);
+}
+
+// Names of the masters of the system crossbar, from their generated indices, then of the external masters
+std::string masterName(Vtestharness *dut, int idx){
+  static const char* dma_names[] = {"dma_read_ch0", "dma_write_ch0", "dma_addr_ch0"};
+  int kind, hart, nsystem;
+  dut->tb_getMasterRole(idx, &kind, &hart);
+  if(kind == 0 || kind == 1) {
+    std::string port = kind == 0 ? "instr" : "data";
+    return hart == 0 ? "core_" + port : "hart" + std::to_string(hart) + "_" + port;
+  }
+  if(kind == 2) return "debug_master";
+  if(kind >= 3) return dma_names[kind - 3];
+  dut->tb_getSystemMasters(&nsystem);
+  return "ext_master" + std::to_string(idx - nsystem);
+}
+
+// Heatmap of the RAM accesses per bank, window and master, see XHEEP_MemHeatmap.hh
+XHEEP_MemHeatmap *mem_heatmap = NULL;
+int heatmap_banks, heatmap_masters;
+
+void sampleHeatmap(Vtestharness *dut){
+  svBit req, gnt, we;
+  int addr;
+
+  for(int i = 0; i < heatmap_banks; i++) {
+    dut->tb_getBankPort(i, &req, &we, &addr);
+    if(req) mem_heatmap->bank_request(i, (uint32_t)addr, we);
+  }
+  for(int i = 0; i < heatmap_masters; i++) {
+    dut->tb_getBusPort(i, &req, &gnt, &we, &addr);
+    if(req) mem_heatmap->master_request(i, (uint32_t)addr, gnt);
+  }
+}
+
+// Binary trace of the retired instructions, bus transactions and interrupts, see XHEEP_EventTrace.hh
+XHEEP_EventTrace *event_trace = NULL;
+std::vector<bool> bus_pending;
+std::vector<uint64_t> bus_request_cycle;
+uint32_t last_irq = 0;
+
+void traceEvents(Vtestharness *dut){
+  svBit valid, req, gnt, we;
+  int pc, irq, addr, nmaster, nslave;
+  uint64_t cycle = sim_time >> 1;
+
+  dut->tb_get_core_retire(&valid, &pc);
+  if(valid) event_trace->retire(cycle, (uint32_t)pc);
+
+  dut->tb_getBusSize(&nmaster, &nslave);
+  for(int i = 0; i < nmaster; i++) {
+    dut->tb_getBusPort(i, &req, &gnt, &we, &addr);
+    if(!req) continue;
+    if(gnt) {
+      event_trace->bus(bus_pending[i] ? bus_request_cycle[i] : cycle, cycle, i, (uint32_t)addr, we);
+      bus_pending[i] = false;
+    } else if(!bus_pending[i]) {
+      bus_pending[i] = true;
+      bus_request_cycle[i] = cycle;
+    }
+  }
+
+  dut->tb_get_core_irq(&irq);
+  if((uint32_t)irq != last_irq) event_trace->irq(cycle, (uint32_t)irq);
+  last_irq = irq;
+}
+
+// Startup time, from the reset release to the first fetch of +startup_pc (e.g. main)
+bool startup_enabled = false, startup_pending = false;
+uint32_t startup_pc;
+vluint64_t reset_release_cycle = 0, startup_cycles = 0;
+
+void sampleStartup(Vtestharness *dut){
+  svBit req;
+  int addr;
+  dut->tb_get_core_instr_req(&req, &addr);
+  if(req && (uint32_t)addr == startup_pc) {
+    startup_pending = false;
+    startup_cycles  = (sim_time >> 1) - reset_release_cycle;
+    std::cout<<"[TESTBENCH]: Startup PC reached "<<startup_cycles<<" cycles after the reset release"<<std::endl;
+  }
+}
+
+// Heartbeat (+heartbeat=<seconds>), the simulated cycles and the speed since the previous one
+double heartbeat_period = 0;
+std::chrono::steady_clock::time_point heartbeat_last;
+vluint64_t heartbeat_cycle = 0;
+
+void heartbeat(){
+  auto now = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration<double>(now - heartbeat_last).count();
+  if(elapsed < heartbeat_period) return;
+  vluint64_t cycle = sim_time >> 1;
+  std::cout<<"[TESTBENCH]: Heartbeat at cycle "<<cycle<<" ("<<(unsigned long)((cycle - heartbeat_cycle) / elapsed)
+           <<" cycles/s)"<<std::endl;
+  heartbeat_last  = now;
+  heartbeat_cycle = cycle;
+}
+
+// Hang detection (+hang_cycles=<cycles>): outside of WFI, the run stops when the core has not retired
+// an instruction at another PC, or the system bus has not seen any request, for hang_cycles cycles
+vluint64_t hang_cycles = 0, hang_pc_cycle = 0;
+uint32_t hang_pc = 0;
+bool hang_detected = false;
+
+void resetHang(){
+  hang_detected = false;
+  hang_pc_cycle = sim_time >> 1;
+}
+
+void sampleHang(Vtestharness *dut){
+  svBit valid, sleep, periph_timer_active;
+  int pc;
+  long long idle_cycles;
+  dut->tb_get_core_retire(&valid, &pc);
+  dut->tb_getSleepState(&sleep, &idle_cycles, &periph_timer_active);
+  if(sleep || (valid && (uint32_t)pc != hang_pc)) hang_pc_cycle = sim_time >> 1;
+  if(valid) hang_pc = pc;
+}
+
+void dumpHangState(Vtestharness *dut, const char *reason){
+  svBit req, gnt, we;
+  int irq, addr, nmaster, nslave;
+  long long mcycle, minstret;
+
+  std::cout<<"[TESTBENCH]: ERROR: hang detected at cycle "<<(sim_time >> 1)<<": "<<reason<<" for "<<hang_cycles
+           <<" cycles"<<std::endl;
+  dut->tb_getCoreCounters(&mcycle, &minstret);
+  dut->tb_get_core_irq(&irq);
+  std::cout<<"[TESTBENCH]:   last retired PC 0x"<<std::hex<<hang_pc<<", irq 0x"<<(uint32_t)irq<<std::dec
+           <<", mcycle "<<mcycle<<", minstret "<<minstret<<std::endl;
+  dut->tb_getBusSize(&nmaster, &nslave);
+  for(int i = 0; i < nmaster; i++) {
+    dut->tb_getBusPort(i, &req, &gnt, &we, &addr);
+    if(req) std::cout<<"[TESTBENCH]:   master "<<i<<" "<<(we ? "write" : "read")<<" 0x"<<std::hex<<(uint32_t)addr
+                     <<std::dec<<(gnt ? "" : " waiting for its grant")<<std::endl;
+  }
+  hang_detected = true;
+}
+
+bool checkHang(Vtestharness *dut){
+  svBit sleep, periph_timer_active;
+  long long idle_cycles;
+  dut->tb_getSleepState(&sleep, &idle_cycles, &periph_timer_active);
+  if(sleep) return false;
+  if((sim_time >> 1) - hang_pc_cycle >= hang_cycles) {
+    dumpHangState(dut, "no instruction retired at another PC");
+  } else if((vluint64_t)idle_cycles >= hang_cycles) {
+    dumpHangState(dut, "no request on the system bus");
+  }
+  return hang_detected;
+}
+
+// Checks done between two chunks of cycles of the run loops, false when the run must stop
+bool monitorRun(Vtestharness *dut){
+  if(heartbeat_period > 0) heartbeat();
+  return !(hang_cycles && checkHang(dut));
+}
+
+void runCycles(unsigned int ncycles, Vtestharness *dut){
   for(unsigned int i = 0; i < ncycles; i++) {
     dut->clk_i ^= 1;
     dut->eval();
-    m_trace->dump(sim_time);
+    if(m_trace) dumpTrace(dut);
     sim_time++;
+    if(!save_checkpoint.empty() && (sim_time >> 1) >= checkpoint_cycle && dut->clk_i == 0) saveCheckpoint(dut);
+    if(power_profiler && dut->clk_i && power_profiler->due(sim_time >> 1)) samplePower(dut);
+    if(!pc_profile.empty() && dut->clk_i) samplePc(dut);
+    if(pc_profiler && dut->clk_i) sampleRetire(dut);
+    if(event_trace && dut->clk_i) traceEvents(dut);
+    if(mem_heatmap && dut->clk_i) sampleHeatmap(dut);
+    if(startup_pending && dut->clk_i) sampleStartup(dut);
+    if(hang_cycles && dut->clk_i) sampleHang(dut);
   }
 }
 
-int main (int argc, char * argv[])
-{
+// Fast-forward of the sleep periods: when the core sleeps and the system bus has been idle for
+// ff_idle_cycles, the always-on rv_timer is advanced to FF_MARGIN_TICKS ticks before its next
+// armed compare. The skipped cycles are added to sim_time, so cycle counts stay correct.
+#define FF_MARGIN_TICKS 2
 
-  std::string firmware;
-  unsigned int max_sim_time, boot_sel, exit_val;
-  bool use_openocd;
-  bool run_all = false;
+bool fast_forward = false;
+vluint64_t ff_idle_cycles, ff_skipped_cycles = 0, ff_jumps = 0;
 
-  Verilated::commandArgs(argc, argv);
+void fastForward(Vtestharness *dut, vluint64_t max_cycles){
+  svBit sleep, periph_timer_active, active[2], intr_en[2];
+  int prescaler[2], step[2], tick_count[2];
+  long long idle_cycles, mtime[2], mtimecmp[2];
+  vluint64_t skip = max_cycles;
+  bool armed = false;
 
-  // Instantiate the model
-  Vtestharness *dut = new Vtestharness;
+  if(dut->clk_i) return;
+  dut->tb_getSleepState(&sleep, &idle_cycles, &periph_timer_active);
+  if(!sleep || periph_timer_active || (vluint64_t)idle_cycles < ff_idle_cycles) return;
 
-  // Open VCD
-  Verilated::traceEverOn (true);
-  VerilatedFstC *m_trace = new VerilatedFstC;
-  dut->trace (m_trace, 99);
-  m_trace->open ("waveform.vcd");
+  for(int h = 0; h < 2; h++) {
+    dut->tb_getTimer(h, &active[h], &intr_en[h], &prescaler[h], &step[h], &tick_count[h], &mtime[h], &mtimecmp[h]);
+    if(!active[h] || !intr_en[h] || step[h] == 0) continue;
+    uint64_t now = mtime[h], cmp = mtimecmp[h];
+    // the interrupt is already pending, the core is about to wake up
+    if(now >= cmp) return;
+    // ticks that keep mtime below mtimecmp
+    uint64_t ticks = (cmp - now - 1) / step[h];
+    if(ticks <= FF_MARGIN_TICKS) return;
+    uint64_t cycles = (ticks - FF_MARGIN_TICKS) * (prescaler[h] + 1) - tick_count[h];
+    if(cycles < skip) skip = cycles;
+    armed = true;
+  }
 
-  XHEEP_CmdLineOptions* cmd_lines_options = new XHEEP_CmdLineOptions(argc,argv);
+  // without an armed timer, the wake-up cannot be predicted
+  if(!armed || skip == 0) return;
 
-  use_openocd = cmd_lines_options->get_use_openocd();
-  firmware = cmd_lines_options->get_firmware();
+  for(int h = 0; h < 2; h++) {
+    if(!active[h]) continue;
+    uint64_t total = tick_count[h] + skip;
+    dut->tb_setTimer(h, total % (prescaler[h] + 1), mtime[h] + (total / (prescaler[h] + 1)) * step[h]);
+  }
 
-  if(firmware.empty() && use_openocd==false){
-      std::cout<<"You must specify the firmware if you are not using OpenOCD"<<std::endl;
-      exit(EXIT_FAILURE);
+  sim_time += skip << 1;
+  ff_skipped_cycles += skip;
+  ff_jumps++;
+}
+
+// Runs the model for ncycles half cycles, or until the exit if run_all is set, fast-forwarding the sleep
+// periods. The run always stops at the cycle max_cycles, or when a hang is detected.
+void runSimulation(Vtestharness *dut, vluint64_t ncycles, bool run_all, vluint64_t max_cycles){
+  vluint64_t end_time = run_all || ncycles > UINT64_MAX - sim_time ? UINT64_MAX : sim_time + ncycles;
+  if(max_cycles < UINT64_MAX >> 1) end_time = std::min<vluint64_t>(end_time, max_cycles << 1);
+  resetHang();
+
+  while((!run_all || dut->exit_valid_o != 1) && sim_time < end_time) {
+    runCycles(std::min<vluint64_t>(500, end_time - sim_time), dut);
+    if(fast_forward) {
+      vluint64_t ff_max_cycles = (end_time - sim_time) >> 1;
+      // do not jump over the checkpoint
+      if(!save_checkpoint.empty() && checkpoint_cycle > (sim_time >> 1))
+        ff_max_cycles = std::min<vluint64_t>(ff_max_cycles, checkpoint_cycle - (sim_time >> 1));
+      fastForward(dut, ff_max_cycles);
+    }
+    if(!monitorRun(dut)) break;
   }
 
-  max_sim_time = cmd_lines_options->get_max_sim_time(run_all);
+  if(run_all && dut->exit_valid_o != 1 && !hang_detected) {
+    std::cout<<"[TESTBENCH]: ERROR: no exit after "<<(sim_time >> 1)<<" cycles"<<std::endl;
+  }
+}
 
-  boot_sel     = cmd_lines_options->get_boot_sel();
+// Dumps the core and system crossbar counters to a JSON file, see tb_util.svh
+void writePerfCounters(Vtestharness *dut, const std::string& perf_json, bool exit_valid){
+  long long mcycle, minstret, req_cycles, gnt, rvalid;
+  int nmaster, nslave, nbanks, conflicts, dma_busy, core_stall;
+  std::ofstream json(perf_json);
 
-  if(boot_sel == 1) {
-    std::cout<<"[TESTBENCH]: ERROR: Executing from SPI is not supported (yet) in Verilator"<<std::endl;
-    std::cout<<"exit simulation..."<<std::endl;
-    exit(EXIT_FAILURE);
+  if(!json.is_open()) {
+    std::cout<<"[TESTBENCH]: ERROR: cannot write "<<perf_json<<std::endl;
+    return;
   }
 
-  svSetScope(svGetScopeFromName("TOP.testharness"));
-  svScope scope = svGetScope();
-  if (!scope) {
-    std::cout<<"Warning: svGetScope failed"<< std::endl;
+  dut->tb_getCoreCounters(&mcycle, &minstret);
+  dut->tb_getBusSize(&nmaster, &nslave);
+  // slaves are ERROR, the RAM banks, DEBUG, AO_PERIPHERAL, PERIPHERAL and FLASH_MEM
+  nbanks = nslave - 5;
+
+  json<<"{"<<std::endl;
+  json<<"  \"exit_valid\": "<<(exit_valid ? "true" : "false")<<","<<std::endl;
+  json<<"  \"exit_value\": "<<dut->exit_value_o<<","<<std::endl;
+  json<<"  \"cycles\": "<<(sim_time >> 1)<<","<<std::endl;
+  json<<"  \"fast_forwarded_cycles\": "<<ff_skipped_cycles<<","<<std::endl;
+  if(startup_enabled) json<<"  \"startup_cycles\": "<<startup_cycles<<","<<std::endl;
+  json<<"  \"core\": { \"mcycle\": "<<mcycle<<", \"minstret\": "<<minstret
+      <<", \"cpi\": "<<(minstret ? (double)mcycle / minstret : 0.0)<<" },"<<std::endl;
+  dut->tb_getGlobalCounters(&dma_busy, &core_stall);
+  json<<"  \"dma_busy_cycles\": "<<(uint32_t)dma_busy<<","<<std::endl;
+  json<<"  \"core_stall_cycles\": "<<(uint32_t)core_stall<<","<<std::endl;
+
+  json<<"  \"masters\": {"<<std::endl;
+  for(int i = 0; i < nmaster; i++) {
+    dut->tb_getMasterCounters(i, &req_cycles, &gnt, &rvalid);
+    std::string name = masterName(dut, i);
+    json<<"    \""<<name<<"\": { \"req_cycles\": "<<req_cycles<<", \"gnt\": "<<gnt
+        <<", \"rvalid\": "<<rvalid<<", \"stall_cycles\": "<<(req_cycles - gnt)
+        <<", \"utilization\": "<<((sim_time >> 1) ? (double)gnt / (sim_time >> 1) : 0.0)<<" }"
+        <<(i < nmaster - 1 ? "," : "")<<std::endl;
+  }
+  json<<"  },"<<std::endl;
+
+  json<<"  \"ram_banks\": {"<<std::endl;
+  for(int i = 0; i < nbanks; i++) {
+    dut->tb_getSlaveCounters(i + 1, &gnt);
+    dut->tb_getBankConflicts(i, &conflicts);
+    json<<"    \"ram"<<i<<"\": { \"accesses\": "<<gnt<<", \"conflicts\": "<<(uint32_t)conflicts<<" }"
+        <<(i < nbanks - 1 ? "," : "")<<std::endl;
+  }
+  json<<"  }"<<std::endl;
+  json<<"}"<<std::endl;
+}
+
+// Content of the boot flash (spi_flash_dpi.sv), written before the reset is released: +flash_image,
+// else the firmware when booting from flash (+boot_sel=1)
+std::string flash_image;
+bool execute_from_flash = true;
+
+void loadFlash(const std::string& image){
+  void *flash = spi_flash_dpi_find("flash_boot");
+  if(!flash) {
+    std::cout<<"[TESTBENCH]: ERROR: no boot flash model in the testharness"<<std::endl;
     exit(EXIT_FAILURE);
   }
+  // the flash is mapped from FLASH_MEM_START_ADDRESS, the model wraps the addresses on its size
+  XHEEP_FirmwareLoader loader([flash](uint32_t addr, uint32_t data) {
+    for(int i = 0; i < 4; i++) spi_flash_dpi_write(flash, addr + i, data >> (8 * i));
+  });
+  if(!loader.load(image)) exit(EXIT_FAILURE);
+  std::cout<<"Flash Loaded"<< std::endl;
+}
 
+void resetDut(Vtestharness *dut, unsigned int boot_sel){
   dut->clk_i                = 0;
   dut->rst_ni               = 1;
   dut->jtag_tck_i           = 0;
   dut->jtag_tms_i           = 0;
   dut->jtag_trst_ni         = 0;
   dut->jtag_tdi_i           = 0;
-  dut->execute_from_flash_i = 1; //this cause boot_sel cannot be 1 anyway
+  dut->execute_from_flash_i = execute_from_flash; //only used when booting from flash
   dut->boot_select_i        = boot_sel;
 
   dut->eval();
-  m_trace->dump(sim_time);
+  if(m_trace) dumpTrace(dut);
   sim_time++;
 
+  //the flash model exists once the first eval has run its initial block
+  if(!flash_image.empty()) loadFlash(flash_image);
+
   dut->rst_ni               = 1;
   //this creates the negedge
-  runCycles(50, dut, m_trace);
+  runCycles(50, dut);
   dut->rst_ni               = 0;
-  runCycles(50, dut, m_trace);
+  runCycles(50, dut);
 
 
   dut->rst_ni = 1;
-  runCycles(20, dut, m_trace);
+  reset_release_cycle = sim_time >> 1;
+  startup_cycles      = 0;
+  startup_pending     = startup_enabled;
+  runCycles(20, dut);
   std::cout<<"Reset Released"<< std::endl;
+}
 
-  //dont need to exit from boot loop if using OpenOCD or Boot from Flash
-  if(use_openocd==false || boot_sel == 1) {
-    dut->tb_loadHEX(firmware.c_str());
-    runCycles(1, dut, m_trace);
+void loadFirmware(Vtestharness *dut, unsigned int boot_sel, bool use_openocd, const std::string& firmware, bool fast_loader){
+  //the boot ROM reads the firmware from the flash, loaded by resetDut
+  if(boot_sel == 1) {
+    std::cout<<"Booting from Flash"<< std::endl;
+  //dont need to exit from boot loop if using OpenOCD
+  } else if(use_openocd==false) {
+    XHEEP_FirmwareLoader loader([dut](uint32_t addr, uint32_t data) { dut->tb_writeWord(addr, data); });
+    if(fast_loader && !loader.load(firmware)) {
+      // $readmemh accepts more of the .hex syntax than the C++ parser
+      if(!XHEEP_FirmwareLoader::is_hex(firmware)) exit(EXIT_FAILURE);
+      std::cout<<"[TESTBENCH]: Falling back to tb_loadHEX"<<std::endl;
+      fast_loader = false;
+    }
+    if(!fast_loader) {
+      dut->tb_loadHEX(firmware.c_str());
+    }
+    runCycles(1, dut);
     dut->tb_set_exit_loop();
     std::cout<<"Set Exit Loop"<< std::endl;
-    runCycles(1, dut, m_trace);
+    runCycles(1, dut);
     std::cout<<"Memory Loaded"<< std::endl;
   } else {
     std::cout<<"Waiting for GDB"<< std::endl;
   }
+}
+
+// Start from the state of the virtual platform (+vp_state), see XHEEP_SwitchState.hh. The boot ROM
+// jumps to the restore program, placed at the boot address (the reset value of SOC_CTRL BOOT_ADDRESS)
+// or, when it would cover the code at pc, right after it. The words of the program are written back
+// once the instruction at pc retires, before the core can fetch them or read them.
+#define VP_STATE_BOOT_ADDRESS 0x180
+#define VP_STATE_PC_MARGIN    64
+#define VP_STATE_TIMEOUT      1000000
+
+static uint32_t jal_x0(int32_t offset){
+  uint32_t imm = (uint32_t)offset;
+  return (imm >> 20 & 1) << 31 | (imm >> 1 & 0x3FF) << 21 | (imm >> 11 & 1) << 20 | (imm >> 12 & 0xFF) << 12 | 0x6F;
+}
+
+void loadSwitchState(Vtestharness *dut, unsigned int boot_sel, const std::string& file){
+  XHEEP_SwitchState state;
+  std::vector<uint32_t> program;
+
+  if(!state.read(file)) exit(EXIT_FAILURE);
+
+  uint32_t ram_end = state.ram_base + 4 * state.ram.size();
+  uint32_t address = VP_STATE_BOOT_ADDRESS;
+  state.restore_program(address, program);
+  if(address < state.pc + VP_STATE_PC_MARGIN && state.pc < address + 4 * program.size()) {
+    address = (state.pc + VP_STATE_PC_MARGIN) & ~3u;
+    state.restore_program(address, program);
+  }
+  if(VP_STATE_BOOT_ADDRESS < state.ram_base || address + 4 * program.size() > ram_end) {
+    std::cout<<"[TESTBENCH]: ERROR: no room in the RAM for the restore program of "<<file<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  resetDut(dut, boot_sel);
+  for(size_t i = 0; i < state.ram.size(); i++) dut->tb_writeWord(state.ram_base + 4 * i, state.ram[i]);
+  for(size_t i = 0; i < program.size(); i++) dut->tb_writeWord(address + 4 * i, program[i]);
+  if(address != VP_STATE_BOOT_ADDRESS) dut->tb_writeWord(VP_STATE_BOOT_ADDRESS, jal_x0(address - VP_STATE_BOOT_ADDRESS));
+  runCycles(1, dut);
+  dut->tb_set_exit_loop();
+
+  svBit valid;
+  int pc;
+  vluint64_t start_time = sim_time;
+  do {
+    runCycles(1, dut);
+    dut->tb_get_core_retire(&valid, &pc);
+    if(sim_time - start_time > 2 * VP_STATE_TIMEOUT) {
+      std::cout<<"[TESTBENCH]: ERROR: the restore program of "<<file<<" did not reach pc 0x"<<std::hex<<state.pc<<std::dec<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+  } while(!(dut->clk_i && valid && (uint32_t)pc == state.pc));
+
+  for(size_t i = 0; i < program.size(); i++)
+    dut->tb_writeWord(address + 4 * i, state.ram[(address - state.ram_base) / 4 + i]);
+  dut->tb_writeWord(VP_STATE_BOOT_ADDRESS, state.ram[(VP_STATE_BOOT_ADDRESS - state.ram_base) / 4]);
+
+  std::cout<<"[TESTBENCH]: Switched from the virtual platform (cycle "<<state.cycle<<") at cycle "<<(sim_time >> 1)
+           <<", "<<state.regs.size()<<" register writes restored"<<std::endl;
+}
 
-  if(run_all==false) {
-    runCycles(max_sim_time, dut, m_trace);
+void resetAndLoad(Vtestharness *dut, unsigned int boot_sel, bool use_openocd, const std::string& firmware, bool fast_loader){
+  resetDut(dut, boot_sel);
+  loadFirmware(dut, boot_sel, use_openocd, firmware, fast_loader);
+}
+
+// Batch of firmware images (+firmware_list), run one after the other by the same model, so that the
+// model is built and elaborated once. Every image starts from the state right after the reset: a
+// checkpoint of it is restored when the model is savable, otherwise the reset sequence is run again
+// (the RAM then keeps the data of the previous image beyond the new one). Each image stops at its
+// exit or after +batch_max_cycles, and gets a line of the combined report.
+typedef struct {
+  std::string firmware;
+  bool exit_valid;
+  unsigned int exit_value;
+  bool hang;
+  vluint64_t cycles;
+  double wall_time;
+} batch_result_t;
+
+bool runBatch(Vtestharness *dut, XHEEP_CmdLineOptions *cmd_lines_options, const std::vector<std::string>& firmwares,
+              unsigned int boot_sel, const std::string& report){
+  vluint64_t max_cycles = cmd_lines_options->get_batch_max_cycles();
+  std::vector<batch_result_t> results;
+  std::string reset_checkpoint;
+
+  resetDut(dut, boot_sel);
+#ifdef XHEEP_VERILATOR_SAVABLE
+  reset_checkpoint = report + ".reset";
+  save_checkpoint  = reset_checkpoint;
+  saveCheckpoint(dut);
+#endif
+
+  for(size_t i = 0; i < firmwares.size(); i++) {
+    batch_result_t result;
+    result.firmware = firmwares[i];
+    std::cout<<"[TESTBENCH]: Batch image "<<(i + 1)<<"/"<<firmwares.size()<<": "<<firmwares[i]<<std::endl;
+
+    auto wall_start = std::chrono::steady_clock::now();
+    if(i > 0) {
+      if(reset_checkpoint.empty() || !restoreCheckpoint(dut, reset_checkpoint)) resetDut(dut, boot_sel);
+    }
+    vluint64_t start_time = sim_time;
+    loadFirmware(dut, boot_sel, false, firmwares[i], cmd_lines_options->get_fast_loader(firmwares[i]));
+
+    vluint64_t end_time = max_cycles > (UINT64_MAX - sim_time) >> 1 ? UINT64_MAX : sim_time + (max_cycles << 1);
+    resetHang();
+    while(dut->exit_valid_o != 1 && sim_time < end_time) {
+      runCycles(std::min<vluint64_t>(500, end_time - sim_time), dut);
+      if(fast_forward) fastForward(dut, (end_time - sim_time) >> 1);
+      if(!monitorRun(dut)) break;
+    }
+
+    result.exit_valid = dut->exit_valid_o == 1;
+    result.exit_value = dut->exit_value_o;
+    result.hang       = hang_detected;
+    result.cycles     = (sim_time - start_time) >> 1;
+    result.wall_time  = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    if(result.exit_valid) {
+      std::cout<<"Program Finished with value "<<result.exit_value<<std::endl;
+    } else if(!result.hang) {
+      std::cout<<"[TESTBENCH]: "<<firmwares[i]<<" did not exit in "<<max_cycles<<" cycles"<<std::endl;
+    }
+    results.push_back(result);
+  }
+
+  if(!reset_checkpoint.empty()) std::remove(reset_checkpoint.c_str());
+
+  unsigned int passed = 0;
+  vluint64_t total_cycles = 0;
+  std::ofstream json(report);
+  if(!json.is_open()) std::cout<<"[TESTBENCH]: ERROR: cannot write "<<report<<std::endl;
+  json<<"{"<<std::endl;
+  json<<"  \"images\": ["<<std::endl;
+  std::cout<<"[TESTBENCH]: Batch results"<<std::endl;
+  for(size_t i = 0; i < results.size(); i++) {
+    const batch_result_t& r = results[i];
+    const char *status = !r.exit_valid ? (r.hang ? "hang" : "timeout") : r.exit_value == 0 ? "pass" : "fail";
+    if(r.exit_valid && r.exit_value == 0) passed++;
+    total_cycles += r.cycles;
+    json<<"    { \"firmware\": \""<<r.firmware<<"\", \"status\": \""<<status<<"\", \"exit_valid\": "
+        <<(r.exit_valid ? "true" : "false")<<", \"exit_value\": "<<r.exit_value<<", \"cycles\": "<<r.cycles
+        <<", \"wall_time_s\": "<<r.wall_time<<" }"<<(i < results.size() - 1 ? "," : "")<<std::endl;
+    std::cout<<"  "<<status<<"\t"<<r.cycles<<" cycles\t"<<r.firmware<<std::endl;
+  }
+  json<<"  ],"<<std::endl;
+  json<<"  \"passed\": "<<passed<<","<<std::endl;
+  json<<"  \"failed\": "<<(results.size() - passed)<<","<<std::endl;
+  json<<"  \"cycles\": "<<total_cycles<<std::endl;
+  json<<"}"<<std::endl;
+  std::cout<<"[TESTBENCH]: "<<passed<<"/"<<results.size()<<" images passed in "<<total_cycles<<" cycles, report in "<<report<<std::endl;
+
+  return passed == results.size();
+}
+
+// Sweep (+sweep=<file>): every line of the file gives the plusargs of a run, added to the ones of the
+// command line (e.g. +firmware and +max_cycles). The runs get a model each, in its own VerilatedContext,
+// and +sweep_threads of them are simulated at a time, so that the model and the libraries are loaded
+// once for the whole sweep. Run i writes its log to <sweep_dir>/run<i>.log and the UART output to
+// <sweep_dir>/run<i>_uart0.log. A run only resets the model, loads the firmware with the fast loader
+// and runs until the exit or +max_cycles: the other options of this testbench use its global state and
+// are not available. The models must be thread-safe, i.e. built with --threads (verilator-sim-mt).
+typedef struct {
+  std::string line;
+  std::vector<std::string> args;
+  bool exit_valid;
+  unsigned int exit_value;
+  vluint64_t cycles;
+  double wall_time;
+} sweep_run_t;
+
+std::mutex sweep_mutex;
+
+void runSweepRun(sweep_run_t& run, const std::string& log_file){
+  std::vector<const char*> args;
+  for(const auto& arg : run.args) args.push_back(arg.c_str());
+  std::ofstream log(log_file);
+  auto wall_start = std::chrono::steady_clock::now();
+
+  VerilatedContext *contextp = new VerilatedContext;
+  contextp->commandArgs(args.size(), args.data());
+  Verilated::threadContextp(contextp);
+  Vtestharness *dut = new Vtestharness(contextp, "TOP");
+  svSetScope(svGetScopeFromName("TOP.testharness"));
+
+  XHEEP_CmdLineOptions options(args.size(), const_cast<char**>(args.data()));
+  std::string firmware = options.getCmdOption(options.argc, options.argv, "+firmware=");
+  std::string arg_max_cycles = options.getCmdOption(options.argc, options.argv, "+max_cycles=");
+  vluint64_t max_cycles = arg_max_cycles.empty() ? UINT64_MAX : stoull(arg_max_cycles);
+  vluint64_t half_cycles = 0;
+  auto step = [&](vluint64_t n) {
+    for(vluint64_t i = 0; i < n; i++) {
+      dut->clk_i ^= 1;
+      dut->eval();
+      half_cycles++;
+    }
+  };
+
+  run.exit_valid = false;
+  run.exit_value = 0;
+  log<<"[TESTBENCH]: Run of "<<run.line<<std::endl;
+
+  // the reset sequence of resetDut()
+  dut->clk_i                = 0;
+  dut->rst_ni               = 1;
+  dut->jtag_tck_i           = 0;
+  dut->jtag_tms_i           = 0;
+  dut->jtag_trst_ni         = 0;
+  dut->jtag_tdi_i           = 0;
+  dut->execute_from_flash_i = 1;
+  dut->boot_select_i        = 0;
+  dut->eval();
+  step(50);
+  dut->rst_ni = 0;
+  step(50);
+  dut->rst_ni = 1;
+  step(20);
+
+  XHEEP_FirmwareLoader loader([dut](uint32_t addr, uint32_t data) { dut->tb_writeWord(addr, data); });
+  if(firmware.empty()) {
+    log<<"[TESTBENCH]: ERROR: no +firmware"<<std::endl;
+  } else if(loader.load(firmware)) {
+    step(1);
+    dut->tb_set_exit_loop();
+    step(1);
+    log<<"[TESTBENCH]: Loaded "<<loader.get_loaded_words()<<" words from "<<firmware<<std::endl;
+
+    vluint64_t end_time = max_cycles > UINT64_MAX >> 1 ? UINT64_MAX : max_cycles << 1;
+    while(dut->exit_valid_o != 1 && half_cycles < end_time) step(std::min<vluint64_t>(500, end_time - half_cycles));
+
+    run.exit_valid = dut->exit_valid_o == 1;
+    run.exit_value = dut->exit_value_o;
+    if(run.exit_valid) {
+      log<<"Program Finished with value "<<run.exit_value<<std::endl;
+    } else {
+      log<<"[TESTBENCH]: ERROR: no exit after "<<(half_cycles >> 1)<<" cycles"<<std::endl;
+    }
   } else {
-    while(dut->exit_valid_o!=1) {
-      runCycles(500, dut, m_trace);
+    log<<"[TESTBENCH]: ERROR: cannot load "<<firmware<<std::endl;
+  }
+
+  dut->final();
+  delete dut;
+  delete contextp;
+
+  run.cycles    = half_cycles >> 1;
+  run.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+  log<<"[TESTBENCH]: Simulated "<<run.cycles<<" cycles in "<<run.wall_time<<" s ("
+     <<(unsigned long)(run.cycles / run.wall_time)<<" cycles/s)"<<std::endl;
+}
+
+bool runSweep(int argc, char *argv[], XHEEP_CmdLineOptions *cmd_lines_options, const std::vector<std::string>& lines){
+#if !defined(VL_THREADED) && VERILATOR_VERSION_INTEGER < 5000000
+  std::cout<<"[TESTBENCH]: ERROR: +sweep needs a model built with --threads, e.g. make verilator-sim-mt VERILATOR_THREADS=1"<<std::endl;
+  return false;
+#endif
+  unsigned int threads = cmd_lines_options->get_sweep_threads();
+  std::string dir      = cmd_lines_options->get_sweep_dir();
+  std::string report   = cmd_lines_options->get_sweep_report();
+  std::vector<sweep_run_t> runs(lines.size());
+
+  mkdir(dir.c_str(), 0755);
+  for(size_t i = 0; i < lines.size(); i++) {
+    runs[i].line = lines[i];
+    runs[i].args.push_back(argv[0]);
+    for(int a = 1; a < argc; a++) {
+      if(std::string(argv[a]).find("+sweep") != 0) runs[i].args.push_back(argv[a]);
     }
+    std::istringstream tokens(lines[i]);
+    std::string arg;
+    while(tokens >> arg) runs[i].args.push_back(arg);
+    runs[i].args.push_back("+UARTDPI_LOG_uart0=" + dir + "/run" + std::to_string(i) + "_uart0.log");
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> pool;
+  auto wall_start = std::chrono::steady_clock::now();
+  for(unsigned int t = 0; t < std::min<size_t>(threads, runs.size()); t++) {
+    pool.emplace_back([&]() {
+      for(size_t i = next++; i < runs.size(); i = next++) {
+        runSweepRun(runs[i], dir + "/run" + std::to_string(i) + ".log");
+        std::lock_guard<std::mutex> lock(sweep_mutex);
+        std::cout<<"[TESTBENCH]: Run "<<i<<" "<<(!runs[i].exit_valid ? "timeout" : runs[i].exit_value == 0 ? "pass" : "fail")
+                 <<" in "<<runs[i].cycles<<" cycles: "<<runs[i].line<<std::endl;
+      }
+    });
+  }
+  for(auto& thread : pool) thread.join();
+  double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+  unsigned int passed = 0;
+  vluint64_t total_cycles = 0;
+  std::ofstream json(report);
+  if(!json.is_open()) std::cout<<"[TESTBENCH]: ERROR: cannot write "<<report<<std::endl;
+  json<<"{"<<std::endl;
+  json<<"  \"runs\": ["<<std::endl;
+  for(size_t i = 0; i < runs.size(); i++) {
+    const sweep_run_t& r = runs[i];
+    const char *status = !r.exit_valid ? "timeout" : r.exit_value == 0 ? "pass" : "fail";
+    if(r.exit_valid && r.exit_value == 0) passed++;
+    total_cycles += r.cycles;
+    std::string line = r.line;
+    std::replace(line.begin(), line.end(), '"', '\'');
+    json<<"    { \"run\": "<<i<<", \"plusargs\": \""<<line<<"\", \"log\": \""<<dir<<"/run"<<i<<".log\", \"status\": \""
+        <<status<<"\", \"exit_valid\": "<<(r.exit_valid ? "true" : "false")<<", \"exit_value\": "<<r.exit_value
+        <<", \"cycles\": "<<r.cycles<<", \"wall_time_s\": "<<r.wall_time<<" }"<<(i < runs.size() - 1 ? "," : "")<<std::endl;
+  }
+  json<<"  ],"<<std::endl;
+  json<<"  \"passed\": "<<passed<<","<<std::endl;
+  json<<"  \"failed\": "<<(runs.size() - passed)<<","<<std::endl;
+  json<<"  \"cycles\": "<<total_cycles<<","<<std::endl;
+  json<<"  \"wall_time_s\": "<<wall_time<<std::endl;
+  json<<"}"<<std::endl;
+  std::cout<<"[TESTBENCH]: "<<passed<<"/"<<runs.size()<<" runs passed, "<<total_cycles<<" cycles in "<<wall_time<<" s ("
+           <<(unsigned long)(total_cycles / wall_time)<<" cycles/s), report in "<<report<<std::endl;
+
+  return passed == runs.size();
+}
+
+int main (int argc, char * argv[])
+{
+
+  std::string firmware, restore_checkpoint, perf_json, power_report, profile, profile_folded, event_trace_file, mem_dump, heatmap, heatmap_csv;
+  std::string batch_report, vp_state;
+  std::vector<std::string> firmware_list;
+  vluint64_t max_sim_time, max_cycles;
+  unsigned int boot_sel, exit_val;
+  bool use_openocd, fast_loader = false;
+  bool run_all = false;
+
+  Verilated::commandArgs(argc, argv);
+
+  auto wall_start = std::chrono::steady_clock::now();
+
+  XHEEP_CmdLineOptions* cmd_lines_options = new XHEEP_CmdLineOptions(argc,argv);
+
+  std::vector<std::string> sweep = cmd_lines_options->get_sweep();
+  if(!sweep.empty()) {
+    bool passed = runSweep(argc, argv, cmd_lines_options, sweep);
+    delete cmd_lines_options;
+    exit(passed ? EXIT_SUCCESS : EXIT_FAILURE);
   }
 
-  if(dut->exit_valid_o==1) {
-    std::cout<<"Program Finished with value "<<dut->exit_value_o<<std::endl;
-    exit_val = EXIT_SUCCESS;
-  } else exit_val = EXIT_FAILURE;
+  trace_mode = cmd_lines_options->get_trace_mode();
+
+  // Instantiate the model
+  if(trace_mode != TRACE_OFF) Verilated::traceEverOn (true);
+  Vtestharness *dut = new Vtestharness;
+
+  // Register the FST trace, it is opened lazily in dumpTrace()
+  if(trace_mode != TRACE_OFF) {
+    m_trace = new VerilatedFstC;
+    dut->trace (m_trace, 99);
+  }
+
+  switch(trace_mode) {
+    case TRACE_WINDOW:
+      trace_start  = cmd_lines_options->get_trace_start();
+      trace_end    = cmd_lines_options->get_trace_end();
+      break;
+    case TRACE_EXIT:
+      trace_cycles = std::max<vluint64_t>(cmd_lines_options->get_trace_cycles(100), 1);
+      break;
+    case TRACE_PC:
+      trace_pc     = cmd_lines_options->get_trace_pc();
+      trace_cycles = cmd_lines_options->get_trace_cycles(UINT64_MAX);
+      trace_start  = trace_end = UINT64_MAX;
+      break;
+    default:
+      trace_start  = 0;
+      trace_end    = UINT64_MAX;
+      break;
+  }
 
-  m_trace->close();
+  use_openocd = cmd_lines_options->get_use_openocd();
+  firmware = cmd_lines_options->get_firmware();
+
+  restore_checkpoint = cmd_lines_options->get_restore_checkpoint();
+  save_checkpoint    = cmd_lines_options->get_save_checkpoint();
+  if(!save_checkpoint.empty()) checkpoint_cycle = cmd_lines_options->get_checkpoint_cycle();
+
+  vp_state = cmd_lines_options->get_vp_state();
+  if(!vp_state.empty() && (use_openocd || !restore_checkpoint.empty())) {
+    std::cout<<"[TESTBENCH]: ERROR: +vp_state cannot be used with OpenOCD or +restore_checkpoint"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  firmware_list = cmd_lines_options->get_firmware_list();
+  if(!firmware_list.empty()) {
+    if(use_openocd || !restore_checkpoint.empty() || !save_checkpoint.empty() || !vp_state.empty()) {
+      std::cout<<"[TESTBENCH]: ERROR: +firmware_list cannot be used with OpenOCD, the checkpoints or +vp_state"<<std::endl;
+      exit(EXIT_FAILURE);
+    }
+    batch_report = cmd_lines_options->get_batch_report();
+    firmware     = firmware_list.front();
+  }
+
+  if(firmware.empty() && use_openocd==false && restore_checkpoint.empty() && vp_state.empty()){
+      std::cout<<"You must specify the firmware if you are not using OpenOCD"<<std::endl;
+      exit(EXIT_FAILURE);
+  }
+
+  perf_json = cmd_lines_options->get_perf_json();
+
+  startup_enabled = cmd_lines_options->get_startup_pc(startup_pc);
+
+  pc_profile = cmd_lines_options->get_pc_profile();
+
+  mem_dump = cmd_lines_options->get_mem_dump();
+  uint32_t mem_dump_addr = 0, mem_dump_size = 0;
+  if(!mem_dump.empty()) {
+    mem_dump_addr = cmd_lines_options->get_mem_dump_addr();
+    mem_dump_size = cmd_lines_options->get_mem_dump_size();
+  }
+
+  profile = cmd_lines_options->get_profile();
+  if(!profile.empty()) {
+    profile_folded = cmd_lines_options->get_profile_folded();
+    pc_profiler = new XHEEP_PcProfiler(cmd_lines_options->get_profile_period());
+    if(!pc_profiler->load_symbols(cmd_lines_options->get_profile_elf(firmware))) exit(EXIT_FAILURE);
+  }
+
+  heatmap = cmd_lines_options->get_mem_heatmap();
+  uint32_t heatmap_window = 0;
+  unsigned int heatmap_top = 0;
+  if(!heatmap.empty()) {
+    heatmap_csv    = cmd_lines_options->get_mem_heatmap_csv();
+    heatmap_window = cmd_lines_options->get_mem_heatmap_window();
+    heatmap_top    = cmd_lines_options->get_mem_heatmap_top();
+  }
+
+  if(!firmware.empty()) fast_loader = cmd_lines_options->get_fast_loader(firmware);
+
+  max_sim_time = cmd_lines_options->get_max_sim_time(run_all);
+  max_cycles   = cmd_lines_options->get_max_cycles();
+
+  heartbeat_period = cmd_lines_options->get_heartbeat();
+  heartbeat_last   = wall_start;
+  hang_cycles      = cmd_lines_options->get_hang_cycles();
+
+  boot_sel     = cmd_lines_options->get_boot_sel();
+
+  power_report = cmd_lines_options->get_power_report();
+
+  fast_forward = cmd_lines_options->get_fast_forward();
+  if(fast_forward) ff_idle_cycles = cmd_lines_options->get_fast_forward_idle();
+
+  flash_image = cmd_lines_options->get_flash_image();
+  if(boot_sel == 1) {
+    execute_from_flash = cmd_lines_options->get_execute_from_flash();
+    if(flash_image.empty()) flash_image = firmware;
+  }
+
+  svSetScope(svGetScopeFromName("TOP.testharness"));
+  svScope scope = svGetScope();
+  if (!scope) {
+    std::cout<<"Warning: svGetScope failed"<< std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  event_trace_file = cmd_lines_options->get_event_trace();
+  if(!event_trace_file.empty()) {
+    int nmaster, nslave, nsystem;
+    dut->tb_getBusSize(&nmaster, &nslave);
+    dut->tb_getSystemMasters(&nsystem);
+    bus_pending.assign(nmaster, false);
+    bus_request_cycle.assign(nmaster, 0);
+    event_trace = new XHEEP_EventTrace(nmaster, nsystem);
+    if(!event_trace->open(event_trace_file)) exit(EXIT_FAILURE);
+  }
+
+  if(!heatmap.empty()) {
+    int nexternal, nslave, mem_size;
+    std::vector<std::string> masters;
+    dut->tb_getPowerDomains(&heatmap_banks, &nexternal);
+    dut->tb_getBusSize(&heatmap_masters, &nslave);
+    dut->tb_getMemSize(&mem_size);
+    for(int i = 0; i < heatmap_masters; i++) masters.push_back(masterName(dut, i));
+    mem_heatmap = new XHEEP_MemHeatmap(heatmap_banks, masters, mem_size, heatmap_window);
+    if(!mem_heatmap->load_symbols(cmd_lines_options->get_profile_elf(firmware))) exit(EXIT_FAILURE);
+  }
+
+  if(!power_report.empty()) {
+    int nbanks, nexternal;
+    dut->tb_getPowerDomains(&nbanks, &nexternal);
+    power_profiler = new XHEEP_PowerProfiler(nbanks, nexternal, cmd_lines_options->get_power_sample());
+    std::string power_table = cmd_lines_options->get_power_table();
+    std::string power_trace = cmd_lines_options->get_power_trace();
+    if((!power_table.empty() && !power_profiler->load_power_table(power_table)) ||
+       (!power_trace.empty() && !power_profiler->open_trace(power_trace))) exit(EXIT_FAILURE);
+  }
+
+  if(!firmware_list.empty()) {
+    // the other outputs (+perf_json, profiles and traces) cover the whole batch
+    exit_val = runBatch(dut, cmd_lines_options, firmware_list, boot_sel, batch_report) ? EXIT_SUCCESS : EXIT_FAILURE;
+  } else {
+    if(!restore_checkpoint.empty()) {
+      // the checkpoint already contains the reset sequence and the loaded firmware
+      if(!restoreCheckpoint(dut, restore_checkpoint)) {
+        std::cout<<"[TESTBENCH]: ERROR: cannot restore checkpoint "<<restore_checkpoint<<std::endl;
+        exit(EXIT_FAILURE);
+      }
+    } else if(!vp_state.empty()) {
+      // the firmware, if any, only gives the symbols of the profiles
+      loadSwitchState(dut, boot_sel, vp_state);
+    } else {
+      resetAndLoad(dut, boot_sel, use_openocd, firmware, fast_loader);
+    }
+
+    if(!save_checkpoint.empty() && checkpoint_cycle == UINT64_MAX) saveCheckpoint(dut);
+
+    runSimulation(dut, max_sim_time, run_all, max_cycles);
+
+    if(dut->exit_valid_o==1) {
+      std::cout<<"Program Finished with value "<<dut->exit_value_o<<std::endl;
+      exit_val = EXIT_SUCCESS;
+    } else exit_val = EXIT_FAILURE;
+  }
+
+  writePerfCounters(dut, perf_json, exit_val == EXIT_SUCCESS);
+
+  if(!pc_profile.empty()) writePcProfile(pc_profile);
+
+  if(!mem_dump.empty()) writeMemDump(dut, mem_dump, mem_dump_addr, mem_dump_size);
+
+  if(event_trace) {
+    event_trace->close();
+    delete event_trace;
+    event_trace = NULL;
+  }
+
+  if(pc_profiler) {
+    pc_profiler->write_report(profile, profile_folded);
+    delete pc_profiler;
+    pc_profiler = NULL;
+  }
+
+  if(mem_heatmap) {
+    mem_heatmap->write_report(heatmap, heatmap_csv, heatmap_top);
+    delete mem_heatmap;
+    mem_heatmap = NULL;
+  }
+
+  if(power_profiler) {
+    samplePower(dut);
+    power_profiler->write_report(power_report);
+    delete power_profiler;
+    power_profiler = NULL;
+  }
+
+  // without an exit, keep the last cycles before the end of the simulation
+  if(trace_mode == TRACE_EXIT && !trace_triggered) keepTrace(sim_time >> 1);
+
+  if(fast_forward) {
+    std::cout<<"[TESTBENCH]: Fast-forwarded "<<ff_skipped_cycles<<" cycles in "<<ff_jumps<<" jumps"<<std::endl;
+  }
+
+  double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+  std::cout<<"[TESTBENCH]: Simulated "<<(sim_time >> 1)<<" cycles in "<<wall_time<<" s ("
+           <<(unsigned long)((sim_time >> 1) / wall_time)<<" cycles/s)"<<std::endl;
+
+  if(m_trace) {
+    if(m_trace->isOpen()) m_trace->close();
+    delete m_trace;
+  }
   delete dut;
   delete cmd_lines_options;
 
@@ -180,6 +180,7 @@ module tb_top #(
     if (exit_valid) begin
       if (exit_value == 0) $display("EXIT SUCCESS");
       else $display("EXIT FAILURE: %d", exit_value);
+      $display("[TESTBENCH]: Simulated %0d cycles", $time / CLK_PERIOD);
       $finish;
     end
   end
@@ -2,6 +2,15 @@
 // Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
 // SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
 
+<%
+  # Word in its bank of the byte address addr: the address bits above the ones
+  # choosing the bank in an interleaved group, then the words of the granularity
+  def word_of(addr, bank):
+    if bank.il_shift() == 2:
+      return f"(({addr}/4) >> {bank.il_level()}) % {bank.size()//4}"
+    return (f"((({addr} >> {bank.il_shift() + bank.il_level()}) << {bank.il_shift() - 2}) | "
+            f"(({addr}/4) & {2**(bank.il_shift() - 2) - 1})) % {bank.size()//4}")
+%>
 `ifndef SYNTHESIS
 // Task for loading 'mem' with SystemVerilog system task $readmemh()
 export "DPI-C" task tb_readHEX;
@@ -9,11 +18,78 @@ export "DPI-C" task tb_loadHEX;
 % for bank in xheep.iter_ram_banks():
 export "DPI-C" task tb_writetoSram${bank.name()};
 % endfor
+export "DPI-C" task tb_writeWord;
+export "DPI-C" task tb_readWord;
 export "DPI-C" task tb_getMemSize;
 export "DPI-C" task tb_set_exit_loop;
+export "DPI-C" task tb_get_core_instr_req;
+export "DPI-C" task tb_get_core_instr_fetch;
+export "DPI-C" task tb_get_core_retire;
+export "DPI-C" task tb_get_core_irq;
+export "DPI-C" task tb_getBusSize;
+export "DPI-C" task tb_getSystemMasters;
+export "DPI-C" task tb_getMasterRole;
+export "DPI-C" task tb_getBusPort;
+export "DPI-C" task tb_getBankPort;
+export "DPI-C" task tb_getMasterCounters;
+export "DPI-C" task tb_getSlaveCounters;
+export "DPI-C" task tb_getBankConflicts;
+export "DPI-C" task tb_getGlobalCounters;
+export "DPI-C" task tb_getCoreCounters;
+export "DPI-C" task tb_getSleepState;
+export "DPI-C" task tb_getTimer;
+export "DPI-C" task tb_setTimer;
+export "DPI-C" task tb_getPowerDomains;
+export "DPI-C" task tb_getPowerState;
+export "DPI-C" task tb_getExtSlaveRegion;
 
 import core_v_mini_mcu_pkg::*;
 
+task tb_getSystemMasters;
+  output int nsystem;
+  nsystem = core_v_mini_mcu_pkg::SYSTEM_XBAR_NMASTER;
+endtask
+
+// Role of a master of the system crossbar, for the names of tb_top.cpp: kind is 0 for the instruction
+// port of a hart, 1 for its data port, 2 for the debug master, 3 to 5 for the read, write and address
+// ports of the DMA and -1 for an external master
+task tb_getMasterRole;
+  input int idx;
+  output int kind;
+  output int hart;
+  kind = -1;
+  hart = 0;
+  if (idx == core_v_mini_mcu_pkg::CORE_INSTR_IDX) kind = 0;
+  if (idx == core_v_mini_mcu_pkg::CORE_DATA_IDX) kind = 1;
+  if (idx == core_v_mini_mcu_pkg::DEBUG_MASTER_IDX) kind = 2;
+  if (idx == core_v_mini_mcu_pkg::DMA_READ_CH0_IDX) kind = 3;
+  if (idx == core_v_mini_mcu_pkg::DMA_WRITE_CH0_IDX) kind = 4;
+  if (idx == core_v_mini_mcu_pkg::DMA_ADDR_CH0_IDX) kind = 5;
+% for h in range(1, num_harts):
+  if (idx == core_v_mini_mcu_pkg::HART${h}_INSTR_IDX) begin
+    kind = 0;
+    hart = ${h};
+  end
+  if (idx == core_v_mini_mcu_pkg::HART${h}_DATA_IDX) begin
+    kind = 1;
+    hart = ${h};
+  end
+% endfor
+endtask
+
+// Request of a master of the system crossbar in this cycle, for the event trace of tb_top.cpp
+task tb_getBusPort;
+  input int idx;
+  output bit req;
+  output bit gnt;
+  output bit we;
+  output int addr;
+  req  = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.master_req[idx].req;
+  gnt  = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.master_resp[idx].gnt;
+  we   = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.master_req[idx].we;
+  addr = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.master_req[idx].addr;
+endtask
+
 task tb_getMemSize;
   output int mem_size;
   mem_size  = core_v_mini_mcu_pkg::MEM_SIZE;
@@ -71,8 +147,8 @@ task tb_loadHEX;
 `else
 % for bank in xheep.iter_ram_banks():
   for (i=${bank.start_address()}; i < ${bank.end_address()}; i = i + 4) begin
-    if (((i/4) & ${2**bank.il_level()-1}) == ${bank.il_offset()}) begin
-      w_addr = ((i/4) >> ${bank.il_level()}) % ${bank.size()//4};
+    if (((i >> ${bank.il_shift()}) & ${2**bank.il_level()-1}) == ${bank.il_offset()}) begin
+      w_addr = ${word_of("i", bank)};
       tb_writetoSram${bank.name()}(w_addr, stimuli[i+3], stimuli[i+2],
                                           stimuli[i+1], stimuli[i]);
     end
@@ -83,6 +159,35 @@ task tb_loadHEX;
 
 endtask
 
+// Writes one 32-bit word at the byte address addr to the RAM bank it is mapped to,
+// used by the C++ firmware loader of the Verilator testbenches
+task tb_writeWord;
+  input int addr;
+  input int data;
+  int w_addr;
+% for bank in xheep.iter_ram_banks():
+  if (addr >= ${bank.start_address()} && addr < ${bank.end_address()} && ((addr >> ${bank.il_shift()}) & ${2**bank.il_level()-1}) == ${bank.il_offset()}) begin
+    w_addr = ${word_of("addr", bank)};
+    tb_writetoSram${bank.name()}(w_addr, data[31:24], data[23:16], data[15:8], data[7:0]);
+  end
+% endfor
+endtask
+
+// Reads one 32-bit word at the byte address addr from the RAM bank it is mapped to,
+// used by the C++ testbench to dump memory at exit (+mem_dump), 0 outside of the RAM
+task tb_readWord;
+  input int addr;
+  output int data;
+  int r_addr;
+  data = 0;
+% for bank in xheep.iter_ram_banks():
+  if (addr >= ${bank.start_address()} && addr < ${bank.end_address()} && ((addr >> ${bank.il_shift()}) & ${2**bank.il_level()-1}) == ${bank.il_offset()}) begin
+    r_addr = ${word_of("addr", bank)};
+    data = x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_i.ram${bank.name()}_i.tc_ram_i.sram[r_addr];
+  end
+% endfor
+endtask
+
 % for bank in xheep.iter_ram_banks():
 task tb_writetoSram${bank.name()};
   input int addr;
@@ -112,4 +217,216 @@ task tb_set_exit_loop;
   x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.soc_ctrl_i.testbench_set_exit_loop[0] = 1'b1;
 `endif
 endtask
+
+// Returns the core instruction fetch request, used by the C++ testbench to trigger on a PC
+task tb_get_core_instr_req;
+  output bit req;
+  output int addr;
+  req  = x_heep_system_i.core_v_mini_mcu_i.core_instr_cpu_req.req;
+  addr = x_heep_system_i.core_v_mini_mcu_i.core_instr_cpu_req.addr;
+endtask
+
+// Instruction fetch granted in this cycle, for the PC profile of tb_top.cpp
+task tb_get_core_instr_fetch;
+  output bit gnt;
+  output int addr;
+  gnt  = x_heep_system_i.core_v_mini_mcu_i.core_instr_cpu_req.req && x_heep_system_i.core_v_mini_mcu_i.core_instr_cpu_resp.gnt;
+  addr = x_heep_system_i.core_v_mini_mcu_i.core_instr_cpu_req.addr;
+endtask
+
+// Performance counters of the system crossbar, see system_bus.sv
+task tb_getBusSize;
+  output int nmaster;
+  output int nslave;
+  nmaster = $size(x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_master_gnt);
+  nslave  = $size(x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_slave_gnt);
+endtask
+
+// Request at the port of a RAM bank in this cycle, granted in the same cycle, for the heatmap of tb_top.cpp
+task tb_getBankPort;
+  input int bank;
+  output bit req;
+  output bit we;
+  output int addr;
+  req  = x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_i.ram_req_i[bank].req;
+  we   = x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_i.ram_req_i[bank].we;
+  addr = x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_i.ram_req_i[bank].addr;
+endtask
+
+task tb_getMasterCounters;
+  input int idx;
+  output longint req_cycles;
+  output longint gnt;
+  output longint rvalid;
+  req_cycles = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_master_req_cycles[idx];
+  gnt        = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_master_gnt[idx];
+  rvalid     = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_master_rvalid[idx];
+endtask
+
+task tb_getSlaveCounters;
+  input int idx;
+  output longint gnt;
+  gnt = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_slave_gnt[idx];
+endtask
+
+// Counters of bus_perf_counters, cleared and frozen by the software through
+// the PERF_CTRL register of soc_ctrl
+task tb_getBankConflicts;
+  input int bank;
+  output int conflicts;
+  conflicts = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.bus_perf_counters_i.bank_conflicts_q[bank];
+endtask
+
+task tb_getGlobalCounters;
+  output int dma_busy;
+  output int core_stall;
+  dma_busy   = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.bus_perf_counters_i.global_q[1];
+  core_stall = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.bus_perf_counters_i.global_q[2];
+endtask
+
+// mcycle and minstret CSRs of the core
+task tb_getCoreCounters;
+  output longint mcycle;
+  output longint minstret;
+% if cpu_type == "cv32e20":
+  mcycle   = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e20.cv32e20_i.u_cve2_core.cs_registers_i.mcycle_counter_i.counter_val_o;
+  minstret = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e20.cv32e20_i.u_cve2_core.cs_registers_i.minstret_counter_i.counter_val_o;
+% elif cpu_type == "cv32e40x":
+  mcycle   = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40x.cv32e40x_core_i.cs_registers_i.mhpmcounter_q[0];
+  minstret = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40x.cv32e40x_core_i.cs_registers_i.mhpmcounter_q[2];
+% elif cpu_type == "cv32e40px":
+  mcycle   = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40px.cv32e40px_top_i.core_i.cs_registers_i.mhpmcounter_q[0];
+  minstret = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40px.cv32e40px_top_i.core_i.cs_registers_i.mhpmcounter_q[2];
+% else:
+  mcycle   = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40p.cv32e40p_top_i.core_i.cs_registers_i.mhpmcounter_q[0];
+  minstret = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40p.cv32e40p_top_i.core_i.cs_registers_i.mhpmcounter_q[2];
+% endif
+endtask
+
+// Instruction retired in this cycle and its PC, for the PC sampling profiler of tb_top.cpp
+task tb_get_core_retire;
+  output bit valid;
+  output int pc;
+% if cpu_type == "cv32e20":
+  valid = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e20.cv32e20_i.u_cve2_core.instr_id_done;
+  pc    = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e20.cv32e20_i.u_cve2_core.pc_id;
+% elif cpu_type == "cv32e40x":
+  valid = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40x.cv32e40x_core_i.wb_valid;
+  pc    = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40x.cv32e40x_core_i.ex_wb_pipe.pc;
+% elif cpu_type == "cv32e40px":
+  valid = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40px.cv32e40px_top_i.core_i.id_valid &&
+          x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40px.cv32e40px_top_i.core_i.is_decoding;
+  pc    = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40px.cv32e40px_top_i.core_i.pc_id;
+% else:
+  valid = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40p.cv32e40p_top_i.core_i.id_valid &&
+          x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40p.cv32e40p_top_i.core_i.is_decoding;
+  pc    = x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_i.gen_cv32e40p.cv32e40p_top_i.core_i.pc_id;
+% endif
+endtask
+
+// Interrupt lines of the core, for the event trace of tb_top.cpp
+task tb_get_core_irq;
+  output int irq;
+  irq = x_heep_system_i.core_v_mini_mcu_i.intr;
+endtask
+
+// Fast-forward of the sleep periods: the testbench checks that the core sleeps and the bus is idle,
+// then advances the always-on rv_timer (harts 0 and 1) up to its next compare, see tb_top.cpp
+task tb_getSleepState;
+  output bit sleep;
+  output longint idle_cycles;
+  output bit periph_timer_active;
+  sleep       = x_heep_system_i.core_v_mini_mcu_i.core_sleep;
+  idle_cycles = x_heep_system_i.core_v_mini_mcu_i.system_bus_i.perf_idle_cycles;
+% if peripherals["rv_timer"]["is_included"] == "yes":
+  // the peripheral domain timer is clock gated with the peripheral subsystem, it is not fast-forwarded
+`ifdef XHEEP_VERILATOR_HIER
+  // peripheral_subsystem is a hierarchical block, its timer cannot be read: never fast-forward
+  periph_timer_active = 1'b1;
+`else
+  periph_timer_active = |x_heep_system_i.core_v_mini_mcu_i.peripheral_subsystem_i.rv_timer_2_3_i.active;
+`endif
+% else:
+  periph_timer_active = 1'b0;
+% endif
+endtask
+
+task tb_getTimer;
+  input int hart;
+  output bit active;
+  output bit intr_en;
+  output int prescaler;
+  output int step;
+  output int tick_count;
+  output longint mtime;
+  output longint mtimecmp;
+  active     = x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.active[hart];
+  intr_en    = x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.intr_timer_en[hart];
+  prescaler  = x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.prescaler[hart];
+  step       = x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.step[hart];
+  mtime      = x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.mtime[hart];
+  mtimecmp   = x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.mtimecmp[hart][0];
+  tick_count = hart == 0 ? x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.gen_harts[0].u_core.tick_count : x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.gen_harts[1].u_core.tick_count;
+endtask
+
+task tb_setTimer;
+  input int hart;
+  input int tick_count;
+  input longint mtime;
+  if (hart == 0) begin
+    x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.gen_harts[0].u_core.tick_count = tick_count[11:0];
+    x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.u_reg.u_timer_v_lower0.q = mtime[31:0];
+    x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.u_reg.u_timer_v_upper0.q = mtime[63:32];
+  end else begin
+    x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.gen_harts[1].u_core.tick_count = tick_count[11:0];
+    x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.u_reg.u_timer_v_lower1.q = mtime[31:0];
+    x_heep_system_i.core_v_mini_mcu_i.ao_peripheral_subsystem_i.rv_timer_0_1_i.u_reg.u_timer_v_upper1.q = mtime[63:32];
+  end
+endtask
+
+// External slave region, split between the SystemC memory ports by tb_sc_top.cpp to preload an ELF
+task tb_getExtSlaveRegion;
+  output int start_address;
+  output int size;
+  start_address = core_v_mini_mcu_pkg::EXT_SLAVE_START_ADDRESS;
+  size          = core_v_mini_mcu_pkg::EXT_SLAVE_SIZE;
+endtask
+
+// Power state of the domains, sampled by the power profiler of the C++ testbenches, see XHEEP_PowerProfiler.hh.
+// The masks have one bit per RAM bank or external domain, set when it is off, retentive or clock gated.
+task tb_getPowerDomains;
+  output int nbanks;
+  output int nexternal;
+  nbanks    = core_v_mini_mcu_pkg::NUM_BANKS;
+  nexternal = core_v_mini_mcu_pkg::EXTERNAL_DOMAINS;
+endtask
+
+task tb_getPowerState;
+  output bit cpu_off;
+  output bit cpu_sleep;
+  output bit periph_off;
+  output bit periph_clkgate;
+  output int banks_off;
+  output int banks_retentive;
+  output int banks_clkgate;
+  output int ext_off;
+  output int ext_retentive;
+  output int ext_clkgate;
+  cpu_off         = ~x_heep_system_i.core_v_mini_mcu_i.cpu_subsystem_powergate_switch_no;
+  cpu_sleep       = x_heep_system_i.core_v_mini_mcu_i.core_sleep;
+  periph_off      = ~x_heep_system_i.core_v_mini_mcu_i.peripheral_subsystem_powergate_switch_no;
+  periph_clkgate  = ~x_heep_system_i.core_v_mini_mcu_i.peripheral_subsystem_clkgate_en_n;
+  banks_off       = '0;
+  banks_retentive = '0;
+  banks_clkgate   = '0;
+  banks_off[core_v_mini_mcu_pkg::NUM_BANKS-1:0]       = ~x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_banks_powergate_switch_no;
+  banks_retentive[core_v_mini_mcu_pkg::NUM_BANKS-1:0] = ~x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_banks_set_retentive_n;
+  banks_clkgate[core_v_mini_mcu_pkg::NUM_BANKS-1:0]   = ~x_heep_system_i.core_v_mini_mcu_i.memory_subsystem_clkgate_en_n;
+  ext_off         = '0;
+  ext_retentive   = '0;
+  ext_clkgate     = '0;
+  ext_off[EXT_DOMAINS_RND-1:0]       = ~external_subsystem_powergate_switch_n;
+  ext_retentive[EXT_DOMAINS_RND-1:0] = ~external_ram_banks_set_retentive_n;
+  ext_clkgate[EXT_DOMAINS_RND-1:0]   = ~external_subsystem_clkgate_en_n;
+endtask
 `endif
@@ -31,6 +31,16 @@ module testharness #(
     input  logic        ext_systemc_resp_gnt_i,
     input  logic        ext_systemc_resp_rvalid_i,
     input  logic [31:0] ext_systemc_resp_rdata_i,
+
+    output logic        ext_systemc1_req_req_o,
+    output logic        ext_systemc1_req_we_o,
+    output logic [ 3:0] ext_systemc1_req_be_o,
+    output logic [31:0] ext_systemc1_req_addr_o,
+    output logic [31:0] ext_systemc1_req_wdata_o,
+
+    input  logic        ext_systemc1_resp_gnt_i,
+    input  logic        ext_systemc1_resp_rvalid_i,
+    input  logic [31:0] ext_systemc1_resp_rdata_i,
 `endif
     input  wire         jtag_tck_i,
     input  wire         jtag_tms_i,
@@ -88,6 +98,8 @@ module testharness #(
   logic iffifo_in_ready, iffifo_out_valid;
   logic iffifo_int_o;
 
+  logic fft_fir_in_ready, fft_fir_out_valid;
+
   // External xbar master/slave and peripheral ports
   obi_req_t [EXT_XBAR_NMASTER_RND-1:0] ext_master_req;
   obi_req_t [EXT_XBAR_NMASTER_RND-1:0] heep_slave_req;
@@ -116,6 +128,10 @@ module testharness #(
   // External interrupts
   logic [NEXT_INT_RND-1:0] intr_vector_ext;
   logic memcopy_intr;
+  logic irq_trigger_intr;
+  logic simple_acc_intr;
+  logic irq_trigger_gpio;
+  logic irq_trigger_gpio_oe;
 
   // External subsystems
   logic [EXT_DOMAINS_RND-1:0] external_subsystem_powergate_switch_n;
@@ -143,6 +159,8 @@ module testharness #(
     // Re-assign the interrupt lines used here
     intr_vector_ext[0] = memcopy_intr;
     intr_vector_ext[1] = iffifo_int_o;
+    intr_vector_ext[2] = irq_trigger_intr;
+    intr_vector_ext[3] = simple_acc_intr;
   end
 
   //log parameters
@@ -262,7 +280,9 @@ module testharness #(
       .external_ram_banks_set_retentive_no(external_ram_banks_set_retentive_n),
       .external_subsystem_clkgate_en_no(external_subsystem_clkgate_en_n),
       .ext_dma_slot_tx_i(iffifo_in_ready),
-      .ext_dma_slot_rx_i(iffifo_out_valid)
+      .ext_dma_slot_rx_i(iffifo_out_valid),
+      .ext_dma_slot_acc_tx_i(fft_fir_in_ready),
+      .ext_dma_slot_acc_rx_i(fft_fir_out_valid)
   );
 
   // Testbench external bus
@@ -297,6 +317,17 @@ module testharness #(
       .ext_slave_resp_i         (ext_slave_resp)
   );
 
+  // Trace of the transactions of the system crossbar with +bus_trace=<file>
+  bus_trace #(
+      .NMASTER(core_v_mini_mcu_pkg::SYSTEM_XBAR_NMASTER + HEEP_EXT_XBAR_NMASTER),
+      .SYSTEM_NMASTER(core_v_mini_mcu_pkg::SYSTEM_XBAR_NMASTER)
+  ) bus_trace_i (
+      .clk_i,
+      .rst_ni,
+      .master_req_i (x_heep_system_i.core_v_mini_mcu_i.system_bus_i.master_req),
+      .master_resp_i(x_heep_system_i.core_v_mini_mcu_i.system_bus_i.master_resp)
+  );
+
   logic pdm;
 
   //pretending to be SWITCH CELLs that delay by SWITCH_ACK_LATENCY cycles the ACK signal
@@ -406,6 +437,23 @@ module testharness #(
 
   assign ext_systemc_req                 = ext_slave_req[SLOW_MEMORY_IDX];
   assign ext_slave_resp[SLOW_MEMORY_IDX] = ext_systemc_resp;
+
+  // Second SystemC memory port
+  obi_req_t  ext_systemc1_req;
+  obi_resp_t ext_systemc1_resp;
+
+  assign ext_systemc1_req_req_o              = ext_systemc1_req.req;
+  assign ext_systemc1_req_we_o               = ext_systemc1_req.we;
+  assign ext_systemc1_req_be_o               = ext_systemc1_req.be;
+  assign ext_systemc1_req_addr_o             = ext_systemc1_req.addr;
+  assign ext_systemc1_req_wdata_o            = ext_systemc1_req.wdata;
+
+  assign ext_systemc1_resp.gnt               = ext_systemc1_resp_gnt_i;
+  assign ext_systemc1_resp.rvalid            = ext_systemc1_resp_rvalid_i;
+  assign ext_systemc1_resp.rdata             = ext_systemc1_resp_rdata_i;
+
+  assign ext_systemc1_req                    = ext_slave_req[SYSTEMC_MEMORY1_IDX];
+  assign ext_slave_resp[SYSTEMC_MEMORY1_IDX] = ext_systemc1_resp;
 `endif
 
   generate
@@ -464,12 +512,18 @@ module testharness #(
           .dma_write_ch0_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER1_IDX]),
           .dma_addr_ch0_req_o(),
           .dma_addr_ch0_resp_i('0),
+          .dma_wide_read_req_o(),
+          .dma_wide_read_resp_i('0),
+          .dma_wide_write_req_o(),
+          .dma_wide_write_resp_i('0),
           .trigger_slot_i('0),
           .dma_done_intr_o(memcopy_intr),
-          .dma_window_intr_o()
+          .dma_window_intr_o(),
+          .dma_busy_o()
       );
 
-      simple_accelerator #(
+      // Simple accelerator behind the standard command queue, see hw/ip/acc_cmdq
+      simple_accelerator_cmdq #(
           .reg_req_t (reg_pkg::reg_req_t),
           .reg_rsp_t (reg_pkg::reg_rsp_t),
           .obi_req_t (obi_pkg::obi_req_t),
@@ -482,7 +536,8 @@ module testharness #(
           .acc_read_ch0_req_o(ext_master_req[testharness_pkg::EXT_MASTER2_IDX]),
           .acc_read_ch0_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER2_IDX]),
           .acc_write_ch0_req_o(ext_master_req[testharness_pkg::EXT_MASTER3_IDX]),
-          .acc_write_ch0_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER3_IDX])
+          .acc_write_ch0_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER3_IDX]),
+          .intr_o(simple_acc_intr)
       );
 
       // AMS external peripheral
@@ -512,6 +567,99 @@ module testharness #(
           .iffifo_int_o(iffifo_int_o)
       );
 
+      // Streaming FFT and FIR accelerator of the audio path
+      fft_fir #(
+          .reg_req_t(reg_pkg::reg_req_t),
+          .reg_rsp_t(reg_pkg::reg_rsp_t)
+      ) fft_fir_i (
+          .clk_i,
+          .rst_ni,
+          .reg_req_i(ext_periph_slv_req[testharness_pkg::FFT_FIR_IDX]),
+          .reg_rsp_o(ext_periph_slv_rsp[testharness_pkg::FFT_FIR_IDX]),
+          // DMA slots
+          .fft_fir_in_ready_o(fft_fir_in_ready),
+          .fft_fir_out_valid_o(fft_fir_out_valid)
+      );
+
+      // Simulation-only console external peripheral
+      sim_console #(
+          .reg_req_t(reg_pkg::reg_req_t),
+          .reg_rsp_t(reg_pkg::reg_rsp_t)
+      ) sim_console_i (
+          .clk_i,
+          .rst_ni,
+          .reg_req_i(ext_periph_slv_req[testharness_pkg::SIM_CONSOLE_IDX]),
+          .reg_rsp_o(ext_periph_slv_rsp[testharness_pkg::SIM_CONSOLE_IDX])
+      );
+
+      // Interrupt trigger for the latency measurements, on an external interrupt line and GPIO 1
+      irq_trigger #(
+          .reg_req_t(reg_pkg::reg_req_t),
+          .reg_rsp_t(reg_pkg::reg_rsp_t)
+      ) irq_trigger_i (
+          .clk_i,
+          .rst_ni,
+          .reg_req_i(ext_periph_slv_req[testharness_pkg::IRQ_TRIGGER_IDX]),
+          .reg_rsp_o(ext_periph_slv_rsp[testharness_pkg::IRQ_TRIGGER_IDX]),
+          .intr_o(irq_trigger_intr),
+          .gpio_o(irq_trigger_gpio),
+          .gpio_oe_o(irq_trigger_gpio_oe)
+      );
+
+      assign gpio[1] = irq_trigger_gpio_oe ? irq_trigger_gpio : 1'bz;
+
+      // Bus traffic generators, to measure the contention of external masters for the RAM banks
+      traffic_gen #(
+          .reg_req_t (reg_pkg::reg_req_t),
+          .reg_rsp_t (reg_pkg::reg_rsp_t),
+          .obi_req_t (obi_pkg::obi_req_t),
+          .obi_resp_t(obi_pkg::obi_resp_t)
+      ) traffic_gen0_i (
+          .clk_i,
+          .rst_ni,
+          .reg_req_i(ext_periph_slv_req[testharness_pkg::TRAFFIC_GEN0_IDX]),
+          .reg_rsp_o(ext_periph_slv_rsp[testharness_pkg::TRAFFIC_GEN0_IDX]),
+          .master_req_o(ext_master_req[testharness_pkg::EXT_MASTER4_IDX]),
+          .master_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER4_IDX])
+      );
+
+      traffic_gen #(
+          .reg_req_t (reg_pkg::reg_req_t),
+          .reg_rsp_t (reg_pkg::reg_rsp_t),
+          .obi_req_t (obi_pkg::obi_req_t),
+          .obi_resp_t(obi_pkg::obi_resp_t)
+      ) traffic_gen1_i (
+          .clk_i,
+          .rst_ni,
+          .reg_req_i(ext_periph_slv_req[testharness_pkg::TRAFFIC_GEN1_IDX]),
+          .reg_rsp_o(ext_periph_slv_rsp[testharness_pkg::TRAFFIC_GEN1_IDX]),
+          .master_req_o(ext_master_req[testharness_pkg::EXT_MASTER5_IDX]),
+          .master_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER5_IDX])
+      );
+
+      // SPI slave on the second chip select of the SPI host, an external master giving the host
+      // access to the memory map (an external processor, played here by X-HEEP itself)
+      logic [3:0] spi_slave_sd_out, spi_slave_sd_oe;
+
+      obi_spi_slave #(
+          .obi_req_t (obi_pkg::obi_req_t),
+          .obi_resp_t(obi_pkg::obi_resp_t)
+      ) obi_spi_slave_i (
+          .clk_i,
+          .rst_ni,
+          .spi_sck_i(spi_sck),
+          .spi_csb_i(spi_csb[1]),
+          .spi_sd_i(spi_sd_io),
+          .spi_sd_o(spi_slave_sd_out),
+          .spi_sd_oe_o(spi_slave_sd_oe),
+          .master_req_o(ext_master_req[testharness_pkg::EXT_MASTER6_IDX]),
+          .master_resp_i(ext_master_resp[testharness_pkg::EXT_MASTER6_IDX])
+      );
+
+      for (genvar i = 0; i < 4; i++) begin : gen_spi_slave_sd
+        assign spi_sd_io[i] = spi_slave_sd_oe[i] ? spi_slave_sd_out[i] : 1'bz;
+      end
+
       addr_decode #(
           .NoIndices(testharness_pkg::EXT_NPERIPHERALS),
           .NoRules(testharness_pkg::EXT_NPERIPHERALS),
@@ -576,6 +724,24 @@ module testharness #(
           .io2(spi_flash_sd_io[2]),
           .io3(spi_flash_sd_io[3])
       );
+`else
+      // Flash used for booting, its content in C memory (or in +flash_file) and preloaded by
+      // tb_top.cpp with +flash_image, or with the firmware when +boot_sel=1
+      logic [3:0] flash_boot_sd_out, flash_boot_sd_oe;
+
+      spi_flash_dpi #(
+          .NAME("flash_boot")
+      ) flash_boot_i (
+          .sck_i(spi_flash_sck),
+          .csb_i(spi_flash_csb[0]),
+          .sd_i(spi_flash_sd_io),
+          .sd_o(flash_boot_sd_out),
+          .sd_oe_o(flash_boot_sd_oe)
+      );
+
+      for (genvar i = 0; i < 4; i++) begin : gen_flash_boot_sd
+        assign spi_flash_sd_io[i] = flash_boot_sd_oe[i] ? flash_boot_sd_out[i] : 1'bz;
+      end
 `endif
 
 `ifndef VERILATOR
@@ -590,7 +756,9 @@ module testharness #(
       );
 `endif
 
-      if ((core_v_mini_mcu_pkg::CpuType == cv32e40x || core_v_mini_mcu_pkg::CpuType == cv32e40px) && X_EXT != 0) begin: gen_fpu_ss_wrapper
+      // Coprocessor on the eXtension Interface, chosen by xif_coprocessor in mcu_cfg.hjson
+      if ((core_v_mini_mcu_pkg::CpuType == cv32e40x || core_v_mini_mcu_pkg::CpuType == cv32e40px) && X_EXT != 0 &&
+          core_v_mini_mcu_pkg::XifCoprocessor == core_v_mini_mcu_pkg::XifFpuSs) begin: gen_fpu_ss_wrapper
         fpu_ss_wrapper #(
             .PULP_ZFINX(ZFINX),
             .INPUT_BUFFER_DEPTH(1),
@@ -611,6 +779,31 @@ module testharness #(
             .xif_mem_result_if(ext_if),
             .xif_result_if(ext_if)
         );
+      end else if ((core_v_mini_mcu_pkg::CpuType == cv32e40x || core_v_mini_mcu_pkg::CpuType == cv32e40px) && X_EXT != 0 &&
+          core_v_mini_mcu_pkg::XifCoprocessor == core_v_mini_mcu_pkg::XifMac) begin: gen_xif_mac
+        xif_mac xif_mac_i (
+            // Clock and reset
+            .clk_i,
+            .rst_ni,
+
+            // eXtension Interface
+            .xif_compressed_if(ext_if),
+            .xif_issue_if(ext_if),
+            .xif_commit_if(ext_if),
+            .xif_mem_if(ext_if),
+            .xif_mem_result_if(ext_if),
+            .xif_result_if(ext_if)
+        );
+      end else if ((core_v_mini_mcu_pkg::CpuType == cv32e40x || core_v_mini_mcu_pkg::CpuType == cv32e40px) && X_EXT != 0) begin: gen_no_xif_coprocessor
+        // Every offloaded instruction is refused, and raises an illegal instruction exception
+        assign ext_if.compressed_ready = 1'b1;
+        assign ext_if.compressed_resp = '0;
+        assign ext_if.issue_ready = 1'b1;
+        assign ext_if.issue_resp = '0;
+        assign ext_if.mem_valid = 1'b0;
+        assign ext_if.mem_req = '0;
+        assign ext_if.result_valid = 1'b0;
+        assign ext_if.result = '0;
       end
 
     end else begin : gen_DONT_USE_EXTERNAL_DEVICE_EXAMPLE
@@ -629,6 +822,10 @@ module testharness #(
 
       assign memcopy_intr = '0;
       assign iffifo_int_o = '0;
+      assign fft_fir_in_ready = '0;
+      assign fft_fir_out_valid = '0;
+      assign irq_trigger_intr = '0;
+      assign simple_acc_intr = '0;
       assign periph_slave_rsp = '0;
 
     end
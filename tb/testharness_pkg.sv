@@ -7,14 +7,22 @@ package testharness_pkg;
   import addr_map_rule_pkg::*;
   import core_v_mini_mcu_pkg::*;
 
-  localparam EXT_XBAR_NMASTER = 4;
+  localparam EXT_XBAR_NMASTER = 7;
+`ifdef SIM_SYSTEMC
+  // The SystemC testbench has a second external memory port, see SYSTEMC_MEMORY1
+  localparam EXT_XBAR_NSLAVE = 2;
+`else
   localparam EXT_XBAR_NSLAVE = 1;
+`endif
 
   //master idx
   localparam logic [31:0] EXT_MASTER0_IDX = 0;
   localparam logic [31:0] EXT_MASTER1_IDX = 1;
   localparam logic [31:0] EXT_MASTER2_IDX = 2;
   localparam logic [31:0] EXT_MASTER3_IDX = 3;
+  localparam logic [31:0] EXT_MASTER4_IDX = 4;
+  localparam logic [31:0] EXT_MASTER5_IDX = 5;
+  localparam logic [31:0] EXT_MASTER6_IDX = 6;
 
   //slave mmap and idx
   localparam logic [31:0] SLOW_MEMORY_START_ADDRESS = core_v_mini_mcu_pkg::EXT_SLAVE_START_ADDRESS;
@@ -22,7 +30,20 @@ package testharness_pkg;
   localparam logic [31:0] SLOW_MEMORY_END_ADDRESS = SLOW_MEMORY_START_ADDRESS + SLOW_MEMORY_SIZE;
   localparam logic [31:0] SLOW_MEMORY_IDX = 32'd0;
 
+  // Second SystemC memory port, on the upper half of the external slave region; the rest of the
+  // region goes to the first port (SLOW_MEMORY_IDX, the default slave)
+  localparam logic [31:0] SYSTEMC_MEMORY1_START_ADDRESS = core_v_mini_mcu_pkg::EXT_SLAVE_START_ADDRESS + core_v_mini_mcu_pkg::EXT_SLAVE_SIZE / 2;
+  localparam logic [31:0] SYSTEMC_MEMORY1_END_ADDRESS = core_v_mini_mcu_pkg::EXT_SLAVE_END_ADDRESS;
+  localparam logic [31:0] SYSTEMC_MEMORY1_IDX = 32'd1;
+
   localparam addr_map_rule_t [EXT_XBAR_NSLAVE-1:0] EXT_XBAR_ADDR_RULES = '{
+`ifdef SIM_SYSTEMC
+      '{
+          idx: SYSTEMC_MEMORY1_IDX,
+          start_addr: SYSTEMC_MEMORY1_START_ADDRESS,
+          end_addr: SYSTEMC_MEMORY1_END_ADDRESS
+      },
+`endif
       '{
           idx: SLOW_MEMORY_IDX,
           start_addr: SLOW_MEMORY_START_ADDRESS,
@@ -31,7 +52,7 @@ package testharness_pkg;
   };
 
   //slave encoder
-  localparam EXT_NPERIPHERALS = 4;
+  localparam EXT_NPERIPHERALS = 9;
 
   // Memcopy controller (external peripheral example)
   localparam logic [31:0] MEMCOPY_CTRL_START_ADDRESS = core_v_mini_mcu_pkg::EXT_PERIPHERAL_START_ADDRESS + 32'h0;
@@ -57,6 +78,35 @@ package testharness_pkg;
   localparam logic [31:0] SIMPLE_ACC_END_ADDRESS = SIMPLE_ACC_START_ADDRESS + SIMPLE_ACC_SIZE;
   localparam logic [31:0] SIMPLE_ACC_IDX = 32'd3;
 
+  // Simulation-only console, prints to the host stdout without going through the UART
+  localparam logic [31:0] SIM_CONSOLE_START_ADDRESS = core_v_mini_mcu_pkg::EXT_PERIPHERAL_START_ADDRESS + 32'h04000;
+  localparam logic [31:0] SIM_CONSOLE_SIZE = 32'h10;
+  localparam logic [31:0] SIM_CONSOLE_END_ADDRESS = SIM_CONSOLE_START_ADDRESS + SIM_CONSOLE_SIZE;
+  localparam logic [31:0] SIM_CONSOLE_IDX = 32'd4;
+
+  // Interrupt trigger, raises interrupt lines a programmed number of cycles after a write
+  localparam logic [31:0] IRQ_TRIGGER_START_ADDRESS = core_v_mini_mcu_pkg::EXT_PERIPHERAL_START_ADDRESS + 32'h05000;
+  localparam logic [31:0] IRQ_TRIGGER_SIZE = 32'h10;
+  localparam logic [31:0] IRQ_TRIGGER_END_ADDRESS = IRQ_TRIGGER_START_ADDRESS + IRQ_TRIGGER_SIZE;
+  localparam logic [31:0] IRQ_TRIGGER_IDX = 32'd5;
+
+  // Bus traffic generators, external masters 4 and 5
+  localparam logic [31:0] TRAFFIC_GEN0_START_ADDRESS = core_v_mini_mcu_pkg::EXT_PERIPHERAL_START_ADDRESS + 32'h06000;
+  localparam logic [31:0] TRAFFIC_GEN0_SIZE = 32'h100;
+  localparam logic [31:0] TRAFFIC_GEN0_END_ADDRESS = TRAFFIC_GEN0_START_ADDRESS + TRAFFIC_GEN0_SIZE;
+  localparam logic [31:0] TRAFFIC_GEN0_IDX = 32'd6;
+
+  localparam logic [31:0] TRAFFIC_GEN1_START_ADDRESS = core_v_mini_mcu_pkg::EXT_PERIPHERAL_START_ADDRESS + 32'h07000;
+  localparam logic [31:0] TRAFFIC_GEN1_SIZE = 32'h100;
+  localparam logic [31:0] TRAFFIC_GEN1_END_ADDRESS = TRAFFIC_GEN1_START_ADDRESS + TRAFFIC_GEN1_SIZE;
+  localparam logic [31:0] TRAFFIC_GEN1_IDX = 32'd7;
+
+  // Streaming FFT and FIR accelerator of the audio path
+  localparam logic [31:0] FFT_FIR_START_ADDRESS = core_v_mini_mcu_pkg::EXT_PERIPHERAL_START_ADDRESS + 32'h08000;
+  localparam logic [31:0] FFT_FIR_SIZE = 32'h100;
+  localparam logic [31:0] FFT_FIR_END_ADDRESS = FFT_FIR_START_ADDRESS + FFT_FIR_SIZE;
+  localparam logic [31:0] FFT_FIR_IDX = 32'd8;
+
   localparam addr_map_rule_t [EXT_NPERIPHERALS-1:0] EXT_PERIPHERALS_ADDR_RULES = '{
       '{
           idx: MEMCOPY_CTRL_IDX,
@@ -69,7 +119,28 @@ package testharness_pkg;
           idx: SIMPLE_ACC_IDX,
           start_addr: SIMPLE_ACC_START_ADDRESS,
           end_addr: SIMPLE_ACC_END_ADDRESS
-      }
+      },
+      '{
+          idx: SIM_CONSOLE_IDX,
+          start_addr: SIM_CONSOLE_START_ADDRESS,
+          end_addr: SIM_CONSOLE_END_ADDRESS
+      },
+      '{
+          idx: IRQ_TRIGGER_IDX,
+          start_addr: IRQ_TRIGGER_START_ADDRESS,
+          end_addr: IRQ_TRIGGER_END_ADDRESS
+      },
+      '{
+          idx: TRAFFIC_GEN0_IDX,
+          start_addr: TRAFFIC_GEN0_START_ADDRESS,
+          end_addr: TRAFFIC_GEN0_END_ADDRESS
+      },
+      '{
+          idx: TRAFFIC_GEN1_IDX,
+          start_addr: TRAFFIC_GEN1_START_ADDRESS,
+          end_addr: TRAFFIC_GEN1_END_ADDRESS
+      },
+      '{idx: FFT_FIR_IDX, start_addr: FFT_FIR_START_ADDRESS, end_addr: FFT_FIR_END_ADDRESS}
   };
 
   localparam int unsigned EXT_PERIPHERALS_PORT_SEL_WIDTH = EXT_NPERIPHERALS > 1 ? $clog2(
@@ -0,0 +1,99 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include "systemc"
+using namespace sc_core;
+using namespace sc_dt;
+using namespace std;
+
+#include "tlm.h"
+#include "tlm_utils/multi_passthrough_initiator_socket.h"
+#include "tlm_utils/multi_passthrough_target_socket.h"
+
+#include <vector>
+
+
+// Address decoder of the virtual platform: the initiators (core, DMA) are bound to target_socket,
+// the slaves to initiator_socket in the order of their map() calls. The transactions and the DMI
+// regions are translated to the offsets of the slaves.
+SC_MODULE(Bus)
+{
+  tlm_utils::multi_passthrough_target_socket<Bus>    target_socket;
+  tlm_utils::multi_passthrough_initiator_socket<Bus> initiator_socket;
+
+  struct region_t {
+    sc_dt::uint64 start;
+    sc_dt::uint64 size;
+    unsigned int  port;
+    std::string   name;
+  };
+  std::vector<region_t> regions;
+
+  // accesses outside the map, the first 16 are reported
+  uint64_t decode_errors = 0;
+
+  SC_CTOR(Bus)
+  : target_socket("target_socket"), initiator_socket("initiator_socket")
+  {
+    target_socket.register_b_transport(this, &Bus::b_transport);
+    target_socket.register_get_direct_mem_ptr(this, &Bus::get_direct_mem_ptr);
+    initiator_socket.register_invalidate_direct_mem_ptr(this, &Bus::invalidate_direct_mem_ptr);
+  }
+
+  // Maps the next slave bound to initiator_socket at [start, start + size)
+  void map(const std::string& name, sc_dt::uint64 start, sc_dt::uint64 size) {
+    region_t region = { start, size, (unsigned int)regions.size(), name };
+    regions.push_back(region);
+  }
+
+  const region_t* decode(sc_dt::uint64 address) {
+    for (size_t i = 0; i < regions.size(); i++)
+      if (address >= regions[i].start && address - regions[i].start < regions[i].size)
+        return &regions[i];
+    return NULL;
+  }
+
+  virtual void b_transport( int id, tlm::tlm_generic_payload& trans, sc_time& delay )
+  {
+    sc_dt::uint64 address = trans.get_address();
+    const region_t* region = decode(address);
+    if (region == NULL) {
+      if (decode_errors++ < 16)
+        std::cout<<"[VP]: no slave at 0x"<<std::hex<<address<<std::dec<<std::endl;
+      trans.set_response_status( tlm::TLM_ADDRESS_ERROR_RESPONSE );
+      return;
+    }
+    trans.set_address( address - region->start );
+    initiator_socket[region->port]->b_transport( trans, delay );
+    trans.set_address( address );
+  }
+
+  virtual bool get_direct_mem_ptr( int id, tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data )
+  {
+    sc_dt::uint64 address = trans.get_address();
+    const region_t* region = decode(address);
+    if (region == NULL)
+      return false;
+    trans.set_address( address - region->start );
+    bool granted = initiator_socket[region->port]->get_direct_mem_ptr( trans, dmi_data );
+    trans.set_address( address );
+    if (!granted)
+      return false;
+    dmi_data.set_start_address( dmi_data.get_start_address() + region->start );
+    dmi_data.set_end_address( std::min(dmi_data.get_end_address() + region->start, region->start + region->size - 1) );
+    return true;
+  }
+
+  virtual void invalidate_direct_mem_ptr( int id, sc_dt::uint64 start, sc_dt::uint64 end )
+  {
+    for (size_t i = 0; i < regions.size(); i++) {
+      if (regions[i].port != (unsigned int)id)
+        continue;
+      for (unsigned int t = 0; t < target_socket.size(); t++)
+        target_socket[t]->invalidate_direct_mem_ptr( start + regions[i].start, end + regions[i].start );
+    }
+  }
+
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef CORE_H
+#define CORE_H
+
+#include "systemc"
+using namespace sc_core;
+using namespace sc_dt;
+using namespace std;
+
+#include "tlm.h"
+#include "tlm_utils/simple_initiator_socket.h"
+#include "tlm_utils/tlm_quantumkeeper.h"
+
+#include "Iss.h"
+
+
+// Loosely-timed initiator of the core: the ISS runs ahead of the simulation time by up to the
+// global quantum, one cycle of clk_period per instruction, and reads the RAM through its DMI
+// pointer. The other accesses are b_transport calls annotated with the local time of the core.
+// The interrupt lines are sampled when the core synchronises, at least once per quantum.
+SC_MODULE(Core)
+{
+  tlm_utils::simple_initiator_socket<Core> socket;
+
+  Iss*    iss;
+  sc_time clk_period;
+  sc_dt::uint64 ram_base;
+
+  // stops the simulation once reached, 0 for no limit
+  uint64_t max_cycles = 0;
+
+  // the program wrote its exit or the marker of the switch to the RTL, the simulation stops at
+  // the next synchronisation
+  bool halted = false;
+
+  sc_event irq_event;
+
+  SC_HAS_PROCESS(Core);
+
+  Core(sc_module_name name, sc_time clk_period, sc_dt::uint64 ram_base)
+  : sc_module(name), socket("socket"), clk_period(clk_period), ram_base(ram_base)
+  {
+    iss = new Iss([this](uint32_t addr, uint32_t& data, unsigned int size, bool write) {
+      return this->mmio(addr, data, size, write);
+    });
+    socket.register_invalidate_direct_mem_ptr(this, &Core::invalidate_direct_mem_ptr);
+    SC_THREAD(run);
+  }
+
+  ~Core() {
+    delete iss;
+  }
+
+  // Level of the interrupt line of mip
+  void set_line(unsigned int bit, bool level) {
+    uint32_t lines = level ? iss->irq_lines | (1u << bit) : iss->irq_lines & ~(1u << bit);
+    set_lines(lines);
+  }
+
+  // Fast interrupts 16 to 30 of mip, from the fast interrupt controller
+  void set_fast(uint32_t lines) {
+    set_lines((iss->irq_lines & 0xFFFF) | (lines & 0x7FFF) << 16);
+  }
+
+  // Stops the simulation after the current instruction
+  void halt() {
+    halted    = true;
+    iss->stop = true;
+  }
+
+private:
+  tlm_utils::tlm_quantumkeeper qk;
+  // cycles of the ISS already added to the local time
+  uint64_t accounted = 0;
+
+  void set_lines(uint32_t lines) {
+    if (lines == iss->irq_lines)
+      return;
+    iss->irq_lines = lines;
+    iss->update_irq();
+    irq_event.notify();
+  }
+
+  void account() {
+    qk.inc( clk_period * (double)(iss->elapsed - accounted) );
+    accounted = iss->elapsed;
+  }
+
+  void map_ram() {
+    tlm::tlm_generic_payload trans;
+    tlm::tlm_dmi dmi;
+    trans.set_address( ram_base );
+    if (!socket->get_direct_mem_ptr( trans, dmi ) || !dmi.is_read_write_allowed()) {
+      SC_REPORT_WARNING("VP", "the RAM does not grant DMI, the core only issues b_transport calls");
+      iss->set_ram( NULL, 0, 0 );
+      return;
+    }
+    iss->set_ram( dmi.get_dmi_ptr(), (uint32_t)dmi.get_start_address(),
+                  (uint32_t)(dmi.get_end_address() - dmi.get_start_address() + 1) );
+  }
+
+  void invalidate_direct_mem_ptr( sc_dt::uint64 start, sc_dt::uint64 end ) {
+    iss->set_ram( NULL, 0, 0 );
+  }
+
+  bool mmio(uint32_t addr, uint32_t& data, unsigned int size, bool write) {
+    account();
+    // the target only writes the bytes read, the ISS extends them
+    if (!write)
+      data = 0;
+    sc_time delay = qk.get_local_time();
+    tlm::tlm_generic_payload trans;
+    trans.set_command( write ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND );
+    trans.set_address( addr );
+    trans.set_data_ptr( reinterpret_cast<unsigned char*>(&data) );
+    trans.set_data_length( size );
+    trans.set_streaming_width( size );
+    trans.set_byte_enable_ptr( 0 );
+    trans.set_dmi_allowed( false );
+    trans.set_response_status( tlm::TLM_INCOMPLETE_RESPONSE );
+    socket->b_transport( trans, delay );
+    qk.set( delay );
+    return trans.is_response_ok();
+  }
+
+  void run() {
+    map_ram();
+    qk.reset();
+    while (true) {
+      if (halted || (max_cycles != 0 && iss->elapsed >= max_cycles)) {
+        qk.sync();
+        sc_stop();
+        return;
+      }
+      if (iss->wfi) {
+        qk.sync();
+        // the core sleeps until an enabled interrupt is pending, its counters do not count
+        while (iss->wfi)
+          wait( irq_event );
+        qk.reset();
+        continue;
+      }
+      sc_time quantum = tlm::tlm_global_quantum::instance().get();
+      sc_time local   = qk.get_local_time();
+      uint64_t budget = local < quantum ? (uint64_t)((quantum - local) / clk_period) : 0;
+      if (budget == 0)
+        budget = 1;
+      if (max_cycles != 0)
+        budget = std::min(budget, max_cycles - iss->elapsed);
+      iss->run( budget );
+      account();
+      if (qk.need_sync())
+        qk.sync();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef DMA_H
+#define DMA_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "dma/dma_regs.h"
+
+#include "tlm_utils/simple_initiator_socket.h"
+
+
+// Channel of the DMA: the transaction started by writing SIZE_D1 is copied at once through
+// initiator_socket, in the order of the RTL (1D, 2D, transposed 2D with DIM_INV, address mode, sign
+// extension), and the channel is busy for one cycle per data unit. Its end is seen by a read of
+// STATUS or by the done interrupt, a pulse of the first bit of irq_out, and restarts the
+// transaction in circular mode. The padding, the trigger slots and the windows are not modelled.
+struct DmaChannel : RegTarget
+{
+  tlm_utils::simple_initiator_socket<DmaChannel> initiator_socket;
+
+  sc_time clk_period;
+
+  bool     running = false;
+  sc_time  done_time;
+  sc_event done_event;
+
+  uint64_t transactions = 0;
+  uint64_t units        = 0;
+
+  SC_HAS_PROCESS(DmaChannel);
+
+  DmaChannel(sc_module_name name, sc_time clk_period)
+  : RegTarget(name, VP_DMA_REGS, VP_DMA_NREGS), initiator_socket("initiator_socket"), clk_period(clk_period)
+  {
+    SC_METHOD(done);
+    sensitive << done_event;
+    dont_initialize();
+  }
+
+  bool access(uint32_t addr, uint32_t& data, unsigned int size, bool write, sc_time& delay) {
+    tlm::tlm_generic_payload trans;
+    trans.set_command( write ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND );
+    trans.set_address( addr );
+    trans.set_data_ptr( reinterpret_cast<unsigned char*>(&data) );
+    trans.set_data_length( size );
+    trans.set_streaming_width( size );
+    trans.set_byte_enable_ptr( 0 );
+    trans.set_dmi_allowed( false );
+    trans.set_response_status( tlm::TLM_INCOMPLETE_RESPONSE );
+    initiator_socket->b_transport( trans, delay );
+    return trans.is_response_ok();
+  }
+
+  static unsigned int unit_size(uint32_t data_type) {
+    return data_type == 0 ? 4 : data_type == 1 ? 2 : 1;
+  }
+
+  void start(const sc_time& t) {
+    uint32_t src      = reg(DMA_SRC_PTR_REG_OFFSET);
+    uint32_t dst      = reg(DMA_DST_PTR_REG_OFFSET);
+    uint32_t addr_ptr = reg(DMA_ADDR_PTR_REG_OFFSET);
+    uint32_t src_inc1 = reg(DMA_SRC_PTR_INC_D1_REG_OFFSET);
+    uint32_t src_inc2 = reg(DMA_SRC_PTR_INC_D2_REG_OFFSET);
+    uint32_t dst_inc1 = reg(DMA_DST_PTR_INC_D1_REG_OFFSET);
+    uint32_t dst_inc2 = reg(DMA_DST_PTR_INC_D2_REG_OFFSET);
+    unsigned int src_du = unit_size(reg(DMA_SRC_DATA_TYPE_REG_OFFSET));
+    unsigned int dst_du = unit_size(reg(DMA_DST_DATA_TYPE_REG_OFFSET));
+    bool two_d   = reg(DMA_DIM_CONFIG_REG_OFFSET) & 1;
+    bool inv     = two_d && (reg(DMA_DIM_INV_REG_OFFSET) & 1);
+    bool by_addr = reg(DMA_MODE_REG_OFFSET) == 2;
+    bool sign    = (reg(DMA_SIGN_EXT_REG_OFFSET) & 1) && src_du < dst_du;
+
+    // the sizes are counted in data units of the destination
+    uint32_t cols = reg(DMA_SIZE_D1_REG_OFFSET) / dst_du;
+    uint32_t rows = two_d ? reg(DMA_SIZE_D2_REG_OFFSET) / dst_du : 1;
+
+    sc_time delay = SC_ZERO_TIME;
+    uint32_t row_start = src;
+    for (uint32_t r = 0; r < rows; r++) {
+      for (uint32_t c = 0; c < cols; c++) {
+        uint32_t data = 0;
+        if (!access(src, data, src_du, false, delay))
+          std::cout<<"[VP]: "<<name()<<": read error at 0x"<<std::hex<<src<<std::dec<<std::endl;
+        if (sign)
+          data = src_du == 1 ? (uint32_t)(int32_t)(int8_t)data : (uint32_t)(int32_t)(int16_t)data;
+        uint32_t target = dst;
+        if (by_addr) {
+          access(addr_ptr, target, 4, false, delay);
+          addr_ptr += 4;
+        }
+        if (!access(target, data, dst_du, true, delay))
+          std::cout<<"[VP]: "<<name()<<": write error at 0x"<<std::hex<<target<<std::dec<<std::endl;
+
+        bool last = c == cols - 1 && r != rows - 1;
+        if (inv) {
+          // transposed: the rows of the source are read along d2, then the next column
+          if (last) {
+            row_start += src_inc1;
+            src = row_start;
+          } else {
+            src += src_inc2;
+          }
+        } else {
+          src += last ? src_inc2 : src_inc1;
+        }
+        dst += last ? dst_inc2 : dst_inc1;
+      }
+    }
+
+    uint64_t n = (uint64_t)rows * cols;
+    transactions++;
+    units += n;
+    running   = true;
+    done_time = t + clk_period * (double)(n + 1);
+    reg(DMA_STATUS_REG_OFFSET) &= ~1u;
+    done_event.notify(done_time > sc_time_stamp() ? done_time - sc_time_stamp() : SC_ZERO_TIME);
+  }
+
+  void finish() {
+    if (!running)
+      return;
+    running = false;
+    done_event.cancel();
+    reg(DMA_STATUS_REG_OFFSET) |= 1;
+    if (reg(DMA_INTERRUPT_EN_REG_OFFSET) & 1) {
+      set_irq(1);
+      set_irq(0);
+    }
+    if (reg(DMA_MODE_REG_OFFSET) == 1)
+      start(done_time);
+  }
+
+  void done() {
+    finish();
+  }
+
+  virtual uint32_t read_hook(uint32_t offset, uint32_t value) {
+    if (offset == DMA_STATUS_REG_OFFSET && running && access_time() >= done_time) {
+      finish();
+      return reg(offset);
+    }
+    return value;
+  }
+
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {
+    if (offset == DMA_SIZE_D1_REG_OFFSET && reg(offset) != 0 && !running)
+      start(access_time());
+  }
+
+  // the RTL gets the configuration of the channel, a write of SIZE_D1 would start a transaction
+  virtual void state(std::vector<std::pair<uint32_t, uint32_t> >& writes) {
+    if (running)
+      std::cout<<"[VP]: WARNING: "<<name()<<": the transaction in progress is not given to the RTL"<<std::endl;
+    std::vector<std::pair<uint32_t, uint32_t> > all;
+    RegTarget::state(all);
+    for (size_t i = 0; i < all.size(); i++)
+      if (all[i].first != DMA_SIZE_D1_REG_OFFSET)
+        writes.push_back(all[i]);
+  }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef FAST_INTR_CTRL_H
+#define FAST_INTR_CTRL_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "fast_intr_ctrl/fast_intr_ctrl_regs.h"
+
+
+// Fast interrupt controller: as in the RTL, an input that is high sets its pending bit to its
+// enable bit, and writing 1 to FAST_INTR_CLEAR clears it. The pending bits are the fast
+// interrupts of the core.
+struct FastIntrCtrl : RegTarget
+{
+  uint32_t inputs = 0;
+
+  FastIntrCtrl(sc_module_name name)
+  : RegTarget(name, VP_FAST_INTR_CTRL_REGS, VP_FAST_INTR_CTRL_NREGS)
+  {}
+
+  void update() {
+    uint32_t& pending = reg(FAST_INTR_CTRL_FAST_INTR_PENDING_REG_OFFSET);
+    uint32_t  enable  = reg(FAST_INTR_CTRL_FAST_INTR_ENABLE_REG_OFFSET);
+    pending = (pending & ~inputs) | (enable & inputs);
+    set_irq(pending);
+  }
+
+  // Level of an input, a pulse of the RTL is a set followed by a clear
+  void set_input(unsigned int index, bool level) {
+    inputs = level ? inputs | (1u << index) : inputs & ~(1u << index);
+    update();
+  }
+
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {
+    if (offset == FAST_INTR_CTRL_FAST_INTR_CLEAR_REG_OFFSET) {
+      reg(FAST_INTR_CTRL_FAST_INTR_PENDING_REG_OFFSET) &= ~written;
+      reg(offset) = 0;
+    }
+    update();
+  }
+};
+
+#endif
@@ -0,0 +1,582 @@
+#ifndef ISS_H
+#define ISS_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <iostream>
+
+
+// Instruction set simulator of the RV32IMC + Zicsr subset shared by the cv32e* cores, with their
+// machine mode interrupts (the fast interrupts 16 to 30 on top of the standard ones).
+// Every instruction and every trap takes one cycle.
+// The memory mapped as `ram` is accessed directly, every other access goes through `mmio`.
+class Iss
+{
+public:
+  // access of `size` bytes outside the RAM, returns false for an access fault
+  typedef std::function<bool(uint32_t addr, uint32_t& data, unsigned int size, bool write)> mmio_t;
+
+  enum {
+    CAUSE_FETCH_FAULT   = 1,
+    CAUSE_ILLEGAL       = 2,
+    CAUSE_BREAKPOINT    = 3,
+    CAUSE_LOAD_FAULT    = 5,
+    CAUSE_STORE_FAULT   = 7,
+    CAUSE_ECALL_M       = 11,
+
+    IRQ_MSI             = 3,
+    IRQ_MTI             = 7,
+    IRQ_MEI             = 11,
+
+    MSTATUS_MIE         = 1 << 3,
+    MSTATUS_MPIE        = 1 << 7,
+    MSTATUS_MPP         = 3 << 11,
+
+    // software interrupt, timer, external and the 15 fast interrupts
+    MIE_MASK            = 0x7FFF0888
+  };
+
+  uint32_t x[32];
+  uint32_t pc;
+
+  uint32_t mstatus, mie, mtvec, mscratch, mepc, mcause, mtval, mcountinhibit;
+  uint64_t cycle, instret;
+  // cycles run since the reset, unlike mcycle it cannot be written by the software
+  uint64_t elapsed;
+
+  // interrupt lines of the platform, the read-only bits of mip
+  uint32_t irq_lines;
+
+  // the core waits for an interrupt, run returns until one is pending
+  bool wfi;
+  // set by mmio to leave run after the current instruction, e.g. at the exit of the program
+  bool stop;
+  uint64_t traps;
+
+  Iss(mmio_t mmio)
+  : mmio(mmio), ram(NULL), ram_base(0), ram_size(0)
+  {
+    reset(0);
+  }
+
+  void set_ram(uint8_t* ptr, uint32_t base, uint32_t size) {
+    ram      = ptr;
+    ram_base = base;
+    ram_size = size;
+  }
+
+  void reset(uint32_t boot_address) {
+    memset(x, 0, sizeof(x));
+    pc            = boot_address;
+    mstatus       = MSTATUS_MPP;
+    mie           = 0;
+    mtvec         = 0;
+    mscratch      = 0;
+    mepc          = 0;
+    mcause        = 0;
+    mtval         = 0;
+    mcountinhibit = 0;
+    cycle         = 0;
+    instret       = 0;
+    elapsed       = 0;
+    irq_lines     = 0;
+    wfi           = false;
+    stop          = false;
+    traps         = 0;
+    irq_dirty     = true;
+  }
+
+  // To be called when irq_lines change
+  void update_irq() {
+    irq_dirty = true;
+    if (irq_lines & mie)
+      wfi = false;
+  }
+
+  // Runs up to n cycles, less when the core waits for an interrupt or mmio stops it.
+  // Returns the number of cycles run, a trap takes one cycle.
+  uint64_t run(uint64_t n) {
+    uint64_t i;
+    stop = false;
+    for (i = 0; i < n && !wfi && !stop; i++) {
+      if (irq_dirty)
+        take_irq();
+      step();
+      cycle++;
+      elapsed++;
+    }
+    return i;
+  }
+
+private:
+  mmio_t   mmio;
+  uint8_t* ram;
+  uint32_t ram_base;
+  uint32_t ram_size;
+  bool     irq_dirty;
+  std::set<uint32_t> warned_csrs;
+
+  // Highest priority interrupt, as the cv32e* cores: fast 30 to 16, then external, software
+  // and timer
+  void take_irq() {
+    irq_dirty = false;
+    uint32_t pending = irq_lines & mie;
+    if (!pending || !(mstatus & MSTATUS_MIE))
+      return;
+    unsigned int id;
+    if (pending & 0xFFFF0000)
+      id = 31 - __builtin_clz(pending & 0xFFFF0000);
+    else if (pending & (1u << IRQ_MEI))
+      id = IRQ_MEI;
+    else if (pending & (1u << IRQ_MSI))
+      id = IRQ_MSI;
+    else
+      id = IRQ_MTI;
+    trap(0x80000000u | id, 0, pc);
+  }
+
+  void trap(uint32_t cause, uint32_t tval, uint32_t epc) {
+    traps++;
+    mepc    = epc;
+    mcause  = cause;
+    mtval   = tval;
+    mstatus = (mstatus & MSTATUS_MIE ? mstatus | MSTATUS_MPIE : mstatus & ~MSTATUS_MPIE) & ~MSTATUS_MIE;
+    mstatus |= MSTATUS_MPP;
+    // vectored mode only for the interrupts
+    if ((mtvec & 1) && (cause & 0x80000000u))
+      pc = (mtvec & ~3u) + 4 * (cause & 0x1F);
+    else
+      pc = mtvec & ~3u;
+  }
+
+  template <typename T>
+  bool load(uint32_t addr, T& value) {
+    uint32_t offset = addr - ram_base;
+    if (offset < ram_size && ram_size - offset >= sizeof(T)) {
+      memcpy(&value, ram + offset, sizeof(T));
+      return true;
+    }
+    uint32_t data;
+    bool ok = mmio(addr, data, sizeof(T), false);
+    irq_dirty = true;
+    value = (T)data;
+    return ok;
+  }
+
+  template <typename T>
+  bool store(uint32_t addr, T value) {
+    uint32_t offset = addr - ram_base;
+    if (offset < ram_size && ram_size - offset >= sizeof(T)) {
+      memcpy(ram + offset, &value, sizeof(T));
+      return true;
+    }
+    uint32_t data = (uint32_t)value;
+    bool ok = mmio(addr, data, sizeof(T), true);
+    irq_dirty = true;
+    return ok;
+  }
+
+  bool fetch(uint32_t addr, uint32_t& insn) {
+    uint32_t offset = addr - ram_base;
+    if (offset < ram_size && ram_size - offset >= 2) {
+      uint16_t low;
+      memcpy(&low, ram + offset, 2);
+      if ((low & 3) != 3) {
+        insn = low;
+        return true;
+      }
+      if (ram_size - offset >= 4) {
+        memcpy(&insn, ram + offset, 4);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool read_csr(uint32_t csr, uint32_t& value) {
+    switch (csr) {
+      case 0x300: value = mstatus; return true;
+      case 0x301: value = (1u << 30) | (1 << 2) | (1 << 8) | (1 << 12); return true; // RV32 I M C
+      case 0x304: value = mie; return true;
+      case 0x305: value = mtvec; return true;
+      case 0x320: value = mcountinhibit; return true;
+      case 0x340: value = mscratch; return true;
+      case 0x341: value = mepc; return true;
+      case 0x342: value = mcause; return true;
+      case 0x343: value = mtval; return true;
+      case 0x344: value = irq_lines; return true;
+      case 0xB00: case 0xC00: value = (uint32_t)cycle; return true;
+      case 0xB02: case 0xC02: value = (uint32_t)instret; return true;
+      case 0xB80: case 0xC80: value = (uint32_t)(cycle >> 32); return true;
+      case 0xB82: case 0xC82: value = (uint32_t)(instret >> 32); return true;
+      case 0xF11: case 0xF12: case 0xF13: case 0xF14: value = 0; return true;
+    }
+    // hardware performance counters and events, not modelled
+    if ((csr >= 0xB03 && csr <= 0xB1F) || (csr >= 0xB83 && csr <= 0xB9F) ||
+        (csr >= 0xC03 && csr <= 0xC1F) || (csr >= 0xC83 && csr <= 0xC9F) ||
+        (csr >= 0x323 && csr <= 0x33F)) {
+      value = 0;
+      return true;
+    }
+    return false;
+  }
+
+  bool write_csr(uint32_t csr, uint32_t value) {
+    if ((csr >> 10) == 3)
+      return false; // read-only
+    switch (csr) {
+      case 0x300: mstatus = (value & (MSTATUS_MIE | MSTATUS_MPIE)) | MSTATUS_MPP; irq_dirty = true; return true;
+      case 0x301: return true;
+      case 0x304: mie = value & MIE_MASK; irq_dirty = true; return true;
+      case 0x305: mtvec = value & ~2u; return true;
+      case 0x320: mcountinhibit = value; return true;
+      case 0x340: mscratch = value; return true;
+      case 0x341: mepc = value & ~1u; return true;
+      case 0x342: mcause = value; return true;
+      case 0x343: mtval = value; return true;
+      case 0x344: return true;
+      case 0xB00: cycle   = (cycle & 0xFFFFFFFF00000000ull) | value; return true;
+      case 0xB02: instret = (instret & 0xFFFFFFFF00000000ull) | value; return true;
+      case 0xB80: cycle   = (cycle & 0xFFFFFFFFull) | ((uint64_t)value << 32); return true;
+      case 0xB82: instret = (instret & 0xFFFFFFFFull) | ((uint64_t)value << 32); return true;
+    }
+    if ((csr >= 0xB03 && csr <= 0xB1F) || (csr >= 0xB83 && csr <= 0xB9F) || (csr >= 0x323 && csr <= 0x33F))
+      return true;
+    return false;
+  }
+
+  void illegal(uint32_t insn) {
+    trap(CAUSE_ILLEGAL, insn, pc);
+  }
+
+  // 32-bit instruction equivalent to a compressed one, 0 if it is illegal
+  static uint32_t expand(uint32_t c) {
+    uint32_t op     = c & 3;
+    uint32_t funct3 = c >> 13;
+    uint32_t rd     = (c >> 7) & 0x1F;
+    uint32_t rs2    = (c >> 2) & 0x1F;
+    uint32_t rdp    = 8 + ((c >> 2) & 7);
+    uint32_t rs1p   = 8 + ((c >> 7) & 7);
+
+    #define I_TYPE(imm, rs1, f3, rd, opc) ((((imm) & 0xFFF) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | (opc))
+    #define S_TYPE(imm, rs2, rs1, f3, opc) (((((imm) >> 5) & 0x7F) << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | (((imm) & 0x1F) << 7) | (opc))
+    #define R_TYPE(f7, rs2, rs1, f3, rd, opc) (((f7) << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | (opc))
+    #define B_TYPE(imm, rs2, rs1, f3) (((((imm) >> 12) & 1) << 31) | ((((imm) >> 5) & 0x3F) << 25) | ((rs2) << 20) | ((rs1) << 15) | \
+                                       ((f3) << 12) | ((((imm) >> 1) & 0xF) << 8) | ((((imm) >> 11) & 1) << 7) | 0x63)
+    #define J_TYPE(imm, rd) (((((imm) >> 20) & 1) << 31) | ((((imm) >> 1) & 0x3FF) << 21) | ((((imm) >> 11) & 1) << 20) | \
+                             ((((imm) >> 12) & 0xFF) << 12) | ((rd) << 7) | 0x6F)
+
+    switch (op) {
+      case 0:
+        switch (funct3) {
+          case 0: { // c.addi4spn
+            uint32_t imm = ((c >> 7) & 0x30) | ((c >> 1) & 0x3C0) | ((c >> 4) & 0x4) | ((c >> 2) & 0x8);
+            return imm ? I_TYPE(imm, 2, 0, rdp, 0x13) : 0;
+          }
+          case 2: { // c.lw
+            uint32_t imm = ((c >> 7) & 0x38) | ((c >> 4) & 0x4) | ((c << 1) & 0x40);
+            return I_TYPE(imm, rs1p, 2, rdp, 0x03);
+          }
+          case 6: { // c.sw
+            uint32_t imm = ((c >> 7) & 0x38) | ((c >> 4) & 0x4) | ((c << 1) & 0x40);
+            return S_TYPE(imm, rdp, rs1p, 2, 0x23);
+          }
+        }
+        return 0;
+
+      case 1: {
+        int32_t imm6 = (int32_t)(((c >> 7) & 0x20) | ((c >> 2) & 0x1F)) << 26 >> 26;
+        switch (funct3) {
+          case 0: // c.addi, c.nop
+            return I_TYPE(imm6, rd, 0, rd, 0x13);
+          case 1: case 5: { // c.jal, c.j
+            int32_t imm = ((c >> 1) & 0x800) | ((c >> 7) & 0x10) | ((c >> 1) & 0x300) | ((c << 2) & 0x400) |
+                          ((c >> 1) & 0x40) | ((c << 1) & 0x80) | ((c >> 2) & 0xE) | ((c << 3) & 0x20);
+            imm = imm << 20 >> 20;
+            return J_TYPE(imm, funct3 == 1 ? 1u : 0u);
+          }
+          case 2: // c.li
+            return I_TYPE(imm6, 0, 0, rd, 0x13);
+          case 3:
+            if (rd == 2) { // c.addi16sp
+              int32_t imm = ((c >> 3) & 0x200) | ((c >> 2) & 0x10) | ((c << 1) & 0x40) | ((c << 4) & 0x180) | ((c << 3) & 0x20);
+              imm = imm << 22 >> 22;
+              return imm ? I_TYPE(imm, 2, 0, 2, 0x13) : 0;
+            }
+            // c.lui
+            return imm6 ? (((uint32_t)imm6 << 12) & 0xFFFFF000) | (rd << 7) | 0x37 : 0;
+          case 4: {
+            uint32_t funct2 = (c >> 10) & 3;
+            uint32_t shamt  = ((c >> 7) & 0x20) | ((c >> 2) & 0x1F);
+            if (funct2 == 0) // c.srli
+              return shamt & 0x20 ? 0 : I_TYPE(shamt, rs1p, 5, rs1p, 0x13);
+            if (funct2 == 1) // c.srai
+              return shamt & 0x20 ? 0 : I_TYPE(0x400 | shamt, rs1p, 5, rs1p, 0x13);
+            if (funct2 == 2) // c.andi
+              return I_TYPE(imm6, rs1p, 7, rs1p, 0x13);
+            if (c & 0x1000)
+              return 0;
+            switch ((c >> 5) & 3) {
+              case 0: return R_TYPE(0x20, rdp, rs1p, 0, rs1p, 0x33); // c.sub
+              case 1: return R_TYPE(0, rdp, rs1p, 4, rs1p, 0x33);    // c.xor
+              case 2: return R_TYPE(0, rdp, rs1p, 6, rs1p, 0x33);    // c.or
+              case 3: return R_TYPE(0, rdp, rs1p, 7, rs1p, 0x33);    // c.and
+            }
+            return 0;
+          }
+          case 6: case 7: { // c.beqz, c.bnez
+            int32_t imm = ((c >> 4) & 0x100) | ((c >> 7) & 0x18) | ((c << 1) & 0xC0) | ((c >> 2) & 0x6) | ((c << 3) & 0x20);
+            imm = imm << 23 >> 23;
+            return B_TYPE(imm, 0, rs1p, funct3 == 6 ? 0u : 1u);
+          }
+        }
+        return 0;
+      }
+
+      case 2:
+        switch (funct3) {
+          case 0: { // c.slli
+            uint32_t shamt = ((c >> 7) & 0x20) | rs2;
+            return shamt & 0x20 ? 0 : I_TYPE(shamt, rd, 1, rd, 0x13);
+          }
+          case 2: { // c.lwsp
+            uint32_t imm = ((c >> 7) & 0x20) | ((c >> 2) & 0x1C) | ((c << 4) & 0xC0);
+            return rd ? I_TYPE(imm, 2, 2, rd, 0x03) : 0;
+          }
+          case 4:
+            if (!(c & 0x1000)) {
+              if (rs2 == 0) // c.jr
+                return rd ? I_TYPE(0, rd, 0, 0, 0x67) : 0;
+              return R_TYPE(0, rs2, 0, 0, rd, 0x33); // c.mv
+            }
+            if (rs2 == 0) {
+              if (rd == 0) // c.ebreak
+                return 0x00100073;
+              return I_TYPE(0, rd, 0, 1, 0x67); // c.jalr
+            }
+            return R_TYPE(0, rs2, rd, 0, rd, 0x33); // c.add
+          case 6: { // c.swsp
+            uint32_t imm = ((c >> 7) & 0x3C) | ((c >> 1) & 0xC0);
+            return S_TYPE(imm, rs2, 2, 2, 0x23);
+          }
+        }
+        return 0;
+    }
+    return 0;
+
+    #undef I_TYPE
+    #undef S_TYPE
+    #undef R_TYPE
+    #undef B_TYPE
+    #undef J_TYPE
+  }
+
+  void step() {
+    uint32_t insn;
+    if (!fetch(pc, insn)) {
+      trap(CAUSE_FETCH_FAULT, pc, pc);
+      return;
+    }
+    uint32_t len = 4;
+    if ((insn & 3) != 3) {
+      uint32_t raw = insn;
+      insn = expand(raw);
+      len  = 2;
+      if (insn == 0) {
+        illegal(raw);
+        return;
+      }
+    }
+
+    uint32_t next = pc + len;
+    uint32_t rd   = (insn >> 7) & 0x1F;
+    uint32_t rs1  = (insn >> 15) & 0x1F;
+    uint32_t rs2  = (insn >> 20) & 0x1F;
+    uint32_t f3   = (insn >> 12) & 7;
+    uint32_t f7   = insn >> 25;
+    uint32_t a    = x[rs1];
+    uint32_t b    = x[rs2];
+    int32_t  imm_i = (int32_t)insn >> 20;
+    uint32_t result = 0;
+    bool     write_rd = true;
+
+    switch (insn & 0x7F) {
+      case 0x37: // lui
+        result = insn & 0xFFFFF000;
+        break;
+      case 0x17: // auipc
+        result = pc + (insn & 0xFFFFF000);
+        break;
+      case 0x6F: { // jal
+        int32_t imm = (int32_t)(((insn >> 11) & 0x100000) | (insn & 0xFF000) | ((insn >> 9) & 0x800) | ((insn >> 20) & 0x7FE)) << 11 >> 11;
+        result = next;
+        next   = pc + imm;
+        break;
+      }
+      case 0x67: // jalr
+        if (f3 != 0) { illegal(insn); return; }
+        result = next;
+        next   = (a + imm_i) & ~1u;
+        break;
+      case 0x63: { // branches
+        int32_t imm = (int32_t)(((insn >> 19) & 0x1000) | ((insn << 4) & 0x800) | ((insn >> 20) & 0x7E0) | ((insn >> 7) & 0x1E)) << 19 >> 19;
+        bool taken;
+        switch (f3) {
+          case 0: taken = a == b; break;
+          case 1: taken = a != b; break;
+          case 4: taken = (int32_t)a < (int32_t)b; break;
+          case 5: taken = (int32_t)a >= (int32_t)b; break;
+          case 6: taken = a < b; break;
+          case 7: taken = a >= b; break;
+          default: illegal(insn); return;
+        }
+        if (taken)
+          next = pc + imm;
+        write_rd = false;
+        break;
+      }
+      case 0x03: { // loads
+        uint32_t addr = a + imm_i;
+        bool ok;
+        switch (f3) {
+          case 0: { int8_t   v; ok = load(addr, v); result = (int32_t)v; break; }
+          case 1: { int16_t  v; ok = load(addr, v); result = (int32_t)v; break; }
+          case 2: { uint32_t v; ok = load(addr, v); result = v; break; }
+          case 4: { uint8_t  v; ok = load(addr, v); result = v; break; }
+          case 5: { uint16_t v; ok = load(addr, v); result = v; break; }
+          default: illegal(insn); return;
+        }
+        if (!ok) {
+          trap(CAUSE_LOAD_FAULT, addr, pc);
+          return;
+        }
+        break;
+      }
+      case 0x23: { // stores
+        uint32_t addr = a + ((int32_t)(((insn >> 20) & 0xFE0) | ((insn >> 7) & 0x1F)) << 20 >> 20);
+        bool ok;
+        switch (f3) {
+          case 0: ok = store(addr, (uint8_t)b); break;
+          case 1: ok = store(addr, (uint16_t)b); break;
+          case 2: ok = store(addr, b); break;
+          default: illegal(insn); return;
+        }
+        if (!ok) {
+          trap(CAUSE_STORE_FAULT, addr, pc);
+          return;
+        }
+        write_rd = false;
+        break;
+      }
+      case 0x13: { // immediates
+        uint32_t shamt = rs2;
+        switch (f3) {
+          case 0: result = a + imm_i; break;
+          case 1: if (f7 != 0) { illegal(insn); return; } result = a << shamt; break;
+          case 2: result = (int32_t)a < imm_i; break;
+          case 3: result = a < (uint32_t)imm_i; break;
+          case 4: result = a ^ imm_i; break;
+          case 5:
+            if (f7 == 0)         result = a >> shamt;
+            else if (f7 == 0x20) result = (int32_t)a >> shamt;
+            else { illegal(insn); return; }
+            break;
+          case 6: result = a | imm_i; break;
+          case 7: result = a & imm_i; break;
+        }
+        break;
+      }
+      case 0x33: // registers
+        if (f7 == 0) {
+          switch (f3) {
+            case 0: result = a + b; break;
+            case 1: result = a << (b & 0x1F); break;
+            case 2: result = (int32_t)a < (int32_t)b; break;
+            case 3: result = a < b; break;
+            case 4: result = a ^ b; break;
+            case 5: result = a >> (b & 0x1F); break;
+            case 6: result = a | b; break;
+            case 7: result = a & b; break;
+          }
+        } else if (f7 == 0x20 && f3 == 0) {
+          result = a - b;
+        } else if (f7 == 0x20 && f3 == 5) {
+          result = (int32_t)a >> (b & 0x1F);
+        } else if (f7 == 1) {
+          int32_t sa = (int32_t)a, sb = (int32_t)b;
+          switch (f3) {
+            case 0: result = a * b; break;
+            case 1: result = (uint32_t)(((int64_t)sa * sb) >> 32); break;
+            case 2: result = (uint32_t)(((int64_t)sa * (uint64_t)b) >> 32); break;
+            case 3: result = (uint32_t)(((uint64_t)a * b) >> 32); break;
+            case 4: result = b == 0 ? 0xFFFFFFFF : (sa == INT32_MIN && sb == -1) ? a : (uint32_t)(sa / sb); break;
+            case 5: result = b == 0 ? 0xFFFFFFFF : a / b; break;
+            case 6: result = b == 0 ? a : (sa == INT32_MIN && sb == -1) ? 0 : (uint32_t)(sa % sb); break;
+            case 7: result = b == 0 ? a : a % b; break;
+          }
+        } else {
+          illegal(insn);
+          return;
+        }
+        break;
+      case 0x0F: // fence, fence.i
+        write_rd = false;
+        break;
+      case 0x73: { // system
+        if (f3 == 0) {
+          write_rd = false;
+          switch (insn) {
+            case 0x00000073: trap(CAUSE_ECALL_M, 0, pc); return;
+            case 0x00100073: trap(CAUSE_BREAKPOINT, pc, pc); return;
+            case 0x30200073: // mret
+              mstatus = (mstatus & MSTATUS_MPIE ? mstatus | MSTATUS_MIE : mstatus & ~MSTATUS_MIE) | MSTATUS_MPIE;
+              next = mepc;
+              irq_dirty = true;
+              break;
+            case 0x10500073: // wfi
+              if (!(irq_lines & mie))
+                wfi = true;
+              break;
+            default: illegal(insn); return;
+          }
+          break;
+        }
+        uint32_t csr = insn >> 20;
+        uint32_t old;
+        if (f3 == 4 || !read_csr(csr, old)) {
+          // the unknown CSRs are reported once, then trap as on the core
+          if (warned_csrs.insert(csr).second)
+            std::cout<<"[VP]: unsupported CSR 0x"<<std::hex<<csr<<std::dec<<" at pc 0x"<<std::hex<<pc<<std::dec<<std::endl;
+          illegal(insn);
+          return;
+        }
+        uint32_t src = f3 & 4 ? rs1 : a;
+        uint32_t value;
+        bool     write;
+        switch (f3 & 3) {
+          case 1:  value = src;        write = true;     break; // csrrw
+          case 2:  value = old | src;  write = rs1 != 0; break; // csrrs
+          default: value = old & ~src; write = rs1 != 0; break; // csrrc
+        }
+        if (write && !write_csr(csr, value)) {
+          illegal(insn);
+          return;
+        }
+        result = old;
+        break;
+      }
+      default:
+        illegal(insn);
+        return;
+    }
+
+    if (write_rd && rd != 0)
+      x[rd] = result;
+    pc = next;
+    instret++;
+  }
+};
+
+#endif
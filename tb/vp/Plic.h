@@ -0,0 +1,94 @@
+#ifndef PLIC_H
+#define PLIC_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "rv_plic/rv_plic_regs.h"
+
+
+// Platform-level interrupt controller of one target, with level-triggered sources: a source
+// that is high and not claimed is pending, a claim (read of CC0) returns the pending enabled
+// source of highest priority above the threshold, the completion (write of CC0) releases it.
+// irq_out gives the external interrupt (bit 0) and the software interrupt of MSIP0 (bit 1).
+struct Plic : RegTarget
+{
+  enum { NUM_SRC = RV_PLIC_PARAM_NUM_SRC };
+
+  uint64_t levels  = 0;
+  uint64_t claimed = 0;
+
+  Plic(sc_module_name name)
+  : RegTarget(name, VP_RV_PLIC_REGS, VP_RV_PLIC_NREGS)
+  {}
+
+  // Levels of the sources [first, first + count)
+  void set_sources(unsigned int first, unsigned int count, uint32_t lines) {
+    uint64_t mask = (((uint64_t)1 << count) - 1) << first;
+    levels = (levels & ~mask) | (((uint64_t)lines << first) & mask);
+    update();
+  }
+
+  uint64_t pending() {
+    return ((uint64_t)reg(RV_PLIC_IP_1_REG_OFFSET) << 32) | reg(RV_PLIC_IP_0_REG_OFFSET);
+  }
+
+  uint64_t enabled() {
+    return ((uint64_t)reg(RV_PLIC_IE0_1_REG_OFFSET) << 32) | reg(RV_PLIC_IE0_0_REG_OFFSET);
+  }
+
+  // Pending enabled source of highest priority above the threshold, 0 if none
+  unsigned int best() {
+    uint64_t candidates = pending() & enabled();
+    uint32_t threshold  = reg(RV_PLIC_THRESHOLD0_REG_OFFSET);
+    unsigned int id = 0;
+    uint32_t max_prio = threshold;
+    for (unsigned int i = 1; i < NUM_SRC; i++) {
+      if (!(candidates >> i & 1))
+        continue;
+      uint32_t prio = reg(RV_PLIC_PRIO0_REG_OFFSET + 4 * i);
+      if (prio > max_prio) {
+        max_prio = prio;
+        id = i;
+      }
+    }
+    return id;
+  }
+
+  void update() {
+    uint64_t ip = pending() | (levels & ~claimed);
+    reg(RV_PLIC_IP_0_REG_OFFSET) = (uint32_t)ip;
+    reg(RV_PLIC_IP_1_REG_OFFSET) = (uint32_t)(ip >> 32);
+    set_irq((best() != 0 ? 1 : 0) | (reg(RV_PLIC_MSIP0_REG_OFFSET) & 1) << 1);
+  }
+
+  virtual uint32_t read_hook(uint32_t offset, uint32_t value) {
+    if (offset != RV_PLIC_CC0_REG_OFFSET)
+      return value;
+    unsigned int id = best();
+    if (id != 0) {
+      uint64_t ip = pending() & ~((uint64_t)1 << id);
+      reg(RV_PLIC_IP_0_REG_OFFSET) = (uint32_t)ip;
+      reg(RV_PLIC_IP_1_REG_OFFSET) = (uint32_t)(ip >> 32);
+      claimed |= (uint64_t)1 << id;
+      update();
+    }
+    return id;
+  }
+
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {
+    if (offset == RV_PLIC_CC0_REG_OFFSET && written < NUM_SRC)
+      claimed &= ~((uint64_t)1 << written);
+    update();
+  }
+
+  // a write of CC0 is a completion, the claims are not given to the RTL
+  virtual void state(std::vector<std::pair<uint32_t, uint32_t> >& writes) {
+    std::vector<std::pair<uint32_t, uint32_t> > all;
+    RegTarget::state(all);
+    for (size_t i = 0; i < all.size(); i++)
+      if (all[i].first != RV_PLIC_CC0_REG_OFFSET)
+        writes.push_back(all[i]);
+  }
+};
+
+#endif
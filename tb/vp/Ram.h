@@ -0,0 +1,81 @@
+#ifndef RAM_H
+#define RAM_H
+
+// Needed for the simple_target_socket
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+
+#include "systemc"
+using namespace sc_core;
+using namespace sc_dt;
+using namespace std;
+
+#include "tlm.h"
+#include "tlm_utils/simple_target_socket.h"
+
+#include <vector>
+
+
+// Target module of the on-chip RAM banks, seen as one contiguous memory granted by DMI
+SC_MODULE(Ram)
+{
+  tlm_utils::simple_target_socket<Ram> socket;
+
+  std::vector<unsigned char> data;
+
+  SC_CTOR(Ram)
+  : socket("socket")
+  {
+    socket.register_b_transport(this, &Ram::b_transport);
+    socket.register_get_direct_mem_ptr(this, &Ram::get_direct_mem_ptr);
+  }
+
+  // Sets the size of the memory, to be called before the simulation starts
+  void configure_size(uint32_t size) {
+    data.assign(size, 0);
+  }
+
+  // TLM-2 blocking transport method
+  virtual void b_transport( tlm::tlm_generic_payload& trans, sc_time& delay )
+  {
+    sc_dt::uint64  adr = trans.get_address();
+    unsigned char* ptr = trans.get_data_ptr();
+    unsigned int   len = trans.get_data_length();
+    unsigned char* byt = trans.get_byte_enable_ptr();
+    unsigned int   bel = trans.get_byte_enable_length();
+
+    if (adr + len > data.size()) {
+      trans.set_response_status( tlm::TLM_ADDRESS_ERROR_RESPONSE );
+      return;
+    }
+
+    bool we = trans.get_command() == tlm::TLM_WRITE_COMMAND;
+    for (unsigned int i = 0; i < len; i++) {
+      if (byt != 0 && byt[i % bel] != tlm::TLM_BYTE_ENABLE_ENABLED)
+        continue;
+      if (we)
+        data[adr + i] = ptr[i];
+      else
+        ptr[i] = data[adr + i];
+    }
+
+    trans.set_dmi_allowed( true );
+    trans.set_response_status( tlm::TLM_OK_RESPONSE );
+  }
+
+  // TLM-2 forward DMI method, grants read and write access to the whole memory
+  virtual bool get_direct_mem_ptr( tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data )
+  {
+    if (trans.get_address() >= data.size())
+      return false;
+    dmi_data.allow_read_write();
+    dmi_data.set_dmi_ptr( data.data() );
+    dmi_data.set_start_address( 0 );
+    dmi_data.set_end_address( data.size() - 1 );
+    dmi_data.set_read_latency( SC_ZERO_TIME );
+    dmi_data.set_write_latency( SC_ZERO_TIME );
+    return true;
+  }
+
+};
+
+#endif
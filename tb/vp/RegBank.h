@@ -0,0 +1,195 @@
+#ifndef REG_BANK_H
+#define REG_BANK_H
+
+// Needed for the simple_target_socket
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+
+#include "systemc"
+using namespace sc_core;
+using namespace sc_dt;
+using namespace std;
+
+#include "tlm.h"
+#include "tlm_utils/simple_target_socket.h"
+
+#include <functional>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+// Register of an IP, from its hjson (util/vp_regs_gen.py), the masks are the bits of its fields
+// with that software access
+struct RegDesc {
+  uint32_t    offset;
+  uint32_t    reset;
+  uint32_t    rw;   // written as is (rw, wo)
+  uint32_t    w1c;  // cleared by writing 1 (rw1c, r0w1c)
+  uint32_t    w1s;  // set by writing 1 (rw1s)
+  uint32_t    rc;   // cleared by a read
+  uint32_t    wo;   // read as 0
+  const char* name;
+};
+
+// Memory window of an IP, accessed through RegTarget::window_access
+struct RegWindow {
+  uint32_t    offset;
+  uint32_t    size;
+  const char* name;
+};
+
+
+// Target module of the registers of an IP: the software access of every field is applied by
+// the bank, the models of the IPs only add their behaviour in read_hook and write_hook.
+// The accesses of less than a word read or write the bytes of their word.
+struct RegTarget : sc_module
+{
+  tlm_utils::simple_target_socket<RegTarget> socket;
+
+  // value of every register, indexed by offset / 4
+  std::vector<uint32_t> regs;
+
+  // interrupt lines of the IP, given to irq_out when they change
+  std::function<void(uint32_t lines)> irq_out;
+  uint32_t irq_lines = 0;
+
+  RegTarget(sc_module_name name, const RegDesc* descs, unsigned int ndescs,
+            const RegWindow* windows = NULL, unsigned int nwindows = 0)
+  : sc_module(name), socket("socket"), windows(windows), nwindows(nwindows)
+  {
+    socket.register_b_transport(this, &RegTarget::b_transport);
+
+    uint32_t words = 0;
+    for (unsigned int i = 0; i < ndescs; i++)
+      words = std::max(words, descs[i].offset / 4 + 1);
+    regs.assign(words, 0);
+    index.assign(words, (const RegDesc*)NULL);
+    for (unsigned int i = 0; i < ndescs; i++) {
+      index[descs[i].offset / 4] = &descs[i];
+      regs[descs[i].offset / 4]  = descs[i].reset;
+    }
+  }
+
+  virtual ~RegTarget() {}
+
+  uint32_t& reg(uint32_t offset) {
+    return regs[offset / 4];
+  }
+
+  // Value read by the software, called before the read side effects
+  virtual uint32_t read_hook(uint32_t offset, uint32_t value) {
+    return value;
+  }
+
+  // Called once the software access of a write is applied, written holds the bytes written
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {}
+
+  // Access to a window, the offset is relative to the window
+  virtual bool window_access(const RegWindow& window, uint32_t offset, uint32_t& data, bool write) {
+    if (!write)
+      data = 0;
+    return true;
+  }
+
+  // Register writes that bring the RTL of the IP to the state of the model, at the switch to the
+  // RTL (+vp_switch): by default the registers written as is by the software that are not at
+  // their reset value, without their write-only fields, in the order of their offsets
+  virtual void state(std::vector<std::pair<uint32_t, uint32_t> >& writes) {
+    for (size_t i = 0; i < index.size(); i++) {
+      const RegDesc* desc = index[i];
+      uint32_t       mask = desc ? desc->rw & ~desc->wo : 0;
+      if (mask == 0 || (desc->w1c | desc->w1s | desc->rc) != 0)
+        continue;
+      if ((regs[i] & mask) != (desc->reset & mask))
+        writes.push_back(std::make_pair(desc->offset, regs[i] & mask));
+    }
+  }
+
+  void set_irq(uint32_t lines) {
+    if (lines == irq_lines)
+      return;
+    irq_lines = lines;
+    if (irq_out)
+      irq_out(lines);
+  }
+
+  // Time of the access being served, for the models that depend on the time
+  sc_time access_time() const {
+    return now;
+  }
+
+  // TLM-2 blocking transport method
+  virtual void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay)
+  {
+    sc_dt::uint64  adr = trans.get_address();
+    unsigned char* ptr = trans.get_data_ptr();
+    unsigned int   len = trans.get_data_length();
+    bool           we  = trans.get_command() == tlm::TLM_WRITE_COMMAND;
+
+    if (len > 4 || (adr & 3) + len > 4 || trans.get_byte_enable_ptr() != 0) {
+      trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+      return;
+    }
+
+    now = sc_time_stamp() + delay;
+    uint32_t offset = adr & ~3u;
+    uint32_t shift  = (adr & 3) * 8;
+    uint32_t mask   = len == 4 ? 0xFFFFFFFF : ((1u << (len * 8)) - 1) << shift;
+    uint32_t data   = 0;
+    if (we) {
+      memcpy(&data, ptr, len);
+      data <<= shift;
+    }
+
+    for (unsigned int i = 0; i < nwindows; i++) {
+      if (offset >= windows[i].offset && offset < windows[i].offset + windows[i].size) {
+        uint32_t word = data;
+        if (!window_access(windows[i], offset - windows[i].offset, word, we)) {
+          trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+          return;
+        }
+        if (!we) {
+          word >>= shift;
+          memcpy(ptr, &word, len);
+        }
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+        return;
+      }
+    }
+
+    const RegDesc* desc = offset / 4 < index.size() ? index[offset / 4] : NULL;
+    if (desc == NULL) {
+      // as on the register interface, the holes read as 0 and ignore the writes
+      if (unmapped.insert(offset).second)
+        std::cout<<"[VP]: "<<name()<<": no register at offset 0x"<<std::hex<<offset<<std::dec<<std::endl;
+      if (!we)
+        memset(ptr, 0, len);
+      trans.set_response_status(tlm::TLM_OK_RESPONSE);
+      return;
+    }
+
+    uint32_t& value = regs[offset / 4];
+    if (we) {
+      uint32_t old_value = value;
+      value = (value & ~(desc->rw & mask)) | (data & desc->rw & mask);
+      value &= ~(data & desc->w1c & mask);
+      value |= data & desc->w1s & mask;
+      write_hook(offset, old_value, data & mask);
+    } else {
+      uint32_t word = read_hook(offset, value) & ~desc->wo;
+      value &= ~desc->rc;
+      word >>= shift;
+      memcpy(ptr, &word, len);
+    }
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+  }
+
+private:
+  const RegWindow* windows;
+  unsigned int     nwindows;
+  std::vector<const RegDesc*> index;
+  std::set<uint32_t> unmapped;
+  sc_time now;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef RV_TIMER_H
+#define RV_TIMER_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "rv_timer/rv_timer_regs.h"
+
+
+// Timer of RV_TIMER_PARAM_N_HARTS harts: the value of a hart is computed from the simulation
+// time, counting step every prescale + 1 cycles of clk_period while it is active. The interrupt
+// of a hart is raised at the time its value reaches its compare value.
+struct RvTimer : RegTarget
+{
+  enum { N_HARTS = RV_TIMER_PARAM_N_HARTS, HART_STRIDE = 0x100 };
+
+  sc_time clk_period;
+
+  // value of each hart at the anchor cycle, from which it counts
+  uint64_t anchor_value[N_HARTS];
+  uint64_t anchor_cycle[N_HARTS];
+
+  sc_event expire;
+
+  SC_HAS_PROCESS(RvTimer);
+
+  RvTimer(sc_module_name name, sc_time clk_period)
+  : RegTarget(name, VP_RV_TIMER_REGS, VP_RV_TIMER_NREGS), clk_period(clk_period)
+  {
+    for (unsigned int h = 0; h < N_HARTS; h++) {
+      anchor_value[h] = 0;
+      anchor_cycle[h] = 0;
+    }
+    SC_METHOD(tick);
+    sensitive << expire;
+    dont_initialize();
+  }
+
+  uint32_t hart_reg(unsigned int hart, uint32_t offset) {
+    return reg(offset + HART_STRIDE * hart);
+  }
+
+  bool active(unsigned int hart) {
+    return reg(RV_TIMER_CTRL_REG_OFFSET) >> hart & 1;
+  }
+
+  uint64_t ticks_per_step(unsigned int hart) {
+    return (hart_reg(hart, RV_TIMER_CFG0_REG_OFFSET) & RV_TIMER_CFG0_PRESCALE_MASK) + 1;
+  }
+
+  uint32_t step(unsigned int hart) {
+    return hart_reg(hart, RV_TIMER_CFG0_REG_OFFSET) >> RV_TIMER_CFG0_STEP_OFFSET & RV_TIMER_CFG0_STEP_MASK;
+  }
+
+  uint64_t cycle(const sc_time& t) {
+    return (uint64_t)(t / clk_period);
+  }
+
+  uint64_t value(unsigned int hart, const sc_time& t) {
+    if (!active(hart))
+      return anchor_value[hart];
+    return anchor_value[hart] + (cycle(t) - anchor_cycle[hart]) / ticks_per_step(hart) * step(hart);
+  }
+
+  uint64_t compare(unsigned int hart) {
+    return (uint64_t)hart_reg(hart, RV_TIMER_COMPARE_UPPER0_0_REG_OFFSET) << 32 |
+           hart_reg(hart, RV_TIMER_COMPARE_LOWER0_0_REG_OFFSET);
+  }
+
+  // Moves the anchor of a hart to t, before its configuration changes
+  void anchor(unsigned int hart, const sc_time& t) {
+    anchor_value[hart] = value(hart, t);
+    anchor_cycle[hart] = cycle(t);
+  }
+
+  // Sets the interrupt states reached at t and schedules the next one
+  void update(const sc_time& t) {
+    uint32_t lines = 0;
+    sc_time  next  = SC_ZERO_TIME;
+    for (unsigned int h = 0; h < N_HARTS; h++) {
+      uint32_t& state = reg(RV_TIMER_INTR_STATE0_REG_OFFSET + HART_STRIDE * h);
+      uint64_t  now   = value(h, t);
+      if (now >= compare(h))
+        state |= 1;
+      else if (active(h) && step(h) != 0) {
+        uint64_t steps  = (compare(h) - now + step(h) - 1) / step(h);
+        uint64_t cycles = anchor_cycle[h] + ((now - anchor_value[h]) / step(h) + steps) * ticks_per_step(h);
+        sc_time  at     = clk_period * (double)cycles;
+        if (next == SC_ZERO_TIME || at < next)
+          next = at;
+      }
+      lines |= (state & hart_reg(h, RV_TIMER_INTR_ENABLE0_REG_OFFSET) & 1) << h;
+    }
+    set_irq(lines);
+    expire.cancel();
+    if (next != SC_ZERO_TIME)
+      expire.notify(next > sc_time_stamp() ? next - sc_time_stamp() : SC_ZERO_TIME);
+  }
+
+  void tick() {
+    update(sc_time_stamp());
+  }
+
+  virtual uint32_t read_hook(uint32_t offset, uint32_t value) {
+    unsigned int hart = offset / HART_STRIDE - 1;
+    uint32_t     reg  = offset % HART_STRIDE + HART_STRIDE;
+    if (offset >= HART_STRIDE && hart < N_HARTS) {
+      if (reg == RV_TIMER_TIMER_V_LOWER0_REG_OFFSET)
+        return (uint32_t)this->value(hart, access_time());
+      if (reg == RV_TIMER_TIMER_V_UPPER0_REG_OFFSET)
+        return (uint32_t)(this->value(hart, access_time()) >> 32);
+      if (reg == RV_TIMER_INTR_STATE0_REG_OFFSET) {
+        update(access_time());
+        return this->reg(offset);
+      }
+    }
+    return value;
+  }
+
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {
+    sc_time t = access_time();
+    if (offset == RV_TIMER_CTRL_REG_OFFSET) {
+      // the harts count from the time they are started or stopped
+      uint32_t now = reg(offset);
+      reg(offset)  = old_value;
+      for (unsigned int h = 0; h < N_HARTS; h++)
+        anchor(h, t);
+      reg(offset) = now;
+    } else if (offset >= HART_STRIDE && offset / HART_STRIDE - 1 < N_HARTS) {
+      unsigned int hart = offset / HART_STRIDE - 1;
+      uint32_t     reg  = offset % HART_STRIDE + HART_STRIDE;
+      if (reg == RV_TIMER_CFG0_REG_OFFSET) {
+        uint32_t now = this->reg(offset);
+        this->reg(offset) = old_value;
+        anchor(hart, t);
+        this->reg(offset) = now;
+      } else if (reg == RV_TIMER_TIMER_V_LOWER0_REG_OFFSET || reg == RV_TIMER_TIMER_V_UPPER0_REG_OFFSET) {
+        anchor(hart, t);
+        uint64_t v = anchor_value[hart];
+        if (reg == RV_TIMER_TIMER_V_LOWER0_REG_OFFSET)
+          v = (v & 0xFFFFFFFF00000000ull) | this->reg(offset);
+        else
+          v = (v & 0xFFFFFFFFull) | (uint64_t)this->reg(offset) << 32;
+        anchor_value[hart] = v;
+      } else if (reg == RV_TIMER_INTR_TEST0_REG_OFFSET) {
+        this->reg(RV_TIMER_INTR_STATE0_REG_OFFSET + HART_STRIDE * hart) |= written & 1;
+      }
+    }
+    update(t);
+  }
+
+  // the values of the harts at the current time, and CTRL last so that they start counting once
+  // configured
+  virtual void state(std::vector<std::pair<uint32_t, uint32_t> >& writes) {
+    std::vector<std::pair<uint32_t, uint32_t> > all;
+    RegTarget::state(all);
+    for (size_t i = 0; i < all.size(); i++) {
+      uint32_t reg = all[i].first % HART_STRIDE + HART_STRIDE;
+      if (all[i].first != RV_TIMER_CTRL_REG_OFFSET && (all[i].first < HART_STRIDE ||
+          (reg != RV_TIMER_TIMER_V_LOWER0_REG_OFFSET && reg != RV_TIMER_TIMER_V_UPPER0_REG_OFFSET)))
+        writes.push_back(all[i]);
+    }
+    for (unsigned int h = 0; h < N_HARTS; h++) {
+      uint64_t v = value(h, sc_time_stamp());
+      if (v == 0)
+        continue;
+      writes.push_back(std::make_pair(RV_TIMER_TIMER_V_LOWER0_REG_OFFSET + HART_STRIDE * h, (uint32_t)v));
+      writes.push_back(std::make_pair(RV_TIMER_TIMER_V_UPPER0_REG_OFFSET + HART_STRIDE * h, (uint32_t)(v >> 32)));
+    }
+    if (reg(RV_TIMER_CTRL_REG_OFFSET) != 0)
+      writes.push_back(std::make_pair((uint32_t)RV_TIMER_CTRL_REG_OFFSET, reg(RV_TIMER_CTRL_REG_OFFSET)));
+  }
+};
+
+#endif
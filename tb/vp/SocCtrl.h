@@ -0,0 +1,38 @@
+#ifndef SOC_CTRL_H
+#define SOC_CTRL_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "soc_ctrl/soc_ctrl_regs.h"
+
+
+// SoC controller: the exit of the program is given to on_exit and the writes of SCRATCH to
+// on_scratch, the other registers are only stored
+struct SocCtrl : RegTarget
+{
+  std::function<void(uint32_t exit_value)> on_exit;
+  std::function<void(uint32_t value)>      on_scratch;
+
+  SocCtrl(sc_module_name name)
+  : RegTarget(name, VP_SOC_CTRL_REGS, VP_SOC_CTRL_NREGS)
+  {}
+
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {
+    if (offset == SOC_CTRL_EXIT_VALID_REG_OFFSET && (reg(offset) & 1) && on_exit)
+      on_exit(reg(SOC_CTRL_EXIT_VALUE_REG_OFFSET));
+    if (offset == SOC_CTRL_SCRATCH_REG_OFFSET && on_scratch)
+      on_scratch(reg(offset));
+  }
+
+  // the exit and the marker of the switch are not given to the RTL
+  virtual void state(std::vector<std::pair<uint32_t, uint32_t> >& writes) {
+    std::vector<std::pair<uint32_t, uint32_t> > all;
+    RegTarget::state(all);
+    for (size_t i = 0; i < all.size(); i++)
+      if (all[i].first != SOC_CTRL_EXIT_VALID_REG_OFFSET && all[i].first != SOC_CTRL_EXIT_VALUE_REG_OFFSET &&
+          all[i].first != SOC_CTRL_SCRATCH_REG_OFFSET)
+        writes.push_back(all[i]);
+  }
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef SPI_HOST_H
+#define SPI_HOST_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "spi_host/spi_host_regs.h"
+
+
+// SPI host without devices: it is always ready with empty FIFOs, the commands end at once and
+// the received words read as an erased flash
+struct SpiHost : RegTarget
+{
+  SpiHost(sc_module_name name)
+  : RegTarget(name, VP_SPI_HOST_REGS, VP_SPI_HOST_NREGS, VP_SPI_HOST_WINDOWS, VP_SPI_HOST_NWINDOWS)
+  {}
+
+  virtual uint32_t read_hook(uint32_t offset, uint32_t value) {
+    if (offset == SPI_HOST_STATUS_REG_OFFSET)
+      return (1u << SPI_HOST_STATUS_READY_BIT) | (1u << SPI_HOST_STATUS_TXEMPTY_BIT) |
+             (1u << SPI_HOST_STATUS_TXWM_BIT) | (1u << SPI_HOST_STATUS_RXEMPTY_BIT);
+    return value;
+  }
+
+  virtual bool window_access(const RegWindow& window, uint32_t offset, uint32_t& data, bool write) {
+    if (!write)
+      data = 0xFFFFFFFF;
+    return true;
+  }
+};
+
+#endif
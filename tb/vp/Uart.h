@@ -0,0 +1,45 @@
+#ifndef UART_H
+#define UART_H
+
+#include "RegBank.h"
+#include "vp_regs.h"
+#include "uart/uart_regs.h"
+
+#include <fstream>
+
+
+// UART: the characters written are printed at once and logged in uart0.log, as by the uartdpi of
+// the RTL testharness, so the transmit FIFO is always empty. Nothing is ever received.
+struct Uart : RegTarget
+{
+  std::ofstream log;
+
+  Uart(sc_module_name name)
+  : RegTarget(name, VP_UART_REGS, VP_UART_NREGS)
+  {
+    log.open("uart0.log");
+  }
+
+  void update() {
+    set_irq(reg(UART_INTR_STATE_REG_OFFSET) & reg(UART_INTR_ENABLE_REG_OFFSET));
+  }
+
+  virtual void write_hook(uint32_t offset, uint32_t old_value, uint32_t written) {
+    uint32_t& state = reg(UART_INTR_STATE_REG_OFFSET);
+    if (offset == UART_WDATA_REG_OFFSET) {
+      char c = (char)written;
+      std::cout<<c;
+      log<<c;
+      if (c == '\n') {
+        std::cout.flush();
+        log.flush();
+      }
+      state |= (1 << UART_INTR_STATE_TX_WATERMARK_BIT) | (1 << UART_INTR_STATE_TX_EMPTY_BIT);
+    } else if (offset == UART_INTR_TEST_REG_OFFSET) {
+      state |= written & 0xFF;
+    }
+    update();
+  }
+};
+
+#endif
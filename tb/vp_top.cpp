@@ -0,0 +1,270 @@
+// Copyright 2024 EPFL
+// Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+// SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+// SystemC/TLM-2 loosely-timed virtual platform of X-HEEP (make vp), see
+// docs/source/How_to/SystemC.md: an ISS of the core, the RAM and register models of the
+// peripherals generated from their hjson, at the addresses of the current MCU (make mcu-gen).
+
+#include "systemc.h"
+#include "tlm.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "XHEEP_CmdLineOptions.hh"
+#include "XHEEP_FirmwareLoader.hh"
+#include "XHEEP_SwitchState.hh"
+
+#include "core_v_mini_mcu.h"
+
+#include "vp/Core.h"
+#include "vp/Bus.h"
+#include "vp/Ram.h"
+#include "vp/SocCtrl.h"
+#include "vp/Uart.h"
+#include "vp/RvTimer.h"
+#include "vp/FastIntrCtrl.h"
+#include "vp/Plic.h"
+#include "vp/Dma.h"
+#include "vp/SpiHost.h"
+
+
+#define CLK_PERIOD 10
+
+// fast interrupts of fast_intr_ctrl, see sw/device/lib/drivers/fast_intr_ctrl/fast_intr_ctrl.h
+#define FIC_TIMER_1 0
+#define FIC_TIMER_2 1
+#define FIC_TIMER_3 2
+#define FIC_DMA     3
+
+// State of the platform at the switch to the RTL (+vp_switch), see tb/XHEEP_SwitchState.hh
+bool writeSwitchState(const std::string& file, Iss* iss, Ram& ram, uint32_t ram_base,
+                      const std::vector<std::pair<uint32_t, RegTarget*> >& targets, uint64_t cycle)
+{
+  XHEEP_SwitchState state;
+
+  state.cycle = cycle;
+  state.pc    = iss->pc;
+  for (int i = 0; i < 32; i++)
+    state.x[i] = iss->x[i];
+
+  // the counters are stopped while they are written, mstatus last
+  state.csrs.push_back(std::make_pair(0x320u, 0xFFFFFFFFu));
+  state.csrs.push_back(std::make_pair(0xB00u, (uint32_t)iss->cycle));
+  state.csrs.push_back(std::make_pair(0xB80u, (uint32_t)(iss->cycle >> 32)));
+  state.csrs.push_back(std::make_pair(0xB02u, (uint32_t)iss->instret));
+  state.csrs.push_back(std::make_pair(0xB82u, (uint32_t)(iss->instret >> 32)));
+  state.csrs.push_back(std::make_pair(0x320u, iss->mcountinhibit));
+  state.csrs.push_back(std::make_pair(0x305u, iss->mtvec));
+  state.csrs.push_back(std::make_pair(0x340u, iss->mscratch));
+  state.csrs.push_back(std::make_pair(0x342u, iss->mcause));
+  state.csrs.push_back(std::make_pair(0x343u, iss->mtval));
+  state.csrs.push_back(std::make_pair(0x304u, iss->mie));
+  state.csrs.push_back(std::make_pair(0x300u, iss->mstatus));
+
+  for (size_t t = 0; t < targets.size(); t++) {
+    std::vector<std::pair<uint32_t, uint32_t> > writes;
+    targets[t].second->state(writes);
+    for (size_t i = 0; i < writes.size(); i++)
+      state.regs.push_back(std::make_pair(targets[t].first + writes[i].first, writes[i].second));
+  }
+
+  state.ram_base = ram_base;
+  state.ram.resize(ram.data.size() / 4);
+  memcpy(state.ram.data(), ram.data.data(), state.ram.size() * 4);
+
+  return state.write(file);
+}
+
+int sc_main (int argc, char * argv[])
+{
+  XHEEP_CmdLineOptions* cmd_lines_options = new XHEEP_CmdLineOptions(argc,argv);
+
+  std::string firmware = cmd_lines_options->get_firmware();
+  if(firmware.empty()){
+    std::cout<<"[VP]: ERROR: the virtual platform needs a +firmware"<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::string perf_json  = cmd_lines_options->get_perf_json();
+  uint64_t    quantum    = cmd_lines_options->get_vp_quantum();
+  uint64_t    max_cycles = cmd_lines_options->get_vp_max_cycles();
+  std::string vp_switch  = cmd_lines_options->get_vp_switch();
+
+  sc_time clk_period(CLK_PERIOD, SC_NS);
+  tlm::tlm_global_quantum::instance().set(sc_time((double)quantum, SC_NS));
+
+  uint32_t ram_start[] = RAM_BANK_START_ADDRESSES;
+  uint32_t ram_end[]   = RAM_BANK_END_ADDRESSES;
+  uint32_t ram_base    = ram_start[0];
+  uint32_t ram_size    = ram_end[MEMORY_BANKS - 1] - ram_base;
+
+  Core         core("core", clk_period, ram_base);
+  Bus          bus("bus");
+  Ram          ram("ram");
+  SocCtrl      soc_ctrl("soc_ctrl");
+  Uart         uart("uart");
+  RvTimer      rv_timer_ao("rv_timer_ao", clk_period);
+  FastIntrCtrl fast_intr_ctrl("fast_intr_ctrl");
+  SpiHost      spi_flash("spi_flash");
+  RegTarget    power_manager("power_manager", VP_POWER_MANAGER_REGS, VP_POWER_MANAGER_NREGS);
+  // the other peripherals read as 0 and ignore the writes
+  RegTarget    ao_peripherals("ao_peripherals", NULL, 0);
+  RegTarget    peripherals("peripherals", NULL, 0);
+
+  std::vector<DmaChannel*> dma;
+  for (int ch = 0; ch < DMA_CH_NUM; ch++)
+    dma.push_back(new DmaChannel(sc_gen_unique_name("dma_ch"), clk_period));
+
+#ifdef RV_PLIC_IS_INCLUDED
+  Plic         rv_plic("rv_plic");
+#endif
+#ifdef RV_TIMER_IS_INCLUDED
+  RvTimer      rv_timer("rv_timer", clk_period);
+#endif
+#ifdef SPI_HOST_IS_INCLUDED
+  SpiHost      spi_host("spi_host");
+#endif
+
+  ram.configure_size(ram_size);
+
+  // initiators
+  core.socket.bind(bus.target_socket);
+  for (int ch = 0; ch < DMA_CH_NUM; ch++)
+    dma[ch]->initiator_socket.bind(bus.target_socket);
+
+  // slaves, the first region of an address wins, the register targets are kept for the switch
+  std::vector<std::pair<uint32_t, RegTarget*> > targets;
+  auto attach = [&](RegTarget& target, uint32_t start, uint32_t size) {
+    bus.map(target.name(), start, size);
+    target.socket.bind(bus.initiator_socket);
+    targets.push_back(std::make_pair(start, &target));
+  };
+  bus.map("ram", ram_base, ram_size);
+  ram.socket.bind(bus.initiator_socket);
+  attach(soc_ctrl, SOC_CTRL_START_ADDRESS, SOC_CTRL_SIZE);
+  attach(spi_flash, SPI_FLASH_START_ADDRESS, SPI_FLASH_SIZE);
+  for (int ch = 0; ch < DMA_CH_NUM; ch++)
+    attach(*dma[ch], DMA_START_ADDRESS + ch * DMA_CH_SIZE, DMA_CH_SIZE);
+  attach(power_manager, POWER_MANAGER_START_ADDRESS, POWER_MANAGER_SIZE);
+  attach(rv_timer_ao, RV_TIMER_AO_START_ADDRESS, RV_TIMER_AO_SIZE);
+  attach(fast_intr_ctrl, FAST_INTR_CTRL_START_ADDRESS, FAST_INTR_CTRL_SIZE);
+  attach(uart, UART_START_ADDRESS, UART_SIZE);
+#ifdef RV_PLIC_IS_INCLUDED
+  attach(rv_plic, RV_PLIC_START_ADDRESS, RV_PLIC_SIZE);
+#endif
+#ifdef SPI_HOST_IS_INCLUDED
+  attach(spi_host, SPI_HOST_START_ADDRESS, SPI_HOST_SIZE);
+#endif
+#ifdef RV_TIMER_IS_INCLUDED
+  attach(rv_timer, RV_TIMER_START_ADDRESS, RV_TIMER_SIZE);
+#endif
+  attach(ao_peripherals, AO_PERIPHERAL_START_ADDRESS, AO_PERIPHERAL_SIZE);
+  attach(peripherals, PERIPHERAL_START_ADDRESS, PERIPHERAL_SIZE);
+
+  // interrupts, as wired in core_v_mini_mcu.sv
+  rv_timer_ao.irq_out = [&](uint32_t lines) {
+    core.set_line(Iss::IRQ_MTI, lines & 1);
+    fast_intr_ctrl.set_input(FIC_TIMER_1, lines & 2);
+  };
+#ifdef RV_TIMER_IS_INCLUDED
+  rv_timer.irq_out = [&](uint32_t lines) {
+    fast_intr_ctrl.set_input(FIC_TIMER_2, lines & 1);
+    fast_intr_ctrl.set_input(FIC_TIMER_3, lines & 2);
+  };
+#endif
+  for (int ch = 0; ch < DMA_CH_NUM; ch++)
+    dma[ch]->irq_out = [&](uint32_t lines) { fast_intr_ctrl.set_input(FIC_DMA, lines & 1); };
+  fast_intr_ctrl.irq_out = [&](uint32_t lines) { core.set_fast(lines); };
+#ifdef RV_PLIC_IS_INCLUDED
+  uart.irq_out = [&](uint32_t lines) { rv_plic.set_sources(UART_INTR_TX_WATERMARK, 8, lines); };
+  rv_plic.irq_out = [&](uint32_t lines) {
+    core.set_line(Iss::IRQ_MEI, lines & 1);
+    core.set_line(Iss::IRQ_MSI, lines & 2);
+  };
+#endif
+
+  bool     exit_valid = false;
+  uint32_t exit_value = 0;
+  soc_ctrl.on_exit = [&](uint32_t value) {
+    exit_valid = true;
+    exit_value = value;
+    core.halt();
+  };
+
+  // the first write of SCRATCH stops the platform, its state is then given to the RTL
+  bool switched = false;
+  if (!vp_switch.empty()) {
+    soc_ctrl.on_scratch = [&](uint32_t value) {
+      switched = true;
+      core.halt();
+    };
+  }
+
+  XHEEP_FirmwareLoader loader([&](uint32_t addr, uint32_t data) {
+    if (addr >= ram_base && addr - ram_base <= ram_size - 4)
+      memcpy(&ram.data[addr - ram_base], &data, 4);
+    else
+      std::cout<<"[VP]: WARNING: the firmware word at 0x"<<std::hex<<addr<<std::dec<<" is outside the RAM"<<std::endl;
+  });
+  if (!loader.load(firmware)) {
+    std::cout<<"[VP]: ERROR: cannot load "<<firmware<<std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::cout<<"[VP]: "<<loader.get_loaded_words()<<" words loaded"<<std::endl;
+
+  // as after the boot ROM, the core starts at the boot address of the firmware
+  core.iss->reset(soc_ctrl.reg(SOC_CTRL_BOOT_ADDRESS_REG_OFFSET));
+  core.max_cycles = max_cycles;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  sc_start();
+  double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  Iss* iss = core.iss;
+  bool state_written = false;
+  if (switched) {
+    state_written = writeSwitchState(vp_switch, iss, ram, ram_base, targets, (uint64_t)(sc_time_stamp() / clk_period));
+    if (state_written)
+      std::cout<<"[VP]: switch to the RTL at cycle "<<iss->elapsed<<", state written to "<<vp_switch<<std::endl;
+    else
+      std::cout<<"[VP]: ERROR: cannot write "<<vp_switch<<std::endl;
+  } else if (exit_valid)
+    std::cout<<"Program Finished with value "<<exit_value<<std::endl;
+  else if (iss->wfi)
+    std::cout<<"[VP]: the core waits for an interrupt that no model will raise"<<std::endl;
+  else
+    std::cout<<"[VP]: stopped after "<<iss->elapsed<<" cycles at pc 0x"<<std::hex<<iss->pc<<std::dec<<std::endl;
+
+  double mips = wall_time > 0 ? iss->instret / wall_time / 1e6 : 0.0;
+  std::cout<<"[VP]: "<<iss->instret<<" instructions in "<<wall_time<<" s, "<<mips<<" MIPS"<<std::endl;
+
+  std::ofstream json(perf_json);
+  if (json.is_open()) {
+    uint64_t dma_transactions = 0, dma_units = 0;
+    for (int ch = 0; ch < DMA_CH_NUM; ch++) {
+      dma_transactions += dma[ch]->transactions;
+      dma_units        += dma[ch]->units;
+    }
+    json<<"{"<<std::endl;
+    json<<"  \"exit_valid\": "<<(exit_valid ? "true" : "false")<<","<<std::endl;
+    json<<"  \"exit_value\": "<<exit_value<<","<<std::endl;
+    json<<"  \"cycles\": "<<(uint64_t)(sc_time_stamp() / clk_period)<<","<<std::endl;
+    json<<"  \"core\": { \"mcycle\": "<<iss->elapsed<<", \"minstret\": "<<iss->instret
+        <<", \"traps\": "<<iss->traps<<" },"<<std::endl;
+    json<<"  \"dma\": { \"transactions\": "<<dma_transactions<<", \"units\": "<<dma_units<<" },"<<std::endl;
+    json<<"  \"wall_time_s\": "<<wall_time<<","<<std::endl;
+    json<<"  \"mips\": "<<mips<<std::endl;
+    json<<"}"<<std::endl;
+  } else {
+    std::cout<<"[VP]: ERROR: cannot write "<<perf_json<<std::endl;
+  }
+
+  for (int ch = 0; ch < DMA_CH_NUM; ch++)
+    delete dma[ch];
+  delete cmd_lines_options;
+
+  if (switched)
+    return state_written ? EXIT_SUCCESS : EXIT_FAILURE;
+  return exit_valid && exit_value == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+############################################################
+#  This module generates, from the hjson description of an #
+#  accelerator, the SystemVerilog wrapper that puts it     #
+#  behind the standard command queue of hw/ip/acc_cmdq and #
+#  its typed C driver on top of acc_cmdq.h.                #
+############################################################
+
+import argparse
+import os
+import string
+import sys
+from datetime import date
+
+import hjson
+
+# Registers of the command queue: 8 arguments fit in front of the end of the
+# 0x100 window of an external peripheral
+max_args = 8
+
+tab_spaces = "  "
+
+templates_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "hw", "ip", "acc_cmdq", "data")
+
+
+def read_json(json_file):
+    """
+    Opens the json file taken as input and returns its content
+    """
+    with open(json_file) as f:
+        return hjson.load(f)
+
+
+def write_template(tpl, fields):
+    """
+    Opens a given template and substitutes its fields.
+    Returns a string with the content of the updated template
+    """
+    with open(tpl) as t:
+        template = string.Template(t.read())
+
+    return template.substitute(fields)
+
+
+def write_output(out_file, out_string):
+    """
+    Writes the final out_string into the specified out_file
+    """
+    with open(out_file, "w") as f:
+        f.write(out_string)
+
+
+def camel_case(name):
+    """
+    simple_accelerator -> SimpleAccelerator
+    """
+    return "".join(word.capitalize() for word in name.split("_"))
+
+
+def check(cfg):
+    """
+    Checks the description and fills in the optional fields
+    """
+    for key in ["name", "id", "start_address", "args", "opcodes"]:
+        if key not in cfg:
+            sys.exit("accgen: missing '{}' in the description".format(key))
+
+    if not 1 <= len(cfg["args"]) <= max_args:
+        sys.exit("accgen: an accelerator takes 1 to {} arguments".format(max_args))
+
+    for op in cfg["opcodes"]:
+        if not 0 <= int(op["value"]) <= 255:
+            sys.exit("accgen: opcode '{}' does not fit in 8 bits".format(op["name"]))
+
+    cfg.setdefault("cmd_depth", 4)
+    cfg.setdefault("cpl_depth", 4)
+    cfg.setdefault("irq", "0")
+    cfg.setdefault("type_params", [])
+    cfg.setdefault("ports", [])
+
+    cfg["id"] = "{:08X}".format(int(str(cfg["id"]), 0))
+    return cfg
+
+
+def fields_of(cfg, description_file):
+    """
+    Builds the fields of the templates from the description
+    """
+    name = cfg["name"]
+    args = cfg["args"]
+
+    type_params = "".join(",\n    parameter type {} = logic".format(t) for t in cfg["type_params"])
+    type_param_connections = "".join(",\n      .{0}({0})".format(t) for t in cfg["type_params"])
+
+    port_declarations = "".join("\n    {:<6} {} {},".format(p["dir"], p.get("type", "logic"), p["name"])
+                                for p in cfg["ports"])
+    if port_declarations:
+        port_declarations += "\n"
+    port_connections = "".join(",\n      .{0}({0})".format(p["name"]) for p in cfg["ports"])
+
+    arg_connections = "\n".join("      .cmd_{}_i(cmd_args[{}]),".format(a["name"], i) for i, a in enumerate(args))
+
+    opcode_entries = "\n".join("{}k{}Op{} = {},{}".format(tab_spaces, camel_case(name), camel_case(op["name"]),
+                                                        op["value"],
+                                                        "  /*!< {} */".format(op["desc"]) if "desc" in op else "")
+                               for op in cfg["opcodes"])
+    arg_entries = "\n".join("{}uint32_t {};{}".format(tab_spaces, a["name"],
+                                                      "  /*!< {} */".format(a["desc"]) if "desc" in a else "")
+                            for a in args)
+    arg_words = "\n".join("{}{}args->{},".format(tab_spaces, tab_spaces, a["name"]) for a in args)
+
+    return {
+        "name": name,
+        "NAME": name.upper(),
+        "description_file": description_file,
+        "date": date.today().strftime("%d/%m/%Y"),
+        "id": cfg["id"],
+        "num_args": len(args),
+        "num_args_minus_one": len(args) - 1,
+        "cmd_depth": cfg["cmd_depth"],
+        "cpl_depth": cfg["cpl_depth"],
+        "start_address": cfg["start_address"],
+        "irq": cfg["irq"],
+        "type_params": type_params,
+        "type_param_connections": type_param_connections,
+        "port_declarations": port_declarations,
+        "port_connections": port_connections,
+        "arg_connections": arg_connections,
+        "opcode_entries": opcode_entries,
+        "arg_entries": arg_entries,
+        "arg_words": arg_words,
+    }
+
+
+def main(arg_vect):
+
+    parser = argparse.ArgumentParser(prog="accgen",
+                                     description="Given the hjson description of an accelerator, generates the "
+                                                 "wrapper putting it behind the standard command queue and its "
+                                                 "typed C driver.")
+    parser.add_argument("--cfg", required=True,
+                        help="hjson description of the accelerator")
+    parser.add_argument("--outdir_hw", required=True,
+                        help="folder of the generated <name>_cmdq.sv")
+    parser.add_argument("--outdir_sw", required=True,
+                        help="folder of the generated <name>.h and <name>.c")
+
+    args = parser.parse_args(arg_vect)
+
+    cfg = check(read_json(args.cfg))
+    fields = fields_of(cfg, os.path.relpath(args.cfg))
+    name = cfg["name"]
+
+    os.makedirs(args.outdir_hw, exist_ok=True)
+    os.makedirs(args.outdir_sw, exist_ok=True)
+
+    write_output(os.path.join(args.outdir_hw, name + "_cmdq.sv"),
+                 write_template(os.path.join(templates_dir, "acc_wrapper.sv.tpl"), fields))
+    write_output(os.path.join(args.outdir_sw, name + ".h"),
+                 write_template(os.path.join(templates_dir, "acc_driver.h.tpl"), fields))
+    write_output(os.path.join(args.outdir_sw, name + ".c"),
+                 write_template(os.path.join(templates_dir, "acc_driver.c.tpl"), fields))
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Profile-guided optimisation of an application, driven by the simulation (make app-pgo).
+#
+# The application is built and simulated three times on the current MCU (make mcu-gen) and
+# Verilator model (make verilator-sim):
+#   base       the build without PGO, the reference of the cycles
+#   generate   make app PGO=generate, the edge counters are serialised at exit into the gcov_dump
+#              buffer of sw/device/lib/runtime/gcov_dump.h, which the testharness copies to a
+#              file with +mem_dump; gcov-tool merge-stream turns it into the .gcda files
+#   use        make app PGO=use, optimised with these .gcda files
+# The samples of the profile are the inputs the application runs in simulation, so it is only
+# as representative as they are.
+
+import argparse
+import json
+import os
+import pathlib
+import shutil
+import struct
+import subprocess
+import sys
+
+from app_profiles import ROOT, SIM_DIR, elf_sizes, make
+
+GCOV_DUMP_MAGIC = 0x50444347
+GCOV_DUMP_HEADER = 16
+
+
+def elf_symbol(path, symbol):
+    """Return the address and size of a symbol of a 32-bit little-endian ELF, None if it is not there."""
+    elf = pathlib.Path(path).read_bytes()
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+
+    def section(i):
+        # name, type, flags, addr, offset, size, link
+        return struct.unpack_from("<IIIIIII", elf, shoff + i * shentsize)
+
+    for i in range(shnum):
+        _, sh_type, _, _, offset, size, link = section(i)
+        if sh_type != 2:  # SHT_SYMTAB
+            continue
+        strtab_off = section(link)[4]
+        for s in range(offset, offset + size, 16):
+            name, value, sym_size, _, _, _ = struct.unpack_from("<IIIBBH", elf, s)
+            end = elf.index(b"\0", strtab_off + name)
+            if elf[strtab_off + name:end] == symbol.encode():
+                return value, sym_size
+    return None
+
+
+def simulate(name, outdir, timeout, extra=()):
+    """Simulate sw/build/main.hex, return the counters of perf_counters.json or the reason of the failure."""
+    perf = outdir / "perf-{}.json".format(name)
+    try:
+        with open(outdir / "sim-{}.log".format(name), "w") as out:
+            subprocess.run(["./Vtestharness", "+firmware=" + str(ROOT / "sw" / "build" / "main.hex"),
+                            "+trace=off", "+perf_json=" + str(perf)] + list(extra), cwd=SIM_DIR, stdout=out,
+                           stderr=subprocess.STDOUT, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return None, "timeout"
+    try:
+        counters = json.loads(perf.read_text())
+    except (OSError, ValueError):
+        return None, "no_counters"
+    if not counters["exit_valid"] or counters["exit_value"] != 0:
+        return counters, "fail"
+    return counters, "pass"
+
+
+def read_gcov_dump(path):
+    """Return the gcov stream of a +mem_dump of the gcov_dump buffer."""
+    dump = pathlib.Path(path).read_bytes()
+    if len(dump) < GCOV_DUMP_HEADER:
+        sys.exit("{}: truncated memory dump".format(path))
+    magic, length, overflow, objects = struct.unpack_from("<IIII", dump, 0)
+    if magic != GCOV_DUMP_MAGIC:
+        sys.exit("{}: the counters were not dumped, did the application reach exit()?".format(path))
+    if overflow:
+        sys.exit("{}: the counters of {} objects take {} bytes, rebuild with PGO_DUMP_SIZE={} (--dump-size)".format(
+            path, objects, length + overflow, (length + overflow + 1023) // 1024 * 1024))
+    return dump[GCOV_DUMP_HEADER:GCOV_DUMP_HEADER + length]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Profile-guided optimisation of an application in simulation")
+    parser.add_argument("--app", required=True, help="application of sw/applications")
+    parser.add_argument("--profile", default="default", help="build preset of make app PROFILE=<profile>")
+    parser.add_argument("--make-args", nargs="*", default=[], help="other variables of make app, e.g. ARCH=rv32imc")
+    parser.add_argument("--dump-size", type=int, help="bytes of the RAM buffer of the counters (PGO_DUMP_SIZE)")
+    parser.add_argument("--gcov-tool", help="gcov-tool of the toolchain (default $RISCV/bin/<prefix>elf-gcov-tool)")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="app_pgo", help="folder of the logs, profile and results")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir / args.app).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    pgo_dir = outdir / "gcda"
+    build_args = ["PROJECT=" + args.app, "PROFILE=" + args.profile] + args.make_args
+
+    gcov_tool = args.gcov_tool
+    if not gcov_tool:
+        riscv = os.path.expanduser(os.environ.get("RISCV", "~/.riscv"))
+        prefix = next((a.split("=", 1)[1] for a in args.make_args if a.startswith("COMPILER_PREFIX=")),
+                      "riscv32-unknown-")
+        gcov_tool = os.path.join(riscv, "bin", prefix + "elf-gcov-tool")
+
+    runs = {}
+
+    def build_and_run(name, pgo_args, sim_args=lambda: []):
+        entry = {"build": name}
+        runs[name] = entry
+        if not make("app", *build_args, *pgo_args, log=outdir / "app-{}.log".format(name)):
+            sys.exit("{}: make app failed, see {}".format(name, outdir / "app-{}.log".format(name)))
+        entry.update(elf_sizes(ROOT / "sw" / "build" / "main.elf"))
+        counters, entry["status"] = simulate(name, outdir, args.timeout, sim_args())
+        if entry["status"] != "pass":
+            sys.exit("{}: simulation {}, see {}".format(name, entry["status"], outdir / "sim-{}.log".format(name)))
+        entry["cycles"] = counters["cycles"]
+        print("{:9} text {:7} data {:6} bss {:6} cycles {:10}".format(
+            name, entry["text"], entry["data"], entry["bss"], entry["cycles"]))
+
+    build_and_run("base", [])
+
+    # the counters of an earlier run would be merged with the new ones
+    shutil.rmtree(pgo_dir, ignore_errors=True)
+    pgo_dir.mkdir(parents=True)
+    dump = outdir / "gcov_dump.bin"
+
+    def dump_args():
+        symbol = elf_symbol(ROOT / "sw" / "build" / "main.elf", "gcov_dump")
+        if symbol is None:
+            sys.exit("gcov_dump is not in the instrumented ELF, is the toolchain GCC 13 or later?")
+        return ["+mem_dump=" + str(dump), "+mem_dump_addr={:x}".format(symbol[0]), "+mem_dump_size={}".format(symbol[1])]
+
+    build_and_run("generate", ["PGO=generate", "PGO_DIR=" + str(pgo_dir)] +
+                  (["PGO_DUMP_SIZE={}".format(args.dump_size)] if args.dump_size else []), dump_args)
+
+    stream = outdir / "profile.gcfn"
+    stream.write_bytes(read_gcov_dump(dump))
+    with open(outdir / "gcov-tool.log", "w") as out:
+        if subprocess.run([gcov_tool, "merge-stream", str(stream)], stdout=out, stderr=subprocess.STDOUT).returncode:
+            sys.exit("gcov-tool merge-stream failed, see {}".format(outdir / "gcov-tool.log"))
+    gcda = sorted(pgo_dir.glob("*.gcda"))
+    print("{} .gcda files in {}".format(len(gcda), pgo_dir))
+
+    build_and_run("use", ["PGO=use", "PGO_DIR=" + str(pgo_dir)])
+
+    base, use = runs["base"], runs["use"]
+    delta = use["cycles"] - base["cycles"]
+    with open(outdir / "results.json", "w") as f:
+        json.dump({"app": args.app, "profile": args.profile, "runs": list(runs.values()), "cycle_delta": delta}, f,
+                  indent=2)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("{} (PROFILE={})\n\n".format(args.app, args.profile))
+        f.write("| build | text | data | bss | cycles |\n")
+        f.write("|-------|------|------|-----|--------|\n")
+        for r in runs.values():
+            f.write("| {} | {} | {} | {} | {} |\n".format(r["build"], r["text"], r["data"], r["bss"], r["cycles"]))
+        f.write("\nPGO: {:+d} cycles ({:+.2f}%), {:+d} bytes of text\n".format(
+            delta, 100.0 * delta / base["cycles"], use["text"] - base["text"]))
+    print(open(outdir / "results.md").read())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Text, data and cycles of applications with every build preset (make app PROFILE=<profile>).
+#
+# Every application is built with every preset on the current MCU (make mcu-gen) and simulated
+# on the Verilator model, which must already be built (make verilator-sim). The sizes are read
+# from the section headers of the ELF and the cycles from the perf_counters.json of the
+# testharness. The table also gives the fastest and the smallest preset of each application.
+
+import argparse
+import json
+import pathlib
+import struct
+import subprocess
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+SIM_DIR = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0" / "sim-verilator"
+
+PROFILES = ["default", "speed", "size", "balanced"]
+APPS = ["hello_world", "coremark", "example_matmul", "example_kernels_int", "example_dsp"]
+
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+SHT_NOBITS = 8
+
+
+def make(*args, log):
+    cmd = ["make", "-C", str(ROOT), "--no-print-directory"] + list(args)
+    with open(log, "w") as out:
+        return subprocess.run(cmd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def elf_sizes(path):
+    """Return the text, data and bss sizes of a 32-bit little-endian ELF, like size(1)."""
+    elf = pathlib.Path(path).read_bytes()
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+    sizes = {"text": 0, "data": 0, "bss": 0}
+    for i in range(shnum):
+        _, sh_type, flags, _, _, size = struct.unpack_from("<IIIIII", elf, shoff + i * shentsize)
+        if not flags & SHF_ALLOC:
+            continue
+        if sh_type == SHT_NOBITS:
+            sizes["bss"] += size
+        elif flags & SHF_EXECINSTR or not flags & SHF_WRITE:
+            sizes["text"] += size
+        else:
+            sizes["data"] += size
+    return sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Text, data and cycles of applications per build preset")
+    parser.add_argument("--apps", nargs="+", default=APPS, help="applications of sw/applications")
+    parser.add_argument("--profiles", nargs="+", default=PROFILES, choices=PROFILES)
+    parser.add_argument("--make-args", nargs="*", default=[], help="other variables of make app, e.g. LINKER=flash_load")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="app_profiles", help="folder of the logs and results")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    runs = []
+
+    for app in args.apps:
+        for profile in args.profiles:
+            entry = {"app": app, "profile": profile}
+            runs.append(entry)
+            name = "{}-{}".format(app, profile)
+            if not make("app", "PROJECT=" + app, "PROFILE=" + profile, *args.make_args, log=outdir / "app-{}.log".format(name)):
+                entry["status"] = "build_fail"
+                print("{:40} {:9} build failed".format(app, profile))
+                continue
+            entry.update(elf_sizes(ROOT / "sw" / "build" / "main.elf"))
+
+            perf = outdir / "perf-{}.json".format(name)
+            try:
+                with open(outdir / "sim-{}.log".format(name), "w") as out:
+                    subprocess.run(["./Vtestharness", "+firmware=" + str(ROOT / "sw" / "build" / "main.hex"),
+                                    "+trace=off", "+perf_json=" + str(perf)], cwd=SIM_DIR, stdout=out,
+                                   stderr=subprocess.STDOUT, timeout=args.timeout)
+            except subprocess.TimeoutExpired:
+                entry["status"] = "timeout"
+                continue
+            try:
+                counters = json.loads(perf.read_text())
+            except (OSError, ValueError):
+                entry["status"] = "no_counters"
+                continue
+            entry["status"] = "pass" if counters["exit_valid"] and counters["exit_value"] == 0 else "fail"
+            entry["cycles"] = counters["cycles"]
+            print("{:40} {:9} text {:7} data {:6} bss {:6} cycles {:10} {}".format(
+                app, profile, entry["text"], entry["data"], entry["bss"], entry["cycles"], entry["status"]))
+
+    with open(outdir / "results.json", "w") as f:
+        json.dump({"runs": runs}, f, indent=2)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("| application | preset | text | data | bss | cycles | status |\n")
+        f.write("|-------------|--------|------|------|-----|--------|--------|\n")
+        for r in runs:
+            f.write("| {} | {} | {} | {} | {} | {} | {} |\n".format(
+                r["app"], r["profile"], r.get("text", "-"), r.get("data", "-"), r.get("bss", "-"),
+                r.get("cycles", "-"), r["status"]))
+        f.write("\n| application | fastest | smallest |\n")
+        f.write("|-------------|---------|----------|\n")
+        for app in args.apps:
+            ok = [r for r in runs if r["app"] == app and r["status"] == "pass"]
+            if not ok:
+                f.write("| {} | - | - |\n".format(app))
+                continue
+            fastest = min(ok, key=lambda r: r["cycles"])
+            smallest = min(ok, key=lambda r: r["text"] + r["data"])
+            f.write("| {} | {} ({} cycles) | {} ({} bytes) |\n".format(
+                app, fastest["profile"], fastest["cycles"], smallest["profile"], smallest["text"] + smallest["data"]))
+    print(open(outdir / "results.md").read())
+
+    sys.exit(0 if all(r["status"] == "pass" for r in runs) else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# CoreMark/MHz of every CPU and bus type, in one table.
+#
+# For every (CPU, bus), the MCU is generated with configs/coremark.hjson (code and data in
+# separate banks) and the Verilator model is built, then coremark is built with every
+# optimization (COREMARK_OPT) and simulated. The time of coremark is counted with mcycle and
+# normalized to a 1 MHz clock, so its Iterations/Sec is the CoreMark/MHz. On the CPUs with the
+# CORE-V extensions, the tuned build also uses them (COREV_PULP=1 and the CORE-V compiler).
+
+import argparse
+import json
+import pathlib
+import re
+import subprocess
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+SIM_DIR = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0" / "sim-verilator"
+
+SCORE_RE = re.compile(r"Iterations/Sec\s*:\s*([0-9.]+)")
+TICKS_RE = re.compile(r"Total ticks\s*:\s*(\d+)")
+BANK_RE = re.compile(r"(Code|Data|Stack) bank\s*:\s*(-?\d+)")
+
+CPUS = ["cv32e20", "cv32e40p", "cv32e40x", "cv32e40px"]
+BUSES = ["onetoM", "NtoM"]
+OPTS = ["base", "tuned"]
+
+# ISA of the tuned build of the CPUs with the CORE-V (Xpulp) extensions
+XPULP = {
+    "cv32e40px": "rv32imc_zicsr_zifencei_xcvhwlp_xcvmem_xcvmac_xcvbi_xcvalu_xcvsimd_xcvbitmanip",
+}
+
+
+def make(*args, log):
+    cmd = ["make", "-C", str(ROOT), "--no-print-directory"] + list(args)
+    with open(log, "w") as out:
+        return subprocess.run(cmd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CoreMark/MHz per CPU and bus type")
+    parser.add_argument("--cpus", nargs="+", default=CPUS, choices=CPUS)
+    parser.add_argument("--buses", nargs="+", default=BUSES, choices=BUSES)
+    parser.add_argument("--opts", nargs="+", default=OPTS, choices=OPTS)
+    parser.add_argument("--config", default="configs/coremark.hjson", help="X-HEEP configuration")
+    parser.add_argument("--corev-prefix", default="riscv32-corev-", help="COMPILER_PREFIX of the CORE-V compiler")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="coremark_table", help="folder of the logs and results")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    runs = []
+
+    for cpu in args.cpus:
+        # A model with the CORE-V extensions is only built when a tuned build uses them
+        pulps = [False, True] if cpu in XPULP and "tuned" in args.opts else [False]
+        for bus in args.buses:
+            for pulp in pulps:
+                name = "{}-{}{}".format(cpu, bus, "-xpulp" if pulp else "")
+                print("Building the model " + name)
+                ok = make("mcu-gen", "X_HEEP_CFG=" + args.config, "CPU=" + cpu, "BUS=" + bus,
+                          log=outdir / "mcu-gen-{}.log".format(name))
+                ok = ok and make("verilator-sim", "FUSESOC_PARAM=--COREV_PULP={}".format(int(pulp)),
+                                 log=outdir / "verilator-sim-{}.log".format(name))
+                for opt in args.opts:
+                    # the base build runs on the plain model, the tuned one on the Xpulp model if any
+                    if pulp != (opt == "tuned" and cpu in XPULP):
+                        continue
+                    entry = {"cpu": cpu, "bus": bus, "opt": opt, "xpulp": pulp}
+                    runs.append(entry)
+                    if not ok:
+                        entry["status"] = "no_model"
+                        continue
+                    app_args = ["app", "PROJECT=coremark", "COREMARK_OPT=" + opt]
+                    if pulp:
+                        app_args += ["COMPILER_PREFIX=" + args.corev_prefix, "ARCH=" + XPULP[cpu]]
+                    if not make(*app_args, log=outdir / "app-{}-{}.log".format(name, opt)):
+                        entry["status"] = "app_build_fail"
+                        continue
+                    log = outdir / "sim-{}-{}.log".format(name, opt)
+                    try:
+                        with open(log, "w") as out:
+                            subprocess.run(["./Vtestharness", "+firmware=" + str(ROOT / "sw" / "build" / "main.hex"),
+                                            "+trace=off"], cwd=SIM_DIR, stdout=out, stderr=subprocess.STDOUT,
+                                           timeout=args.timeout)
+                    except subprocess.TimeoutExpired:
+                        entry["status"] = "timeout"
+                        continue
+                    uart = (SIM_DIR / "uart0.log").read_text(errors="replace")
+                    (outdir / "uart-{}-{}.log".format(name, opt)).write_text(uart)
+                    score = SCORE_RE.search(uart)
+                    ticks = TICKS_RE.search(uart)
+                    entry["status"] = "pass" if score and "Correct operation validated" in uart else "fail"
+                    if score:
+                        entry["coremark_per_mhz"] = float(score.group(1))
+                    if ticks:
+                        entry["cycles"] = int(ticks.group(1))
+                    for m in BANK_RE.finditer(uart):
+                        entry[m.group(1).lower() + "_bank"] = int(m.group(2))
+                    print("{:10} {:7} {:6} {}".format(cpu, bus, opt, "{:.3f} CoreMark/MHz".format(
+                        entry["coremark_per_mhz"]) if score else entry["status"]))
+
+    with open(outdir / "results.json", "w") as f:
+        json.dump({"config": args.config, "runs": runs}, f, indent=2)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("| CPU | bus | build | CoreMark/MHz | cycles | code bank | data bank | stack bank |\n")
+        f.write("|-----|-----|-------|--------------|--------|-----------|-----------|------------|\n")
+        for r in runs:
+            build = r["opt"] + (" (Xpulp)" if r["xpulp"] else "")
+            if "coremark_per_mhz" not in r:
+                f.write("| {} | {} | {} | {} | - | - | - | - |\n".format(r["cpu"], r["bus"], build, r["status"]))
+                continue
+            f.write("| {} | {} | {} | {:.3f} | {} | {} | {} | {} |\n".format(
+                r["cpu"], r["bus"], build, r["coremark_per_mhz"], r.get("cycles", "-"),
+                r.get("code_bank", "-"), r.get("data_bank", "-"), r.get("stack_bank", "-")))
+    print(open(outdir / "results.md").read())
+
+    sys.exit(0 if all(r["status"] == "pass" for r in runs) else 1)
+
+
+if __name__ == "__main__":
+    main()
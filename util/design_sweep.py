@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Design space sweep: cycles of a set of applications against an area proxy, for every
+# combination of CPU, bus, number and size of the RAM banks and interleaved banks.
+#
+# Every point is an x_heep_gen system built by system() below and checked with validate()
+# before anything is generated. The MCU is generated from a configuration script calling
+# system() with the parameters of the point (make mcu-gen X_HEEP_CFG=<script>), so that
+# each point has its own configuration hash and its own folder of Verilator models.
+#
+# The generated files are shared by mcu-gen, the model and the applications, so each of
+# the --jobs workers uses its own copy of the tree in build/design_sweep/tree<N>, made once
+# (--refresh-trees copies them again after a change of the sources). A point always goes to
+# the same worker, so a second sweep reuses the models of the first one.
+#
+# The area proxy is the sum of the CPU, the RAM, a cost per bank and the crossbar, from the
+# AREA table below in kGE: it only ranks the points and should be replaced with figures of
+# the target technology (--area-model <json>) for anything else.
+
+import argparse
+import concurrent.futures
+import itertools
+import json
+import math
+import pathlib
+import shutil
+import subprocess
+import sys
+
+from x_heep_gen.linker_section import LinkerSection
+from x_heep_gen.system import XHeep, BusType
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+TREES = ROOT / "build" / "design_sweep"
+SIM_DIR = pathlib.PurePath("build", "openhwgroup.org_systems_core-v-mini-mcu_0", "sim-verilator")
+
+CPUS = ["cv32e20", "cv32e40p", "cv32e40x", "cv32e40px"]
+BUSES = ["onetoM", "NtoM"]
+APPS = ["coremark", "example_matmul"]
+
+# Rough area in kGE, the CPUs without their optional units
+AREA = {
+    "cpu": {"cv32e20": 20, "cv32e40p": 50, "cv32e40x": 40, "cv32e40px": 60},
+    "ram_per_kib": 8,
+    "bank": 5,
+    "xbar_port": {"onetoM": 0.5, "NtoM": 2},
+}
+
+CONFIG_SCRIPT = """\
+# Point {name} of util/design_sweep.py
+import design_sweep
+
+
+def config():
+    return design_sweep.system({bus!r}, {banks}, {bank_size}, {il_banks}, {il_size})
+"""
+
+
+def system(bus, banks, bank_size, il_banks, il_size):
+    """Returns the built x_heep_gen system of a point, or raises an error if it is not valid.
+
+    The code has the first bank and the data the others, as in configs/coremark.hjson, or
+    the halves of the bank if there is only one. The interleaved banks, if any, have their
+    own data_interleaved section.
+    """
+    system = XHeep(BusType(bus))
+    system.add_ram_banks([bank_size] * banks)
+    if il_banks:
+        system.add_ram_banks_il(il_banks, il_size, "data_interleaved")
+
+    code_size = bank_size * 1024 if banks > 1 else bank_size * 512
+    system.add_linker_section(LinkerSection.by_size("code", 0, code_size))
+    system.add_linker_section(LinkerSection("data", code_size, banks * bank_size * 1024))
+
+    system.build()
+    if not system.validate():
+        raise RuntimeError("invalid configuration")
+    return system
+
+
+def area(point, model):
+    masters = 4  # core instruction and data, debug and DMA
+    slaves = point["banks"] + point["il_banks"]
+    return (model["cpu"][point["cpu"]] + model["ram_per_kib"] * point["ram_kib"] + model["bank"] * slaves
+            + model["xbar_port"][point["bus"]] * masters * slaves)
+
+
+def make(tree, *args, log):
+    cmd = ["make", "-C", str(tree), "--no-print-directory"] + list(args)
+    with open(log, "w") as out:
+        return subprocess.run(cmd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def copy_tree(tree, outdir, refresh):
+    if tree.exists() and not refresh:
+        return
+    shutil.rmtree(tree, ignore_errors=True)
+    skip = {ROOT / ".git", ROOT / "build", ROOT / "sw" / "build", outdir}
+    shutil.copytree(ROOT, tree, symlinks=True,
+                    ignore=lambda d, names: [n for n in names if pathlib.Path(d) / n in skip])
+
+
+def run_point(tree, point, args):
+    """Generates the MCU of point in tree, builds its model and simulates the applications"""
+    pdir = point["dir"]
+    pdir.mkdir(parents=True, exist_ok=True)
+    config = pdir / "config.py"
+    config.write_text(CONFIG_SCRIPT.format(**point))
+
+    if not (make(tree, "mcu-gen", "X_HEEP_CFG=" + str(config), "CPU=" + point["cpu"], "BUS=" + point["bus"],
+                 log=pdir / "mcu-gen.log")
+            and make(tree, "verilator-sim", log=pdir / "verilator-sim.log")):
+        point["status"] = "no_model"
+        return point
+    point["hash"] = (tree / "build" / ".mcu_gen" / "config_hash").read_text().strip()
+
+    point["status"] = "pass"
+    for app in args.apps:
+        if not make(tree, "app", "PROJECT=" + app, *args.make_args, log=pdir / "app-{}.log".format(app)):
+            point["cycles"][app] = "build_fail"
+            point["status"] = "fail"
+            continue
+        perf = pdir / "perf-{}.json".format(app)
+        try:
+            with open(pdir / "sim-{}.log".format(app), "w") as out:
+                subprocess.run(["./Vtestharness", "+firmware=" + str(tree / "sw" / "build" / "main.hex"),
+                                "+trace=off", "+perf_json=" + str(perf)], cwd=tree / SIM_DIR, stdout=out,
+                               stderr=subprocess.STDOUT, timeout=args.timeout)
+            counters = json.loads(perf.read_text())
+        except subprocess.TimeoutExpired:
+            counters = {"exit_valid": False, "status": "timeout"}
+        except (OSError, ValueError):
+            counters = {"exit_valid": False, "status": "no_counters"}
+        if counters["exit_valid"] and counters["exit_value"] == 0:
+            point["cycles"][app] = counters["cycles"]
+        else:
+            point["cycles"][app] = counters.get("status", "fail")
+            point["status"] = "fail"
+    print("{:40} {}".format(point["name"], point["status"]))
+    return point
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cycles against area of a sweep of X-HEEP configurations")
+    parser.add_argument("--cpus", nargs="+", default=["cv32e20", "cv32e40p"], choices=CPUS)
+    parser.add_argument("--buses", nargs="+", default=BUSES, choices=BUSES)
+    parser.add_argument("--banks", nargs="+", type=int, default=[2, 4], help="numbers of contiguous RAM banks")
+    parser.add_argument("--bank-sizes", nargs="+", type=int, default=[32, 64], help="sizes of the RAM banks in KiB")
+    parser.add_argument("--il-banks", nargs="+", type=int, default=[0, 2], help="numbers of interleaved banks, NtoM only")
+    parser.add_argument("--il-size", type=int, default=32, help="size of the interleaved banks in KiB")
+    parser.add_argument("--apps", nargs="+", default=APPS, help="applications of sw/applications")
+    parser.add_argument("--make-args", nargs="*", default=[], help="other variables of make app, e.g. PROFILE=speed")
+    parser.add_argument("--area-model", help="json file replacing the AREA table of util/design_sweep.py")
+    parser.add_argument("--jobs", type=int, default=1, help="number of points built and simulated in parallel")
+    parser.add_argument("--refresh-trees", action="store_true", help="copy the sources to the workers again")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="design_sweep", help="folder of the logs and results")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    model = json.loads(pathlib.Path(args.area_model).read_text()) if args.area_model else AREA
+
+    points = []
+    for cpu, bus, banks, bank_size, il_banks in itertools.product(
+            args.cpus, args.buses, args.banks, args.bank_sizes, args.il_banks):
+        name = "{}-{}-{}x{}k{}".format(cpu, bus, banks, bank_size,
+                                       "-il{}x{}k".format(il_banks, args.il_size) if il_banks else "")
+        try:
+            system(bus, banks, bank_size, il_banks, args.il_size)
+        except Exception as e:
+            print("{:40} skipped: {}".format(name, e))
+            continue
+        point = {"name": name, "cpu": cpu, "bus": bus, "banks": banks, "bank_size": bank_size,
+                 "il_banks": il_banks, "il_size": args.il_size if il_banks else 0, "cycles": {}}
+        point["ram_kib"] = banks * bank_size + il_banks * point["il_size"]
+        point["area"] = area(point, model)
+        point["dir"] = outdir / name
+        points.append(point)
+    if not points:
+        sys.exit("No valid configuration in the sweep")
+
+    # the points of a worker run one after the other in its tree
+    jobs = max(1, min(args.jobs, len(points)))
+    trees = [TREES / "tree{}".format(i) for i in range(jobs)]
+    for tree in trees:
+        copy_tree(tree, outdir, args.refresh_trees)
+
+    def worker(i):
+        return [run_point(trees[i], p, args) for p in points[i::jobs]]
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        list(pool.map(worker, range(jobs)))
+
+    # cycles of each application relative to the fastest point, their geometric mean is the score
+    passed = [p for p in points if p["status"] == "pass"]
+    for p in passed:
+        ratios = [p["cycles"][app] / min(q["cycles"][app] for q in passed) for app in args.apps]
+        p["score"] = math.exp(sum(math.log(r) for r in ratios) / len(ratios))
+    for p in passed:
+        p["pareto"] = not any(q["area"] <= p["area"] and q["score"] <= p["score"]
+                              and (q["area"] < p["area"] or q["score"] < p["score"]) for q in passed)
+
+    for p in points:
+        p["dir"] = str(p["dir"])
+    with open(outdir / "results.json", "w") as f:
+        json.dump({"area_model": model, "apps": args.apps, "points": points}, f, indent=2)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("| configuration | RAM KiB | area | {} | relative cycles | Pareto |\n".format(" | ".join(args.apps)))
+        f.write("|---------------|---------|------|{}|-----------------|--------|\n".format("|".join(["---"] * len(args.apps))))
+        for p in sorted(points, key=lambda p: p["area"]):
+            f.write("| {} | {} | {:.0f} | {} | {} | {} |\n".format(
+                p["name"], p["ram_kib"], p["area"], " | ".join(str(p["cycles"].get(app, "-")) for app in args.apps),
+                "{:.3f}".format(p["score"]) if "score" in p else p["status"], "yes" if p.get("pareto") else ""))
+        f.write("\nPareto front, by area:\n\n")
+        f.write("| configuration | area | relative cycles |\n")
+        f.write("|---------------|------|-----------------|\n")
+        for p in sorted([p for p in passed if p["pareto"]], key=lambda p: p["area"]):
+            f.write("| {} | {:.0f} | {:.3f} |\n".format(p["name"], p["area"], p["score"]))
+    print(open(outdir / "results.md").read())
+
+    sys.exit(0 if len(passed) == len(points) else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Decoder of the deferred logs of sw/device/lib/runtime/dlog.h.
+#
+# The input is a capture of the UART, or a memory dump, holding one or more dumps written by
+# dlog_dump(). Any byte outside of the dumps (e.g. printf output) is skipped. The format
+# strings are read from the .dlog_fmt section of the ELF of the application.
+
+import argparse
+import re
+import struct
+import sys
+
+DUMP_MAGIC = 0x474F4C44
+DUMP_END = 0xFFFFFFFF
+
+# printf conversion, the length modifiers are dropped as all the arguments are 32-bit words
+CONVERSION_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diuxXoc%])")
+
+
+def read_fmt_section(elf_path):
+    """Return the .dlog_fmt section of a 32-bit little-endian ELF and its address."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit(f"{elf_path}: not a 32-bit little-endian ELF")
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def section(i):
+        # name, type, flags, addr, offset, size
+        return struct.unpack_from("<IIIIII", elf, shoff + i * shentsize)
+
+    strtab_off = section(shstrndx)[4]
+    for i in range(shnum):
+        name, _, _, addr, offset, size = section(i)
+        end = elf.index(b"\0", strtab_off + name)
+        if elf[strtab_off + name:end] == b".dlog_fmt":
+            return elf[offset:offset + size], addr
+    sys.exit(f"{elf_path}: no .dlog_fmt section, is DLOG used?")
+
+
+def format_record(fmt, args):
+    """Format a record with printf semantics."""
+    values = iter(args)
+
+    def convert(match):
+        flags, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        value = next(values, 0)
+        if conv in "di":
+            value = value - (1 << 32) if value & 0x80000000 else value
+            conv = "d"
+        elif conv == "u":
+            conv = "d"
+        elif conv == "c":
+            value &= 0xFF
+        return ("%" + flags + conv) % value
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+def decode(data, strings, base):
+    """Yield (timestamp, text) for the records of the dumps in data, and a line per drop count."""
+    pos = 0
+    magic = struct.pack("<I", DUMP_MAGIC)
+    while True:
+        pos = data.find(magic, pos)
+        if pos < 0 or pos + 8 > len(data):
+            return
+        dropped, = struct.unpack_from("<I", data, pos + 4)
+        pos += 8
+        if dropped:
+            yield None, f"[{dropped} records dropped]"
+        while pos + 4 <= len(data):
+            header, = struct.unpack_from("<I", data, pos)
+            if header == DUMP_END:
+                pos += 4
+                break
+            nargs, fmt_id = header >> 28, header & 0x0FFFFFFF
+            if pos + 8 + 4 * nargs > len(data):
+                yield None, "[truncated dump]"
+                return
+            timestamp, = struct.unpack_from("<I", data, pos + 4)
+            args = struct.unpack_from(f"<{nargs}I", data, pos + 8)
+            pos += 8 + 4 * nargs
+
+            offset = fmt_id - (base & 0x0FFFFFFF)
+            if not 0 <= offset < len(strings):
+                yield timestamp, f"[unknown format ID 0x{fmt_id:07x}] {list(args)}"
+                continue
+            fmt = strings[offset:strings.index(b"\0", offset)].decode(errors="replace")
+            yield timestamp, format_record(fmt, args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the deferred logs of dlog_dump()")
+    parser.add_argument("elf", help="ELF of the application (e.g. sw/build/main.elf)")
+    parser.add_argument("dump", help="UART capture or memory dump, '-' for stdin")
+    parser.add_argument("--no-timestamps", action="store_true", help="do not print mcycle")
+    args = parser.parse_args()
+
+    strings, base = read_fmt_section(args.elf)
+    if args.dump == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.dump, "rb") as f:
+            data = f.read()
+
+    for timestamp, text in decode(data, strings, base):
+        text = text.rstrip("\n")
+        if args.no_timestamps or timestamp is None:
+            print(text)
+        else:
+            print(f"{timestamp:10d}: {text}")
+
+
+if __name__ == "__main__":
+    main()
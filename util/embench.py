@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Embench-IoT speed and size scores of every CPU type.
+#
+# The benchmarks are built one at a time with the shared main and board support of
+# sw/applications/embench (make app PROJECT=embench EMBENCH_BENCHMARK=<name>). minver and the dummy
+# benchmark are in the tree, the others are copied from src/ of an Embench-IoT checkout given with
+# --embench-dir. For every CPU, the MCU is generated and the model of the simulator built, then
+# every benchmark is simulated. The board support counts the cycles of the benchmark with mcycle,
+# with CPU_MHZ at 1, so that they are its time in us at 1 MHz. The size of a benchmark is its text
+# minus the text of the dummy benchmark, i.e. without the main, the board support and the libraries.
+#
+# As in Embench, the speed score of a benchmark is the time of the reference platform
+# (baseline-data/speed.json of the checkout) over its time, its size score its size over the
+# reference size (baseline-data/size.json), and the scores of a CPU are their geometric means, with
+# their geometric standard deviations. With --baseline, the scores are relative to a CPU of the
+# results of another run instead, e.g. cv32e20.
+
+import argparse
+import json
+import math
+import pathlib
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+BUILD = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0"
+FIRMWARE = ROOT / "sw" / "build" / "main.hex"
+ELF = ROOT / "sw" / "build" / "main.elf"
+APP_SRC = ROOT / "sw" / "applications" / "embench" / "src"
+
+# make target building the model, work folder and command running the firmware
+SIMULATORS = {
+    "verilator": ("verilator-sim", BUILD / "sim-verilator",
+                  ["./Vtestharness", "+firmware=" + str(FIRMWARE), "+trace=off"]),
+    "verilator-sc": ("verilator-sim-sc", BUILD / "sim_sc-verilator",
+                     ["./Vtestharness", "+firmware=" + str(FIRMWARE)]),
+    "questasim": ("questasim-sim", BUILD / "sim-modelsim",
+                  ["make", "run", "PLUSARGS=c firmware=" + str(FIRMWARE)]),
+    "vcs": ("vcs-sim", BUILD / "sim-vcs",
+            ["./openhwgroup.org_systems_core-v-mini-mcu_0", "+firmware=" + str(FIRMWARE)]),
+}
+
+CPUS = ["cv32e20", "cv32e40p", "cv32e40x", "cv32e40px"]
+
+# Embench-IoT 1.0
+BENCHMARKS = ["aha-mont64", "crc32", "cubic", "edn", "huffbench", "matmult-int", "minver", "nbody",
+              "nettle-aes", "nettle-sha256", "nsichneu", "picojpeg", "qrduino", "sglib-combined", "slre",
+              "st", "statemate", "ud", "wikisort"]
+
+# Benchmarks of sw/applications/embench/src, never replaced by the checkout
+IN_TREE = ["dummy", "minver"]
+
+CYCLES_RE = re.compile(r"Embench cycles: (\d+)")
+PASS_RE = re.compile(r"Program Finished with value 0\b|EXIT SUCCESS")
+
+SHF_ALLOC = 0x2
+SHF_WRITE = 0x1
+SHT_NOBITS = 8
+
+
+def make(*args, log):
+    cmd = ["make", "-C", str(ROOT), "--no-print-directory"] + list(args)
+    with open(log, "w") as out:
+        return subprocess.run(cmd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def elf_text(path):
+    """Return the size of the allocated read-only sections (code and constants) of a 32-bit ELF."""
+    elf = pathlib.Path(path).read_bytes()
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", elf, 0x2E)
+    text = 0
+    for i in range(shnum):
+        _, sh_type, flags, _, _, size = struct.unpack_from("<IIIIII", elf, shoff + i * shentsize)
+        if flags & SHF_ALLOC and not flags & SHF_WRITE and sh_type != SHT_NOBITS:
+            text += size
+    return text
+
+
+def stage(bench, embench_dir):
+    """Copies the sources of a benchmark from the checkout, returns False if there are none"""
+    if bench in IN_TREE:
+        return True
+    src = embench_dir / "src" / bench if embench_dir else None
+    if not src or not src.is_dir():
+        return (APP_SRC / bench).is_dir()
+    dst = APP_SRC / bench
+    shutil.rmtree(dst, ignore_errors=True)
+    shutil.copytree(src, dst, ignore=shutil.ignore_patterns("*.o", "*.txt", "*.md"))
+    return True
+
+
+def load_reference(embench_dir, name):
+    """Reference values of baseline-data/<name>.json of the checkout, {} if there are none"""
+    path = embench_dir / "baseline-data" / (name + ".json") if embench_dir else None
+    if not path or not path.exists():
+        return {}
+    data = json.loads(path.read_text())
+    return {k: float(v) for k, v in data.items() if isinstance(v, (int, float)) and v > 0}
+
+
+def geo(values):
+    """Geometric mean and geometric standard deviation"""
+    logs = [math.log(v) for v in values]
+    mean = sum(logs) / len(logs)
+    return math.exp(mean), math.exp(math.sqrt(sum((x - mean) ** 2 for x in logs) / len(logs)))
+
+
+def run_bench(cpu, bench, args, outdir, dummy_text):
+    entry = {"cpu": cpu, "benchmark": bench}
+    name = "{}-{}".format(cpu, bench)
+    if not stage(bench, args.embench_dir):
+        entry["status"] = "missing"
+        return entry
+    if not make("app", "PROJECT=embench", "EMBENCH_BENCHMARK=" + bench, *args.make_args,
+                log=outdir / "app-{}.log".format(name)):
+        entry["status"] = "build_fail"
+        return entry
+    if dummy_text is not None:
+        entry["size"] = max(elf_text(ELF) - dummy_text, 1)
+
+    _, work_dir, cmd = SIMULATORS[args.simulator]
+    log = outdir / "sim-{}.log".format(name)
+    (work_dir / "uart0.log").unlink(missing_ok=True)
+    try:
+        with open(log, "w") as out:
+            subprocess.run(cmd, cwd=work_dir, stdout=out, stderr=subprocess.STDOUT, timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        entry["status"] = "timeout"
+        return entry
+    sim = log.read_text(errors="replace")
+    uart_log = work_dir / "uart0.log"
+    uart = uart_log.read_text(errors="replace") if uart_log.exists() else ""
+    cycles = CYCLES_RE.search(uart) or CYCLES_RE.search(sim)
+    entry["status"] = "pass" if cycles and PASS_RE.search(sim) else "fail"
+    if cycles:
+        entry["cycles"] = int(cycles.group(1))
+    return entry
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Embench-IoT speed and size scores per CPU type")
+    parser.add_argument("--cpus", nargs="+", default=CPUS, choices=CPUS)
+    parser.add_argument("--simulator", default="verilator", choices=SIMULATORS.keys())
+    parser.add_argument("--benchmarks", nargs="+", default=BENCHMARKS, help="benchmarks to run (default: Embench-IoT 1.0)")
+    parser.add_argument("--embench-dir", type=pathlib.Path, help="Embench-IoT checkout with the sources of the benchmarks")
+    parser.add_argument("--config", default="configs/general.hjson", help="X-HEEP configuration")
+    parser.add_argument("--make-args", nargs="*", default=[], help="other variables of make app, e.g. PROFILE=speed")
+    parser.add_argument("--baseline", type=pathlib.Path, help="results.json of another run, the reference of the scores")
+    parser.add_argument("--baseline-cpu", help="CPU of --baseline (default: its first one)")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="embench", help="folder of the logs and results")
+    args = parser.parse_args()
+
+    if args.embench_dir:
+        args.embench_dir = args.embench_dir.resolve()
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+
+    if args.baseline:
+        base = json.loads(args.baseline.read_text())
+        base_cpu = args.baseline_cpu or base["cpus"][0]
+        base_runs = [r for r in base["runs"] if r["cpu"] == base_cpu and r["status"] == "pass"]
+        ref_speed = {r["benchmark"]: r["cycles"] / 1000.0 for r in base_runs}
+        ref_size = {r["benchmark"]: r["size"] for r in base_runs if "size" in r}
+        reference = "{} of {}".format(base_cpu, args.baseline)
+    else:
+        ref_speed = load_reference(args.embench_dir, "speed")
+        ref_size = load_reference(args.embench_dir, "size")
+        reference = "the Embench reference platform" if ref_speed else None
+
+    runs, scores = [], []
+    target, work_dir, _ = SIMULATORS[args.simulator]
+    for cpu in args.cpus:
+        print("Building the model of " + cpu)
+        ok = make("mcu-gen", "X_HEEP_CFG=" + args.config, "CPU=" + cpu, log=outdir / "mcu-gen-{}.log".format(cpu))
+        ok = ok and make(target, log=outdir / "{}-{}.log".format(target, cpu))
+        if not ok:
+            runs += [{"cpu": cpu, "benchmark": b, "status": "no_model"} for b in args.benchmarks]
+            continue
+
+        # the text of the main, the board support and the libraries, the same for every benchmark
+        dummy_text = None
+        if make("app", "PROJECT=embench", "EMBENCH_BENCHMARK=dummy", *args.make_args,
+                log=outdir / "app-{}-dummy.log".format(cpu)):
+            dummy_text = elf_text(ELF)
+
+        cpu_runs = []
+        for bench in args.benchmarks:
+            entry = run_bench(cpu, bench, args, outdir, dummy_text)
+            cpu_runs.append(entry)
+            print("{:10} {:15} {}".format(cpu, bench, "{} cycles, {} bytes".format(
+                entry["cycles"], entry.get("size", "-")) if entry["status"] == "pass" else entry["status"]))
+        runs += cpu_runs
+
+        passed = [r for r in cpu_runs if r["status"] == "pass"]
+        score = {"cpu": cpu, "benchmarks": len(passed)}
+        speed = [ref_speed[r["benchmark"]] / (r["cycles"] / 1000.0) for r in passed if r["benchmark"] in ref_speed]
+        size = [r["size"] / ref_size[r["benchmark"]] for r in passed if "size" in r and r["benchmark"] in ref_size]
+        if speed:
+            score["speed"], score["speed_gsd"] = geo(speed)
+        if size:
+            score["size"], score["size_gsd"] = geo(size)
+        if passed:
+            score["cycles_geomean"] = geo([r["cycles"] for r in passed])[0]
+        if [r for r in passed if "size" in r]:
+            score["size_geomean"] = geo([r["size"] for r in passed if "size" in r])[0]
+        scores.append(score)
+
+    with open(outdir / "results.json", "w") as f:
+        json.dump({"config": args.config, "simulator": args.simulator, "cpus": args.cpus,
+                   "reference": reference, "scores": scores, "runs": runs}, f, indent=2)
+
+    def fmt(value, digits=3):
+        return "-" if value is None else "{:.{}f}".format(value, digits)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("Scores relative to {}\n\n".format(reference) if reference else
+                "No reference: only the geometric means of the cycles and sizes\n\n")
+        f.write("| CPU | benchmarks | speed | speed GSD | size | size GSD | cycles geomean | size geomean |\n")
+        f.write("|-----|------------|-------|-----------|------|----------|----------------|--------------|\n")
+        for s in scores:
+            f.write("| {} | {} | {} | {} | {} | {} | {} | {} |\n".format(
+                s["cpu"], s["benchmarks"], fmt(s.get("speed")), fmt(s.get("speed_gsd")), fmt(s.get("size")),
+                fmt(s.get("size_gsd")), fmt(s.get("cycles_geomean"), 0), fmt(s.get("size_geomean"), 0)))
+        f.write("\n| benchmark | " + " | ".join("{} cycles | {} size".format(c, c) for c in args.cpus) + " |\n")
+        f.write("|-----------|" + "------|------|" * len(args.cpus) + "\n")
+        for bench in args.benchmarks:
+            cells = []
+            for cpu in args.cpus:
+                r = next((r for r in runs if r["cpu"] == cpu and r["benchmark"] == bench), {})
+                cells += [str(r["cycles"]) if r.get("status") == "pass" else r.get("status", "-"),
+                          str(r.get("size", "-"))]
+            f.write("| {} | {} |\n".format(bench, " | ".join(cells)))
+    print(open(outdir / "results.md").read())
+
+    sys.exit(0 if all(r["status"] == "pass" for r in runs) else 1)
+
+
+if __name__ == "__main__":
+    main()
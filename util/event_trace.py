@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Converters of the binary event trace written by the Verilator testharness with
+# +event_trace=<file>, see tb/XHEEP_EventTrace.hh:
+#   stats    the number of events of each kind, per master for the bus
+#   dump     one line of text per event
+#   bus      the text trace of tb/bus_trace.sv, for other tools than mcu_gen.py --analyze_trace,
+#            which reads the event trace directly
+#   profile  the retired instructions at each address, in the format of +pc_profile, for
+#            util/hot_functions.py
+# The events are streamed, the whole trace is never held in memory.
+
+import argparse
+import sys
+from collections import Counter
+
+from x_heep_gen.event_trace import Bus, EventReader, Retire
+from x_heep_gen.bank_analysis import SYSTEM_MASTER_NAMES
+
+
+def master_name(master, nsystem):
+    if master < nsystem and master < len(SYSTEM_MASTER_NAMES):
+        return SYSTEM_MASTER_NAMES[master]
+    return f"ext master {master - nsystem}"
+
+
+def stats(events, out):
+    retired = irqs = 0
+    accesses = Counter()
+    wait = Counter()
+    last = 0
+    for e in events:
+        if isinstance(e, Retire):
+            retired += 1
+            last = e.cycle
+        elif isinstance(e, Bus):
+            accesses[(e.master, e.write)] += 1
+            wait[e.master] += e.gnt - e.req
+            last = e.gnt
+        else:
+            irqs += 1
+            last = e.cycle
+    out.write(f"{last} cycles, {retired} retired instructions, {irqs} interrupt changes\n")
+    for master in sorted({m for m, _ in accesses}):
+        out.write(f"{master_name(master, events.nsystem):>14}: {accesses[(master, False)]} reads, "
+                  f"{accesses[(master, True)]} writes, {wait[master]} cycles waited\n")
+
+
+def dump(events, out):
+    for e in events:
+        if isinstance(e, Retire):
+            out.write(f"{e.cycle} retire {e.pc:08x}\n")
+        elif isinstance(e, Bus):
+            out.write(f"{e.gnt} bus {e.master} {'w' if e.write else 'r'} {e.addr:08x} wait {e.gnt - e.req}\n")
+        else:
+            out.write(f"{e.cycle} irq {e.lines:08x}\n")
+
+
+def bus(events, out):
+    out.write(f"# x-heep bus trace, masters {events.nmaster}, system masters {events.nsystem}\n")
+    out.write("# request_cycle grant_cycle master address r/w\n")
+    for e in events:
+        if isinstance(e, Bus):
+            out.write(f"{e.req} {e.gnt} {e.master} {e.addr:08x} {'w' if e.write else 'r'}\n")
+
+
+def profile(events, out):
+    histogram = Counter(e.pc for e in events if isinstance(e, Retire))
+    out.write("# address retired\n")
+    for pc in sorted(histogram):
+        out.write(f"0x{pc:x} {histogram[pc]}\n")
+
+
+def main():
+    converters = {"stats": stats, "dump": dump, "bus": bus, "profile": profile}
+    parser = argparse.ArgumentParser(description="Converters of the binary event trace of the testharness")
+    parser.add_argument("command", choices=converters.keys())
+    parser.add_argument("trace", help="Event trace written with +event_trace=<file>")
+    parser.add_argument("-o", "--output", help="Output file (default standard output)")
+    args = parser.parse_args()
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    try:
+        with EventReader(args.trace) as events:
+            converters[args.command](events, out)
+    except RuntimeError as e:
+        sys.exit(str(e))
+    finally:
+        if args.output:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Compressed flash image of an application linked with link_flash_load.ld (make app
+# LINKER=flash_load FLASH_LOAD_LZ=1).
+#
+# The bytes copied by the boot ROM are kept as they are. The rest of the code and the
+# sections loaded by the crt0 are compressed in the next bytes of the flash, behind the
+# w25q_lz_header_t of w25q128jw.h, and w25q128jw_load_lz_crt0() decompresses them into
+# RAM while they are read. The data that stays in the flash (.data_flash_only) keeps
+# its address. The image is written as the verilog hex file of objcopy, in place of the
+# uncompressed one, and its round trip is checked before. When the CRC peripheral is
+# included, w25q128jw_checksum() is the CRC-32 of zlib, found by the symbol of its helper.
+
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+# As in crt0.S.tpl and w25q128jw.h
+RAMSIZE_COPIEDBY_BOOTROM = 2048
+LZ_MAGIC = 0x5A4C5848
+LZ_MAX_SECTIONS = 16
+
+PT_LOAD = 1
+SHT_SYMTAB = 2
+
+MIN_MATCH = 4
+MAX_MATCH = 4 + 15 + 255 * 3
+MAX_OFFSET = 0xFFFF
+MASK32 = 0xFFFFFFFF
+
+
+def read_elf(elf_path):
+    """Return the PT_LOAD segments (paddr, bytes) and the symbols of a 32-bit little-endian ELF."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit(f"{elf_path}: not a 32-bit little-endian ELF")
+
+    phoff, shoff = struct.unpack_from("<II", elf, 0x1C)
+    phentsize, phnum, shentsize, shnum = struct.unpack_from("<HHHH", elf, 0x2A)
+
+    segments = []
+    for i in range(phnum):
+        p_type, p_offset, _, p_paddr, p_filesz = struct.unpack_from("<IIIII", elf, phoff + i * phentsize)
+        if p_type == PT_LOAD and p_filesz:
+            segments.append((p_paddr, elf[p_offset:p_offset + p_filesz]))
+
+    symbols = {}
+    for i in range(shnum):
+        _, sh_type, _, _, sh_offset, sh_size, sh_link, _, _, sh_entsize = \
+            struct.unpack_from("<IIIIIIIIII", elf, shoff + i * shentsize)
+        if sh_type != SHT_SYMTAB:
+            continue
+        strtab_off = struct.unpack_from("<I", elf, shoff + sh_link * shentsize + 0x10)[0]
+        for off in range(sh_offset, sh_offset + sh_size, sh_entsize):
+            st_name, st_value = struct.unpack_from("<II", elf, off)
+            end = elf.index(b"\0", strtab_off + st_name)
+            symbols[elf[strtab_off + st_name:end].decode()] = st_value
+    return segments, symbols
+
+
+def checksum(data, c, crc32=False):
+    """w25q128jw_checksum(): rotate and add of the words, the last bytes padded with zeros,
+    or the CRC-32 of the CRC peripheral."""
+    if crc32:
+        return zlib.crc32(bytes(data), c)
+    data = bytes(data) + bytes(-len(data) % 4)
+    for (w,) in struct.iter_unpack("<I", data):
+        c = ((((c << 5) | (c >> 27)) & MASK32) + w) & MASK32
+    return c
+
+
+def ext_len(n):
+    """Extra bytes of a count that does not fit its nibble."""
+    return 0 if n < 15 else (n - 15) // 255 + 1
+
+
+def seq_size(literals, match):
+    return 1 + ext_len(literals) + literals + 2 + (ext_len(match - MIN_MATCH) if match else 0)
+
+
+def put_ext(out, n):
+    n -= 15
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def compress(data, chunk):
+    """Greedy LZ4 sequences, none crossing the end of a chunk, the last chunk padded.
+    With chunk None, one stream with no padding, as read by the UART loader of the boot ROM."""
+    out = bytearray()
+
+    def room():
+        return chunk - len(out) % chunk if chunk else sys.maxsize
+
+    def put(literals, match, offset):
+        lit = len(literals)
+        nib_m = min(match - MIN_MATCH, 15) if match else 0
+        out.append((min(lit, 15) << 4) | nib_m)
+        if lit >= 15:
+            put_ext(out, lit)
+        out.extend(literals)
+        out.extend(struct.pack("<H", offset))
+        if match and match - MIN_MATCH >= 15:
+            put_ext(out, match - MIN_MATCH)
+
+    def emit(literals, match, offset):
+        while True:
+            if seq_size(len(literals), match) <= room():
+                if literals or match:
+                    put(literals, match, offset)
+                return
+            # The literals that fit go alone, the rest in the next chunk
+            k = min(len(literals), room() - 3)
+            while k > 0 and seq_size(k, 0) > room():
+                k -= 1
+            if k > 0:
+                put(literals[:k], 0, 0)
+                literals = literals[k:]
+            else:
+                out.extend(bytes(room()))
+
+    table = {}
+    i = 0
+    start = 0
+    n = len(data)
+    while i + MIN_MATCH <= n:
+        key = data[i:i + MIN_MATCH]
+        cand = table.get(key)
+        table[key] = i
+        if cand is not None and i - cand <= MAX_OFFSET:
+            length = MIN_MATCH
+            while i + length < n and length < MAX_MATCH and data[cand + length] == data[i + length]:
+                length += 1
+            emit(data[start:i], length, i - cand)
+            for j in range(i + 1, min(i + length, n - MIN_MATCH + 1)):
+                table[data[j:j + MIN_MATCH]] = j
+            i += length
+            start = i
+        else:
+            i += 1
+    emit(data[start:], 0, 0)
+    if chunk and len(out) % chunk:
+        out.extend(bytes(room()))
+    return bytes(out)
+
+
+def decompress(packed, length, chunk):
+    """w25q128jw_load_lz_crt0_chunk() over all the chunks, to check the round trip."""
+    out = bytearray()
+    chunk = chunk or len(packed)
+    for base in range(0, len(packed), chunk):
+        pos, end = base, base + chunk
+        while end - pos >= 3:
+            token = packed[pos]
+            pos += 1
+            n = token >> 4
+            if n == 15:
+                while True:
+                    pos += 1
+                    n += packed[pos - 1]
+                    if packed[pos - 1] != 255:
+                        break
+            out.extend(packed[pos:pos + n])
+            pos += n
+            offset = packed[pos] | (packed[pos + 1] << 8)
+            pos += 2
+            if offset == 0:
+                continue
+            n = (token & 15) + MIN_MATCH
+            if token & 15 == 15:
+                while True:
+                    pos += 1
+                    n += packed[pos - 1]
+                    if packed[pos - 1] != 255:
+                        break
+            for _ in range(n):
+                out.append(out[-offset])
+    if len(out) != length:
+        sys.exit(f"decompressed {len(out)} bytes instead of {length}")
+    return bytes(out)
+
+
+def write_hex(path, image):
+    """Verilog hex of objcopy, 16 bytes per line, a @address line before each contiguous block."""
+    with open(path, "w") as f:
+        addr = None
+        for a in sorted(image):
+            if a != addr:
+                if addr is not None:
+                    f.write("\n")
+                f.write(f"@{a:08X}\n")
+                col = 0
+            elif col == 16:
+                f.write("\n")
+                col = 0
+            f.write(("" if col == 0 else " ") + f"{image[a]:02X}")
+            col += 1
+            addr = a + 1
+        f.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compressed flash image of a flash_load application")
+    parser.add_argument("elf", help="application linked with link_flash_load.ld")
+    parser.add_argument("hex", help="flash image to write")
+    parser.add_argument("--flash-base", type=lambda x: int(x, 0), default=0x40000000,
+                        help="FLASH_MEM_START_ADDRESS (default 0x40000000)")
+    parser.add_argument("--chunk", type=int, default=512, help="W25Q_LZ_CHUNK_BYTES (default 512)")
+    args = parser.parse_args()
+
+    segments, symbols = read_elf(args.elf)
+
+    flash = {}
+    for paddr, data in segments:
+        if paddr >= args.flash_base:
+            for i, b in enumerate(data):
+                flash[paddr - args.flash_base + i] = b
+
+    def flash_bytes(addr, length):
+        return bytes(flash.get(addr + i, 0) for i in range(length))
+
+    # Loaded as by the crt0: the code after the bytes of the boot ROM, then the sections
+    loads = []
+    etext = symbols["_etext"]
+    if etext > RAMSIZE_COPIEDBY_BOOTROM:
+        loads.append(("code", RAMSIZE_COPIEDBY_BOOTROM, RAMSIZE_COPIEDBY_BOOTROM, etext - RAMSIZE_COPIEDBY_BOOTROM))
+    sections = []
+    for name, value in symbols.items():
+        m = re.fullmatch(r"_lma_(\w+)_start", name)
+        if not m or m.group(1) == "text" or f"_lma_{m.group(1)}_end" not in symbols:
+            continue
+        length = symbols[f"_lma_{m.group(1)}_end"] - value
+        if length > 0:
+            sections.append((value, m.group(1), length))
+    for lma, name, length in sorted(sections):
+        loads.append((name, lma - args.flash_base, symbols[f"__{name}_start"], length))
+    if len(loads) > LZ_MAX_SECTIONS:
+        sys.exit(f"{len(loads)} sections, at most {LZ_MAX_SECTIONS}")
+
+    # w25q128jw_checksum() of a platform with the CRC peripheral (CRC_IS_INCLUDED)
+    crc32 = any(name.startswith("w25q128jw_checksum_crc32") for name in symbols)
+
+    # The two chunks of w25q128jw_load_lz_crt0() are at the start of the heap
+    if symbols["__heap_end"] - symbols["__heap_start"] < 2 * args.chunk:
+        sys.exit(f"the heap must hold the {2 * args.chunk} bytes of the two chunks")
+
+    header_addr = RAMSIZE_COPIEDBY_BOOTROM
+    addr = header_addr + args.chunk
+    entries = []
+    streams = bytearray()
+    c = 0
+    for name, src, dst, length in loads:
+        data = flash_bytes(src, length)
+        packed = compress(data, args.chunk)
+        if decompress(packed, length, args.chunk) != data:
+            sys.exit(f"{name}: round trip failed")
+        c = checksum(data, c, crc32)
+        entries.append(struct.pack("<IIIII", addr + len(streams), dst, length, len(packed), c))
+        streams += packed
+        print(f"{name:<12} {length:8d} -> {len(packed):8d} bytes")
+
+    header = struct.pack("<II", LZ_MAGIC, len(entries)) + b"".join(entries)
+    header += bytes(args.chunk - len(header))
+
+    # The boot ROM bytes, the compressed sections, and what stays at its flash address
+    image = {a: b for a, b in flash.items() if a < RAMSIZE_COPIEDBY_BOOTROM}
+    for i, b in enumerate(header + streams):
+        image[header_addr + i] = b
+    packed_end = header_addr + len(header) + len(streams)
+    loaded = [(src, src + length) for _, src, _, length in loads]
+    for a, b in flash.items():
+        if a >= RAMSIZE_COPIEDBY_BOOTROM and not any(s <= a < e for s, e in loaded):
+            if a < packed_end:
+                sys.exit(f"flash address {a:#x} of the image is overwritten by the compressed sections")
+            image[a] = b
+
+    raw = sum(length for _, _, _, length in loads)
+    print(f"{'total':<12} {raw:8d} -> {len(header) + len(streams):8d} bytes, "
+          f"{len(flash)} -> {len(image)} bytes of flash")
+    write_hex(args.hex, image)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Flash images of a binary striped over two flashes, as read by w25q_stripe.h.
+#
+# Page p of the binary (256 bytes) goes to flash p % 2, at the flash address base + (p / 2) * 256.
+# Each image is written as the verilog hex file of objcopy, <prefix>0.hex and <prefix>1.hex, with
+# the number of bytes from base to program in <prefix>0.size and <prefix>1.size, the -a of iceprog.
+
+import argparse
+import sys
+
+PAGE = 256
+FLASHES = 2
+FLASH_SIZE = 16 * 1024 * 1024
+
+
+def write_hex(path, base, data):
+    """Verilog hex of objcopy, 16 bytes per line, from the address base."""
+    with open(path, "w") as f:
+        f.write(f"@{base:08X}\n")
+        for i in range(0, len(data), 16):
+            f.write(" ".join(f"{b:02X}" for b in data[i:i + 16]) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flash images of a binary striped over two flashes")
+    parser.add_argument("bin", help="binary to stripe, e.g. model weights")
+    parser.add_argument("prefix", help="prefix of the images to write")
+    parser.add_argument("--base", type=lambda x: int(x, 0), default=0,
+                        help="flash address of the area in both flashes, page aligned (default 0)")
+    args = parser.parse_args()
+
+    if args.base % PAGE:
+        sys.exit(f"base {args.base:#x} is not page aligned")
+
+    with open(args.bin, "rb") as f:
+        data = f.read()
+    # The last page is completed with the erased value of the flash
+    if len(data) % PAGE:
+        data += b"\xff" * (PAGE - len(data) % PAGE)
+
+    for flash in range(FLASHES):
+        image = b"".join(data[p:p + PAGE] for p in range(flash * PAGE, len(data), FLASHES * PAGE))
+        if args.base + len(image) > FLASH_SIZE:
+            sys.exit(f"flash {flash}: {len(image)} bytes from {args.base:#x} do not fit in the flash")
+        write_hex(f"{args.prefix}{flash}.hex", args.base, image)
+        with open(f"{args.prefix}{flash}.size", "w") as f:
+            f.write(f"{len(image)}\n")
+        print(f"flash {flash}: {len(image):8d} bytes from {args.base:#08x}")
+
+
+if __name__ == "__main__":
+    main()
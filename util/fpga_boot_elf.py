@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Makes the ELF that updatemem writes into the RAM banks of a bitstream (make
+# vivado-fpga-update-sw): the loaded segments of an application linked for the
+# RAM (LINKER=on_chip), and the boot record of hw/ip/boot_rom/boot_rom.S, "XHBR"
+# and _start, with which the boot ROM starts the application at power-up when
+# boot_sel_i is at 0 instead of waiting for the JTAG.
+
+import argparse
+import struct
+import sys
+
+from flash_lz import read_elf
+
+# As in boot_rom.S
+BOOT_RECORD_ADDRESS = 0x178
+BOOT_RECORD_MAGIC = 0x52424858
+
+EM_RISCV = 243
+PT_LOAD = 1
+PF_RWX = 7
+
+
+def write_elf(path, entry, segments):
+    """Write a 32-bit little-endian RISC-V ELF with one PT_LOAD per segment."""
+    ehsize, phentsize = 52, 32
+    offset = ehsize + phentsize * len(segments)
+    header = b"\x7fELF" + bytes([1, 1, 1]) + bytes(9)
+    header += struct.pack("<HHIIIIIHHHHHH", 2, EM_RISCV, 1, entry, ehsize, 0, 0, ehsize,
+                          phentsize, len(segments), 40, 0, 0)
+    phdrs, data = b"", b""
+    for paddr, d in segments:
+        phdrs += struct.pack("<8I", PT_LOAD, offset + len(data), paddr, paddr, len(d), len(d), PF_RWX, 4)
+        data += d + bytes(-len(d) % 4)
+    with open(path, "wb") as f:
+        f.write(header + phdrs + data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Make the RAM contents of a bitstream from an application")
+    parser.add_argument("elf", help="application linked with link.ld, e.g. sw/build/main.elf")
+    parser.add_argument("out", help="ELF given to updatemem")
+    parser.add_argument("--no-boot-record", action="store_true",
+                        help="leave the boot ROM waiting for the JTAG")
+    args = parser.parse_args()
+
+    segments, symbols = read_elf(args.elf)
+    if "_start" not in symbols:
+        sys.exit(f"{args.elf}: no symbol _start")
+    for paddr, data in segments:
+        if paddr < BOOT_RECORD_ADDRESS + 8 and paddr + len(data) > BOOT_RECORD_ADDRESS:
+            sys.exit(f"the segment at {paddr:#010x} covers the boot record at {BOOT_RECORD_ADDRESS:#x}")
+
+    if not args.no_boot_record:
+        segments.append((BOOT_RECORD_ADDRESS, struct.pack("<2I", BOOT_RECORD_MAGIC, symbols["_start"])))
+    write_elf(args.out, symbols["_start"], sorted(segments))
+    print(f"{sum(len(d) for _, d in segments)} bytes, entry {symbols['_start']:#010x}", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Runs a list of applications on the FPGA and collects the performance counters of the core
+# and of the system crossbar into the perf_counters.json format of the Verilator testbench.
+#
+# Every application is built with PERF_DUMP=1 and LINKER=on_chip: before main() the
+# counters are cleared, at exit they are frozen, copied to perf_dump and printed (see
+# sw/device/lib/runtime/perf_dump.h). Then, with boot_sel_i at 0,
+#
+#   --mode jtag   OpenOCD and GDB load the application, stop it at _exit and read perf_dump
+#                 and the exit value through the debug module
+#   --mode uart   uart_load.py sends it to the UART loader of the boot ROM and the PERF lines
+#                 are read from the UART; the exit value is not known
+#
+# The results go to <outdir>/<app>.json and <outdir>/fpga_perf.json. With --compare, the
+# cycles, instructions and counters are checked against the perf_counters.json files of
+# simulations of the same applications, <dir>/<app>.json.
+
+import argparse
+import json
+import pathlib
+import re
+import subprocess
+import sys
+import time
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+ELF = ROOT / "sw" / "build" / "main.elf"
+
+# As in tb_top.cpp
+MASTER_NAMES = ["core_instr", "core_data", "debug_master", "dma_read_ch0", "dma_write_ch0", "dma_addr_ch0"]
+
+# As in perf_dump.h
+PERF_DUMP_MAX = 32
+PERF_DUMP_MAGIC = 0x50444650
+PERF_DUMP_WORDS = 4 + 6 + 3 * PERF_DUMP_MAX + 2 * PERF_DUMP_MAX
+
+OPENOCD_CFG = {
+    "pynq-z2": ROOT / "tb" / "core-v-mini-mcu-pynq-z2-esl-programmer.cfg",
+    "nexys-a7-100t": ROOT / "tb" / "core-v-mini-mcu-nexsys-hs2.cfg",
+}
+
+GDB_SCRIPT = """set pagination off
+set confirm off
+set remotetimeout 2000
+target extended-remote :3333
+monitor reset halt
+load
+break _exit
+continue
+printf "PERF exit %d\\n", $a0
+x/{words}wx &perf_dump
+quit
+"""
+
+LINE_RE = re.compile(r"PERF (\w+)((?: \S+)*)")
+
+
+def make(log, *args):
+    with open(log, "w") as out:
+        return subprocess.run(["make", "-C", str(ROOT), "--no-print-directory"] + list(args),
+                              stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def parse_dump(words):
+    """Turn the words of perf_dump into the records of the PERF lines."""
+    if len(words) < PERF_DUMP_WORDS or words[4] != PERF_DUMP_MAGIC:
+        return None
+    masters, banks = min(words[5], PERF_DUMP_MAX), min(words[6], PERF_DUMP_MAX)
+    records = {
+        "core": (words[1] << 32 | words[0], words[3] << 32 | words[2]),
+        "global": tuple(words[7:10]),
+        "master": {i: tuple(words[10 + 3 * i:13 + 3 * i]) for i in range(masters)},
+        "bank": {},
+    }
+    base = 10 + 3 * PERF_DUMP_MAX
+    for i in range(banks):
+        records["bank"][i] = tuple(words[base + 2 * i:base + 2 * i + 2])
+    return records
+
+
+def parse_lines(text):
+    """Turn the PERF lines printed at exit into records, None if they are incomplete."""
+    records = {"master": {}, "bank": {}}
+    for match in LINE_RE.finditer(text):
+        key, values = match.group(1), [int(v, 0) for v in match.group(2).split()]
+        if key in ("master", "bank"):
+            records[key][values[0]] = tuple(values[1:])
+        elif key == "end":
+            return records
+        else:
+            records[key] = tuple(values)
+    return None
+
+
+def to_json(records, exit_value):
+    """The records in the format of perf_counters.json of tb_top.cpp."""
+    mcycle, minstret = records["core"]
+    cycles, dma_busy, core_stall = records["global"]
+    result = {
+        "exit_valid": exit_value is not None,
+        "exit_value": exit_value,
+        "cycles": cycles,
+        "core": {"mcycle": mcycle, "minstret": minstret, "cpi": mcycle / minstret if minstret else 0.0},
+        "dma_busy_cycles": dma_busy,
+        "core_stall_cycles": core_stall,
+        "masters": {},
+        "ram_banks": {},
+    }
+    for i, (req_cycles, gnt, rvalid) in sorted(records["master"].items()):
+        name = MASTER_NAMES[i] if i < len(MASTER_NAMES) else "ext_master{}".format(i - len(MASTER_NAMES))
+        result["masters"][name] = {"req_cycles": req_cycles, "gnt": gnt, "rvalid": rvalid,
+                                   "stall_cycles": req_cycles - gnt,
+                                   "utilization": gnt / cycles if cycles else 0.0}
+    for i, (accesses, conflicts) in sorted(records["bank"].items()):
+        result["ram_banks"]["ram{}".format(i)] = {"accesses": accesses, "conflicts": conflicts}
+    return result
+
+
+def run_jtag(args, log):
+    """Load and run sw/build/main.elf with OpenOCD and GDB, return (records, exit value)."""
+    gdb_script = pathlib.Path(log).with_suffix(".gdb")
+    gdb_script.write_text(GDB_SCRIPT.format(words=PERF_DUMP_WORDS))
+    with open(log, "w") as out:
+        openocd = subprocess.Popen(["openocd", "-f", str(args.openocd_cfg)], stdout=out, stderr=subprocess.STDOUT)
+        try:
+            time.sleep(2)
+            gdb = subprocess.run([args.gdb, "-batch", "-x", str(gdb_script), str(ELF)], capture_output=True,
+                                 text=True, timeout=args.timeout)
+        except subprocess.TimeoutExpired:
+            return None, None
+        finally:
+            openocd.terminate()
+            openocd.wait()
+        out.write(gdb.stdout + gdb.stderr)
+
+    exit_value = re.search(r"PERF exit (-?\d+)", gdb.stdout)
+    words = [int(w, 16) for line in gdb.stdout.splitlines() if line.startswith("0x") and ":" in line
+             for w in line.split(":", 1)[1].split()]
+    return parse_dump(words), int(exit_value.group(1)) if exit_value else None
+
+
+def run_uart(args, log):
+    """Load and run sw/build/main.elf through the UART loader, return (records, None)."""
+    import serial
+
+    from uart_load import load_stream, ACK
+
+    stream, _, _ = load_stream(str(ELF))
+    text = ""
+    with serial.Serial(args.port, args.boot_baudrate, timeout=5) as port:
+        port.reset_input_buffer()
+        port.write(stream)
+        if port.read(1) != ACK:
+            return None, None
+        # The application prints at its own baudrate
+        port.baudrate = args.baudrate
+        deadline = time.time() + args.timeout
+        while time.time() < deadline and "PERF end" not in text:
+            text += port.read(port.in_waiting or 1).decode(errors="replace")
+    pathlib.Path(log).write_text(text)
+    return parse_lines(text), None
+
+
+def compare(fpga, sim, tolerance):
+    """Relative differences above the tolerance between the FPGA and simulation counters."""
+    pairs = [("core.mcycle", fpga["core"]["mcycle"], sim["core"]["mcycle"]),
+             ("core.minstret", fpga["core"]["minstret"], sim["core"]["minstret"]),
+             ("dma_busy_cycles", fpga["dma_busy_cycles"], sim.get("dma_busy_cycles")),
+             ("core_stall_cycles", fpga["core_stall_cycles"], sim.get("core_stall_cycles"))]
+    for name, counters in fpga["masters"].items():
+        for key in ("gnt", "rvalid"):
+            pairs.append(("masters.{}.{}".format(name, key), counters[key], sim["masters"].get(name, {}).get(key)))
+    for name, counters in fpga["ram_banks"].items():
+        for key in ("accesses", "conflicts"):
+            pairs.append(("ram_banks.{}.{}".format(name, key), counters[key], sim["ram_banks"].get(name, {}).get(key)))
+
+    diffs = []
+    for name, value, reference in pairs:
+        if reference is None:
+            continue
+        error = abs(value - reference) / max(reference, 1)
+        if error > tolerance:
+            diffs.append("{} {} on the FPGA, {} in simulation ({:+.1%})".format(
+                name, value, reference, (value - reference) / max(reference, 1)))
+    return diffs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Performance counters of applications run on the FPGA")
+    parser.add_argument("--apps", nargs="+", required=True, help="applications in sw/applications")
+    parser.add_argument("--board", default="pynq-z2", choices=OPENOCD_CFG.keys(), help="TARGET of make app")
+    parser.add_argument("--mode", default="jtag", choices=["jtag", "uart"])
+    parser.add_argument("--openocd-cfg", type=pathlib.Path, help="OpenOCD configuration (default per board)")
+    parser.add_argument("--gdb", default="riscv32-unknown-elf-gdb")
+    parser.add_argument("--port", help="serial port of the UART, e.g. /dev/ttyUSB2 (--mode uart)")
+    parser.add_argument("--baudrate", type=int, default=9600, help="baudrate of the application")
+    parser.add_argument("--boot-baudrate", type=int, default=921600, help="BOOT_UART_BAUDRATE of boot_rom.S")
+    parser.add_argument("--timeout", type=int, default=600, help="timeout of each application in seconds")
+    parser.add_argument("--outdir", default="fpga_perf", help="folder of the logs and results")
+    parser.add_argument("--compare", type=pathlib.Path, help="folder of the simulation results, <app>.json")
+    parser.add_argument("--tolerance", type=float, default=0.05, help="accepted difference with --compare")
+    parser.add_argument("--make-args", nargs="*", default=[], help="other variables of make app, e.g. ARCH=rv32imfc")
+    args = parser.parse_args()
+
+    if args.mode == "uart" and not args.port:
+        sys.exit("--mode uart needs --port")
+    args.openocd_cfg = args.openocd_cfg or OPENOCD_CFG[args.board]
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    results, failed = {}, []
+
+    for app in args.apps:
+        if not make(outdir / "{}-app.log".format(app), "app", "PROJECT=" + app, "TARGET=" + args.board,
+                    "LINKER=on_chip", "PERF_DUMP=1", *args.make_args):
+            print("{}: make app failed, see {}-app.log".format(app, outdir / app))
+            failed.append(app)
+            continue
+
+        run = run_jtag if args.mode == "jtag" else run_uart
+        records, exit_value = run(args, outdir / "{}-{}.log".format(app, args.mode))
+        if records is None:
+            print("{}: no counters, see {}-{}.log".format(app, outdir / app, args.mode))
+            failed.append(app)
+            continue
+
+        result = to_json(records, exit_value)
+        results[app] = result
+        (outdir / "{}.json".format(app)).write_text(json.dumps(result, indent=2) + "\n")
+        print("{:24} cycles {:10} minstret {:10} cpi {:5.2f} exit {}".format(
+            app, result["cycles"], result["core"]["minstret"], result["core"]["cpi"], exit_value))
+
+        if args.compare:
+            sim_json = args.compare / "{}.json".format(app)
+            if not sim_json.exists():
+                print("  no simulation results in {}".format(sim_json))
+                continue
+            diffs = compare(result, json.loads(sim_json.read_text()), args.tolerance)
+            for diff in diffs:
+                print("  " + diff)
+            if diffs:
+                failed.append(app)
+
+    (outdir / "fpga_perf.json").write_text(json.dumps({"board": args.board, "mode": args.mode, "apps": results},
+                                                      indent=2) + "\n")
+    if failed:
+        print("failed: " + " ".join(failed))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Content-addressed writing of the generated files.
+#
+# The hash of the content produced by a generator is stored in build/.mcu_gen/hashes.json,
+# with the hash of the file left on disk once formatted (e.g. by verible). A generated file
+# is only written if the content changed, or if the file is missing or no longer the one
+# left by the last run (checkout, hand edit), so that unchanged files keep their timestamp
+# and the simulation models depending on them are not rebuilt.
+#
+# Usage from the shell, to copy the files generated in a temporary folder:
+#   gen_cache.py sync <src_dir> <dst_dir>
+# and to record the files on disk once the ones written after <stamp> are formatted:
+#   gen_cache.py seal <stamp>
+
+import hashlib
+import json
+import pathlib
+import shutil
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+HASHES_FILE = ROOT / "build" / ".mcu_gen" / "hashes.json"
+
+
+def _load():
+    try:
+        return json.loads(HASHES_FILE.read_text())
+    except (OSError, ValueError):
+        return {}
+
+
+def _store(hashes):
+    HASHES_FILE.parent.mkdir(parents=True, exist_ok=True)
+    HASHES_FILE.write_text(json.dumps(hashes, indent=2, sort_keys=True))
+
+
+def _digest(path):
+    return hashlib.sha256(path.read_bytes()).hexdigest()
+
+
+def _changed(hashes, filename, digest):
+    path = pathlib.Path(filename)
+    key = str(path.resolve())
+    entry = hashes.get(key)
+    if isinstance(entry, dict) and entry["content"] == digest and path.exists() and _digest(path) == entry["disk"]:
+        return False
+    # the file holds the content as written until it is sealed
+    hashes[key] = {"content": digest, "disk": digest}
+    return True
+
+
+def write_if_changed(filename, content):
+    """Writes content to filename unless it was already generated. Returns True if written"""
+    hashes = _load()
+    if not _changed(hashes, filename, hashlib.sha256(content.encode()).hexdigest()):
+        return False
+    with open(filename, "w") as file:
+        file.write(content)
+    _store(hashes)
+    return True
+
+
+def sync(src_dir, dst_dir):
+    """Copies the files of src_dir to dst_dir, skipping the ones already generated"""
+    hashes = _load()
+    dst_dir = pathlib.Path(dst_dir)
+    dst_dir.mkdir(parents=True, exist_ok=True)
+    for src in sorted(pathlib.Path(src_dir).iterdir()):
+        if src.is_file() and _changed(hashes, dst_dir / src.name, _digest(src)):
+            shutil.copyfile(src, dst_dir / src.name)
+    _store(hashes)
+
+
+def seal(stamp):
+    """Records the files written since stamp as they are on disk, once formatted"""
+    hashes = _load()
+    since = pathlib.Path(stamp).stat().st_mtime
+    for key, entry in hashes.items():
+        path = pathlib.Path(key)
+        if isinstance(entry, dict) and path.exists() and path.stat().st_mtime >= since:
+            entry["disk"] = _digest(path)
+    _store(hashes)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 4 and sys.argv[1] == "sync":
+        sync(sys.argv[2], sys.argv[3])
+    elif len(sys.argv) == 3 and sys.argv[1] == "seal":
+        seal(sys.argv[2])
+    else:
+        sys.exit("Usage: gen_cache.py sync <src_dir> <dst_dir> | seal <stamp>")
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Selection of the hot functions of an application from a PC profile.
+#
+# The profile is written by the Verilator testharness with +pc_profile=<file>: one line per
+# address with the number of instruction fetches granted to the core. The fetches are summed
+# per function of the ELF that was simulated, and the functions with the most fetches per byte
+# are listed until the size of the hot linker section is reached. The output is a linker
+# script fragment, included by the .text_hot output section of link.ld, with one input
+# section per function, as the applications are compiled with -ffunction-sections.
+
+import argparse
+import struct
+import sys
+
+STT_FUNC = 2
+
+
+def read_functions(elf_path):
+    """Return the (address, size, name) of the functions of a 32-bit little-endian ELF."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit(f"{elf_path}: not a 32-bit little-endian ELF")
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, _ = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def section(i):
+        # name, type, flags, addr, offset, size, link
+        return struct.unpack_from("<IIIIIII", elf, shoff + i * shentsize)
+
+    functions = []
+    for i in range(shnum):
+        _, sh_type, _, _, offset, size, link = section(i)
+        if sh_type != 2:  # SHT_SYMTAB
+            continue
+        strtab_off = section(link)[4]
+        for s in range(offset, offset + size, 16):
+            name, value, sym_size, info, _, _ = struct.unpack_from("<IIIBBH", elf, s)
+            if info & 0xF != STT_FUNC or sym_size == 0:
+                continue
+            end = elf.index(b"\0", strtab_off + name)
+            functions.append((value & ~1, sym_size, elf[strtab_off + name:end].decode()))
+    if not functions:
+        sys.exit(f"{elf_path}: no function symbols, is it stripped?")
+    return sorted(functions)
+
+
+def read_profile(profile_path):
+    """Return the (address, fetches) of a PC profile."""
+    samples = []
+    with open(profile_path) as f:
+        for line in f:
+            line = line.split("#")[0].split()
+            if len(line) == 2:
+                samples.append((int(line[0], 0), int(line[1])))
+    return sorted(samples)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Hot functions of a PC profile, as a linker script fragment")
+    parser.add_argument("--elf", required=True, help="ELF of the profiled application")
+    parser.add_argument("--profile", required=True, help="PC profile written with +pc_profile=<file>")
+    parser.add_argument("--size", default="0", help="Size of the hot linker section in bytes, 0 for no limit")
+    parser.add_argument("--min-share", type=float, default=0.01,
+                        help="Fraction of the fetches below which a function is not listed (default 0.01)")
+    parser.add_argument("-o", "--output", default="hot_functions.ld", help="Output fragment (default hot_functions.ld)")
+    args = parser.parse_args()
+
+    functions = read_functions(args.elf)
+    samples = read_profile(args.profile)
+    total = sum(n for _, n in samples)
+    if total == 0:
+        sys.exit(f"{args.profile}: empty profile")
+
+    # Fetches per function, both lists are sorted by address
+    fetches = {}
+    f = 0
+    for addr, n in samples:
+        while f < len(functions) and functions[f][0] + functions[f][1] <= addr:
+            f += 1
+        if f < len(functions) and functions[f][0] <= addr:
+            fetches[f] = fetches.get(f, 0) + n
+
+    ranked = sorted(fetches.items(), key=lambda item: item[1] / functions[item[0]][1], reverse=True)
+    budget = int(args.size, 0)
+    used = 0
+    selected = []
+    for f, n in ranked:
+        _, size, name = functions[f]
+        if n < args.min_share * total:
+            continue
+        # the functions are aligned on 4 bytes at most by -ffunction-sections
+        if budget and used + ((size + 3) & ~3) > budget:
+            continue
+        used += (size + 3) & ~3
+        selected.append((name, size, n))
+
+    with open(args.output, "w") as out:
+        out.write(f"/* Hot functions of {args.profile}, generated by util/hot_functions.py */\n")
+        for name, size, n in selected:
+            out.write(f"*(.text.{name} .text.hot.{name}) /* {size} B, {100.0 * n / total:.1f}% of the fetches */\n")
+
+    covered = sum(n for _, _, n in selected)
+    print(f"{len(selected)} functions, {used} B, {100.0 * covered / total:.1f}% of the fetches, written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
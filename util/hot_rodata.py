@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Selection of the hot constants of a flash_exec application from a bus trace.
+#
+# The trace is written by the Verilator testharness with +bus_trace=<file> (or +event_trace=<file>):
+# the reads of the core data port and of the DMA are summed per read-only object of the ELF that was
+# simulated, and the objects are reported by reads per byte, the most read first. The objects above
+# --min-share of the reads are listed, until the --size of RAM is reached, in a linker script
+# fragment included by the .ram_rodata output section of link_flash_exec.ld, with one input section
+# per object, as the flash_exec builds are compiled with -fdata-sections.
+
+import argparse
+import struct
+import sys
+from bisect import bisect_right
+
+from x_heep_gen.event_trace import Bus, EventReader, is_event_trace
+
+STT_OBJECT = 1
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+
+# Master of the instruction fetches, as SYSTEM_MASTER_NAMES of x_heep_gen/bank_analysis.py
+MASTER_CORE_INSTR = 0
+
+
+def read_objects(elf_path):
+    """Return the (address, size, name, section) of the read-only objects of a 32-bit little-endian ELF."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit(f"{elf_path}: not a 32-bit little-endian ELF")
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def section(i):
+        # name, type, flags, addr, offset, size, link
+        return struct.unpack_from("<IIIIIII", elf, shoff + i * shentsize)
+
+    def string(table, off):
+        start = section(table)[4] + off
+        return elf[start:elf.index(b"\0", start)].decode()
+
+    objects = []
+    for i in range(shnum):
+        _, sh_type, _, _, offset, size, link = section(i)
+        if sh_type != 2:  # SHT_SYMTAB
+            continue
+        for s in range(offset, offset + size, 16):
+            name, value, sym_size, info, _, shndx = struct.unpack_from("<IIIBBH", elf, s)
+            if info & 0xF != STT_OBJECT or sym_size == 0 or shndx == 0 or shndx >= shnum:
+                continue
+            sh_name, _, flags = section(shndx)[:3]
+            if flags & SHF_ALLOC and not flags & SHF_WRITE:
+                objects.append((value, sym_size, string(link, name), string(shstrndx, sh_name)))
+    if not objects:
+        sys.exit(f"{elf_path}: no read-only object symbols, is it stripped?")
+    return sorted(objects)
+
+
+def read_trace(trace_path):
+    """Yield the addresses of the data reads of a bus trace or of an event trace."""
+    if is_event_trace(trace_path):
+        with EventReader(trace_path) as events:
+            for e in events:
+                if isinstance(e, Bus) and not e.write and e.master != MASTER_CORE_INSTR:
+                    yield e.addr
+        return
+    with open(trace_path) as f:
+        for line in f:
+            fields = line.split("#")[0].split()
+            if len(fields) == 5 and fields[4] == "r" and int(fields[2]) != MASTER_CORE_INSTR:
+                yield int(fields[3], 16)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Hot constants of a bus trace, as a linker script fragment")
+    parser.add_argument("--elf", required=True, help="ELF of the traced application")
+    parser.add_argument("--trace", required=True, help="trace written with +bus_trace=<file> or +event_trace=<file>")
+    parser.add_argument("--size", default="0", help="Bytes of RAM for the constants, 0 for no limit")
+    parser.add_argument("--min-share", type=float, default=0.01,
+                        help="Fraction of the reads below which an object is not listed (default 0.01)")
+    parser.add_argument("--top", type=int, default=20, help="Objects of the report (default 20)")
+    parser.add_argument("-o", "--output", default="hot_rodata.ld", help="Output fragment (default hot_rodata.ld)")
+    args = parser.parse_args()
+
+    objects = read_objects(args.elf)
+    starts = [addr for addr, _, _, _ in objects]
+
+    reads = {}
+    total = 0
+    for addr in read_trace(args.trace):
+        o = bisect_right(starts, addr) - 1
+        if o >= 0 and addr < objects[o][0] + objects[o][1]:
+            reads[o] = reads.get(o, 0) + 1
+            total += 1
+    if total == 0:
+        sys.exit(f"{args.trace}: no read of a read-only object")
+
+    ranked = sorted(reads.items(), key=lambda item: item[1] / objects[item[0]][1], reverse=True)
+    budget = int(args.size, 0)
+    used = 0
+    selected = []
+    for o, n in ranked:
+        _, size, name, sect = objects[o]
+        # Already in RAM, or too few reads to be worth it
+        if sect.startswith(".ram_rodata") or n < args.min_share * total:
+            continue
+        if budget and used + ((size + 3) & ~3) > budget:
+            continue
+        used += (size + 3) & ~3
+        selected.append((name, size, n))
+
+    print(f"{'object':<32} {'section':<12} {'bytes':>8} {'reads':>10} {'reads/B':>8} {'share':>6}")
+    chosen = {name for name, _, _ in selected}
+    for o, n in ranked[:args.top]:
+        _, size, name, sect = objects[o]
+        mark = " *" if name in chosen else ""
+        print(f"{name:<32} {sect:<12} {size:8d} {n:10d} {n / size:8.1f} {100.0 * n / total:5.1f}%{mark}")
+
+    with open(args.output, "w") as out:
+        out.write(f"/* Hot constants of {args.trace}, generated by util/hot_rodata.py */\n")
+        for name, size, n in selected:
+            out.write(f"*(.rodata.{name} .srodata.{name}) /* {size} B, {100.0 * n / total:.1f}% of the reads */\n")
+
+    covered = sum(n for _, _, n in selected)
+    print(f"{len(selected)} objects (*), {used} B, {100.0 * covered / total:.1f}% of the reads, written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
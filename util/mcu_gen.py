@@ -19,6 +19,8 @@ from mako.template import Template
 import collections
 from math import log2
 import x_heep_gen.load_config
+import x_heep_gen.bank_analysis
+import gen_cache
 from x_heep_gen.system import BusType
 
 class Pad:
@@ -291,10 +293,10 @@ def write_template(tpl_path, outdir, outfile, **kwargs):
                 filename = outdir / tpl_path.with_suffix("").name
             else:
                 filename = outfile
-            with open(filename, "w") as file:
-                code = tpl.render_unicode(**kwargs)
-                code = re_trailws.sub("", code)
-                file.write(code)
+            code = tpl.render_unicode(**kwargs)
+            code = re_trailws.sub("", code)
+            # Only write the outputs that changed, so that the models depending on them are not rebuilt
+            gen_cache.write_if_changed(filename, code)
         else:
             raise FileNotFoundError
 
@@ -390,6 +392,18 @@ def main():
                         const=None,
                         help="Name of the hjson file contaiting extra pads")
 
+    parser.add_argument("--analyze_trace",
+                        metavar="TRACE",
+                        help="Bus trace of the testharness (+bus_trace=<file>): reports the bank conflicts and the speed-up of other memory configurations instead of generating files")
+
+    parser.add_argument("--analyze_map",
+                        metavar="MAP",
+                        help="Linker map of the traced application, to name the data waiting for its bank and choose what goes in the interleaved banks")
+
+    parser.add_argument("--analyze_il_symbols",
+                        metavar="SYMBOLS",
+                        help="Comma-separated symbols of the map placed in the interleaved banks of the candidates (default: the ones waiting the most)")
+
     parser.add_argument("-v",
                         "--verbose",
                         help="increase output verbosity",
@@ -432,6 +446,10 @@ def main():
     else:
         cpu_type = obj['cpu_type']
 
+    xif_coprocessor = obj.get('xif_coprocessor', 'fpu_ss')
+    if xif_coprocessor not in ('none', 'fpu_ss', 'xif_mac'):
+        exit("xif_coprocessor must be none, fpu_ss or xif_mac instead of " + str(xif_coprocessor))
+
     if args.bus != None and args.bus != '':
         config_override.bus_type = BusType(args.bus)
 
@@ -453,6 +471,11 @@ def main():
 
     xheep = x_heep_gen.load_config.load_cfg_file(pathlib.PurePath(str(args.config)), config_override)
 
+    if args.analyze_trace:
+        il_symbols = args.analyze_il_symbols.split(",") if args.analyze_il_symbols else None
+        print(x_heep_gen.bank_analysis.analyze(xheep, args.analyze_trace, args.analyze_map, il_symbols))
+        return
+
 
 
     debug_start_address = string2int(obj['debug']['address'])
@@ -467,6 +490,12 @@ def main():
 
     ao_peripheral_size_address = string2int(obj['ao_peripherals']['length'])
 
+    # Requests in flight on the path to each peripheral bus, 1 serialises them
+    ao_peripheral_outstanding = int(obj['ao_peripherals'].get('outstanding', 1))
+    peripheral_outstanding = int(obj['peripherals'].get('outstanding', 1))
+    if not 1 <= ao_peripheral_outstanding <= 8 or not 1 <= peripheral_outstanding <= 8:
+        exit("the outstanding requests of the peripheral buses must be between 1 and 8")
+
 
     def extract_peripherals(peripherals):
         result = {}
@@ -487,7 +516,7 @@ def main():
         new = {}
         for k,v in peripherals.items():
             if isinstance(v, dict):
-                new[k] = {key:val for key,val in v.items() if key not in ("path")}
+                new[k] = {key:val for key,val in v.items() if key not in ("path", "num_channels", "ch_length", "wide_width", "trigger_slots", "cache_size", "cache_line_size")}
             else:
                 new[k] = v
         return new
@@ -505,6 +534,98 @@ def main():
     ao_peripherals = extract_peripherals(discard_path(obj['ao_peripherals']))
     ao_peripherals_count = len(ao_peripherals)
 
+    dma_ch_count = int(obj['ao_peripherals']['dma'].get('num_channels', 1))
+    dma_ch_size = string2int(obj['ao_peripherals']['dma'].get('ch_length', '0x100'))
+    if dma_ch_count < 1 or (dma_ch_count & (dma_ch_count - 1)) != 0:
+        exit("the number of DMA channels must be a power of 2 instead of " + str(dma_ch_count))
+    if int(dma_ch_size, 16) < int('80', 16) or (int(dma_ch_size, 16) & (int(dma_ch_size, 16) - 1)) != 0:
+        exit("the DMA channel length must be a power of 2 of at least 0x80 bytes instead of 0x" + dma_ch_size)
+    if dma_ch_count * int(dma_ch_size, 16) > int(ao_peripherals['dma']['length'], 16):
+        exit("the DMA channels do not fit in the DMA length 0x" + ao_peripherals['dma']['length'])
+
+    # Wide port of the DMA into the first interleaved group, one lane per bank
+    dma_wide_width = int(obj['ao_peripherals']['dma'].get('wide_width', 32))
+    if dma_wide_width not in (32, 64, 128):
+        exit("the DMA wide port must be 32, 64 or 128 bits instead of " + str(dma_wide_width))
+    dma_wide_lanes = dma_wide_width // 32
+    dma_wide_group = next(xheep.iter_il_groups(), None)
+    if dma_wide_lanes > 1 and (dma_wide_group is None or dma_wide_group.n < dma_wide_lanes):
+        exit("a DMA wide port of " + str(dma_wide_width) + " bits needs a group of at least " + str(dma_wide_lanes) + " interleaved banks")
+    if dma_wide_lanes > 1 and dma_wide_group.granularity != 4:
+        exit("a DMA wide port needs a group of banks interleaved by words instead of " + str(dma_wide_group.granularity) + " bytes")
+
+    # DMA request lines: the signals that ao_peripheral_subsystem can connect
+    # (DMA_TRIG_SRC_*), and the ones given a trigger slot, in the slot order
+    dma_trigger_sources = ["spi_rx", "spi_tx", "spi_flash_rx", "spi_flash_tx", "i2s", "ext_tx", "ext_rx", "pdm2pcm", "uart_rx", "uart_tx", "ext_acc_tx", "ext_acc_rx"]
+    dma_trigger_slots = list(obj['ao_peripherals']['dma'].get('trigger_slots', dma_trigger_sources))
+    if len(dma_trigger_slots) < 1 or len(dma_trigger_slots) > 16:
+        exit("the DMA has 1 to 16 trigger slots instead of " + str(len(dma_trigger_slots)))
+    for slot in dma_trigger_slots:
+        if slot not in dma_trigger_sources:
+            exit("unknown DMA trigger slot " + str(slot) + ", the sources are " + ", ".join(dma_trigger_sources))
+        if dma_trigger_slots.count(slot) > 1:
+            exit("the DMA trigger slot " + slot + " is given twice")
+
+    flash_cache_size = string2int(obj['ao_peripherals']['spi_memio'].get('cache_size', '0x0'))
+    flash_cache_line_size = string2int(obj['ao_peripherals']['spi_memio'].get('cache_line_size', '0x10'))
+    if int(flash_cache_line_size, 16) < 4 or (int(flash_cache_line_size, 16) & (int(flash_cache_line_size, 16) - 1)) != 0:
+        exit("the flash cache line size must be a power of 2 of at least 4 bytes instead of 0x" + flash_cache_line_size)
+    if int(flash_cache_size, 16) != 0 and (int(flash_cache_size, 16) < int(flash_cache_line_size, 16) or (int(flash_cache_size, 16) & (int(flash_cache_size, 16) - 1)) != 0):
+        exit("the flash cache size must be 0 or a power of 2 of at least one line instead of 0x" + flash_cache_size)
+
+    instr_buffer = obj.get('instr_buffer', {})
+    instr_buffer_lines = int(instr_buffer.get('lines', 0))
+    instr_buffer_line_size = string2int(instr_buffer.get('line_size', '0x10'))
+    if not 0 <= instr_buffer_lines <= 16:
+        exit("the instruction buffer has 0 to 16 lines instead of " + str(instr_buffer_lines))
+    if int(instr_buffer_line_size, 16) not in (4, 8, 16, 32, 64):
+        exit("the instruction buffer line size must be a power of 2 from 4 to 64 bytes instead of 0x" + instr_buffer_line_size)
+
+    posted_write_buffer_depth = int(obj.get('posted_write_buffer', {}).get('depth', 0))
+    if not 0 <= posted_write_buffer_depth <= 8:
+        exit("the posted write buffer has 0 to 8 entries instead of " + str(posted_write_buffer_depth))
+
+    # Extra harts of the cluster, each one with an instruction and a data master
+    # after the masters of the DMA
+    num_harts = int(obj.get('num_harts', 1))
+    if not 1 <= num_harts <= 8:
+        exit("num_harts must be between 1 and 8 instead of " + str(num_harts))
+    if num_harts > 1:
+        if xheep.bus_type() != BusType.NtoM:
+            exit("a cluster of " + str(num_harts) + " harts needs the NtoM bus")
+        if obj['peripherals'].get('cluster_ctrl', {}).get('is_included', 'no') != 'yes':
+            exit("a cluster of " + str(num_harts) + " harts needs the cluster_ctrl peripheral")
+    hart_stack_size = string2int(obj['linker_script'].get('hart_stack_size', '0x400'))
+
+    # Arbitration of the system crossbar, packed in the order of the master indices
+    bus_qos = obj.get('bus_qos', {})
+    bus_qos_masters = {
+        'core_instr': [0],
+        'core_data': [1],
+        'debug': [2],
+        'dma': [3, 4, 5],
+        'cluster': list(range(6, 6 + 2 * (num_harts - 1))),
+    }
+    bus_qos_window = int(bus_qos.get('window', 0))
+    if not 0 <= bus_qos_window < 2**16:
+        exit("the bus_qos window must fit in 16 bits instead of " + str(bus_qos_window))
+    bus_qos_priority = 0
+    bus_qos_budget = 0
+    for master, idx_list in bus_qos_masters.items():
+        priority = int(bus_qos.get(master, {}).get('priority', 0))
+        budget = int(bus_qos.get(master, {}).get('budget', 0))
+        if not 0 <= priority <= 3:
+            exit("the bus_qos priority of " + master + " must be between 0 and 3")
+        if not 0 <= budget <= 15:
+            exit("the bus_qos budget of " + master + " must be between 0 and 15 sixteenths")
+        for idx in idx_list:
+            if idx < 16:
+                bus_qos_priority |= priority << (2 * idx)
+            if idx < 8:
+                bus_qos_budget |= budget << (4 * idx)
+    bus_qos_priority = f"{bus_qos_priority:08X}"
+    bus_qos_budget = f"{bus_qos_budget:08X}"
+
 
     peripheral_start_address = string2int(obj['peripherals']['address'])
     if int(peripheral_start_address, 16) < int('10000', 16):
@@ -527,6 +648,9 @@ def main():
     if ((int(stack_size,16) + int(heap_size,16)) > xheep.ram_size_address()):
         exit("The stack and heap section must fit in the RAM size, instead they takes " + str(stack_size + heap_size))
 
+    if (num_harts - 1) * int(hart_stack_size, 16) > xheep.ram_size_address():
+        exit("The stacks of the extra harts must fit in the RAM size")
+
 
     plic_used_n_interrupts = len(obj['interrupts']['list'])
     plit_n_interrupts = obj['interrupts']['number']
@@ -815,15 +939,34 @@ def main():
     kwargs = {
         "xheep"                            : xheep,
         "cpu_type"                         : cpu_type,
+        "xif_coprocessor"                  : xif_coprocessor,
+        "num_harts"                        : num_harts,
+        "hart_stack_size"                  : hart_stack_size,
         "external_domains"                 : external_domains,
         "debug_start_address"              : debug_start_address,
         "debug_size_address"               : debug_size_address,
         "ao_peripheral_start_address"      : ao_peripheral_start_address,
         "ao_peripheral_size_address"       : ao_peripheral_size_address,
+        "ao_peripheral_outstanding"        : ao_peripheral_outstanding,
         "ao_peripherals"                   : ao_peripherals,
         "ao_peripherals_count"             : ao_peripherals_count,
+        "dma_ch_count"                     : dma_ch_count,
+        "dma_ch_size"                      : dma_ch_size,
+        "dma_wide_lanes"                   : dma_wide_lanes,
+        "dma_wide_group"                   : dma_wide_group,
+        "dma_trigger_sources"              : dma_trigger_sources,
+        "dma_trigger_slots"                : dma_trigger_slots,
+        "flash_cache_size"                 : flash_cache_size,
+        "flash_cache_line_size"            : flash_cache_line_size,
+        "instr_buffer_lines"               : instr_buffer_lines,
+        "instr_buffer_line_size"           : instr_buffer_line_size,
+        "posted_write_buffer_depth"        : posted_write_buffer_depth,
+        "bus_qos_priority"                 : bus_qos_priority,
+        "bus_qos_budget"                   : bus_qos_budget,
+        "bus_qos_window"                   : bus_qos_window,
         "peripheral_start_address"         : peripheral_start_address,
         "peripheral_size_address"          : peripheral_size_address,
+        "peripheral_outstanding"           : peripheral_outstanding,
         "peripherals"                      : peripherals,
         "peripherals_count"                : peripherals_count,
         "ext_slave_start_address"          : ext_slave_start_address,
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Parallel regression runner for the applications in sw/applications.
+#
+# For every configuration, the MCU is generated and the Verilator model is built
+# once, then every (app, linker, compiler) is compiled. As the sw build folder is
+# shared, compilation is serial, while the simulations are spread over N workers,
+# each one running in its own folder. A simulation is skipped if a passing result
+# with the same firmware, model and options is found in the cache.
+
+import argparse
+import concurrent.futures
+import hashlib
+import json
+import os
+import pathlib
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+SIM_DIR = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0" / "sim-verilator"
+EXIT_RE = re.compile(r"Program Finished with value (\d+)")
+
+# Applications that are not simulated, as in util/test_all.sh
+BLACKLIST = ["example_virtual_flash"]
+
+
+def sha256(path):
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 20), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def make(*args, log=None):
+    cmd = ["make", "-C", str(ROOT), "--no-print-directory"] + list(args)
+    with open(log if log else os.devnull, "w") as out:
+        return subprocess.run(cmd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def build_model(config, outdir):
+    """Generates the MCU for config and builds the Verilator model, returns the model path"""
+    if not make("mcu-gen", "X_HEEP_CFG=" + config, "EXTERNAL_DOMAINS=1", log=outdir / "mcu-gen.log"):
+        return None
+    if not make("verilator-sim", log=outdir / "verilator-sim.log"):
+        return None
+    # keep a private copy so that the next configuration can rebuild the model
+    model = outdir / "Vtestharness"
+    shutil.copy2(SIM_DIR / "Vtestharness", model)
+    return model
+
+
+def build_app(app, linker, compiler, jobdir):
+    start = time.time()
+    ok = make("app", "PROJECT=" + app, "LINKER=" + linker, "COMPILER=" + compiler, log=jobdir / "build.log")
+    if ok:
+        for ext in ["hex", "elf"]:
+            shutil.copy2(ROOT / "sw" / "build" / ("main." + ext), jobdir / ("main." + ext))
+    return ok, time.time() - start
+
+
+def simulate(job, timeout):
+    """Runs one simulation in its own folder, so that uart0.log and the waveform are not shared"""
+    cmd = [str(job["model"]), "+firmware=" + str(job["dir"] / "main.hex"), "+trace=off"] + job["plusargs"]
+    start = time.time()
+    try:
+        out = subprocess.run(cmd, cwd=job["dir"], capture_output=True, text=True, timeout=timeout)
+        (job["dir"] / "sim.log").write_text(out.stdout + out.stderr)
+        m = EXIT_RE.search(out.stdout)
+        exit_value = int(m.group(1)) if m else None
+        status = "pass" if out.returncode == 0 and exit_value == 0 else "fail"
+        return {"status": status, "returncode": out.returncode, "exit_value": exit_value, "sim_time_s": time.time() - start}
+    except subprocess.TimeoutExpired:
+        return {"status": "timeout", "returncode": None, "exit_value": None, "sim_time_s": time.time() - start}
+
+
+def simulate_batch(jobs, batchdir, timeout, max_cycles):
+    """Runs the firmware of several jobs of the same model in one simulation (+firmware_list)"""
+    batchdir.mkdir(parents=True, exist_ok=True)
+    (batchdir / "firmware_list.txt").write_text("".join(str(job["dir"] / "main.hex") + "\n" for job in jobs))
+    report = batchdir / "batch_report.json"
+    report.unlink(missing_ok=True)
+    cmd = [str(jobs[0]["model"]), "+firmware_list=firmware_list.txt", "+batch_report=" + str(report),
+           "+trace=off"] + (["+batch_max_cycles={}".format(max_cycles)] if max_cycles else []) + jobs[0]["plusargs"]
+    start = time.time()
+    try:
+        out = subprocess.run(cmd, cwd=batchdir, capture_output=True, text=True, timeout=timeout * len(jobs))
+        (batchdir / "sim.log").write_text(out.stdout + out.stderr)
+        images = json.loads(report.read_text())["images"] if report.exists() else []
+    except subprocess.TimeoutExpired:
+        images = []
+    results = []
+    for i, job in enumerate(jobs):
+        if i < len(images):
+            results.append({"status": images[i]["status"], "returncode": None,
+                            "exit_value": images[i]["exit_value"] if images[i]["exit_valid"] else None,
+                            "sim_time_s": images[i]["wall_time_s"]})
+        else:
+            # the batch stopped before this image
+            results.append({"status": "timeout", "returncode": None, "exit_value": None,
+                            "sim_time_s": time.time() - start})
+    return results
+
+
+def regress(args, outdir, apps, cache, cache_file):
+    """Builds and simulates the jobs, writes the cache and the report, returns the failed jobs"""
+    report = {"jobs": []}
+    sim_jobs = []
+    for config in args.configs:
+        cfg_name = pathlib.Path(config).stem
+        cfg_dir = outdir / cfg_name
+        cfg_dir.mkdir(parents=True, exist_ok=True)
+
+        model = None
+        if args.simulator != "none":
+            print("Building the model for " + config)
+            model = build_model(config, cfg_dir)
+            if model is None:
+                print("Failed building the model for {}, see {}".format(config, cfg_dir))
+                report["jobs"].append({"config": config, "status": "model_build_fail"})
+                continue
+        else:
+            make("mcu-gen", "X_HEEP_CFG=" + config, "EXTERNAL_DOMAINS=1", log=cfg_dir / "mcu-gen.log")
+
+        for app in apps:
+            for linker in args.linkers:
+                for compiler in args.compilers:
+                    jobdir = cfg_dir / "{}-{}-{}".format(app, linker, compiler)
+                    jobdir.mkdir(parents=True, exist_ok=True)
+                    job = {"config": config, "app": app, "linker": linker, "compiler": compiler,
+                           "simulator": args.simulator}
+                    ok, build_time = build_app(app, linker, compiler, jobdir)
+                    job["build"] = "pass" if ok else "fail"
+                    job["build_time_s"] = build_time
+                    print("{:8} build {} ({}, {}, {})".format(job["build"], app, cfg_name, linker, compiler))
+                    report["jobs"].append(job)
+                    if not ok or model is None or app in BLACKLIST or linker != "on_chip":
+                        # flash linkers require booting from flash, not supported in Verilator
+                        job["status"] = "skipped" if ok else "build_fail"
+                        continue
+                    job["key"] = hashlib.sha256("{}:{}:{}".format(
+                        sha256(jobdir / "main.hex"), sha256(model), " ".join(args.plusargs)).encode()).hexdigest()
+                    if not args.no_cache and cache.get(job["key"], {}).get("status") == "pass":
+                        job.update(cache[job["key"]])
+                        job["cached"] = True
+                        continue
+                    job["cached"] = False
+                    job["model"] = model
+                    job["dir"] = jobdir
+                    job["plusargs"] = args.plusargs
+                    sim_jobs.append(job)
+
+    def done(job, result):
+        job.update(result)
+        print("{:8} sim   {} ({}, {:.1f} s)".format(job["status"], job["app"], pathlib.Path(job["config"]).stem, job["sim_time_s"]))
+        cache[job["key"]] = {k: job[k] for k in ["status", "returncode", "exit_value", "sim_time_s"]}
+
+    print("Running {} simulations on {} workers".format(len(sim_jobs), args.jobs))
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        if args.batch:
+            # one batch per worker and per model
+            batches = []
+            for model in dict.fromkeys(job["model"] for job in sim_jobs):
+                jobs = [job for job in sim_jobs if job["model"] == model]
+                for w in range(min(args.jobs, len(jobs))):
+                    batches.append((model.parent / "batch{}".format(w), jobs[w::args.jobs]))
+            futures = {pool.submit(simulate_batch, jobs, batchdir, args.timeout, args.batch_max_cycles): jobs
+                       for batchdir, jobs in batches}
+            for future in concurrent.futures.as_completed(futures):
+                for job, result in zip(futures[future], future.result()):
+                    done(job, result)
+        else:
+            futures = {pool.submit(simulate, job, args.timeout): job for job in sim_jobs}
+            for future in concurrent.futures.as_completed(futures):
+                done(futures[future], future.result())
+
+    for job in report["jobs"]:
+        job.pop("model", None)
+        job.pop("dir", None)
+        job.pop("plusargs", None)
+    cache_file.write_text(json.dumps(cache, indent=2))
+    (outdir / "report.json").write_text(json.dumps(report, indent=2))
+
+    failures = [j for j in report["jobs"] if j.get("status") not in ["pass", "skipped"]]
+    print("\n{} jobs, {} failures, report in {}".format(len(report["jobs"]), len(failures), outdir / "report.json"))
+    for j in failures:
+        print("  {} {} ({})".format(j.get("status"), j.get("app", ""), j["config"]))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parallel regression of the X-HEEP applications")
+    parser.add_argument("--configs", nargs="+", default=["configs/testall.hjson"], help="X-HEEP configurations")
+    parser.add_argument("--apps", nargs="*", help="applications to test (default: all of sw/applications)")
+    parser.add_argument("--linkers", nargs="+", default=["on_chip"])
+    parser.add_argument("--compilers", nargs="+", default=["gcc"])
+    parser.add_argument("--simulator", default="verilator", choices=["verilator", "none"])
+    parser.add_argument("--plusargs", nargs="*", default=[], help="extra simulation options, e.g. +max_sim_time=...")
+    parser.add_argument("-j", "--jobs", type=int, default=1, help="number of parallel simulations")
+    parser.add_argument("--timeout", type=int, default=120, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="regression", help="working folder, also holds the cache")
+    parser.add_argument("--no-cache", action="store_true", help="simulate even if a cached result matches")
+    parser.add_argument("--batch", action="store_true",
+                        help="run the applications of a worker in one simulation, the model is elaborated once")
+    parser.add_argument("--batch-max-cycles", type=int, help="cycles after which an application of a batch is stopped")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    cache_file = outdir / "cache.json"
+    cache = json.loads(cache_file.read_text()) if cache_file.exists() else {}
+
+    apps = args.apps or sorted(p.name for p in (ROOT / "sw" / "applications").iterdir() if p.is_dir())
+
+    # All peripherals are included to make sure all apps can be built, as in util/test_all.sh.
+    # The tracked configuration is restored at the end, even if the regression is interrupted.
+    mcu_cfg = ROOT / "mcu_cfg.hjson"
+    mcu_cfg_text = mcu_cfg.read_text()
+    mcu_cfg.write_text(mcu_cfg_text.replace('is_included: "no",', 'is_included: "yes",'))
+    try:
+        failures = regress(args, outdir, apps, cache, cache_file)
+    finally:
+        mcu_cfg.write_text(mcu_cfg_text)
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
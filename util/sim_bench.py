@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Simulation throughput benchmark of the testbenches.
+#
+# For every simulator, the model is built (the build time is measured) and a fixed set of
+# applications is simulated. For every (simulator, app), the simulated cycles per wall-clock
+# second and the peak RSS of the simulation are reported. Results are compared with the
+# baseline saved for this host, and a slow-down above the tolerance is reported as a failure.
+
+import argparse
+import json
+import os
+import pathlib
+import platform
+import re
+import subprocess
+import sys
+import threading
+import time
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+BUILD = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0"
+FIRMWARE = ROOT / "sw" / "build" / "main.hex"
+CYCLES_RE = re.compile(r"\[TESTBENCH\]: Simulated (\d+) cycles")
+
+# make target building the model, work folder and command running the firmware
+SIMULATORS = {
+    "verilator": ("verilator-sim", BUILD / "sim-verilator",
+                  ["./Vtestharness", "+firmware=" + str(FIRMWARE), "+trace=off"]),
+    "verilator-opt": ("verilator-sim-opt", BUILD / "sim_opt-verilator",
+                      ["./Vtestharness", "+firmware=" + str(FIRMWARE), "+trace=off"]),
+    "verilator-pgo": ("verilator-sim-pgo", BUILD / "sim_pgo-verilator",
+                      ["./Vtestharness", "+firmware=" + str(FIRMWARE), "+trace=off"]),
+    "verilator-sc": ("verilator-sim-sc", BUILD / "sim_sc-verilator",
+                     ["./Vtestharness", "+firmware=" + str(FIRMWARE), "+trace=off"]),
+    "questasim": ("questasim-sim", BUILD / "sim-modelsim",
+                  ["make", "run", "PLUSARGS=c firmware=" + str(FIRMWARE)]),
+    "vcs": ("vcs-sim", BUILD / "sim-vcs",
+            ["./openhwgroup.org_systems_core-v-mini-mcu_0", "+firmware=" + str(FIRMWARE)]),
+}
+
+DEFAULT_APPS = ["hello_world", "coremark", "example_matmul", "example_dma", "example_spi_read"]
+
+
+def run(cmd, cwd, timeout, log):
+    """Runs cmd, returns (exit code, wall time, peak RSS in MB of cmd and the children it waited for)"""
+    start = time.time()
+    with open(log, "w") as out:
+        proc = subprocess.Popen(cmd, cwd=cwd, stdout=out, stderr=subprocess.STDOUT)
+        timer = threading.Timer(timeout, proc.kill) if timeout else None
+        if timer:
+            timer.start()
+        # wait4 also reports the peak RSS of the simulator processes started by make (e.g. vsim)
+        _, status, rusage = os.wait4(proc.pid, 0)
+        if timer:
+            timer.cancel()
+    return os.waitstatus_to_exitcode(status), time.time() - start, rusage.ru_maxrss / 1024
+
+
+def make(*args, log):
+    cmd = ["make", "-C", str(ROOT), "--no-print-directory"] + list(args)
+    return run(cmd, ROOT, None, log)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulation throughput benchmark")
+    parser.add_argument("--simulators", nargs="+", default=["verilator", "verilator-sc"], choices=SIMULATORS.keys())
+    parser.add_argument("--apps", nargs="+", default=DEFAULT_APPS, help="applications in sw/applications")
+    parser.add_argument("--no-build", action="store_true", help="use the models already built")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="sim_bench", help="folder of the logs and results")
+    parser.add_argument("--baseline", default="sim_bench_baseline.json", help="baselines, per host")
+    parser.add_argument("--save-baseline", action="store_true", help="store the results as the baseline of this host")
+    parser.add_argument("--tolerance", type=float, default=0.1, help="accepted slow-down w.r.t. the baseline")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    host = platform.node()
+    results = {"host": host, "cpu": platform.processor(), "models": {}, "runs": []}
+
+    for sim in args.simulators:
+        target, work_dir, _ = SIMULATORS[sim]
+        if args.no_build:
+            continue
+        print("Building the {} model".format(sim))
+        ret, wall, rss = make(target, log=outdir / "build-{}.log".format(sim))
+        results["models"][sim] = {"build": "pass" if ret == 0 else "fail", "build_time_s": wall, "build_rss_mb": rss}
+
+    for app in args.apps:
+        ret, _, _ = make("app", "PROJECT=" + app, log=outdir / "app-{}.log".format(app))
+        if ret != 0:
+            print("Failed building " + app)
+            results["runs"].append({"app": app, "status": "app_build_fail"})
+            continue
+        for sim in args.simulators:
+            _, work_dir, cmd = SIMULATORS[sim]
+            entry = {"app": app, "simulator": sim}
+            results["runs"].append(entry)
+            if results["models"].get(sim, {}).get("build") == "fail" or not work_dir.exists():
+                entry["status"] = "no_model"
+                continue
+            log = outdir / "sim-{}-{}.log".format(sim, app)
+            ret, wall, rss = run(cmd, work_dir, args.timeout, log)
+            m = CYCLES_RE.search(log.read_text(errors="replace"))
+            entry.update({"status": "pass" if ret == 0 and m else "fail", "wall_time_s": wall, "peak_rss_mb": rss})
+            if m:
+                entry["cycles"] = int(m.group(1))
+                entry["cycles_per_s"] = int(m.group(1)) / wall
+            print("{:12} {:20} {}".format(sim, app, "{:.0f} cycles/s".format(entry["cycles_per_s"]) if m else entry["status"]))
+
+    # compare with the baseline of this host
+    baseline_file = ROOT / args.baseline
+    baselines = json.loads(baseline_file.read_text()) if baseline_file.exists() else {}
+    baseline = {(r["simulator"], r["app"]): r for r in baselines.get(host, {}).get("runs", []) if "cycles_per_s" in r}
+    regressions = []
+    for r in results["runs"]:
+        ref = baseline.get((r.get("simulator"), r["app"]))
+        if ref and "cycles_per_s" in r:
+            r["baseline_cycles_per_s"] = ref["cycles_per_s"]
+            r["speed_ratio"] = r["cycles_per_s"] / ref["cycles_per_s"]
+            if r["speed_ratio"] < 1 - args.tolerance:
+                regressions.append(r)
+
+    # speed of the other models w.r.t. the default Verilator one, on the same run
+    reference = {r["app"]: r["cycles_per_s"] for r in results["runs"] if r.get("simulator") == "verilator" and "cycles_per_s" in r}
+    for r in results["runs"]:
+        if r["app"] in reference and "cycles_per_s" in r:
+            r["speedup_vs_verilator"] = r["cycles_per_s"] / reference[r["app"]]
+
+    with open(outdir / "results.json", "w") as f:
+        json.dump(results, f, indent=2)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("| simulator | build time (s) | app | cycles | cycles/s | vs verilator | peak RSS (MB) | vs baseline |\n")
+        f.write("|-----------|----------------|-----|--------|----------|--------------|---------------|-------------|\n")
+        for r in results["runs"]:
+            if "cycles_per_s" not in r:
+                f.write("| {} | - | {} | {} | - | - | - | - |\n".format(r.get("simulator", "-"), r["app"], r["status"]))
+                continue
+            build = results["models"].get(r["simulator"], {}).get("build_time_s")
+            f.write("| {} | {} | {} | {} | {:.0f} | {} | {} | {} |\n".format(
+                r["simulator"], "{:.0f}".format(build) if build else "-", r["app"], r["cycles"], r["cycles_per_s"],
+                "{:.2f}x".format(r["speedup_vs_verilator"]) if "speedup_vs_verilator" in r else "-",
+                "{:.0f}".format(r["peak_rss_mb"]),
+                "{:.2f}x".format(r["speed_ratio"]) if "speed_ratio" in r else "-"))
+    print(open(outdir / "results.md").read())
+
+    if args.save_baseline:
+        baselines[host] = results
+        baseline_file.write_text(json.dumps(baselines, indent=2))
+        print("Baseline of {} saved in {}".format(host, baseline_file))
+
+    for r in regressions:
+        print("Slow-down of {} on {}: {:.2f}x the baseline".format(r["simulator"], r["app"], r["speed_ratio"]))
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Code and data size of an application per function, object and library.
+#
+# The symbols of the ELF are read with their size and source file from `nm -S -l`, which takes
+# the files from the debug information, so that the sources linked as temporary or LTO objects
+# are still found. Each symbol is counted in the code, rodata, data or bss column from the
+# section it is in, and in the library of its source file: the drivers, the SDK and the runtime
+# of sw/device/lib, FreeRTOS, external, or the application for the other sources. The symbols
+# without source file come from newlib and libgcc, built without debug information.
+#
+# The report lists the libraries and the largest symbols, and the full list goes to --output.
+# With --baseline, a file written with --json by an earlier build, it also lists the libraries
+# and the symbols whose size changed, so that a change of a driver that adds code to every
+# application shows before it takes the space of the buffers. A baseline that does not exist
+# yet is written with the sizes of this build.
+
+import argparse
+import json
+import os
+import re
+import struct
+import subprocess
+import sys
+
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+
+KINDS = ["code", "rodata", "data", "bss"]
+
+# Library of a source file, the first match
+LIBRARIES = [
+    ("drivers", re.compile(r"/device/lib/drivers/")),
+    ("sdk", re.compile(r"/device/lib/sdk/")),
+    ("runtime", re.compile(r"/device/lib/(runtime|base|crt|cpp)/")),
+    ("freertos", re.compile(r"/freertos|FreeRTOS")),
+    ("external", re.compile(r"/external/")),
+    ("newlib", re.compile(r"newlib|libgloss|libgcc")),
+]
+
+
+def read_sections(elf_path):
+    """Return the (start, end, kind) of the allocated sections of a 32-bit little-endian ELF."""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit(f"{elf_path}: not a 32-bit little-endian ELF")
+
+    shoff, = struct.unpack_from("<I", elf, 0x20)
+    shentsize, shnum, _ = struct.unpack_from("<HHH", elf, 0x2E)
+
+    sections = []
+    for i in range(shnum):
+        # name, type, flags, addr, offset, size
+        _, sh_type, flags, addr, _, size = struct.unpack_from("<IIIIII", elf, shoff + i * shentsize)
+        if not flags & SHF_ALLOC or size == 0:
+            continue
+        if flags & SHF_EXECINSTR:
+            kind = "code"
+        elif sh_type == SHT_NOBITS:
+            kind = "bss"
+        elif flags & SHF_WRITE:
+            kind = "data"
+        else:
+            kind = "rodata"
+        sections.append((addr, addr + size, kind))
+    return sections
+
+
+def library_of(path):
+    if not path:
+        return "newlib"
+    for name, pattern in LIBRARIES:
+        if pattern.search(path):
+            return name
+    return "app"
+
+
+def read_symbols(elf_path, nm):
+    """Return the sized symbols of the ELF: {key: {name, file, library, kind, size}}."""
+    sections = read_sections(elf_path)
+    try:
+        out = subprocess.run([nm, "-S", "-l", "--defined-only", elf_path],
+                             capture_output=True, text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit(f"{nm}: {e}")
+
+    symbols = {}
+    for line in out.splitlines():
+        fields, _, location = line.partition("\t")
+        fields = fields.split()
+        if len(fields) != 4:
+            continue
+        addr, size, name = int(fields[0], 16), int(fields[1], 16), fields[3]
+        if size == 0:
+            continue
+        kind = next((k for start, end, k in sections if start <= addr < end), None)
+        if kind is None:
+            continue
+        path = location.rsplit(":", 1)[0] if location else ""
+        # the local symbols of different files may have the same name
+        key = name if fields[2].isupper() else f"{name}@{os.path.basename(path)}"
+        if key in symbols:
+            continue
+        symbols[key] = {"name": name, "file": path, "library": library_of(path), "kind": kind, "size": size}
+    if not symbols:
+        sys.exit(f"{elf_path}: no sized symbols, is it stripped?")
+    return symbols
+
+
+def library_totals(symbols):
+    totals = {}
+    for s in symbols.values():
+        totals.setdefault(s["library"], dict.fromkeys(KINDS, 0))[s["kind"]] += s["size"]
+    return totals
+
+
+def print_libraries(totals, out):
+    out.write(f"  {'library':<10}" + "".join(f"{k:>9}" for k in KINDS) + f"{'total':>9}\n")
+    for lib in sorted(totals, key=lambda lib: -sum(totals[lib].values())):
+        out.write(f"  {lib:<10}" + "".join(f"{totals[lib][k]:>9}" for k in KINDS)
+                  + f"{sum(totals[lib].values()):>9}\n")
+    out.write(f"  {'all':<10}" + "".join(f"{sum(t[k] for t in totals.values()):>9}" for k in KINDS)
+              + f"{sum(sum(t.values()) for t in totals.values()):>9}\n")
+
+
+def print_symbols(symbols, keys, out):
+    for key in keys:
+        s = symbols[key]
+        out.write(f"  {s['size']:>7}  {s['kind']:<6}  {s['library']:<8}  {key}\n")
+
+
+def print_diff(symbols, baseline, top, out):
+    totals, base_totals = library_totals(symbols), library_totals(baseline)
+    out.write("\nDifference from the baseline, per library\n")
+    out.write(f"  {'library':<10}" + "".join(f"{k:>9}" for k in KINDS) + f"{'total':>9}\n")
+    for lib in sorted(set(totals) | set(base_totals)):
+        now = totals.get(lib, dict.fromkeys(KINDS, 0))
+        before = base_totals.get(lib, dict.fromkeys(KINDS, 0))
+        delta = {k: now[k] - before[k] for k in KINDS}
+        if any(delta.values()):
+            out.write(f"  {lib:<10}" + "".join(f"{delta[k]:>+9}" for k in KINDS)
+                      + f"{sum(delta.values()):>+9}\n")
+
+    changes = []
+    for key in set(symbols) | set(baseline):
+        now = symbols[key]["size"] if key in symbols else 0
+        before = baseline[key]["size"] if key in baseline else 0
+        if now != before:
+            s = symbols.get(key) or baseline[key]
+            changes.append((now - before, before, now, s, key))
+    changes.sort(key=lambda c: -abs(c[0]))
+    out.write(f"\nSymbols whose size changed ({len(changes)}, the {min(top, len(changes))} largest changes)\n")
+    for delta, before, now, s, key in changes[:top]:
+        state = "new" if not before else "removed" if not now else f"{before} -> {now}"
+        out.write(f"  {delta:>+7}  {s['kind']:<6}  {s['library']:<8}  {key} ({state})\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Code and data size per function, object and library")
+    parser.add_argument("elf", help="ELF of the application")
+    parser.add_argument("--nm", default="riscv32-unknown-elf-nm", help="nm of the toolchain")
+    parser.add_argument("--top", type=int, default=20, help="Symbols and changes printed (default 20)")
+    parser.add_argument("-o", "--output", help="Write the size of every symbol to this file")
+    parser.add_argument("--json", help="Write the sizes to this file, the --baseline of later builds")
+    parser.add_argument("--baseline", help="Sizes written with --json by an earlier build, written if it does not exist")
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.elf, args.nm)
+    by_size = sorted(symbols, key=lambda key: (-symbols[key]["size"], key))
+
+    out = sys.stdout
+    out.write(f"Size of {args.elf} per library, in bytes\n")
+    print_libraries(library_totals(symbols), out)
+    out.write("\nLargest symbols\n")
+    print_symbols(symbols, by_size[:args.top], out)
+
+    if args.baseline:
+        if os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                print_diff(symbols, json.load(f), args.top, out)
+        else:
+            # the first build is the baseline of the next ones
+            with open(args.baseline, "w") as f:
+                json.dump(symbols, f, indent=1, sort_keys=True)
+            out.write(f"\nNo baseline yet, written to {args.baseline}\n")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(f"Size of {args.elf} per library, in bytes\n")
+            print_libraries(library_totals(symbols), f)
+            f.write("\nAll symbols\n")
+            print_symbols(symbols, by_size, f)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(symbols, f, indent=1, sort_keys=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Host side of the SPI slave of hw/ip_examples/obi_spi_slave, over a Linux spidev device
+# (python3-spidev), for a host processor driving X-HEEP as a co-processor.
+#
+#   spi_slave_host.py DEV write ADDR FILE           writes FILE to the memory map from ADDR
+#   spi_slave_host.py DEV read ADDR LENGTH FILE     saves LENGTH bytes from ADDR
+#   spi_slave_host.py DEV load ELF                  loads an application and starts it
+#   spi_slave_host.py DEV mailbox ELF CMD [ARG...]  sends a request to spi_slave_mailbox
+#   spi_slave_host.py DEV bench [ADDR]              times writes and reads of the RAM
+#
+# load writes the PT_LOAD segments of an application linked for the RAM (LINKER=on_chip),
+# then BOOT_ADDRESS and BOOT_EXIT_LOOP of soc_ctrl, which the boot ROM waits for with
+# boot_sel_i at 0 (JTAG boot). The SPI mode is 0, and the SCK at most half the system clock.
+
+import argparse
+import struct
+import sys
+import time
+
+from flash_lz import read_elf
+
+# As in spi_slave_host.h
+CMD_WRITE_MEM = 0x02
+CMD_READ_MEM = 0x0B
+CMD_WRITE_REG1 = 0x11
+DUMMY_CYCLES = 32
+
+# As in spi_slave_mailbox.h
+MAILBOX_MAGIC = 0x424D4858
+MAILBOX_ARGS = 4
+MAILBOX_RETS = 2
+
+SOC_CTRL_START_ADDRESS = 0x20000000
+SOC_CTRL_BOOT_EXIT_LOOP_REG_OFFSET = 0xC
+SOC_CTRL_BOOT_ADDRESS_REG_OFFSET = 0x10
+
+# Bytes of data in one spidev transfer, below its default bufsiz of 4096
+CHUNK = 4032
+
+
+def swap_words(data):
+    """Reverse the bytes of each word: the slave takes the words MSB first."""
+    data = bytes(data) + bytes(-len(data) % 4)
+    return b"".join(data[i:i + 4][::-1] for i in range(0, len(data), 4))
+
+
+class SpiSlave:
+    def __init__(self, device, speed):
+        import spidev
+
+        bus, cs = (int(x) for x in device.replace("/dev/spidev", "").split("."))
+        self.spi = spidev.SpiDev()
+        self.spi.open(bus, cs)
+        self.spi.mode = 0
+        self.spi.max_speed_hz = speed
+        # REG1 holds the dummy cycles minus 1
+        self.spi.xfer3([CMD_WRITE_REG1, DUMMY_CYCLES - 1])
+
+    def write(self, addr, data):
+        """Write bytes from a word-aligned address, padded to words."""
+        data = swap_words(data)
+        for offset in range(0, len(data), CHUNK):
+            header = struct.pack(">BI", CMD_WRITE_MEM, addr + offset)
+            self.spi.xfer3(header + data[offset:offset + CHUNK])
+
+    def read(self, addr, length):
+        """Read bytes from a word-aligned address."""
+        size = (length + 3) & ~3
+        data = bytearray()
+        for offset in range(0, size, CHUNK):
+            n = min(CHUNK, size - offset)
+            header = struct.pack(">BI", CMD_READ_MEM, addr + offset) + bytes(DUMMY_CYCLES // 8)
+            data += bytes(self.spi.xfer3(header + bytes(n)))[len(header):]
+        return swap_words(data)[:length]
+
+    def write_words(self, addr, *words):
+        self.write(addr, struct.pack(f"<{len(words)}I", *words))
+
+    def read_words(self, addr, count):
+        return struct.unpack(f"<{count}I", self.read(addr, 4 * count))
+
+
+def load(slave, elf_path, soc_ctrl):
+    segments, symbols = read_elf(elf_path)
+    if "_start" not in symbols:
+        sys.exit(f"{elf_path}: no symbol _start")
+    for paddr, data in segments:
+        slave.write(paddr, data)
+        if slave.read(paddr, len(data)) != data:
+            sys.exit(f"the segment at {paddr:#010x} was not written")
+    slave.write_words(soc_ctrl + SOC_CTRL_BOOT_ADDRESS_REG_OFFSET, symbols["_start"])
+    slave.write_words(soc_ctrl + SOC_CTRL_BOOT_EXIT_LOOP_REG_OFFSET, 1)
+    print(f"{sum(len(d) for _, d in segments)} bytes loaded, started at {symbols['_start']:#010x}",
+          file=sys.stderr)
+
+
+def mailbox(slave, elf_path, cmd, args, timeout):
+    """Send a request and return its status and results."""
+    _, symbols = read_elf(elf_path)
+    if "spi_slave_mailbox" not in symbols:
+        sys.exit(f"{elf_path}: no spi_slave_mailbox")
+    base = symbols["spi_slave_mailbox"]
+
+    magic, ack = slave.read_words(base, 2)
+    if magic != MAILBOX_MAGIC:
+        sys.exit("the mailbox is not served (no spi_slave_mailbox_init())")
+    doorbell = (ack + 1) & 0xFFFFFFFF
+    args = (list(args) + [0] * MAILBOX_ARGS)[:MAILBOX_ARGS]
+    # cmd, arg, then the doorbell, the last word written by the slave
+    slave.write_words(base + 4 * (3 + MAILBOX_RETS), cmd, *args, doorbell)
+
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        ack, status, *ret = slave.read_words(base + 4, 2 + MAILBOX_RETS)
+        if ack == doorbell:
+            return status, ret
+    sys.exit("no answer from the device")
+
+
+def bench(slave, addr, speed):
+    print(f"SCK {speed} Hz, {speed // 8} B/s at most")
+    for size in (256, 1024, 4096, 16384):
+        data = bytes((i * 7 + (i >> 8)) & 0xFF for i in range(size))
+        start = time.perf_counter()
+        slave.write(addr, data)
+        write_time = time.perf_counter() - start
+        start = time.perf_counter()
+        back = slave.read(addr, size)
+        read_time = time.perf_counter() - start
+        print(f"{size:6} bytes: write {size / write_time / 1e3:8.1f} kB/s, "
+              f"read {size / read_time / 1e3:8.1f} kB/s{'' if back == data else ', MISMATCH'}")
+
+
+def number(s):
+    return int(s, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Access X-HEEP through its SPI slave")
+    parser.add_argument("device", help="spidev device, e.g. /dev/spidev0.0")
+    parser.add_argument("--speed", type=int, default=1000000, help="SCK frequency in Hz")
+    parser.add_argument("--soc-ctrl", type=number, default=SOC_CTRL_START_ADDRESS,
+                        help="SOC_CTRL_START_ADDRESS of core_v_mini_mcu.h")
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("write")
+    p.add_argument("addr", type=number)
+    p.add_argument("file")
+    p = sub.add_parser("read")
+    p.add_argument("addr", type=number)
+    p.add_argument("length", type=number)
+    p.add_argument("file")
+    p = sub.add_parser("load")
+    p.add_argument("elf")
+    p = sub.add_parser("mailbox")
+    p.add_argument("elf")
+    p.add_argument("cmd", type=number)
+    p.add_argument("args", type=number, nargs="*")
+    p.add_argument("--timeout", type=float, default=1.0)
+    p = sub.add_parser("bench")
+    p.add_argument("addr", type=number, nargs="?", default=0x8000,
+                   help="scratch RAM, 16 kB (default 0x8000)")
+    args = parser.parse_args()
+
+    if args.command in ("write", "read") and args.addr % 4:
+        sys.exit("the address must be word aligned")
+
+    slave = SpiSlave(args.device, args.speed)
+    if args.command == "write":
+        with open(args.file, "rb") as f:
+            slave.write(args.addr, f.read())
+    elif args.command == "read":
+        with open(args.file, "wb") as f:
+            f.write(slave.read(args.addr, args.length))
+    elif args.command == "load":
+        load(slave, args.elf, args.soc_ctrl)
+    elif args.command == "mailbox":
+        status, ret = mailbox(slave, args.elf, args.cmd, args.args, args.timeout)
+        print(f"status {status:#x}, ret " + " ".join(f"{r:#010x}" for r in ret))
+        return 0 if status == 0 else 1
+    else:
+        bench(slave, args.addr, args.speed)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -54,7 +54,7 @@ def read_json(json_file):
     return j_data
 
 
-def write_template(tpl, structs, enums, struct_name):
+def write_template(tpl, structs, enums, struct_name, accessors=""):
     """
     Opens a given template and substitutes the structs and enums fields.
     Returns a string with the content of the updated template
@@ -76,6 +76,7 @@ def write_template(tpl, structs, enums, struct_name):
                                 peripheral_name=struct_name, 
                                 peripheral_name_upper=upper_case_name, 
                                 date=today,
+                                inline_functions=accessors,
                                 start_address_define=start_addr_def)
 
 
@@ -366,6 +367,112 @@ def add_registers(peripheral_json):
     return reg_struct, reg_enum
 
 
+def field_range(bits_range):
+    """
+    Returns the index of the lowest bit and the mask (not shifted) of a field given as "end_bit:start_bit"
+    or as a single bit index.
+
+    :param bits_range: string containing the bit (or range of bits) of a field
+    :return: the index of the lowest bit and the mask of the field
+    """
+    if bits_range.find(":") != -1:
+        index = int(bits_range.split(":")[1])
+    else:
+        index = int(bits_range)
+    return index, (1 << count_bits(bits_range)) - 1
+
+
+def add_accessors(peripheral_json):
+    """
+    Generates inline accessors for the registers of a peripheral, taking the structure of the registers:
+    <name>_<reg>_read/_write for every register, <name>_<reg>_update to write a part of the register
+    with a single read and write, and for each field <name>_<reg>_<field>_get/_set and the macro
+    <NAME>_<REG>_<FIELD>(v) placing a value in the field, to build the value of a whole register.
+    The registers with write-1-to-clear fields only get _read and _write, and the read-only fields
+    no _set. The multiregs of a single field get <name>_<reg>_get/_set(p, i) on the field of index i,
+    or <name>_<reg>_write(p, i, v) if write-only or write-1-to-clear. Windows are skipped.
+    Once inlined with a constant pointer (e.g. <name>_peri), each access is a single load or store.
+
+    :param peripheral_json: the json-like description of the registers of a peripheral
+    :return: the string containing the accessors
+    """
+
+    name = peripheral_json["name"]
+    struct_type = "volatile {} *".format(name)
+    res = ""
+    if "interrupt_list" in peripheral_json and "no_auto_intr_regs" not in peripheral_json:
+        registers = [{"name": r, "swaccess": "rw1c" if r == "INTR_STATE" else "rw", "fields": []}
+                     for r in ("INTR_STATE", "INTR_ENABLE", "INTR_TEST")]
+    else:
+        registers = []
+    registers += [r for r in peripheral_json["registers"] if "name" in r and "fields" in r]
+
+    for reg in registers:
+        reg_name = reg["name"]
+        prefix = "{}_{}".format(name.lower(), reg_name.lower())
+        upper_prefix = "{}_{}".format(name.upper(), reg_name.upper())
+        reg_access = reg.get("swaccess", "rw")
+        fields = reg["fields"]
+        field_access = [f.get("swaccess", reg_access) for f in fields]
+        writable = reg_access != "ro" or any(a != "ro" for a in field_access)
+        clears = reg_access == "rw1c" or "rw1c" in field_access
+
+        res += "/* {} */\n".format(reg_name)
+        res += "static inline uint32_t {}_read(const {}p) {{ return p->{}; }}\n".format(prefix, struct_type, reg_name)
+        if writable:
+            res += "static inline void {}_write({}p, uint32_t value) {{ p->{} = value; }}\n".format(
+                prefix, struct_type, reg_name)
+        if writable and not clears:
+            res += ("static inline void {}_update({}p, uint32_t mask, uint32_t value)\n"
+                    "{{\n" + tab_spaces + "p->{} = (p->{} & ~mask) | (value & mask);\n}}\n").format(
+                prefix, struct_type, reg_name, reg_name)
+
+        for field, access in zip(fields, field_access):
+            field_name = field.get("name", reg_name)
+            index, mask = field_range(field["bits"])
+            full = "{}_{}".format(prefix, field_name.lower())
+            res += "#define {}_{}(v) (((uint32_t)(v) & 0x{:x}u) << {})\n".format(
+                upper_prefix, field_name.upper(), mask, index)
+            res += "static inline uint32_t {}_get(const {}p) {{ return (p->{} >> {}) & 0x{:x}u; }}\n".format(
+                full, struct_type, reg_name, index, mask)
+            if access != "ro" and not clears:
+                res += "static inline void {}_set({}p, uint32_t v) {{ {}_update(p, 0x{:x}u << {}, v << {}); }}\n".format(
+                    full, struct_type, prefix, mask, index, index)
+        res += "\n"
+
+    for elem in peripheral_json["registers"]:
+        if "multireg" not in elem or len(elem["multireg"]["fields"]) != 1:
+            continue
+        multireg = elem["multireg"]
+        reg_name = multireg["name"]
+        prefix = "{}_{}".format(name.lower(), reg_name.lower())
+        field = multireg["fields"][0]
+        access = field.get("swaccess", multireg.get("swaccess", "rw"))
+        index, mask = field_range(field["bits"])
+        per_reg = int(peripheral_json.get("regwidth", 32)) // count_bits(field["bits"])
+        word = "(&p->{}0)[i / {}]".format(reg_name, per_reg)
+        shift = "{} * (i % {}) + {}".format(count_bits(field["bits"]), per_reg, index)
+
+        res += "/* {} */\n".format(reg_name)
+        if access != "wo":
+            res += ("static inline uint32_t {}_get(const {}p, uint32_t i)\n"
+                    "{{\n" + tab_spaces + "return ({} >> ({})) & 0x{:x}u;\n}}\n").format(
+                prefix, struct_type, word, shift, mask)
+        if access in ("wo", "rw1c"):
+            # writing the other fields has no effect, no need to read the register
+            res += ("static inline void {}_write({}p, uint32_t i, uint32_t v)\n"
+                    "{{\n" + tab_spaces + "{} = (v & 0x{:x}u) << ({});\n}}\n").format(
+                prefix, struct_type, word, mask, shift)
+        elif access != "ro":
+            res += ("static inline void {}_set({}p, uint32_t i, uint32_t v)\n"
+                    "{{\n" + tab_spaces + "uint32_t shift = {};\n" +
+                    tab_spaces + "{} = ({} & ~(0x{:x}u << shift)) | ((v & 0x{:x}u) << shift);\n}}\n").format(
+                prefix, struct_type, shift, word, word, mask, mask)
+        res += "\n"
+
+    return res
+
+
 # def gen(input_template, input_hjson_file):
 # if __name__ == '__main__':
 def main(arg_vect):
@@ -405,7 +512,8 @@ def main(arg_vect):
 
     structs_definitions += "}} {};".format(data["name"])
 
-    final_output = write_template(input_template, structs_definitions, enums_definitions, data["name"])
+    final_output = write_template(input_template, structs_definitions, enums_definitions, data["name"],
+                                  add_accessors(data))
     write_output(output_filename, final_output)
 
 
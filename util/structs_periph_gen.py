@@ -35,6 +35,8 @@ def add_peripheral(name, path):
 """
 def scan_peripherals(json_list):
     for p in json_list:
+        if not isinstance(json_list[p], dict):
+            continue
         for field in json_list[p]:
             if(field == 'path'):
                 add_peripheral(p, json_list[p]["path"])
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Host side of the framed transfers of sw/device/lib/sdk/uart/uart_frame.h, over a
+# serial port (pyserial).
+#
+#   uart_frame.py PORT receive FILE   saves what the device sends with uart_frame_upload()
+#   uart_frame.py PORT send FILE      sends FILE to uart_frame_download() on the device
+#
+# The baudrate is the one of the uart_t of the device, at most UART_MAX_BAUDRATE() of its
+# clock: the adapter of the host must make it too.
+
+import argparse
+import struct
+import sys
+import zlib
+
+import serial
+
+# As in uart_frame.h
+SYNC = b"\xa5\x5a"
+DATA, ACK, NAK, END = 1, 2, 3, 4
+MAX_PAYLOAD = 1024
+RETRIES = 8
+
+
+def frame(kind, seq, payload=b""):
+    """Return the bytes of a frame."""
+    body = struct.pack("<BBH", kind, seq & 0xFF, len(payload)) + payload
+    return SYNC + body + struct.pack("<I", zlib.crc32(body))
+
+
+def read_frame(port):
+    """Return (kind, seq, payload) of the next frame, None on a timeout or a bad frame."""
+    # Find the sync bytes, skipping anything before
+    previous = b""
+    while True:
+        c = port.read(1)
+        if not c:
+            return None
+        if previous + c == SYNC:
+            break
+        previous = c
+    header = port.read(4)
+    if len(header) < 4:
+        return None
+    kind, seq, length = struct.unpack("<BBH", header)
+    rest = port.read(length + 4)
+    if len(rest) < length + 4:
+        return None
+    payload, (crc,) = rest[:length], struct.unpack("<I", rest[length:])
+    if zlib.crc32(header + payload) != crc:
+        port.reset_input_buffer()
+        return None
+    return kind, seq, payload
+
+
+def receive(port, path):
+    """Save the DATA frames of the device until its END frame."""
+    data = bytearray()
+    expected = 0
+    tries = 0
+    while tries < RETRIES:
+        f = read_frame(port)
+        if f is None:
+            port.write(frame(NAK, expected))
+            tries += 1
+            continue
+        tries = 0
+        kind, seq, payload = f
+        if kind == DATA and seq == expected:
+            data += payload
+            expected = (expected + 1) & 0xFF
+            port.write(frame(ACK, seq))
+        elif kind == DATA and seq == (expected - 1) & 0xFF:
+            port.write(frame(ACK, seq))
+        elif kind == END and seq == expected:
+            port.write(frame(ACK, seq))
+            with open(path, "wb") as out:
+                out.write(data)
+            print(f"{len(data)} bytes received", file=sys.stderr)
+            return 0
+        else:
+            port.write(frame(NAK, expected))
+    print("no frame from the device", file=sys.stderr)
+    return 1
+
+
+def send_acked(port, kind, seq, payload=b""):
+    """Send a frame until the device acknowledges it."""
+    for _ in range(RETRIES):
+        port.write(frame(kind, seq, payload))
+        f = read_frame(port)
+        if f is not None and f[0] == ACK and f[1] == seq & 0xFF:
+            return True
+    return False
+
+
+def send(port, path):
+    """Send a file in DATA frames, then an END frame."""
+    with open(path, "rb") as f:
+        data = f.read()
+    seq = 0
+    for offset in range(0, len(data), MAX_PAYLOAD):
+        if not send_acked(port, DATA, seq, data[offset : offset + MAX_PAYLOAD]):
+            print(f"no ACK of the frame at byte {offset}", file=sys.stderr)
+            return 1
+        seq += 1
+    if not send_acked(port, END, seq):
+        print("no ACK of the end", file=sys.stderr)
+        return 1
+    print(f"{len(data)} bytes sent", file=sys.stderr)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Framed bulk transfers with uart_frame.h")
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyUSB2")
+    parser.add_argument("direction", choices=["receive", "send"])
+    parser.add_argument("file")
+    parser.add_argument("--baudrate", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=0.5, help="seconds to wait for a frame")
+    args = parser.parse_args()
+
+    with serial.Serial(args.port, args.baudrate, timeout=args.timeout) as port:
+        if args.direction == "receive":
+            return receive(port, args.file)
+        return send(port, args.file)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Loads an application linked for the RAM (LINKER=on_chip) through the UART loader of
+# the boot ROM, and starts it (make uart-load).
+#
+# With boot_sel_i at 0, the boot ROM listens to the UART while it waits for the JTAG.
+# The loaded bytes of the ELF, from the first to the last, are compressed with the LZ4
+# sequences of flash_lz.py and sent after the magic and a header. The DMA copies them
+# to the heap and the stack of the application, which are free before it starts, the
+# boot ROM checks their CRC-32 and answers 'K' or 'N', then decompresses them in place
+# and jumps to _start. The baudrate is BOOT_UART_BAUDRATE of hw/ip/boot_rom/boot_rom.S.
+
+import argparse
+import struct
+import sys
+import zlib
+
+from flash_lz import compress, decompress, read_elf
+
+# As in boot_rom.S
+MAGIC = b"XHUL"
+ACK = b"K"
+NAK = b"N"
+
+
+def load_stream(elf_path):
+    """Return the bytes sent to the boot ROM, the load address and the image bytes."""
+    segments, symbols = read_elf(elf_path)
+    if not segments:
+        sys.exit(f"{elf_path}: nothing to load")
+    for name in ("_start", "_end", "__heap_end"):
+        if name not in symbols:
+            sys.exit(f"{elf_path}: no symbol {name}, not linked with link.ld")
+
+    base = min(paddr for paddr, _ in segments)
+    end = max(paddr + len(data) for paddr, data in segments)
+    image = bytearray(end - base)
+    for paddr, data in segments:
+        image[paddr - base:paddr - base + len(data)] = data
+    image = bytes(image)
+
+    packed = compress(image, None)
+    if decompress(packed, len(image), None) != image:
+        sys.exit("the round trip of the compression failed")
+
+    # The heap, and the stack when it follows it
+    staging = (symbols["_end"] + 3) & ~3
+    limit = symbols["__heap_end"]
+    if symbols.get("__stack_start", limit + 16) - limit < 16:
+        limit = symbols["__stack_end"]
+    if staging < end or staging + len(packed) > limit:
+        sys.exit(f"the {len(packed)} compressed bytes do not fit between _end and the end of the heap")
+
+    header = struct.pack("<6I", base, len(image), staging, len(packed), zlib.crc32(packed),
+                         symbols["_start"])
+    return MAGIC + header + packed, base, len(image)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load an application through the UART loader of the boot ROM")
+    parser.add_argument("elf", help="application linked with link.ld, e.g. sw/build/main.elf")
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyUSB2")
+    parser.add_argument("--baudrate", type=int, default=921600, help="BOOT_UART_BAUDRATE (default 921600)")
+    parser.add_argument("--retries", type=int, default=3)
+    args = parser.parse_args()
+
+    stream, base, length = load_stream(args.elf)
+
+    import serial
+
+    # The answer comes after the CRC is computed, at a few cycles per bit
+    with serial.Serial(args.port, args.baudrate, timeout=max(2.0, length / 20000)) as port:
+        for _ in range(args.retries):
+            port.reset_input_buffer()
+            port.write(stream)
+            answer = port.read(1)
+            if answer == ACK:
+                print(f"{length} bytes at {base:#010x} sent as {len(stream)}, started", file=sys.stderr)
+                return 0
+            if answer != NAK:
+                print("no answer from the boot ROM: is boot_sel_i at 0, and the baudrate the one of boot_rom.S?",
+                      file=sys.stderr)
+                return 1
+            print("bad CRC, sent again", file=sys.stderr)
+    print(f"bad CRC after {args.retries} tries", file=sys.stderr)
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
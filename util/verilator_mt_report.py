@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Compares the simulation speed (cycles/s) of the single-threaded (verilator-sim)
+# and multithreaded (verilator-sim-mt) Verilator models on a set of applications.
+
+import argparse
+import pathlib
+import re
+import subprocess
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+BUILD = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0"
+MODELS = {
+    "st": BUILD / "sim-verilator",
+    "mt": BUILD / "sim_mt-verilator",
+}
+SPEED_RE = re.compile(r"\[TESTBENCH\]: Simulated (\d+) cycles in ([0-9.e+-]+) s")
+
+
+def build_app(app, linker, compiler):
+    cmd = ["make", "-C", str(ROOT), "app", "PROJECT=" + app, "LINKER=" + linker, "COMPILER=" + compiler]
+    return subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode == 0
+
+
+def run_model(model_dir, timeout):
+    cmd = ["./Vtestharness", "+firmware=" + str(ROOT / "sw" / "build" / "main.hex"), "+trace=off"]
+    try:
+        out = subprocess.run(cmd, cwd=model_dir, capture_output=True, text=True, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return None
+    m = SPEED_RE.search(out.stdout)
+    if out.returncode != 0 or m is None:
+        return None
+    return int(m.group(1)), float(m.group(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Verilator single vs multithreaded speed report")
+    parser.add_argument("--apps", nargs="+", required=True, help="applications in sw/applications")
+    parser.add_argument("--linker", default="on_chip")
+    parser.add_argument("--compiler", default="gcc")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--output", default="verilator_mt_report.md")
+    args = parser.parse_args()
+
+    for name, model_dir in MODELS.items():
+        if not (model_dir / "Vtestharness").exists():
+            sys.exit("Missing model {}: build it first with make verilator-sim{}".format(
+                model_dir, "-mt" if name == "mt" else ""))
+
+    rows = []
+    for app in args.apps:
+        if not build_app(app, args.linker, args.compiler):
+            print("Failed building " + app)
+            rows.append((app, None, None))
+            continue
+        res = {name: run_model(model_dir, args.timeout) for name, model_dir in MODELS.items()}
+        rows.append((app, res["st"], res["mt"]))
+
+    with open(args.output, "w") as f:
+        f.write("| app | cycles | single-thread cycles/s | multi-thread cycles/s | speed-up |\n")
+        f.write("|-----|--------|------------------------|-----------------------|----------|\n")
+        for app, st, mt in rows:
+            if st is None or mt is None:
+                f.write("| {} | failed | - | - | - |\n".format(app))
+                continue
+            st_speed = st[0] / st[1]
+            mt_speed = mt[0] / mt[1]
+            f.write("| {} | {} | {:.0f} | {:.0f} | {:.2f}x |\n".format(app, st[0], st_speed, mt_speed, mt_speed / st_speed))
+
+    print(open(args.output).read())
+
+
+if __name__ == "__main__":
+    main()
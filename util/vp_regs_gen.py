@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Register tables of the virtual platform (make vp), see tb/vp/RegBank.h.
+#
+# The registers of the IPs modelled by the virtual platform are read from their hjson with
+# reggen, the library of regtool.py, so that the offsets, reset values and software accesses
+# of the models follow the RTL. The power manager description is generated by make mcu-gen.
+
+import argparse
+import pathlib
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+sys.path.insert(0, str(ROOT / "hw" / "vendor" / "pulp_platform_register_interface" / "vendor" / "lowrisc_opentitan" / "util"))
+
+from reggen.ip_block import IpBlock  # noqa: E402
+
+IPS = {
+    "soc_ctrl": "hw/ip/soc_ctrl/data/soc_ctrl.hjson",
+    "fast_intr_ctrl": "hw/ip/fast_intr_ctrl/data/fast_intr_ctrl.hjson",
+    "dma": "hw/ip/dma/data/dma.hjson",
+    "power_manager": "hw/ip/power_manager/data/power_manager.hjson",
+    "rv_timer": "hw/vendor/lowrisc_opentitan/hw/ip/rv_timer/data/rv_timer.hjson",
+    "uart": "hw/vendor/lowrisc_opentitan/hw/ip/uart/data/uart.hjson",
+    "rv_plic": "hw/vendor/lowrisc_opentitan/hw/ip/rv_plic/data/rv_plic.hjson",
+    "spi_host": "hw/vendor/lowrisc_opentitan_spi_host/data/spi_host.hjson",
+}
+
+# software access of the fields -> mask of RegDesc
+ACCESS = {
+    "rw": "rw",
+    "wo": "rw",
+    "rw1c": "w1c",
+    "r0w1c": "w1c",
+    "rw1s": "w1s",
+    "rc": "rc",
+    "rw0c": "rw",
+    "ro": None,
+}
+
+
+def reg_desc(reg):
+    masks = {"rw": 0, "w1c": 0, "w1s": 0, "rc": 0, "wo": 0}
+    for field in reg.fields:
+        bits = field.bits.bitmask()
+        key = field.swaccess.key
+        if ACCESS.get(key):
+            masks[ACCESS[key]] |= bits
+        if key in ("wo", "r0w1c"):
+            masks["wo"] |= bits
+    return "  {{ 0x{:03x}, 0x{:08x}, 0x{:08x}, 0x{:08x}, 0x{:08x}, 0x{:08x}, 0x{:08x}, \"{}\" }},".format(
+        reg.offset, reg.resval, masks["rw"], masks["w1c"], masks["w1s"], masks["rc"], masks["wo"], reg.name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Register tables of the virtual platform")
+    parser.add_argument("--outdir", required=True, help="folder of the generated vp_regs.h")
+    args = parser.parse_args()
+
+    out = ["// Generated by util/vp_regs_gen.py, do not edit",
+           "",
+           "#ifndef VP_REGS_H",
+           "#define VP_REGS_H",
+           "",
+           "#include \"RegBank.h\"",
+           ""]
+
+    for name, path in IPS.items():
+        hjson = ROOT / path
+        if not hjson.exists():
+            sys.exit("{} does not exist, run make mcu-gen first".format(path))
+        block = IpBlock.from_path(str(hjson), [])
+        regs = block.reg_blocks[None]
+        upper = name.upper()
+
+        out.append("// {}".format(path))
+        out.append("// offset, reset, rw, w1c, w1s, rc, wo, name")
+        out.append("static const RegDesc VP_{}_REGS[] = {{".format(upper))
+        out += [reg_desc(reg) for reg in regs.flat_regs]
+        out.append("};")
+        out.append("#define VP_{}_NREGS {}".format(upper, len(regs.flat_regs)))
+        if regs.windows:
+            out.append("static const RegWindow VP_{}_WINDOWS[] = {{".format(upper))
+            out += ["  {{ 0x{:03x}, 0x{:x}, \"{}\" }},".format(w.offset, w.size_in_bytes, w.name) for w in regs.windows]
+            out.append("};")
+            out.append("#define VP_{}_NWINDOWS {}".format(upper, len(regs.windows)))
+        out.append("")
+
+    out.append("#endif")
+    outdir = pathlib.Path(args.outdir)
+    outdir.mkdir(parents=True, exist_ok=True)
+    (outdir / "vp_regs.h").write_text("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,5 @@
 from .system import XHeep
 from . import system
 from . import load_config
-from . import ram_bank
\ No newline at end of file
+from . import ram_bank
+from . import bank_analysis
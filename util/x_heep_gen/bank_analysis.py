@@ -0,0 +1,461 @@
+"""
+Bank-conflict analysis of a bus trace of the testharness.
+
+The trace written with ``+bus_trace=<file>`` (``tb/bus_trace.sv``) holds every
+transaction of the masters of the system crossbar with the cycle it was asked
+for and the cycle it was granted. The transactions of each master are replayed
+over memory configurations: a transaction is asked for as many cycles after the
+grant of the previous one of its master as in the trace, and waits when another
+master uses the same slave in that cycle. With ``NtoM`` each bank and each
+other slave serve one master per cycle, with ``onetoM`` the whole bus does. The
+time spent by the masters between their transactions, e.g. the core waiting
+for its data, is kept from the trace, so the model is an estimate of the effect
+of the bank conflicts only.
+
+The candidates have banks of 32 KiB as with ``make mcu-gen MEMORY_BANKS=<n>
+MEMORY_BANKS_IL=<m>``. The data they put in the interleaved banks is the data in
+the interleaved banks of the traced configuration, and the symbols of the
+linker map chosen with ``il_symbols``, or else those that wait the most in the
+traced configuration. The other addresses keep their place in the continuous
+banks.
+"""
+
+import re
+from bisect import bisect_right
+from dataclasses import dataclass
+from typing import Dict, Iterable, List, Optional, Tuple
+
+from .event_trace import Bus, EventReader, is_event_trace
+from .system import BusType, XHeep
+
+BANK_SIZE = 32 * 1024
+"""Size of the banks of the candidate configurations"""
+
+CANDIDATE_NUMBANKS = [2, 4, 8, 16]
+CANDIDATE_NUMBANKS_IL = [0, 2, 4, 8]
+
+SYSTEM_MASTER_NAMES = ["core instr", "core data", "debug", "dma read", "dma write", "dma addr"]
+
+
+
+@dataclass
+class Access():
+    """
+    A transaction of the trace.
+    """
+    req: int
+    """cycle the master asked for it"""
+    gnt: int
+    """cycle it was granted"""
+    master: int
+    addr: int
+    write: bool
+
+
+
+@dataclass
+class Symbol():
+    """
+    A region of the linker map.
+    """
+    name: str
+    start: int
+    size: int
+
+
+
+@dataclass
+class Result():
+    """
+    Outcome of the replay of the trace over a configuration.
+    """
+    cycles: int
+    accesses: int
+    conflicts: int
+    """transactions that waited at least a cycle for their slave"""
+    wait: int
+    """cycles waited by all the transactions"""
+    master_accesses: Dict[int, int]
+    master_conflicts: Dict[int, int]
+    master_wait: Dict[int, int]
+    addr_wait: Dict[int, int]
+    """cycles waited at each word address"""
+
+
+
+def read_trace(path: str) -> Tuple[List[Access], int, int]:
+    """
+    Reads a trace of ``tb/bus_trace.sv``, or the transactions of a binary event
+    trace of the testharness (``+event_trace=<file>``).
+
+    :param str path: the trace
+    :return: the transactions, the number of masters and of system masters
+    :raise RuntimeError: when a line cannot be parsed
+    """
+    accesses: List[Access] = []
+    nmaster = 0
+    nsystem = len(SYSTEM_MASTER_NAMES)
+    header = re.compile(r"#.*masters (\d+), system masters (\d+)")
+
+    if is_event_trace(path):
+        with EventReader(path) as events:
+            accesses = [Access(e.req, e.gnt, e.master, e.addr, e.write) for e in events if isinstance(e, Bus)]
+            nmaster, nsystem = events.nmaster, events.nsystem
+        return accesses, nmaster, nsystem
+
+    with open(path, "r") as f:
+        for n, line in enumerate(f, 1):
+            line = line.strip()
+            if line == "":
+                continue
+            if line.startswith("#"):
+                m = header.match(line)
+                if m:
+                    nmaster, nsystem = int(m.group(1)), int(m.group(2))
+                continue
+            fields = line.split()
+            if len(fields) != 5 or fields[4] not in ("r", "w"):
+                raise RuntimeError(f"{path}:{n}: expected '<request cycle> <grant cycle> <master> <address> <r|w>'")
+            accesses.append(Access(int(fields[0]), int(fields[1]), int(fields[2]), int(fields[3], 16), fields[4] == "w"))
+
+    if len(accesses) > 0:
+        nmaster = max(nmaster, max(a.master for a in accesses) + 1)
+    return accesses, nmaster, nsystem
+
+
+
+def read_map(path: str) -> List[Symbol]:
+    """
+    Reads the input sections and the symbols of a GNU ld map file, e.g. sw/build/main.map.
+    The symbols split the input sections that hold them.
+
+    :param str path: the map file
+    :return: the regions sorted by address, without overlap
+    """
+    section_full = re.compile(r"^ (\.[^\s]+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+\S")
+    section_name = re.compile(r"^ (\.[^\s]+)$")
+    section_addr = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+\S")
+    symbol = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)$")
+
+    sections: List[Symbol] = []
+    symbols: List[Tuple[int, str]] = []
+    in_map = False
+    pending: Optional[str] = None
+
+    with open(path, "r") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Linker script and memory map"):
+                in_map = True
+                continue
+            if not in_map:
+                continue
+            if pending is not None:
+                m = section_addr.match(line)
+                if m:
+                    sections.append(Symbol(pending, int(m.group(1), 16), int(m.group(2), 16)))
+                pending = None
+                continue
+            m = section_full.match(line)
+            if m:
+                sections.append(Symbol(m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+                continue
+            m = section_name.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = symbol.match(line)
+            if m:
+                symbols.append((int(m.group(1), 16), m.group(2)))
+
+    symbols.sort()
+    starts = [s[0] for s in symbols]
+    regions: List[Symbol] = []
+    for sec in sorted((s for s in sections if s.size > 0), key=lambda s: s.start):
+        end = sec.start + sec.size
+        if len(regions) > 0 and sec.start < regions[-1].start + regions[-1].size:
+            continue
+        # Symbols inside the section
+        inner = [symbols[i] for i in range(bisect_right(starts, sec.start - 1), bisect_right(starts, end - 1))]
+        cuts = [(sec.start, sec.name)] + [s for s in inner if s[0] > sec.start]
+        if len(inner) > 0 and inner[0][0] == sec.start:
+            cuts[0] = (sec.start, inner[0][1])
+        for i, (start, name) in enumerate(cuts):
+            stop = cuts[i + 1][0] if i + 1 < len(cuts) else end
+            if stop > start:
+                regions.append(Symbol(name, start, stop - start))
+    return regions
+
+
+
+def symbol_of(regions: List[Symbol], starts: List[int], addr: int) -> Optional[Symbol]:
+    i = bisect_right(starts, addr) - 1
+    if i >= 0 and addr < regions[i].start + regions[i].size:
+        return regions[i]
+    return None
+
+
+
+def real_slave(xheep: XHeep):
+    """
+    :return: a function of an address giving its slave in a configuration: the index of its bank in
+    the ram, else its 256 MiB region.
+    """
+    banks = list(xheep.iter_ram_banks())
+
+    def slave(addr: int):
+        for i, b in enumerate(banks):
+            if b.start_address() <= addr < b.end_address():
+                if b.il_level() == 0:
+                    return i
+                if (addr >> b.il_shift()) & ((1 << b.il_level()) - 1) == b.il_offset():
+                    return i
+        return ("region", addr >> 28)
+
+    return slave
+
+
+
+def candidate_slave(numbanks: int, numbanks_il: int, ram_start: int, il_offset: Dict[int, int]):
+    """
+    :param Dict[int,int] il_offset: offset in the interleaved banks of the word addresses placed there
+    :return: a function of an address giving its slave in a candidate configuration, or None when
+    the address does not fit in it.
+    """
+    cont_size = (numbanks - numbanks_il) * BANK_SIZE
+    ram_end = ram_start + numbanks * BANK_SIZE
+
+    def slave(addr: int):
+        word = addr & ~3
+        if numbanks_il > 0 and word in il_offset:
+            return numbanks - numbanks_il + (il_offset[word] >> 2) % numbanks_il
+        if ram_start <= addr < ram_end or addr >> 28 == ram_start >> 28:
+            if addr - ram_start >= cont_size:
+                return None
+            return (addr - ram_start) // BANK_SIZE
+        return ("region", addr >> 28)
+
+    return slave
+
+
+
+def replay(accesses: List[Access], slave, bus_type: BusType) -> Result:
+    """
+    Replays the transactions of each master in the order of the trace over the slaves given by
+    ``slave``, granting per cycle one transaction per slave with NtoM, one in all with onetoM, the
+    one that waits since the longest first.
+    """
+    per_master: Dict[int, List[Access]] = {}
+    for a in accesses:
+        per_master.setdefault(a.master, []).append(a)
+    for l in per_master.values():
+        l.sort(key=lambda a: a.gnt)
+
+    masters = sorted(per_master)
+    pos = {m: 0 for m in masters}
+    last_gnt_trace = {m: 0 for m in masters}
+    last_gnt = {m: 0 for m in masters}
+    ready: Dict[int, int] = {}
+    for m in masters:
+        ready[m] = per_master[m][0].req
+        last_gnt_trace[m] = per_master[m][0].req
+        last_gnt[m] = per_master[m][0].req
+
+    res = Result(0, 0, 0, 0, {m: 0 for m in masters}, {m: 0 for m in masters}, {m: 0 for m in masters}, {})
+    start = min(ready.values()) if len(ready) > 0 else 0
+    end = start
+    active = set(masters)
+    slaves: Dict[int, object] = {}
+    t = start
+
+    while len(active) > 0:
+        waiting = [m for m in active if ready[m] <= t]
+        if len(waiting) == 0:
+            t = min(ready[m] for m in active)
+            continue
+        waiting.sort(key=lambda m: (ready[m], m))
+        used = set()
+        for m in waiting:
+            a = per_master[m][pos[m]]
+            s = "bus"
+            if bus_type == BusType.NtoM:
+                if a.addr not in slaves:
+                    slaves[a.addr] = slave(a.addr)
+                s = slaves[a.addr]
+            if s in used:
+                continue
+            used.add(s)
+
+            wait = t - ready[m]
+            res.accesses += 1
+            res.master_accesses[m] += 1
+            if wait > 0:
+                res.conflicts += 1
+                res.master_conflicts[m] += 1
+                res.wait += wait
+                res.master_wait[m] += wait
+                word = a.addr & ~3
+                res.addr_wait[word] = res.addr_wait.get(word, 0) + wait
+            end = max(end, t + 1)
+
+            # Next transaction of the master, after the same time as in the trace
+            pos[m] += 1
+            if pos[m] == len(per_master[m]):
+                active.remove(m)
+            else:
+                n = per_master[m][pos[m]]
+                ready[m] = t + max(1, n.req - a.gnt)
+        t += 1
+
+    res.cycles = end - start
+    return res
+
+
+
+def master_name(m: int, nsystem: int) -> str:
+    if m < nsystem:
+        if m < len(SYSTEM_MASTER_NAMES):
+            return SYSTEM_MASTER_NAMES[m]
+        return f"system {m}"
+    return f"external {m - nsystem}"
+
+
+
+def pick_il_symbols(regions: List[Symbol], addr_wait: Dict[int, int], names: Optional[Iterable[str]],
+                    capacity: int) -> List[Symbol]:
+    """
+    :return: the regions to place in the interleaved banks: the named ones, else the ones waiting the
+    most in the traced configuration that fit in ``capacity`` bytes.
+    """
+    if names is not None:
+        wanted = set(names)
+        return [r for r in regions if r.name in wanted]
+
+    starts = [r.start for r in regions]
+    wait: Dict[str, int] = {}
+    for addr, w in addr_wait.items():
+        r = symbol_of(regions, starts, addr)
+        if r is not None:
+            wait[r.name] = wait.get(r.name, 0) + w
+
+    chosen: List[Symbol] = []
+    size = 0
+    for r in sorted((r for r in regions if r.name in wait), key=lambda r: -wait[r.name]):
+        if size + r.size <= capacity:
+            chosen.append(r)
+            size += r.size
+    return chosen
+
+
+
+def analyze(xheep: XHeep, trace: str, map_file: Optional[str] = None, il_symbols: Optional[List[str]] = None,
+            top: int = 10) -> str:
+    """
+    Replays a trace over the traced configuration and over the candidates, and reports their bank
+    conflicts and their speed-up over the traced configuration.
+
+    :param XHeep xheep: the configuration the trace was taken with
+    :param str trace: trace of ``tb/bus_trace.sv``
+    :param str map_file: linker map of the application, to name the data that waits and to choose what
+      goes in the interleaved banks
+    :param List[str] il_symbols: symbols of the map to place in the interleaved banks of the candidates
+    :param int top: number of symbols listed
+    :return: the report
+    """
+    accesses, nmaster, nsystem = read_trace(trace)
+    if len(accesses) == 0:
+        return f"{trace}: no transaction\n"
+
+    out: List[str] = []
+    traced_cycles = max(a.gnt for a in accesses) + 1 - min(a.req for a in accesses)
+    traced_wait = sum(a.gnt - a.req for a in accesses)
+
+    current = replay(accesses, real_slave(xheep), xheep.bus_type())
+
+    out.append(f"Trace {trace}: {len(accesses)} transactions of {nmaster} masters in {traced_cycles} cycles, "
+               f"{traced_wait} cycles waiting for a grant")
+    out.append(f"Traced configuration: {xheep.bus_type().value}, {xheep.ram_numbanks()} banks of which "
+               f"{xheep.ram_numbanks_il()} interleaved, modelled in {current.cycles} cycles")
+    out.append("")
+    out.append(f"{'master':<12} {'transactions':>12} {'conflicts':>10} {'wait':>8}")
+    for m in sorted(current.master_accesses):
+        n = current.master_accesses[m]
+        out.append(f"{master_name(m, nsystem):<12} {n:>12} {100.0 * current.master_conflicts[m] / n:>9.1f}% "
+                   f"{current.master_wait[m] / n:>8.2f}")
+
+    regions: List[Symbol] = []
+    if map_file is not None:
+        regions = read_map(map_file)
+        starts = [r.start for r in regions]
+        wait: Dict[str, int] = {}
+        for addr, w in current.addr_wait.items():
+            r = symbol_of(regions, starts, addr)
+            name = r.name if r is not None else f"0x{addr:08x}"
+            wait[name] = wait.get(name, 0) + w
+        if len(wait) > 0:
+            out.append("")
+            out.append(f"Data waiting the most for its bank ({map_file}):")
+            for name, w in sorted(wait.items(), key=lambda x: -x[1])[:top]:
+                out.append(f"  {name:<40} {w:>10} cycles")
+
+    # Data of the interleaved banks of the traced configuration keeps its offset
+    traced_il: Dict[int, int] = {}
+    traced_il_size = 0
+    for group in xheep.iter_il_groups():
+        for a in accesses:
+            if group.start <= a.addr < group.start + group.size:
+                traced_il[a.addr & ~3] = traced_il_size + ((a.addr & ~3) - group.start)
+        traced_il_size += group.size
+    words = sorted(set(a.addr & ~3 for a in accesses))
+
+    def il_placement(numbanks_il: int) -> Tuple[Optional[Dict[int, int]], List[Symbol]]:
+        """Word offsets in the interleaved banks and moved symbols, None when they do not fit"""
+        capacity = numbanks_il * BANK_SIZE - traced_il_size
+        if capacity < 0:
+            return None, []
+        offset = dict(traced_il)
+        moved = pick_il_symbols(regions, current.addr_wait, il_symbols, capacity) if len(regions) > 0 else []
+        next_offset = traced_il_size
+        for r in moved:
+            for w in words[bisect_right(words, r.start - 1):bisect_right(words, r.start + r.size - 1)]:
+                offset[w] = next_offset + (w - r.start)
+            next_offset += (r.size + 3) & ~3
+        if next_offset > numbanks_il * BANK_SIZE:
+            return None, []
+        return offset, moved
+
+    out.append("")
+    out.append(f"{'bus':<7} {'banks':>5} {'il':>3} {'cycles':>10} {'speed-up':>8} {'conflicts':>10} {'wait':>8}  interleaved data")
+
+    best: Optional[Tuple[float, str]] = None
+    for bus in (BusType.onetoM, BusType.NtoM):
+        for numbanks in CANDIDATE_NUMBANKS:
+            for numbanks_il in CANDIDATE_NUMBANKS_IL:
+                if numbanks_il >= numbanks:
+                    continue
+                if numbanks_il > 0 and bus not in XHeep.IL_COMPATIBLE_BUS_TYPES:
+                    continue
+                offset: Dict[int, int] = {}
+                moved: List[Symbol] = []
+                if numbanks_il > 0:
+                    placed, moved = il_placement(numbanks_il)
+                    if placed is None:
+                        continue
+                    offset = placed
+                slave = candidate_slave(numbanks, numbanks_il, xheep.ram_start_address(), offset)
+                if any(slave(a.addr) is None for a in accesses):
+                    continue
+                r = replay(accesses, slave, bus)
+                speedup = current.cycles / r.cycles if r.cycles > 0 else 0.0
+                il_data = ", ".join((["traced interleaved banks"] if numbanks_il > 0 and len(traced_il) > 0 else []) +
+                                    [m.name for m in moved])
+                out.append(f"{bus.value:<7} {numbanks:>5} {numbanks_il:>3} {r.cycles:>10} {speedup:>7.3f}x "
+                           f"{100.0 * r.conflicts / r.accesses:>9.1f}% {r.wait / r.accesses:>8.2f}  {il_data}")
+                if best is None or speedup > best[0]:
+                    best = (speedup, f"{bus.value}, {numbanks} banks of which {numbanks_il} interleaved")
+
+    if best is not None:
+        out.append("")
+        out.append(f"Fastest: {best[1]}, {best[0]:.3f}x the traced configuration")
+    out.append("")
+    return "\n".join(out)
@@ -0,0 +1,170 @@
+"""
+Streaming reader of the binary event trace of the testharness.
+
+The trace written with ``+event_trace=<file>`` (``tb/XHEEP_EventTrace.hh``) is a
+gzip stream of the retired instructions, of the transactions of the masters of
+the system crossbar and of the changes of the interrupt lines of the core. The
+events are read one at a time, so that a trace of billions of events is never
+held in memory.
+"""
+
+import gzip
+from dataclasses import dataclass
+from typing import BinaryIO, Iterator, Tuple, Union
+
+MAGIC = b"XHEEPEVT"
+VERSION = 1
+
+EVENT_RETIRE = 0
+EVENT_BUS_READ = 1
+EVENT_BUS_WRITE = 2
+EVENT_IRQ = 3
+
+READ_SIZE = 1 << 20
+
+
+
+@dataclass
+class Retire():
+    """
+    An instruction retired by the core.
+    """
+    cycle: int
+    pc: int
+
+
+
+@dataclass
+class Bus():
+    """
+    A transaction granted to a master of the system crossbar.
+    """
+    req: int
+    """cycle the master asked for it"""
+    gnt: int
+    """cycle it was granted"""
+    master: int
+    addr: int
+    write: bool
+
+
+
+@dataclass
+class Irq():
+    """
+    A change of the interrupt lines of the core.
+    """
+    cycle: int
+    lines: int
+
+
+
+Event = Union[Retire, Bus, Irq]
+
+
+
+def is_event_trace(path: str) -> bool:
+    """
+    :param str path: a trace of the testharness
+    :return: whether it is a binary event trace rather than a text trace
+    """
+    with open(path, "rb") as f:
+        if f.read(2) != b"\x1f\x8b":
+            return False
+    with gzip.open(path, "rb") as f:
+        return f.read(len(MAGIC)) == MAGIC
+
+
+
+class EventReader():
+    """
+    Iterator over the events of a binary event trace.
+
+    :param str path: the trace
+    :raise RuntimeError: when the file is not an event trace
+    """
+
+    def __init__(self, path: str):
+        self.path = path
+        self.file: BinaryIO = gzip.open(path, "rb")
+        header = self.file.read(len(MAGIC) + 4)
+        if len(header) < len(MAGIC) + 4 or header[:len(MAGIC)] != MAGIC:
+            raise RuntimeError(f"{path}: not an event trace of the testharness")
+        if header[len(MAGIC)] != VERSION:
+            raise RuntimeError(f"{path}: event trace version {header[len(MAGIC)]}, expected {VERSION}")
+        self.nmaster = header[len(MAGIC) + 1]
+        """number of masters of the system crossbar"""
+        self.nsystem = header[len(MAGIC) + 2]
+        """number of masters of X-HEEP, the others being the external masters"""
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.file.close()
+
+    def _blocks(self) -> Iterator[bytes]:
+        while True:
+            data = self.file.read(READ_SIZE)
+            if not data:
+                return
+            yield data
+
+    def __iter__(self) -> Iterator[Event]:
+        cycle = 0
+        pc = 0
+        addr = [0] * max(self.nmaster, 64)
+        buf = b""
+        pos = 0
+
+        # the varints of an event can straddle two blocks, the rest of a block is kept
+        for data in self._blocks():
+            buf = buf[pos:] + data
+            pos = 0
+            end = len(buf)
+            while pos < end:
+                start = pos
+                try:
+                    tag = buf[pos]
+                    pos += 1
+                    delta, pos = _varint(buf, pos)
+                    kind = tag & 3
+                    if kind == EVENT_RETIRE:
+                        value, pos = _varint(buf, pos)
+                        pc = (pc + _unzigzag(value)) & 0xFFFFFFFF
+                        cycle += delta
+                        yield Retire(cycle, pc)
+                    elif kind == EVENT_IRQ:
+                        lines, pos = _varint(buf, pos)
+                        cycle += delta
+                        yield Irq(cycle, lines)
+                    else:
+                        wait, pos = _varint(buf, pos)
+                        value, pos = _varint(buf, pos)
+                        master = tag >> 2
+                        addr[master] = (addr[master] + _unzigzag(value)) & 0xFFFFFFFF
+                        cycle += delta
+                        yield Bus(cycle - wait, cycle, master, addr[master], kind == EVENT_BUS_WRITE)
+                except IndexError:
+                    pos = start
+                    break
+        if pos < len(buf):
+            raise RuntimeError(f"{self.path}: truncated event")
+
+
+
+def _varint(buf: bytes, pos: int) -> Tuple[int, int]:
+    value = 0
+    shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+
+def _unzigzag(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
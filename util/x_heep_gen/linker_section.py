@@ -16,6 +16,11 @@ class LinkerSection():
     The name can be anything that does not collide with section names used by the linker,
     except code and data that are used to configure the size of the code and data part.
     code and data do not only contain the actual .code and .data section but other related sections.
+
+    Three other names are placed by the linker script in their own region:
+    - hot: the hot functions, in .text.hot (`__attribute__((hot))`) or listed in hot_functions.ld
+    - cold: the cold functions, in .text.unlikely (`__attribute__((cold))`)
+    - stack: the stack, instead of the end of the data
     """
 
     start: int
@@ -24,6 +29,9 @@ class LinkerSection():
     end: Optional[int]
     """The end address"""
 
+    align: int = 4
+    """The alignment of the start and end of the section content, e.g. the row of the wide DMA ports"""
+
     def __post_init__(self):
         self.check()
 
@@ -44,6 +52,8 @@ class LinkerSection():
             raise TypeError("start should be of type int")
         if type(self.end) is not int and self.end is not None:
             raise TypeError("end should be of type int")
+        if type(self.align) is not int:
+            raise TypeError("align should be of type int")
         
         if self.name == "":
             raise ValueError("name should not be empty")
@@ -51,15 +61,18 @@ class LinkerSection():
             raise ValueError("start address should be positif")
         if self.end is not None and self.end <= self.start:
             raise ValueError("end address should be bigger than the start address")
+        if self.align < 4 or self.align & (self.align - 1) != 0:
+            raise ValueError("align should be a power of 2 of at least 4")
 
     @staticmethod
-    def by_size(name: str, start: int, size: int) -> "LinkerSection":
+    def by_size(name: str, start: int, size: int, align: int = 4) -> "LinkerSection":
         """
         Creates a Linker Section by it's size rather than end address.
 
         :param str name: the name of the section
         :param int start: the start address
         :param int size: the size of the section
+        :param int align: the alignment of the content of the section
         :return: the linker section
         :rtype: LinkerSection
         """
@@ -70,7 +83,7 @@ class LinkerSection():
         if type(size) is not int:
             raise TypeError("size should be of type int")
         
-        return LinkerSection(name, start, start + size)
+        return LinkerSection(name, start, start + size, align)
     
     @property
     def size(self) -> Optional[int]:
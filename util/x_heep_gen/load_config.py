@@ -102,7 +102,13 @@ def load_ram_configuration(system: XHeep, mem: hjson.OrderedDict):
             if "size" not in value or type(value["size"]) is not int:
                 raise RuntimeError("The size field is required for interleaved ram section and should be an integer")
             
-            system.add_ram_banks_il(int(value["num"]), int(value["size"]), section_name)
+            granularity = 4
+            if "granularity" in value:
+                if type(value["granularity"]) is not int:
+                    raise RuntimeError("The granularity field of an interleaved ram section should be an integer")
+                granularity = int(value["granularity"])
+
+            system.add_ram_banks_il(int(value["num"]), int(value["size"]), section_name, granularity)
 
         elif t == "continuous":
             banks: List[int] = []
@@ -164,8 +170,14 @@ def load_linker_config(system: XHeep, config: list):
                 raise RuntimeError("Sections should end after their start")
         else:
             end = None
-        
-        system.add_linker_section(LinkerSection(name, start, end))
+
+        align = 4
+        if "align" in l:
+            align = to_int(l["align"])
+            if align is None:
+                raise RuntimeError("Section alignments should be an integer")
+
+        system.add_linker_section(LinkerSection(name, start, end, align))
 
 
 
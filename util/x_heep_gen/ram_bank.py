@@ -21,12 +21,14 @@ class Bank():
     :param int map_idx: index in the global address map. Has to be unique. Interleaved mode banks should have consecutive indices.
     :param int il_level: number of bits used for interleaving.
     :param int il_offset: position in interleaved bank group if in any else 0. Should be consistent with map_idx.
+    :param int il_granularity: bytes taken in each bank of an interleaved group in turn, a power of two from a word to the bank size.
     :raise TypeError: when parameters don't have the right type.
     :raise ValueError: when size_k isn't a power of two.
     :raise ValueError: when start_address is not aligned on size.
     :raise ValueError: when il_offset is to big for the given il_level().
+    :raise ValueError: when il_granularity is not a power of two between a word and the bank size.
     """
-    def __init__(self, size_k: int, start_address: int, map_idx: int, il_level: int = 0, il_offset: int = 0):
+    def __init__(self, size_k: int, start_address: int, map_idx: int, il_level: int = 0, il_offset: int = 0, il_granularity: int = 4):
         if not type(size_k) is int:
             raise TypeError("Bank size should be an int")
         
@@ -41,12 +43,16 @@ class Bank():
         
         if not type(il_offset) is int:
             raise TypeError("il_offset size should be an int")
+
+        if not type(il_granularity) is int:
+            raise TypeError("il_granularity should be an int")
         
         self._size_k: int = size_k
         self._start_address: int = start_address
         self._map_idx: int = map_idx
         self._il_level: int = il_level
         self._il_offset: int = il_offset
+        self._il_granularity: int = il_granularity
         
         # check if power of 2
         if not is_pow2(self._size_k):
@@ -54,6 +60,9 @@ class Bank():
         
         if self._il_offset >= 2**self._il_level:
             raise ValueError(f"il_offset is to big for an il_level of {self._il_level}")
+
+        if not is_pow2(self._il_granularity) or self._il_granularity < 4 or self._il_granularity > self._size_k*1024:
+            raise ValueError(f"il_granularity of {self._il_granularity} bytes is not a power of two between a word and the bank size")
         
         mask = 0b11
         if not self._start_address & mask == 0:
@@ -112,6 +121,18 @@ class Bank():
         :rtype: int
         """
         return self._il_offset
+
+    def il_granularity(self) -> int:
+        """
+        :return: the bytes taken in each bank of the interleaved group in turn, a word by default.
+        """
+        return self._il_granularity
+
+    def il_shift(self) -> int:
+        """
+        :return: the position of the address bits choosing the bank in an interleaved group, 2 for a word.
+        """
+        return self._il_granularity.bit_length() - 1
     
 @dataclass
 class ILRamGroup():
@@ -130,4 +151,7 @@ class ILRamGroup():
 
     first_name: str
     """name of the first bank"""
+
+    granularity: int = 4
+    """bytes taken in each bank in turn"""
     
\ No newline at end of file
@@ -112,7 +112,7 @@ class XHeep():
     
 
 
-    def add_ram_banks_il(self, num: int, bank_size: int, section_name: str = "", ignore_ignore: bool = False):
+    def add_ram_banks_il(self, num: int, bank_size: int, section_name: str = "", granularity: int = 4, ignore_ignore: bool = False):
         """
         Add ram banks in interleaved mode to the system.
         The bank size should be a power of two and at least 1kiB,
@@ -121,9 +121,11 @@ class XHeep():
         :param int num: number of banks to add
         :param int bank_size: size of the banks in kiB
         :param str section_name: If not empty adds automatically a linker section for this banks. The names must be unique and not be used by the linker for other purposes.
+        :param int granularity: bytes taken in each bank in turn, a power of two from a word (the default) to the bank size, e.g. 16 or 64 for DMA bursts or 4096 for a page.
         :param bool ignore_ignore: Ignores the fact that an override was set. For internal uses to apply this override.
         :raise TypeError: when arguments are of wrong type
         :raise ValueError: when banks have an incorrect size or their number is not a power of two.
+        :raise ValueError: when the granularity is not a power of two between a word and the bank size.
         :raise ValueError: if the name was allready used for another section or the first and second are not code and data.
         """
         if self._ignore_ram_interleaved and not ignore_ignore:
@@ -137,40 +139,47 @@ class XHeep():
             raise ValueError(f"A power of two is required for the number of banks, got {num}")
         if not type(section_name) == str:
             raise TypeError("section_name should be of type str")
+        if not type(granularity) == int:
+            raise TypeError("granularity should be of type int")
+        # The bank is chosen by address bits, the group starts on a row
+        if is_pow2(granularity) and self._ram_next_addr % (granularity*num) != 0:
+            raise ValueError(f"The group starts at {self._ram_next_addr:#x}, not on a row of {num} banks of {granularity} bytes")
 
         first_il = self.ram_numbanks()
 
         banks: List[Bank] = []
         for i in range(num):
-            banks.append(Bank(bank_size, self._ram_next_addr, self._ram_next_idx, num.bit_length()-1, i))
+            banks.append(Bank(bank_size, self._ram_next_addr, self._ram_next_idx, num.bit_length()-1, i, granularity))
             self._ram_next_idx += 1
         
         self._ram_next_addr = banks[-1]._end_address
         
         if section_name != "":
-            self.add_linker_section_for_banks(banks, section_name)
+            # Aligned on a row of the group, a block of the granularity in each bank, e.g. for the wide DMA ports
+            self.add_linker_section_for_banks(banks, section_name, granularity * num)
         # Add all new banks if no error was raised
         self._ram_banks += banks
 
         indices = range(first_il, first_il + num)
         self._ram_banks_il_idx += indices
-        self._ram_banks_il_groups.append(ILRamGroup(banks[0].start_address(), bank_size*num*1024, len(banks), banks[0].name()))
+        self._ram_banks_il_groups.append(ILRamGroup(banks[0].start_address(), bank_size*num*1024, len(banks), banks[0].name(), granularity))
         self._il_banks_present = True
     
 
 
-    def add_linker_section_for_banks(self, banks: "List[Bank]", name: str):
+    def add_linker_section_for_banks(self, banks: "List[Bank]", name: str, align: int = 4):
         """
         Function to add linker sections coupled to some banks.
         :param List[Bank] banks: list of banks that compose the section, assumed to be continuous in memory
         :param str name: the name of the section.
+        :param int align: the alignment of the content of the section.
         :raise ValueError: if the name was allready used for another section or the first and second are not code and data.
         """
         if name in self._used_section_names:
             raise ValueError("linker section names should be unique")
         
         self._used_section_names.add(name)
-        self._linker_sections.append(LinkerSection(name, banks[0].start_address(), banks[-1].end_address()))
+        self._linker_sections.append(LinkerSection(name, banks[0].start_address(), banks[-1].end_address(), align))
     
     def add_linker_section(self, section: LinkerSection):
         """
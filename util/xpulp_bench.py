@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 EPFL
+# Solderpad Hardware License, Version 2.1, see LICENSE.md for details.
+# SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+
+# Cycles of the hot paths of the libraries built for RV32IMC and with the CORE-V extensions.
+#
+# For every CPU with the CORE-V (Xpulp) extensions, the MCU is generated and the Verilator model
+# is built with COREV_PULP=1, then example_xpulp_bench is built with the CORE-V compiler twice,
+# with XPULP_LIB=0 (RV32IMC) and with XPULP_LIB=auto (the hot paths with the extensions, see
+# sw/CMakeLists.txt), and simulated. The cycles of each path are compared between the two builds.
+
+import argparse
+import json
+import pathlib
+import re
+import subprocess
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[1]
+SIM_DIR = ROOT / "build" / "openhwgroup.org_systems_core-v-mini-mcu_0" / "sim-verilator"
+
+APP = "example_xpulp_bench"
+CYCLES_RE = re.compile(r"^(\w+)\s+(\d+)\s*$", re.MULTILINE)
+
+CPUS = ["cv32e40p", "cv32e40px"]
+BUILDS = {"rv32imc": "0", "xpulp": "auto"}
+
+
+def make(*args, log):
+    cmd = ["make", "-C", str(ROOT), "--no-print-directory"] + list(args)
+    with open(log, "w") as out:
+        return subprocess.run(cmd, stdout=out, stderr=subprocess.STDOUT).returncode == 0
+
+
+def simulate(timeout, log):
+    """Runs the firmware on the Verilator model, returns the UART output or None"""
+    (SIM_DIR / "uart0.log").unlink(missing_ok=True)
+    try:
+        with open(log, "w") as out:
+            subprocess.run(["./Vtestharness", "+firmware=" + str(ROOT / "sw" / "build" / "main.hex"),
+                            "+trace=off"], cwd=SIM_DIR, stdout=out, stderr=subprocess.STDOUT, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return None
+    uart = SIM_DIR / "uart0.log"
+    return uart.read_text(errors="replace") if uart.exists() else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cycles of the hot paths with and without the CORE-V extensions")
+    parser.add_argument("--cpus", nargs="+", default=CPUS, choices=CPUS)
+    parser.add_argument("--config", default="configs/general.hjson", help="X-HEEP configuration")
+    parser.add_argument("--corev-prefix", default="riscv32-corev-", help="COMPILER_PREFIX of the CORE-V compiler")
+    parser.add_argument("--timeout", type=int, default=3600, help="timeout of each simulation in seconds")
+    parser.add_argument("--outdir", default="xpulp_bench", help="folder of the logs and results")
+    args = parser.parse_args()
+
+    outdir = (ROOT / args.outdir).resolve()
+    outdir.mkdir(parents=True, exist_ok=True)
+    runs = []
+
+    for cpu in args.cpus:
+        print("Building the model " + cpu)
+        ok = make("mcu-gen", "X_HEEP_CFG=" + args.config, "CPU=" + cpu, log=outdir / "mcu-gen-{}.log".format(cpu))
+        ok = ok and make("verilator-sim", "FUSESOC_PARAM=--COREV_PULP=1",
+                         log=outdir / "verilator-sim-{}.log".format(cpu))
+        entry = {"cpu": cpu, "status": "pass", "cycles": {}}
+        runs.append(entry)
+        if not ok:
+            entry["status"] = "no_model"
+            continue
+        for build, xpulp_lib in BUILDS.items():
+            if not make("app", "PROJECT=" + APP, "COMPILER_PREFIX=" + args.corev_prefix, "XPULP_LIB=" + xpulp_lib,
+                        log=outdir / "app-{}-{}.log".format(cpu, build)):
+                entry["status"] = "app_build_fail"
+                break
+            uart = simulate(args.timeout, outdir / "sim-{}-{}.log".format(cpu, build))
+            if uart is None:
+                entry["status"] = "timeout"
+                break
+            (outdir / "uart-{}-{}.log".format(cpu, build)).write_text(uart)
+            if "success!" not in uart:
+                entry["status"] = "fail"
+            for m in CYCLES_RE.finditer(uart):
+                entry["cycles"].setdefault(m.group(1), {})[build] = int(m.group(2))
+        print("{:10} {}".format(cpu, entry["status"]))
+
+    with open(outdir / "results.json", "w") as f:
+        json.dump({"config": args.config, "runs": runs}, f, indent=2)
+
+    with open(outdir / "results.md", "w") as f:
+        f.write("| CPU | path | RV32IMC cycles | Xpulp cycles | speed-up |\n")
+        f.write("|-----|------|----------------|--------------|----------|\n")
+        for r in runs:
+            if not r["cycles"]:
+                f.write("| {} | {} | - | - | - |\n".format(r["cpu"], r["status"]))
+                continue
+            for path, cycles in r["cycles"].items():
+                base, pulp = cycles.get("rv32imc"), cycles.get("xpulp")
+                f.write("| {} | {} | {} | {} | {} |\n".format(
+                    r["cpu"], path, base if base is not None else "-", pulp if pulp is not None else "-",
+                    "{:.2f}x".format(base / pulp) if base and pulp else "-"))
+    print(open(outdir / "results.md").read())
+
+    sys.exit(0 if all(r["status"] == "pass" for r in runs) else 1)
+
+
+if __name__ == "__main__":
+    main()